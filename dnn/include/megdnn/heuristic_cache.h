@@ -15,12 +15,21 @@
 #include "megdnn/basic_types.h"
 #include "megdnn/oprs/base.h"
 
+#include <atomic>
+#include <list>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 
 namespace megdnn {
 
+/*!
+ * \brief cache of algorithms chosen by heuristic or profiling
+ *
+ * Entries are sharded by key hash, each shard with its own lock, so oprs
+ * on different threads rarely contend. The number of entries is bounded
+ * by capacity(), and least recently used entries are evicted first.
+ */
 class HeuristicCache {
 private:
     HeuristicCache() = default;
@@ -67,13 +76,32 @@ public:
         size_t workspace;
     };
 
+    struct Stats {
+        size_t nr_hit = 0, nr_miss = 0, nr_eviction = 0, size = 0;
+    };
+
+    //! default max number of entries
+    static constexpr size_t DEFAULT_CAPACITY = 16384;
+
     void put(const Key& key, Result& result);
 
     Result get(const Key& key);
 
     void clear();
 
+    //! set max number of entries, 0 for unlimited; the limit is enforced
+    //! for each shard (rounded up), and exceeding entries are evicted on
+    //! the next put() to the shard
+    void set_capacity(size_t capacity) { m_capacity = capacity; }
+
+    size_t capacity() const { return m_capacity; }
+
+    //! accumulated counters (reset by clear()) and current size
+    Stats stats();
+
 private:
+    static constexpr size_t NR_SHARD = 16;
+
     struct Hash {
         size_t operator()(const KeyStorage& k) const {
             size_t h1 = std::hash<std::string>{}(k.category);
@@ -82,12 +110,45 @@ private:
             return h1;
         }
     };
-    std::unordered_map<KeyStorage, Result, Hash> m_heuristic_cache;
+
+    //! key with precomputed hash, so hashing happens outside of the lock
+    struct HashedKey {
+        KeyStorage key;
+        size_t hash;
+
+        //! hash and equality of pointers to keys
+        struct PtrHash {
+            size_t operator()(const HashedKey* k) const { return k->hash; }
+        };
+        struct PtrEqual {
+            bool operator()(const HashedKey* lhs, const HashedKey* rhs) const {
+                return lhs->hash == rhs->hash && lhs->key == rhs->key;
+            }
+        };
+    };
+
+    struct Shard {
+        //! entries from the most recently used to the least recently used
+        std::list<std::pair<HashedKey, Result>> lru;
+        //! index of entries in lru, keyed by pointers to the keys stored in
+        //! lru to avoid storing each key twice
+        std::unordered_map<
+                const HashedKey*, decltype(lru)::iterator, HashedKey::PtrHash,
+                HashedKey::PtrEqual>
+                index;
+        size_t nr_hit = 0, nr_miss = 0, nr_eviction = 0;
 #if __DEPLOY_ON_XP_SP2__
-    size_t m_mtx;
+        size_t mtx;
 #else
-    std::mutex m_mtx;
+        std::mutex mtx;
 #endif
+    };
+
+    Shard m_shards[NR_SHARD];
+    std::atomic_size_t m_capacity{DEFAULT_CAPACITY};
+
+    HashedKey make_hashed_key(const Key& key);
+    Shard& get_shard(const HashedKey& key);
 };
 
 }  // namespace megdnn
@@ -256,6 +256,41 @@ protected:
             size_t workspace_in_bytes);
 };
 
+/**
+ * \brief fused image preprocessing: color conversion, resize and per-channel
+ *      affine normalization in a single pass
+ *
+ * src is a contiguous uint8 image of shape (N, H, W, 3) for the RGB modes, or
+ * (N, H * 3 / 2, W, 1) for the YUV modes; scale and bias are float32 of shape
+ * (3,). dst is float32 of shape (N, 3, OH, OW) for NCHW, (N, OH, OW, 3) for
+ * NHWC or (N, 1, OH, OW, 4) with a zero last channel for NCHW44, where
+ *
+ *      dst[c] = resize(cvt_color(src))[c] * scale[c] + bias[c]
+ *
+ * The color conversion is the same as CvtColor and the interpolation, which is
+ * NEAREST or LINEAR, is the same as Resize on float images.
+ */
+class ImagePreprocessForward : public OperatorBase {
+    DEF_OPR_PARAM(ImagePreprocess);
+    DEF_OPR_IMPL(ImagePreprocessForward, OperatorBase, 3, 1);
+
+public:
+    virtual void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) = 0;
+
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using ImagePreprocess = ImagePreprocessForward;
+
 /**
  * \brief Remap opr.
  */
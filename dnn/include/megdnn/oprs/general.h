@@ -165,6 +165,16 @@ public:
     using Mode = Param::Mode;
     using DataType = Param::DataType;
 
+    /*!
+     * \brief value of param().axis to reduce src to the shape of dst in one
+     *      operator, which is the default value of the param
+     *
+     * Every dimension of dst must either equal that of src, or be one. Only
+     * DataType::DEFAULT is supported in this case, and backends other than the
+     * CPU ones may not implement it.
+     */
+    static constexpr int32_t TARGET_SHAPE_AXIS = 0x7fffffff;
+
     /**
      * \param[in] src input tensor
      * \param[out] dst output tensor
@@ -1068,6 +1078,54 @@ protected:
 };
 using IndexingSetOneHot = IndexingSetOneHotForward;
 
+/*!
+ * \brief lookup and pool the rows of an embedding table by bags of indices
+ *
+ * Bag b consists of the rows weight[indices[j]] for j in
+ * [offsets[b], offsets[b + 1]), where offsets[B] is taken as the number of
+ * indices; dst[b] is the sum or the mean of the rows of bag b.
+ *
+ * The table can be quantized by rows: a Uint8 row of D + 8 bytes holds D
+ * quantized values q followed by the float32 scale and bias of the row, and
+ * the value is q * scale + bias. Keeping the scale and bias in the row makes
+ * a lookup touch a single contiguous piece of memory.
+ */
+class EmbeddingBagForward : public OperatorBase {
+    DEF_OPR_IMPL(EmbeddingBagForward, OperatorBase, 3, 1);
+    DEF_OPR_PARAM(EmbeddingBag);
+
+public:
+    /**
+     * \param[in] weight (N, D) of Float32 or Float16, or (N, D + 8) of Uint8
+     *      for quantized rows
+     * \param[in] indices (L) of Int32, each in [0, N)
+     * \param[in] offsets (B) of Int32, non-decreasing and in [0, L]
+     * \param[out] dst (B, D) of Float32
+     *
+     * All tensors must be contiguous.
+     */
+    virtual void exec(
+            _megdnn_tensor_in weight, _megdnn_tensor_in indices,
+            _megdnn_tensor_in offsets, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& weight, const TensorLayout& indices,
+            const TensorLayout& offsets, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& weight, const TensorLayout& indices,
+            const TensorLayout& offsets, const TensorLayout& dst) = 0;
+
+    //! number of bytes appended to each quantized row
+    static constexpr size_t QUANT_ROW_EXTRA_BYTES = 8;
+
+protected:
+    void check_exec(
+            const TensorLayout& weight, const TensorLayout& indices,
+            const TensorLayout& offsets, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using EmbeddingBag = EmbeddingBagForward;
+
 /*!
  * \brief base class for indexing on multiple axes using vector indices
  *
@@ -1192,12 +1250,25 @@ public:
     size_t get_workspace_in_bytes(
             const TensorShape& value, const size_t* axes, size_t nr_axes);
 
+    /*!
+     * \brief require the result to be reproducible if index values overlap
+     *
+     * Backends that accumulate by atomics would switch to a slower but
+     * order-preserving implementation.
+     */
+    void set_deterministic(bool flag) { m_deterministic = flag; }
+
+    bool deterministic() const { return m_deterministic; }
+
 protected:
     ExecInfo check_exec(
             const TensorLayout& data, const TensorLayout& value, const IndexDesc& index,
             size_t workspace_in_bytes);
 
     virtual size_t get_workspace_in_bytes(size_t value_idx_size) = 0;
+
+private:
+    bool m_deterministic = false;
 };
 
 //! set value to indexed locations; index values must be non-overlapping
@@ -1358,6 +1429,33 @@ protected:
             size_t workspace_in_bytes);
 };
 
+/*!
+ * \brief check whether any of the inputs contains inf or nan value.
+ *
+ * All the inputs must be contiguous float32 tensors; they are multiplied by
+ * param().scale inplace while being checked, so a gradient scaler can unscale
+ * and check all its gradients in one call. The inputs are only read if the
+ * scale is 1. dst is a single int32 flag.
+ */
+class CheckNonFiniteV2 : public OperatorBase {
+    DEF_OPR_PARAM(CheckNonFiniteV2);
+    DEF_OPR_IMPL(CheckNonFiniteV2, OperatorBase, -1, 1);
+
+public:
+    virtual size_t get_workspace_in_bytes(
+            const TensorNDArray& srcs, const TensorLayout& dst) = 0;
+
+    void deduce_layout(const TensorLayoutArray& srcs, TensorLayout& dst);
+
+    virtual void exec(
+            _megdnn_in const TensorNDArray& srcs, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+
+protected:
+    void check_exec(
+            const TensorNDArray& srcs, const TensorND& dst, size_t workspace_in_bytes);
+};
+
 /*!
  * \brief fill the tensor with a scalar value
  */
@@ -161,6 +161,92 @@ protected:
 };
 using Dot = DotForward;
 
+/*!
+ * \brief product of a block sparse matrix A and a batch of dense matrices
+ *
+ * A of shape (M, K) is stored in block compressed sparse row (BSR) format:
+ * the nnz non-zero blocks of (block_h, block_w) elements are stored row block
+ * by row block in values, the block column of each block is in col_idx, and
+ * the blocks of row block i are [row_ptr[i], row_ptr[i + 1]). The block
+ * columns in a row block do not have to be sorted.
+ */
+class BlockSparseMatrixMulForward : public OperatorBase {
+    DEF_OPR_IMPL(BlockSparseMatrixMulForward, OperatorBase, 4, 1);
+    DEF_OPR_PARAM(BlockSparseMatrixMul);
+
+public:
+    /**
+     * \param[in] values (nnz, block_h, block_w)
+     * \param[in] col_idx (nnz) of Int32
+     * \param[in] row_ptr (M / block_h + 1) of Int32
+     * \param[in] src (B, K, N) for SPARSE_DENSE and (B, N, K) for
+     *      DENSE_SPARSE_T; the batch axis can be omitted
+     * \param[out] dst (B, M, N) for SPARSE_DENSE and (B, N, M) for
+     *      DENSE_SPARSE_T
+     *
+     * All tensors must be contiguous, and values, src and dst must be of the
+     * same floating point dtype.
+     */
+    virtual void exec(
+            _megdnn_tensor_in values, _megdnn_tensor_in col_idx,
+            _megdnn_tensor_in row_ptr, _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& values, const TensorLayout& col_idx,
+            const TensorLayout& row_ptr, const TensorLayout& src, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& values, const TensorLayout& col_idx,
+            const TensorLayout& row_ptr, const TensorLayout& src,
+            const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& values, const TensorLayout& col_idx,
+            const TensorLayout& row_ptr, const TensorLayout& src,
+            const TensorLayout& dst, size_t workspace_in_bytes);
+};
+using BlockSparseMatrixMul = BlockSparseMatrixMulForward;
+
+/*!
+ * \brief dst = src * (weight * scale)^T, where the weight is quantized per
+ *      output channel to signed integers of 8 or 4 bits
+ *
+ * The weight is dequantized in registers, so only the quantized values are
+ * read from memory; this is meant for memory bound matmuls with few rows of
+ * activations.
+ */
+class WeightQuantMatrixMulForward : public OperatorBase {
+    DEF_OPR_IMPL(WeightQuantMatrixMulForward, OperatorBase, 3, 1);
+    DEF_OPR_PARAM(WeightQuantMatrixMul);
+
+public:
+    /**
+     * \param[in] src (M, K) of floating point dtype
+     * \param[in] weight (N, K) of Int8 for 8 bits, or (N, (K + 1) / 2) of
+     *      Int8 holding packed 4-bit values for 4 bits
+     * \param[in] scale (N) of Float32
+     * \param[out] dst (M, N) of the dtype of src
+     *
+     * All tensors must be contiguous.
+     */
+    virtual void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in weight, _megdnn_tensor_in scale,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& src, const TensorLayout& weight,
+            const TensorLayout& scale, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& weight,
+            const TensorLayout& scale, const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& src, const TensorLayout& weight,
+            const TensorLayout& scale, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using WeightQuantMatrixMul = WeightQuantMatrixMulForward;
+
 /*!
  * \brief Compute the singular value decomposition of a batch of matrices
  *
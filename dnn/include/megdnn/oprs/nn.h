@@ -1009,6 +1009,9 @@ public:
      * \param[out] batch_inv_variance (see m_param.ParamDim)
      *   Optionally cached intermediate variance from forward pass
      * \param[out] reserve (see cudnnBatchNormalizationForwardTrainingEx)
+     *   If m_param.nonlineMode is RELU, dst = max(dst, 0) is fused; in
+     *   training, a bitmask of dst > 0 is kept at the head of reserve so
+     *   that BNBackward needs no output of the relu.
      * src and dst must have the same shape.
      * src and dst must be contiguous.
      */
@@ -1141,6 +1144,278 @@ protected:
             const TensorLayout& grad, size_t workspace_in_bytes);
 };
 
+class SoftmaxBase : public OperatorBase {
+    DEF_OPR_IMPL_CTOR(SoftmaxBase, OperatorBase);
+    DEF_OPR_PARAM(Softmax);
+
+public:
+    //! get the non-negative softmax axis for a tensor of given ndim
+    size_t get_axis(size_t ndim) const;
+
+protected:
+    void check_layout_fwd(const TensorLayout& src, const TensorLayout& dst);
+};
+
+class SoftmaxForward : public SoftmaxBase {
+    DEF_OPR_IMPL(SoftmaxForward, SoftmaxBase, 1, 1);
+
+public:
+    /**
+     * \param[in] src input tensor
+     * \param[out] dst exp(src - max(src)) / sum(exp(src - max(src))) along
+     *      param().axis
+     *
+     * src and dst must be contiguous and of the same layout.
+     */
+    virtual void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(const TensorLayout& src, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& src, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using Softmax = SoftmaxForward;
+
+class SoftmaxBackward : public SoftmaxBase {
+    DEF_OPR_IMPL(SoftmaxBackward, SoftmaxBase, 2, 1);
+
+public:
+    /**
+     * \param[in] dst the `dst' parameter in SoftmaxForward::exec
+     * \param[in] diff the backpropagated gradient wrt. dst
+     * \param[out] grad the backpropagated gradient wrt. src, which is
+     *      (diff - sum(diff * dst)) * dst
+     *
+     * All tensors should be contiguous and of the same layout.
+     */
+    virtual void exec(
+            _megdnn_tensor_in dst, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+            _megdnn_workspace workspace) = 0;
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& dst, const TensorLayout& diff,
+            const TensorLayout& grad) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& dst, const TensorLayout& diff,
+            const TensorLayout& grad, size_t workspace_in_bytes);
+};
+
+class LayerNormBase : public OperatorBase {
+    DEF_OPR_IMPL_CTOR(LayerNormBase, OperatorBase);
+    DEF_OPR_PARAM(LayerNorm);
+
+protected:
+    void deduce_layout_fwd(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, TensorLayout& dst, TensorLayout& mean,
+            TensorLayout& rstd);
+    void check_layout_fwd(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            const TensorLayout& mean, const TensorLayout& rstd);
+};
+
+class LayerNormForward : public LayerNormBase {
+    DEF_OPR_IMPL(LayerNormForward, LayerNormBase, 3, 3);
+
+public:
+    /**
+     * \param[in] data input tensor whose last param().normalized_dim axes are
+     *      normalized
+     * \param[in] weight scale of the normalized axes; only used if
+     *      param().affine
+     * \param[in] bias offset of the normalized axes; only used if
+     *      param().affine
+     * \param[out] dst (data - mean) * rstd * weight + bias
+     * \param[out] mean float32 mean over the normalized axes
+     * \param[out] rstd float32 1 / sqrt(var + eps) over the normalized axes
+     *
+     * weight and bias may be empty tensors if param().affine is false.
+     */
+    virtual void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, TensorLayout& dst, TensorLayout& mean,
+            TensorLayout& rstd);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            const TensorLayout& mean, const TensorLayout& rstd) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            const TensorLayout& mean, const TensorLayout& rstd,
+            size_t workspace_in_bytes);
+};
+using LayerNorm = LayerNormForward;
+
+class LayerNormBackward : public LayerNormBase {
+    DEF_OPR_IMPL(LayerNormBackward, LayerNormBase, 5, 3);
+
+public:
+    /**
+     * \param[in] diff the backpropagated gradient wrt. dst
+     * \param[in] data, weight, mean, rstd the corresponding tensors in
+     *      LayerNormForward::exec
+     * \param[out] ddata the backpropagated gradient wrt. data
+     * \param[out] dweight, dbias the backpropagated gradient wrt. weight and
+     *      bias; only written if param().affine
+     */
+    virtual void exec(
+            _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+            _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+            _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& diff, const TensorLayout& data,
+            const TensorLayout& weight, const TensorLayout& mean,
+            const TensorLayout& rstd, TensorLayout& ddata, TensorLayout& dweight,
+            TensorLayout& dbias);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& diff, const TensorLayout& data,
+            const TensorLayout& weight, const TensorLayout& mean,
+            const TensorLayout& rstd, const TensorLayout& ddata,
+            const TensorLayout& dweight, const TensorLayout& dbias) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& diff, const TensorLayout& data,
+            const TensorLayout& weight, const TensorLayout& mean,
+            const TensorLayout& rstd, const TensorLayout& ddata,
+            const TensorLayout& dweight, const TensorLayout& dbias,
+            size_t workspace_in_bytes);
+};
+
+class GroupNormBase : public OperatorBase {
+    DEF_OPR_IMPL_CTOR(GroupNormBase, OperatorBase);
+    DEF_OPR_PARAM(GroupNorm);
+
+protected:
+    void deduce_layout_fwd(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, TensorLayout& dst, TensorLayout& mean,
+            TensorLayout& rstd);
+    void check_layout_fwd(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            const TensorLayout& mean, const TensorLayout& rstd);
+};
+
+class GroupNormForward : public GroupNormBase {
+    DEF_OPR_IMPL(GroupNormForward, GroupNormBase, 3, 3);
+
+public:
+    /**
+     * \param[in] data (N, C, ...) tensor whose channels are divided into
+     *      param().group groups, each of which is normalized separately
+     * \param[in] weight (C,) per-channel scale; only used if param().affine
+     * \param[in] bias (C,) per-channel offset; only used if param().affine
+     * \param[out] dst (data - mean) * rstd * weight + bias
+     * \param[out] mean (N, group) float32 mean of each group
+     * \param[out] rstd (N, group) float32 1 / sqrt(var + eps) of each group
+     *
+     * weight and bias may be empty tensors if param().affine is false.
+     */
+    virtual void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, TensorLayout& dst, TensorLayout& mean,
+            TensorLayout& rstd);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            const TensorLayout& mean, const TensorLayout& rstd) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            const TensorLayout& mean, const TensorLayout& rstd,
+            size_t workspace_in_bytes);
+};
+using GroupNorm = GroupNormForward;
+
+class GroupNormBackward : public GroupNormBase {
+    DEF_OPR_IMPL(GroupNormBackward, GroupNormBase, 5, 3);
+
+public:
+    //! see LayerNormBackward::exec
+    virtual void exec(
+            _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+            _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+            _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& diff, const TensorLayout& data,
+            const TensorLayout& weight, const TensorLayout& mean,
+            const TensorLayout& rstd, TensorLayout& ddata, TensorLayout& dweight,
+            TensorLayout& dbias);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& diff, const TensorLayout& data,
+            const TensorLayout& weight, const TensorLayout& mean,
+            const TensorLayout& rstd, const TensorLayout& ddata,
+            const TensorLayout& dweight, const TensorLayout& dbias) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& diff, const TensorLayout& data,
+            const TensorLayout& weight, const TensorLayout& mean,
+            const TensorLayout& rstd, const TensorLayout& ddata,
+            const TensorLayout& dweight, const TensorLayout& dbias,
+            size_t workspace_in_bytes);
+};
+
+/*!
+ * \brief softmax(query * key^T * scale) * value along the key axis, computed
+ *      tile by tile without materializing the attention scores
+ *
+ * Multiple attention heads should be folded into the batch axis.
+ */
+class FusedAttentionForward : public OperatorBase {
+    DEF_OPR_IMPL(FusedAttentionForward, OperatorBase, 3, 1);
+    DEF_OPR_PARAM(FusedAttention);
+
+public:
+    /**
+     * \param[in] query (B, S, D)
+     * \param[in] key (B, T, D)
+     * \param[in] value (B, T, Dv)
+     * \param[out] dst (B, S, Dv)
+     *
+     * All tensors must be contiguous and of the same floating point dtype.
+     */
+    virtual void exec(
+            _megdnn_tensor_in query, _megdnn_tensor_in key, _megdnn_tensor_in value,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& query, const TensorLayout& key,
+            const TensorLayout& value, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& query, const TensorLayout& key,
+            const TensorLayout& value, const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& query, const TensorLayout& key,
+            const TensorLayout& value, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using FusedAttention = FusedAttentionForward;
+
 class ROIPoolingBase : public OperatorBase {
     DEF_OPR_IMPL_CTOR(ROIPoolingBase, OperatorBase);
     DEF_OPR_PARAM(ROIPooling);
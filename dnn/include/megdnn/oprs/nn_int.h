@@ -61,6 +61,41 @@ protected:
             const TensorLayoutPtrArray& src, const TensorLayout& dst);
 };
 
+/*!
+ * \brief elemwise oprs writing two outputs, so that intermediate results
+ *      needed by other readers are not recomputed by another kernel
+ *
+ * The inputs are broadcast to a common shape, and both outputs have that
+ * shape and the dtype of the inputs.
+ */
+class ElemwiseMultiOutput : public OperatorBase {
+    DEF_OPR_PARAM(ElemwiseMultiOutput);
+    DEF_OPR_IMPL(ElemwiseMultiOutput, OperatorBase, -1, 2);
+
+public:
+    using Mode = Param::Mode;
+
+    //! number of inputs needed by a mode
+    static size_t nr_inputs(Mode mode);
+
+    virtual void exec(
+            _megdnn_in const TensorNDArray& src,
+            _megdnn_out const TensorNDArray& dst) = 0;
+
+    //! deduce layouts of the two outputs
+    void deduce_layout(const TensorLayoutArray& src, TensorLayoutArray& dst);
+
+protected:
+    /*!
+     * \brief throw exception if incorrect layout; broadcast inputs to
+     *      output shape
+     *
+     * \param dst layout of each of the two outputs, which must be the same
+     */
+    void check_layout_and_broadcast(
+            const TensorLayoutPtrArray& src, const TensorLayout& dst);
+};
+
 }  // namespace megdnn
 
 #include "megdnn/internal/opr_header_epilogue.h"
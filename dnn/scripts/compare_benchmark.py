@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""compare a benchmark corpus dump against a stored baseline
+
+Both files are written by the ``BENCHMARK_CORPUS`` tests of megdnn_test with
+``MEGDNN_BENCHMARK_JSON`` set. A record is reported as a regression when its
+median slows down by more than ``--threshold`` and the difference is
+significant under a one-sided Mann-Whitney U test, so that noisy kernels do
+not trigger on a single slow sample. The exit status is non-zero if any
+regression is found.
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+def load(path):
+    with open(path) as fin:
+        data = json.load(fin)
+    records = {}
+    for r in data['records']:
+        key = (r.get('suite', ''), r['opr'], r['model'], r['shapes'],
+               r['dtype'], r['algo'])
+        records[key] = r['samples']
+    return data['info'], records
+
+
+def median(samples):
+    s = sorted(samples)
+    n = len(s)
+    return s[n // 2] if n % 2 else (s[n // 2 - 1] + s[n // 2]) / 2
+
+
+def mann_whitney_p(base, cur):
+    """p-value of the hypothesis that cur is not slower than base"""
+    n1, n2 = len(base), len(cur)
+    ranked = sorted([(v, 0) for v in base] + [(v, 1) for v in cur])
+    ranks = [0.0] * len(ranked)
+    i = 0
+    while i < len(ranked):
+        j = i
+        while j + 1 < len(ranked) and ranked[j + 1][0] == ranked[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        i = j + 1
+    r2 = sum(r for r, (_, g) in zip(ranks, ranked) if g == 1)
+    u = r2 - n2 * (n2 + 1) / 2
+    mu = n1 * n2 / 2
+    sigma = math.sqrt(n1 * n2 * (n1 + n2 + 1) / 12)
+    if sigma == 0:
+        return 1.0
+    z = (u - mu - 0.5) / sigma
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('baseline', help='baseline json dump')
+    parser.add_argument('current', help='current json dump')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='relative slowdown of median to tolerate')
+    parser.add_argument('--alpha', type=float, default=0.01,
+                        help='significance level of the rank test')
+    parser.add_argument('--show-all', action='store_true',
+                        help='print every record, not only regressions')
+    args = parser.parse_args()
+
+    base_info, base = load(args.baseline)
+    cur_info, cur = load(args.current)
+    for k in sorted(set(base_info) | set(cur_info)):
+        if base_info.get(k) != cur_info.get(k) and k != 'time':
+            print('warning: {} differs: {!r} vs {!r}'.format(
+                k, base_info.get(k), cur_info.get(k)))
+
+    nr_regression = 0
+    for key in sorted(set(base) & set(cur)):
+        b, c = base[key], cur[key]
+        ratio = median(c) / max(median(b), 1e-9)
+        p = mann_whitney_p(b, c)
+        regressed = ratio > 1 + args.threshold and p < args.alpha
+        nr_regression += regressed
+        if regressed or args.show_all:
+            print('{} {:.3f}x p={:.4f} {}'.format(
+                'REGRESSION' if regressed else 'ok', ratio, p, ' '.join(key)))
+    for key in sorted(set(base) - set(cur)):
+        print('missing: {}'.format(' '.join(key)))
+
+    print('{} regression(s) in {} common records'.format(
+        nr_regression, len(set(base) & set(cur))))
+    return 1 if nr_regression else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
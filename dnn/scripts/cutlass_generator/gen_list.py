@@ -10,6 +10,7 @@ class GenArg:
     def __init__(self, gen_op, gen_type):
         self.operations = gen_op
         self.type = gen_type
+        self.tiles = "default"
 
 
 def write_op_list(f, gen_op, gen_type):
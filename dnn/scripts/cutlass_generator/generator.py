@@ -12,6 +12,7 @@ import platform
 
 from library import *
 from manifest import *
+from tile_catalog import *
 ###################################################################################################
 
 #
@@ -232,15 +233,7 @@ def GenerateConv2d_TensorOp_8816(args):
     for layout in layouts:
       for dst_type, dst_layout in zip(dst_types, dst_layouts):
         if dst_layout == LayoutType.TensorNC32HW32:
-          tile_descriptions = [
-            TileDescription([128, 256, 64], 2, [2, 4, 1], math_inst, min_cc, max_cc),
-            TileDescription([256, 128, 64], 2, [4, 2, 1], math_inst, min_cc, max_cc),
-            TileDescription([128, 128, 64], 2, [2, 2, 1], math_inst, min_cc, max_cc),
-            TileDescription([128,  64, 64], 2, [2, 2, 1], math_inst, min_cc, max_cc),
-            TileDescription([ 64, 128, 64], 2, [2, 2, 1], math_inst, min_cc, max_cc),
-            TileDescription([128,  64, 32], 1, [2, 2, 1], math_inst, min_cc, max_cc),
-            TileDescription([128,  32, 32], 1, [2, 1, 1], math_inst, min_cc, max_cc),
-          ] 
+          tile_descriptions = SelectConvTiles('nchw32_s8', args.tiles, math_inst, min_cc, max_cc)
           operations += GenerateConv2d(ConvKind.Fprop, tile_descriptions, layout[0], layout[1], 
                                      dst_layout, dst_type, min_cc, 128, 128, 64, use_special_optimization, 
                                      ImplicitGemmMode.GemmTN, True, cuda_major, cuda_minor)
@@ -342,12 +335,7 @@ def GenerateConv2d_TensorOp_8832(args):
     for layout in layouts:
       for dst_layout in dst_layouts:
         dst_type = math_inst.element_b
-        tile_descriptions = [
-          TileDescription([128, 256, 128], 2, [2, 4, 1], math_inst, min_cc, max_cc),
-          TileDescription([128, 128, 128], 2, [2, 2, 1], math_inst, min_cc, max_cc),
-          TileDescription([128, 64, 128], 2, [2, 1, 1], math_inst, min_cc, max_cc),
-          TileDescription([128, 64, 64], 1, [2, 1, 1], math_inst, min_cc, max_cc),
-        ] 
+        tile_descriptions = SelectConvTiles('nchw64_s4', args.tiles, math_inst, min_cc, max_cc)
         operations += GenerateConv2d(ConvKind.Fprop, tile_descriptions, layout[0], layout[1], 
                                      dst_layout, dst_type, min_cc, 128, 128, 64, use_special_optimization, 
                                      ImplicitGemmMode.GemmTN, True, cuda_major, cuda_minor)
@@ -900,6 +888,9 @@ if __name__ == "__main__":
   parser.add_argument("output", type=str, help="output directory for CUTLASS kernel files")
   parser.add_argument("--type", type=str, choices=['simt', 'tensorop8816', 'tensorop8832', 'tensorop884', 'tensorop1688'], 
                       default='simt', help="kernel type of CUTLASS kernel generator")
+  parser.add_argument("--tiles", type=str, default='default', 
+                      help="tiles of the NCHW32 int8 and NCHW64 int4 convolutions to generate, "
+                           "'default', 'all' or a comma separated list of tile names like 128x128_64x2")
 
   gemv_wrapper_path = "src/cuda/matrix_mul/cutlass_matrix_mul_wrapper_batched_gemv_strided.cuinl"
   short_path = (platform.system() == "Windows" or platform.system().find('NT') >= 0) and ('true'!= os.getenv("CUTLASS_WITH_LONG_PATH", default='False').lower())
@@ -0,0 +1,86 @@
+#
+# \file tile_catalog.py
+#
+# \brief Catalog of the threadblock configurations of the implicit gemm convolutions
+#
+
+from library import *
+
+###################################################################################################
+#
+# Each entry is (threadblock_shape, stages, warp_count). The 'default' tiles are the ones which
+# have always been built, the 'extended' tiles widen the space searched by fast-run, e.g. for
+# narrow or wide output channels and shallow reduction on A100/T4.
+#
+# \note the algorithms of dnn/src/cuda/conv_bias/algo.cpp are registered for every tile of the
+# catalog, and an algorithm whose kernel is not built is reported as unavailable. Please keep
+# both lists in sync.
+#
+###################################################################################################
+
+ConvTileCatalog = {
+  # int8 NCHW32 IMMA, instruction shape 8x8x16
+  'nchw32_s8': {
+    'default': [
+      ([128, 256, 64], 2, [2, 4, 1]),
+      ([256, 128, 64], 2, [4, 2, 1]),
+      ([128, 128, 64], 2, [2, 2, 1]),
+      ([128,  64, 64], 2, [2, 2, 1]),
+      ([ 64, 128, 64], 2, [2, 2, 1]),
+      ([128,  64, 32], 1, [2, 2, 1]),
+      ([128,  32, 32], 1, [2, 1, 1]),
+    ],
+    'extended': [
+      ([256,  64, 64], 2, [4, 1, 1]),
+      ([ 64, 256, 64], 2, [1, 4, 1]),
+      ([ 64,  64, 64], 2, [2, 1, 1]),
+      ([128, 128, 32], 1, [2, 2, 1]),
+      ([ 64,  64, 32], 1, [2, 1, 1]),
+    ],
+  },
+  # int4 NCHW64 IMMA, instruction shape 8x8x32
+  'nchw64_s4': {
+    'default': [
+      ([128, 256, 128], 2, [2, 4, 1]),
+      ([128, 128, 128], 2, [2, 2, 1]),
+      ([128,  64, 128], 2, [2, 1, 1]),
+      ([128,  64,  64], 1, [2, 1, 1]),
+    ],
+    'extended': [
+      ([256, 128, 128], 2, [4, 2, 1]),
+      ([256,  64, 128], 2, [4, 1, 1]),
+      ([ 64, 128, 128], 2, [1, 2, 1]),
+      ([ 64,  64, 128], 2, [1, 1, 1]),
+      ([128, 128,  64], 1, [2, 2, 1]),
+    ],
+  },
+}
+
+#
+def TileName(threadblock_shape, stages):
+  return "%dx%d_%dx%d" % (threadblock_shape[0], threadblock_shape[1], threadblock_shape[2], stages)
+
+#
+def SelectConvTiles(catalog_name, tiles, math_inst, min_cc, max_cc):
+  """Returns the TileDescriptions of a catalog selected by the --tiles argument
+
+  tiles is 'default', 'all', or a comma separated list of tile names such as 128x128_64x2, which
+  is the threadblock shape and the number of stages as in the kernel names. Only the tiles of
+  the list which belong to this catalog are selected.
+  """
+  catalog = ConvTileCatalog[catalog_name]
+  entries = catalog['default'] + catalog['extended']
+  if tiles == 'default':
+    entries = catalog['default']
+  elif tiles != 'all':
+    names = [x for x in tiles.split(',') if x != '']
+    known = set(TileName(shape, stages) for tables in ConvTileCatalog.values() \
+                                        for group in tables.values() \
+                                        for shape, stages, _ in group)
+    unknown = [x for x in names if x not in known]
+    assert len(unknown) == 0, "unknown tiles: {}".format(", ".join(unknown))
+    entries = [x for x in entries if TileName(x[0], x[1]) in names]
+  return [TileDescription(shape, stages, warp_count, math_inst, min_cc, max_cc) \
+          for shape, stages, warp_count in entries]
+
+###################################################################################################
@@ -270,6 +270,36 @@ pdef('Axis').add_fields('int32', 'axis', 0)
  add_fields('float32', 'k', '2.f', 'alpha', '1e-4f', 'beta', '0.75f')
 )
 
+(pdef('Softmax').
+ add_fields('int32',
+            Doc('axis', 'axis along which softmax is computed; negative values '
+                'count from the last axis'), -1)
+)
+
+(pdef('LayerNorm').
+ add_fields('bool', Doc('affine', 'whether to apply the elementwise affine '
+                        'transform given by weight and bias'), 'true').
+ add_fields('float32', 'eps', '1e-5f').
+ add_fields('uint64',
+            Doc('normalized_dim', 'number of trailing axes to be normalized'),
+            '1',
+            Doc('normalized_size', 'product of the normalized axes'), '1')
+)
+
+(pdef('GroupNorm').
+ add_fields('bool', Doc('affine', 'whether to apply the per-channel affine '
+                        'transform given by weight and bias'), 'true').
+ add_fields('float32', 'eps', '1e-5f').
+ add_fields('uint32',
+            Doc('group', 'number of groups the channels are divided into'), '1')
+)
+
+(pdef('FusedAttention').
+ add_fields('float32',
+            Doc('scale', 'factor applied to query * key^T before softmax'),
+            '1.f')
+)
+
 (pdef('BN').
  add_enum(
      'ParamDim',
@@ -288,7 +318,8 @@ pdef('Axis').add_fields('int32', 'axis', 0)
  add_fields('float64', 'epsilon', '1e-4f').
  add_fields('float64', 'avg_factor', '1.f').
  add_fields('float32', 'scale', '1.f').
- add_fields('float32', 'bias', '0.f')
+ add_fields('float32', 'bias', '0.f').
+ add_enum_alias('NonlineMode', 'ConvBiasV0')
 )
 
 (pdef('ROIPooling').
@@ -500,6 +531,15 @@ pdef('ElemwiseMultiType').add_enum(
     Doc('QH_SWISH_GRAD = 53', 'quantized h_swish_grad')
 )
 
+(pdef('ElemwiseMultiOutput', 'elemwise computation writing two outputs in one pass').
+ add_enum('Mode',
+          Doc('SIGMOID_MUL = 0', 'inputs ``(x, y)``; outputs ``s = sigmoid(x)`` '
+              'and ``s * y``'),
+          Doc('MOMENTUM_UPDATE = 1', 'inputs ``(param, buf, grad)``; outputs '
+              '``param - lr * buf1`` and ``buf1 = momentum * buf + grad``')).
+ add_fields('float32', Doc('momentum', 'used by MOMENTUM_UPDATE'), '0.f',
+            Doc('lr', 'used by MOMENTUM_UPDATE'), '0.f'))
+
 pdef('PowC', 'power with constant exponent').add_fields('float32', 'exp', 0)
 
 (pdef('DctChannelSelect', '2d discrete cosine transform', version=0, is_legacy=True).add_enum_alias('Format', 'ConvolutionV0').
@@ -547,6 +587,26 @@ pdef('PowC', 'power with constant exponent').add_fields('float32', 'exp', 0)
               'layout is (K/4, M/4, 4(m), 4(k)) x (K/4, N, 4(k))'))
  )
 
+(pdef('BlockSparseMatrixMul').
+ add_enum('Mode',
+          Doc('SPARSE_DENSE = 0', 'dst[b] = A * src[b], where src is (B, K, N) '
+              'and dst is (B, M, N)'),
+          Doc('DENSE_SPARSE_T = 1', 'dst[b] = src[b] * A^T, where src is '
+              '(B, N, K) and dst is (B, N, M)')).
+ add_fields('uint32',
+            Doc('block_h', 'number of rows of the blocks of the sparse matrix '
+                'A of shape (M, K)'), '1',
+            Doc('block_w', 'number of columns of the blocks of the sparse '
+                'matrix A'), '4')
+ )
+
+(pdef('WeightQuantMatrixMul').
+ add_fields('uint32',
+            Doc('bits', 'number of bits of the quantized weight, which is 8 '
+                'or 4; two 4-bit values are packed into a byte with the first '
+                'in the lower half'), '8')
+ )
+
 (pdef('SVD').
  add_fields('bool',
             Doc('full_matrices',
@@ -715,6 +775,13 @@ pdef('Argsort').add_enum('Order', 'ASCENDING = 0', 'DESCENDING = 1')
                 ' atomic adding operations could be avoided.'),
             'false'))
 
+(pdef('EmbeddingBag').
+ add_enum('Mode',
+          Doc('SUM = 0', 'sum of the rows of each bag'),
+          Doc('MEAN = 1', 'mean of the rows of each bag, which is zeros for '
+              'empty bags'))
+ )
+
 pdef('Sleep').add_fields('float32', Doc('time', 'time to sleep in seconds'), 0)
 
 (pdef('Linspace').
@@ -812,6 +879,14 @@ pdef('Sleep').add_fields('float32', Doc('time', 'time to sleep in seconds'), 0)
                   ('YUV2GRAY_YU12', 'BT601_YUV2GRAY_YU12')],
     name_field = 'mode'))
 
+(pdef('ImagePreprocess', 'fused color conversion, resize and per-channel affine '
+      'normalization of uint8 images')
+ .add_enum('Mode', Doc('RGB = 0', 'three-channel image kept in its channel order'),
+           'RGB2BGR = 1', 'YUV2RGB_NV21 = 2', 'YUV2BGR_NV21 = 3', 'YUV2RGB_NV12 = 4',
+           'YUV2BGR_NV12 = 5', name_field='mode')
+ .add_enum_alias('InterpolationMode', 'WarpPerspectiveV1', name_field='imode')
+ .add_enum_alias('Format', 'Convolution'))
+
 (pdef('WarpAffine', version=0, is_legacy=True)
  .add_enum_alias('InterpolationMode', 'WarpPerspectiveV1', name_field='imode')
  .add_enum_alias('BorderMode', 'WarpPerspectiveV1', name_field='border_mode')
@@ -1176,6 +1251,11 @@ Note: NCHW_NCHW4_WEIGHT will auto pad oc and ic, you should remove oc in later o
  )
 pdef('Fill').add_fields('float32', 'value', '0')
 
+(pdef('CheckNonFiniteV2').
+ add_fields('float32', Doc('scale', 'the inputs are multiplied by scale inplace '
+                           'while being checked'), '1.0')
+ )
+
 
 PADDING_MODES = [Doc('REPLICATE = 0', 'aaaaaa|abcdefgh|hhhhhhh'),
                 Doc('REFLECT = 1', 'fedcba|abcdefgh|hgfedcb'),
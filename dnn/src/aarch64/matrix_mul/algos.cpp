@@ -11,16 +11,20 @@
  */
 
 #include "src/aarch64/matrix_mul/algos.h"
+#include "src/aarch64/matrix_mul/bf16/strategy.h"
 #include "src/aarch64/matrix_mul/fp16/strategy.h"
 #include "src/aarch64/matrix_mul/fp32/strategy.h"
 #include "src/aarch64/matrix_mul/int16/strategy.h"
 #include "src/aarch64/matrix_mul/int4x4x16/strategy.h"
 #include "src/aarch64/matrix_mul/int8/strategy.h"
 #include "src/aarch64/matrix_mul/int8_dot/strategy.h"
+#include "src/aarch64/matrix_mul/int8_i8mm/strategy.h"
 #include "src/aarch64/matrix_mul/int8x8x16/strategy.h"
 #include "src/aarch64/matrix_mul/quint8/strategy.h"
 #include "src/aarch64/matrix_mul/quint8_dot/gemv.h"
 #include "src/aarch64/matrix_mul/quint8_dot/strategy.h"
+#include "src/aarch64/sve/sgemm.h"
+#include "src/common/cpuinfo_arch_vendor.h"
 #include "src/common/utils.h"
 #include "src/fallback/matrix_mul/gemm_impl.h"
 
@@ -251,6 +255,44 @@ MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32MK4_4x16::get_kern(
     return f32_kern_mk4_4x16;
 }
 
+#if MGB_ENABLE_SVE
+/* ===================== F32 SVE 8xVL algo ===================== */
+namespace {
+void f32_sve_8xvl_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_aarch64_matmul_kern, midout_iv("f32_sve_8xvl_kern"_hash)) {
+        auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        const auto Aptr = kern_param.A<float>(), Bptr = kern_param.B<float>();
+        auto Cptr = kern_param.C<float>();
+        aarch64::sve::sgemm_8xvl(
+                Aptr, LDA, Bptr, LDB, Cptr, LDC, M, N, K, kern_param.trA,
+                kern_param.trB, kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+}  // anonymous namespace
+
+bool MatrixMulImpl::AlgoF32SVE8xVL::usable(const KernSizeParam& kern_size_param) const {
+    return kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           kern_size_param.C_type == dtype::Float32() &&
+           kern_size_param.B_type == dtype::Float32() &&
+           kern_size_param.A_type == dtype::Float32() &&
+           kern_size_param.format == param::MatrixMul::Format::DEFAULT &&
+           aarch64::sve::preferred();
+}
+
+size_t MatrixMulImpl::AlgoF32SVE8xVL::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return aarch64::sve::sgemm_8xvl_workspace(
+            kern_size_param.M, kern_size_param.N, kern_size_param.K);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32SVE8xVL::get_kern(
+        const KernSizeParam&) const {
+    return f32_sve_8xvl_kern;
+}
+#endif
+
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC
 /* ===================== F16 K8x24x1 algo ===================== */
 namespace {
@@ -496,6 +538,197 @@ MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
         int8_t, int32_t, AlgoDataType::QINT8X8X32, MK4_DOT);
 #endif
 
+#if MGB_ENABLE_I8MM
+/* ===================== Int8x8x32 K8x12x8 I8MM algo ===================== */
+namespace {
+void int8x8x32_k8x12x8_i8mm_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(
+            megdnn_aarch64_matmul_kern, midout_iv("int8x8x32_k8x12x8_i8mm_kern"_hash)) {
+        auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        auto trA = kern_param.trA, trB = kern_param.trB;
+        auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        auto A_type = kern_param.A_type, B_type = kern_param.B_type,
+             C_type = kern_param.C_type;
+        const auto Aptr = kern_param.A<dt_int8>(), Bptr = kern_param.B<dt_int8>();
+        auto Cptr = kern_param.C<dt_int32>();
+
+        aarch64::matmul::gemm_s8_8x12_i8mm strategy(M, N, K, A_type, B_type, C_type);
+        megdnn::matmul::GemmInterleaved<aarch64::matmul::gemm_s8_8x12_i8mm>(
+                M, N, K, trA, trB, strategy)
+                .execute(Aptr, LDA, Bptr, LDB, Cptr, LDC, kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+}  // anonymous namespace
+
+bool MatrixMulImpl::AlgoInt8x8x32K8x12x8I8MM::usable(
+        const KernSizeParam& kern_size_param) const {
+    if (!arm_has_i8mm()) {
+        return false;
+    }
+    return can_be_treated_as_int8x8x32(kern_size_param);
+}
+
+size_t MatrixMulImpl::AlgoInt8x8x32K8x12x8I8MM::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    MIDOUT_BEGIN(
+            megdnn_aarch64_matmul_kern,
+            midout_iv("AlgoInt8x8x32K8x12x8I8MM::get_workspace"_hash)) {
+        auto M = kern_size_param.M, N = kern_size_param.N, K = kern_size_param.K;
+        auto trA = kern_size_param.trA, trB = kern_size_param.trB;
+        auto A_type = kern_size_param.A_type, B_type = kern_size_param.B_type,
+             C_type = kern_size_param.C_type;
+
+        aarch64::matmul::gemm_s8_8x12_i8mm strategy(M, N, K, A_type, B_type, C_type);
+        return megdnn::matmul::GemmInterleaved<aarch64::matmul::gemm_s8_8x12_i8mm>(
+                       M, N, K, trA, trB, strategy)
+                .get_workspace_size();
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoInt8x8x32K8x12x8I8MM::get_kern(
+        const KernSizeParam&) const {
+    return int8x8x32_k8x12x8_i8mm_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoInt8x8x32K8x12x8I8MM, megdnn_aarch64_matmul_kern,
+        "AlgoInt8x8x32K8x12x8I8MMImpl"_hash, aarch64::matmul::gemm_s8_8x12_i8mm,
+        int8_t, int32_t, AlgoDataType::QINT8X8X32, DEFAULT);
+
+/* =================== Int8x8x32 MK4 8x12x8 I8MM algo =================== */
+namespace {
+void int8x8x32_mk4_8x12x8_i8mm_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(
+            megdnn_aarch64_matmul_kern,
+            midout_iv("int8x8x32_mk4_8x12x8_i8mm_kern"_hash)) {
+        auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        auto trA = kern_param.trA, trB = kern_param.trB;
+        auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        auto A_type = kern_param.A_type, B_type = kern_param.B_type,
+             C_type = kern_param.C_type;
+        const auto Aptr = kern_param.A<dt_int8>(), Bptr = kern_param.B<dt_int8>();
+        auto Cptr = kern_param.C<dt_int32>();
+
+        aarch64::matmul::gemm_mk4_s8_8x12_i8mm strategy(
+                M, N, K, A_type, B_type, C_type);
+        megdnn::matmul::GemmInterleaved<aarch64::matmul::gemm_mk4_s8_8x12_i8mm>(
+                M, N, K, trA, trB, strategy)
+                .execute(Aptr, LDA, Bptr, LDB, Cptr, LDC, kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+}  // anonymous namespace
+
+bool MatrixMulImpl::AlgoInt8x8x32MK4_8x12x8I8MM::usable(
+        const KernSizeParam& kern_size_param) const {
+    if (!arm_has_i8mm()) {
+        return false;
+    }
+
+    return kern_size_param.A_type.enumv() == kern_size_param.B_type.enumv() &&
+           (kern_size_param.A_type.enumv() == DTypeEnum::Int8 ||
+            kern_size_param.A_type.enumv() == DTypeEnum::QuantizedS8) &&
+           (kern_size_param.C_type.enumv() == DTypeEnum::Int32 ||
+            kern_size_param.C_type.enumv() == DTypeEnum::QuantizedS32) &&
+           kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           kern_size_param.format == param::MatrixMul::Format::MK4_DOT &&
+           !kern_size_param.trA && !kern_size_param.trB;
+}
+
+size_t MatrixMulImpl::AlgoInt8x8x32MK4_8x12x8I8MM::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    MIDOUT_BEGIN(
+            megdnn_aarch64_matmul_kern,
+            midout_iv("AlgoInt8x8x32MK4_8x12x8I8MM::get_workspace"_hash)) {
+        auto M = kern_size_param.M, N = kern_size_param.N, K = kern_size_param.K;
+        auto trA = kern_size_param.trA, trB = kern_size_param.trB;
+        auto A_type = kern_size_param.A_type, B_type = kern_size_param.B_type,
+             C_type = kern_size_param.C_type;
+
+        aarch64::matmul::gemm_mk4_s8_8x12_i8mm strategy(
+                M, N, K, A_type, B_type, C_type);
+        return megdnn::matmul::GemmInterleaved<
+                       aarch64::matmul::gemm_mk4_s8_8x12_i8mm>(
+                       M, N, K, trA, trB, strategy)
+                .get_workspace_size();
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoInt8x8x32MK4_8x12x8I8MM::get_kern(
+        const KernSizeParam&) const {
+    return int8x8x32_mk4_8x12x8_i8mm_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoInt8x8x32MK4_8x12x8I8MM, megdnn_aarch64_matmul_kern,
+        "AlgoInt8x8x32MK4_8x12x8I8MMImpl"_hash,
+        aarch64::matmul::gemm_mk4_s8_8x12_i8mm, int8_t, int32_t,
+        AlgoDataType::QINT8X8X32, MK4_DOT);
+
+#if !MEGDNN_DISABLE_FLOAT16
+/* ======================== BF16 K8x12x4 algo ======================== */
+namespace {
+void bf16_k8x12x4_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_aarch64_matmul_kern, midout_iv("bf16_k8x12x4_kern"_hash)) {
+        auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        auto trA = kern_param.trA, trB = kern_param.trB;
+        auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        auto A_type = kern_param.A_type, B_type = kern_param.B_type,
+             C_type = kern_param.C_type;
+        const auto Aptr = kern_param.A<dt_bfloat16>(),
+                   Bptr = kern_param.B<dt_bfloat16>();
+        auto Cptr = kern_param.C<dt_bfloat16>();
+
+        aarch64::matmul::gemm_bf16_8x12 strategy(M, N, K, A_type, B_type, C_type);
+        megdnn::matmul::GemmInterleaved<aarch64::matmul::gemm_bf16_8x12>(
+                M, N, K, trA, trB, strategy)
+                .execute(Aptr, LDA, Bptr, LDB, Cptr, LDC, kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+}  // anonymous namespace
+
+bool MatrixMulImpl::AlgoBf16K8x12x4::usable(
+        const KernSizeParam& kern_size_param) const {
+    //! accumulation is always in float32, so both compute modes are accepted
+    return arm_has_bf16() &&
+           kern_size_param.A_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.B_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.C_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.format == param::MatrixMul::Format::DEFAULT;
+}
+
+size_t MatrixMulImpl::AlgoBf16K8x12x4::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    MIDOUT_BEGIN(
+            megdnn_aarch64_matmul_kern,
+            midout_iv("AlgoBf16K8x12x4::get_workspace"_hash)) {
+        auto M = kern_size_param.M, N = kern_size_param.N, K = kern_size_param.K;
+        auto trA = kern_size_param.trA, trB = kern_size_param.trB;
+        auto A_type = kern_size_param.A_type, B_type = kern_size_param.B_type,
+             C_type = kern_size_param.C_type;
+
+        aarch64::matmul::gemm_bf16_8x12 strategy(M, N, K, A_type, B_type, C_type);
+        return megdnn::matmul::GemmInterleaved<aarch64::matmul::gemm_bf16_8x12>(
+                       M, N, K, trA, trB, strategy)
+                .get_workspace_size();
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoBf16K8x12x4::get_kern(
+        const KernSizeParam&) const {
+    return bf16_k8x12x4_kern;
+}
+#endif
+#endif
+
 /* ===================== Int8x8x32 MK4 4x4x16 algo ===================== */
 namespace {
 void int8x8x32_mk4_4x4x16_kern(const MatrixMulImpl::KernParam& kern_param) {
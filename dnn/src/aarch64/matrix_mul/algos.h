@@ -66,6 +66,20 @@ public:
     MEGDNN_DECL_ALGO_TYPE(AARCH64_F32_MK4_4x16)
 };
 
+#if MGB_ENABLE_SVE
+class MatrixMulImpl::AlgoF32SVE8xVL final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "AARCH64_F32_SVE_8XVL"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    PackMode packmode() const override { return PackMode::NO_PACK; }
+    MEGDNN_OVERRIDE_MATMUL_DESC(8, 16, 1, 4, AlgoDataType::FLOAT32, DEFAULT)
+    MEGDNN_DECL_ALGO_TYPE(AARCH64_F32_SVE_8XVL)
+};
+#endif
+
 class MatrixMulImpl::AlgoF32Gemv final : public arm_common::MatrixMulImpl::AlgoF32Gemv {
 public:
     AlgoF32Gemv() : arm_common::MatrixMulImpl::AlgoF32Gemv() {
@@ -124,6 +138,44 @@ public:
 };
 #endif
 
+#if MGB_ENABLE_I8MM
+class MatrixMulImpl::AlgoInt8x8x32K8x12x8I8MM final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "AARCH64_INT8X8X32_K8X12X8_I8MM"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(AARCH64_INT8X8X32_K8X12X8_I8MM)
+};
+
+class MatrixMulImpl::AlgoInt8x8x32MK4_8x12x8I8MM final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "AARCH64_INT8X8X32_MK4_8X12X8_I8MM"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(AARCH64_INT8X8X32_MK4_8X12X8_I8MM)
+};
+
+#if !MEGDNN_DISABLE_FLOAT16
+class MatrixMulImpl::AlgoBf16K8x12x4 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "AARCH64_BF16_K8X12X4"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    PackMode packmode() const override { return PackMode::NO_PACK; }
+    MEGDNN_OVERRIDE_MATMUL_DESC(8, 12, 4, 2, AlgoDataType::BFLOAT16, DEFAULT)
+    MEGDNN_DECL_ALGO_TYPE(AARCH64_BF16_K8X12X4)
+};
+#endif
+#endif
+
 class MatrixMulImpl::AlgoInt8x8x32MK4_4x4x16 final : public AlgoBase {
 public:
     AlgoAttribute attribute() const override {
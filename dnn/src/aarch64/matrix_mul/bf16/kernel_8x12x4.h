@@ -0,0 +1,181 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/bf16/kernel_8x12x4.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#if MGB_ENABLE_I8MM
+#include "src/aarch64/matrix_mul/mmla_common.h"
+#include "src/arm_common/simd_macro/marm_neon.h"
+
+namespace megdnn {
+namespace aarch64 {
+namespace matmul_bf16_8x12x4 {
+
+// The register layout is the same as matmul_8x12x8, except that each bfmmla
+// multiplies 2x4 blocks of bf16, which are held as uint16 since the bf16
+// vector types are not available without the bf16 target feature. The
+// accumulators are float32, and are rounded to bf16 when C is written.
+
+//! number of bf16 along K consumed by each bfmmla
+constexpr int UNROLL_K = 4;
+
+MEGDNN_ATTRIBUTE_TARGET("bf16")
+static inline void bfmmla(float32x4_t& c, uint16x8_t a, uint16x8_t b) {
+    asm("bfmmla %[c].4s, %[a].8h, %[b].8h\n" : [c] "+w"(c) : [a] "w"(a), [b] "w"(b));
+}
+
+static inline float32x4_t bf16_to_f32(const uint16_t* ptr) {
+    return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(ptr), 16));
+}
+
+//! round to nearest even as dt_bfloat16 does, and keep NaN quiet
+static inline uint16x4_t f32_to_bf16(float32x4_t v) {
+    uint32x4_t bits = vreinterpretq_u32_f32(v);
+    uint32x4_t lsb = vandq_u32(vshrq_n_u32(bits, 16), vdupq_n_u32(1));
+    uint32x4_t rounded = vaddq_u32(bits, vaddq_u32(lsb, vdupq_n_u32(0x7fff)));
+    uint32x4_t nan = vorrq_u32(bits, vdupq_n_u32(0x400000));
+    return vshrn_n_u32(vbslq_u32(vceqq_f32(v, v), rounded, nan), 16);
+}
+
+static inline uint16_t f32_to_bf16(float v) {
+    uint16_t ret;
+    vst1_lane_u16(&ret, f32_to_bf16(vdupq_n_f32(v)), 0);
+    return ret;
+}
+
+static inline float bf16_to_f32(uint16_t v) {
+    uint32_t bits = static_cast<uint32_t>(v) << 16;
+    float ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+//! write back a 2NP x 2NQ tile to the row major C, see matmul_8x12x8
+template <int NP, int NQ>
+static inline void store_tile(
+        float32x4_t (&c)[NP][NQ], uint16_t* output, int ldc, bool is_first_k,
+        int m_valid, int n_valid) {
+    if (m_valid == 2 * NP && n_valid == 2 * NQ) {
+        auto store = [is_first_k](uint16_t* ptr, float32x4_t v) {
+            if (!is_first_k) {
+                v = vaddq_f32(v, bf16_to_f32(ptr));
+            }
+            vst1_u16(ptr, f32_to_bf16(v));
+        };
+        for (int p = 0; p < NP; ++p) {
+            uint16_t* out0 = output + 2 * p * ldc;
+            uint16_t* out1 = out0 + ldc;
+            for (int q = 0; q < NQ; q += 2) {
+                float64x2_t x = vreinterpretq_f64_f32(c[p][q]),
+                            y = vreinterpretq_f64_f32(c[p][q + 1]);
+                store(out0 + q * 2, vreinterpretq_f32_f64(vzip1q_f64(x, y)));
+                store(out1 + q * 2, vreinterpretq_f32_f64(vzip2q_f64(x, y)));
+            }
+        }
+        return;
+    }
+    float tile[2 * NP][2 * NQ];
+    for (int p = 0; p < NP; ++p) {
+        for (int q = 0; q < NQ; ++q) {
+            float v[4];
+            vst1q_f32(v, c[p][q]);
+            tile[2 * p][2 * q] = v[0];
+            tile[2 * p][2 * q + 1] = v[1];
+            tile[2 * p + 1][2 * q] = v[2];
+            tile[2 * p + 1][2 * q + 1] = v[3];
+        }
+    }
+    for (int i = 0; i < m_valid; ++i) {
+        for (int j = 0; j < n_valid; ++j) {
+            uint16_t* ptr = output + i * ldc + j;
+            float v = is_first_k ? tile[i][j] : bf16_to_f32(*ptr) + tile[i][j];
+            *ptr = f32_to_bf16(v);
+        }
+    }
+}
+
+//! compute a 2NP x 2NQ tile of C; K must be a multiple of UNROLL_K
+template <int NP, int NQ>
+MEGDNN_ATTRIBUTE_TARGET("bf16")
+static void kern(
+        const uint16_t* packA, const uint16_t* packB, int K, uint16_t* output,
+        int ldc, bool is_first_k, int m_valid, int n_valid) {
+    float32x4_t c[NP][NQ];
+    for (int p = 0; p < NP; ++p) {
+        for (int q = 0; q < NQ; ++q) {
+            c[p][q] = vdupq_n_f32(0.f);
+        }
+    }
+    for (int k = 0; k < K; k += UNROLL_K) {
+        uint16x8_t a[NP];
+        for (int p = 0; p < NP; ++p) {
+            a[p] = vld1q_u16(packA + 8 * p);
+        }
+        for (int q = 0; q < NQ; ++q) {
+            uint16x8_t b = vld1q_u16(packB + 8 * q);
+            for (int p = 0; p < NP; ++p) {
+                bfmmla(c[p][q], a[p], b);
+            }
+        }
+        packA += 8 * NP;
+        packB += 8 * NQ;
+    }
+    store_tile<NP, NQ>(c, output, ldc, is_first_k, m_valid, n_valid);
+}
+
+template <int NP>
+static inline void kern_panel(
+        const uint16_t* packA, const uint16_t* packB, int K, uint16_t* output,
+        int ldc, bool is_first_k, int cols, int m_valid, int n_valid) {
+    switch (cols) {
+        case 12:
+            return kern<NP, 6>(
+                    packA, packB, K, output, ldc, is_first_k, m_valid, n_valid);
+        case 8:
+            return kern<NP, 4>(
+                    packA, packB, K, output, ldc, is_first_k, m_valid, n_valid);
+        default:
+            return kern<NP, 2>(
+                    packA, packB, K, output, ldc, is_first_k, m_valid, n_valid);
+    }
+}
+
+//! compute C = A * B from the panels packed by mmla::pack()
+static void gemm_bf16_8x12x4(
+        const uint16_t* packA, const uint16_t* packB, int M, int N, int K,
+        uint16_t* C, int LDC, bool is_first_k) {
+    K = round_up(K, UNROLL_K);
+    for (int m = 0; m < M; m += 8) {
+        int rows = mmla::panel_rows(m, M, 8), m_valid = std::min(rows, M - m);
+        const uint16_t* cur_packB = packB;
+        for (int n = 0; n < N; n += 12) {
+            int cols = mmla::panel_rows(n, N, 12), n_valid = std::min(cols, N - n);
+            uint16_t* out = C + m * LDC + n;
+            if (rows == 8) {
+                kern_panel<4>(
+                        packA, cur_packB, K, out, LDC, is_first_k, cols, m_valid,
+                        n_valid);
+            } else {
+                kern_panel<2>(
+                        packA, cur_packB, K, out, LDC, is_first_k, cols, m_valid,
+                        n_valid);
+            }
+            cur_packB += cols * K;
+        }
+        packA += rows * K;
+    }
+}
+
+}  // namespace matmul_bf16_8x12x4
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,77 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/bf16/strategy.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/aarch64/matrix_mul/bf16/strategy.h"
+#if MGB_ENABLE_I8MM && !MEGDNN_DISABLE_FLOAT16
+#include "src/aarch64/matrix_mul/bf16/kernel_8x12x4.h"
+#include "src/aarch64/matrix_mul/mmla_common.h"
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace aarch64;
+using namespace aarch64::matmul;
+
+namespace {
+//! bf16 are packed and computed as their bits
+const uint16_t* as_bits(const dt_bfloat16* ptr) {
+    return reinterpret_cast<const uint16_t*>(ptr);
+}
+uint16_t* as_bits(dt_bfloat16* ptr) {
+    return reinterpret_cast<uint16_t*>(ptr);
+}
+}  // anonymous namespace
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(gemm_bf16_8x12);
+
+void gemm_bf16_8x12::pack_A(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int y0, int ymax, int k0,
+        int kmax, bool transpose) const {
+    constexpr int UNROLL_K = matmul_bf16_8x12x4::UNROLL_K;
+    if (transpose) {
+        mmla::pack_col_major<UNROLL_K>(
+                as_bits(out), as_bits(in), ldin, y0, ymax, k0, kmax, 8);
+    } else {
+        mmla::pack_row_major<UNROLL_K>(
+                as_bits(out), as_bits(in), ldin, y0, ymax, k0, kmax, 8);
+    }
+}
+
+void gemm_bf16_8x12::pack_B(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int x0, int xmax, int k0,
+        int kmax, bool transpose) const {
+    constexpr int UNROLL_K = matmul_bf16_8x12x4::UNROLL_K;
+    if (transpose) {
+        mmla::pack_row_major<UNROLL_K>(
+                as_bits(out), as_bits(in), ldin, x0, xmax, k0, kmax, 12);
+    } else {
+        mmla::pack_col_major<UNROLL_K>(
+                as_bits(out), as_bits(in), ldin, x0, xmax, k0, kmax, 12);
+    }
+}
+
+void gemm_bf16_8x12::kern(
+        const dt_bfloat16* packA, const dt_bfloat16* packB, size_t M, size_t N,
+        size_t K, dt_bfloat16* C, size_t LDC, bool is_first_k, const dt_float32*,
+        dt_float32*) const {
+    megdnn_assert(
+            A_dtype.enumv() == DTypeEnum::BFloat16 &&
+                    B_dtype.enumv() == DTypeEnum::BFloat16 &&
+                    C_dtype.enumv() == DTypeEnum::BFloat16,
+            "A: %s B: %s C: %s", A_dtype.name(), B_dtype.name(), C_dtype.name());
+    MEGDNN_MARK_USED_VAR(A_dtype);
+    MEGDNN_MARK_USED_VAR(B_dtype);
+    MEGDNN_MARK_USED_VAR(C_dtype);
+    matmul_bf16_8x12x4::gemm_bf16_8x12x4(
+            as_bits(packA), as_bits(packB), M, N, K, as_bits(C), LDC, is_first_k);
+}
+
+#endif
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,26 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/bf16/strategy.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/fallback/matrix_mul/gemm_common.h"
+
+#if MGB_ENABLE_I8MM && !MEGDNN_DISABLE_FLOAT16
+namespace megdnn {
+namespace aarch64 {
+namespace matmul {
+
+MEGDNN_REG_GEMM_STRATEGY(
+        dt_bfloat16, dt_bfloat16, dt_float32, 8, 12, 4, false, true, gemm_bf16_8x12);
+
+}  // namespace matmul
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,199 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/int8_i8mm/kernel_8x12x8.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#if MGB_ENABLE_I8MM
+#include "src/aarch64/matrix_mul/mmla_common.h"
+#include "src/arm_common/simd_macro/marm_neon.h"
+
+namespace megdnn {
+namespace aarch64 {
+namespace matmul_8x12x8 {
+
+// Overview of register layout:
+//
+// Each smmla multiplies a 2x8 block of A by the transpose of a 2x8 block of B
+// and accumulates a 2x2 block of C, so a 8x12 tile of C is kept in 4x6
+// accumulators; each q register of A and B holds two rows of 8 int8.
+//
+//                              +--------+--------+ - - - +--------+
+//                              | B0:n01 | B1:n23 |       | B5:ab  |
+//                              +--------+--------+ - - - +--------+
+//
+//  +--------+   +--------------+--------------+ - - - +--------------+
+//  | A0:m01 |   | c00: m01n01  | c01: m01n23  |       | c05: m01nab  |
+//  | A1:m23 |   | c10          | c11          |       | c15          |
+//  | A2:m45 |   | c20          | c21          |       | c25          |
+//  | A3:m67 |   | c30          | c31          |       | c35          |
+//  +--------+   +--------------+--------------+ - - - +--------------+
+//
+//                            Accumulator
+//
+// The element (i, j) of a 2x2 block is at lane 2 * i + j.
+
+//! number of int8 along K consumed by each smmla
+constexpr int UNROLL_K = 8;
+
+MEGDNN_ATTRIBUTE_TARGET("i8mm")
+static inline void smmla(int32x4_t& c, int8x16_t a, int8x16_t b) {
+    asm("smmla %[c].4s, %[a].16b, %[b].16b\n" : [c] "+w"(c) : [a] "w"(a), [b] "w"(b));
+}
+
+/*!
+ * \brief write back a tile of 2 * NP rows and 2 * NQ columns, of which only
+ *      the first m_valid rows and n_valid columns are stored
+ *
+ * \tparam MK4 whether C is in (M / 4, N, 4) layout, where ldc is the distance
+ *      between two groups of 4 rows; otherwise C is row major
+ */
+template <int NP, int NQ, bool MK4>
+static inline void store_tile(
+        int32x4_t (&c)[NP][NQ], int32_t* output, int ldc, bool is_first_k,
+        int m_valid, int n_valid) {
+    if (m_valid == 2 * NP && n_valid == 2 * NQ) {
+        auto store = [is_first_k](int32_t* ptr, int32x4_t v) {
+            if (!is_first_k) {
+                v = vaddq_s32(v, vld1q_s32(ptr));
+            }
+            vst1q_s32(ptr, v);
+        };
+        if (MK4) {
+            //! lanes 0, 2 of c[2g][q] and c[2g + 1][q] are rows 4g .. 4g + 3
+            //! of column 2q, and lanes 1, 3 of them are of column 2q + 1
+            for (int g = 0; g < NP / 2; ++g) {
+                int32_t* out = output + g * ldc;
+                for (int q = 0; q < NQ; ++q) {
+                    store(out + q * 8, vuzp1q_s32(c[2 * g][q], c[2 * g + 1][q]));
+                    store(out + q * 8 + 4, vuzp2q_s32(c[2 * g][q], c[2 * g + 1][q]));
+                }
+            }
+        } else {
+            for (int p = 0; p < NP; ++p) {
+                int32_t* out0 = output + 2 * p * ldc;
+                int32_t* out1 = out0 + ldc;
+                for (int q = 0; q < NQ; q += 2) {
+                    int64x2_t x = vreinterpretq_s64_s32(c[p][q]),
+                              y = vreinterpretq_s64_s32(c[p][q + 1]);
+                    store(out0 + q * 2, vreinterpretq_s32_s64(vzip1q_s64(x, y)));
+                    store(out1 + q * 2, vreinterpretq_s32_s64(vzip2q_s64(x, y)));
+                }
+            }
+        }
+        return;
+    }
+    int32_t tile[2 * NP][2 * NQ];
+    for (int p = 0; p < NP; ++p) {
+        for (int q = 0; q < NQ; ++q) {
+            int32_t v[4];
+            vst1q_s32(v, c[p][q]);
+            tile[2 * p][2 * q] = v[0];
+            tile[2 * p][2 * q + 1] = v[1];
+            tile[2 * p + 1][2 * q] = v[2];
+            tile[2 * p + 1][2 * q + 1] = v[3];
+        }
+    }
+    for (int i = 0; i < m_valid; ++i) {
+        for (int j = 0; j < n_valid; ++j) {
+            int32_t* ptr = MK4 ? output + (i / 4) * ldc + j * 4 + i % 4
+                               : output + i * ldc + j;
+            *ptr = is_first_k ? tile[i][j] : *ptr + tile[i][j];
+        }
+    }
+}
+
+/*!
+ * \brief compute a (2 * NP) x (2 * NQ) tile of C from packed panels of A and B
+ *
+ * \param K the reduction size, which must be a multiple of UNROLL_K
+ */
+template <int NP, int NQ, bool MK4>
+MEGDNN_ATTRIBUTE_TARGET("i8mm")
+static void kern(
+        const int8_t* packA, const int8_t* packB, int K, int32_t* output, int ldc,
+        bool is_first_k, int m_valid, int n_valid) {
+    int32x4_t c[NP][NQ];
+    for (int p = 0; p < NP; ++p) {
+        for (int q = 0; q < NQ; ++q) {
+            c[p][q] = vdupq_n_s32(0);
+        }
+    }
+    for (int k = 0; k < K; k += UNROLL_K) {
+        int8x16_t a[NP];
+        for (int p = 0; p < NP; ++p) {
+            a[p] = vld1q_s8(packA + 16 * p);
+        }
+        for (int q = 0; q < NQ; ++q) {
+            int8x16_t b = vld1q_s8(packB + 16 * q);
+            for (int p = 0; p < NP; ++p) {
+                smmla(c[p][q], a[p], b);
+            }
+        }
+        packA += 16 * NP;
+        packB += 16 * NQ;
+    }
+    store_tile<NP, NQ, MK4>(c, output, ldc, is_first_k, m_valid, n_valid);
+}
+
+//! dispatch a panel of 2 * NP rows of A by the number of columns of B
+template <int NP, bool MK4>
+static inline void kern_panel(
+        const int8_t* packA, const int8_t* packB, int K, int32_t* output, int ldc,
+        bool is_first_k, int cols, int m_valid, int n_valid) {
+    switch (cols) {
+        case 12:
+            return kern<NP, 6, MK4>(
+                    packA, packB, K, output, ldc, is_first_k, m_valid, n_valid);
+        case 8:
+            return kern<NP, 4, MK4>(
+                    packA, packB, K, output, ldc, is_first_k, m_valid, n_valid);
+        default:
+            return kern<NP, 2, MK4>(
+                    packA, packB, K, output, ldc, is_first_k, m_valid, n_valid);
+    }
+}
+
+/*!
+ * \brief compute C = A * B from the panels packed by mmla::pack() with 8 rows
+ *      of A and 12 columns of B
+ */
+template <bool MK4>
+static void gemm_s8_8x12x8(
+        const int8_t* packA, const int8_t* packB, int M, int N, int K, int32_t* C,
+        int LDC, bool is_first_k) {
+    K = round_up(K, UNROLL_K);
+    for (int m = 0; m < M; m += 8) {
+        int rows = mmla::panel_rows(m, M, 8), m_valid = std::min(rows, M - m);
+        int32_t* output = MK4 ? C + (m / 4) * LDC : C + m * LDC;
+        const int8_t* cur_packB = packB;
+        for (int n = 0; n < N; n += 12) {
+            int cols = mmla::panel_rows(n, N, 12), n_valid = std::min(cols, N - n);
+            int32_t* out = output + (MK4 ? n * 4 : n);
+            if (rows == 8) {
+                kern_panel<4, MK4>(
+                        packA, cur_packB, K, out, LDC, is_first_k, cols, m_valid,
+                        n_valid);
+            } else {
+                kern_panel<2, MK4>(
+                        packA, cur_packB, K, out, LDC, is_first_k, cols, m_valid,
+                        n_valid);
+            }
+            cur_packB += cols * K;
+        }
+        packA += rows * K;
+    }
+}
+
+}  // namespace matmul_8x12x8
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
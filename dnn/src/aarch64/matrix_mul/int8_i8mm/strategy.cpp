@@ -0,0 +1,107 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/int8_i8mm/strategy.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/aarch64/matrix_mul/int8_i8mm/strategy.h"
+#if MGB_ENABLE_I8MM
+#include "src/aarch64/matrix_mul/int8_i8mm/kernel_8x12x8.h"
+#include "src/aarch64/matrix_mul/mmla_common.h"
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace aarch64;
+using namespace aarch64::matmul;
+
+namespace {
+void check_dtype(DType A_dtype, DType B_dtype, DType C_dtype) {
+    megdnn_assert(
+            A_dtype.enumv() == B_dtype.enumv() &&
+                    ((A_dtype.enumv() == DTypeEnum::Int8 &&
+                      C_dtype.enumv() == DTypeEnum::Int32) ||
+                     (A_dtype.enumv() == DTypeEnum::QuantizedS8 &&
+                      C_dtype.enumv() == DTypeEnum::QuantizedS32)),
+            "A: %s B: %s C: %s", A_dtype.name(), B_dtype.name(), C_dtype.name());
+    MEGDNN_MARK_USED_VAR(A_dtype);
+    MEGDNN_MARK_USED_VAR(B_dtype);
+    MEGDNN_MARK_USED_VAR(C_dtype);
+}
+}  // anonymous namespace
+
+/* ====================== gemm_s8_8x12_i8mm ===========================*/
+MEGDNN_REG_GEMM_STRATEGY_IMPL(gemm_s8_8x12_i8mm);
+
+void gemm_s8_8x12_i8mm::pack_A(
+        dt_int8* outptr, const dt_int8* inptr, int ldin, int y0, int ymax, int k0,
+        int kmax, bool transpose) const {
+    constexpr int UNROLL_K = matmul_8x12x8::UNROLL_K;
+    if (transpose) {
+        mmla::pack_col_major<UNROLL_K>(outptr, inptr, ldin, y0, ymax, k0, kmax, 8);
+    } else {
+        mmla::pack_row_major<UNROLL_K>(outptr, inptr, ldin, y0, ymax, k0, kmax, 8);
+    }
+}
+
+void gemm_s8_8x12_i8mm::pack_B(
+        dt_int8* out, const dt_int8* in, int ldin, int x0, int xmax, int k0, int kmax,
+        bool transpose) const {
+    constexpr int UNROLL_K = matmul_8x12x8::UNROLL_K;
+    if (transpose) {
+        mmla::pack_row_major<UNROLL_K>(out, in, ldin, x0, xmax, k0, kmax, 12);
+    } else {
+        mmla::pack_col_major<UNROLL_K>(out, in, ldin, x0, xmax, k0, kmax, 12);
+    }
+}
+
+void gemm_s8_8x12_i8mm::kern(
+        const dt_int8* packA, const dt_int8* packB, size_t M, size_t N, size_t K,
+        dt_int32* C, size_t LDC, bool is_first_k, const dt_int32*, dt_int32*) const {
+    check_dtype(A_dtype, B_dtype, C_dtype);
+    matmul_8x12x8::gemm_s8_8x12x8<false>(packA, packB, M, N, K, C, LDC, is_first_k);
+}
+
+/* ====================== gemm_mk4_s8_8x12_i8mm ===========================*/
+MEGDNN_REG_GEMM_STRATEGY_IMPL(gemm_mk4_s8_8x12_i8mm);
+
+//! A is in (M / 4, K / 4, 4, 4) layout, and ldin is the distance between two
+//! groups of 4 rows
+void gemm_mk4_s8_8x12_i8mm::pack_A(
+        dt_int8* outptr, const dt_int8* inptr, int ldin, int y0, int ymax, int k0,
+        int kmax, bool transpose) const {
+    megdnn_assert(
+            !transpose, "matrix mul mk4 with transposed matrix A is not supported");
+    megdnn_assert(ymax % 4 == 0 && y0 % 4 == 0, "mk4 matmul with m is not times of 4");
+    megdnn_assert(kmax % 4 == 0 && k0 % 4 == 0, "mk4 matmul with k is not times of 4");
+    mmla::pack<matmul_8x12x8::UNROLL_K, 4>(
+            outptr, y0, ymax, k0, kmax, 8, [=](int m, int k) {
+                return inptr + (m / 4) * ldin + (k / 4) * 16 + (m % 4) * 4 + k % 4;
+            });
+}
+
+//! B is in (K / 4, N, 4) layout, and ldin is the distance between two groups
+//! of 4 rows
+void gemm_mk4_s8_8x12_i8mm::pack_B(
+        dt_int8* out, const dt_int8* in, int ldin, int x0, int xmax, int k0, int kmax,
+        bool transpose) const {
+    megdnn_assert(
+            !transpose, "matrix mul mk4 with transposed matrix B is not supported");
+    mmla::pack<matmul_8x12x8::UNROLL_K, 4>(
+            out, x0, xmax, k0, kmax, 12,
+            [=](int n, int k) { return in + (k / 4) * ldin + n * 4 + k % 4; });
+}
+
+void gemm_mk4_s8_8x12_i8mm::kern(
+        const dt_int8* packA, const dt_int8* packB, size_t M, size_t N, size_t K,
+        dt_int32* C, size_t LDC, bool is_first_k, const dt_int32*, dt_int32*) const {
+    check_dtype(A_dtype, B_dtype, C_dtype);
+    matmul_8x12x8::gemm_s8_8x12x8<true>(packA, packB, M, N, K, C, LDC, is_first_k);
+}
+
+#endif
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,29 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/int8_i8mm/strategy.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/fallback/matrix_mul/gemm_common.h"
+
+#if MGB_ENABLE_I8MM
+namespace megdnn {
+namespace aarch64 {
+namespace matmul {
+
+MEGDNN_REG_GEMM_STRATEGY(
+        dt_int8, dt_int32, dt_int32, 8, 12, 8, false, true, gemm_s8_8x12_i8mm);
+
+MEGDNN_REG_GEMM_STRATEGY(
+        dt_int8, dt_int32, dt_int32, 8, 12, 8, false, true, gemm_mk4_s8_8x12_i8mm);
+
+}  // namespace matmul
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,93 @@
+/**
+ * \file dnn/src/aarch64/matrix_mul/mmla_common.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace aarch64 {
+//! packing shared by the kernels built on the matrix multiply instructions
+namespace mmla {
+
+/*!
+ * \brief number of rows of the panel starting at row \p r of [0, \p nr_row)
+ *
+ * Panels have \p max_rows rows, except for the last one, which is rounded up
+ * to a multiple of 4 so that it can be computed by a narrower kernel.
+ */
+static inline int panel_rows(int r, int nr_row, int max_rows) {
+    return std::min(max_rows, static_cast<int>(round_up(nr_row - r, 4)));
+}
+
+/*!
+ * \brief pack rows [r0, r1) and columns [k0, k1) of a matrix for the xMMLA
+ *      instructions
+ *
+ * The instructions multiply a 2 x UNROLL_K block of the left matrix by the
+ * transpose of a 2 x UNROLL_K block of the right one, so both operands are
+ * packed the same way: for each panel of rows (see panel_rows()) and each
+ * UNROLL_K columns, the panel_rows x UNROLL_K block is stored in row major.
+ * Rows and columns out of range are padded with zeros.
+ *
+ * \param addr addr(r, k) is the address of element (r, k); elements (r, k)
+ *      to (r, k + RUN - 1) must be contiguous if k - k0 is a multiple of RUN
+ */
+template <int UNROLL_K, int RUN, typename T, typename Addr>
+void pack(T* out, int r0, int r1, int k0, int k1, int max_rows, Addr addr) {
+    static_assert(UNROLL_K % RUN == 0, "RUN must divide UNROLL_K");
+    for (int r = r0; r < r1; r += max_rows) {
+        int rows = panel_rows(r - r0, r1 - r0, max_rows);
+        for (int k = k0; k < k1; k += UNROLL_K) {
+            for (int i = 0; i < rows; ++i, out += UNROLL_K) {
+                if (r + i >= r1) {
+                    std::memset(out, 0, sizeof(T) * UNROLL_K);
+                    continue;
+                }
+                for (int kk = k; kk < k + UNROLL_K; kk += RUN) {
+                    T* dst = out + (kk - k);
+                    if (kk + RUN <= k1) {
+                        std::memcpy(dst, addr(r + i, kk), sizeof(T) * RUN);
+                        continue;
+                    }
+                    for (int j = 0; j < RUN; ++j) {
+                        dst[j] = kk + j < k1 ? *addr(r + i, kk + j) : T(0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//! pack a row major matrix whose rows are \p ld elements apart
+template <int UNROLL_K, typename T>
+void pack_row_major(
+        T* out, const T* in, int ld, int r0, int r1, int k0, int k1, int max_rows) {
+    pack<UNROLL_K, UNROLL_K>(
+            out, r0, r1, k0, k1, max_rows,
+            [=](int r, int k) { return in + static_cast<size_t>(r) * ld + k; });
+}
+
+//! pack the transpose of a row major matrix, i.e. element (r, k) is in[k][r]
+template <int UNROLL_K, typename T>
+void pack_col_major(
+        T* out, const T* in, int ld, int r0, int r1, int k0, int k1, int max_rows) {
+    pack<UNROLL_K, 1>(out, r0, r1, k0, k1, max_rows, [=](int r, int k) {
+        return in + static_cast<size_t>(k) * ld + r;
+    });
+}
+
+}  // namespace mmla
+}  // namespace aarch64
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -23,6 +23,9 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
     AlgoF32K4x16x1 f32k4x16x1;
     AlgoF32MK4_4x16 f32mk4_4x16;
     AlgoF32Gemv f32_gemv;
+#if MGB_ENABLE_SVE
+    AlgoF32SVE8xVL f32_sve_8xvl;
+#endif
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC
     AlgoF16K8x24x1 f16_k8x24x1;
     AlgoF16MK8_8x8 f16_mk8_8x8;
@@ -30,6 +33,13 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
 #if MGB_ENABLE_DOT
     AlgoInt8x8x32K8x12x4DotProd int8x8x32_k8x12x4_dotprod;
     AlgoInt8x8x32MK4_8x12x4DotProd int8x8x32_mk4_8x12x4_dotprod;
+#endif
+#if MGB_ENABLE_I8MM
+    AlgoInt8x8x32K8x12x8I8MM int8x8x32_k8x12x8_i8mm;
+    AlgoInt8x8x32MK4_8x12x8I8MM int8x8x32_mk4_8x12x8_i8mm;
+#if !MEGDNN_DISABLE_FLOAT16
+    AlgoBf16K8x12x4 bf16_k8x12x4;
+#endif
 #endif
     AlgoInt8x8x32MK4_4x4x16 int8x8x32_mk4_4x4x16;
     AlgoInt8x8x32K4x4x16 int8x8x32_k4x4x16;
@@ -56,6 +66,10 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
 public:
     AlgoPack() {
         m_all_algos.emplace_back(&f32_gemv);
+#if MGB_ENABLE_SVE
+        //! only usable with vectors wider than 128 bits
+        m_all_algos.emplace_back(&f32_sve_8xvl);
+#endif
         m_all_algos.emplace_back(&f32K8x12x1);
         m_all_algos.emplace_back(&f32_mk4_8x12x1);
         m_all_algos.emplace_back(&f32k4x16x1);
@@ -64,6 +78,13 @@ public:
         m_all_algos.emplace_back(&f16_k8x24x1);
         m_all_algos.emplace_back(&f16_mk8_8x8);
 #endif
+#if MGB_ENABLE_I8MM && !MEGDNN_DISABLE_FLOAT16
+        m_all_algos.emplace_back(&bf16_k8x12x4);
+#endif
+#if MGB_ENABLE_I8MM
+        m_all_algos.emplace_back(&int8x8x32_k8x12x8_i8mm);
+        m_all_algos.emplace_back(&int8x8x32_mk4_8x12x8_i8mm);
+#endif
 #if MGB_ENABLE_DOT
         m_all_algos.emplace_back(&int8x8x32_k8x12x4_dotprod);
         m_all_algos.emplace_back(&int8x8x32_mk4_8x12x4_dotprod);
@@ -35,6 +35,9 @@ private:
     class AlgoF32K4x16x1;     // Aarch64 F32 Kernel 4x16x1
     class AlgoF32MK4_4x16;    // Aarch64 F32 Format MK4 block 16x4
     class AlgoF32Gemv;        // Aarch64 F32 Gemv
+#if MGB_ENABLE_SVE
+    class AlgoF32SVE8xVL;  // Aarch64 F32 Kernel 8x2VL SVE
+#endif
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC
     class AlgoF16K8x24x1;  // Aarch64 F16 Kernel 8x24x1
     class AlgoF16MK8_8x8;  // Aarch64 F16 Format MK8 block 16x8
@@ -45,6 +48,14 @@ private:
                                            // 8x12x4 DotProduct
     class AlgoInt8x8x32MK4_8x12x4DotProd;  // Aarch64 nchw44 Int8x8x32 Kernel
                                            // 8x12x4 DotProduct
+#endif
+#if MGB_ENABLE_I8MM
+    class AlgoInt8x8x32K8x12x8I8MM;     // Aarch64 Int8x8x32 Kernel 8x12x8 I8MM
+    class AlgoInt8x8x32MK4_8x12x8I8MM;  // Aarch64 nchw44 Int8x8x32 Kernel
+                                        // 8x12x8 I8MM
+#if !MEGDNN_DISABLE_FLOAT16
+    class AlgoBf16K8x12x4;  // Aarch64 BF16 Kernel 8x12x4 BFMMLA
+#endif
 #endif
     class AlgoInt8x8x32MK4_4x4x16;   // Aarch64 nchw44 Int8x8x32 Kernel 4x4x16
     class AlgoInt8x8x32K4x4x16;      // Aarch64 Int8x8x32 Kernel 4x4x16
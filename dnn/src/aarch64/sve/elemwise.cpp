@@ -0,0 +1,203 @@
+/**
+ * \file dnn/src/aarch64/sve/elemwise.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/aarch64/sve/elemwise.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+#include <arm_sve.h>
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace aarch64;
+using namespace sve;
+
+namespace {
+
+inline svfloat32_t h_swish(svbool_t pg, svfloat32_t x) {
+    svfloat32_t t = svmax_n_f32_x(pg, svadd_n_f32_x(pg, x, 3.f), 0.f);
+    t = svmin_n_f32_x(pg, t, 6.f);
+    return svdiv_n_f32_x(pg, svmul_f32_x(pg, x, t), 6.f);
+}
+
+#define DEF_UNARY(_name, _expr)                                   \
+    struct _name {                                                \
+        static svfloat32_t apply(svbool_t pg, svfloat32_t x) {    \
+            return _expr;                                         \
+        }                                                         \
+    }
+DEF_UNARY(ReluOp, svmax_n_f32_x(pg, x, 0.f));
+DEF_UNARY(AbsOp, svabs_f32_x(pg, x));
+DEF_UNARY(NegateOp, svneg_f32_x(pg, x));
+DEF_UNARY(HSwishOp, h_swish(pg, x));
+#undef DEF_UNARY
+
+#define DEF_BINARY(_name, _expr)                                                \
+    struct _name {                                                              \
+        static svfloat32_t apply(svbool_t pg, svfloat32_t a, svfloat32_t b) {   \
+            return _expr;                                                       \
+        }                                                                       \
+    }
+DEF_BINARY(AddOp, svadd_f32_x(pg, a, b));
+DEF_BINARY(SubOp, svsub_f32_x(pg, a, b));
+DEF_BINARY(MulOp, svmul_f32_x(pg, a, b));
+DEF_BINARY(MaxOp, svmax_f32_x(pg, a, b));
+DEF_BINARY(MinOp, svmin_f32_x(pg, a, b));
+DEF_BINARY(TrueDivOp, svdiv_f32_x(pg, a, b));
+DEF_BINARY(FuseAddReluOp, svmax_n_f32_x(pg, svadd_f32_x(pg, a, b), 0.f));
+DEF_BINARY(FuseAddHSwishOp, h_swish(pg, svadd_f32_x(pg, a, b)));
+#undef DEF_BINARY
+
+//! load a vector of \p ptr, or broadcast ptr[0] if it is a scalar
+template <bool SCALAR>
+inline svfloat32_t load(svbool_t pg, const float* ptr, size_t i) {
+    return SCALAR ? svdup_n_f32(ptr[0]) : svld1_f32(pg, ptr + i);
+}
+
+/*
+ * All the loops below process two full vectors per iteration, and the tail
+ * of less than two vectors with predicates.
+ */
+
+template <typename Op>
+void run_unary(const float* src, float* dst, size_t n) {
+    size_t vl = svcntw(), i = 0;
+    svbool_t all = svptrue_b32();
+    for (; i + 2 * vl <= n; i += 2 * vl) {
+        svfloat32_t x0 = svld1_f32(all, src + i), x1 = svld1_f32(all, src + i + vl);
+        svst1_f32(all, dst + i, Op::apply(all, x0));
+        svst1_f32(all, dst + i + vl, Op::apply(all, x1));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svst1_f32(pg, dst + i, Op::apply(pg, svld1_f32(pg, src + i)));
+    }
+}
+
+template <typename Op, bool A_SCALAR, bool B_SCALAR>
+void run_binary(const float* a, const float* b, float* dst, size_t n) {
+    size_t vl = svcntw(), i = 0;
+    svbool_t all = svptrue_b32();
+    for (; i + 2 * vl <= n; i += 2 * vl) {
+        svfloat32_t a0 = load<A_SCALAR>(all, a, i), a1 = load<A_SCALAR>(all, a, i + vl),
+                    b0 = load<B_SCALAR>(all, b, i), b1 = load<B_SCALAR>(all, b, i + vl);
+        svst1_f32(all, dst + i, Op::apply(all, a0, b0));
+        svst1_f32(all, dst + i + vl, Op::apply(all, a1, b1));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svst1_f32(
+                pg, dst + i,
+                Op::apply(pg, load<A_SCALAR>(pg, a, i), load<B_SCALAR>(pg, b, i)));
+    }
+}
+
+template <typename Op>
+void dispatch_binary(
+        const float* a, bool a_scalar, const float* b, bool b_scalar, float* dst,
+        size_t n) {
+    megdnn_assert(!(a_scalar && b_scalar));
+    if (a_scalar) {
+        run_binary<Op, true, false>(a, b, dst, n);
+    } else if (b_scalar) {
+        run_binary<Op, false, true>(a, b, dst, n);
+    } else {
+        run_binary<Op, false, false>(a, b, dst, n);
+    }
+}
+
+template <bool C_SCALAR>
+void run_fma3(const float* a, const float* b, const float* c, float* dst, size_t n) {
+    size_t vl = svcntw(), i = 0;
+    svbool_t all = svptrue_b32();
+    for (; i + 2 * vl <= n; i += 2 * vl) {
+        svfloat32_t a0 = svld1_f32(all, a + i), a1 = svld1_f32(all, a + i + vl),
+                    b0 = svld1_f32(all, b + i), b1 = svld1_f32(all, b + i + vl);
+        svst1_f32(all, dst + i, svmla_f32_x(all, load<C_SCALAR>(all, c, i), a0, b0));
+        svst1_f32(
+                all, dst + i + vl,
+                svmla_f32_x(all, load<C_SCALAR>(all, c, i + vl), a1, b1));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svfloat32_t va = svld1_f32(pg, a + i), vb = svld1_f32(pg, b + i);
+        svst1_f32(pg, dst + i, svmla_f32_x(pg, load<C_SCALAR>(pg, c, i), va, vb));
+    }
+}
+
+}  // anonymous namespace
+
+bool sve::elemwise_mode_supported(ElemwiseMode mode, size_t nr_input) {
+    using Mode = ElemwiseMode;
+    switch (nr_input) {
+        case 1:
+            return mode == Mode::RELU || mode == Mode::ABS || mode == Mode::NEGATE ||
+                   mode == Mode::H_SWISH;
+        case 2:
+            return mode == Mode::ADD || mode == Mode::SUB || mode == Mode::MUL ||
+                   mode == Mode::MAX || mode == Mode::MIN || mode == Mode::TRUE_DIV ||
+                   mode == Mode::FUSE_ADD_RELU || mode == Mode::FUSE_ADD_H_SWISH;
+        case 3:
+            return mode == Mode::FUSE_MUL_ADD3;
+        default:
+            return false;
+    }
+}
+
+void sve::unary_f32(ElemwiseMode mode, const float* src, float* dst, size_t n) {
+    using Mode = ElemwiseMode;
+    switch (mode) {
+#define cb(_mode, _op) \
+    case Mode::_mode:  \
+        return run_unary<_op>(src, dst, n)
+        cb(RELU, ReluOp);
+        cb(ABS, AbsOp);
+        cb(NEGATE, NegateOp);
+        cb(H_SWISH, HSwishOp);
+#undef cb
+        default:
+            megdnn_throw(ssprintf("unsupported sve unary mode %d", int(mode)));
+    }
+}
+
+void sve::binary_f32(
+        ElemwiseMode mode, const float* a, bool a_scalar, const float* b,
+        bool b_scalar, float* dst, size_t n) {
+    using Mode = ElemwiseMode;
+    switch (mode) {
+#define cb(_mode, _op) \
+    case Mode::_mode:  \
+        return dispatch_binary<_op>(a, a_scalar, b, b_scalar, dst, n)
+        cb(ADD, AddOp);
+        cb(SUB, SubOp);
+        cb(MUL, MulOp);
+        cb(MAX, MaxOp);
+        cb(MIN, MinOp);
+        cb(TRUE_DIV, TrueDivOp);
+        cb(FUSE_ADD_RELU, FuseAddReluOp);
+        cb(FUSE_ADD_H_SWISH, FuseAddHSwishOp);
+#undef cb
+        default:
+            megdnn_throw(ssprintf("unsupported sve binary mode %d", int(mode)));
+    }
+}
+
+void sve::fma3_f32(
+        const float* a, const float* b, const float* c, bool c_scalar, float* dst,
+        size_t n) {
+    if (c_scalar) {
+        run_fma3<true>(a, b, c, dst, n);
+    } else {
+        run_fma3<false>(a, b, c, dst, n);
+    }
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,48 @@
+/**
+ * \file dnn/src/aarch64/sve/elemwise.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/opr_param_defs.h"
+#include "src/aarch64/sve/sve_helper.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+namespace megdnn {
+namespace aarch64 {
+namespace sve {
+
+using ElemwiseMode = param::Elemwise::Mode;
+
+//! whether the float32 kernel of \p mode with \p nr_input inputs is implemented
+bool elemwise_mode_supported(ElemwiseMode mode, size_t nr_input);
+
+void unary_f32(ElemwiseMode mode, const float* src, float* dst, size_t n);
+
+/*!
+ * \brief binary elemwise of contiguous float32 tensors
+ *
+ * At most one of \p a and \p b is a scalar, of which only the first element
+ * is read.
+ */
+void binary_f32(
+        ElemwiseMode mode, const float* a, bool a_scalar, const float* b,
+        bool b_scalar, float* dst, size_t n);
+
+//! dst = a * b + c, where \p c may be a scalar
+void fma3_f32(
+        const float* a, const float* b, const float* c, bool c_scalar, float* dst,
+        size_t n);
+
+}  // namespace sve
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,128 @@
+/**
+ * \file dnn/src/aarch64/sve/pooling.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/aarch64/sve/pooling.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+#include <arm_sve.h>
+#include <algorithm>
+#include <limits>
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace aarch64;
+using namespace sve;
+
+namespace {
+
+//! load the active lanes of ptr[i * SW]
+MEGDNN_FORCE_INLINE svfloat32_t load_strided(
+        svbool_t pg, const float* ptr, ptrdiff_t SW, svuint32_t index) {
+    if (SW == 1) {
+        return svld1_f32(pg, ptr);
+    }
+    //! svld2 is not used for SW == 2, since it would read one element beyond
+    //! the last window
+    return svld1_gather_u32index_f32(pg, ptr, index);
+}
+
+template <bool IS_MAX>
+struct Pooler {
+    static float identity() {
+        return IS_MAX ? -std::numeric_limits<float>::infinity() : 0.f;
+    }
+    static svfloat32_t feed(svbool_t pg, svfloat32_t acc, svfloat32_t x) {
+        return IS_MAX ? svmax_f32_m(pg, acc, x) : svadd_f32_m(pg, acc, x);
+    }
+    static float feed(float acc, float x) {
+        return IS_MAX ? std::max(acc, x) : acc + x;
+    }
+};
+
+template <bool IS_MAX>
+void pooling(
+        bool exclude_padding, const float* src, float* dst, ptrdiff_t IH,
+        ptrdiff_t IW, size_t OH, size_t OW, ptrdiff_t FH, ptrdiff_t FW,
+        ptrdiff_t SH, ptrdiff_t SW, ptrdiff_t PH, ptrdiff_t PW) {
+    using P = Pooler<IS_MAX>;
+    size_t vl = svcntw();
+    svuint32_t index = svindex_u32(0, SW);
+    //! output columns in [ow_begin, ow_end) have their windows inside the input
+    size_t ow_begin = std::min<size_t>(div_ceil(PW, SW), OW),
+           ow_end = IW + PW >= FW ? (IW + PW - FW) / SW + 1 : 0;
+    ow_end = std::max(ow_begin, std::min(ow_end, OW));
+    for (size_t oh = 0; oh < OH; ++oh, dst += OW) {
+        ptrdiff_t ih0 = static_cast<ptrdiff_t>(oh) * SH - PH;
+        ptrdiff_t kh_begin = std::max<ptrdiff_t>(0, -ih0),
+                  kh_end = std::min(FH, IH - ih0);
+        auto scalar = [&](size_t ow) {
+            ptrdiff_t iw0 = static_cast<ptrdiff_t>(ow) * SW - PW;
+            ptrdiff_t kw_begin = std::max<ptrdiff_t>(0, -iw0),
+                      kw_end = std::min(FW, IW - iw0);
+            float acc = P::identity();
+            for (ptrdiff_t kh = kh_begin; kh < kh_end; ++kh) {
+                for (ptrdiff_t kw = kw_begin; kw < kw_end; ++kw) {
+                    acc = P::feed(acc, src[(ih0 + kh) * IW + iw0 + kw]);
+                }
+            }
+            if (!IS_MAX) {
+                acc /= exclude_padding ? (kh_end - kh_begin) * (kw_end - kw_begin)
+                                       : FH * FW;
+            }
+            dst[ow] = acc;
+        };
+        for (size_t ow = 0; ow < ow_begin; ++ow) {
+            scalar(ow);
+        }
+        float scale = 1.f / (exclude_padding ? (kh_end - kh_begin) * FW : FH * FW);
+        for (size_t ow = ow_begin; ow < ow_end; ow += vl) {
+            svbool_t pg = svwhilelt_b32(ow, ow_end);
+            svfloat32_t acc = svdup_n_f32(P::identity());
+            for (ptrdiff_t kh = kh_begin; kh < kh_end; ++kh) {
+                const float* ptr =
+                        src + (ih0 + kh) * IW + static_cast<ptrdiff_t>(ow) * SW - PW;
+                for (ptrdiff_t kw = 0; kw < FW; ++kw) {
+                    acc = P::feed(pg, acc, load_strided(pg, ptr + kw, SW, index));
+                }
+            }
+            if (!IS_MAX) {
+                acc = svmul_n_f32_x(pg, acc, scale);
+            }
+            svst1_f32(pg, dst + ow, acc);
+        }
+        for (size_t ow = ow_end; ow < OW; ++ow) {
+            scalar(ow);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+void sve::pooling_f32(
+        PoolingMode mode, const float* src, float* dst, size_t IH, size_t IW,
+        size_t OH, size_t OW, size_t FH, size_t FW, size_t SH, size_t SW, size_t PH,
+        size_t PW) {
+    switch (mode) {
+        case PoolingMode::MAX:
+            return pooling<true>(
+                    false, src, dst, IH, IW, OH, OW, FH, FW, SH, SW, PH, PW);
+        case PoolingMode::AVERAGE:
+        case PoolingMode::AVERAGE_COUNT_EXCLUDE_PADDING:
+            return pooling<false>(
+                    mode == PoolingMode::AVERAGE_COUNT_EXCLUDE_PADDING, src, dst, IH,
+                    IW, OH, OW, FH, FW, SH, SW, PH, PW);
+        default:
+            megdnn_throw(ssprintf("unsupported sve pooling mode %d", int(mode)));
+    }
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/aarch64/sve/pooling.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/opr_param_defs.h"
+#include "src/aarch64/sve/sve_helper.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+namespace megdnn {
+namespace aarch64 {
+namespace sve {
+
+using PoolingMode = param::Pooling::Mode;
+
+/*!
+ * \brief pooling of a float32 plane of IH x IW into OH x OW
+ *
+ * Any window, stride and padding is supported; the output columns whose
+ * windows are inside the input are vectorized, and the others on the borders
+ * are computed one by one.
+ */
+void pooling_f32(
+        PoolingMode mode, const float* src, float* dst, size_t IH, size_t IW,
+        size_t OH, size_t OW, size_t FH, size_t FW, size_t SH, size_t SW, size_t PH,
+        size_t PW);
+
+}  // namespace sve
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,144 @@
+/**
+ * \file dnn/src/aarch64/sve/reduce.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/aarch64/sve/reduce.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+#include <arm_sve.h>
+#include <limits>
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace aarch64;
+using namespace sve;
+
+namespace {
+
+/*
+ * A reducer feeds the active lanes of a vector into the accumulator, merges
+ * two accumulators, and finally reduces the lanes of the accumulator; the
+ * inactive lanes keep the identity.
+ */
+
+struct SumReducer {
+    static float identity() { return 0.f; }
+    static svfloat32_t feed(svbool_t pg, svfloat32_t acc, svfloat32_t x) {
+        return svadd_f32_m(pg, acc, x);
+    }
+    static svfloat32_t merge(svbool_t pg, svfloat32_t a, svfloat32_t b) {
+        return svadd_f32_x(pg, a, b);
+    }
+    static float reduce(svbool_t pg, svfloat32_t acc) { return svaddv_f32(pg, acc); }
+};
+
+struct SumSqrReducer : SumReducer {
+    static svfloat32_t feed(svbool_t pg, svfloat32_t acc, svfloat32_t x) {
+        return svmla_f32_m(pg, acc, x, x);
+    }
+};
+
+struct MaxReducer {
+    static float identity() { return -std::numeric_limits<float>::infinity(); }
+    static svfloat32_t feed(svbool_t pg, svfloat32_t acc, svfloat32_t x) {
+        return svmax_f32_m(pg, acc, x);
+    }
+    static svfloat32_t merge(svbool_t pg, svfloat32_t a, svfloat32_t b) {
+        return svmax_f32_x(pg, a, b);
+    }
+    static float reduce(svbool_t pg, svfloat32_t acc) { return svmaxv_f32(pg, acc); }
+};
+
+struct MinReducer {
+    static float identity() { return std::numeric_limits<float>::infinity(); }
+    static svfloat32_t feed(svbool_t pg, svfloat32_t acc, svfloat32_t x) {
+        return svmin_f32_m(pg, acc, x);
+    }
+    static svfloat32_t merge(svbool_t pg, svfloat32_t a, svfloat32_t b) {
+        return svmin_f32_x(pg, a, b);
+    }
+    static float reduce(svbool_t pg, svfloat32_t acc) { return svminv_f32(pg, acc); }
+};
+
+//! reduce each of the \p A contiguous rows of length \p B
+template <typename Reducer>
+void reduce_rows(const float* src, float* dst, size_t A, size_t B, float scale) {
+    size_t vl = svcntw();
+    svbool_t all = svptrue_b32();
+    for (size_t a = 0; a < A; ++a, src += B) {
+        svfloat32_t acc0 = svdup_n_f32(Reducer::identity()), acc1 = acc0;
+        size_t i = 0;
+        for (; i + 2 * vl <= B; i += 2 * vl) {
+            acc0 = Reducer::feed(all, acc0, svld1_f32(all, src + i));
+            acc1 = Reducer::feed(all, acc1, svld1_f32(all, src + i + vl));
+        }
+        for (; i < B; i += vl) {
+            svbool_t pg = svwhilelt_b32(i, B);
+            acc0 = Reducer::feed(pg, acc0, svld1_f32(pg, src + i));
+        }
+        dst[a] = Reducer::reduce(all, Reducer::merge(all, acc0, acc1)) * scale;
+    }
+}
+
+//! reduce along B of (A, B, C) with C > 1, where lanes are along C
+template <typename Reducer>
+void reduce_cols(
+        const float* src, float* dst, size_t A, size_t B, size_t C, float scale) {
+    size_t vl = svcntw();
+    for (size_t a = 0; a < A; ++a, src += B * C, dst += C) {
+        for (size_t c = 0; c < C; c += vl) {
+            svbool_t pg = svwhilelt_b32(c, C);
+            svfloat32_t acc = svdup_n_f32(Reducer::identity());
+            for (size_t b = 0; b < B; ++b) {
+                acc = Reducer::feed(pg, acc, svld1_f32(pg, src + b * C + c));
+            }
+            svst1_f32(pg, dst + c, svmul_n_f32_x(pg, acc, scale));
+        }
+    }
+}
+
+template <typename Reducer>
+void dispatch(
+        const float* src, float* dst, size_t A, size_t B, size_t C, float scale) {
+    if (C == 1) {
+        reduce_rows<Reducer>(src, dst, A, B, scale);
+    } else {
+        reduce_cols<Reducer>(src, dst, A, B, C, scale);
+    }
+}
+
+}  // anonymous namespace
+
+bool sve::reduce_mode_supported(ReduceMode mode) {
+    return mode == ReduceMode::SUM || mode == ReduceMode::MEAN ||
+           mode == ReduceMode::SUM_SQR || mode == ReduceMode::MAX ||
+           mode == ReduceMode::MIN;
+}
+
+void sve::reduce_f32(
+        ReduceMode mode, const float* src, float* dst, size_t A, size_t B, size_t C) {
+    switch (mode) {
+        case ReduceMode::SUM:
+            return dispatch<SumReducer>(src, dst, A, B, C, 1.f);
+        case ReduceMode::MEAN:
+            return dispatch<SumReducer>(src, dst, A, B, C, 1.f / B);
+        case ReduceMode::SUM_SQR:
+            return dispatch<SumSqrReducer>(src, dst, A, B, C, 1.f);
+        case ReduceMode::MAX:
+            return dispatch<MaxReducer>(src, dst, A, B, C, 1.f);
+        case ReduceMode::MIN:
+            return dispatch<MinReducer>(src, dst, A, B, C, 1.f);
+        default:
+            megdnn_throw(ssprintf("unsupported sve reduce mode %d", int(mode)));
+    }
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,39 @@
+/**
+ * \file dnn/src/aarch64/sve/reduce.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/opr_param_defs.h"
+#include "src/aarch64/sve/sve_helper.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+namespace megdnn {
+namespace aarch64 {
+namespace sve {
+
+using ReduceMode = param::Reduce::Mode;
+
+//! whether the float32 kernel of \p mode is implemented
+bool reduce_mode_supported(ReduceMode mode);
+
+/*!
+ * \brief reduce contiguous \p src of shape (A, B, C) along B
+ *
+ * The reduction is vectorized along B if C is 1, and along C otherwise.
+ */
+void reduce_f32(
+        ReduceMode mode, const float* src, float* dst, size_t A, size_t B, size_t C);
+
+}  // namespace sve
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,142 @@
+/**
+ * \file dnn/src/aarch64/sve/sgemm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/aarch64/sve/sgemm.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+#include <arm_sve.h>
+#include <algorithm>
+#include <cstring>
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace aarch64;
+using namespace sve;
+
+namespace {
+
+constexpr size_t TILE_M = 8;
+//! K is blocked so that a panel of B stays in L1 for vectors up to 512 bits
+constexpr size_t BLOCK_K = 256;
+
+//! pack rows [m0, m0 + 8) and columns [k0, k1) of op(A), k-major
+void pack_a(
+        float* out, const float* A, size_t lda, size_t M, size_t m0, size_t k0,
+        size_t k1, bool trA) {
+    for (size_t k = k0; k < k1; ++k, out += TILE_M) {
+        for (size_t i = 0; i < TILE_M; ++i) {
+            size_t m = m0 + i;
+            out[i] = m >= M ? 0.f : trA ? A[k * lda + m] : A[m * lda + k];
+        }
+    }
+}
+
+//! pack rows [k0, k1) and columns [n0, n0 + width) of op(B), k-major
+void pack_b(
+        float* out, const float* B, size_t ldb, size_t N, size_t n0, size_t width,
+        size_t k0, size_t k1, bool trB) {
+    size_t valid = std::min(width, N - n0);
+    for (size_t k = k0; k < k1; ++k, out += width) {
+        if (trB) {
+            for (size_t j = 0; j < valid; ++j) {
+                out[j] = B[(n0 + j) * ldb + k];
+            }
+        } else {
+            std::memcpy(out, B + k * ldb + n0, sizeof(float) * valid);
+        }
+        std::fill(out + valid, out + width, 0.f);
+    }
+}
+
+/*!
+ * \brief compute a tile of 8 rows and two vectors of columns from the packed
+ *      panels, of which only m_valid rows and n_valid columns are stored
+ *
+ * The 8 values of A of each k are loaded by svld1rq, which replicates 4 of
+ * them into every 128-bit segment of a vector, so that svmla_lane can pick
+ * them by index whatever the vector length is.
+ */
+void kern_8xvl(
+        const float* pa, const float* pb, size_t K, float* C, size_t ldc,
+        bool is_first_k, size_t m_valid, size_t n_valid) {
+    size_t vl = svcntw();
+    svbool_t all = svptrue_b32();
+#define DEF_ACC(i) svfloat32_t c##i##0 = svdup_n_f32(0.f), c##i##1 = svdup_n_f32(0.f);
+    DEF_ACC(0) DEF_ACC(1) DEF_ACC(2) DEF_ACC(3)
+    DEF_ACC(4) DEF_ACC(5) DEF_ACC(6) DEF_ACC(7)
+#undef DEF_ACC
+    for (size_t k = 0; k < K; ++k, pa += TILE_M, pb += 2 * vl) {
+        svfloat32_t b0 = svld1_f32(all, pb), b1 = svld1_f32(all, pb + vl);
+        svfloat32_t a0 = svld1rq_f32(all, pa), a1 = svld1rq_f32(all, pa + 4);
+#define FMA(i, a, lane)                             \
+    c##i##0 = svmla_lane_f32(c##i##0, b0, a, lane); \
+    c##i##1 = svmla_lane_f32(c##i##1, b1, a, lane);
+        FMA(0, a0, 0) FMA(1, a0, 1) FMA(2, a0, 2) FMA(3, a0, 3)
+        FMA(4, a1, 0) FMA(5, a1, 1) FMA(6, a1, 2) FMA(7, a1, 3)
+#undef FMA
+    }
+    svbool_t pg0 = svwhilelt_b32(size_t(0), n_valid),
+             pg1 = svwhilelt_b32(vl, n_valid);
+#define STORE(i)                                                              \
+    if (i < m_valid) {                                                        \
+        float* out = C + i * ldc;                                             \
+        if (!is_first_k) {                                                    \
+            c##i##0 = svadd_f32_x(pg0, c##i##0, svld1_f32(pg0, out));         \
+            c##i##1 = svadd_f32_x(pg1, c##i##1, svld1_f32(pg1, out + vl));    \
+        }                                                                     \
+        svst1_f32(pg0, out, c##i##0);                                         \
+        svst1_f32(pg1, out + vl, c##i##1);                                    \
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3)
+    STORE(4) STORE(5) STORE(6) STORE(7)
+#undef STORE
+}
+
+}  // anonymous namespace
+
+size_t sve::sgemm_8xvl_workspace(size_t M, size_t N, size_t K) {
+    size_t width = 2 * nr_f32(), block_k = std::min(K, BLOCK_K);
+    return (round_up(M, TILE_M) + round_up(N, width)) * block_k * sizeof(float);
+}
+
+void sve::sgemm_8xvl(
+        const float* A, size_t lda, const float* B, size_t ldb, float* C,
+        size_t ldc, size_t M, size_t N, size_t K, bool trA, bool trB,
+        void* workspace) {
+    if (!K) {
+        for (size_t m = 0; m < M; ++m) {
+            std::fill(C + m * ldc, C + m * ldc + N, 0.f);
+        }
+        return;
+    }
+    size_t width = 2 * nr_f32();
+    float* pack_A = static_cast<float*>(workspace);
+    float* pack_B = pack_A + round_up(M, TILE_M) * std::min(K, BLOCK_K);
+    for (size_t k0 = 0; k0 < K; k0 += BLOCK_K) {
+        size_t k1 = std::min(K, k0 + BLOCK_K), kb = k1 - k0;
+        for (size_t m = 0; m < M; m += TILE_M) {
+            pack_a(pack_A + m * kb, A, lda, M, m, k0, k1, trA);
+        }
+        for (size_t n = 0; n < N; n += width) {
+            pack_b(pack_B + n * kb, B, ldb, N, n, width, k0, k1, trB);
+        }
+        for (size_t m = 0; m < M; m += TILE_M) {
+            for (size_t n = 0; n < N; n += width) {
+                kern_8xvl(
+                        pack_A + m * kb, pack_B + n * kb, kb, C + m * ldc + n, ldc,
+                        k0 == 0, std::min(TILE_M, M - m), std::min(width, N - n));
+            }
+        }
+    }
+}
+#endif
+
+// vim: syntax=cpp.doxygen
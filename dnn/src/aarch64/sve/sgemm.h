@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/aarch64/sve/sgemm.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/aarch64/sve/sve_helper.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+namespace megdnn {
+namespace aarch64 {
+namespace sve {
+
+//! workspace in bytes needed by sgemm_8xvl()
+size_t sgemm_8xvl_workspace(size_t M, size_t N, size_t K);
+
+/*!
+ * \brief C = op(A) * op(B) of row major float32 matrices
+ *
+ * Tiles of C are 8 rows by two vectors of columns, so the width of the tiles
+ * follows the vector length of the cpu. K is blocked, and for each block op(A)
+ * is packed into panels of 8 rows and op(B) into panels of two vectors.
+ */
+void sgemm_8xvl(
+        const float* A, size_t lda, const float* B, size_t ldb, float* C,
+        size_t ldc, size_t M, size_t N, size_t K, bool trA, bool trB,
+        void* workspace);
+
+}  // namespace sve
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
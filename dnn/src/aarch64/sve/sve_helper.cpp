@@ -0,0 +1,28 @@
+/**
+ * \file dnn/src/aarch64/sve/sve_helper.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/aarch64/sve/sve_helper.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+#include <arm_sve.h>
+#include "src/common/cpuinfo_arch_vendor.h"
+
+size_t megdnn::aarch64::sve::nr_f32() {
+    return svcntw();
+}
+
+bool megdnn::aarch64::sve::preferred() {
+    static const bool ret = arm_has_sve() && nr_f32() > 4;
+    return ret;
+}
+#endif
+
+// vim: syntax=cpp.doxygen
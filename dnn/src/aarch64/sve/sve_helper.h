@@ -0,0 +1,45 @@
+/**
+ * \file dnn/src/aarch64/sve/sve_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <cstddef>
+#include "megdnn/arch.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+namespace megdnn {
+namespace aarch64 {
+/*!
+ * \brief vector length agnostic kernels built on SVE
+ *
+ * Only the sources in this directory are compiled with SVE enabled, and the
+ * kernels are dispatched at runtime, so the interfaces here are plain C++ and
+ * must only be called if preferred() returns true.
+ */
+namespace sve {
+
+//! number of float32 in an SVE vector; only valid if the cpu supports SVE
+size_t nr_f32();
+
+/*!
+ * \brief whether the SVE kernels should be used instead of the NEON ones
+ *
+ * This is the case when the cpu supports SVE with vectors wider than 128
+ * bits, such as Neoverse-V1; with 128-bit vectors the tuned NEON kernels are
+ * as wide and are kept.
+ */
+bool preferred();
+
+}  // namespace sve
+}  // namespace aarch64
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
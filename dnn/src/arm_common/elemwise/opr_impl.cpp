@@ -11,6 +11,7 @@
  */
 #include "src/arm_common/elemwise/opr_impl.h"
 #include "src/arm_common/elemwise/binary/algo.h"
+#include "src/arm_common/elemwise/sve/algo.h"
 #include "src/arm_common/elemwise/ternary/algo.h"
 #include "src/arm_common/elemwise/unary/algo.h"
 #include "src/arm_common/elemwise_op.h"
@@ -36,9 +37,16 @@ class ElemwiseImpl::AlgoPack {
     AlgoTernaryFma3VecBcast101xXVec algo_ternaryfma3_vec_bcast101xX_vec;
     AlgoTernaryFma3VecScalarVec algo_ternaryfma3_vec_sca_vec;
     AlgoTernaryFma3VecScalarScalar algo_ternaryfma3_vec_sca_sca;
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+    AlgoSveF32 algo_sve_f32;
+#endif
 
 public:
     AlgoPack() {
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+        //! only available if the cpu has SVE wider than 128 bits
+        all_algos.emplace_back(&algo_sve_f32);
+#endif
         all_algos.emplace_back(&algo_unary);
         all_algos.emplace_back(&algo_binary_vec_vec);
         all_algos.emplace_back(&algo_binary_vec_sca);
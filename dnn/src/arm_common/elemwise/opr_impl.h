@@ -47,6 +47,9 @@ private:
     class AlgoTernaryFma3VecBcast101xXVec;
     class AlgoTernaryFma3VecScalarVec;
     class AlgoTernaryFma3VecScalarScalar;
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+    class AlgoSveF32;
+#endif
     class AlgoPack;
 };
 
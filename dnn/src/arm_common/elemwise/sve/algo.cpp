@@ -0,0 +1,112 @@
+/**
+ * \file dnn/src/arm_common/elemwise/sve/algo.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/elemwise/sve/algo.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+#include "src/aarch64/sve/elemwise.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_arm_common_elemwise_sve)
+
+using namespace megdnn;
+using namespace arm_common;
+
+namespace {
+//! number of elements computed by each thread, which is a multiple of 64
+size_t nr_elems_per_task(const ElemwiseImpl::KernParam& kern_param, size_t nr_elems) {
+    size_t nr_threads = static_cast<naive::HandleImpl*>(kern_param.handle)
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    return round_up<size_t>(div_ceil(nr_elems, nr_threads), 64);
+}
+}  // anonymous namespace
+
+bool ElemwiseImpl::AlgoSveF32::is_available(const KernParam& kern_param) const {
+    if (kern_param.m_dst->layout.dtype != dtype::Float32() ||
+        !aarch64::sve::preferred()) {
+        return false;
+    }
+    switch (kern_param.broad_cast_type) {
+        case BcastType::VEC:
+            return kern_param.unary_elparam[0].layout.is_contiguous() &&
+                   aarch64::sve::elemwise_mode_supported(kern_param.mode, 1);
+        case BcastType::VEC_VEC:
+        case BcastType::VEC_SCALAR:
+        case BcastType::SCALAR_VEC:
+            return kern_param.binary_elparam[0].layout.dtype == dtype::Float32() &&
+                   aarch64::sve::elemwise_mode_supported(kern_param.mode, 2);
+        case BcastType::VEC_VEC_VEC:
+        case BcastType::VEC_VEC_SCALAR:
+            return kern_param.ternary_elparam[0].layout.dtype == dtype::Float32() &&
+                   aarch64::sve::elemwise_mode_supported(kern_param.mode, 3);
+        default:
+            return false;
+    }
+}
+
+void ElemwiseImpl::AlgoSveF32::exec(const KernParam& kern_param) const {
+    auto mode = kern_param.mode;
+    auto bcast = kern_param.broad_cast_type;
+    float* dst = kern_param.m_dst->ptr<float>();
+    size_t nr_elems = kern_param.m_dst->layout.total_nr_elems();
+    size_t task_size = nr_elems_per_task(kern_param, nr_elems);
+    size_t nr_task = div_ceil(nr_elems, task_size);
+    auto handle = static_cast<naive::HandleImpl*>(kern_param.handle);
+
+    //! run kern(offset, size) on the parts of the output in parallel
+    auto dispatch = [&](auto kern) {
+        auto task = [=](size_t task_id, size_t) {
+            size_t offset = task_id * task_size;
+            kern(offset, std::min(task_size, nr_elems - offset));
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, task);
+    };
+
+    MIDOUT_BEGIN(megdnn_arm_common_elemwise_sve, midout_iv(bcast), midout_iv(mode)) {
+        if (bcast == BcastType::VEC) {
+            const float* src = kern_param.unary_elparam[0].ptr<float>();
+            dispatch([=](size_t offset, size_t size) {
+                aarch64::sve::unary_f32(mode, src + offset, dst + offset, size);
+            });
+            return;
+        }
+        if (bcast == BcastType::VEC_VEC || bcast == BcastType::VEC_SCALAR ||
+            bcast == BcastType::SCALAR_VEC) {
+            const float* a = kern_param.binary_elparam[0].ptr<float>();
+            const float* b = kern_param.binary_elparam[1].ptr<float>();
+            bool a_scalar = bcast == BcastType::SCALAR_VEC,
+                 b_scalar = bcast == BcastType::VEC_SCALAR;
+            dispatch([=](size_t offset, size_t size) {
+                aarch64::sve::binary_f32(
+                        mode, a_scalar ? a : a + offset, a_scalar,
+                        b_scalar ? b : b + offset, b_scalar, dst + offset, size);
+            });
+            return;
+        }
+        const float* a = kern_param.ternary_elparam[0].ptr<float>();
+        const float* b = kern_param.ternary_elparam[1].ptr<float>();
+        const float* c = kern_param.ternary_elparam[2].ptr<float>();
+        bool c_scalar = bcast == BcastType::VEC_VEC_SCALAR;
+        dispatch([=](size_t offset, size_t size) {
+            aarch64::sve::fma3_f32(
+                    a + offset, b + offset, c_scalar ? c : c + offset, c_scalar,
+                    dst + offset, size);
+        });
+    }
+    MIDOUT_END();
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,31 @@
+/**
+ * \file dnn/src/arm_common/elemwise/sve/algo.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/arm_common/elemwise/opr_impl.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+namespace megdnn {
+namespace arm_common {
+//! float32 vector, vector-scalar and fma3 cases computed by the SVE kernels
+class ElemwiseImpl::AlgoSveF32 final : public ElemwiseImpl::AlgoBase {
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "Elemwise::AlgoSveF32"; }
+
+    bool is_available(const KernParam&) const override;
+    void exec(const KernParam&) const override;
+};
+
+}  // namespace arm_common
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
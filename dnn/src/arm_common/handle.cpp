@@ -24,6 +24,7 @@
 #include "src/arm_common/resize/opr_impl.h"
 #include "src/arm_common/separable_conv/opr_impl.h"
 #include "src/arm_common/separable_filter/opr_impl.h"
+#include "src/arm_common/softmax/opr_impl.h"
 #include "src/arm_common/type_cvt/opr_impl.h"
 #include "src/arm_common/warp_affine/opr_impl.h"
 #include "src/arm_common/warp_perspective/opr_impl.h"
@@ -50,6 +51,7 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(TypeCvt)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Reduce)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardData)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxForward)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -144,6 +144,17 @@ public:
     void exec(const PoolingKernParam& param) const override;
     MEGDNN_DECL_ALGO_TYPE(ARM_Fp32ModexStridexNCHW44)
 };
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+//! float32 NCHW pooling of any window by the SVE kernels
+class PoolingImpl::AlgoFp32SVE final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; };
+    const char* name() const override { return "ARM_POOLING_FP32_SVE"; }
+    bool usable(const PoolingKernSizeParam& param) const override;
+    void exec(const PoolingKernParam& param) const override;
+    MEGDNN_DECL_ALGO_TYPE(ARM_Fp32SVE)
+};
+#endif
 class PoolingImpl::AlgoFallback final : public AlgoBase {
 public:
     AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; };
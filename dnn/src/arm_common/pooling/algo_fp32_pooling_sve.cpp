@@ -0,0 +1,62 @@
+/**
+ * \file dnn/src/arm_common/pooling/algo_fp32_pooling_sve.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/arm_common/pooling/algo.h"
+#include "src/aarch64/sve/pooling.h"
+
+#include "midout.h"
+
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+MIDOUT_DECL(megdnn_arm_common_fp32_pooling_sve)
+
+namespace megdnn {
+namespace arm_common {
+bool PoolingImpl::AlgoFp32SVE::usable(const PoolingKernSizeParam& param) const {
+    bool mode_ok = param.mode == Mode::MAX || param.mode == Mode::AVERAGE ||
+                   param.mode == Mode::AVERAGE_COUNT_EXCLUDE_PADDING;
+    //! the padding must be smaller than the window, so that every window
+    //! covers at least one element of the input
+    bool padding_ok = param.padding[0] < param.filter[0] &&
+                      param.padding[1] < param.filter[1];
+    return param.src_type.enumv() == DTypeEnum::Float32 &&
+           param.format == Param::Format::NCHW && mode_ok && padding_ok &&
+           aarch64::sve::preferred();
+}
+
+void PoolingImpl::AlgoFp32SVE::exec(const PoolingKernParam& param) const {
+    size_t IH = param.isz[0], IW = param.isz[1];
+    size_t OH = param.osz[0], OW = param.osz[1];
+    size_t FH = param.filter[0], FW = param.filter[1];
+    size_t SH = param.stride[0], SW = param.stride[1];
+    size_t PH = param.padding[0], PW = param.padding[1];
+    auto mode = param.mode;
+    auto src_ptr = param.src<float>();
+    auto dst_ptr = param.dst<float>();
+
+    MIDOUT_BEGIN(megdnn_arm_common_fp32_pooling_sve, midout_iv(0)) {
+        auto run = [=](size_t index, size_t) {
+            aarch64::sve::pooling_f32(
+                    mode, src_ptr + index * IH * IW, dst_ptr + index * OH * OW, IH,
+                    IW, OH, OW, FH, FW, SH, SW, PH, PW);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                static_cast<::megdnn::naive::HandleImpl*>(param.handle),
+                param.n * param.ic, run);
+    }
+    MIDOUT_END();
+}
+
+}  // namespace arm_common
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -33,10 +33,18 @@ private:
     AlgoFilter4ModexStridexNCHW44 algo_filter4_modex_stridex_nchw4;
     AlgoFilter5ModexStridexNCHW44 algo_filter5_modex_stridex_nchw4;
     AlgoFp32ModexStridexNCHW44 algo_fp32_modex_stridex_nchw44;
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+    AlgoFp32SVE algo_fp32_sve;
+#endif
     AlgoFallback algo_fallback;
 
 public:
     AlgoPack() {
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+        //! only usable with vectors wider than 128 bits, where it beats the
+        //! NEON kernels below
+        all_algos.emplace_back(&algo_fp32_sve);
+#endif
         all_algos.emplace_back(&algo_filterx_modex_stride1);
         all_algos.emplace_back(&algo_filter2_modex_stride2);
         all_algos.emplace_back(&algo_filter3_max_stride2);
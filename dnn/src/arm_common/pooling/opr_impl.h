@@ -32,6 +32,9 @@ private:
     class AlgoFilter4ModexStridexNCHW44;
     class AlgoFilter5ModexStridexNCHW44;
     class AlgoFp32ModexStridexNCHW44;
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+    class AlgoFp32SVE;
+#endif
     class AlgoFallback;
     class AlgoPack;
     static AlgoPack sm_algo_pack;
@@ -102,7 +105,8 @@ public:
             ARM_Filter4ModexStridexNCHW44,
             ARM_Filter5ModexStridexNCHW44,
             ARM_Fp32ModexStridexNCHW44,
-            ARM_Fallback
+            ARM_Fallback,
+            ARM_Fp32SVE
         };
 
         using Mapper = std::unordered_map<AlgorithmDesc, AlgoBase*>;
@@ -12,6 +12,7 @@
 
 #include <cstring>
 #include "src/arm_common/quantized_converter.h"
+#include "src/aarch64/sve/reduce.h"
 #include "src/arm_common/simd_macro/marm_neon.h"
 #include "src/common/reduce_helper.h"
 #include "src/common/unroll_macro.h"
@@ -804,6 +805,9 @@ struct Exec<Reducer, false> {
 void ReduceImpl::exec(
         _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
     check_exec(src.layout, dst.layout, workspace.size);
+    if (param().axis == TARGET_SHAPE_AXIS) {
+        return fallback::ReduceImpl::exec(src, dst, workspace);
+    }
     size_t A, B, C;
     reduce::get_ABC(src.layout, A, B, C, param().axis);
     bool execed = false;
@@ -889,7 +893,22 @@ void ReduceImpl::exec(
             src.layout.dtype.category() == DTypeCategory::FLOAT &&
             param().data_type == param::Reduce::DataType::DEFAULT) {
         DType src_type = src.layout.dtype;
-        if (src.layout.dtype.enumv() == DTypeEnum::Float32) {
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+        if (src.layout.dtype.enumv() == DTypeEnum::Float32 &&
+            aarch64::sve::preferred() &&
+            aarch64::sve::reduce_mode_supported(param().mode)) {
+            MIDOUT_BEGIN(megdnn_arm_common_reduce, midout_iv("sve_f32"_hash)) {
+                auto mode = param().mode;
+                auto sptr = src.ptr<dt_float32>();
+                auto dptr = dst.ptr<dt_float32>();
+                MEGDNN_DISPATCH_CPU_KERN_OPR(
+                        aarch64::sve::reduce_f32(mode, sptr, dptr, A, B, C));
+                execed = true;
+            }
+            MIDOUT_END();
+        }
+#endif
+        if (!execed && src.layout.dtype.enumv() == DTypeEnum::Float32) {
             DISPATCH_MODE_FLOAT(dt_float32, float, float)
         }
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC
@@ -0,0 +1,73 @@
+/**
+ * \file dnn/src/arm_common/relayout_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/arm_common/simd_macro/marm_neon.h"
+#include "src/common/relayout_helper.h"
+
+namespace megdnn {
+namespace arm_common {
+
+//! 4-byte element type whose transpose is implemented with neon
+struct TransposeWord {
+    uint32_t v;
+};
+
+//! transpose a 4x4 block of 32-bit values in registers
+static inline void trans_4x4_u32(
+        const uint32_t* src, uint32_t* dst, const size_t src_stride,
+        const size_t dst_stride) {
+    uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(src), vld1q_u32(src + src_stride));
+    uint32x4x2_t t23 = vtrnq_u32(
+            vld1q_u32(src + 2 * src_stride), vld1q_u32(src + 3 * src_stride));
+    vst1q_u32(dst, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+    vst1q_u32(
+            dst + dst_stride,
+            vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+    vst1q_u32(
+            dst + 2 * dst_stride,
+            vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+    vst1q_u32(
+            dst + 3 * dst_stride,
+            vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+}
+
+}  // namespace arm_common
+
+namespace relayout {
+namespace transpose_fallback {
+
+template <>
+struct transpose_traits<arm_common::TransposeWord> {
+    static constexpr size_t block_size = 8;
+};
+
+template <>
+inline void transpose_block<arm_common::TransposeWord>(
+        const arm_common::TransposeWord* src, arm_common::TransposeWord* dst,
+        const size_t src_stride, const size_t dst_stride) {
+    auto sptr = reinterpret_cast<const uint32_t*>(src);
+    auto dptr = reinterpret_cast<uint32_t*>(dst);
+    for (size_t i = 0; i < 8; i += 4) {
+        for (size_t j = 0; j < 8; j += 4) {
+            arm_common::trans_4x4_u32(
+                    sptr + i * src_stride + j, dptr + j * dst_stride + i, src_stride,
+                    dst_stride);
+        }
+    }
+}
+
+}  // namespace transpose_fallback
+}  // namespace relayout
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
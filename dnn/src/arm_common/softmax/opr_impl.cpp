@@ -0,0 +1,75 @@
+/**
+ * \file dnn/src/arm_common/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/softmax/opr_impl.h"
+#include "src/arm_common/elemwise/neon_mathfun.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace megdnn;
+using namespace arm_common;
+
+namespace {
+
+inline float reduce_max(float32x4_t v) {
+    float32x2_t x = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(x, x), 0);
+}
+
+inline float reduce_sum(float32x4_t v) {
+    float32x2_t x = vpadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(x, x), 0);
+}
+
+void softmax_rows_neon(const float* src, float* dst, size_t nr_row, size_t len) {
+    for (size_t r = 0; r < nr_row; ++r, src += len, dst += len) {
+        size_t i = 0;
+        float32x4_t vmax = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+        for (; i + 4 <= len; i += 4) {
+            vmax = vmaxq_f32(vmax, vld1q_f32(src + i));
+        }
+        float max_val = reduce_max(vmax);
+        for (; i < len; ++i) {
+            max_val = std::max(max_val, src[i]);
+        }
+
+        float32x4_t vsum = vdupq_n_f32(0.f);
+        vmax = vdupq_n_f32(max_val);
+        for (i = 0; i + 4 <= len; i += 4) {
+            float32x4_t v = exp_ps_f32(vsubq_f32(vld1q_f32(src + i), vmax));
+            vst1q_f32(dst + i, v);
+            vsum = vaddq_f32(vsum, v);
+        }
+        float sum = reduce_sum(vsum);
+        for (; i < len; ++i) {
+            dst[i] = std::exp(src[i] - max_val);
+            sum += dst[i];
+        }
+
+        float scale = 1.f / sum;
+        for (i = 0; i + 4 <= len; i += 4) {
+            vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(dst + i), scale));
+        }
+        for (; i < len; ++i) {
+            dst[i] *= scale;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+SoftmaxForwardImpl::RowKern SoftmaxForwardImpl::get_row_kern() const {
+    return softmax_rows_neon;
+}
+
+// vim: syntax=cpp.doxygen
@@ -9,6 +9,7 @@
  * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
+#include "src/arm_common/relayout_helper.h"
 #include "src/common/relayout_helper.h"
 #include "src/common/utils.h"
 
@@ -136,10 +137,15 @@ void armv7::RelayoutForwardImpl::exec(
     relayout::TransposeParam trans_param;
     bool trans = relayout::is_transpose(src.layout, dst.layout, trans_param);
     if (trans && trans_param.c == 1 && src0.layout.dtype.size() == 1) {
-        auto sptr = static_cast<TransposeByte*>(src.raw_ptr),
-             dptr = static_cast<TransposeByte*>(dst.raw_ptr);
-        MEGDNN_DISPATCH_CPU_KERN_OPR(transpose_fallback::transpose<TransposeByte>(
-                trans_param.batch, trans_param.m, trans_param.n, sptr, dptr));
+        dispatch_transpose<TransposeByte>(trans_param, src.raw_ptr, dst.raw_ptr);
+        return;
+    }
+    auto addr = reinterpret_cast<uintptr_t>(src.raw_ptr) |
+                reinterpret_cast<uintptr_t>(dst.raw_ptr);
+    if (trans && trans_param.c == 1 && src0.layout.dtype.size() == 4 &&
+        !(addr & (alignof(uint32_t) - 1))) {
+        dispatch_transpose<arm_common::TransposeWord>(
+                trans_param, src.raw_ptr, dst.raw_ptr);
         return;
     }
     exec_after_preprocess(src, dst, trans ? &trans_param : nullptr);
@@ -14,6 +14,14 @@
 
 namespace megdnn {
 
+void BNBase::check_param() {
+    megdnn_assert(
+            param().nonlineMode == Param::NonlineMode::IDENTITY ||
+                    param().nonlineMode == Param::NonlineMode::RELU,
+            "BN only supports fusing relu, got nonline mode %d",
+            static_cast<int>(param().nonlineMode));
+}
+
 void BNForward::deduce_layout(
         const TensorLayout& src, const TensorLayout&, const TensorLayout&,
         TensorLayout&, TensorLayout&, TensorLayout&, TensorLayout&,
@@ -28,6 +36,7 @@ void BNForward::check_exec(
         const TensorLayout& variance, const TensorLayout& batch_mean,
         const TensorLayout& batch_inv_variance, const TensorLayout& dst,
         size_t workspace_in_bytes, size_t reserve_in_bytes) {
+    check_param();
     megdnn_assert_contiguous(src);
     megdnn_assert_eq_layout(src, dst);
     megdnn_assert_eq_layout(bn_scale, bn_bias);
@@ -48,6 +57,7 @@ void BNBackward::check_exec(
         const TensorLayout& bn_scale, const TensorLayout& d_bn_scale,
         const TensorLayout& d_bn_bias, const TensorLayout& dx,
         size_t workspace_in_bytes, size_t reserve_in_bytes) {
+    check_param();
     megdnn_assert_contiguous(x);
     megdnn_assert_eq_layout(x, dy);
     megdnn_assert_eq_layout(x, dx);
@@ -0,0 +1,68 @@
+/**
+ * \file dnn/src/common/block_sparse_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void BlockSparseMatrixMulForward::deduce_layout(
+        const TensorLayout& values, const TensorLayout& col_idx,
+        const TensorLayout& row_ptr, const TensorLayout& src, TensorLayout& dst) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(values) + ", " + megdnn_layout_msg(col_idx) + ", " +
+               megdnn_layout_msg(row_ptr) + ", " + megdnn_layout_msg(src);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    size_t bh = param().block_h, bw = param().block_w;
+    megdnn_assert(
+            values.ndim == 3 && values[1] == bh && values[2] == bw && bh && bw,
+            "values should be of (nnz, block_h, block_w) shape: %s",
+            errmsg().c_str());
+    megdnn_assert(
+            col_idx.ndim == 1 && col_idx[0] == values[0] && row_ptr.ndim == 1 &&
+                    row_ptr[0] >= 1,
+            "invalid block sparse matrix: %s", errmsg().c_str());
+    megdnn_assert(src.ndim == 2 || src.ndim == 3, "%s", errmsg().c_str());
+    bool sparse_dense = param().mode == Param::Mode::SPARSE_DENSE;
+    size_t M = (row_ptr[0] - 1) * bh, K = src[src.ndim - (sparse_dense ? 2 : 1)];
+    megdnn_assert(
+            K % bw == 0, "K should be a multiple of block_w: %s", errmsg().c_str());
+    dst = src;
+    dst[dst.ndim - (sparse_dense ? 2 : 1)] = M;
+    dst.init_contiguous_stride();
+}
+
+void BlockSparseMatrixMulForward::check_exec(
+        const TensorLayout& values, const TensorLayout& col_idx,
+        const TensorLayout& row_ptr, const TensorLayout& src, const TensorLayout& dst,
+        size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(values);
+    megdnn_assert_contiguous(col_idx);
+    megdnn_assert_contiguous(row_ptr);
+    megdnn_assert_contiguous(src);
+    megdnn_assert_contiguous(dst);
+    megdnn_assert(values.dtype.category() == DTypeCategory::FLOAT);
+    megdnn_assert(
+            col_idx.dtype == dtype::Int32() && row_ptr.dtype == dtype::Int32(),
+            "indices of block sparse matrix should be of Int32");
+    megdnn_assert_eq_dtype(values, src);
+    megdnn_assert_eq_dtype(values, dst);
+    TensorLayout dst_expected;
+    deduce_layout(values, col_idx, row_ptr, src, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    auto required_workspace_in_bytes =
+            get_workspace_in_bytes(values, col_idx, row_ptr, src, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
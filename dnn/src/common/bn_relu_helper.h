@@ -0,0 +1,70 @@
+/**
+ * \file dnn/src/common/bn_relu_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megdnn/oprs.h"
+#include "src/common/utils.h"
+
+#include <algorithm>
+
+namespace megdnn {
+namespace bn_relu {
+
+/*!
+ * \brief whether the relu fused into a training BN is recorded as a mask in
+ *      reserve, so that BNBackward needs no activation other than x
+ */
+inline bool need_mask(const param::BN& param) {
+    return param.nonlineMode == param::BN::NonlineMode::RELU &&
+           param.fwd_mode == param::BN::FwdMode::TRAINING;
+}
+
+//! bytes of the mask of nr_elems elements, with one bit for each element
+inline size_t mask_in_bytes(size_t nr_elems) {
+    return div_ceil<size_t>(nr_elems, 32) * sizeof(uint32_t);
+}
+
+/*!
+ * \brief y = max(y, 0) on [begin, end), setting bit i of mask if y[i] > 0
+ *
+ * begin must be a multiple of 8; mask could be null if it is not needed.
+ */
+template <typename T>
+void forward(T* y, uint8_t* mask, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i += 8) {
+        uint8_t bits = 0;
+        for (size_t j = i; j < std::min(i + 8, end); ++j) {
+            if (y[j] > T(0)) {
+                bits |= 1 << (j - i);
+            } else {
+                y[j] = T(0);
+            }
+        }
+        if (mask) {
+            mask[i / 8] = bits;
+        }
+    }
+}
+
+//! masked_dy[i] = dy[i] if bit i of mask is set else 0, for i in [begin, end)
+template <typename T>
+void backward(
+        const T* dy, const uint8_t* mask, T* masked_dy, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        masked_dy[i] = (mask[i / 8] >> (i % 8)) & 1 ? dy[i] : T(0);
+    }
+}
+
+}  // namespace bn_relu
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
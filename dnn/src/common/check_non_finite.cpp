@@ -31,6 +31,33 @@ void CheckNonFinite::deduce_layout(const TensorLayout&, TensorLayout& dst) {
     dst.init_contiguous_stride();
 }
 
+void CheckNonFiniteV2::check_exec(
+        const TensorNDArray& srcs, const TensorND& dst, size_t workspace_in_bytes) {
+    for (auto&& src : srcs) {
+        if (!src.layout.is_empty()) {
+            megdnn_assert_contiguous(src.layout);
+        }
+        megdnn_assert(
+                src.layout.dtype == dtype::Float32(),
+                "CheckNonFiniteV2 only supports float32 inputs, got %s",
+                src.layout.dtype.name());
+    }
+    megdnn_assert_contiguous(dst.layout);
+    megdnn_assert(
+            dst.layout.total_nr_elems() == 1 && dst.layout.dtype == dtype::Int32(),
+            "the output of CheckNonFiniteV2 should be an int32 scalar, got %s",
+            dst.layout.to_string().c_str());
+    auto required_workspace_in_bytes = get_workspace_in_bytes(srcs, dst.layout);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+void CheckNonFiniteV2::deduce_layout(const TensorLayoutArray&, TensorLayout& dst) {
+    dst.shape[0] = 1;
+    dst.ndim = 1;
+    dst.dtype = dtype::Int32();
+    dst.init_contiguous_stride();
+}
+
 }  // namespace megdnn
 
 // vim: syntax=cpp.doxygen
@@ -266,4 +266,57 @@ const char* uarch_to_string(enum cpuinfo_uarch uarch) {
 }  // namespace megdnn
 #endif
 
+#if MEGDNN_AARCH64 && (MGB_ENABLE_I8MM || MGB_ENABLE_SVE)
+#include "cpuinfo_arch_vendor.h"
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+namespace {
+//! bits of AT_HWCAP and AT_HWCAP2 defined in arch/arm64/include/uapi/asm/hwcap.h
+constexpr unsigned long HWCAP_SVE_BIT = 1ul << 22;
+constexpr unsigned long HWCAP2_I8MM_BIT = 1ul << 13;
+constexpr unsigned long HWCAP2_BF16_BIT = 1ul << 14;
+
+unsigned long get_hwcap() {
+#if defined(__linux__) && defined(AT_HWCAP)
+    return getauxval(AT_HWCAP);
+#else
+    return 0;
+#endif
+}
+
+unsigned long get_hwcap2() {
+#if defined(__linux__) && defined(AT_HWCAP2)
+    return getauxval(AT_HWCAP2);
+#else
+    return 0;
+#endif
+}
+}  // anonymous namespace
+
+namespace megdnn {
+
+#if MGB_ENABLE_I8MM
+bool arm_has_i8mm() {
+    static const bool ret = get_hwcap2() & HWCAP2_I8MM_BIT;
+    return ret;
+}
+
+bool arm_has_bf16() {
+    static const bool ret = get_hwcap2() & HWCAP2_BF16_BIT;
+    return ret;
+}
+#endif
+
+#if MGB_ENABLE_SVE
+bool arm_has_sve() {
+    static const bool ret = get_hwcap() & HWCAP_SVE_BIT;
+    return ret;
+}
+#endif
+
+}  // namespace megdnn
+#endif
+
 // vim: syntax=cpp.doxygen
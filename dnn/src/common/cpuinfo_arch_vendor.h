@@ -24,4 +24,30 @@ const char* uarch_to_string(enum cpuinfo_uarch uarch);
 }  // namespace megdnn
 #endif
 
+#if MEGDNN_AARCH64 && (MGB_ENABLE_I8MM || MGB_ENABLE_SVE)
+namespace megdnn {
+
+/*
+ * The cpuinfo version we depend on does not report the armv8.6 features and
+ * SVE, so they are read from the hwcaps of the kernel; false is returned on
+ * systems without hwcaps.
+ */
+
+#if MGB_ENABLE_I8MM
+//! whether the cpu supports the int8 matrix multiply instructions (smmla,
+//! ummla) of armv8.6
+bool arm_has_i8mm();
+
+//! whether the cpu supports the bf16 instructions (bfmmla) of armv8.6
+bool arm_has_bf16();
+#endif
+
+#if MGB_ENABLE_SVE
+//! whether the cpu supports the scalable vector extension
+bool arm_has_sve();
+#endif
+
+}  // namespace megdnn
+#endif
+
 // vim: syntax=cpp.doxygen
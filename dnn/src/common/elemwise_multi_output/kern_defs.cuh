@@ -0,0 +1,54 @@
+/**
+ * \file dnn/src/common/elemwise_multi_output/kern_defs.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megdnn/dtype.h"
+#include "src/common/utils.cuh"
+
+#include <cmath>
+
+namespace megdnn {
+namespace elemwise_multi_output {
+
+/*!
+ * Each op reads one element of every input from \p src and writes one
+ * element of each of the two outputs to \p dst; computation is done in
+ * float regardless of ctype.
+ */
+
+//! dst = {sigmoid(x), sigmoid(x) * y}
+template <typename ctype>
+struct SigmoidMulOp {
+    MEGDNN_HOST MEGDNN_DEVICE void operator()(ctype* dst, const ctype* src) const {
+        float s = 1.f / (1.f + expf(-static_cast<float>(src[0])));
+        dst[0] = static_cast<ctype>(s);
+        dst[1] = static_cast<ctype>(s * static_cast<float>(src[1]));
+    }
+};
+
+//! dst = {param - lr * buf1, buf1}, where buf1 = momentum * buf + grad
+template <typename ctype>
+struct MomentumUpdateOp {
+    float momentum, lr;
+
+    MEGDNN_HOST MEGDNN_DEVICE void operator()(ctype* dst, const ctype* src) const {
+        float buf =
+                momentum * static_cast<float>(src[1]) + static_cast<float>(src[2]);
+        dst[0] = static_cast<ctype>(static_cast<float>(src[0]) - lr * buf);
+        dst[1] = static_cast<ctype>(buf);
+    }
+};
+
+}  // namespace elemwise_multi_output
+}  // namespace megdnn
+
+// vim: ft=cpp syntax=cpp.doxygen
@@ -0,0 +1,55 @@
+/**
+ * \file dnn/src/common/elemwise_multi_output/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megdnn/oprs.h"
+#include "src/common/utils.h"
+
+using namespace megdnn;
+
+size_t ElemwiseMultiOutput::nr_inputs(Mode mode) {
+    switch (mode) {
+        case Mode::SIGMOID_MUL:
+            return 2;
+        case Mode::MOMENTUM_UPDATE:
+            return 3;
+        default:
+            megdnn_throw("bad ElemwiseMultiOutput mode");
+    }
+}
+
+void ElemwiseMultiOutput::deduce_layout(
+        const TensorLayoutArray& src, TensorLayoutArray& dst) {
+    megdnn_assert(src.size() == nr_inputs(param().mode));
+    TensorShapeArray src_shp;
+    for (auto&& i : src) {
+        megdnn_assert_eq_dtype(src[0], i);
+        src_shp.push_back(i);
+    }
+    megdnn_assert(src[0].dtype.category() == DTypeCategory::FLOAT);
+    TensorLayout out;
+    Elemwise::deduce_shape(src_shp, out);
+    out.dtype = src[0].dtype;
+    out.init_contiguous_stride();
+    dst = {out, out};
+}
+
+void ElemwiseMultiOutput::check_layout_and_broadcast(
+        const TensorLayoutPtrArray& src, const TensorLayout& dst) {
+    megdnn_assert(src.size() == nr_inputs(param().mode));
+    megdnn_assert(dst.dtype.category() == DTypeCategory::FLOAT);
+    for (auto i : src) {
+        megdnn_assert_eq_dtype((*i), dst);
+        *i = i->broadcast(dst);
+    }
+    megdnn_assert_contiguous(dst);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/common/elemwise_multi_output/opr_impl_helper.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./opr_impl_helper.h"
+#include "src/common/utils.h"
+
+using namespace megdnn;
+
+template <int arity>
+ElemwiseOpParamN<arity> ElemwiseMultiOutputImplHelper::make_elemwise_op_param(
+        const TensorNDArray& src, const TensorNDArray& dst) {
+    megdnn_assert(dst.size() == 2);
+    megdnn_assert_eq_layout(dst[0].layout, dst[1].layout);
+    return ElemwiseLayoutHelper::make_elemwise_op_param<arity>(
+            this, call_check_layout_and_broadcast, src, dst[0]);
+}
+
+void ElemwiseMultiOutputImplHelper::exec(
+        _megdnn_in const TensorNDArray& src, _megdnn_out const TensorNDArray& dst) {
+    switch (m_param.mode) {
+        case Mode::SIGMOID_MUL:
+            on_sigmoid_mul(make_elemwise_op_param<2>(src, dst), dst);
+            break;
+        case Mode::MOMENTUM_UPDATE:
+            on_momentum_update(make_elemwise_op_param<3>(src, dst), dst);
+            break;
+        default:
+            megdnn_throw("invalid mode");
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,49 @@
+/**
+ * \file dnn/src/common/elemwise_multi_output/opr_impl_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megdnn/oprs/nn_int.h"
+#include "src/common/elemwise/opr_impl_helper.h"
+
+namespace megdnn {
+
+class ElemwiseMultiOutputImplHelper : public ElemwiseMultiOutput,
+                                      protected ElemwiseLayoutHelper {
+    static void call_check_layout_and_broadcast(
+            void* opr, const TensorLayoutPtrArray& src, const TensorLayout& dst) {
+        return static_cast<ElemwiseMultiOutputImplHelper*>(opr)
+                ->check_layout_and_broadcast(src, dst);
+    }
+
+    template <int arity>
+    ElemwiseOpParamN<arity> make_elemwise_op_param(
+            const TensorNDArray& src, const TensorNDArray& dst);
+
+protected:
+    //! dst contains two contiguous tensors with the same layout
+    virtual void on_sigmoid_mul(
+            const ElemwiseOpParamN<2>& param, const TensorNDArray& dst) = 0;
+
+    virtual void on_momentum_update(
+            const ElemwiseOpParamN<3>& param, const TensorNDArray& dst) = 0;
+
+public:
+    using ElemwiseMultiOutput::ElemwiseMultiOutput;
+
+    void exec(
+            _megdnn_in const TensorNDArray& src,
+            _megdnn_out const TensorNDArray& dst) override final;
+};
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,65 @@
+/**
+ * \file dnn/src/common/embedding_bag.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void EmbeddingBagForward::deduce_layout(
+        const TensorLayout& weight, const TensorLayout& indices,
+        const TensorLayout& offsets, TensorLayout& dst) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(weight) + ", " + megdnn_layout_msg(indices) + ", " +
+               megdnn_layout_msg(offsets);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(
+            weight.ndim == 2 && indices.ndim == 1 && offsets.ndim == 1,
+            "invalid layouts for EmbeddingBag: %s", errmsg().c_str());
+    size_t dim = weight[1];
+    if (weight.dtype == dtype::Uint8()) {
+        megdnn_assert(
+                dim >= QUANT_ROW_EXTRA_BYTES,
+                "quantized rows should have the scale and bias: %s",
+                errmsg().c_str());
+        dim -= QUANT_ROW_EXTRA_BYTES;
+    }
+    dst = TensorLayout{{offsets[0], dim}, dtype::Float32()};
+}
+
+void EmbeddingBagForward::check_exec(
+        const TensorLayout& weight, const TensorLayout& indices,
+        const TensorLayout& offsets, const TensorLayout& dst,
+        size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(weight);
+    megdnn_assert_contiguous(indices);
+    megdnn_assert_contiguous(offsets);
+    megdnn_assert_contiguous(dst);
+    megdnn_assert(
+            weight.dtype == dtype::Float32() ||
+                    DNN_FLOAT16_SELECT(weight.dtype == dtype::Float16(), false) ||
+                    weight.dtype == dtype::Uint8(),
+            "unsupported dtype of embedding table: %s", weight.dtype.name());
+    megdnn_assert(
+            indices.dtype == dtype::Int32() && offsets.dtype == dtype::Int32(),
+            "indices and offsets of EmbeddingBag should be of Int32");
+    TensorLayout dst_expected;
+    deduce_layout(weight, indices, offsets, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    auto required_workspace_in_bytes =
+            get_workspace_in_bytes(weight, indices, offsets, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,53 @@
+/**
+ * \file dnn/src/common/fused_attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void FusedAttentionForward::deduce_layout(
+        const TensorLayout& query, const TensorLayout& key, const TensorLayout& value,
+        TensorLayout& dst) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(query) + ", " + megdnn_layout_msg(key) + ", " +
+               megdnn_layout_msg(value);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(
+            query.ndim == 3 && key.ndim == 3 && value.ndim == 3, "%s",
+            errmsg().c_str());
+    megdnn_assert(
+            query[0] == key[0] && key[0] == value[0] && query[2] == key[2] &&
+                    key[1] == value[1],
+            "shape mismatch for attention: %s", errmsg().c_str());
+    dst = TensorLayout{{query[0], query[1], value[2]}, query.dtype};
+}
+
+void FusedAttentionForward::check_exec(
+        const TensorLayout& query, const TensorLayout& key, const TensorLayout& value,
+        const TensorLayout& dst, size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(query);
+    megdnn_assert_contiguous(key);
+    megdnn_assert_contiguous(value);
+    megdnn_assert_contiguous(dst);
+    megdnn_assert(query.dtype.category() == DTypeCategory::FLOAT);
+    megdnn_assert_eq_dtype(query, key);
+    megdnn_assert_eq_dtype(query, value);
+    TensorLayout dst_expected;
+    deduce_layout(query, key, value, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(query, key, value, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,101 @@
+/**
+ * \file dnn/src/common/group_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void GroupNormBase::deduce_layout_fwd(
+        const TensorLayout& data, const TensorLayout&, const TensorLayout&,
+        TensorLayout& dst, TensorLayout& mean, TensorLayout& rstd) {
+    megdnn_assert(
+            data.ndim >= 2, "group norm requires (N, C, ...) input, got %s",
+            data.to_string().c_str());
+    size_t group = param().group;
+    megdnn_assert(
+            group >= 1 && data.shape[1] % group == 0,
+            "number of channels %zu is not divisible by group %zu", data.shape[1],
+            group);
+    dst = TensorLayout{data, data.dtype};
+    mean = TensorLayout{{data.shape[0], group}, dtype::Float32()};
+    rstd = mean;
+}
+
+void GroupNormBase::check_layout_fwd(
+        const TensorLayout& data, const TensorLayout& weight,
+        const TensorLayout& bias, const TensorLayout& dst, const TensorLayout& mean,
+        const TensorLayout& rstd) {
+    megdnn_assert_contiguous(data);
+    megdnn_assert(data.dtype.category() == DTypeCategory::FLOAT);
+    TensorLayout dst_expected, mean_expected, rstd_expected;
+    deduce_layout_fwd(data, weight, bias, dst_expected, mean_expected, rstd_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    megdnn_assert_eq_layout(mean_expected, mean);
+    megdnn_assert_eq_layout(rstd_expected, rstd);
+    if (param().affine) {
+        megdnn_assert_contiguous(weight);
+        megdnn_assert_eq_dtype(data, weight);
+        megdnn_assert_eq_layout(weight, bias);
+        megdnn_assert(
+                weight.ndim == 1 && weight.shape[0] == data.shape[1],
+                "weight shape %s mismatches data shape %s",
+                weight.to_string().c_str(), data.to_string().c_str());
+    }
+}
+
+void GroupNormForward::deduce_layout(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        TensorLayout& dst, TensorLayout& mean, TensorLayout& rstd) {
+    deduce_layout_fwd(data, weight, bias, dst, mean, rstd);
+}
+
+void GroupNormForward::check_exec(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        const TensorLayout& dst, const TensorLayout& mean, const TensorLayout& rstd,
+        size_t workspace_in_bytes) {
+    check_layout_fwd(data, weight, bias, dst, mean, rstd);
+    auto required_workspace_in_bytes =
+            get_workspace_in_bytes(data, weight, bias, dst, mean, rstd);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+void GroupNormBackward::deduce_layout(
+        const TensorLayout&, const TensorLayout& data, const TensorLayout& weight,
+        const TensorLayout&, const TensorLayout&, TensorLayout& ddata,
+        TensorLayout& dweight, TensorLayout& dbias) {
+    ddata = data;
+    if (param().affine) {
+        dweight = weight;
+        dbias = weight;
+    } else {
+        dweight = dbias = TensorLayout{data.dtype};
+    }
+}
+
+void GroupNormBackward::check_exec(
+        const TensorLayout& diff, const TensorLayout& data, const TensorLayout& weight,
+        const TensorLayout& mean, const TensorLayout& rstd, const TensorLayout& ddata,
+        const TensorLayout& dweight, const TensorLayout& dbias,
+        size_t workspace_in_bytes) {
+    check_layout_fwd(data, weight, weight, diff, mean, rstd);
+    megdnn_assert_eq_layout(data, ddata);
+    if (param().affine) {
+        megdnn_assert_eq_layout(weight, dweight);
+        megdnn_assert_eq_layout(weight, dbias);
+    }
+    auto required_workspace_in_bytes = get_workspace_in_bytes(
+            diff, data, weight, mean, rstd, ddata, dweight, dbias);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
@@ -141,12 +141,12 @@ private:
                                                                                                                                                                                                                                                                                             cb(DctChannelSelectForward) cb(FakeQuantForward) cb(FakeQuantBackward)                                                                                                                                                                                      \
                                                                                                                                                                                                                                                                                                     cb(TQTForward) cb(                                                                                                                                                                                                                                  \
                                                                                                                                                                                                                                                                                                             TQTBackward)                                                                                                                                                                                                                                \
-                                                                                                                                                                                                                                                                                                            cb(CheckNonFinite)                                                                                                                                                                                                                          \
+                                                                                                                                                                                                                                                                                                            cb(CheckNonFinite) cb(CheckNonFiniteV2)                                                                                                                                                                                                     \
                                                                                                                                                                                                                                                                                                                     cb(LSQForward) cb(                                                                                                                                                                                                                  \
                                                                                                                                                                                                                                                                                                                             LSQBackward)                                                                                                                                                                                                                \
                                                                                                                                                                                                                                                                                                                             cb(Fill) cb(                                                                                                                                                                                                                \
                                                                                                                                                                                                                                                                                                                                     PaddingForward)                                                                                                                                                                                                     \
-                                                                                                                                                                                                                                                                                                                                    cb(PaddingBackward)
+                                                                                                                                                                                                                                                                                                                                    cb(PaddingBackward) cb(SoftmaxForward) cb(SoftmaxBackward) cb(LayerNormForward) cb(LayerNormBackward) cb(GroupNormForward) cb(GroupNormBackward) cb(FusedAttentionForward) cb(BlockSparseMatrixMulForward) cb(WeightQuantMatrixMulForward) cb(ImagePreprocessForward) cb(ElemwiseMultiOutput) cb(EmbeddingBagForward)
 
 /*!
  * \brief specialize HandleImpl::create_operator for a single opr type;
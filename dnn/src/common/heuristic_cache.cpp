@@ -26,6 +26,9 @@
 
 using namespace megdnn;
 
+constexpr size_t HeuristicCache::DEFAULT_CAPACITY;
+constexpr size_t HeuristicCache::NR_SHARD;
+
 HeuristicCache& HeuristicCache::instance() {
     static HeuristicCache ins;
     return ins;
@@ -120,24 +123,73 @@ HeuristicCache::KeyStorage HeuristicCache::Key::build_key_storage() const {
     return {ctg, inp};
 }
 
+HeuristicCache::HashedKey HeuristicCache::make_hashed_key(const Key& key) {
+    HashedKey ret{key.build_key_storage(), 0};
+    ret.hash = Hash{}(ret.key);
+    return ret;
+}
+
+HeuristicCache::Shard& HeuristicCache::get_shard(const HashedKey& key) {
+    // low bits are used by the hash table of each shard
+    return m_shards[(key.hash >> 16) % NR_SHARD];
+}
+
 void HeuristicCache::put(const Key& key, Result& result) {
-    MEGDNN_LOCK_GUARD(m_mtx);
-    if (result.policy.algo.valid())
-        m_heuristic_cache[key.build_key_storage()] = result;
+    if (!result.policy.algo.valid())
+        return;
+    auto hashed_key = make_hashed_key(key);
+    auto&& shard = get_shard(hashed_key);
+    size_t capacity = m_capacity;
+    size_t shard_capacity = (capacity + NR_SHARD - 1) / NR_SHARD;
+
+    MEGDNN_LOCK_GUARD(shard.mtx);
+    auto iter = shard.index.find(&hashed_key);
+    if (iter != shard.index.end()) {
+        iter->second->second = result;
+        shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+        return;
+    }
+    shard.lru.emplace_front(std::move(hashed_key), result);
+    shard.index.emplace(&shard.lru.front().first, shard.lru.begin());
+    while (capacity && shard.lru.size() > shard_capacity) {
+        shard.index.erase(&shard.lru.back().first);
+        shard.lru.pop_back();
+        ++shard.nr_eviction;
+    }
 }
 
 HeuristicCache::Result HeuristicCache::get(const Key& key) {
-    MEGDNN_LOCK_GUARD(m_mtx);
-    KeyStorage ks = key.build_key_storage();
-    auto iter = m_heuristic_cache.find(ks);
-    if (iter == m_heuristic_cache.end()) {
+    auto hashed_key = make_hashed_key(key);
+    auto&& shard = get_shard(hashed_key);
+
+    MEGDNN_LOCK_GUARD(shard.mtx);
+    auto iter = shard.index.find(&hashed_key);
+    if (iter == shard.index.end()) {
+        ++shard.nr_miss;
         return {};
-    } else {
-        return iter->second;
     }
+    ++shard.nr_hit;
+    shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+    return iter->second->second;
 }
 
 void HeuristicCache::clear() {
-    MEGDNN_LOCK_GUARD(m_mtx);
-    m_heuristic_cache.clear();
-}
\ No newline at end of file
+    for (auto&& shard : m_shards) {
+        MEGDNN_LOCK_GUARD(shard.mtx);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.nr_hit = shard.nr_miss = shard.nr_eviction = 0;
+    }
+}
+
+HeuristicCache::Stats HeuristicCache::stats() {
+    Stats ret;
+    for (auto&& shard : m_shards) {
+        MEGDNN_LOCK_GUARD(shard.mtx);
+        ret.nr_hit += shard.nr_hit;
+        ret.nr_miss += shard.nr_miss;
+        ret.nr_eviction += shard.nr_eviction;
+        ret.size += shard.lru.size();
+    }
+    return ret;
+}
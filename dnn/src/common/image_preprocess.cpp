@@ -0,0 +1,75 @@
+/**
+ * \file dnn/src/common/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void ImagePreprocessForward::check_exec(
+        const TensorLayout& src, const TensorLayout& scale, const TensorLayout& bias,
+        const TensorLayout& dst, size_t workspace_in_bytes) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(src) + ", " + megdnn_layout_msg(scale) + ", " +
+               megdnn_layout_msg(bias) + ", " + megdnn_layout_msg(dst);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert_contiguous(src);
+    megdnn_assert_contiguous(scale);
+    megdnn_assert_contiguous(bias);
+    megdnn_assert_contiguous(dst);
+    megdnn_assert(
+            src.dtype == dtype::Uint8() && scale.dtype == dtype::Float32() &&
+                    bias.dtype == dtype::Float32() && dst.dtype == dtype::Float32(),
+            "image preprocess takes uint8 images and float32 scales: %s",
+            errmsg().c_str());
+    megdnn_assert(
+            scale.ndim == 1 && scale[0] == 3 && bias.ndim == 1 && bias[0] == 3,
+            "scale and bias should be of 3 channels: %s", errmsg().c_str());
+
+    using Mode = Param::Mode;
+    using Format = Param::Format;
+    bool yuv = param().mode != Mode::RGB && param().mode != Mode::RGB2BGR;
+    megdnn_assert(src.ndim == 4 && src[3] == (yuv ? 1u : 3u), "%s", errmsg().c_str());
+    if (yuv) {
+        megdnn_assert(
+                src[1] % 3 == 0 && src[2] % 2 == 0,
+                "yuv image should be of even height and width: %s", errmsg().c_str());
+    }
+    megdnn_assert(
+            param().imode == Param::InterpolationMode::NEAREST ||
+                    param().imode == Param::InterpolationMode::LINEAR,
+            "unsupported interpolation mode of image preprocess");
+    size_t OH, OW;
+    if (param().format == Format::NCHW) {
+        megdnn_assert(dst.ndim == 4 && dst[1] == 3, "%s", errmsg().c_str());
+        OH = dst[2];
+        OW = dst[3];
+    } else if (param().format == Format::NHWC) {
+        megdnn_assert(dst.ndim == 4 && dst[3] == 3, "%s", errmsg().c_str());
+        OH = dst[1];
+        OW = dst[2];
+    } else {
+        megdnn_assert(
+                param().format == Format::NCHW44,
+                "image preprocess only supports NCHW, NHWC and NCHW44 outputs");
+        megdnn_assert(
+                dst.ndim == 5 && dst[1] == 1 && dst[4] == 4, "%s", errmsg().c_str());
+        OH = dst[2];
+        OW = dst[3];
+    }
+    megdnn_assert(dst[0] == src[0] && OH && OW, "%s", errmsg().c_str());
+    auto required_workspace_in_bytes = get_workspace_in_bytes(src, scale, bias, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,88 @@
+/**
+ * \file dnn/src/common/image_preprocess.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megdnn/arch.h"
+#include "src/common/opr_param_defs_enumv.cuh"
+
+#include <math.h>
+#include <stdint.h>
+
+namespace megdnn {
+namespace image_preprocess {
+
+using Mode = param_enumv::ImagePreprocess::Mode;
+
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE int clamp_u8(int x) {
+    return x > 255 ? 255 : (x < 0 ? 0 : x);
+}
+
+/*!
+ * \brief load pixel (h, w) of an image of height ih and width iw in the channel
+ *      order of the output; the same as CvtColor for the YUV modes
+ */
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE void load_pixel(
+        const uint8_t* sptr, int ih, int iw, int h, int w, uint32_t mode, int* pixel) {
+    if (mode == Mode::RGB || mode == Mode::RGB2BGR) {
+        const uint8_t* p = sptr + (h * iw + w) * 3;
+        bool swap = mode == Mode::RGB2BGR;
+        pixel[0] = p[swap ? 2 : 0];
+        pixel[1] = p[1];
+        pixel[2] = p[swap ? 0 : 2];
+        return;
+    }
+    int y = sptr[h * iw + w];
+    const uint8_t* uv = sptr + (ih + h / 2) * iw + (w & ~1);
+    bool nv12 = mode == Mode::YUV2RGB_NV12 || mode == Mode::YUV2BGR_NV12;
+    int u = nv12 ? uv[0] : uv[1], v = nv12 ? uv[1] : uv[0];
+    int r = clamp_u8(y + ((359 * (v - 128)) >> 8));
+    int g = clamp_u8(y - ((88 * (u - 128) + 183 * (v - 128)) >> 8));
+    int b = clamp_u8(y + ((454 * (u - 128)) >> 8));
+    bool rgb = mode == Mode::YUV2RGB_NV21 || mode == Mode::YUV2RGB_NV12;
+    pixel[0] = rgb ? r : b;
+    pixel[1] = g;
+    pixel[2] = rgb ? b : r;
+}
+
+//! source coords of linear interpolation, the same as Resize; the weight of
+//! i1 is alpha and that of i0 is 1 - alpha
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE void get_linear_coord(
+        float scale, int size, int idx, int& i0, int& i1, float& alpha) {
+    if (size == 1) {
+        i0 = i1 = 0;
+        alpha = 0;
+        return;
+    }
+    alpha = (idx + 0.5f) / scale - 0.5f;
+    i0 = static_cast<int>(floorf(alpha));
+    alpha -= i0;
+    if (i0 < 0) {
+        i0 = 0;
+        alpha = 0;
+    } else if (i0 + 1 >= size) {
+        i0 = size - 2;
+        alpha = 1;
+    }
+    i1 = i0 + 1;
+}
+
+//! source coord of nearest interpolation, the same as Resize
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE int get_nearest_coord(
+        float scale, int size, int idx) {
+    int origin = static_cast<int>(idx / scale);
+    return origin < size - 1 ? origin : size - 1;
+}
+
+}  // namespace image_preprocess
+}  // namespace megdnn
+
+/* vim: set ft=cpp: */
@@ -0,0 +1,119 @@
+/**
+ * \file dnn/src/common/layer_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void LayerNormBase::deduce_layout_fwd(
+        const TensorLayout& data, const TensorLayout&, const TensorLayout&,
+        TensorLayout& dst, TensorLayout& mean, TensorLayout& rstd) {
+    size_t normalized_dim = param().normalized_dim;
+    megdnn_assert(
+            normalized_dim >= 1 && normalized_dim <= data.ndim,
+            "invalid normalized_dim %zu for %zu-dim tensor", normalized_dim,
+            data.ndim);
+    TensorShape unnormalized_shape;
+    unnormalized_shape.ndim = std::max<size_t>(data.ndim - normalized_dim, 1);
+    unnormalized_shape.shape[0] = 1;
+    for (size_t i = 0; i < data.ndim - normalized_dim; ++i) {
+        unnormalized_shape.shape[i] = data.shape[i];
+    }
+    dst = TensorLayout{data, data.dtype};
+    mean = TensorLayout{unnormalized_shape, dtype::Float32()};
+    rstd = mean;
+}
+
+void LayerNormBase::check_layout_fwd(
+        const TensorLayout& data, const TensorLayout& weight,
+        const TensorLayout& bias, const TensorLayout& dst, const TensorLayout& mean,
+        const TensorLayout& rstd) {
+    megdnn_assert_contiguous(data);
+    megdnn_assert(data.dtype.category() == DTypeCategory::FLOAT);
+    TensorLayout dst_expected, mean_expected, rstd_expected;
+    deduce_layout_fwd(data, weight, bias, dst_expected, mean_expected, rstd_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    megdnn_assert_eq_layout(mean_expected, mean);
+    megdnn_assert_eq_layout(rstd_expected, rstd);
+
+    size_t normalized_dim = param().normalized_dim;
+    size_t normalized_size = 1;
+    for (size_t i = data.ndim - normalized_dim; i < data.ndim; ++i) {
+        normalized_size *= data.shape[i];
+    }
+    megdnn_assert(
+            normalized_size == param().normalized_size,
+            "normalized_size mismatch: expected %zu, got %zu", normalized_size,
+            static_cast<size_t>(param().normalized_size));
+    if (param().affine) {
+        megdnn_assert_contiguous(weight);
+        megdnn_assert_eq_dtype(data, weight);
+        megdnn_assert_eq_layout(weight, bias);
+        megdnn_assert(
+                weight.ndim == normalized_dim, "weight should be %zu-dim, got %s",
+                normalized_dim, weight.to_string().c_str());
+        for (size_t i = 0; i < normalized_dim; ++i) {
+            megdnn_assert(
+                    weight.shape[i] == data.shape[data.ndim - normalized_dim + i],
+                    "weight shape %s mismatches data shape %s",
+                    weight.to_string().c_str(), data.to_string().c_str());
+        }
+    }
+}
+
+void LayerNormForward::deduce_layout(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        TensorLayout& dst, TensorLayout& mean, TensorLayout& rstd) {
+    deduce_layout_fwd(data, weight, bias, dst, mean, rstd);
+}
+
+void LayerNormForward::check_exec(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        const TensorLayout& dst, const TensorLayout& mean, const TensorLayout& rstd,
+        size_t workspace_in_bytes) {
+    check_layout_fwd(data, weight, bias, dst, mean, rstd);
+    auto required_workspace_in_bytes =
+            get_workspace_in_bytes(data, weight, bias, dst, mean, rstd);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+void LayerNormBackward::deduce_layout(
+        const TensorLayout&, const TensorLayout& data, const TensorLayout& weight,
+        const TensorLayout&, const TensorLayout&, TensorLayout& ddata,
+        TensorLayout& dweight, TensorLayout& dbias) {
+    ddata = data;
+    if (param().affine) {
+        dweight = weight;
+        dbias = weight;
+    } else {
+        dweight = dbias = TensorLayout{data.dtype};
+    }
+}
+
+void LayerNormBackward::check_exec(
+        const TensorLayout& diff, const TensorLayout& data, const TensorLayout& weight,
+        const TensorLayout& mean, const TensorLayout& rstd, const TensorLayout& ddata,
+        const TensorLayout& dweight, const TensorLayout& dbias,
+        size_t workspace_in_bytes) {
+    check_layout_fwd(data, weight, weight, diff, mean, rstd);
+    megdnn_assert_eq_layout(data, ddata);
+    if (param().affine) {
+        megdnn_assert_eq_layout(weight, dweight);
+        megdnn_assert_eq_layout(weight, dbias);
+    }
+    auto required_workspace_in_bytes = get_workspace_in_bytes(
+            diff, data, weight, mean, rstd, ddata, dweight, dbias);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
@@ -55,6 +55,13 @@ DEF(GroupLocalBackwardData, 3, true, false);
 DEF(GroupLocalBackwardFilter, 3, true, false);
 DEF(LRNForward, 2, true, true);
 DEF(LRNBackward, 4, true, false);
+DEF(SoftmaxForward, 2, true, true);
+DEF(SoftmaxBackward, 3, true, false);
+DEF(LayerNormForward, 6, true, true);
+DEF(LayerNormBackward, 8, true, true);
+DEF(GroupNormForward, 6, true, true);
+DEF(GroupNormBackward, 8, true, true);
+DEF(FusedAttentionForward, 4, true, true);
 DEF(BNForward, 9, true, true);
 DEF(BNBackward, 9, true, false);
 DEF(ROIPoolingForward, 4, true, false);
@@ -71,6 +78,8 @@ DEF(MatrixMulForward, 3, true, true);
 DEF(BatchedMatrixMulForward, 3, true, true);
 DEF(MatrixInverse, 2, true, true);
 DEF(SVDForward, 4, true, true);
+DEF(BlockSparseMatrixMulForward, 5, true, true);
+DEF(WeightQuantMatrixMulForward, 4, true, true);
 DEF(ReduceForward, 2, true, true);
 DEF(CumsumForward, 2, true, true);
 DEF(ArgmaxForward, 2, true, true);
@@ -96,8 +105,10 @@ DEF(WarpAffine, 3, true, false);
 DEF(GaussianBlur, 2, true, true);
 DEF(Resize, 2, true, false);
 DEF(ResizeBackward, 2, true, false);
+DEF(ImagePreprocessForward, 4, true, false);
 DEF(IndexingOneHot, 3, true, true);
 DEF(IndexingSetOneHot, 3, true, false);
+DEF(EmbeddingBagForward, 4, true, true);
 DEF(MaskConvolution, 4, true, true);
 DEF(MaskPropagate, 2, true, true);
 DEF(RelayoutFormat, 2, true, true);
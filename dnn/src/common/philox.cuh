@@ -0,0 +1,108 @@
+/**
+ * \file dnn/src/common/philox.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#pragma once
+
+#include "megdnn/arch.h"
+
+#include <math.h>
+#include <stdint.h>
+
+namespace megdnn {
+namespace philox {
+
+/*!
+ * \brief the counter based Philox4x32-10 PRNG of Salmon et al., "Parallel
+ *      random numbers: as easy as 1, 2, 3"
+ *
+ * Block k of the stream of a seed is the four words of the counter
+ * {k_lo, k_hi, 0, 0} and the key {seed_lo, seed_hi}, which are the words
+ * curand gives after curand_init(seed, 0, 4 * k). The element i of a
+ * generated tensor takes word i % 4 of block offset + i / 4, so any range
+ * of the elements can be computed independently.
+ */
+static constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57, W0 = 0x9E3779B9,
+                          W1 = 0xBB67AE85;
+
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE void single_round(
+        uint32_t* ctr, uint32_t k0, uint32_t k1) {
+    uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0],
+             p1 = static_cast<uint64_t>(M1) * ctr[2];
+    uint32_t hi0 = p0 >> 32, lo0 = static_cast<uint32_t>(p0), hi1 = p1 >> 32,
+             lo1 = static_cast<uint32_t>(p1);
+    ctr[0] = hi1 ^ ctr[1] ^ k0;
+    ctr[1] = lo1;
+    ctr[2] = hi0 ^ ctr[3] ^ k1;
+    ctr[3] = lo0;
+}
+
+//! the four words of a block of the stream
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE void generate(
+        uint64_t seed, uint64_t block, uint32_t* out) {
+    out[0] = static_cast<uint32_t>(block);
+    out[1] = static_cast<uint32_t>(block >> 32);
+    out[2] = out[3] = 0;
+    uint32_t k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+    for (int i = 0; i < 9; ++i) {
+        single_round(out, k0, k1);
+        k0 += W0;
+        k1 += W1;
+    }
+    single_round(out, k0, k1);
+}
+
+//! uniform float in (0, 1] of the higher 23 bits of a word, the same as the
+//! naive uniform rng
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE float to_uniform(uint32_t x) {
+    union {
+        uint32_t i;
+        float f;
+    } u;
+    u.i = (0x7F << 23) | (x >> 9);
+    return 2.f - u.f;
+}
+
+//! two gaussian floats of the Box-Muller transform of two words
+MEGDNN_HOST MEGDNN_DEVICE MEGDNN_FORCE_INLINE void to_gaussian(
+        uint32_t x0, uint32_t x1, float mean, float std, float& z0, float& z1) {
+    float r = std * sqrtf(-2.f * logf(to_uniform(x0))),
+          theta = 2.f * static_cast<float>(M_PI) * to_uniform(x1);
+    z0 = r * cosf(theta) + mean;
+    z1 = r * sinf(theta) + mean;
+}
+
+/*!
+ * \brief the seed and the offset of the next block of an rng opr
+ *
+ * The offset is reset when the seed changes and advanced by the blocks used by
+ * each exec, the same as the CUDA rng oprs.
+ */
+class State {
+    uint64_t m_seed = 0, m_offset = 0;
+
+public:
+    //! offset of nr_blocks blocks reserved for an exec of the seed
+    uint64_t reserve(uint64_t seed, uint64_t nr_blocks) {
+        if (seed != m_seed) {
+            m_seed = seed;
+            m_offset = 0;
+        }
+        uint64_t offset = m_offset;
+        m_offset += nr_blocks;
+        return offset;
+    }
+};
+
+}  // namespace philox
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
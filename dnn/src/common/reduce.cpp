@@ -43,6 +43,8 @@ DType get_out_dtype(const Reduce::DataType data_type, const DType inp_dtype) {
 
 namespace megdnn {
 
+constexpr int32_t ReduceForward::TARGET_SHAPE_AXIS;
+
 void ReduceForward::deduce_layout(const TensorLayout& src, TensorLayout& dst) {
     megdnn_assert(
             param().axis >= 0 && static_cast<uint32_t>(param().axis) < src.ndim,
@@ -68,13 +70,27 @@ void ReduceForward::check_exec(
     megdnn_assert_contiguous(dst);
     megdnn_assert(src.ndim == dst.ndim, "%s", errmsg().c_str());
     megdnn_assert(param().axis >= 0);
-    uint32_t axis = param().axis;
-    megdnn_assert(axis < src.ndim, "%s", errmsg().c_str());
-    rep(i, src.ndim) {
-        if (i != axis) {
-            megdnn_assert(src.shape[i] == dst.shape[i], "%s", errmsg().c_str());
-        } else {
-            megdnn_assert(dst.shape[i] == 1_z, "%s", errmsg().c_str());
+    if (param().axis == TARGET_SHAPE_AXIS) {
+        megdnn_assert(
+                param().data_type == DataType::DEFAULT,
+                "reduce to target shape only supports DEFAULT data type");
+        megdnn_assert(
+                src.dtype.category() != DTypeCategory::QUANTIZED,
+                "reduce to target shape does not support quantized dtypes");
+        rep(i, src.ndim) {
+            megdnn_assert(
+                    dst.shape[i] == src.shape[i] || dst.shape[i] == 1_z, "%s",
+                    errmsg().c_str());
+        }
+    } else {
+        uint32_t axis = param().axis;
+        megdnn_assert(axis < src.ndim, "%s", errmsg().c_str());
+        rep(i, src.ndim) {
+            if (i != axis) {
+                megdnn_assert(src.shape[i] == dst.shape[i], "%s", errmsg().c_str());
+            } else {
+                megdnn_assert(dst.shape[i] == 1_z, "%s", errmsg().c_str());
+            }
         }
     }
     megdnn_assert(
@@ -26,5 +26,35 @@ void get_ABC(const TensorShape& shape, size_t& A, size_t& B, size_t& C, size_t a
             shape_arr + (axis + 1), shape_arr + ndim, 1_z, SafeMultiplies<size_t>());
 }
 
+bool get_target_shape_ABC(
+        const TensorShape& src, const TensorShape& dst, size_t& A, size_t& B,
+        size_t& C) {
+    megdnn_assert(src.ndim == dst.ndim);
+    A = B = C = 1;
+    //! 0: in the reduced outer axes, 1: in the kept axes, 2: in the reduced
+    //! inner axes
+    int stage = 0;
+    for (size_t i = 0; i < src.ndim; ++i) {
+        size_t len = src.shape[i];
+        if (len == 1) {
+            continue;
+        }
+        bool reduced = dst.shape[i] == 1;
+        if (!reduced) {
+            if (stage == 2) {
+                return false;
+            }
+            stage = 1;
+            B *= len;
+        } else if (stage == 0) {
+            A *= len;
+        } else {
+            stage = 2;
+            C *= len;
+        }
+    }
+    return true;
+}
+
 }  // namespace reduce
 }  // namespace megdnn
@@ -167,6 +167,19 @@ struct CheckNonFiniteOp {
 
 #if MEGDNN_CC_HOST
 void get_ABC(const TensorShape& shape, size_t& A, size_t& B, size_t& C, size_t axis);
+
+/*!
+ * \brief collapse a reduction of \p src to the shape of \p dst into reducing
+ *      (A, B, C) to (1, B, 1)
+ *
+ * This is the case if all the kept dimensions of size larger than one are
+ * adjacent, such as reducing (N, C, H, W) to (1, C, 1, 1).
+ *
+ * \return whether the reduction can be collapsed
+ */
+bool get_target_shape_ABC(
+        const TensorShape& src, const TensorShape& dst, size_t& A, size_t& B,
+        size_t& C);
 #endif
 
 }  // namespace reduce
@@ -102,47 +102,44 @@ void transpose_block(
 }
 
 /*!
- * \brief transpose contiguous (batch, m, n) to (batch, n, m)
+ * \brief transpose the sub-matrix [row_begin, row_end) x [col_begin, col_end)
+ *      of a contiguous (m, n) matrix to the corresponding part of (n, m)
+ *
+ * The sub-matrix is processed by blocks starting at (row_begin, col_begin),
+ * so they should be multiples of the block size to use full blocks.
  */
 template <typename T>
-void transpose(size_t batch, size_t m, size_t n, T* src, T* dst) {
-    auto batch_src = src;
-    auto batch_dst = dst;
+void transpose_range(
+        size_t m, size_t n, size_t row_begin, size_t row_end, size_t col_begin,
+        size_t col_end, const T* src, T* dst) {
     constexpr size_t B = transpose_traits<T>::block_size;
-
-    auto work_block = [m, n, &batch_src, &batch_dst](
-                              const size_t i, const size_t j, const size_t h,
-                              const size_t w) {
-        auto src = batch_src + i * n + j, dst = batch_dst + j * m + i;
-        MIDOUT_BEGIN(transpose_fallback, midout_iv(0)) {
-            if (h == B && w == B) {
-                transpose_block(src, dst, n, m);
-            } else {
-                transpose_block(src, dst, n, m, h, w);
+    for (size_t i = row_begin; i < row_end; i += B) {
+        size_t h = std::min(B, row_end - i);
+        for (size_t j = col_begin; j < col_end; j += B) {
+            size_t w = std::min(B, col_end - j);
+            auto sptr = src + i * n + j;
+            auto dptr = dst + j * m + i;
+            MIDOUT_BEGIN(transpose_fallback, midout_iv(0)) {
+                if (h == B && w == B) {
+                    transpose_block(sptr, dptr, n, m);
+                } else {
+                    transpose_block(sptr, dptr, n, m, h, w);
+                }
             }
+            MIDOUT_END();
         }
-        MIDOUT_END();
-    };
-    auto work_row = [&work_block, n](size_t i, size_t h) {
-        size_t j = 0;
-        for (; j + B <= n; j += B) {
-            work_block(i, j, h, B);
-        }
-        if (j < n) {
-            work_block(i, j, h, n - j);
-        }
-    };
+    }
+}
 
+/*!
+ * \brief transpose contiguous (batch, m, n) to (batch, n, m)
+ */
+template <typename T>
+void transpose(size_t batch, size_t m, size_t n, const T* src, T* dst) {
     for (size_t b = 0; b < batch; ++b) {
-        size_t i = 0;
-        for (; i + B <= m; i += B) {
-            work_row(i, B);
-        }
-        if (i < m) {
-            work_row(i, m - i);
-        }
-        batch_src += m * n;
-        batch_dst += m * n;
+        transpose_range<T>(m, n, 0, m, 0, n, src, dst);
+        src += m * n;
+        dst += m * n;
     }
 }
 }  // namespace transpose_fallback
@@ -0,0 +1,56 @@
+/**
+ * \file dnn/src/common/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+size_t SoftmaxBase::get_axis(size_t ndim) const {
+    int axis = param().axis;
+    if (axis < 0) {
+        axis += static_cast<int>(ndim);
+    }
+    megdnn_assert(
+            axis >= 0 && static_cast<size_t>(axis) < ndim,
+            "invalid softmax axis %d for %zu-dim tensor", param().axis, ndim);
+    return axis;
+}
+
+void SoftmaxBase::check_layout_fwd(const TensorLayout& src, const TensorLayout& dst) {
+    megdnn_assert_contiguous(src);
+    megdnn_assert_eq_layout(src, dst);
+    megdnn_assert(src.dtype.category() == DTypeCategory::FLOAT);
+    get_axis(src.ndim);
+}
+
+void SoftmaxForward::deduce_layout(const TensorLayout& src, TensorLayout& dst) {
+    dst = src;
+}
+
+void SoftmaxForward::check_exec(
+        const TensorLayout& src, const TensorLayout& dst, size_t workspace_in_bytes) {
+    check_layout_fwd(src, dst);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(src, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+void SoftmaxBackward::check_exec(
+        const TensorLayout& dst, const TensorLayout& diff, const TensorLayout& grad,
+        size_t workspace_in_bytes) {
+    check_layout_fwd(dst, diff);
+    megdnn_assert_eq_layout(dst, grad);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(dst, diff, grad);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
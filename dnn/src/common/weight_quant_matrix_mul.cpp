@@ -0,0 +1,57 @@
+/**
+ * \file dnn/src/common/weight_quant_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void WeightQuantMatrixMulForward::deduce_layout(
+        const TensorLayout& src, const TensorLayout& weight, const TensorLayout& scale,
+        TensorLayout& dst) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(src) + ", " + megdnn_layout_msg(weight) + ", " +
+               megdnn_layout_msg(scale);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    uint32_t bits = param().bits;
+    megdnn_assert(bits == 8 || bits == 4, "invalid weight bits: %u", bits);
+    megdnn_assert(
+            src.ndim == 2 && weight.ndim == 2 && scale.ndim == 1, "%s",
+            errmsg().c_str());
+    size_t K = src[1];
+    megdnn_assert(
+            weight[1] == (bits == 8 ? K : (K + 1) / 2) && scale[0] == weight[0],
+            "shape mismatch for quantized weight: %s", errmsg().c_str());
+    dst = TensorLayout{{src[0], weight[0]}, src.dtype};
+}
+
+void WeightQuantMatrixMulForward::check_exec(
+        const TensorLayout& src, const TensorLayout& weight, const TensorLayout& scale,
+        const TensorLayout& dst, size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(src);
+    megdnn_assert_contiguous(weight);
+    megdnn_assert_contiguous(scale);
+    megdnn_assert_contiguous(dst);
+    megdnn_assert(src.dtype.category() == DTypeCategory::FLOAT);
+    megdnn_assert(
+            weight.dtype == dtype::Int8() && scale.dtype == dtype::Float32(),
+            "quantized weight should be of Int8 with Float32 scales");
+    megdnn_assert_eq_dtype(src, dst);
+    TensorLayout dst_expected;
+    deduce_layout(src, weight, scale, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(src, weight, scale, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
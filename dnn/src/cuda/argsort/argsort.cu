@@ -12,6 +12,7 @@
 #include "./argsort.cuh"
 #include "./bitonic_sort.cuh"
 #include "megdnn/basic_types.h"
+#include "src/cuda/topk/topk_radix.cuh"
 #include "src/cuda/utils.cuh"
 
 #include "src/cuda/cub/device/device_radix_sort.cuh"
@@ -46,6 +47,79 @@ bool use_segmented(uint32_t M, uint32_t /*N*/) {
     return M >= 8;
 }
 
+bool use_packed_key(uint32_t M, uint32_t N) {
+    // segmented sort assigns a single block to each row, and sorting row by
+    // row pays several kernel launches per row; for long rows it is faster
+    // to sort all the rows at once by a device-wide radix sort with the row
+    // index packed into the high bits of the keys
+    return M >= 2 && N >= 16384 && static_cast<uint64_t>(M) * N <= UINT32_MAX;
+}
+
+int get_packed_key_end_bit(uint32_t M) {
+    int row_bits = 0;
+    while ((1ull << row_bits) < M) {
+        ++row_bits;
+    }
+    return 32 + row_bits;
+}
+
+template <typename ctype>
+__global__ void kern_pack_key(
+        const ctype* src, uint64_t* keys, uint32_t total, uint32_t N,
+        bool is_ascending) {
+    uint32_t i = threadIdx.x + blockIdx.x * blockDim.x;
+    if (i < total) {
+        uint32_t radix = topk::internal::RadixConverter<ctype>::to_radix(src[i]);
+        if (!is_ascending) {
+            radix = ~radix;
+        }
+        keys[i] = (static_cast<uint64_t>(i / N) << 32) | radix;
+    }
+}
+
+template <typename ctype>
+__global__ void kern_unpack_key(
+        const uint64_t* keys, ctype* dst, uint32_t total, bool is_ascending) {
+    using Converter = topk::internal::RadixConverter<ctype>;
+    using radix_t = decltype(Converter::to_radix(ctype()));
+    uint32_t i = threadIdx.x + blockIdx.x * blockDim.x;
+    if (i < total) {
+        uint32_t radix = static_cast<uint32_t>(keys[i]);
+        if (!is_ascending) {
+            radix = ~radix;
+        }
+        dst[i] = Converter::from_radix(static_cast<radix_t>(radix));
+    }
+}
+
+size_t get_packed_key_workspace(uint32_t M, uint32_t N) {
+    size_t keys_size = sizeof(uint64_t) * M * N;
+    size_t sort_size = argsort::cub_sort_pairs<uint64_t, int>(
+            true, NULL, 0, NULL, NULL, NULL, NULL, 1, M * N, 0,
+            get_packed_key_end_bit(M), NULL);
+    return keys_size * 2 + sort_size;
+}
+
+template <typename ctype>
+void packed_key_sort(
+        const ctype* sptr, ctype* dptr, const int* iptr_src, int* iptr,
+        void* workspace, uint32_t M, uint32_t N, bool is_ascending,
+        cudaStream_t stream) {
+    uint32_t total = M * N;
+    auto keys_in = static_cast<uint64_t*>(workspace), keys_out = keys_in + total;
+    void* sort_workspace = keys_out + total;
+    size_t sort_size = get_packed_key_workspace(M, N) - sizeof(uint64_t) * total * 2;
+    kern_pack_key<<<DIVUP(total, 512), 512, 0, stream>>>(
+            sptr, keys_in, total, N, is_ascending);
+    after_kernel_launch();
+    argsort::cub_sort_pairs<uint64_t, int>(
+            true, sort_workspace, sort_size, keys_in, keys_out, iptr_src, iptr, 1,
+            total, 0, get_packed_key_end_bit(M), stream);
+    kern_unpack_key<<<DIVUP(total, 512), 512, 0, stream>>>(
+            keys_out, dptr, total, is_ascending);
+    after_kernel_launch();
+}
+
 __global__ void kern_arange(int* dst, uint32_t n, uint32_t mod) {
     uint32_t i = threadIdx.x + blockIdx.x * blockDim.x;
     if (i < n) {
@@ -58,6 +132,9 @@ size_t get_sort_workspace(uint32_t M, uint32_t N, bool is_ascending) {
     if (use_bitonic(M, N)) {
         return 0;
     }
+    if (use_packed_key(M, N)) {
+        return get_packed_key_workspace(M, N);
+    }
     return argsort::cub_sort_pairs<ctype, int>(
             is_ascending, NULL, 0, NULL, NULL, NULL, NULL, M, N, 0, sizeof(float) * 8,
             NULL);
@@ -148,6 +225,9 @@ void argsort::forward(
     if (use_bitonic(M, N)) {
         cuda_check(
                 bitonic_sort(M, N, sptr, iptr_src, dptr, iptr, is_ascending, stream));
+    } else if (use_packed_key(M, N)) {
+        packed_key_sort(
+                sptr, dptr, iptr_src, iptr, workspace, M, N, is_ascending, stream);
     } else {
         cub_sort_pairs(
                 is_ascending, workspace, wk_size, sptr, dptr, iptr_src, iptr, M, N, 0,
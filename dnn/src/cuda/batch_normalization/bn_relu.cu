@@ -0,0 +1,90 @@
+/**
+ * \file dnn/src/cuda/batch_normalization/bn_relu.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/cuda/batch_normalization/bn_relu.cuh"
+
+#include "megdnn/dtype.h"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+constexpr uint32_t NR_THREADS = 256;
+
+//! a warp covers 32 consecutive elements, i.e. a word of the mask
+template <typename T>
+__global__ void relu_fwd_kern(T* y, uint32_t* mask, size_t n) {
+    size_t i = static_cast<size_t>(blockIdx.x) * NR_THREADS + threadIdx.x;
+    bool pos = false;
+    if (i < n) {
+        T v = y[i];
+        pos = static_cast<float>(v) > 0.f;
+        if (!pos) {
+            y[i] = static_cast<T>(0.f);
+        }
+    }
+    uint32_t bits = __ballot_sync(0xffffffff, pos);
+    if (mask && (threadIdx.x & 31) == 0 && i < n) {
+        mask[i >> 5] = bits;
+    }
+}
+
+template <typename T>
+__global__ void relu_bwd_kern(
+        const T* dy, const uint32_t* mask, T* masked_dy, size_t n) {
+    size_t i = static_cast<size_t>(blockIdx.x) * NR_THREADS + threadIdx.x;
+    if (i < n) {
+        masked_dy[i] = (mask[i >> 5] >> (i & 31)) & 1 ? dy[i] : static_cast<T>(0.f);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace batch_normalization {
+
+template <typename T>
+void relu_forward_proxy(T* y, uint32_t* mask, size_t n, cudaStream_t stream) {
+    if (!n) {
+        return;
+    }
+    relu_fwd_kern<T><<<DIVUP(n, NR_THREADS), NR_THREADS, 0, stream>>>(y, mask, n);
+    after_kernel_launch();
+}
+
+template <typename T>
+void relu_backward_proxy(
+        const T* dy, const uint32_t* mask, T* masked_dy, size_t n,
+        cudaStream_t stream) {
+    if (!n) {
+        return;
+    }
+    relu_bwd_kern<T><<<DIVUP(n, NR_THREADS), NR_THREADS, 0, stream>>>(
+            dy, mask, masked_dy, n);
+    after_kernel_launch();
+}
+
+#define INST(T)                                                               \
+    template void relu_forward_proxy<T>(T*, uint32_t*, size_t, cudaStream_t); \
+    template void relu_backward_proxy<T>(                                     \
+            const T*, const uint32_t*, T*, size_t, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace batch_normalization
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
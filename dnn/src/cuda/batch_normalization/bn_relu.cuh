@@ -0,0 +1,38 @@
+/**
+ * \file dnn/src/cuda/batch_normalization/bn_relu.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace batch_normalization {
+
+/*!
+ * \brief y = max(y, 0) in place for the relu fused into BN
+ *
+ * Bit i of mask is set if y[i] > 0; mask could be null if no backward follows.
+ */
+template <typename T>
+void relu_forward_proxy(T* y, uint32_t* mask, size_t n, cudaStream_t stream);
+
+//! masked_dy[i] = dy[i] if bit i of mask is set else 0
+template <typename T>
+void relu_backward_proxy(
+        const T* dy, const uint32_t* mask, T* masked_dy, size_t n,
+        cudaStream_t stream);
+
+}  // namespace batch_normalization
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -10,6 +10,8 @@
  */
 #include "./opr_impl.h"
 
+#include "src/common/bn_relu_helper.h"
+#include "src/cuda/batch_normalization/bn_relu.cuh"
 #include "src/cuda/utils.h"
 
 namespace megdnn {
@@ -65,6 +67,13 @@ size_t get_reserve_size(
     return 0;
 #endif  // CUDNN_VERSION >= 7410
 }
+
+size_t get_mask_size(const param::BN& param, size_t nr_elems) {
+    // padded to keep the reserve of cudnn aligned
+    return bn_relu::need_mask(param)
+                 ? get_aligned_power2<size_t>(bn_relu::mask_in_bytes(nr_elems), 256)
+                 : 0;
+}
 }  // namespace batch_normalization
 
 using batch_normalization::BNTensorDescHolder;
@@ -94,8 +103,9 @@ size_t BNForwardImpl::get_workspace_in_bytes(
 
 size_t BNForwardImpl::get_reserve_in_bytes(const TensorLayout& src) {
     BNTensorDescHolder tensor_desc(src, m_param.param_dim, m_param.fwd_mode);
-    return batch_normalization::get_reserve_size(
-            cudnn_handle(this->handle()), tensor_desc);
+    return batch_normalization::get_mask_size(m_param, src.total_nr_elems()) +
+           batch_normalization::get_reserve_size(
+                   cudnn_handle(this->handle()), tensor_desc);
 }
 
 void BNForwardImpl::exec(
@@ -110,6 +120,13 @@ void BNForwardImpl::exec(
             reserve.layout.access_bytes());
     auto handle = cudnn_handle(this->handle());
     BNTensorDescHolder tensor_desc(src.layout, m_param.param_dim, m_param.fwd_mode);
+#if CUDNN_VERSION >= 7410
+    // the reserve of cudnn follows the mask of the fused relu
+    size_t mask_size =
+            batch_normalization::get_mask_size(m_param, src.layout.total_nr_elems());
+    void* cudnn_reserve = static_cast<dt_byte*>(reserve.raw_ptr) + mask_size;
+    size_t cudnn_reserve_size = reserve.layout.access_bytes() - mask_size;
+#endif  // CUDNN_VERSION >= 7410
 
     float alpha = 1.0f, beta = 0.0f;
     switch (m_param.fwd_mode) {
@@ -125,7 +142,7 @@ void BNForwardImpl::exec(
                     bn_scale.raw_ptr, bn_bias.raw_ptr, m_param.avg_factor, mean.raw_ptr,
                     variance.raw_ptr, m_param.epsilon, batch_mean.raw_ptr,
                     batch_inv_variance.raw_ptr, nullptr, workspace.raw_ptr,
-                    workspace.size, reserve.raw_ptr, reserve.layout.access_bytes()));
+                    workspace.size, cudnn_reserve, cudnn_reserve_size));
 #else
             cudnn_check(cudnnBatchNormalizationForwardTraining(
                     handle, tensor_desc.bn_mode, &alpha, &beta,
@@ -147,17 +164,36 @@ void BNForwardImpl::exec(
         default:
             megdnn_throw("Unknown forward mode type of batch normalization.");
     }
+
+    if (m_param.nonlineMode == param::BN::NonlineMode::RELU) {
+        auto mask = bn_relu::need_mask(m_param)
+                          ? static_cast<uint32_t*>(reserve.raw_ptr)
+                          : nullptr;
+        auto stream = cuda_stream(this->handle());
+        switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                           \
+    case DTypeTrait<_dt>::enumv: {                                        \
+        using T = typename DTypeTrait<_dt>::ctype;                        \
+        batch_normalization::relu_forward_proxy<T>(                       \
+                dst.ptr<T>(), mask, dst.layout.total_nr_elems(), stream); \
+        break;                                                            \
+    }
+            MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+            default:
+                megdnn_assert_internal(0);
+        }
+    }
 }
 
-size_t BNBackwardImpl::get_workspace_in_bytes(
-        const TensorLayout& x, const TensorLayout&, const TensorLayout&,
-        const TensorLayout&, const TensorLayout&, const TensorLayout&,
-        const TensorLayout&, const TensorLayout&, const TensorLayout&) {
+WorkspaceBundle BNBackwardImpl::get_workspace_bundle(
+        const TensorLayout& x, void* raw_ptr) {
+    size_t masked_dy_size = bn_relu::need_mask(m_param) ? x.span().dist_byte() : 0;
+    size_t workspace_size = 0;
 #if CUDNN_VERSION >= 7410
     auto handle = cudnn_handle(this->handle());
     BNTensorDescHolder tensor_desc(x, m_param.param_dim, m_param.fwd_mode);
 
-    size_t workspace_size;
     cudnn_check(cudnnGetBatchNormalizationBackwardExWorkspaceSize(
             handle, tensor_desc.bn_mode, CUDNN_BATCHNORM_OPS_BN,
             tensor_desc.xy_desc.desc,     // xDesc
@@ -168,16 +204,22 @@ size_t BNBackwardImpl::get_workspace_in_bytes(
             tensor_desc.param_desc.desc,  // dBnScaleBiasDesc
             nullptr,                      // activationDesc
             &workspace_size));
-    return workspace_size;
-#else
-    return 0;
 #endif  // CUDNN_VERSION >= 7410
+    return {raw_ptr, {masked_dy_size, workspace_size}};
+}
+
+size_t BNBackwardImpl::get_workspace_in_bytes(
+        const TensorLayout& x, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&) {
+    return get_workspace_bundle(x).total_size_in_bytes();
 }
 
 size_t BNBackwardImpl::get_reserve_in_bytes(const TensorLayout& src) {
     BNTensorDescHolder tensor_desc(src, m_param.param_dim, m_param.fwd_mode);
-    return batch_normalization::get_reserve_size(
-            cudnn_handle(this->handle()), tensor_desc);
+    return batch_normalization::get_mask_size(m_param, src.total_nr_elems()) +
+           batch_normalization::get_reserve_size(
+                   cudnn_handle(this->handle()), tensor_desc);
 }
 
 void BNBackwardImpl::exec(
@@ -192,28 +234,54 @@ void BNBackwardImpl::exec(
             d_bn_bias.layout, dx.layout, workspace.size, reserve.layout.access_bytes());
     auto handle = cudnn_handle(this->handle());
     BNTensorDescHolder tensor_desc(x.layout, m_param.param_dim, m_param.fwd_mode);
+    auto bundle = get_workspace_bundle(x.layout, workspace.raw_ptr);
+
+    void* dy_ptr = dy.raw_ptr;
+    if (bn_relu::need_mask(m_param)) {
+        // backward through the fused relu, then through BN
+        auto mask = static_cast<const uint32_t*>(reserve.raw_ptr);
+        auto stream = cuda_stream(this->handle());
+        switch (dy.layout.dtype.enumv()) {
+#define cb(_dt)                                                    \
+    case DTypeTrait<_dt>::enumv: {                                 \
+        using T = typename DTypeTrait<_dt>::ctype;                 \
+        batch_normalization::relu_backward_proxy<T>(               \
+                dy.ptr<T>(), mask, static_cast<T*>(bundle.get(0)), \
+                dy.layout.total_nr_elems(), stream);               \
+        break;                                                     \
+    }
+            MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+            default:
+                megdnn_assert_internal(0);
+        }
+        dy_ptr = bundle.get(0);
+    }
 
     float alpha = 1.0, beta = 0.0;
 #if CUDNN_VERSION >= 7410
+    size_t mask_size =
+            batch_normalization::get_mask_size(m_param, x.layout.total_nr_elems());
     cudnn_check(cudnnBatchNormalizationBackwardEx(
             handle, tensor_desc.bn_mode, CUDNN_BATCHNORM_OPS_BN, &alpha, &beta, &alpha,
             &beta, tensor_desc.xy_desc.desc,
             x.raw_ptr,                                      // xDesc & x
             nullptr, nullptr,                               // yDesc & y
-            tensor_desc.xy_desc.desc, dy.raw_ptr,           // dyDesc & dy
+            tensor_desc.xy_desc.desc, dy_ptr,               // dyDesc & dy
             nullptr, nullptr,                               // dzDesc & dz
             tensor_desc.xy_desc.desc, dx.raw_ptr,           // dxDesc & dx
             tensor_desc.param_desc.desc, bn_scale.raw_ptr,  // bnScale
             nullptr,                                        // bnBias
             d_bn_scale.raw_ptr, d_bn_bias.raw_ptr,          // dScale, dBias
             m_param.epsilon, saved_batch_mean.raw_ptr, saved_batch_inv_variance.raw_ptr,
-            nullptr, workspace.raw_ptr, workspace.size, reserve.raw_ptr,
-            reserve.layout.access_bytes()));
+            nullptr, bundle.get(1), bundle.get_size(1),
+            static_cast<dt_byte*>(reserve.raw_ptr) + mask_size,
+            reserve.layout.access_bytes() - mask_size));
 #else
     cudnn_check(cudnnBatchNormalizationBackward(
             handle, tensor_desc.bn_mode, &alpha, &beta, &alpha, &beta,
             tensor_desc.xy_desc.desc, x.raw_ptr,            // xDesc & x
-            tensor_desc.xy_desc.desc, dy.raw_ptr,           // dyDesc & dy
+            tensor_desc.xy_desc.desc, dy_ptr,               // dyDesc & dy
             tensor_desc.xy_desc.desc, dx.raw_ptr,           // dxDesc & dx
             tensor_desc.param_desc.desc, bn_scale.raw_ptr,  // bnScale
             d_bn_scale.raw_ptr, d_bn_bias.raw_ptr,          // dScale, dBias
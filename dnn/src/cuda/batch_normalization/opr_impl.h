@@ -11,6 +11,7 @@
 #pragma once
 #include "megdnn/oprs.h"
 
+#include "src/common/utils.h"
 #include "src/cuda/cudnn_wrapper.h"
 
 namespace megdnn {
@@ -34,6 +35,12 @@ struct BNTensorDescHolder {
 size_t get_reserve_size(
         const cudnnHandle_t& handle, const BNTensorDescHolder& tensor_desc);
 
+/*!
+ * \brief size of the mask of the fused relu, which is stored at the head of
+ *      reserve and followed by the reserve of cudnn
+ */
+size_t get_mask_size(const param::BN& param, size_t nr_elems);
+
 }  // namespace batch_normalization
 
 class BNForwardImpl final : public BNForward {
@@ -69,6 +76,11 @@ public:
             const TensorLayout&, const TensorLayout&, const TensorLayout&,
             const TensorLayout&, const TensorLayout&, const TensorLayout&) override;
     size_t get_reserve_in_bytes(const TensorLayout& src) override;
+
+private:
+    //! dy masked by the fused relu and the workspace of cudnn
+    WorkspaceBundle get_workspace_bundle(
+            const TensorLayout& x, void* raw_ptr = nullptr);
 };
 
 }  // namespace cuda
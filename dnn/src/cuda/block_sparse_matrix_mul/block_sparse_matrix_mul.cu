@@ -0,0 +1,106 @@
+/**
+ * \file dnn/src/cuda/block_sparse_matrix_mul/block_sparse_matrix_mul.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/block_sparse_matrix_mul/block_sparse_matrix_mul.cuh"
+
+#include "megdnn/dtype.h"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+constexpr uint32_t NR_THREADS = 256;
+
+using block_sparse_matrix_mul::Shape;
+
+//! threads of a warp compute adjacent columns of an output row
+template <typename T>
+__global__ void sparse_dense_kern(
+        const T* values, const int* col_idx, const int* row_ptr, const T* src, T* dst,
+        Shape shp, uint32_t total) {
+    uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= total) {
+        return;
+    }
+    uint32_t n = idx % shp.N, m = idx / shp.N % shp.M, b = idx / shp.N / shp.M;
+    uint32_t rb = m / shp.bh, i = m % shp.bh;
+    src += b * shp.K * shp.N + n;
+    float acc = 0.f;
+    for (int blk = row_ptr[rb]; blk < row_ptr[rb + 1]; ++blk) {
+        const T* val = values + (blk * shp.bh + i) * shp.bw;
+        const T* s = src + col_idx[blk] * shp.bw * shp.N;
+        for (uint32_t j = 0; j < shp.bw; ++j) {
+            acc += static_cast<float>(val[j]) * static_cast<float>(s[j * shp.N]);
+        }
+    }
+    dst[idx] = static_cast<T>(acc);
+}
+
+//! threads of a warp compute adjacent elements of a row of src * A^T
+template <typename T>
+__global__ void dense_sparse_t_kern(
+        const T* values, const int* col_idx, const int* row_ptr, const T* src, T* dst,
+        Shape shp, uint32_t total) {
+    uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= total) {
+        return;
+    }
+    uint32_t m = idx % shp.M, row = idx / shp.M;
+    uint32_t rb = m / shp.bh, i = m % shp.bh;
+    src += row * shp.K;
+    float acc = 0.f;
+    for (int blk = row_ptr[rb]; blk < row_ptr[rb + 1]; ++blk) {
+        const T* val = values + (blk * shp.bh + i) * shp.bw;
+        const T* s = src + col_idx[blk] * shp.bw;
+        for (uint32_t j = 0; j < shp.bw; ++j) {
+            acc += static_cast<float>(val[j]) * static_cast<float>(s[j]);
+        }
+    }
+    dst[idx] = static_cast<T>(acc);
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace block_sparse_matrix_mul {
+
+template <typename T>
+void forward_proxy(
+        const T* values, const int* col_idx, const int* row_ptr, const T* src, T* dst,
+        const Shape& shp, bool sparse_dense, cudaStream_t stream) {
+    uint32_t total = shp.B * shp.M * shp.N;
+    uint32_t nr_blocks = DIVUP(total, NR_THREADS);
+    if (sparse_dense) {
+        sparse_dense_kern<T><<<nr_blocks, NR_THREADS, 0, stream>>>(
+                values, col_idx, row_ptr, src, dst, shp, total);
+    } else {
+        dense_sparse_t_kern<T><<<nr_blocks, NR_THREADS, 0, stream>>>(
+                values, col_idx, row_ptr, src, dst, shp, total);
+    }
+    after_kernel_launch();
+}
+
+#define INST(T)                                                                  \
+    template void forward_proxy<T>(                                              \
+            const T*, const int*, const int*, const T*, T*, const Shape&, bool, \
+            cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace block_sparse_matrix_mul
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/cuda/block_sparse_matrix_mul/block_sparse_matrix_mul.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace block_sparse_matrix_mul {
+
+struct Shape {
+    uint32_t B, M, K, N, bh, bw;
+};
+
+/*!
+ * \brief dst[b] = A * src[b] of (B, K, N) src if sparse_dense, or
+ *      dst[b] = src[b] * A^T of (B, N, K) src otherwise
+ *
+ * Each thread computes an output element from the non-zero blocks of a row of
+ * the BSR matrix A.
+ */
+template <typename T>
+void forward_proxy(
+        const T* values, const int* col_idx, const int* row_ptr, const T* src, T* dst,
+        const Shape& shp, bool sparse_dense, cudaStream_t stream);
+
+}  // namespace block_sparse_matrix_mul
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,62 @@
+/**
+ * \file dnn/src/cuda/block_sparse_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/block_sparse_matrix_mul/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/cuda/block_sparse_matrix_mul/block_sparse_matrix_mul.cuh"
+#include "src/cuda/handle.h"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void BlockSparseMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in values, _megdnn_tensor_in col_idx, _megdnn_tensor_in row_ptr,
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(
+            values.layout, col_idx.layout, row_ptr.layout, src.layout, dst.layout,
+            workspace.size);
+    if (!dst.layout.total_nr_elems()) {
+        return;
+    }
+    megdnn_assert(
+            src.layout.total_nr_elems() <= UINT32_MAX &&
+                    dst.layout.total_nr_elems() <= UINT32_MAX &&
+                    values.layout.total_nr_elems() <= UINT32_MAX,
+            "block sparse matmul tensors are too large");
+    auto&& sl = src.layout;
+    bool sparse_dense = param().mode == Param::Mode::SPARSE_DENSE;
+    block_sparse_matrix_mul::Shape shp;
+    shp.B = sl.ndim == 3 ? sl[0] : 1;
+    shp.bh = param().block_h;
+    shp.bw = param().block_w;
+    shp.M = (row_ptr.layout[0] - 1) * shp.bh;
+    shp.K = sl[sl.ndim - (sparse_dense ? 2 : 1)];
+    shp.N = sl[sl.ndim - (sparse_dense ? 1 : 2)];
+    auto stream = cuda_stream(this->handle());
+#define cb(DType)                                                             \
+    if (src.layout.dtype == DType()) {                                        \
+        using ctype = typename DTypeTrait<DType>::ctype;                      \
+        block_sparse_matrix_mul::forward_proxy<ctype>(                        \
+                values.ptr<ctype>(), col_idx.ptr<dt_int32>(),                 \
+                row_ptr.ptr<dt_int32>(), src.ptr<ctype>(), dst.ptr<ctype>(),  \
+                shp, sparse_dense, stream);                                   \
+        return;                                                               \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
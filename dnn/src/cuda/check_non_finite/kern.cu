@@ -11,8 +11,35 @@
 #include "src/common/reduce_helper.h"
 
 #include "megdnn/dtype.h"
+#include "src/cuda/check_non_finite/kern.cuh"
 #include "src/cuda/reduce_helper.cuh"
 
+namespace {
+
+using namespace megdnn;
+using namespace cuda;
+using check_non_finite::Chunk;
+
+template <bool need_scale>
+__global__ void check_and_scale_kernel(
+        const Chunk* chunks, dt_float32 scale, dt_int32* dst) {
+    Chunk chunk = chunks[blockIdx.x];
+    int flag = 0;
+    for (uint32_t i = threadIdx.x; i < chunk.size; i += blockDim.x) {
+        dt_float32 val = chunk.ptr[i];
+        flag |= !isfinite(val);
+        if (need_scale) {
+            chunk.ptr[i] = val * scale;
+        }
+    }
+    // a single atomic from the blocks which find non-finite values
+    if (__syncthreads_or(flag) && !threadIdx.x) {
+        atomicOr(dst, 1);
+    }
+}
+
+}  // anonymous namespace
+
 namespace megdnn {
 namespace cuda {
 
@@ -21,6 +48,27 @@ namespace cuda {
 INST_REDUCE(reduce::CheckNonFiniteOp<dt_float32 COMMA dt_int32 COMMA dt_int32>, false);
 
 #undef COMMA
+
+namespace check_non_finite {
+
+void check_and_scale(
+        const Chunk* chunks, uint32_t nr_chunks, dt_float32 scale, dt_int32* dst,
+        cudaStream_t stream) {
+    cuda_check(cudaMemsetAsync(dst, 0, sizeof(dt_int32), stream));
+    if (!nr_chunks) {
+        return;
+    }
+    if (scale != 1.f) {
+        check_and_scale_kernel<true>
+                <<<nr_chunks, NR_THREADS_PER_CHUNK, 0, stream>>>(chunks, scale, dst);
+    } else {
+        check_and_scale_kernel<false>
+                <<<nr_chunks, NR_THREADS_PER_CHUNK, 0, stream>>>(chunks, scale, dst);
+    }
+    after_kernel_launch();
+}
+
+}  // namespace check_non_finite
 }  // namespace cuda
 }  // namespace megdnn
 
@@ -0,0 +1,46 @@
+/**
+ * \file dnn/src/cuda/check_non_finite/kern.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+
+#pragma once
+
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace check_non_finite {
+
+//! number of threads of each block, which checks one chunk
+constexpr uint32_t NR_THREADS_PER_CHUNK = 256;
+//! the inputs are split into chunks of at most this many elements
+constexpr uint32_t CHUNK_SIZE = NR_THREADS_PER_CHUNK * 64;
+
+//! a piece of one input, whose elements are checked by one block
+struct Chunk {
+    dt_float32* ptr;
+    uint32_t size;
+};
+
+/*!
+ * \brief set *dst to whether any element of the chunks is not finite, and
+ *      multiply the elements by \p scale inplace if it is not 1
+ *
+ * \param chunks the chunk table on device
+ */
+void check_and_scale(
+        const Chunk* chunks, uint32_t nr_chunks, dt_float32 scale, dt_int32* dst,
+        cudaStream_t stream);
+
+}  // namespace check_non_finite
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: ft=cpp syntax=cpp.doxygen
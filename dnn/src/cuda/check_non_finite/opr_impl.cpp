@@ -10,6 +10,7 @@
  */
 
 #include "src/cuda/check_non_finite/opr_impl.h"
+#include "src/cuda/check_non_finite/kern.cuh"
 #include "src/cuda/reduce_helper.cuh"
 
 #include "src/cuda/handle.h"
@@ -39,6 +40,62 @@ void CheckNonFiniteImpl::exec(
             Op(src.ptr<dt_float32>(), dst.ptr<dt_int32>(), B));
 }
 
+using check_non_finite::Chunk;
+using check_non_finite::CHUNK_SIZE;
+
+namespace {
+size_t get_nr_chunks(const TensorNDArray& srcs) {
+    size_t ret = 0;
+    for (auto&& src : srcs) {
+        ret += DIVUP(src.layout.total_nr_elems(), CHUNK_SIZE);
+    }
+    return ret;
+}
+}  // anonymous namespace
+
+size_t CheckNonFiniteV2Impl::get_workspace_in_bytes(
+        const TensorNDArray& srcs, const TensorLayout&) {
+    return get_nr_chunks(srcs) * sizeof(Chunk);
+}
+
+void CheckNonFiniteV2Impl::exec(
+        _megdnn_in const TensorNDArray& srcs, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(srcs, dst, workspace.size);
+    auto stream = cuda_stream(this->handle());
+    // one block checks one chunk, so that all the inputs are handled by a
+    // single kernel no matter how many (and how small) they are; the chunk
+    // table is built on host and freed by a cuda callback
+    size_t nr_chunks = get_nr_chunks(srcs);
+    megdnn_assert(
+            nr_chunks < std::numeric_limits<int32_t>::max(),
+            "too many elements to check: %zu chunks", nr_chunks);
+    Chunk* chunks_gpu = nullptr;
+    if (nr_chunks) {
+        auto chunks_cpu = static_cast<Chunk*>(malloc(nr_chunks * sizeof(Chunk)));
+        megdnn_assert_internal(chunks_cpu);
+        size_t idx = 0;
+        for (auto&& src : srcs) {
+            auto ptr = src.ptr<dt_float32>();
+            size_t size = src.layout.total_nr_elems();
+            for (size_t begin = 0; begin < size; begin += CHUNK_SIZE) {
+                chunks_cpu[idx++] = {
+                        ptr + begin,
+                        static_cast<uint32_t>(std::min<size_t>(
+                                CHUNK_SIZE, size - begin))};
+            }
+        }
+        chunks_gpu = workspace.ptr<Chunk>();
+        cuda_check(cudaMemcpyAsync(
+                chunks_gpu, chunks_cpu, nr_chunks * sizeof(Chunk),
+                cudaMemcpyHostToDevice, stream));
+        cuda_check(cudaStreamAddCallback(
+                stream, callback_free, static_cast<void*>(chunks_cpu), 0));
+    }
+    check_non_finite::check_and_scale(
+            chunks_gpu, nr_chunks, param().scale, dst.ptr<dt_int32>(), stream);
+}
+
 }  // namespace cuda
 }  // namespace megdnn
 
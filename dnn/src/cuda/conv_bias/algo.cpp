@@ -222,6 +222,13 @@ void ConvBiasForwardImpl::AlgoPack::fill_imma_algos() {
         int8_nchw32_imma.emplace_back(AlgoParam{128, 32, 32, 64, 32, 32, 8, 8, 16, 1});
         int8_nchw32_imma.emplace_back(AlgoParam{64, 128, 32, 32, 64, 32, 8, 8, 16, 1});
         int8_nchw32_imma.emplace_back(AlgoParam{32, 128, 32, 32, 64, 32, 8, 8, 16, 1});
+        //! extended tiles of the cutlass tile catalog, whose kernels are only
+        //! built on demand; see dnn/scripts/cutlass_generator/tile_catalog.py
+        int8_nchw32_imma.emplace_back(AlgoParam{256, 64, 64, 64, 64, 64, 8, 8, 16, 2});
+        int8_nchw32_imma.emplace_back(AlgoParam{64, 256, 64, 64, 64, 64, 8, 8, 16, 2});
+        int8_nchw32_imma.emplace_back(AlgoParam{64, 64, 64, 32, 64, 64, 8, 8, 16, 2});
+        int8_nchw32_imma.emplace_back(AlgoParam{128, 128, 32, 64, 64, 32, 8, 8, 16, 1});
+        int8_nchw32_imma.emplace_back(AlgoParam{64, 64, 32, 32, 64, 32, 8, 8, 16, 1});
     }
     {
         using AlgoParam = AlgoInt8NHWCIMMAImplicitGemm::AlgoParam;
@@ -243,6 +250,17 @@ void ConvBiasForwardImpl::AlgoPack::fill_imma_algos() {
                 AlgoParam{128, 64, 128, 64, 64, 128, 8, 8, 32, 2});
         int4_int4_nchw64_imma.emplace_back(
                 AlgoParam{128, 64, 64, 64, 64, 64, 8, 8, 32, 1});
+        //! extended tiles of the cutlass tile catalog
+        int4_int4_nchw64_imma.emplace_back(
+                AlgoParam{256, 128, 128, 64, 64, 128, 8, 8, 32, 2});
+        int4_int4_nchw64_imma.emplace_back(
+                AlgoParam{256, 64, 128, 64, 64, 128, 8, 8, 32, 2});
+        int4_int4_nchw64_imma.emplace_back(
+                AlgoParam{64, 128, 128, 64, 64, 128, 8, 8, 32, 2});
+        int4_int4_nchw64_imma.emplace_back(
+                AlgoParam{64, 64, 128, 64, 64, 128, 8, 8, 32, 2});
+        int4_int4_nchw64_imma.emplace_back(
+                AlgoParam{128, 128, 64, 64, 64, 64, 8, 8, 32, 1});
     }
     {
         using AlgoParam = AlgoUInt4Int4NCHW64IMMAImplicitGemm::AlgoParam;
@@ -254,6 +272,17 @@ void ConvBiasForwardImpl::AlgoPack::fill_imma_algos() {
                 AlgoParam{128, 64, 128, 64, 64, 128, 8, 8, 32, 2});
         uint4_int4_nchw64_imma.emplace_back(
                 AlgoParam{128, 64, 64, 64, 64, 64, 8, 8, 32, 1});
+        //! extended tiles of the cutlass tile catalog
+        uint4_int4_nchw64_imma.emplace_back(
+                AlgoParam{256, 128, 128, 64, 64, 128, 8, 8, 32, 2});
+        uint4_int4_nchw64_imma.emplace_back(
+                AlgoParam{256, 64, 128, 64, 64, 128, 8, 8, 32, 2});
+        uint4_int4_nchw64_imma.emplace_back(
+                AlgoParam{64, 128, 128, 64, 64, 128, 8, 8, 32, 2});
+        uint4_int4_nchw64_imma.emplace_back(
+                AlgoParam{64, 64, 128, 64, 64, 128, 8, 8, 32, 2});
+        uint4_int4_nchw64_imma.emplace_back(
+                AlgoParam{128, 128, 64, 64, 64, 64, 8, 8, 32, 1});
     }
     {
         using AlgoParam = AlgoInt4Int4NHWCIMMAImplicitGemm::AlgoParam;
@@ -1652,6 +1652,205 @@ INST_DT_IBYTE(dt_qint8);
 INST_DT_IBYTE(dt_quint8);
 INST_DT_IBYTE(dt_bool);
 #undef INST_DT_IBYTE
+
+/* f{{{ multi-output callers and invoker */
+
+//! 16-byte pack of elements, loaded and stored with a single vector access
+template <typename ctype>
+struct ATTR_ALIGNED(16) MultiOutputPack {
+    static const uint32_t packed_size = 16 / sizeof(ctype);
+    ctype v[packed_size];
+};
+
+/*!
+ * \brief call an op writing nr_out outputs, visiting inputs through PVis
+ *
+ * The outputs must be contiguous.
+ */
+template <class Op, typename ctype, int arity, int nr_out, class PVis>
+struct OpCallerMultiOutput {
+    Op op;
+    PVis par[arity];
+    ctype* dst[nr_out];
+
+    devfunc void thread_init(uint32_t) {}
+
+    devfunc void on(uint32_t idx) {
+        ctype src_val[arity], dst_val[nr_out];
+#pragma unroll
+        for (int i = 0; i < arity; ++i)
+            src_val[i] = par[i].at(idx);
+        op(dst_val, src_val);
+#pragma unroll
+        for (int i = 0; i < nr_out; ++i)
+            dst[i][idx] = dst_val[i];
+    }
+
+    devfunc void next() {}
+};
+
+/*!
+ * \brief vectorized version of OpCallerMultiOutput
+ *
+ * Each input is either contiguous or a broadcasted scalar, and all the
+ * non-scalar pointers are 16-byte aligned; \p idx passed to on() is the
+ * index of a MultiOutputPack, and the last partial pack is handled
+ * element by element.
+ */
+template <class Op, typename ctype, int arity, int nr_out>
+struct OpCallerMultiOutputVect {
+    typedef MultiOutputPack<ctype> Pack;
+    static const uint32_t packed_size = Pack::packed_size;
+
+    Op op;
+    const ctype* src[arity];
+    bool src_scalar[arity];
+    ctype* dst[nr_out];
+    uint32_t size;
+
+    devfunc void thread_init(uint32_t) {}
+
+    devfunc void on(uint32_t idx) {
+        ctype src_val[arity], dst_val[nr_out];
+        uint32_t begin = idx * packed_size;
+        if (begin + packed_size > size) {
+            for (uint32_t k = begin; k < size; ++k) {
+#pragma unroll
+                for (int i = 0; i < arity; ++i)
+                    src_val[i] = src[i][src_scalar[i] ? 0 : k];
+                op(dst_val, src_val);
+#pragma unroll
+                for (int i = 0; i < nr_out; ++i)
+                    dst[i][k] = dst_val[i];
+            }
+            return;
+        }
+        Pack src_pack[arity], dst_pack[nr_out];
+#pragma unroll
+        for (int i = 0; i < arity; ++i) {
+            if (src_scalar[i]) {
+                ctype val = src[i][0];
+#pragma unroll
+                for (uint32_t k = 0; k < packed_size; ++k)
+                    src_pack[i].v[k] = val;
+            } else {
+                src_pack[i] = reinterpret_cast<const Pack*>(src[i])[idx];
+            }
+        }
+#pragma unroll
+        for (uint32_t k = 0; k < packed_size; ++k) {
+#pragma unroll
+            for (int i = 0; i < arity; ++i)
+                src_val[i] = src_pack[i].v[k];
+            op(dst_val, src_val);
+#pragma unroll
+            for (int i = 0; i < nr_out; ++i)
+                dst_pack[i].v[k] = dst_val[i];
+        }
+#pragma unroll
+        for (int i = 0; i < nr_out; ++i)
+            reinterpret_cast<Pack*>(dst[i])[idx] = dst_pack[i];
+    }
+
+    devfunc void next() {}
+};
+
+//! invoke a user Op passed to run_elemwise_multi_output
+template <class Op, typename ctype, int arity, int nr_out>
+class MultiOutputInvoker {
+    const ElemwiseOpParamN<arity>& m_param;
+    ctype* const* m_dst;
+    cudaStream_t m_stream;
+    const Op& m_op;
+
+    static bool is_aligned(const void* ptr) {
+        return !(reinterpret_cast<uintptr_t>(ptr) % sizeof(MultiOutputPack<ctype>));
+    }
+
+    static bool is_scalar(const TensorLayout& layout) {
+        for (size_t i = 0; i < layout.ndim; ++i) {
+            if (layout.stride[i])
+                return false;
+        }
+        return true;
+    }
+
+    template <class Caller>
+    void launch(const Caller& caller, size_t size) {
+        int grid_size, block_size;
+        void (*fptr)(Caller, uint32_t) = cuda_kern<Caller>;
+        get_launch_spec(
+                reinterpret_cast<const void*>(fptr), size, &grid_size, &block_size);
+        (*fptr)<<<grid_size, block_size, 0, m_stream>>>(caller, size);
+        after_kernel_launch();
+    }
+
+    bool try_run_vect() {
+        typedef OpCallerMultiOutputVect<Op, ctype, arity, nr_out> Caller;
+        Caller caller;
+        for (int i = 0; i < nr_out; ++i) {
+            if (!is_aligned(m_dst[i]))
+                return false;
+            caller.dst[i] = m_dst[i];
+        }
+        for (int i = 0; i < arity; ++i) {
+            auto&& layout = m_param[i].layout;
+            caller.src[i] = m_param[i].template ptr<ctype>();
+            caller.src_scalar[i] = is_scalar(layout);
+            if (!caller.src_scalar[i] &&
+                !(layout.is_contiguous() && is_aligned(caller.src[i])))
+                return false;
+        }
+        caller.op = m_op;
+        caller.size = m_param.size;
+        launch(caller, DIVUP(m_param.size, Caller::packed_size));
+        return true;
+    }
+
+    void dispatch0() {
+        switch (m_param.max_ndim) {
+#define cb(ndim) \
+    case ndim:   \
+        return dispatch1<ndim>();
+            MEGDNN_FOREACH_TENSOR_NDIM(cb)
+#undef cb
+        }
+        on_bad_ndim(m_param.max_ndim);
+    }
+
+    template <int ndim>
+    void dispatch1() {
+        typedef OpCallerMultiOutput<
+                Op, ctype, arity, nr_out, ParamElemVisitor<ndim, ctype, BCAST_OTHER>>
+                Caller;
+        size_t size = m_param.size;
+        int grid_size, block_size;
+        void (*fptr)(Caller, uint32_t) = cuda_kern<Caller>;
+        get_launch_spec(
+                reinterpret_cast<const void*>(fptr), size, &grid_size, &block_size);
+
+        Caller caller;
+        caller.op = m_op;
+        for (int i = 0; i < arity; ++i)
+            caller.par[i].host_init(m_param[i], grid_size, block_size);
+        for (int i = 0; i < nr_out; ++i)
+            caller.dst[i] = m_dst[i];
+        (*fptr)<<<grid_size, block_size, 0, m_stream>>>(caller, size);
+        after_kernel_launch();
+    }
+
+public:
+    MultiOutputInvoker(
+            const ElemwiseOpParamN<arity>& param, ctype* const* dst,
+            cudaStream_t stream, const Op& op)
+            : m_param(param), m_dst(dst), m_stream(stream), m_op(op) {
+        if (!try_run_vect())
+            dispatch0();
+    }
+};
+
+/* f}}} */
+
 #endif
 
 #undef DEFINE_BRDCAST_DISPATCH_RECEIVERS
@@ -1698,6 +1897,39 @@ void run_elemwise(
             const ElemwiseOpParamN<arity>&, cudaStream_t, const Op&)
 #endif
 
+/*!
+ * \brief element-wise kernel launcher for operators with multiple outputs
+ *
+ * Inputs and outputs are accessed with 16-byte vector loads and stores if
+ * every input is contiguous or a broadcasted scalar and all pointers are
+ * aligned; otherwise each element is visited separately.
+ *
+ * \param param input params, initialized as for run_elemwise
+ * \param dst pointers to nr_out contiguous outputs with param.size elements
+ * \param op callable with a signature compatible with
+ *      `void op(ctype* dst, const ctype* src)`, where src contains arity
+ *      elements and dst nr_out elements
+ */
+template <class Op, typename ctype, int arity, int nr_out>
+void run_elemwise_multi_output(
+        const ElemwiseOpParamN<arity>& param, ctype* const* dst, cudaStream_t stream,
+        const Op& op = Op());
+
+#if MEGDNN_CC_CUDA
+template <class Op, typename ctype, int arity, int nr_out>
+void run_elemwise_multi_output(
+        const ElemwiseOpParamN<arity>& param, ctype* const* dst, cudaStream_t stream,
+        const Op& op) {
+    param.assert_initialized();
+    elemwise_intl::MultiOutputInvoker<Op, ctype, arity, nr_out>(
+            param, dst, stream, op);
+}
+
+#define INST_RUN_ELEMWISE_MULTI_OUTPUT(Op, ctype, arity, nr_out)       \
+    template void run_elemwise_multi_output<Op, ctype, arity, nr_out>( \
+            const ElemwiseOpParamN<arity>&, ctype* const*, cudaStream_t, const Op&)
+#endif
+
 }  // namespace cuda
 }  // namespace megdnn
 
@@ -0,0 +1,49 @@
+/**
+ * \file dnn/src/cuda/elemwise_multi_output/kern.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./kern.cuh"
+#include "src/common/elemwise_multi_output/kern_defs.cuh"
+#include "src/cuda/elemwise_helper.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace elemwise_multi_output {
+
+template <typename ctype>
+void sigmoid_mul(
+        const ElemwiseOpParamN<2>& param, ctype* const* dst, cudaStream_t stream) {
+    using Op = megdnn::elemwise_multi_output::SigmoidMulOp<ctype>;
+    run_elemwise_multi_output<Op, ctype, 2, 2>(param, dst, stream, Op{});
+}
+
+template <typename ctype>
+void momentum_update(
+        const ElemwiseOpParamN<3>& param, ctype* const* dst, float momentum,
+        float lr, cudaStream_t stream) {
+    using Op = megdnn::elemwise_multi_output::MomentumUpdateOp<ctype>;
+    run_elemwise_multi_output<Op, ctype, 3, 2>(param, dst, stream, Op{momentum, lr});
+}
+
+#define INST(_dt)                                                              \
+    template void sigmoid_mul<DTypeTrait<_dt>::ctype>(                         \
+            const ElemwiseOpParamN<2>&, DTypeTrait<_dt>::ctype* const*,        \
+            cudaStream_t);                                                     \
+    template void momentum_update<DTypeTrait<_dt>::ctype>(                     \
+            const ElemwiseOpParamN<3>&, DTypeTrait<_dt>::ctype* const*, float, \
+            float, cudaStream_t);
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(INST)
+#undef INST
+
+}  // namespace elemwise_multi_output
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
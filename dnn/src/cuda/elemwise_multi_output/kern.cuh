@@ -0,0 +1,36 @@
+/**
+ * \file dnn/src/cuda/elemwise_multi_output/kern.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "src/common/elemwise_helper.cuh"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace elemwise_multi_output {
+
+//! dst[0] = sigmoid(x), dst[1] = dst[0] * y
+template <typename ctype>
+void sigmoid_mul(
+        const ElemwiseOpParamN<2>& param, ctype* const* dst, cudaStream_t stream);
+
+//! dst[1] = momentum * buf + grad, dst[0] = param - lr * dst[1]
+template <typename ctype>
+void momentum_update(
+        const ElemwiseOpParamN<3>& param, ctype* const* dst, float momentum,
+        float lr, cudaStream_t stream);
+
+}  // namespace elemwise_multi_output
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: ft=cpp syntax=cpp.doxygen
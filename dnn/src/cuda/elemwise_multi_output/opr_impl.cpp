@@ -0,0 +1,55 @@
+/**
+ * \file dnn/src/cuda/elemwise_multi_output/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./opr_impl.h"
+#include "./kern.cuh"
+
+#include "src/cuda/utils.h"
+
+using namespace megdnn;
+using namespace cuda;
+
+void ElemwiseMultiOutputImpl::on_sigmoid_mul(
+        const ElemwiseOpParamN<2>& param, const TensorNDArray& dst) {
+    auto stream = cuda_stream(handle());
+    switch (param[0].layout.dtype.enumv()) {
+#define cb(_dt)                                                                   \
+    case DTypeTrait<_dt>::enumv: {                                                \
+        using ctype = DTypeTrait<_dt>::ctype;                                     \
+        ctype* dst_ptr[2] = {dst[0].ptr<ctype>(), dst[1].ptr<ctype>()};           \
+        return elemwise_multi_output::sigmoid_mul<ctype>(param, dst_ptr, stream); \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("unsupported dtype for SIGMOID_MUL");
+    }
+}
+
+void ElemwiseMultiOutputImpl::on_momentum_update(
+        const ElemwiseOpParamN<3>& param, const TensorNDArray& dst) {
+    auto stream = cuda_stream(handle());
+    switch (param[0].layout.dtype.enumv()) {
+#define cb(_dt)                                                         \
+    case DTypeTrait<_dt>::enumv: {                                      \
+        using ctype = DTypeTrait<_dt>::ctype;                           \
+        ctype* dst_ptr[2] = {dst[0].ptr<ctype>(), dst[1].ptr<ctype>()}; \
+        return elemwise_multi_output::momentum_update<ctype>(           \
+                param, dst_ptr, m_param.momentum, m_param.lr, stream);  \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("unsupported dtype for MOMENTUM_UPDATE");
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,33 @@
+/**
+ * \file dnn/src/cuda/elemwise_multi_output/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "src/common/elemwise_multi_output/opr_impl_helper.h"
+
+namespace megdnn {
+namespace cuda {
+
+class ElemwiseMultiOutputImpl final : public ElemwiseMultiOutputImplHelper {
+    void on_sigmoid_mul(
+            const ElemwiseOpParamN<2>& param, const TensorNDArray& dst) override;
+
+    void on_momentum_update(
+            const ElemwiseOpParamN<3>& param, const TensorNDArray& dst) override;
+
+public:
+    using ElemwiseMultiOutputImplHelper::ElemwiseMultiOutputImplHelper;
+};
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
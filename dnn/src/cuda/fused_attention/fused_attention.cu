@@ -0,0 +1,265 @@
+/**
+ * \file dnn/src/cuda/fused_attention/fused_attention.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/fused_attention/fused_attention.cuh"
+
+#include <algorithm>
+#include "megdnn/dtype.h"
+#include "src/cuda/cuda_shfl_compat.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+//! number of keys of a tile, one per lane when computing scores
+constexpr uint32_t TILE_KEYS = 32;
+constexpr uint32_t NR_WARPS = 4;
+constexpr uint32_t ROWS_PER_WARP = 4;
+constexpr uint32_t BLOCK_ROWS = NR_WARPS * ROWS_PER_WARP;
+constexpr uint32_t NR_BLOCK_THREADS = NR_WARPS * 32;
+//! number of output columns of a warp in the generic kernel
+constexpr uint32_t GENERIC_COLS = 128;
+
+__device__ __forceinline__ float warp_max(float v) {
+    for (int mask = 16; mask; mask >>= 1) {
+        v = fmaxf(v, __shfl_xor(v, mask, 32));
+    }
+    return v;
+}
+
+__device__ __forceinline__ float warp_sum(float v) {
+    for (int mask = 16; mask; mask >>= 1) {
+        v += __shfl_xor(v, mask, 32);
+    }
+    return v;
+}
+
+//! running max, sum and unnormalized output of a query row held by a warp
+template <int NR_ACC>
+struct RowState {
+    float max_val, sum, acc[NR_ACC];
+
+    __device__ __forceinline__ void init() {
+        max_val = -INFINITY;
+        sum = 0.f;
+#pragma unroll
+        for (int i = 0; i < NR_ACC; ++i) {
+            acc[i] = 0.f;
+        }
+    }
+
+    /*!
+     * \brief rescale the state by the new max of a tile whose score of the
+     *      current lane is \p s, and return exp(s - max)
+     */
+    __device__ __forceinline__ float update_max(float s, bool valid) {
+        float new_max = fmaxf(max_val, warp_max(valid ? s : -INFINITY));
+        float p = valid ? __expf(s - new_max) : 0.f,
+              correction = __expf(max_val - new_max);
+        sum = sum * correction + warp_sum(p);
+        max_val = new_max;
+#pragma unroll
+        for (int i = 0; i < NR_ACC; ++i) {
+            acc[i] *= correction;
+        }
+        return p;
+    }
+};
+
+/*!
+ * \brief each block computes BLOCK_ROWS query rows of a batch, and each warp
+ *      ROWS_PER_WARP of them
+ *
+ * Scores of a key tile are computed by one key per lane, reading the
+ * (pre-scaled) query from shared memory by broadcast; the probabilities are
+ * then broadcast by shuffles and each lane accumulates MAX_D / 32 output
+ * columns.
+ */
+template <typename T, int MAX_D>
+__global__ void attn_tile_kern(
+        const T* q, const T* k, const T* v, T* dst, uint32_t nr_row_block,
+        uint32_t S, uint32_t T_, uint32_t D, uint32_t Dv, float scale) {
+    constexpr int NR_ACC = MAX_D / 32;
+    __shared__ float sq[BLOCK_ROWS][MAX_D];
+    // padded so that lanes reading different keys hit different banks
+    __shared__ float sk[TILE_KEYS][MAX_D + 1];
+    __shared__ float sv[TILE_KEYS][MAX_D];
+    uint32_t b = blockIdx.x / nr_row_block,
+             row0 = blockIdx.x % nr_row_block * BLOCK_ROWS;
+    uint32_t lane = threadIdx.x % 32, warp = threadIdx.x / 32;
+    q += static_cast<size_t>(b) * S * D;
+    k += static_cast<size_t>(b) * T_ * D;
+    v += static_cast<size_t>(b) * T_ * Dv;
+    dst += static_cast<size_t>(b) * S * Dv;
+
+    for (uint32_t i = threadIdx.x; i < BLOCK_ROWS * D; i += NR_BLOCK_THREADS) {
+        uint32_t r = i / D, c = i % D;
+        sq[r][c] = row0 + r < S
+                         ? static_cast<float>(q[(row0 + r) * D + c]) * scale
+                         : 0.f;
+    }
+    RowState<NR_ACC> state[ROWS_PER_WARP];
+#pragma unroll
+    for (uint32_t j = 0; j < ROWS_PER_WARP; ++j) {
+        state[j].init();
+    }
+
+    for (uint32_t t0 = 0; t0 < T_; t0 += TILE_KEYS) {
+        uint32_t nr_key = min(TILE_KEYS, T_ - t0);
+        __syncthreads();
+        for (uint32_t i = threadIdx.x; i < TILE_KEYS * D; i += NR_BLOCK_THREADS) {
+            uint32_t r = i / D, c = i % D;
+            sk[r][c] = r < nr_key ? static_cast<float>(k[(t0 + r) * D + c]) : 0.f;
+        }
+        for (uint32_t i = threadIdx.x; i < TILE_KEYS * Dv; i += NR_BLOCK_THREADS) {
+            uint32_t r = i / Dv, c = i % Dv;
+            sv[r][c] = r < nr_key ? static_cast<float>(v[(t0 + r) * Dv + c]) : 0.f;
+        }
+        __syncthreads();
+#pragma unroll
+        for (uint32_t j = 0; j < ROWS_PER_WARP; ++j) {
+            const float* qr = sq[warp * ROWS_PER_WARP + j];
+            float s = 0.f;
+            for (uint32_t c = 0; c < D; ++c) {
+                s += qr[c] * sk[lane][c];
+            }
+            float p = state[j].update_max(s, lane < nr_key);
+            for (uint32_t key = 0; key < nr_key; ++key) {
+                float pk = __shfl(p, key, 32);
+#pragma unroll
+                for (int a = 0; a < NR_ACC; ++a) {
+                    state[j].acc[a] += pk * sv[key][lane + a * 32];
+                }
+            }
+        }
+    }
+
+#pragma unroll
+    for (uint32_t j = 0; j < ROWS_PER_WARP; ++j) {
+        uint32_t row = row0 + warp * ROWS_PER_WARP + j;
+        if (row >= S) {
+            break;
+        }
+        float inv = 1.f / state[j].sum;
+#pragma unroll
+        for (int a = 0; a < NR_ACC; ++a) {
+            uint32_t c = lane + a * 32;
+            if (c < Dv) {
+                dst[row * Dv + c] = static_cast<T>(state[j].acc[a] * inv);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief each warp computes GENERIC_COLS output columns of a query row,
+ *      reading keys and values from global memory
+ *
+ * Used for large head dims whose tiles do not fit in shared memory; the
+ * scores are recomputed for each column chunk.
+ */
+template <typename T>
+__global__ void attn_generic_kern(
+        const T* q, const T* k, const T* v, T* dst, uint32_t nr_row_block,
+        uint32_t S, uint32_t T_, uint32_t D, uint32_t Dv, float scale) {
+    constexpr int NR_ACC = GENERIC_COLS / 32;
+    uint32_t b = blockIdx.x / nr_row_block,
+             row = blockIdx.x % nr_row_block * NR_WARPS + threadIdx.x / 32,
+             lane = threadIdx.x % 32, col0 = blockIdx.y * GENERIC_COLS;
+    if (row >= S) {
+        return;
+    }
+    q += (static_cast<size_t>(b) * S + row) * D;
+    k += static_cast<size_t>(b) * T_ * D;
+    v += static_cast<size_t>(b) * T_ * Dv;
+    dst += (static_cast<size_t>(b) * S + row) * Dv;
+    RowState<NR_ACC> state;
+    state.init();
+    for (uint32_t t0 = 0; t0 < T_; t0 += TILE_KEYS) {
+        uint32_t nr_key = min(TILE_KEYS, T_ - t0);
+        float s = 0.f;
+        if (lane < nr_key) {
+            const T* kr = k + static_cast<size_t>(t0 + lane) * D;
+            for (uint32_t c = 0; c < D; ++c) {
+                s += static_cast<float>(q[c]) * static_cast<float>(kr[c]);
+            }
+            s *= scale;
+        }
+        float p = state.update_max(s, lane < nr_key);
+        for (uint32_t key = 0; key < nr_key; ++key) {
+            float pk = __shfl(p, key, 32);
+            const T* vr = v + static_cast<size_t>(t0 + key) * Dv;
+#pragma unroll
+            for (int a = 0; a < NR_ACC; ++a) {
+                uint32_t c = col0 + lane + a * 32;
+                if (c < Dv) {
+                    state.acc[a] += pk * static_cast<float>(vr[c]);
+                }
+            }
+        }
+    }
+    float inv = 1.f / state.sum;
+#pragma unroll
+    for (int a = 0; a < NR_ACC; ++a) {
+        uint32_t c = col0 + lane + a * 32;
+        if (c < Dv) {
+            dst[c] = static_cast<T>(state.acc[a] * inv);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace fused_attention {
+
+template <typename T>
+void forward_proxy(
+        const T* q, const T* k, const T* v, T* dst, uint32_t B, uint32_t S,
+        uint32_t T_, uint32_t D, uint32_t Dv, float scale, cudaStream_t stream) {
+    if (!B || !S) {
+        return;
+    }
+    uint32_t head_dim = std::max(D, Dv);
+    if (head_dim <= MAX_TILE_HEAD_DIM) {
+        uint32_t nr_row_block = DIVUP(S, BLOCK_ROWS);
+        if (head_dim <= 64) {
+            attn_tile_kern<T, 64><<<B * nr_row_block, NR_BLOCK_THREADS, 0, stream>>>(
+                    q, k, v, dst, nr_row_block, S, T_, D, Dv, scale);
+        } else {
+            attn_tile_kern<T, 128><<<B * nr_row_block, NR_BLOCK_THREADS, 0, stream>>>(
+                    q, k, v, dst, nr_row_block, S, T_, D, Dv, scale);
+        }
+    } else {
+        uint32_t nr_row_block = DIVUP(S, NR_WARPS);
+        dim3 blocks(B * nr_row_block, DIVUP(Dv, GENERIC_COLS));
+        attn_generic_kern<T><<<blocks, NR_BLOCK_THREADS, 0, stream>>>(
+                q, k, v, dst, nr_row_block, S, T_, D, Dv, scale);
+    }
+    after_kernel_launch();
+}
+
+#define INST(T)                                                             \
+    template void forward_proxy<T>(                                         \
+            const T*, const T*, const T*, T*, uint32_t, uint32_t, uint32_t, \
+            uint32_t, uint32_t, float, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace fused_attention
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,41 @@
+/**
+ * \file dnn/src/cuda/fused_attention/fused_attention.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace fused_attention {
+
+//! head dims up to this value are computed by the tiled kernel
+constexpr uint32_t MAX_TILE_HEAD_DIM = 128;
+
+/*!
+ * \brief dst = softmax(q * k^T * scale) * v of (B, S, D), (B, T, D) and
+ *      (B, T, Dv) shaped tensors
+ *
+ * Keys are processed in tiles with an online softmax, so the scores are never
+ * written to global memory. If D and Dv are no larger than MAX_TILE_HEAD_DIM,
+ * a block of query rows shares the key and value tiles in shared memory;
+ * otherwise each warp streams keys and values from global memory.
+ */
+template <typename T>
+void forward_proxy(
+        const T* q, const T* k, const T* v, T* dst, uint32_t B, uint32_t S,
+        uint32_t T_, uint32_t D, uint32_t Dv, float scale, cudaStream_t stream);
+
+}  // namespace fused_attention
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
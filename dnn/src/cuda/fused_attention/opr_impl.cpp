@@ -0,0 +1,55 @@
+/**
+ * \file dnn/src/cuda/fused_attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/fused_attention/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/cuda/fused_attention/fused_attention.cuh"
+#include "src/cuda/handle.h"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void FusedAttentionForwardImpl::exec(
+        _megdnn_tensor_in query, _megdnn_tensor_in key, _megdnn_tensor_in value,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(query.layout, key.layout, value.layout, dst.layout, workspace.size);
+    size_t B = query.layout[0], S = query.layout[1], T = key.layout[1],
+           D = query.layout[2], Dv = value.layout[2];
+    if (!B || !S) {
+        return;
+    }
+    megdnn_assert(T, "attention over empty keys");
+    megdnn_assert(
+            query.layout.total_nr_elems() <= UINT32_MAX &&
+                    key.layout.total_nr_elems() <= UINT32_MAX &&
+                    value.layout.total_nr_elems() <= UINT32_MAX &&
+                    dst.layout.total_nr_elems() <= UINT32_MAX,
+            "attention tensors are too large");
+    auto stream = cuda_stream(this->handle());
+    float scale = param().scale;
+#define cb(DType)                                                         \
+    if (query.layout.dtype == DType()) {                                  \
+        using ctype = typename DTypeTrait<DType>::ctype;                  \
+        fused_attention::forward_proxy<ctype>(                            \
+                query.ptr<ctype>(), key.ptr<ctype>(), value.ptr<ctype>(), \
+                dst.ptr<ctype>(), B, S, T, D, Dv, scale, stream);         \
+        return;                                                           \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,107 @@
+/**
+ * \file dnn/src/cuda/group_norm/group_norm.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/group_norm/group_norm.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/norm_helper.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+constexpr int NR_PARAM_THREADS = 256;
+
+//! dweight and dbias of the blockIdx.x-th channel
+template <typename T, int NR_X>
+__global__ void bwd_param_kern(
+        const T* dy, const T* x, const float* mean, const float* rstd, T* dw, T* db,
+        uint32_t N, uint32_t C, uint32_t G, uint32_t S) {
+    uint32_t c = blockIdx.x, cpg = C / G;
+    norm::Sum2 v = norm::Sum2::identity();
+    for (uint32_t n = 0; n < N; ++n) {
+        uint32_t r = n * G + c / cpg;
+        float m = mean[r], rs = rstd[r];
+        size_t offset = (static_cast<size_t>(n) * C + c) * S;
+        for (uint32_t i = threadIdx.x; i < S; i += NR_X) {
+            float g = static_cast<float>(dy[offset + i]);
+            v.a += g * (static_cast<float>(x[offset + i]) - m) * rs;
+            v.b += g;
+        }
+    }
+    v = norm::reduce_x<NR_X>(v);
+    if (!threadIdx.x) {
+        dw[c] = static_cast<T>(v.a);
+        db[c] = static_cast<T>(v.b);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace group_norm {
+
+template <typename T>
+void forward_proxy(
+        const T* x, const T* w, const T* b, T* y, float* mean, float* rstd, size_t N,
+        size_t C, size_t G, size_t S, float eps, cudaStream_t stream) {
+    size_t cpg = C / G;
+    if (!N || !cpg || !S) {
+        return;
+    }
+    norm::ChannelIndex index{
+            static_cast<uint32_t>(G), static_cast<uint32_t>(cpg),
+            static_cast<uint32_t>(S)};
+    norm::launch_fwd(x, w, b, y, mean, rstd, N * G, cpg * S, eps, index, stream);
+}
+
+template <typename T>
+void backward_proxy(
+        const T* dy, const T* x, const T* w, const float* mean, const float* rstd,
+        T* dx, T* dw, T* db, size_t N, size_t C, size_t G, size_t S,
+        cudaStream_t stream) {
+    size_t cpg = C / G;
+    if (!cpg) {
+        return;
+    }
+    if (N && S) {
+        norm::ChannelIndex index{
+                static_cast<uint32_t>(G), static_cast<uint32_t>(cpg),
+                static_cast<uint32_t>(S)};
+        norm::launch_bwd_data(
+                dy, x, w, mean, rstd, dx, N * G, cpg * S, index, stream);
+    }
+    if (w) {
+        bwd_param_kern<T, NR_PARAM_THREADS><<<C, NR_PARAM_THREADS, 0, stream>>>(
+                dy, x, mean, rstd, dw, db, N, C, G, S);
+        after_kernel_launch();
+    }
+}
+
+#define INST(T)                                                                   \
+    template void forward_proxy<T>(                                               \
+            const T*, const T*, const T*, T*, float*, float*, size_t, size_t,     \
+            size_t, size_t, float, cudaStream_t);                                 \
+    template void backward_proxy<T>(                                              \
+            const T*, const T*, const T*, const float*, const float*, T*, T*, T*, \
+            size_t, size_t, size_t, size_t, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace group_norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,41 @@
+/**
+ * \file dnn/src/cuda/group_norm/group_norm.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace group_norm {
+
+/*!
+ * \brief normalize each of the G groups of a (N, C, S) tensor
+ *
+ * w and b are per-channel params, or null if no affine transform is applied.
+ */
+template <typename T>
+void forward_proxy(
+        const T* x, const T* w, const T* b, T* y, float* mean, float* rstd, size_t N,
+        size_t C, size_t G, size_t S, float eps, cudaStream_t stream);
+
+//! gradients of group norm; dw and db are only computed if w is not null
+template <typename T>
+void backward_proxy(
+        const T* dy, const T* x, const T* w, const float* mean, const float* rstd,
+        T* dx, T* dw, T* db, size_t N, size_t C, size_t G, size_t S,
+        cudaStream_t stream);
+
+}  // namespace group_norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
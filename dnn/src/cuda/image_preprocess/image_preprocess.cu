@@ -0,0 +1,114 @@
+/**
+ * \file dnn/src/cuda/image_preprocess/image_preprocess.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/image_preprocess/image_preprocess.cuh"
+
+#include "src/common/image_preprocess.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+using namespace image_preprocess;
+
+namespace {
+
+constexpr uint32_t BLOCK_SIZE = 128;
+
+template <uint32_t mode, bool linear>
+__global__ void forward_kern(
+        const uint8_t* src, const float* scale, const float* bias, float* dst,
+        uint32_t IH, uint32_t IW, uint32_t OH, uint32_t OW, uint32_t src_size,
+        DstStride stride, bool pad_channel) {
+    uint32_t ow = blockIdx.x * BLOCK_SIZE + threadIdx.x, oh = blockIdx.y,
+             n = blockIdx.z;
+    if (ow >= OW) {
+        return;
+    }
+    const uint8_t* sptr = src + n * src_size;
+    float scale_h = static_cast<float>(OH) / IH,
+          scale_w = static_cast<float>(OW) / IW;
+    float value[3];
+    if (linear) {
+        int ih0, ih1, iw0, iw1;
+        float ah1, aw1;
+        get_linear_coord(scale_h, IH, oh, ih0, ih1, ah1);
+        get_linear_coord(scale_w, IW, ow, iw0, iw1, aw1);
+        float ah0 = 1 - ah1, aw0 = 1 - aw1;
+        int p00[3], p01[3], p10[3], p11[3];
+        load_pixel(sptr, IH, IW, ih0, iw0, mode, p00);
+        load_pixel(sptr, IH, IW, ih0, iw1, mode, p01);
+        load_pixel(sptr, IH, IW, ih1, iw0, mode, p10);
+        load_pixel(sptr, IH, IW, ih1, iw1, mode, p11);
+#pragma unroll
+        for (int c = 0; c < 3; ++c) {
+            value[c] = p00[c] * ah0 * aw0 + p01[c] * ah0 * aw1 + p10[c] * ah1 * aw0 +
+                       p11[c] * ah1 * aw1;
+        }
+    } else {
+        int p00[3];
+        load_pixel(
+                sptr, IH, IW, get_nearest_coord(scale_h, IH, oh),
+                get_nearest_coord(scale_w, IW, ow), mode, p00);
+#pragma unroll
+        for (int c = 0; c < 3; ++c) {
+            value[c] = p00[c];
+        }
+    }
+    float* dptr = dst + n * stride.image + oh * stride.row + ow * stride.pixel;
+#pragma unroll
+    for (int c = 0; c < 3; ++c) {
+        dptr[c * stride.channel] = value[c] * scale[c] + bias[c];
+    }
+    if (pad_channel) {
+        dptr[3] = 0.f;
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace image_preprocess {
+
+void forward_proxy(
+        const uint8_t* src, const float* scale, const float* bias, float* dst,
+        uint32_t N, uint32_t IH, uint32_t IW, uint32_t OH, uint32_t OW,
+        DstStride stride, uint32_t mode, bool linear, bool pad_channel,
+        cudaStream_t stream) {
+    bool yuv = mode != Mode::RGB && mode != Mode::RGB2BGR;
+    uint32_t src_size = yuv ? IH * IW * 3 / 2 : IH * IW * 3;
+    dim3 blocks(DIVUP(OW, BLOCK_SIZE), OH, N);
+    switch (mode) {
+#define cb(_mode)                                                                \
+    case Mode::_mode:                                                            \
+        if (linear) {                                                            \
+            forward_kern<Mode::_mode, true><<<blocks, BLOCK_SIZE, 0, stream>>>(  \
+                    src, scale, bias, dst, IH, IW, OH, OW, src_size, stride,     \
+                    pad_channel);                                                \
+        } else {                                                                 \
+            forward_kern<Mode::_mode, false><<<blocks, BLOCK_SIZE, 0, stream>>>( \
+                    src, scale, bias, dst, IH, IW, OH, OW, src_size, stride,     \
+                    pad_channel);                                                \
+        }                                                                        \
+        break;
+        cb(RGB) cb(RGB2BGR) cb(YUV2RGB_NV21) cb(YUV2BGR_NV21) cb(YUV2RGB_NV12)
+                cb(YUV2BGR_NV12)
+#undef cb
+        default:
+            megdnn_throw("unsupported image preprocess mode for cuda");
+    }
+    after_kernel_launch();
+}
+
+}  // namespace image_preprocess
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
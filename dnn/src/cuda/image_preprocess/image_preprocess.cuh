@@ -0,0 +1,45 @@
+/**
+ * \file dnn/src/cuda/image_preprocess/image_preprocess.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace image_preprocess {
+
+//! strides of dst of an image, a row, a pixel and a channel
+struct DstStride {
+    uint32_t image, row, pixel, channel;
+};
+
+/*!
+ * \brief convert color, resize and normalize uint8 images of N * IH * IW
+ *      pixels into float dst in one kernel
+ *
+ * A thread computes an output pixel, which converts the color of the source
+ * pixels it samples in registers.
+ *
+ * \param mode the param_enumv::ImagePreprocess::Mode
+ * \param pad_channel whether to write a zero 4th channel
+ */
+void forward_proxy(
+        const uint8_t* src, const float* scale, const float* bias, float* dst,
+        uint32_t N, uint32_t IH, uint32_t IW, uint32_t OH, uint32_t OW,
+        DstStride stride, uint32_t mode, bool linear, bool pad_channel,
+        cudaStream_t stream);
+
+}  // namespace image_preprocess
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
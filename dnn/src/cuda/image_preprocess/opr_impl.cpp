@@ -0,0 +1,60 @@
+/**
+ * \file dnn/src/cuda/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/image_preprocess/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/cuda/handle.h"
+#include "src/cuda/image_preprocess/image_preprocess.cuh"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, scale.layout, bias.layout, dst.layout, workspace.size);
+    if (!dst.layout.total_nr_elems()) {
+        return;
+    }
+    megdnn_assert(
+            src.layout.total_nr_elems() <= UINT32_MAX &&
+                    dst.layout.total_nr_elems() <= UINT32_MAX,
+            "image preprocess tensors are too large");
+    using Format = param::ImagePreprocess::Format;
+    auto mode = param().mode;
+    bool yuv = mode != Param::Mode::RGB && mode != Param::Mode::RGB2BGR;
+    bool nhwc = param().format == Format::NHWC;
+    uint32_t IH = yuv ? src.layout[1] / 3 * 2 : src.layout[1], IW = src.layout[2],
+             OH = dst.layout[nhwc ? 1 : 2], OW = dst.layout[nhwc ? 2 : 3];
+    image_preprocess::DstStride stride;
+    stride.image = dst.layout.stride[0];
+    if (param().format == Format::NCHW) {
+        stride.row = OW;
+        stride.pixel = 1;
+        stride.channel = OH * OW;
+    } else {
+        stride.pixel = nhwc ? 3 : 4;
+        stride.row = OW * stride.pixel;
+        stride.channel = 1;
+    }
+    image_preprocess::forward_proxy(
+            src.ptr<dt_uint8>(), scale.ptr<dt_float32>(), bias.ptr<dt_float32>(),
+            dst.ptr<dt_float32>(), src.layout[0], IH, IW, OH, OW, stride,
+            static_cast<uint32_t>(mode),
+            param().imode == param::ImagePreprocess::InterpolationMode::LINEAR,
+            param().format == Format::NCHW44, cuda_stream(this->handle()));
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -67,6 +67,30 @@ struct ApplyOprParam {
     FastLayout<ndim> value_ly_on_data;
 };
 
+//! param for incr_deterministic
+template <typename ctype, int ndim>
+struct IncrDeterministicParam {
+    uint32_t nr_idx;     //!< size of the indexed axis of value
+    uint32_t rest_size;  //!< number of value elements for each index
+
+    //! offset array generated by gen_offset_base
+    const int* offset_base;
+    ctype *data, *value;
+
+    int value_stride;
+
+    //! distance between neighbouring indices on the flattened value
+    int value_idx_stride;
+
+    //! number of bits needed by the largest offset in offset_base
+    int offset_bits;
+
+    //! shape of the non-indexed axes of value, and their strides on data and
+    //! on the flattened value; only the first ndim - 1 items are used
+    Uint32Fastdiv rest_shape[ndim];
+    int rest_data_stride[ndim], rest_value_stride[ndim];
+};
+
 //! generate offset bases for first axis in the output
 template <int nidx>
 void gen_offset_base(const GenOffsetBaseParam<nidx>& param, cudaStream_t stream);
@@ -88,6 +112,21 @@ struct OprAtomicIncr {
 template <typename ctype, int ndim, class Opr>
 void apply_opr(const ApplyOprParam<ctype, ndim>& param, cudaStream_t stream);
 
+//! workspace needed by incr_deterministic, excluding the offset base
+size_t get_incr_deterministic_workspace(uint32_t nr_idx);
+
+/*!
+ * \brief incr kernel without atomics
+ *
+ * The offset bases are sorted by a stable radix sort, and each location in
+ * data is then accumulated by a single thread in the order of the indices,
+ * so the result is reproducible even if index values overlap.
+ */
+template <typename ctype, int ndim>
+void incr_deterministic(
+        const IncrDeterministicParam<ctype, ndim>& param, void* workspace,
+        cudaStream_t stream);
+
 }  // namespace indexing_multi_axis_vec
 }  // namespace cuda
 }  // namespace megdnn
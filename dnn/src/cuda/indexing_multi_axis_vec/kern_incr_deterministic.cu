@@ -0,0 +1,114 @@
+/**
+ * \file dnn/src/cuda/indexing_multi_axis_vec/kern_incr_deterministic.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./kern.cuh"
+#include "megdnn/dtype.h"
+#include "megdnn/internal/defs.h"
+#include "src/cuda/argsort/argsort.cuh"
+#include "src/cuda/query_blocksize.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+using namespace indexing_multi_axis_vec;
+
+namespace {
+__global__ void kern_iota(uint32_t* dst, uint32_t size) {
+    uint32_t i = threadIdx.x + blockIdx.x * blockDim.x;
+    if (i < size) {
+        dst[i] = i;
+    }
+}
+
+template <typename ctype, int ndim>
+__global__ void kincr_deterministic(
+        IncrDeterministicParam<ctype, ndim> param, const uint32_t* sorted_offset,
+        const uint32_t* sorted_idx, Uint32Fastdiv rest_size) {
+    uint32_t tid = threadIdx.x + blockDim.x * blockIdx.x;
+    if (tid >= param.nr_idx * param.rest_size) {
+        return;
+    }
+    uint32_t pos = tid / rest_size, rest_idx = tid - pos * param.rest_size;
+    uint32_t offset = sorted_offset[pos];
+    // indices with the same offset are accumulated by the first of them
+    if (pos && sorted_offset[pos - 1] == offset) {
+        return;
+    }
+    int data_offset = offset, value_offset = 0;
+#pragma unroll
+    for (int i = ndim - 2; i >= 0; --i) {
+        uint32_t next = rest_idx / param.rest_shape[i],
+                 ax_idx = rest_idx - next * param.rest_shape[i].divisor();
+        data_offset += param.rest_data_stride[i] * ax_idx;
+        value_offset += param.rest_value_stride[i] * ax_idx;
+        rest_idx = next;
+    }
+    ctype acc = param.data[data_offset];
+    do {
+        int vidx = value_offset + sorted_idx[pos] * param.value_idx_stride;
+        acc += param.value[vidx * param.value_stride];
+    } while (++pos < param.nr_idx && sorted_offset[pos] == offset);
+    param.data[data_offset] = acc;
+}
+
+size_t get_sort_workspace(uint32_t nr_idx) {
+    return argsort::cub_sort_pairs<uint32_t, uint32_t>(
+            true, NULL, 0, NULL, NULL, NULL, NULL, 1, nr_idx, 0, 32, NULL);
+}
+}  // anonymous namespace
+
+size_t indexing_multi_axis_vec::get_incr_deterministic_workspace(uint32_t nr_idx) {
+    return sizeof(uint32_t) * nr_idx * 3 + get_sort_workspace(nr_idx);
+}
+
+template <typename ctype, int ndim>
+void indexing_multi_axis_vec::incr_deterministic(
+        const IncrDeterministicParam<ctype, ndim>& param, void* workspace,
+        cudaStream_t stream) {
+    uint32_t nr_idx = param.nr_idx;
+    auto sorted_offset = static_cast<uint32_t*>(workspace),
+         idx = sorted_offset + nr_idx, sorted_idx = idx + nr_idx;
+    kern_iota<<<DIVUP(nr_idx, 512), 512, 0, stream>>>(idx, nr_idx);
+    after_kernel_launch();
+    // the radix sort is stable, so indices with the same offset keep their
+    // order and the accumulation order is fixed
+    argsort::cub_sort_pairs<uint32_t, uint32_t>(
+            true, sorted_idx + nr_idx, get_sort_workspace(nr_idx),
+            reinterpret_cast<const uint32_t*>(param.offset_base), sorted_offset, idx,
+            sorted_idx, 1, nr_idx, 0, param.offset_bits, stream);
+
+    void (*kptr)(
+            IncrDeterministicParam<ctype, ndim>, const uint32_t*, const uint32_t*,
+            Uint32Fastdiv) = kincr_deterministic<ctype, ndim>;
+    int bsize = query_blocksize_for_kernel(kptr);
+    (*kptr)<<<DIVUP(nr_idx * param.rest_size, bsize), bsize, 0, stream>>>(
+            param, sorted_offset, sorted_idx, param.rest_size);
+    after_kernel_launch();
+}
+
+namespace megdnn {
+namespace cuda {
+namespace indexing_multi_axis_vec {
+
+#define INST(_ndim, _ctype)                                      \
+    template void incr_deterministic<_ctype, _ndim>(             \
+            const IncrDeterministicParam<_ctype, _ndim>&, void*, \
+            cudaStream_t);
+#define cb0(_dtype) MEGDNN_FOREACH_TENSOR_NDIM(INST, DTypeTrait<_dtype>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE(cb0)
+cb0(::megdnn::dtype::Bool)
+#undef cb0
+#undef INST
+
+}  // namespace indexing_multi_axis_vec
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: ft=cuda syntax=cpp.doxygen
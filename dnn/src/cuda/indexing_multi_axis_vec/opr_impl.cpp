@@ -64,6 +64,38 @@ public:
         after_kernel_launch();
     }
 };
+//! ExecImpl for IndexingIncrMultiAxisVec that does not use atomics
+class IncrDeterministicExecImpl : public ExecImplHelper {
+    int m_offset_bits;
+
+    void dispatch_exec();
+
+    template <typename ctype>
+    void dispatch_exec_ctype();
+
+    template <typename ctype, int ndim>
+    void dispatch_exec_ctype_ndim();
+
+public:
+    IncrDeterministicExecImpl(
+            const TensorND& data, const TensorND& value, const IndexDesc& index,
+            const Workspace& workspace, const ExecInfo& exec_info,
+            cudaStream_t stream);
+
+    void operator()() { dispatch_exec(); }
+};
+
+//! whether atomicAdd is implemented for the dtype in kern_apply_opr_incr.cu
+bool has_atomic_incr(DType dtype) {
+    switch (dtype.enumv()) {
+        case DTypeEnum::Float32:
+        case DTypeEnum::Int32:
+            DNN_INC_FLOAT16(case DTypeEnum::Float16:)
+            return true;
+        default:
+            return false;
+    }
+}
 }  // anonymous namespace
 
 ExecImplHelper::ExecImplHelper(
@@ -163,6 +195,73 @@ void ExecImpl<Opr>::dispatch_exec_ctype_ndim() {
     apply_opr<ctype, ndim, Opr>(param, m_stream);
 }
 
+IncrDeterministicExecImpl::IncrDeterministicExecImpl(
+        const TensorND& data, const TensorND& value, const IndexDesc& index,
+        const Workspace& workspace, const ExecInfo& exec_info, cudaStream_t stream)
+        : ExecImplHelper(data, value, index, workspace, exec_info, stream) {
+    // offsets are sorted as uint32, so negative offsets need all the bits
+    auto span = data.layout.span();
+    m_offset_bits = 32;
+    if (span.low_elem >= 0) {
+        m_offset_bits = 1;
+        while (m_offset_bits < 32 && (size_t(1) << m_offset_bits) < span.high_elem) {
+            ++m_offset_bits;
+        }
+    }
+}
+
+void IncrDeterministicExecImpl::dispatch_exec() {
+    switch (m_data->layout.dtype.enumv()) {
+#define cb(_dtype)                  \
+    case DTypeTrait<_dtype>::enumv: \
+        return dispatch_exec_ctype<DTypeTrait<_dtype>::ctype>();
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Bool)
+#undef cb
+                default : megdnn_throw("bad dtype");
+    }
+}
+
+template <typename ctype>
+void IncrDeterministicExecImpl::dispatch_exec_ctype() {
+    switch (m_value_layout_on_data.ndim) {
+#define cb(_n) \
+    case _n:   \
+        return dispatch_exec_ctype_ndim<ctype, _n>();
+        MEGDNN_FOREACH_TENSOR_NDIM(cb)
+#undef cb
+        default:
+            megdnn_throw("bad data ndim");
+    }
+}
+
+template <typename ctype, int ndim>
+void IncrDeterministicExecImpl::dispatch_exec_ctype_ndim() {
+    auto&& ly = m_value_layout_on_data;
+    IncrDeterministicParam<ctype, ndim> param;
+    param.nr_idx = ly.shape[m_idx_axis];
+    param.rest_size =
+            safe_size_in_kern(m_value->layout.total_nr_elems()) / param.nr_idx;
+    param.offset_base = m_offset_base;
+    param.data = m_data->ptr<ctype>();
+    param.value = m_value->ptr<ctype>();
+    param.value_stride = m_value_stride;
+    param.offset_bits = m_offset_bits;
+    int value_stride = 1;
+    for (int i = ndim - 1, j = ndim - 2; i >= 0; --i) {
+        if (i == static_cast<int>(m_idx_axis)) {
+            param.value_idx_stride = value_stride;
+        } else {
+            param.rest_shape[j] = ly.shape[i];
+            param.rest_data_stride[j] = ly.stride[i];
+            param.rest_value_stride[j] = value_stride;
+            --j;
+        }
+        value_stride *= ly.shape[i];
+    }
+    incr_deterministic(param, m_offset_base + param.nr_idx, m_stream);
+}
+
 size_t IndexingMultiAxisVecImpl::get_workspace_in_bytes(size_t dst_idx_size) {
     return dst_idx_size * sizeof(int);
 }
@@ -192,7 +291,22 @@ void IndexingSetMultiAxisVecImpl::exec(
 }
 
 size_t IndexingIncrMultiAxisVecImpl::get_workspace_in_bytes(size_t value_idx_size) {
-    return value_idx_size * sizeof(int);
+    return value_idx_size * sizeof(int) +
+           get_incr_deterministic_workspace(value_idx_size);
+}
+
+bool IndexingIncrMultiAxisVecImpl::use_deterministic(
+        const TensorLayout& data, const IndexDesc& index, size_t nr_idx) {
+    if (deterministic() || !has_atomic_incr(data.dtype)) {
+        return true;
+    }
+    // many indices onto few locations must collide heavily, and atomics on
+    // the same address are serialized
+    size_t nr_loc = 1;
+    for (auto&& i : index) {
+        nr_loc *= data.shape[i.axis];
+    }
+    return nr_idx >= nr_loc * 2;
 }
 
 void IndexingIncrMultiAxisVecImpl::exec(
@@ -201,6 +315,11 @@ void IndexingIncrMultiAxisVecImpl::exec(
     auto info = check_exec(data.layout, value.layout, index, workspace.size);
     info.error_tracker = m_error_tracker;
     info.error_info = async_error_info(handle());
+    if (use_deterministic(data.layout, index, value.layout[info.idx_axis])) {
+        IncrDeterministicExecImpl{
+                data, value, index, workspace, info, cuda_stream(handle())}();
+        return;
+    }
     ExecImpl<OprAtomicIncr>{data,      value, index,
                             workspace, info,  cuda_stream(handle())}();
 }
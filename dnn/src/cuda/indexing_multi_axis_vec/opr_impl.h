@@ -49,6 +49,10 @@ public:
 class IndexingIncrMultiAxisVecImpl final : public IndexingIncrMultiAxisVec {
     void* m_error_tracker = nullptr;
 
+    //! whether to sort the indices instead of accumulating by atomics
+    bool use_deterministic(
+            const TensorLayout& data, const IndexDesc& index, size_t nr_idx);
+
 public:
     using IndexingIncrMultiAxisVec::IndexingIncrMultiAxisVec;
 
@@ -0,0 +1,139 @@
+/**
+ * \file dnn/src/cuda/layer_norm/layer_norm.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/layer_norm/layer_norm.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/norm_helper.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+constexpr uint32_t PARAM_BLOCK_X = 32;
+constexpr uint32_t PARAM_BLOCK_Y = 8;
+
+/*!
+ * \brief partial sums of dweight and dbias over the blockIdx.y-th chunk of
+ *      rows
+ *
+ * Adjacent threads along x access adjacent columns, and the threads along y
+ * are reduced in shared memory.
+ */
+template <typename T>
+__global__ void bwd_param_partial_kern(
+        const T* dy, const T* x, const float* mean, const float* rstd, float* ws,
+        uint32_t nr_row, uint32_t len, uint32_t chunk_rows) {
+    __shared__ float sum_w[PARAM_BLOCK_Y][PARAM_BLOCK_X + 1],
+            sum_b[PARAM_BLOCK_Y][PARAM_BLOCK_X + 1];
+    uint32_t col = blockIdx.x * PARAM_BLOCK_X + threadIdx.x,
+             begin = blockIdx.y * chunk_rows, end = min(nr_row, begin + chunk_rows);
+    float vw = 0.f, vb = 0.f;
+    if (col < len) {
+        for (uint32_t r = begin + threadIdx.y; r < end; r += PARAM_BLOCK_Y) {
+            size_t offset = static_cast<size_t>(r) * len + col;
+            float g = static_cast<float>(dy[offset]);
+            vw += g * (static_cast<float>(x[offset]) - mean[r]) * rstd[r];
+            vb += g;
+        }
+    }
+    sum_w[threadIdx.y][threadIdx.x] = vw;
+    sum_b[threadIdx.y][threadIdx.x] = vb;
+    __syncthreads();
+    if (threadIdx.y || col >= len) {
+        return;
+    }
+    for (uint32_t i = 1; i < PARAM_BLOCK_Y; ++i) {
+        vw += sum_w[i][threadIdx.x];
+        vb += sum_b[i][threadIdx.x];
+    }
+    ws[blockIdx.y * len + col] = vw;
+    ws[(gridDim.y + blockIdx.y) * len + col] = vb;
+}
+
+template <typename T>
+__global__ void bwd_param_final_kern(
+        const float* ws, T* dw, T* db, uint32_t nr_chunk, uint32_t len) {
+    uint32_t col = blockIdx.x * blockDim.x + threadIdx.x;
+    if (col >= len) {
+        return;
+    }
+    float vw = 0.f, vb = 0.f;
+    for (uint32_t i = 0; i < nr_chunk; ++i) {
+        vw += ws[i * len + col];
+        vb += ws[(nr_chunk + i) * len + col];
+    }
+    dw[col] = static_cast<T>(vw);
+    db[col] = static_cast<T>(vb);
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace layer_norm {
+
+template <typename T>
+void forward_proxy(
+        const T* x, const T* w, const T* b, T* y, float* mean, float* rstd,
+        size_t nr_row, size_t len, float eps, cudaStream_t stream) {
+    if (!nr_row || !len) {
+        return;
+    }
+    norm::launch_fwd(
+            x, w, b, y, mean, rstd, nr_row, len, eps, norm::RowIndex{}, stream);
+}
+
+template <typename T>
+void backward_proxy(
+        const T* dy, const T* x, const T* w, const float* mean, const float* rstd,
+        T* dx, T* dw, T* db, size_t nr_row, size_t len, float* workspace,
+        cudaStream_t stream) {
+    if (!len) {
+        return;
+    }
+    if (nr_row) {
+        norm::launch_bwd_data(
+                dy, x, w, mean, rstd, dx, nr_row, len, norm::RowIndex{}, stream);
+    }
+    if (!w) {
+        return;
+    }
+    uint32_t nr_chunk = get_nr_param_chunk(nr_row),
+             chunk_rows = DIVUP(nr_row, nr_chunk);
+    dim3 blocks(DIVUP(len, PARAM_BLOCK_X), nr_chunk),
+            threads(PARAM_BLOCK_X, PARAM_BLOCK_Y);
+    bwd_param_partial_kern<T><<<blocks, threads, 0, stream>>>(
+            dy, x, mean, rstd, workspace, nr_row, len, chunk_rows);
+    after_kernel_launch();
+    bwd_param_final_kern<T><<<DIVUP(len, NR_THREADS), NR_THREADS, 0, stream>>>(
+            workspace, dw, db, nr_chunk, len);
+    after_kernel_launch();
+}
+
+#define INST(T)                                                                   \
+    template void forward_proxy<T>(                                               \
+            const T*, const T*, const T*, T*, float*, float*, size_t, size_t,     \
+            float, cudaStream_t);                                                 \
+    template void backward_proxy<T>(                                              \
+            const T*, const T*, const T*, const float*, const float*, T*, T*, T*, \
+            size_t, size_t, float*, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace layer_norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
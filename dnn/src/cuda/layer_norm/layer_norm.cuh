@@ -0,0 +1,62 @@
+/**
+ * \file dnn/src/cuda/layer_norm/layer_norm.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <algorithm>
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace layer_norm {
+
+//! maximal number of row chunks whose partial dweight and dbias are reduced
+constexpr size_t MAX_NR_PARAM_CHUNK = 64;
+//! minimal number of rows in a chunk
+constexpr size_t MIN_PARAM_CHUNK_ROWS = 32;
+
+inline size_t get_nr_param_chunk(size_t nr_row) {
+    return std::max<size_t>(
+            std::min(MAX_NR_PARAM_CHUNK, nr_row / MIN_PARAM_CHUNK_ROWS), 1);
+}
+
+//! workspace holding float32 partial sums of dweight and dbias
+inline size_t get_bwd_workspace_in_bytes(size_t nr_row, size_t len) {
+    return get_nr_param_chunk(nr_row) * len * 2 * sizeof(float);
+}
+
+/*!
+ * \brief normalize nr_row contiguous rows of length len
+ *
+ * w and b are null if no affine transform is applied.
+ */
+template <typename T>
+void forward_proxy(
+        const T* x, const T* w, const T* b, T* y, float* mean, float* rstd,
+        size_t nr_row, size_t len, float eps, cudaStream_t stream);
+
+/*!
+ * \brief gradients of layer norm; dw and db are only computed if w is not
+ *      null
+ *
+ * \param workspace of get_bwd_workspace_in_bytes() bytes
+ */
+template <typename T>
+void backward_proxy(
+        const T* dy, const T* x, const T* w, const float* mean, const float* rstd,
+        T* dx, T* dw, T* db, size_t nr_row, size_t len, float* workspace,
+        cudaStream_t stream);
+
+}  // namespace layer_norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
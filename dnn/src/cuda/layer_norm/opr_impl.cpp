@@ -0,0 +1,91 @@
+/**
+ * \file dnn/src/cuda/layer_norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/layer_norm/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/cuda/handle.h"
+#include "src/cuda/layer_norm/layer_norm.cuh"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void LayerNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+        _megdnn_workspace workspace) {
+    check_exec(
+            data.layout, weight.layout, bias.layout, dst.layout, mean.layout,
+            rstd.layout, workspace.size);
+    auto p = param();
+    size_t len = p.normalized_size,
+           nr_row = len ? data.layout.total_nr_elems() / len : 0;
+    auto stream = cuda_stream(this->handle());
+#define cb(DType)                                                            \
+    if (data.layout.dtype == DType()) {                                      \
+        using ctype = typename DTypeTrait<DType>::ctype;                     \
+        layer_norm::forward_proxy<ctype>(                                    \
+                data.ptr<ctype>(), p.affine ? weight.ptr<ctype>() : nullptr, \
+                p.affine ? bias.ptr<ctype>() : nullptr, dst.ptr<ctype>(),    \
+                mean.ptr<dt_float32>(), rstd.ptr<dt_float32>(), nr_row, len, \
+                p.eps, stream);                                              \
+        return;                                                              \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+size_t LayerNormBackwardImpl::get_workspace_in_bytes(
+        const TensorLayout&, const TensorLayout& data, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&) {
+    if (!param().affine) {
+        return 0;
+    }
+    size_t len = param().normalized_size;
+    return layer_norm::get_bwd_workspace_in_bytes(
+            len ? data.total_nr_elems() / len : 0, len);
+}
+
+void LayerNormBackwardImpl::exec(
+        _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+        _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+        _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+        _megdnn_workspace workspace) {
+    check_exec(
+            diff.layout, data.layout, weight.layout, mean.layout, rstd.layout,
+            ddata.layout, dweight.layout, dbias.layout, workspace.size);
+    auto p = param();
+    size_t len = p.normalized_size,
+           nr_row = len ? data.layout.total_nr_elems() / len : 0;
+    auto stream = cuda_stream(this->handle());
+#define cb(DType)                                                                 \
+    if (data.layout.dtype == DType()) {                                           \
+        using ctype = typename DTypeTrait<DType>::ctype;                          \
+        layer_norm::backward_proxy<ctype>(                                        \
+                diff.ptr<ctype>(), data.ptr<ctype>(),                             \
+                p.affine ? weight.ptr<ctype>() : nullptr, mean.ptr<dt_float32>(), \
+                rstd.ptr<dt_float32>(), ddata.ptr<ctype>(),                       \
+                p.affine ? dweight.ptr<ctype>() : nullptr,                        \
+                p.affine ? dbias.ptr<ctype>() : nullptr, nr_row, len,             \
+                workspace.ptr<float>(), stream);                                  \
+        return;                                                                   \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
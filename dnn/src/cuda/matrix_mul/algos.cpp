@@ -51,7 +51,18 @@ MatrixMulForwardImpl::AlgoPack::AlgoPack() {
     for (auto&& algo : tensorop_float16_split_k) {
         all_algos.push_back(&algo);
     }
+    for (auto&& algo : tensorop_float16_split_k_balanced) {
+        all_algos.push_back(&algo);
+    }
+#endif
 #endif
+#if !MEGDNN_DISABLE_FLOAT16
+    float16_gemv_batched_strided.emplace_back(128);
+    float16_gemv_batched_strided.emplace_back(64);
+    float16_gemv_batched_strided.emplace_back(32);
+    for (auto&& algo : float16_gemv_batched_strided) {
+        all_algos.push_back(&algo);
+    }
 #endif
 
     all_algos.push_back(&naive);
@@ -120,9 +131,10 @@ void MatrixMulForwardImpl::AlgoPack::fill_cutlass_algos() {
     cb(256, 128, 32, 64, 64, 32, 16, 8, 8);   \
     cb(128, 256, 32, 64, 64, 32, 16, 8, 8);   \
     cb(128, 128, 32, 64, 64, 32, 16, 8, 8);
-#define cb(...)                                            \
-    tensorop_float16.emplace_back(AlgoParam{__VA_ARGS__}); \
-    tensorop_float16_split_k.emplace_back(AlgoParam{__VA_ARGS__});
+#define cb(...)                                                             \
+    tensorop_float16.emplace_back(AlgoParam{__VA_ARGS__});                  \
+    tensorop_float16_split_k.emplace_back(AlgoParam{__VA_ARGS__});          \
+    tensorop_float16_split_k_balanced.emplace_back(AlgoParam{__VA_ARGS__});
 #if CUDA_VERSION >= 10020
     FOREACH_CUTLASS_MATMUL_F16_SHAPES(cb)
 #endif
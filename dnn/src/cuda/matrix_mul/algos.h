@@ -49,7 +49,9 @@ public:
         CUDA_FLOAT32_SIMT_GEMV_BATCHED_STRIDED,
         CUDA_FLOAT16_TENSOR_OP,
         CUDA_FLOAT16_TENSOR_OP_SPLIT_K,
+        CUDA_FLOAT16_TENSOR_OP_SPLIT_K_BALANCED,
 #endif
+        CUDA_FLOAT16_GEMV_BATCHED_STRIDED,
     };
     using Mapper = std::unordered_map<AlgorithmDesc, AlgoBase*>;
 
@@ -180,6 +182,37 @@ public:
 private:
     WorkspaceBundle get_workspace_bundle(void* ptr, const SizeArgs& args) const;
 };
+
+/*!
+ * \brief C = A * B with a dedicated float16 gemv kernel for small m, which
+ *      shares the loads of B among several rows of A and splits K when the
+ *      output is too small to fill the SMs
+ */
+class MatrixMulForwardImpl::AlgoFloat16GemvBatchedStrided final : public AlgoBase {
+public:
+    AlgoFloat16GemvBatchedStrided(int threadblock_n)
+            : m_threadblock_n{threadblock_n},
+              m_name{ssprintf(
+                      "CUDA_FLOAT16_GEMV_BATCHED_STRIDED_%d", m_threadblock_n)} {}
+    bool is_available(const SizeArgs& args) const override;
+    size_t get_workspace_in_bytes(const SizeArgs& args) const override;
+    const char* name() const override { return m_name.c_str(); }
+    void exec(const ExecArgs& args) const override;
+    AlgoAttribute attribute() const override {
+        return AlgoAttribute::REPRODUCIBLE | AlgoAttribute::USABLE_DEPEND_ON_SHAPE;
+    }
+    MEGDNN_DECL_ALGO_TYPE(CUDA_FLOAT16_GEMV_BATCHED_STRIDED)
+
+    std::string param() const override {
+        std::string ret;
+        serialize_write_pod(m_threadblock_n, ret);
+        return ret;
+    }
+
+private:
+    int m_threadblock_n;
+    std::string m_name;
+};
 #endif
 
 class MatrixMulForwardImpl::AlgoConv1X1CUDNN final : public AlgoBase {
@@ -394,6 +427,37 @@ private:
     int min_alignment_requirement() const override { return 2; }
     std::string m_name;
 };
+
+/*!
+ * \brief split K of the parallel split-K kernels by the number of SMs
+ *
+ * When m and n give fewer threadblocks than the SMs, as in the fully connected
+ * layers of a small batch, K is split so that the grid fills the device,
+ * instead of by k / n.
+ */
+class MatrixMulForwardImpl::AlgoFloat16TensorOpSplitKBalanced final
+        : public AlgoCutlassMatrixMulBase {
+public:
+    AlgoFloat16TensorOpSplitKBalanced(AlgoParam algo_param)
+            : AlgoCutlassMatrixMulBase{algo_param},
+              m_name{ssprintf(
+                      "CUTLASS_FLOAT16_TENSOR_OP_SPLIT_K_BALANCED_h%d%d%d_%s",
+                      m_algo_param.instruction_m, m_algo_param.instruction_n,
+                      m_algo_param.instruction_k, m_algo_param.to_string().c_str())} {}
+    bool is_available(const SizeArgs& args) const override;
+    size_t get_workspace_in_bytes(const SizeArgs& args) const override;
+    const char* name() const override { return m_name.c_str(); }
+    AlgoAttribute attribute() const override {
+        return AlgoAttribute::REPRODUCIBLE | AlgoAttribute::USABLE_DEPEND_ON_SHAPE;
+    }
+    MEGDNN_DECL_ALGO_TYPE(CUDA_FLOAT16_TENSOR_OP_SPLIT_K_BALANCED)
+
+private:
+    void do_exec(const ExecArgs& args) const override;
+    int min_alignment_requirement() const override { return 2; }
+    int get_split_k_slices(int m, int n, int k) const;
+    std::string m_name;
+};
 #endif
 #endif
 
@@ -413,6 +477,7 @@ public:
 #endif
 #if !MEGDNN_DISABLE_FLOAT16
     AlgoBFloat16 bfloat16;
+    std::vector<AlgoFloat16GemvBatchedStrided> float16_gemv_batched_strided;
 #endif
 #if CUDA_VERSION >= 9020
     std::vector<AlgoFloat32SIMT> simt_float32;
@@ -421,6 +486,7 @@ public:
 #if CUDA_VERSION >= 10020
     std::vector<AlgoFloat16TensorOp> tensorop_float16;
     std::vector<AlgoFloat16TensorOpSplitK> tensorop_float16_split_k;
+    std::vector<AlgoFloat16TensorOpSplitKBalanced> tensorop_float16_split_k_balanced;
 #endif
 #endif
     std::vector<AlgoConv1X1CUDNN> conv1x1;
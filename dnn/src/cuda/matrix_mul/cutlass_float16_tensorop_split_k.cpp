@@ -66,12 +66,16 @@ size_t MatrixMulForwardImpl::AlgoFloat16TensorOpSplitK::get_workspace_in_bytes(
     return ws_size;
 }
 
-void MatrixMulForwardImpl::AlgoFloat16TensorOpSplitK::do_exec(
-        const ExecArgs& args) const {
+namespace {
+using AlgoParam = MatrixMulForwardImpl::AlgoCutlassMatrixMulBase::AlgoParam;
+
+//! run the cutlass gemm of parallel split-k mode with the given slices
+void exec_parallel_split_k(
+        const MatrixMulForwardImpl::AlgoBase::ExecArgs& args,
+        const AlgoParam& algo_param, int alignment, int min_alignment,
+        int split_k_slices) {
     int64_t lda = args.tensor_a.layout.stride[0], ldb = args.tensor_b.layout.stride[0],
             ldc = args.tensor_c.layout.stride[0];
-    int alignment = max_alignment(args);
-    int min_alignment = min_alignment_requirement();
     auto&& param = args.opr->param();
     int m = args.tensor_c.layout.shape[0], n = args.tensor_c.layout.shape[1],
         k = args.tensor_a.layout.shape[param.transposeA ? 0 : 1];
@@ -80,7 +84,6 @@ void MatrixMulForwardImpl::AlgoFloat16TensorOpSplitK::do_exec(
             m % alignment == 0 && n % alignment == 0 && k % alignment == 0 &&
             alignment >= min_alignment);
     cutlass::gemm::GemmCoord problem_size{m, n, k};
-    int split_k_slices = std::max(1, k / n);
     auto&& stream = cuda_stream(args.opr->handle());
     int* workspace = reinterpret_cast<int*>(args.workspace.raw_ptr);
     // \note these constants (i.e. one and zero) of cutlass epilogue will be
@@ -121,15 +124,15 @@ void MatrixMulForwardImpl::AlgoFloat16TensorOpSplitK::do_exec(
             NumericTypeID::kF16,
             LayoutTypeID::kRowMajor,
             element_accumulator,
-            m_algo_param.threadblock_m,
-            m_algo_param.threadblock_n,
-            m_algo_param.threadblock_k,
-            m_algo_param.warp_m,
-            m_algo_param.warp_n,
-            m_algo_param.warp_k,
-            m_algo_param.instruction_m,
-            m_algo_param.instruction_n,
-            m_algo_param.instruction_k,
+            algo_param.threadblock_m,
+            algo_param.threadblock_n,
+            algo_param.threadblock_k,
+            algo_param.warp_m,
+            algo_param.warp_n,
+            algo_param.warp_k,
+            algo_param.instruction_m,
+            algo_param.instruction_n,
+            algo_param.instruction_k,
             2,
             alignment,
             alignment,
@@ -158,6 +161,87 @@ void MatrixMulForwardImpl::AlgoFloat16TensorOpSplitK::do_exec(
 
     cutlass_check(ops[0]->run(&gemm_args, workspace, stream));
 }
+}  // anonymous namespace
+
+void MatrixMulForwardImpl::AlgoFloat16TensorOpSplitK::do_exec(
+        const ExecArgs& args) const {
+    auto&& param = args.opr->param();
+    int n = args.tensor_c.layout.shape[1],
+        k = args.tensor_a.layout.shape[param.transposeA ? 0 : 1];
+    exec_parallel_split_k(
+            args, m_algo_param, max_alignment(args), min_alignment_requirement(),
+            std::max(1, k / n));
+}
+int MatrixMulForwardImpl::AlgoFloat16TensorOpSplitKBalanced::get_split_k_slices(
+        int m, int n, int k) const {
+    //! split K only as far as needed to give every SM a threadblock, and leave
+    //! each slice at least four iterations of the main loop
+    int nr_tiles = DIVUP(m, m_algo_param.threadblock_m) *
+                   DIVUP(n, m_algo_param.threadblock_n);
+    int nr_sm = cuda::current_device_prop().multiProcessorCount;
+    int max_slices = std::max(1, k / (m_algo_param.threadblock_k * 4));
+    return std::max(1, std::min(DIVUP(nr_sm, nr_tiles), max_slices));
+}
+
+bool MatrixMulForwardImpl::AlgoFloat16TensorOpSplitKBalanced::is_available(
+        const SizeArgs& args) const {
+    auto&& param = args.opr->param();
+    int m = args.layout_c.shape[0], n = args.layout_c.shape[1],
+        k = args.layout_a.shape[param.transposeA ? 0 : 1];
+    bool available = args.opr->param().format == param::MatrixMul::Format::DEFAULT &&
+                     args.layout_a.dtype == dtype::Float16() &&
+                     args.layout_b.dtype == dtype::Float16() &&
+                     args.layout_c.dtype == dtype::Float16();
+    //! the grid of m and n alone fills the device, there is nothing to balance
+    available &= get_split_k_slices(m, n, k) >= 2;
+    auto&& device_prop = cuda::current_device_prop();
+    int y_grid_limit = device_prop.maxGridSize[1];
+    // limit y grid
+    available &=
+            ((m + m_algo_param.threadblock_m - 1) / m_algo_param.threadblock_m <=
+             y_grid_limit);
+    if (m_algo_param.instruction_m == 8 && m_algo_param.instruction_n == 8 &&
+        m_algo_param.instruction_k == 4) {
+        available &= is_compute_capability_required(7, 0);
+    } else {
+        megdnn_assert(
+                m_algo_param.instruction_m == 16 && m_algo_param.instruction_n == 8 &&
+                m_algo_param.instruction_k == 8);
+        available &= is_compute_capability_required(7, 5);
+    }
+
+    return available;
+}
+
+size_t MatrixMulForwardImpl::AlgoFloat16TensorOpSplitKBalanced::get_workspace_in_bytes(
+        const SizeArgs& args) const {
+    auto aligned = construct_aligned_layouts(args);
+    auto&& param = args.opr->param();
+    int m = args.layout_c.shape[0], n = args.layout_c.shape[1],
+        k = args.layout_a.shape[param.transposeA ? 0 : 1];
+    //! the partial sums are kept in the accumulator type, which is float32 at
+    //! most
+    if (!aligned.first)
+        return dtype::Float32().size(m * n * get_split_k_slices(m, n, k));
+    const auto& layouts = aligned.second;
+    int align_m = layouts[2].shape[0], align_n = layouts[2].shape[1],
+        align_k = layouts[0].shape[1];
+    size_t ws_size = dtype::Float32().size(
+            align_m * align_n * get_split_k_slices(align_m, align_n, align_k));
+    for (auto&& ly : layouts)
+        ws_size += ly.span().dist_byte();
+    return ws_size;
+}
+
+void MatrixMulForwardImpl::AlgoFloat16TensorOpSplitKBalanced::do_exec(
+        const ExecArgs& args) const {
+    auto&& param = args.opr->param();
+    int m = args.tensor_c.layout.shape[0], n = args.tensor_c.layout.shape[1],
+        k = args.tensor_a.layout.shape[param.transposeA ? 0 : 1];
+    exec_parallel_split_k(
+            args, m_algo_param, max_alignment(args), min_alignment_requirement(),
+            get_split_k_slices(m, n, k));
+}
 #endif
 
 // vim: syntax=cpp.doxygen
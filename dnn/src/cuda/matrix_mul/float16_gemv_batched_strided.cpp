@@ -0,0 +1,65 @@
+/**
+ * \file dnn/src/cuda/matrix_mul/float16_gemv_batched_strided.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/handle.h"
+#include "src/cuda/matrix_mul/algos.h"
+#include "src/cuda/matrix_mul/float16_gemv_batched_strided.cuh"
+#include "src/cuda/utils.h"
+
+#if !MEGDNN_DISABLE_FLOAT16
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+int split_k_slices(int m, int n, int k, int threadblock_n) {
+    return gemv_batched_strided::get_split_k_slices(
+            m, n, k, threadblock_n, current_device_prop().multiProcessorCount);
+}
+}  // anonymous namespace
+
+bool MatrixMulForwardImpl::AlgoFloat16GemvBatchedStrided::is_available(
+        const SizeArgs& args) const {
+    auto&& param = args.opr->param();
+    bool ta = param.transposeA, tb = param.transposeB;
+    size_t m = args.layout_c.shape[0];
+    auto&& device_prop = current_device_prop();
+    return param.format == param::MatrixMul::Format::DEFAULT &&
+           args.layout_a.dtype == dtype::Float16() &&
+           args.layout_b.dtype == dtype::Float16() &&
+           args.layout_c.dtype == dtype::Float16() && !ta && !tb &&
+           DIVUP(m, gemv_batched_strided::ROWS_PER_BLOCK) <=
+                   static_cast<size_t>(device_prop.maxGridSize[1]);
+}
+
+size_t MatrixMulForwardImpl::AlgoFloat16GemvBatchedStrided::get_workspace_in_bytes(
+        const SizeArgs& args) const {
+    int m = args.layout_c.shape[0], n = args.layout_c.shape[1],
+        k = args.layout_a.shape[1];
+    return gemv_batched_strided::get_workspace_in_bytes(
+            m, n, split_k_slices(m, n, k, m_threadblock_n));
+}
+
+void MatrixMulForwardImpl::AlgoFloat16GemvBatchedStrided::exec(
+        const ExecArgs& args) const {
+    size_t lda = args.tensor_a.layout.stride[0], ldb = args.tensor_b.layout.stride[0],
+           ldc = args.tensor_c.layout.stride[0];
+    int m = args.tensor_c.layout.shape[0], n = args.tensor_c.layout.shape[1],
+        k = args.tensor_a.layout.shape[1];
+    auto&& stream = cuda_stream(args.opr->handle());
+    gemv_batched_strided::exec_float16_gemv_batched_strided(
+            args.tensor_a.ptr<dt_float16>(), lda, args.tensor_b.ptr<dt_float16>(), ldb,
+            args.tensor_c.ptr<dt_float16>(), ldc, m, n, k, m_threadblock_n,
+            split_k_slices(m, n, k, m_threadblock_n),
+            reinterpret_cast<float*>(args.workspace.raw_ptr), stream);
+}
+#endif
+
+// vim: syntax=cpp.doxygen
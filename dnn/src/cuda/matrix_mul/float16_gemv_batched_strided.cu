@@ -0,0 +1,184 @@
+/**
+ * \file dnn/src/cuda/matrix_mul/float16_gemv_batched_strided.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include <cuda_fp16.h>
+#include <algorithm>
+#include <cstdint>
+#include "src/cuda/matrix_mul/float16_gemv_batched_strided.cuh"
+#include "src/cuda/utils.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+using namespace gemv_batched_strided;
+
+namespace {
+
+//! two consecutive columns of a row of B, which are zero out of range
+template <bool kVec2>
+__device__ __forceinline__ float2 load_b(const __half* row, int n, int N) {
+    if (kVec2) {
+        //! N is even, so both columns are in range if the first one is
+        return n < N ? __half22float2(*reinterpret_cast<const __half2*>(row + n))
+                     : make_float2(0.f, 0.f);
+    }
+    return make_float2(
+            n < N ? __half2float(row[n]) : 0.f,
+            n + 1 < N ? __half2float(row[n + 1]) : 0.f);
+}
+
+/*!
+ * Each thread computes two columns of ROWS_PER_BLOCK rows, and the threads
+ * along y split the slice of K of the block, whose partial sums are reduced
+ * in shared memory.
+ */
+template <int kThreadblockN, bool kVec2>
+__global__ void gemv_kernel(
+        const __half* A, size_t lda, const __half* B, size_t ldb, __half* C,
+        size_t ldc, int M, int N, int K, int k_per_slice, float* workspace) {
+    constexpr int THREADS_N = kThreadblockN / 2;
+    constexpr int THREADS_K = NR_THREADS / THREADS_N;
+    static_assert(THREADS_K >= ROWS_PER_BLOCK, "too few threads along k");
+    __shared__ float2 partial[THREADS_K][ROWS_PER_BLOCK][THREADS_N];
+
+    int tx = threadIdx.x, ty = threadIdx.y;
+    int n = blockIdx.x * kThreadblockN + 2 * tx;
+    int m0 = blockIdx.y * ROWS_PER_BLOCK;
+    int rows = min(ROWS_PER_BLOCK, M - m0);
+    int k_begin = blockIdx.z * k_per_slice, k_end = min(K, k_begin + k_per_slice);
+    A += m0 * lda;
+
+    float2 acc[ROWS_PER_BLOCK];
+#pragma unroll
+    for (int r = 0; r < ROWS_PER_BLOCK; ++r) {
+        acc[r] = make_float2(0.f, 0.f);
+    }
+    for (int k = k_begin + ty; k < k_end; k += THREADS_K) {
+        float2 b = load_b<kVec2>(B + k * ldb, n, N);
+#pragma unroll
+        for (int r = 0; r < ROWS_PER_BLOCK; ++r) {
+            if (r < rows) {
+                float a = __half2float(A[r * lda + k]);
+                acc[r].x += a * b.x;
+                acc[r].y += a * b.y;
+            }
+        }
+    }
+#pragma unroll
+    for (int r = 0; r < ROWS_PER_BLOCK; ++r) {
+        partial[ty][r][tx] = acc[r];
+    }
+    __syncthreads();
+
+    //! the threads of the first ROWS_PER_BLOCK rows of y reduce a row of C
+    if (ty < rows) {
+        float2 sum = make_float2(0.f, 0.f);
+#pragma unroll
+        for (int i = 0; i < THREADS_K; ++i) {
+            sum.x += partial[i][ty][tx].x;
+            sum.y += partial[i][ty][tx].y;
+        }
+        int m = m0 + ty;
+        if (gridDim.z == 1) {
+            __half* dst = C + m * ldc;
+            if (n < N)
+                dst[n] = __float2half(sum.x);
+            if (n + 1 < N)
+                dst[n + 1] = __float2half(sum.y);
+        } else {
+            float* dst = workspace + (static_cast<size_t>(blockIdx.z) * M + m) * N;
+            if (n < N)
+                dst[n] = sum.x;
+            if (n + 1 < N)
+                dst[n + 1] = sum.y;
+        }
+    }
+}
+
+__global__ void reduce_split_k_kernel(
+        const float* workspace, __half* C, size_t ldc, int M, int N,
+        int split_k_slices) {
+    size_t size = static_cast<size_t>(M) * N;
+    size_t idx = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (idx >= size)
+        return;
+    float sum = 0.f;
+    for (int s = 0; s < split_k_slices; ++s) {
+        sum += workspace[s * size + idx];
+    }
+    C[idx / N * ldc + idx % N] = __float2half(sum);
+}
+
+template <int kThreadblockN, bool kVec2>
+void dispatch_gemv(
+        const __half* A, size_t lda, const __half* B, size_t ldb, __half* C,
+        size_t ldc, int m, int n, int k, int split_k_slices, float* workspace,
+        cudaStream_t stream) {
+    constexpr int THREADS_N = kThreadblockN / 2;
+    dim3 block(THREADS_N, NR_THREADS / THREADS_N);
+    dim3 grid(DIVUP(n, kThreadblockN), DIVUP(m, ROWS_PER_BLOCK), split_k_slices);
+    int k_per_slice = DIVUP(k, split_k_slices);
+    gemv_kernel<kThreadblockN, kVec2><<<grid, block, 0, stream>>>(
+            A, lda, B, ldb, C, ldc, m, n, k, k_per_slice, workspace);
+    after_kernel_launch();
+}
+
+}  // anonymous namespace
+
+int gemv_batched_strided::get_split_k_slices(
+        int m, int n, int k, int threadblock_n, int nr_sm) {
+    int nr_blocks = DIVUP(n, threadblock_n) * DIVUP(m, ROWS_PER_BLOCK);
+    int threads_k = NR_THREADS / (threadblock_n / 2);
+    //! aim at two blocks per SM
+    int slices = DIVUP(2 * nr_sm, nr_blocks);
+    int max_slices = std::max(1, std::min(k / (threads_k * 16), 65535));
+    return std::max(1, std::min(slices, max_slices));
+}
+
+size_t gemv_batched_strided::get_workspace_in_bytes(int m, int n, int split_k_slices) {
+    if (split_k_slices <= 1)
+        return 0;
+    return sizeof(float) * static_cast<size_t>(m) * n * split_k_slices;
+}
+
+void gemv_batched_strided::exec_float16_gemv_batched_strided(
+        const dt_float16* A, size_t lda, const dt_float16* B, size_t ldb,
+        dt_float16* C, size_t ldc, int m, int n, int k, int threadblock_n,
+        int split_k_slices, float* workspace, cudaStream_t stream) {
+    auto a = reinterpret_cast<const __half*>(A);
+    auto b = reinterpret_cast<const __half*>(B);
+    auto c = reinterpret_cast<__half*>(C);
+    bool vec2 = n % 2 == 0 && ldb % 2 == 0 &&
+                reinterpret_cast<uintptr_t>(B) % sizeof(__half2) == 0;
+#define cb(threadblock_n_)                                                      \
+    if (threadblock_n == threadblock_n_) {                                      \
+        if (vec2) {                                                             \
+            dispatch_gemv<threadblock_n_, true>(                                \
+                    a, lda, b, ldb, c, ldc, m, n, k, split_k_slices, workspace, \
+                    stream);                                                    \
+        } else {                                                                \
+            dispatch_gemv<threadblock_n_, false>(                               \
+                    a, lda, b, ldb, c, ldc, m, n, k, split_k_slices, workspace, \
+                    stream);                                                    \
+        }                                                                       \
+    } else
+    cb(128) cb(64) cb(32) {
+        megdnn_assert(false, "unsupported threadblock_n %d", threadblock_n);
+    }
+#undef cb
+    if (split_k_slices > 1) {
+        size_t size = static_cast<size_t>(m) * n;
+        unsigned nr_blocks = DIVUP(size, NR_THREADS);
+        reduce_split_k_kernel<<<nr_blocks, NR_THREADS, 0, stream>>>(
+                workspace, c, ldc, m, n, split_k_slices);
+        after_kernel_launch();
+    }
+}
+
+// vim: syntax=cuda.doxygen
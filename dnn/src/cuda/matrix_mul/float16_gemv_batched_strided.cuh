@@ -0,0 +1,56 @@
+/**
+ * \file dnn/src/cuda/matrix_mul/float16_gemv_batched_strided.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#include "megdnn/dtype.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace gemv_batched_strided {
+
+//! number of threads of a block
+constexpr int NR_THREADS = 256;
+//! rows of A computed by a block, which share the loads of B
+constexpr int ROWS_PER_BLOCK = 4;
+
+/*!
+ * \brief number of slices K is split into, which fills the SMs of the device
+ *      when the grid of m and n alone is small
+ *
+ * Every slice is left at least 16 iterations of the threads along K.
+ */
+int get_split_k_slices(int m, int n, int k, int threadblock_n, int nr_sm);
+
+//! workspace in bytes for the partial sums of the slices
+size_t get_workspace_in_bytes(int m, int n, int split_k_slices);
+
+/*!
+ * \brief C = A * B of row major float16 matrices for small m, accumulated in
+ *      float32
+ *
+ * Each block computes ROWS_PER_BLOCK rows and threadblock_n columns of C over
+ * a slice of K, so a row of B loaded by the block is used for all its rows of
+ * A. The partial sums of the slices are written to the workspace and reduced
+ * by a second kernel, which keeps the result deterministic.
+ *
+ * \param threadblock_n one of 128, 64 and 32
+ */
+void exec_float16_gemv_batched_strided(
+        const dt_float16* A, size_t lda, const dt_float16* B, size_t ldb,
+        dt_float16* C, size_t ldc, int m, int n, int k, int threadblock_n,
+        int split_k_slices, float* workspace, cudaStream_t stream);
+
+}  // namespace gemv_batched_strided
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
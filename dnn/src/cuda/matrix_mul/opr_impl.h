@@ -40,6 +40,7 @@ public:
     class AlgoNaive;
 #if !MEGDNN_DISABLE_FLOAT16
     class AlgoBFloat16;
+    class AlgoFloat16GemvBatchedStrided;
 #endif
 #if CUDA_VERSION >= 9020
     class AlgoCutlassMatrixMulBase;
@@ -48,6 +49,7 @@ public:
     class AlgoFloat32SIMTGemvBatchedStrided;
     class AlgoFloat16TensorOp;
     class AlgoFloat16TensorOpSplitK;
+    class AlgoFloat16TensorOpSplitKBalanced;
 #endif
     class AlgoPack;
 
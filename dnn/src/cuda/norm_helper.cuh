@@ -0,0 +1,221 @@
+/**
+ * \file dnn/src/cuda/norm_helper.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/cuda/cuda_shfl_compat.cuh"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+//! row kernels shared by LayerNorm and GroupNorm
+namespace norm {
+
+//! rows no longer than this are computed by a single warp
+constexpr uint32_t MAX_WARP_ROW_LEN = 1024;
+//! number of rows computed by a block when each row is handled by a warp
+constexpr uint32_t NR_WARP_ROWS = 4;
+//! number of threads of a block that computes a long row
+constexpr int NR_BLOCK_ROW_THREADS = 512;
+
+//! running mean, sum of squared deviations and count of Welford's algorithm
+struct Welford {
+    float mean, m2, count;
+
+    static __device__ __forceinline__ Welford identity() { return {0.f, 0.f, 0.f}; }
+
+    __device__ __forceinline__ void update(float x) {
+        count += 1.f;
+        float d = x - mean;
+        mean += d / count;
+        m2 += d * (x - mean);
+    }
+
+    static __device__ __forceinline__ Welford merge(Welford a, Welford b) {
+        float count = a.count + b.count;
+        if (count == 0.f) {
+            return a;
+        }
+        float d = b.mean - a.mean, ratio = b.count / count;
+        return {a.mean + d * ratio, a.m2 + b.m2 + d * d * a.count * ratio, count};
+    }
+
+    __device__ __forceinline__ Welford shfl_xor(int mask) const {
+        return {__shfl_xor(mean, mask, 32), __shfl_xor(m2, mask, 32),
+                __shfl_xor(count, mask, 32)};
+    }
+};
+
+//! a pair of sums reduced together
+struct Sum2 {
+    float a, b;
+
+    static __device__ __forceinline__ Sum2 identity() { return {0.f, 0.f}; }
+
+    static __device__ __forceinline__ Sum2 merge(Sum2 x, Sum2 y) {
+        return {x.a + y.a, x.b + y.b};
+    }
+
+    __device__ __forceinline__ Sum2 shfl_xor(int mask) const {
+        return {__shfl_xor(a, mask, 32), __shfl_xor(b, mask, 32)};
+    }
+};
+
+/*!
+ * \brief reduce among the NR_X threads along x of a block and broadcast the
+ *      result to all of them
+ *
+ * NR_X is either the warp size, or a larger multiple of it in which case
+ * blockDim.y must be 1.
+ */
+template <int NR_X, typename V>
+__device__ __forceinline__ V reduce_x(V v) {
+    for (int mask = 16; mask; mask >>= 1) {
+        v = V::merge(v, v.shfl_xor(mask));
+    }
+    if (NR_X > 32) {
+        __shared__ V warp_result[NR_X / 32];
+        int lane = threadIdx.x % 32, warp = threadIdx.x / 32;
+        if (!lane) {
+            warp_result[warp] = v;
+        }
+        __syncthreads();
+        v = lane < NR_X / 32 ? warp_result[lane] : V::identity();
+        for (int mask = NR_X / 64; mask; mask >>= 1) {
+            v = V::merge(v, v.shfl_xor(mask));
+        }
+    }
+    return v;
+}
+
+//! index of affine params for layer norm, where weight has the shape of a row
+struct RowIndex {
+    __device__ __forceinline__ uint32_t operator()(uint32_t, uint32_t i) const {
+        return i;
+    }
+};
+
+//! index of affine params for group norm, where a row has cpg channels of size S
+struct ChannelIndex {
+    uint32_t G, cpg, S;
+
+    __device__ __forceinline__ uint32_t operator()(uint32_t row, uint32_t i) const {
+        return row % G * cpg + i / S;
+    }
+};
+
+/*!
+ * \brief normalize rows of length len; mean and variance are computed in a
+ *      single pass with Welford's algorithm
+ *
+ * w and b are null if no affine transform is applied.
+ */
+template <typename T, int NR_X, typename Index>
+__global__ void fwd_kern(
+        const T* x, const T* w, const T* b, T* y, float* mean, float* rstd,
+        uint32_t nr_row, uint32_t len, float eps, Index index) {
+    uint32_t row = blockIdx.x * blockDim.y + threadIdx.y;
+    if (row >= nr_row) {
+        return;
+    }
+    size_t offset = static_cast<size_t>(row) * len;
+    x += offset;
+    y += offset;
+    Welford v = Welford::identity();
+    for (uint32_t i = threadIdx.x; i < len; i += NR_X) {
+        v.update(static_cast<float>(x[i]));
+    }
+    v = reduce_x<NR_X>(v);
+    float r = rsqrtf(v.m2 / len + eps);
+    if (!threadIdx.x) {
+        mean[row] = v.mean;
+        rstd[row] = r;
+    }
+    for (uint32_t i = threadIdx.x; i < len; i += NR_X) {
+        float val = (static_cast<float>(x[i]) - v.mean) * r;
+        if (w) {
+            uint32_t k = index(row, i);
+            val = val * static_cast<float>(w[k]) + static_cast<float>(b[k]);
+        }
+        y[i] = static_cast<T>(val);
+    }
+}
+
+//! gradient wrt. x of rows normalized by fwd_kern
+template <typename T, int NR_X, typename Index>
+__global__ void bwd_data_kern(
+        const T* dy, const T* x, const T* w, const float* mean, const float* rstd,
+        T* dx, uint32_t nr_row, uint32_t len, Index index) {
+    uint32_t row = blockIdx.x * blockDim.y + threadIdx.y;
+    if (row >= nr_row) {
+        return;
+    }
+    size_t offset = static_cast<size_t>(row) * len;
+    dy += offset;
+    x += offset;
+    dx += offset;
+    float m = mean[row], r = rstd[row];
+    Sum2 v = Sum2::identity();
+    for (uint32_t i = threadIdx.x; i < len; i += NR_X) {
+        float g = static_cast<float>(dy[i]);
+        if (w) {
+            g *= static_cast<float>(w[index(row, i)]);
+        }
+        v.a += g;
+        v.b += g * (static_cast<float>(x[i]) - m);
+    }
+    v = reduce_x<NR_X>(v);
+    float coef = r * r * r * v.b / len, shift = r * v.a / len;
+    for (uint32_t i = threadIdx.x; i < len; i += NR_X) {
+        float g = static_cast<float>(dy[i]);
+        if (w) {
+            g *= static_cast<float>(w[index(row, i)]);
+        }
+        dx[i] = static_cast<T>(r * g - coef * (static_cast<float>(x[i]) - m) - shift);
+    }
+}
+
+template <typename T, typename Index>
+void launch_fwd(
+        const T* x, const T* w, const T* b, T* y, float* mean, float* rstd,
+        uint32_t nr_row, uint32_t len, float eps, Index index, cudaStream_t stream) {
+    if (len <= MAX_WARP_ROW_LEN) {
+        dim3 threads(32, NR_WARP_ROWS);
+        fwd_kern<T, 32><<<DIVUP(nr_row, NR_WARP_ROWS), threads, 0, stream>>>(
+                x, w, b, y, mean, rstd, nr_row, len, eps, index);
+    } else {
+        fwd_kern<T, NR_BLOCK_ROW_THREADS><<<nr_row, NR_BLOCK_ROW_THREADS, 0, stream>>>(
+                x, w, b, y, mean, rstd, nr_row, len, eps, index);
+    }
+    after_kernel_launch();
+}
+
+template <typename T, typename Index>
+void launch_bwd_data(
+        const T* dy, const T* x, const T* w, const float* mean, const float* rstd,
+        T* dx, uint32_t nr_row, uint32_t len, Index index, cudaStream_t stream) {
+    if (len <= MAX_WARP_ROW_LEN) {
+        dim3 threads(32, NR_WARP_ROWS);
+        bwd_data_kern<T, 32><<<DIVUP(nr_row, NR_WARP_ROWS), threads, 0, stream>>>(
+                dy, x, w, mean, rstd, dx, nr_row, len, index);
+    } else {
+        bwd_data_kern<T, NR_BLOCK_ROW_THREADS>
+                <<<nr_row, NR_BLOCK_ROW_THREADS, 0, stream>>>(
+                        dy, x, w, mean, rstd, dx, nr_row, len, index);
+    }
+    after_kernel_launch();
+}
+
+}  // namespace norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -16,6 +16,7 @@
 #include <curand_kernel.h>
 
 #include "megdnn/dtype.h"
+#include "src/common/philox.cuh"
 #include "src/cuda/elemwise_helper.cuh"
 #include "src/cuda/utils.cuh"
 
@@ -108,6 +109,61 @@ struct AsTypeKernel {
 #endif
 };
 
+//! element i takes word i % 4 of block offset + i / 4, the same as fallback
+template <typename ctype>
+struct PhiloxUniformKernel {
+    ctype* output;
+    size_t size;
+    uint64_t seed, offset;
+
+    __device__ void operator()(uint32_t idx) {
+        uint32_t words[4];
+        philox::generate(seed, offset + idx, words);
+        size_t begin = static_cast<size_t>(idx) * 4;
+        for (int i = 0; i < 4 && begin + i < size; ++i) {
+            output[begin + i] = static_cast<ctype>(philox::to_uniform(words[i]));
+        }
+    }
+
+#if MEGDNN_CC_HOST
+    PhiloxUniformKernel(
+            const TensorND& output, size_t size, uint64_t seed, uint64_t offset)
+            : output{output.ptr<ctype>()}, size{size}, seed{seed}, offset{offset} {}
+#endif
+};
+
+template <typename ctype>
+struct PhiloxGaussianKernel {
+    ctype* output;
+    size_t size;
+    uint64_t seed, offset;
+    float mean, std;
+
+    __device__ void operator()(uint32_t idx) {
+        uint32_t words[4];
+        philox::generate(seed, offset + idx, words);
+        float z[4];
+        philox::to_gaussian(words[0], words[1], mean, std, z[0], z[1]);
+        philox::to_gaussian(words[2], words[3], mean, std, z[2], z[3]);
+        size_t begin = static_cast<size_t>(idx) * 4;
+        for (int i = 0; i < 4 && begin + i < size; ++i) {
+            output[begin + i] = static_cast<ctype>(z[i]);
+        }
+    }
+
+#if MEGDNN_CC_HOST
+    PhiloxGaussianKernel(
+            const TensorND& output, size_t size, uint64_t seed, uint64_t offset,
+            float mean, float std)
+            : output{output.ptr<ctype>()},
+              size{size},
+              seed{seed},
+              offset{offset},
+              mean{mean},
+              std{std} {}
+#endif
+};
+
 template <typename ctype>
 struct GammaKernel {
     ctype* output;
@@ -11,37 +11,17 @@
  */
 #pragma once
 
-#include <curand.h>
 #include "megdnn/oprs.h"
+#include "src/common/philox.cuh"
 #include "src/cuda/handle.h"
 
 namespace megdnn {
 namespace cuda {
 
-class CuRandHandle {
-    curandGenerator_t m_gen;
-    uint64_t m_seed;
-
-    CuRandHandle(const CuRandHandle&) = delete;
-    CuRandHandle& operator=(const CuRandHandle&) = delete;
-
-public:
-    CuRandHandle(cudaStream_t stream, uint64_t seed = 0);
-    ~CuRandHandle();
-
-    void seed(uint64_t seed);
-
-    curandGenerator_t gen() const { return m_gen; }
-
-    void ensure_seed(uint64_t seed) {
-        if (m_seed != seed) {
-            this->seed(seed);
-        }
-    }
-};
-
+//! uniform rng by the Philox streams, the same as the fallback impl
 class UniformRNGImpl : public UniformRNG {
-    CuRandHandle m_curand_handle;
+    philox::State m_state;
+    cudaStream_t m_stream;
 
 public:
     UniformRNGImpl(Handle* handle);
@@ -51,14 +31,15 @@ public:
 };
 
 class GaussianRNGImpl : public GaussianRNG {
-    CuRandHandle m_curand_handle;
+    philox::State m_state;
+    cudaStream_t m_stream;
 
 public:
     GaussianRNGImpl(Handle* handle);
 
     void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
 
-    size_t get_workspace_in_bytes(const TensorLayout& layout) override;
+    size_t get_workspace_in_bytes(const TensorLayout&) override { return 0; }
 };
 
 class GammaRNGImpl : public GammaRNG {
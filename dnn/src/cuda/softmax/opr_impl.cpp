@@ -0,0 +1,63 @@
+/**
+ * \file dnn/src/cuda/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/softmax/opr_impl.h"
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/cuda/handle.h"
+#include "src/cuda/softmax/softmax.cuh"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void SoftmaxForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, get_axis(src.layout.ndim));
+    auto stream = cuda_stream(this->handle());
+#define cb(DType)                                                     \
+    if (src.layout.dtype == DType()) {                                \
+        using ctype = typename DTypeTrait<DType>::ctype;              \
+        softmax::forward_proxy<ctype>(                                \
+                src.ptr<ctype>(), dst.ptr<ctype>(), A, B, C, stream); \
+        return;                                                       \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+void SoftmaxBackwardImpl::exec(
+        _megdnn_tensor_in dst, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+        _megdnn_workspace workspace) {
+    check_exec(dst.layout, diff.layout, grad.layout, workspace.size);
+    size_t A, B, C;
+    reduce::get_ABC(dst.layout, A, B, C, get_axis(dst.layout.ndim));
+    auto stream = cuda_stream(this->handle());
+#define cb(DType)                                                                \
+    if (dst.layout.dtype == DType()) {                                           \
+        using ctype = typename DTypeTrait<DType>::ctype;                         \
+        softmax::backward_proxy<ctype>(                                          \
+                dst.ptr<ctype>(), diff.ptr<ctype>(), grad.ptr<ctype>(), A, B, C, \
+                stream);                                                         \
+        return;                                                                  \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
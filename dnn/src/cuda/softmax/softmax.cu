@@ -0,0 +1,244 @@
+/**
+ * \file dnn/src/cuda/softmax/softmax.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/softmax/softmax.cuh"
+
+#include <cfloat>
+#include "megdnn/dtype.h"
+#include "src/cuda/cuda_shfl_compat.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+//! rows no longer than this are computed by a single warp
+constexpr uint32_t MAX_WARP_ROW_LEN = 1024;
+//! number of rows computed by a block when each row is handled by a warp
+constexpr uint32_t NR_WARP_ROWS = 4;
+//! number of threads of a block that computes a long row
+constexpr int NR_BLOCK_ROW_THREADS = 256;
+
+//! running maximum and sum of exp(x - max) of the online normalizer
+struct MaxSum {
+    float max, sum;
+
+    static __device__ __forceinline__ MaxSum identity() { return {-FLT_MAX, 0.f}; }
+
+    __device__ __forceinline__ void update(float x) {
+        float m = fmaxf(max, x);
+        sum = sum * expf(max - m) + expf(x - m);
+        max = m;
+    }
+
+    static __device__ __forceinline__ MaxSum merge(MaxSum a, MaxSum b) {
+        float m = fmaxf(a.max, b.max);
+        return {m, a.sum * expf(a.max - m) + b.sum * expf(b.max - m)};
+    }
+
+    __device__ __forceinline__ MaxSum shfl_xor(int mask) const {
+        return {__shfl_xor(max, mask, 32), __shfl_xor(sum, mask, 32)};
+    }
+};
+
+struct Sum {
+    float sum;
+
+    static __device__ __forceinline__ Sum identity() { return {0.f}; }
+
+    static __device__ __forceinline__ Sum merge(Sum a, Sum b) {
+        return {a.sum + b.sum};
+    }
+
+    __device__ __forceinline__ Sum shfl_xor(int mask) const {
+        return {__shfl_xor(sum, mask, 32)};
+    }
+};
+
+/*!
+ * \brief reduce among the NR_X threads along x of a block and broadcast the
+ *      result to all of them
+ *
+ * NR_X is either the warp size, or a larger multiple of it in which case
+ * blockDim.y must be 1.
+ */
+template <int NR_X, typename V>
+__device__ __forceinline__ V reduce_x(V v) {
+    for (int mask = 16; mask; mask >>= 1) {
+        v = V::merge(v, v.shfl_xor(mask));
+    }
+    if (NR_X > 32) {
+        __shared__ V warp_result[NR_X / 32];
+        int lane = threadIdx.x % 32, warp = threadIdx.x / 32;
+        if (!lane) {
+            warp_result[warp] = v;
+        }
+        __syncthreads();
+        v = lane < NR_X / 32 ? warp_result[lane] : V::identity();
+        for (int mask = NR_X / 64; mask; mask >>= 1) {
+            v = V::merge(v, v.shfl_xor(mask));
+        }
+    }
+    return v;
+}
+
+template <typename T, int NR_X>
+__global__ void fwd_rows_kern(const T* src, T* dst, uint32_t A, uint32_t B) {
+    uint32_t row = blockIdx.x * blockDim.y + threadIdx.y;
+    if (row >= A) {
+        return;
+    }
+    src += static_cast<size_t>(row) * B;
+    dst += static_cast<size_t>(row) * B;
+    MaxSum v = MaxSum::identity();
+    for (uint32_t i = threadIdx.x; i < B; i += NR_X) {
+        v.update(static_cast<float>(src[i]));
+    }
+    v = reduce_x<NR_X>(v);
+    float scale = 1.f / v.sum;
+    for (uint32_t i = threadIdx.x; i < B; i += NR_X) {
+        dst[i] = static_cast<T>(expf(static_cast<float>(src[i]) - v.max) * scale);
+    }
+}
+
+//! each thread computes a column; adjacent threads access adjacent elements
+template <typename T>
+__global__ void fwd_cols_kern(
+        const T* src, T* dst, uint32_t A, uint32_t B, uint32_t C) {
+    uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= A * C) {
+        return;
+    }
+    uint32_t a = idx / C, c = idx - a * C;
+    size_t offset = static_cast<size_t>(a) * B * C + c;
+    src += offset;
+    dst += offset;
+    MaxSum v = MaxSum::identity();
+    for (uint32_t b = 0; b < B; ++b) {
+        v.update(static_cast<float>(src[b * C]));
+    }
+    float scale = 1.f / v.sum;
+    for (uint32_t b = 0; b < B; ++b) {
+        float x = static_cast<float>(src[b * C]);
+        dst[b * C] = static_cast<T>(expf(x - v.max) * scale);
+    }
+}
+
+template <typename T, int NR_X>
+__global__ void bwd_rows_kern(
+        const T* y, const T* diff, T* grad, uint32_t A, uint32_t B) {
+    uint32_t row = blockIdx.x * blockDim.y + threadIdx.y;
+    if (row >= A) {
+        return;
+    }
+    size_t offset = static_cast<size_t>(row) * B;
+    y += offset;
+    diff += offset;
+    grad += offset;
+    Sum v = Sum::identity();
+    for (uint32_t i = threadIdx.x; i < B; i += NR_X) {
+        v.sum += static_cast<float>(y[i]) * static_cast<float>(diff[i]);
+    }
+    v = reduce_x<NR_X>(v);
+    for (uint32_t i = threadIdx.x; i < B; i += NR_X) {
+        grad[i] = static_cast<T>(
+                (static_cast<float>(diff[i]) - v.sum) * static_cast<float>(y[i]));
+    }
+}
+
+template <typename T>
+__global__ void bwd_cols_kern(
+        const T* y, const T* diff, T* grad, uint32_t A, uint32_t B, uint32_t C) {
+    uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= A * C) {
+        return;
+    }
+    uint32_t a = idx / C, c = idx - a * C;
+    size_t offset = static_cast<size_t>(a) * B * C + c;
+    y += offset;
+    diff += offset;
+    grad += offset;
+    float dot = 0.f;
+    for (uint32_t b = 0; b < B; ++b) {
+        dot += static_cast<float>(y[b * C]) * static_cast<float>(diff[b * C]);
+    }
+    for (uint32_t b = 0; b < B; ++b) {
+        float h = static_cast<float>(diff[b * C]);
+        grad[b * C] = static_cast<T>((h - dot) * static_cast<float>(y[b * C]));
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace softmax {
+
+template <typename T>
+void forward_proxy(
+        const T* src, T* dst, size_t A, size_t B, size_t C, cudaStream_t stream) {
+    if (!A || !B || !C) {
+        return;
+    }
+    if (C == 1) {
+        if (B <= MAX_WARP_ROW_LEN) {
+            dim3 threads(32, NR_WARP_ROWS);
+            fwd_rows_kern<T, 32><<<DIVUP(A, NR_WARP_ROWS), threads, 0, stream>>>(
+                    src, dst, A, B);
+        } else {
+            fwd_rows_kern<T, NR_BLOCK_ROW_THREADS>
+                    <<<A, NR_BLOCK_ROW_THREADS, 0, stream>>>(src, dst, A, B);
+        }
+    } else {
+        fwd_cols_kern<T><<<DIVUP(A * C, NR_THREADS), NR_THREADS, 0, stream>>>(
+                src, dst, A, B, C);
+    }
+    after_kernel_launch();
+}
+
+template <typename T>
+void backward_proxy(
+        const T* y, const T* diff, T* grad, size_t A, size_t B, size_t C,
+        cudaStream_t stream) {
+    if (!A || !B || !C) {
+        return;
+    }
+    if (C == 1) {
+        if (B <= MAX_WARP_ROW_LEN) {
+            dim3 threads(32, NR_WARP_ROWS);
+            bwd_rows_kern<T, 32><<<DIVUP(A, NR_WARP_ROWS), threads, 0, stream>>>(
+                    y, diff, grad, A, B);
+        } else {
+            bwd_rows_kern<T, NR_BLOCK_ROW_THREADS>
+                    <<<A, NR_BLOCK_ROW_THREADS, 0, stream>>>(y, diff, grad, A, B);
+        }
+    } else {
+        bwd_cols_kern<T><<<DIVUP(A * C, NR_THREADS), NR_THREADS, 0, stream>>>(
+                y, diff, grad, A, B, C);
+    }
+    after_kernel_launch();
+}
+
+#define INST(T)                                                            \
+    template void forward_proxy<T>(                                        \
+            const T*, T*, size_t, size_t, size_t, cudaStream_t);           \
+    template void backward_proxy<T>(                                       \
+            const T*, const T*, T*, size_t, size_t, size_t, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace softmax
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/cuda/softmax/softmax.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace softmax {
+
+/*!
+ * \brief softmax of a contiguous tensor viewed as (A, B, C) along B
+ *
+ * Max and sum of each row are computed in a single pass with the online
+ * normalizer, and dst is written in a second pass.
+ */
+template <typename T>
+void forward_proxy(
+        const T* src, T* dst, size_t A, size_t B, size_t C, cudaStream_t stream);
+
+//! grad = (diff - sum(diff * y)) * y along B of (A, B, C) shaped tensors
+template <typename T>
+void backward_proxy(
+        const T* y, const T* diff, T* grad, size_t A, size_t B, size_t C,
+        cudaStream_t stream);
+
+}  // namespace softmax
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,51 @@
+/**
+ * \file dnn/src/cuda/weight_quant_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/weight_quant_matrix_mul/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/cuda/handle.h"
+#include "src/cuda/utils.h"
+#include "src/cuda/weight_quant_matrix_mul/weight_quant_matrix_mul.cuh"
+
+namespace megdnn {
+namespace cuda {
+
+void WeightQuantMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in weight, _megdnn_tensor_in scale,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, weight.layout, scale.layout, dst.layout, workspace.size);
+    if (!dst.layout.total_nr_elems()) {
+        return;
+    }
+    megdnn_assert(
+            src.layout.total_nr_elems() <= UINT32_MAX &&
+                    dst.layout.total_nr_elems() <= UINT32_MAX &&
+                    weight.layout.total_nr_elems() <= UINT32_MAX,
+            "weight quantized matmul tensors are too large");
+    uint32_t M = src.layout[0], K = src.layout[1], N = weight.layout[0];
+    auto stream = cuda_stream(this->handle());
+#define cb(DType)                                                                 \
+    if (src.layout.dtype == DType()) {                                            \
+        using ctype = typename DTypeTrait<DType>::ctype;                          \
+        weight_quant_matrix_mul::forward_proxy<ctype>(                            \
+                src.ptr<ctype>(), weight.ptr<dt_int8>(), scale.ptr<dt_float32>(), \
+                dst.ptr<ctype>(), M, K, N, param().bits, stream);                 \
+        return;                                                                   \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,102 @@
+/**
+ * \file dnn/src/cuda/weight_quant_matrix_mul/weight_quant_matrix_mul.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/weight_quant_matrix_mul/weight_quant_matrix_mul.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/cuda_shfl_compat.cuh"
+
+using namespace megdnn;
+using namespace cuda;
+
+namespace {
+
+constexpr uint32_t WARP_SIZE = 32, NR_WARPS = 4;
+
+__device__ __forceinline__ float warp_sum(float v) {
+#pragma unroll
+    for (int mask = WARP_SIZE / 2; mask > 0; mask >>= 1) {
+        v += __shfl_xor(v, mask, 32);
+    }
+    return v;
+}
+
+//! the warps of a block compute adjacent output channels of a row
+template <typename T, uint32_t bits>
+__global__ void forward_kern(
+        const T* src, const int8_t* weight, const float* scale, T* dst, uint32_t M,
+        uint32_t K, uint32_t N) {
+    uint32_t lane = threadIdx.x % WARP_SIZE,
+             n = blockIdx.x * NR_WARPS + threadIdx.x / WARP_SIZE, m = blockIdx.y;
+    if (n >= N) {
+        return;
+    }
+    src += m * K;
+    float acc = 0.f;
+    if (bits == 8) {
+        weight += n * K;
+        for (uint32_t k = lane; k < K; k += WARP_SIZE) {
+            acc += static_cast<float>(weight[k]) * static_cast<float>(src[k]);
+        }
+    } else {
+        uint32_t row_bytes = (K + 1) / 2;
+        weight += n * row_bytes;
+        for (uint32_t i = lane; i < row_bytes; i += WARP_SIZE) {
+            int8_t byte = weight[i];
+            uint32_t k = i * 2;
+            acc += static_cast<float>(static_cast<int8_t>(byte << 4) >> 4) *
+                   static_cast<float>(src[k]);
+            if (k + 1 < K) {
+                acc += static_cast<float>(byte >> 4) * static_cast<float>(src[k + 1]);
+            }
+        }
+    }
+    acc = warp_sum(acc);
+    if (!lane) {
+        dst[m * N + n] = static_cast<T>(acc * scale[n]);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace weight_quant_matrix_mul {
+
+template <typename T>
+void forward_proxy(
+        const T* src, const int8_t* weight, const float* scale, T* dst, uint32_t M,
+        uint32_t K, uint32_t N, uint32_t bits, cudaStream_t stream) {
+    dim3 blocks(DIVUP(N, NR_WARPS), M);
+    if (bits == 8) {
+        forward_kern<T, 8><<<blocks, NR_WARPS * WARP_SIZE, 0, stream>>>(
+                src, weight, scale, dst, M, K, N);
+    } else {
+        forward_kern<T, 4><<<blocks, NR_WARPS * WARP_SIZE, 0, stream>>>(
+                src, weight, scale, dst, M, K, N);
+    }
+    after_kernel_launch();
+}
+
+#define INST(T)                                                                      \
+    template void forward_proxy<T>(                                                  \
+            const T*, const int8_t*, const float*, T*, uint32_t, uint32_t, uint32_t, \
+            uint32_t, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace weight_quant_matrix_mul
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,37 @@
+/**
+ * \file dnn/src/cuda/weight_quant_matrix_mul/weight_quant_matrix_mul.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "cuda_runtime.h"
+#include "src/cuda/utils.cuh"
+
+namespace megdnn {
+namespace cuda {
+namespace weight_quant_matrix_mul {
+
+/*!
+ * \brief dst = src * (weight * scale)^T of (M, K) src and (N, K) weight of the
+ *      given bits
+ *
+ * A warp computes an output element, whose lanes read adjacent bytes of the
+ * weight row and dequantize them in registers, so the weight is read from
+ * global memory in its packed form.
+ */
+template <typename T>
+void forward_proxy(
+        const T* src, const int8_t* weight, const float* scale, T* dst, uint32_t M,
+        uint32_t K, uint32_t N, uint32_t bits, cudaStream_t stream);
+
+}  // namespace weight_quant_matrix_mul
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cuda.doxygen
@@ -0,0 +1,145 @@
+/**
+ * \file dnn/src/fallback/argsort/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/argsort/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! a row is split among threads only if each thread gets this many elements
+constexpr size_t MIN_SEGMENT_SIZE = 4096;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+bool use_segment(size_t M, size_t N, size_t nr_threads) {
+    return M < nr_threads && N >= MIN_SEGMENT_SIZE * 2;
+}
+
+/*!
+ * Elements are sorted as (key, index) pairs, which have a total order, so the
+ * result is the same as naive impl regardless of how the rows are split.
+ */
+template <typename KeyType, typename Cmp>
+void forward_impl(
+        naive::HandleImpl* handle, size_t M, size_t N, const KeyType* sptr,
+        KeyType* dptr, dt_int32* iptr, void* workspace) {
+    using KV = std::pair<KeyType, int>;
+    auto buf = static_cast<KV*>(workspace);
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    auto load = [=](KV* row, size_t m, size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+            row[n].first = sptr[m * N + n];
+            row[n].second = n;
+        }
+    };
+    auto store = [=](const KV* row, size_t m, size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+            dptr[m * N + n] = row[n].first;
+            iptr[m * N + n] = row[n].second;
+        }
+    };
+
+    if (!use_segment(M, N, nr_threads)) {
+        auto kern = [=](size_t m, size_t thread_id) {
+            KV* row = buf + thread_id * N;
+            load(row, m, 0, N);
+            std::sort(row, row + N, Cmp{});
+            store(row, m, 0, N);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, M, kern);
+        return;
+    }
+
+    size_t segment = std::max(div_ceil(N, nr_threads), MIN_SEGMENT_SIZE);
+    size_t nr_segment = div_ceil(N, segment);
+    for (size_t m = 0; m < M; ++m) {
+        auto sort_segment = [=](size_t s, size_t) {
+            size_t begin = s * segment, end = std::min(N, begin + segment);
+            load(buf, m, begin, end);
+            std::sort(buf + begin, buf + end, Cmp{});
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_segment, sort_segment);
+
+        // merge adjacent sorted runs, switching between the two halves of
+        // the workspace
+        KV *src = buf, *dst = buf + N;
+        for (size_t width = segment; width < N; width *= 2) {
+            auto merge = [=](size_t p, size_t) {
+                size_t begin = p * width * 2, mid = std::min(N, begin + width),
+                       end = std::min(N, mid + width);
+                std::merge(
+                        src + begin, src + mid, src + mid, src + end, dst + begin,
+                        Cmp{});
+            };
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                    handle, div_ceil(N, width * 2), merge);
+            std::swap(src, dst);
+        }
+        auto store_segment = [=](size_t s, size_t) {
+            size_t begin = s * segment, end = std::min(N, begin + segment);
+            store(src, m, begin, end);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_segment, store_segment);
+    }
+}
+
+}  // anonymous namespace
+
+void ArgsortForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, indices.layout, workspace.size);
+    auto M = src.layout.shape[0], N = src.layout.shape[1];
+    auto iptr = indices.ptr<dt_int32>();
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    bool ascending = param().order == Order::ASCENDING;
+    switch (src.layout.dtype.enumv()) {
+#define cb(dt)                                                                    \
+    case DTypeTrait<dt>::enumv: {                                                 \
+        using ctype = DTypeTrait<dt>::ctype;                                      \
+        using KV = std::pair<ctype, int>;                                         \
+        auto sptr = src.ptr<ctype>();                                             \
+        auto dptr = dst.ptr<ctype>();                                             \
+        if (ascending) {                                                          \
+            forward_impl<ctype, std::less<KV>>(                                   \
+                    handle, M, N, sptr, dptr, iptr, workspace.raw_ptr);           \
+        } else {                                                                  \
+            forward_impl<ctype, std::greater<KV>>(                                \
+                    handle, M, N, sptr, dptr, iptr, workspace.raw_ptr);           \
+        }                                                                         \
+        return;                                                                   \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+#undef cb
+        default:
+            megdnn_throw("bad dtype");
+    }
+}
+
+size_t ArgsortForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout&, const TensorLayout&) {
+    size_t M = src.shape[0], N = src.shape[1];
+    size_t nr_threads = get_nr_threads(handle());
+    // upper bound of sizeof(std::pair<ctype, int>)
+    size_t pair_size = std::max<size_t>(4, src.dtype.size()) * 2;
+    size_t nr_pair = use_segment(M, N, nr_threads) ? N * 2 : N * nr_threads;
+    return nr_pair * pair_size;
+}
+
+// vim: syntax=cpp.doxygen
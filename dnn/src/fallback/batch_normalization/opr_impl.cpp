@@ -0,0 +1,406 @@
+/**
+ * \file dnn/src/fallback/batch_normalization/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/batch_normalization/opr_impl.h"
+#include "src/common/bn_relu_helper.h"
+#include "src/common/utils.h"
+#include "src/fallback/norm_helper.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! number of channels handled by a task when channels are innermost
+constexpr size_t CH_BLOCK = 64;
+
+/*!
+ * \brief src viewed as (outer, channel, inner), where the statistics of a
+ *      channel are taken over outer and inner
+ */
+struct Shape {
+    size_t outer, channel, inner;
+
+    size_t batch_size() const { return outer * inner; }
+
+    //! a task covers a channel, or CH_BLOCK channels if inner is 1
+    size_t nr_channel_task() const {
+        return inner > 1 ? channel : div_ceil(channel, CH_BLOCK);
+    }
+
+    //! outer is split into chunks if there are not enough channel tasks
+    size_t nr_chunk(size_t nr_threads) const {
+        size_t nr_task = nr_channel_task(),
+               per_task = outer * channel * inner / nr_task;
+        return std::min(
+                {div_ceil(nr_threads, nr_task), outer,
+                 std::max<size_t>(per_task / norm::MIN_TASK_SIZE, 1)});
+    }
+
+    size_t chunk_begin(size_t chunk, size_t nr_chunk) const {
+        return chunk * outer / nr_chunk;
+    }
+};
+
+bool get_shape(const TensorLayout& src, const TensorLayout& param, Shape& shape) {
+    if (src.dtype != dtype::Float32() || param.dtype != dtype::Float32() ||
+        !src.is_contiguous() || !param.is_contiguous() || src.ndim != param.ndim ||
+        src.is_empty()) {
+        return false;
+    }
+    size_t first = src.ndim, last = 0;
+    for (size_t i = 0; i < src.ndim; ++i) {
+        if (param.shape[i] != 1) {
+            first = std::min(first, i);
+            last = i;
+        }
+    }
+    if (first == src.ndim) {
+        shape = {1, 1, src.total_nr_elems()};
+        return true;
+    }
+    shape = {1, 1, 1};
+    for (size_t i = 0; i < src.ndim; ++i) {
+        if (i < first) {
+            shape.outer *= src.shape[i];
+        } else if (i > last) {
+            shape.inner *= src.shape[i];
+        } else if (param.shape[i] == src.shape[i]) {
+            shape.channel *= src.shape[i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! run kern(chunk, channel_task) for every chunk of outer and channel task
+template <typename Func>
+void dispatch_chunks(
+        naive::HandleImpl* handle, const Shape& shape, size_t nr_chunk, Func kern) {
+    size_t nr_channel_task = shape.nr_channel_task();
+    auto task = [=](size_t task_id, size_t) {
+        kern(task_id / nr_channel_task, task_id % nr_channel_task);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_chunk * nr_channel_task, task);
+}
+
+//! moments of the channels of a task over rows [begin, end) of outer
+void chunk_moments(
+        const float* x, const Shape& s, size_t ctask, size_t begin, size_t end,
+        float* mean, float* m2) {
+    if (s.inner > 1) {
+        size_t n = 0;
+        float m = 0.f, q = 0.f;
+        for (size_t r = begin; r < end; ++r) {
+            float rm, rq;
+            norm::row_moments(x + (r * s.channel + ctask) * s.inner, s.inner, rm, rq);
+            norm::merge_moments(n, m, q, s.inner, rm, rq);
+        }
+        mean[ctask] = m;
+        m2[ctask] = q;
+        return;
+    }
+    // Welford's update, vectorized over the channels of the block
+    size_t c0 = ctask * CH_BLOCK, width = std::min(CH_BLOCK, s.channel - c0);
+    float m[CH_BLOCK] = {0.f}, q[CH_BLOCK] = {0.f};
+    for (size_t r = begin; r < end; ++r) {
+        const float* row = x + r * s.channel + c0;
+        float inv = 1.f / (r - begin + 1);
+        for (size_t i = 0; i < width; ++i) {
+            float d = row[i] - m[i];
+            m[i] += d * inv;
+            q[i] += d * (row[i] - m[i]);
+        }
+    }
+    std::copy(m, m + width, mean + c0);
+    std::copy(q, q + width, m2 + c0);
+}
+
+//! sums of dy and dy * (x - mean) of the channels of a task
+void chunk_grad_sums(
+        const float* x, const float* dy, const float* mean, const Shape& s,
+        size_t ctask, size_t begin, size_t end, float* sum_dy, float* sum_dyx) {
+    if (s.inner > 1) {
+        float sdy = 0.f, sdyx = 0.f, m = mean[ctask];
+        for (size_t r = begin; r < end; ++r) {
+            size_t offset = (r * s.channel + ctask) * s.inner;
+            const float *xr = x + offset, *dyr = dy + offset;
+            sdy += norm::lane_sum(s.inner, [=](size_t i) { return dyr[i]; });
+            sdyx += norm::lane_sum(
+                    s.inner, [=](size_t i) { return dyr[i] * (xr[i] - m); });
+        }
+        sum_dy[ctask] = sdy;
+        sum_dyx[ctask] = sdyx;
+        return;
+    }
+    size_t c0 = ctask * CH_BLOCK, width = std::min(CH_BLOCK, s.channel - c0);
+    float sdy[CH_BLOCK] = {0.f}, sdyx[CH_BLOCK] = {0.f};
+    for (size_t r = begin; r < end; ++r) {
+        size_t offset = r * s.channel + c0;
+        const float *xr = x + offset, *dyr = dy + offset, *m = mean + c0;
+        for (size_t i = 0; i < width; ++i) {
+            sdy[i] += dyr[i];
+            sdyx[i] += dyr[i] * (xr[i] - m[i]);
+        }
+    }
+    std::copy(sdy, sdy + width, sum_dy + c0);
+    std::copy(sdyx, sdyx + width, sum_dyx + c0);
+}
+
+//! dst = src * scale + shift with per channel scale and shift
+void apply_scale_shift(
+        naive::HandleImpl* handle, const Shape& s, const float* x, float* y,
+        const float* scale, const float* shift) {
+    if (s.inner > 1) {
+        norm::dispatch_rows(
+                handle, s.outer * s.channel, s.inner, [=](size_t begin, size_t end) {
+                    for (size_t r = begin; r < end; ++r) {
+                        size_t c = r % s.channel, offset = r * s.inner;
+                        norm::scale_shift(
+                                x + offset, y + offset, s.inner, scale[c], shift[c]);
+                    }
+                });
+        return;
+    }
+    norm::dispatch_rows(handle, s.outer, s.channel, [=](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            const float* xr = x + r * s.channel;
+            float* yr = y + r * s.channel;
+            for (size_t c = 0; c < s.channel; ++c) {
+                yr[c] = xr[c] * scale[c] + shift[c];
+            }
+        }
+    });
+}
+
+}  // anonymous namespace
+
+/* ======================== BNForwardImpl ======================== */
+
+size_t BNForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& bn_scale, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&, const TensorLayout& dst) {
+    Shape shape;
+    if (!get_shape(src, bn_scale, shape) || !dst.is_contiguous()) {
+        return 0;
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    // scale, shift and the moments of every chunk
+    return sizeof(float) * shape.channel * (2 + 2 * shape.nr_chunk(nr_threads));
+}
+
+void BNForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in bn_scale, _megdnn_tensor_in bn_bias,
+        _megdnn_tensor_inout mean, _megdnn_tensor_inout variance,
+        _megdnn_tensor_out batch_mean, _megdnn_tensor_out batch_inv_variance,
+        _megdnn_tensor_out reserve, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    Shape s;
+    if (!get_shape(src.layout, bn_scale.layout, s) || !dst.layout.is_contiguous()) {
+        return naive::BNForwardImpl::exec(
+                src, bn_scale, bn_bias, mean, variance, batch_mean,
+                batch_inv_variance, reserve, dst, workspace);
+    }
+    check_exec(
+            src.layout, bn_scale.layout, bn_bias.layout, mean.layout, variance.layout,
+            batch_mean.layout, batch_inv_variance.layout, dst.layout, workspace.size,
+            reserve.layout.access_bytes());
+
+    auto nhandle = static_cast<naive::HandleImpl*>(handle());
+    auto p = param();
+    size_t C = s.channel,
+           nr_chunk = s.nr_chunk(nhandle->megcore_dispatcher()->nr_threads());
+    float eps = p.epsilon, factor = p.avg_factor;
+    const float *xptr = src.ptr<dt_float32>(), *gamma = bn_scale.ptr<dt_float32>(),
+                *beta = bn_bias.ptr<dt_float32>();
+    float* running_mean = mean.layout.is_empty() ? nullptr : mean.ptr<dt_float32>();
+    float* running_var =
+            variance.layout.is_empty() ? nullptr : variance.ptr<dt_float32>();
+    float *scale = workspace.ptr<dt_float32>(), *shift = scale + C;
+
+    if (p.fwd_mode == param::BN::FwdMode::TRAINING) {
+        float *part_mean = shift + C, *part_m2 = part_mean + nr_chunk * C;
+        dispatch_chunks(nhandle, s, nr_chunk, [=](size_t chunk, size_t ctask) {
+            chunk_moments(
+                    xptr, s, ctask, s.chunk_begin(chunk, nr_chunk),
+                    s.chunk_begin(chunk + 1, nr_chunk), part_mean + chunk * C,
+                    part_m2 + chunk * C);
+        });
+        float *bmean = batch_mean.ptr<dt_float32>(),
+              *binv = batch_inv_variance.ptr<dt_float32>();
+        size_t B = s.batch_size();
+        auto merge = [=]() {
+            for (size_t c = 0; c < C; ++c) {
+                size_t n = 0;
+                float m = 0.f, q = 0.f;
+                for (size_t k = 0; k < nr_chunk; ++k) {
+                    size_t rows = s.chunk_begin(k + 1, nr_chunk) -
+                                  s.chunk_begin(k, nr_chunk);
+                    norm::merge_moments(
+                            n, m, q, rows * s.inner, part_mean[k * C + c],
+                            part_m2[k * C + c]);
+                }
+                float var = q / B, inv = 1.f / std::sqrt(var + eps);
+                bmean[c] = m;
+                binv[c] = inv;
+                if (running_mean) {
+                    running_mean[c] = (1 - factor) * running_mean[c] + factor * m;
+                }
+                if (running_var) {
+                    running_var[c] = (1 - factor) * running_var[c] +
+                                     factor * var * B / (B - 1);
+                }
+                scale[c] = gamma[c] * inv;
+                shift[c] = beta[c] - m * scale[c];
+            }
+        };
+        MEGDNN_DISPATCH_CPU_KERN(nhandle, merge());
+    } else {
+        auto prepare = [=]() {
+            for (size_t c = 0; c < C; ++c) {
+                scale[c] = gamma[c] / std::sqrt(running_var[c] + eps);
+                shift[c] = beta[c] - running_mean[c] * scale[c];
+            }
+        };
+        MEGDNN_DISPATCH_CPU_KERN(nhandle, prepare());
+    }
+    float* y = dst.ptr<dt_float32>();
+    apply_scale_shift(nhandle, s, xptr, y, scale, shift);
+    if (p.nonlineMode == param::BN::NonlineMode::RELU) {
+        // rows of 8 elements, so that every task writes whole bytes of the mask
+        size_t n = src.layout.total_nr_elems();
+        uint8_t* mask = bn_relu::need_mask(p) ? static_cast<uint8_t*>(reserve.raw_ptr)
+                                              : nullptr;
+        norm::dispatch_rows(
+                nhandle, div_ceil<size_t>(n, 8), 8, [=](size_t begin, size_t end) {
+                    bn_relu::forward(y, mask, begin * 8, std::min(end * 8, n));
+                });
+    }
+}
+
+/* ======================== BNBackwardImpl ======================== */
+
+size_t BNBackwardImpl::get_workspace_in_bytes(
+        const TensorLayout& x, const TensorLayout& dy, const TensorLayout& mean,
+        const TensorLayout& inv_variance, const TensorLayout& bn_scale,
+        const TensorLayout& reserve, const TensorLayout& d_bn_scale,
+        const TensorLayout& d_bn_bias, const TensorLayout& dx) {
+    Shape shape;
+    if (!get_shape(x, bn_scale, shape) || !dy.is_contiguous() || !dx.is_contiguous()) {
+        return naive::BNBackwardImpl::get_workspace_in_bytes(
+                x, dy, mean, inv_variance, bn_scale, reserve, d_bn_scale, d_bn_bias,
+                dx);
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    // scale, coef, shift, the partial sums of every chunk and the masked dy
+    size_t masked_dy = bn_relu::need_mask(param()) ? x.total_nr_elems() : 0;
+    return sizeof(float) *
+           (shape.channel * (3 + 2 * shape.nr_chunk(nr_threads)) + masked_dy);
+}
+
+void BNBackwardImpl::exec(
+        _megdnn_tensor_in x_in, _megdnn_tensor_in dy_in,
+        _megdnn_tensor_in saved_batch_mean, _megdnn_tensor_in saved_batch_inv_variance,
+        _megdnn_tensor_in bn_scale, _megdnn_tensor_in reserve,
+        _megdnn_tensor_out d_bn_scale, _megdnn_tensor_out d_bn_bias,
+        _megdnn_tensor_out dx_out, _megdnn_workspace workspace) {
+    Shape s;
+    if (!get_shape(x_in.layout, bn_scale.layout, s) || !dy_in.layout.is_contiguous() ||
+        !dx_out.layout.is_contiguous()) {
+        return naive::BNBackwardImpl::exec(
+                x_in, dy_in, saved_batch_mean, saved_batch_inv_variance, bn_scale,
+                reserve, d_bn_scale, d_bn_bias, dx_out, workspace);
+    }
+    check_exec(
+            x_in.layout, dy_in.layout, saved_batch_mean.layout,
+            saved_batch_inv_variance.layout, bn_scale.layout, d_bn_scale.layout,
+            d_bn_bias.layout, dx_out.layout, workspace.size,
+            reserve.layout.access_bytes());
+
+    auto nhandle = static_cast<naive::HandleImpl*>(handle());
+    size_t C = s.channel, B = s.batch_size(),
+           nr_chunk = s.nr_chunk(nhandle->megcore_dispatcher()->nr_threads());
+    const float *x = x_in.ptr<dt_float32>(), *dy = dy_in.ptr<dt_float32>(),
+                *mu = saved_batch_mean.ptr<dt_float32>(),
+                *ivar = saved_batch_inv_variance.ptr<dt_float32>(),
+                *gamma = bn_scale.ptr<dt_float32>();
+    float *dgamma = d_bn_scale.ptr<dt_float32>(), *dbeta = d_bn_bias.ptr<dt_float32>(),
+          *dx = dx_out.ptr<dt_float32>();
+    float *scale = workspace.ptr<dt_float32>(), *coef = scale + C, *shift = coef + C,
+          *part_dy = shift + C, *part_dyx = part_dy + nr_chunk * C;
+
+    if (bn_relu::need_mask(param())) {
+        // backward through the fused relu first, dy of BN is dy * (y > 0)
+        size_t n = x_in.layout.total_nr_elems();
+        auto mask = static_cast<const uint8_t*>(reserve.raw_ptr);
+        float* masked_dy = part_dyx + nr_chunk * C;
+        norm::dispatch_rows(nhandle, n, 1, [=](size_t begin, size_t end) {
+            bn_relu::backward(dy, mask, masked_dy, begin, end);
+        });
+        dy = masked_dy;
+    }
+
+    dispatch_chunks(nhandle, s, nr_chunk, [=](size_t chunk, size_t ctask) {
+        chunk_grad_sums(
+                x, dy, mu, s, ctask, s.chunk_begin(chunk, nr_chunk),
+                s.chunk_begin(chunk + 1, nr_chunk), part_dy + chunk * C,
+                part_dyx + chunk * C);
+    });
+    // dx = gamma * ivar * (dy - dbeta / B - xhat * dgamma / B)
+    auto merge = [=]() {
+        for (size_t c = 0; c < C; ++c) {
+            float sdy = 0.f, sdyx = 0.f;
+            for (size_t k = 0; k < nr_chunk; ++k) {
+                sdy += part_dy[k * C + c];
+                sdyx += part_dyx[k * C + c];
+            }
+            float sc = gamma[c] * ivar[c];
+            dbeta[c] = sdy;
+            dgamma[c] = sdyx * ivar[c];
+            scale[c] = sc;
+            coef[c] = sc * ivar[c] * dgamma[c] / B;
+            shift[c] = sc * sdy / B;
+        }
+    };
+    MEGDNN_DISPATCH_CPU_KERN(nhandle, merge());
+
+    if (s.inner > 1) {
+        norm::dispatch_rows(
+                nhandle, s.outer * C, s.inner, [=](size_t begin, size_t end) {
+                    for (size_t r = begin; r < end; ++r) {
+                        size_t c = r % C, offset = r * s.inner;
+                        norm::bwd_data(
+                                dy + offset, x + offset, dx + offset, s.inner,
+                                scale[c], mu[c], coef[c], shift[c]);
+                    }
+                });
+        return;
+    }
+    norm::dispatch_rows(nhandle, s.outer, C, [=](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            size_t offset = r * C;
+            const float *dyr = dy + offset, *xr = x + offset;
+            float* dxr = dx + offset;
+            for (size_t c = 0; c < C; ++c) {
+                dxr[c] = scale[c] * dyr[c] - coef[c] * (xr[c] - mu[c]) - shift[c];
+            }
+        }
+    });
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,63 @@
+/**
+ * \file dnn/src/fallback/batch_normalization/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/batch_normalization/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief float32 batch norm parallelized over channels and batch chunks
+ *
+ * The batch statistics are gathered in a single pass over src: every task
+ * computes the moments of a chunk, which are then merged per channel.
+ */
+class BNForwardImpl : public naive::BNForwardImpl {
+public:
+    using naive::BNForwardImpl::BNForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in bn_scale,
+            _megdnn_tensor_in bn_bias, _megdnn_tensor_out mean,
+            _megdnn_tensor_out variance, _megdnn_tensor_out batch_mean,
+            _megdnn_tensor_out batch_inv_variance, _megdnn_tensor_out reserve,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& bn_scale,
+            const TensorLayout&, const TensorLayout&, const TensorLayout&,
+            const TensorLayout&, const TensorLayout&, const TensorLayout&,
+            const TensorLayout& dst) override;
+};
+
+class BNBackwardImpl : public naive::BNBackwardImpl {
+public:
+    using naive::BNBackwardImpl::BNBackwardImpl;
+    void exec(
+            _megdnn_tensor_in x, _megdnn_tensor_in dy,
+            _megdnn_tensor_in saved_batch_mean,
+            _megdnn_tensor_in saved_batch_inv_variance, _megdnn_tensor_in bn_scale,
+            _megdnn_tensor_in reserve, _megdnn_tensor_out d_bn_scale,
+            _megdnn_tensor_out d_bn_bias, _megdnn_tensor_out dx,
+            _megdnn_workspace workspace) override;
+
+    size_t get_workspace_in_bytes(
+            const TensorLayout& x, const TensorLayout& dy, const TensorLayout&,
+            const TensorLayout&, const TensorLayout& bn_scale, const TensorLayout&,
+            const TensorLayout&, const TensorLayout&,
+            const TensorLayout& dx) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
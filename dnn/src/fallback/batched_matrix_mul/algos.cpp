@@ -18,6 +18,7 @@ using namespace megdnn;
 using namespace fallback;
 
 BatchedMatrixMulForwardImpl::AlgoPack::AlgoPack() {
+    all_algos.push_back(&algo_f32_small);
     all_algos.push_back(&algo_default);
 
     for (auto&& algo : all_algos) {
@@ -59,6 +60,70 @@ std::string BatchedMatrixMulForwardImpl::AlgoBase::SizeArgs::to_string() const {
             static_cast<size_t>(layout_c.stride[0]));
 }
 
+namespace {
+
+size_t nr_threads_of(BatchedMatrixMulForwardImpl* opr) {
+    return static_cast<naive::HandleImpl*>(opr->handle())
+            ->megcore_dispatcher()
+            ->nr_threads();
+}
+
+size_t aligned_per_thread(BatchedMatrixMulForwardImpl* opr, size_t size) {
+    return get_aligned_power2(size, opr->handle()->alignment_requirement());
+}
+
+//! the batches are split into at most nr_threads contiguous ranges
+template <typename Func>
+void dispatch_batches(
+        BatchedMatrixMulForwardImpl* opr, size_t batch, size_t nr_threads,
+        Func&& func) {
+    size_t nr_tasks = std::min(batch, nr_threads);
+    auto kern = [=](size_t task, size_t thread_id) {
+        func(task * batch / nr_tasks, (task + 1) * batch / nr_tasks, thread_id);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            static_cast<naive::HandleImpl*>(opr->handle()), nr_tasks, kern);
+}
+
+//! rows of C in blocks of 4, so that every loaded row of B is used 4 times
+void small_sgemm(
+        const float* A, const float* B, float* C, size_t M, size_t N, size_t K,
+        size_t lda_row, size_t lda_col, size_t ldb, size_t ldc) {
+    size_t i = 0;
+    for (; i + 4 <= M; i += 4) {
+        float *c0 = C + i * ldc, *c1 = c0 + ldc, *c2 = c1 + ldc, *c3 = c2 + ldc;
+        std::fill_n(c0, N, 0.f);
+        std::fill_n(c1, N, 0.f);
+        std::fill_n(c2, N, 0.f);
+        std::fill_n(c3, N, 0.f);
+        for (size_t p = 0; p < K; ++p) {
+            const float* a = A + i * lda_row + p * lda_col;
+            float a0 = a[0], a1 = a[lda_row], a2 = a[2 * lda_row],
+                  a3 = a[3 * lda_row];
+            const float* b = B + p * ldb;
+            for (size_t j = 0; j < N; ++j) {
+                c0[j] += a0 * b[j];
+                c1[j] += a1 * b[j];
+                c2[j] += a2 * b[j];
+                c3[j] += a3 * b[j];
+            }
+        }
+    }
+    for (; i < M; ++i) {
+        float* c = C + i * ldc;
+        std::fill_n(c, N, 0.f);
+        for (size_t p = 0; p < K; ++p) {
+            float a = A[i * lda_row + p * lda_col];
+            const float* b = B + p * ldb;
+            for (size_t j = 0; j < N; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
 /* ===================== default algo ===================== */
 size_t BatchedMatrixMulForwardImpl::AlgoDefault::get_workspace_in_bytes(
         const SizeArgs& args) const {
@@ -66,42 +131,117 @@ size_t BatchedMatrixMulForwardImpl::AlgoDefault::get_workspace_in_bytes(
     auto A_ = args.layout_a.remove_axis(0), B_ = args.layout_b.remove_axis(0),
          C_ = args.layout_c.remove_axis(0);
     opr->param() = args.opr->param();
-    return opr->get_workspace_in_bytes(A_, B_, C_);
+    return aligned_per_thread(args.opr, opr->get_workspace_in_bytes(A_, B_, C_)) *
+           nr_threads_of(args.opr);
 }
 
 void BatchedMatrixMulForwardImpl::AlgoDefault::exec(const ExecArgs& args) const {
     //! As megbrain may modify param when checking all transpose situations, so
     //! here we should copy the param when dispatching kern
     auto param = args.opr->param();
-    auto kern = [args, param]() {
-        auto N = args.layout_a.shape[0];
-        TensorND A_, B_, C_;
-        A_.raw_ptr = args.tensor_a.raw_ptr;
-        A_.layout = args.layout_a.remove_axis(0);
-        B_.raw_ptr = args.tensor_b.raw_ptr;
-        B_.layout = args.layout_b.remove_axis(0);
-        C_.raw_ptr = args.tensor_c.raw_ptr;
-        C_.layout = args.layout_c.remove_axis(0);
-
-        auto Astrd = args.layout_a.dtype.size() * args.layout_a.stride[0],
-             Bstrd = args.layout_b.dtype.size() * args.layout_b.stride[0],
-             Cstrd = args.layout_c.dtype.size() * args.layout_c.stride[0];
-
-        auto advance_ptr = [](TensorND& dest, ptrdiff_t d) {
-            dest.raw_ptr = static_cast<void*>(static_cast<dt_byte*>(dest.raw_ptr) + d);
-        };
-
-        auto opr = inplace_cpu_handle()->create_operator<MatrixMul>();
-        opr->param() = param;
-        rep(n, N) {
-            opr->exec(A_, B_, C_, args.workspace);
-            advance_ptr(A_, Astrd);
-            advance_ptr(B_, Bstrd);
-            advance_ptr(C_, Cstrd);
+    size_t nr_threads = nr_threads_of(args.opr);
+    auto A_layout = args.layout_a.remove_axis(0),
+         B_layout = args.layout_b.remove_axis(0),
+         C_layout = args.layout_c.remove_axis(0);
+
+    //! every thread owns a MatrixMul opr and a slice of the workspace
+    auto oprs = std::make_shared<std::vector<std::unique_ptr<MatrixMul>>>();
+    for (size_t i = 0; i < nr_threads; ++i) {
+        oprs->emplace_back(inplace_cpu_handle()->create_operator<MatrixMul>());
+        oprs->back()->param() = param;
+    }
+    size_t workspace_per_thread = aligned_per_thread(
+            args.opr,
+            oprs->front()->get_workspace_in_bytes(A_layout, B_layout, C_layout));
+
+    auto Astrd = args.layout_a.dtype.size() * args.layout_a.stride[0],
+         Bstrd = args.layout_b.dtype.size() * args.layout_b.stride[0],
+         Cstrd = args.layout_c.dtype.size() * args.layout_c.stride[0];
+    auto A_ptr = static_cast<dt_byte*>(args.tensor_a.raw_ptr),
+         B_ptr = static_cast<dt_byte*>(args.tensor_b.raw_ptr),
+         C_ptr = static_cast<dt_byte*>(args.tensor_c.raw_ptr);
+    auto workspace_ptr = args.workspace.raw_ptr;
+
+    auto kern = [=](size_t begin, size_t end, size_t thread_id) {
+        TensorND A_{A_ptr + begin * Astrd, A_layout},
+                B_{B_ptr + begin * Bstrd, B_layout},
+                C_{C_ptr + begin * Cstrd, C_layout};
+        Workspace workspace{
+                workspace_ptr + thread_id * workspace_per_thread,
+                workspace_per_thread};
+        auto&& opr = (*oprs)[thread_id];
+        for (size_t n = begin; n < end; ++n) {
+            opr->exec(A_, B_, C_, workspace);
+            incr_voidp(A_.raw_ptr, Astrd);
+            incr_voidp(B_.raw_ptr, Bstrd);
+            incr_voidp(C_.raw_ptr, Cstrd);
         }
     };
+    dispatch_batches(args.opr, args.layout_a.shape[0], nr_threads, kern);
+}
 
-    static_cast<naive::HandleImpl*>(args.opr->handle())->dispatch_kern(kern);
+/* ===================== f32 small algo ===================== */
+bool BatchedMatrixMulForwardImpl::AlgoF32Small::is_available(
+        const SizeArgs& args) const {
+    auto&& param = args.opr->param();
+    auto &&A = args.layout_a, &&B = args.layout_b, &&C = args.layout_c;
+    size_t m = C.shape[1], n = C.shape[2], k = A.shape[param.transposeA ? 1 : 2];
+    return A.dtype == dtype::Float32() && B.dtype == dtype::Float32() &&
+           C.dtype == dtype::Float32() &&
+           param.format == param::MatrixMul::Format::DEFAULT &&
+           param.compute_mode == param::MatrixMul::ComputeMode::DEFAULT &&
+           A.stride[2] == 1 && B.stride[2] == 1 && C.stride[2] == 1 &&
+           m * n * k <= 32 * 32 * 32;
+}
+
+size_t BatchedMatrixMulForwardImpl::AlgoF32Small::get_workspace_in_bytes(
+        const SizeArgs& args) const {
+    if (!args.opr->param().transposeB) {
+        return 0;
+    }
+    //! a transposed B is repacked so that the kernel reads rows of it
+    size_t size = args.layout_b.shape[1] * args.layout_b.shape[2] * sizeof(float);
+    return aligned_per_thread(args.opr, size) * nr_threads_of(args.opr);
+}
+
+void BatchedMatrixMulForwardImpl::AlgoF32Small::exec(const ExecArgs& args) const {
+    auto param = args.opr->param();
+    size_t nr_threads = nr_threads_of(args.opr);
+    auto &&A = args.layout_a, &&B = args.layout_b, &&C = args.layout_c;
+    size_t M = C.shape[1], N = C.shape[2], K = A.shape[param.transposeA ? 1 : 2];
+    size_t lda_row = param.transposeA ? 1 : A.stride[1],
+           lda_col = param.transposeA ? A.stride[1] : 1;
+    ptrdiff_t Astrd = A.stride[0], Bstrd = B.stride[0], Cstrd = C.stride[0],
+              ldb = B.stride[1], ldc = C.stride[1];
+    size_t workspace_per_thread =
+            param.transposeB ? aligned_per_thread(args.opr, K * N * sizeof(float))
+                             : 0;
+    bool transposeB = param.transposeB;
+    auto A_ptr = args.tensor_a.ptr<float>(), B_ptr = args.tensor_b.ptr<float>();
+    auto C_ptr = args.tensor_c.ptr<float>();
+    auto workspace_ptr = args.workspace.raw_ptr;
+
+    auto kern = [=](size_t begin, size_t end, size_t thread_id) {
+        float* packed = reinterpret_cast<float*>(
+                workspace_ptr + thread_id * workspace_per_thread);
+        for (size_t n = begin; n < end; ++n) {
+            const float* b = B_ptr + n * Bstrd;
+            size_t cur_ldb = ldb;
+            if (transposeB) {
+                for (size_t p = 0; p < K; ++p) {
+                    for (size_t j = 0; j < N; ++j) {
+                        packed[p * N + j] = b[j * ldb + p];
+                    }
+                }
+                b = packed;
+                cur_ldb = N;
+            }
+            small_sgemm(
+                    A_ptr + n * Astrd, b, C_ptr + n * Cstrd, M, N, K, lda_row,
+                    lda_col, cur_ldb, ldc);
+        }
+    };
+    dispatch_batches(args.opr, A.shape[0], nr_threads, kern);
 }
 
 // vim: syntax=cpp.doxygen
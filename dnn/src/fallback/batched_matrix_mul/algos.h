@@ -34,6 +34,7 @@ protected:
 public:
     enum class AlgoType : uint32_t {
         fallback_BLAS,
+        fallback_F32_SMALL,
     };
     using Mapper = std::unordered_map<AlgorithmDesc, AlgoBase*>;
 
@@ -93,6 +94,24 @@ public:
     MEGDNN_DECL_ALGO_TYPE(fallback_BLAS)
 };
 
+/*!
+ * \brief float32 batched matmul of small matrices
+ *
+ * MatrixMul packing dominates when every matrix of the batch is tiny (e.g.
+ * attention heads), so C is computed directly by a register blocked kernel
+ * and the batch is split among threads.
+ */
+class BatchedMatrixMulForwardImpl::AlgoF32Small final : public AlgoBase {
+public:
+    AlgoF32Small() = default;
+    bool is_available(const SizeArgs& args) const override;
+    size_t get_workspace_in_bytes(const SizeArgs& args) const override;
+    const char* name() const override { return "F32_SMALL"; }
+    virtual void exec(const ExecArgs&) const override;
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    MEGDNN_DECL_ALGO_TYPE(fallback_F32_SMALL)
+};
+
 class BatchedMatrixMulForwardImpl::AlgoPack : NonCopyableObj {
 private:
     AlgoBase::Mapper m_all_algos_map;
@@ -100,6 +119,7 @@ private:
 public:
     AlgoPack();
     AlgoDefault algo_default;
+    AlgoF32Small algo_f32_small;
     std::vector<AlgoBase*> all_algos;
 
     const AlgoBase::Mapper& all_algos_map() const { return m_all_algos_map; }
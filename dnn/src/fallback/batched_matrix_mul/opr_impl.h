@@ -28,6 +28,7 @@ public:
 
     class AlgoBase;
     class AlgoDefault;
+    class AlgoF32Small;
     class AlgoPack;
     static const AlgoPack& algo_pack() { return sm_algo_pack; }
     Algorithm* get_algorithm_from_desc(const AlgorithmDesc&) override;
@@ -0,0 +1,128 @@
+/**
+ * \file dnn/src/fallback/block_sparse_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/block_sparse_matrix_mul/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! y += a * x
+MEGDNN_FORCE_INLINE void axpy(
+        float a, const float* __restrict x, float* __restrict y, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+MEGDNN_FORCE_INLINE float dot(const float* a, const float* b, size_t len) {
+    float sum = 0.f;
+    for (size_t i = 0; i < len; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+struct Shape {
+    size_t M, K, N, bh, bw;
+};
+
+//! rows [rb * bh, (rb + 1) * bh) of A * src of a batch
+void sparse_dense_row_block(
+        const float* values, const dt_int32* col_idx, const dt_int32* row_ptr,
+        const float* src, float* dst, size_t rb, const Shape& shp) {
+    dst += rb * shp.bh * shp.N;
+    std::fill(dst, dst + shp.bh * shp.N, 0.f);
+    for (dt_int32 blk = row_ptr[rb]; blk < row_ptr[rb + 1]; ++blk) {
+        const float* val = values + blk * shp.bh * shp.bw;
+        const float* s = src + col_idx[blk] * shp.bw * shp.N;
+        for (size_t i = 0; i < shp.bh; ++i) {
+            for (size_t j = 0; j < shp.bw; ++j) {
+                float v = val[i * shp.bw + j];
+                if (v != 0.f) {
+                    axpy(v, s + j * shp.N, dst + i * shp.N, shp.N);
+                }
+            }
+        }
+    }
+}
+
+//! a row of src * A^T
+void dense_sparse_t_row(
+        const float* values, const dt_int32* col_idx, const dt_int32* row_ptr,
+        const float* src, float* dst, const Shape& shp) {
+    size_t nr_rb = shp.M / shp.bh;
+    for (size_t rb = 0; rb < nr_rb; ++rb) {
+        float* d = dst + rb * shp.bh;
+        std::fill(d, d + shp.bh, 0.f);
+        for (dt_int32 blk = row_ptr[rb]; blk < row_ptr[rb + 1]; ++blk) {
+            const float* val = values + blk * shp.bh * shp.bw;
+            const float* s = src + col_idx[blk] * shp.bw;
+            for (size_t i = 0; i < shp.bh; ++i) {
+                d[i] += dot(val + i * shp.bw, s, shp.bw);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+void BlockSparseMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in values, _megdnn_tensor_in col_idx, _megdnn_tensor_in row_ptr,
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    if (src.layout.dtype != dtype::Float32()) {
+        return naive::BlockSparseMatrixMulForwardImpl::exec(
+                values, col_idx, row_ptr, src, dst, workspace);
+    }
+    check_exec(
+            values.layout, col_idx.layout, row_ptr.layout, src.layout, dst.layout,
+            workspace.size);
+    auto&& sl = src.layout;
+    bool sparse_dense = param().mode == Param::Mode::SPARSE_DENSE;
+    size_t B = sl.ndim == 3 ? sl[0] : 1;
+    Shape shp;
+    shp.bh = param().block_h;
+    shp.bw = param().block_w;
+    shp.M = (row_ptr.layout[0] - 1) * shp.bh;
+    shp.K = sl[sl.ndim - (sparse_dense ? 2 : 1)];
+    shp.N = sl[sl.ndim - (sparse_dense ? 1 : 2)];
+    if (!B || !shp.M || !shp.N) {
+        return;
+    }
+    const float *vptr = values.ptr<dt_float32>(), *sptr = src.ptr<dt_float32>();
+    const dt_int32 *cptr = col_idx.ptr<dt_int32>(), *rptr = row_ptr.ptr<dt_int32>();
+    float* dptr = dst.ptr<dt_float32>();
+    if (sparse_dense) {
+        size_t nr_rb = shp.M / shp.bh;
+        auto kern = [=](size_t task, size_t) {
+            size_t b = task / nr_rb, rb = task % nr_rb;
+            sparse_dense_row_block(
+                    vptr, cptr, rptr, sptr + b * shp.K * shp.N,
+                    dptr + b * shp.M * shp.N, rb, shp);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                static_cast<naive::HandleImpl*>(handle()), B * nr_rb, kern);
+    } else {
+        auto kern = [=](size_t task, size_t) {
+            dense_sparse_t_row(
+                    vptr, cptr, rptr, sptr + task * shp.K, dptr + task * shp.M, shp);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                static_cast<naive::HandleImpl*>(handle()), B * shp.N, kern);
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,38 @@
+/**
+ * \file dnn/src/fallback/block_sparse_matrix_mul/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/block_sparse_matrix_mul/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief float32 block sparse matmul that only visits the non-zero blocks
+ *
+ * For SPARSE_DENSE, each block is applied to the contiguous rows of src with
+ * vectorizable axpys, and the row blocks of each batch are computed in
+ * parallel. For DENSE_SPARSE_T, the rows of src are computed in parallel.
+ */
+class BlockSparseMatrixMulForwardImpl : public naive::BlockSparseMatrixMulForwardImpl {
+public:
+    using naive::BlockSparseMatrixMulForwardImpl::BlockSparseMatrixMulForwardImpl;
+    void exec(
+            _megdnn_tensor_in values, _megdnn_tensor_in col_idx,
+            _megdnn_tensor_in row_ptr, _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,160 @@
+/**
+ * \file dnn/src/fallback/cond_take/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/fallback/cond_take/opr_impl.h"
+#include "src/common/cond_take/predicate.cuh"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+using namespace cond_take;
+
+using Param = CondTake::Param;
+
+namespace {
+
+//! number of elements to be processed by each task
+constexpr size_t MIN_TASK_SIZE = 4096;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+size_t get_chunk_size(size_t size, size_t nr_threads) {
+    return std::max(MIN_TASK_SIZE, div_ceil(size, nr_threads));
+}
+
+/*!
+ * \param dest indices of matched elements, followed by the number of them and
+ *      then the number of matched elements of each chunk
+ */
+template <uint32_t mode, typename ctype>
+void gen_index(
+        naive::HandleImpl* handle, size_t size, dt_int32* dest, const ctype* inp,
+        cond_take::Pred<mode, ctype> pred) {
+    size_t chunk = get_chunk_size(size, handle->megcore_dispatcher()->nr_threads()),
+           nr_chunk = div_ceil(size, chunk);
+    dt_int32* counts = dest + size + 1;
+    auto count = [=](size_t t, size_t) {
+        size_t begin = t * chunk, end = std::min(size, begin + chunk);
+        dt_int32 cnt = 0;
+        for (size_t i = begin; i < end; ++i) {
+            cnt += pred(inp[i]);
+        }
+        counts[t] = cnt;
+    };
+    auto prefix_sum = [=]() {
+        dt_int32 sum = 0;
+        for (size_t t = 0; t < nr_chunk; ++t) {
+            auto cnt = counts[t];
+            counts[t] = sum;
+            sum += cnt;
+        }
+        dest[size] = sum;
+    };
+    auto write = [=](size_t t, size_t) {
+        size_t begin = t * chunk, end = std::min(size, begin + chunk);
+        dt_int32* out = dest + counts[t];
+        for (size_t i = begin; i < end; ++i) {
+            if (pred(inp[i])) {
+                *(out++) = i;
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_chunk, count);
+    MEGDNN_DISPATCH_CPU_KERN(handle, prefix_sum());
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_chunk, write);
+}
+
+template <typename ctype>
+void copy_data(
+        naive::HandleImpl* handle, size_t sz, dt_int32* dest_idx, ctype* dest_data,
+        const dt_int32* src_idx, const ctype* src_data) {
+    auto kern = [=](size_t t, size_t) {
+        size_t begin = t * MIN_TASK_SIZE, end = std::min(sz, begin + MIN_TASK_SIZE);
+        for (size_t i = begin; i < end; ++i) {
+            auto idx = src_idx[i];
+            dest_idx[i] = idx;
+            dest_data[i] = src_data[idx];
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, div_ceil(sz, MIN_TASK_SIZE), kern);
+}
+
+}  // anonymous namespace
+
+size_t CondTakeImpl::get_workspace_in_bytes(const TensorLayout& data) {
+    return (data.total_nr_elems() + 1 + get_nr_threads(handle())) * sizeof(dt_int32);
+}
+
+CondTakeImpl::Output CondTakeImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in mask, _megdnn_workspace workspace,
+        DynOutMallocPolicyCall malloc_policy) {
+    auto size = check_exec_get_size(data.layout, mask.layout, workspace.size);
+    auto idx_tmp = workspace.ptr<dt_int32>();
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+
+    switch (mask.layout.dtype.enumv()) {
+#define cb(_dt)                                                   \
+    case DTypeTrait<_dt>::enumv: {                                \
+        using ctype = DTypeTrait<_dt>::ctype;                     \
+        dispatch_genidx<ctype>(size, idx_tmp, mask.ptr<ctype>()); \
+        break;                                                    \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Bool)
+#undef cb
+                default : megdnn_throw("bad mask dtype");
+    }
+
+    handle->megcore_dispatcher()->sync();
+    size_t out_size = idx_tmp[size];
+    auto out_data = malloc_policy.alloc_output(0, data.layout.dtype, {out_size});
+    auto out_idx = malloc_policy.alloc_output(1, dtype::Int32(), {out_size});
+    auto out_idx_ptr = out_idx.ptr<dt_int32>();
+
+    switch (data.layout.dtype.enumv()) {
+#define cb(_dt)                                                                \
+    case DTypeTrait<_dt>::enumv: {                                             \
+        using ctype = DTypeTrait<_dt>::ctype;                                  \
+        copy_data<ctype>(                                                      \
+                handle, out_size, out_idx_ptr, out_data.ptr<ctype>(), idx_tmp, \
+                data.ptr<ctype>());                                            \
+        break;                                                                 \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Bool)
+#undef cb
+                default : megdnn_throw("bad data dtype");
+    }
+
+    return {{out_data, out_idx}};
+}
+
+template <typename ctype>
+void CondTakeImpl::dispatch_genidx(size_t size, dt_int32* dest, const ctype* inp) {
+    KParam kparam(m_param);
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    switch (m_param.mode) {
+#define cb(_m)                                    \
+    case Param::Mode::_m: {                       \
+        Pred<PEnum::_m, ctype> pred(kparam);      \
+        gen_index(handle, size, dest, inp, pred); \
+        return;                                   \
+    }
+        MEGDNN_FOREACH_COND_TAKE_MODE(cb)
+#undef cb
+    }
+    megdnn_assert_internal(0);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/fallback/cond_take/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/naive/cond_take/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief CondTake that splits the input into chunks: matched elements in each
+ *      chunk are counted in parallel, and then written at the prefix sum of the
+ *      counts
+ */
+class CondTakeImpl : public naive::CondTakeImpl {
+    template <typename ctype>
+    void dispatch_genidx(size_t size, dt_int32* dest, const ctype* inp);
+
+public:
+    using naive::CondTakeImpl::CondTakeImpl;
+
+    size_t get_workspace_in_bytes(const TensorLayout& data) override;
+
+    Output exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in mask, _megdnn_workspace workspace,
+            DynOutMallocPolicyCall malloc_policy) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -118,6 +118,10 @@ void kern_default(const ConvBiasImpl::NCBKernParam& p) {
             Float16, Float16, Float16, FLOAT32,
             (megdnn::naive::convolution::forward_bias<
                     dt_float16, dt_float16, dt_float16, dt_float32>))
+    DISPATCH_RAW(
+            BFloat16, BFloat16, BFloat16, FLOAT32,
+            (megdnn::naive::convolution::forward_bias<
+                    dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_float32>))
 #endif
     else {
         megdnn_throw(ssprintf(
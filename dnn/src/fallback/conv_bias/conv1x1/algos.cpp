@@ -49,6 +49,26 @@ size_t ConvBiasImpl::AlgoConv1x1::get_oc_tile_size_heuristic(
     return round_up<size_t>(oc_block_size_one_thread, 24);
 }
 
+float ConvBiasImpl::AlgoConv1x1::estimate_cost(
+        const NCBKernSizeParam& param, const CpuCacheInfo& cache) const {
+    size_t OC = param.filter_meta.ocpg;
+    size_t compt_oc_block_size = get_oc_tile_size_heuristic(param);
+    CpuCacheInfo::GemmBlocks blocks;
+    blocks.nr_blocks = param.n * param.filter_meta.group *
+                       div_ceil(OC, compt_oc_block_size);
+    blocks.nr_threads = param.nr_threads;
+    blocks.m = std::min(compt_oc_block_size, OC);
+    blocks.n = param.osz[0] * param.osz[1];
+    blocks.k = param.filter_meta.icpg;
+    blocks.inner_m = m_matmul_algo->matmul_description().innerblocksize.m;
+    blocks.nr_b_copies = 1;
+    blocks.src_size = param.src_type.size();
+    blocks.acc_size = param.dst_type.category() == DTypeCategory::FLOAT
+                            ? param.dst_type.size()
+                            : sizeof(int32_t);
+    return cache.estimate_ns(blocks);
+}
+
 WorkspaceBundle ConvBiasImpl::AlgoConv1x1::get_bundle_according_packmode(
         const NCBKernSizeParam& param) const {
     size_t OH = param.osz[0];
@@ -225,6 +245,7 @@ bool ConvBiasImpl::AlgoConv1x1::usable(
              param.src_type.enumv() != DTypeEnum::Quantized8Asymm &&
 #if !MEGDNN_DISABLE_FLOAT16
              param.src_type.enumv() != DTypeEnum::Float16 &&
+             param.src_type.enumv() != DTypeEnum::BFloat16 &&
 #endif
              param.src_type.enumv() != DTypeEnum::Float32)) {
             return false;
@@ -246,6 +267,13 @@ bool ConvBiasImpl::AlgoConv1x1::usable(
                 return false;
             }
         }
+        //! bfloat16 strategy does no postprocess and its matmul always
+        //! accumulates in float32
+        bool is_bf16 = param.src_type.enumv() == DTypeEnum::BFloat16;
+        if (is_bf16 && (param.bias_mode != megdnn::BiasMode::NO_BIAS ||
+                        param.nonlineMode != megdnn::NonlineMode::IDENTITY)) {
+            return false;
+        }
         MatrixMulImpl::KernSizeParam matmul_param = utils::get_matmul_kern_param(
                 param, OH * OW, get_oc_tile_size_heuristic(param));
         bool matmul_usable = m_matmul_algo->usable(matmul_param);
@@ -255,7 +283,9 @@ bool ConvBiasImpl::AlgoConv1x1::usable(
         return matmul_usable && strategy_usable &&
                (param.filter_meta.dilation[0] == param.filter_meta.dilation[1] &&
                 param.filter_meta.dilation[0] == 1) &&
-               param.compute_mode == param::ConvBias::ComputeMode::DEFAULT;
+               (param.compute_mode == param::ConvBias::ComputeMode::DEFAULT ||
+                (is_bf16 &&
+                 param.compute_mode == param::ConvBias::ComputeMode::FLOAT32));
     }
     MIDOUT_END();
     return false;
@@ -44,6 +44,12 @@ public:
     SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
 
     bool is_preferred(const NCBKernSizeParam&) const override;
+    bool is_block_variant_of(const AlgoBase* other) const override {
+        return other->type() == type() &&
+               static_cast<const AlgoConv1x1*>(other)->m_matmul_algo == m_matmul_algo;
+    }
+    float estimate_cost(
+            const NCBKernSizeParam& param, const CpuCacheInfo& cache) const override;
 
     SmallVector<TensorLayout> deduce_preprocessed_filter_layout(
             const NCBKernSizeParam& param) const override;
@@ -77,6 +77,10 @@ std::unique_ptr<Conv1x1StrategyBase> create_conv1x1_strategy(
             cb1(MatrixMulImpl::AlgoBase::PackMode::DEFAULT, dt_float16, dt_float16,
                 PostprocessMode::NO_PROCESS, "Default::FLOAT16_FLOAT16"_hash);
 #endif
+#endif
+#if !MEGDNN_DISABLE_FLOAT16
+            cb1(MatrixMulImpl::AlgoBase::PackMode::DEFAULT, dt_bfloat16, dt_bfloat16,
+                PostprocessMode::NO_PROCESS, "Default::BFLOAT16_BFLOAT16"_hash);
 #endif
             cb3(MatrixMulImpl::AlgoBase::PackMode::DEFAULT, dt_int8, dt_int32, dt_int32,
                 dt_int8, dt_int32, dt_int32, PostprocessMode::ADD_BIAS,
@@ -159,6 +163,10 @@ bool Conv1x1Factory::can_make_conv1x1_strategy(
     bool ok_default_cb1_fp16 = false;
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC || !MEGDNN_DISABLE_FLOAT16
     ok_default_cb1_fp16 = param.src_type.enumv() == DTypeTrait<dt_float16>::enumv;
+#endif
+    bool ok_default_cb1_bf16 = false;
+#if !MEGDNN_DISABLE_FLOAT16
+    ok_default_cb1_bf16 = param.src_type.enumv() == DTypeTrait<dt_bfloat16>::enumv;
 #endif
     bool ok_default_cb2_arm = false;
 #if MEGDNN_AARCH64 || MEGDNN_ARMV7
@@ -183,7 +191,7 @@ bool Conv1x1Factory::can_make_conv1x1_strategy(
     switch (pack_mode) {
         case MatrixMulImpl::AlgoBase::PackMode::DEFAULT:
             return ok_default_cb1 || ok_default_cb2 || ok_default_cb1_fp16 ||
-                   ok_default_cb2_arm;
+                   ok_default_cb1_bf16 || ok_default_cb2_arm;
             break;
         case MatrixMulImpl::AlgoBase::PackMode::ONLY_PACKA:
             return ok_only_packa_cb1;
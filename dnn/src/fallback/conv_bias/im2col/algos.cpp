@@ -236,6 +236,33 @@ size_t ConvBiasImpl::AlgoIm2col::get_workspace(const NCBKernSizeParam& p) const
     return 0;
 }
 
+float ConvBiasImpl::AlgoIm2col::estimate_cost(
+        const NCBKernSizeParam& param, const CpuCacheInfo& cache) const {
+    auto matmul_desc = m_matmul_algo->matmul_description();
+    size_t oc_tile_size = 0, ohw_tile_size = 0;
+    choice_ohw_oc_block(
+            param, oc_tile_size, ohw_tile_size, matmul_desc.innerblocksize.m,
+            matmul_desc.innerblocksize.n, m_ohw_tile_size, matmul_desc.packmode);
+    size_t OC = param.filter_meta.ocpg;
+    size_t ohw = param.osz[0] * param.osz[1];
+    CpuCacheInfo::GemmBlocks blocks;
+    blocks.nr_blocks = param.n * param.filter_meta.group *
+                       div_ceil(ohw, ohw_tile_size) * div_ceil(OC, oc_tile_size);
+    blocks.nr_threads = param.nr_threads;
+    blocks.m = std::min(oc_tile_size, OC);
+    blocks.n = ohw_tile_size;
+    blocks.k = param.filter_meta.icpg * param.filter_meta.spatial[0] *
+               param.filter_meta.spatial[1];
+    blocks.inner_m = matmul_desc.innerblocksize.m;
+    //! the im2col result is packed again unless in no_pack mode
+    blocks.nr_b_copies = matmul_desc.packmode == Pack_Mode::NO_PACK ? 1 : 2;
+    blocks.src_size = param.src_type.size();
+    blocks.acc_size = param.dst_type.category() == DTypeCategory::FLOAT
+                            ? param.dst_type.size()
+                            : sizeof(int32_t);
+    return cache.estimate_ns(blocks);
+}
+
 SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoIm2col::dispatch_kerns(
         const NCBKernSizeParam& param) const {
     MIDOUT_BEGIN(megdnn_fallback_im2col, 0, 1) {
@@ -365,6 +392,7 @@ bool ConvBiasImpl::AlgoIm2col::usable(
              param.src_type.enumv() != DTypeEnum::Quantized8Asymm &&
 #if !MEGDNN_DISABLE_FLOAT16
              param.src_type.enumv() != DTypeEnum::Float16 &&
+             param.src_type.enumv() != DTypeEnum::BFloat16 &&
 #endif
              param.src_type.enumv() != DTypeEnum::Float32)) {
             return false;
@@ -387,6 +415,13 @@ bool ConvBiasImpl::AlgoIm2col::usable(
                 return false;
             }
         }
+        //! bfloat16 strategy does no postprocess and its matmul always
+        //! accumulates in float32
+        bool is_bf16 = param.src_type.enumv() == DTypeEnum::BFloat16;
+        if (is_bf16 && (param.bias_mode != megdnn::BiasMode::NO_BIAS ||
+                        param.nonlineMode != megdnn::NonlineMode::IDENTITY)) {
+            return false;
+        }
         size_t oc_tile_size = 0, ohw_tile_size = 0;
         choice_ohw_oc_block(
                 param, oc_tile_size, ohw_tile_size, matmul_desc.innerblocksize.m,
@@ -401,7 +436,9 @@ bool ConvBiasImpl::AlgoIm2col::usable(
                   param.filter_meta.stride[0] == 1)) &&
                (param.filter_meta.dilation[0] == param.filter_meta.dilation[1] &&
                 param.filter_meta.dilation[0] == 1) &&
-               param.compute_mode == param::ConvBias::ComputeMode::DEFAULT;
+               (param.compute_mode == param::ConvBias::ComputeMode::DEFAULT ||
+                (is_bf16 &&
+                 param.compute_mode == param::ConvBias::ComputeMode::FLOAT32));
     }
     MIDOUT_END();
     return false;
@@ -62,6 +62,13 @@ public:
         }
     }
 
+    bool is_block_variant_of(const AlgoBase* other) const override {
+        return other->type() == type() &&
+               static_cast<const AlgoIm2col*>(other)->m_matmul_algo == m_matmul_algo;
+    }
+    float estimate_cost(
+            const NCBKernSizeParam& param, const CpuCacheInfo& cache) const override;
+
     ConvAlgoTypePack get_algo_type() const override {
         return {m_matmul_algo->matmul_description().algo_type.data_type,
                 AlgoCategory::IM2COL};
@@ -179,6 +179,9 @@ INSTANTIAL_CLASS(
 INSTANTIAL_CLASS(
         dt_float16, dt_float16, dt_float16, dt_float16, dt_float16,
         megdnn::PostprocessMode::NO_PROCESS)
+INSTANTIAL_CLASS(
+        dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_bfloat16,
+        megdnn::PostprocessMode::NO_PROCESS)
 #endif
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC
 INSTANTIAL_CLASS(
@@ -301,23 +301,41 @@ ConvBiasImpl::Algorithm* ConvBiasImpl::get_algorithm_heuristic_with_ncb(
     }
     auto algo_data_type = param.deduce_algo_data_type();
     auto suggest_category_order = suggest_algo_category_order(param);
+    auto usable = [&](AlgoBase* algo) {
+        return algo->usable_attribute(
+                       param, AlgoSelectionStrategy::HEURISTIC, positive_attr,
+                       negative_attr) &&
+               algo->get_workspace(param) <= workspace_limit_in_bytes;
+    };
     for (auto category : suggest_category_order) {
         auto&& origin_algos = select_algo_type({algo_data_type, category});
         ConvBiasImpl::Algorithm* heuristic_algo = nullptr;
-        for (auto i : origin_algos) {
-            bool usable_attribute = static_cast<AlgoBase*>(i)->usable_attribute(
-                    param, AlgoSelectionStrategy::HEURISTIC, positive_attr,
-                    negative_attr);
-            if (usable_attribute && static_cast<AlgoBase*>(i)->get_workspace(param) <=
-                                            workspace_limit_in_bytes) {
+        for (size_t idx = 0; idx < origin_algos.size(); ++idx) {
+            auto i = origin_algos[idx];
+            if (usable(i)) {
                 //! store the first usable algo if no prefer algo, choose it as
                 //! the target algo
                 if (!heuristic_algo) {
                     heuristic_algo = i;
                 }
-                //! choose the first prefer algo
+                //! choose the first prefer algo, or the block variant of it
+                //! with the lowest estimated cost on the caches of the cpu
                 if (i->is_preferred(param)) {
-                    return i;
+                    auto&& cache = CpuCacheInfo::inst();
+                    float best_cost = i->estimate_cost(param, cache);
+                    AlgoBase* best = i;
+                    for (size_t j = idx + 1; best_cost > 0 && j < origin_algos.size() &&
+                                             origin_algos[j]->is_block_variant_of(i);
+                         ++j) {
+                        if (!usable(origin_algos[j]))
+                            continue;
+                        float cost = origin_algos[j]->estimate_cost(param, cache);
+                        if (cost > 0 && cost < best_cost) {
+                            best = origin_algos[j];
+                            best_cost = cost;
+                        }
+                    }
+                    return best;
                 }
             }
         }
@@ -15,6 +15,7 @@
 #include "src/common/utils.h"
 #include "src/fallback/conv_bias/common.h"
 #include "src/fallback/convolution/opr_impl.h"
+#include "src/fallback/cpu_cache_info.h"
 #include "src/fallback/matrix_mul/opr_impl.h"
 #include "src/naive/conv_bias/opr_impl.h"
 
@@ -225,6 +226,7 @@ public:
             X86_DIRECT_AVX2_STRD2_INT8,
             X86_MKLDNN_QINT8,
             X86_MKLDNN_MATMUL_QINT8,
+            X86_WINOGRAD_F43_8x8_F32,
 #elif MEGDNN_AARCH64 || MEGDNN_ARMV7
             ARM_COMMON_WINOGRAD_F23_FP16 = 1 << 8,
             ARM_COMMON_WINOGRAD_F45_FP16,
@@ -312,6 +314,17 @@ public:
         //! is_preferred.
         virtual bool is_preferred(const NCBKernSizeParam&) const { return false; }
 
+        //! whether this algo only differs from \p other in the block sizes,
+        //! the variants of an algo are registered next to each other
+        virtual bool is_block_variant_of(const AlgoBase*) const { return false; }
+
+        //! estimate the time in nanoseconds to run the algo, which is used to
+        //! choose among the block variants in the heuristic; 0 if not modelled
+        virtual float estimate_cost(
+                const NCBKernSizeParam&, const CpuCacheInfo&) const {
+            return 0.f;
+        }
+
         bool usable_attribute(
                 const NCBKernSizeParam& param,
                 AlgoSelectionStrategy algo_selection_strategy,
@@ -269,6 +269,7 @@ SmallVector<ConvolutionImpl::NCBKern> ConvolutionImpl::AlgoNaive::dispatch_kern(
 #if !MEGDNN_DISABLE_FLOAT16
     cb(dtype::Float16, DEFAULT, dtype::Float16);
     cb(dtype::Float16, FLOAT32, dtype::Float32);
+    cb(dtype::BFloat16, FLOAT32, dtype::Float32);
 #endif
 #undef cb
 
@@ -420,6 +420,8 @@ ConvolutionImpl::AlgoDataType ConvolutionImpl::NCBKernSizeParam::deduce_algo_dat
 #if !MEGDNN_DISABLE_FLOAT16
     } else if (src_type.enumv() == DTypeEnum::Float16) {
         return ConvolutionImpl::AlgoDataType::FLOAT16;
+    } else if (src_type.enumv() == DTypeEnum::BFloat16) {
+        return ConvolutionImpl::AlgoDataType::BFLOAT16;
 #endif
     } else if (
             src_type.enumv() == DTypeEnum::Int8 ||
@@ -621,62 +623,66 @@ void ConvolutionBackwardDataImpl::exec_with_ncb_kern(const NCBKernParam& param)
     p1g.filter_meta.group = 1;
     auto&& algo = get_algorithm(p1g);
     auto kptr = ncb_1g_dispatch_kern(algo, p1g);
-    if (group == 1 || static_cast<AlgoBase*>(algo)->is_naive()) {
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    if (static_cast<AlgoBase*>(algo)->is_naive()) {
         auto run = [kptr, param]() { kptr(param); };
-        static_cast<naive::HandleImpl*>(handle())->dispatch_kern(run);
-    } else {
-        megdnn_assert(
-                p1g.filter_meta.format == Param::Format::NCHW ||
-                        p1g.filter_meta.format == Param::Format::NHWC,
-                "invalid conv format");
-        auto run = [kptr, p1g_orig = p1g, group]() {
-            auto p1g = p1g_orig;
-            ptrdiff_t istrd, fstrd, ostrd;
-            fstrd = p1g.filter_meta.icpg * p1g.filter_meta.ocpg *
-                    p1g.filter_meta.spatial[0] * p1g.filter_meta.spatial[1] *
-                    p1g.filter_type.size();
-            istrd = p1g.filter_meta.ocpg * p1g.diff_type.size();
-            ostrd = p1g.filter_meta.icpg * p1g.grad_type.size();
-            p1g.diff_extra_mem_size =
-                    (group - 1) * p1g.filter_meta.ocpg * p1g.diff_type.size();
-            p1g.filter_extra_mem_size =
-                    (group - 1) * p1g.filter_meta.icpg * p1g.filter_meta.ocpg *
-                    p1g.filter_meta.spatial[0] * p1g.filter_meta.spatial[1] *
-                    p1g.filter_type.size();
-            p1g.grad_extra_mem_size =
-                    (group - 1) * p1g.filter_meta.icpg * p1g.grad_type.size();
-            if (p1g.filter_meta.format == Param::Format::NCHW) {
-                istrd *= p1g.isz[0] * p1g.isz[1];
-                ostrd *= p1g.osz[0] * p1g.osz[1];
-                p1g.diff_extra_mem_size *= p1g.isz[0] * p1g.isz[1];
-                p1g.grad_extra_mem_size *= p1g.osz[0] * p1g.osz[1];
-            } else {
-                // must be NHWC. No action performed.
-            }
-            for (size_t i = 0; i < group; ++i) {
-                kptr(p1g);
-                incr_ptr(p1g.diff_ptr, istrd);
-                incr_ptr(p1g.filter_ptr, fstrd);
-                incr_ptr(p1g.grad_ptr, ostrd);
-                p1g.diff_extra_mem_size -= istrd;
-                p1g.filter_extra_mem_size -= fstrd;
-                p1g.grad_extra_mem_size -= ostrd;
-            }
-        };
-        static_cast<naive::HandleImpl*>(handle())->dispatch_kern(run);
+        handle->dispatch_kern(run);
+        return;
     }
+    megdnn_assert(
+            p1g.filter_meta.format == Param::Format::NCHW ||
+                    p1g.filter_meta.format == Param::Format::NHWC,
+            "invalid conv format");
+    ptrdiff_t istrd, fstrd, ostrd;
+    fstrd = p1g.filter_meta.icpg * p1g.filter_meta.ocpg * p1g.filter_meta.spatial[0] *
+            p1g.filter_meta.spatial[1] * p1g.filter_type.size();
+    istrd = p1g.filter_meta.ocpg * p1g.diff_type.size();
+    ostrd = p1g.filter_meta.icpg * p1g.grad_type.size();
+    p1g.diff_extra_mem_size = (group - 1) * p1g.filter_meta.ocpg * p1g.diff_type.size();
+    p1g.filter_extra_mem_size = (group - 1) * fstrd;
+    p1g.grad_extra_mem_size = (group - 1) * p1g.filter_meta.icpg * p1g.grad_type.size();
+    if (p1g.filter_meta.format == Param::Format::NCHW) {
+        istrd *= p1g.isz[0] * p1g.isz[1];
+        ostrd *= p1g.osz[0] * p1g.osz[1];
+        p1g.diff_extra_mem_size *= p1g.isz[0] * p1g.isz[1];
+        p1g.grad_extra_mem_size *= p1g.osz[0] * p1g.osz[1];
+    } else {
+        // must be NHWC. No action performed.
+    }
+
+    // each (group, batch) pair is a task, run with the workspace of its thread
+    size_t batch = p1g.n;
+    p1g.n = 1;
+    size_t workspace_per_thread = ncb_1g_get_workspace(algo, p1g);
+    auto run = [kptr, p1g_orig = p1g, batch, istrd, fstrd, ostrd,
+                workspace_per_thread](size_t index, size_t thread_id) {
+        auto p1g = p1g_orig;
+        size_t g = index / batch, n = index % batch;
+        incr_ptr(p1g.diff_ptr, g * istrd + n * p1g.inp_bs * p1g.diff_type.size());
+        incr_ptr(p1g.filter_ptr, g * fstrd);
+        incr_ptr(p1g.grad_ptr, g * ostrd + n * p1g.out_bs * p1g.grad_type.size());
+        p1g.diff_extra_mem_size -= g * istrd;
+        p1g.filter_extra_mem_size -= g * fstrd;
+        p1g.grad_extra_mem_size -= g * ostrd;
+        incr_ptr(p1g.workspace_ptr, thread_id * workspace_per_thread);
+        p1g.workspace_size = workspace_per_thread;
+        kptr(p1g);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, group * batch, run);
 }
 
 size_t ConvolutionBackwardDataImpl::get_workspace_with_ncb(
         const NCBKernSizeParam& param) {
-    if (param.filter_meta.group != 1) {
-        auto p1g = param;
-        p1g.filter_meta.group = 1;
-        auto algo = get_algorithm(p1g);
+    auto p1g = param;
+    p1g.filter_meta.group = 1;
+    auto algo = get_algorithm(p1g);
+    if (static_cast<AlgoBase*>(algo)->is_naive()) {
         return ncb_1g_get_workspace(algo, p1g);
     }
-    auto algo = get_algorithm(param);
-    return ncb_1g_get_workspace(algo, param);
+    // a single batch is computed by each task on its thread
+    p1g.n = 1;
+    return ncb_1g_get_workspace(algo, p1g) *
+           static_cast<naive::HandleImpl*>(handle())->megcore_dispatcher()->nr_threads();
 }
 
 std::vector<ConvolutionBackwardDataImpl::Algorithm*> ConvolutionBackwardDataImpl::
@@ -818,4 +824,169 @@ const char* ConvolutionBackwardDataImpl::get_algorithm_set_name() const {
     return "FALLBACK_CONVOLUTION_BACKWARD_DATA_IMPL0";
 }
 
+/* ===================== ConvolutionBackwardFilter ===================== */
+
+namespace {
+
+using BwdFilterParam = ConvolutionBackwardFilter::Param;
+using CanonizedFilterMeta = ConvolutionBackwardFilter::CanonizedFilterMeta;
+
+//! parts of the workspace of each thread
+enum BwdFilterPart { BF_COL = 0, BF_PRODUCT, BF_PARTIAL, BF_MATMUL, BF_NR_PARTS };
+
+//! grad of a group: diff (OC, OH * OW) multiplied by transposed col
+//! (IC * FH * FW, OH * OW)
+MatrixMul* get_bwd_filter_matmul_opr() {
+    static CpuOprDelegationStorage<> storage;
+    MatrixMul::Param param;
+    param.transposeB = true;
+    return storage.get<MatrixMul>(param);
+}
+
+WorkspaceBundle get_bwd_filter_bundle(
+        const CanonizedFilterMeta& fm, const TensorLayout& diff, size_t nr_threads) {
+    size_t OC = fm.ocpg, K = fm.icpg * fm.spatial[0] * fm.spatial[1],
+           P = diff[2] * diff[3];
+    size_t matmul_workspace = get_bwd_filter_matmul_opr()->get_workspace_in_bytes(
+            {{OC, P}, dtype::Float32()}, {{K, P}, dtype::Float32()},
+            {{OC, K}, dtype::Float32()});
+    SmallVector<size_t> sizes;
+    for (size_t i = 0; i < nr_threads; ++i) {
+        sizes.push_back(K * P * sizeof(float));
+        sizes.push_back(OC * K * sizeof(float));
+        sizes.push_back(fm.group * OC * K * sizeof(float));
+        sizes.push_back(matmul_workspace);
+    }
+    return {nullptr, sizes};
+}
+
+//! unroll a group of the src image to (IC * FH * FW, OH * OW) with the padding
+void img2col_pad(
+        const float* src, float* col, size_t IC, size_t IH, size_t IW, size_t OH,
+        size_t OW, size_t FH, size_t FW, size_t SH, size_t SW, size_t PH, size_t PW) {
+    for (size_t ic = 0; ic < IC; ++ic) {
+        for (size_t fh = 0; fh < FH; ++fh) {
+            for (size_t fw = 0; fw < FW; ++fw) {
+                for (size_t oh = 0; oh < OH; ++oh) {
+                    int ih = static_cast<int>(oh * SH + fh) - static_cast<int>(PH);
+                    if (ih < 0 || ih >= static_cast<int>(IH)) {
+                        std::memset(col, 0, sizeof(float) * OW);
+                        col += OW;
+                        continue;
+                    }
+                    const float* row = src + (ic * IH + ih) * IW;
+                    for (size_t ow = 0; ow < OW; ++ow) {
+                        int iw = static_cast<int>(ow * SW + fw) - static_cast<int>(PW);
+                        *(col++) = (iw >= 0 && iw < static_cast<int>(IW)) ? row[iw]
+                                                                          : 0.f;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+size_t ConvolutionBackwardFilterImpl::nr_threads() const {
+    return static_cast<naive::HandleImpl*>(handle())->megcore_dispatcher()->nr_threads();
+}
+
+bool ConvolutionBackwardFilterImpl::is_matmul_usable(
+        const TensorLayout& src, const TensorLayout& diff,
+        const TensorLayout& grad) const {
+    if (param().format != BwdFilterParam::Format::NCHW ||
+        param().compute_mode != BwdFilterParam::ComputeMode::DEFAULT ||
+        src.dtype != dtype::Float32() || diff.dtype != dtype::Float32() ||
+        grad.dtype != dtype::Float32() || !src.is_contiguous() ||
+        !diff.is_contiguous() || !grad.is_contiguous() || src.ndim != 4) {
+        return false;
+    }
+    auto fm = make_canonized_filter_meta(src.ndim, grad);
+    return fm.spatial_ndim == 2 && !fm.should_flip && fm.dilation[0] == 1 &&
+           fm.dilation[1] == 1;
+}
+
+size_t ConvolutionBackwardFilterImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& diff, const TensorLayout& grad) {
+    if (!is_matmul_usable(src, diff, grad)) {
+        return naive::ConvolutionBackwardFilterImpl::get_workspace_in_bytes(
+                src, diff, grad);
+    }
+    auto fm = make_canonized_filter_meta(src.ndim, grad);
+    return get_bwd_filter_bundle(fm, diff, nr_threads()).total_size_in_bytes();
+}
+
+void ConvolutionBackwardFilterImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+        _megdnn_workspace workspace) {
+    if (!is_matmul_usable(src.layout, diff.layout, grad.layout)) {
+        return naive::ConvolutionBackwardFilterImpl::exec(src, diff, grad, workspace);
+    }
+    auto fm = check_exec(src.layout, diff.layout, grad.layout, workspace.size);
+    size_t N = src.layout[0], IH = src.layout[2], IW = src.layout[3],
+           OH = diff.layout[2], OW = diff.layout[3], IC = fm.icpg, OC = fm.ocpg,
+           FH = fm.spatial[0], FW = fm.spatial[1], SH = fm.stride[0],
+           SW = fm.stride[1], PH = fm.padding[0], PW = fm.padding[1],
+           group = fm.group;
+    size_t K = IC * FH * FW, P = OH * OW, grad_size = group * OC * K,
+           threads = nr_threads();
+    auto bundle = get_bwd_filter_bundle(fm, diff.layout, threads);
+    bundle.set(workspace.raw_ptr);
+    auto src_ptr = src.ptr<float>(), diff_ptr = diff.ptr<float>(),
+         grad_ptr = grad.ptr<float>();
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+
+    auto clear_partial = [bundle, grad_size](size_t thread, size_t) {
+        std::memset(
+                bundle.get(thread * BF_NR_PARTS + BF_PARTIAL), 0,
+                grad_size * sizeof(float));
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, threads, clear_partial);
+
+    auto accumulate = [=](size_t index, size_t thread_id) {
+        size_t n = index / group, g = index % group;
+        auto part = [&](size_t i) {
+            return static_cast<float*>(bundle.get(thread_id * BF_NR_PARTS + i));
+        };
+        float *col = part(BF_COL), *product = part(BF_PRODUCT),
+              *partial = part(BF_PARTIAL) + g * OC * K;
+        img2col_pad(
+                src_ptr + (n * group + g) * IC * IH * IW, col, IC, IH, IW, OH, OW, FH,
+                FW, SH, SW, PH, PW);
+        TensorND A, B, C;
+        A.layout = {{OC, P}, dtype::Float32()};
+        A.raw_ptr = const_cast<float*>(diff_ptr + (n * group + g) * OC * P);
+        B.layout = {{K, P}, dtype::Float32()};
+        B.raw_ptr = col;
+        C.layout = {{OC, K}, dtype::Float32()};
+        C.raw_ptr = product;
+        Workspace matmul_workspace(
+                static_cast<dt_byte*>(bundle.get(thread_id * BF_NR_PARTS + BF_MATMUL)),
+                bundle.get_size(thread_id * BF_NR_PARTS + BF_MATMUL));
+        get_bwd_filter_matmul_opr()->exec(A, B, C, matmul_workspace);
+        for (size_t i = 0; i < OC * K; ++i) {
+            partial[i] += product[i];
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, N * group, accumulate);
+
+    // the partial gradients are summed by segments of grad
+    size_t segment = div_ceil(grad_size, threads);
+    auto reduce = [=](size_t index, size_t) {
+        size_t begin = index * segment, end = std::min(grad_size, begin + segment);
+        auto dst = grad_ptr + begin;
+        std::memset(dst, 0, (end - begin) * sizeof(float));
+        for (size_t t = 0; t < threads; ++t) {
+            auto partial = static_cast<const float*>(
+                                   bundle.get(t * BF_NR_PARTS + BF_PARTIAL)) +
+                           begin;
+            for (size_t i = 0; i < end - begin; ++i) {
+                dst[i] += partial[i];
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, div_ceil(grad_size, segment), reduce);
+}
+
 // vim: syntax=cpp.doxygen
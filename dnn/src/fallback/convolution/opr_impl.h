@@ -495,6 +495,31 @@ public:
     static const AlgoPack& algo_pack();
 };
 
+/*!
+ * \brief ConvolutionBackwardFilter of float32 NCHW cross correlation by im2col
+ *      and matrix mul, falling back to naive for the other cases
+ *
+ * Each (batch, group) pair is a task accumulating into the partial filter
+ * gradient of its thread, and the partial gradients are summed at last.
+ */
+class ConvolutionBackwardFilterImpl : public naive::ConvolutionBackwardFilterImpl {
+public:
+    using naive::ConvolutionBackwardFilterImpl::ConvolutionBackwardFilterImpl;
+
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+            _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& diff,
+            const TensorLayout& grad) override;
+
+private:
+    bool is_matmul_usable(
+            const TensorLayout& src, const TensorLayout& diff,
+            const TensorLayout& grad) const;
+    size_t nr_threads() const;
+};
+
 }  // namespace fallback
 }  // namespace megdnn
 
@@ -0,0 +1,162 @@
+/**
+ * \file dnn/src/fallback/cpu_cache_info.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+
+#include "src/fallback/cpu_cache_info.h"
+#include "src/common/utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(MGB_ENABLE_CPUINFO_CHECK) && MGB_ENABLE_CPUINFO
+#include "cpuinfo.h"
+#endif
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! the smallest nonzero size of each level among the cores
+struct CacheSizes {
+    size_t size[4] = {0, 0, 0, 0};
+
+    void update(size_t level, size_t bytes) {
+        if (level == 0 || level > 3 || bytes == 0)
+            return;
+        if (size[level] == 0 || bytes < size[level])
+            size[level] = bytes;
+    }
+};
+
+#if defined(MGB_ENABLE_CPUINFO_CHECK) && MGB_ENABLE_CPUINFO
+bool detect_by_cpuinfo(CacheSizes& sizes) {
+    if (!cpuinfo_initialize())
+        return false;
+    for (uint32_t i = 0; i < cpuinfo_get_processors_count(); ++i) {
+        auto processor = cpuinfo_get_processor(i);
+        if (!processor)
+            continue;
+        if (processor->cache.l1d)
+            sizes.update(1, processor->cache.l1d->size);
+        if (processor->cache.l2)
+            sizes.update(2, processor->cache.l2->size);
+        if (processor->cache.l3)
+            sizes.update(3, processor->cache.l3->size);
+    }
+    return sizes.size[1] || sizes.size[2];
+}
+#endif
+
+#if defined(__linux__)
+bool read_sysfs(const char* path, char* buf, size_t len) {
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+    bool ok = fgets(buf, len, fp) != nullptr;
+    fclose(fp);
+    return ok;
+}
+
+//! parse the cache info in /sys/devices/system/cpu/cpu*/cache/index*
+bool detect_by_sysfs(CacheSizes& sizes) {
+    char path[128], buf[64];
+    for (size_t cpu = 0;; ++cpu) {
+        //! stop at the first cpu without the cache info
+        snprintf(
+                path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/cache/index0/level",
+                cpu);
+        if (!read_sysfs(path, buf, sizeof(buf)))
+            break;
+        for (size_t index = 0;; ++index) {
+            const char* prefix = "/sys/devices/system/cpu/cpu%zu/cache/index%zu/%s";
+            snprintf(path, sizeof(path), prefix, cpu, index, "level");
+            if (!read_sysfs(path, buf, sizeof(buf)))
+                break;
+            size_t level = strtoul(buf, nullptr, 10);
+            snprintf(path, sizeof(path), prefix, cpu, index, "type");
+            if (!read_sysfs(path, buf, sizeof(buf)) || buf[0] == 'I')
+                continue;
+            snprintf(path, sizeof(path), prefix, cpu, index, "size");
+            if (!read_sysfs(path, buf, sizeof(buf)))
+                continue;
+            char* end = nullptr;
+            size_t bytes = strtoul(buf, &end, 10);
+            if (*end == 'K') {
+                bytes *= 1024;
+            } else if (*end == 'M') {
+                bytes *= 1024 * 1024;
+            }
+            sizes.update(level, bytes);
+        }
+    }
+    return sizes.size[1] || sizes.size[2];
+}
+#endif
+
+CpuCacheInfo detect() {
+    CpuCacheInfo info;
+    CacheSizes sizes;
+    bool detected = false;
+#if defined(MGB_ENABLE_CPUINFO_CHECK) && MGB_ENABLE_CPUINFO
+    detected = detect_by_cpuinfo(sizes);
+#endif
+#if defined(__linux__)
+    if (!detected) {
+        sizes = {};
+        detected = detect_by_sysfs(sizes);
+    }
+#endif
+    if (detected) {
+        if (sizes.size[1])
+            info.l1d_size = sizes.size[1];
+        if (sizes.size[2])
+            info.l2_size = sizes.size[2];
+        info.l3_size = sizes.size[3];
+    }
+    return info;
+}
+
+}  // namespace
+
+const CpuCacheInfo& CpuCacheInfo::inst() {
+    static CpuCacheInfo info = detect();
+    return info;
+}
+
+float CpuCacheInfo::bandwidth_of(size_t working_set) const {
+    if (working_set <= l2_size)
+        return l2_bandwidth;
+    if (working_set <= l3_size)
+        return l3_bandwidth;
+    return dram_bandwidth;
+}
+
+float CpuCacheInfo::estimate_ns(const GemmBlocks& blocks) const {
+    float a_bytes = blocks.m * blocks.k * blocks.src_size;
+    float b_bytes = blocks.k * blocks.n * blocks.src_size;
+    float c_bytes = blocks.m * blocks.n * blocks.acc_size;
+    size_t working_set = a_bytes + b_bytes * blocks.nr_b_copies + c_bytes;
+    float bytes = a_bytes + b_bytes * blocks.nr_b_copies * 2 + c_bytes;
+    if (working_set > l2_size) {
+        size_t nr_inner_m = div_ceil(blocks.m, std::max<size_t>(blocks.inner_m, 1));
+        bytes += b_bytes * (nr_inner_m - 1);
+    }
+    float ops = 2.f * blocks.m * blocks.n * blocks.k;
+    float block_ns = ops / peak_ops + bytes / bandwidth_of(working_set) +
+                     block_overhead;
+    size_t nr_rounds =
+            div_ceil(blocks.nr_blocks, std::max<size_t>(blocks.nr_threads, 1));
+    return nr_rounds * block_ns;
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,77 @@
+/**
+ * \file dnn/src/fallback/cpu_cache_info.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#include <cstddef>
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief the sizes of the data caches of the cpu and a simple model of the
+ * time of the kernels blocked on them
+ *
+ * The sizes are detected by cpuinfo if it is enabled, or else by the sysfs on
+ * linux, and the smallest ones among the cores are taken, so the blocks
+ * chosen by them also fit the little cores of a big.LITTLE soc. The
+ * bandwidths and the throughput can not be detected, which are typical values
+ * of a mobile core.
+ */
+struct CpuCacheInfo {
+    //! in bytes, 0 if there is no such cache
+    size_t l1d_size = 32 * 1024;
+    size_t l2_size = 256 * 1024;
+    size_t l3_size = 0;
+    //! the bandwidths of a core in bytes per nanosecond
+    float l2_bandwidth = 32.f;
+    float l3_bandwidth = 16.f;
+    float dram_bandwidth = 6.f;
+    //! the arithmetic ops of a core per nanosecond
+    float peak_ops = 16.f;
+    //! the time in nanoseconds to dispatch a block to a thread
+    float block_overhead = 1000.f;
+
+    //! the sizes detected at the first call
+    static const CpuCacheInfo& inst();
+
+    //! the bandwidth of the nearest cache the working set fits in
+    float bandwidth_of(size_t working_set) const;
+
+    /*!
+     * \brief the gemm blocks dispatched to the threads, each of which is a
+     * (m, k) x (k, n) gemm with its own copies of the k x n matrix
+     *
+     * \param inner_m the block size of m in the gemm kernel, which loads the
+     *      k x n matrix once for each of them
+     * \param nr_b_copies the number of the k x n matrices written and read
+     *      in a block, like the im2col result and its packed copy
+     */
+    struct GemmBlocks {
+        size_t nr_blocks, nr_threads;
+        size_t m, n, k, inner_m;
+        size_t nr_b_copies;
+        size_t src_size, acc_size;
+    };
+
+    /*!
+     * \brief estimate the time in nanoseconds to run the blocks
+     *
+     * The compute and the memory access of a block are not assumed to
+     * overlap, and the k x n matrices are loaded again for each inner_m rows
+     * if the working set of the block does not fit in L2.
+     */
+    float estimate_ns(const GemmBlocks& blocks) const;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,179 @@
+/**
+ * \file dnn/src/fallback/cumsum/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/cumsum/opr_impl.h"
+#include "src/naive/handle.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! the axis is split into blocks only if each thread gets this many elements
+constexpr size_t MIN_BLOCK_SIZE = 4096;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+//! number of blocks along the axis; 1 means parallel over A only
+size_t get_nr_block(size_t A, size_t B, size_t C, size_t nr_threads) {
+    if (nr_threads > 1 && A < nr_threads && B >= nr_threads * 4 &&
+        B * C >= MIN_BLOCK_SIZE * nr_threads) {
+        return nr_threads;
+    }
+    return 1;
+}
+
+/*!
+ * \brief cumsum of a (B, C) slab along B; each step adds a whole row of C
+ *      contiguous elements, which can be vectorized by the compiler
+ */
+template <typename T>
+void scan(
+        const T* __restrict src, T* __restrict dst, size_t B, size_t C, bool exclusive,
+        bool reverse) {
+    for (size_t i = 0; i < B; ++i) {
+        size_t b = reverse ? B - 1 - i : i;
+        T* __restrict cur = dst + b * C;
+        if (!i) {
+            for (size_t c = 0; c < C; ++c) {
+                cur[c] = exclusive ? T(0) : src[b * C + c];
+            }
+            continue;
+        }
+        size_t prev = reverse ? b + 1 : b - 1;
+        const T* __restrict last = dst + prev * C;
+        const T* __restrict add = src + (exclusive ? prev : b) * C;
+        for (size_t c = 0; c < C; ++c) {
+            cur[c] = last[c] + add[c];
+        }
+    }
+}
+
+/*!
+ * The axis is split into \p nr_block blocks. Each block is scanned locally,
+ * then the sum of preceding blocks is added to it.
+ */
+template <typename T>
+void exec_internal(
+        naive::HandleImpl* handle, const T* src, T* dst, size_t A, size_t B,
+        size_t C, size_t nr_block, bool exclusive, bool reverse, T* workspace) {
+    if (nr_block == 1) {
+        auto kern = [=](size_t a, size_t) {
+            scan(src + a * B * C, dst + a * B * C, B, C, exclusive, reverse);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, A, kern);
+        return;
+    }
+
+    size_t block = div_ceil(B, nr_block);
+    nr_block = div_ceil(B, block);
+    auto block_range = [=](size_t t, size_t& begin, size_t& size) {
+        begin = t * block;
+        size = std::min(B, begin + block) - begin;
+    };
+    auto local_scan = [=](size_t index, size_t) {
+        size_t a = index / nr_block, begin, size;
+        block_range(index % nr_block, begin, size);
+        size_t offset = (a * B + begin) * C;
+        scan(src + offset, dst + offset, size, C, exclusive, reverse);
+    };
+    // workspace[a][t] is the sum of blocks preceding block t in the scanning
+    // order
+    auto compute_offset = [=]() {
+        for (size_t a = 0; a < A; ++a) {
+            T* sum = workspace + a * nr_block * C;
+            T* prev_sum = nullptr;
+            size_t prev_last = 0;
+            for (size_t i = 0; i < nr_block; ++i) {
+                size_t t = reverse ? nr_block - 1 - i : i, begin, size;
+                block_range(t, begin, size);
+                T* cur = sum + t * C;
+                if (!prev_sum) {
+                    for (size_t c = 0; c < C; ++c) {
+                        cur[c] = T(0);
+                    }
+                } else {
+                    // total of the previous block is its last local result
+                    // (plus its last input for exclusive cumsum)
+                    size_t offset = (a * B + prev_last) * C;
+                    for (size_t c = 0; c < C; ++c) {
+                        cur[c] = prev_sum[c] + dst[offset + c];
+                    }
+                    if (exclusive) {
+                        for (size_t c = 0; c < C; ++c) {
+                            cur[c] += src[offset + c];
+                        }
+                    }
+                }
+                prev_sum = cur;
+                prev_last = reverse ? begin : begin + size - 1;
+            }
+        }
+    };
+    auto add_offset = [=](size_t index, size_t) {
+        size_t a = index / nr_block, t = index % nr_block, begin, size;
+        if (t == (reverse ? nr_block - 1 : 0)) {
+            return;
+        }
+        block_range(t, begin, size);
+        const T* __restrict sum = workspace + index * C;
+        for (size_t b = begin; b < begin + size; ++b) {
+            T* __restrict cur = dst + (a * B + b) * C;
+            for (size_t c = 0; c < C; ++c) {
+                cur[c] += sum[c];
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, A * nr_block, local_scan);
+    MEGDNN_DISPATCH_CPU_KERN(handle, compute_offset());
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, A * nr_block, add_offset);
+}
+
+}  // anonymous namespace
+
+void CumsumForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, param().axis);
+    size_t nr_block = get_nr_block(A, B, C, get_nr_threads(handle()));
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+#define cb(DType)                                                    \
+    if (src.layout.dtype == DType()) {                               \
+        using ctype = DTypeTrait<DType>::ctype;                      \
+        exec_internal<ctype>(                                        \
+                handle, src.ptr<ctype>(), dst.ptr<ctype>(), A, B, C, \
+                nr_block, param().exclusive, param().reverse,        \
+                workspace.ptr<ctype>());                             \
+        return;                                                      \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+size_t CumsumForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout&) {
+    size_t A, B, C;
+    reduce::get_ABC(src, A, B, C, param().axis);
+    size_t nr_block = get_nr_block(A, B, C, get_nr_threads(handle()));
+    if (nr_block == 1) {
+        return 0;
+    }
+    return A * nr_block * C * src.dtype.size();
+}
+
+// vim: syntax=cpp.doxygen
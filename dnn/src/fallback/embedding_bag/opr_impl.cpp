@@ -0,0 +1,166 @@
+/**
+ * \file dnn/src/fallback/embedding_bag/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/fallback/embedding_bag/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using Mode = param::EmbeddingBag::Mode;
+
+//! number of lookups whose rows are prefetched ahead
+constexpr size_t PREFETCH_DIST = 8;
+//! at most so many cache lines of a row are prefetched
+constexpr size_t PREFETCH_MAX_LINES = 8;
+constexpr size_t CACHE_LINE = 64;
+
+struct Shape {
+    size_t N, D, L, B, row_bytes;
+};
+
+MEGDNN_FORCE_INLINE void prefetch_row(const uint8_t* row, size_t nr_lines) {
+#if defined(__GNUC__) || defined(__clang__)
+    for (size_t i = 0; i < nr_lines; ++i) {
+        __builtin_prefetch(row + i * CACHE_LINE, 0, 0);
+    }
+#else
+    MEGDNN_MARK_USED_VAR(row);
+    MEGDNN_MARK_USED_VAR(nr_lines);
+#endif
+}
+
+//! acc += row, and return the bias of the row to be added afterwards
+template <typename T>
+struct RowAdder {
+    static MEGDNN_FORCE_INLINE float add(
+            const uint8_t* row, float* __restrict acc, size_t D) {
+        auto src = reinterpret_cast<const T*>(row);
+        for (size_t d = 0; d < D; ++d) {
+            acc[d] += static_cast<float>(src[d]);
+        }
+        return 0.f;
+    }
+};
+
+template <>
+struct RowAdder<dt_uint8> {
+    static MEGDNN_FORCE_INLINE float add(
+            const uint8_t* row, float* __restrict acc, size_t D) {
+        float scale, bias;
+        memcpy(&scale, row + D, sizeof(float));
+        memcpy(&bias, row + D + sizeof(float), sizeof(float));
+        auto src = reinterpret_cast<const dt_uint8*>(row);
+        for (size_t d = 0; d < D; ++d) {
+            acc[d] += scale * static_cast<float>(src[d]);
+        }
+        return bias;
+    }
+};
+
+//! compute the bags in [bag_begin, bag_end)
+template <typename T>
+void forward_bags(
+        const uint8_t* weight, const dt_int32* indices, const dt_int32* offsets,
+        float* dst, size_t bag_begin, size_t bag_end, const Shape& shp, Mode mode) {
+    auto bag_bound = [&](size_t b) -> size_t {
+        return b < shp.B ? offsets[b] : shp.L;
+    };
+    size_t nr_lines = std::min(
+            (shp.row_bytes + CACHE_LINE - 1) / CACHE_LINE, PREFETCH_MAX_LINES);
+    size_t idx_begin = bag_bound(bag_begin), idx_end = bag_bound(bag_end);
+    megdnn_assert(
+            offsets[bag_begin] >= 0 && idx_begin <= idx_end && idx_end <= shp.L,
+            "invalid offsets of bags [%zu, %zu)", bag_begin, bag_end);
+    auto row_of = [&](size_t j) {
+        auto idx = static_cast<size_t>(static_cast<uint32_t>(indices[j]));
+        megdnn_assert(
+                idx < shp.N, "index %d out of range of %zu rows", indices[j], shp.N);
+        return weight + idx * shp.row_bytes;
+    };
+    for (size_t j = idx_begin; j < std::min(idx_begin + PREFETCH_DIST, idx_end); ++j) {
+        prefetch_row(row_of(j), nr_lines);
+    }
+    for (size_t b = bag_begin; b < bag_end; ++b) {
+        size_t begin = bag_bound(b), end = bag_bound(b + 1);
+        megdnn_assert(begin <= end, "offsets should be non-decreasing");
+        float* acc = dst + b * shp.D;
+        std::fill(acc, acc + shp.D, 0.f);
+        float bias = 0.f;
+        for (size_t j = begin; j < end; ++j) {
+            if (j + PREFETCH_DIST < idx_end) {
+                prefetch_row(row_of(j + PREFETCH_DIST), nr_lines);
+            }
+            bias += RowAdder<T>::add(row_of(j), acc, shp.D);
+        }
+        float k = mode == Mode::MEAN && end > begin
+                        ? 1.f / static_cast<float>(end - begin)
+                        : 1.f;
+        for (size_t d = 0; d < shp.D; ++d) {
+            acc[d] = (acc[d] + bias) * k;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+void EmbeddingBagForwardImpl::exec(
+        _megdnn_tensor_in weight, _megdnn_tensor_in indices, _megdnn_tensor_in offsets,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(
+            weight.layout, indices.layout, offsets.layout, dst.layout, workspace.size);
+    Shape shp;
+    shp.N = weight.layout[0];
+    shp.D = dst.layout[1];
+    shp.L = indices.layout[0];
+    shp.B = offsets.layout[0];
+    shp.row_bytes = weight.layout.stride[0] * weight.layout.dtype.size();
+    if (!shp.B || !shp.D) {
+        return;
+    }
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    // a few tasks per thread to balance the bags of different sizes
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t nr_tasks = std::min(shp.B, nr_threads > 1 ? nr_threads * 4 : 1);
+    size_t bags_per_task = (shp.B + nr_tasks - 1) / nr_tasks;
+    nr_tasks = (shp.B + bags_per_task - 1) / bags_per_task;
+    auto wptr = static_cast<const uint8_t*>(weight.raw_ptr);
+    auto iptr = indices.ptr<dt_int32>(), optr = offsets.ptr<dt_int32>();
+    auto dptr = dst.ptr<dt_float32>();
+    auto mode = param().mode;
+    auto dispatch = [&](auto forward) {
+        auto kern = [=](size_t task, size_t) {
+            size_t bag_begin = task * bags_per_task,
+                   bag_end = std::min(bag_begin + bags_per_task, shp.B);
+            forward(wptr, iptr, optr, dptr, bag_begin, bag_end, shp, mode);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_tasks, kern);
+    };
+    auto dtype = weight.layout.dtype;
+    if (dtype == dtype::Float32()) {
+        return dispatch(forward_bags<dt_float32>);
+    }
+#if !MEGDNN_DISABLE_FLOAT16
+    if (dtype == dtype::Float16()) {
+        return dispatch(forward_bags<dt_float16>);
+    }
+#endif
+    megdnn_assert(dtype == dtype::Uint8());
+    dispatch(forward_bags<dt_uint8>);
+}
+
+// vim: syntax=cpp.doxygen
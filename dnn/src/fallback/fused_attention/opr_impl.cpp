@@ -0,0 +1,165 @@
+/**
+ * \file dnn/src/fallback/fused_attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/fused_attention/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+constexpr size_t BR = FusedAttentionForwardImpl::BLOCK_ROWS,
+                 BC = FusedAttentionForwardImpl::BLOCK_COLS;
+
+//! number of independent accumulators of a dot product
+constexpr size_t NR_LANE = 8;
+
+MEGDNN_FORCE_INLINE float dot(const float* a, const float* b, size_t len) {
+    float acc[NR_LANE] = {0.f};
+    size_t i = 0;
+    for (; i + NR_LANE <= len; i += NR_LANE) {
+        for (size_t k = 0; k < NR_LANE; ++k) {
+            acc[k] += a[i + k] * b[i + k];
+        }
+    }
+    float sum = 0.f;
+    for (; i < len; ++i) {
+        sum += a[i] * b[i];
+    }
+    for (size_t k = 0; k < NR_LANE; ++k) {
+        sum += acc[k];
+    }
+    return sum;
+}
+
+//! y += a * x
+MEGDNN_FORCE_INLINE void axpy(
+        float a, const float* __restrict x, float* __restrict y, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+struct Shape {
+    size_t S, T, D, Dv;
+    float scale;
+};
+
+/*!
+ * \brief attention of query rows [row, row + nr_row) of a batch
+ *
+ * \param q, k, v, dst pointers of the batch
+ * \param ws thread workspace holding a BR x BC tile of scores, the running
+ *      max and sum of each row and the BR x Dv unnormalized output
+ */
+void attention_rows(
+        const float* q, const float* k, const float* v, float* dst, float* ws,
+        size_t row, size_t nr_row, const Shape& shp) {
+    float *score = ws, *max_val = score + BR * BC, *sum = max_val + BR,
+          *acc = sum + BR;
+    std::fill(max_val, max_val + nr_row, -INFINITY);
+    std::fill(sum, sum + nr_row, 0.f);
+    std::fill(acc, acc + nr_row * shp.Dv, 0.f);
+    q += row * shp.D;
+    for (size_t col = 0; col < shp.T; col += BC) {
+        size_t nr_col = std::min(BC, shp.T - col);
+        const float *kt = k + col * shp.D, *vt = v + col * shp.Dv;
+        for (size_t r = 0; r < nr_row; ++r) {
+            float* sr = score + r * BC;
+            float tile_max = -INFINITY;
+            for (size_t c = 0; c < nr_col; ++c) {
+                sr[c] = dot(q + r * shp.D, kt + c * shp.D, shp.D) * shp.scale;
+                tile_max = std::max(tile_max, sr[c]);
+            }
+            // rescale the partial result computed with the previous max
+            float new_max = std::max(max_val[r], tile_max),
+                  correction = std::exp(max_val[r] - new_max), tile_sum = 0.f;
+            max_val[r] = new_max;
+            float* ar = acc + r * shp.Dv;
+            if (correction != 1.f) {
+                for (size_t i = 0; i < shp.Dv; ++i) {
+                    ar[i] *= correction;
+                }
+            }
+            for (size_t c = 0; c < nr_col; ++c) {
+                float p = std::exp(sr[c] - new_max);
+                tile_sum += p;
+                axpy(p, vt + c * shp.Dv, ar, shp.Dv);
+            }
+            sum[r] = sum[r] * correction + tile_sum;
+        }
+    }
+    dst += row * shp.Dv;
+    for (size_t r = 0; r < nr_row; ++r) {
+        float inv = 1.f / sum[r];
+        for (size_t i = 0; i < shp.Dv; ++i) {
+            dst[r * shp.Dv + i] = acc[r * shp.Dv + i] * inv;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+size_t FusedAttentionForwardImpl::get_thread_workspace_size(size_t Dv) {
+    return BR * BC + 2 * BR + BR * Dv;
+}
+
+size_t FusedAttentionForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& query, const TensorLayout& key, const TensorLayout& value,
+        const TensorLayout& dst) {
+    if (query.dtype != dtype::Float32()) {
+        return naive::FusedAttentionForwardImpl::get_workspace_in_bytes(
+                query, key, value, dst);
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    return nr_threads * get_thread_workspace_size(value[2]) * sizeof(float);
+}
+
+void FusedAttentionForwardImpl::exec(
+        _megdnn_tensor_in query, _megdnn_tensor_in key, _megdnn_tensor_in value,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    if (query.layout.dtype != dtype::Float32()) {
+        return naive::FusedAttentionForwardImpl::exec(
+                query, key, value, dst, workspace);
+    }
+    check_exec(query.layout, key.layout, value.layout, dst.layout, workspace.size);
+    size_t B = query.layout[0];
+    Shape shp{query.layout[1], key.layout[1], query.layout[2], value.layout[2],
+              param().scale};
+    if (!B || !shp.S) {
+        return;
+    }
+    megdnn_assert(shp.T, "attention over empty keys");
+    const float *qptr = query.ptr<dt_float32>(), *kptr = key.ptr<dt_float32>(),
+                *vptr = value.ptr<dt_float32>();
+    float *dptr = dst.ptr<dt_float32>(), *wsptr = workspace.ptr<dt_float32>();
+    size_t nr_row_block = div_ceil(shp.S, BR),
+           thread_ws_size = get_thread_workspace_size(shp.Dv);
+    auto kern = [=](size_t task, size_t thread_id) {
+        size_t b = task / nr_row_block, row = task % nr_row_block * BR;
+        attention_rows(
+                qptr + b * shp.S * shp.D, kptr + b * shp.T * shp.D,
+                vptr + b * shp.T * shp.Dv, dptr + b * shp.S * shp.Dv,
+                wsptr + thread_id * thread_ws_size, row, std::min(BR, shp.S - row),
+                shp);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            static_cast<naive::HandleImpl*>(handle()), B * nr_row_block, kern);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,48 @@
+/**
+ * \file dnn/src/fallback/fused_attention/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/fused_attention/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief float32 attention computed on tiles of query rows and keys with an
+ *      online softmax, so only a tile of scores is kept per thread
+ *
+ * Tasks of BLOCK_ROWS query rows of a batch are computed in parallel.
+ */
+class FusedAttentionForwardImpl : public naive::FusedAttentionForwardImpl {
+public:
+    using naive::FusedAttentionForwardImpl::FusedAttentionForwardImpl;
+    void exec(
+            _megdnn_tensor_in query, _megdnn_tensor_in key, _megdnn_tensor_in value,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& query, const TensorLayout& key,
+            const TensorLayout& value, const TensorLayout& dst) override;
+
+    //! number of query rows of a tile
+    static constexpr size_t BLOCK_ROWS = 16;
+    //! number of keys of a tile
+    static constexpr size_t BLOCK_COLS = 64;
+
+private:
+    //! number of floats in the workspace of a thread
+    static size_t get_thread_workspace_size(size_t Dv);
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
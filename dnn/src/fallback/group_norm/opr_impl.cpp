@@ -0,0 +1,169 @@
+/**
+ * \file dnn/src/fallback/group_norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/group_norm/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/fallback/norm_helper.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+/*!
+ * \brief shape of group norm: N * G groups of cpg channels with S elements
+ *
+ * The elements of a group are contiguous in NCHW layout.
+ */
+struct Shape {
+    size_t N, C, G, cpg, S;
+
+    Shape(const TensorLayout& data, size_t group)
+            : N{data.shape[0]}, C{data.shape[1]}, G{group}, cpg{C / group} {
+        size_t NC = N * C;
+        S = NC ? data.total_nr_elems() / NC : 0;
+    }
+
+    size_t group_size() const { return cpg * S; }
+};
+
+void fwd_groups(
+        const float* x, const float* w, const float* b, float* y, float* mean,
+        float* rstd, size_t begin, size_t end, const Shape& shp, float eps) {
+    size_t len = shp.group_size();
+    for (size_t r = begin; r < end; ++r) {
+        const float* xr = x + r * len;
+        float* yr = y + r * len;
+        float m, rs;
+        norm::row_stats(xr, len, eps, m, rs);
+        mean[r] = m;
+        rstd[r] = rs;
+        if (!w) {
+            norm::scale_shift(xr, yr, len, rs, -m * rs);
+            continue;
+        }
+        size_t c0 = r % shp.G * shp.cpg;
+        for (size_t c = 0; c < shp.cpg; ++c) {
+            float scale = rs * w[c0 + c], shift = b[c0 + c] - m * scale;
+            norm::scale_shift(xr + c * shp.S, yr + c * shp.S, shp.S, scale, shift);
+        }
+    }
+}
+
+void bwd_data_groups(
+        const float* dy, const float* x, const float* w, const float* mean,
+        const float* rstd, float* dx, size_t begin, size_t end, const Shape& shp) {
+    size_t len = shp.group_size();
+    for (size_t r = begin; r < end; ++r) {
+        const float *dyr = dy + r * len, *xr = x + r * len;
+        float* dxr = dx + r * len;
+        float m = mean[r], rs = rstd[r];
+        size_t c0 = r % shp.G * shp.cpg;
+        float sum_g = 0.f, sum_gx = 0.f;
+        for (size_t c = 0; c < shp.cpg; ++c) {
+            const float *dyc = dyr + c * shp.S, *xc = xr + c * shp.S;
+            float wc = w ? w[c0 + c] : 1.f;
+            sum_g += wc * norm::lane_sum(shp.S, [=](size_t i) { return dyc[i]; });
+            sum_gx += wc * norm::lane_sum(shp.S, [=](size_t i) {
+                          return dyc[i] * (xc[i] - m);
+                      });
+        }
+        float coef = rs * rs * rs * sum_gx / len, shift = rs * sum_g / len;
+        for (size_t c = 0; c < shp.cpg; ++c) {
+            float wc = w ? w[c0 + c] : 1.f;
+            norm::bwd_data(
+                    dyr + c * shp.S, xr + c * shp.S, dxr + c * shp.S, shp.S, rs * wc,
+                    m, coef, shift);
+        }
+    }
+}
+
+//! dweight and dbias of the \p c-th channel
+void bwd_param_channel(
+        const float* dy, const float* x, const float* mean, const float* rstd,
+        float* dw, float* db, size_t c, const Shape& shp) {
+    float sum_w = 0.f, sum_b = 0.f;
+    for (size_t n = 0; n < shp.N; ++n) {
+        size_t off = (n * shp.C + c) * shp.S, r = n * shp.G + c / shp.cpg;
+        const float *dyc = dy + off, *xc = x + off;
+        float m = mean[r];
+        sum_w += rstd[r] * norm::lane_sum(shp.S, [=](size_t i) {
+                     return dyc[i] * (xc[i] - m);
+                 });
+        sum_b += norm::lane_sum(shp.S, [=](size_t i) { return dyc[i]; });
+    }
+    dw[c] = sum_w;
+    db[c] = sum_b;
+}
+
+}  // anonymous namespace
+
+void GroupNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+        _megdnn_workspace workspace) {
+    if (data.layout.dtype != dtype::Float32()) {
+        return naive::GroupNormForwardImpl::exec(
+                data, weight, bias, dst, mean, rstd, workspace);
+    }
+    check_exec(
+            data.layout, weight.layout, bias.layout, dst.layout, mean.layout,
+            rstd.layout, workspace.size);
+    auto p = param();
+    Shape shp{data.layout, p.group};
+    float eps = p.eps;
+    const float* xptr = data.ptr<dt_float32>();
+    const float* wptr = p.affine ? weight.ptr<dt_float32>() : nullptr;
+    const float* bptr = p.affine ? bias.ptr<dt_float32>() : nullptr;
+    float *yptr = dst.ptr<dt_float32>(), *mptr = mean.ptr<dt_float32>(),
+          *rptr = rstd.ptr<dt_float32>();
+    norm::dispatch_rows(
+            static_cast<naive::HandleImpl*>(handle()), shp.N * shp.G,
+            shp.group_size(), [=](size_t begin, size_t end) {
+                fwd_groups(xptr, wptr, bptr, yptr, mptr, rptr, begin, end, shp, eps);
+            });
+}
+
+void GroupNormBackwardImpl::exec(
+        _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+        _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+        _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+        _megdnn_workspace workspace) {
+    if (data.layout.dtype != dtype::Float32()) {
+        return naive::GroupNormBackwardImpl::exec(
+                diff, data, weight, mean, rstd, ddata, dweight, dbias, workspace);
+    }
+    check_exec(
+            diff.layout, data.layout, weight.layout, mean.layout, rstd.layout,
+            ddata.layout, dweight.layout, dbias.layout, workspace.size);
+    auto p = param();
+    Shape shp{data.layout, p.group};
+    const float *dyptr = diff.ptr<dt_float32>(), *xptr = data.ptr<dt_float32>(),
+                *mptr = mean.ptr<dt_float32>(), *rptr = rstd.ptr<dt_float32>();
+    const float* wptr = p.affine ? weight.ptr<dt_float32>() : nullptr;
+    float* dxptr = ddata.ptr<dt_float32>();
+    auto nhandle = static_cast<naive::HandleImpl*>(handle());
+    norm::dispatch_rows(
+            nhandle, shp.N * shp.G, shp.group_size(), [=](size_t begin, size_t end) {
+                bwd_data_groups(dyptr, xptr, wptr, mptr, rptr, dxptr, begin, end, shp);
+            });
+    if (!p.affine || !shp.C) {
+        return;
+    }
+    float *dwptr = dweight.ptr<dt_float32>(), *dbptr = dbias.ptr<dt_float32>();
+    auto kern = [=](size_t c, size_t) {
+        bwd_param_channel(dyptr, xptr, mptr, rptr, dwptr, dbptr, c, shp);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(nhandle, shp.C, kern);
+}
+
+// vim: syntax=cpp.doxygen
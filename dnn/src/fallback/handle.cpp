@@ -13,29 +13,48 @@
 #include "src/common/handle_impl.h"
 
 #include "src/fallback/add_update/opr_impl.h"
+#include "src/fallback/argsort/opr_impl.h"
+#include "src/fallback/batch_normalization/opr_impl.h"
 #include "src/fallback/batched_matrix_mul/opr_impl.h"
+#include "src/fallback/block_sparse_matrix_mul/opr_impl.h"
 #include "src/fallback/concat/opr_impl.h"
+#include "src/fallback/cond_take/opr_impl.h"
 #include "src/fallback/conv_bias/opr_impl.h"
 #include "src/fallback/convolution/opr_impl.h"
+#include "src/fallback/cumsum/opr_impl.h"
 #include "src/fallback/elemwise/opr_impl.h"
 #include "src/fallback/elemwise_multi_type/opr_impl.h"
+#include "src/fallback/embedding_bag/opr_impl.h"
 #include "src/fallback/flip/opr_impl.h"
+#include "src/fallback/fused_attention/opr_impl.h"
 #include "src/fallback/gaussian_blur/opr_impl.h"
 #include "src/fallback/group_local/opr_impl.h"
+#include "src/fallback/group_norm/opr_impl.h"
+#include "src/fallback/image_preprocess/opr_impl.h"
+#include "src/fallback/indexing_multi_axis_vec/opr_impl.h"
+#include "src/fallback/indexing_one_hot/opr_impl.h"
+#include "src/fallback/layer_norm/opr_impl.h"
 #include "src/fallback/mask_conv/opr_impl.h"
 #include "src/fallback/matrix_mul/opr_impl.h"
 #include "src/fallback/pooling/opr_impl.h"
 #include "src/fallback/powc/opr_impl.h"
 #include "src/fallback/reduce/opr_impl.h"
 #include "src/fallback/relayout/opr_impl.h"
+#include "src/fallback/remap/opr_impl.h"
 #include "src/fallback/repeat/opr_impl.h"
 #include "src/fallback/resize/opr_impl.h"
+#include "src/fallback/rng/opr_impl.h"
+#include "src/fallback/roi_align/opr_impl.h"
 #include "src/fallback/roi_copy/opr_impl.h"
+#include "src/fallback/roi_pooling/opr_impl.h"
 #include "src/fallback/rotate/opr_impl.h"
+#include "src/fallback/softmax/opr_impl.h"
 #include "src/fallback/split/opr_impl.h"
 #include "src/fallback/tile/opr_impl.h"
+#include "src/fallback/topk/opr_impl.h"
 #include "src/fallback/type_cvt/opr_impl.h"
 #include "src/fallback/warp_perspective/opr_impl.h"
+#include "src/fallback/weight_quant_matrix_mul/opr_impl.h"
 
 namespace megdnn {
 namespace fallback {
@@ -47,6 +66,7 @@ std::unique_ptr<Opr> HandleImpl::create_operator() {
 
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Convolution)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardData)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardFilter)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Elemwise)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Pooling)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Reduce)
@@ -67,9 +87,36 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(ElemwiseMultiType)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(AddUpdate)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(MaskConvForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Resize)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ImagePreprocessForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(Remap)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedMatrixMulForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BNForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BNBackward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BlockSparseMatrixMulForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(WeightQuantMatrixMulForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(PowC)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(TopK)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ArgsortForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(CumsumForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingSetMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingIncrMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingOneHotForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingSetOneHotForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(EmbeddingBagForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(CondTake)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxBackward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(UniformRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GaussianRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ROIAlignForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ROIPoolingForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LayerNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LayerNormBackward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GroupNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GroupNormBackward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(FusedAttentionForward)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -0,0 +1,171 @@
+/**
+ * \file dnn/src/fallback/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/image_preprocess/opr_impl.h"
+#include "src/common/image_preprocess.cuh"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+using namespace image_preprocess;
+
+namespace {
+
+using Param = param::ImagePreprocess;
+
+//! horizontal source coords of an output column
+struct ColCoord {
+    int iw0, iw1;
+    float aw1;
+};
+
+struct KernParam {
+    const uint8_t* src;
+    const float *scale, *bias;
+    float* dst;
+    const ColCoord* col;
+    size_t src_size;
+    int IH, IW, OH, OW;
+    //! strides of dst of an image, a row, a pixel and a channel
+    size_t image_stride, row_stride, pixel_stride, channel_stride;
+    bool pad_channel;
+};
+
+//! compute output row oh of image n; mode is a template argument so the color
+//! conversion is specialized in the inner loop
+template <uint32_t mode, bool linear>
+void kern_row(const KernParam& p, size_t n, int oh) {
+    const uint8_t* sptr = p.src + n * p.src_size;
+    float* dptr = p.dst + n * p.image_stride + oh * p.row_stride;
+    float scale_h = static_cast<float>(p.OH) / p.IH;
+    int ih0, ih1;
+    float ah1 = 0;
+    if (linear) {
+        get_linear_coord(scale_h, p.IH, oh, ih0, ih1, ah1);
+    } else {
+        ih0 = ih1 = get_nearest_coord(scale_h, p.IH, oh);
+    }
+    float ah0 = 1 - ah1;
+    float scale[3] = {p.scale[0], p.scale[1], p.scale[2]},
+          bias[3] = {p.bias[0], p.bias[1], p.bias[2]};
+    for (int ow = 0; ow < p.OW; ++ow, dptr += p.pixel_stride) {
+        auto&& col = p.col[ow];
+        float value[3];
+        if (linear) {
+            float aw1 = col.aw1, aw0 = 1 - aw1;
+            int p00[3], p01[3], p10[3], p11[3];
+            load_pixel(sptr, p.IH, p.IW, ih0, col.iw0, mode, p00);
+            load_pixel(sptr, p.IH, p.IW, ih0, col.iw1, mode, p01);
+            load_pixel(sptr, p.IH, p.IW, ih1, col.iw0, mode, p10);
+            load_pixel(sptr, p.IH, p.IW, ih1, col.iw1, mode, p11);
+            for (int c = 0; c < 3; ++c) {
+                value[c] = p00[c] * ah0 * aw0 + p01[c] * ah0 * aw1 +
+                           p10[c] * ah1 * aw0 + p11[c] * ah1 * aw1;
+            }
+        } else {
+            int p00[3];
+            load_pixel(sptr, p.IH, p.IW, ih0, col.iw0, mode, p00);
+            for (int c = 0; c < 3; ++c) {
+                value[c] = p00[c];
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            dptr[c * p.channel_stride] = value[c] * scale[c] + bias[c];
+        }
+        if (p.pad_channel) {
+            dptr[3] = 0.f;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+size_t ImagePreprocessForwardImpl::get_workspace_in_bytes(
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout& dst) {
+    size_t OW = dst[param().format == Param::Format::NHWC ? 2 : 3];
+    return OW * sizeof(ColCoord);
+}
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, scale.layout, bias.layout, dst.layout, workspace.size);
+    auto mode = static_cast<uint32_t>(param().mode);
+    auto format = param().format;
+    bool yuv = mode != Mode::RGB && mode != Mode::RGB2BGR;
+    bool nhwc = format == Param::Format::NHWC;
+
+    KernParam p;
+    p.src = src.ptr<dt_uint8>();
+    p.scale = scale.ptr<dt_float32>();
+    p.bias = bias.ptr<dt_float32>();
+    p.dst = dst.ptr<dt_float32>();
+    p.IH = yuv ? src.layout[1] / 3 * 2 : src.layout[1];
+    p.IW = src.layout[2];
+    p.OH = dst.layout[nhwc ? 1 : 2];
+    p.OW = dst.layout[nhwc ? 2 : 3];
+    p.src_size = src.layout.stride[0];
+    if (format == Param::Format::NCHW) {
+        p.row_stride = p.OW;
+        p.pixel_stride = 1;
+        p.channel_stride = p.OH * p.OW;
+    } else {
+        p.pixel_stride = nhwc ? 3 : 4;
+        p.row_stride = p.OW * p.pixel_stride;
+        p.channel_stride = 1;
+    }
+    p.image_stride = dst.layout.stride[0];
+    p.pad_channel = format == Param::Format::NCHW44;
+    bool linear = param().imode == Param::InterpolationMode::LINEAR;
+
+    auto col = workspace.ptr<ColCoord>();
+    p.col = col;
+    auto init_col = [col, linear, IW = p.IW, OW = p.OW]() {
+        float scale_w = static_cast<float>(OW) / IW;
+        for (int ow = 0; ow < OW; ++ow) {
+            auto&& c = col[ow];
+            if (linear) {
+                get_linear_coord(scale_w, IW, ow, c.iw0, c.iw1, c.aw1);
+            } else {
+                c.iw0 = c.iw1 = get_nearest_coord(scale_w, IW, ow);
+                c.aw1 = 0;
+            }
+        }
+    };
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    MEGDNN_DISPATCH_CPU_KERN(handle, init_col());
+
+    size_t nr_task = src.layout[0] * p.OH;
+    switch (mode) {
+#define cb(_mode)                                                         \
+    case Mode::_mode: {                                                   \
+        auto kern = [p, linear](size_t task, size_t) {                    \
+            size_t n = task / p.OH;                                       \
+            int oh = task % p.OH;                                         \
+            if (linear) {                                                 \
+                kern_row<Mode::_mode, true>(p, n, oh);                    \
+            } else {                                                      \
+                kern_row<Mode::_mode, false>(p, n, oh);                   \
+            }                                                             \
+        };                                                                \
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, kern);     \
+        return;                                                           \
+    }
+        cb(RGB) cb(RGB2BGR) cb(YUV2RGB_NV21) cb(YUV2BGR_NV21) cb(YUV2RGB_NV12)
+                cb(YUV2BGR_NV12)
+#undef cb
+        default:
+            megdnn_throw("unsupported image preprocess mode");
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,39 @@
+/**
+ * \file dnn/src/fallback/image_preprocess/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/naive/image_preprocess/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief image preprocess computed row by row in parallel
+ *
+ * The horizontal source coords are computed once into the workspace, and each
+ * task converts the color of the source pixels it samples for an output row,
+ * so no intermediate image is written.
+ */
+class ImagePreprocessForwardImpl : public naive::ImagePreprocessForwardImpl {
+public:
+    using naive::ImagePreprocessForwardImpl::ImagePreprocessForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,286 @@
+/**
+ * \file dnn/src/fallback/indexing_multi_axis_vec/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/fallback/indexing_multi_axis_vec/opr_impl.h"
+#include "src/naive/handle.h"
+
+#include "src/common/indexing_multi_axis_vec_kdef.h"
+#include "src/common/utils.h"
+
+#include <cstring>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! number of elements to be processed by each task
+constexpr size_t MIN_TASK_SIZE = 4096;
+//! minimal number of columns of a row processed by the same thread
+constexpr size_t MIN_COL_BLOCK = 64;
+//! rows are prefetched this many indices ahead
+constexpr size_t PREFETCH_DIST = 4;
+
+/*!
+ * \brief value viewed as (nr_outer, nr_idx, row_size), where the rows are
+ *      contiguous in both data and value
+ */
+struct RowLayout {
+    size_t nr_outer, nr_idx, row_size, outer_ndim;
+    size_t outer_shape[TensorLayout::MAX_NDIM];
+    ptrdiff_t outer_stride[TensorLayout::MAX_NDIM];
+
+    //! offset in data of the given outer index
+    ptrdiff_t outer_offset(size_t idx) const {
+        ptrdiff_t ret = 0;
+        for (size_t i = outer_ndim; i; --i) {
+            ret += outer_stride[i - 1] * static_cast<ptrdiff_t>(
+                                                 idx % outer_shape[i - 1]);
+            idx /= outer_shape[i - 1];
+        }
+        return ret;
+    }
+};
+
+//! \return whether value can be viewed as RowLayout
+bool get_row_layout(
+        const TensorLayout& data, const TensorLayout& value,
+        const IndexingMultiAxisVec::IndexDesc& index, size_t idx_axis,
+        RowLayout& ret) {
+    if (!value.is_contiguous() || !value.total_nr_elems()) {
+        return false;
+    }
+    size_t nonidx_axes[TensorLayout::MAX_NDIM],
+            nr_nonidx_axes = IndexingMultiAxisVec::get_nonindex_axes(
+                    data.ndim, index, nonidx_axes);
+
+    // non-indexed axes after idx_axis must be the last axes of data
+    size_t expect_axis = data.ndim;
+    ptrdiff_t expect_stride = 1;
+    ret.row_size = 1;
+    for (size_t i = nr_nonidx_axes; i > idx_axis; --i) {
+        size_t axis = nonidx_axes[i - 1];
+        if (axis != --expect_axis ||
+            (data.shape[axis] != 1 && data.stride[axis] != expect_stride)) {
+            return false;
+        }
+        ret.row_size *= data.shape[axis];
+        expect_stride *= data.shape[axis];
+    }
+    ret.outer_ndim = idx_axis;
+    ret.nr_outer = 1;
+    for (size_t i = 0; i < idx_axis; ++i) {
+        ret.outer_shape[i] = data.shape[nonidx_axes[i]];
+        ret.outer_stride[i] = data.stride[nonidx_axes[i]];
+        ret.nr_outer *= ret.outer_shape[i];
+    }
+    ret.nr_idx = value.shape[idx_axis];
+    return true;
+}
+
+//! raw pointers of indexers, which can be captured by kernels
+struct IndexRaw {
+    size_t nr_index;
+    size_t axis[TensorLayout::MAX_NDIM];
+    const dt_int32* ptr[TensorLayout::MAX_NDIM];
+    ptrdiff_t stride[TensorLayout::MAX_NDIM];
+
+    explicit IndexRaw(const IndexingMultiAxisVec::IndexDesc& index)
+            : nr_index{index.size()} {
+        for (size_t i = 0; i < nr_index; ++i) {
+            auto&& s = index[i];
+            axis[i] = s.axis;
+            ptr[i] = s.vec.ptr<dt_int32>();
+            stride[i] = s.vec.layout.shape[0] == 1 ? 0 : s.vec.layout.stride[0];
+        }
+    }
+};
+
+//! compute offsets in data of each index
+void compute_offsets(
+        const TensorLayout& data, const IndexRaw& index, size_t nr_idx,
+        ptrdiff_t* offsets) {
+    for (size_t n = 0; n < nr_idx; ++n) {
+        ptrdiff_t offset = 0;
+        for (size_t i = 0; i < index.nr_index; ++i) {
+            size_t axis = index.axis[i], data_shape = data.shape[axis];
+            dt_int32 data_idx = index.ptr[i][index.stride[i] * n];
+            if (data_idx < 0)
+                data_idx += data_shape;
+            megdnn_assert(
+                    data_idx >= 0 && static_cast<size_t>(data_idx) < data_shape,
+                    "bad index value for index %zu at output %zu", i, n);
+            offset += data.stride[axis] * data_idx;
+        }
+        offsets[n] = offset;
+    }
+}
+
+template <typename ctype>
+void exec_fwd(
+        naive::HandleImpl* handle, const ctype* data, ctype* value,
+        const RowLayout& layout, const ptrdiff_t* offsets) {
+    size_t nr_row = layout.nr_outer * layout.nr_idx, row_size = layout.row_size;
+    size_t rows_per_task = std::max<size_t>(1, MIN_TASK_SIZE / row_size);
+    auto kern = [=](size_t task, size_t) {
+        size_t begin = task * rows_per_task,
+               end = std::min(nr_row, begin + rows_per_task);
+        size_t outer = begin / layout.nr_idx;
+        const ctype* base = data + layout.outer_offset(outer);
+        for (size_t r = begin; r < end; ++r) {
+            size_t n = r % layout.nr_idx;
+            if (!n && r != begin) {
+                base = data + layout.outer_offset(++outer);
+            }
+            if (n + PREFETCH_DIST < layout.nr_idx) {
+                __builtin_prefetch(base + offsets[n + PREFETCH_DIST], 0, 0);
+            }
+            memcpy(value + r * row_size, base + offsets[n], sizeof(ctype) * row_size);
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            handle, div_ceil(nr_row, rows_per_task), kern);
+}
+
+/*!
+ * Index values may be duplicated for incr, so the rows of the same outer index
+ * are processed in order, and the threads are split over the outer index or
+ * the columns.
+ */
+template <typename ctype, class Opr>
+void exec_modify(
+        naive::HandleImpl* handle, ctype* data, const ctype* value,
+        const RowLayout& layout, const ptrdiff_t* offsets) {
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t row_size = layout.row_size, nr_col_block = 1;
+    if (layout.nr_outer < nr_threads &&
+        row_size * layout.nr_idx >= MIN_TASK_SIZE * nr_threads) {
+        nr_col_block = std::min(nr_threads, div_ceil(row_size, MIN_COL_BLOCK));
+    }
+    size_t col_block = div_ceil(row_size, nr_col_block);
+    nr_col_block = div_ceil(row_size, col_block);
+    auto kern = [=](size_t task, size_t) {
+        size_t outer = task / nr_col_block,
+               col_begin = task % nr_col_block * col_block,
+               col_end = std::min(row_size, col_begin + col_block);
+        ctype* base = data + layout.outer_offset(outer) + col_begin;
+        const ctype* vptr = value + outer * layout.nr_idx * row_size + col_begin;
+        for (size_t n = 0; n < layout.nr_idx; ++n, vptr += row_size) {
+            if (n + PREFETCH_DIST < layout.nr_idx) {
+                __builtin_prefetch(base + offsets[n + PREFETCH_DIST], 1, 0);
+            }
+            ctype* dptr = base + offsets[n];
+            for (size_t c = 0; c < col_end - col_begin; ++c) {
+                Opr::apply(dptr[c], vptr[c]);
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            handle, layout.nr_outer * nr_col_block, kern);
+}
+
+template <typename ctype, class Opr>
+struct RowKern {
+    static void exec(
+            naive::HandleImpl* handle, const TensorND& data, const TensorND& value,
+            const RowLayout& layout, const ptrdiff_t* offsets) {
+        exec_modify<ctype, Opr>(
+                handle, data.ptr<ctype>(), value.ptr<ctype>(), layout, offsets);
+    }
+};
+
+template <typename ctype>
+struct RowKern<ctype, indexing_multi_axis_vec_kdef::OprFwd> {
+    static void exec(
+            naive::HandleImpl* handle, const TensorND& data, const TensorND& value,
+            const RowLayout& layout, const ptrdiff_t* offsets) {
+        exec_fwd<ctype>(handle, data.ptr<ctype>(), value.ptr<ctype>(), layout, offsets);
+    }
+};
+
+template <class Opr>
+void dispatch_exec(
+        naive::HandleImpl* handle, const TensorND& data, const TensorND& value,
+        const IndexingMultiAxisVec::IndexDesc& index, const RowLayout& layout,
+        ptrdiff_t* offsets) {
+    IndexRaw index_raw{index};
+    auto data_layout = data.layout;
+    auto nr_idx = layout.nr_idx;
+    MEGDNN_DISPATCH_CPU_KERN(
+            handle, compute_offsets(data_layout, index_raw, nr_idx, offsets));
+#define cb(_dt)                                                                   \
+    case DTypeTrait<_dt>::enumv: {                                                \
+        RowKern<DTypeTrait<_dt>::ctype, Opr>::exec(                               \
+                handle, data, value, layout, offsets);                            \
+        return;                                                                   \
+    }
+    switch (data.layout.dtype.enumv()) {
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Bool) default : megdnn_throw("bad dtype");
+    }
+#undef cb
+}
+
+}  // anonymous namespace
+
+size_t IndexingMultiAxisVecImpl::get_workspace_in_bytes(size_t dst_idx_size) {
+    return dst_idx_size * sizeof(ptrdiff_t);
+}
+
+void IndexingMultiAxisVecImpl::exec(
+        _megdnn_tensor_in src, const IndexDesc& index, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(src.layout, index, dst.layout, workspace.size);
+    RowLayout layout;
+    if (!get_row_layout(src.layout, dst.layout, index, info.idx_axis, layout)) {
+        return naive::IndexingMultiAxisVecImpl::exec(src, index, dst, workspace);
+    }
+    dispatch_exec<indexing_multi_axis_vec_kdef::OprFwd>(
+            static_cast<naive::HandleImpl*>(handle()), src, dst, index, layout,
+            workspace.ptr<ptrdiff_t>());
+}
+
+size_t IndexingSetMultiAxisVecImpl::get_workspace_in_bytes(size_t value_idx_size) {
+    return value_idx_size * sizeof(ptrdiff_t);
+}
+
+void IndexingSetMultiAxisVecImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(data.layout, value.layout, index, workspace.size);
+    RowLayout layout;
+    if (!get_row_layout(data.layout, value.layout, index, info.idx_axis, layout)) {
+        return naive::IndexingSetMultiAxisVecImpl::exec(data, value, index, workspace);
+    }
+    dispatch_exec<indexing_multi_axis_vec_kdef::OprSet>(
+            static_cast<naive::HandleImpl*>(handle()), data, value, index, layout,
+            workspace.ptr<ptrdiff_t>());
+}
+
+size_t IndexingIncrMultiAxisVecImpl::get_workspace_in_bytes(size_t value_idx_size) {
+    return value_idx_size * sizeof(ptrdiff_t);
+}
+
+void IndexingIncrMultiAxisVecImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(data.layout, value.layout, index, workspace.size);
+    RowLayout layout;
+    if (!get_row_layout(data.layout, value.layout, index, info.idx_axis, layout)) {
+        return naive::IndexingIncrMultiAxisVecImpl::exec(
+                data, value, index, workspace);
+    }
+    dispatch_exec<indexing_multi_axis_vec_kdef::OprIncr>(
+            static_cast<naive::HandleImpl*>(handle()), data, value, index, layout,
+            workspace.ptr<ptrdiff_t>());
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,61 @@
+/**
+ * \file dnn/src/fallback/indexing_multi_axis_vec/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/naive/indexing_multi_axis_vec/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*
+ * The fallback impls handle the case where the non-indexed axes after the
+ * indexer form contiguous rows in both data and value (such as embedding
+ * lookup), and copy a whole row for each index; other cases are forwarded to
+ * naive impls.
+ */
+
+class IndexingMultiAxisVecImpl : public naive::IndexingMultiAxisVecImpl {
+public:
+    using naive::IndexingMultiAxisVecImpl::IndexingMultiAxisVecImpl;
+
+    size_t get_workspace_in_bytes(size_t dst_idx_size) override;
+
+    void exec(
+            _megdnn_tensor_in src, const IndexDesc& index, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
+class IndexingSetMultiAxisVecImpl : public naive::IndexingSetMultiAxisVecImpl {
+public:
+    using naive::IndexingSetMultiAxisVecImpl::IndexingSetMultiAxisVecImpl;
+
+    size_t get_workspace_in_bytes(size_t value_idx_size) override;
+
+    void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+            _megdnn_workspace workspace) override;
+};
+
+class IndexingIncrMultiAxisVecImpl : public naive::IndexingIncrMultiAxisVecImpl {
+public:
+    using naive::IndexingIncrMultiAxisVecImpl::IndexingIncrMultiAxisVecImpl;
+
+    size_t get_workspace_in_bytes(size_t value_idx_size) override;
+
+    void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+            _megdnn_workspace workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
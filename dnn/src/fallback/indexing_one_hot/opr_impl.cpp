@@ -0,0 +1,113 @@
+/**
+ * \file dnn/src/fallback/indexing_one_hot/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/fallback/indexing_one_hot/opr_impl.h"
+#include "src/naive/handle.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! number of elements to be processed by each task
+constexpr size_t MIN_TASK_SIZE = 4096;
+
+/*!
+ * \brief all the tensors are contiguous; viewing the indexed tensor as
+ *      (A, M, C), the other tensors are (A, C)
+ *
+ * \param Set false to copy from \p mid to \p dense, and true to copy from
+ *      \p dense to \p mid
+ */
+template <bool Set, typename ctype>
+void exec_one_hot(
+        naive::HandleImpl* handle, ctype* mid, const dt_int32* index, ctype* dense,
+        size_t A, size_t M, size_t C) {
+    size_t nr_elems = A * C;
+    auto kern = [=](size_t task, size_t) {
+        size_t begin = task * MIN_TASK_SIZE,
+               end = std::min(nr_elems, begin + MIN_TASK_SIZE);
+        size_t a = begin / C, c = begin % C;
+        ctype* mid_row = mid + a * M * C;
+        for (size_t i = begin; i < end; ++i) {
+            int idx = index[i];
+            megdnn_assert(
+                    idx >= 0 && idx < static_cast<int>(M),
+                    "bad value in IndexingOneHot index: input shape is %zu, "
+                    "index value is %d",
+                    M, idx);
+            if (Set) {
+                mid_row[idx * C + c] = dense[i];
+            } else {
+                dense[i] = mid_row[idx * C + c];
+            }
+            if (++c == C) {
+                c = 0;
+                mid_row += M * C;
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            handle, div_ceil(nr_elems, MIN_TASK_SIZE), kern);
+}
+
+}  // anonymous namespace
+
+void IndexingOneHotForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in index, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, index.layout, dst.layout, workspace.size);
+    size_t A, M, C;
+    reduce::get_ABC(src.layout, A, M, C, param().axis);
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+
+#define cb(_dt)                                                                    \
+    case DTypeTrait<_dt>::enumv: {                                                 \
+        using ctype = DTypeTrait<_dt>::ctype;                                      \
+        exec_one_hot<false>(                                                       \
+                handle, src.ptr<ctype>(), index.ptr<dt_int32>(), dst.ptr<ctype>(), \
+                A, M, C);                                                          \
+        return;                                                                    \
+    }
+    switch (src.layout.dtype.enumv()) {
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(megdnn::dtype::Quantized8Asymm) default : megdnn_throw("bad dtype");
+    }
+#undef cb
+}
+
+void IndexingSetOneHotForwardImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in index, _megdnn_tensor_in sub,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, index.layout, sub.layout, workspace.size);
+    size_t A, M, C;
+    reduce::get_ABC(data.layout, A, M, C, param().axis);
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+
+#define cb(_dt)                                                                     \
+    case DTypeTrait<_dt>::enumv: {                                                  \
+        using ctype = DTypeTrait<_dt>::ctype;                                       \
+        exec_one_hot<true>(                                                         \
+                handle, data.ptr<ctype>(), index.ptr<dt_int32>(), sub.ptr<ctype>(), \
+                A, M, C);                                                           \
+        return;                                                                     \
+    }
+    switch (data.layout.dtype.enumv()) {
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(megdnn::dtype::Quantized8Asymm) default : megdnn_throw("bad dtype");
+    }
+#undef cb
+}
+
+// vim: syntax=cpp.doxygen
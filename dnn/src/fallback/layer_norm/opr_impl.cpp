@@ -0,0 +1,153 @@
+/**
+ * \file dnn/src/fallback/layer_norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/layer_norm/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/fallback/norm_helper.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! number of columns of dweight and dbias computed by a task
+constexpr size_t COL_BLOCK = 64;
+
+void fwd_rows(
+        const float* x, const float* w, const float* b, float* y, float* mean,
+        float* rstd, size_t begin, size_t end, size_t len, float eps) {
+    for (size_t r = begin; r < end; ++r) {
+        const float* xr = x + r * len;
+        float* yr = y + r * len;
+        float m, rs;
+        norm::row_stats(xr, len, eps, m, rs);
+        mean[r] = m;
+        rstd[r] = rs;
+        if (w) {
+            for (size_t i = 0; i < len; ++i) {
+                yr[i] = (xr[i] - m) * rs * w[i] + b[i];
+            }
+        } else {
+            norm::scale_shift(xr, yr, len, rs, -m * rs);
+        }
+    }
+}
+
+void bwd_data_rows(
+        const float* dy, const float* x, const float* w, const float* mean,
+        const float* rstd, float* dx, size_t begin, size_t end, size_t len) {
+    for (size_t r = begin; r < end; ++r) {
+        const float *dyr = dy + r * len, *xr = x + r * len;
+        float* dxr = dx + r * len;
+        float m = mean[r], rs = rstd[r], sum_g, sum_gx;
+        if (w) {
+            sum_g = norm::lane_sum(len, [=](size_t i) { return dyr[i] * w[i]; });
+            sum_gx = norm::lane_sum(
+                    len, [=](size_t i) { return dyr[i] * w[i] * (xr[i] - m); });
+            float coef = rs * rs * rs * sum_gx / len, shift = rs * sum_g / len;
+            for (size_t i = 0; i < len; ++i) {
+                dxr[i] = rs * w[i] * dyr[i] - coef * (xr[i] - m) - shift;
+            }
+        } else {
+            sum_g = norm::lane_sum(len, [=](size_t i) { return dyr[i]; });
+            sum_gx = norm::lane_sum(
+                    len, [=](size_t i) { return dyr[i] * (xr[i] - m); });
+            norm::bwd_data(
+                    dyr, xr, dxr, len, rs, m, rs * rs * rs * sum_gx / len,
+                    rs * sum_g / len);
+        }
+    }
+}
+
+//! dweight and dbias of columns [col, col + width)
+void bwd_param_cols(
+        const float* dy, const float* x, const float* mean, const float* rstd,
+        float* dw, float* db, size_t nr_row, size_t len, size_t col, size_t width) {
+    float sum_w[COL_BLOCK] = {0.f}, sum_b[COL_BLOCK] = {0.f};
+    for (size_t r = 0; r < nr_row; ++r) {
+        const float *dyr = dy + r * len + col, *xr = x + r * len + col;
+        float m = mean[r], rs = rstd[r];
+        for (size_t i = 0; i < width; ++i) {
+            sum_w[i] += dyr[i] * (xr[i] - m) * rs;
+            sum_b[i] += dyr[i];
+        }
+    }
+    std::copy(sum_w, sum_w + width, dw + col);
+    std::copy(sum_b, sum_b + width, db + col);
+}
+
+}  // anonymous namespace
+
+void LayerNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+        _megdnn_workspace workspace) {
+    if (data.layout.dtype != dtype::Float32()) {
+        return naive::LayerNormForwardImpl::exec(
+                data, weight, bias, dst, mean, rstd, workspace);
+    }
+    check_exec(
+            data.layout, weight.layout, bias.layout, dst.layout, mean.layout,
+            rstd.layout, workspace.size);
+    auto p = param();
+    size_t len = p.normalized_size,
+           nr_row = len ? data.layout.total_nr_elems() / len : 0;
+    float eps = p.eps;
+    const float* xptr = data.ptr<dt_float32>();
+    const float* wptr = p.affine ? weight.ptr<dt_float32>() : nullptr;
+    const float* bptr = p.affine ? bias.ptr<dt_float32>() : nullptr;
+    float *yptr = dst.ptr<dt_float32>(), *mptr = mean.ptr<dt_float32>(),
+          *rptr = rstd.ptr<dt_float32>();
+    norm::dispatch_rows(
+            static_cast<naive::HandleImpl*>(handle()), nr_row, len,
+            [=](size_t begin, size_t end) {
+                fwd_rows(xptr, wptr, bptr, yptr, mptr, rptr, begin, end, len, eps);
+            });
+}
+
+void LayerNormBackwardImpl::exec(
+        _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+        _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+        _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+        _megdnn_workspace workspace) {
+    if (data.layout.dtype != dtype::Float32()) {
+        return naive::LayerNormBackwardImpl::exec(
+                diff, data, weight, mean, rstd, ddata, dweight, dbias, workspace);
+    }
+    check_exec(
+            diff.layout, data.layout, weight.layout, mean.layout, rstd.layout,
+            ddata.layout, dweight.layout, dbias.layout, workspace.size);
+    auto p = param();
+    size_t len = p.normalized_size,
+           nr_row = len ? data.layout.total_nr_elems() / len : 0;
+    const float *dyptr = diff.ptr<dt_float32>(), *xptr = data.ptr<dt_float32>(),
+                *mptr = mean.ptr<dt_float32>(), *rptr = rstd.ptr<dt_float32>();
+    const float* wptr = p.affine ? weight.ptr<dt_float32>() : nullptr;
+    float* dxptr = ddata.ptr<dt_float32>();
+    auto nhandle = static_cast<naive::HandleImpl*>(handle());
+    norm::dispatch_rows(nhandle, nr_row, len, [=](size_t begin, size_t end) {
+        bwd_data_rows(dyptr, xptr, wptr, mptr, rptr, dxptr, begin, end, len);
+    });
+    if (!p.affine || !len) {
+        return;
+    }
+    float *dwptr = dweight.ptr<dt_float32>(), *dbptr = dbias.ptr<dt_float32>();
+    auto kern = [=](size_t task, size_t) {
+        size_t col = task * COL_BLOCK;
+        bwd_param_cols(
+                dyptr, xptr, mptr, rptr, dwptr, dbptr, nr_row, len, col,
+                std::min(COL_BLOCK, len - col));
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(nhandle, div_ceil(len, COL_BLOCK), kern);
+}
+
+// vim: syntax=cpp.doxygen
@@ -271,6 +271,8 @@ MatrixMulImpl::AlgoDataType MatrixMulImpl::KernSizeParam::deduce_algo_data_type(
 #if !MEGDNN_DISABLE_FLOAT16
     } else if (A_type.enumv() == DTypeEnum::Float16) {
         return MatrixMulImpl::AlgoDataType::FLOAT16;
+    } else if (A_type.enumv() == DTypeEnum::BFloat16) {
+        return MatrixMulImpl::AlgoDataType::BFLOAT16;
 #endif
     } else if (
             A_type.enumv() == DTypeEnum::Int8 ||
@@ -125,6 +125,9 @@ public:
             X86_F32_MK8_8X8,
             X86_INT8X8X32_VNNI,
             X86_INT8X8X32_MKLDNN,
+            X86_INT8X8X32_AVX512_8X32X2,
+            X86_INT8X8X32_AMX_32X32X64,
+            X86_BF16_AMX_32X32X32,
 #elif MEGDNN_AARCH64 || MEGDNN_ARMV7
             ARM_COMMON_INT8X8X16 = 1 << 8,
             ARM_COMMON_INT8X8X32_GEMV,
@@ -157,6 +160,10 @@ public:
             AARCH64_QUINT8_GEMV_DOTPROD,
             AARCH64_QUINT8_K8X8X8,
             AARCH64_INT4X4X16_K8X8X8,
+            AARCH64_INT8X8X32_K8X12X8_I8MM,
+            AARCH64_INT8X8X32_MK4_8X12X8_I8MM,
+            AARCH64_BF16_K8X12X4,
+            AARCH64_F32_SVE_8XVL,
 #else
             ARMV7_F32 = 1 << 16,
             ARMV7_F32_MK4_PACK_4X12,
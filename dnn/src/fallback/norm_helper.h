@@ -0,0 +1,147 @@
+/**
+ * \file dnn/src/fallback/norm_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace megdnn {
+namespace fallback {
+//! float32 kernels shared by LayerNorm, GroupNorm and BatchNorm
+namespace norm {
+
+//! number of independent accumulators used in reductions
+constexpr size_t NR_LANE = 8;
+
+//! minimal number of elements processed by a thread
+constexpr size_t MIN_TASK_SIZE = 16384;
+
+/*!
+ * \brief sum of f(i) for i in [0, len)
+ *
+ * The partial sums are kept in NR_LANE accumulators, so the loop can be
+ * vectorized without reassociating floating point additions.
+ */
+template <typename Func>
+MEGDNN_FORCE_INLINE float lane_sum(size_t len, Func f) {
+    float acc[NR_LANE] = {0.f};
+    size_t i = 0;
+    for (; i + NR_LANE <= len; i += NR_LANE) {
+        for (size_t k = 0; k < NR_LANE; ++k) {
+            acc[k] += f(i + k);
+        }
+    }
+    float sum = 0.f;
+    for (; i < len; ++i) {
+        sum += f(i);
+    }
+    for (size_t k = 0; k < NR_LANE; ++k) {
+        sum += acc[k];
+    }
+    return sum;
+}
+
+/*!
+ * \brief mean and sum of squared deviations from it of a row
+ *
+ * Two passes are used rather than Welford's update, since the row is in
+ * cache after the first pass and both passes are vectorized. The sum is
+ * taken relative to x[0] to avoid losing precision for rows with large mean.
+ */
+MEGDNN_FORCE_INLINE void row_moments(
+        const float* x, size_t len, float& mean, float& m2) {
+    float k = x[0];
+    float m = k + lane_sum(len, [x, k](size_t i) { return x[i] - k; }) / len;
+    m2 = lane_sum(len, [x, m](size_t i) {
+        float d = x[i] - m;
+        return d * d;
+    });
+    mean = m;
+}
+
+//! mean and 1 / sqrt(var + eps) of a row
+MEGDNN_FORCE_INLINE void row_stats(
+        const float* x, size_t len, float eps, float& mean, float& rstd) {
+    float m2;
+    row_moments(x, len, mean, m2);
+    rstd = 1.f / std::sqrt(m2 / len + eps);
+}
+
+/*!
+ * \brief merge the moments of \p nb elements into those of \p na elements
+ *
+ * This is the pairwise update of Chan et al., which generalizes Welford's
+ * algorithm to partial results.
+ */
+MEGDNN_FORCE_INLINE void merge_moments(
+        size_t& na, float& mean_a, float& m2_a, size_t nb, float mean_b, float m2_b) {
+    if (!nb) {
+        return;
+    }
+    size_t n = na + nb;
+    float delta = mean_b - mean_a, rb = static_cast<float>(nb) / n;
+    mean_a += delta * rb;
+    m2_a += m2_b + delta * delta * na * rb;
+    na = n;
+}
+
+//! y = x * scale + shift
+MEGDNN_FORCE_INLINE void scale_shift(
+        const float* __restrict x, float* __restrict y, size_t len, float scale,
+        float shift) {
+    for (size_t i = 0; i < len; ++i) {
+        y[i] = x[i] * scale + shift;
+    }
+}
+
+/*!
+ * \brief gradient wrt. x of a normalized segment
+ *
+ * dx = scale * dy - coef * (x - mean) - shift, where scale is rstd times the
+ * affine weight, and coef, shift come from the row-wise sums.
+ */
+MEGDNN_FORCE_INLINE void bwd_data(
+        const float* __restrict dy, const float* __restrict x, float* __restrict dx,
+        size_t len, float scale, float mean, float coef, float shift) {
+    for (size_t i = 0; i < len; ++i) {
+        dx[i] = scale * dy[i] - coef * (x[i] - mean) - shift;
+    }
+}
+
+/*!
+ * \brief run kern(begin, end) on ranges of \p nr_row rows of length \p len
+ *      in parallel
+ */
+template <typename Func>
+void dispatch_rows(naive::HandleImpl* handle, size_t nr_row, size_t len, Func kern) {
+    if (!nr_row) {
+        return;
+    }
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t nr_task = std::min(
+            {nr_threads, nr_row, std::max<size_t>(nr_row * len / MIN_TASK_SIZE, 1)});
+    size_t rows_per_task = div_ceil(nr_row, nr_task);
+    nr_task = div_ceil(nr_row, rows_per_task);
+    auto task = [=](size_t task_id, size_t) {
+        size_t begin = task_id * rows_per_task,
+               end = std::min(nr_row, begin + rows_per_task);
+        kern(begin, end);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, task);
+}
+
+}  // namespace norm
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -19,6 +19,7 @@
 MIDOUT_DECL(megdnn_fb_reduce_op)
 MIDOUT_DECL(megdnn_fb_reduce_c)
 MIDOUT_DECL(megdnn_fb_reduce_dtype)
+MIDOUT_DECL(megdnn_fb_reduce_target_shape)
 
 namespace {
 
@@ -70,16 +71,70 @@ void reduce_exec(size_t A, size_t B, size_t C, Op op) MEGDNN_NOEXCEPT {
     }
 }
 
+//! reduce (A, B, C) to (1, B, 1), where op.B must be A * C
+template <typename Op>
+void reduce_exec_target_shape(size_t A, size_t B, size_t C, Op op) MEGDNN_NOEXCEPT {
+    using wtype = typename Op::wtype;
+    rep(b, B) {
+        wtype res = op.INIT;
+        rep(a, A) {
+            size_t offset = a * B * C + b * C;
+            wtype part = op.INIT;
+            rep(c, C) { part = op.apply(part, op.read(offset + c)); }
+            res = op.apply(res, part);
+        }
+        op.write(b, res);
+    }
+}
+
 }  // anonymous namespace
 
 namespace megdnn {
 namespace fallback {
 
+bool ReduceImpl::exec_target_shape(_megdnn_tensor_in src, _megdnn_tensor_out dst) {
+    using namespace reduce;
+    using Mode = Param::Mode;
+    size_t A, B, C;
+    if (!get_target_shape_ABC(src.layout, dst.layout, A, B, C)) {
+        return false;
+    }
+#define cb_by_op(mode_, Op_)                                                    \
+    if (param().mode == mode_) {                                                \
+        Op_<ctype, ctype, ctype> op(src.ptr<ctype>(), dst.ptr<ctype>(), A * C); \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(reduce_exec_target_shape(A, B, C, op));    \
+        return true;                                                            \
+    }
+#define cb(dtype_)                                                  \
+    if (dtype_() == src.layout.dtype) {                             \
+        using ctype = DTypeTrait<dtype_>::ctype;                    \
+        MIDOUT_BEGIN(megdnn_fb_reduce_target_shape, midout_iv(0)) { \
+            cb_by_op(Mode::SUM, SumOp);                             \
+            cb_by_op(Mode::SUM_SQR, SumSqrOp);                      \
+            cb_by_op(Mode::PRODUCT, ProdOp);                        \
+            cb_by_op(Mode::MIN, MinOp);                             \
+            cb_by_op(Mode::MAX, MaxOp);                             \
+            cb_by_op(Mode::MEAN, MeanOp);                           \
+        }                                                           \
+        MIDOUT_END();                                               \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE(cb);
+#undef cb
+#undef cb_by_op
+    return false;
+}
+
 void ReduceImpl::exec(
         _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
     using namespace reduce;
     using Mode = Param::Mode;
     check_exec(src.layout, dst.layout, workspace.size);
+    if (param().axis == TARGET_SHAPE_AXIS) {
+        if (!exec_target_shape(src, dst)) {
+            naive::ReduceForwardImpl::exec(src, dst, workspace);
+        }
+        return;
+    }
     size_t A, B, C;
     get_ABC(src.layout, A, B, C, param().axis);
 #define cb_by_op(src_type, dst_type, _wtype, mode_, Op_, kern_func) \
@@ -19,6 +19,16 @@ public:
     using ReduceForwardImpl::ReduceForwardImpl;
     void exec(
             _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace) override;
+
+protected:
+    /*!
+     * \brief reduce src to the shape of dst in one pass over src, see
+     *      ReduceForward::TARGET_SHAPE_AXIS
+     *
+     * \return false if the reduced axes can not be collapsed, see
+     *      reduce::get_target_shape_ABC()
+     */
+    bool exec_target_shape(_megdnn_tensor_in src, _megdnn_tensor_out dst);
 };
 
 }  // namespace fallback
@@ -47,11 +47,11 @@ void memcpy_noncont2cont(void* cont, void* non_cont, size_t size) {
     memcpy(cont, non_cont, size);
 }
 
-template <typename T>
-void call_transpose(size_t batch, size_t m, size_t n, size_t ch, void* src, void* dst) {
-    megdnn_assert(ch == 1);
-    relayout::transpose_fallback::transpose<T>(
-            batch, m, n, static_cast<T*>(src), static_cast<T*>(dst));
+//! relayouts smaller than this are not split among threads
+constexpr size_t MIN_PARALLEL_BYTES = 64 * 1024;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
 }
 
 //! one operand contiguous, and the other non-contiguous
@@ -61,16 +61,24 @@ void dispatch_on_dtype_cont(
         memcpy_policy_t mcp_pol) {
     auto ctptr = static_cast<uint8_t*>(cont.raw_ptr),
          ncptr = static_cast<uint8_t*>(nonc.raw_ptr);
-    thin_function<void()> kern;
+    // the copy is split along the first axis into tasks of nr_rows
+    size_t shp0 = nonc.layout.shape[0], nr_rows = shp0;
+    size_t nr_threads = get_nr_threads(handle);
+    if (nr_threads > 1 &&
+        nonc.layout.total_nr_elems() * sizeof(ctype) >= MIN_PARALLEL_BYTES) {
+        nr_rows = div_ceil(shp0, nr_threads * 2);
+    }
+    thin_function<void(size_t, size_t)> kern;
     switch (nonc.layout.ndim) {
         case 2: {
-            auto shp0 = nonc.layout.shape[0], shp1 = nonc.layout.shape[1];
+            auto shp1 = nonc.layout.shape[1];
             auto strd0_n = nonc.layout.stride[0] * sizeof(ctype);
             auto strd0_c = shp1 * sizeof(ctype);
-            kern = [=]() {
-                auto cur_ctptr = ctptr;
-                auto cur_ncptr = ncptr;
-                for (size_t i = 0; i < shp0; ++i) {
+            kern = [=](size_t task, size_t) {
+                size_t begin = task * nr_rows, end = std::min(shp0, begin + nr_rows);
+                auto cur_ctptr = ctptr + begin * strd0_c;
+                auto cur_ncptr = ncptr + begin * strd0_n;
+                for (size_t i = begin; i < end; ++i) {
                     mcp_pol(cur_ctptr, cur_ncptr, strd0_c);
                     cur_ctptr += strd0_c;
                     cur_ncptr += strd0_n;
@@ -79,15 +87,15 @@ void dispatch_on_dtype_cont(
             break;
         }
         case 3: {
-            auto shp0 = nonc.layout.shape[0], shp1 = nonc.layout.shape[1],
-                 shp2 = nonc.layout.shape[2];
+            auto shp1 = nonc.layout.shape[1], shp2 = nonc.layout.shape[2];
             auto strd0_n = nonc.layout.stride[0] * sizeof(ctype),
                  strd1_n = nonc.layout.stride[1] * sizeof(ctype);
             auto strd1_c = shp2 * sizeof(ctype);
-            kern = [=]() {
-                auto cur_ctptr = ctptr;
-                auto ncptr_row = ncptr;
-                for (size_t i = 0; i < shp0; ++i) {
+            kern = [=](size_t task, size_t) {
+                size_t begin = task * nr_rows, end = std::min(shp0, begin + nr_rows);
+                auto cur_ctptr = ctptr + begin * shp1 * strd1_c;
+                auto ncptr_row = ncptr + begin * strd0_n;
+                for (size_t i = begin; i < end; ++i) {
                     auto cur_ncptr = ncptr_row;
                     for (size_t j = 0; j < shp1; ++j) {
                         mcp_pol(cur_ctptr, cur_ncptr, strd1_c);
@@ -103,7 +111,8 @@ void dispatch_on_dtype_cont(
             megdnn_assert(0);
     }
 
-    static_cast<naive::HandleImpl*>(handle)->dispatch_kern(std::move(kern));
+    static_cast<naive::HandleImpl*>(handle)->dispatch_kern(
+            std::move(kern), div_ceil(shp0, nr_rows));
 }
 
 void dispatch_cont(
@@ -205,6 +214,30 @@ void transpose_cv(size_t batch, size_t m, size_t n, size_t ch, void* src, void*
 
 }  // anonymous namespace
 
+RelayoutForwardImpl::TransposeSplit RelayoutForwardImpl::get_transpose_split(
+        const relayout::TransposeParam& param, size_t dtype_size, size_t block_size) {
+    size_t batch = param.batch, m = param.m, n = param.n;
+    TransposeSplit ret{false, m, n, 1, 1};
+    size_t nr_threads = get_nr_threads(handle());
+    if (nr_threads == 1 || batch * m * n * dtype_size < MIN_PARALLEL_BYTES) {
+        return ret;
+    }
+    ret.parallel = true;
+    // split each matrix along its longer side, so that there are at least
+    // two tasks for each thread
+    size_t nr_tile = div_ceil(nr_threads * 2, batch);
+    if (nr_tile > 1) {
+        if (m >= n) {
+            ret.rows = round_up(div_ceil(m, nr_tile), block_size);
+            ret.nr_row_tile = div_ceil(m, ret.rows);
+        } else {
+            ret.cols = round_up(div_ceil(n, nr_tile), block_size);
+            ret.nr_col_tile = div_ceil(n, ret.cols);
+        }
+    }
+    return ret;
+}
+
 void RelayoutForwardImpl::exec(
         _megdnn_tensor_in src0, _megdnn_tensor_out dst0, Handle* src_handle) {
     check_cpu_handle(src_handle);
@@ -248,37 +281,40 @@ void RelayoutForwardImpl::exec_after_preprocess(
         void (*kptr)(size_t, size_t, size_t, size_t, void*, void*) = nullptr;
         auto src_addr = reinterpret_cast<uintptr_t>(src.raw_ptr),
              dst_addr = reinterpret_cast<uintptr_t>(dst.raw_ptr);
+        bool aligned_2 = !((src_addr | dst_addr) & (alignof(uint16_t) - 1)),
+             aligned_4 = !((src_addr | dst_addr) & (alignof(uint32_t) - 1));
+        auto sptr = src.raw_ptr;
+        auto dptr = dst.raw_ptr;
         if (dsize == 1) {
             megdnn_assert(transpose->c == 1);
-            kptr = call_transpose<uint8_t>;
+            return dispatch_transpose<uint8_t>(*transpose, sptr, dptr);
         } else if (dsize == 2) {
             transpose->c = 1;
-            if (!((src_addr | dst_addr) & (alignof(uint16_t) - 1))) {
-                kptr = call_transpose<uint16_t>;
-            } else {
-                kptr = call_transpose<equiv_ctype_storage<2>>;
-                megdnn_log_error("unaligned addr in relayout");
+            if (aligned_2) {
+                return dispatch_transpose<uint16_t>(*transpose, sptr, dptr);
             }
+            megdnn_log_error("unaligned addr in relayout");
+            return dispatch_transpose<equiv_ctype_storage<2>>(*transpose, sptr, dptr);
         } else if (dsize == 3) {
             transpose->c = 1;
-            kptr = call_transpose<equiv_ctype_storage<3>>;
+            return dispatch_transpose<equiv_ctype_storage<3>>(*transpose, sptr, dptr);
         } else if (dsize == 4) {
             transpose->c = 1;
-            if (!((src_addr | dst_addr) & (alignof(uint32_t) - 1))) {
-                kptr = call_transpose<uint32_t>;
-            } else {
-                kptr = call_transpose<equiv_ctype_storage<4>>;
-                megdnn_log_error("unaligned addr in relayout");
+            if (aligned_4) {
+                return dispatch_transpose<uint32_t>(*transpose, sptr, dptr);
             }
+            megdnn_log_error("unaligned addr in relayout");
+            return dispatch_transpose<equiv_ctype_storage<4>>(*transpose, sptr, dptr);
         } else if (dsize == 12) {
             transpose->c = 1;
-            if (!((src_addr | dst_addr) & (alignof(uint32_t) - 1))) {
-                kptr = call_transpose<equiv_ctype_storage<3, uint32_t>>;
-            } else {
-                kptr = call_transpose<equiv_ctype_storage<12>>;
-                megdnn_log_error("unaligned addr in relayout");
+            if (aligned_4) {
+                return dispatch_transpose<equiv_ctype_storage<3, uint32_t>>(
+                        *transpose, sptr, dptr);
             }
-        } else if (dsize <= TRANSPOSE_CV_MAX_C) {
+            megdnn_log_error("unaligned addr in relayout");
+            return dispatch_transpose<equiv_ctype_storage<12>>(*transpose, sptr, dptr);
+        }
+        if (dsize <= TRANSPOSE_CV_MAX_C) {
             switch (dst.layout.dtype.enumv()) {
 #define cb(_dt)                                             \
     case DTypeTrait<dtype::_dt>::enumv:                     \
@@ -306,7 +342,17 @@ void RelayoutForwardImpl::exec_after_preprocess(
     if (is_contig(dst.layout) && is_contig(src.layout)) {
         auto sptr = src.raw_ptr, dptr = dst.raw_ptr;
         auto sz = src.layout.span().dist_byte();
-        MEGDNN_DISPATCH_CPU_KERN_OPR(memcpy(dptr, sptr, sz));
+        size_t nr_threads = get_nr_threads(handle());
+        if (nr_threads == 1 || sz < MIN_PARALLEL_BYTES) {
+            MEGDNN_DISPATCH_CPU_KERN_OPR(memcpy(dptr, sptr, sz));
+            return;
+        }
+        size_t chunk = round_up<size_t>(div_ceil(sz, nr_threads), 64);
+        auto kern = [=](size_t task, size_t) {
+            size_t begin = task * chunk, end = std::min(sz, begin + chunk);
+            memcpy(dptr + begin, sptr + begin, end - begin);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(kern, div_ceil(sz, chunk));
         return;
     }
 
@@ -13,6 +13,7 @@
 
 #include "megdnn/oprs.h"
 #include "src/common/relayout_helper.h"
+#include "src/naive/handle.h"
 #include "src/naive/relayout/opr_impl.h"
 
 namespace megdnn {
@@ -41,6 +42,58 @@ protected:
     void exec_after_preprocess(
             const TensorND& src, const TensorND& dst,
             relayout::TransposeParam* transpose);
+
+    //! a transpose split into tiles of (rows, cols) of each matrix
+    struct TransposeSplit {
+        //! whether to run on multiple threads
+        bool parallel;
+        size_t rows, cols, nr_row_tile, nr_col_tile;
+    };
+
+    /*!
+     * \brief split a transpose among the threads of the handle
+     *
+     * \param block_size size of a block of the transpose kernel; tiles would
+     *      be aligned to it
+     */
+    TransposeSplit get_transpose_split(
+            const relayout::TransposeParam& param, size_t dtype_size,
+            size_t block_size);
+
+    /*!
+     * \brief transpose contiguous (batch, m, n) to (batch, n, m) by
+     *      relayout::transpose_fallback with multiple threads
+     *
+     * The element type T can be a type with optimized transpose_block
+     * specialization.
+     */
+    template <typename T>
+    void dispatch_transpose(
+            const relayout::TransposeParam& param, const void* src, void* dst) {
+        using namespace relayout::transpose_fallback;
+        auto s = get_transpose_split(
+                param, sizeof(T), transpose_traits<T>::block_size);
+        auto sptr = static_cast<const T*>(src);
+        auto dptr = static_cast<T*>(dst);
+        size_t m = param.m, n = param.n;
+        auto handle = static_cast<naive::HandleImpl*>(this->handle());
+        if (!s.parallel) {
+            MEGDNN_DISPATCH_CPU_KERN(
+                    handle, transpose<T>(param.batch, m, n, sptr, dptr));
+            return;
+        }
+        auto kern = [=](size_t task, size_t) {
+            size_t nr_tile = s.nr_row_tile * s.nr_col_tile;
+            size_t b = task / nr_tile, tile = task % nr_tile;
+            size_t row = tile / s.nr_col_tile * s.rows,
+                   col = tile % s.nr_col_tile * s.cols;
+            transpose_range<T>(
+                    m, n, row, std::min(m, row + s.rows), col,
+                    std::min(n, col + s.cols), sptr + b * m * n, dptr + b * m * n);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                handle, param.batch * s.nr_row_tile * s.nr_col_tile, kern);
+    }
 };
 
 }  // namespace fallback
@@ -0,0 +1,101 @@
+/**
+ * \file dnn/src/fallback/remap/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/remap/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+#include "src/naive/remap/remap_linear.h"
+
+#include "midout.h"
+MIDOUT_DECL(megdnn_fallback_remap)
+
+using namespace megdnn;
+using namespace fallback;
+
+void RemapImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in map_xy, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, map_xy.layout, dst.layout, workspace.size);
+    if (param().imode != param::Remap::InterpolationMode::LINEAR) {
+        return naive::RemapImpl::exec(src, map_xy, dst, workspace);
+    }
+    int N, C, IH, IW, OH, OW;
+    if (param().format == param::Remap::Format::NCHW) {
+        N = src.layout.shape[0];
+        C = src.layout.shape[1];
+        IH = src.layout.shape[2];
+        IW = src.layout.shape[3];
+    } else if (param().format == param::Remap::Format::NHWC) {
+        N = src.layout.shape[0];
+        C = src.layout.shape[3];
+        IH = src.layout.shape[1];
+        IW = src.layout.shape[2];
+    } else {
+        return naive::RemapImpl::exec(src, map_xy, dst, workspace);
+    }
+    OH = map_xy.layout.shape[1];
+    OW = map_xy.layout.shape[2];
+    float scalar = param().scalar;
+    //! the rows of all the batch items are computed in parallel
+    switch (src.layout.dtype.enumv()) {
+#define cb(dt, fmt, border)                                                \
+    if (param().format == param::Remap::Format::fmt &&                     \
+        param().border_type == param::Remap::BorderMode::border) {         \
+        using ctype = DTypeTrait<dt>::ctype;                               \
+        auto sptr = src.compatible_ptr<ctype>();                           \
+        auto mptr = map_xy.compatible_ptr<dt_float32>();                   \
+        auto dptr = dst.compatible_ptr<ctype>();                           \
+        auto run = [=](size_t index, size_t) {                             \
+            int n = index / OH, h = index % OH;                            \
+            remap::remap_linear_row<                                       \
+                    ctype, param::Remap::Format::fmt,                      \
+                    param::Remap::BorderMode::border>(                     \
+                    sptr + n * C * IH * IW, mptr + n * OH * OW * 2,        \
+                    dptr + n * C * OH * OW, C, IH, IW, OH, OW, h, scalar); \
+        };                                                                 \
+        MIDOUT_BEGIN(megdnn_fallback_remap, midout_iv(0)) {                \
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, N* OH);         \
+        }                                                                  \
+        MIDOUT_END();                                                      \
+        return;                                                            \
+    }
+
+#define support_dtype(dt)          \
+    case DTypeTrait<dt>::enumv: {  \
+        cb(dt, NCHW, CONSTANT);    \
+        cb(dt, NCHW, REPLICATE);   \
+        cb(dt, NCHW, REFLECT);     \
+        cb(dt, NCHW, REFLECT_101); \
+        cb(dt, NCHW, WRAP);        \
+        cb(dt, NHWC, CONSTANT);    \
+        cb(dt, NHWC, REPLICATE);   \
+        cb(dt, NHWC, REFLECT);     \
+        cb(dt, NHWC, REFLECT_101); \
+        cb(dt, NHWC, WRAP);        \
+        break;                     \
+    }
+
+        support_dtype(dtype::Float32);
+        DNN_INC_FLOAT16(support_dtype(dtype::Float16));
+        DNN_INC_FLOAT16(support_dtype(dtype::BFloat16));
+        support_dtype(dtype::Int8);
+        support_dtype(dtype::Uint8);
+#undef cb
+#undef support_dtype
+
+        default:
+            break;
+    }
+    naive::RemapImpl::exec(src, map_xy, dst, workspace);
+}
+
+// vim: syntax=cpp.doxygen
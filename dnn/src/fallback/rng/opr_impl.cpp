@@ -0,0 +1,150 @@
+/**
+ * \file dnn/src/fallback/rng/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/rng/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! the blocks of the stream generated by a task
+constexpr size_t BLOCKS_PER_TASK = 1024;
+//! the blocks generated together, whose rounds are vectorizable
+constexpr size_t BATCH = 8;
+
+//! blocks [block, block + BATCH) of the stream, with out[j][l] the word j of
+//! block + l
+void generate_batch(uint64_t seed, uint64_t block, uint32_t (&out)[4][BATCH]) {
+    for (size_t l = 0; l < BATCH; ++l) {
+        out[0][l] = static_cast<uint32_t>(block + l);
+        out[1][l] = static_cast<uint32_t>((block + l) >> 32);
+        out[2][l] = out[3][l] = 0;
+    }
+    uint32_t k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+    for (int r = 0; r < 10; ++r) {
+        for (size_t l = 0; l < BATCH; ++l) {
+            uint64_t p0 = static_cast<uint64_t>(philox::M0) * out[0][l],
+                     p1 = static_cast<uint64_t>(philox::M1) * out[2][l];
+            uint32_t c1 = out[1][l], c3 = out[3][l];
+            out[0][l] = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            out[1][l] = static_cast<uint32_t>(p1);
+            out[2][l] = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            out[3][l] = static_cast<uint32_t>(p0);
+        }
+        k0 += philox::W0;
+        k1 += philox::W1;
+    }
+}
+
+/*!
+ * \brief fill the elements of blocks [begin, end) of dst, where block b takes
+ *      block offset + b of the stream
+ *
+ * \param fill fill(words, ptr, nr) writes nr <= 4 elements of a block
+ */
+template <typename ctype, typename Fill>
+void fill_blocks(
+        ctype* dst, size_t size, uint64_t seed, uint64_t offset, size_t begin,
+        size_t end, const Fill& fill) {
+    size_t b = begin;
+    for (; b + BATCH <= end && (b + BATCH) * 4 <= size; b += BATCH) {
+        uint32_t out[4][BATCH];
+        generate_batch(seed, offset + b, out);
+        for (size_t l = 0; l < BATCH; ++l) {
+            uint32_t words[4] = {out[0][l], out[1][l], out[2][l], out[3][l]};
+            fill(words, dst + (b + l) * 4, 4);
+        }
+    }
+    for (; b < end; ++b) {
+        uint32_t words[4];
+        philox::generate(seed, offset + b, words);
+        fill(words, dst + b * 4, std::min<size_t>(4, size - b * 4));
+    }
+}
+
+template <typename ctype, typename Fill>
+void dispatch_fill(
+        naive::HandleImpl* handle, ctype* dst, size_t size, uint64_t seed,
+        uint64_t offset, const Fill& fill) {
+    size_t nr_blocks = (size + 3) / 4,
+           nr_tasks = (nr_blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK;
+    auto kern = [=](size_t task, size_t) {
+        size_t begin = task * BLOCKS_PER_TASK,
+               end = std::min(begin + BLOCKS_PER_TASK, nr_blocks);
+        fill_blocks(dst, size, seed, offset, begin, end, fill);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_tasks, kern);
+}
+
+}  // anonymous namespace
+
+void UniformRNGImpl::exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    check_exec(dst.layout, workspace.size);
+    size_t size = dst.layout.total_nr_elems();
+    if (!size) {
+        return;
+    }
+    uint64_t seed = m_param.seed, offset = m_state.reserve(seed, (size + 3) / 4);
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                            \
+    case DTypeTrait<_dt>::enumv: {                                         \
+        using ctype = DTypeTrait<_dt>::ctype;                              \
+        auto fill = [](const uint32_t* words, ctype* ptr, size_t nr) {     \
+            for (size_t i = 0; i < nr; ++i) {                              \
+                ptr[i] = ctype(philox::to_uniform(words[i]));              \
+            }                                                              \
+        };                                                                 \
+        dispatch_fill(handle, dst.ptr<ctype>(), size, seed, offset, fill); \
+        return;                                                            \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("bad dtype");
+    }
+}
+
+void GaussianRNGImpl::exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    check_exec(dst.layout, workspace.size);
+    size_t size = dst.layout.total_nr_elems();
+    if (!size) {
+        return;
+    }
+    uint64_t seed = m_param.seed, offset = m_state.reserve(seed, (size + 3) / 4);
+    float mean = m_param.mean, std = m_param.std;
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                                 \
+    case DTypeTrait<_dt>::enumv: {                                              \
+        using ctype = DTypeTrait<_dt>::ctype;                                   \
+        auto fill = [mean, std](const uint32_t* words, ctype* ptr, size_t nr) { \
+            float z[4];                                                         \
+            philox::to_gaussian(words[0], words[1], mean, std, z[0], z[1]);     \
+            philox::to_gaussian(words[2], words[3], mean, std, z[2], z[3]);     \
+            for (size_t i = 0; i < nr; ++i) {                                   \
+                ptr[i] = ctype(z[i]);                                           \
+            }                                                                   \
+        };                                                                      \
+        dispatch_fill(handle, dst.ptr<ctype>(), size, seed, offset, fill);      \
+        return;                                                                 \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("bad dtype");
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,48 @@
+/**
+ * \file dnn/src/fallback/rng/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/oprs.h"
+#include "src/common/philox.cuh"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief uniform rng by the Philox streams, split among the threads by block
+ *      ranges; the results are the same as the CUDA impl
+ */
+class UniformRNGImpl : public UniformRNG {
+    philox::State m_state;
+
+public:
+    using UniformRNG::UniformRNG;
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
+
+    size_t get_workspace_in_bytes(const TensorLayout&) override { return 0; }
+};
+
+//! gaussian rng by the Box-Muller transform of the Philox streams
+class GaussianRNGImpl : public GaussianRNG {
+    philox::State m_state;
+
+public:
+    using GaussianRNG::GaussianRNG;
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
+
+    size_t get_workspace_in_bytes(const TensorLayout&) override { return 0; }
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
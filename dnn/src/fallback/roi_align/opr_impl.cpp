@@ -0,0 +1,184 @@
+/**
+ * \file dnn/src/fallback/roi_align/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/roi_align/opr_impl.h"
+
+#include "src/common/roi_align_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using Param = megdnn::ROIAlign::Param;
+
+//! channels of a roi computed by a task, which share the sampling table
+constexpr size_t CHANNEL_BLOCK = 16;
+
+//! a sampling point: the offsets of its four neighbours, whether they are in
+//! the feature map and the fractions of the bilinear interpolation
+struct Sample {
+    int offset[4];
+    bool valid[4];
+    float dh, dw;
+};
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+size_t get_table_size(const Param& param, size_t pooled_height, size_t pooled_width) {
+    return pooled_height * pooled_width * param.sample_height * param.sample_width;
+}
+
+//! the samples of a roi, in the order of the outputs and the sample grid
+template <typename T>
+void build_table(
+        const T* rois_ptr, const Param& param, int height, int width,
+        int pooled_height, int pooled_width, Sample* table) {
+    float spatial_scale = param.spatial_scale, offset = param.offset;
+    int sample_height = param.sample_height, sample_width = param.sample_width;
+    float roi_start_w = rois_ptr[1] * spatial_scale - offset;
+    float roi_start_h = rois_ptr[2] * spatial_scale - offset;
+    float roi_end_w = rois_ptr[3] * spatial_scale - offset;
+    float roi_end_h = rois_ptr[4] * spatial_scale - offset;
+
+    float roi_width = std::max(roi_end_w - roi_start_w, ((float)(0.0)));
+    float roi_height = std::max(roi_end_h - roi_start_h, ((float)(0.0)));
+    float bin_size_h = static_cast<float>(roi_height) / static_cast<float>(pooled_height);
+    float bin_size_w = static_cast<float>(roi_width) / static_cast<float>(pooled_width);
+    float sample_h_rate = 1.0f / float(sample_height);
+    float sample_w_rate = 1.0f / float(sample_width);
+
+    for (int ph = 0; ph < pooled_height; ++ph) {
+        for (int pw = 0; pw < pooled_width; ++pw) {
+            for (int h_iter = 0; h_iter < sample_height; ++h_iter) {
+                for (int w_iter = 0; w_iter < sample_width; ++w_iter) {
+                    // the same coordinates as the naive impl
+                    float h = roi_start_h +
+                              bin_size_h * (ph + sample_h_rate * (h_iter + 0.5f));
+                    float w = roi_start_w +
+                              bin_size_w * (pw + sample_w_rate * (w_iter + 0.5f));
+                    int h0 = floorf(h), w0 = floorf(w), h1 = h0 + 1, w1 = w0 + 1;
+                    bool h0_valid = h0 >= 0 && h0 < height,
+                         h1_valid = h1 >= 0 && h1 < height,
+                         w0_valid = w0 >= 0 && w0 < width,
+                         w1_valid = w1 >= 0 && w1 < width;
+                    Sample& s = *(table++);
+                    s.offset[0] = h0 * width + w0;
+                    s.offset[1] = h0 * width + w1;
+                    s.offset[2] = h1 * width + w0;
+                    s.offset[3] = h1 * width + w1;
+                    s.valid[0] = h0_valid && w0_valid;
+                    s.valid[1] = h0_valid && w1_valid;
+                    s.valid[2] = h1_valid && w0_valid;
+                    s.valid[3] = h1_valid && w1_valid;
+                    s.dh = h - h0;
+                    s.dw = w - w0;
+                }
+            }
+        }
+    }
+}
+
+//! the same as roi_align::bilinear_interp with the precomputed sample
+template <typename T>
+T interp(const T* data, const Sample& s) {
+    T top_left = s.valid[0] ? data[s.offset[0]] : T(0.f);
+    T top_right = s.valid[1] ? data[s.offset[1]] : T(0.f);
+    T bottom_left = s.valid[2] ? data[s.offset[2]] : T(0.f);
+    T bottom_right = s.valid[3] ? data[s.offset[3]] : T(0.f);
+    T top = top_left + (top_right - top_left) * static_cast<T>(s.dw);
+    T bottom = bottom_left + (bottom_right - bottom_left) * static_cast<T>(s.dw);
+    return top + (bottom - top) * static_cast<T>(s.dh);
+}
+
+template <typename T, typename Pooler>
+void forward(
+        naive::HandleImpl* handle, _megdnn_tensor_in src, _megdnn_tensor_in rois,
+        _megdnn_tensor_out dst, _megdnn_tensor_out index, const Param& param,
+        Sample* workspace) {
+    size_t channels = src.layout[1], height = src.layout[2], width = src.layout[3];
+    size_t pooled_height = dst.layout[2], pooled_width = dst.layout[3];
+    size_t nr_rois = rois.layout[0], nr_blocks = div_ceil(channels, CHANNEL_BLOCK);
+    size_t nr_outputs = pooled_height * pooled_width,
+           nr_samples = param.sample_height * param.sample_width,
+           table_size = get_table_size(param, pooled_height, pooled_width);
+    auto src_ptr = src.ptr<T>(), rois_ptr = rois.ptr<T>(), dst_ptr = dst.ptr<T>();
+    auto index_ptr = index.ptr<dt_int32>();
+
+    auto kern = [=](size_t task, size_t thread_id) {
+        size_t n = task / nr_blocks, block = task % nr_blocks;
+        Sample* table = workspace + thread_id * table_size;
+        const T* roi = rois_ptr + n * 5;
+        int roi_batch_ind = roi[0];
+        build_table(roi, param, height, width, pooled_height, pooled_width, table);
+        size_t c_end = std::min(channels, (block + 1) * CHANNEL_BLOCK);
+        for (size_t c = block * CHANNEL_BLOCK; c < c_end; ++c) {
+            const T* feat_map_ptr =
+                    src_ptr + (roi_batch_ind * channels + c) * height * width;
+            size_t out_begin = (n * channels + c) * nr_outputs;
+            const Sample* s = table;
+            for (size_t o = 0; o < nr_outputs; ++o) {
+                Pooler pooler;
+                for (size_t k = 0; k < nr_samples; ++k) {
+                    pooler.feed(interp(feat_map_ptr, *(s++)), k);
+                }
+                pooler.writeback_val(dst_ptr[out_begin + o]);
+                pooler.writeback_idx(index_ptr[out_begin + o]);
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_rois * nr_blocks, kern);
+}
+
+}  // anonymous namespace
+
+size_t ROIAlignForwardImpl::get_workspace_in_bytes(
+        const TensorLayout&, const TensorLayout&, const TensorLayout& dst,
+        const TensorLayout&) {
+    return get_table_size(param(), dst[2], dst[3]) * sizeof(Sample) *
+           get_nr_threads(handle());
+}
+
+void ROIAlignForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in rois, _megdnn_tensor_out dst,
+        _megdnn_tensor_out index, _megdnn_workspace workspace) {
+    check_exec(src.layout, rois.layout, dst.layout, index.layout, workspace.size);
+    if (!dst.layout.total_nr_elems()) {
+        return;
+    }
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    auto table = workspace.ptr<Sample>();
+#define cb(DType)                                                       \
+    if (src.layout.dtype == DType()) {                                  \
+        using T = typename DTypeTrait<DType>::ctype;                    \
+        switch (param().mode) {                                         \
+            case Param::Mode::MAX:                                      \
+                forward<T, roi_align::MaxPooler<T>>(                    \
+                        handle, src, rois, dst, index, param(), table); \
+                return;                                                 \
+            case Param::Mode::AVERAGE:                                  \
+                forward<T, roi_align::AveragePooler<T>>(                \
+                        handle, src, rois, dst, index, param(), table); \
+                return;                                                 \
+            default:                                                    \
+                megdnn_assert_internal(false);                          \
+        }                                                               \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_throw("bad dtype");
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,134 @@
+/**
+ * \file dnn/src/fallback/roi_pooling/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/roi_pooling/opr_impl.h"
+
+#include "src/common/roi_pooling_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cmath>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using Param = param::ROIPooling;
+
+//! channels of a roi computed by a task, which share the bins
+constexpr size_t CHANNEL_BLOCK = 16;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+//! [start, end) of the bins along an axis clipped to [0, size)
+void compute_bins(
+        int roi_start, int roi_end, int pooled_size, int size, int* start, int* end) {
+    // Force malformed ROIs to be 1x1
+    int roi_size = std::max(roi_end - roi_start + 1, 1);
+    float bin_size = static_cast<float>(roi_size) / static_cast<float>(pooled_size);
+    for (int p = 0; p < pooled_size; ++p) {
+        int pstart = static_cast<int>(floor(static_cast<float>(p) * bin_size));
+        int pend = static_cast<int>(ceil(static_cast<float>(p + 1) * bin_size));
+        start[p] = std::min<int>(std::max(pstart + roi_start, 0), size);
+        end[p] = std::min<int>(std::max(pend + roi_start, 0), size);
+    }
+}
+
+template <typename T, typename Pooler>
+void forward(
+        naive::HandleImpl* handle, _megdnn_tensor_in src, _megdnn_tensor_in rois,
+        _megdnn_tensor_out dst, _megdnn_tensor_out index, float spatial_scale,
+        int* workspace) {
+    size_t channels = src.layout[1], height = src.layout[2], width = src.layout[3];
+    size_t pooled_height = dst.layout[2], pooled_width = dst.layout[3];
+    size_t nr_rois = rois.layout[0], nr_blocks = div_ceil(channels, CHANNEL_BLOCK);
+    size_t nr_bins = (pooled_height + pooled_width) * 2;
+    auto src_ptr = src.ptr<T>(), rois_ptr = rois.ptr<T>(), dst_ptr = dst.ptr<T>();
+    auto index_ptr = index.ptr<dt_int32>();
+
+    auto kern = [=](size_t task, size_t thread_id) {
+        size_t n = task / nr_blocks, block = task % nr_blocks;
+        int *hstart = workspace + thread_id * nr_bins, *hend = hstart + pooled_height,
+            *wstart = hend + pooled_height, *wend = wstart + pooled_width;
+        const T* roi = rois_ptr + n * 5;
+        int roi_batch_ind = roi[0];
+        int roi_start_w = round(roi[1] * spatial_scale);
+        int roi_start_h = round(roi[2] * spatial_scale);
+        int roi_end_w = round(roi[3] * spatial_scale);
+        int roi_end_h = round(roi[4] * spatial_scale);
+        compute_bins(roi_start_h, roi_end_h, pooled_height, height, hstart, hend);
+        compute_bins(roi_start_w, roi_end_w, pooled_width, width, wstart, wend);
+
+        size_t c_end = std::min(channels, (block + 1) * CHANNEL_BLOCK);
+        for (size_t c = block * CHANNEL_BLOCK; c < c_end; ++c) {
+            const T* feat_map_ptr =
+                    src_ptr + (roi_batch_ind * channels + c) * height * width;
+            size_t out = (n * channels + c) * pooled_height * pooled_width;
+            for (size_t ph = 0; ph < pooled_height; ++ph) {
+                for (size_t pw = 0; pw < pooled_width; ++pw, ++out) {
+                    Pooler pooler;
+                    for (int h = hstart[ph]; h < hend[ph]; ++h) {
+                        const T* row = feat_map_ptr + h * width;
+                        for (int w = wstart[pw]; w < wend[pw]; ++w) {
+                            pooler.feed(row[w], h * width + w);
+                        }
+                    }
+                    pooler.writeback_val(dst_ptr[out]);
+                    pooler.writeback_idx(index_ptr[out]);
+                }
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_rois * nr_blocks, kern);
+}
+
+}  // anonymous namespace
+
+size_t ROIPoolingForwardImpl::get_workspace_in_bytes(
+        const TensorLayout&, const TensorLayout&, const TensorLayout& dst,
+        const TensorLayout&) {
+    return (dst[2] + dst[3]) * 2 * sizeof(int) * get_nr_threads(handle());
+}
+
+void ROIPoolingForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in rois, _megdnn_tensor_out dst,
+        _megdnn_tensor_out index, _megdnn_workspace workspace) {
+    check_exec(src.layout, rois.layout, dst.layout, index.layout, workspace.size);
+    if (!dst.layout.total_nr_elems()) {
+        return;
+    }
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    auto bins = workspace.ptr<int>();
+#define cb(DType)                                                            \
+    if (src.layout.dtype == DType()) {                                       \
+        using T = typename DTypeTrait<DType>::ctype;                         \
+        switch (param().mode) {                                              \
+            case Param::Mode::MAX:                                           \
+                forward<T, roi_pooling::MaxPooler<T>>(                       \
+                        handle, src, rois, dst, index, param().scale, bins); \
+                return;                                                      \
+            case Param::Mode::AVERAGE:                                       \
+                forward<T, roi_pooling::AveragePooler<T>>(                   \
+                        handle, src, rois, dst, index, param().scale, bins); \
+                return;                                                      \
+            default:                                                         \
+                megdnn_assert_internal(false);                               \
+        }                                                                    \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_throw("bad dtype");
+}
+
+// vim: syntax=cpp.doxygen
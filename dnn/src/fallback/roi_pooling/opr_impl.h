@@ -0,0 +1,37 @@
+/**
+ * \file dnn/src/fallback/roi_pooling/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/oprs.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief ROIPooling forward computed in parallel over blocks of channels of
+ *      each roi, which share the bin boundaries of the roi
+ */
+class ROIPoolingForwardImpl final : public ROIPoolingForward {
+public:
+    using ROIPoolingForward::ROIPoolingForward;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in rois, _megdnn_tensor_out dst,
+            _megdnn_tensor_out index, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& rois, const TensorLayout& dst,
+            const TensorLayout& index) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
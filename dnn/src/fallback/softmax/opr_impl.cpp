@@ -0,0 +1,193 @@
+/**
+ * \file dnn/src/fallback/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/softmax/opr_impl.h"
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! number of columns processed together if softmax axis is not the last one
+constexpr size_t COL_BLOCK = 256;
+
+//! minimal number of elements processed by a thread along the last axis
+constexpr size_t MIN_TASK_SIZE = 16384;
+
+/*!
+ * \brief softmax of \p width columns with stride \p C, each of which has \p B
+ *      elements
+ */
+void softmax_cols(const float* src, float* dst, size_t B, size_t C, size_t width) {
+    float max_val[COL_BLOCK], sum[COL_BLOCK];
+    std::copy(src, src + width, max_val);
+    for (size_t b = 1; b < B; ++b) {
+        const float* sptr = src + b * C;
+        for (size_t i = 0; i < width; ++i) {
+            max_val[i] = std::max(max_val[i], sptr[i]);
+        }
+    }
+    std::fill(sum, sum + width, 0.f);
+    for (size_t b = 0; b < B; ++b) {
+        const float* sptr = src + b * C;
+        float* dptr = dst + b * C;
+        for (size_t i = 0; i < width; ++i) {
+            dptr[i] = std::exp(sptr[i] - max_val[i]);
+            sum[i] += dptr[i];
+        }
+    }
+    for (size_t i = 0; i < width; ++i) {
+        sum[i] = 1.f / sum[i];
+    }
+    for (size_t b = 0; b < B; ++b) {
+        float* dptr = dst + b * C;
+        for (size_t i = 0; i < width; ++i) {
+            dptr[i] *= sum[i];
+        }
+    }
+}
+
+void softmax_bwd_rows(
+        const float* y, const float* diff, float* grad, size_t nr_row, size_t len) {
+    for (size_t r = 0; r < nr_row; ++r, y += len, diff += len, grad += len) {
+        float dot = 0.f;
+        for (size_t i = 0; i < len; ++i) {
+            dot += y[i] * diff[i];
+        }
+        for (size_t i = 0; i < len; ++i) {
+            grad[i] = (diff[i] - dot) * y[i];
+        }
+    }
+}
+
+void softmax_bwd_cols(
+        const float* y, const float* diff, float* grad, size_t B, size_t C,
+        size_t width) {
+    float dot[COL_BLOCK];
+    std::fill(dot, dot + width, 0.f);
+    for (size_t b = 0; b < B; ++b) {
+        const float *yptr = y + b * C, *hptr = diff + b * C;
+        for (size_t i = 0; i < width; ++i) {
+            dot[i] += yptr[i] * hptr[i];
+        }
+    }
+    for (size_t b = 0; b < B; ++b) {
+        const float *yptr = y + b * C, *hptr = diff + b * C;
+        float* gptr = grad + b * C;
+        for (size_t i = 0; i < width; ++i) {
+            gptr[i] = (hptr[i] - dot[i]) * yptr[i];
+        }
+    }
+}
+
+/*!
+ * \brief dispatch a row kernel or a column kernel on (A, B, C) shaped tensors
+ *
+ * \param row_kern called as row_kern(offset, nr_row) if C == 1
+ * \param col_kern called as col_kern(offset, width) otherwise
+ */
+template <typename RowFunc, typename ColFunc>
+void dispatch_softmax(
+        naive::HandleImpl* handle, size_t A, size_t B, size_t C, RowFunc row_kern,
+        ColFunc col_kern) {
+    if (!A || !B || !C) {
+        return;
+    }
+    if (C == 1) {
+        size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+        size_t nr_task = std::min(
+                {nr_threads, A, std::max<size_t>(A * B / MIN_TASK_SIZE, 1)});
+        size_t rows_per_task = div_ceil(A, nr_task);
+        nr_task = div_ceil(A, rows_per_task);
+        auto kern = [=](size_t task, size_t) {
+            size_t begin = task * rows_per_task,
+                   end = std::min(A, begin + rows_per_task);
+            row_kern(begin * B, end - begin);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, kern);
+        return;
+    }
+    size_t nr_col_block = div_ceil(C, COL_BLOCK);
+    auto kern = [=](size_t task, size_t) {
+        size_t a = task / nr_col_block, c = task % nr_col_block * COL_BLOCK;
+        col_kern(a * B * C + c, std::min(COL_BLOCK, C - c));
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, A * nr_col_block, kern);
+}
+
+}  // anonymous namespace
+
+void SoftmaxForwardImpl::softmax_rows(
+        const float* src, float* dst, size_t nr_row, size_t len) {
+    for (size_t r = 0; r < nr_row; ++r, src += len, dst += len) {
+        float max_val = src[0];
+        for (size_t i = 1; i < len; ++i) {
+            max_val = std::max(max_val, src[i]);
+        }
+        float sum = 0.f;
+        for (size_t i = 0; i < len; ++i) {
+            dst[i] = std::exp(src[i] - max_val);
+            sum += dst[i];
+        }
+        float scale = 1.f / sum;
+        for (size_t i = 0; i < len; ++i) {
+            dst[i] *= scale;
+        }
+    }
+}
+
+void SoftmaxForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    if (src.layout.dtype != dtype::Float32()) {
+        return naive::SoftmaxForwardImpl::exec(src, dst, workspace);
+    }
+    check_exec(src.layout, dst.layout, workspace.size);
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, get_axis(src.layout.ndim));
+    const float* sptr = src.ptr<dt_float32>();
+    float* dptr = dst.ptr<dt_float32>();
+    auto kern = get_row_kern();
+    dispatch_softmax(
+            static_cast<naive::HandleImpl*>(handle()), A, B, C,
+            [=](size_t off, size_t nr_row) { kern(sptr + off, dptr + off, nr_row, B); },
+            [=](size_t off, size_t width) {
+                softmax_cols(sptr + off, dptr + off, B, C, width);
+            });
+}
+
+void SoftmaxBackwardImpl::exec(
+        _megdnn_tensor_in dst, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+        _megdnn_workspace workspace) {
+    if (dst.layout.dtype != dtype::Float32()) {
+        return naive::SoftmaxBackwardImpl::exec(dst, diff, grad, workspace);
+    }
+    check_exec(dst.layout, diff.layout, grad.layout, workspace.size);
+    size_t A, B, C;
+    reduce::get_ABC(dst.layout, A, B, C, get_axis(dst.layout.ndim));
+    const float *yptr = dst.ptr<dt_float32>(), *hptr = diff.ptr<dt_float32>();
+    float* gptr = grad.ptr<dt_float32>();
+    dispatch_softmax(
+            static_cast<naive::HandleImpl*>(handle()), A, B, C,
+            [=](size_t off, size_t nr_row) {
+                softmax_bwd_rows(yptr + off, hptr + off, gptr + off, nr_row, B);
+            },
+            [=](size_t off, size_t width) {
+                softmax_bwd_cols(yptr + off, hptr + off, gptr + off, B, C, width);
+            });
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,52 @@
+/**
+ * \file dnn/src/fallback/softmax/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/softmax/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief float32 softmax that computes rows (or column blocks if the axis is
+ *      not the last one) in parallel
+ */
+class SoftmaxForwardImpl : public naive::SoftmaxForwardImpl {
+public:
+    using naive::SoftmaxForwardImpl::SoftmaxForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+
+    //! compute softmax of \p nr_row contiguous rows of length \p len
+    using RowKern = void (*)(const float* src, float* dst, size_t nr_row, size_t len);
+
+    //! portable row kernel which is auto-vectorized by the compiler
+    static void softmax_rows(const float* src, float* dst, size_t nr_row, size_t len);
+
+protected:
+    //! kernel used along the last axis; overridden by arch-specific impls
+    virtual RowKern get_row_kern() const { return softmax_rows; }
+};
+
+class SoftmaxBackwardImpl : public naive::SoftmaxBackwardImpl {
+public:
+    using naive::SoftmaxBackwardImpl::SoftmaxBackwardImpl;
+    void exec(
+            _megdnn_tensor_in dst, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+            _megdnn_workspace workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,194 @@
+/**
+ * \file dnn/src/fallback/topk/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/fallback/topk/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! a row is split among threads only if each thread gets this many elements
+constexpr size_t MIN_SEGMENT_SIZE = 4096;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+template <typename ctype>
+void load(ctype* dst, const ctype* src, size_t begin, size_t end) {
+    memcpy(dst + begin, src + begin, sizeof(ctype) * (end - begin));
+}
+
+template <typename ctype>
+void load(std::pair<ctype, uint32_t>* dst, const ctype* src, size_t begin, size_t end) {
+    for (size_t j = begin; j < end; ++j) {
+        dst[j].first = src[j];
+        dst[j].second = j;
+    }
+}
+
+//! store the k-th element for KTH_ONLY mode
+template <typename ctype>
+void store(const ctype* wk, size_t k, ctype* values, int*) {
+    values[0] = wk[k - 1];
+}
+
+template <typename ctype>
+void store(
+        const std::pair<ctype, uint32_t>* wk, size_t k, ctype* values, int* indices) {
+    for (size_t j = 0; j < k; ++j) {
+        values[j] = wk[j].first;
+        indices[j] = wk[j].second;
+    }
+}
+
+//! move the first k elements in \p wk of [0, n) by \p cmp to the front
+template <typename T, typename Cmp>
+void select(T* wk, size_t n, size_t k, bool sorted, Cmp cmp) {
+    if (sorted) {
+        std::partial_sort(wk, wk + std::min(k, n), wk + n, cmp);
+    } else if (k < n) {
+        std::nth_element(wk, wk + k - 1, wk + n, cmp);
+    }
+}
+
+/*!
+ * \param T element type in workspace: ctype for KTH_ONLY, and (value, index)
+ *      pairs for the other modes
+ * \param k number of elements to be selected
+ * \param ow number of outputs of each row
+ */
+template <typename ctype, typename T, typename Cmp>
+void dispatch_topk(
+        naive::HandleImpl* handle, size_t k, size_t ow, bool sorted, size_t m,
+        size_t n, ptrdiff_t lda, const ctype* data, ctype* values, int* indices,
+        T* workspace) {
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t segment = div_ceil(n, nr_threads);
+    if (m >= nr_threads || segment < std::max(MIN_SEGMENT_SIZE, k * 4)) {
+        auto kern = [=](size_t i, size_t thread_id) {
+            T* wk = workspace + thread_id * n;
+            load(wk, data + i * lda, 0, n);
+            select(wk, n, k, sorted, Cmp{});
+            store(wk, k, values + i * ow, indices + i * ow);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, m, kern);
+        return;
+    }
+
+    // each thread selects k candidates in its segment; the candidates are
+    // then gathered to select the final results
+    for (size_t i = 0; i < m; ++i) {
+        const ctype* row = data + i * lda;
+        auto select_segment = [=](size_t s, size_t) {
+            size_t begin = s * segment, end = std::min(n, begin + segment);
+            load(workspace, row, begin, end);
+            select(workspace + begin, end - begin, k, false, Cmp{});
+        };
+        auto select_candidate = [=]() {
+            size_t nr_candidate = 0;
+            for (size_t begin = 0; begin < n; begin += segment) {
+                size_t size = std::min({k, segment, n - begin});
+                std::move(
+                        workspace + begin, workspace + begin + size,
+                        workspace + nr_candidate);
+                nr_candidate += size;
+            }
+            select(workspace, nr_candidate, k, sorted, Cmp{});
+            store(workspace, k, values + i * ow, indices + i * ow);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                handle, div_ceil(n, segment), select_segment);
+        MEGDNN_DISPATCH_CPU_KERN(handle, select_candidate());
+    }
+}
+
+}  // anonymous namespace
+
+template <typename ctype>
+void TopKImpl::dispatch_with_ctype(
+        int k, size_t m, size_t n, ptrdiff_t lda, const ctype* data, ctype* values,
+        int* indices, void* workspace) {
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    size_t abs_k = std::abs(k);
+    using Pair = std::pair<ctype, uint32_t>;
+    auto pairs = static_cast<Pair*>(workspace);
+    switch (param().mode) {
+        case Param::Mode::KTH_ONLY:
+            if (k < 0) {
+                dispatch_topk<ctype, ctype, std::greater<ctype>>(
+                        handle, abs_k, 1, false, m, n, lda, data, values, indices,
+                        static_cast<ctype*>(workspace));
+            } else {
+                dispatch_topk<ctype, ctype, std::less<ctype>>(
+                        handle, abs_k, 1, false, m, n, lda, data, values, indices,
+                        static_cast<ctype*>(workspace));
+            }
+            break;
+        case Param::Mode::VALUE_IDX_NOSORT:
+        case Param::Mode::VALUE_IDX_SORTED: {
+            megdnn_assert(n <= std::numeric_limits<uint32_t>::max());
+            bool sorted = param().mode == Param::Mode::VALUE_IDX_SORTED;
+            if (k < 0) {
+                dispatch_topk<ctype, Pair, std::greater<Pair>>(
+                        handle, abs_k, abs_k, sorted, m, n, lda, data, values, indices,
+                        pairs);
+            } else {
+                dispatch_topk<ctype, Pair, std::less<Pair>>(
+                        handle, abs_k, abs_k, sorted, m, n, lda, data, values, indices,
+                        pairs);
+            }
+            break;
+        }
+        default:
+            megdnn_throw("invalid TopK mode");
+    }
+}
+
+void TopKImpl::do_exec(
+        int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+        _megdnn_workspace workspace) {
+    size_t m = data.layout[0], n = data.layout[1];
+    ptrdiff_t lda = data.layout.stride[0];
+    switch (data.layout.dtype.enumv()) {
+#define cb(t)                                                                \
+    case DTypeTrait<t>::enumv:                                               \
+        do {                                                                 \
+            using ct = DTypeTrait<t>::ctype;                                 \
+            dispatch_with_ctype<ct>(                                         \
+                    k, m, n, lda, data.ptr<ct>(), values.ptr<ct>(), indices, \
+                    workspace.raw_ptr);                                      \
+            return;                                                          \
+        } while (0);
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb);
+#undef cb
+        default:
+            megdnn_throw("unsupported dtype in fallback TopKImpl");
+    }
+}
+
+size_t TopKImpl::get_workspace_in_bytes(
+        int k, const TensorLayout& data, const TensorLayout& values,
+        const TensorLayout& indices) {
+    // the workspace of naive impl for each thread
+    return naive::TopKImpl::get_workspace_in_bytes(k, data, values, indices) *
+           get_nr_threads(handle());
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,114 @@
+/**
+ * \file dnn/src/fallback/weight_quant_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/weight_quant_matrix_mul/opr_impl.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! number of independent accumulators of a dot product
+constexpr size_t NR_LANE = 8;
+
+MEGDNN_FORCE_INLINE float dot(const float* a, const float* b, size_t len) {
+    float acc[NR_LANE] = {0.f};
+    size_t i = 0;
+    for (; i + NR_LANE <= len; i += NR_LANE) {
+        for (size_t k = 0; k < NR_LANE; ++k) {
+            acc[k] += a[i + k] * b[i + k];
+        }
+    }
+    float sum = 0.f;
+    for (; i < len; ++i) {
+        sum += a[i] * b[i];
+    }
+    for (size_t k = 0; k < NR_LANE; ++k) {
+        sum += acc[k];
+    }
+    return sum;
+}
+
+//! dequantize a weight row of K values, leaving the scale to the output
+void unpack_row(const dt_int8* w, float* dst, size_t K, uint32_t bits) {
+    if (bits == 8) {
+        for (size_t k = 0; k < K; ++k) {
+            dst[k] = w[k];
+        }
+        return;
+    }
+    size_t k = 0;
+    for (; k + 2 <= K; k += 2) {
+        dt_int8 byte = w[k / 2];
+        dst[k] = static_cast<dt_int8>(byte << 4) >> 4;
+        dst[k + 1] = byte >> 4;
+    }
+    if (k < K) {
+        dst[k] = static_cast<dt_int8>(w[k / 2] << 4) >> 4;
+    }
+}
+
+}  // anonymous namespace
+
+size_t WeightQuantMatrixMulForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& weight, const TensorLayout& scale,
+        const TensorLayout& dst) {
+    if (src.dtype != dtype::Float32()) {
+        return naive::WeightQuantMatrixMulForwardImpl::get_workspace_in_bytes(
+                src, weight, scale, dst);
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    return nr_threads * BLOCK_N * src[1] * sizeof(float);
+}
+
+void WeightQuantMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in weight, _megdnn_tensor_in scale,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    if (src.layout.dtype != dtype::Float32()) {
+        return naive::WeightQuantMatrixMulForwardImpl::exec(
+                src, weight, scale, dst, workspace);
+    }
+    check_exec(src.layout, weight.layout, scale.layout, dst.layout, workspace.size);
+    size_t M = src.layout[0], K = src.layout[1], N = weight.layout[0];
+    if (!M || !N) {
+        return;
+    }
+    uint32_t bits = param().bits;
+    size_t row_bytes = weight.layout[1];
+    const float *sptr = src.ptr<dt_float32>(), *scptr = scale.ptr<dt_float32>();
+    const dt_int8* wptr = weight.ptr<dt_int8>();
+    float *dptr = dst.ptr<dt_float32>(), *wsptr = workspace.ptr<dt_float32>();
+    size_t block_n = BLOCK_N, block_m = BLOCK_M, nr_m_block = div_ceil(M, block_m),
+           nr_task = div_ceil(N, block_n) * nr_m_block;
+    auto kern = [=](size_t task, size_t thread_id) {
+        size_t n0 = task / nr_m_block * block_n, m0 = task % nr_m_block * block_m,
+               nr_n = std::min(block_n, N - n0), nr_m = std::min(block_m, M - m0);
+        float* w = wsptr + thread_id * block_n * K;
+        for (size_t i = 0; i < nr_n; ++i) {
+            unpack_row(wptr + (n0 + i) * row_bytes, w + i * K, K, bits);
+        }
+        for (size_t m = m0; m < m0 + nr_m; ++m) {
+            for (size_t i = 0; i < nr_n; ++i) {
+                dptr[m * N + n0 + i] = dot(sptr + m * K, w + i * K, K) * scptr[n0 + i];
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            static_cast<naive::HandleImpl*>(handle()), nr_task, kern);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,45 @@
+/**
+ * \file dnn/src/fallback/weight_quant_matrix_mul/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/weight_quant_matrix_mul/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief float32 matmul on quantized weights
+ *
+ * Each task dequantizes BLOCK_N weight rows into the thread workspace and
+ * applies them to BLOCK_M rows of src, so each weight is read once per
+ * BLOCK_M rows. The tasks are computed in parallel.
+ */
+class WeightQuantMatrixMulForwardImpl : public naive::WeightQuantMatrixMulForwardImpl {
+public:
+    using naive::WeightQuantMatrixMulForwardImpl::WeightQuantMatrixMulForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in weight, _megdnn_tensor_in scale,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& weight,
+            const TensorLayout& scale, const TensorLayout& dst) override;
+
+    //! number of output channels of a task
+    static constexpr size_t BLOCK_N = 8;
+    //! number of rows of src of a task
+    static constexpr size_t BLOCK_M = 32;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -206,16 +206,30 @@ void bn_backward_exec(
     rep_4d_end
 }
 
+template <typename T>
+void bn_relu_exec(_megdnn_tensor_inout dst, uint8_t* mask) {
+    bn_relu::forward(dst.ptr<T>(), mask, 0, dst.layout.total_nr_elems());
+}
+
+template <typename T>
+void bn_relu_mask_grad(_megdnn_tensor_in dy, const uint8_t* mask, void* masked_dy) {
+    bn_relu::backward(
+            dy.ptr<T>(), mask, static_cast<T*>(masked_dy), 0,
+            dy.layout.total_nr_elems());
+}
+
 };  // anonymous namespace
 
 void BNForwardImpl::exec(
         _megdnn_tensor_in src, _megdnn_tensor_in bn_scale, _megdnn_tensor_in bn_bias,
         _megdnn_tensor_inout mean, _megdnn_tensor_inout variance,
         _megdnn_tensor_out batch_mean, _megdnn_tensor_out batch_inv_variance,
-        _megdnn_tensor_out, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+        _megdnn_tensor_out reserve, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
     check_exec(
             src.layout, bn_scale.layout, bn_bias.layout, mean.layout, variance.layout,
-            batch_mean.layout, batch_inv_variance.layout, dst.layout, workspace.size);
+            batch_mean.layout, batch_inv_variance.layout, dst.layout, workspace.size,
+            reserve.layout.access_bytes());
 
     DNN_INC_FLOAT16(
             if (src.layout.dtype == dtype::Float16() &&
@@ -239,6 +253,25 @@ void BNForwardImpl::exec(
         break;                                                      \
     }
             MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+            default:
+                megdnn_assert_internal(0);
+        }
+    }
+
+    if (m_param.nonlineMode == Param::NonlineMode::RELU) {
+        // only training needs the mask, which is consumed by BNBackward
+        uint8_t* mask = bn_relu::need_mask(m_param)
+                              ? static_cast<uint8_t*>(reserve.raw_ptr)
+                              : nullptr;
+        switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                     \
+    case DTypeTrait<_dt>::enumv: {                                  \
+        using T = typename DTypeTrait<_dt>::ctype;                  \
+        MEGDNN_DISPATCH_CPU_KERN_OPR((bn_relu_exec<T>(dst, mask))); \
+        break;                                                      \
+    }
+            MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
 #undef cb
             default:
                 megdnn_assert_internal(0);
@@ -247,10 +280,10 @@ void BNForwardImpl::exec(
 }
 
 WorkspaceBundle BNBackwardImpl::get_workspace_bundle(
-        size_t x_size, size_t param_size, void* raw_ptr) {
+        size_t x_size, size_t param_size, size_t masked_dy_size, void* raw_ptr) {
     return {raw_ptr,
             {sizeof(float) * x_size, sizeof(float) * param_size,
-             sizeof(float) * param_size}};
+             sizeof(float) * param_size, masked_dy_size}};
 }
 
 size_t BNBackwardImpl::get_workspace_in_bytes(
@@ -258,23 +291,47 @@ size_t BNBackwardImpl::get_workspace_in_bytes(
         const TensorLayout&, const TensorLayout& bn_scale, const TensorLayout&,
         const TensorLayout&, const TensorLayout&, const TensorLayout&) {
     auto x_size = x.total_nr_elems(), param_size = bn_scale.total_nr_elems();
-    return get_workspace_bundle(x_size, param_size).total_size_in_bytes();
+    size_t masked_dy_size = bn_relu::need_mask(m_param) ? x.span().dist_byte() : 0;
+    return get_workspace_bundle(x_size, param_size, masked_dy_size)
+            .total_size_in_bytes();
 }
 
 void BNBackwardImpl::exec(
         _megdnn_tensor_in x_in, _megdnn_tensor_in dy_in,
         _megdnn_tensor_in saved_batch_mean, _megdnn_tensor_in saved_batch_inv_variance,
-        _megdnn_tensor_in bn_scale, _megdnn_tensor_in, _megdnn_tensor_out d_bn_scale,
-        _megdnn_tensor_out d_bn_bias, _megdnn_tensor_out dx_out,
-        _megdnn_workspace workspace) {
+        _megdnn_tensor_in bn_scale, _megdnn_tensor_in reserve,
+        _megdnn_tensor_out d_bn_scale, _megdnn_tensor_out d_bn_bias,
+        _megdnn_tensor_out dx_out, _megdnn_workspace workspace) {
     check_exec(
             x_in.layout, dy_in.layout, saved_batch_mean.layout,
             saved_batch_inv_variance.layout, bn_scale.layout, d_bn_scale.layout,
-            d_bn_bias.layout, dx_out.layout, workspace.size);
+            d_bn_bias.layout, dx_out.layout, workspace.size,
+            reserve.layout.access_bytes());
 
+    bool need_mask = bn_relu::need_mask(m_param);
     auto&& bundle = get_workspace_bundle(
             x_in.layout.total_nr_elems(), bn_scale.layout.total_nr_elems(),
-            workspace.raw_ptr);
+            need_mask ? dy_in.layout.span().dist_byte() : 0, workspace.raw_ptr);
+
+    TensorND dy = dy_in;
+    if (need_mask) {
+        // backward through the fused relu: dz = dy * (z > 0)
+        auto mask = static_cast<const uint8_t*>(reserve.raw_ptr);
+        switch (dy_in.layout.dtype.enumv()) {
+#define cb(_dt)                                                      \
+    case DTypeTrait<_dt>::enumv: {                                   \
+        using T = typename DTypeTrait<_dt>::ctype;                   \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(                                \
+                (bn_relu_mask_grad<T>(dy_in, mask, bundle.get(3)))); \
+        break;                                                       \
+    }
+            MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+            default:
+                megdnn_assert_internal(0);
+        }
+        dy.raw_ptr = bundle.get(3);
+    }
 
     DNN_INC_FLOAT16(
             if (x_in.layout.dtype == dtype::Float16() &&
@@ -283,19 +340,19 @@ void BNBackwardImpl::exec(
                     using T0 = typename DTypeTrait<dtype::Float16>::ctype;
                     using T1 = typename DTypeTrait<dtype::Float32>::ctype;
                     bn_backward_exec<T0, T1>(
-                            x_in, dy_in, saved_batch_mean, saved_batch_inv_variance,
+                            x_in, dy, saved_batch_mean, saved_batch_inv_variance,
                             bn_scale, d_bn_scale, d_bn_bias, dx_out, bundle);
                 }));
             } else) {
         megdnn_assert(x_in.layout.dtype == bn_scale.layout.dtype);
         switch (x_in.layout.dtype.enumv()) {
-#define cb(_dt)                                                                    \
-    case DTypeTrait<_dt>::enumv: {                                                 \
-        using T = typename DTypeTrait<_dt>::ctype;                                 \
-        MEGDNN_DISPATCH_CPU_KERN_OPR((bn_backward_exec<T>(                         \
-                x_in, dy_in, saved_batch_mean, saved_batch_inv_variance, bn_scale, \
-                d_bn_scale, d_bn_bias, dx_out, bundle)));                          \
-        break;                                                                     \
+#define cb(_dt)                                                                 \
+    case DTypeTrait<_dt>::enumv: {                                              \
+        using T = typename DTypeTrait<_dt>::ctype;                              \
+        MEGDNN_DISPATCH_CPU_KERN_OPR((bn_backward_exec<T>(                      \
+                x_in, dy, saved_batch_mean, saved_batch_inv_variance, bn_scale, \
+                d_bn_scale, d_bn_bias, dx_out, bundle)));                       \
+        break;                                                                  \
     }
             MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
 #undef cb
@@ -11,12 +11,13 @@
  */
 #pragma once
 #include "megdnn/oprs.h"
+#include "src/common/bn_relu_helper.h"
 #include "src/common/utils.h"
 
 namespace megdnn {
 namespace naive {
 
-class BNForwardImpl final : public BNForward {
+class BNForwardImpl : public BNForward {
 public:
     using BNForward::BNForward;
     void exec(
@@ -32,10 +33,14 @@ public:
             const TensorLayout&, const TensorLayout&, const TensorLayout&) override {
         return 0;
     }
-    size_t get_reserve_in_bytes(const TensorLayout&) override { return 0; }
+    size_t get_reserve_in_bytes(const TensorLayout& src) override {
+        return bn_relu::need_mask(m_param)
+                     ? bn_relu::mask_in_bytes(src.total_nr_elems())
+                     : 0;
+    }
 };
 
-class BNBackwardImpl final : public BNBackward {
+class BNBackwardImpl : public BNBackward {
 public:
     using BNBackward::BNBackward;
     void exec(
@@ -50,11 +55,17 @@ public:
             const TensorLayout& x, const TensorLayout&, const TensorLayout&,
             const TensorLayout&, const TensorLayout& bn_scale, const TensorLayout&,
             const TensorLayout&, const TensorLayout&, const TensorLayout&) override;
-    size_t get_reserve_in_bytes(const TensorLayout&) override { return 0; }
+    size_t get_reserve_in_bytes(const TensorLayout& src) override {
+        return bn_relu::need_mask(m_param)
+                     ? bn_relu::mask_in_bytes(src.total_nr_elems())
+                     : 0;
+    }
 
 private:
+    //! masked_dy_size is the size of dy masked by the fused relu, if any
     WorkspaceBundle get_workspace_bundle(
-            size_t x_size, size_t param_size, void* raw_ptr = nullptr);
+            size_t x_size, size_t param_size, size_t masked_dy_size,
+            void* raw_ptr = nullptr);
 };
 
 }  // namespace naive
@@ -0,0 +1,90 @@
+/**
+ * \file dnn/src/naive/block_sparse_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/block_sparse_matrix_mul/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+using Mode = param::BlockSparseMatrixMul::Mode;
+
+struct Shape {
+    size_t B, M, K, N, bh, bw;
+};
+
+//! dst of (B, M, N) for SPARSE_DENSE or (B, N, M) for DENSE_SPARSE_T
+template <typename T>
+void forward(
+        const T* values, const dt_int32* col_idx, const dt_int32* row_ptr,
+        const T* src, T* dst, Shape shp, Mode mode) {
+    bool sparse_dense = mode == Mode::SPARSE_DENSE;
+    rep(b, shp.B) rep(m, shp.M) rep(n, shp.N) {
+        size_t rb = m / shp.bh, i = m % shp.bh;
+        float acc = 0.f;
+        for (dt_int32 blk = row_ptr[rb]; blk < row_ptr[rb + 1]; ++blk) {
+            const T* val = values + (blk * shp.bh + i) * shp.bw;
+            size_t col = col_idx[blk] * shp.bw;
+            megdnn_assert(col + shp.bw <= shp.K, "block column out of range");
+            rep(j, shp.bw) {
+                size_t k = col + j;
+                size_t sidx = sparse_dense ? (b * shp.K + k) * shp.N + n
+                                           : (b * shp.N + n) * shp.K + k;
+                acc += static_cast<float>(val[j]) * static_cast<float>(src[sidx]);
+            }
+        }
+        size_t didx = sparse_dense ? (b * shp.M + m) * shp.N + n
+                                   : (b * shp.N + n) * shp.M + m;
+        dst[didx] = T(acc);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void BlockSparseMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in values, _megdnn_tensor_in col_idx, _megdnn_tensor_in row_ptr,
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(
+            values.layout, col_idx.layout, row_ptr.layout, src.layout, dst.layout,
+            workspace.size);
+    auto&& sl = src.layout;
+    bool sparse_dense = param().mode == Mode::SPARSE_DENSE;
+    Shape shp;
+    shp.B = sl.ndim == 3 ? sl[0] : 1;
+    shp.bh = param().block_h;
+    shp.bw = param().block_w;
+    shp.M = (row_ptr.layout[0] - 1) * shp.bh;
+    shp.K = sl[sl.ndim - (sparse_dense ? 2 : 1)];
+    shp.N = sl[sl.ndim - (sparse_dense ? 1 : 2)];
+    auto mode = param().mode;
+#define cb(DType)                                                                 \
+    if (src.layout.dtype == DType()) {                                            \
+        using ctype = typename DTypeTrait<DType>::ctype;                          \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(forward<ctype>(                              \
+                values.ptr<ctype>(), col_idx.ptr<dt_int32>(),                     \
+                row_ptr.ptr<dt_int32>(), src.ptr<ctype>(), dst.ptr<ctype>(), shp, \
+                mode));                                                           \
+        return;                                                                   \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
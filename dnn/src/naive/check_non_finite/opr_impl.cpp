@@ -34,6 +34,21 @@ void reduce_fwd(const src_ctype* sptr, wtype* dptr, size_t size) {
     dptr[0] = func(0, size);
 }
 
+#undef wtype
+#undef src_ctype
+
+template <bool need_scale>
+dt_int32 check_and_scale(dt_float32* ptr, size_t size, dt_float32 scale) {
+    dt_int32 ret = 0;
+    for (size_t i = 0; i < size; ++i) {
+        ret |= !std::isfinite(ptr[i]);
+        if (need_scale) {
+            ptr[i] *= scale;
+        }
+    }
+    return ret;
+}
+
 }  // namespace
 
 namespace megdnn {
@@ -54,6 +69,31 @@ void CheckNonFiniteImpl::exec(
                             src.ptr<dt_float32>(), dst.ptr<dt_int32>(),
                             src.layout.total_nr_elems()));
 }
+
+size_t CheckNonFiniteV2Impl::get_workspace_in_bytes(
+        const TensorNDArray&, const TensorLayout&) {
+    return 0;
+}
+
+void CheckNonFiniteV2Impl::exec(
+        _megdnn_in const TensorNDArray& srcs, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(srcs, dst, workspace.size);
+    auto scale = param().scale;
+    //! the inputs are only read if the scale is 1, so that the opr can also
+    //! be used to check tensors owned by others
+    auto kern = [srcs, dst, scale]() {
+        dt_int32 flag = 0;
+        for (auto&& src : srcs) {
+            auto ptr = src.ptr<dt_float32>();
+            auto size = src.layout.total_nr_elems();
+            flag |= scale != 1.f ? check_and_scale<true>(ptr, size, scale)
+                                 : check_and_scale<false>(ptr, size, scale);
+        }
+        dst.ptr<dt_int32>()[0] = flag;
+    };
+    MEGDNN_DISPATCH_CPU_KERN_OPR(kern());
+}
 }  // namespace naive
 }  // namespace megdnn
 
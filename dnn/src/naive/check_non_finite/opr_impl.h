@@ -30,6 +30,20 @@ public:
             _megdnn_workspace workspace) override;
 };
 
+class CheckNonFiniteV2Impl final : public CheckNonFiniteV2 {
+public:
+    using CheckNonFiniteV2::CheckNonFiniteV2;
+
+    bool is_thread_safe() const override { return true; }
+
+    size_t get_workspace_in_bytes(
+            const TensorNDArray& srcs, const TensorLayout& dst) override;
+
+    void exec(
+            _megdnn_in const TensorNDArray& srcs, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
 }  // namespace naive
 }  // namespace megdnn
 
@@ -0,0 +1,81 @@
+/**
+ * \file dnn/src/naive/elemwise_multi_output/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./opr_impl.h"
+#include "megdnn/tensor_iter.h"
+#include "src/common/elemwise_multi_output/kern_defs.cuh"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace naive;
+
+template <class Op, typename ctype, int arity>
+void ElemwiseMultiOutputImpl::dispatch_op(
+        const ElemwiseOpParamN<arity>& param, const TensorNDArray& dst,
+        const Op& op) {
+    using Iter = decltype(tensor_iter_valonly<ctype>(param[0]).begin());
+    std::vector<Iter> iters;
+    for (int i = 0; i < arity; ++i) {
+        iters.push_back(tensor_iter_valonly<ctype>(param[i]).begin());
+    }
+    ctype* dst0 = dst[0].ptr<ctype>();
+    ctype* dst1 = dst[1].ptr<ctype>();
+    auto size = param.size;
+    auto work = [iters, dst0, dst1, size, op]() {
+        auto its = iters;
+        ctype src_val[arity], dst_val[2];
+        for (size_t i = 0; i < size; ++i) {
+            for (int j = 0; j < arity; ++j) {
+                src_val[j] = *its[j];
+                ++its[j];
+            }
+            op(dst_val, src_val);
+            dst0[i] = dst_val[0];
+            dst1[i] = dst_val[1];
+        }
+    };
+    MEGDNN_DISPATCH_CPU_KERN_OPR(work());
+}
+
+void ElemwiseMultiOutputImpl::on_sigmoid_mul(
+        const ElemwiseOpParamN<2>& param, const TensorNDArray& dst) {
+    switch (param[0].layout.dtype.enumv()) {
+#define cb(_dt)                                                \
+    case DTypeTrait<_dt>::enumv: {                             \
+        using ctype = DTypeTrait<_dt>::ctype;                  \
+        using Op = elemwise_multi_output::SigmoidMulOp<ctype>; \
+        return dispatch_op<Op, ctype>(param, dst, Op{});       \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("unsupported dtype for SIGMOID_MUL");
+    }
+}
+
+void ElemwiseMultiOutputImpl::on_momentum_update(
+        const ElemwiseOpParamN<3>& param, const TensorNDArray& dst) {
+    switch (param[0].layout.dtype.enumv()) {
+#define cb(_dt)                                                    \
+    case DTypeTrait<_dt>::enumv: {                                 \
+        using ctype = DTypeTrait<_dt>::ctype;                      \
+        using Op = elemwise_multi_output::MomentumUpdateOp<ctype>; \
+        return dispatch_op<Op, ctype>(                             \
+                param, dst, Op{m_param.momentum, m_param.lr});     \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("unsupported dtype for MOMENTUM_UPDATE");
+    }
+}
+
+// vim: syntax=cpp.doxygen
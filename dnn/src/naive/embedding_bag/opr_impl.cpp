@@ -0,0 +1,97 @@
+/**
+ * \file dnn/src/naive/embedding_bag/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/naive/embedding_bag/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cstring>
+
+namespace {
+
+using namespace megdnn;
+using Mode = param::EmbeddingBag::Mode;
+
+struct Shape {
+    size_t N, D, L, B, row_bytes;
+};
+
+float get_value(const dt_byte* row, DType dtype, size_t d, size_t D) {
+    if (dtype == dtype::Float32()) {
+        return reinterpret_cast<const dt_float32*>(row)[d];
+    }
+#if !MEGDNN_DISABLE_FLOAT16
+    if (dtype == dtype::Float16()) {
+        return reinterpret_cast<const dt_float16*>(row)[d];
+    }
+#endif
+    megdnn_assert(dtype == dtype::Uint8());
+    float scale, bias;
+    memcpy(&scale, row + D, sizeof(float));
+    memcpy(&bias, row + D + sizeof(float), sizeof(float));
+    return static_cast<float>(reinterpret_cast<const dt_uint8*>(row)[d]) * scale +
+           bias;
+}
+
+void forward(
+        const dt_byte* weight, DType dtype, const dt_int32* indices,
+        const dt_int32* offsets, dt_float32* dst, Shape shp, Mode mode) {
+    rep(b, shp.B) {
+        size_t begin = offsets[b], end = b + 1 < shp.B ? offsets[b + 1] : shp.L;
+        megdnn_assert(
+                offsets[b] >= 0 && begin <= end && end <= shp.L,
+                "invalid offsets of bag %zu: [%zu, %zu)", b, begin, end);
+        rep(d, shp.D) {
+            float acc = 0.f;
+            for (size_t j = begin; j < end; ++j) {
+                megdnn_assert(
+                        indices[j] >= 0 && static_cast<size_t>(indices[j]) < shp.N,
+                        "index %d out of range of %zu rows", indices[j], shp.N);
+                acc += get_value(
+                        weight + indices[j] * shp.row_bytes, dtype, d, shp.D);
+            }
+            if (mode == Mode::MEAN && end > begin) {
+                acc /= static_cast<float>(end - begin);
+            }
+            dst[b * shp.D + d] = acc;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void EmbeddingBagForwardImpl::exec(
+        _megdnn_tensor_in weight, _megdnn_tensor_in indices, _megdnn_tensor_in offsets,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(
+            weight.layout, indices.layout, offsets.layout, dst.layout, workspace.size);
+    Shape shp;
+    shp.N = weight.layout[0];
+    shp.D = dst.layout[1];
+    shp.L = indices.layout[0];
+    shp.B = offsets.layout[0];
+    shp.row_bytes = weight.layout.stride[0] * weight.layout.dtype.size();
+    auto dtype = weight.layout.dtype;
+    auto mode = param().mode;
+    MEGDNN_DISPATCH_CPU_KERN_OPR(forward(
+            static_cast<const dt_byte*>(weight.raw_ptr), dtype,
+            indices.ptr<dt_int32>(), offsets.ptr<dt_int32>(), dst.ptr<dt_float32>(),
+            shp, mode));
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,83 @@
+/**
+ * \file dnn/src/naive/fused_attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/fused_attention/opr_impl.h"
+
+#include <cmath>
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+
+//! scores are recomputed in each pass, so no SxT buffer is needed
+template <typename T>
+void forward(
+        const T* qptr, const T* kptr, const T* vptr, T* dptr, float* acc, size_t B,
+        size_t S, size_t T_, size_t D, size_t Dv, float scale) {
+    rep(b, B) rep(s, S) {
+        const T* q = qptr + (b * S + s) * D;
+        const T* k = kptr + b * T_ * D;
+        const T* v = vptr + b * T_ * Dv;
+        auto score = [&](size_t t) {
+            float dot = 0.f;
+            rep(i, D) { dot += static_cast<float>(q[i]) * k[t * D + i]; }
+            return dot * scale;
+        };
+        float max_val = -INFINITY;
+        rep(t, T_) { max_val = std::max(max_val, score(t)); }
+        float sum = 0.f;
+        rep(i, Dv) { acc[i] = 0.f; }
+        rep(t, T_) {
+            float p = std::exp(score(t) - max_val);
+            sum += p;
+            rep(i, Dv) { acc[i] += p * static_cast<float>(v[t * Dv + i]); }
+        }
+        T* dst = dptr + (b * S + s) * Dv;
+        rep(i, Dv) { dst[i] = T(acc[i] / sum); }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void FusedAttentionForwardImpl::exec(
+        _megdnn_tensor_in query, _megdnn_tensor_in key, _megdnn_tensor_in value,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(query.layout, key.layout, value.layout, dst.layout, workspace.size);
+    size_t B = query.layout[0], S = query.layout[1], T = key.layout[1],
+           D = query.layout[2], Dv = value.layout[2];
+    if (!T) {
+        megdnn_assert(!dst.layout.total_nr_elems(), "attention over empty keys");
+        return;
+    }
+    float scale = param().scale;
+    float* acc = workspace.ptr<float>();
+#define cb(DType)                                                         \
+    if (query.layout.dtype == DType()) {                                  \
+        using ctype = typename DTypeTrait<DType>::ctype;                  \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(forward<ctype>(                      \
+                query.ptr<ctype>(), key.ptr<ctype>(), value.ptr<ctype>(), \
+                dst.ptr<ctype>(), acc, B, S, T, D, Dv, scale));           \
+        return;                                                           \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,35 @@
+/**
+ * \file dnn/src/naive/fused_attention/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/oprs.h"
+
+namespace megdnn {
+namespace naive {
+
+class FusedAttentionForwardImpl : public FusedAttentionForward {
+public:
+    using FusedAttentionForward::FusedAttentionForward;
+    void exec(
+            _megdnn_tensor_in query, _megdnn_tensor_in key, _megdnn_tensor_in value,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+    //! float accumulators of an output row
+    size_t get_workspace_in_bytes(
+            const TensorLayout&, const TensorLayout&, const TensorLayout& value,
+            const TensorLayout&) override {
+        return value[2] * sizeof(float);
+    }
+};
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,161 @@
+/**
+ * \file dnn/src/naive/group_norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/group_norm/opr_impl.h"
+
+#include <cmath>
+#include <vector>
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+
+//! shape of group norm: N * G groups, each of which has C / G channels of size S
+struct Shape {
+    size_t N, C, G, S;
+
+    Shape(const TensorLayout& data, size_t group)
+            : N{data.shape[0]},
+              C{data.shape[1]},
+              G{group} {
+        size_t NC = N * C;
+        S = NC ? data.total_nr_elems() / NC : 0;
+    }
+
+    size_t group_size() const { return C / G * S; }
+
+    //! channel of the \p i-th element in the \p r-th group
+    size_t channel(size_t r, size_t i) const { return r % G * (C / G) + i / S; }
+};
+
+template <typename T>
+void forward(
+        const T* data, const T* weight, const T* bias, T* dst, float* mean,
+        float* rstd, const Shape& shp, bool affine, float eps) {
+    size_t B = shp.group_size();
+    rep(a, shp.N * shp.G) {
+        auto x = data + a * B;
+        auto y = dst + a * B;
+        double sum = 0;
+        rep(b, B) { sum += static_cast<float>(x[b]); }
+        double m = sum / B, var = 0;
+        rep(b, B) {
+            double d = static_cast<float>(x[b]) - m;
+            var += d * d;
+        }
+        double r = 1.0 / std::sqrt(var / B + eps);
+        mean[a] = m;
+        rstd[a] = r;
+        rep(b, B) {
+            double v = (static_cast<float>(x[b]) - m) * r;
+            if (affine) {
+                auto c = shp.channel(a, b);
+                v = v * static_cast<float>(weight[c]) + static_cast<float>(bias[c]);
+            }
+            y[b] = T(static_cast<float>(v));
+        }
+    }
+}
+
+template <typename T>
+void backward(
+        const T* diff, const T* data, const T* weight, const float* mean,
+        const float* rstd, T* ddata, T* dweight, T* dbias, const Shape& shp,
+        bool affine) {
+    size_t B = shp.group_size();
+    std::vector<double> dw(shp.C), db(shp.C), g(B), xhat(B);
+    rep(a, shp.N * shp.G) {
+        auto off = a * B;
+        double sum_g = 0, sum_gx = 0;
+        rep(b, B) {
+            auto c = shp.channel(a, b);
+            double dy = static_cast<float>(diff[off + b]);
+            xhat[b] = (static_cast<float>(data[off + b]) - mean[a]) * rstd[a];
+            g[b] = affine ? dy * static_cast<float>(weight[c]) : dy;
+            sum_g += g[b];
+            sum_gx += g[b] * xhat[b];
+            dw[c] += dy * xhat[b];
+            db[c] += dy;
+        }
+        rep(b, B) {
+            double v = rstd[a] * (g[b] - sum_g / B - xhat[b] * sum_gx / B);
+            ddata[off + b] = T(static_cast<float>(v));
+        }
+    }
+    if (affine) {
+        rep(c, shp.C) {
+            dweight[c] = T(static_cast<float>(dw[c]));
+            dbias[c] = T(static_cast<float>(db[c]));
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void GroupNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+        _megdnn_workspace workspace) {
+    check_exec(
+            data.layout, weight.layout, bias.layout, dst.layout, mean.layout,
+            rstd.layout, workspace.size);
+    auto p = param();
+    Shape shp{data.layout, p.group};
+#define cb(DType)                                                              \
+    if (data.layout.dtype == DType()) {                                        \
+        using ctype = typename DTypeTrait<DType>::ctype;                       \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(forward<ctype>(                           \
+                data.ptr<ctype>(), static_cast<const ctype*>(weight.raw_ptr),  \
+                static_cast<const ctype*>(bias.raw_ptr), dst.ptr<ctype>(),     \
+                mean.ptr<dt_float32>(), rstd.ptr<dt_float32>(), shp, p.affine, \
+                p.eps));                                                       \
+        return;                                                                \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+void GroupNormBackwardImpl::exec(
+        _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+        _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+        _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+        _megdnn_workspace workspace) {
+    check_exec(
+            diff.layout, data.layout, weight.layout, mean.layout, rstd.layout,
+            ddata.layout, dweight.layout, dbias.layout, workspace.size);
+    auto p = param();
+    Shape shp{data.layout, p.group};
+#define cb(DType)                                                                  \
+    if (data.layout.dtype == DType()) {                                            \
+        using ctype = typename DTypeTrait<DType>::ctype;                           \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(backward<ctype>(                              \
+                diff.ptr<ctype>(), data.ptr<ctype>(),                              \
+                static_cast<const ctype*>(weight.raw_ptr), mean.ptr<dt_float32>(), \
+                rstd.ptr<dt_float32>(), ddata.ptr<ctype>(),                        \
+                static_cast<ctype*>(dweight.raw_ptr),                              \
+                static_cast<ctype*>(dbias.raw_ptr), shp, p.affine));               \
+        return;                                                                    \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,102 @@
+/**
+ * \file dnn/src/naive/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/naive/image_preprocess/opr_impl.h"
+
+#include "src/common/image_preprocess.cuh"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+using namespace image_preprocess;
+using Param = param::ImagePreprocess;
+
+void forward(
+        const uint8_t* src, const float* scale, const float* bias, float* dst,
+        size_t N, int IH, int IW, int OH, int OW, const Param& param) {
+    float scale_h = static_cast<float>(OH) / IH;
+    float scale_w = static_cast<float>(OW) / IW;
+    auto mode = static_cast<uint32_t>(param.mode);
+    size_t src_size = param.mode == Param::Mode::RGB ||
+                                      param.mode == Param::Mode::RGB2BGR
+                              ? IH * IW * 3
+                              : IH * IW * 3 / 2;
+    rep(n, N) {
+        const uint8_t* sptr = src + n * src_size;
+        rep(oh, OH) rep(ow, OW) {
+            float value[3];
+            if (param.imode == Param::InterpolationMode::NEAREST) {
+                int p[3];
+                load_pixel(
+                        sptr, IH, IW, get_nearest_coord(scale_h, IH, oh),
+                        get_nearest_coord(scale_w, IW, ow), mode, p);
+                rep(c, 3) { value[c] = p[c]; }
+            } else {
+                int ih0, ih1, iw0, iw1;
+                float ah1, aw1;
+                get_linear_coord(scale_h, IH, oh, ih0, ih1, ah1);
+                get_linear_coord(scale_w, IW, ow, iw0, iw1, aw1);
+                float ah0 = 1 - ah1, aw0 = 1 - aw1;
+                int p00[3], p01[3], p10[3], p11[3];
+                load_pixel(sptr, IH, IW, ih0, iw0, mode, p00);
+                load_pixel(sptr, IH, IW, ih0, iw1, mode, p01);
+                load_pixel(sptr, IH, IW, ih1, iw0, mode, p10);
+                load_pixel(sptr, IH, IW, ih1, iw1, mode, p11);
+                rep(c, 3) {
+                    value[c] = p00[c] * ah0 * aw0 + p01[c] * ah0 * aw1 +
+                               p10[c] * ah1 * aw0 + p11[c] * ah1 * aw1;
+                }
+            }
+            rep(c, 4) {
+                float v = c < 3 ? value[c] * scale[c] + bias[c] : 0.f;
+                switch (param.format) {
+                    case Param::Format::NCHW:
+                        if (c < 3) {
+                            dst[((n * 3 + c) * OH + oh) * OW + ow] = v;
+                        }
+                        break;
+                    case Param::Format::NHWC:
+                        if (c < 3) {
+                            dst[((n * OH + oh) * OW + ow) * 3 + c] = v;
+                        }
+                        break;
+                    default:
+                        dst[((n * OH + oh) * OW + ow) * 4 + c] = v;
+                        break;
+                }
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, scale.layout, bias.layout, dst.layout, workspace.size);
+    bool yuv = param().mode != Param::Mode::RGB && param().mode != Param::Mode::RGB2BGR;
+    int IH = yuv ? src.layout[1] / 3 * 2 : src.layout[1], IW = src.layout[2];
+    bool nhwc = param().format == Param::Format::NHWC;
+    int OH = dst.layout[nhwc ? 1 : 2], OW = dst.layout[nhwc ? 2 : 3];
+    MEGDNN_DISPATCH_CPU_KERN_OPR(forward(
+            src.ptr<dt_uint8>(), scale.ptr<dt_float32>(), bias.ptr<dt_float32>(),
+            dst.ptr<dt_float32>(), src.layout[0], IH, IW, OH, OW, param()));
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,139 @@
+/**
+ * \file dnn/src/naive/layer_norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/layer_norm/opr_impl.h"
+
+#include <cmath>
+#include <vector>
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+
+template <typename T>
+void forward(
+        const T* data, const T* weight, const T* bias, T* dst, float* mean,
+        float* rstd, size_t A, size_t B, bool affine, float eps) {
+    rep(a, A) {
+        auto x = data + a * B;
+        auto y = dst + a * B;
+        double sum = 0;
+        rep(b, B) { sum += static_cast<float>(x[b]); }
+        double m = sum / B, var = 0;
+        rep(b, B) {
+            double d = static_cast<float>(x[b]) - m;
+            var += d * d;
+        }
+        double r = 1.0 / std::sqrt(var / B + eps);
+        mean[a] = m;
+        rstd[a] = r;
+        rep(b, B) {
+            double v = (static_cast<float>(x[b]) - m) * r;
+            if (affine) {
+                v = v * static_cast<float>(weight[b]) + static_cast<float>(bias[b]);
+            }
+            y[b] = T(static_cast<float>(v));
+        }
+    }
+}
+
+template <typename T>
+void backward(
+        const T* diff, const T* data, const T* weight, const float* mean,
+        const float* rstd, T* ddata, T* dweight, T* dbias, size_t A, size_t B,
+        bool affine) {
+    std::vector<double> dw(B), db(B), g(B), xhat(B);
+    rep(a, A) {
+        auto off = a * B;
+        double sum_g = 0, sum_gx = 0;
+        rep(b, B) {
+            double dy = static_cast<float>(diff[off + b]);
+            xhat[b] = (static_cast<float>(data[off + b]) - mean[a]) * rstd[a];
+            g[b] = affine ? dy * static_cast<float>(weight[b]) : dy;
+            sum_g += g[b];
+            sum_gx += g[b] * xhat[b];
+            dw[b] += dy * xhat[b];
+            db[b] += dy;
+        }
+        rep(b, B) {
+            double v = rstd[a] * (g[b] - sum_g / B - xhat[b] * sum_gx / B);
+            ddata[off + b] = T(static_cast<float>(v));
+        }
+    }
+    if (affine) {
+        rep(b, B) {
+            dweight[b] = T(static_cast<float>(dw[b]));
+            dbias[b] = T(static_cast<float>(db[b]));
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void LayerNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_tensor_out mean, _megdnn_tensor_out rstd,
+        _megdnn_workspace workspace) {
+    check_exec(
+            data.layout, weight.layout, bias.layout, dst.layout, mean.layout,
+            rstd.layout, workspace.size);
+    auto p = param();
+    size_t B = p.normalized_size, A = B ? data.layout.total_nr_elems() / B : 0;
+#define cb(DType)                                                               \
+    if (data.layout.dtype == DType()) {                                         \
+        using ctype = typename DTypeTrait<DType>::ctype;                        \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(forward<ctype>(                            \
+                data.ptr<ctype>(), static_cast<const ctype*>(weight.raw_ptr),   \
+                static_cast<const ctype*>(bias.raw_ptr), dst.ptr<ctype>(),      \
+                mean.ptr<dt_float32>(), rstd.ptr<dt_float32>(), A, B, p.affine, \
+                p.eps));                                                        \
+        return;                                                                 \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+void LayerNormBackwardImpl::exec(
+        _megdnn_tensor_in diff, _megdnn_tensor_in data, _megdnn_tensor_in weight,
+        _megdnn_tensor_in mean, _megdnn_tensor_in rstd, _megdnn_tensor_out ddata,
+        _megdnn_tensor_out dweight, _megdnn_tensor_out dbias,
+        _megdnn_workspace workspace) {
+    check_exec(
+            diff.layout, data.layout, weight.layout, mean.layout, rstd.layout,
+            ddata.layout, dweight.layout, dbias.layout, workspace.size);
+    auto p = param();
+    size_t B = p.normalized_size, A = B ? data.layout.total_nr_elems() / B : 0;
+#define cb(DType)                                                                  \
+    if (data.layout.dtype == DType()) {                                            \
+        using ctype = typename DTypeTrait<DType>::ctype;                           \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(backward<ctype>(                              \
+                diff.ptr<ctype>(), data.ptr<ctype>(),                              \
+                static_cast<const ctype*>(weight.raw_ptr), mean.ptr<dt_float32>(), \
+                rstd.ptr<dt_float32>(), ddata.ptr<ctype>(),                        \
+                static_cast<ctype*>(dweight.raw_ptr),                              \
+                static_cast<ctype*>(dbias.raw_ptr), A, B, p.affine));              \
+        return;                                                                    \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
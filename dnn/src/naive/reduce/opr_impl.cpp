@@ -198,11 +198,77 @@ void dispatch_dtype(
     }
 }
 
+template <Mode mode>
+void dispatch_dtype_ptr(
+        megdnn::naive::HandleImpl* handle, DType dtype, const void* src, void* dst,
+        size_t A, size_t B, size_t C) {
+    TensorLayout layout({A * B * C}, dtype);
+    dispatch_dtype<mode>(
+            handle, {const_cast<void*>(src), layout}, {dst, layout}, A, B, C);
+}
+
+//! the axes to be reduced to target shape, from the innermost one
+SmallVector<size_t> target_shape_axes(
+        const TensorLayout& src, const TensorLayout& dst) {
+    SmallVector<size_t> axes;
+    for (size_t i = src.ndim; i--;) {
+        if (src.shape[i] != 1 && dst.shape[i] == 1) {
+            axes.push_back(i);
+        }
+    }
+    return axes;
+}
+
+//! size in bytes of each of the two buffers of intermediate results
+size_t target_shape_buf_size(const TensorLayout& src, const TensorLayout& dst) {
+    auto axes = target_shape_axes(src, dst);
+    if (axes.size() < 2) {
+        return 0;
+    }
+    return src.dtype.size(src.total_nr_elems() / src.shape[axes[0]]);
+}
+
 }  // anonymous namespace
 
 namespace megdnn {
 namespace naive {
 
+void ReduceForwardImpl::exec_target_shape(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    auto axes = target_shape_axes(src.layout, dst.layout);
+    if (axes.empty()) {
+        auto typecvt = handle()->create_operator<TypeCvt>();
+        typecvt->exec(src, dst);
+        return;
+    }
+    size_t buf_size = target_shape_buf_size(src.layout, dst.layout);
+    dt_byte* bufs[2] = {workspace.raw_ptr, workspace.raw_ptr + buf_size};
+    TensorShape shape = src.layout;
+    const void* sptr = src.raw_ptr;
+    for (size_t i = 0; i < axes.size(); ++i) {
+        size_t A, B, C;
+        reduce::get_ABC(shape, A, B, C, axes[i]);
+        shape[axes[i]] = 1;
+        void* dptr = i + 1 == axes.size() ? dst.raw_ptr : bufs[i % 2];
+        //! the squares are only taken in the first step
+        Mode mode = i && param().mode == Mode::SUM_SQR ? Mode::SUM : param().mode;
+        auto handle = static_cast<HandleImpl*>(this->handle());
+        auto dtype = src.layout.dtype;
+        switch (mode) {
+#define cb(_mode)                                                      \
+    case _mode:                                                        \
+        dispatch_dtype_ptr<_mode>(handle, dtype, sptr, dptr, A, B, C); \
+        break;
+            cb(Mode::SUM) cb(Mode::SUM_SQR) cb(Mode::PRODUCT) cb(Mode::MIN)
+            cb(Mode::MAX) cb(Mode::MEAN)
+#undef cb
+            default:
+                megdnn_assert_internal(false);
+        }
+        sptr = dptr;
+    }
+}
+
 size_t ReduceForwardImpl::get_workspace_in_bytes(
         const TensorLayout& src, const TensorLayout& dst) {
     MEGDNN_MARK_USED_VAR(src);
@@ -210,6 +276,9 @@ size_t ReduceForwardImpl::get_workspace_in_bytes(
     megdnn_assert(
             param().data_type != Reduce::DataType::FLOAT_IO16xC32,
             "FLOAT_IO16xC32 is deprecated");
+    if (param().axis == TARGET_SHAPE_AXIS) {
+        return target_shape_buf_size(src, dst) * 2;
+    }
     DType comp_dtype = src.dtype;
     if (param().mode == Mode::SUM || param().mode == Mode::MEAN) {
         if (src.dtype.category() == DTypeCategory::QUANTIZED) {
@@ -241,6 +310,9 @@ void ReduceForwardImpl::exec(
         _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
     using namespace reduce;
     check_exec(src.layout, dst.layout, workspace.size);
+    if (param().axis == TARGET_SHAPE_AXIS) {
+        return exec_target_shape(src, dst, workspace);
+    }
     size_t A, B, C;
     get_ABC(src.layout, A, B, C, param().axis);
 
@@ -23,6 +23,12 @@ public:
             _megdnn_workspace workspace) override;
     size_t get_workspace_in_bytes(
             const TensorLayout& src, const TensorLayout& dst) override;
+
+private:
+    //! reduce the axes one by one, see ReduceForward::TARGET_SHAPE_AXIS
+    void exec_target_shape(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace);
 };
 
 }  // namespace naive
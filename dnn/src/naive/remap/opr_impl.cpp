@@ -11,6 +11,7 @@
  */
 
 #include "src/naive/remap/opr_impl.h"
+#include "src/naive/remap/remap_linear.h"
 #include "src/common/cv/helper.h"
 #include "src/common/rounding_converter.cuh"
 #include "src/common/utils.h"
@@ -19,93 +20,20 @@
 using namespace megdnn;
 using namespace naive;
 using namespace rounding;
+using namespace remap;
 
 namespace {
-template <param::Remap::Format format>
-inline int get_offset(int, int, int, int, int, int);
-
-template <>
-inline int get_offset<param::Remap::Format::NCHW>(
-        int height, int width, int channel, int h, int w, int) {
-    return channel * h * w + height * w + width;
-}
-
-template <>
-inline int get_offset<param::Remap::Format::NHWC>(
-        int height, int width, int channel, int, int w, int c) {
-    return height * w * c + width * c + channel;
-}
-
-template <
-        typename ctype, param::Remap::Format format,
-        param::Remap::BorderMode bordertype>
-struct GetSrcData {
-    static inline ctype get(
-            const ctype* src, int height, int width, int channel, int h, int w, int c,
-            float) {
-        height = megcv::border_interpolate<bordertype>(height, h);
-        width = megcv::border_interpolate<bordertype>(width, w);
-        return src[get_offset<format>(height, width, channel, h, w, c)];
-    }
-    static inline int get_index(
-            int height, int width, int channel, int h, int w, int c) {
-        height = megcv::border_interpolate<bordertype>(height, h);
-        width = megcv::border_interpolate<bordertype>(width, w);
-        return get_offset<format>(height, width, channel, h, w, c);
-    }
-};
-
-template <typename ctype, param::Remap::Format format>
-struct GetSrcData<ctype, format, param::Remap::BorderMode::CONSTANT> {
-    static inline ctype get(
-            const ctype* src, int height, int width, int channel, int h, int w, int c,
-            float scalar) {
-        RoundingConverter<ctype> round;
-        return (height >= 0 && height < h && width >= 0 && width < w)
-                     ? src[get_offset<format>(height, width, channel, h, w, c)]
-                     : round(scalar);
-    }
-    static inline int get_index(
-            int height, int width, int channel, int h, int w, int c) {
-        return (height >= 0 && height < h && width >= 0 && width < w)
-                     ? get_offset<format>(height, width, channel, h, w, c)
-                     : -1;
-    }
-};
-
 template <
         typename ctype, param::Remap::Format format,
         param::Remap::BorderMode bordertype>
 void remap_LINEAR(
         const ctype* src, const float* map_xy, ctype* dst, int N, int C, int IH, int IW,
         int OH, int OW, float scalar) {
-    RoundingConverter<ctype> round_converter;
     for (int n = 0; n < N;
          ++n, src += C * IH * IW, dst += C * OH * OW, map_xy += OH * OW * 2) {
         for (int h = 0; h < OH; ++h) {
-            for (int w = 0; w < OW; ++w) {
-                float index_col = map_xy[h * OW * 2 + w * 2 + 0];
-                float index_row = map_xy[h * OW * 2 + w * 2 + 1];
-                int col = static_cast<int>(floor(index_col));
-                int row = static_cast<int>(floor(index_row));
-                float v = index_col - col;  // alphaw
-                float u = index_row - row;  // alphah
-                const float one = 1.f;
-                for (int c = 0; c < C; ++c) {
-                    ctype a00 = GetSrcData<ctype, format, bordertype>::get(
-                            src, row + 0, col + 0, c, IH, IW, C, scalar);
-                    ctype a01 = GetSrcData<ctype, format, bordertype>::get(
-                            src, row + 0, col + 1, c, IH, IW, C, scalar);
-                    ctype a10 = GetSrcData<ctype, format, bordertype>::get(
-                            src, row + 1, col + 0, c, IH, IW, C, scalar);
-                    ctype a11 = GetSrcData<ctype, format, bordertype>::get(
-                            src, row + 1, col + 1, c, IH, IW, C, scalar);
-
-                    dst[get_offset<format>(h, w, c, OH, OW, C)] = round_converter(
-                            a00 * (one - v) * (one - u) + a01 * (one - u) * v +
-                            a10 * (one - v) * u + a11 * u * v);
-                }
-            }
+            remap_linear_row<ctype, format, bordertype>(
+                    src, map_xy, dst, C, IH, IW, OH, OW, h, scalar);
         }
     }
 }
@@ -14,7 +14,8 @@
 
 namespace megdnn {
 namespace naive {
-class RemapImpl final : public Remap {
+class RemapImpl : public Remap {
+public:
     using Remap::Remap;
     void exec(
             _megdnn_tensor_in, _megdnn_tensor_in, _megdnn_tensor_out,
@@ -0,0 +1,128 @@
+/**
+ * \file dnn/src/naive/remap/remap_linear.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/oprs.h"
+#include "src/common/cv/helper.h"
+#include "src/common/rounding_converter.cuh"
+
+#include <cmath>
+
+namespace megdnn {
+//! the bilinear remap kernels shared by the CPU backends
+namespace remap {
+
+template <param::Remap::Format format>
+inline int get_offset(int, int, int, int, int, int);
+
+template <>
+inline int get_offset<param::Remap::Format::NCHW>(
+        int height, int width, int channel, int h, int w, int) {
+    return channel * h * w + height * w + width;
+}
+
+template <>
+inline int get_offset<param::Remap::Format::NHWC>(
+        int height, int width, int channel, int, int w, int c) {
+    return height * w * c + width * c + channel;
+}
+
+template <
+        typename ctype, param::Remap::Format format,
+        param::Remap::BorderMode bordertype>
+struct GetSrcData {
+    static inline ctype get(
+            const ctype* src, int height, int width, int channel, int h, int w, int c,
+            float) {
+        height = megcv::border_interpolate<bordertype>(height, h);
+        width = megcv::border_interpolate<bordertype>(width, w);
+        return src[get_offset<format>(height, width, channel, h, w, c)];
+    }
+    static inline int get_index(
+            int height, int width, int channel, int h, int w, int c) {
+        height = megcv::border_interpolate<bordertype>(height, h);
+        width = megcv::border_interpolate<bordertype>(width, w);
+        return get_offset<format>(height, width, channel, h, w, c);
+    }
+};
+
+template <typename ctype, param::Remap::Format format>
+struct GetSrcData<ctype, format, param::Remap::BorderMode::CONSTANT> {
+    static inline ctype get(
+            const ctype* src, int height, int width, int channel, int h, int w, int c,
+            float scalar) {
+        rounding::RoundingConverter<ctype> round;
+        return (height >= 0 && height < h && width >= 0 && width < w)
+                     ? src[get_offset<format>(height, width, channel, h, w, c)]
+                     : round(scalar);
+    }
+    static inline int get_index(
+            int height, int width, int channel, int h, int w, int c) {
+        return (height >= 0 && height < h && width >= 0 && width < w)
+                     ? get_offset<format>(height, width, channel, h, w, c)
+                     : -1;
+    }
+};
+
+/*!
+ * \brief compute pixel (\p h, \p w) of the bilinear remap of one image
+ *
+ * \param src the source image of the batch item
+ * \param map_xy the map of the batch item, of shape (OH, OW, 2)
+ * \param dst the destination image of the batch item
+ */
+template <
+        typename ctype, param::Remap::Format format,
+        param::Remap::BorderMode bordertype>
+void remap_linear_pixel(
+        const ctype* src, const float* map_xy, ctype* dst, int C, int IH, int IW,
+        int OH, int OW, int h, int w, float scalar) {
+    rounding::RoundingConverter<ctype> round_converter;
+    float index_col = map_xy[h * OW * 2 + w * 2 + 0];
+    float index_row = map_xy[h * OW * 2 + w * 2 + 1];
+    int col = static_cast<int>(floor(index_col));
+    int row = static_cast<int>(floor(index_row));
+    float v = index_col - col;  // alphaw
+    float u = index_row - row;  // alphah
+    const float one = 1.f;
+    for (int c = 0; c < C; ++c) {
+        ctype a00 = GetSrcData<ctype, format, bordertype>::get(
+                src, row + 0, col + 0, c, IH, IW, C, scalar);
+        ctype a01 = GetSrcData<ctype, format, bordertype>::get(
+                src, row + 0, col + 1, c, IH, IW, C, scalar);
+        ctype a10 = GetSrcData<ctype, format, bordertype>::get(
+                src, row + 1, col + 0, c, IH, IW, C, scalar);
+        ctype a11 = GetSrcData<ctype, format, bordertype>::get(
+                src, row + 1, col + 1, c, IH, IW, C, scalar);
+
+        dst[get_offset<format>(h, w, c, OH, OW, C)] = round_converter(
+                a00 * (one - v) * (one - u) + a01 * (one - u) * v +
+                a10 * (one - v) * u + a11 * u * v);
+    }
+}
+
+//! compute row \p h of the bilinear remap of one image
+template <
+        typename ctype, param::Remap::Format format,
+        param::Remap::BorderMode bordertype>
+void remap_linear_row(
+        const ctype* src, const float* map_xy, ctype* dst, int C, int IH, int IW,
+        int OH, int OW, int h, float scalar) {
+    for (int w = 0; w < OW; ++w) {
+        remap_linear_pixel<ctype, format, bordertype>(
+                src, map_xy, dst, C, IH, IW, OH, OW, h, w, scalar);
+    }
+}
+
+}  // namespace remap
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
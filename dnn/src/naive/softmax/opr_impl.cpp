@@ -0,0 +1,97 @@
+/**
+ * \file dnn/src/naive/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/softmax/opr_impl.h"
+
+#include <cmath>
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+
+template <typename T>
+void forward(const T* sptr, T* dptr, size_t A, size_t B, size_t C) {
+    rep(a, A) rep(c, C) {
+        auto src = sptr + a * B * C + c;
+        auto dst = dptr + a * B * C + c;
+        float max_val = src[0];
+        rep(b, B) { max_val = std::max<float>(max_val, src[b * C]); }
+        float sum = 0.f;
+        rep(b, B) { sum += std::exp(static_cast<float>(src[b * C]) - max_val); }
+        rep(b, B) {
+            dst[b * C] = T(std::exp(static_cast<float>(src[b * C]) - max_val) / sum);
+        }
+    }
+}
+
+template <typename T>
+void backward(
+        const T* yptr, const T* hptr, T* gptr, size_t A, size_t B, size_t C) {
+    rep(a, A) rep(c, C) {
+        auto off = a * B * C + c;
+        auto y = yptr + off, diff = hptr + off;
+        auto grad = gptr + off;
+        float dot = 0.f;
+        rep(b, B) { dot += static_cast<float>(y[b * C]) * diff[b * C]; }
+        rep(b, B) {
+            grad[b * C] = T((static_cast<float>(diff[b * C]) - dot) * y[b * C]);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void SoftmaxForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, get_axis(src.layout.ndim));
+#define cb(DType)                                                             \
+    if (src.layout.dtype == DType()) {                                        \
+        using ctype = typename DTypeTrait<DType>::ctype;                      \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(                                         \
+                forward<ctype>(src.ptr<ctype>(), dst.ptr<ctype>(), A, B, C)); \
+        return;                                                               \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+void SoftmaxBackwardImpl::exec(
+        _megdnn_tensor_in dst, _megdnn_tensor_in diff, _megdnn_tensor_out grad,
+        _megdnn_workspace workspace) {
+    check_exec(dst.layout, diff.layout, grad.layout, workspace.size);
+    size_t A, B, C;
+    reduce::get_ABC(dst.layout, A, B, C, get_axis(dst.layout.ndim));
+#define cb(DType)                                                          \
+    if (dst.layout.dtype == DType()) {                                     \
+        using ctype = typename DTypeTrait<DType>::ctype;                   \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(backward<ctype>(                      \
+                dst.ptr<ctype>(), diff.ptr<ctype>(), grad.ptr<ctype>(), A, \
+                B, C));                                                    \
+        return;                                                            \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,73 @@
+/**
+ * \file dnn/src/naive/weight_quant_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/weight_quant_matrix_mul/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+using namespace megdnn;
+
+//! k-th quantized value of a weight row
+int get_weight(const dt_int8* row, size_t k, uint32_t bits) {
+    if (bits == 8) {
+        return row[k];
+    }
+    dt_int8 byte = row[k / 2];
+    // sign extend the lower or higher half of the byte
+    return k % 2 ? byte >> 4 : static_cast<dt_int8>(byte << 4) >> 4;
+}
+
+template <typename T>
+void forward(
+        const T* src, const dt_int8* weight, const dt_float32* scale, T* dst, size_t M,
+        size_t K, size_t N, uint32_t bits) {
+    size_t row_bytes = bits == 8 ? K : (K + 1) / 2;
+    rep(m, M) rep(n, N) {
+        const dt_int8* w = weight + n * row_bytes;
+        float acc = 0.f;
+        rep(k, K) {
+            acc += static_cast<float>(src[m * K + k]) * get_weight(w, k, bits);
+        }
+        dst[m * N + n] = T(acc * scale[n]);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void WeightQuantMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in weight, _megdnn_tensor_in scale,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, weight.layout, scale.layout, dst.layout, workspace.size);
+    size_t M = src.layout[0], K = src.layout[1], N = weight.layout[0];
+    uint32_t bits = param().bits;
+#define cb(DType)                                                           \
+    if (src.layout.dtype == DType()) {                                      \
+        using ctype = typename DTypeTrait<DType>::ctype;                    \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(forward<ctype>(                        \
+                src.ptr<ctype>(), weight.ptr<dt_int8>(),                    \
+                scale.ptr<dt_float32>(), dst.ptr<ctype>(), M, K, N, bits)); \
+        return;                                                             \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_assert_internal(0);
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -51,6 +51,9 @@ void BNForwardImpl::exec(
     check_exec(
             src.layout, bn_scale.layout, bn_bias.layout, mean.layout, variance.layout,
             batch_mean.layout, batch_inv_variance.layout, dst.layout, workspace.size);
+    megdnn_assert(
+            m_param.nonlineMode == param::BN::NonlineMode::IDENTITY,
+            "fused relu of BN is not supported on rocm");
     auto handle = concrete_handle(this->handle())->miopen_handle();
     m_tensor_desc.setup(src.layout, m_param.param_dim);
 
@@ -90,6 +93,9 @@ void BNBackwardImpl::exec(
             x.layout, dy.layout, saved_batch_mean.layout,
             saved_batch_inv_variance.layout, bn_scale.layout, d_bn_scale.layout,
             d_bn_bias.layout, dx.layout, workspace.size);
+    megdnn_assert(
+            m_param.nonlineMode == param::BN::NonlineMode::IDENTITY,
+            "fused relu of BN is not supported on rocm");
     auto handle = concrete_handle(this->handle())->miopen_handle();
     m_tensor_desc.setup(x.layout, m_param.param_dim);
 
@@ -0,0 +1,141 @@
+/**
+ * \file dnn/src/rocm/conv_bias/algo.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "hcc_detail/hcc_defs_prologue.h"
+
+#include "src/rocm/conv_bias/algo.h"
+#include "src/common/algo_base.h"
+#include "src/common/conv_bias.h"
+
+using namespace megdnn;
+using namespace rocm;
+
+namespace {
+
+std::pair<TensorLayoutArray, ConvolutionForward::Param> sub_opr_config(
+        const ConvBiasForwardImpl::AlgoBase::SizeArgs& args) {
+    auto&& param = args.opr->param();
+    std::pair<TensorLayoutArray, ConvolutionForward::Param> ret;
+    ret.second = {param.mode,     param.pad_h,    param.pad_w,
+                  param.stride_h, param.stride_w, param.dilate_h,
+                  param.dilate_w, param.sparse,   param.format,
+                  param.compute_mode};
+    ret.first = {*args.src_layout, *args.filter_layout, *args.dst_layout};
+    return ret;
+}
+
+std::pair<TensorLayoutArray, std::unique_ptr<ConvolutionForward>> prepare_sub_opr(
+        const ConvBiasForwardImpl::AlgoBase::SizeArgs& args) {
+    auto conv_opr = args.opr->handle()->create_operator<ConvolutionForward>();
+    set_execution_policy<ConvBiasForward, ConvolutionForward*>(
+            args.opr, conv_opr.get());
+    auto&& config = sub_opr_config(args);
+    conv_opr->param() = config.second;
+    return {config.first, std::move(conv_opr)};
+}
+
+}  // namespace
+
+ConvBiasForwardImpl::AlgoPack::AlgoPack() {
+    all_algos.push_back(&convolution);
+
+    for (auto&& algo : all_algos) {
+        m_all_algos_map.emplace(algo->info().desc, algo);
+    }
+}
+
+ConvBiasForwardImpl::AlgoPack ConvBiasForwardImpl::sm_algo_pack;
+
+MEGDNN_DEF_GET_ALGO_FROM_DESC(ConvBiasForwardImpl)
+
+ConvBiasForwardImpl::AlgoBase::SizeArgs::SizeArgs(
+        const ConvBiasForwardImpl* o, const TensorLayout& src,
+        const TensorLayout& filter, const TensorLayout& bias, const TensorLayout& z,
+        const TensorLayout& dst)
+        : opr{o},
+          src_layout{&src},
+          filter_layout{&filter},
+          bias_layout{&bias},
+          z_layout{&z},
+          dst_layout{&dst} {}
+
+ConvBiasForwardImpl::AlgoBase::ExecArgs::ExecArgs(
+        ConvBiasForwardImpl* opr, _megdnn_tensor_in src, _megdnn_tensor_in filter,
+        _megdnn_tensor_in bias, _megdnn_tensor_in z, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace)
+        : SizeArgs(opr, src.layout, filter.layout, bias.layout, z.layout, dst.layout),
+          src_tensor{&src},
+          filter_tensor{&filter},
+          bias_tensor{&bias},
+          z_tensor{&z},
+          dst_tensor{&dst},
+          workspace{workspace} {}
+
+std::string ConvBiasForwardImpl::AlgoBase::SizeArgs::to_string() const {
+    return ssprintf(
+            "src=%s, filter=%s, bias=%s, z=%s, dst=%s, nonlineMode=%d",
+            src_layout->to_string().c_str(), filter_layout->to_string().c_str(),
+            bias_layout->to_string().c_str(), z_layout->to_string().c_str(),
+            dst_layout->to_string().c_str(),
+            static_cast<int>(opr->param().nonlineMode));
+}
+
+/* ===================== convolution algo ===================== */
+std::vector<Algorithm::SearchItem> ConvBiasForwardImpl::AlgoConvolution::
+        get_subopr_list(
+                const TensorLayoutArray& layouts, const OperatorBase* opr) const {
+    AlgoBase::SizeArgs args{
+            static_cast<const ConvBiasForwardImpl*>(opr),
+            layouts[0],
+            layouts[1],
+            layouts[2],
+            layouts[3],
+            layouts[4]};
+    auto&& config = sub_opr_config(args);
+
+    std::string param_str;
+    Algorithm::serialize_write_pod(config.second, param_str);
+    return {{Algorithm::OprType::CONVOLUTION_FORWARD, param_str, config.first}};
+}
+
+bool ConvBiasForwardImpl::AlgoConvolution::is_available(const SizeArgs& args) const {
+    auto&& param = args.opr->param();
+    if (args.z_layout->ndim > 0 || param.format != Param::Format::NCHW)
+        return false;
+    // the bias is fused after the convolution has been written to dst, so only
+    // float convolutions whose dst has the same dtype as src are supported
+    auto&& src_dtype = args.src_layout->dtype;
+    if (src_dtype.category() != DTypeCategory::FLOAT ||
+        src_dtype == dtype::BFloat16() || args.filter_layout->dtype != src_dtype ||
+        args.dst_layout->dtype != src_dtype)
+        return false;
+    return args.bias_layout->ndim == 0 || args.bias_layout->dtype == src_dtype;
+}
+
+size_t ConvBiasForwardImpl::AlgoConvolution::get_workspace_in_bytes(
+        const SizeArgs& args) const {
+    auto config = prepare_sub_opr(args);
+    return config.second->get_workspace_in_bytes(
+            config.first[0], config.first[1], config.first[2], nullptr);
+}
+
+void ConvBiasForwardImpl::AlgoConvolution::exec(const ExecArgs& args) const {
+    auto config = prepare_sub_opr(args);
+    config.second->exec(
+            *args.src_tensor, *args.filter_tensor, *args.dst_tensor, nullptr,
+            args.workspace);
+    handle_bias_and_nonlinear(
+            args.opr->handle(), args.opr->param(), args.dst_tensor, args.dst_tensor,
+            args.bias_tensor);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,122 @@
+/**
+ * \file dnn/src/rocm/conv_bias/algo.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#pragma once
+#include "megdnn/oprs.h"
+#include "src/common/algo_base.h"
+#include "src/common/metahelper.h"
+#include "src/common/utils.h"
+#include "src/rocm/conv_bias/opr_impl.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace megdnn {
+namespace rocm {
+
+/*!
+ * \brief base class for conv bias algos
+ */
+class ConvBiasForwardImpl::AlgoBase : public Algorithm {
+protected:
+    ~AlgoBase() = default;
+
+public:
+    enum class AlgoType : uint32_t {
+        ROCM_CONVOLUTION,
+    };
+    using Mapper = std::unordered_map<AlgorithmDesc, AlgoBase*>;
+
+    AlgoBase() : Algorithm() { m_handle_type = Handle::HandleType::ROCM; }
+    struct SizeArgs {
+        const ConvBiasForwardImpl* opr;
+        const TensorLayout *src_layout, *filter_layout, *bias_layout, *z_layout,
+                *dst_layout;
+
+        std::string to_string() const;
+        SizeArgs(
+                const ConvBiasForwardImpl* opr, const TensorLayout& src,
+                const TensorLayout& filter, const TensorLayout& bias,
+                const TensorLayout& z, const TensorLayout& dst);
+    };
+    struct ExecArgs : public SizeArgs {
+        const TensorND *src_tensor, *filter_tensor, *bias_tensor, *z_tensor,
+                *dst_tensor;
+        Workspace workspace;
+
+        ExecArgs(
+                ConvBiasForwardImpl* opr, _megdnn_tensor_in src,
+                _megdnn_tensor_in filter, _megdnn_tensor_in bias, _megdnn_tensor_in z,
+                _megdnn_tensor_out dst, _megdnn_workspace workspace);
+    };
+    virtual bool is_available(const SizeArgs& args) const = 0;
+    virtual size_t get_workspace_in_bytes(const SizeArgs& args) const = 0;
+    virtual void exec(const ExecArgs& args) const = 0;
+
+    bool is_available_wk(const SizeArgs& args, size_t limit) const {
+        return is_available(args) && get_workspace_in_bytes(args) <= limit;
+    }
+    bool is_available_attribute(
+            const SizeArgs& args,
+            const AlgoAttribute& positive_attr = AlgoAttribute::REPRODUCIBLE,
+            const AlgoAttribute& negative_attr = AlgoAttribute::DEFAULT,
+            size_t limit = std::numeric_limits<size_t>::max()) const {
+        return contain_attribute_all(positive_attr) &&
+               !contain_attribute_any(negative_attr) && is_available_wk(args, limit);
+    }
+    AlgoBase& check_workspace(const SizeArgs& args, const Workspace& workspace) {
+        auto req = get_workspace_in_bytes(args);
+        megdnn_assert(
+                req <= workspace.size,
+                "conv bias fwd algo %s: required workspace %zu bytes, got %zu", name(),
+                req, workspace.size);
+        return *this;
+    }
+};
+
+/*!
+ * \brief run a ConvolutionForward sub-opr directly into dst, then apply bias
+ *      and nonlinearity by a single fused elemwise in place
+ *
+ * The convolution algorithm (MIOpen find-mode results included) is exposed as
+ * a sub-opr, so it is profiled and cached by the fastrun algo chooser.
+ */
+class ConvBiasForwardImpl::AlgoConvolution final : public AlgoBase {
+public:
+    AlgoConvolution() = default;
+    bool is_available(const SizeArgs& args) const override;
+    size_t get_workspace_in_bytes(const SizeArgs& args) const override;
+    void exec(const ExecArgs& args) const override;
+    std::vector<SearchItem> get_subopr_list(
+            const TensorLayoutArray& layouts, const OperatorBase* opr) const override;
+
+    const char* name() const override { return "ROCM_CONVOLUTION"; }
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    MEGDNN_DECL_ALGO_TYPE(ROCM_CONVOLUTION)
+};
+
+class ConvBiasForwardImpl::AlgoPack : NonCopyableObj {
+private:
+    AlgoBase::Mapper m_all_algos_map;
+
+public:
+    AlgoPack();
+    AlgoConvolution convolution;
+    std::vector<AlgoBase*> all_algos;
+
+    const AlgoBase::Mapper& all_algos_map() const { return m_all_algos_map; }
+};
+
+}  // namespace rocm
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
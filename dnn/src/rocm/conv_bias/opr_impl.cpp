@@ -0,0 +1,69 @@
+/**
+ * \file dnn/src/rocm/conv_bias/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "hcc_detail/hcc_defs_prologue.h"
+
+#include "src/rocm/conv_bias/opr_impl.h"
+#include "src/rocm/conv_bias/algo.h"
+
+#include "src/common/algo_chooser.h"
+
+using namespace megdnn;
+using namespace rocm;
+
+void ConvBiasForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in filter, _megdnn_tensor_in bias,
+        _megdnn_tensor_in z, _megdnn_tensor_out dst,
+        const PreprocessedFilter* preprocessed_filter, _megdnn_workspace workspace) {
+    check_exec(
+            src.layout, filter.layout, bias.layout, z.layout, dst.layout,
+            workspace.size, preprocessed_filter);
+    AlgoBase::ExecArgs args(this, src, filter, bias, z, dst, workspace);
+    auto algo = get_algorithm(
+            this, src.layout, filter.layout, bias.layout, z.layout, dst.layout);
+    algo->check_workspace(args, workspace).exec(args);
+}
+
+std::vector<ConvBiasForward::Algorithm*> ConvBiasForwardImpl::get_all_algorithms(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& z, const TensorLayout& dst) {
+    return megdnn::get_all_algorithms<ConvBiasForwardImpl>(
+            {this, src, filter, bias, z, dst});
+}
+
+std::vector<ConvBiasForward::Algorithm*> ConvBiasForwardImpl::get_all_algorithms_safe(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& z, const TensorLayout& dst) {
+    return megdnn::get_all_algorithms_safe<ConvBiasForwardImpl>(
+            {this, src, filter, bias, z, dst});
+}
+
+ConvBiasForward::Algorithm* ConvBiasForwardImpl::get_algorithm_heuristic(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& z, const TensorLayout& dst, size_t workspace_limit_in_bytes,
+        const AlgoAttribute& positive_attr, const AlgoAttribute& negative_attr) {
+    AlgoBase::SizeArgs args{this, src, filter, bias, z, dst};
+    if (sm_algo_pack.convolution.is_available_attribute(
+                args, positive_attr, negative_attr, workspace_limit_in_bytes)) {
+        return &sm_algo_pack.convolution;
+    }
+    return megdnn::get_algo_match_attribute<ConvBiasForwardImpl>(
+            sm_algo_pack.all_algos, args, workspace_limit_in_bytes,
+            "rocm conv bias fwd", positive_attr, negative_attr);
+}
+
+size_t ConvBiasForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& z, const TensorLayout& dst, const PreprocessedFilter*) {
+    return get_dnn_workspace(this, src, filter, bias, z, dst);
+}
+
+// vim: syntax=cpp.doxygen
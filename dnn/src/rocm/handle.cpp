@@ -24,6 +24,7 @@
 #include "src/rocm/batch_normalization/opr_impl.h"
 #include "src/rocm/batched_matrix_mul/opr_impl.h"
 #include "src/rocm/checksum/opr_impl.h"
+#include "src/rocm/conv_bias/opr_impl.h"
 #include "src/rocm/convolution/opr_impl.h"
 #include "src/rocm/elemwise/opr_impl.h"
 #include "src/rocm/eye/opr_impl.h"
@@ -156,6 +157,7 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(ArgsortBackward);
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionForward);
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardData);
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardFilter);
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBiasForward);
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ElemwiseForward);
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Eye);
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ChecksumForward);
@@ -23,6 +23,9 @@ MEGDNN_REG_WINOGRAD_STRATEGY(
 
 MEGDNN_REG_WINOGRAD_STRATEGY(
         float, float, float, float, 2, 3, 8, 8, winograd_nchw88_2x3_8x8_f)
+
+MEGDNN_REG_WINOGRAD_STRATEGY(
+        float, float, float, float, 4, 3, 8, 8, winograd_nchw88_4x3_8x8_f)
 }  // namespace winograd
 }  // namespace x86
 }  // namespace megdnn
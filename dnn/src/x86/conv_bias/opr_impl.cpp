@@ -78,6 +78,10 @@ public:
                         static_cast<fallback::MatrixMulImpl::AlgoBase*>(algo),
                         tile_size));
                 m_winograd_algos.emplace_back(refhold.back().get());
+                refhold.emplace_back(new AlgoFP32WinogradF43_8x8(
+                        static_cast<fallback::MatrixMulImpl::AlgoBase*>(algo),
+                        tile_size));
+                m_winograd_algos.emplace_back(refhold.back().get());
                 refhold.emplace_back(new AlgoFP32WinogradF23_8x8(
                         static_cast<fallback::MatrixMulImpl::AlgoBase*>(algo),
                         tile_size));
@@ -158,8 +162,9 @@ bool ConvBiasImpl::is_matmul_quantized_prefer(
 #endif
     }
 
+    //! the avx512 and vnni matmuls are faster than the avx2 direct algos
     return !conv_direct_chanwise_mkldnn_usable ||
-           (is_supported(SIMDType::VNNI) &&
+           ((is_supported(SIMDType::VNNI) || is_supported(SIMDType::AVX512)) &&
             !chanwise_avx2_stride1_qint8_usable_preferred(param) &&
             !chanwise_avx2_stride2_qint8_usable_preferred(param));
 }
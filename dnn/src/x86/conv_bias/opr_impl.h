@@ -54,6 +54,7 @@ private:
     class AlgoDirectStride2;
     class AlgoFP32WinogradF63_8x8;
     class AlgoFP32WinogradF23_8x8;
+    class AlgoFP32WinogradF43_8x8;
     class AlgoDirectAvx2Stride1Int8;
     class AlgoAVX2DirectConvStride2;
     class AlgoChanWiseAvx2Stride1Qint8;
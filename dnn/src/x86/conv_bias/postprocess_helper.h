@@ -182,6 +182,7 @@ struct PostProcess<ctype, dtype, megdnn::PostprocessMode::NO_PROCESS> {
 #undef cb_binary
 #undef cb_unary
 #undef CALL_UNARY
+#undef CALL_BINARY
 #undef CALL_BINARY_BROADCAST
 
 #define CALL_UNARY(_op, _simd_type)                                           \
@@ -201,6 +202,16 @@ struct PostProcess<ctype, dtype, megdnn::PostprocessMode::NO_PROCESS> {
         reinterpret_cast<dtype*>(dst_ptr), bias_type, bias_type, dst_type, N, OC,    \
         OH* OW);
 
+#define CALL_BINARY(_op, _simd_type)                                          \
+    thin_function<void(                                                       \
+            const ctype*, const ctype*, dtype*, DType, DType, DType, size_t)> \
+            run = OpCallerBinary<                                             \
+                    _op<_simd_type, ctype, dtype>, _simd_type,                \
+                    megdnn::x86::BcastType::VEC_VEC>::run;                    \
+    run(static_cast<ctype*>(conv_dst_ptr), static_cast<ctype*>(bias_ptr),     \
+        reinterpret_cast<dtype*>(dst_ptr), bias_type, bias_type, dst_type,    \
+        N* OC* OH* OW);
+
 #define cb_unary(_simd_type)                                                 \
     if (elem_mode == megdnn::param::Elemwise::Mode::RELU) {                  \
         CALL_UNARY(ReluOp, _simd_type);                                      \
@@ -214,23 +225,13 @@ struct PostProcess<ctype, dtype, megdnn::PostprocessMode::NO_PROCESS> {
         }                                                                    \
     }
 
-#define FOR_NONLINEAR_NOBIAS()                                                   \
-    if (is_supported(SIMDType::AVX2)) {                                          \
-        if (elem_mode == megdnn::param::Elemwise::Mode::RELU) {                  \
-            CALL_UNARY(ReluOp, SIMDType::AVX2);                                  \
-        } else if (elem_mode == megdnn::param::Elemwise::Mode::H_SWISH) {        \
-            CALL_UNARY(HSwishOp, SIMDType::NONE);                                \
-        } else {                                                                 \
-            if (nonlineMode == megdnn::param::ConvBias::NonlineMode::IDENTITY) { \
-                CALL_UNARY(TypeCvtOp, SIMDType::NONE);                           \
-            } else {                                                             \
-                megdnn_throw("not supported nonlinemode\n");                     \
-            }                                                                    \
-        }                                                                        \
-    } else if (is_supported(SIMDType::SSE4_2)) {                                 \
-        cb_unary(SIMDType::SSE4_2)                                               \
-    } else {                                                                     \
-        cb_unary(SIMDType::NONE)                                                 \
+#define FOR_NONLINEAR_NOBIAS()                   \
+    if (is_supported(SIMDType::AVX2)) {          \
+        cb_unary(SIMDType::AVX2)                 \
+    } else if (is_supported(SIMDType::SSE4_2)) { \
+        cb_unary(SIMDType::SSE4_2)               \
+    } else {                                     \
+        cb_unary(SIMDType::NONE)                 \
     }
 
 #define cb_binary(_caller, _simd_type)                                         \
@@ -242,13 +243,13 @@ struct PostProcess<ctype, dtype, megdnn::PostprocessMode::NO_PROCESS> {
         _caller(FuseAddHSwishOp, _simd_type);                                  \
     }
 
-#define FOR_NONLINEAR(CALLER)                     \
-    if (is_supported(SIMDType::AVX2)) {           \
-        cb_binary(CALLER, SIMDType::AVX2)         \
-    } else if (!is_supported(SIMDType::SSE4_2)) { \
-        cb_binary(CALLER, SIMDType::SSE4_2)       \
-    } else {                                      \
-        cb_binary(CALLER, SIMDType::NONE)         \
+#define FOR_NONLINEAR(CALLER)                    \
+    if (is_supported(SIMDType::AVX2)) {          \
+        cb_binary(CALLER, SIMDType::AVX2)        \
+    } else if (is_supported(SIMDType::SSE4_2)) { \
+        cb_binary(CALLER, SIMDType::SSE4_2)      \
+    } else {                                     \
+        cb_binary(CALLER, SIMDType::NONE)        \
     }
 
 #define FOR_BIAS(bias_mode)                       \
@@ -259,10 +260,15 @@ struct PostProcess<ctype, dtype, megdnn::PostprocessMode::NO_PROCESS> {
         case BiasMode::BROADCAST_CHANNEL_BIAS:    \
             FOR_NONLINEAR(CALL_BINARY_BROADCAST); \
             break;                                \
+        case BiasMode::BIAS:                      \
+            FOR_NONLINEAR(CALL_BINARY);           \
+            break;                                \
         default:                                  \
             break;                                \
     }
 
+//! the bias, the activation and the requantization to dst_type are fused into
+//! one pass over the qint32 conv result
 template <typename ctype, typename dtype>
 struct PostProcess<ctype, dtype, megdnn::PostprocessMode::QUANTIZED> {
     static void run(
@@ -252,7 +252,7 @@ struct TypeCvtOp<SIMDType::AVX2, dt_qint32, dt_qint8>
 
     MEGDNN_ATTRIBUTE_TARGET("avx2")
     void operator()(const __m256ix2& vsrc, dt_qint8* dst) const {
-        _mm_store_si128((__m128i*)(dst), (operator()(vsrc)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), operator()(vsrc));
     }
 
     MEGDNN_ATTRIBUTE_TARGET("avx2")
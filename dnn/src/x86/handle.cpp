@@ -24,9 +24,13 @@
 #include "src/x86/lrn/opr_impl.h"
 #include "src/x86/matrix_mul/opr_impl.h"
 #include "src/x86/pooling/opr_impl.h"
+#include "src/x86/reduce/opr_impl.h"
+#include "src/x86/relayout/opr_impl.h"
+#include "src/x86/remap/opr_impl.h"
 #include "src/x86/resize/opr_impl.h"
 #include "src/x86/separable_conv/opr_impl.h"
 #include "src/x86/separable_filter/opr_impl.h"
+#include "src/x86/softmax/opr_impl.h"
 #include "src/x86/type_cvt/opr_impl.h"
 #include "src/x86/utils.h"
 #include "src/x86/warp_affine/opr_impl.h"
@@ -87,6 +91,10 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(WarpPerspective)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(AddUpdate)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(TypeCvt)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(RelayoutForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(Reduce)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(Remap)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -13,6 +13,7 @@
 #include "src/x86/matrix_mul/algos.h"
 #include "src/common/utils.h"
 #include "src/fallback/matrix_mul/gemm_impl.h"
+#include "src/x86/matrix_mul/bf16/strategy.h"
 #include "src/x86/matrix_mul/f32/strategy.h"
 #include "src/x86/matrix_mul/int8/strategy.h"
 
@@ -40,6 +41,7 @@ void f32_blas_kern(const MatrixMulImpl::KernParam& kern_param) {
             trB ? CblasTrans : CblasNoTrans, m, n, k, 1.0f, Aptr, Atrd, Bptr, Btrd,
             0.0f, Cptr, Ctrd);
 #else
+    MEGDNN_MARK_USED_VAR(kern_param);
     megdnn_throw("a blas library is required");
 #endif
 }
@@ -70,6 +72,7 @@ bool MatrixMulImpl::AlgoF32Blas::usable(const KernSizeParam& kern_size_param) co
            kern_size_param.C_type == kern_size_param.A_type &&
            kern_size_param.A_type == dtype::Float32() && preferred(kern_size_param);
 #else
+    MEGDNN_MARK_USED_VAR(kern_size_param);
     return false;
 #endif
 }
@@ -184,6 +187,112 @@ MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL_DETAIL(
         dt_uint8AlgoDataType::QINT8X8X32, DEFAULT);
 #endif
 
+/* ===================== Int8 AMX algo ===================== */
+#if MEGDNN_X86_WITH_AMX
+namespace {
+constexpr size_t AMX_ALIGN_SIZE = 64;
+
+void int8x8x32_kern_amx(const MatrixMulImpl::KernParam& kern_param) {
+    MEGDNN_MARK_USED_VAR(kern_param);
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("int8x8x32_kern_amx"_hash)) {
+        auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        auto trA = kern_param.trA, trB = kern_param.trB;
+        auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        auto A_type = kern_param.A_type, B_type = kern_param.B_type,
+             C_type = kern_param.C_type;
+        const auto Aptr = kern_param.A<dt_int8>(), Bptr = kern_param.B<dt_int8>();
+        auto Cptr = kern_param.C<dt_int32>();
+        x86::matmul::gemm_int8_amx_32x32x64 strategy(M, N, K, A_type, B_type, C_type);
+        megdnn::matmul::GemmInterleaved<x86::matmul::gemm_int8_amx_32x32x64>(
+                M, N, K, trA, trB, strategy, AMX_ALIGN_SIZE)
+                .execute(Aptr, LDA, Bptr, LDB, Cptr, LDC, kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+}  // namespace
+
+bool MatrixMulImpl::AlgoInt8x8x32AMX::usable(
+        const KernSizeParam& kern_size_param) const {
+    return kern_size_param.A_type.enumv() == kern_size_param.B_type.enumv() &&
+           ((kern_size_param.A_type.enumv() == DTypeEnum::Int8 &&
+             kern_size_param.C_type.enumv() == DTypeEnum::Int32) ||
+            (kern_size_param.A_type.enumv() == DTypeEnum::QuantizedS8 &&
+             kern_size_param.C_type.enumv() == DTypeEnum::QuantizedS32)) &&
+           kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           kern_size_param.format == Param::Format::DEFAULT &&
+           is_supported(SIMDType::AMX_INT8);
+}
+
+size_t MatrixMulImpl::AlgoInt8x8x32AMX::get_workspace(
+        const KernSizeParam& kern_param) const {
+    x86::matmul::gemm_int8_amx_32x32x64 strategy(
+            kern_param.M, kern_param.N, kern_param.K, kern_param.A_type,
+            kern_param.B_type, kern_param.C_type);
+    return megdnn::matmul::GemmInterleaved<x86::matmul::gemm_int8_amx_32x32x64>(
+                   kern_param.M, kern_param.N, kern_param.K, kern_param.trA,
+                   kern_param.trB, strategy, AMX_ALIGN_SIZE)
+            .get_workspace_size();
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoInt8x8x32AMX::get_kern(
+        const KernSizeParam&) const {
+    return int8x8x32_kern_amx;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoInt8x8x32AMX, megdnn_x86_matmul_kern, "AlgoInt8x8x32AMX"_hash,
+        x86::matmul::gemm_int8_amx_32x32x64, dt_int8, dt_int32,
+        AlgoDataType::QINT8X8X32, DEFAULT);
+
+/* ===================== BF16 AMX algo ===================== */
+#if !MEGDNN_DISABLE_FLOAT16
+namespace {
+void bf16_kern_amx(const MatrixMulImpl::KernParam& kern_param) {
+    MEGDNN_MARK_USED_VAR(kern_param);
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("bf16_kern_amx"_hash)) {
+        auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        auto trA = kern_param.trA, trB = kern_param.trB;
+        auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        auto A_type = kern_param.A_type, B_type = kern_param.B_type,
+             C_type = kern_param.C_type;
+        const auto Aptr = kern_param.A<dt_bfloat16>(),
+                   Bptr = kern_param.B<dt_bfloat16>();
+        auto Cptr = kern_param.C<dt_bfloat16>();
+        x86::matmul::gemm_bf16_amx_32x32x32 strategy(M, N, K, A_type, B_type, C_type);
+        megdnn::matmul::GemmInterleaved<x86::matmul::gemm_bf16_amx_32x32x32>(
+                M, N, K, trA, trB, strategy, AMX_ALIGN_SIZE)
+                .execute(Aptr, LDA, Bptr, LDB, Cptr, LDC, kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+}  // namespace
+
+bool MatrixMulImpl::AlgoBf16AMX::usable(const KernSizeParam& kern_size_param) const {
+    //! accumulation is always in float32, so both compute modes are accepted
+    return kern_size_param.A_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.B_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.C_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.format == Param::Format::DEFAULT &&
+           is_supported(SIMDType::AMX_BF16);
+}
+
+size_t MatrixMulImpl::AlgoBf16AMX::get_workspace(
+        const KernSizeParam& kern_param) const {
+    x86::matmul::gemm_bf16_amx_32x32x32 strategy(
+            kern_param.M, kern_param.N, kern_param.K, kern_param.A_type,
+            kern_param.B_type, kern_param.C_type);
+    return megdnn::matmul::GemmInterleaved<x86::matmul::gemm_bf16_amx_32x32x32>(
+                   kern_param.M, kern_param.N, kern_param.K, kern_param.trA,
+                   kern_param.trB, strategy, AMX_ALIGN_SIZE)
+            .get_workspace_size();
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoBf16AMX::get_kern(const KernSizeParam&) const {
+    return bf16_kern_amx;
+}
+#endif
+#endif
+
 /* ===================== Int8 mkldnn algo ===================== */
 #if MEGDNN_X86_WITH_MKL_DNN
 namespace {
@@ -289,6 +398,26 @@ void gemm_s8s8s32_avx2_4x16x2(const MatrixMulImpl::KernParam& kern_param) {
     MIDOUT_END();
 }
 
+void gemm_s8s8s32_avx512_8x32x2(const MatrixMulImpl::KernParam& kern_param) {
+    MEGDNN_MARK_USED_VAR(kern_param);
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern_avx512_8x32x2, midout_iv(0)) {
+        constexpr int cacheline = 64;
+        x86::matmul::gemm_avx512_s8s8s32_8x32x2 strategy(
+                kern_param.M, kern_param.N, kern_param.K, kern_param.A_type,
+                kern_param.B_type, kern_param.C_type);
+
+        megdnn::matmul::GemmInterleaved<x86::matmul::gemm_avx512_s8s8s32_8x32x2>(
+                kern_param.M, kern_param.N, kern_param.K, kern_param.trA,
+                kern_param.trB, strategy, cacheline)
+                .execute(
+                        kern_param.A<dt_int8>(), kern_param.LDA,
+                        kern_param.B<dt_int8>(), kern_param.LDB,
+                        kern_param.C<dt_int32>(), kern_param.LDC,
+                        kern_param.workspace_ptr);
+    }
+    MIDOUT_END();
+}
+
 void gemm_s8s8s32_sse_4x8x2(const MatrixMulImpl::KernParam& kern_param) {
     MEGDNN_MARK_USED_VAR(kern_param);
     MIDOUT_BEGIN(megdnn_x86_matmul_kern_sse_4x8x2, midout_iv(0)) {
@@ -494,6 +623,38 @@ MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL_DETAIL(
         "AlgoInt8x8x32AVX2M4N16K2"_hash, x86::matmul::gemm_avx2_s8s8s32_4x16x2, dt_int8,
         dt_int32, dt_int16, AlgoDataType::QINT8X8X32, DEFAULT);
 
+/*************************AlgoInt8x8x32AVX512M8N32K2********************/
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoInt8x8x32AVX512M8N32K2::get_kern(
+        const KernSizeParam&) const {
+    return gemm_s8s8s32_avx512_8x32x2;
+}
+bool MatrixMulImpl::AlgoInt8x8x32AVX512M8N32K2::usable(
+        const KernSizeParam& kern_size_param) const {
+    return kern_size_param.A_type.enumv() == kern_size_param.B_type.enumv() &&
+           ((kern_size_param.A_type.enumv() == DTypeEnum::Int8 &&
+             kern_size_param.C_type.enumv() == DTypeEnum::Int32) ||
+            (kern_size_param.A_type.enumv() == DTypeEnum::QuantizedS8 &&
+             kern_size_param.C_type.enumv() == DTypeEnum::QuantizedS32)) &&
+           kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           kern_size_param.format == Param::Format::DEFAULT &&
+           is_supported(SIMDType::AVX512);
+}
+size_t MatrixMulImpl::AlgoInt8x8x32AVX512M8N32K2::get_workspace(
+        const KernSizeParam& kern_param) const {
+    constexpr int cacheline = 64;
+    x86::matmul::gemm_avx512_s8s8s32_8x32x2 strategy(
+            kern_param.M, kern_param.N, kern_param.K, kern_param.A_type,
+            kern_param.B_type, kern_param.C_type);
+    return megdnn::matmul::GemmInterleaved<x86::matmul::gemm_avx512_s8s8s32_8x32x2>(
+                   kern_param.M, kern_param.N, kern_param.K, kern_param.trA,
+                   kern_param.trB, strategy, cacheline)
+            .get_workspace_size();
+}
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL_DETAIL(
+        AlgoInt8x8x32AVX512M8N32K2, megdnn_x86_matmul_kern,
+        "AlgoInt8x8x32AVX512M8N32K2"_hash, x86::matmul::gemm_avx512_s8s8s32_8x32x2,
+        dt_int8, dt_int32, dt_int16, AlgoDataType::QINT8X8X32, DEFAULT);
+
 MatrixMulImpl::kern_t MatrixMulImpl::AlgoInt8x8x32AVX2M2N4K16::get_kern(
         const KernSizeParam&) const {
     return gemm_s8s8s32_avx2_2x4x16;
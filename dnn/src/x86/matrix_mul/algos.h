@@ -79,6 +79,44 @@ public:
     MEGDNN_DECL_ALGO_TYPE(X86_INT8X8X32_AVX2_4X16X2)
 };
 
+class MatrixMulImpl::AlgoInt8x8x32AVX512M8N32K2 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_INT8X8X32_AVX512_8X32X2"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_INT8X8X32_AVX512_8X32X2)
+};
+
+#if MEGDNN_X86_WITH_AMX
+class MatrixMulImpl::AlgoInt8x8x32AMX : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_INT8X8X32_AMX_32X32X64"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_INT8X8X32_AMX_32X32X64)
+};
+
+#if !MEGDNN_DISABLE_FLOAT16
+class MatrixMulImpl::AlgoBf16AMX : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_BF16_AMX_32X32X32"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    PackMode packmode() const override { return PackMode::NO_PACK; }
+    MEGDNN_OVERRIDE_MATMUL_DESC(32, 32, 32, 2, AlgoDataType::BFLOAT16, DEFAULT)
+    MEGDNN_DECL_ALGO_TYPE(X86_BF16_AMX_32X32X32)
+};
+#endif
+#endif
+
 class MatrixMulImpl::AlgoInt8x8x16AVX2 : public AlgoBase {
 private:
     static void gemm_s8s8s16_avx2_4x16x2(const MatrixMulImpl::KernParam& kern_param);
@@ -0,0 +1,111 @@
+/**
+ * \file dnn/src/x86/matrix_mul/bf16/kernel_amx_32x32x32.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#if MEGDNN_X86_WITH_AMX && !MEGDNN_DISABLE_FLOAT16
+#include "megdnn/dtype.h"
+#include "src/x86/matrix_mul/common/amx_common.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul_amx_32x32x32 {
+
+//! number of bf16 along K held by a row of the A tiles
+constexpr int UNROLL_K = amx::TILE_BYTES / sizeof(uint16_t);
+
+static inline float bf16_to_f32(uint16_t v) {
+    uint32_t bits = static_cast<uint32_t>(v) << 16;
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+//! round to nearest even in the same way as dt_bfloat16
+static inline uint16_t f32_to_bf16(float v) {
+    dt_bfloat16 ret(v);
+    uint16_t bits;
+    memcpy(&bits, &ret, sizeof(bits));
+    return bits;
+}
+
+/*!
+ * \brief compute a 32x32 block of C
+ *
+ * The accumulators are float32 tiles, which are stored to a local buffer and
+ * rounded to bf16 when C is written; if is_first_k is false, the old value of
+ * C is added before rounding.
+ */
+MEGDNN_ATTRIBUTE_TARGET("amx-tile,amx-bf16")
+static void kern_32x32(
+        const uint16_t* packA, const uint16_t* packB, int K, uint16_t* output,
+        int LDC, bool is_first_k, int m_remain, int n_remain) {
+    constexpr int T = amx::TILE_ROWS, S = amx::KERNEL_SIZE;
+    constexpr int STRIDE = S * sizeof(float);
+    constexpr int TILE_ELEMS = T * amx::TILE_BYTES / sizeof(uint16_t);
+    alignas(64) float buf[S * S];
+
+    _tile_zero(0);
+    _tile_zero(1);
+    _tile_zero(2);
+    _tile_zero(3);
+    for (int k = 0; k < K; k += UNROLL_K) {
+        _tile_loadd(4, packA, amx::TILE_BYTES);
+        _tile_loadd(5, packA + TILE_ELEMS, amx::TILE_BYTES);
+        _tile_loadd(6, packB, amx::TILE_BYTES);
+        _tile_loadd(7, packB + TILE_ELEMS, amx::TILE_BYTES);
+        _tile_dpbf16ps(0, 4, 6);
+        _tile_dpbf16ps(1, 4, 7);
+        _tile_dpbf16ps(2, 5, 6);
+        _tile_dpbf16ps(3, 5, 7);
+        packA += 2 * TILE_ELEMS;
+        packB += 2 * TILE_ELEMS;
+    }
+    _tile_stored(0, buf, STRIDE);
+    _tile_stored(1, buf + T, STRIDE);
+    _tile_stored(2, buf + T * S, STRIDE);
+    _tile_stored(3, buf + T * S + T, STRIDE);
+
+    for (int i = 0; i < m_remain; ++i) {
+        uint16_t* out = output + i * LDC;
+        const float* acc = buf + i * S;
+        for (int j = 0; j < n_remain; ++j) {
+            float v = is_first_k ? acc[j] : acc[j] + bf16_to_f32(out[j]);
+            out[j] = f32_to_bf16(v);
+        }
+    }
+}
+
+static void gemm_bf16_amx_32x32x32(
+        const uint16_t* packA, const uint16_t* packB, int M, int N, int K,
+        uint16_t* C, int LDC, bool is_first_k) {
+    constexpr int S = amx::KERNEL_SIZE;
+    //! K is packed to times of UNROLL_K
+    K = round_up(K, UNROLL_K);
+    amx::config_tiles();
+    for (int m = 0; m < M; m += S) {
+        const uint16_t* cur_packB = packB;
+        for (int n = 0; n < N; n += S) {
+            kern_32x32(
+                    packA, cur_packB, K, C + m * LDC + n, LDC, is_first_k,
+                    std::min(M - m, S), std::min(N - n, S));
+            cur_packB += K * S;
+        }
+        packA += K * S;
+    }
+    amx::release_tiles();
+}
+
+}  // namespace matmul_amx_32x32x32
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,137 @@
+/**
+ * \file dnn/src/x86/matrix_mul/common/amx_common.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#if MEGDNN_X86_WITH_AMX
+#include <immintrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace x86 {
+namespace amx {
+
+//! memory layout of the operand of ldtilecfg
+struct alignas(64) TileConfig {
+    uint8_t palette_id;
+    uint8_t start_row;
+    uint8_t reserved[14];
+    uint16_t colsb[16];
+    uint8_t rows[16];
+};
+
+//! all the tiles used by the kernels are 16 rows of 64 bytes
+constexpr int TILE_ROWS = 16;
+constexpr int TILE_BYTES = 64;
+
+//! the kernels compute 32x32 blocks of C by 2x2 tiles
+constexpr int KERNEL_SIZE = 32;
+
+/*!
+ * \brief configure tmm0-tmm7 for the 32x32 kernels
+ *
+ * tmm0-tmm3 hold the 2x2 tiles of C, tmm4-tmm5 hold the two row blocks of A
+ * and tmm6-tmm7 hold the two column blocks of B.
+ */
+MEGDNN_ATTRIBUTE_TARGET("amx-tile")
+static inline void config_tiles() {
+    TileConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.palette_id = 1;
+    for (int i = 0; i < 8; ++i) {
+        cfg.rows[i] = TILE_ROWS;
+        cfg.colsb[i] = TILE_BYTES;
+    }
+    //! the operand of ldtilecfg in some versions of gcc only covers 8 bytes,
+    //! which allows the compiler to drop the stores to rows and colsb
+    asm volatile("" : : "r"(&cfg) : "memory");
+    _tile_loadconfig(&cfg);
+}
+
+MEGDNN_ATTRIBUTE_TARGET("amx-tile")
+static inline void release_tiles() {
+    _tile_release();
+}
+
+/*!
+ * \brief pack A into blocks of 32 rows; each block stores 32 rows of
+ *      TILE_BYTES for each step of K, which are the two tiles of A
+ *
+ * \tparam T element type; bf16 is packed as its bits
+ */
+template <typename T>
+static inline void pack_A(
+        T* out, const T* in, int ldin, int y0, int ymax, int k0, int kmax,
+        bool transpose) {
+    constexpr int UNROLL_K = TILE_BYTES / sizeof(T);
+    for (int y = y0; y < ymax; y += KERNEL_SIZE) {
+        for (int k = k0; k < kmax; k += UNROLL_K) {
+            int klen = std::min(UNROLL_K, kmax - k);
+            for (int r = 0; r < KERNEL_SIZE; ++r, out += UNROLL_K) {
+                int yy = y + r;
+                if (yy >= ymax) {
+                    memset(out, 0, sizeof(T) * UNROLL_K);
+                    continue;
+                }
+                if (transpose) {
+                    for (int kk = 0; kk < klen; ++kk) {
+                        out[kk] = in[(k + kk) * ldin + yy];
+                    }
+                } else {
+                    memcpy(out, in + yy * ldin + k, sizeof(T) * klen);
+                }
+                memset(out + klen, 0, sizeof(T) * (UNROLL_K - klen));
+            }
+        }
+    }
+}
+
+/*!
+ * \brief pack B into blocks of 32 columns; for each step of K, a block stores
+ *      two tiles of 16 columns, whose rows interleave 4 bytes of K for each
+ *      column as required by the tile dot product instructions
+ */
+template <typename T>
+static inline void pack_B(
+        T* out, const T* in, int ldin, int x0, int xmax, int k0, int kmax,
+        bool transpose) {
+    constexpr int UNROLL_K = TILE_BYTES / sizeof(T), GROUP = 4 / sizeof(T);
+    for (int x = x0; x < xmax; x += KERNEL_SIZE) {
+        for (int k = k0; k < kmax; k += UNROLL_K) {
+            for (int t = 0; t < 2; ++t) {
+                for (int kr = 0; kr < UNROLL_K; kr += GROUP) {
+                    for (int n = 0; n < TILE_ROWS; ++n) {
+                        int xx = x + t * TILE_ROWS + n;
+                        for (int g = 0; g < GROUP; ++g) {
+                            int kk = k + kr + g;
+                            if (xx < xmax && kk < kmax) {
+                                *out++ = transpose ? in[xx * ldin + kk]
+                                                   : in[kk * ldin + xx];
+                            } else {
+                                *out++ = T(0);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace amx
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
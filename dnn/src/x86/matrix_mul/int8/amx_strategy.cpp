@@ -0,0 +1,54 @@
+/**
+ * \file dnn/src/x86/matrix_mul/int8/amx_strategy.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#if MEGDNN_X86_WITH_AMX
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/int8/kernel_amx_32x32x64.h"
+#include "src/x86/matrix_mul/int8/strategy.h"
+
+using namespace megdnn;
+using namespace x86;
+using namespace x86::matmul;
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(gemm_int8_amx_32x32x64);
+
+void gemm_int8_amx_32x32x64::pack_A(
+        dt_int8* out, const dt_int8* in, int ldin, int y0, int ymax, int k0, int kmax,
+        bool transpose) const {
+    amx::pack_A(out, in, ldin, y0, ymax, k0, kmax, transpose);
+}
+
+void gemm_int8_amx_32x32x64::pack_B(
+        dt_int8* out, const dt_int8* in, int ldin, int x0, int xmax, int k0, int kmax,
+        bool transpose) const {
+    amx::pack_B(out, in, ldin, x0, xmax, k0, kmax, transpose);
+}
+
+void gemm_int8_amx_32x32x64::kern(
+        const dt_int8* packA, const dt_int8* packB, size_t M, size_t N, size_t K,
+        dt_int32* C, size_t LDC, bool is_first_k, const dt_int32*, dt_int32*) const {
+    megdnn_assert(
+            A_dtype.enumv() == B_dtype.enumv() &&
+                    ((A_dtype.enumv() == DTypeEnum::Int8 &&
+                      C_dtype.enumv() == DTypeEnum::Int32) ||
+                     (A_dtype.enumv() == DTypeEnum::QuantizedS8 &&
+                      C_dtype.enumv() == DTypeEnum::QuantizedS32)),
+            "A: %s B: %s C: %s", A_dtype.name(), B_dtype.name(), C_dtype.name());
+
+    MEGDNN_MARK_USED_VAR(A_dtype);
+    MEGDNN_MARK_USED_VAR(B_dtype);
+    MEGDNN_MARK_USED_VAR(C_dtype);
+
+    matmul_amx_32x32x64::gemm_s8s8s32_amx_32x32x64(
+            packA, packB, M, N, K, C, LDC, is_first_k);
+}
+#endif
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,89 @@
+/**
+ * \file dnn/src/x86/matrix_mul/int8/avx512_strategy_8x32x2.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/int8/kernel_avx512_8x32x2.h"
+#include "src/x86/matrix_mul/int8/strategy.h"
+#include "src/x86/utils.h"
+
+using namespace megdnn;
+using namespace x86;
+using namespace x86::matmul;
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(gemm_avx512_s8s8s32_8x32x2);
+
+//! the packed layouts are shared with gemm_avx2_s8s8s32_4x16x2
+void gemm_avx512_s8s8s32_8x32x2::pack_A(
+        dt_int16* out, const dt_int8* in, int ldin, int y0, int ymax, int k0, int kmax,
+        bool transpose) const {
+    gemm_avx2_s8s8s32_4x16x2 strategy(block_m, block_n, block_k, A_dtype, B_dtype,
+                                      C_dtype);
+    strategy.pack_A(out, in, ldin, y0, ymax, k0, kmax, transpose);
+}
+
+void gemm_avx512_s8s8s32_8x32x2::pack_B(
+        dt_int8* out, const dt_int8* in, int ldin, int x0, int xmax, int k0, int kmax,
+        bool transpose) const {
+    gemm_avx2_s8s8s32_4x16x2 strategy(block_m, block_n, block_k, A_dtype, B_dtype,
+                                      C_dtype);
+    strategy.pack_B(out, in, ldin, x0, xmax, k0, kmax, transpose);
+}
+
+void gemm_avx512_s8s8s32_8x32x2::kern(
+        const dt_int16* pack_a_ptr, const dt_int8* pack_b_ptr, size_t m, size_t n,
+        size_t k, dt_int32* c_ptr, size_t ldc, bool is_first_k, const dt_int32*,
+        dt_int32*) const {
+    megdnn_assert(
+            A_dtype.enumv() == B_dtype.enumv() &&
+                    ((A_dtype.enumv() == DTypeEnum::Int8 &&
+                      C_dtype.enumv() == DTypeEnum::Int32) ||
+                     (A_dtype.enumv() == DTypeEnum::QuantizedS8 &&
+                      C_dtype.enumv() == DTypeEnum::QuantizedS32)),
+            "A: %s B: %s C: %s", A_dtype.name(), B_dtype.name(), C_dtype.name());
+    megdnn_assert(is_first_k == true);
+    constexpr size_t m_tile = 8;
+    constexpr size_t n_tile = 32;
+    const size_t roundup_k = round_up<size_t>(k, 2);
+    //! distance between the packed blocks of 4 rows or 16 columns
+    const size_t a_stride = 4 * roundup_k;
+    const size_t b_stride = 16 * roundup_k;
+
+    using namespace matmul_avx512_8x32x2;
+    for (size_t m_offset = 0; m_offset < m; m_offset += m_tile) {
+        const size_t remain_m = std::min(m - m_offset, m_tile);
+        auto iter_a_ptr = pack_a_ptr + m_offset * roundup_k;
+        for (size_t n_offset = 0; n_offset < n; n_offset += n_tile) {
+            const size_t remain_n = std::min(n - n_offset, n_tile);
+            auto iter_b_ptr = pack_b_ptr + n_offset * roundup_k;
+            auto iter_c_ptr = c_ptr + m_offset * ldc + n_offset;
+            if (remain_m > 4 && remain_n > 16) {
+                kern_gemm_s8s8s32_avx512_8x32x2<2, 2>(
+                        iter_a_ptr, a_stride, iter_b_ptr, b_stride, iter_c_ptr, ldc,
+                        k, remain_m, remain_n);
+            } else if (remain_m > 4) {
+                kern_gemm_s8s8s32_avx512_8x32x2<2, 1>(
+                        iter_a_ptr, a_stride, iter_b_ptr, b_stride, iter_c_ptr, ldc,
+                        k, remain_m, remain_n);
+            } else if (remain_n > 16) {
+                kern_gemm_s8s8s32_avx512_8x32x2<1, 2>(
+                        iter_a_ptr, a_stride, iter_b_ptr, b_stride, iter_c_ptr, ldc,
+                        k, remain_m, remain_n);
+            } else {
+                kern_gemm_s8s8s32_avx512_8x32x2<1, 1>(
+                        iter_a_ptr, a_stride, iter_b_ptr, b_stride, iter_c_ptr, ldc,
+                        k, remain_m, remain_n);
+            }
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,95 @@
+/**
+ * \file dnn/src/x86/matrix_mul/int8/kernel_amx_32x32x64.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#if MEGDNN_X86_WITH_AMX
+#include "src/x86/matrix_mul/common/amx_common.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul_amx_32x32x64 {
+
+constexpr int UNROLL_K = amx::TILE_BYTES;
+
+MEGDNN_ATTRIBUTE_TARGET("amx-tile,amx-int8")
+static void kern_32x32(
+        const int8_t* packA, const int8_t* packB, int K, int32_t* output, int LDC,
+        bool is_first_k, int m_remain, int n_remain) {
+    constexpr int T = amx::TILE_ROWS, S = amx::KERNEL_SIZE;
+    alignas(64) int32_t buf[S * S];
+    bool full = m_remain == S && n_remain == S;
+    int32_t* dst = full ? output : buf;
+    int ld = full ? LDC : S;
+
+    if (is_first_k) {
+        _tile_zero(0);
+        _tile_zero(1);
+        _tile_zero(2);
+        _tile_zero(3);
+    } else {
+        if (!full) {
+            for (int i = 0; i < m_remain; ++i) {
+                memcpy(buf + i * S, output + i * LDC, sizeof(int32_t) * n_remain);
+            }
+        }
+        _tile_loadd(0, dst, ld * sizeof(int32_t));
+        _tile_loadd(1, dst + T, ld * sizeof(int32_t));
+        _tile_loadd(2, dst + T * ld, ld * sizeof(int32_t));
+        _tile_loadd(3, dst + T * ld + T, ld * sizeof(int32_t));
+    }
+    for (int k = 0; k < K; k += UNROLL_K) {
+        _tile_loadd(4, packA, amx::TILE_BYTES);
+        _tile_loadd(5, packA + T * amx::TILE_BYTES, amx::TILE_BYTES);
+        _tile_loadd(6, packB, amx::TILE_BYTES);
+        _tile_loadd(7, packB + T * amx::TILE_BYTES, amx::TILE_BYTES);
+        _tile_dpbssd(0, 4, 6);
+        _tile_dpbssd(1, 4, 7);
+        _tile_dpbssd(2, 5, 6);
+        _tile_dpbssd(3, 5, 7);
+        packA += S * amx::TILE_BYTES;
+        packB += S * amx::TILE_BYTES;
+    }
+    _tile_stored(0, dst, ld * sizeof(int32_t));
+    _tile_stored(1, dst + T, ld * sizeof(int32_t));
+    _tile_stored(2, dst + T * ld, ld * sizeof(int32_t));
+    _tile_stored(3, dst + T * ld + T, ld * sizeof(int32_t));
+    if (!full) {
+        for (int i = 0; i < m_remain; ++i) {
+            memcpy(output + i * LDC, buf + i * S, sizeof(int32_t) * n_remain);
+        }
+    }
+}
+
+static void gemm_s8s8s32_amx_32x32x64(
+        const int8_t* packA, const int8_t* packB, int M, int N, int K, int32_t* C,
+        int LDC, bool is_first_k) {
+    constexpr int S = amx::KERNEL_SIZE;
+    //! K is packed to times of UNROLL_K
+    K = round_up(K, UNROLL_K);
+    amx::config_tiles();
+    for (int m = 0; m < M; m += S) {
+        const int8_t* cur_packB = packB;
+        for (int n = 0; n < N; n += S) {
+            kern_32x32(
+                    packA, cur_packB, K, C + m * LDC + n, LDC, is_first_k,
+                    std::min(M - m, S), std::min(N - n, S));
+            cur_packB += K * S;
+        }
+        packA += K * S;
+    }
+    amx::release_tiles();
+}
+
+}  // namespace matmul_amx_32x32x64
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,90 @@
+/**
+ * \file dnn/src/x86/matrix_mul/int8/kernel_avx512_8x32x2.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include <immintrin.h>
+#include <cstdint>
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace x86 {
+
+/*!
+ * The packed layouts are the same as matmul_avx2_4x16x2: A is packed into
+ * blocks of 4 rows, which hold the int16 values of the 4 rows for each pair of
+ * k; B is packed into panels of 16 columns, which hold the interleaved int8
+ * values of 2 rows of k for each column. A zmm register holds a whole panel
+ * row after being widened to int16, so the kernel computes 2 blocks by 2
+ * panels at a time.
+ */
+namespace matmul_avx512_8x32x2 {
+
+/*!
+ * \brief compute nr_m_block * 4 rows by nr_n_block * 16 columns of C
+ *
+ * \param a_stride distance between adjacent blocks of packed A
+ * \param b_stride distance between adjacent panels of packed B
+ * \param remain_m number of rows to be stored
+ * \param remain_n number of columns to be stored
+ */
+template <int nr_m_block, int nr_n_block>
+MEGDNN_ATTRIBUTE_TARGET("avx512f,avx512bw")
+static inline void kern_gemm_s8s8s32_avx512_8x32x2(
+        const int16_t* pack_a_ptr, size_t a_stride, const int8_t* pack_b_ptr,
+        size_t b_stride, int32_t* c_ptr, size_t ldc, size_t k, size_t remain_m,
+        size_t remain_n) {
+    constexpr size_t k_step = 2;
+    constexpr int nr_row = nr_m_block * 4;
+
+    __m512i c_vec[nr_row][nr_n_block];
+    for (int i = 0; i < nr_row; ++i) {
+        for (int j = 0; j < nr_n_block; ++j) {
+            c_vec[i][j] = _mm512_setzero_si512();
+        }
+    }
+
+    for (size_t iter_k = 0; iter_k < k; iter_k += k_step) {
+        __m512i b_vec[nr_n_block];
+        for (int j = 0; j < nr_n_block; ++j) {
+            b_vec[j] = _mm512_cvtepi8_epi16(_mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(pack_b_ptr + j * b_stride)));
+        }
+        for (int i = 0; i < nr_row; ++i) {
+            __m512i a_vec = _mm512_set1_epi32(*reinterpret_cast<const int32_t*>(
+                    pack_a_ptr + i / 4 * a_stride + i % 4 * 2));
+            for (int j = 0; j < nr_n_block; ++j) {
+                c_vec[i][j] = _mm512_add_epi32(
+                        c_vec[i][j], _mm512_madd_epi16(a_vec, b_vec[j]));
+            }
+        }
+        pack_a_ptr += 8;
+        pack_b_ptr += 32;
+    }
+
+    for (int i = 0; i < nr_row && i < static_cast<int>(remain_m); ++i) {
+        int32_t* output = c_ptr + i * ldc;
+        for (int j = 0; j < nr_n_block; ++j) {
+            const size_t n_start = j * 16;
+            if (remain_n >= n_start + 16) {
+                _mm512_storeu_si512(output + j * 16, c_vec[i][j]);
+            } else if (remain_n > n_start) {
+                __mmask16 mask = (1u << (remain_n - n_start)) - 1;
+                _mm512_mask_storeu_epi32(output + j * 16, mask, c_vec[i][j]);
+            }
+        }
+    }
+}
+
+}  // namespace matmul_avx512_8x32x2
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
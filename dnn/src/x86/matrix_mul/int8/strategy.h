@@ -23,6 +23,11 @@ MEGDNN_REG_GEMM_STRATEGY_WITH_PACK_A_TYPE(
         gemm_int8_vnni_12x32x4);
 #endif
 
+#if MEGDNN_X86_WITH_AMX
+MEGDNN_REG_GEMM_STRATEGY(
+        dt_int8, dt_int32, dt_int32, 32, 32, 64, false, false, gemm_int8_amx_32x32x64);
+#endif
+
 MEGDNN_REG_GEMM_STRATEGY(
         dt_int8, dt_int32, dt_int32, 2, 4, 16, false, false, gemm_avx2_s8s8s32_2x4x16);
 
@@ -34,6 +39,10 @@ MEGDNN_REG_GEMM_STRATEGY_WITH_PACK_A_TYPE(
         dt_int8, dt_int16, dt_int16, dt_int32, 4, 16, 2, false, false,
         gemm_avx2_s8s8s16_4x16x2);
 
+MEGDNN_REG_GEMM_STRATEGY_WITH_PACK_A_TYPE(
+        dt_int8, dt_int16, dt_int32, dt_int32, 8, 32, 2, false, false,
+        gemm_avx512_s8s8s32_8x32x2);
+
 MEGDNN_REG_GEMM_STRATEGY_WITH_PACK_A_TYPE(
         dt_int8, dt_int16, dt_int32, dt_int32, 4, 8, 2, false, false,
         gemm_sse_s8s8s32_4x8x2);
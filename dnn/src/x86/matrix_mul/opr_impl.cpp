@@ -25,9 +25,16 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
 #if MEGDNN_X86_WITH_VNNI
     AlgoInt8x8x32Vnni algoint8x8x32vnni;
 #endif
+#if MEGDNN_X86_WITH_AMX
+    AlgoInt8x8x32AMX algoint8x8x32amx;
+#if !MEGDNN_DISABLE_FLOAT16
+    AlgoBf16AMX algobf16amx;
+#endif
+#endif
 #if MEGDNN_X86_WITH_MKL_DNN
     AlgoInt8x8x32Mkldnn algoint8x8x32mkldnn;
 #endif
+    AlgoInt8x8x32AVX512M8N32K2 algoint8x8x32avx512_m8n32k2;
     AlgoInt8x8x32AVX2M4N16K2 algoint8x8x32avx2_m4n16k2;
     AlgoInt8x8x32AVX2M2N4K16 algoint8x8x32avx2_m2n4k16;
     AlgoInt8x8x32SSEM4N8K2 algoint8x8x32sse_m4n8k2;
@@ -40,11 +47,22 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
 
 public:
     AlgoPack() {
+#if MEGDNN_X86_WITH_AMX
+        if (is_supported(SIMDType::AMX_INT8)) {
+            m_all_algos.emplace_back(&algoint8x8x32amx);
+        }
+#if !MEGDNN_DISABLE_FLOAT16
+        if (is_supported(SIMDType::AMX_BF16)) {
+            m_all_algos.emplace_back(&algobf16amx);
+        }
+#endif
+#endif
         if (is_supported(SIMDType::VNNI)) {
 #if MEGDNN_X86_WITH_VNNI
             m_all_algos.emplace_back(&algoint8x8x32vnni);
 #endif
         }
+        m_all_algos.emplace_back(&algoint8x8x32avx512_m8n32k2);
         m_all_algos.emplace_back(&algoint8x8x32avx2_m4n16k2);
         m_all_algos.emplace_back(&algoint8x8x16avx2_m4n16k2);
         m_all_algos.emplace_back(&algoint8x8x32avx2_m2n4k16);
@@ -55,6 +55,12 @@ private:
 #if MEGDNN_X86_WITH_VNNI
     class AlgoInt8x8x32Vnni;
 #endif
+#if MEGDNN_X86_WITH_AMX
+    class AlgoInt8x8x32AMX;
+#if !MEGDNN_DISABLE_FLOAT16
+    class AlgoBf16AMX;
+#endif
+#endif
 
 #if MEGDNN_X86_WITH_MKL_DNN
     class AlgoInt8x8x32Mkldnn;
@@ -62,6 +68,7 @@ private:
 
     class AlgoInt8x8x32AVX2M2N4K16;
     class AlgoInt8x8x32AVX2M4N16K2;
+    class AlgoInt8x8x32AVX512M8N32K2;
     class AlgoInt8x8x32SSEM4N8K2;
     class AlgoInt8x8x16AVX2;
     class AlgoInt8x8x16SSE;
@@ -0,0 +1,278 @@
+/**
+ * \file dnn/src/x86/reduce/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/reduce/opr_impl.h"
+#include "src/common/reduce_helper.h"
+#include "src/naive/handle.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <limits>
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_reduce)
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+using Mode = param::Reduce::Mode;
+
+//! number of columns reduced by each task of the column reductions
+constexpr size_t COL_BLOCK = 64;
+//! least number of elements of src reduced by each task of the row reductions
+constexpr size_t MIN_TASK_SIZE = 4096;
+
+template <Mode mode>
+struct ReduceOp;
+
+template <>
+struct ReduceOp<Mode::SUM> {
+    static float init() { return 0.f; }
+    static float visit(float x) { return x; }
+    static float apply(float x, float y) { return x + y; }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 visit(__m256 x) { return x; }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 apply(__m256 x, __m256 y) { return _mm256_add_ps(x, y); }
+    static float write(float x, size_t) { return x; }
+};
+
+template <>
+struct ReduceOp<Mode::MEAN> : ReduceOp<Mode::SUM> {
+    static float write(float x, size_t n) { return x / static_cast<float>(n); }
+};
+
+template <>
+struct ReduceOp<Mode::SUM_SQR> : ReduceOp<Mode::SUM> {
+    static float visit(float x) { return x * x; }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 visit(__m256 x) { return _mm256_mul_ps(x, x); }
+};
+
+template <>
+struct ReduceOp<Mode::MAX> {
+    static float init() { return -std::numeric_limits<float>::infinity(); }
+    static float visit(float x) { return x; }
+    static float apply(float x, float y) { return std::max(x, y); }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 visit(__m256 x) { return x; }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 apply(__m256 x, __m256 y) { return _mm256_max_ps(x, y); }
+    static float write(float x, size_t) { return x; }
+};
+
+template <>
+struct ReduceOp<Mode::MIN> {
+    static float init() { return std::numeric_limits<float>::infinity(); }
+    static float visit(float x) { return x; }
+    static float apply(float x, float y) { return std::min(x, y); }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 visit(__m256 x) { return x; }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 apply(__m256 x, __m256 y) { return _mm256_min_ps(x, y); }
+    static float write(float x, size_t) { return x; }
+};
+
+//! reduce \p nr_seg segments of \p len elements which are \p stride apart
+template <Mode mode>
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+float reduce_segments(const float* src, size_t nr_seg, size_t stride, size_t len) {
+    using Op = ReduceOp<mode>;
+    __m256 acc[4];
+    for (auto& v : acc) {
+        v = _mm256_set1_ps(Op::init());
+    }
+    float res = Op::init();
+    for (size_t s = 0; s < nr_seg; ++s, src += stride) {
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32) {
+            for (int j = 0; j < 4; ++j) {
+                acc[j] = Op::apply(acc[j], Op::visit(_mm256_loadu_ps(src + i + j * 8)));
+            }
+        }
+        for (; i + 8 <= len; i += 8) {
+            acc[0] = Op::apply(acc[0], Op::visit(_mm256_loadu_ps(src + i)));
+        }
+        for (; i < len; ++i) {
+            res = Op::apply(res, Op::visit(src[i]));
+        }
+    }
+    float lanes[8];
+    _mm256_storeu_ps(
+            lanes, Op::apply(Op::apply(acc[0], acc[1]), Op::apply(acc[2], acc[3])));
+    for (float x : lanes) {
+        res = Op::apply(res, x);
+    }
+    return res;
+}
+
+template <Mode mode>
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline void write_lanes(float* dst, __m256 v, size_t n) {
+    float lanes[8];
+    _mm256_storeu_ps(lanes, v);
+    for (int i = 0; i < 8; ++i) {
+        dst[i] = ReduceOp<mode>::write(lanes[i], n);
+    }
+}
+
+/*!
+ * \brief reduce the columns of a matrix of \p nr_row rows, which are \p ld
+ *      apart, and write the first \p nr_col columns of the result
+ */
+template <Mode mode>
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void reduce_cols(
+        const float* src, float* dst, size_t nr_row, size_t ld, size_t nr_col,
+        size_t n) {
+    using Op = ReduceOp<mode>;
+    size_t j = 0;
+    for (; j + 32 <= nr_col; j += 32) {
+        __m256 acc[4];
+        for (auto& v : acc) {
+            v = _mm256_set1_ps(Op::init());
+        }
+        for (size_t i = 0; i < nr_row; ++i) {
+            const float* row = src + i * ld + j;
+            for (int k = 0; k < 4; ++k) {
+                acc[k] = Op::apply(acc[k], Op::visit(_mm256_loadu_ps(row + k * 8)));
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            write_lanes<mode>(dst + j + k * 8, acc[k], n);
+        }
+    }
+    for (; j + 8 <= nr_col; j += 8) {
+        __m256 acc = _mm256_set1_ps(Op::init());
+        for (size_t i = 0; i < nr_row; ++i) {
+            acc = Op::apply(acc, Op::visit(_mm256_loadu_ps(src + i * ld + j)));
+        }
+        write_lanes<mode>(dst + j, acc, n);
+    }
+    for (; j < nr_col; ++j) {
+        float res = Op::init();
+        for (size_t i = 0; i < nr_row; ++i) {
+            res = Op::apply(res, Op::visit(src[i * ld + j]));
+        }
+        dst[j] = Op::write(res, n);
+    }
+}
+
+/*!
+ * \brief reduce (A, B, C) to (A, 1, C), or to (1, B, 1) if \p target_shape
+ *
+ * The tasks are split over the kept dimensions, so that every element of dst
+ * is computed by one task in one pass.
+ */
+template <Mode mode>
+void dispatch_kern(
+        naive::HandleImpl* handle, const float* sptr, float* dptr, size_t A,
+        size_t B, size_t C, bool target_shape) {
+    using Op = ReduceOp<mode>;
+    //! the reduction is of rows if the innermost axis is reduced, otherwise it
+    //! is of columns
+    size_t nr_row, nr_col, len, nr_reduced;
+    if (target_shape) {
+        nr_row = A;
+        nr_col = B;
+        len = C;
+        nr_reduced = A * C;
+    } else {
+        nr_row = B;
+        nr_col = C;
+        len = C == 1 ? B : 1;
+        nr_reduced = B;
+    }
+    if (target_shape && C > 1) {
+        size_t per_task = std::max<size_t>(1, MIN_TASK_SIZE / nr_reduced);
+        auto run = [=](size_t index, size_t) {
+            size_t b0 = index * per_task, b1 = std::min(B, b0 + per_task);
+            for (size_t b = b0; b < b1; ++b) {
+                dptr[b] = Op::write(
+                        reduce_segments<mode>(sptr + b * C, A, B * C, C), nr_reduced);
+            }
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, div_ceil(B, per_task), run);
+    } else if (!target_shape && C == 1) {
+        size_t per_task = std::max<size_t>(1, MIN_TASK_SIZE / len);
+        auto run = [=](size_t index, size_t) {
+            size_t a0 = index * per_task, a1 = std::min(A, a0 + per_task);
+            for (size_t a = a0; a < a1; ++a) {
+                dptr[a] = Op::write(
+                        reduce_segments<mode>(sptr + a * len, 1, 0, len), nr_reduced);
+            }
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, div_ceil(A, per_task), run);
+    } else {
+        size_t nr_outer = target_shape ? 1 : A,
+               nr_block = div_ceil(nr_col, COL_BLOCK);
+        auto run = [=](size_t index, size_t) {
+            size_t a = index / nr_block, col = index % nr_block * COL_BLOCK;
+            reduce_cols<mode>(
+                    sptr + a * nr_row * nr_col + col, dptr + a * nr_col + col, nr_row,
+                    nr_col, std::min(COL_BLOCK, nr_col - col), nr_reduced);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_outer * nr_block, run);
+    }
+}
+
+}  // anonymous namespace
+
+bool ReduceImpl::is_avx2_usable(const TensorLayout& src) const {
+    auto mode = param().mode;
+    bool mode_ok = mode == Mode::SUM || mode == Mode::MEAN || mode == Mode::SUM_SQR ||
+                   mode == Mode::MAX || mode == Mode::MIN;
+    bool dtype_ok = src.dtype == dtype::Float32() &&
+                    (param().data_type == DataType::DEFAULT ||
+                     param().data_type == DataType::FLOAT_O32xC32);
+    return mode_ok && dtype_ok && is_supported(SIMDType::AVX2);
+}
+
+void ReduceImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+    if (!is_avx2_usable(src.layout)) {
+        return fallback::ReduceImpl::exec(src, dst, workspace);
+    }
+    size_t A, B, C;
+    bool target_shape = param().axis == TARGET_SHAPE_AXIS;
+    if (!target_shape) {
+        reduce::get_ABC(src.layout, A, B, C, param().axis);
+    } else if (!reduce::get_target_shape_ABC(src.layout, dst.layout, A, B, C)) {
+        return fallback::ReduceImpl::exec(src, dst, workspace);
+    }
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    auto sptr = src.ptr<dt_float32>();
+    auto dptr = dst.ptr<dt_float32>();
+    switch (param().mode) {
+#define cb(_mode, _idx)                                                      \
+    case _mode:                                                              \
+        MIDOUT_BEGIN(megdnn_x86_reduce, midout_iv(_idx)) {                   \
+            dispatch_kern<_mode>(handle, sptr, dptr, A, B, C, target_shape); \
+        }                                                                    \
+        MIDOUT_END();                                                        \
+        return;
+        cb(Mode::SUM, 0);
+        cb(Mode::MEAN, 1);
+        cb(Mode::SUM_SQR, 2);
+        cb(Mode::MAX, 3);
+        cb(Mode::MIN, 4);
+#undef cb
+        default:
+            megdnn_assert_internal(false);
+    }
+}
+
+// vim: syntax=cpp.doxygen
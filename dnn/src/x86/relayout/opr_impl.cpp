@@ -0,0 +1,155 @@
+/**
+ * \file dnn/src/x86/relayout/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/common/relayout_helper.h"
+#include "src/common/utils.h"
+
+#include "src/x86/handle.h"
+#include "src/x86/relayout/opr_impl.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+
+using namespace megdnn;
+using namespace relayout;
+
+namespace {
+
+//! 4-byte element types whose 16x16 block is transposed in registers
+struct TransposeWordSSE {
+    uint32_t v;
+};
+struct TransposeWordAVX {
+    uint32_t v;
+};
+
+void trans_16x16_u32_sse(
+        const float* src, float* dst, const size_t src_stride,
+        const size_t dst_stride) {
+    for (size_t i = 0; i < 16; i += 4) {
+        for (size_t j = 0; j < 16; j += 4) {
+            auto sptr = src + i * src_stride + j;
+            __m128 r0 = _mm_loadu_ps(sptr), r1 = _mm_loadu_ps(sptr + src_stride),
+                   r2 = _mm_loadu_ps(sptr + 2 * src_stride),
+                   r3 = _mm_loadu_ps(sptr + 3 * src_stride);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            auto dptr = dst + j * dst_stride + i;
+            _mm_storeu_ps(dptr, r0);
+            _mm_storeu_ps(dptr + dst_stride, r1);
+            _mm_storeu_ps(dptr + 2 * dst_stride, r2);
+            _mm_storeu_ps(dptr + 3 * dst_stride, r3);
+        }
+    }
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx")
+void trans_16x16_u32_avx(
+        const float* src, float* dst, const size_t src_stride,
+        const size_t dst_stride) {
+    for (size_t i = 0; i < 16; i += 8) {
+        for (size_t j = 0; j < 16; j += 8) {
+            auto sptr = src + i * src_stride + j;
+            __m256 r[8], t[8];
+            for (size_t k = 0; k < 8; ++k) {
+                r[k] = _mm256_loadu_ps(sptr + k * src_stride);
+            }
+            for (size_t k = 0; k < 8; k += 2) {
+                t[k] = _mm256_unpacklo_ps(r[k], r[k + 1]);
+                t[k + 1] = _mm256_unpackhi_ps(r[k], r[k + 1]);
+            }
+            for (size_t k = 0; k < 8; k += 4) {
+                r[k] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+                r[k + 1] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+                r[k + 2] =
+                        _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+                r[k + 3] =
+                        _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+            }
+            auto dptr = dst + j * dst_stride + i;
+            for (size_t k = 0; k < 4; ++k) {
+                _mm256_storeu_ps(
+                        dptr + k * dst_stride,
+                        _mm256_permute2f128_ps(r[k], r[k + 4], 0x20));
+                _mm256_storeu_ps(
+                        dptr + (k + 4) * dst_stride,
+                        _mm256_permute2f128_ps(r[k], r[k + 4], 0x31));
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace relayout {
+namespace transpose_fallback {
+template <>
+struct transpose_traits<TransposeWordSSE> {
+    static constexpr size_t block_size = 16;
+};
+
+template <>
+void transpose_block<TransposeWordSSE>(
+        const TransposeWordSSE* src, TransposeWordSSE* dst, const size_t src_stride,
+        const size_t dst_stride) {
+    trans_16x16_u32_sse(
+            reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst),
+            src_stride, dst_stride);
+}
+
+template <>
+struct transpose_traits<TransposeWordAVX> {
+    static constexpr size_t block_size = 16;
+};
+
+template <>
+void transpose_block<TransposeWordAVX>(
+        const TransposeWordAVX* src, TransposeWordAVX* dst, const size_t src_stride,
+        const size_t dst_stride) {
+    trans_16x16_u32_avx(
+            reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst),
+            src_stride, dst_stride);
+}
+
+}  // namespace transpose_fallback
+}  // namespace relayout
+}  // namespace megdnn
+
+void x86::RelayoutForwardImpl::exec(
+        _megdnn_tensor_in src0, _megdnn_tensor_out dst0, Handle* src_handle) {
+    check_cpu_handle(src_handle);
+    TensorND src = src0, dst = dst0;
+    check_layout_and_canonize(src.layout, dst.layout);
+
+    // FIXME: optimize for lowbit cases
+    if (src.layout.dtype.enumv() == DTypeEnum::QuantizedS4 ||
+        src.layout.dtype.enumv() == DTypeEnum::Quantized4Asymm) {
+        fallback::RelayoutForwardImpl::exec(src0, dst0, src_handle);
+        return;
+    }
+
+    relayout::TransposeParam trans_param;
+    bool trans = relayout::is_transpose(src.layout, dst.layout, trans_param);
+    auto addr = reinterpret_cast<uintptr_t>(src.raw_ptr) |
+                reinterpret_cast<uintptr_t>(dst.raw_ptr);
+    if (trans && trans_param.c == 1 && src0.layout.dtype.size() == 4 &&
+        !(addr & (alignof(uint32_t) - 1))) {
+        if (is_supported(SIMDType::AVX)) {
+            dispatch_transpose<TransposeWordAVX>(trans_param, src.raw_ptr, dst.raw_ptr);
+        } else {
+            dispatch_transpose<TransposeWordSSE>(trans_param, src.raw_ptr, dst.raw_ptr);
+        }
+        return;
+    }
+    exec_after_preprocess(src, dst, trans ? &trans_param : nullptr);
+}
+
+// vim: syntax=cpp.doxygen
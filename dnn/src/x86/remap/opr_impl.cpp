@@ -0,0 +1,146 @@
+/**
+ * \file dnn/src/x86/remap/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/remap/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+#include "src/naive/remap/remap_linear.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#include <climits>
+
+#include "midout.h"
+MIDOUT_DECL(megdnn_x86_remap)
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+using BorderMode = param::Remap::BorderMode;
+constexpr auto NCHW = param::Remap::Format::NCHW;
+
+/*!
+ * \brief compute row \p h of the bilinear remap of a float32 NCHW image
+ *
+ * Blocks of 8 output pixels whose sources all lie inside the image are computed
+ * by gathering the four neighbours in every channel, and the others by
+ * remap::remap_linear_pixel().
+ */
+template <BorderMode bmode>
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void remap_row_nchw_f32(
+        const float* src, const float* map_xy, float* dst, int C, int IH, int IW,
+        int OH, int OW, int h, float scalar) {
+    const float* map_row = map_xy + h * OW * 2;
+    __m256 one = _mm256_set1_ps(1.f);
+    __m256i vmax_w = _mm256_set1_epi32(IW - 1), vmax_h = _mm256_set1_epi32(IH - 1),
+            vneg = _mm256_set1_epi32(-1), viw = _mm256_set1_epi32(IW);
+    int w = 0;
+    for (; w + 8 <= OW; w += 8) {
+        //! (x0, y0, ..., x3, y3) and (x4, y4, ..., x7, y7)
+        __m256 xy0 = _mm256_loadu_ps(map_row + w * 2),
+               xy1 = _mm256_loadu_ps(map_row + w * 2 + 8);
+        //! (x0, x1, x4, x5, x2, x3, x6, x7), then reorder the 64-bit pairs
+        __m256 x = _mm256_shuffle_ps(xy0, xy1, _MM_SHUFFLE(2, 0, 2, 0)),
+               y = _mm256_shuffle_ps(xy0, xy1, _MM_SHUFFLE(3, 1, 3, 1));
+        x = _mm256_castpd_ps(
+                _mm256_permute4x64_pd(_mm256_castps_pd(x), _MM_SHUFFLE(3, 1, 2, 0)));
+        y = _mm256_castpd_ps(
+                _mm256_permute4x64_pd(_mm256_castps_pd(y), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 floorx = _mm256_floor_ps(x), floory = _mm256_floor_ps(y);
+        //! nan and values out of the range of int32 are converted to INT_MIN
+        __m256i col = _mm256_cvttps_epi32(floorx), row = _mm256_cvttps_epi32(floory);
+        __m256i inside_w = _mm256_and_si256(
+                _mm256_cmpgt_epi32(col, vneg), _mm256_cmpgt_epi32(vmax_w, col));
+        __m256i inside_h = _mm256_and_si256(
+                _mm256_cmpgt_epi32(row, vneg), _mm256_cmpgt_epi32(vmax_h, row));
+        if (_mm256_movemask_epi8(_mm256_and_si256(inside_w, inside_h)) != -1) {
+            for (int i = 0; i < 8; ++i) {
+                remap::remap_linear_pixel<float, NCHW, bmode>(
+                        src, map_xy, dst, C, IH, IW, OH, OW, h, w + i, scalar);
+            }
+            continue;
+        }
+        __m256 v = _mm256_sub_ps(x, floorx), u = _mm256_sub_ps(y, floory);
+        __m256 rv = _mm256_sub_ps(one, v), ru = _mm256_sub_ps(one, u);
+        __m256 w00 = _mm256_mul_ps(rv, ru), w01 = _mm256_mul_ps(ru, v),
+               w10 = _mm256_mul_ps(rv, u), w11 = _mm256_mul_ps(u, v);
+        __m256i idx = _mm256_add_epi32(_mm256_mullo_epi32(row, viw), col);
+        for (int c = 0; c < C; ++c) {
+            const float* p0 = src + c * IH * IW;
+            const float* p1 = p0 + IW;
+            __m256 val = _mm256_mul_ps(_mm256_i32gather_ps(p0, idx, 4), w00);
+            val = _mm256_add_ps(
+                    val, _mm256_mul_ps(_mm256_i32gather_ps(p0 + 1, idx, 4), w01));
+            val = _mm256_add_ps(
+                    val, _mm256_mul_ps(_mm256_i32gather_ps(p1, idx, 4), w10));
+            val = _mm256_add_ps(
+                    val, _mm256_mul_ps(_mm256_i32gather_ps(p1 + 1, idx, 4), w11));
+            _mm256_storeu_ps(dst + (c * OH + h) * OW + w, val);
+        }
+    }
+    for (; w < OW; ++w) {
+        remap::remap_linear_pixel<float, NCHW, bmode>(
+                src, map_xy, dst, C, IH, IW, OH, OW, h, w, scalar);
+    }
+}
+
+}  // anonymous namespace
+
+void RemapImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in map_xy, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, map_xy.layout, dst.layout, workspace.size);
+    if (param().format != param::Remap::Format::NCHW ||
+        param().imode != param::Remap::InterpolationMode::LINEAR ||
+        src.layout.dtype != dtype::Float32() ||
+        src.layout.total_nr_elems() > static_cast<size_t>(INT_MAX) ||
+        !is_supported(SIMDType::AVX2)) {
+        return fallback::RemapImpl::exec(src, map_xy, dst, workspace);
+    }
+    int N = src.layout.shape[0], C = src.layout.shape[1], IH = src.layout.shape[2],
+        IW = src.layout.shape[3], OH = map_xy.layout.shape[1],
+        OW = map_xy.layout.shape[2];
+    float scalar = param().scalar;
+    auto sptr = src.ptr<dt_float32>();
+    auto mptr = map_xy.ptr<dt_float32>();
+    auto dptr = dst.ptr<dt_float32>();
+    switch (param().border_type) {
+#define cb(_bmode, _idx)                                                   \
+    case BorderMode::_bmode: {                                             \
+        auto run = [=](size_t index, size_t) {                             \
+            int n = index / OH, h = index % OH;                            \
+            remap_row_nchw_f32<BorderMode::_bmode>(                        \
+                    sptr + n * C * IH * IW, mptr + n * OH * OW * 2,        \
+                    dptr + n * C * OH * OW, C, IH, IW, OH, OW, h, scalar); \
+        };                                                                 \
+        MIDOUT_BEGIN(megdnn_x86_remap, midout_iv(_idx)) {                  \
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, N* OH);         \
+        }                                                                  \
+        MIDOUT_END();                                                      \
+        return;                                                            \
+    }
+        cb(CONSTANT, 0);
+        cb(REPLICATE, 1);
+        cb(REFLECT, 2);
+        cb(REFLECT_101, 3);
+        cb(WRAP, 4);
+#undef cb
+        default:
+            break;
+    }
+    fallback::RemapImpl::exec(src, map_xy, dst, workspace);
+}
+
+// vim: syntax=cpp.doxygen
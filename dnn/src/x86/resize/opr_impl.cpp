@@ -26,12 +26,99 @@
 #include "src/x86/resize/resize_cv.h"
 #include "src/x86/utils.h"
 
+#include <immintrin.h>
+#include <climits>
+#include <vector>
+
 using namespace megdnn;
 using namespace x86;
 
+namespace {
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 weighted_gather(const float* row, __m256i idx, __m256 ah, __m256 aw) {
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_i32gather_ps(row, idx, 4), ah), aw);
+}
+
+/*!
+ * \brief compute a row of the bilinear resize from the two source rows
+ *
+ * \param iw0, iw1 offsets of the two source pixels of each output column
+ * \param aw0, aw1 weights of the two source pixels of each output column
+ */
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void resize_row_f32(
+        const float* row0, const float* row1, float ah0, float ah1, const int* iw0,
+        const int* iw1, const float* aw0, const float* aw1, float* dst, size_t OW) {
+    __m256 vah0 = _mm256_set1_ps(ah0), vah1 = _mm256_set1_ps(ah1);
+    size_t ow = 0;
+    for (; ow + 8 <= OW; ow += 8) {
+        __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(iw0 + ow));
+        __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(iw1 + ow));
+        __m256 w0 = _mm256_loadu_ps(aw0 + ow), w1 = _mm256_loadu_ps(aw1 + ow);
+        __m256 val = weighted_gather(row0, i0, vah0, w0);
+        val = _mm256_add_ps(val, weighted_gather(row0, i1, vah0, w1));
+        val = _mm256_add_ps(val, weighted_gather(row1, i0, vah1, w0));
+        val = _mm256_add_ps(val, weighted_gather(row1, i1, vah1, w1));
+        _mm256_storeu_ps(dst + ow, val);
+    }
+    for (; ow < OW; ++ow) {
+        dst[ow] = row0[iw0[ow]] * ah0 * aw0[ow] + row0[iw1[ow]] * ah0 * aw1[ow] +
+                  row1[iw0[ow]] * ah1 * aw0[ow] + row1[iw1[ow]] * ah1 * aw1[ow];
+    }
+}
+
+}  // anonymous namespace
+
+void ResizeImpl::exec_nchw_f32_avx2(_megdnn_tensor_in src, _megdnn_tensor_out dst) {
+    using ctype = float;
+    auto kern_param =
+            KernParam<ctype>::from_tensors(param().format, param().imode, src, dst, {});
+    UNPACK_RESIZE_FWD_KERN_PARAM_WITH_STRIDE(kern_param);
+    //! source offsets and weights of the output rows or columns, the same as
+    //! those of fallback::ResizeImpl
+    auto build_table = [this](
+                               float scale, int isize, int osize, ptrdiff_t stride,
+                               std::vector<int>& idx0, std::vector<int>& idx1,
+                               std::vector<float>& alpha0,
+                               std::vector<float>& alpha1) {
+        rep(i, osize) {
+            float a0, a1;
+            int i0, i1;
+            std::tie(a0, i0, a1, i1) = get_nearest_linear_coord(
+                    InterpolationMode::LINEAR, scale, isize, i);
+            idx0.push_back(i0 * stride);
+            idx1.push_back(i1 * stride);
+            alpha0.push_back(a0);
+            alpha1.push_back(a1);
+        }
+    };
+    std::vector<int> ih0, ih1, iw0, iw1;
+    std::vector<float> ah0, ah1, aw0, aw1;
+    build_table(static_cast<float>(OH) / IH, IH, OH, S_IH, ih0, ih1, ah0, ah1);
+    build_table(static_cast<float>(OW) / IW, IW, OW, S_IW, iw0, iw1, aw0, aw1);
+    auto run = [=](size_t index, size_t) {
+        ptrdiff_t n = index / (C * OH), c = index / OH % C;
+        size_t oh = index % OH;
+        const float* plane = sptr + n * S_IN + c * S_IC;
+        resize_row_f32(
+                plane + ih0[oh], plane + ih1[oh], ah0[oh], ah1[oh], iw0.data(),
+                iw1.data(), aw0.data(), aw1.data(), dptr + index * OW, OW);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, N * C * OH);
+}
+
 void ResizeImpl::exec(
         _megdnn_tensor_in src, _megdnn_tensor_in dst, _megdnn_workspace workspace) {
     check_exec(src.layout, dst.layout, workspace.size);
+    if (param().format == param::Resize::Format::NCHW &&
+        param().imode == param::Resize::InterpolationMode::LINEAR &&
+        src.layout.dtype == dtype::Float32() && dst.layout.is_contiguous() &&
+        src.layout.span().dist_elem() <= static_cast<size_t>(INT_MAX) &&
+        is_supported(SIMDType::AVX2)) {
+        exec_nchw_f32_avx2(src, dst);
+        return;
+    }
     if (param().format == param::Resize::Format::NCHW ||
         (src.layout[3] != 1 && src.layout[3] != 3) || !is_supported(SIMDType::SSE4_2) ||
         !is_nhwc_contig_wc(src.layout)) {
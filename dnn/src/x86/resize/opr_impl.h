@@ -26,6 +26,10 @@ public:
     size_t get_workspace_in_bytes(const TensorLayout&, const TensorLayout&) override {
         return 0;
     }
+
+private:
+    //! bilinear resize of NCHW float32 images, split over the output rows
+    void exec_nchw_f32_avx2(_megdnn_tensor_in src, _megdnn_tensor_out dst);
 };
 
 }  // namespace x86
@@ -0,0 +1,88 @@
+/**
+ * \file dnn/src/x86/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/softmax/opr_impl.h"
+#include "src/x86/elemwise/avx_util/avx_mathfun.h"
+#include "src/x86/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline float reduce_max(__m256 v) {
+    __m128 x = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_max_ss(x, _mm_shuffle_ps(x, x, 1));
+    return _mm_cvtss_f32(x);
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline float reduce_sum(__m256 v) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+    return _mm_cvtss_f32(x);
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void softmax_rows_avx2(const float* src, float* dst, size_t nr_row, size_t len) {
+    for (size_t r = 0; r < nr_row; ++r, src += len, dst += len) {
+        size_t i = 0;
+        __m256 vmax = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+        for (; i + 8 <= len; i += 8) {
+            vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(src + i));
+        }
+        float max_val = reduce_max(vmax);
+        for (; i < len; ++i) {
+            max_val = std::max(max_val, src[i]);
+        }
+
+        __m256 vsum = _mm256_setzero_ps();
+        vmax = _mm256_set1_ps(max_val);
+        for (i = 0; i + 8 <= len; i += 8) {
+            __m256 v = x86::detail::exp256_ps(
+                    _mm256_sub_ps(_mm256_loadu_ps(src + i), vmax));
+            _mm256_storeu_ps(dst + i, v);
+            vsum = _mm256_add_ps(vsum, v);
+        }
+        float sum = reduce_sum(vsum);
+        for (; i < len; ++i) {
+            dst[i] = std::exp(src[i] - max_val);
+            sum += dst[i];
+        }
+
+        float scale = 1.f / sum;
+        __m256 vscale = _mm256_set1_ps(scale);
+        for (i = 0; i + 8 <= len; i += 8) {
+            _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), vscale));
+        }
+        for (; i < len; ++i) {
+            dst[i] *= scale;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+SoftmaxForwardImpl::RowKern SoftmaxForwardImpl::get_row_kern() const {
+    if (is_supported(SIMDType::AVX2)) {
+        return softmax_rows_avx2;
+    }
+    return fallback::SoftmaxForwardImpl::get_row_kern();
+}
+
+// vim: syntax=cpp.doxygen
@@ -22,6 +22,11 @@
 #include <pmmintrin.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace megdnn;
 using namespace x86;
 
@@ -127,6 +132,72 @@ bool feature_detect_vnni() {
     return (eax & 6) == 6;
 }
 
+bool feature_detect_avx512() {
+    uint32_t eax, ebx, ecx, edx;
+
+    // check cpu support
+#if defined(_WIN32)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 7);
+    eax = cpuInfo[0];
+    ebx = cpuInfo[1];
+    ecx = cpuInfo[2];
+    edx = cpuInfo[3];
+#else
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(7), "c"(0)
+                 : "cc");
+#endif
+    // avx512f  ---> 16 ebx
+    // avx512bw ---> 30 ebx
+    if (!(bit(ebx, 16) && bit(ebx, 30)))
+        return false;
+
+    // check os support of xmm, ymm, opmask and zmm states
+    asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return (eax & 0xe6) == 0xe6;
+}
+
+bool feature_detect_amx(int ftr) {
+    uint32_t eax, ebx, ecx, edx;
+
+    // check cpu support
+#if defined(_WIN32)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 7);
+    eax = cpuInfo[0];
+    ebx = cpuInfo[1];
+    ecx = cpuInfo[2];
+    edx = cpuInfo[3];
+#else
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(7), "c"(0)
+                 : "cc");
+#endif
+    // amx-bf16 ---> 22 edx
+    // amx-tile ---> 24 edx
+    // amx-int8 ---> 25 edx
+    if (!(bit(edx, 24) && bit(edx, ftr)))
+        return false;
+
+    // check os support of tilecfg and tiledata states
+    asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    if ((eax & 0x60000) != 0x60000)
+        return false;
+
+#if defined(__linux__)
+    // linux only allows a process to use the tile data after asking for the
+    // permission, see Documentation/x86/xstate.rst
+    constexpr int ARCH_REQ_XCOMP_PERM = 0x1023, XFEATURE_XTILEDATA = 18;
+    return syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) == 0;
+#else
+    return true;
+#endif
+}
+
 bool feature_detect_avx_fma(int ftr) {
     // see Detecting Availability and Support in
     // https://software.intel.com/en-us/articles/introduction-to-intel-advanced-vector-extensions
@@ -145,7 +216,10 @@ bool feature_detect_avx_fma(int ftr) {
 bool is_avx_supported = feature_detect_avx_fma(28);
 bool is_fma_supported = feature_detect_avx_fma(12);
 bool is_avx2_supported = feature_detect_avx2();
+bool is_avx512_supported = feature_detect_avx512();
 bool is_vnni_supported = feature_detect_vnni();
+bool is_amx_int8_supported = feature_detect_amx(25);
+bool is_amx_bf16_supported = feature_detect_amx(22);
 
 SIMDType disabled_simd_type_thresh = SIMDType::__NR_SIMD_TYPE;
 
@@ -177,8 +251,14 @@ bool x86::is_supported(SIMDType type) {
             return is_fma_supported;
         case SIMDType::AVX2:
             return is_avx2_supported;
+        case SIMDType::AVX512:
+            return is_avx512_supported;
         case SIMDType::VNNI:
             return is_vnni_supported;
+        case SIMDType::AMX_INT8:
+            return is_amx_int8_supported;
+        case SIMDType::AMX_BF16:
+            return is_amx_bf16_supported;
         default:
             break;
     }
@@ -37,7 +37,10 @@ enum class SIMDType {
     AVX,
     AVX2,
     FMA,
+    AVX512,  //! avx512f and avx512bw
     VNNI,
+    AMX_INT8,  //! amx-tile and amx-int8, and the os allows to use them
+    AMX_BF16,  //! amx-tile and amx-bf16, and the os allows to use them
     NONE,
     __NR_SIMD_TYPE  //! total number of SIMD types; used for testing
 };
@@ -17,9 +17,156 @@
 #include "src/common/warp_common.h"
 #include "src/naive/handle.h"
 
+#include <immintrin.h>
+#include <climits>
+#include <cmath>
+
+#include "midout.h"
+MIDOUT_DECL(megdnn_x86_warpperspective)
+
+namespace {
+
+//! m[0] * x + m[1] * y + m[2]
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 affine(const __m256* m, __m256 x, __m256 y) {
+    return _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(m[0], x), _mm256_mul_ps(m[1], y)), m[2]);
+}
+
+/*!
+ * \brief compute row \p oh of the bilinear warp of a float32 NCHW image
+ *
+ * Blocks of 8 output pixels whose sources all lie inside the image are computed
+ * by gathering the four neighbours in every channel. The other pixels are
+ * computed in the same way as the naive kernel, where \p real_coord maps the
+ * coordinates out of the image according to the border mode.
+ */
+template <typename RealCoord>
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void warp_row_nchw_f32(
+        const float* src, const float* mat, float* dst, size_t C, size_t IH,
+        size_t IW, size_t OH, size_t OW, size_t oh, bool border_constant,
+        float border_val, RealCoord real_coord) {
+    auto scalar_pixel = [&](size_t ow) {
+        float numeratorw = mat[0] * ow + mat[1] * oh + mat[2];
+        float numeratorh = mat[3] * ow + mat[4] * oh + mat[5];
+        float denominator = mat[6] * ow + mat[7] * oh + mat[8];
+        float alphaw = numeratorw / denominator;
+        float alphah = numeratorh / denominator;
+        int iw0 = real_coord(std::floor(alphaw) + 0, IW);
+        int iw1 = real_coord(std::floor(alphaw) + 1, IW);
+        int ih0 = real_coord(std::floor(alphah) + 0, IH);
+        int ih1 = real_coord(std::floor(alphah) + 1, IH);
+        alphaw -= std::floor(alphaw);
+        alphah -= std::floor(alphah);
+        for (size_t c = 0; c < C; ++c) {
+            const float* plane = src + c * IH * IW;
+            auto visit = [&](int h, int w) {
+                return h != -1 && w != -1 ? plane[h * IW + w] : border_val;
+            };
+            float val = visit(ih0, iw0) * (1.0f - alphaw) * (1.0f - alphah) +
+                        visit(ih0, iw1) * alphaw * (1.0f - alphah) +
+                        visit(ih1, iw0) * (1.0f - alphaw) * alphah +
+                        visit(ih1, iw1) * alphaw * alphah;
+            if (border_constant && !std::isfinite(val)) {
+                val = border_val;
+            }
+            dst[(c * OH + oh) * OW + ow] = val;
+        }
+    };
+
+    __m256 vm[9];
+    for (int i = 0; i < 9; ++i) {
+        vm[i] = _mm256_set1_ps(mat[i]);
+    }
+    __m256 voh = _mm256_set1_ps(oh), one = _mm256_set1_ps(1.f),
+           vbval = _mm256_set1_ps(border_val), zero = _mm256_setzero_ps();
+    __m256i vmax_w = _mm256_set1_epi32(IW - 1), vmax_h = _mm256_set1_epi32(IH - 1),
+            vneg = _mm256_set1_epi32(-1), viw = _mm256_set1_epi32(IW);
+    size_t ow = 0;
+    for (; ow + 8 <= OW; ow += 8) {
+        __m256 vow = _mm256_add_ps(
+                _mm256_set1_ps(ow), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 denominator = affine(vm + 6, vow, voh);
+        __m256 alphaw = _mm256_div_ps(affine(vm, vow, voh), denominator);
+        __m256 alphah = _mm256_div_ps(affine(vm + 3, vow, voh), denominator);
+        __m256 floorw = _mm256_floor_ps(alphaw), floorh = _mm256_floor_ps(alphah);
+        //! nan and values out of the range of int32 are converted to INT_MIN
+        __m256i iw0 = _mm256_cvttps_epi32(floorw), ih0 = _mm256_cvttps_epi32(floorh);
+        __m256i inside_w = _mm256_and_si256(
+                _mm256_cmpgt_epi32(iw0, vneg), _mm256_cmpgt_epi32(vmax_w, iw0));
+        __m256i inside_h = _mm256_and_si256(
+                _mm256_cmpgt_epi32(ih0, vneg), _mm256_cmpgt_epi32(vmax_h, ih0));
+        __m256i inside = _mm256_and_si256(inside_w, inside_h);
+        if (_mm256_movemask_epi8(inside) != -1) {
+            for (size_t i = 0; i < 8; ++i) {
+                scalar_pixel(ow + i);
+            }
+            continue;
+        }
+        alphaw = _mm256_sub_ps(alphaw, floorw);
+        alphah = _mm256_sub_ps(alphah, floorh);
+        __m256 rw = _mm256_sub_ps(one, alphaw), rh = _mm256_sub_ps(one, alphah);
+        __m256 w00 = _mm256_mul_ps(rw, rh), w01 = _mm256_mul_ps(alphaw, rh),
+               w10 = _mm256_mul_ps(rw, alphah), w11 = _mm256_mul_ps(alphaw, alphah);
+        __m256i idx = _mm256_add_epi32(_mm256_mullo_epi32(ih0, viw), iw0);
+        for (size_t c = 0; c < C; ++c) {
+            const float* p0 = src + c * IH * IW;
+            const float* p1 = p0 + IW;
+            __m256 val = _mm256_add_ps(
+                    _mm256_add_ps(
+                            _mm256_mul_ps(_mm256_i32gather_ps(p0, idx, 4), w00),
+                            _mm256_mul_ps(_mm256_i32gather_ps(p0 + 1, idx, 4), w01)),
+                    _mm256_add_ps(
+                            _mm256_mul_ps(_mm256_i32gather_ps(p1, idx, 4), w10),
+                            _mm256_mul_ps(_mm256_i32gather_ps(p1 + 1, idx, 4), w11)));
+            if (border_constant) {
+                //! x - x is zero iff x is finite
+                __m256 finite =
+                        _mm256_cmp_ps(_mm256_sub_ps(val, val), zero, _CMP_EQ_OQ);
+                val = _mm256_blendv_ps(vbval, val, finite);
+            }
+            _mm256_storeu_ps(dst + (c * OH + oh) * OW + ow, val);
+        }
+    }
+    for (; ow < OW; ++ow) {
+        scalar_pixel(ow);
+    }
+}
+
+}  // anonymous namespace
+
 namespace megdnn {
 namespace x86 {
 
+void WarpPerspectiveImpl::exec_nchw_f32_avx2(
+        _megdnn_tensor_in src, _megdnn_tensor_in mat, _megdnn_tensor_in mat_idx,
+        _megdnn_tensor_out dst) {
+    size_t N_SRC = src.layout[0], C = src.layout[1], IH = src.layout[2],
+           IW = src.layout[3], N_MAT = mat.layout[0], OH = dst.layout[2],
+           OW = dst.layout[3];
+    const float* sptr = src.ptr<dt_float32>();
+    const float* mptr = mat.ptr<dt_float32>();
+    float* dptr = dst.ptr<dt_float32>();
+    const int* midx_ptr = mat_idx.raw_ptr ? mat_idx.ptr<dt_int32>() : nullptr;
+    bool border_constant = param().bmode == BorderMode::CONSTANT;
+    float border_val = param().border_val;
+    auto real_coord = [this](int p, int len) { return get_real_coord(p, len); };
+    auto run = [=](size_t index, size_t) {
+        size_t n = index / OH, oh = index % OH, idx = n;
+        if (midx_ptr) {
+            idx = midx_ptr[n];
+            megdnn_assert(
+                    idx < N_SRC, "mat_idx out of bound: mat_idx[%zu]=%zu src_batch=%zu",
+                    n, idx, N_SRC);
+        }
+        warp_row_nchw_f32(
+                sptr + idx * C * IH * IW, mptr + n * 3 * 3, dptr + n * C * OH * OW, C,
+                IH, IW, OH, OW, oh, border_constant, border_val, real_coord);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, N_MAT * OH);
+}
+
 void WarpPerspectiveImpl::exec(
         _megdnn_tensor_in src, _megdnn_tensor_in mat, _megdnn_tensor_in mat_idx,
         _megdnn_tensor_in dst, _megdnn_workspace workspace) {
@@ -31,6 +178,17 @@ void WarpPerspectiveImpl::exec(
         warp_perspective_cv_exec(
                 src, mat, mat_idx, dst, param().border_val, param().bmode,
                 param().imode, handle());
+    } else if (
+            param().format == Format::NCHW &&
+            param().imode == InterpolationMode::LINEAR &&
+            src.layout.dtype == dtype::Float32() &&
+            mat.layout.dtype == dtype::Float32() &&
+            src.layout[2] * src.layout[3] <= static_cast<size_t>(INT_MAX) &&
+            is_supported(SIMDType::AVX2)) {
+        MIDOUT_BEGIN(megdnn_x86_warpperspective, midout_iv(0)) {
+            exec_nchw_f32_avx2(src, mat, mat_idx, dst);
+        }
+        MIDOUT_END();
     } else {
         //! Use fallback implementation
         fallback::WarpPerspectiveImpl::exec(src, mat, mat_idx, dst, workspace);
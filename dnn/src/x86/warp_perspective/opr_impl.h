@@ -22,6 +22,12 @@ public:
     void exec(
             _megdnn_tensor_in src, _megdnn_tensor_in mat, _megdnn_tensor_in mat_idx,
             _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+
+private:
+    //! bilinear warp of NCHW float32 images, split over the output rows
+    void exec_nchw_f32_avx2(
+            _megdnn_tensor_in src, _megdnn_tensor_in mat, _megdnn_tensor_in mat_idx,
+            _megdnn_tensor_out dst);
 };
 
 }  // namespace x86
@@ -17,6 +17,8 @@
 #include "test/common/matrix_mul.h"
 #include "test/common/rng.h"
 
+#include "src/aarch64/sve/sve_helper.h"
+#include "src/common/cpuinfo_arch_vendor.h"
 #include "test/arm_common/cpuinfo_help.h"
 using namespace megdnn;
 using namespace test;
@@ -155,6 +157,64 @@ TEST_F(AARCH64, MATRIX_MUL_INT8x8x32_K8x8x8) {
 }
 #endif
 
+#if MGB_ENABLE_I8MM
+TEST_F(AARCH64, MATRIX_MUL_INT8X8X32_K8X12X8_I8MM) {
+    if (!arm_has_i8mm()) {
+        return;
+    }
+    matrix_mul::check_matrix_mul(
+            dtype::Int8{}, dtype::Int8{}, dtype::Int32{}, handle(),
+            "AARCH64_INT8X8X32_K8X12X8_I8MM");
+}
+
+TEST_F(AARCH64, MATRIX_MUL_INT8X8X32_MK4_8X12X8_I8MM) {
+    if (!arm_has_i8mm()) {
+        return;
+    }
+    std::vector<matrix_mul::TestArg> args;
+    for (size_t m : {1, 2, 3, 4, 5, 6, 7, 10, 11})
+        for (size_t n : {2, 3, 4, 5, 8, 12, 13, 14, 15, 16, 31})
+            for (size_t k : {1, 2, 3, 4, 5, 6, 7, 8, 16, 32, 33, 34})
+                args.emplace_back(m, n, k, 0);
+    matrix_mul::check_matrix_mul(
+            dtype::Int8{}, dtype::Int8{}, dtype::Int32{}, handle(),
+            "AARCH64_INT8X8X32_MK4_8X12X8_I8MM", param::MatrixMul::Format::MK4_DOT,
+            1, 1e-3, std::move(args));
+}
+
+#if !MEGDNN_DISABLE_FLOAT16
+TEST_F(AARCH64, MATRIX_MUL_BF16_K8X12X4) {
+    if (!arm_has_bf16()) {
+        return;
+    }
+    //! the reference also accumulates in float32, and the result is rounded to
+    //! bf16 once
+    matrix_mul::check_matrix_mul(
+            dtype::BFloat16{}, dtype::BFloat16{}, dtype::BFloat16{}, handle(),
+            "AARCH64_BF16_K8X12X4", param::MatrixMul::Format::DEFAULT, 1, 5e-2, {},
+            true, param::MatrixMul::ComputeMode::FLOAT32);
+}
+#endif
+#endif
+
+#if MGB_ENABLE_SVE
+TEST_F(AARCH64, MATRIX_MUL_F32_SVE_8XVL) {
+    if (!aarch64::sve::preferred()) {
+        return;
+    }
+    std::vector<matrix_mul::TestArg> args;
+    //! K larger than the block of 256 is accumulated into C
+    for (size_t m : {1, 7, 8, 9, 17})
+        for (size_t n : {1, 15, 16, 33, 64, 130})
+            for (size_t k : {1, 3, 256, 300})
+                args.emplace_back(m, n, k, 0);
+    matrix_mul::check_matrix_mul(
+            dtype::Float32{}, dtype::Float32{}, dtype::Float32{}, handle(),
+            "AARCH64_F32_SVE_8XVL", param::MatrixMul::Format::DEFAULT, 1, 1e-3,
+            std::move(args));
+}
+#endif
+
 TEST_F(AARCH64, MATRIX_MUL_INT8x8x16_K8x8x8) {
     matrix_mul::check_matrix_mul(
             dtype::Int8{}, dtype::Int8{}, dtype::Int16{}, handle(),
@@ -15,6 +15,8 @@
 #include "test/common/pooling.h"
 #include "test/common/rng.h"
 
+#include "src/aarch64/sve/sve_helper.h"
+
 namespace megdnn {
 namespace test {
 
@@ -67,6 +69,37 @@ TEST_F(ARM_COMMON, POOLING) {
     // clang-format on
 }
 
+#if MEGDNN_AARCH64 && MGB_ENABLE_SVE
+TEST_F(ARM_COMMON, POOLING_FP32_SVE) {
+    if (!aarch64::sve::preferred()) {
+        return;
+    }
+    using Param = param::Pooling;
+    Checker<Pooling> checker(handle());
+    checker.set_before_exec_callback(
+            AlgoChecker<PoolingForward>("ARM_POOLING_FP32_SVE"));
+    // clang-format off
+    for (auto mode: {Param::Mode::MAX, Param::Mode::AVERAGE,
+                     Param::Mode::AVERAGE_COUNT_EXCLUDE_PADDING})
+    for (size_t ih: {3, 7, 16, 33})
+    for (size_t iw: {3, 7, 16, 33, 70})
+    for (size_t f: {1, 2, 3, 5})
+    for (size_t s: {1, 2, 3})
+    for (size_t p: {0, 1, 2})
+    {
+        if (p >= f || ih + 2 * p < f || iw + 2 * p < f)
+            continue;
+        Param param;
+        param.mode = mode;
+        param.window_h = param.window_w = f;
+        param.stride_h = param.stride_w = s;
+        param.pad_h = param.pad_w = p;
+        checker.set_param(param).exec({{2, 3, ih, iw}, {}});
+    }
+    // clang-format on
+}
+#endif
+
 TEST_F(ARM_COMMON, POOLING_INT8_W2x2_S2x2) {
     // clang-format off
     for (size_t ih: {2, 3, 7, 13, 52, 53, 54, 55})
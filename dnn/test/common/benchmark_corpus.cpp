@@ -0,0 +1,284 @@
+/**
+ * \file dnn/test/common/benchmark_corpus.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/common/benchmark_corpus.h"
+#include "test/common/utils.h"
+
+#include <gtest/gtest.h>
+
+#if MEGDNN_WITH_BENCHMARK
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+using namespace megdnn;
+using namespace test;
+using namespace benchmark_corpus;
+
+namespace {
+
+std::string json_escape(const std::string& str) {
+    std::string ret;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            ret.push_back('\\');
+            ret.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            ret.push_back(' ');
+        } else {
+            ret.push_back(c);
+        }
+    }
+    return ret;
+}
+
+const char* handle_type_name(Handle::HandleType type) {
+    switch (type) {
+        case Handle::HandleType::NAIVE:
+            return "naive";
+        case Handle::HandleType::FALLBACK:
+            return "fallback";
+        case Handle::HandleType::X86:
+            return "x86";
+        case Handle::HandleType::ARM_COMMON:
+            return "arm_common";
+        case Handle::HandleType::ARMV7:
+            return "armv7";
+        case Handle::HandleType::AARCH64:
+            return "aarch64";
+        case Handle::HandleType::CUDA:
+            return "cuda";
+        default:
+            return "unknown";
+    }
+}
+
+//! model name of the first cpu in /proc/cpuinfo, or empty if unavailable
+std::string host_cpu_model() {
+    std::ifstream fin("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(fin, line)) {
+        auto pos = line.find(':');
+        if (pos == std::string::npos)
+            continue;
+        auto key = line.substr(0, line.find_last_not_of(" \t", pos - 1) + 1);
+        if (key == "model name" || key == "Hardware" || key == "CPU part") {
+            return line.substr(line.find_first_not_of(' ', pos + 1));
+        }
+    }
+    return {};
+}
+
+param::ConvBias make_conv(
+        size_t stride, size_t pad, bool group = false,
+        param::ConvBias::NonlineMode mode = param::ConvBias::NonlineMode::RELU) {
+    param::ConvBias param;
+    param.stride_h = param.stride_w = stride;
+    param.pad_h = param.pad_w = pad;
+    param.nonlineMode = mode;
+    if (group)
+        param.sparse = param::ConvBias::Sparse::GROUP;
+    return param;
+}
+
+param::Pooling make_pooling(
+        param::Pooling::Mode mode, size_t window, size_t stride, size_t pad) {
+    param::Pooling param;
+    param.mode = mode;
+    param.window_h = param.window_w = window;
+    param.stride_h = param.stride_w = stride;
+    param.pad_h = param.pad_w = pad;
+    return param;
+}
+
+}  // anonymous namespace
+
+std::vector<Case<param::ConvBias>> benchmark_corpus::conv_bias_cases() {
+    // shapes: {src, filter, bias, z, dst}
+    auto dense = [](const char* model, size_t n, size_t ic, size_t ih, size_t oc,
+                    size_t fh, size_t stride) {
+        return Case<param::ConvBias>{
+                model,
+                make_conv(stride, fh / 2),
+                {{n, ic, ih, ih}, {oc, ic, fh, fh}, {1, oc, 1, 1}, {}, {}}};
+    };
+    auto chanwise = [](const char* model, size_t n, size_t c, size_t ih,
+                       size_t stride) {
+        return Case<param::ConvBias>{
+                model,
+                make_conv(stride, 1, true),
+                {{n, c, ih, ih}, {c, 1, 1, 3, 3}, {1, c, 1, 1}, {}, {}}};
+    };
+    return {
+            dense("resnet50", 1, 3, 224, 64, 7, 2),
+            dense("resnet50", 1, 64, 56, 64, 3, 1),
+            dense("resnet50", 1, 256, 56, 64, 1, 1),
+            dense("resnet50", 1, 128, 28, 128, 3, 1),
+            dense("resnet50", 1, 1024, 14, 256, 1, 1),
+            dense("resnet50", 1, 256, 14, 256, 3, 1),
+            dense("resnet50", 1, 512, 7, 512, 3, 1),
+            dense("resnet50_bs32", 32, 64, 56, 64, 3, 1),
+            dense("mobilenet_v2", 1, 3, 224, 32, 3, 2),
+            dense("mobilenet_v2", 1, 96, 56, 24, 1, 1),
+            dense("mobilenet_v2", 1, 24, 56, 144, 1, 1),
+            chanwise("mobilenet_v2", 1, 144, 56, 1),
+            chanwise("mobilenet_v2", 1, 144, 56, 2),
+            chanwise("mobilenet_v2", 1, 384, 14, 1),
+            chanwise("mobilenet_v2", 1, 960, 7, 1),
+            dense("shufflenet_v2", 1, 58, 28, 58, 1, 1),
+            dense("yolov3", 1, 256, 52, 512, 3, 1),
+    };
+}
+
+std::vector<Case<param::MatrixMul>> benchmark_corpus::matrix_mul_cases() {
+    // shapes: {A, B, C}
+    auto mm = [](const char* model, size_t m, size_t k, size_t n) {
+        return Case<param::MatrixMul>{model, {}, {{m, k}, {k, n}, {}}};
+    };
+    return {
+            mm("resnet50_fc", 1, 2048, 1000),
+            mm("resnet50_fc_bs32", 32, 2048, 1000),
+            mm("bert_base", 128, 768, 768),
+            mm("bert_base", 128, 768, 3072),
+            mm("bert_base", 128, 3072, 768),
+            mm("bert_base_bs8", 1024, 768, 768),
+            mm("lstm", 16, 512, 2048),
+            mm("square", 1024, 1024, 1024),
+    };
+}
+
+std::vector<Case<param::Pooling>> benchmark_corpus::pooling_cases() {
+    using Mode = param::Pooling::Mode;
+    return {
+            {"resnet50", make_pooling(Mode::MAX, 3, 2, 1), {{1, 64, 112, 112}, {}}},
+            {"resnet50_bs32",
+             make_pooling(Mode::MAX, 3, 2, 1),
+             {{32, 64, 112, 112}, {}}},
+            {"resnet50",
+             make_pooling(Mode::AVERAGE, 7, 1, 0),
+             {{1, 2048, 7, 7}, {}}},
+            {"vgg16", make_pooling(Mode::MAX, 2, 2, 0), {{1, 128, 112, 112}, {}}},
+    };
+}
+
+std::vector<Case<param::Elemwise>> benchmark_corpus::elemwise_cases() {
+    using Mode = param::Elemwise::Mode;
+    auto make = [](Mode mode) {
+        param::Elemwise param;
+        param.mode = mode;
+        return param;
+    };
+    return {
+            {"resnet50", make(Mode::RELU), {{1, 64, 112, 112}, {}}},
+            {"resnet50",
+             make(Mode::ADD),
+             {{1, 256, 56, 56}, {1, 256, 56, 56}, {}}},
+            {"resnet50_bs32",
+             make(Mode::FUSE_ADD_RELU),
+             {{32, 256, 56, 56}, {32, 256, 56, 56}, {}}},
+            {"bert_base", make(Mode::ADD), {{128, 3072}, {1, 3072}, {}}},
+            {"bert_base", make(Mode::GELU), {{128, 3072}, {}}},
+            {"mobilenet_v2", make(Mode::H_SWISH), {{1, 144, 56, 56}, {}}},
+            {"lstm", make(Mode::SIGMOID), {{16, 2048}, {}}},
+    };
+}
+
+Recorder& Recorder::inst() {
+    static Recorder recorder;
+    return recorder;
+}
+
+Recorder::Recorder() {
+    if (auto path = std::getenv("MEGDNN_BENCHMARK_JSON"))
+        m_path = path;
+    m_nr_samples = 10;
+    if (auto nr = std::getenv("MEGDNN_BENCHMARK_SAMPLES"))
+        m_nr_samples = std::max(std::atoi(nr), 1);
+    auto now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    set_info("time", buf);
+    set_info("cpu_count", std::to_string(get_cpu_count()));
+    set_info("cpu_model", host_cpu_model());
+#ifdef __VERSION__
+    set_info("compiler", __VERSION__);
+#endif
+}
+
+void Recorder::set_info(const std::string& key, const std::string& value) {
+    for (auto&& i : m_info) {
+        if (i.first == key) {
+            i.second = value;
+            return;
+        }
+    }
+    m_info.emplace_back(key, value);
+}
+
+void Recorder::add(Record record) {
+    if (auto info = ::testing::UnitTest::GetInstance()->current_test_info())
+        record.suite = info->test_case_name();
+    printf("%s %s %s %s: min %.4f ms over %zu samples\n", record.opr.c_str(),
+           record.model.c_str(), record.shapes.c_str(), record.algo.c_str(),
+           *std::min_element(record.samples.begin(), record.samples.end()),
+           record.samples.size());
+    m_records.emplace_back(std::move(record));
+    dump();
+}
+
+void Recorder::dump() const {
+    if (m_path.empty())
+        return;
+    std::ostringstream os;
+    os << "{\n  \"info\": {";
+    for (size_t i = 0; i < m_info.size(); ++i) {
+        os << (i ? ",\n" : "\n") << "    \"" << json_escape(m_info[i].first)
+           << "\": \"" << json_escape(m_info[i].second) << "\"";
+    }
+    os << "\n  },\n  \"records\": [";
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        auto&& r = m_records[i];
+        os << (i ? ",\n" : "\n") << "    {\"suite\": \"" << json_escape(r.suite)
+           << "\", \"opr\": \"" << json_escape(r.opr)
+           << "\", \"model\": \"" << json_escape(r.model) << "\", \"algo\": \""
+           << json_escape(r.algo) << "\", \"shapes\": \"" << json_escape(r.shapes)
+           << "\", \"dtype\": \"" << json_escape(r.dtype)
+           << "\", \"nr_runs\": " << r.nr_runs << ", \"samples\": [";
+        for (size_t j = 0; j < r.samples.size(); ++j) {
+            os << (j ? ", " : "") << r.samples[j];
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+    std::ofstream fout(m_path);
+    megdnn_assert(fout.good(), "failed to open %s", m_path.c_str());
+    fout << os.str();
+}
+
+void benchmark_corpus::record_handle_info(Handle* handle) {
+    auto&& recorder = Recorder::inst();
+    recorder.set_info("handle", handle_type_name(handle->type()));
+}
+
+std::string benchmark_corpus::shapes_to_string(const TensorLayoutArray& layouts) {
+    std::string ret;
+    for (auto&& layout : layouts) {
+        if (!ret.empty())
+            ret += ",";
+        ret += layout.TensorShape::to_string();
+    }
+    return ret;
+}
+
+#endif  // MEGDNN_WITH_BENCHMARK
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,189 @@
+/**
+ * \file dnn/test/common/benchmark_corpus.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "megdnn/oprs.h"
+#include "test/common/benchmarker.h"
+
+#include <string>
+#include <vector>
+
+#if MEGDNN_WITH_BENCHMARK
+
+namespace megdnn {
+namespace test {
+namespace benchmark_corpus {
+
+/*!
+ * \brief one shape of the curated corpus
+ *
+ * \p model names the network the shape is taken from, so that a regression
+ * report can be traced back to the workload that would be affected.
+ */
+template <typename Param>
+struct Case {
+    std::string model;
+    Param param;
+    TensorShapeArray shapes;
+};
+
+std::vector<Case<param::ConvBias>> conv_bias_cases();
+std::vector<Case<param::MatrixMul>> matrix_mul_cases();
+std::vector<Case<param::Pooling>> pooling_cases();
+std::vector<Case<param::Elemwise>> elemwise_cases();
+
+//! timing statistics of one (opr, case, algo) triple
+struct Record {
+    std::string opr, model, algo, shapes, dtype;
+    //! gtest fixture name, filled by Recorder::add() to tell backends apart
+    size_t nr_runs;
+    //! per-sample time in ms; each sample averages \p nr_runs execs
+    std::vector<float> samples;
+    std::string suite;
+};
+
+/*!
+ * \brief collect benchmark records and dump them as json
+ *
+ * Output goes to the file named by MEGDNN_BENCHMARK_JSON; nothing is written
+ * if the variable is unset, so the corpus tests can also be run ad hoc. The
+ * number of samples per record is controlled by MEGDNN_BENCHMARK_SAMPLES.
+ * Use dnn/scripts/compare_benchmark.py to check a dump against a baseline.
+ */
+class Recorder {
+public:
+    static Recorder& inst();
+
+    //! set a hardware / environment description entry
+    void set_info(const std::string& key, const std::string& value);
+    void add(Record record);
+
+    size_t nr_samples() const { return m_nr_samples; }
+
+    //! write all records collected so far; called again on each add()
+    void dump() const;
+
+private:
+    Recorder();
+
+    std::string m_path;
+    size_t m_nr_samples;
+    std::vector<std::pair<std::string, std::string>> m_info;
+    std::vector<Record> m_records;
+};
+
+//! record the backend of \p handle; backends may add more entries via set_info()
+void record_handle_info(Handle* handle);
+
+std::string shapes_to_string(const TensorLayoutArray& layouts);
+
+template <typename Opr, typename T>
+void run_sample(
+        Benchmarker<Opr, T>& benchmarker, const TensorLayoutArray& layouts,
+        Record& record) {
+    auto nr_samples = Recorder::inst().nr_samples();
+    for (size_t i = 0; i < nr_samples; ++i) {
+        record.samples.push_back(benchmarker.execl(layouts) / record.nr_runs);
+    }
+}
+
+/*!
+ * \brief benchmark every applicable algorithm of \p Opr on each case
+ *
+ * \p dtypes are applied to the leading tensors; the remaining ones keep the
+ * Benchmarker default.
+ */
+template <typename Opr, typename T>
+void run_algo_cases(
+        Benchmarker<Opr, T>& benchmarker, const char* opr_name,
+        const std::vector<Case<typename Opr::Param>>& cases,
+        const std::vector<DType>& dtypes, size_t nr_runs = 5) {
+    for (size_t i = 0; i < dtypes.size(); ++i)
+        benchmarker.set_dtype(i, dtypes[i]);
+    benchmarker.set_display(false).set_times(nr_runs);
+    for (auto&& c : cases) {
+        benchmarker.set_param(c.param);
+        auto opr = benchmarker.opr();
+        opr->param() = c.param;
+        auto layouts = benchmarker.make_layouts(c.shapes);
+        OprProxy<Opr>{}.deduce_layout(opr, layouts);
+        auto algos = OprAlgoProxy<Opr>::get_all_algorithms_info_safe(opr, layouts);
+        for (auto&& algo : algos) {
+            opr->execution_policy().algo = algo.desc;
+            Record record{opr_name, c.model, algo.desc.name,
+                          shapes_to_string(layouts), dtypes[0].name(), nr_runs, {}};
+            run_sample(benchmarker, layouts, record);
+            Recorder::inst().add(std::move(record));
+        }
+        opr->execution_policy() = {};
+    }
+}
+
+//! like run_algo_cases(), but for oprs without selectable algorithms
+template <typename Opr, typename T>
+void run_cases(
+        Benchmarker<Opr, T>& benchmarker, const char* opr_name,
+        const std::vector<Case<typename Opr::Param>>& cases, DType dtype,
+        size_t nr_runs = 5) {
+    benchmarker.set_display(false).set_times(nr_runs);
+    for (auto&& c : cases) {
+        for (size_t i = 0; i < c.shapes.size(); ++i)
+            benchmarker.set_dtype(i, dtype);
+        benchmarker.set_param(c.param);
+        auto layouts = benchmarker.make_layouts(c.shapes);
+        OprProxy<Opr>{}.deduce_layout(benchmarker.opr(), layouts);
+        Record record{opr_name, c.model, "default", shapes_to_string(layouts),
+                      dtype.name(), nr_runs, {}};
+        run_sample(benchmarker, layouts, record);
+        Recorder::inst().add(std::move(record));
+    }
+}
+
+/*!
+ * \brief run the whole corpus on \p handle
+ *
+ * Backends call this from a BENCHMARK_CORPUS test after recording their
+ * hardware info; \p T is the timer type used by the backend benchmarker.
+ */
+template <typename T = Timer>
+void run_all(Handle* handle) {
+    {
+        Benchmarker<ConvBias, T> benchmarker(handle);
+        run_algo_cases(
+                benchmarker, "ConvBias", conv_bias_cases(),
+                {dtype::Float32(), dtype::Float32(), dtype::Float32(),
+                 dtype::Float32(), dtype::Float32()});
+    }
+    {
+        Benchmarker<MatrixMul, T> benchmarker(handle);
+        run_algo_cases(
+                benchmarker, "MatrixMul", matrix_mul_cases(),
+                {dtype::Float32(), dtype::Float32(), dtype::Float32()});
+    }
+    {
+        Benchmarker<Pooling, T> benchmarker(handle);
+        run_algo_cases(
+                benchmarker, "Pooling", pooling_cases(),
+                {dtype::Float32(), dtype::Float32()});
+    }
+    {
+        Benchmarker<Elemwise, T> benchmarker(handle);
+        run_cases(benchmarker, "Elemwise", elemwise_cases(), dtype::Float32());
+    }
+}
+
+}  // namespace benchmark_corpus
+}  // namespace test
+}  // namespace megdnn
+
+#endif  // MEGDNN_WITH_BENCHMARK
+
+// vim: syntax=cpp.doxygen
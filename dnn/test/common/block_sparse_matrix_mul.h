@@ -0,0 +1,95 @@
+/**
+ * \file dnn/test/common/block_sparse_matrix_mul.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+#include "test/common/checker.h"
+
+namespace megdnn {
+namespace test {
+namespace block_sparse_matrix_mul {
+
+using Mode = param::BlockSparseMatrixMul::Mode;
+
+struct TestArg {
+    param::BlockSparseMatrixMul param;
+    size_t nnz;
+    TensorShape values, col_idx, row_ptr, src;
+};
+
+/*!
+ * \brief A is of (M, K), with nnz blocks of (bh, bw); B is of (K, N) or
+ *      (N, K) with an optional batch of nr_batch, which is not batched if it
+ *      is 0
+ */
+inline TestArg make_arg(
+        Mode mode, size_t bh, size_t bw, size_t M, size_t K, size_t nnz,
+        size_t nr_batch, size_t N) {
+    param::BlockSparseMatrixMul param{
+            mode, static_cast<uint32_t>(bh), static_cast<uint32_t>(bw)};
+    bool sd = mode == Mode::SPARSE_DENSE;
+    TensorShape src = sd ? TensorShape{K, N} : TensorShape{N, K};
+    if (nr_batch) {
+        src = sd ? TensorShape{nr_batch, K, N} : TensorShape{nr_batch, N, K};
+    }
+    return {param, nnz, {nnz, bh, bw}, {nnz}, {M / bh + 1}, src};
+}
+
+inline std::vector<TestArg> get_args() {
+    std::vector<TestArg> args;
+    for (auto mode : {Mode::SPARSE_DENSE, Mode::DENSE_SPARSE_T}) {
+        args.push_back(make_arg(mode, 1, 1, 1, 1, 1, 1, 1));
+        args.push_back(make_arg(mode, 1, 4, 8, 16, 5, 2, 7));
+        args.push_back(make_arg(mode, 4, 4, 32, 64, 40, 0, 33));
+        args.push_back(make_arg(mode, 1, 4, 64, 128, 300, 3, 49));
+        // some row blocks are empty
+        args.push_back(make_arg(mode, 2, 8, 16, 32, 3, 2, 20));
+        args.push_back(make_arg(mode, 8, 1, 64, 16, 100, 1, 128));
+    }
+    return args;
+}
+
+/*!
+ * \brief fill col_idx and row_ptr of arg with a random sparse structure, in
+ *      which the blocks are spread over the row blocks as evenly as possible
+ */
+inline CheckerHelper::TensorsConstriant make_constraint(const TestArg& arg) {
+    size_t nr_rb = arg.row_ptr[0] - 1,
+           K = arg.src[arg.src.ndim -
+                       (arg.param.mode == Mode::SPARSE_DENSE ? 2 : 1)],
+           nr_cb = K / arg.param.block_w, nnz = arg.nnz;
+    megdnn_assert(nnz <= nr_rb * nr_cb);
+    return [=](CheckerHelper::TensorValueArray& tensors) {
+        auto col_idx = tensors[1].ptr<dt_int32>();
+        auto row_ptr = tensors[2].ptr<dt_int32>();
+        std::mt19937 rng(nnz);
+        std::vector<dt_int32> cols(nr_cb);
+        std::iota(cols.begin(), cols.end(), 0);
+        row_ptr[0] = 0;
+        for (size_t rb = 0; rb < nr_rb; ++rb) {
+            size_t cnt = nnz / nr_rb + (rb < nnz % nr_rb);
+            std::shuffle(cols.begin(), cols.end(), rng);
+            std::copy(cols.begin(), cols.begin() + cnt, col_idx + row_ptr[rb]);
+            row_ptr[rb + 1] = row_ptr[rb] + cnt;
+        }
+    };
+}
+
+}  // namespace block_sparse_matrix_mul
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,60 @@
+/**
+ * \file dnn/test/common/embedding_bag.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+#include "test/common/checker.h"
+
+namespace megdnn {
+namespace test {
+namespace embedding_bag {
+
+using Mode = param::EmbeddingBag::Mode;
+
+/*!
+ * \brief fill indices and offsets with random valid values, some of the bags
+ *      being empty, and give the quantized rows valid scales and biases
+ */
+inline CheckerHelper::TensorsConstriant make_constraint(size_t nr_rows) {
+    return [=](CheckerHelper::TensorValueArray& tensors) {
+        auto&& wl = tensors[0].layout;
+        size_t L = tensors[1].layout[0], B = tensors[2].layout[0];
+        std::mt19937 rng(L * 131 + B);
+        auto indices = tensors[1].ptr<dt_int32>();
+        for (size_t i = 0; i < L; ++i) {
+            indices[i] = rng() % nr_rows;
+        }
+        auto offsets = tensors[2].ptr<dt_int32>();
+        for (size_t b = 0; b < B; ++b) {
+            offsets[b] = b ? rng() % (L + 1) : 0;
+        }
+        std::sort(offsets, offsets + B);
+        if (wl.dtype == dtype::Uint8()) {
+            size_t D = wl[1] - EmbeddingBag::QUANT_ROW_EXTRA_BYTES;
+            std::uniform_real_distribution<float> dist{-1.f, 1.f};
+            for (size_t r = 0; r < nr_rows; ++r) {
+                auto row = tensors[0].ptr<dt_uint8>() + r * wl[1];
+                float scale_bias[2] = {dist(rng) / 128, dist(rng)};
+                memcpy(row + D, scale_bias, sizeof(scale_bias));
+            }
+        }
+    };
+}
+
+}  // namespace embedding_bag
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
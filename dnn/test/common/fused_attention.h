@@ -0,0 +1,47 @@
+/**
+ * \file dnn/test/common/fused_attention.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <cmath>
+#include <vector>
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+
+namespace megdnn {
+namespace test {
+namespace fused_attention {
+
+struct TestArg {
+    param::FusedAttention param;
+    TensorShape query, key, value;
+};
+
+inline std::vector<TestArg> get_args() {
+    std::vector<TestArg> args;
+    auto add = [&](size_t B, size_t S, size_t T, size_t D, size_t Dv) {
+        param::FusedAttention param{1.f / std::sqrt(static_cast<float>(D))};
+        args.push_back({param, {B, S, D}, {B, T, D}, {B, T, Dv}});
+    };
+    add(1, 1, 1, 1, 1);
+    add(2, 3, 5, 7, 9);
+    add(4, 17, 33, 64, 64);
+    add(3, 16, 100, 32, 96);
+    add(2, 40, 65, 128, 128);
+    add(2, 9, 70, 160, 40);
+    add(1, 5, 31, 20, 300);
+    return args;
+}
+
+}  // namespace fused_attention
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
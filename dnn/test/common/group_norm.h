@@ -0,0 +1,43 @@
+/**
+ * \file dnn/test/common/group_norm.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <vector>
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+
+namespace megdnn {
+namespace test {
+namespace group_norm {
+
+struct TestArg {
+    param::GroupNorm param;
+    TensorShape shape;
+};
+
+inline std::vector<TestArg> get_args() {
+    std::vector<TestArg> args;
+    for (auto&& shape : TensorShapeArray{
+                 {1, 4}, {2, 6, 5}, {3, 8, 7, 7}, {2, 32, 33, 35}, {1, 4, 2, 1000}}) {
+        for (uint32_t group : {1, 2, 4}) {
+            for (bool affine : {true, false}) {
+                args.push_back({{affine, 1e-5f, group}, shape});
+            }
+        }
+    }
+    return args;
+}
+
+}  // namespace group_norm
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
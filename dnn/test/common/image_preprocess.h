@@ -0,0 +1,73 @@
+/**
+ * \file dnn/test/common/image_preprocess.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+namespace image_preprocess {
+
+//! check forward of all the modes and formats against the naive impl
+inline void run_test(Handle* handle) {
+    using Param = param::ImagePreprocess;
+    Checker<ImagePreprocessForward> checker(handle);
+    UniformIntRNG src_rng{0, 255};
+    UniformFloatRNG scale_rng{1e-3f, 1e-1f}, bias_rng{-1.f, 1.f};
+    checker.set_dtype(0, dtype::Uint8())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32())
+            .set_dtype(3, dtype::Float32());
+    checker.set_rng(0, &src_rng).set_rng(1, &scale_rng).set_rng(2, &bias_rng);
+    checker.set_epsilon(1e-3);
+    for (auto mode :
+         {Param::Mode::RGB, Param::Mode::RGB2BGR, Param::Mode::YUV2RGB_NV21,
+          Param::Mode::YUV2BGR_NV21, Param::Mode::YUV2RGB_NV12,
+          Param::Mode::YUV2BGR_NV12}) {
+        bool yuv = mode != Param::Mode::RGB && mode != Param::Mode::RGB2BGR;
+        for (auto imode :
+             {Param::InterpolationMode::LINEAR, Param::InterpolationMode::NEAREST}) {
+            for (auto format :
+                 {Param::Format::NCHW, Param::Format::NHWC, Param::Format::NCHW44}) {
+                checker.set_param({mode, imode, format});
+                // shrinking, enlarging and keeping sizes, of odd output sizes
+                for (auto&& size : std::vector<std::array<size_t, 4>>{
+                             {2, 2, 1, 1},
+                             {4, 6, 4, 6},
+                             {20, 32, 7, 9},
+                             {6, 8, 13, 17},
+                             {32, 4, 17, 30}}) {
+                    size_t IH = size[0], IW = size[1], OH = size[2], OW = size[3];
+                    TensorShape src = yuv ? TensorShape{2, IH * 3 / 2, IW, 1}
+                                          : TensorShape{2, IH, IW, 3};
+                    TensorShape dst;
+                    if (format == Param::Format::NCHW) {
+                        dst = {2, 3, OH, OW};
+                    } else if (format == Param::Format::NHWC) {
+                        dst = {2, OH, OW, 3};
+                    } else {
+                        dst = {2, 1, OH, OW, 4};
+                    }
+                    checker.execs({src, {3}, {3}, dst});
+                }
+            }
+        }
+    }
+}
+
+}  // namespace image_preprocess
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
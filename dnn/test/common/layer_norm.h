@@ -0,0 +1,63 @@
+/**
+ * \file dnn/test/common/layer_norm.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <vector>
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+
+namespace megdnn {
+namespace test {
+namespace layer_norm {
+
+struct TestArg {
+    param::LayerNorm param;
+    TensorShape shape, normalized_shape, unnormalized_shape;
+};
+
+//! normalize over the last \p dim axes of \p shape
+inline TestArg make_arg(const TensorShape& shape, size_t dim, bool affine) {
+    TestArg arg;
+    arg.shape = shape;
+    arg.normalized_shape.ndim = dim;
+    arg.unnormalized_shape.ndim = shape.ndim - dim;
+    size_t size = 1;
+    for (size_t i = 0; i < shape.ndim; ++i) {
+        if (i < shape.ndim - dim) {
+            arg.unnormalized_shape[i] = shape[i];
+        } else {
+            arg.normalized_shape[i - shape.ndim + dim] = shape[i];
+            size *= shape[i];
+        }
+    }
+    arg.param = {affine, 1e-5f, dim, size};
+    return arg;
+}
+
+inline std::vector<TestArg> get_args() {
+    std::vector<TestArg> args;
+    for (auto&& shape : TensorShapeArray{
+                 {1, 1}, {7, 3}, {2, 1000}, {3, 4097}, {100, 33}, {2, 3, 300},
+                 {5, 1, 9, 17}}) {
+        for (size_t dim = 1; dim < shape.ndim; ++dim) {
+            for (bool affine : {true, false}) {
+                args.push_back(make_arg(shape, dim, affine));
+            }
+        }
+    }
+    return args;
+}
+
+}  // namespace layer_norm
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
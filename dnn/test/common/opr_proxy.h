@@ -170,6 +170,43 @@ struct OprProxy<ElemwiseMultiType> {
     }
 };
 
+template <>
+struct OprProxy<ElemwiseMultiOutput> {
+    static void deduce_layout(ElemwiseMultiOutput* opr, TensorLayoutArray& layouts) {
+        megdnn_assert(layouts.size() >= 3);
+        TensorLayoutArray inp(layouts.begin(), layouts.end() - 2), out;
+        opr->deduce_layout(inp, out);
+        std::copy(out.begin(), out.end(), layouts.end() - 2);
+    }
+
+    static void exec(ElemwiseMultiOutput* opr, const TensorNDArray& tensors) {
+        megdnn_assert(tensors.size() >= 3);
+        TensorNDArray inp(tensors.begin(), tensors.end() - 2),
+                out(tensors.end() - 2, tensors.end());
+        opr->exec(inp, out);
+    }
+};
+
+template <>
+struct OprProxy<CheckNonFiniteV2> {
+    static void deduce_layout(CheckNonFiniteV2* opr, TensorLayoutArray& layouts) {
+        megdnn_assert(layouts.size() >= 2);
+        auto inp = layouts;
+        inp.pop_back();
+        opr->deduce_layout(inp, layouts.back());
+    }
+
+    static void exec(CheckNonFiniteV2* opr, const TensorNDArray& tensors) {
+        megdnn_assert(tensors.size() >= 2);
+        auto inp = tensors;
+        inp.pop_back();
+        WorkspaceWrapper W(
+                opr->handle(),
+                opr->get_workspace_in_bytes(inp, tensors.back().layout));
+        opr->exec(inp, tensors.back(), W.workspace());
+    }
+};
+
 template <>
 struct OprProxy<ConcatForward> {
     static void deduce_layout(ConcatForward* opr, TensorLayoutArray& layouts) {
@@ -0,0 +1,42 @@
+/**
+ * \file dnn/test/common/softmax.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <vector>
+#include "megdnn/basic_types.h"
+#include "megdnn/opr_param_defs.h"
+
+namespace megdnn {
+namespace test {
+namespace softmax {
+
+struct TestArg {
+    param::Softmax param;
+    TensorShape shape;
+    TestArg(param::Softmax param, TensorShape shape) : param(param), shape(shape) {}
+};
+
+inline std::vector<TestArg> get_args() {
+    std::vector<TestArg> args;
+    for (auto&& shape : TensorShapeArray{
+                 {1}, {7}, {1000}, {3, 4097}, {100, 33}, {2, 3, 300}, {5, 1, 9, 17}}) {
+        for (int axis = -1; axis < static_cast<int>(shape.ndim); ++axis) {
+            args.emplace_back(param::Softmax{axis}, shape);
+        }
+    }
+    return args;
+}
+
+}  // namespace softmax
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
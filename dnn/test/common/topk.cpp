@@ -164,6 +164,8 @@ void test::run_topk_test(Handle* handle) {
         run(5, 23, 100, mode);
         run(-7, 23, 100, mode);
         run(23, 3, 50001, mode);
+        run(-1000, 4, 50001, mode);   // large k on long rows
+        run(20000, 2, 50001, mode);
         run(5, 123, 3, mode);         // equiv to sort
         run(-5, 123, 3, mode);        // equiv to rev sort
         run(5, 3, 1231, mode, 2000);  // non contig
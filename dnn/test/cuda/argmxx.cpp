@@ -85,6 +85,9 @@ void test_argmxx(Handle* handle) {
     checker.execs({{3, 64 * 64 + 1, 7}, {}});
     checker.execs({{3, 32 * 32 + 1, 15}, {}});
     checker.execs({{3, 512, 500}, {}});
+    // short reduce axis / long contiguous rows
+    checker.execs({{1000, 4, 64}, {}});
+    checker.execs({{4, 10000, 1}, {}});
     // very large reduce
     checker.execs({{1, 4194304, 1}, {}});
 }
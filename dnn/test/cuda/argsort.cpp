@@ -75,6 +75,15 @@ void run_forward_test(Handle* handle, DType dtype) {
         param.order = Order::ASCENDING;
         checker.set_param(param).execs({{1, N}, {}, {}});
     }
+    {
+        // batched long rows
+        rng.set_rev_order(false);
+        Param param;
+        param.order = Order::ASCENDING;
+        checker.set_param(param).execs({{4, 100003}, {}, {}});
+        param.order = Order::DESCENDING;
+        checker.set_param(param).execs({{17, 20000}, {}, {}});
+    }
 }
 
 void run_backward_test(Handle* handle, DType dtype) {
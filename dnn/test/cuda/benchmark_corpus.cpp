@@ -0,0 +1,37 @@
+/**
+ * \file dnn/test/cuda/benchmark_corpus.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "test/cuda/fixture.h"
+
+#include "src/cuda/utils.h"
+#include "test/common/benchmark_corpus.h"
+#include "test/cuda/benchmark.h"
+
+namespace megdnn {
+namespace test {
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(CUDA, BENCHMARK_CORPUS) {
+    auto&& prop = cuda::current_device_prop();
+    auto&& recorder = benchmark_corpus::Recorder::inst();
+    benchmark_corpus::record_handle_info(handle_cuda());
+    recorder.set_info("device", prop.name);
+    recorder.set_info(
+            "compute_capability",
+            std::to_string(prop.major) + "." + std::to_string(prop.minor));
+    benchmark_corpus::run_all<CUTimer>(handle_cuda());
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
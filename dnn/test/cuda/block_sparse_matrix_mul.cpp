@@ -0,0 +1,51 @@
+/**
+ * \file dnn/test/cuda/block_sparse_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/block_sparse_matrix_mul.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, BLOCK_SPARSE_MATRIX_MUL) {
+    using namespace block_sparse_matrix_mul;
+    Checker<BlockSparseMatrixMulForward> checker(handle_cuda());
+    UniformFloatRNG rng{-1.f, 1.f};
+    checker.set_dtype(1, dtype::Int32()).set_dtype(2, dtype::Int32());
+    checker.set_rng(0, &rng).set_rng(3, &rng);
+    auto run = [&](const TestArg& arg) {
+        checker.set_param(arg.param)
+                .set_tensors_constraint(make_constraint(arg))
+                .execs({arg.values, arg.col_idx, arg.row_ptr, arg.src, {}});
+    };
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-4f}, {dtype::Float16(), 1e-2f}}) {
+        for (size_t i : {0, 3, 4}) {
+            checker.set_dtype(i, dtype_eps.first);
+        }
+        checker.set_epsilon(dtype_eps.second);
+        for (auto&& arg : get_args()) {
+            run(arg);
+        }
+        for (auto mode : {Mode::SPARSE_DENSE, Mode::DENSE_SPARSE_T}) {
+            // a thread for each output element, with the last block of 256
+            // threads partially filled
+            run(make_arg(mode, 4, 4, 32, 64, 40, 3, 257));
+            run(make_arg(mode, 1, 8, 3, 8, 3, 0, 1));
+            // all the blocks are present
+            run(make_arg(mode, 4, 4, 16, 16, 16, 0, 9));
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
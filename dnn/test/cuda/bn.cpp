@@ -26,16 +26,18 @@ namespace test {
 
 TEST_F(CUDA, BN_FORWARD_BACKWARD) {
     using namespace batch_normalization;
-    using cuda::cudnn_handle;
-    using cuda::batch_normalization::BNTensorDescHolder;
-    using cuda::batch_normalization::get_reserve_size;
     std::vector<TestArg> args = get_args();
+    for (auto arg : get_args()) {
+        // the mask of the fused relu is kept in reserve
+        arg.param.nonlineMode = param::BN::NonlineMode::RELU;
+        args.push_back(arg);
+    }
     Checker<BNForward> checker(handle_cuda());
     Checker<BNBackward> checker_bwd(handle_cuda());
     for (auto&& arg : args) {
-        auto tensor_desc = BNTensorDescHolder(
-                {arg.src, arg.dtype}, arg.param.param_dim, arg.param.fwd_mode);
-        auto reserve = get_reserve_size(cudnn_handle(handle_cuda()), tensor_desc);
+        auto opr = handle_cuda()->create_operator<BNForward>();
+        opr->param() = arg.param;
+        auto reserve = opr->get_reserve_in_bytes({arg.src, arg.dtype});
         // Forward
         for (int i = 0; i < 9; ++i) {
             checker.set_dtype(i, dtype::Float32());
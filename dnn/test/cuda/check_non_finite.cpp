@@ -31,6 +31,28 @@ TEST_F(CUDA, CHECK_NON_FINITE_BASIC) {
     checker.execs({{512 * 16}, {1}});
 }
 
+TEST_F(CUDA, CHECK_NON_FINITE_V2_MULTI_INPUT) {
+    Checker<CheckNonFiniteV2> checker(handle_cuda());
+    checker.set_allow_invalid_check(true);
+    const auto inf = std::numeric_limits<float>::infinity();
+    // a large tensor spanning several chunks, and many small ones
+    UniformFloatWithValueRNG rng(-1.0f, 1.0f, 0.f, inf),
+            rng_inf(-1.0f, 1.0f, 1e-3f, inf);
+    for (float scale : {1.f, 1.f / 1024}) {
+        checker.set_param({scale});
+        for (size_t i = 0; i < 8; ++i) {
+            checker.set_rng(i, &rng);
+        }
+        checker.execs(
+                {{100000}, {3}, {1}, {513}, {16384}, {7}, {1}, {65536 + 1}, {1}});
+        checker.set_rng(7, &rng_inf);
+        checker.execs(
+                {{100000}, {3}, {1}, {513}, {16384}, {7}, {1}, {65536 + 1}, {1}});
+        checker.set_rng(7, &rng).set_rng(0, &rng_inf);
+        checker.execs({{100000}, {1}});
+    }
+}
+
 }  // namespace test
 }  // namespace megdnn
 
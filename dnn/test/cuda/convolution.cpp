@@ -314,6 +314,46 @@ TEST_F(CUDA, CONVOLUTION_BACKWARD_DATA_NHWC) {
     }
 }
 
+TEST_F(CUDA, CONVOLUTION_BACKWARD_FILTER_NHWC) {
+    using namespace convolution;
+    std::vector<TestArg> args = get_args_cuda_conv_bwd_data();
+    Checker<ConvolutionBackwardFilter> checker(handle_cuda());
+    bool f16_checked = false;
+    for (auto&& arg : args) {
+        arg.param.format = param::Convolution::Format::NHWC;
+        arg.src = cvt_src_or_dst_nchw2nhwc(arg.src);
+        arg.filter = cvt_filter_nchw2nhwc(arg.filter);
+        auto src = TensorLayout(arg.src, dtype::Float32());
+        auto filter = TensorLayout(arg.filter, dtype::Float32());
+        TensorLayout dst;
+        {
+            auto opr = handle_cuda()->create_operator<Convolution>();
+            opr->param() = arg.param;
+            opr->deduce_layout(src, filter, dst);
+        }
+        float scale = 1.0f / sqrt(dst[1] * dst[2]);
+        UniformFloatRNG rng(scale, 2 * scale);
+        checker.set_rng(0, &rng)
+                .set_rng(1, &rng)
+                .set_epsilon(1e-3)
+                .set_param(arg.param)
+                .exec(TensorLayoutArray{src, dst, filter});
+
+        // reduce on large f16 array may introduce significant error
+        if (dst.total_nr_elems() >= 1000 && f16_checked)
+            continue;
+
+        f16_checked = true;
+        src.dtype = dst.dtype = filter.dtype = dtype::Float16();
+        arg.param.compute_mode = param::Convolution::ComputeMode::FLOAT32;
+        checker.set_rng(0, &rng)
+                .set_rng(1, &rng)
+                .set_epsilon(1e-1)
+                .set_param(arg.param)
+                .exec(TensorLayoutArray{src, dst, filter});
+    }
+}
+
 TEST_F(CUDA, CONVOLUTION_BACKWARD_DATA_CUDNN) {
     if (cuda::is_compute_capability_required(7, 0))
         return;
@@ -278,6 +278,24 @@ void benchmark_matrix_mul(
     }
 }
 #endif
+
+//! small m and n with a long k, of which the grid of m and n alone can not
+//! fill the device
+std::vector<matrix_mul::TestArg> get_skinny_matmul_args(size_t nr_masks) {
+    std::vector<matrix_mul::TestArg> args;
+    for (size_t mask = 0; mask < nr_masks; ++mask) {
+        for (size_t m : {1, 4, 6, 64}) {
+            for (size_t n : {1, 8, 30, 128}) {
+                for (size_t k : {1024, 4096}) {
+                    args.emplace_back(m, n, k, mask);
+                }
+            }
+        }
+    }
+    // non-contiguous case
+    args.emplace_back(5, 62, 2048, 0, 2048 + 8, 62 + 2, 62 * 2 + 2);
+    return args;
+}
 }  // namespace
 
 TEST_F(CUDA, CUTLASS_GEMM_MULTI_BATCHSIZE) {
@@ -321,6 +339,19 @@ TEST_F(CUDA, CUTLASS_GEMV_BATCHED_STRIDED_32_MULTI_BATCHSIZE) {
             param::MatrixMul::Format::DEFAULT);
 }
 
+#if !MEGDNN_DISABLE_FLOAT16
+#define cb(tbn)                                                                      \
+    TEST_F(CUDA, CUDA_FLOAT16_GEMV_BATCHED_STRIDED_##tbn) {                          \
+        matrix_mul::check_matrix_mul<MatrixMulForward>(                              \
+                dtype::Float16(), dtype::Float16(), dtype::Float16(), handle_cuda(), \
+                "CUDA_FLOAT16_GEMV_BATCHED_STRIDED_" #tbn,                           \
+                param::MatrixMul::Format::DEFAULT, 8, 1e-2,                          \
+                get_skinny_matmul_args(1));                                          \
+    }
+cb(128) cb(64) cb(32)
+#undef cb
+#endif
+
 #define MEGDNN_FOREACH_CUTLASS_KERNEL(cb) \
     cb(1, 64, 256, 8, 32, 64, 8);         \
     cb(2, 256, 64, 8, 64, 32, 8);         \
@@ -402,6 +433,21 @@ MEGDNN_FOREACH_CUTLASS_KERNEL(cb)
 
 #undef cb
 
+#define cb(name, tbm, tbn, tbk, wm, wn, wk, im, in, ik)                              \
+    TEST_F(CUDA, CUTLASS_F16_884_GEMM_SPLIT_K_BALANCED_##name) {                     \
+        require_compute_capability(7, 0);                                            \
+        matrix_mul::check_matrix_mul<MatrixMulForward>(                              \
+                dtype::Float16(), dtype::Float16(), dtype::Float16(), handle_cuda(), \
+                "CUTLASS_FLOAT16_TENSOR_OP_SPLIT_K_BALANCED_h" #im #in #ik "_" #tbm  \
+                "X" #tbn "X" #tbk "_" #wm "X" #wn "X" #wk,                           \
+                param::MatrixMul::Format::DEFAULT, 8, 1e-2,                          \
+                get_skinny_matmul_args(4), true,                                     \
+                param::MatrixMul::ComputeMode::FLOAT32);                             \
+    }
+MEGDNN_FOREACH_CUTLASS_KERNEL(cb)
+
+#undef cb
+
 #undef MEGDNN_FOREACH_CUTLASS_KERNEL
 
 #define MEGDNN_FOREACH_CUTLASS_KERNEL(cb)      \
@@ -438,6 +484,21 @@ MEGDNN_FOREACH_CUTLASS_KERNEL(cb)
 
 #undef cb
 
+#define cb(name, tbm, tbn, tbk, wm, wn, wk, im, in, ik)                              \
+    TEST_F(CUDA, CUTLASS_F16_1688_GEMM_SPLIT_K_BALANCED_##name) {                    \
+        require_compute_capability(7, 5);                                            \
+        matrix_mul::check_matrix_mul<MatrixMulForward>(                              \
+                dtype::Float16(), dtype::Float16(), dtype::Float16(), handle_cuda(), \
+                "CUTLASS_FLOAT16_TENSOR_OP_SPLIT_K_BALANCED_h" #im #in #ik "_" #tbm  \
+                "X" #tbn "X" #tbk "_" #wm "X" #wn "X" #wk,                           \
+                param::MatrixMul::Format::DEFAULT, 8, 1e-2,                          \
+                get_skinny_matmul_args(4), true,                                     \
+                param::MatrixMul::ComputeMode::FLOAT32);                             \
+    }
+MEGDNN_FOREACH_CUTLASS_KERNEL(cb)
+
+#undef cb
+
 #undef MEGDNN_FOREACH_CUTLASS_KERNEL
 #endif
 
@@ -0,0 +1,83 @@
+/**
+ * \file dnn/test/cuda/elemwise_multi_output.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megdnn/oprs/nn_int.h"
+#include "test/common/checker.h"
+#include "test/cuda/fixture.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+using Mode = ElemwiseMultiOutput::Param::Mode;
+
+void run_test(Handle* handle, Mode mode) {
+    Checker<ElemwiseMultiOutput> checker(handle);
+    ElemwiseMultiOutput::Param param;
+    param.mode = mode;
+    param.momentum = 0.9f;
+    param.lr = 0.1f;
+    checker.set_param(param);
+    size_t arity = ElemwiseMultiOutput::nr_inputs(mode);
+
+    auto run = [&](const TensorShapeArray& inp) {
+        auto shapes = inp;
+        shapes.emplace_back();
+        shapes.emplace_back();
+        checker.execs(shapes);
+    };
+    auto run_same = [&](const TensorShape& shape) {
+        run(TensorShapeArray(arity, shape));
+    };
+    for (auto dtype : std::vector<DType>{
+                 dtype::Float32(), dtype::Float16(), dtype::BFloat16()}) {
+        for (size_t i = 0; i < arity; ++i) {
+            checker.set_dtype(i, dtype);
+        }
+        checker.set_dtype(arity, dtype).set_dtype(arity + 1, dtype);
+        if (dtype == dtype::Float32()) {
+            checker.set_epsilon(1e-5);
+        } else if (dtype == dtype::Float16()) {
+            checker.set_epsilon(1e-3);
+        } else {
+            checker.set_epsilon(1e-2);
+        }
+
+        // vectorized, with and without a partial pack at the end
+        run_same({1024});
+        run_same({2, 3, 1001});
+        run_same({1});
+        run_same({7});
+
+        // broadcasted scalar is still vectorized
+        TensorShapeArray inp(arity, {4, 5, 24});
+        inp[1] = {1};
+        run(inp);
+
+        // bias-like broadcast goes through the generic path
+        inp[1] = {1, 5, 1};
+        run(inp);
+        inp = TensorShapeArray(arity, {4, 5, 24});
+        inp[0] = {4, 1, 24};
+        run(inp);
+    }
+}
+}  // anonymous namespace
+
+TEST_F(CUDA, ELEMWISE_MULTI_OUTPUT_SIGMOID_MUL) {
+    run_test(handle_cuda(), Mode::SIGMOID_MUL);
+}
+
+TEST_F(CUDA, ELEMWISE_MULTI_OUTPUT_MOMENTUM_UPDATE) {
+    run_test(handle_cuda(), Mode::MOMENTUM_UPDATE);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,79 @@
+/**
+ * \file dnn/test/cuda/fused_attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include <cmath>
+
+#include "test/common/checker.h"
+#include "test/common/fused_attention.h"
+#include "test/cuda/benchmark.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, FUSED_ATTENTION) {
+    Checker<FusedAttentionForward> checker(handle_cuda());
+    UniformFloatRNG rng{-2.f, 2.f};
+    for (size_t i = 0; i < 3; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    auto run = [&](size_t B, size_t S, size_t T, size_t D, size_t Dv) {
+        checker.set_param({1.f / std::sqrt(static_cast<float>(D))})
+                .execs({{B, S, D}, {B, T, D}, {B, T, Dv}, {}});
+    };
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-4f}, {dtype::Float16(), 1e-2f}}) {
+        for (size_t i = 0; i < 4; ++i) {
+            checker.set_dtype(i, dtype_eps.first);
+        }
+        checker.set_epsilon(dtype_eps.second);
+        for (auto&& arg : fused_attention::get_args()) {
+            checker.set_param(arg.param).execs({arg.query, arg.key, arg.value, {}});
+        }
+        // the tile kernels compute blocks of 16 query rows over tiles of 32
+        // keys, with head dims up to 64 or 128
+        for (size_t S : {15, 16, 17}) {
+            for (size_t T : {31, 32, 33}) {
+                run(2, S, T, 64, 63);
+                run(2, S, T, 65, 128);
+            }
+        }
+        // the generic kernel computes 4 query rows and 128 output columns
+        // per block if the head dim exceeds 128
+        run(2, 5, 40, 129, 20);
+        run(2, 9, 40, 32, 257);
+    }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(CUDA, BENCHMARK_FUSED_ATTENTION) {
+    CUBenchmarker<FusedAttentionForward> benchmarker(handle_cuda());
+    constexpr size_t RUNS = 20;
+    benchmarker.set_times(RUNS);
+    auto run = [&](size_t B, size_t S, size_t D) {
+        benchmarker.set_param(
+                param::FusedAttention{1.f / std::sqrt(static_cast<float>(D))});
+        auto time_ms = benchmarker.execs({{B, S, D}, {B, S, D}, {B, S, D}, {}}) / RUNS;
+        double flops = 4.0 * B * S * S * D;
+        printf("B=%zu S=%zu D=%zu: %.3fms %.2fGFlops\n", B, S, D, time_ms,
+               flops / time_ms * 1e-6);
+    };
+    // (batch * heads, seq, head_dim)
+    for (size_t seq : {128, 512, 2048, 8192}) {
+        run(96, seq, 64);
+    }
+    run(16, 1024, 128);
+    run(16, 1024, 256);
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,61 @@
+/**
+ * \file dnn/test/cuda/group_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/group_norm.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, GROUP_NORM) {
+    Checker<GroupNormForward> checker_fwd(handle_cuda());
+    Checker<GroupNormBackward> checker_bwd(handle_cuda());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_rstd{0.5f, 2.f};
+    for (size_t i = 0; i < 4; ++i) {
+        checker_fwd.set_rng(i, &rng);
+        checker_bwd.set_rng(i, &rng);
+    }
+    checker_bwd.set_rng(4, &rng_rstd);
+    auto run = [&](const TensorShape& shape, uint32_t group, bool affine) {
+        TensorShape c{shape[1]}, ng{shape[0], group};
+        param::GroupNorm param{affine, 1e-5f, group};
+        checker_fwd.set_param(param).execs({shape, c, c, {}, {}, {}});
+        checker_bwd.set_param(param).execs({shape, shape, c, ng, ng, shape, c, c});
+    };
+    // mean and rstd are always float32
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-3f}, {dtype::Float16(), 5e-2f}}) {
+        for (size_t i = 0; i < 4; ++i) {
+            checker_fwd.set_dtype(i, dtype_eps.first);
+        }
+        for (size_t i : {0, 1, 2, 5, 6, 7}) {
+            checker_bwd.set_dtype(i, dtype_eps.first);
+        }
+        checker_fwd.set_epsilon(dtype_eps.second);
+        checker_bwd.set_epsilon(dtype_eps.second);
+        for (auto&& arg : group_norm::get_args()) {
+            run(arg.shape, arg.param.group, arg.param.affine);
+        }
+        for (bool affine : {true, false}) {
+            // a warp handles a group of at most 1024 elements, and larger
+            // groups are handled by a block each
+            run({3, 4, 4, 128}, 2, affine);
+            run({3, 4, 4, 129}, 2, affine);
+            run({5, 6, 1, 1}, 6, affine);
+            // dweight and dbias are reduced by 256 threads for each channel
+            run({3, 8, 9, 29}, 4, affine);
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
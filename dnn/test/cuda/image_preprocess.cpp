@@ -0,0 +1,23 @@
+/**
+ * \file dnn/test/cuda/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/image_preprocess.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, IMAGE_PREPROCESS) {
+    image_preprocess::run_test(handle_cuda());
+}
+
+// vim: syntax=cpp.doxygen
@@ -149,6 +149,38 @@ TEST_F(CUDA, INDEXING_INCR_MULTI_AXIS_VEC) {
     checker.set_proxy({{1}}).execs({{5, 8, 3}, {5, 2, 3}, {2}});
 }
 
+TEST_F(CUDA, INDEXING_INCR_MULTI_AXIS_VEC_DETERMINISTIC) {
+    Checker<IndexingIncrMultiAxisVec> checker(handle_cuda());
+    checker.opr()->set_deterministic(true);
+    size_t idx_size0, idx_size1;
+    OrderedRNG rng_inp;
+    IndexRNG rng0{idx_size0, 2}, rng1{idx_size1, 3};
+    checker.set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Int32())
+            .set_dtype(3, dtype::Int32())
+            .set_rng(0, &rng_inp)
+            .set_rng(1, &rng_inp)
+            .set_rng(2, &rng0)
+            .set_rng(3, &rng1);
+
+    idx_size0 = 1000;
+    checker.set_proxy({{0}}).execs({{1000, 64}, {300, 64}, {300}});
+    idx_size0 = 4;
+    idx_size1 = 6;
+    checker.set_proxy({{1, 3}}).execs({{3, 4, 5, 6}, {7, 3, 5}, {7}, {7}});
+
+    // int8 has no atomicAdd, so it always takes the deterministic path
+    UniformIntRNG rng_i8{-3, 3};
+    idx_size0 = 23;
+    checker.set_dtype(0, dtype::Int8())
+            .set_dtype(1, dtype::Int8())
+            .set_rng(0, &rng_i8)
+            .set_rng(1, &rng_i8)
+            .set_proxy({{0}})
+            .execs({{23, 5}, {100, 5}, {100}});
+}
+
 TEST_F(CUDA, INDEXING_SET_MULTI_AXIS_VEC) {
     Checker<IndexingSetMultiAxisVec> checker(handle_cuda());
     OrderedRNG rng;
@@ -0,0 +1,85 @@
+/**
+ * \file dnn/test/cuda/layer_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/layer_norm.h"
+#include "test/cuda/benchmark.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, LAYER_NORM) {
+    Checker<LayerNormForward> checker_fwd(handle_cuda());
+    Checker<LayerNormBackward> checker_bwd(handle_cuda());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_rstd{0.5f, 2.f};
+    for (size_t i = 0; i < 4; ++i) {
+        checker_fwd.set_rng(i, &rng);
+        checker_bwd.set_rng(i, &rng);
+    }
+    checker_bwd.set_rng(4, &rng_rstd);
+    auto run = [&](const layer_norm::TestArg& arg) {
+        auto&& s = arg.shape;
+        auto&& ns = arg.normalized_shape;
+        auto&& us = arg.unnormalized_shape;
+        checker_fwd.set_param(arg.param).execs({s, ns, ns, {}, {}, {}});
+        checker_bwd.set_param(arg.param).execs({s, s, ns, us, us, s, ns, ns});
+    };
+    // mean and rstd are always float32
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-3f}, {dtype::Float16(), 5e-2f}}) {
+        for (size_t i = 0; i < 4; ++i) {
+            checker_fwd.set_dtype(i, dtype_eps.first);
+        }
+        for (size_t i : {0, 1, 2, 5, 6, 7}) {
+            checker_bwd.set_dtype(i, dtype_eps.first);
+        }
+        checker_fwd.set_epsilon(dtype_eps.second);
+        checker_bwd.set_epsilon(dtype_eps.second);
+        for (auto&& arg : layer_norm::get_args()) {
+            run(arg);
+        }
+        for (bool affine : {true, false}) {
+            // a warp handles a row of at most 1024 elements, and longer rows
+            // are handled by a block each
+            for (size_t len : {31, 33, 1024, 1025}) {
+                run(layer_norm::make_arg({7, len}, 1, affine));
+            }
+            // dweight and dbias are reduced in chunks of at least 32 rows,
+            // and in blocks of 32 columns
+            run(layer_norm::make_arg({33, 47}, 1, affine));
+            run(layer_norm::make_arg({3000, 65}, 1, affine));
+        }
+    }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(CUDA, BENCHMARK_LAYER_NORM) {
+    CUBenchmarker<LayerNormForward> benchmarker(handle_cuda());
+    constexpr size_t RUNS = 20;
+    benchmarker.set_times(RUNS);
+    benchmarker.set_dtype(4, dtype::Float32()).set_dtype(5, dtype::Float32());
+    // activations of transformers: (batch * seq, hidden)
+    for (size_t hidden : {256, 768, 1024, 4096}) {
+        size_t rows = 16384;
+        benchmarker.set_param(param::LayerNorm{true, 1e-5f, 1, hidden});
+        auto time_ms =
+                benchmarker.execs({{rows, hidden}, {hidden}, {hidden}, {}, {}, {}}) /
+                RUNS;
+        double bytes = rows * hidden * sizeof(float) * 2;
+        printf("(%zu, %zu): %.3fms %.2fGB/s\n", rows, hidden, time_ms,
+               bytes / time_ms * 1e-6);
+    }
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -51,6 +51,13 @@ TEST_F(CUDA, REDUCE) {
     checker.execs({{3, 64 * 64 + 1, 7}, {}});
     checker.execs({{3, 32 * 32 + 1, 15}, {}});
     checker.execs({{3, 512, 500}, {}});
+    // short reduce axis with many outputs (serial reduction per thread)
+    checker.execs({{1000, 4, 64}, {}});
+    checker.execs({{64, 300, 1024}, {}});
+    checker.execs({{3, 7, 5}, {}});
+    // long contiguous rows (one block per row)
+    checker.execs({{128, 65536 + 3, 1}, {}});
+    checker.execs({{4, 10000, 1}, {}});
     // very large reduce
     checker.execs({{1, 4194304, 1}, {}});
 
@@ -10,6 +10,7 @@
  */
 #include "test/naive/rng.h"
 #include "megdnn/oprs.h"
+#include "src/common/philox.cuh"
 #include "test/common/tensor.h"
 #include "test/cuda/fixture.h"
 
@@ -204,6 +205,21 @@ TEST_F(CUDA, UNIFORM_RNG_F32) {
     assert_uniform_correct(t.ptr_mutable_host(), t.layout().total_nr_elems());
 }
 
+TEST_F(CUDA, UNIFORM_RNG_PHILOX_STREAM) {
+    // the same elements as the fallback impl, for a partial last block too
+    auto opr = handle_cuda()->create_operator<UniformRNG>();
+    opr->param().seed = 42;
+    size_t size = 4099;
+    SyncedTensor<> t(handle_cuda(), {TensorShape{size}, dtype::Float32()});
+    opr->exec(t.tensornd_dev(), {});
+    auto ptr = t.ptr_mutable_host();
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t words[4];
+        philox::generate(42, i / 4, words);
+        ASSERT_EQ(philox::to_uniform(words[i % 4]), ptr[i]) << "i=" << i;
+    }
+}
+
 TEST_F(CUDA, GAUSSIAN_RNG_F32) {
     auto opr = handle_cuda()->create_operator<GaussianRNG>();
     opr->param().mean = 0.8;
@@ -0,0 +1,78 @@
+/**
+ * \file dnn/test/cuda/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/softmax.h"
+#include "test/cuda/benchmark.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, SOFTMAX) {
+    Checker<SoftmaxForward> checker_fwd(handle_cuda());
+    Checker<SoftmaxBackward> checker_bwd(handle_cuda());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_y{0.f, 1.f};
+    checker_fwd.set_rng(0, &rng);
+    checker_bwd.set_rng(0, &rng_y).set_rng(1, &rng);
+    auto run = [&](const TensorShape& shape, int axis) {
+        checker_fwd.set_param({axis}).execs({shape, {}});
+        checker_bwd.set_param({axis}).execs({shape, shape, shape});
+    };
+    auto set_dtype = [&](DType dtype, float epsilon) {
+        checker_fwd.set_dtype(0, dtype).set_dtype(1, dtype).set_epsilon(epsilon);
+        for (size_t i = 0; i < 3; ++i) {
+            checker_bwd.set_dtype(i, dtype);
+        }
+        checker_bwd.set_epsilon(epsilon);
+    };
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-4f}, {dtype::Float16(), 1e-2f}}) {
+        set_dtype(dtype_eps.first, dtype_eps.second);
+        for (auto&& arg : softmax::get_args()) {
+            run(arg.shape, arg.param.axis);
+        }
+        // a warp handles a row of at most 1024 elements, and 4 rows are
+        // processed by a block
+        for (size_t B : {31, 32, 33, 1024}) {
+            run({7, B}, -1);
+        }
+        // longer rows are handled by a block each
+        run({3, 1025}, -1);
+        run({2, 50000}, -1);
+        // one thread for each column if axis is not the last one
+        run({3, 1100, 5}, 1);
+    }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(CUDA, BENCHMARK_SOFTMAX) {
+    CUBenchmarker<SoftmaxForward> benchmarker(handle_cuda());
+    constexpr size_t RUNS = 20;
+    benchmarker.set_times(RUNS);
+    auto run = [&](const TensorShape& shape, int axis) {
+        benchmarker.set_param(param::Softmax{axis});
+        auto time_ms = benchmarker.execs({shape, {}}) / RUNS;
+        double bytes = shape.total_nr_elems() * sizeof(float) * 2;
+        printf("%s axis=%d: %.3fms %.2fGB/s\n", shape.to_string().c_str(), axis,
+               time_ms, bytes / time_ms * 1e-6);
+    };
+    // attention scores: (batch * heads, seq, seq)
+    for (size_t seq : {64, 128, 384, 512, 2048}) {
+        run({96, seq, seq}, -1);
+    }
+    run({32, 1000, 49}, 1);
+    run({8, 1, 1000000}, -1);
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,49 @@
+/**
+ * \file dnn/test/cuda/weight_quant_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(CUDA, WEIGHT_QUANT_MATRIX_MUL) {
+    Checker<WeightQuantMatrixMulForward> checker(handle_cuda());
+    UniformFloatRNG src_rng{-1.f, 1.f}, scale_rng{1e-3f, 1e-2f};
+    UniformIntRNG weight_rng{-128, 127};
+    checker.set_dtype(1, dtype::Int8()).set_dtype(2, dtype::Float32());
+    checker.set_rng(0, &src_rng).set_rng(1, &weight_rng).set_rng(2, &scale_rng);
+    auto run = [&](uint32_t bits, size_t M, size_t K, size_t N) {
+        size_t row_bytes = bits == 8 ? K : (K + 1) / 2;
+        checker.set_param({bits}).execs({{M, K}, {N, row_bytes}, {N}, {}});
+    };
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-4f}, {dtype::Float16(), 1e-2f}}) {
+        checker.set_dtype(0, dtype_eps.first).set_dtype(3, dtype_eps.first);
+        checker.set_epsilon(dtype_eps.second);
+        for (uint32_t bits : {8, 4}) {
+            // a warp for each output channel and 4 warps per block; the
+            // lanes stride over K, or over the bytes of 4-bit weights, so odd
+            // K leaves the upper half of the last byte unused
+            for (size_t M : {1, 3, 33}) {
+                for (size_t N : {1, 3, 4, 5, 100}) {
+                    for (size_t K : {1, 7, 31, 32, 33, 64, 65, 255}) {
+                        run(bits, M, K, N);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,54 @@
+/**
+ * \file dnn/test/fallback/argsort.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+void run_forward_test(Handle* handle, DType dtype) {
+    using Order = Argsort::Param::Order;
+    Checker<ArgsortForward> checker(handle);
+    // small range to produce ties, which must be ordered as naive impl
+    UniformIntRNG rng{-1000, 1000};
+    checker.set_dtype(0, dtype).set_rng(0, &rng);
+    checker.set_dtype(2, dtype::Int32());
+    for (auto order : {Order::ASCENDING, Order::DESCENDING}) {
+        Argsort::Param param;
+        param.order = order;
+        checker.set_param(param);
+        for (size_t n : {1, 7, 1023, 4097}) {
+            checker.execs({{1, n}, {}, {}});
+            checker.execs({{13, n}, {}, {}});
+        }
+        // rows split into segments
+        checker.execs({{1, 100003}, {}, {}});
+        checker.execs({{3, 65536}, {}, {}});
+    }
+}
+}  // anonymous namespace
+
+TEST_F(FALLBACK, ARGSORT_FORWARD) {
+    run_forward_test(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ARGSORT_FORWARD_F32) {
+    run_forward_test(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ARGSORT_FORWARD_I32) {
+    run_forward_test(handle(), dtype::Int32());
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,99 @@
+/**
+ * \file dnn/test/fallback/block_sparse_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/block_sparse_matrix_mul.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+using block_sparse_matrix_mul::make_arg;
+using block_sparse_matrix_mul::Mode;
+using block_sparse_matrix_mul::TestArg;
+
+void run(Checker<BlockSparseMatrixMulForward>& checker, const TestArg& arg) {
+    checker.set_param(arg.param)
+            .set_tensors_constraint(block_sparse_matrix_mul::make_constraint(arg))
+            .execs({arg.values, arg.col_idx, arg.row_ptr, arg.src, {}});
+}
+
+void set_rng(Checker<BlockSparseMatrixMulForward>& checker, RNG* rng) {
+    checker.set_dtype(1, dtype::Int32())
+            .set_dtype(2, dtype::Int32())
+            .set_rng(0, rng)
+            .set_rng(3, rng);
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, BLOCK_SPARSE_MATRIX_MUL) {
+    Checker<BlockSparseMatrixMulForward> checker(handle());
+    UniformFloatRNG rng{-1.f, 1.f};
+    set_rng(checker, &rng);
+    checker.set_epsilon(1e-4);
+    for (auto&& arg : block_sparse_matrix_mul::get_args()) {
+        run(checker, arg);
+    }
+    for (auto mode : {Mode::SPARSE_DENSE, Mode::DENSE_SPARSE_T}) {
+        // all the blocks are present
+        run(checker, make_arg(mode, 4, 4, 16, 16, 16, 0, 9));
+        // a single column or row of src
+        run(checker, make_arg(mode, 2, 4, 8, 32, 10, 2, 1));
+        // blocks spanning the whole width of A
+        run(checker, make_arg(mode, 1, 24, 5, 24, 5, 0, 3));
+    }
+
+    // zeros in the blocks are skipped by the SPARSE_DENSE kernel, which must
+    // not change the result
+    for (auto mode : {Mode::SPARSE_DENSE, Mode::DENSE_SPARSE_T}) {
+        auto arg = make_arg(mode, 4, 4, 32, 64, 40, 0, 33);
+        auto constraint = block_sparse_matrix_mul::make_constraint(arg);
+        checker.set_param(arg.param)
+                .set_tensors_constraint(
+                        [constraint](CheckerHelper::TensorValueArray& tensors) {
+                            constraint(tensors);
+                            auto values = tensors[0].ptr<dt_float32>();
+                            for (size_t i = 0; i < tensors[0].layout.total_nr_elems();
+                                 i += 3) {
+                                values[i] = 0.f;
+                            }
+                        })
+                .execs({arg.values, arg.col_idx, arg.row_ptr, arg.src, {}});
+    }
+
+    // other dtypes are forwarded to the naive impl
+    for (size_t i : {0, 3, 4}) {
+        checker.set_dtype(i, dtype::Float16());
+    }
+    checker.set_epsilon(1e-2);
+    run(checker, make_arg(Mode::SPARSE_DENSE, 1, 4, 8, 16, 5, 2, 7));
+    run(checker, make_arg(Mode::DENSE_SPARSE_T, 1, 4, 8, 16, 5, 2, 7));
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BLOCK_SPARSE_MATRIX_MUL) {
+    Checker<BlockSparseMatrixMulForward> checker(handle());
+    UniformFloatRNG rng{-1.f, 1.f};
+    set_rng(checker, &rng);
+    checker.set_epsilon(1e-4);
+    // a task for each row block of a batch in SPARSE_DENSE mode, and for each
+    // row of src in DENSE_SPARSE_T mode
+    for (auto mode : {Mode::SPARSE_DENSE, Mode::DENSE_SPARSE_T}) {
+        run(checker, make_arg(mode, 1, 4, 64, 128, 300, 3, 49));
+        run(checker, make_arg(mode, 8, 1, 64, 16, 100, 5, 7));
+        run(checker, make_arg(mode, 2, 2, 6, 6, 5, 0, 3));
+    }
+}
+
+// vim: syntax=cpp.doxygen
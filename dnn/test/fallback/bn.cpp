@@ -0,0 +1,132 @@
+/**
+ * \file dnn/test/fallback/bn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/bn.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_bn_forward_backward(Handle* handle) {
+    using namespace batch_normalization;
+    std::vector<TestArg> args = get_args();
+    {
+        // enough rows to be split among threads
+        param::BN param;
+        param.fwd_mode = param::BN::FwdMode::TRAINING;
+        param.param_dim = param::BN::ParamDim::DIM_111C;
+        args.emplace_back(
+                param, TensorShape{8, 32, 32, 16}, TensorShape{1, 1, 1, 16},
+                dtype::Float32());
+        param.param_dim = param::BN::ParamDim::DIM_1C11;
+        args.emplace_back(
+                param, TensorShape{16, 2, 64, 64}, TensorShape{1, 2, 1, 1},
+                dtype::Float32());
+        param.fwd_mode = param::BN::FwdMode::INFERENCE;
+        args.emplace_back(
+                param, TensorShape{4, 5, 7, 9}, TensorShape{1, 5, 1, 1},
+                dtype::Float32());
+        // fused relu, with a number of elements not a multiple of 8
+        param.nonlineMode = param::BN::NonlineMode::RELU;
+        args.emplace_back(
+                param, TensorShape{4, 5, 7, 9}, TensorShape{1, 5, 1, 1},
+                dtype::Float32());
+        param.fwd_mode = param::BN::FwdMode::TRAINING;
+        args.emplace_back(
+                param, TensorShape{3, 5, 7, 9}, TensorShape{1, 5, 1, 1},
+                dtype::Float32());
+        args.emplace_back(
+                param, TensorShape{3, 5, 7, 9}, TensorShape{1, 5, 1, 1},
+                dtype::Float16());
+        param.param_dim = param::BN::ParamDim::DIM_111C;
+        args.emplace_back(
+                param, TensorShape{8, 32, 32, 16}, TensorShape{1, 1, 1, 16},
+                dtype::Float32());
+    }
+    Checker<BNForward> checker(handle);
+    Checker<BNBackward> checker_bwd(handle);
+    // the running variance is an input of inference
+    UniformFloatRNG var_rng(0.5f, 2.f);
+    checker.set_rng(4, &var_rng);
+    for (auto&& arg : args) {
+        auto opr = handle->create_operator<BNForward>();
+        opr->param() = arg.param;
+        size_t reserve = opr->get_reserve_in_bytes({arg.src, arg.dtype});
+
+        // Forward
+        for (int i = 0; i < 9; ++i) {
+            checker.set_dtype(i, dtype::Float32());
+        }
+        checker.set_dtype(0, arg.dtype);
+        checker.set_dtype(7, dtype::Byte());
+        checker.set_dtype(8, arg.dtype);
+        checker.set_bypass(7);
+        checker.set_epsilon(1e-3).set_param(arg.param);
+        bool inference = arg.param.fwd_mode == param::BN::FwdMode::INFERENCE;
+        for (bool need_statistic : {false, true}) {
+            if (inference && !need_statistic)
+                continue;
+            checker.exec({
+                    arg.src,
+                    arg.param_shape,                                      // bn_scale
+                    arg.param_shape,                                      // bn_bias
+                    need_statistic ? arg.param_shape : TensorShape({0}),  // mean
+                    need_statistic ? arg.param_shape : TensorShape({0}),  // variance
+                    arg.param_shape,                                      // batch_mean
+                    arg.param_shape,  // batch_inv_variance
+                    {reserve},        // reserve
+                    arg.src           // dst
+            });
+        }
+        if (inference)
+            continue;
+
+        // Backward
+        for (int i = 0; i < 9; ++i) {
+            checker_bwd.set_dtype(i, dtype::Float32());
+        }
+        checker_bwd
+                .set_dtype(0, arg.dtype)      // x
+                .set_dtype(1, arg.dtype)      // dy
+                .set_dtype(5, dtype::Byte())  // reserve
+                .set_dtype(8, arg.dtype)      // dx
+                .set_bypass(5);
+        checker_bwd.set_epsilon(1e-3).set_param(arg.param).exec(
+                {arg.src,
+                 arg.src,
+                 arg.param_shape,
+                 arg.param_shape,
+                 arg.param_shape,
+                 {reserve},
+                 arg.param_shape,
+                 arg.param_shape,
+                 arg.src});
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, BN_FORWARD_BACKWARD) {
+    run_bn_forward_backward(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BN_FORWARD_BACKWARD) {
+    run_bn_forward_backward(handle());
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
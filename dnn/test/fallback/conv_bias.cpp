@@ -18,6 +18,8 @@
 #include "test/common/tensor.h"
 #include "test/fallback/fixture.h"
 
+#include "src/fallback/cpu_cache_info.h"
+
 #if MEGDNN_X86
 #include "src/x86/utils.h"
 #endif
@@ -232,6 +234,50 @@ TEST_F(FALLBACK_MULTI_THREADS, CONV_BIAS_FORWARD_QUANTIZED) {
             dtype::QuantizedS8(60.25f), "FALLBACK_NAIVE");
 }
 
+TEST_F(FALLBACK, CONV_BIAS_CACHE_COST_MODEL) {
+    auto&& detected = fallback::CpuCacheInfo::inst();
+    ASSERT_GT(detected.l1d_size, 0u);
+    ASSERT_GT(detected.l2_size, 0u);
+
+    fallback::CpuCacheInfo cache;
+    cache.l2_size = 256 * 1024;
+    cache.l3_size = 0;
+    //! the im2col blocks of a 3x3 conv from 64 to 64 channels on 56x56
+    auto cost_of = [&](size_t ohw_tile_size) {
+        fallback::CpuCacheInfo::GemmBlocks blocks;
+        blocks.nr_blocks = div_ceil<size_t>(56 * 56, ohw_tile_size);
+        blocks.nr_threads = 1;
+        blocks.m = 64;
+        blocks.n = ohw_tile_size;
+        blocks.k = 64 * 3 * 3;
+        blocks.inner_m = 8;
+        blocks.nr_b_copies = 2;
+        blocks.src_size = blocks.acc_size = sizeof(float);
+        return cache.estimate_ns(blocks);
+    };
+    //! the packed buffers of 192 columns exceed L2, which are loaded again
+    //! for every 8 rows
+    ASSERT_LT(cost_of(96), cost_of(192));
+    //! the small blocks pay for the dispatch
+    ASSERT_LT(cost_of(96), cost_of(24));
+
+    //! only the blocks out of L2 are slowed down
+    float cost_192 = cost_of(192), cost_96 = cost_of(96);
+    cache.l2_size = 8 * 1024 * 1024;
+    ASSERT_LT(cost_of(192), cost_192);
+    ASSERT_EQ(cost_of(96), cost_96);
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, CONV_BIAS_FORWARD_HEURISTIC_BLOCKS) {
+    //! the heuristic chooses among the im2col block sizes by the cache sizes
+    Checker<ConvBiasForward> checker(handle());
+    param::ConvBias param;
+    param.pad_h = param.pad_w = 1;
+    checker.set_param(param)
+            .set_epsilon(1e-3)
+            .execs({{1, 64, 56, 56}, {64, 64, 3, 3}, {1, 64, 1, 1}, {}, {}});
+}
+
 #if MEGDNN_WITH_BENCHMARK
 TEST_F(FALLBACK, BENCHMARK_CONVBIAS) {
     constexpr size_t RUNS = 10;
@@ -649,4 +649,98 @@ TEST_F(FALLBACK, CONVOLUTION_BACKWARD_DATA_NAIVE_ALGO) {
     }
 }
 
+TEST_F(FALLBACK_MULTI_THREADS, CONVOLUTION_BACKWARD_DATA) {
+    Checker<ConvolutionBackwardData> checker(handle());
+    using Param = ConvolutionBackwardData::Param;
+
+    Param param;
+    auto run = [&](size_t n, size_t ic, size_t oh, size_t ow, size_t oc, size_t fh,
+                   size_t fw, size_t stride, size_t padding, size_t dilate = 1,
+                   size_t group = 1) {
+        param.pad_h = param.pad_w = padding;
+        param.stride_h = param.stride_w = stride;
+        param.dilate_h = param.dilate_w = dilate;
+
+        TensorLayout diff = TensorLayout{{n, oc * group, oh, ow}, dtype::Float32()};
+        TensorLayout grad;
+        TensorLayout filter;
+        if (group == 1) {
+            param.sparse = Param::Sparse::DENSE;
+            filter = {{oc, ic, fh, fw}, dtype::Float32()};
+        } else {
+            param.sparse = Param::Sparse::GROUP;
+            filter = {{group, oc, ic, fh, fw}, dtype::Float32()};
+        }
+        {
+            auto opr = handle()->create_operator<ConvolutionBackwardData>();
+            opr->param() = param;
+            opr->deduce_layout(filter, diff, grad);
+        }
+        checker.set_param(param);
+        checker.exec(TensorLayoutArray{filter, diff, grad});
+    };
+
+    for (auto mode : {Param::Mode::CONVOLUTION, Param::Mode::CROSS_CORRELATION}) {
+        param.mode = mode;
+        run(4, 3, 10, 13, 5, 1, 1, 1, 0, 1, 1);
+        run(5, 5, 24, 43, 11, 9, 3, 3, 12, 1, 2);
+        run(1, 3, 10, 45, 2, 1, 1, 1, 0, 4, 3);
+        run(7, 4, 17, 32, 2, 3, 2, 5, 4, 4, 3);
+        run(2, 3, 20, 33, 3, 5, 7, 4, 15, 2, 3);
+    }
+}
+
+namespace {
+void run_conv_backward_filter(Handle* handle) {
+    Checker<ConvolutionBackwardFilter> checker(handle);
+    using Param = ConvolutionBackwardFilter::Param;
+
+    Param param;
+    auto run = [&](size_t n, size_t ic, size_t ih, size_t iw, size_t oc, size_t fh,
+                   size_t fw, size_t stride, size_t padding, size_t dilate = 1,
+                   size_t group = 1) {
+        param.pad_h = param.pad_w = padding;
+        param.stride_h = param.stride_w = stride;
+        param.dilate_h = param.dilate_w = dilate;
+        param.sparse = group == 1 ? Param::Sparse::DENSE : Param::Sparse::GROUP;
+
+        TensorLayout src{{n, ic * group, ih, iw}, dtype::Float32()}, diff, grad;
+        if (group == 1) {
+            grad = {{oc, ic, fh, fw}, dtype::Float32()};
+        } else {
+            grad = {{group, oc, ic, fh, fw}, dtype::Float32()};
+        }
+        {
+            auto opr = handle->create_operator<Convolution>();
+            opr->param() = param;
+            opr->deduce_layout(src, grad, diff);
+        }
+        float scale = 1.0f / sqrt(diff[2] * diff[3]);
+        UniformFloatRNG rng(scale, 2 * scale);
+        checker.set_rng(0, &rng)
+                .set_rng(1, &rng)
+                .set_epsilon(1e-3)
+                .set_param(param)
+                .exec(TensorLayoutArray{src, diff, grad});
+    };
+
+    for (auto mode : {Param::Mode::CONVOLUTION, Param::Mode::CROSS_CORRELATION}) {
+        param.mode = mode;
+        run(4, 3, 10, 13, 5, 1, 1, 1, 0);
+        run(5, 5, 24, 43, 11, 3, 3, 2, 1);
+        run(1, 3, 10, 45, 2, 3, 1, 1, 2, 1, 3);
+        run(7, 4, 17, 32, 2, 3, 2, 3, 0, 1, 2);
+        run(2, 3, 20, 33, 3, 5, 7, 2, 3, 2, 3);
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, CONVOLUTION_BACKWARD_FILTER) {
+    run_conv_backward_filter(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, CONVOLUTION_BACKWARD_FILTER) {
+    run_conv_backward_filter(handle());
+}
+
 // vim: syntax=cpp.doxygen
@@ -0,0 +1,46 @@
+/**
+ * \file dnn/test/fallback/cumsum.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+void run_cumsum_test(Handle* handle) {
+    Checker<Cumsum> checker(handle);
+    checker.set_epsilon(1e-2);
+    for (auto shape : TensorShapeArray{
+                 {1}, {10000}, {100003}, {33000, 33}, {3, 50000}, {100, 100, 100}}) {
+        for (size_t axis = 0; axis < shape.ndim; ++axis) {
+            for (bool exclusive : {true, false}) {
+                for (bool reverse : {true, false}) {
+                    checker.set_param(param::Cumsum(axis, exclusive, reverse));
+                    checker.set_dtype(0, dtype::Float32()).execs({shape, {}});
+                    checker.set_dtype(0, dtype::Int32()).execs({shape, {}});
+                }
+            }
+        }
+    }
+}
+}  // anonymous namespace
+
+TEST_F(FALLBACK, CUMSUM) {
+    run_cumsum_test(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, CUMSUM) {
+    run_cumsum_test(handle());
+}
+
+// vim: syntax=cpp.doxygen
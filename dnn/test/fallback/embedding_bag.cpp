@@ -0,0 +1,121 @@
+/**
+ * \file dnn/test/fallback/embedding_bag.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/embedding_bag.h"
+#include "test/common/rng.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+using embedding_bag::Mode;
+
+class EmbeddingBagChecker {
+    Checker<EmbeddingBagForward> m_checker;
+    UniformFloatRNG m_float_rng{-1.f, 1.f};
+    UniformIntRNG m_int_rng{0, 255};
+    DType m_dtype;
+
+public:
+    EmbeddingBagChecker(Handle* handle, DType dtype, float epsilon)
+            : m_checker(handle), m_dtype(dtype) {
+        bool quant = dtype == dtype::Uint8();
+        m_checker.set_dtype(0, dtype)
+                .set_dtype(1, dtype::Int32())
+                .set_dtype(2, dtype::Int32())
+                .set_dtype(3, dtype::Float32())
+                .set_rng(0, quant ? static_cast<RNG*>(&m_int_rng) : &m_float_rng)
+                .set_epsilon(epsilon);
+    }
+
+    size_t row_size(size_t D) const {
+        return m_dtype == dtype::Uint8()
+                     ? D + EmbeddingBag::QUANT_ROW_EXTRA_BYTES
+                     : D;
+    }
+
+    //! \p fixup modifies the random indices and offsets
+    void run(
+            Mode mode, size_t N, size_t D, size_t L, size_t B,
+            thin_function<void(dt_int32*, dt_int32*)> fixup = {}) {
+        auto constraint = embedding_bag::make_constraint(N);
+        m_checker.set_param({mode})
+                .set_tensors_constraint(
+                        [constraint, fixup](CheckerHelper::TensorValueArray& tensors) {
+                            constraint(tensors);
+                            if (fixup) {
+                                fixup(tensors[1].ptr<dt_int32>(),
+                                      tensors[2].ptr<dt_int32>());
+                            }
+                        })
+                .execs({{N, row_size(D)}, {L}, {B}, {}});
+    }
+};
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, EMBEDDING_BAG) {
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-4f},
+                 {dtype::Float16(), 1e-3f},
+                 {dtype::Uint8(), 1e-3f}}) {
+        EmbeddingBagChecker checker(handle(), dtype_eps.first, dtype_eps.second);
+        for (auto mode : {Mode::SUM, Mode::MEAN}) {
+            for (size_t N : {1, 100, 5000}) {
+                // rows of 3 bytes make the scale and bias of quantized rows
+                // unaligned, and rows of 200 floats are longer than the 8
+                // cache lines prefetched
+                for (size_t D : {1, 3, 16, 67, 200}) {
+                    for (auto&& lb : std::vector<std::pair<size_t, size_t>>{
+                                 {1, 1}, {10, 3}, {500, 37}, {2000, 128}}) {
+                        checker.run(mode, N, D, lb.first, lb.second);
+                    }
+                }
+            }
+            // bags shorter than the distance of 8 lookups prefetched ahead
+            checker.run(mode, 100, 16, 7, 7);
+            // all the lookups are in the last bag, so the MEAN of the other
+            // bags is zero
+            checker.run(mode, 100, 16, 50, 9, [](dt_int32*, dt_int32* offsets) {
+                std::fill(offsets, offsets + 9, 0);
+            });
+            // a row looked up by every index
+            checker.run(mode, 100, 67, 300, 10, [](dt_int32* indices, dt_int32*) {
+                std::fill(indices, indices + 300, 99);
+            });
+        }
+    }
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, EMBEDDING_BAG) {
+    // the bags are split into 4 tasks per thread, which may not divide them
+    // evenly
+    for (auto&& dtype_eps : std::vector<std::pair<DType, float>>{
+                 {dtype::Float32(), 1e-4f}, {dtype::Uint8(), 1e-3f}}) {
+        EmbeddingBagChecker checker(handle(), dtype_eps.first, dtype_eps.second);
+        for (auto mode : {Mode::SUM, Mode::MEAN}) {
+            checker.run(mode, 5000, 67, 2000, 129);
+            checker.run(mode, 100, 16, 10, 3);
+            // a bag much longer than the others
+            checker.run(mode, 1000, 32, 3000, 64, [](dt_int32*, dt_int32* offsets) {
+                for (size_t b = 1; b < 64; ++b) {
+                    offsets[b] = 2900 + b;
+                }
+            });
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
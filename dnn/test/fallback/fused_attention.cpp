@@ -0,0 +1,85 @@
+/**
+ * \file dnn/test/fallback/fused_attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include <cmath>
+
+#include "test/common/checker.h"
+#include "test/common/fused_attention.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+void run(
+        Checker<FusedAttentionForward>& checker, size_t B, size_t S, size_t T,
+        size_t D, size_t Dv, float scale) {
+    checker.set_param({scale}).execs({{B, S, D}, {B, T, D}, {B, T, Dv}, {}});
+}
+
+void run(
+        Checker<FusedAttentionForward>& checker, size_t B, size_t S, size_t T,
+        size_t D, size_t Dv) {
+    run(checker, B, S, T, D, Dv, 1.f / std::sqrt(static_cast<float>(D)));
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, FUSED_ATTENTION) {
+    Checker<FusedAttentionForward> checker(handle());
+    UniformFloatRNG rng{-2.f, 2.f};
+    for (size_t i = 0; i < 3; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_epsilon(1e-4);
+    for (auto&& arg : fused_attention::get_args()) {
+        checker.set_param(arg.param).execs({arg.query, arg.key, arg.value, {}});
+    }
+    // tasks of 16 query rows, each iterating over tiles of 64 keys
+    for (size_t S : {15, 16, 17}) {
+        for (size_t T : {63, 64, 65, 129}) {
+            run(checker, 2, S, T, 9, 7);
+        }
+    }
+    // the partial results are rescaled when a later tile has a larger max,
+    // and the scores overflow exp unless the running max is subtracted
+    UniformFloatRNG rng_large{-3.f, 3.f};
+    checker.set_rng(0, &rng_large).set_rng(1, &rng_large);
+    run(checker, 2, 20, 200, 64, 33, 1.f);
+    // all the keys have the same weight
+    run(checker, 1, 5, 70, 8, 16, 0.f);
+
+    // other dtypes are forwarded to the naive impl
+    checker.set_rng(0, &rng).set_rng(1, &rng);
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_dtype(i, dtype::Float16());
+    }
+    checker.set_epsilon(1e-2);
+    run(checker, 2, 9, 70, 16, 8);
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, FUSED_ATTENTION) {
+    Checker<FusedAttentionForward> checker(handle());
+    UniformFloatRNG rng{-2.f, 2.f};
+    for (size_t i = 0; i < 3; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_epsilon(1e-4);
+    // a task for each block of query rows of a batch, each using the
+    // workspace of its thread
+    run(checker, 3, 50, 70, 32, 48);
+    run(checker, 1, 100, 130, 64, 64);
+    run(checker, 7, 3, 65, 20, 300);
+}
+
+// vim: syntax=cpp.doxygen
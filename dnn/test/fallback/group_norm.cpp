@@ -0,0 +1,112 @@
+/**
+ * \file dnn/test/fallback/group_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/group_norm.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+void run_fwd(
+        Checker<GroupNormForward>& checker, const TensorShape& shape, uint32_t group,
+        bool affine) {
+    TensorShape c{shape[1]};
+    checker.set_param({affine, 1e-5f, group}).execs({shape, c, c, {}, {}, {}});
+}
+
+void run_bwd(
+        Checker<GroupNormBackward>& checker, const TensorShape& shape, uint32_t group,
+        bool affine) {
+    TensorShape c{shape[1]}, ng{shape[0], group};
+    checker.set_param({affine, 1e-5f, group})
+            .execs({shape, shape, c, ng, ng, shape, c, c});
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, GROUP_NORM_FORWARD) {
+    Checker<GroupNormForward> checker(handle());
+    UniformFloatRNG rng{-10.f, 10.f};
+    for (size_t i = 0; i < 3; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_epsilon(1e-3);
+    for (auto&& arg : group_norm::get_args()) {
+        run_fwd(checker, arg.shape, arg.param.group, arg.param.affine);
+    }
+    for (bool affine : {true, false}) {
+        // a group of each channel, and groups of one element per channel
+        run_fwd(checker, {2, 6, 5, 3}, 6, affine);
+        run_fwd(checker, {3, 8}, 2, affine);
+        // spatial sizes not a multiple of the 8 accumulators
+        run_fwd(checker, {2, 6, 3, 5}, 3, affine);
+        run_fwd(checker, {1, 12, 1, 9}, 4, affine);
+    }
+
+    // the deviations are summed relative to the first element of a group
+    UniformFloatRNG rng_shifted{1000.f, 1002.f};
+    checker.set_rng(0, &rng_shifted);
+    run_fwd(checker, {2, 8, 17, 19}, 4, true);
+
+    // other dtypes are forwarded to the naive impl
+    checker.set_rng(0, &rng);
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_dtype(i, dtype::Float16());
+    }
+    checker.set_epsilon(5e-2);
+    run_fwd(checker, {2, 6, 5, 3}, 3, true);
+}
+
+TEST_F(FALLBACK, GROUP_NORM_BACKWARD) {
+    Checker<GroupNormBackward> checker(handle());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_rstd{0.5f, 2.f};
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_rng(4, &rng_rstd).set_epsilon(1e-3);
+    for (auto&& arg : group_norm::get_args()) {
+        run_bwd(checker, arg.shape, arg.param.group, arg.param.affine);
+    }
+    for (bool affine : {true, false}) {
+        run_bwd(checker, {2, 6, 5, 3}, 6, affine);
+        run_bwd(checker, {3, 8}, 2, affine);
+        run_bwd(checker, {2, 6, 3, 5}, 3, affine);
+        run_bwd(checker, {1, 12, 1, 9}, 4, affine);
+    }
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, GROUP_NORM) {
+    Checker<GroupNormForward> checker_fwd(handle());
+    Checker<GroupNormBackward> checker_bwd(handle());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_rstd{0.5f, 2.f};
+    for (size_t i = 0; i < 4; ++i) {
+        checker_fwd.set_rng(i, &rng);
+        checker_bwd.set_rng(i, &rng);
+    }
+    checker_bwd.set_rng(4, &rng_rstd);
+    checker_fwd.set_epsilon(1e-3);
+    checker_bwd.set_epsilon(1e-3);
+    // the groups are split into tasks of at least 16384 elements, and dweight
+    // and dbias are computed by a task for each channel
+    for (bool affine : {true, false}) {
+        for (auto&& shape_group : std::vector<std::pair<TensorShape, uint32_t>>{
+                     {{4, 64, 17, 17}, 8}, {{1, 4, 100, 100}, 2}, {{3, 10, 33, 7}, 5}}) {
+            run_fwd(checker_fwd, shape_group.first, shape_group.second, affine);
+            run_bwd(checker_bwd, shape_group.first, shape_group.second, affine);
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
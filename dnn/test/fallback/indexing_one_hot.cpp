@@ -0,0 +1,46 @@
+/**
+ * \file dnn/test/fallback/indexing_one_hot.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/common/indexing_one_hot.h"
+#include "test/common/checker.h"
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs/general.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, INDEXING_ONE_HOT) {
+    run_indexing_one_hot_test(handle());
+}
+
+TEST_F(FALLBACK, INDEXING_SET_ONE_HOT) {
+    run_indexing_set_one_hot_test(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_ONE_HOT) {
+    run_indexing_one_hot_test(handle());
+    Checker<IndexingOneHot> checker(handle());
+    UniformIntRNG rng_idx{0, 99};
+    checker.set_dtype(1, dtype::Int32{}).set_rng(1, &rng_idx);
+    // pick one column of each row, such as the logit of labels
+    checker.set_param({1}).execs({{40009, 100}, {40009}, {}});
+    checker.set_param({0}).execs({{100, 40009}, {40009}, {}});
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_SET_ONE_HOT) {
+    run_indexing_set_one_hot_test(handle());
+    Checker<IndexingSetOneHot> checker(handle());
+    UniformIntRNG rng_idx{0, 99};
+    checker.set_dtype(1, dtype::Int32{}).set_rng(1, &rng_idx);
+    checker.set_param({1}).execs({{40009, 100}, {40009}, {40009, 1}});
+}
+
+// vim: syntax=cpp.doxygen
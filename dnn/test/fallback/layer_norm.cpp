@@ -0,0 +1,111 @@
+/**
+ * \file dnn/test/fallback/layer_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/layer_norm.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+void run_fwd(Checker<LayerNormForward>& checker, const layer_norm::TestArg& arg) {
+    auto&& ns = arg.normalized_shape;
+    checker.set_param(arg.param).execs({arg.shape, ns, ns, {}, {}, {}});
+}
+
+void run_bwd(Checker<LayerNormBackward>& checker, const layer_norm::TestArg& arg) {
+    auto&& s = arg.shape;
+    auto&& ns = arg.normalized_shape;
+    auto&& us = arg.unnormalized_shape;
+    checker.set_param(arg.param).execs({s, s, ns, us, us, s, ns, ns});
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, LAYER_NORM_FORWARD) {
+    Checker<LayerNormForward> checker(handle());
+    UniformFloatRNG rng{-10.f, 10.f};
+    for (size_t i = 0; i < 3; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_epsilon(1e-3);
+    for (auto&& arg : layer_norm::get_args()) {
+        run_fwd(checker, arg);
+    }
+    // the reductions use 8 accumulators and a scalar tail
+    for (size_t len : {1, 7, 8, 9, 17, 63}) {
+        for (bool affine : {true, false}) {
+            run_fwd(checker, layer_norm::make_arg({3, len}, 1, affine));
+        }
+    }
+    run_fwd(checker, layer_norm::make_arg({2, 3, 5, 7}, 2, true));
+
+    // the deviations are summed relative to the first element of a row, which
+    // keeps the precision for rows with a large mean
+    UniformFloatRNG rng_shifted{1000.f, 1002.f};
+    checker.set_rng(0, &rng_shifted);
+    run_fwd(checker, layer_norm::make_arg({4, 1001}, 1, true));
+    run_fwd(checker, layer_norm::make_arg({4, 1001}, 1, false));
+
+    // other dtypes are forwarded to the naive impl
+    checker.set_rng(0, &rng);
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_dtype(i, dtype::Float16());
+    }
+    checker.set_epsilon(5e-2);
+    run_fwd(checker, layer_norm::make_arg({5, 33}, 1, true));
+}
+
+TEST_F(FALLBACK, LAYER_NORM_BACKWARD) {
+    Checker<LayerNormBackward> checker(handle());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_rstd{0.5f, 2.f};
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_rng(4, &rng_rstd).set_epsilon(1e-3);
+    for (auto&& arg : layer_norm::get_args()) {
+        run_bwd(checker, arg);
+    }
+    // dweight and dbias are computed in blocks of 64 columns, with a tail
+    for (size_t len : {1, 9, 63, 64, 65, 129}) {
+        for (bool affine : {true, false}) {
+            run_bwd(checker, layer_norm::make_arg({5, len}, 1, affine));
+        }
+    }
+    run_bwd(checker, layer_norm::make_arg({2, 3, 5, 7}, 2, true));
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, LAYER_NORM) {
+    Checker<LayerNormForward> checker_fwd(handle());
+    Checker<LayerNormBackward> checker_bwd(handle());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_rstd{0.5f, 2.f};
+    for (size_t i = 0; i < 4; ++i) {
+        checker_fwd.set_rng(i, &rng);
+        checker_bwd.set_rng(i, &rng);
+    }
+    checker_bwd.set_rng(4, &rng_rstd);
+    checker_fwd.set_epsilon(1e-3);
+    checker_bwd.set_epsilon(1e-3);
+    // the rows are split into tasks of at least 16384 elements, which do not
+    // divide the rows evenly
+    for (auto&& shape : TensorShapeArray{{37, 1000}, {3, 20000}, {65, 300}}) {
+        for (bool affine : {true, false}) {
+            auto arg = layer_norm::make_arg(shape, 1, affine);
+            run_fwd(checker_fwd, arg);
+            run_bwd(checker_bwd, arg);
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -95,10 +95,15 @@ TEST_F(FALLBACK, MATRIX_MUL_NAIVE) {
     }
 }
 
-TEST_F(FALLBACK, BATCHED_MATRIX_MUL) {
-    Checker<BatchedMatrixMul> checker(handle());
+namespace {
+void run_batched_matrix_mul(
+        Handle* handle, const std::vector<matrix_mul::TestArg>& args,
+        const char* algo = nullptr) {
+    Checker<BatchedMatrixMul> checker(handle);
+    if (algo) {
+        checker.set_before_exec_callback(AlgoChecker<BatchedMatrixMul>(algo));
+    }
     using Param = MatrixMul::Param;
-    auto args = matrix_mul::get_batched_matmul_args();
     for (auto arg : args) {
         auto b = arg.b, m = arg.m, n = arg.n, k = arg.k;
         auto mask = arg.mask;
@@ -122,6 +127,35 @@ TEST_F(FALLBACK, BATCHED_MATRIX_MUL) {
         checker.execs({AL, BL, {}});
     }
 }
+
+std::vector<matrix_mul::TestArg> get_small_batched_matmul_args() {
+    std::vector<matrix_mul::TestArg> args;
+    for (size_t mask = 0; mask < 4; ++mask)
+        for (size_t b : {1, 7, 33})
+            for (size_t m : {1, 3, 4, 9, 32})
+                for (size_t n : {1, 5, 16, 31})
+                    for (size_t k : {1, 4, 17})
+                        args.emplace_back(m, n, k, mask, 0, 0, 0, b);
+    return args;
+}
+}  // namespace
+
+TEST_F(FALLBACK, BATCHED_MATRIX_MUL) {
+    run_batched_matrix_mul(handle(), matrix_mul::get_batched_matmul_args());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BATCHED_MATRIX_MUL) {
+    run_batched_matrix_mul(handle(), matrix_mul::get_batched_matmul_args());
+}
+
+TEST_F(FALLBACK, BATCHED_MATRIX_MUL_F32_SMALL) {
+    run_batched_matrix_mul(handle(), get_small_batched_matmul_args(), "F32_SMALL");
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BATCHED_MATRIX_MUL_F32_SMALL) {
+    run_batched_matrix_mul(handle(), get_small_batched_matmul_args(), "F32_SMALL");
+}
+
 }  // namespace test
 }  // namespace megdnn
 
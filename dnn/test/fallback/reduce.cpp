@@ -130,4 +130,26 @@ TEST_F(FALLBACK, REDUCE) {
     }
 }
 
+TEST_F(FALLBACK, REDUCE_TARGET_SHAPE) {
+    using Param = Reduce::Param;
+    using Mode = Param::Mode;
+    using Shapes = std::pair<TensorShape, TensorShape>;
+    Checker<Reduce> checker(handle());
+    for (auto mode :
+         {Mode::SUM, Mode::MEAN, Mode::SUM_SQR, Mode::PRODUCT, Mode::MIN, Mode::MAX})
+        for (auto dtype : std::vector<DType>{
+                     dtype::Float32(), dtype::Int32(), dtype::Int8(), dtype::Uint8()})
+            for (auto&& shapes :
+                 {Shapes{{2, 3, 20, 5}, {1, 3, 1, 1}},
+                  Shapes{{2, 3, 20, 5}, {1, 1, 1, 1}},
+                  Shapes{{2, 3, 20, 5}, {1, 3, 20, 1}}, Shapes{{6, 7}, {1, 7}},
+                  Shapes{{2, 3, 4, 5}, {2, 1, 4, 1}},
+                  Shapes{{2, 3, 4, 5}, {2, 3, 4, 5}}}) {
+                checker.set_dtype(0, dtype)
+                        .set_dtype(1, dtype)
+                        .set_param(Param(mode, Reduce::TARGET_SHAPE_AXIS))
+                        .execs({shapes.first, shapes.second});
+            }
+}
+
 // vim: syntax=cpp.doxygen
@@ -0,0 +1,92 @@
+/**
+ * \file dnn/test/fallback/rng.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include <gtest/gtest.h>
+
+#include "megdnn/oprs.h"
+#include "src/common/philox.cuh"
+#include "test/common/tensor.h"
+#include "test/fallback/fixture.h"
+#include "test/naive/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+
+void run_uniform(Handle* handle) {
+    auto opr = handle->create_operator<UniformRNG>();
+    opr->param().seed = 23;
+    // odd sizes leave a partial block at the end of the stream
+    for (size_t size : {1, 4099, 200001}) {
+        Tensor<> t(handle, {TensorShape{size}, dtype::Float32()});
+        opr->exec(t.tensornd(), {});
+        auto ptr = t.ptr();
+        if (size >= 1000) {
+            assert_uniform_correct(ptr, size);
+        }
+    }
+
+    // the elements of a new seed are the blocks of its stream from the start
+    opr->param().seed = 42;
+    size_t offset = 0;
+    for (size_t size : {4099, 4099}) {
+        Tensor<> t(handle, {TensorShape{size}, dtype::Float32()});
+        opr->exec(t.tensornd(), {});
+        auto ptr = t.ptr();
+        for (size_t i = 0; i < size; ++i) {
+            uint32_t words[4];
+            philox::generate(42, offset + i / 4, words);
+            ASSERT_EQ(philox::to_uniform(words[i % 4]), ptr[i]) << "i=" << i;
+        }
+        offset += (size + 3) / 4;
+    }
+}
+
+void run_gaussian(Handle* handle) {
+    auto opr = handle->create_operator<GaussianRNG>();
+    opr->param().mean = 0.8;
+    opr->param().std = 2.3;
+    for (size_t size : {1, 200000, 200001}) {
+        Tensor<> t(handle, {TensorShape{size}, dtype::Float32()});
+        opr->exec(t.tensornd(), {});
+        auto ptr = t.ptr();
+        ASSERT_LE(std::abs(ptr[0] - 0.8), 2.3 * 6);
+        if (size >= 1000) {
+            auto stat = get_mean_var(ptr, size, 0.8f);
+            ASSERT_LE(std::abs(stat.first - 0.8), 1e-2);
+            ASSERT_LE(std::abs(stat.second - 2.3 * 2.3), 5e-2);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, UNIFORM_RNG_F32) {
+    run_uniform(handle());
+}
+
+TEST_F(FALLBACK, GAUSSIAN_RNG_F32) {
+    run_gaussian(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, UNIFORM_RNG_F32) {
+    run_uniform(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, GAUSSIAN_RNG_F32) {
+    run_gaussian(handle());
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,52 @@
+/**
+ * \file dnn/test/fallback/roi_pooling.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/roi_pooling.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_roi_pooling_forward(Handle* handle) {
+    size_t N = 4, IH = 42, IW = 38, OH = 7, OW = 6, M = 7;
+    ROIPoolingRNG rng(N);
+    using Param = ROIPooling::Param;
+    Param param;
+    param.scale = 40;
+    Checker<ROIPoolingForward> checker(handle);
+    for (auto mode : {Param::Mode::MAX, Param::Mode::AVERAGE})
+        for (size_t C : {3, 37}) {
+            param.mode = mode;
+            checker.set_param(param)
+                    .set_rng(1, &rng)
+                    .set_dtype(0, dtype::Float32())
+                    .set_dtype(1, dtype::Float32())
+                    .set_dtype(2, dtype::Float32())
+                    .set_dtype(3, dtype::Int32())
+                    .execs({{N, C, IH, IW}, {M, 5}, {M, C, OH, OW}, {M, C, OH, OW}});
+        }
+}
+}  // namespace
+
+TEST_F(FALLBACK, ROI_POOLING_FORWARD) {
+    run_roi_pooling_forward(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ROI_POOLING_FORWARD) {
+    run_roi_pooling_forward(handle());
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,78 @@
+/**
+ * \file dnn/test/fallback/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/softmax.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, SOFTMAX_FORWARD) {
+    Checker<SoftmaxForward> checker(handle());
+    // exp overflows for such inputs unless the max along the axis is subtracted
+    UniformFloatRNG rng{-100.f, 100.f};
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    for (auto&& arg : softmax::get_args()) {
+        checker.set_param(arg.param).execs({arg.shape, {}});
+    }
+    // the columns are processed in blocks of 256 if axis is not the last one
+    for (size_t C : {255, 256, 257, 600}) {
+        checker.set_param({1}).execs({{2, 7, C}, {}});
+    }
+    checker.set_param({0}).execs({{1, 300}, {}});
+    checker.set_param({-1}).execs({{300, 1}, {}});
+
+    // other dtypes are forwarded to the naive impl
+    checker.set_dtype(0, dtype::Float16())
+            .set_dtype(1, dtype::Float16())
+            .set_epsilon(1e-3);
+    checker.set_param({-1}).execs({{5, 33}, {}});
+    checker.set_param({0}).execs({{5, 33}, {}});
+}
+
+TEST_F(FALLBACK, SOFTMAX_BACKWARD) {
+    Checker<SoftmaxBackward> checker(handle());
+    UniformFloatRNG rng_y{0.f, 1.f}, rng_diff{-10.f, 10.f};
+    checker.set_rng(0, &rng_y).set_rng(1, &rng_diff).set_epsilon(1e-4);
+    for (auto&& arg : softmax::get_args()) {
+        checker.set_param(arg.param).execs({arg.shape, arg.shape, arg.shape});
+    }
+    for (size_t C : {255, 256, 257, 600}) {
+        TensorShape shape{2, 7, C};
+        checker.set_param({1}).execs({shape, shape, shape});
+    }
+    checker.set_param({0}).execs({{1, 300}, {1, 300}, {1, 300}});
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, SOFTMAX) {
+    Checker<SoftmaxForward> checker_fwd(handle());
+    Checker<SoftmaxBackward> checker_bwd(handle());
+    UniformFloatRNG rng{-10.f, 10.f}, rng_y{0.f, 1.f};
+    checker_fwd.set_rng(0, &rng).set_epsilon(1e-4);
+    checker_bwd.set_rng(0, &rng_y).set_rng(1, &rng).set_epsilon(1e-4);
+    auto run = [&](const TensorShape& shape, int axis) {
+        checker_fwd.set_param({axis}).execs({shape, {}});
+        checker_bwd.set_param({axis}).execs({shape, shape, shape});
+    };
+    // the rows are split into tasks of at least 16384 elements, and the
+    // number of rows is not a multiple of the number of tasks
+    run({7, 5003}, -1);
+    run({3, 16384}, -1);
+    run({1, 100000}, -1);
+    run({65, 300}, -1);
+    // one task for each block of columns
+    run({5, 9, 300}, 1);
+    run({3, 40, 7}, 1);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,48 @@
+/**
+ * \file dnn/test/fallback/topk.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/common/topk.h"
+#include "test/common/checker.h"
+#include "test/fallback/fixture.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K_I32) {
+    run_topk_test<dtype::Int32>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K_LARGE_ROW) {
+    // few rows with many columns, which are split among threads
+    using Mode = TopK::Param::Mode;
+    Checker<TopK> checker{handle()};
+    UniformIntRNG rng{-100, 100};
+    checker.set_rng(0, &rng).set_dtype(0, dtype::Int32());
+    for (int k : {1, 7, -13, 100}) {
+        checker.set_proxy(k);
+        checker.set_param(Mode::KTH_ONLY);
+        checker.execs({{1, 100003}, {}});
+        checker.execs({{2, 65536}, {}});
+        // ties are broken by index, which matches naive impl
+        checker.set_param(Mode::VALUE_IDX_SORTED);
+        checker.execs({{1, 100003}, {}, {}});
+        checker.execs({{2, 65536}, {}, {}});
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,83 @@
+/**
+ * \file dnn/test/fallback/weight_quant_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+void run(
+        Checker<WeightQuantMatrixMulForward>& checker, uint32_t bits, size_t M,
+        size_t K, size_t N) {
+    size_t row_bytes = bits == 8 ? K : (K + 1) / 2;
+    checker.set_param({bits}).execs({{M, K}, {N, row_bytes}, {N}, {}});
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, WEIGHT_QUANT_MATRIX_MUL) {
+    Checker<WeightQuantMatrixMulForward> checker(handle());
+    UniformFloatRNG src_rng{-1.f, 1.f}, scale_rng{1e-3f, 1e-2f};
+    UniformIntRNG weight_rng{-128, 127};
+    checker.set_dtype(1, dtype::Int8()).set_dtype(2, dtype::Float32());
+    checker.set_rng(0, &src_rng).set_rng(1, &weight_rng).set_rng(2, &scale_rng);
+    checker.set_epsilon(1e-4);
+    for (uint32_t bits : {8, 4}) {
+        // tasks of 8 weight rows and 32 src rows, with partial tasks at the
+        // ends; odd K leaves the upper half of the last byte of 4 bits unused
+        for (size_t M : {1, 31, 32, 33}) {
+            for (size_t N : {1, 7, 8, 9}) {
+                for (size_t K : {1, 7, 8, 9, 64, 255}) {
+                    run(checker, bits, M, K, N);
+                }
+            }
+        }
+    }
+
+    // the most negative values, which are sign extended from the nibbles if
+    // the weight is of 4 bits
+    ConstValue weight_min8{-128.f}, weight_min4{-120.f};
+    checker.set_rng(1, &weight_min8);
+    run(checker, 8, 5, 33, 9);
+    checker.set_rng(1, &weight_min4);
+    run(checker, 4, 5, 33, 9);
+
+    // src of other dtypes is forwarded to the naive impl
+    checker.set_rng(1, &weight_rng);
+    checker.set_dtype(0, dtype::Float16()).set_dtype(3, dtype::Float16());
+    checker.set_epsilon(1e-2);
+    for (uint32_t bits : {8, 4}) {
+        run(checker, bits, 3, 7, 9);
+    }
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, WEIGHT_QUANT_MATRIX_MUL) {
+    Checker<WeightQuantMatrixMulForward> checker(handle());
+    UniformFloatRNG src_rng{-1.f, 1.f}, scale_rng{1e-3f, 1e-2f};
+    UniformIntRNG weight_rng{-128, 127};
+    checker.set_dtype(1, dtype::Int8()).set_dtype(2, dtype::Float32());
+    checker.set_rng(0, &src_rng).set_rng(1, &weight_rng).set_rng(2, &scale_rng);
+    checker.set_epsilon(1e-4);
+    // each thread dequantizes the weight rows of its task into its own
+    // workspace
+    for (uint32_t bits : {8, 4}) {
+        run(checker, bits, 100, 255, 70);
+        run(checker, bits, 1, 4096, 33);
+        run(checker, bits, 65, 3, 1);
+    }
+}
+
+// vim: syntax=cpp.doxygen
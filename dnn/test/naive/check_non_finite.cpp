@@ -39,6 +39,56 @@ TEST_F(NAIVE, CHECK_NON_FINITE_BASIC) {
             Testcase{{}, TensorValue({1}, dtype::Int32(), {1})});
 }
 
+TEST_F(NAIVE, CHECK_NON_FINITE_V2_MULTI_INPUT_SCALE) {
+    Checker<CheckNonFiniteV2> checker(handle(), false);
+    checker.set_param({0.5f});
+    checker.exect(
+            Testcase{
+                    TensorValue({4}, dtype::Float32(), {1.f, 2.f, 3.f, 4.f}),
+                    TensorValue({2}, dtype::Float32(), {-2.f, 8.f}),
+                    {}},
+            Testcase{
+                    TensorValue({4}, dtype::Float32(), {.5f, 1.f, 1.5f, 2.f}),
+                    TensorValue({2}, dtype::Float32(), {-1.f, 4.f}),
+                    TensorValue({1}, dtype::Int32(), {0})});
+    checker.exect(
+            Testcase{
+                    TensorValue({2}, dtype::Float32(), {1.f, 2.f}),
+                    TensorValue(
+                            {2}, dtype::Float32(),
+                            {-std::numeric_limits<float>::infinity(), 8.f}),
+                    {}},
+            Testcase{
+                    TensorValue({2}, dtype::Float32(), {.5f, 1.f}),
+                    {},
+                    TensorValue({1}, dtype::Int32(), {1})});
+}
+
+TEST_F(NAIVE, CHECK_NON_FINITE_V2_NO_SCALE) {
+    Checker<CheckNonFiniteV2> checker(handle(), false);
+    // the inputs are left as they are when the scale is 1
+    checker.exect(
+            Testcase{
+                    TensorValue({3}, dtype::Float32(), {1.f, -3e38f, 3.f}),
+                    TensorValue({2}, dtype::Float32(), {-2.f, 8.f}),
+                    {}},
+            Testcase{
+                    TensorValue({3}, dtype::Float32(), {1.f, -3e38f, 3.f}),
+                    TensorValue({2}, dtype::Float32(), {-2.f, 8.f}),
+                    TensorValue({1}, dtype::Int32(), {0})});
+    checker.exect(
+            Testcase{
+                    TensorValue({3}, dtype::Float32(), {1.f, 2.f, 3.f}),
+                    TensorValue(
+                            {2}, dtype::Float32(),
+                            {std::numeric_limits<float>::quiet_NaN(), 8.f}),
+                    {}},
+            Testcase{
+                    TensorValue({3}, dtype::Float32(), {1.f, 2.f, 3.f}),
+                    {},
+                    TensorValue({1}, dtype::Int32(), {1})});
+}
+
 }  // namespace test
 }  // namespace megdnn
 
@@ -0,0 +1,163 @@
+/**
+ * \file dnn/test/naive/heuristic_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/heuristic_cache.h"
+#include "test/naive/fixture.h"
+
+#include <thread>
+
+namespace megdnn {
+namespace test {
+
+namespace {
+//! clear the global cache and restore its capacity after the test
+class HeuristicCacheGuard {
+    size_t m_orig_capacity;
+
+public:
+    HeuristicCacheGuard() : m_orig_capacity{HeuristicCache::instance().capacity()} {
+        HeuristicCache::instance().clear();
+    }
+
+    ~HeuristicCacheGuard() {
+        HeuristicCache::instance().clear();
+        HeuristicCache::instance().set_capacity(m_orig_capacity);
+    }
+};
+
+class HeuristicCacheTest {
+    Handle* m_handle;
+
+public:
+    explicit HeuristicCacheTest(Handle* handle) : m_handle{handle} {}
+
+    //! key with an input of shape (i,)
+    HeuristicCache::Key key(size_t i, const TensorLayout*& layout) {
+        m_layouts.emplace_back(new TensorLayout{{i + 1}, dtype::Float32()});
+        layout = m_layouts.back().get();
+        return {m_handle, Algorithm::OprType::MATRIX_MUL_FORWARD, layout, 1};
+    }
+
+    void put(size_t i) {
+        const TensorLayout* layout;
+        HeuristicCache::Result result{{}, i};
+        result.policy.algo.handle_type = m_handle->type();
+        result.policy.algo.type = i;
+        HeuristicCache::instance().put(key(i, layout), result);
+    }
+
+    //! workspace of cached entry, or -1 if not cached
+    int get(size_t i) {
+        const TensorLayout* layout;
+        auto ret = HeuristicCache::instance().get(key(i, layout));
+        if (!ret.policy.algo.valid()) {
+            return -1;
+        }
+        return ret.workspace;
+    }
+
+private:
+    std::vector<std::unique_ptr<TensorLayout>> m_layouts;
+};
+}  // anonymous namespace
+
+TEST_F(NAIVE, HEURISTIC_CACHE) {
+    HeuristicCacheGuard guard;
+    HeuristicCacheTest cache{handle()};
+    auto&& inst = HeuristicCache::instance();
+    ASSERT_EQ(-1, cache.get(0));
+    cache.put(0);
+    cache.put(1);
+    ASSERT_EQ(0, cache.get(0));
+    ASSERT_EQ(1, cache.get(1));
+    ASSERT_EQ(-1, cache.get(2));
+
+    // entries with invalid algo are not cached
+    const TensorLayout* layout;
+    HeuristicCache::Result invalid{{}, 2};
+    inst.put(cache.key(2, layout), invalid);
+    ASSERT_EQ(-1, cache.get(2));
+
+    auto stats = inst.stats();
+    ASSERT_EQ(2u, stats.nr_hit);
+    ASSERT_EQ(3u, stats.nr_miss);
+    ASSERT_EQ(0u, stats.nr_eviction);
+    ASSERT_EQ(2u, stats.size);
+
+    inst.clear();
+    stats = inst.stats();
+    ASSERT_EQ(0u, stats.nr_hit + stats.nr_miss + stats.size);
+    ASSERT_EQ(-1, cache.get(0));
+}
+
+TEST_F(NAIVE, HEURISTIC_CACHE_EVICTION) {
+    HeuristicCacheGuard guard;
+    HeuristicCacheTest cache{handle()};
+    auto&& inst = HeuristicCache::instance();
+    // a single entry per shard
+    inst.set_capacity(1);
+    constexpr size_t N = 200;
+    for (size_t i = 0; i < N; ++i) {
+        cache.put(i);
+    }
+    auto stats = inst.stats();
+    ASSERT_LE(stats.size, 16u);
+    ASSERT_EQ(N, stats.size + stats.nr_eviction);
+    // the last entry is always kept
+    ASSERT_EQ(int(N - 1), cache.get(N - 1));
+
+    // least recently used entries are evicted first
+    inst.clear();
+    inst.set_capacity(16 * 4);
+    for (size_t i = 0; i < N; ++i) {
+        cache.put(i);
+        // keep entry 0 recently used
+        ASSERT_EQ(0, cache.get(0));
+    }
+    stats = inst.stats();
+    ASSERT_LE(stats.size, 16u * 4);
+    ASSERT_EQ(N, stats.size + stats.nr_eviction);
+    ASSERT_GT(stats.nr_eviction, 0u);
+
+    // unlimited
+    inst.clear();
+    inst.set_capacity(0);
+    for (size_t i = 0; i < N; ++i) {
+        cache.put(i);
+    }
+    ASSERT_EQ(N, inst.stats().size);
+    ASSERT_EQ(0u, inst.stats().nr_eviction);
+}
+
+TEST_F(NAIVE, HEURISTIC_CACHE_MULTI_THREAD) {
+    HeuristicCacheGuard guard;
+    constexpr size_t NR_THREAD = 4, N = 100;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < NR_THREAD; ++t) {
+        workers.emplace_back([this, t]() {
+            HeuristicCacheTest worker{handle()};
+            for (size_t i = 0; i < N; ++i) {
+                worker.put(t * N + i);
+                ASSERT_EQ(int(t * N + i), worker.get(t * N + i));
+            }
+        });
+    }
+    for (auto&& i : workers) {
+        i.join();
+    }
+    auto stats = HeuristicCache::instance().stats();
+    ASSERT_EQ(NR_THREAD * N, stats.size);
+    ASSERT_EQ(NR_THREAD * N, stats.nr_hit);
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
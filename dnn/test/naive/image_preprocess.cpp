@@ -0,0 +1,63 @@
+/**
+ * \file dnn/test/naive/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/naive/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(NAIVE, IMAGE_PREPROCESS) {
+    using Param = param::ImagePreprocess;
+    Checker<ImagePreprocess> checker(handle(), false);
+
+    // gray NV12 pixels keep their luma; the output is y / 128 - 1 in NCHW
+    checker.set_param({Param::Mode::YUV2RGB_NV12, Param::InterpolationMode::NEAREST,
+                       Param::Format::NCHW});
+    checker.exect(
+            Testcase{
+                    TensorValue(
+                            {1, 3, 2, 1}, dtype::Uint8(), {0, 64, 128, 192, 128, 128}),
+                    TensorValue({3}, dtype::Float32(), {1 / 128.f, 1 / 128.f, 1 / 128.f}),
+                    TensorValue({3}, dtype::Float32(), {-1.f, -1.f, -1.f}),
+                    {}},
+            Testcase{
+                    {},
+                    {},
+                    {},
+                    TensorValue(
+                            {1, 3, 2, 2}, dtype::Float32(),
+                            {-1.f, -0.5f, 0.f, 0.5f, -1.f, -0.5f, 0.f, 0.5f, -1.f, -0.5f,
+                             0.f, 0.5f})});
+
+    // two pixels are averaged into one, with the channels reversed
+    checker.set_param({Param::Mode::RGB2BGR, Param::InterpolationMode::LINEAR,
+                       Param::Format::NCHW44});
+    checker.exect(
+            Testcase{
+                    TensorValue({1, 1, 2, 3}, dtype::Uint8(), {10, 20, 30, 50, 60, 70}),
+                    TensorValue({3}, dtype::Float32(), {1.f, 2.f, 3.f}),
+                    TensorValue({3}, dtype::Float32(), {0.f, 0.f, 1.f}),
+                    {}},
+            Testcase{
+                    {},
+                    {},
+                    {},
+                    TensorValue(
+                            {1, 1, 1, 1, 4}, dtype::Float32(), {50.f, 80.f, 91.f, 0.f})});
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,37 @@
+/**
+ * \file dnn/test/x86/benchmark_corpus.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmark_corpus.h"
+
+namespace megdnn {
+namespace test {
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86, BENCHMARK_CORPUS) {
+    benchmark_corpus::record_handle_info(handle());
+    benchmark_corpus::run_all(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, BENCHMARK_CORPUS) {
+    benchmark_corpus::record_handle_info(handle());
+    // keep in sync with CPU_MULTI_THREADS::SetUp()
+    benchmark_corpus::Recorder::inst().set_info(
+            "nr_threads", std::to_string(std::min<size_t>(get_cpu_count(), 2)));
+    benchmark_corpus::run_all(handle());
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
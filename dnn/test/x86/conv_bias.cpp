@@ -880,6 +880,9 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_INT8X8X32) {
         cb("IM2COLMATMUL:X86_INT8X8X32_VNNI");
     }
 #endif
+    if (megdnn::x86::is_supported(x86::SIMDType::AVX512)) {
+        cb("IM2COLMATMUL:X86_INT8X8X32_AVX512_8X32X2");
+    }
     if (megdnn::x86::is_supported(x86::SIMDType::AVX2)) {
         cb("IM2COLMATMUL:X86_INT8X8X32_AVX2_2X4X16");
         cb("IM2COLMATMUL:X86_INT8X8X32_AVX2_4X16X2");
@@ -1381,6 +1384,12 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_CONV1X1_S1_INT8X8X32) {
                 dtype::Int32{}, dtype::Int32{}, "CONV1x1:X86_INT8X8X32_VNNI:24");
     }
 #endif
+    if (x86::is_supported(x86::SIMDType::AVX512)) {
+        checker_conv_bias(
+                args, handle(), &rng, epsilon, dtype::Int8{}, dtype::Int8{},
+                dtype::Int32{}, dtype::Int32{},
+                "CONV1x1:X86_INT8X8X32_AVX512_8X32X2:24");
+    }
     if (x86::is_supported(x86::SIMDType::AVX2)) {
         checker_conv_bias(
                 args, handle(), &rng, epsilon, dtype::Int8{}, dtype::Int8{},
@@ -1505,6 +1514,71 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_QINT8) {
 #undef cb
 }
 
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_QINT8_BIAS) {
+    using namespace conv_bias;
+    std::vector<TestArg> args;
+
+    auto run = [&](size_t oc, size_t ic, size_t w, size_t h, size_t kernel, size_t p,
+                   NonlineMode nonline_mode) {
+        param::ConvBias param;
+        param.stride_h = 1;
+        param.stride_w = 1;
+        param.pad_h = p;
+        param.pad_w = p;
+        param.nonlineMode = nonline_mode;
+        size_t oh = h + 2 * p - kernel + 1, ow = w + 2 * p - kernel + 1;
+
+        //! bias channel
+        args.emplace_back(
+                param, TensorShape{2, ic, h, w}, TensorShape{oc, ic, kernel, kernel},
+                TensorShape{1, oc, 1, 1});
+        //! full bias, which is requantized with the conv result in one pass
+        args.emplace_back(
+                param, TensorShape{2, ic, h, w}, TensorShape{oc, ic, kernel, kernel},
+                TensorShape{2, oc, oh, ow});
+    };
+
+    for (size_t kernel : {1, 3})
+        for (size_t ic : {1, 8})
+            for (size_t oc : {4, 13})
+                for (size_t size : {7, 20})
+                    for (NonlineMode nonline_mode :
+                         {NonlineMode::IDENTITY, NonlineMode::RELU,
+                          NonlineMode::H_SWISH}) {
+                        run(oc, ic, size, size, kernel, 1, nonline_mode);
+                    }
+    Checker<ConvBias> checker(handle());
+#define cb(algo_name)                                             \
+    checker.set_before_exec_callback(                             \
+            conv_bias::ConvBiasAlgoChecker<ConvBias>(algo_name)); \
+    UniformIntRNG rng{-50, 50};                                   \
+    for (auto&& arg : args) {                                     \
+        checker.set_dtype(0, dtype::QuantizedS8(2.5f))            \
+                .set_dtype(1, dtype::QuantizedS8(2.5f))           \
+                .set_dtype(2, dtype::QuantizedS32(6.25f))         \
+                .set_dtype(4, dtype::QuantizedS8(60.25))          \
+                .set_rng(0, &rng)                                 \
+                .set_rng(1, &rng)                                 \
+                .set_rng(2, &rng)                                 \
+                .set_param(arg.param)                             \
+                .execs({arg.src, arg.filter, arg.bias, {}, {}});  \
+    }
+
+#if MEGDNN_X86_WITH_VNNI
+    if (x86::is_supported(x86::SIMDType::VNNI)) {
+        cb("IM2COLMATMUL:X86_INT8X8X32_VNNI");
+    }
+#endif
+    if (x86::is_supported(x86::SIMDType::AVX2)) {
+        cb("IM2COLMATMUL:X86_INT8X8X32_AVX2_2X4X16");
+    }
+    if (x86::is_supported(x86::SIMDType::SSE4_2)) {
+        cb("IM2COLMATMUL:X86_INT8X8X32_SSE_4X8X2");
+    }
+
+#undef cb
+}
+
 TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_QINT8_FILTER_PREPROCESS) {
     using namespace conv_bias;
     std::vector<TestArg> args;
@@ -1754,6 +1828,33 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F63_WEIGHT_PREPROCESS) {
     }
 }
 
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F43) {
+    using namespace conv_bias;
+    std::vector<TestArg> args = get_winograd_mk_nchw88_args();
+    Checker<ConvBiasForward> checker(handle());
+
+    checker.set_before_exec_callback(conv_bias::ConvBiasAlgoChecker<ConvBias>(
+            ssprintf("WINOGRAD:X86_F32MK8_8X8:8:4").c_str()));
+
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).execs({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F43_WEIGHT_PREPROCESS) {
+    using namespace conv_bias;
+    std::vector<TestArg> args = get_winograd_mk_nchw88_args();
+    Checker<ConvBiasForward, OprWeightPreprocessProxy<ConvBiasForward>> checker(
+            handle());
+
+    checker.set_before_exec_callback(conv_bias::ConvBiasAlgoChecker<ConvBias>(
+            ssprintf("WINOGRAD:X86_F32MK8_8X8:8:4").c_str()));
+
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).execs({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
 TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F23) {
     using namespace conv_bias;
     std::vector<TestArg> args = get_winograd_mk_nchw88_args();
@@ -2819,6 +2920,10 @@ TEST_F(X86, BENCHMARK_CONVBIAS_WINOGRAD_F63_8x8) {
     benchmark_winograd("WINOGRAD:X86_F32MK8_8X8:8:6:8", handle(), 3, 8);
 }
 
+TEST_F(X86, BENCHMARK_CONVBIAS_WINOGRAD_F43_8x8) {
+    benchmark_winograd("WINOGRAD:X86_F32MK8_8X8:8:4:8", handle(), 3, 8);
+}
+
 TEST_F(X86, BENCHMARK_CONVBIAS_WINOGRAD_F23_8x8) {
     benchmark_winograd("WINOGRAD:X86_F32MK8_8X8:8:2:8", handle(), 3, 8);
 }
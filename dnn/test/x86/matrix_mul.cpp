@@ -52,6 +52,41 @@ TEST_F(X86, MATRIX_MUL_AVX2_8X8X32) {
             "X86_INT8X8X32_AVX2_4X16X2", param::MatrixMul::Format::DEFAULT, 8, 1e-3,
             false);
 }
+TEST_F(X86, MATRIX_MUL_AVX512_8X8X32) {
+    if (!is_supported(SIMDType::AVX512)) {
+        return;
+    }
+    matrix_mul::check_matrix_mul(
+            dtype::Int8{}, dtype::Int8{}, dtype::Int32{}, handle(),
+            "X86_INT8X8X32_AVX512_8X32X2", param::MatrixMul::Format::DEFAULT, 8, 1e-3,
+            false);
+}
+#if MEGDNN_X86_WITH_AMX
+TEST_F(X86, MATRIX_MUL_AMX_8X8X32) {
+    if (!is_supported(SIMDType::AMX_INT8)) {
+        return;
+    }
+    matrix_mul::check_matrix_mul(
+            dtype::Int8{}, dtype::Int8{}, dtype::Int32{}, handle(),
+            "X86_INT8X8X32_AMX_32X32X64", param::MatrixMul::Format::DEFAULT, 8, 1e-3,
+            false);
+}
+
+#if !MEGDNN_DISABLE_FLOAT16
+TEST_F(X86, MATRIX_MUL_AMX_BF16) {
+    if (!is_supported(SIMDType::AMX_BF16)) {
+        return;
+    }
+    //! the reference also accumulates in float32, and the result is rounded to
+    //! bf16 once
+    matrix_mul::check_matrix_mul(
+            dtype::BFloat16{}, dtype::BFloat16{}, dtype::BFloat16{}, handle(),
+            "X86_BF16_AMX_32X32X32", param::MatrixMul::Format::DEFAULT, 8, 5e-2, {},
+            true, param::MatrixMul::ComputeMode::FLOAT32);
+}
+#endif
+#endif
+
 TEST_F(X86, MATRIX_MUL_AVX2_8X8X16) {
     matrix_mul::check_matrix_mul(
             dtype::Int8{}, dtype::Int8{}, dtype::Int16{}, handle(),
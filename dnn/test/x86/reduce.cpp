@@ -0,0 +1,85 @@
+/**
+ * \file dnn/test/x86/reduce.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+using Param = Reduce::Param;
+using Mode = Param::Mode;
+
+void run_reduce_test(Handle* handle) {
+    Checker<Reduce> checker(handle);
+    checker.set_dtype(0, dtype::Float32()).set_dtype(1, dtype::Float32());
+    for (auto mode : {Mode::SUM, Mode::MEAN, Mode::SUM_SQR, Mode::MAX, Mode::MIN}) {
+        for (auto data_type :
+             {Param::DataType::DEFAULT, Param::DataType::FLOAT_O32xC32}) {
+            for (TensorShape shape :
+                 {TensorShape{2, 3, 20, 5}, TensorShape{3, 70, 37},
+                  TensorShape{1, 50000}, TensorShape{5000, 3}}) {
+                for (size_t axis = 0; axis < shape.ndim; ++axis) {
+                    checker.set_param(Param(mode, axis, data_type))
+                            .execs({shape, {}});
+                }
+            }
+        }
+        using Shapes = std::pair<TensorShape, TensorShape>;
+        checker.set_param(Param(mode, Reduce::TARGET_SHAPE_AXIS));
+        for (auto&& shapes :
+             {Shapes{{2, 3, 20, 5}, {1, 3, 1, 1}}, Shapes{{2, 3, 20, 5}, {1, 1, 1, 1}},
+              Shapes{{4, 70, 37}, {1, 70, 1}}, Shapes{{300, 70}, {1, 70}},
+              Shapes{{3, 70, 37}, {3, 1, 37}}, Shapes{{2, 3, 4, 5}, {2, 1, 4, 1}},
+              Shapes{{2, 3, 4, 5}, {2, 3, 4, 5}}}) {
+            checker.execs({shapes.first, shapes.second});
+        }
+    }
+}
+}  // anonymous namespace
+
+TEST_F(X86, REDUCE) {
+    run_reduce_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, REDUCE) {
+    run_reduce_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86, BENCHMARK_REDUCE_TARGET_SHAPE) {
+    auto run = [&](const TensorShape& src, const TensorShape& dst) {
+        Benchmarker<Reduce> benchmarker(handle());
+        constexpr size_t RUNS = 20;
+        benchmarker.set_times(RUNS).set_display(false);
+        //! the same reduction by two operators on one axis each
+        benchmarker.set_param(Param(Mode::SUM, 0));
+        TensorShape mid = src;
+        mid[0] = 1;
+        float t_axis = benchmarker.exec({src, mid});
+        benchmarker.set_param(Param(Mode::SUM, 2));
+        t_axis += benchmarker.exec({mid, dst});
+        benchmarker.set_param(Param(Mode::SUM, Reduce::TARGET_SHAPE_AXIS));
+        float t_target = benchmarker.exec({src, dst});
+        printf("%s => %s: two axes %.3fms, target shape %.3fms, speedup %.2f\n",
+               src.to_string().c_str(), dst.to_string().c_str(), t_axis / RUNS,
+               t_target / RUNS, t_axis / t_target);
+    };
+    run({32, 64, 56 * 56}, {1, 64, 1});
+    run({64, 256, 14 * 14}, {1, 256, 1});
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,93 @@
+/**
+ * \file dnn/test/x86/relayout.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/relayout.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+template <typename tag>
+class X86_RELAYOUT : public X86 {};
+TYPED_TEST_CASE(X86_RELAYOUT, relayout::test_types);
+TYPED_TEST(X86_RELAYOUT, run) {
+    relayout::run_test<TypeParam>(this->handle());
+}
+
+//! transposes large enough to be split among threads
+std::vector<relayout::TestArg> get_transpose_args() {
+    std::vector<relayout::TestArg> args;
+    auto add = [&](const TensorShape& shape, const std::vector<size_t>& pattern,
+                   DType dtype) {
+        TensorLayout src{shape, dtype};
+        src = src.dimshuffle(pattern);
+        TensorLayout dst{src, dtype};
+        dst.init_contiguous_stride();
+        args.emplace_back(src, dst);
+    };
+    for (DType dtype :
+         std::vector<DType>{dtype::Float32(), dtype::Int8(), dtype::Float16()}) {
+        // NCHW <-> NHWC
+        add({2, 64, 56, 56}, {0, 2, 3, 1}, dtype);
+        add({2, 56, 56, 64}, {0, 3, 1, 2}, dtype);
+        add({1, 3, 224, 224}, {0, 2, 3, 1}, dtype);
+        // sizes not divisible by the block size
+        add({129, 1031}, {1, 0}, dtype);
+        add({3, 257, 129}, {0, 2, 1}, dtype);
+        add({1023, 17}, {1, 0}, dtype);
+    }
+    return args;
+}
+}  // namespace
+
+TEST_F(X86, RELAYOUT_TRANSPOSE) {
+    Checker<Relayout> checker(handle());
+    for (auto&& arg : get_transpose_args()) {
+        checker.execl({arg.src, arg.dst});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, RELAYOUT_TRANSPOSE) {
+    Checker<Relayout> checker(handle());
+    for (auto&& arg : get_transpose_args()) {
+        checker.execl({arg.src, arg.dst});
+    }
+    // contiguous and strided copies
+    checker.execl(
+            {TensorLayout{{1000, 1001}, dtype::Float32()},
+             TensorLayout{{1000, 1001}, dtype::Float32()}});
+    checker.execl(
+            {TensorLayout{{100, 200, 30}, {12000, 60, 1}, dtype::Float32()},
+             TensorLayout{{100, 200, 30}, dtype::Float32()}});
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_MULTI_THREADS, BENCHMARK_RELAYOUT_TRANSPOSE) {
+    auto handle_naive = create_cpu_handle(2);
+    Benchmarker<Relayout> benchmarker(handle());
+    Benchmarker<Relayout> benchmarker_naive(handle_naive.get());
+    constexpr size_t RUNS = 10;
+    benchmarker.set_times(RUNS).set_display(false);
+    benchmarker_naive.set_times(RUNS).set_display(false);
+    for (auto&& arg : get_transpose_args()) {
+        auto t0 = benchmarker.execl({arg.src, arg.dst}) / RUNS;
+        auto t1 = benchmarker_naive.execl({arg.src, arg.dst}) / RUNS;
+        double k = arg.dst.span().dist_byte() * 1e3 / (1024 * 1024 * 1024);
+        printf("cur=%7.3fms,%5.2fGiB/s naive=%7.3fms,%5.2fGiB/s %s %s\n", t0, k / t0,
+               t1, k / t1, arg.src.to_string().c_str(), arg.dst.dtype.name());
+    }
+}
+#endif
+
+// vim: syntax=cpp.doxygen
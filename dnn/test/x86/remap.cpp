@@ -0,0 +1,54 @@
+/**
+ * \file dnn/test/x86/remap.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/common/remap.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/x86/fixture.h"
+
+namespace megdnn {
+namespace test {
+namespace remap {
+
+namespace {
+//! the map covers both the inside and the border of the source image
+void run_remap_test(
+        Handle* handle, const std::vector<TestArg>& args, DType dtype, RNG* data_rng,
+        float epsilon) {
+    Checker<Remap> checker(handle);
+    for (auto&& arg : args) {
+        UniformFloatRNG map_rng(
+                -2, std::max(arg.map_xy.shape[2], arg.map_xy.shape[1]) + 2);
+        checker.set_dtype(0, dtype)
+                .set_dtype(1, dtype::Float32())
+                .set_dtype(2, dtype)
+                .set_rng(0, data_rng)
+                .set_rng(1, &map_rng)
+                .set_epsilon(epsilon)
+                .set_param(arg.param)
+                .execs({arg.src, arg.map_xy, arg.dst});
+    }
+}
+}  // namespace
+
+TEST_F(X86, REMAP_NCHW_FLOAT) {
+    UniformFloatRNG float_rng(0, 255);
+    run_remap_test(handle(), get_nchw_args(), dtype::Float32(), &float_rng, 1e-3);
+}
+
+TEST_F(X86_MULTI_THREADS, REMAP_NCHW_FLOAT) {
+    UniformFloatRNG float_rng(0, 255);
+    run_remap_test(handle(), get_nchw_args(), dtype::Float32(), &float_rng, 1e-3);
+}
+
+}  // namespace remap
+}  // namespace test
+}  // namespace megdnn
+// vim: syntax=cpp.doxygen
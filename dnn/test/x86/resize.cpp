@@ -36,6 +36,39 @@ TEST_F(X86, RESIZE_CV) {
     }
 }
 
+TEST_F(X86, RESIZE_NCHW_FLOAT) {
+    param::Resize param;
+    param.format = param::Resize::Format::NCHW;
+    param.imode = param::Resize::InterpolationMode::LINEAR;
+    Checker<Resize> checker(handle());
+    checker.set_param(param)
+            .set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32());
+    checker.execs({{2, 2, 3, 4}, {2, 2, 6, 8}});
+    checker.execs({{1, 2, 6, 8}, {1, 2, 3, 4}});
+    checker.execs({{1, 3, 17, 21}, {1, 3, 30, 37}});
+    checker.execs({{2, 1, 64, 70}, {2, 1, 25, 19}});
+    //! strided src, including negative strides
+    checker.execl(
+            {{{1, 2, 10, 11}, {440, 220, 22, 2}, dtype::Float32()},
+             {{1, 2, 20, 21}, dtype::Float32()}});
+    checker.execl(
+            {{{2, 3, 4, 4}, {-256, 32, -8, 1}, dtype::Float32()},
+             {{2, 3, 9, 11}, dtype::Float32()}});
+}
+
+TEST_F(X86_MULTI_THREADS, RESIZE_NCHW_FLOAT) {
+    param::Resize param;
+    param.format = param::Resize::Format::NCHW;
+    param.imode = param::Resize::InterpolationMode::LINEAR;
+    Checker<Resize> checker(handle());
+    checker.set_param(param)
+            .set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32());
+    checker.execs({{2, 3, 17, 21}, {2, 3, 30, 37}});
+    checker.execs({{4, 2, 64, 70}, {4, 2, 25, 19}});
+}
+
 }  // namespace test
 }  // namespace megdnn
 // vim: syntax=cpp.doxygen
@@ -0,0 +1,46 @@
+/**
+ * \file dnn/test/x86/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/softmax.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(X86, SOFTMAX) {
+    Checker<SoftmaxForward> checker(handle());
+    // exp overflows for such inputs unless the max along the axis is subtracted
+    UniformFloatRNG rng{-100.f, 100.f};
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    // the AVX2 row kernel handles 8 floats per step and a scalar tail
+    for (size_t len : {1, 7, 8, 9, 16, 31, 1000}) {
+        checker.set_param({-1}).execs({{5, len}, {}});
+        checker.set_param({-1}).execs({{2, 3, len}, {}});
+    }
+    // the column kernel of fallback is used if axis is not the last one
+    checker.set_param({1}).execs({{3, 17, 9}, {}});
+    checker.set_param({0}).execs({{17, 300}, {}});
+}
+
+TEST_F(X86_MULTI_THREADS, SOFTMAX) {
+    Checker<SoftmaxForward> checker(handle());
+    UniformFloatRNG rng{-10.f, 10.f};
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    // rows split among the threads, with lengths not a multiple of 8
+    for (auto&& shape : TensorShapeArray{{7, 5003}, {33, 1001}, {1, 100003}}) {
+        checker.set_param({-1}).execs({shape, {}});
+    }
+    checker.set_param({1}).execs({{5, 9, 300}, {}});
+}
+
+// vim: syntax=cpp.doxygen
@@ -28,6 +28,36 @@ TEST_F(X86_MULTI_THREADS, WARP_PERSPECTIVE_MAT_IDX) {
     warp_perspective::run_mat_idx_test(handle());
 }
 
+namespace {
+void run_nchw_float_test(Handle* handle) {
+    using BMode = WarpPerspective::Param::BorderMode;
+    Checker<WarpPerspectiveForward> checker(handle);
+    WarpPerspectiveMatRNG mat_rng;
+    checker.set_rng(1, &mat_rng);
+    WarpPerspective::Param param;
+    param.imode = param::WarpPerspective::InterpolationMode::LINEAR;
+    param.border_val = 1.25f;
+    for (auto bmode :
+         {BMode::WRAP, BMode::REFLECT, BMode::REFLECT_101, BMode::REPLICATE,
+          BMode::CONSTANT}) {
+        param.bmode = bmode;
+        checker.set_param(param);
+        //! widths not multiple of 8 cover the tail of the vectorized rows
+        checker.execs({{2, 3, 10, 11}, {2, 3, 3}, {2, 3, 11, 12}});
+        checker.execs({{1, 2, 40, 33}, {1, 3, 3}, {1, 2, 31, 45}});
+        checker.execs({{3, 1, 3, 5}, {3, 3, 3}, {3, 1, 20, 17}});
+    }
+}
+}  // namespace
+
+TEST_F(X86, WARP_PERSPECTIVE_NCHW_FLOAT) {
+    run_nchw_float_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, WARP_PERSPECTIVE_NCHW_FLOAT) {
+    run_nchw_float_test(handle());
+}
+
 TEST_F(X86_MULTI_THREADS, WARP_AFFINE_CV) {
     using namespace warp_affine;
     std::vector<TestArg> args = get_cv_args();
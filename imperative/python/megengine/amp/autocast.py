@@ -63,11 +63,13 @@ class autocast:
         amp._high_prec_dtype = self.high_prec_dtype
         self._origin_low = amp._low_prec_dtype
         amp._low_prec_dtype = self.low_prec_dtype
+        amp._sync()
 
     def __exit__(self, *args):
         amp._enabled = self._origin_enabled
         amp._high_prec_dtype = self._origin_high
         amp._low_prec_dtype = self._origin_low
+        amp._sync()
 
     def __call__(self, func):
         @functools.wraps(func)
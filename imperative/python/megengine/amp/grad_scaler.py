@@ -128,15 +128,24 @@ class GradScaler:
             grad_tensors: Tensors needed to unscale grads. Should be all tensors
                 that are affected by ``target`` tensor in GradManager's backward.
         """
+        grads = [
+            tensor.grad
+            for tensor in grad_tensors
+            if tensor is not None and getattr(tensor, "grad", None) is not None
+        ]
+        if not grads:
+            return self
         # use float64 for better precision
-        inv_scale = Tensor(1.0 / self.scale_factor)
-        for tensor in grad_tensors:
-            if tensor is None or getattr(tensor, "grad", None) is None:
-                continue
-            # to support tracing, _check_gradients should be applied to every grad.
-            if self._check_gradients(tensor.grad):
-                self._found_non_finite = True
-            tensor.grad *= inv_scale
+        inv_scale = 1.0 / self.scale_factor
+        if self.growth_interval == 0:
+            inv_scale = Tensor(inv_scale)
+            for grad in grads:
+                grad *= inv_scale
+            return self
+
+        # unscale and check all the grads by one kernel
+        if _check_non_finite(grads, inv_scale):
+            self._found_non_finite = True
 
         if self._found_non_finite:
             for tensor in grad_tensors:
@@ -145,11 +154,6 @@ class GradScaler:
                 tensor.grad = None
         return self
 
-    def _check_gradients(self, grad):
-        if self.growth_interval == 0:
-            return False
-        return _check_non_finite(grad)
-
     def update(self, new_scale: float = None):
         r"""Update the scale factor according to whether encountered overflow grad.
         If ``new_scale`` is provided, internal update mechanism will be ignored.
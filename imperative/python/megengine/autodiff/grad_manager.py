@@ -5,12 +5,19 @@
 # Unless required by applicable law or agreed to in writing,
 # software distributed under the License is distributed on an
 # "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+import os
 import weakref
 from collections import OrderedDict
 from typing import Callable, Iterable, List, Union
 
-from ..core._imperative_rt.core2 import pop_scope, push_scope, set_option
+from ..core._imperative_rt.core2 import (
+    _clear_amp_cast_cache,
+    pop_scope,
+    push_scope,
+    set_option,
+)
 from ..core.autodiff.grad import Grad
+from ..functional.inplace import _inplace_add_
 from ..logger import get_logger
 from ..tensor import Tensor
 from ..utils.future import Future
@@ -128,6 +135,8 @@ class GradManager:
         self._after_backward_callback = []
         self._gradients = {}
         self._priority = None
+        # id(Tensor) -> weakref of the .grad allocated by accumulation
+        self._accum_grads = {}
 
     def attached_tensors(self):
         r"""Return attached tensor list from :meth:`attach`."""
@@ -204,6 +213,7 @@ class GradManager:
                 self = selfref()
                 if self is not None:
                     del self._attach_specs[key]
+                    self._accum_grads.pop(key, None)
 
             spec = AttachSpec()
             spec.tensor = weakref.ref(tensor, deleter)
@@ -254,6 +264,11 @@ class GradManager:
         process of this call. When the call successfully finishes, the GradManager will be put back
         to an inactive state.
 
+        When gradients are accumulated over several calls, e.g. over micro-batches, the sum is
+        allocated once by the second call. With ``MEGENGINE_INPLACE_UPDATE=1``, the later calls
+        add to it in place rather than allocating a new .grad each time, until .grad is replaced,
+        for example set to None by :meth:`~.Optimizer.clear_grad`.
+
         Args:
             y: tensor or list of tensors
             dy: tensor or list of tensors. Defaults to 1 if y is scalar
@@ -285,6 +300,9 @@ class GradManager:
             dys = dy
         else:
             dys = [dy]
+        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
+        if inplace_mode:
+            c1 = Tensor([1.0])
         try:
             self._grad(ys, dys)
             for callback in self._after_backward_callback:
@@ -297,8 +315,14 @@ class GradManager:
                 if tensor is not None:
                     if tensor.grad is None:
                         tensor.grad = grad
+                    elif inplace_mode and self._owns_grad(id_, tensor, grad):
+                        _inplace_add_(tensor.grad, grad, alpha=c1, beta=c1)
                     else:
                         tensor.grad += grad
+                        # the sum is only referred by .grad, unlike the grads
+                        # returned by backward which may share storage with
+                        # other tensors, so later backwards accumulate into it
+                        self._track_accum_grad(id_, tensor.grad)
                     if tensor._isscalar() and tensor.grad is not None:
                         tensor.grad._setscalar()
         finally:
@@ -307,6 +331,23 @@ class GradManager:
         set_option("record_computing_path", 1)
         pop_scope("backward")
 
+    def _track_accum_grad(self, id_, grad):
+        selfref = weakref.ref(self)
+
+        def deleter(ref):
+            self = selfref()
+            # a newer grad of the same tensor may have been tracked since
+            if self is not None and self._accum_grads.get(id_) is ref:
+                del self._accum_grads[id_]
+
+        self._accum_grads[id_] = weakref.ref(grad, deleter)
+
+    def _owns_grad(self, id_, tensor, grad):
+        ref = self._accum_grads.get(id_)
+        if ref is None or ref() is not tensor.grad:
+            return False
+        return tensor.grad.dtype == grad.dtype and tensor.grad.shape == grad.shape
+
     def record(self):
         r"""Start recording operations
 
@@ -315,6 +356,9 @@ class GradManager:
         global _global_priority
         if self._recording:
             raise RuntimeError("already recording")
+        # the casts of parameters cached by amp autocast before recording are
+        # not recorded, so they must not be reused
+        _clear_amp_cast_cache()
         grad = Grad()
         self._recording = True
         self._grad = grad
@@ -349,6 +393,7 @@ class GradManager:
             self._grad = None
         self._recording = False
         self._gradients = dict()
+        _clear_amp_cast_cache()
         if self._priority is None:
             _global_priority += 1
 
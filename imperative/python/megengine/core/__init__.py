@@ -10,7 +10,7 @@ import os
 import sys
 from contextlib import contextmanager
 
-from ._imperative_rt.core2 import get_option, set_option
+from ._imperative_rt.core2 import get_option, set_option, start_batch, stop_batch
 from .tensor.megbrain_graph import Graph
 
 
@@ -22,3 +22,15 @@ def option(key, value):
     yield
     assert get_option(key) == value
     set_option(key, old)
+
+
+@contextmanager
+def batch():
+    r"""Issue the ops applied in the context to the interpreter worker in
+    batches of ``batch_length`` commands, instead of one by one. The ops are
+    all issued on exit, or when a value is waited in the context."""
+    start_batch()
+    try:
+        yield
+    finally:
+        stop_batch()
@@ -5,11 +5,19 @@
 # Unless required by applicable law or agreed to in writing,
 # software distributed under the License is distributed on an
 # "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+from .._imperative_rt.core2 import _set_amp_autocast
+
 _enabled = False
 _high_prec_dtype = "float32"
 _low_prec_dtype = "float16"
 
 
+def _sync():
+    r"""Pass the autocast settings to the C++ dispatcher, which casts the inputs of
+    ops and caches the casts of parameters. The cache is cleared."""
+    _set_amp_autocast(_enabled, _low_prec_dtype, _high_prec_dtype)
+
+
 @property
 def enabled(mod):
     r"""Get or set amp autocast mode enabled or not.
@@ -28,6 +36,7 @@ def enabled(mod):
 def enabled(mod, enabled: bool):
     global _enabled
     _enabled = enabled
+    _sync()
 
 
 @property
@@ -49,6 +58,7 @@ def high_prec_dtype(mod):
 def high_prec_dtype(mod, dtype: str):
     global _high_prec_dtype
     _high_prec_dtype = dtype
+    _sync()
 
 
 @property
@@ -70,3 +80,4 @@ def low_prec_dtype(mod):
 def low_prec_dtype(mod, dtype: str):
     global _low_prec_dtype
     _low_prec_dtype = dtype
+    _sync()
@@ -62,11 +62,9 @@ def _elwise(*args, mode):
         _ElwMod.SIGMOID,
         _ElwMod.SIN,
         _ElwMod.LOG_SUM_EXP,
-    ) and (
-        amp._enabled or np.all([np.issubdtype(arg.dtype, np.integer) for arg in args])
-    ):
-        # autocast to FP32 to maintain precision
-        # or to avoid op's not supporting all int args
+    ) and np.all([np.issubdtype(arg.dtype, np.integer) for arg in args]):
+        # autocast to FP32 to avoid op's not supporting all int args, the float
+        # args are autocast by the dispatcher when amp is enabled
         args = cast_tensors(*args, promote=True)
 
     if mode in (_ElwMod.CEIL, _ElwMod.FLOOR, _ElwMod.ROUND,) and np.issubdtype(
@@ -77,11 +75,8 @@ def _elwise(*args, mode):
 
 
 def _matmul(inp1, inp2):
-    if amp._enabled:
-        compute_mode = "float32"
-        inp1, inp2 = cast_tensors(inp1, inp2)
-    else:
-        compute_mode = "default"
+    compute_mode = "default"
+    if not amp._enabled:
         dtype = dtype_promotion(inp1, inp2)
         if inp1.dtype != dtype:
             inp1 = inp1.astype(dtype)
@@ -233,6 +233,10 @@ def optimize_for_inference(dest_vars, **kwargs):
         * enable_ioc16 --
           whether to use float16 for both I/O and computation
           precision.
+        * enable_iobf16xc32 --
+          whether to use bfloat16 for I/O between oprs and use
+          float32 as internal computation precision. Note the output var would be
+          changed to bfloat16.
         * enable_hwcd4 --
           whether to use NHWCD4 data layout. This is faster on some
           OpenCL backend.
@@ -263,6 +267,22 @@ def optimize_for_inference(dest_vars, **kwargs):
           input for inference on nvidia backend(this optimization pass will
           result in mismatch of the precision of output of training and
           inference)
+        * enable_fuse_horizontal: whether to fuse the sibling convs or matmuls
+          sharing an input into one wider opr followed by a split.
+        * enable_block_sparse_weight: whether to compute the matmuls and 1x1
+          convs whose weights are mostly zero blocks by block sparse matmuls.
+        * enable_weight_only_quant_int8: whether to quantize the constant
+          weights of the matmuls to int8 of a scale per output channel, while
+          the activations stay in float.
+        * enable_weight_only_quant_int4: the same as above with int4 weights.
+        * enable_fuse_multi_output_elemwise: whether to compute ``sigmoid(x)``
+          and ``sigmoid(x) * y`` by one kernel when both are used.
+        * enable_spatial_tiling: whether to compute the chains of NCHW convs,
+          poolings and elemwise oprs on large feature maps tile by tile, to
+          bound the memory of the activations.
+        * enable_padding_channel: whether to pad the channels of the float32
+          and qint8 convs to multiple of 4 or 8, so they are converted by
+          ``enable_nchw44``, ``enable_nchw44_dot`` or ``enable_nchw88``.
     """
     inference_options = GraphOptimizeOptions()
     inference_optimize_layout_transform_map = {
@@ -284,12 +304,28 @@ def optimize_for_inference(dest_vars, **kwargs):
         inference_options.f16_io_f32_comp = True
     if kwargs.pop("enable_ioc16", False):
         inference_options.f16_io_comp = True
+    if kwargs.pop("enable_iobf16xc32", False):
+        inference_options.bf16_io_f32_comp = True
     if kwargs.pop("enable_fuse_conv_bias_nonlinearity", False):
         inference_options.fuse_conv_bias_nonlinearity = True
     if kwargs.pop("enable_fuse_conv_bias_with_z", False):
         inference_options.fuse_conv_bias_with_z = True
     if kwargs.pop("enable_fuse_preprocess", False):
         inference_options.fuse_preprocess = True
+    if kwargs.pop("enable_fuse_horizontal", False):
+        inference_options.fuse_horizontal = True
+    if kwargs.pop("enable_block_sparse_weight", False):
+        inference_options.block_sparse_weight = True
+    if kwargs.pop("enable_weight_only_quant_int8", False):
+        inference_options.weight_only_quant_int8 = True
+    if kwargs.pop("enable_weight_only_quant_int4", False):
+        inference_options.weight_only_quant_int4 = True
+    if kwargs.pop("enable_fuse_multi_output_elemwise", False):
+        inference_options.fuse_multi_output_elemwise = True
+    if kwargs.pop("enable_spatial_tiling", False):
+        inference_options.spatial_tiling = True
+    if kwargs.pop("enable_padding_channel", False):
+        inference_options.padding_channel = True
 
     if kwargs:
         raise ValueError("unknown options: %s" % list(kwargs))
@@ -332,12 +368,28 @@ def deserialize_infer_option(x: int) -> Dict[str, bool]:
         ret["enable_io16xc32"] = True
     if inference_options.f16_io_comp:
         ret["enable_ioc16"] = True
+    if inference_options.bf16_io_f32_comp:
+        ret["enable_iobf16xc32"] = True
     if inference_options.fuse_conv_bias_nonlinearity:
         ret["enable_fuse_conv_bias_nonlinearity"] = True
     if inference_options.fuse_conv_bias_with_z:
         ret["enable_fuse_conv_bias_with_z"] = True
     if inference_options.fuse_preprocess:
         ret["enable_fuse_preprocess"] = True
+    if inference_options.fuse_horizontal:
+        ret["enable_fuse_horizontal"] = True
+    if inference_options.block_sparse_weight:
+        ret["enable_block_sparse_weight"] = True
+    if inference_options.weight_only_quant_int8:
+        ret["enable_weight_only_quant_int8"] = True
+    if inference_options.weight_only_quant_int4:
+        ret["enable_weight_only_quant_int4"] = True
+    if inference_options.fuse_multi_output_elemwise:
+        ret["enable_fuse_multi_output_elemwise"] = True
+    if inference_options.spatial_tiling:
+        ret["enable_spatial_tiling"] = True
+    if inference_options.padding_channel:
+        ret["enable_padding_channel"] = True
 
     return ret
 
@@ -375,9 +427,12 @@ def dump_graph(
     keep_opr_name: bool = False,
     keep_param_name: bool = False,
     keep_opr_priority: bool = False,
+    tensor_value_compression: str = None,
+    dedup_tensor_value: bool = False,
     strip_info_file=None,
     append_json=False,
-    metadata=None
+    metadata=None,
+    file=None
 ) -> Tuple[bytes, CompGraphDumpResult]:
     r"""serialize the computing graph of `output_vars` and get byte result.
 
@@ -393,19 +448,37 @@ def dump_graph(
         keep_param_name: whether to keep param names, so param values can be
             easily manipulated after loading model
         keep_opr_priority: whether to keep priority setting for operators
+        tensor_value_compression: lossless codec to compress tensor values,
+            which is decompressed chunk by chunk when loading:
+
+            * None: (default) no compression
+            * "lz": LZ77 compression of raw bytes
+            * "shuffle_lz": shuffle bytes of values into byte planes before
+              LZ77 compression, which is usually better for float params
+
+        dedup_tensor_value: whether to store params with identical values
+            only once; their content hashes are also recorded, so models
+            loaded with a shared tensor value pool (e.g. by
+            ``Runtime.shared_weight_by_value_with_network`` in lite) share
+            identical params. The dumped file can not be loaded by older
+            versions.
         strip_info_file: a string for path or a file handler. if is not None,
             then the dump information for code strip would be written to ``strip_info_file``
         append_json: will be check when `strip_info_file` is not None. if set
             true, the information for code strip will be append to strip_info_file.
             if set false, will rewrite strip_info_file
+        file: a seekable binary file object opened for writing. If given, the
+            dump result is streamed into ``file`` from its current position
+            rather than being buffered in memory, and ``None`` is returned in
+            place of the byte string.
 
     Note:
         The underlying C++ API only accepts a var list. If a dict is given,
         the vars would be renamed to the given names.
 
     Returns:
-        dump result as byte string, and an instance of namedtuple
-        :class:`CompGraphDumpResult`, whose fields are:
+        dump result as byte string (or ``None`` if ``file`` is given), and an
+        instance of namedtuple :class:`CompGraphDumpResult`, whose fields are:
 
         * ``nr_opr`` number of operators dumped
         * ``tot_bytes`` total bytes for the whole graph
@@ -429,23 +502,35 @@ def dump_graph(
 
     ov = _unwrap(output_vars)
 
+    compression_methods = {None: 0, "lz": 1, "shuffle_lz": 2}
+    assert (
+        tensor_value_compression in compression_methods
+    ), "unknown tensor value compression: {}".format(tensor_value_compression)
+
     stat = []
     inputs = []
     outputs = []
     params = []
 
-    dump_content = _imperative_rt.dump_graph(
+    dump_args = (
         ov,
         keep_var_name,
         keep_opr_name,
         keep_param_name,
         keep_opr_priority,
+        compression_methods[tensor_value_compression],
+        dedup_tensor_value,
         metadata,
         stat,
         inputs,
         outputs,
         params,
     )
+    if file is not None:
+        _imperative_rt.dump_graph_to_file(file, *dump_args)
+        dump_content = None
+    else:
+        dump_content = _imperative_rt.dump_graph(*dump_args)
 
     dump_info = CompGraphDumpResult(*stat, inputs, outputs, params)
 
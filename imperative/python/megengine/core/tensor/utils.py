@@ -12,12 +12,18 @@ from typing import Iterable, Union
 import numpy as np
 
 from .._imperative_rt import make_const
-from .._imperative_rt.core2 import SymbolVar, Tensor, apply, dtype_promotion, get_device
+from .._imperative_rt.core2 import (
+    SymbolVar,
+    Tensor,
+    _amp_cast,
+    apply,
+    dtype_promotion,
+    get_device,
+)
 from .._imperative_rt.ops import SubgraphBuilder as _SubgraphBuilder
 from .._wrap import as_device
 from ..ops import builtin
 from ..ops.special import Const
-from .amp import _high_prec_dtype, _low_prec_dtype
 from .dtype import is_dtype_equal, is_quantize
 
 _enable_convert_inputs = True
@@ -101,11 +107,7 @@ def convert_inputs(*args, device=None):
 
 
 def cast_tensors(*args, promote=False):
-    if promote:
-        dtype = _high_prec_dtype
-    else:
-        dtype = _low_prec_dtype
-    return tuple(arg.astype(dtype) if arg is not None else None for arg in args)
+    return tuple(_amp_cast(arg, promote) if arg is not None else None for arg in args)
 
 
 def result_type(*args):
@@ -71,6 +71,7 @@ class DataLoader:
             different sub-process will process different batch. Default: False
         preload: Defines whether to apply the preloading strategy of dataloader, and parallelize the copy of host2device while kernal is executed to improve the loading speed. default is seted False
             the output will change from np.ndarry to dtype tensor. the support dtypes for preload are int,float,list[int,float],tuple[int,float],and another type is not supported.
+            An int means the number of batches to be loaded ahead, and ``True`` loads one batch ahead.
     """
     __initialized = False
 
@@ -173,8 +174,9 @@ class PreLoader:
         if preload:
             self.default_device = get_default_device()
             self.pre_load_device = self.default_device + ":" + str(_sh.get_next())
-            self.pre_load_device_cache = None
-        self.preload = preload
+            # batches copied or being copied to pre_load_device, in order
+            self.pre_load_device_cache = collections.deque()
+        self.preload = int(preload)
 
     """
     strategy one: load from numpy data, and generate dtype tensor
@@ -212,9 +214,12 @@ class PreLoader:
             return data
 
     def _swap_out_cache(self):
-        out = self._load_cache(self.pre_load_device_cache)
-        self.pre_load_device_cache = None  # clean cache
-        return out
+        return self._load_cache(self.pre_load_device_cache.popleft())
+
+    def _fill_cache(self):
+        while len(self.pre_load_device_cache) < self.preload:
+            if not self._try_load_tensor():
+                break
 
 
 class _BaseMapDataLoaderIter(PreLoader):
@@ -242,14 +247,12 @@ class _BaseMapDataLoaderIter(PreLoader):
 
     def __next__(self):
         if self.preload:
-            cached = self.pre_load_device_cache
-            if cached is None:  # first and last
+            if not self.pre_load_device_cache:  # first and last
                 if self.num_processed >= len(self):  # last
                     raise StopIteration
-                elif self.num_processed == 0:  # first
-                    self._try_load_tensor(cached=False)  # first do the h2d
+                self._try_load_tensor(cached=False)  # first do the h2d
             out = self._swap_out_cache()
-            self._try_load_tensor()
+            self._fill_cache()
             return out
         else:
             if self.num_processed >= len(self):
@@ -260,11 +263,12 @@ class _BaseMapDataLoaderIter(PreLoader):
 
     def _try_load_tensor(self, cached=True):
         if self.num_processed >= len(self):
-            return
+            return False
         else:
             self.num_processed += 1
             batch = self._get_next_batch()
-            self.pre_load_device_cache = self._load_tensor(batch, cached)
+            self.pre_load_device_cache.append(self._load_tensor(batch, cached))
+            return True
 
 
 class _SerialMapDataLoaderIter(_BaseMapDataLoaderIter):
@@ -293,13 +297,14 @@ class _ParallelMapDataLoaderIter(_BaseMapDataLoaderIter):
         self.target_batch_idx = multiprocessing.Value("i", 0)
         self.shutdown_flag = multiprocessing.Value("i", 0)
 
+        # use shared-memory queue implemented by pyarrow plasma store, so the
+        # transformed items and the batches are not pickled between processes.
+        from .tools._queue import PlasmaShmQueue
+
         self.trans_data_queues = [
-            multiprocessing.Queue(maxsize=1) for _ in range(self.num_workers)
+            PlasmaShmQueue(maxsize=1) for _ in range(self.num_workers)
         ]
 
-        # use shared-memory queue implemented by pyarrow plasma store.
-        from .tools._queue import PlasmaShmQueue
-
         self.batch_queue = PlasmaShmQueue(maxsize=2)
 
         self.task_feeding_worker = multiprocessing.Process(
@@ -466,17 +471,18 @@ class _BaseStreamDataLoaderIter(PreLoader):
 
     def __next__(self):
         if self.preload:
-            if self.pre_load_device_cache is None:
+            if not self.pre_load_device_cache:
                 self._try_load_tensor(cached=False)  # load in current
             out = self._swap_out_cache()
-            self._try_load_tensor()  # load in cached
+            self._fill_cache()  # load in cached
             return out
         else:
             return self._get_next_batch()
 
     def _try_load_tensor(self, cached=True):
         batch = self._get_next_batch()
-        self.pre_load_device_cache = self._load_tensor(batch, cached)
+        self.pre_load_device_cache.append(self._load_tensor(batch, cached))
+        return True
 
 
 class _SerialStreamDataLoaderIter(_BaseStreamDataLoaderIter):
@@ -756,6 +762,8 @@ def _worker_loop(dataset, task_queue, trans_data_queue, transform, seed, shutdow
                     break
                 logger.debug("batch part queue is full!")
 
+    trans_data_queue.disconnect_client()
+
 
 def _data_gathering_loop(
     trans_data_queues,
@@ -816,6 +824,8 @@ def _data_gathering_loop(
         with target_idx.get_lock():
             target_idx.value += 1
 
+    for q in trans_data_queues:
+        q.disconnect_client()
     batch_queue.disconnect_client()
 
 
@@ -874,4 +884,6 @@ def _data_selecting_loop(
         with target_idx.get_lock():
             target_idx.value += 1
 
+    for q in trans_data_queues:
+        q.disconnect_client()
     batch_queue.disconnect_client()
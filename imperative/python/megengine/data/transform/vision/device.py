@@ -0,0 +1,96 @@
+# -*- coding: utf-8 -*-
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+import numpy as np
+
+from megengine.data.transform.vision.transform import RandomResizedCrop
+from megengine.functional.vision import warp_affine
+from megengine.tensor import Tensor
+
+__all__ = [
+    "DeviceRandomResizedCrop",
+]
+
+
+class DeviceRandomResizedCrop:
+    r"""Crops a batch of images to random sizes and aspect ratios, resizes,
+    randomly flips them horizontally and normalizes them on device.
+
+    It is meant to be applied to the batches produced by the
+    :class:`~.DataLoader` in the main process, to take the heaviest
+    augmentations off the workers. Only the crops are drawn on host, as in
+    :class:`~.RandomResizedCrop`; the crop, the resize and the flip of all the
+    images are done by a single warp affine kernel, whose matrices map the
+    output pixels to the input ones.
+
+    Args:
+        output_size: target size of output image, with (height, width) shape.
+        scale_range: range of size of the origin size cropped. Default: (0.08, 1.0)
+        ratio_range: range of aspect ratio of the origin aspect ratio cropped. Default: (0.75, 1.33)
+        flip_prob: probability of each image to be flipped. Default: 0.5
+        mean: sequence of means for each channel. Default: 0.0
+        std: sequence of standard deviations for each channel. Default: 1.0
+        interp_mode: interpolation method, "linear", "nearest" or "cubic". Default: "linear"
+        device: device to run on. Default: the default device
+
+    Examples:
+
+        .. code-block::
+
+           augment = DeviceRandomResizedCrop(224, mean=[103.5, 116.3, 123.7], std=[57.4, 57.1, 58.4])
+           for images, labels in dataloader:  # uint8 images in NHWC of the same size
+               images = augment(images)  # float32 tensor in NCHW
+    """
+
+    def __init__(
+        self,
+        output_size,
+        scale_range=(0.08, 1.0),
+        ratio_range=(3.0 / 4, 4.0 / 3),
+        flip_prob=0.5,
+        mean=0.0,
+        std=1.0,
+        interp_mode="linear",
+        device=None,
+    ):
+        self._crop = RandomResizedCrop(output_size, scale_range, ratio_range)
+        self.flip_prob = flip_prob
+        self.mean = np.array(mean, dtype=np.float32)
+        self.std = np.array(std, dtype=np.float32)
+        self.interp_mode = interp_mode
+        self.device = device
+
+    def __call__(self, images) -> Tensor:
+        r"""Applies to a batch of images in NHWC, which is a numpy ndarray or a
+        tensor, and returns a float32 tensor in NCHW."""
+        shape = images._tuple_shape if isinstance(images, Tensor) else images.shape
+        # only the shape of an image is needed to draw its crop
+        image = np.broadcast_to(np.uint8(0), shape[1:])
+        oh, ow = self._crop.output_size
+        mat = np.zeros((shape[0], 2, 3), dtype=np.float32)
+        for i in range(shape[0]):
+            x, y, w, h = self._crop._get_coord(image)
+            sx, sy = w / ow, h / oh
+            # the center of an output pixel is mapped to that of the input
+            if np.random.random() < self.flip_prob:
+                mat[i, 0] = [-sx, 0, x + w - 0.5 * sx - 0.5]
+            else:
+                mat[i, 0] = [sx, 0, x + 0.5 * sx - 0.5]
+            mat[i, 1] = [0, sy, y + 0.5 * sy - 0.5]
+
+        inp = images if isinstance(images, Tensor) else Tensor(images, device=self.device)
+        out = warp_affine(
+            inp,
+            Tensor(mat, device=inp.device),
+            (oh, ow),
+            border_mode="replicate",
+            format="NHWC",
+            interp_mode=self.interp_mode,
+        )
+        out = (out.astype("float32") - self.mean) / self.std
+        return out.transpose(0, 3, 1, 2)
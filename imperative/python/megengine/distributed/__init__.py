@@ -27,12 +27,14 @@ from .group import (
 from .helper import bcast_list_, make_allreduce_cb, synchronized
 from .launcher import launcher
 from .server import Client, Server
+from .pipeline import PipelineExecutor
+from .zero import ZeroOptimizer
 
 
 @mproperty
 def backend(mod):
     r"""Get or set backend of collective communication.
-    Available backends are ['nccl', 'shm', 'rccl']
+    Available backends are ['nccl', 'shm', 'rccl', 'ucx', 'auto']
 
     Examples:
 
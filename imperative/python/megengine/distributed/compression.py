@@ -0,0 +1,157 @@
+# -*- coding: utf-8 -*-
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+import math
+
+import numpy as np
+
+from ..functional.math import matmul, norm, topk
+from ..functional.tensor import concat, stack, zeros
+from ..tensor import Tensor
+from .functional import all_gather, all_reduce_sum
+from .group import Group
+
+
+class Compression:
+    r"""Base class of the compressions of the packed float32 gradients summed by
+    :class:`~.AllreduceCallback`.
+
+    A compression keeps its states, such as the errors fed back to the next
+    iteration, for each pack of gradients, so an instance can be shared by
+    several packs.
+    """
+
+    def __init__(self):
+        self._states = {}
+
+    def all_reduce_sum(self, key, inp: Tensor, group: Group) -> Tensor:
+        r"""Returns the approximate sum of 1d tensor ``inp`` over ``group``.
+
+        Args:
+            key: identifier of the pack that ``inp`` is made of.
+            inp: packed gradients.
+            group: communication group.
+        """
+        raise NotImplementedError
+
+    def _residual(self, key, inp):
+        residual = self._states.get(key)
+        if residual is not None and residual._tuple_shape == inp._tuple_shape:
+            return inp + residual
+        return inp
+
+
+class FP16Compression(Compression):
+    r"""Sums the gradients in float16, halving the data to communicate.
+
+    Args:
+        error_feedback: whether to add the rounding error of an iteration to the
+            gradients of the next one. Default: True
+    """
+
+    def __init__(self, error_feedback: bool = True):
+        super().__init__()
+        self._error_feedback = error_feedback
+
+    def all_reduce_sum(self, key, inp, group):
+        # scale down before summing to keep the sum in the range of float16
+        x = inp / group.size
+        if self._error_feedback:
+            x = self._residual(key, x)
+        compressed = x.astype("float16")
+        if self._error_feedback:
+            self._states[key] = x - compressed.astype("float32")
+        reduced = all_reduce_sum(compressed, group, group.comp_node)
+        return reduced.astype("float32") * group.size
+
+
+class TopKCompression(Compression):
+    r"""Sums only the largest gradients in magnitude of each rank, and feeds the
+    rest back to the next iteration.
+
+    The values and the indices of the selected gradients are gathered from all
+    ranks, so the data to communicate is ``2 * ratio`` of the gradients.
+
+    Args:
+        ratio: fraction of the gradients selected on each rank. Default: 0.01
+    """
+
+    def __init__(self, ratio: float = 0.01):
+        super().__init__()
+        assert 0 < ratio <= 1, "ratio should be in (0, 1]"
+        self._ratio = ratio
+
+    def all_reduce_sum(self, key, inp, group):
+        n = inp.shape[0]
+        k = max(1, int(n * self._ratio))
+        x = self._residual(key, inp)
+        _, idx = topk(abs(x), k, descending=True, no_sort=True)
+        values = x[idx]
+        residual = x * 1
+        residual[idx] = 0
+        self._states[key] = residual
+
+        # the indices are unique after being offset by rank, so the gathered
+        # values can be set without accumulation and summed up afterwards
+        values = all_gather(values, group, group.comp_node)
+        idx = all_gather(idx + group.rank * n, group, group.comp_node)
+        dense = zeros((group.size * n,), dtype="float32", device=inp.device)
+        dense[idx] = values
+        return dense.reshape(group.size, n).sum(axis=0)
+
+
+class PowerSGDCompression(Compression):
+    r"""Sums a low-rank approximation of the gradients found by a step of power
+    iteration in each iteration, as in PowerSGD.
+
+    The packed gradients of size :math:`n` are viewed as a nearly square matrix,
+    so the data to communicate is about :math:`2 \cdot rank \cdot \sqrt{n}`.
+    The approximation error is fed back to the next iteration.
+
+    Args:
+        rank: rank of the approximation. Default: 1
+    """
+
+    def __init__(self, rank: int = 1):
+        super().__init__()
+        assert rank > 0, "rank should be positive"
+        self._rank = rank
+
+    @staticmethod
+    def _orthogonalize(p):
+        columns = []
+        for i in range(p.shape[1]):
+            c = p[:, i]
+            for prev in columns:
+                c = c - (c * prev).sum() * prev
+            columns.append(c / (norm(c) + 1e-8))
+        return stack(columns, axis=1)
+
+    def all_reduce_sum(self, key, inp, group):
+        n = inp.shape[0]
+        cols = int(math.ceil(math.sqrt(n)))
+        rows = (n + cols - 1) // cols
+        rank = min(self._rank, rows, cols)
+        m = self._residual(key, inp)
+        if rows * cols > n:
+            m = concat([m, zeros((rows * cols - n,), device=inp.device)])
+        m = m.reshape(rows, cols)
+
+        q = self._states.get((key, "q"))
+        if q is None or q._tuple_shape != (cols, rank):
+            # all ranks must start from the same matrix
+            q = np.random.RandomState(0).randn(cols, rank).astype("float32")
+            q = Tensor(q, device=inp.device)
+        p = all_reduce_sum(matmul(m, q), group, group.comp_node)
+        p = self._orthogonalize(p)
+        q = matmul(m, p, transpose_a=True)
+        self._states[key] = (m - matmul(p, q, transpose_b=True)).flatten()[:n]
+        q = all_reduce_sum(q, group, group.comp_node)
+        # warm start the power iteration of the next iteration
+        self._states[(key, "q")] = q
+        return matmul(p, q, transpose_b=True).flatten()[:n]
@@ -49,6 +49,29 @@ def _backend():
         return group._sd.backend
 
 
+def _send_recv_backend(peer_rank):
+    r"""Returns the backend of the send and recv between this rank and ``peer_rank``.
+
+    On auto backend, the peers on the same machine, as known from the launcher,
+    send tensors through shared memory if the gpus can not access the memory of
+    each other. The other peers use the backend of the device, whose transports
+    already take p2p copies on a machine and RDMA across machines if available.
+    """
+    if group._sd.backend != "auto":
+        return group._sd.backend
+    machine_ranks = group._sd.machine_ranks
+    if (
+        machine_ranks is not None
+        and peer_rank in machine_ranks
+        and what_is_xpu() == "cuda"
+    ):
+        from .helper import _check_enable_p2p
+
+        if not _check_enable_p2p():
+            return "shm"
+    return _backend()
+
+
 def collective_comm(inp, mode, group, device):
     r"""Helper function for applying collective communication functions."""
     assert isinstance(group, Group)
@@ -808,7 +831,7 @@ def remote_send(inp: Tensor, dest_rank: int):
     op.key = group.key
     op.addr, op.port = get_mm_server_addr()
     op.rank_to = dest_rank
-    op.backend = _backend()
+    op.backend = _send_recv_backend(dest_rank)
     (out,) = apply(_RemoteSend(op), inp)
 
     _save_output_for_autodiff(inp, out)
@@ -862,7 +885,7 @@ def remote_recv(src_rank: int, device: Optional[str] = None, inp=None) -> Tensor
     op.dtype = dtype
     op.addr, op.port = get_mm_server_addr()
     op.rank_from = src_rank
-    op.backend = _backend()
+    op.backend = _send_recv_backend(src_rank)
 
     (ret,) = apply(_RemoteRecv(op), inp)
     if _isscalar:
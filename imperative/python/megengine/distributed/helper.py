@@ -23,6 +23,7 @@ from ..tensor import Tensor
 from ..utils.deprecation import deprecated_func
 from ..utils.future import Future
 from . import group as _group
+from .compression import Compression
 from .functional import _bcast_param, all_reduce_sum, broadcast
 from .group import WORLD, Group, group_barrier, is_distributed, override_backend
 
@@ -140,12 +141,17 @@ def _check_enable_p2p():
         return False
 
 
-def pack_allreduce_split(pack_list, shapes, group, reduce_method):
+def pack_allreduce_split(
+    pack_list, shapes, group, reduce_method, compression=None, key=None
+):
     offsets_val = get_offsets(shapes)
     offsets = Tensor(offsets_val)
     packed_grads = param_pack_concat(pack_list, offsets, offsets_val)
 
-    packed_grads = all_reduce_sum(packed_grads, group, group.comp_node)
+    if compression is not None:
+        packed_grads = compression.all_reduce_sum(key, packed_grads, group)
+    else:
+        packed_grads = all_reduce_sum(packed_grads, group, group.comp_node)
     if reduce_method == "mean":
         packed_grads /= group.size
     grads = param_pack_split(packed_grads, offsets_val, shapes)
@@ -214,19 +220,49 @@ def bcast_list_(inps: list, group: Group = WORLD):
 class AllreduceCallback:
     r"""Allreduce Callback with tensor fusion optimization.
 
+    The gradients are packed in the order they are produced in backward. The
+    packs of the first iteration are kept as buckets for the later ones, and a
+    bucket is reduced as soon as all its gradients are produced. The first
+    bucket is kept small so that the communication starts early in backward.
+
     Args:
         reduce_method: the method to reduce gradiants.
         group: communication group.
         backend: override distributed backend in allreduce
+        compression: the :class:`~.Compression` of the float32 gradients, or a
+            function that returns the compression of each parameter, possibly
+            None, so that the parameters with different compressions are packed
+            separately. Default: None
+
+    Examples:
+
+        .. code-block::
+
+           from megengine.distributed.compression import FP16Compression
+           cb = dist.make_allreduce_cb("mean", compression=FP16Compression())
     """
 
-    def __init__(self, reduce_method: str, group: Group = WORLD, backend: str = None):
+    def __init__(
+        self,
+        reduce_method: str,
+        group: Group = WORLD,
+        backend: str = None,
+        compression=None,
+    ):
         reduce_method = reduce_method.lower()
         assert reduce_method in ["sum", "mean"], "reduce_method should be sum or mean"
         self._reduce_method = reduce_method
         self._group = group
+        self._compression = compression
+        # compressions in the order of their first use, which is the same on
+        # all ranks and orders the packs
+        self._compressions = [None]
         self._marked_gm = WeakSet()
         self._param_pack_thd = 10 * 1024 * 1024
+        self._first_bucket_thd = 1024 * 1024
+        # param => index of its bucket, learned from the first iteration
+        self._bucket_of = None
+        self._bucket_sizes = []
         self._reset()
         if backend is None:
             assert _group._sd, "please call init_process_group first"
@@ -245,20 +281,60 @@ class AllreduceCallback:
         self._packing_list = defaultdict(list)
         self._packing_size = defaultdict(int)
         self._grad_origin_device = dict()
-
-    def _pack(self, dtype):
-        if len(self._packing_list[dtype]) == 0:
+        self._produced = []
+
+    def _make_buckets(self):
+        self._bucket_of = dict()
+        self._bucket_sizes = []
+        open_buckets = dict()
+        for param, pack_key, size in self._produced:
+            if param in self._bucket_of:
+                continue
+            if pack_key not in open_buckets:
+                open_buckets[pack_key] = [len(self._bucket_sizes), 0]
+                self._bucket_sizes.append(0)
+            bucket = open_buckets[pack_key]
+            self._bucket_of[param] = bucket[0]
+            self._bucket_sizes[bucket[0]] += 1
+            bucket[1] += size
+            thd = self._param_pack_thd
+            if bucket[0] == 0:
+                thd = min(thd, self._first_bucket_thd)
+            if bucket[1] > thd:
+                del open_buckets[pack_key]
+
+    def _get_compression(self, param, dtype_str):
+        compression = self._compression
+        if compression is None or dtype_str != "float32":
+            return 0
+        if not isinstance(compression, Compression):
+            compression = compression(param)
+        for i, c in enumerate(self._compressions):
+            if c is compression:
+                return i
+        self._compressions.append(compression)
+        return len(self._compressions) - 1
+
+    def _pack(self, pack_key):
+        if len(self._packing_list[pack_key]) == 0:
             return
-        grad_list = [self._gradients_dict[p] for p in self._packing_list[dtype]]
-        shapes = [p._tuple_shape for p in self._packing_list[dtype]]
+        grad_list = [self._gradients_dict[p] for p in self._packing_list[pack_key]]
+        shapes = [p._tuple_shape for p in self._packing_list[pack_key]]
+        compression = self._compressions[pack_key[1]]
+        key = tuple(id(p) for p in self._packing_list[pack_key])
         with override_backend(self._backend):
             reduced_grads = pack_allreduce_split(
-                grad_list, shapes, self._group, self._reduce_method
+                grad_list,
+                shapes,
+                self._group,
+                self._reduce_method,
+                compression,
+                key,
             )
-        for param, grad in zip(self._packing_list[dtype], reduced_grads):
+        for param, grad in zip(self._packing_list[pack_key], reduced_grads):
             self._gradients_dict[param] = grad
-        self._packing_list[dtype] = []
-        self._packing_size[dtype] = 0
+        self._packing_list[pack_key] = []
+        self._packing_size[pack_key] = 0
 
     def __call__(self, param, grad):
         gm = get_backwarding_grad_manager()
@@ -273,15 +349,31 @@ class AllreduceCallback:
 
         dtype_str = str(np.dtype(param.dtype))
         dtype_size = np.dtype(param.dtype).itemsize
-        self._packing_list[dtype_str].append(param)
-        self._packing_size[dtype_str] += int(np.prod(param._tuple_shape)) * dtype_size
-        if self._packing_size[dtype_str] > self._param_pack_thd:
-            self._pack(dtype_str)
+        pack_key = (dtype_str, self._get_compression(param, dtype_str))
+        nbytes = int(np.prod(param._tuple_shape)) * dtype_size
+        if self._bucket_of is None:
+            self._produced.append((param, pack_key, nbytes))
+        elif param in self._bucket_of:
+            bucket = self._bucket_of[param]
+            pack_key = pack_key + (bucket,)
+            self._packing_list[pack_key].append(param)
+            if len(self._packing_list[pack_key]) == self._bucket_sizes[bucket]:
+                self._pack(pack_key)
+            return self._futures_dict[param]
+        # params not seen in the first iteration are packed by size
+        self._packing_list[pack_key].append(param)
+        self._packing_size[pack_key] += nbytes
+        if self._packing_size[pack_key] > self._param_pack_thd:
+            self._pack(pack_key)
         return self._futures_dict[param]
 
     def _flush(self):
-        for dtype in sorted(self._packing_list.keys()):
-            self._pack(dtype)
+        # buckets that are not full, e.g. some params get no gradient in this
+        # iteration, are reduced here in the same order on all ranks
+        for pack_key in sorted(self._packing_list.keys()):
+            self._pack(pack_key)
+        if self._bucket_of is None:
+            self._make_buckets()
         for param in self._params:
             grad = self._gradients_dict[param]
             grad = copy(grad, self._grad_origin_device[param])
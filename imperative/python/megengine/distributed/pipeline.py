@@ -0,0 +1,159 @@
+# -*- coding: utf-8 -*-
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+from collections import deque
+from typing import Callable, Iterable, Optional
+
+from ..autodiff import GradManager
+from ..device import get_default_device
+from ..functional.tensor import split
+from ..module import Module
+from ..tensor import Tensor
+from .functional import remote_recv, remote_send
+from .group import get_rank, get_world_size
+
+
+def _stream_device(device, stream):
+    return "{}:{}".format(str(device).split(":")[0], stream)
+
+
+class PipelineExecutor:
+    r"""Trains a model split into stages, one stage on each rank, with micro
+    batches scheduled in the one-forward-one-backward (1F1B) way.
+
+    Each stage runs at most as many forwards ahead of its backwards as the
+    stages after it, then alternates a forward and a backward, so the
+    activations of at most ``num_stages - stage`` micro batches are alive, and
+    those of a micro batch are released as soon as its backward is done.
+
+    The activations are sent to the next stage and the gradients to the
+    previous stage on two streams other than the computing one, so the
+    transfers overlap the computation of other micro batches, and those in the
+    two directions do not wait for each other.
+
+    The gradients are accumulated into the ``grad`` of the params of the
+    stage, and the loss of each micro batch is divided by ``num_microbatches``,
+    so the gradients equal those of the whole batch when the loss is averaged
+    over the samples.
+
+    Args:
+        module: the stage of this rank.
+        num_microbatches: number of micro batches each batch is split into.
+        loss_fn: called with the output of the last stage and the labels of a
+            micro batch to get its loss. Only needed on the last stage.
+        ranks: ranks of the stages in order. Default: all the ranks
+        device: device of the stage. Default: the default device
+
+    Examples:
+
+        .. code-block::
+
+           pipe = dist.PipelineExecutor(stages[dist.get_rank()], 8, F.nn.cross_entropy)
+           loss = pipe.step(data, label)  # None except on the last stage
+           opt.step().clear_grad()
+    """
+
+    def __init__(
+        self,
+        module: Module,
+        num_microbatches: int,
+        loss_fn: Optional[Callable] = None,
+        ranks: Optional[Iterable[int]] = None,
+        device: Optional[str] = None,
+    ):
+        assert num_microbatches > 0, "num_microbatches should be positive"
+        if ranks is None:
+            ranks = range(get_world_size())
+        ranks = list(ranks)
+        self._module = module
+        self._num_microbatches = num_microbatches
+        self._loss_fn = loss_fn
+        self._num_stages = len(ranks)
+        self._stage = ranks.index(get_rank())
+        self._prev = ranks[self._stage - 1] if not self.is_first_stage else None
+        self._next = ranks[self._stage + 1] if not self.is_last_stage else None
+        assert loss_fn is not None or not self.is_last_stage, "loss_fn is needed"
+        if device is None:
+            device = get_default_device()
+        self._device = device
+        self._forward_device = _stream_device(device, 1)
+        self._backward_device = _stream_device(device, 2)
+        self._params = list(module.parameters())
+
+    @property
+    def is_first_stage(self):
+        return self._stage == 0
+
+    @property
+    def is_last_stage(self):
+        return self._stage == self._num_stages - 1
+
+    @property
+    def bubble_ratio(self):
+        r"""Fraction of the time that a stage is idle in a step, assuming the
+        stages take the same time."""
+        s = self._num_stages
+        return (s - 1) / (self._num_microbatches + s - 1)
+
+    def step(self, data: Optional[Tensor] = None, label: Optional[Tensor] = None):
+        r"""Runs the forwards and backwards of a batch.
+
+        Args:
+            data: input of the batch, only needed on the first stage.
+            label: labels of the batch, only needed on the last stage.
+
+        Returns:
+            the loss of the batch on the last stage, and None on the others.
+        """
+        m = self._num_microbatches
+        self._inputs = deque(split(data, m) if self.is_first_stage else [])
+        self._labels = deque(split(label, m) if self.is_last_stage else [])
+        self._pending = deque()
+        self._loss = None
+
+        warmup = min(self._num_stages - self._stage - 1, m)
+        for _ in range(warmup):
+            self._forward()
+        for _ in range(m - warmup):
+            self._forward()
+            self._backward()
+        for _ in range(warmup):
+            self._backward()
+
+        loss, self._loss = self._loss, None
+        return loss
+
+    def _forward(self):
+        if self.is_first_stage:
+            x = self._inputs.popleft()
+        else:
+            x = remote_recv(self._prev, device=self._forward_device)
+            x = x.to(self._device)
+        gm = GradManager().attach(self._params)
+        if not self.is_first_stage:
+            gm.attach([x])
+        gm.record()
+        y = self._module(x)
+        if self.is_last_stage:
+            y = self._loss_fn(y, self._labels.popleft()) / self._num_microbatches
+        else:
+            remote_send(y.detach().to(self._forward_device), self._next)
+        self._pending.append((gm, x, y))
+
+    def _backward(self):
+        gm, x, y = self._pending.popleft()
+        if self.is_last_stage:
+            gm.backward(y)
+            loss = y.detach()
+            self._loss = loss if self._loss is None else self._loss + loss
+        else:
+            dy = remote_recv(self._next, device=self._backward_device)
+            dy = dy.to(self._device)
+            gm.backward(y, dy)
+        if not self.is_first_stage:
+            remote_send(x.grad.to(self._backward_device), self._prev)
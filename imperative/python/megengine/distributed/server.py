@@ -157,7 +157,10 @@ class Methods:
 
 
 class ThreadXMLRPCServer(ThreadingMixIn, SimpleXMLRPCServer):
-    pass
+    # all the ranks connect at startup, which overflows the default backlog of 5
+    # and makes the refused ones retry after a while
+    request_queue_size = 1024
+    daemon_threads = True
 
 
 def _start_server(py_server_port, queue):
@@ -219,6 +222,7 @@ class Client:
 
     def connect(self):
         r"""Check connection success."""
+        interval = 0.01
         while True:
             try:
                 self.proxy = ServerProxy(
@@ -227,7 +231,8 @@ class Client:
                 if self.proxy.connect():
                     break
             except:
-                time.sleep(1)
+                time.sleep(interval)
+                interval = min(interval * 2, 1)
 
     def get_mm_server_port(self):
         r"""Get multiple machine server port."""
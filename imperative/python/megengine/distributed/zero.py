@@ -0,0 +1,155 @@
+# -*- coding: utf-8 -*-
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+from collections import defaultdict
+from typing import Iterable, Union
+
+import numpy as np
+
+from ..functional.tensor import zeros, zeros_like
+from ..tensor import Parameter, Tensor
+from .functional import all_gather, reduce_scatter_sum
+from .group import WORLD, Group
+from .helper import get_offsets, param_pack_concat, param_pack_split
+
+
+class _ShardedPack:
+    r"""Params of the same dtype packed into a flat tensor, which is padded to be
+    split equally among the ranks, and the shard of this rank."""
+
+    def __init__(self, params, group):
+        self.params = params
+        self.shapes = [p._tuple_shape for p in params]
+        numel = sum(int(np.prod(s)) for s in self.shapes)
+        self.shard_size = (numel + group.size - 1) // group.size
+        self.padding = self.shard_size * group.size - numel
+        self.pack_shapes = self.shapes + ([(self.padding,)] if self.padding else [])
+        self.offsets_val = get_offsets(self.pack_shapes)
+        self.offsets = Tensor(self.offsets_val)
+        begin = group.rank * self.shard_size
+        flat = self.concat(params)
+        self.shard = Parameter(flat[begin : begin + self.shard_size])
+
+    def concat(self, tensors):
+        tensors = list(tensors)
+        if self.padding:
+            p = self.params[0]
+            tensors.append(zeros((self.padding,), dtype=p.dtype, device=p.device))
+        return param_pack_concat(tensors, self.offsets, self.offsets_val)
+
+    def split(self, inp):
+        return param_pack_split(inp, self.offsets_val, self.pack_shapes)[
+            : len(self.params)
+        ]
+
+
+class ZeroOptimizer:
+    r"""Wraps an optimizer to shard its states and the reduced gradients among the
+    ranks of a group, as the stage 2 of ZeRO.
+
+    The params of each param group are packed by dtype, and each rank keeps only
+    its shard of every pack, on which the wrapped optimizer is created. In
+    :meth:`step`, the gradients are reduce scattered into the shards, the
+    shards are updated, and the params are all gathered from the updated
+    shards. So the memory of the optimizer states is divided by the group size.
+
+    The gradients should not be reduced by an allreduce callback of the
+    :class:`~.GradManager`.
+
+    Args:
+        optimizer_cls: the optimizer to wrap, such as :class:`~.Adam`.
+        params: params to optimize, or dicts defining param groups.
+        group: communication group.
+        reduce_method: the method to reduce gradients, "sum" or "mean".
+        kwargs: arguments of ``optimizer_cls`` other than the params.
+
+    Examples:
+
+        .. code-block::
+
+           opt = dist.ZeroOptimizer(optim.Adam, model.parameters(), lr=1e-3)
+           gm = GradManager().attach(model.parameters())
+           with gm:
+               gm.backward(loss)
+           opt.step().clear_grad()
+    """
+
+    def __init__(
+        self,
+        optimizer_cls,
+        params: Union[Iterable[Parameter], dict],
+        group: Group = WORLD,
+        reduce_method: str = "mean",
+        **kwargs
+    ):
+        reduce_method = reduce_method.lower()
+        assert reduce_method in ["sum", "mean"], "reduce_method should be sum or mean"
+        self._group = group
+        self._reduce_method = reduce_method
+        if isinstance(params, (Parameter, dict)):
+            params = [params]
+        param_groups = list(params)
+        if not isinstance(param_groups[0], dict):
+            param_groups = [{"params": param_groups}]
+
+        self._packs = []
+        shard_groups = []
+        for param_group in param_groups:
+            param_group = dict(param_group)
+            group_params = param_group.pop("params")
+            if isinstance(group_params, Parameter):
+                group_params = [group_params]
+            by_dtype = defaultdict(list)
+            for p in group_params:
+                by_dtype[str(np.dtype(p.dtype))].append(p)
+            shards = []
+            for dtype in sorted(by_dtype.keys()):
+                pack = _ShardedPack(by_dtype[dtype], group)
+                self._packs.append(pack)
+                shards.append(pack.shard)
+            shard_groups.append(dict(param_group, params=shards))
+        self._optimizer = optimizer_cls(shard_groups, **kwargs)
+
+    @property
+    def param_groups(self):
+        r"""The param groups of the wrapped optimizer, whose params are shards."""
+        return self._optimizer.param_groups
+
+    def step(self):
+        r"""Performs a single optimization step on the shards and gathers the
+        params."""
+        for pack in self._packs:
+            grads = [
+                p.grad if p.grad is not None else zeros_like(p) for p in pack.params
+            ]
+            grad = reduce_scatter_sum(pack.concat(grads), self._group)
+            if self._reduce_method == "mean":
+                grad /= self._group.size
+            pack.shard.grad = grad
+        self._optimizer.step()
+        for pack in self._packs:
+            values = pack.split(all_gather(pack.shard, self._group))
+            for param, value in zip(pack.params, values):
+                param._reset(value)
+        return self
+
+    def clear_grad(self):
+        r"""Set the grad attribute to None for all parameters and shards."""
+        for pack in self._packs:
+            for param in pack.params:
+                param.grad = None
+        self._optimizer.clear_grad()
+        return self
+
+    def state_dict(self, keep_var=False):
+        r"""Export the states of the shards of this rank."""
+        return self._optimizer.state_dict(keep_var)
+
+    def load_state_dict(self, state: dict):
+        r"""Loads the states of the shards of this rank."""
+        self._optimizer.load_state_dict(state)
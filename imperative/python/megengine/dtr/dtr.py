@@ -13,8 +13,12 @@ from ..core._imperative_rt.core2 import set_option as _set_option
 from ..core._imperative_rt.utils import _set_defrag
 
 _eviction_threshold = 0
+_eviction_low_watermark = 0
 _evictee_minimum_size = 1024 ** 2
 _enable_sqrt_sampling = False
+_enable_profile_compute_time = False
+_candidate_scan_depth = 64
+_swap_bandwidth = 0
 
 
 def _str2bytes(text: str) -> int:
@@ -60,6 +64,41 @@ def eviction_threshold(mod, value: Union[int, str]):
     _set_option("dtr_eviction_threshold", _eviction_threshold)
 
 
+@property
+def eviction_low_watermark(mod):
+    r"""Get or set the low watermark of eviction in bytes. It can also be set to a
+    string, whose formatting supports byte(B), kilobyte(KB), megabyte(MB) and
+    gigabyte(GB) units.
+
+    Note:
+       Once GPU memory usage exceeds the eviction threshold, DTR will keep
+       evicting tensors until the amount of used memory falls below this value,
+       so that eviction happens in fewer and larger rounds instead of on almost
+       every operator. 0 or a value not below the threshold means evicting down
+       to the threshold. The default value is 0.
+
+    Examples:
+        .. code-block::
+
+           import megengine as mge
+           mge.dtr.eviction_threshold = "2GB"
+           mge.dtr.eviction_low_watermark = "1.8GB"
+    """
+    return _eviction_low_watermark
+
+
+@eviction_low_watermark.setter
+def eviction_low_watermark(mod, value: Union[int, str]):
+    global _eviction_low_watermark
+    if isinstance(value, str):
+        _eviction_low_watermark = _str2bytes(value)
+    elif isinstance(value, int):
+        _eviction_low_watermark = value
+    else:
+        raise TypeError("`value` should be a str or an int")
+    _set_option("dtr_eviction_low_watermark", _eviction_low_watermark)
+
+
 @property
 def evictee_minimum_size(mod):
     r"""Get or set the memory threshold of tensors in bytes. It can also be set to a
@@ -116,6 +155,77 @@ def enable_sqrt_sampling(mod, value: bool):
     _set_option("enable_dtr_sqrt_sampling", _enable_sqrt_sampling)
 
 
+@property
+def enable_profile_compute_time(mod):
+    r"""Get or set whether to measure the compute time of each distinct operator
+    on its first execution and use it as the recompute cost, rather than
+    estimating the cost by memory traffic. Measuring synchronizes the device
+    once for each distinct operator, which slows down the first iteration.
+
+    Examples:
+        .. code-block::
+
+           import megengine as mge
+           mge.dtr.enable_profile_compute_time = True
+    """
+    return _enable_profile_compute_time
+
+
+@enable_profile_compute_time.setter
+def enable_profile_compute_time(mod, value: bool):
+    global _enable_profile_compute_time
+    _enable_profile_compute_time = value
+    _set_option("enable_dtr_profile_compute_time", _enable_profile_compute_time)
+
+
+@property
+def candidate_scan_depth(mod):
+    r"""Get or set the number of least recently used tensors evaluated in each
+    size bucket of the candidate set when choosing a tensor to evict. 0 means
+    evaluating all candidates. The default value is 64.
+
+    Examples:
+        .. code-block::
+
+           import megengine as mge
+           mge.dtr.candidate_scan_depth = 0
+    """
+    return _candidate_scan_depth
+
+
+@candidate_scan_depth.setter
+def candidate_scan_depth(mod, value: int):
+    assert value >= 0, "candidate_scan_depth must be non-negative"
+    global _candidate_scan_depth
+    _candidate_scan_depth = value
+    _set_option("dtr_candidate_scan_depth", _candidate_scan_depth)
+
+
+@property
+def swap_bandwidth(mod):
+    r"""Get or set the bandwidth between GPU and host memory in MB/s. When it is
+    not 0, DTR estimates the cost of swapping a tensor to host memory and back
+    with it, and swaps the tensor instead of dropping it if that is cheaper than
+    recomputing it. Swapped tensors are kept in pinned host memory until they
+    are needed again. The default value is 0, which disables swapping.
+
+    Examples:
+        .. code-block::
+
+           import megengine as mge
+           mge.dtr.swap_bandwidth = 10240
+    """
+    return _swap_bandwidth
+
+
+@swap_bandwidth.setter
+def swap_bandwidth(mod, value: int):
+    assert value >= 0, "swap_bandwidth must be non-negative"
+    global _swap_bandwidth
+    _swap_bandwidth = value
+    _set_option("dtr_swap_bandwidth", _swap_bandwidth)
+
+
 def enable():
     r"""Enable to record computing path of tensors and to perform DTR policy."""
     _set_defrag(True)
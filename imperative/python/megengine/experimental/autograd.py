@@ -10,10 +10,13 @@
 from ..core._imperative_rt.core2 import (
     set_allow_higher_order_directive as _set_allow_higher_order_directive,
 )
+from ..core._imperative_rt.core2 import set_fused_backward as _set_fused_backward
 
 __all__ = [
     "enable_higher_order_directive",
     "disable_higher_order_directive",
+    "enable_fused_backward",
+    "disable_fused_backward",
 ]
 
 
@@ -23,3 +26,16 @@ def enable_higher_order_directive():
 
 def disable_higher_order_directive():
     _set_allow_higher_order_directive(False)
+
+
+def enable_fused_backward():
+    r"""Run backward as a single compiled op when the ops recorded are all
+    differentiated by backward graphs, which are fused and cached by the structure
+    of the tape. It reduces the host overhead of repeated training steps, but costs
+    a compilation for each new structure, so models of dynamic structures should
+    not enable it."""
+    _set_fused_backward(True)
+
+
+def disable_fused_backward():
+    _set_fused_backward(False)
@@ -17,3 +17,14 @@ def _inplace_add_(dest, delta, alpha, beta):
     if isscalar:
         dest._setscalar()
     return dest
+
+
+def _multi_tensor_update_(op, dests, inputs):
+    outputs = apply(op, *inputs)
+    assert len(outputs) == len(dests)
+    for dest, output in zip(dests, outputs):
+        isscalar = dest._isscalar()
+        dest._reset(output)
+        if isscalar:
+            dest._setscalar()
+    return dests
@@ -9,7 +9,7 @@
 import collections
 import math
 from functools import lru_cache
-from typing import Optional, Sequence, Tuple, Union
+from typing import Iterable, Optional, Sequence, Tuple, Union
 
 from ..core._imperative_rt.core2 import apply, dtype_promotion
 from ..core._imperative_rt.ops import SubgraphBuilder as _SubgraphBuilder
@@ -18,7 +18,7 @@ from ..core.ops import builtin
 from ..core.ops.builtin import BatchNorm, Elemwise, GetVarShape, Reduce, TypeCvt
 from ..core.ops.special import Const
 from ..core.tensor import amp
-from ..core.tensor.utils import _normalize_axis, cast_tensors, setscalar, subgraph
+from ..core.tensor.utils import _normalize_axis, setscalar, subgraph
 from ..jit import exclude_from_trace
 from ..tensor import Tensor
 from .debug_param import get_execution_strategy
@@ -1064,10 +1064,8 @@ def matmul(
             [[10. 13.]
              [28. 40.]]
     """
-    if amp._enabled:
-        compute_mode = "float32"
-        inp1, inp2 = cast_tensors(inp1, inp2)
-    else:
+    # inputs are autocast to low precision by the dispatcher when amp is enabled
+    if not amp._enabled:
         dtype = dtype_promotion(inp1, inp2)
         if inp1.dtype != dtype:
             inp1 = inp1.astype(dtype)
@@ -1181,16 +1179,29 @@ def svd(inp: Tensor, full_matrices=False, compute_uv=True) -> Tensor:
     return U, sigma, V
 
 
-def _check_non_finite(inp: Tensor) -> Tensor:
-    r"""Check whether input contains infinite or nan value.
+def _check_non_finite(inps: Iterable[Tensor], scale=1.0) -> Tensor:
+    r"""Check whether any of the inputs contains infinite or nan value, and
+    multiply the inputs by ``scale`` inplace. All the inputs are handled by one
+    kernel.
 
     Args:
-        inp: a tensor to be checked.
+        inps: a tensor or a list of tensors to be checked.
+        scale: the factor the inputs are multiplied by.
 
     Returns:
         a int32 scalar tensor, 0 for False and 1 for True.
     """
-    op = builtin.CheckNonFinite()
-    (oup,) = apply(op, inp.reshape(-1).astype("float32"))
-    oup._setscalar()
-    return oup
+    if isinstance(inps, Tensor):
+        inps = [inps]
+    inps = list(inps)
+    f32_inps = [i if i.dtype == "float32" else i.astype("float32") for i in inps]
+    op = builtin.CheckNonFiniteV2(scale=scale)
+    oups = apply(op, *f32_inps)
+    for inp, oup in zip(inps, oups[:-1]):
+        if oup.dtype != inp.dtype:
+            if scale == 1.0:
+                continue
+            oup = oup.astype(inp.dtype)
+        inp._reset(oup)
+    oups[-1]._setscalar()
+    return oups[-1]
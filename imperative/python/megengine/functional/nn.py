@@ -118,7 +118,7 @@ def linear(
     ret = matmul(inp, weight, transpose_b=True, compute_mode=compute_mode)
     if bias is not None:
         if amp._enabled:
-            bias = bias.astype("float16")
+            (bias,) = cast_tensors(bias)
         ret += bias
     return ret
 
@@ -165,9 +165,9 @@ def conv1d(
     assert compute_mode.lower() == "default" or compute_mode.name == "DEFAULT"
     assert inp.ndim == 3, "the input dimension of conv1d should be 3"
     assert weight.ndim == 3, "the weight dimension of conv1d should be 3"
+    # inp and weight are autocast by the dispatcher when amp is enabled
     if amp._enabled:
-        compute_mode = "float32"
-        inp, weight, bias = cast_tensors(inp, weight, bias)
+        (bias,) = cast_tensors(bias)
     else:
         dtype = dtype_promotion(inp, weight)
         if inp.dtype != dtype:
@@ -246,9 +246,9 @@ def conv2d(
         conv_mode.lower() == "cross_correlation"
         or conv_mode.name == "CROSS_CORRELATION"
     )
+    # inp and weight are autocast by the dispatcher when amp is enabled
     if amp._enabled:
-        compute_mode = "float32"
-        inp, weight, bias = cast_tensors(inp, weight, bias)
+        (bias,) = cast_tensors(bias)
     else:
         dtype = dtype_promotion(inp, weight)
         if inp.dtype != dtype:
@@ -387,9 +387,9 @@ def conv_transpose2d(
         conv_mode.lower() == "cross_correlation"
         or conv_mode.name == "CROSS_CORRELATION"
     )
+    # inp and weight are autocast by the dispatcher when amp is enabled
     if amp._enabled:
-        compute_mode = "float32"
-        inp, weight, bias = cast_tensors(inp, weight, bias)
+        (bias,) = cast_tensors(bias)
     else:
         dtype = dtype_promotion(inp, weight)
         if inp.dtype != dtype:
@@ -464,8 +464,7 @@ def deformable_conv2d(
         or conv_mode.name == "CROSS_CORRELATION"
     )
     if amp._enabled:
-        compute_mode = "float32"
-        inp, weight, offset, mask, bias = cast_tensors(inp, weight, offset, mask, bias)
+        (bias,) = cast_tensors(bias)
     else:
         offset = offset.astype("float32")
         mask = mask.astype("float32")
@@ -1020,10 +1019,9 @@ def softmax(inp: Tensor, axis: Optional[int] = None) -> Tensor:
     """
     if axis is None:
         axis = _get_softmax_axis(len(inp.shape))
-    offset = inp.max(axis=axis, keepdims=True).detach()
-    cached = exp(inp - offset)
-    down = sum(cached, axis=axis, keepdims=True)
-    return cached / down
+    op = builtin.Softmax(axis=axis)
+    (output,) = apply(op, inp)
+    return output
 
 
 @lru_cache(maxsize=None)
@@ -1094,6 +1092,24 @@ def layer_norm(
     if amp._enabled:
         inp, weight, bias = cast_tensors(inp, weight, bias, promote=True)
 
+    if eps_mode.lower() == "additive":
+        # mean and rstd are computed by a single fused kernel; only the
+        # "max" eps mode needs the elemwise subgraph below
+        normalized_size = 1
+        for i in normalized_shape:
+            normalized_size *= i
+        op = builtin.LayerNorm(
+            affine=affine,
+            eps=eps,
+            normalized_dim=len(normalized_shape),
+            normalized_size=normalized_size,
+        )
+        if affine:
+            outvar, *_ = apply(op, inp, weight, bias)
+        else:
+            outvar, *_ = apply(op, inp)
+        return outvar
+
     _device = inp.device
     _dtype = inp.dtype
     _dim = len(inp.shape) - len(normalized_shape)
@@ -1115,6 +1131,70 @@ def layer_norm(
     return outvar
 
 
+def group_norm(
+    inp: Tensor,
+    num_groups: int,
+    affine: bool,
+    weight: Optional[Tensor] = None,
+    bias: Optional[Tensor] = None,
+    eps: float = 1e-5,
+):
+    r"""Applies group normalization to the input.
+
+    The channels (axis 1) of ``inp`` are divided into ``num_groups`` groups, and
+    each group of a sample is normalized by a single fused kernel.
+
+    Refer to :class:`~.GroupNorm` for more information.
+
+    Args:
+        inp: input tensor of shape :math:`(N, C, ...)`.
+        num_groups: number of groups to separate the channels into.
+        affine: whether to apply the per-channel ``weight`` and ``bias``.
+        weight: scaling tensor of shape :math:`(C,)`.
+        bias: bias tensor of shape :math:`(C,)`.
+        eps: a value added to the variance for numerical stability.
+    """
+    op = builtin.GroupNorm(affine=affine, eps=eps, group=num_groups)
+    if affine:
+        outvar, *_ = apply(op, inp, weight, bias)
+    else:
+        outvar, *_ = apply(op, inp)
+    return outvar
+
+
+def fused_attention(
+    query: Tensor, key: Tensor, value: Tensor, scale: Optional[float] = None
+) -> Tensor:
+    r"""Computes :math:`\text{softmax}(query \cdot key^T \cdot scale) \cdot value`
+    by a single fused kernel, without materializing the attention scores.
+
+    All the axes but the last two are batch axes, e.g. the batch and the
+    attention heads of multi-head attention.
+
+    Args:
+        query: tensor of shape :math:`(..., S, D)`.
+        key: tensor of shape :math:`(..., T, D)`.
+        value: tensor of shape :math:`(..., T, D_v)`.
+        scale: factor applied to the scores. Default: :math:`1 / \sqrt{D}`
+
+    Returns:
+        output tensor of shape :math:`(..., S, D_v)`.
+    """
+    assert query.ndim >= 3 and query.ndim == key.ndim == value.ndim
+    if scale is None:
+        scale = query.shape[-1] ** -0.5
+    batch_shape = query.shape[:-2]
+    if query.ndim > 3:
+        query, key, value = (
+            x.reshape((-1,) + x.shape[-2:]) for x in (query, key, value)
+        )
+    op = builtin.FusedAttention(scale=scale)
+    (output,) = apply(op, query, key, value)
+    if len(batch_shape) > 1:
+        output = output.reshape(batch_shape + output.shape[-2:])
+    return output
+
+
 def batch_norm(
     inp: Tensor,
     running_mean: Tensor = None,
@@ -1127,7 +1207,8 @@ def batch_norm(
     eps: float = 1e-5,
     inplace: bool = True,
     compute_mode="default",
-    param_dim="dim_1c11"
+    param_dim="dim_1c11",
+    nonlinear_mode="identity"
 ):
     r"""Applies batch normalization to the input.
 
@@ -1148,6 +1229,9 @@ def batch_norm(
         eps: a value added to the denominator for numerical stability. Default: 1e-5
         inplace: whether to update ``running_mean`` and ``running_var``
             inplace or return new tensors. Default: True
+        nonlinear_mode: "identity" or "relu"; with "relu", ``relu`` is fused into
+            batch norm, and only a bitmask of the output is kept for backward in
+            training mode. Default: "identity"
     """
     if inp.ndim != 4:
         raise NotImplementedError("batch_norm for ndim != 4")
@@ -1185,24 +1269,25 @@ def batch_norm(
     if has_var and running_var.ndim != 4:
         raise ValueError
 
-    if amp._enabled:
-        inp = inp.astype("float16")
-        weight, bias, running_mean, running_var = cast_tensors(
-            weight, bias, running_mean, running_var, promote=True
-        )
     weight = make_full_if_none(weight, 1)
     bias = make_full_if_none(bias, 0)
 
     if not training:
         op = builtin.BatchNorm(
-            fwd_mode=BatchNorm.FwdMode.INFERENCE, epsilon=eps, param_dim=param_dim
+            fwd_mode=BatchNorm.FwdMode.INFERENCE,
+            epsilon=eps,
+            param_dim=param_dim,
+            nonlineMode=nonlinear_mode,
         )
         ret = apply(op, inp, weight, bias, running_mean, running_var)[-1]
         return ret
 
     else:
         op = builtin.BatchNorm(
-            avg_factor=1 - momentum, epsilon=eps, param_dim=param_dim
+            avg_factor=1 - momentum,
+            epsilon=eps,
+            param_dim=param_dim,
+            nonlineMode=nonlinear_mode,
         )
         if has_mean or has_var:
             running_mean = make_full_if_none(running_mean, 0)
@@ -15,11 +15,15 @@ class GraphOptimizationConfig:
     Args:
         jit_fuse_dimshuffle: whether to fuse dimshuffle in JIT optimization
         jit_fuse_reduce: whether to fuse reduce in JIT optimization
+        conv_format_nhwc: whether to run the float16 convolutions and their
+            gradients in NHWC format, which enables the tensorcore NHWC kernels
+            of cuDNN in mixed precision training. Only True turns it on.
     """
 
     def __init__(self):
         self.jit_fuse_dimshuffle = None
         self.jit_fuse_reduce = None
+        self.conv_format_nhwc = None
 
     def __repr__(self):
         val2str = {None: "UNSET", False: "OFF", True: "ON"}
@@ -29,5 +33,7 @@ class GraphOptimizationConfig:
             + val2str[self.jit_fuse_dimshuffle]
             + ", jit_fuse_reduce = "
             + val2str[self.jit_fuse_reduce]
+            + ", conv_format_nhwc = "
+            + val2str[self.conv_format_nhwc]
             + " }"
         )
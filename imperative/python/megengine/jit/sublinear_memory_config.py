@@ -29,6 +29,12 @@ class SublinearMemoryConfig:
             in sublinear memory optimization. Default: half of cpu number in the system.
             Note: the value must be greater or equal to one.
             It can also be set through the environmental variable 'MGB_SUBLINEAR_MEMORY_WORKERS'.
+        genetic_early_stop: stop the genetic algorithm if the bottleneck is not improved in this
+            number of iterations; 0 to disable. Default: 0.
+            It can also be set through the environmental variable 'MGB_SUBLINEAR_MEMORY_GENETIC_EARLY_STOP'.
+        enable_plan_cache: whether to save the searched checkpoints in the persistent cache, so that
+            compiling the same graph again (e.g. after restarting the job with a persistent cache)
+            skips the search. Default: True.
     
     Note that the environmental variable MGB_COMP_GRAPH_OPT must be set to 'enable_sublinear_memory_opt=1'
     in order for the above environmental variable to be effective.
@@ -41,6 +47,8 @@ class SublinearMemoryConfig:
         genetic_pool_size: int = 20,
         lb_memory_mb: int = 0,
         num_worker: int = max(1, get_device_count("cpu") // 2),
+        genetic_early_stop: int = 0,
+        enable_plan_cache: bool = True,
     ):
         assert thresh_nr_try >= 0, "thresh_nr_try must be greater or equal to zero"
         self.thresh_nr_try = thresh_nr_try
@@ -53,3 +61,8 @@ class SublinearMemoryConfig:
         self.lb_memory_mb = lb_memory_mb
         assert num_worker > 0, "num_worker must be greater or equal to one"
         self.num_worker = num_worker
+        assert (
+            genetic_early_stop >= 0
+        ), "genetic_early_stop must be greater or equal to zero"
+        self.genetic_early_stop = genetic_early_stop
+        self.enable_plan_cache = enable_plan_cache
@@ -9,6 +9,8 @@
 import collections
 import contextlib
 import functools
+import hashlib
+import inspect
 import itertools
 import json
 import os
@@ -17,7 +19,12 @@ from typing import Any
 
 import numpy as np
 
-from ..core._imperative_rt import GraphProfiler, GraphProfiler2, SerializationMetadata
+from ..core._imperative_rt import (
+    GraphOptimizeOptions,
+    GraphProfiler,
+    GraphProfiler2,
+    SerializationMetadata,
+)
 from ..core._imperative_rt.core2 import Tensor as RawTensor
 from ..core._imperative_rt.core2 import (
     TensorWeakRef,
@@ -38,12 +45,29 @@ from ..core._wrap import as_device
 from ..core.ops.builtin import BatchNorm, OpDef
 from ..core.tensor import megbrain_graph as G
 from ..core.tensor.utils import setscalar
+from ..logger import get_logger
 from ..utils.naming import AutoNaming
 from ..utils.profiler import is_profiling
 from .dtr_config import DTRConfig
 from .graph_opt_config import GraphOptimizationConfig
 from .sublinear_memory_config import SublinearMemoryConfig
 
+logger = get_logger(__name__)
+
+
+def _arg_spec(x):
+    # dtypes, devices and shapes of the tensors in the arguments of a traced function
+    if isinstance(x, RawTensor):
+        shape = RawTensor.shape.__get__(x)
+        return ("Tensor", str(x.dtype), str(x.device), shape)
+    if isinstance(x, (list, tuple)):
+        return (type(x).__name__, *map(_arg_spec, x))
+    if isinstance(x, dict):
+        return ("dict", *sorted((repr(k), _arg_spec(v)) for k, v in x.items()))
+    if x is None or isinstance(x, (bool, int, float, str)):
+        return x
+    return type(x).__qualname__
+
 
 def _input_node_use_static_shape():
     return os.environ.get("MEGENGINE_INPUT_NODE_USE_STATIC_SHAPE") is not None
@@ -136,6 +160,18 @@ class trace:
         opt_level: optimization level for compiling trace. Default: 2
         graph_opt_config: configuration for graph optimization. Default: None
         symbolic_shape: whether to use symbolic shape for tracing. Default: True
+        persistent_cache: whether to save the trace to the persistent cache after
+            tracing, and load it in later processes, where the first call runs the
+            compiled graph without tracing again. The trace is keyed by the source of
+            the function, the specs of the arguments and the options above. If the
+            loaded trace mismatches, it is dropped and the function is called again
+            for tracing, so the side effects of the function before the mismatch
+            happen twice. Not supported with ``capture_as_const``. Default: False
+        max_specializations: max number of traces kept for different dtypes, devices
+            and shapes of the tensors in the arguments. Each call picks the trace of
+            its arguments, or traces the function again if there is none, which
+            replaces the least recently used trace when there are already this
+            number of them. Default: 1, with which the function is traced only once
     """
 
     def __new__(cls, *args, **kwargs):
@@ -155,6 +191,8 @@ class trace:
         opt_level: int = 2,
         graph_opt_config: GraphOptimizationConfig = None,
         symbolic_shape: bool = True,
+        persistent_cache: bool = False,
+        max_specializations: int = 1,
     ):
         self.__wrapped__ = function
         self._symbolic = symbolic or record_only
@@ -169,6 +207,14 @@ class trace:
         self._graph_opt_config = graph_opt_config
         self._symbolic_shape = symbolic_shape
         self._output_handles = set()
+        self._persistent_cache = persistent_cache and not self._capture_as_const
+        # key of the trace in the persistent cache
+        self._cache_key = None
+        assert max_specializations >= 1
+        self._max_specializations = max_specializations
+        # arg spec of the current trace, and the states of the other traces
+        self._spec = None
+        self._specializations = collections.OrderedDict()
 
         self._reset()
 
@@ -542,6 +588,10 @@ class trace:
                 self._graph_opt_config.jit_fuse_dimshuffle
             ]
             jit_config.fuse_reduce = mapping[self._graph_opt_config.jit_fuse_reduce]
+            if self._graph_opt_config.conv_format_nhwc:
+                graph.options.graph_opt.layout_transform = (
+                    GraphOptimizeOptions.LayoutTransform.NHWC
+                )
         # sublinear
         if self._sublinear_memory_config is not None:
             graph.options.enable_sublinear_memory_opt = True
@@ -555,6 +605,12 @@ class trace:
             )
             sublinear_config.thresh_nr_try = self._sublinear_memory_config.thresh_nr_try
             sublinear_config.num_worker = self._sublinear_memory_config.num_worker
+            sublinear_config.genetic_early_stop = (
+                self._sublinear_memory_config.genetic_early_stop
+            )
+            sublinear_config.enable_plan_cache = (
+                self._sublinear_memory_config.enable_plan_cache
+            )
         # profile
         if self._profiling:
             self._profiler = GraphProfiler(graph)
@@ -684,13 +740,163 @@ class trace:
             opnode.reset()
 
     def __call__(self, *args, **kwargs):
-        with self._setup():
-            if self._capture_as_const:
-                self._process_inputs(*args, **kwargs)
-            outputs = self.__wrapped__(*args, **kwargs)
-            if self._capture_as_const:
-                self._process_outputs(outputs)
-            return outputs
+        if self._max_specializations > 1:
+            self._switch_specialization(_arg_spec((args, kwargs)))
+        return self._call(args, kwargs, load_cache=True)
+
+    # the attributes that make a trace, of which _reset() resets the first ones
+    _specialized_attrs = (
+        "_untraced",
+        "_tinfo",
+        "_seq",
+        "_pc",
+        "_graph",
+        "_need_reset_nodes",
+        "_lazy_eval_graph",
+        "_lazy_eval_tensors",
+        "_lazy_eval_links",
+        "_active_tensors",
+        "_tensor_remaps",
+        "_inputs_to_restore",
+        "_arg_bindings",
+        "_kwarg_bindings",
+        "_output_bindings",
+        "_output_names",
+        "_output_handles",
+        "_profiler",
+        "_profiler2",
+        "_cache_key",
+    )
+
+    def _switch_specialization(self, spec):
+        if spec == self._spec:
+            return
+        state = self._specializations.pop(spec, None)
+        if self._spec is not None:
+            self._specializations[self._spec] = {
+                k: getattr(self, k) for k in self._specialized_attrs
+            }
+            while len(self._specializations) >= self._max_specializations:
+                self._specializations.popitem(last=False)
+        if state is None:
+            self._reset()
+            self._output_handles = set()
+            self._profiler = self._profiler2 = None
+            self._cache_key = None
+        else:
+            for k, v in state.items():
+                setattr(self, k, v)
+        self._spec = spec
+
+    def _call(self, args, kwargs, load_cache):
+        tracing = self._untraced
+        cache_loaded = False
+        if self._persistent_cache and tracing:
+            self._cache_key = self._make_cache_key(args, kwargs)
+            if load_cache:
+                cache_loaded = self._load_from_cache()
+        try:
+            with self._setup():
+                if self._capture_as_const:
+                    self._process_inputs(*args, **kwargs)
+                outputs = self.__wrapped__(*args, **kwargs)
+                if self._capture_as_const:
+                    self._process_outputs(outputs)
+        except TraceMismatchError:
+            if not cache_loaded:
+                raise
+            # the trace has been reset in _setup
+            logger.warning(
+                "trace of {} loaded from persistent cache mismatches, "
+                "retrace it".format(self.__wrapped__)
+            )
+            return self._call(args, kwargs, load_cache=False)
+        if tracing and not cache_loaded and self._cache_key is not None:
+            self._save_to_cache()
+        return outputs
+
+    _cache_category = "trace"
+
+    def _make_cache_key(self, args, kwargs):
+        try:
+            source = inspect.getsource(self.__wrapped__)
+        except (OSError, TypeError):
+            return None
+
+        def config(c):
+            return None if c is None else sorted(vars(c).items())
+
+        key = (
+            getattr(self.__wrapped__, "__qualname__", None),
+            source,
+            _arg_spec(args),
+            _arg_spec(kwargs),
+            self._symbolic,
+            self._graph_opt_level,
+            self._symbolic_shape,
+            config(self._sublinear_memory_config),
+            config(self._dtr_config),
+            config(self._graph_opt_config),
+        )
+        return hashlib.sha256(repr(key).encode()).hexdigest().encode("ascii")
+
+    _cached_info_attrs = (
+        "name",
+        "external",
+        "data_read",
+        "shape_read",
+        "value_read",
+        "exported",
+        "device",
+        "dtype",
+        "shape",
+        "is_const",
+    )
+
+    def _save_to_cache(self):
+        from .. import _persistent_cache_impl_ins as cache
+
+        tinfo = []
+        for info in self._tinfo:
+            attrs = {k: getattr(info, k, None) for k in self._cached_info_attrs}
+            if info.bound_data is not None:
+                attrs["bound_data"] = info.bound_data.numpy()
+            tinfo.append(attrs)
+        try:
+            value = pickle.dumps((self._seq, tinfo))
+        except Exception as exc:  # pylint: disable=broad-except
+            logger.debug("trace of {} not cached: {!r}".format(self.__wrapped__, exc))
+            return
+        cache.put(self._cache_category, self._cache_key, value)
+
+    def _load_from_cache(self):
+        from .. import _persistent_cache_impl_ins as cache
+
+        if self._cache_key is None:
+            return False
+        value = cache.get(self._cache_category, self._cache_key)
+        if value is None:
+            return False
+        try:
+            seq, tinfo = pickle.loads(value)
+        except Exception as exc:  # pylint: disable=broad-except
+            logger.debug("failed to load trace of {}: {!r}".format(self.__wrapped__, exc))
+            return False
+        self._reset()
+        for attrs in tinfo:
+            _, info = self._new_handle()
+            for k in self._cached_info_attrs:
+                setattr(info, k, attrs[k])
+            if "bound_data" in attrs:
+                data = attrs["bound_data"]
+                info.bound_data = RawTensor(
+                    data, info.dtype, info.device, False, info.name
+                )
+                if data.ndim == 0:
+                    setscalar(info.bound_data)
+        self._seq = seq
+        self._untraced = False
+        return True
 
     def dump(
         self,
@@ -703,6 +909,8 @@ class trace:
         keep_opr_name: bool = False,
         keep_param_name: bool = False,
         keep_opr_priority: bool = False,
+        tensor_value_compression: str = None,
+        dedup_tensor_value: bool = False,
         strip_info_file=None,
         append_json=False,
         optimize_for_inference=True,
@@ -729,6 +937,11 @@ class trace:
             keep_param_name: whether to keep param names, so param values can be
                 easily manipulated after loading model
             keep_opr_priority: whether to keep priority setting for operators
+            tensor_value_compression: lossless codec to compress tensor values,
+                can be None, "lz" or "shuffle_lz"; see
+                :func:`~.megbrain_graph.dump_graph` for details
+            dedup_tensor_value: whether to store params with identical values
+                only once; see :func:`~.megbrain_graph.dump_graph` for details
             strip_info_file: a string for path or a file handler. if is not None,
                 then the dump information for code strip would be written to ``strip_info_file``
             append_json: will be check when `strip_info_file` is not None. if set
@@ -910,17 +1123,30 @@ class trace:
         if keep_opr_priority:
             graph._set_priority_to_id(dest_vars)
 
+        # stream tensor values into the file when possible; the dumper seeks
+        # back to patch the header, which is not supported in append mode
+        stream = (
+            not append
+            and hasattr(file, "seekable")
+            and file.seekable()
+            and "a" not in getattr(file, "mode", "")
+        )
+
         dump_content, dump_info = G.dump_graph(
             dest_vars,
             keep_var_name=keep_var_name,
             keep_opr_name=keep_opr_name,
             keep_param_name=keep_param_name,
             keep_opr_priority=keep_opr_priority,
+            tensor_value_compression=tensor_value_compression,
+            dedup_tensor_value=dedup_tensor_value,
             strip_info_file=strip_info_file,
             append_json=append_json,
             metadata=metadata,
+            file=file if stream else None,
         )
-        file.write(dump_content)
+        if not stream:
+            file.write(dump_content)
         return dump_info
 
     def _process_inputs(self, *args, **kwargs):
@@ -15,7 +15,7 @@ from .module import Module
 
 
 class GroupNorm(Module):
-    """Simple implementation of GroupNorm. Only support 4d tensor now.
+    """Simple implementation of GroupNorm. Support tensor of shape (N, C, ...).
     Reference: https://arxiv.org/pdf/1803.08494.pdf.
     """
 
@@ -40,19 +40,10 @@ class GroupNorm(Module):
             zeros_(self.bias)
 
     def forward(self, x):
-        N, C, H, W = x.shape
-        assert C == self.num_channels
-
-        x = x.reshape(N, self.num_groups, -1)
-        mean = x.mean(axis=2, keepdims=True)
-        var = (x * x).mean(axis=2, keepdims=True) - mean * mean
-
-        x = (x - mean) / F.sqrt(var + self.eps)
-        x = x.reshape(N, C, H, W)
-        if self.affine:
-            x = self.weight.reshape(1, -1, 1, 1) * x + self.bias.reshape(1, -1, 1, 1)
-
-        return x
+        assert x.shape[1] == self.num_channels
+        return F.nn.group_norm(
+            x, self.num_groups, self.affine, self.weight, self.bias, self.eps
+        )
 
     def _module_info_string(self) -> str:
         s = (
@@ -9,7 +9,8 @@
 import os
 from typing import Iterable, Tuple, Union
 
-from ..functional.inplace import _inplace_add_
+from ..core.ops.builtin import MultiTensorAdam
+from ..functional.inplace import _inplace_add_, _multi_tensor_update_
 from ..tensor import Parameter, tensor
 from .optimizer import Optimizer
 
@@ -60,6 +61,13 @@ class Adam(Optimizer):
         eps = param_group["eps"]
         beta0, beta1 = param_group["betas"]
 
+        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
+        if inplace_mode:
+            batches = self._multi_tensor_batches(param_group, count_step=True)
+            if batches is not None:
+                _multi_tensor_adam_updates(self, param_group, batches)
+                return
+
         def make_scalar(val):
             return tensor(val)
 
@@ -73,11 +81,13 @@ class Adam(Optimizer):
 
         c1, c05 = map(make_scalar, (1.0, 0.5))
 
-        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
         if inplace_mode:
             # reduce device sync
             c1_sub_beta0, c1_sub_beta1 = map(make_scalar, (1 - beta0, 1 - beta1))
 
+        # the steps are counted on device only
+        self._host_steps.clear()
+
         for param in param_group["params"]:
 
             if param.grad is None:
@@ -123,3 +133,32 @@ class Adam(Optimizer):
                 (exp_avg_sq / (c1 - _beta1 ** step)) ** c05 + _eps
             )
             param -= _lr * delta
+
+
+def _multi_tensor_adam_updates(
+    optimizer, param_group, batches, decoupled_weight_decay=False
+):
+    # all the params at the same step are updated by one op, in which the bias
+    # corrections are given as attributes computed from the steps on host
+    beta0, beta1 = param_group["betas"]
+    for step, params in batches:
+        states = [optimizer._state[param] for param in params]
+        op = MultiTensorAdam(
+            lr=param_group["lr"],
+            beta0=beta0,
+            beta1=beta1,
+            eps=param_group["eps"],
+            weight_decay=param_group["weight_decay"],
+            decoupled_weight_decay=decoupled_weight_decay,
+            bias_correction0=1 - beta0 ** step,
+            bias_correction1=1 - beta1 ** step,
+        )
+        exp_avgs = [st["exp_avg"] for st in states]
+        exp_avg_sqs = [st["exp_avg_sq"] for st in states]
+        steps = [st["step"] for st in states]
+        grads = [param.grad for param in params]
+        _multi_tensor_update_(
+            op,
+            params + exp_avgs + exp_avg_sqs + steps,
+            params + grads + exp_avgs + exp_avg_sqs + steps,
+        )
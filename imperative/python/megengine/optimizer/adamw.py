@@ -11,6 +11,7 @@ from typing import Iterable, Tuple, Union
 
 from ..functional.inplace import _inplace_add_
 from ..tensor import Parameter, tensor
+from .adam import _multi_tensor_adam_updates
 from .optimizer import Optimizer
 
 
@@ -60,6 +61,15 @@ class AdamW(Optimizer):
         eps = param_group["eps"]
         beta0, beta1 = param_group["betas"]
 
+        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
+        if inplace_mode:
+            batches = self._multi_tensor_batches(param_group, count_step=True)
+            if batches is not None:
+                _multi_tensor_adam_updates(
+                    self, param_group, batches, decoupled_weight_decay=True
+                )
+                return
+
         def make_scalar(val):
             return tensor(val)
 
@@ -73,11 +83,13 @@ class AdamW(Optimizer):
 
         c1, c05 = map(make_scalar, (1.0, 0.5))
 
-        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
         if inplace_mode:
             # reduce device sync
             c1_sub_beta0, c1_sub_beta1 = map(make_scalar, (1 - beta0, 1 - beta1))
 
+        # the steps are counted on device only
+        self._host_steps.clear()
+
         for param in param_group["params"]:
 
             if param.grad is None:
@@ -15,8 +15,10 @@ from typing import Union
 
 import numpy as np
 
+from ..core import batch
 from ..core._imperative_rt.core2 import pop_scope, push_scope, set_option
 from ..core.tensor.utils import set_convert_inputs
+from ..jit.tracing import is_tracing
 from ..tensor import Parameter, Tensor
 from ..utils.deprecation import deprecated
 
@@ -43,6 +45,8 @@ class Optimizer(metaclass=ABCMeta):
         self._state = dict()
         self._defaults = defaults
         self._disable_type_convert = False
+        # steps of the params counted on host by the multi-tensor updates
+        self._host_steps = dict()
 
         if isinstance(params, (Parameter, dict)):
             params = [params]
@@ -130,6 +134,34 @@ class Optimizer(metaclass=ABCMeta):
     def _create_state(self, param_group):
         pass
 
+    def _multi_tensor_batches(self, param_group, count_step=False):
+        r"""Splits the params with grads in ``param_group`` into batches that are
+        updated by one multi-tensor op each, i.e. the params on the same device,
+        and at the same step if ``count_step`` is set.
+
+        Returns a list of ``(step, params)``, or None if the params should be
+        updated one by one, which happens when tracing or for non-float32 params.
+        """
+        params = [p for p in param_group["params"] if p.grad is not None]
+        if is_tracing() or any(
+            p.dtype != np.float32 or p.grad.dtype != np.float32 for p in params
+        ):
+            # the steps are counted on device only
+            self._host_steps.clear()
+            return None
+        batches = dict()
+        for param in params:
+            step = None
+            if count_step:
+                step = self._host_steps.get(param)
+                if step is None:
+                    # sync once for the steps counted on device or loaded
+                    step = int(self._state[param]["step"].item())
+                step += 1
+                self._host_steps[param] = step
+            batches.setdefault((param.device, step), []).append(param)
+        return [(step, params) for (_, step), params in batches.items()]
+
     @abstractmethod
     def _updates(self, param_group):
         pass
@@ -148,16 +180,18 @@ class Optimizer(metaclass=ABCMeta):
         set_option("record_computing_path", 0)
         if self._disable_type_convert:
             backup = set_convert_inputs(False)
-        for group in self.param_groups:
-            if isinstance(group["params"], set):
-                raise TypeError(
-                    "optimized parameters need to be organized in ordered collections, "
-                    "but the ordering of parameters in sets will change between runs. "
-                    "Please use a list instead."
-                )
-            push_scope("step")
-            self._updates(group)
-            pop_scope("step")
+        # the small ops updating params are issued to the worker in batches
+        with batch():
+            for group in self.param_groups:
+                if isinstance(group["params"], set):
+                    raise TypeError(
+                        "optimized parameters need to be organized in ordered collections, "
+                        "but the ordering of parameters in sets will change between runs. "
+                        "Please use a list instead."
+                    )
+                push_scope("step")
+                self._updates(group)
+                pop_scope("step")
         if self._disable_type_convert:
             # restore the globle state `_enable_convert_inputs`
             set_convert_inputs(backup)
@@ -246,6 +280,7 @@ class Optimizer(metaclass=ABCMeta):
             for key in group_new.keys():
                 if key != "params":
                     group_new[key] = group_saved[key]
+        self._host_steps.clear()
 
         if len(self._state.keys()) != len(state["state"].keys()):
             raise ValueError(
@@ -9,7 +9,8 @@
 import os
 from typing import Iterable, Union
 
-from ..functional.inplace import _inplace_add_
+from ..core.ops.builtin import MultiTensorSGD
+from ..functional.inplace import _inplace_add_, _multi_tensor_update_
 from ..tensor import Parameter, tensor
 from .optimizer import Optimizer
 
@@ -59,6 +60,24 @@ class SGD(Optimizer):
         weight_decay = param_group["weight_decay"]
         momentum = param_group["momentum"]
 
+        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
+        if inplace_mode:
+            batches = self._multi_tensor_batches(param_group)
+            if batches is not None:
+                op = MultiTensorSGD(
+                    lr=lr,
+                    momentum=momentum,
+                    weight_decay=weight_decay,
+                    nesterov=self.nesterov,
+                )
+                for _, params in batches:
+                    grads = [param.grad for param in params]
+                    bufs = []
+                    if momentum != 0.0:
+                        bufs = [self._state[p]["momentum_buffer"] for p in params]
+                    _multi_tensor_update_(op, params + bufs, params + grads + bufs)
+                return
+
         # since `conver_inputs` is disabled for param updates,
         # scalar should be explicitly tansforred to tensor
 
@@ -66,7 +85,6 @@ class SGD(Optimizer):
         _weight_decay = tensor(weight_decay)
         _momentum = tensor(momentum)
 
-        inplace_mode = int(os.getenv("MEGENGINE_INPLACE_UPDATE", "0"))
         if inplace_mode:
             _neg_lr = tensor(-lr)
             c1 = tensor([1.0])
@@ -7,9 +7,11 @@
 # software distributed under the License is distributed on an
 # "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 import argparse
+import io
 import os
 import struct
 import textwrap
+import zlib
 from pathlib import Path
 
 import numpy as np
@@ -58,7 +60,65 @@ def load_tensor_binary(fobj):
     while shape[-1] == 0:
         shape.pop(-1)
     name = fobj.read(name_len).decode("ascii")
-    return np.fromfile(fobj, dtype=DTYPE_LIST[dtype]).reshape(shape), name
+    return np.frombuffer(fobj.read(), dtype=DTYPE_LIST[dtype]).reshape(shape), name
+
+
+IODUMP_MAGIC = b"MGBIODMP"
+IODUMP_INDEX_MAGIC = b"MGBIODIX"
+
+
+def is_iodump_container(fname):
+    """Whether a file is written by the :class:`AsyncBinaryOprIODump` plugin."""
+    if not os.path.isfile(fname):
+        return False
+    with open(fname, "rb") as fin:
+        return fin.read(len(IODUMP_MAGIC)) == IODUMP_MAGIC
+
+
+def load_iodump_container(fname):
+    """Load the tensors in a file written by the :class:`AsyncBinaryOprIODump`
+    plugin; see ``src/plugin/impl/opr_io_dump.cpp`` for the file layout.
+
+    Args:
+      fname: name of the file.
+
+    Returns:
+      dict that maps the file name that :class:`BinaryOprIODump` would use for
+      each tensor to a list of the values loaded by :func:`load_tensor_binary`,
+      one for each execution in order.
+    """
+    with open(fname, "rb") as fin:
+        assert fin.read(len(IODUMP_MAGIC)) == IODUMP_MAGIC, "bad iodump file"
+        trailer_fmt = struct.Struct("<QQ8s")
+        fin.seek(-trailer_fmt.size, os.SEEK_END)
+        index_offset, nr_values, magic = trailer_fmt.unpack(
+            fin.read(trailer_fmt.size)
+        )
+        assert magic == IODUMP_INDEX_MAGIC, "iodump file not flushed: {}".format(
+            fname
+        )
+
+        item_fmt = struct.Struct("<QQQQII")
+        fin.seek(index_offset)
+        index = []
+        for _ in range(nr_values):
+            offset, size, raw_size, seq, codec, name_len = item_fmt.unpack(
+                fin.read(item_fmt.size)
+            )
+            name = fin.read(name_len).decode("ascii")
+            index.append((seq, name, offset, size, raw_size, codec))
+
+        ret = {}
+        for seq, name, offset, size, raw_size, codec in sorted(index):
+            fin.seek(offset)
+            data = fin.read(size)
+            if codec == 1:
+                data = zlib.decompress(data)
+            else:
+                assert codec == 0, "unknown codec {} of {}".format(codec, name)
+            assert len(data) == raw_size
+            ret.setdefault(name, []).append(load_tensor_binary(io.BytesIO(data)))
+        return ret
 
 
 def check(v0, v1, name, max_err):
@@ -87,12 +147,20 @@ def main():
     parser = argparse.ArgumentParser(
         description=(
             "compare tensor dumps generated BinaryOprIODump plugin, "
-            "it can compare two dirs or two single files"
+            "it can compare two dirs or two single files; a file written by "
+            "AsyncBinaryOprIODump is treated as a dir, and the values of "
+            "the last execution are compared"
         ),
         formatter_class=argparse.ArgumentDefaultsHelpFormatter,
     )
     parser.add_argument("input0", help="dirname or filename")
     parser.add_argument("input1", help="dirname or filename")
+    parser.add_argument(
+        "--exec-id",
+        type=int,
+        default=-1,
+        help="index of the execution to compare in AsyncBinaryOprIODump files",
+    )
     parser.add_argument(
         "-e", "--max-err", type=float, default=1e-3, help="max allowed error"
     )
@@ -101,34 +169,19 @@ def main():
     )
     args = parser.parse_args()
 
-    files0 = set()
-    files1 = set()
-    if os.path.isdir(args.input0):
-        assert os.path.isdir(args.input1)
-        name0 = set()
-        name1 = set()
-        for i in os.listdir(args.input0):
-            files0.add(str(Path(args.input0) / i))
-            name0.add(i)
-
-        for i in os.listdir(args.input1):
-            files1.add(str(Path(args.input1) / i))
-            name1.add(i)
-
-        assert name0 == name1, "dir files mismatch: a-b={} b-a={}".format(
-            name0 - name1, name1 - name0
-        )
-    else:
-        files0.add(args.input0)
-        files1.add(args.input1)
-    files0 = sorted(files0)
-    files1 = sorted(files1)
-
-    for i, j in zip(files0, files1):
-        val0, name0 = load_tensor_binary(i)
-        val1, name1 = load_tensor_binary(j)
+    def load_input(fname):
+        """map from the name of each tensor to its value or file"""
+        if is_iodump_container(fname):
+            values = load_iodump_container(fname)
+            return {k: v[args.exec_id] for k, v in values.items()}
+        assert os.path.isdir(fname)
+        return {i: str(Path(fname) / i) for i in os.listdir(fname)}
+
+    def compare(tag, v0, v1):
+        val0, name0 = v0 if isinstance(v0, tuple) else load_tensor_binary(v0)
+        val1, name1 = v1 if isinstance(v1, tuple) else load_tensor_binary(v1)
         name = "{}: \n{}\n{}\n".format(
-            i, "\n  ".join(textwrap.wrap(name0)), "\n  ".join(textwrap.wrap(name1))
+            tag, "\n  ".join(textwrap.wrap(name0)), "\n  ".join(textwrap.wrap(name1))
         )
         try:
             check(val0, val1, name, args.max_err)
@@ -137,6 +190,19 @@ def main():
                 raise exc
             print(exc)
 
+    if os.path.isfile(args.input0) and not is_iodump_container(args.input0):
+        compare(args.input0, args.input0, args.input1)
+        return
+
+    vals0 = load_input(args.input0)
+    vals1 = load_input(args.input1)
+    names0 = set(vals0)
+    names1 = set(vals1)
+    assert names0 == names1, "dir files mismatch: a-b={} b-a={}".format(
+        names0 - names1, names1 - names0
+    )
+    for i in sorted(names0):
+        compare(i, vals0[i], vals1[i])
 
 if __name__ == "__main__":
     main()
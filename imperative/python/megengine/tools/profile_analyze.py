@@ -126,6 +126,12 @@ def main(passed_args=None):  # pylint: disable=too-many-statements
     parser.add_argument(
         "--show-host", action="store_true", help="show host profiling info"
     )
+    parser.add_argument(
+        "--show-hw-counter",
+        action="store_true",
+        help="show the hardware counters of cpu oprs, which are given by "
+        "the profiler with hardware counters enabled",
+    )
     parser.add_argument(
         "--dump-only-opr",
         action="store_true",
@@ -355,6 +361,13 @@ def main(passed_args=None):  # pylint: disable=too-many-statements
                         ("out_shapes", format_shapes(record.out_shapes, sep=", ")),
                     ]
                 )
+                if args.show_hw_counter:
+                    row["IPC"] = "{:.2f}".format(record.ipc)
+                    row["cache miss rate"] = "{:.1%}".format(record.cache_miss_rate)
+                    row["branch misses"] = record.branch_misses
+                    row["dram bandwidth (MiB/s)"] = "{:.1f}".format(
+                        record.dram_bandwidth / 1024 ** 2
+                    )
                 rows.append(row)
             headers = list(rows[0].keys())
             tab = [[row[i] for i in headers] for row in rows]
@@ -365,6 +378,16 @@ def main(passed_args=None):  # pylint: disable=too-many-statements
             cum_time = 0
             for idx, record in enumerate(records):
                 cum_time += record.time
+                hw_counter = ()
+                if args.show_hw_counter:
+                    hw_counter = (
+                        "{:.2f}".format(record.ipc),
+                        "{:.1%}".format(record.cache_miss_rate),
+                        get_number_with_unit(record.branch_misses, "", 1000),
+                        get_number_with_unit(
+                            record.dram_bandwidth, ["byte/s", "iB/s"], 1024
+                        ),
+                    )
                 tab.append(
                     (
                         "#{}\n{:.3}\n{:.1f}%".format(
@@ -384,7 +407,16 @@ def main(passed_args=None):  # pylint: disable=too-many-statements
                         format_shapes(record.in_shapes, record.in_layouts),
                         format_shapes(record.out_shapes),
                     )
+                    + hw_counter
                 )
+            hw_counter_headers = []
+            if args.show_hw_counter:
+                hw_counter_headers = [
+                    "IPC",
+                    "cache miss rate",
+                    "branch misses",
+                    "dram bandwidth",
+                ]
             return _tabulate_ml(
                 tab,
                 headers=[
@@ -397,7 +429,8 @@ def main(passed_args=None):  # pylint: disable=too-many-statements
                     "bandwidth",
                     "in_shapes",
                     "out_shapes",
-                ],
+                ]
+                + hw_counter_headers,
                 tablefmt="fancy_grid",
             )
 
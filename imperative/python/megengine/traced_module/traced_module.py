@@ -320,20 +320,19 @@ class _InsertExprs:
             node.value = None
 
         extra_inp_nodes = set(self.global_scope.inputs)
+        expr2idx = {expr: idx for idx, expr in enumerate(self.graph._exprs)}
         max_inp_expr_idx = -1
         for node in extra_inp_nodes:
             assert (
                 node.top_graph == self.graph
             ), "The input node ({}) is not in the graph ({})".format(node, self.graph)
-            if isinstance(node, TensorNode) and node.expr in self.graph._exprs:
-                max_inp_expr_idx = max(
-                    max_inp_expr_idx, self.graph._exprs.index(node.expr)
-                )
+            if isinstance(node, TensorNode) and node.expr in expr2idx:
+                max_inp_expr_idx = max(max_inp_expr_idx, expr2idx[node.expr])
         max_inp_expr_idx += 1
 
         insert_index = -1
         if self.expr is not None:
-            insert_index = self.graph._exprs.index(self.expr)
+            insert_index = expr2idx[self.expr]
         insert_index += 1
 
         if insert_index < max_inp_expr_idx:
@@ -347,9 +346,7 @@ class _InsertExprs:
                 )
             )
 
-        for expr in self.global_scope._exprs:
-            self.graph._exprs.insert(insert_index, expr)
-            insert_index += 1
+        self.graph._exprs[insert_index:insert_index] = self.global_scope._exprs
 
         self.graph._used_names.update(self.global_scope._used_names)
         self.root_graph._total_ids = (Node._get_next_id(), Expr._get_next_id())
@@ -406,6 +403,8 @@ class InternalGraph:
     _outputs = None  # type: List[Node]
     _top_graph = None  # type: InternalGraph
     _total_ids = None  # type: List[int]
+    # map from a name to n, the names "{name}_1" ... "{name}_{n - 1}" are all used
+    _used_name_suffixes = None  # type: Dict[str, int]
 
     def __init__(self, name: str = None, prefix_name: str = "", module_name: str = ""):
         self._exprs = []
@@ -428,13 +427,28 @@ class InternalGraph:
         if name[0].isdigit():
             name = "_{}".format(name)
 
-        while name in self._used_names or _is_builtin_name(name):
+        def is_used(name):
+            return name in self._used_names or _is_builtin_name(name)
+
+        if is_used(name):
+            # skip the suffixes known to be used, so that creating n nodes of the
+            # same name costs O(n) rather than O(n^2)
+            if self._used_name_suffixes is None:
+                self._used_name_suffixes = {}
             match = re.match(r"(.*)_(\d+)$", name)
             if match is None:
-                name = name + "_1"
+                base, num = name, 0
             else:
-                base, num = match.group(1, 2)
-                name = "{}_{}".format(base, int(num) + 1)
+                base, num = match.group(1), int(match.group(2))
+            used_suffix = self._used_name_suffixes.get(base, 1)
+            contiguous = num < used_suffix
+            num = max(num + 1, used_suffix)
+            name = "{}_{}".format(base, num)
+            while is_used(name):
+                num += 1
+                name = "{}_{}".format(base, num)
+            if contiguous:
+                self._used_name_suffixes[base] = num + 1
 
         self._used_names.setdefault(name)
         return name
@@ -656,19 +670,21 @@ class InternalGraph:
         if not isinstance(nodes, Sequence):
             nodes = (nodes,)
         ret = list()
+        ret_set = set()
         queue = list(nodes)
-        visited_queue = list()
+        # nodes that have been pushed into queue
+        seen = set(queue)
         while queue:
             node = queue.pop()
-            visited_queue.append(node)
-
             expr = node.expr
 
-            if expr not in ret:
+            if expr not in ret_set:
                 ret.append(expr)
+                ret_set.add(expr)
 
             for i in expr.inputs:
-                if i not in queue and i not in visited_queue:
+                if i not in seen:
+                    seen.add(i)
                     queue.append(i)
         return ret
 
@@ -992,6 +1008,8 @@ class InternalGraph:
         Args:
             repl_dict: the map {old_Node: new_Node} that specifies how to replace the Nodes.
         """
+        # the order of exprs is not changed by replacing
+        expr2idx = {expr: idx for idx, expr in enumerate(self._exprs)}
         while repl_dict:
             node, repl_node = repl_dict.popitem()
             assert type(node) == type(
@@ -1010,12 +1028,12 @@ class InternalGraph:
             assert graph is self
             index = -1
             if not isinstance(repl_node.expr, Input):
-                index = graph._exprs.index(repl_node.expr)
-            dep_exprs = self.get_dep_exprs(repl_node)
+                index = expr2idx[repl_node.expr]
+            dep_exprs = set(self.get_dep_exprs(repl_node))
             i = 0
             while i < len(node.users):
                 n = node.users[i]
-                if n in graph._exprs and index >= graph._exprs.index(n):
+                if n in expr2idx and index >= expr2idx[n]:
                     i += 1
                     continue
                 if n in dep_exprs:
@@ -1031,16 +1049,15 @@ class InternalGraph:
 
     def compile(self):
         r"""Delete unused expr."""
-        dep_exprs = self.get_dep_exprs(self.outputs)
-        i = 0
-        while i < len(self._exprs):
-            expr = self._exprs[i]
+        dep_exprs = set(self.get_dep_exprs(self.outputs))
+        exprs = []
+        for expr in self._exprs:
             if expr in dep_exprs or expr._disable_remove:
-                i += 1
+                exprs.append(expr)
                 continue
             for n in expr.inputs:
                 n.users.remove(expr)
-            self._exprs.remove(expr)
+        self._exprs[:] = exprs
 
     def _reset_ids(self):
         for total_expr_id, expr in enumerate(self.exprs()):
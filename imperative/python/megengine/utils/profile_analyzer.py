@@ -78,6 +78,11 @@ class OprProfRst:
     A mapping from ``"memory"`` or ``"computation"`` to the actual number
     of corresponding operations."""
 
+    hw_counter = None
+    r"""
+    A mapping from hardware counter names like ``"cycles"`` or
+    ``"cache_misses"`` to their values summed over the cpu comp nodes."""
+
     def __init__(self, entry: dict):
         assert isinstance(entry, dict)
         self.opr_info = collections.OrderedDict()
@@ -85,6 +90,7 @@ class OprProfRst:
             self.opr_info[key] = entry[key]
         self.time_dict = collections.defaultdict(list)
         self.footprint = collections.defaultdict(NonExistNum)
+        self.hw_counter = collections.defaultdict(NonExistNum)
 
     def update_device_prof_info(self, dev_time: dict):
         """Updates device profiling info.
@@ -116,6 +122,24 @@ class OprProfRst:
         assert isinstance(footprint, dict)
         self.footprint.update(footprint)
 
+    def update_hw_counter(self, hw_counter: dict):
+        r"""Updates hardware counters.
+
+        Args:
+            hw_counter: hardware counters of single opr on a comp node,
+                is an attribute of profiling result.
+        """
+        assert isinstance(hw_counter, dict)
+        for key in [
+            "cycles",
+            "instructions",
+            "cache_references",
+            "cache_misses",
+            "branch_misses",
+            "time",
+        ]:
+            self.hw_counter[key] = self.hw_counter[key] + hw_counter[key]
+
 
 class Record:
     r"""A record of analyzing result
@@ -127,6 +151,7 @@ class Record:
             aggregate infomation if aggregating enabled.
         footprint: contains footprint information, for now, we have
             ``"computation"``, ``"memory"``, ``"in_shapes"``, ``"out_shapes"``.
+        hw_counter: hardware counters of the opr, empty if not profiled.
     """
 
     __slot__ = [
@@ -140,9 +165,15 @@ class Record:
         "flops",
         "bandwidth",
         "opr_id",
+        "ipc",
+        "cache_miss_rate",
+        "branch_misses",
+        "dram_bandwidth",
     ]
 
-    def __init__(self, time: float, info: dict, footprint: dict):
+    def __init__(
+        self, time: float, info: dict, footprint: dict, hw_counter: dict = None
+    ):
         assert isinstance(footprint, dict)
         self.time = time
         self.info = collections.OrderedDict(copy.deepcopy(info))
@@ -156,6 +187,22 @@ class Record:
         self.opr_id = info.get("id")
         if isinstance(self.opr_id, str) and self.opr_id != "N/A":
             self.opr_id = int(self.opr_id)
+        hw_counter = hw_counter or collections.defaultdict(NonExistNum)
+
+        def ratio(a, b):
+            if isinstance(a, NonExistNum) or isinstance(b, NonExistNum) or not b:
+                return NonExistNum()
+            return a / b
+
+        self.ipc = ratio(hw_counter["instructions"], hw_counter["cycles"])
+        self.cache_miss_rate = ratio(
+            hw_counter["cache_misses"], hw_counter["cache_references"]
+        )
+        self.branch_misses = hw_counter["branch_misses"]
+        # each last level cache miss loads a 64-byte line from dram
+        self.dram_bandwidth = ratio(hw_counter["cache_misses"], hw_counter["time"])
+        if not isinstance(self.dram_bandwidth, NonExistNum):
+            self.dram_bandwidth *= 64
 
     def get_column_by_name(self, name: str = None):
         r"""Extracts column value by its column name.
@@ -207,6 +254,13 @@ class ProfileAnalyzer:
             opr = self._opr_set[opr_id]
             opr.update_footprint(entry)
 
+        for opr_id, entry in obj["profiler"].get("hw_counter", {}).items():
+            if opr_id not in self._opr_set:
+                continue
+            opr = self._opr_set[opr_id]
+            for _, counter in entry.items():
+                opr.update_hw_counter(counter)
+
     def _aggregate(
         self, records: List[Record], aop: Union[str, Callable], atype: Optional[str]
     ) -> List[Record]:
@@ -303,7 +357,7 @@ class ProfileAnalyzer:
                 time = time_func(opr)
                 if time is None:
                     continue
-                item = Record(time, opr.opr_info, opr.footprint)
+                item = Record(time, opr.opr_info, opr.footprint, opr.hw_counter)
                 records.append(item)
 
         records = self._aggregate(records, aggregate, aggregate_by)
@@ -0,0 +1,45 @@
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+import numpy as np
+
+from ..core._imperative_rt import CompNode
+from ..core._imperative_rt.core2 import _from_numpy, _numpy_view
+from ..device import get_default_device
+from ..tensor import Tensor
+
+
+def from_numpy(data: np.ndarray, device: str = None) -> Tensor:
+    r"""Creates a :class:`~.Tensor` sharing memory with a numpy array.
+
+    The memory is shared when the tensor is on CPU and ``data`` is contiguous,
+    aligned and of a dtype supported by MegEngine, otherwise ``data`` is copied as
+    ``Tensor(data)`` does. A reference to ``data`` is kept by the tensor.
+
+    Note:
+        ``data`` must not be modified while the tensor is in use, since ops are
+        executed asynchronously. Inplace ops on the tensor are refused because its
+        memory is not owned by MegEngine.
+
+    Args:
+        data: the array to share.
+        device: the device of returned Tensor. Uses :func:`get_default_device`
+            if not specified.
+    """
+    cn = CompNode(get_default_device() if device is None else device)
+    return _from_numpy(Tensor, np.asarray(data), cn)
+
+
+def as_numpy(tensor: Tensor) -> np.ndarray:
+    r"""Returns a read-only :class:`numpy.ndarray` sharing memory with a tensor on CPU,
+    or a copy as :meth:`~.Tensor.numpy` does for other devices.
+
+    Note:
+        Inplace ops on the tensor are refused while the returned array is alive,
+        since they would change the array.
+    """
+    return _numpy_view(tensor)
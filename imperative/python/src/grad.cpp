@@ -530,6 +530,210 @@ void accum_grad(std::shared_ptr<Tensor>& grad, T&& delta) {
     grad = apply(op, grad, std::forward<T>(delta))[0];
 }
 
+namespace {
+
+// the ops of backward graphs are cached by make_backward_graph, so the fused
+// backward graphs of the same tape are compared by the addresses of their ops
+size_t hash_fused_backward(const Subgraph& graph) {
+    using namespace ranges::views;
+    size_t ret = mgb::hash(graph.inputs.size());
+    for (auto&& expr : graph.exprs) {
+        ret = mgb::hash_pair_combine(ret, mgb::hash(expr.op.get()));
+        for (auto i : concat(expr.inputs, expr.outputs)) {
+            ret = mgb::hash_pair_combine(ret, i);
+        }
+    }
+    for (auto i : graph.outputs) {
+        ret = mgb::hash_pair_combine(ret, i);
+    }
+    return ret;
+}
+
+bool same_fused_backward(const Subgraph& lhs, const Subgraph& rhs) {
+    auto same_vars = [](const Subgraph::vars_t& l, const Subgraph::vars_t& r) {
+        return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin());
+    };
+    if (!same_vars(lhs.inputs, rhs.inputs) || !same_vars(lhs.outputs, rhs.outputs) ||
+        lhs.exprs.size() != rhs.exprs.size() ||
+        lhs.constants.size() != rhs.constants.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.constants.size(); ++i) {
+        if (lhs.constants[i] != rhs.constants[i]) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < lhs.exprs.size(); ++i) {
+        auto &&l = lhs.exprs[i], &&r = rhs.exprs[i];
+        if (!same_vars(l.inputs, r.inputs) || !same_vars(l.outputs, r.outputs) ||
+            l.op != r.op) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+/*!
+ * Inline the backward graphs of the tape into one subgraph, whose inputs are
+ * the closures and the initial grads and whose outputs are the grads passed to
+ * callbacks, then run it as a CompiledOp, which is cached by the structure of
+ * the tape, so a repeated training step dispatches a single op for backward.
+ *
+ * Return false without running anything if the tape could not be fused, e.g.
+ * it contains python or custom grad rules, or the grads are recorded by other
+ * grad keys, then the tape is run op by op.
+ */
+bool GradKey::fused_backward(BackwardContext& bctx) {
+    if (ApplyContext::global_enable & (Flags::TRACE | Flags::MODULE_TRACE)) {
+        return false;
+    }
+    auto graph = std::make_shared<Subgraph>();
+    // var 0 is reserved as null by Subgraph
+    size_t nr_vars = 1;
+    SmallVector<Tensor*> inputs;
+    std::unordered_map<Tensor*, size_t> tensor2var;
+    std::unordered_map<GradSlot*, size_t> slot2var;
+    bool recorded = false;
+    auto input_var = [&](Tensor* tensor) {
+        auto [iter, inserted] = tensor2var.insert({tensor, nr_vars});
+        if (inserted) {
+            graph->inputs.push_back(nr_vars++);
+            inputs.push_back(tensor);
+            for (auto&& grad_info : tensor->m_grad_info_dict) {
+                auto key = grad_info.grad_fn->key.lock();
+                recorded |= key && key->active && !key->is_blocked();
+            }
+        }
+        return iter->second;
+    };
+    // the grads given to backward are the initial values of slots
+    auto grad_var = [&](GradSlot* slot) -> std::optional<size_t> {
+        if (auto iter = slot2var.find(slot); iter != slot2var.end()) {
+            return iter->second;
+        }
+        if (slot->grad) {
+            return slot2var[slot] = input_var(slot->grad.get());
+        }
+        return {};
+    };
+    static std::shared_ptr<OpDef> add_op =
+            std::shared_ptr<OpDef>(new Elemwise(Elemwise::Mode::ADD));
+
+    std::vector<std::shared_ptr<GradFn>> grad_fns;
+    SmallVector<GradSlot*> callback_slots;
+    for (std::ptrdiff_t k = tape.size() - 1; k >= 0; --k) {
+        auto grad_fn = tape[k].lock();
+        if (!grad_fn)
+            continue;
+        auto* backward = std::get_if<BackwardGraphWithClosure>(&grad_fn->backward);
+        if (!backward) {
+            return false;
+        }
+        grad_fns.push_back(grad_fn);
+
+        SmallVector<size_t> args;
+        for (auto&& t : backward->closure) {
+            args.push_back(input_var(t.get()));
+        }
+        bool null_grad = false;
+        for (size_t i = 0; i < grad_fn->slots.size(); ++i) {
+            if (!backward->output_requires_grad(i))
+                continue;
+            if (auto var = grad_var(&grad_fn->slots[i])) {
+                if (null_grad) {
+                    // leave the error to the op by op backward
+                    return false;
+                }
+                args.push_back(*var);
+            } else {
+                null_grad = true;
+            }
+        }
+        if (!null_grad) {
+            auto&& bgraph = backward->backward_graph->backward;
+            mgb_assert(bgraph.inputs.size() == args.size());
+            std::unordered_map<size_t, size_t> var_map;
+            for (size_t i = 0; i < args.size(); ++i) {
+                var_map[bgraph.inputs[i]] = args[i];
+            }
+            for (auto&& [var, value] : bgraph.constants) {
+                var_map[var] = nr_vars;
+                graph->constants.push_back({nr_vars++, value});
+            }
+            for (auto&& expr : bgraph.exprs) {
+                Subgraph::expr_t fused{expr.op};
+                for (auto i : expr.inputs) {
+                    fused.inputs.push_back(var_map.at(i));
+                }
+                for (auto i : expr.outputs) {
+                    var_map[i] = nr_vars;
+                    fused.outputs.push_back(nr_vars++);
+                }
+                graph->exprs.push_back(std::move(fused));
+            }
+            auto&& input_has_grad = backward->backward_graph->input_has_grad;
+            auto&& it = bgraph.outputs.begin();
+            for (auto [i, p] : views::enumerate(input_has_grad)) {
+                if (!p)
+                    continue;
+                auto var = var_map.at(*it++);
+                auto& dst = grad_fn->dsts[i];
+                if (!dst)
+                    continue;
+                auto* slot = dst.operator->();
+                if (auto prev = grad_var(slot)) {
+                    graph->exprs.push_back({add_op, {*prev, var}, {nr_vars}});
+                    var = nr_vars++;
+                }
+                slot2var[slot] = var;
+            }
+            mgb_assert(it == bgraph.outputs.end());
+        }
+        for (auto&& dst : grad_fn->dsts) {
+            if (!dst.grad_fn)
+                continue;
+            auto* slot = dst.operator->();
+            if (!dst.producer_record.next && slot->callback && grad_var(slot)) {
+                // the last grad producer, same as the op by op backward
+                callback_slots.push_back(slot);
+            }
+        }
+    }
+    for (auto* slot : callback_slots) {
+        graph->outputs.push_back(slot2var.at(slot));
+    }
+    graph->remove_unused_exprs();
+    if (recorded || graph->exprs.empty()) {
+        return false;
+    }
+    using FusedBackwardCache = std::unordered_map<
+            size_t, SmallVector<std::pair<
+                            std::shared_ptr<Subgraph>, std::shared_ptr<OpDef>>>>;
+    thread_local FusedBackwardCache cache;
+    auto& bucket = cache[hash_fused_backward(*graph)];
+    std::shared_ptr<OpDef> op;
+    for (auto&& [cached_graph, cached_op] : bucket) {
+        if (same_fused_backward(*cached_graph, *graph)) {
+            op = cached_op;
+            break;
+        }
+    }
+    if (!op) {
+        op = CompiledOp::make(SubgraphOp::make("FusedBackward", graph));
+        bucket.emplace_back(graph, op);
+    }
+    auto grads = apply(op, inputs.data(), inputs.size());
+    for (auto&& grad_fn : grad_fns) {
+        grad_fn->clear();
+    }
+    for (size_t i = 0; i < callback_slots.size(); ++i) {
+        callback_slots[i]->callback(bctx.wrap_tensor(grads[i]));
+    }
+    return true;
+}
+
 void GradKey::backward(
         std::vector<TensorWrapper*> tensors, std::vector<TensorWrapper*> grads) {
     if (!active) {
@@ -570,6 +774,10 @@ void GradKey::backward(
         grad_info->grad = grads[i]->m_tensor;
     }
 
+    if (enable_fused_backward && fused_backward(bctx)) {
+        return;
+    }
+
     std::vector<std::shared_ptr<GradFn>> ref_keeper;
     ref_keeper.reserve(tape.size());
 
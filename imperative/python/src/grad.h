@@ -22,6 +22,8 @@ namespace mgb::imperative::python {
 
 apply_result_t apply_grad(ApplyContext& ctx);
 
+struct BackwardContext;
+
 struct GradKey : std::enable_shared_from_this<GradKey>, NonCopyableObj {
     std::string name;
     bool active = true;
@@ -36,8 +38,12 @@ struct GradKey : std::enable_shared_from_this<GradKey>, NonCopyableObj {
     void cleanup();
     bool is_blocked() const { return priority < sm_min_priority; }
     inline static bool allow_higher_order_directive = false;
+    //! run the whole tape as a single compiled op when possible
+    inline static bool enable_fused_backward = false;
 
 private:
+    bool fused_backward(BackwardContext& bctx);
+
     static int sm_min_priority;
 };
 
@@ -56,6 +56,65 @@ struct WeakRendezvousArray : public std::vector<std::weak_ptr<RendezvousBase>>,
     MGB_TYPEINFO_OBJ_DECL;
 };
 MGB_TYPEINFO_OBJ_IMPL(WeakRendezvousArray);
+
+//! OutputFile that writes to a seekable python file object, so tensor values
+//! are streamed to the file instead of being buffered in memory
+class _PyOutputFile final : public ser::OutputFile {
+    //! max number of bytes passed to a single file.write() call
+    static constexpr size_t MAX_WRITE_SIZE = 16 * 1024 * 1024;
+    py::object m_write, m_seek, m_tell;
+
+public:
+    _PyOutputFile(py::object file)
+            : m_write{file.attr("write")},
+              m_seek{file.attr("seek")},
+              m_tell{file.attr("tell")} {}
+
+    void write(const void* src, size_t size) override {
+        auto ptr = static_cast<const char*>(src);
+        while (size) {
+            auto cur = std::min(size, MAX_WRITE_SIZE);
+            m_write(py::bytes(ptr, cur));
+            ptr += cur;
+            size -= cur;
+        }
+    }
+
+    void seek(size_t offset) override { m_seek(offset); }
+
+    size_t tell() override { return m_tell().cast<size_t>(); }
+};
+
+void _dump_graph(
+        std::unique_ptr<ser::OutputFile> file, const std::vector<VarNode*>& dest_vars,
+        const ser::GraphDumper::DumpConfig& config,
+        std::optional<_SerializationMetadata> metadata, py::list& stat,
+        py::list& inputs, py::list& outputs, py::list& params) {
+    auto dumper = ser::GraphDumper::make(std::move(file));
+    SymbolVarArray symvars(dest_vars.begin(), dest_vars.end());
+
+    ser::GraphDumper::DumpResult rst;
+    if (metadata)
+        rst = dumper->dump(symvars, config, *metadata);
+    else
+        rst = dumper->dump(symvars, config);
+
+    for (auto i : rst.inputs) {
+        inputs.append(py::cast(i));
+    }
+    for (auto i : rst.outputs) {
+        outputs.append(py::cast(i));
+    }
+    for (auto i : rst.params) {
+        params.append(py::cast(i));
+    }
+    auto rst_stat = std::vector{
+            rst.nr_opr, rst.tot_bytes, rst.tensor_value_bytes,
+            static_cast<size_t>(rst.content_hash)};
+    for (auto i : rst_stat) {
+        stat.append(py::cast(i));
+    }
+}
 }  // namespace
 #define DEF_READWRITE(name) .def_readwrite(#name, &CURRENT_CLASS::name)
 
@@ -285,6 +344,9 @@ void init_graph_rt(py::module m) {
                             &_OptimizeForInferenceOptions::f16_io_f32_comp)
                     .def_readwrite(
                             "f16_io_comp", &_OptimizeForInferenceOptions::f16_io_comp)
+                    .def_readwrite(
+                            "bf16_io_f32_comp",
+                            &_OptimizeForInferenceOptions::bf16_io_f32_comp)
                     .def_readwrite(
                             "fuse_conv_bias_nonlinearity",
                             &_OptimizeForInferenceOptions::fuse_conv_bias_nonlinearity)
@@ -294,6 +356,27 @@ void init_graph_rt(py::module m) {
                     .def_readwrite(
                             "fuse_preprocess",
                             &_OptimizeForInferenceOptions::fuse_preprocess)
+                    .def_readwrite(
+                            "fuse_horizontal",
+                            &_OptimizeForInferenceOptions::fuse_horizontal)
+                    .def_readwrite(
+                            "block_sparse_weight",
+                            &_OptimizeForInferenceOptions::block_sparse_weight)
+                    .def_readwrite(
+                            "weight_only_quant_int8",
+                            &_OptimizeForInferenceOptions::weight_only_quant_int8)
+                    .def_readwrite(
+                            "weight_only_quant_int4",
+                            &_OptimizeForInferenceOptions::weight_only_quant_int4)
+                    .def_readwrite(
+                            "fuse_multi_output_elemwise",
+                            &_OptimizeForInferenceOptions::fuse_multi_output_elemwise)
+                    .def_readwrite(
+                            "spatial_tiling",
+                            &_OptimizeForInferenceOptions::spatial_tiling)
+                    .def_readwrite(
+                            "padding_channel",
+                            &_OptimizeForInferenceOptions::padding_channel)
                     .def_readwrite(
                             "layout_transform",
                             &_OptimizeForInferenceOptions::layout_transform);
@@ -308,6 +391,7 @@ void init_graph_rt(py::module m) {
             .value("NCHW32", _LayoutTransform::NCHW32)
             .value("CHWN4", _LayoutTransform::CHWN4)
             .value("NCHW64", _LayoutTransform::NCHW64)
+            .value("NHWC", _LayoutTransform::NHWC)
             .export_values();
 
     m.def("optimize_for_inference",
@@ -377,43 +461,52 @@ void init_graph_rt(py::module m) {
             .def_readwrite("graph_modified", &_SerializationMetadata::graph_modified)
             .def_readwrite("is_valid", &_SerializationMetadata::is_valid);
 
+    auto make_dump_config = [](int keep_var_name, bool keep_opr_name,
+                               bool keep_param_name, bool keep_opr_priority,
+                               int tensor_value_compression, bool dedup_tensor_value) {
+        ser::GraphDumper::DumpConfig config{
+                keep_var_name, keep_param_name, keep_opr_priority, keep_opr_name};
+        config.tensor_value_compression =
+                static_cast<ser::TensorValueCompression>(tensor_value_compression);
+        config.dedup_shared_tensor_value = dedup_tensor_value;
+        return config;
+    };
+
     m.def("dump_graph",
-          [](const std::vector<VarNode*>& dest_vars, int keep_var_name,
-             bool keep_opr_name, bool keep_param_name, bool keep_opr_priority,
-             std::optional<_SerializationMetadata> metadata, py::list& stat,
-             py::list& inputs, py::list& outputs, py::list& params) {
+          [make_dump_config](
+                  const std::vector<VarNode*>& dest_vars, int keep_var_name,
+                  bool keep_opr_name, bool keep_param_name, bool keep_opr_priority,
+                  int tensor_value_compression, bool dedup_tensor_value,
+                  std::optional<_SerializationMetadata> metadata, py::list& stat,
+                  py::list& inputs, py::list& outputs, py::list& params) {
               std::vector<uint8_t> buf;
-              auto dumper =
-                      ser::GraphDumper::make(ser::OutputFile::make_vector_proxy(&buf));
-              SymbolVarArray symvars(dest_vars.begin(), dest_vars.end());
-
-              ser::GraphDumper::DumpConfig config{
-                      keep_var_name, keep_param_name, keep_opr_priority, keep_opr_name};
-
-              ser::GraphDumper::DumpResult rst;
-              if (metadata)
-                  rst = dumper->dump(symvars, config, *metadata);
-              else
-                  rst = dumper->dump(symvars, config);
-
-              for (auto i : rst.inputs) {
-                  inputs.append(py::cast(i));
-              }
-              for (auto i : rst.outputs) {
-                  outputs.append(py::cast(i));
-              }
-              for (auto i : rst.params) {
-                  params.append(py::cast(i));
-              }
-              auto rst_stat = std::vector{
-                      rst.nr_opr, rst.tot_bytes, rst.tensor_value_bytes,
-                      static_cast<size_t>(rst.content_hash)};
-              for (auto i : rst_stat) {
-                  stat.append(py::cast(i));
-              }
+              _dump_graph(
+                      ser::OutputFile::make_vector_proxy(&buf), dest_vars,
+                      make_dump_config(
+                              keep_var_name, keep_opr_name, keep_param_name,
+                              keep_opr_priority, tensor_value_compression,
+                              dedup_tensor_value),
+                      metadata, stat, inputs, outputs, params);
               return py::bytes(reinterpret_cast<const char*>(&buf[0]), buf.size());
           });
 
+    m.def("dump_graph_to_file",
+          [make_dump_config](
+                  py::object file, const std::vector<VarNode*>& dest_vars,
+                  int keep_var_name, bool keep_opr_name, bool keep_param_name,
+                  bool keep_opr_priority, int tensor_value_compression,
+                  bool dedup_tensor_value,
+                  std::optional<_SerializationMetadata> metadata, py::list& stat,
+                  py::list& inputs, py::list& outputs, py::list& params) {
+              _dump_graph(
+                      std::make_unique<_PyOutputFile>(file), dest_vars,
+                      make_dump_config(
+                              keep_var_name, keep_opr_name, keep_param_name,
+                              keep_opr_priority, tensor_value_compression,
+                              dedup_tensor_value),
+                      metadata, stat, inputs, outputs, params);
+          });
+
     m.def("load_graph",
           [](std::string& buf, py::list& output_var_map, py::list& output_var_list) {
               auto file = ser::InputFile::make_mem_proxy(buf.c_str(), buf.length());
@@ -493,7 +586,8 @@ void init_graph_rt(py::module m) {
     auto PyGraphOpt = py::class_<cg::ComputingGraph::Options::GraphOpt>(
             PyComputingGraphOptions, "GraphOpt") DEF_READWRITE(jit)
             DEF_READWRITE(jit_config)
-            DEF_READWRITE(tensorrt);
+            DEF_READWRITE(tensorrt)
+            DEF_READWRITE(layout_transform);
 
 #undef CURRENT_CLASS
 #define CURRENT_CLASS cg::ComputingGraph::Options::GraphOpt::JITConfig
@@ -508,7 +602,9 @@ void init_graph_rt(py::module m) {
     py::class_<cg::ComputingGraph::Options::SublinearMemConfig>(
             PyComputingGraphOptions, "SublinearMemConfig") DEF_READWRITE(thresh_nr_try)
             DEF_READWRITE(genetic_nr_iter) DEF_READWRITE(genetic_pool_size)
-                    DEF_READWRITE(lb_memory_mb) DEF_READWRITE(num_worker);
+                    DEF_READWRITE(lb_memory_mb) DEF_READWRITE(num_worker)
+                            DEF_READWRITE(genetic_early_stop)
+                                    DEF_READWRITE(enable_plan_cache);
 
 #undef CURRENT_CLASS
 
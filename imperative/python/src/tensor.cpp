@@ -15,6 +15,7 @@
 #include "megbrain/imperative/ops/backward_graph.h"
 #include "megbrain/imperative/ops/utility.h"
 #include "megbrain/imperative/profiler.h"
+#include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/io.h"
 
 #include "./common.h"
@@ -174,6 +175,197 @@ apply_result_t apply(ApplyContext& ctx) {
     mgb_assert(0);
 }
 
+namespace {
+
+/*!
+ * \brief the state of amp autocast, which is synced from megengine.amp
+ *
+ * The casts of the parameters are cached until the cache is cleared, which
+ * happens when autocast is entered, exited or reconfigured, and when a
+ * GradManager starts or stops recording, i.e. at least once per training
+ * step. So a parameter read by several ops in a step is cast only once, and
+ * the casts for a step are always recorded by the GradManager of that step.
+ */
+struct AutocastState {
+    struct CastCacheEntry {
+        std::weak_ptr<Tensor> src;
+        DType dtype;
+        std::shared_ptr<Tensor> value;
+    };
+
+    bool enabled = false;
+    DType low_dtype = dtype::Float16(), high_dtype = dtype::Float32();
+    std::unordered_map<Tensor*, CastCacheEntry> cast_cache;
+};
+
+AutocastState autocast_state;
+
+//! whether \p obj is an instance of a subclass of Tensor, e.g. Parameter
+bool is_parameter(PyObject* obj) {
+    auto* base = Py_TYPE(obj)->tp_base;
+    return base && TensorWrapper::wrap_t::type().same_pytype(base->tp_base);
+}
+
+std::shared_ptr<Tensor> autocast_tensor(Tensor* tensor, DType dtype, bool cacheable) {
+    if (tensor->dtype() == dtype) {
+        return tensor->shared_from_this();
+    }
+    // the casts recorded by tracing should not be shared across traces
+    cacheable = cacheable && !(ApplyContext::global_enable &
+                               (Tensor::Flags::TRACE | Tensor::Flags::MODULE_TRACE));
+    auto&& cache = autocast_state.cast_cache;
+    if (cacheable) {
+        auto iter = cache.find(tensor);
+        if (iter != cache.end() && iter->second.dtype == dtype &&
+            iter->second.src.lock().get() == tensor) {
+            return iter->second.value;
+        }
+    }
+    auto op = std::make_shared<TypeCvt>();
+    op->dtype = dtype;
+    auto ret = python::apply(op, tensor)[0];
+    if (cacheable) {
+        cache[tensor] = {tensor->shared_from_this(), dtype, ret};
+    }
+    return ret;
+}
+
+//! the elemwise modes computed in high precision, which lose much accuracy or
+//! overflow easily in low precision
+bool autocast_to_high(Elemwise::Mode mode) {
+    using Mode = Elemwise::Mode;
+    switch (mode) {
+        case Mode::TRUE_DIV:
+        case Mode::EXP:
+        case Mode::POW:
+        case Mode::LOG:
+        case Mode::EXPM1:
+        case Mode::LOG1P:
+        case Mode::TANH:
+        case Mode::ACOS:
+        case Mode::ASIN:
+        case Mode::ATAN2:
+        case Mode::COS:
+        case Mode::H_SWISH:
+        case Mode::SIGMOID:
+        case Mode::SIN:
+        case Mode::LOG_SUM_EXP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//! a copy of \p op accumulating in float32, as the low precision inputs
+//! would overflow or lose accuracy in the accumulation
+template <typename T, typename... Args>
+std::shared_ptr<OpDef> float32_compute(
+        const std::shared_ptr<OpDef>& op, Args&&... args) {
+    auto&& typed = op->cast_final_safe<T>();
+    if (typed.compute_mode == T::ComputeMode::FLOAT32) {
+        return op;
+    }
+    auto ret = std::make_shared<T>(
+            typed.param(), typed.policy(), std::forward<Args>(args)...);
+    ret->compute_mode = T::ComputeMode::FLOAT32;
+    ret->set_scope(typed.scope());
+    return ret;
+}
+
+/*!
+ * \brief the autocast rule of \p op
+ * \param[in,out] op the op to be applied, which may be replaced
+ * \return the dtypes the inputs are cast to, where the last one applies to
+ *      all the remaining inputs; empty if the op is not affected by autocast
+ */
+SmallVector<DType, 2> autocast_rule(std::shared_ptr<OpDef>& op) {
+    auto low = autocast_state.low_dtype, high = autocast_state.high_dtype;
+    auto&& type = op->dyn_typeinfo();
+    if (type == MatrixMul::typeinfo()) {
+        op = float32_compute<MatrixMul>(op);
+        return {low};
+    }
+    if (type == BatchedMatrixMul::typeinfo()) {
+        op = float32_compute<BatchedMatrixMul>(op);
+        return {low};
+    }
+    if (type == Convolution::typeinfo()) {
+        op = float32_compute<Convolution>(op);
+        return {low};
+    }
+    if (type == ConvolutionBackwardData::typeinfo()) {
+        op = float32_compute<ConvolutionBackwardData>(
+                op, op->cast_final<ConvolutionBackwardData>().dtype);
+        return {low};
+    }
+    if (type == DeformableConv::typeinfo()) {
+        op = float32_compute<DeformableConv>(op);
+        return {low};
+    }
+    if (type == FusedAttention::typeinfo()) {
+        return {low};
+    }
+    if (type == BatchNorm::typeinfo()) {
+        // only the data is computed in low precision, while the affine params
+        // and the statistics are kept in high precision
+        return {low, high};
+    }
+    if (type == LayerNorm::typeinfo() || type == GroupNorm::typeinfo()) {
+        return {high};
+    }
+    if (type == Elemwise::typeinfo() &&
+        autocast_to_high(op->cast_final<Elemwise>().mode)) {
+        return {high};
+    }
+    return {};
+}
+
+//! quantized and bool inputs are left as is
+bool autocastable(DType dtype) {
+    auto category = dtype.category();
+    return category == DTypeCategory::FLOAT || category == DTypeCategory::INT;
+}
+
+/*!
+ * \brief cast the inputs of \p ctx by the autocast rules
+ * \param holder keeps the casted inputs alive until the op is applied
+ */
+void apply_autocast(
+        ApplyContext& ctx, PyObject* const* pyargs, SmallVector<Tensor*, 64>& tensors,
+        SmallVector<std::shared_ptr<Tensor>, 8>& holder) {
+    auto dtypes = autocast_rule(ctx.op);
+    if (dtypes.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < ctx.nargs; ++i) {
+        if (!autocastable(tensors[i]->dtype())) {
+            continue;
+        }
+        auto dtype = dtypes[std::min(i, dtypes.size() - 1)];
+        auto casted = autocast_tensor(tensors[i], dtype, is_parameter(pyargs[i]));
+        tensors[i] = casted.get();
+        ctx.flags |= casted->m_flags;
+        holder.push_back(std::move(casted));
+    }
+}
+
+//! the autocast of ops on var nodes, whose casts are never cached
+void apply_autocast(std::shared_ptr<OpDef>& op, SmallVector<cg::VarNode*>& inputs) {
+    auto dtypes = autocast_rule(op);
+    for (size_t i = 0; i < inputs.size() && !dtypes.empty(); ++i) {
+        auto dtype = dtypes[std::min(i, dtypes.size() - 1)];
+        if (autocastable(inputs[i]->dtype()) && inputs[i]->dtype() != dtype) {
+            inputs[i] = opr::TypeCvt::make(inputs[i], dtype).node();
+        }
+    }
+}
+
+void clear_amp_cast_cache() {
+    autocast_state.cast_cache.clear();
+}
+
+}  // anonymous namespace
+
 PyObject* py_apply(
         PyObject* self, PyObject* const* args, size_t nargs /* , PyObject* kwnames */) {
     try {
@@ -214,6 +406,9 @@ PyObject* py_apply(
             for (size_t i = 0; i < nargs; ++i) {
                 vinputs[i] = py::handle(args[i]).cast<PySymbolVar*>()->m_node;
             }
+            if (autocast_state.enabled) {
+                apply_autocast(ctx.op, vinputs);
+            }
             auto op = ctx.op.get();
             auto rst = OpDef::apply_on_var_node(*op, vinputs);
             auto ret = pybind11::tuple(rst.size());
@@ -240,6 +435,11 @@ PyObject* py_apply(
             }
         }
 
+        SmallVector<std::shared_ptr<Tensor>, 8> autocast_holder;
+        if (autocast_state.enabled) {
+            apply_autocast(ctx, args, tensors, autocast_holder);
+        }
+
         auto outputs = apply(ctx);
         size_t nout = outputs.size();
         auto ret = py::tuple(nout);
@@ -1048,6 +1248,8 @@ void init_tensor(py::module m) {
     });
     m.def("push_scope", [](std::string name) { interpreter_for_py->push_scope(name); });
     m.def("pop_scope", [](std::string name) { interpreter_for_py->pop_scope(name); });
+    m.def("start_batch", []() { interpreter_for_py->start_batch(); });
+    m.def("stop_batch", []() { interpreter_for_py->stop_batch(); });
     m.def(
             "start_profile",
             [](imperative::Profiler::options_t options) {
@@ -1091,6 +1293,7 @@ void init_tensor(py::module m) {
     m.def(
             "close",
             []() {
+                clear_amp_cast_cache();
                 interpreter_for_py->close();
                 sync_py_task_q();
             },
@@ -1130,9 +1333,80 @@ void init_tensor(py::module m) {
     m.def("unset_tracing", &unset_tracing);
     m.def("set_allow_higher_order_directive",
           [](bool value) { GradKey::allow_higher_order_directive = value; });
+    m.def("set_fused_backward",
+          [](bool value) { GradKey::enable_fused_backward = value; });
     m.def("set_module_tracing", &set_module_tracing);
     m.def("unset_module_tracing", &unset_module_tracing);
     m.def("is_tracing_module", &is_tracing_module);
+
+    m.def("_set_amp_autocast", [](bool enabled, DType low_dtype, DType high_dtype) {
+        autocast_state.enabled = enabled;
+        autocast_state.low_dtype = low_dtype;
+        autocast_state.high_dtype = high_dtype;
+        clear_amp_cast_cache();
+    });
+    m.def("_clear_amp_cast_cache", &clear_amp_cast_cache);
+    m.def("_amp_cast", [](py::handle tensor, bool promote) -> py::object {
+        auto dtype = promote ? autocast_state.high_dtype : autocast_state.low_dtype;
+        auto* tw = TensorWrapper::try_cast(tensor.ptr());
+        if (!tw) {
+            return tensor.attr("astype")(dtype);
+        }
+        bool param = is_parameter(tensor.ptr());
+        auto pytype = param ? Py_TYPE(tensor.ptr())->tp_base : Py_TYPE(tensor.ptr());
+        return TensorWrapper::make(
+                pytype, autocast_tensor(tw->m_tensor.get(), dtype, param));
+    });
+
+    // the memory of CPU tensors is shared with numpy arrays if the arrays are
+    // contiguous, aligned and of supported dtypes, otherwise values are copied
+    m.def("_from_numpy", [](py::handle cls, py::array data, CompNode cn) {
+        interpreter::Interpreter::Handle handle;
+        if (cn.mem_node() == CompNode::default_cpu().mem_node()) {
+            auto hv = npy::np2tensor(data.ptr(), npy::Meth::borrow(cn), {});
+            auto align = cn.get_mem_addr_alignment();
+            if (reinterpret_cast<uintptr_t>(hv.raw_ptr()) % align) {
+                HostTensorND aligned{cn, hv.dtype()};
+                hv = aligned.copy_from(hv);
+            }
+            handle = interpreter_for_py->put(DeviceTensorND::make_proxy(hv), hv);
+        } else {
+            HostTensorND ret(cn);
+            handle = interpreter_for_py->put(
+                    npy::np2tensor(data.ptr(), npy::Meth::copy_into(&ret), {}), false);
+        }
+        auto tensor = std::make_shared<Tensor>(handle);
+        if (data.ndim() == 0) {
+            tensor->m_flags |= Tensor::Flags::SCALAR;
+        }
+        return TensorWrapper::make(
+                reinterpret_cast<PyTypeObject*>(cls.ptr()), std::move(tensor));
+    });
+    // a read-only array sharing the memory of a CPU tensor, which keeps the
+    // memory alive and refuses inplace ops on the tensor until released
+    m.def("_numpy_view", [](py::handle tensor) -> py::object {
+        auto* tw = TensorWrapper::try_cast(tensor.ptr());
+        if (!tw || !tw->m_tensor->m_handle.get() ||
+            tw->m_tensor->comp_node().mem_node() !=
+                    CompNode::default_cpu().mem_node()) {
+            return tensor.attr("numpy")();
+        }
+        auto dv = [&]() {
+            py::gil_scoped_release _;
+            auto dv = interpreter_for_py->get_dev_tensor(tw->m_tensor->m_handle.get());
+            dv.comp_node().sync();
+            return dv;
+        }();
+        auto arr = py::reinterpret_steal<py::array>(npy::ndarray_from_tensor(
+                HostTensorND::make_proxy(dv), npy::ShareType::TRY_SHARE));
+        PyArray_CLEARFLAGS(
+                reinterpret_cast<PyArrayObject*>(arr.ptr()), NPY_ARRAY_WRITEABLE);
+        if (tw->m_tensor->m_flags & Tensor::Flags::SCALAR) {
+            return py::reinterpret_steal<py::object>(
+                    PyArray_Squeeze(reinterpret_cast<PyArrayObject*>(arr.ptr())));
+        }
+        return std::move(arr);
+    });
 }
 
 #undef MGE_PY_INTERFACE
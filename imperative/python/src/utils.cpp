@@ -218,6 +218,11 @@ void init_utils(py::module m) {
     m.def("_defrag", [](const mgb::CompNode& cn) {
         mgb::imperative::BlobManager::inst()->defrag(cn);
     });
+    m.def("_set_blob_arena", [](const mgb::CompNode& cn, size_t warmup_steps) {
+        mgb::imperative::BlobManager::inst()->set_arena(cn, warmup_steps);
+    });
+    m.def("_blob_arena_mark_step",
+          []() { mgb::imperative::BlobManager::inst()->mark_step(); });
     m.def("_set_fork_exec_path_for_timed_func",
           [](const std::string& arg0, const ::std::string arg1) {
               using namespace std::placeholders;
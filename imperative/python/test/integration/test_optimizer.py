@@ -344,3 +344,40 @@ def test_adamw(monkeypatch, case, update_lr, inplace_mode):
     with monkeypatch.context() as mk:
         mk.setenv("MEGENGINE_INPLACE_UPDATE", str(int(inplace_mode)))
         _test_optimizer("AdamW", case, CheckValue, update_lr=update_lr)
+
+
+@pytest.mark.parametrize(
+    "opt_str, case",
+    [
+        ("SGD", {"lr": 0.01, "momentum": 0.9, "nesterov": True, "weight_decay": 0.1}),
+        ("Adam", {"lr": 0.01, "weight_decay": 0.1}),
+        ("AdamW", {"lr": 0.01}),
+    ],
+)
+def test_multi_tensor_update(monkeypatch, opt_str, case):
+    # the params of MLP are updated by one op in inplace mode, which should
+    # give the same params and states as the updates one by one
+    def run(inplace_mode):
+        np.random.seed(0)
+        net = MLP()
+        for param in net.parameters():
+            param._reset(Tensor(np.random.random(param.shape).astype(np.float32)))
+        opt = getattr(optimizer, opt_str)(net.parameters(), **case)
+        gm = ad.GradManager().attach(net.parameters())
+        with monkeypatch.context() as mk:
+            mk.setenv("MEGENGINE_INPLACE_UPDATE", str(int(inplace_mode)))
+            for _ in range(3):
+                data = Tensor(np.random.random((2, 28)).astype(np.float32))
+                opt.clear_grad()
+                with gm:
+                    gm.backward(net(data).sum())
+                opt.step()
+        return [p.numpy() for p in net.parameters()], opt.state_dict()
+
+    params, state = run(False)
+    params_multi, state_multi = run(True)
+    for p, p_multi in zip(params, params_multi):
+        np.testing.assert_allclose(p, p_multi, rtol=1e-5, atol=1e-6)
+    for st, st_multi in zip(state["state"].values(), state_multi["state"].values()):
+        for k in st:
+            np.testing.assert_allclose(st[k], st_multi[k], rtol=1e-5, atol=1e-6)
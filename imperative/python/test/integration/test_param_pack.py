@@ -67,3 +67,72 @@ def test_param_pack(param_shape, threshold, n_iters=100):
             np.testing.assert_equal(p.grad.numpy(), np.ones_like(p.grad.numpy()))
 
     worker()
+
+
+@pytest.mark.require_ngpu(2)
+@pytest.mark.isolated_distributed
+@pytest.mark.parametrize(
+    "compression",
+    [
+        dist.compression.FP16Compression,
+        lambda: dist.compression.TopKCompression(ratio=1),
+        dist.compression.PowerSGDCompression,
+    ],
+    ids=["fp16", "topk", "powersgd"],
+)
+def test_param_pack_compression(compression, n_iters=10):
+    param_shape = (16, 16)
+    data = np.ones(param_shape, dtype="float32")
+
+    @dist.launcher(n_gpus=2)
+    def worker():
+        net = Simple(param_shape)
+        opt = SGD(net.parameters(), lr=0.1)
+
+        allreduce_cb = dist.make_allreduce_cb(
+            "MEAN", dist.WORLD, compression=compression()
+        )
+        gm = ad.GradManager().attach(net.parameters(), callbacks=[allreduce_cb])
+
+        for i in range(n_iters):
+            opt.clear_grad()
+            with gm:
+                loss = net(tensor(data)).sum()
+                gm.backward(loss)
+
+        for p in net.params:
+            np.testing.assert_allclose(
+                p.grad.numpy(), np.ones_like(p.grad.numpy()), rtol=1e-5
+            )
+
+    worker()
+
+
+@pytest.mark.require_ngpu(2)
+@pytest.mark.isolated_distributed
+def test_zero_optimizer(n_iters=5):
+    param_shape = (3, 5)
+    data = np.random.random((2,) + param_shape).astype("float32")
+
+    @dist.launcher(n_gpus=2)
+    def worker():
+        rank = dist.get_rank()
+        net, zero_net = Simple(param_shape), Simple(param_shape)
+        opt = optimizer.Adam(net.parameters(), lr=0.01)
+        zero_opt = dist.ZeroOptimizer(optimizer.Adam, zero_net.parameters(), lr=0.01)
+        gm = ad.GradManager().attach(
+            net.parameters(), callbacks=[dist.make_allreduce_cb("MEAN")]
+        )
+        zero_gm = ad.GradManager().attach(zero_net.parameters())
+
+        for i in range(n_iters):
+            for m, o, g in [(net, opt, gm), (zero_net, zero_opt, zero_gm)]:
+                o.clear_grad()
+                with g:
+                    g.backward(m(tensor(data[rank])).sum())
+                o.step()
+
+        for p, zp in zip(net.params, zero_net.params):
+            np.testing.assert_allclose(p.numpy(), zp.numpy(), rtol=1e-5)
+
+    worker()
@@ -5,7 +5,10 @@
 # Unless required by applicable law or agreed to in writing,
 # software distributed under the License is distributed on an
 # "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-from megengine import amp
+import numpy as np
+
+import megengine.functional as F
+from megengine import Parameter, amp, tensor
 from megengine.core.tensor import amp as origin_amp
 
 
@@ -21,14 +24,27 @@ def test_grad_scaler():
     origin_enabled = amp.enabled
     origin_high = amp.high_prec_dtype
     origin_low = amp.low_prec_dtype
-    with amp.autocast(low_prec_dtype="low", high_prec_dtype="high"):
-        check(True, "low", "high")
+    with amp.autocast(low_prec_dtype="float32", high_prec_dtype="float16"):
+        check(True, "float32", "float16")
     check(origin_enabled, origin_low, origin_high)
     amp.enabled = True
-    amp.high_prec_dtype = "high"
-    amp.low_prec_dtype = "low"
-    check(True, "low", "high")
+    amp.high_prec_dtype = "float16"
+    amp.low_prec_dtype = "float32"
+    check(True, "float32", "float16")
     amp.enabled = origin_enabled
     amp.high_prec_dtype = origin_high
     amp.low_prec_dtype = origin_low
     check(origin_enabled, origin_low, origin_high)
+
+
+def test_autocast_dispatch():
+    x = tensor(np.random.random((4, 8)).astype("float32"))
+    w = Parameter(np.random.random((8, 8)).astype("float32"))
+    with amp.autocast():
+        y = F.matmul(x, w)
+        assert y.dtype == np.float16
+        assert F.exp(y).dtype == np.float32
+        # the cast of a parameter is cached and reused by later ops
+        z = F.matmul(y, w)
+        assert z.dtype == np.float16
+    assert F.matmul(x, w).dtype == np.float32
@@ -19,6 +19,7 @@ import megengine.module as M
 import megengine.optimizer as optim
 from megengine.autodiff import GradManager
 from megengine.jit import trace
+from megengine.utils.zero_copy import as_numpy
 
 
 def test_basic():
@@ -48,6 +49,35 @@ def test_basic():
     np.testing.assert_equal(b.grad.numpy(), [1])
 
 
+def test_fused_backward():
+    from megengine.experimental.autograd import (
+        disable_fused_backward,
+        enable_fused_backward,
+    )
+
+    net = M.Sequential(M.Linear(4, 8), M.ReLU(), M.Linear(8, 2))
+    x = mge.tensor(np.random.random((3, 4)).astype("float32"))
+    gm = GradManager().attach(net.parameters())
+
+    def get_grads():
+        for p in net.parameters():
+            p.grad = None
+        with gm:
+            loss = F.sum(net(x) * F.exp(net(x)))
+            gm.backward(loss)
+        return [p.grad.numpy() for p in net.parameters()]
+
+    expected = get_grads()
+    enable_fused_backward()
+    try:
+        # the second step reuses the fused backward of the first one
+        for _ in range(2):
+            for g, e in zip(get_grads(), expected):
+                np.testing.assert_allclose(g, e, rtol=1e-5)
+    finally:
+        disable_fused_backward()
+
+
 def test_dy():
     x = mge.tensor([1.0, 3.0, 5.0]).reshape(1, 3)
     w = mge.tensor([2.0, 4.0, 6.0]).reshape(3, 1)
@@ -193,6 +223,45 @@ def test_empty_grad_in_backward():
         assert np.all(y.grad.numpy() == 1)
 
 
+@pytest.mark.parametrize("inplace_mode", [False, True])
+def test_accumulate_grad(monkeypatch, inplace_mode):
+    # on CPU, so that as_numpy is a view of the storage of .grad
+    x = mge.tensor([1.0, 3.0, 5.0], device="cpu0").reshape(1, 3)
+    w = mge.Parameter([[2.0], [4.0], [6.0]], device="cpu0")
+    b = mge.Parameter(-1.0, device="cpu0")
+    dy = mge.tensor([[2.0]], device="cpu0")
+
+    def storage_ptr(tensor):
+        return as_numpy(tensor).__array_interface__["data"][0]
+
+    gm = GradManager().attach([w, b])
+    with monkeypatch.context() as mk:
+        mk.setenv("MEGENGINE_INPLACE_UPDATE", str(int(inplace_mode)))
+        for i in range(4):
+            with gm:
+                y = F.matmul(x, w) + b
+                # the grad of b shares storage with dy
+                gm.backward(y, dy)
+            ptr = storage_ptr(w.grad)
+            if i > 1:
+                if inplace_mode:
+                    # accumulated into the sum allocated by the second backward
+                    assert ptr == last_ptr
+                else:
+                    # the sum is allocated while the last one is still alive
+                    assert ptr != last_ptr
+            last_ptr = ptr
+
+    np.testing.assert_equal(w.grad.numpy(), [[8], [24], [40]])
+    np.testing.assert_equal(b.grad.numpy(), 8)
+    np.testing.assert_equal(dy.numpy(), [[2]])
+
+    # the tracked sums are released with the tensors
+    assert len(gm._accum_grads) == 2
+    del w, b
+    assert len(gm._accum_grads) == 0
+
+
 @pytest.mark.require_ngpu(2)
 @pytest.mark.isolated_distributed
 @pytest.mark.parametrize(
@@ -121,3 +121,53 @@ def test_async_error():
             F.utils._simulate_error()
     finally:
         mge.core.set_option("async_level", orig_lvl)
+
+
+def test_elemwise_fusion():
+    def chain(x, y):
+        for _ in range(3):
+            x = F.relu(x * y + 1) - y / 2
+        return x
+
+    x = mge.tensor(np.random.rand(4, 5), dtype="float32")
+    y = mge.tensor(np.random.rand(4, 5) + 1, dtype="float32")
+    expect = chain(x, y).numpy()
+    with mge.core.option("buffer_length", 16):
+        with mge.core.option("enable_elemwise_fusion", 1):
+            # the second run reuses the fused ops
+            for _ in range(2):
+                z = chain(x, y)
+                w = z * 2
+                np.testing.assert_allclose(z.numpy(), expect, rtol=1e-5)
+                np.testing.assert_allclose(w.numpy(), expect * 2, rtol=1e-5)
+
+
+@pytest.mark.require_ngpu(1)
+def test_multi_stream():
+    a = np.random.rand(64, 64).astype("float32")
+    b = np.random.rand(64, 64).astype("float32")
+    with mge.core.option("enable_multi_stream", 1):
+        x = mge.tensor(a, device="gpu0")
+        y = mge.tensor(b, device="gpu0")
+        # tensors copied on the copy stream are still on their logical device
+        assert str(x.device) == "gpu0:0"
+        z = F.matmul(x, y) + x
+        w = z * 2
+        np.testing.assert_allclose(z.numpy(), a @ b + a, rtol=1e-5)
+        np.testing.assert_allclose(w.numpy(), (a @ b + a) * 2, rtol=1e-5)
+
+
+def test_batch():
+    x = mge.tensor(np.random.rand(8, 8), dtype="float32")
+    expect = x.numpy()
+    with mge.core.option("batch_length", 16):
+        with mge.core.batch():
+            y = x
+            for _ in range(40):
+                y = y * 2 - x
+            with mge.core.batch():
+                z = y + 1
+            # waiting for a value issues the held commands
+            np.testing.assert_allclose(y.numpy(), expect, rtol=1e-5)
+            w = z * 2
+    np.testing.assert_allclose(w.numpy(), (expect + 1) * 2, rtol=1e-5)
@@ -148,6 +148,16 @@ def test_dataloader_serial():
         assert label._tuple_shape == (4,)
 
 
+
+def test_dataloader_preload_ahead():
+    dataset = init_dataset()
+    dataloader = DataLoader(
+        dataset, sampler=SequentialSampler(dataset, batch_size=6), preload=3
+    )
+    labels = [label.numpy() for _, label in dataloader]
+    assert len(labels) == len(dataloader)
+    np.testing.assert_equal(np.concatenate(labels), dataset.arrays[1])
+
 def test_dataloader_parallel():
     # set max shared memory to 100M
     os.environ["MGE_PLASMA_MEMORY"] = "100000000"
@@ -77,6 +77,26 @@ def test_RandomResizedCrop():
     assert aug_data_shape == target_shape
 
 
+def test_DeviceRandomResizedCrop():
+    images = np.stack([a for a, _ in generate_data()])
+    t = DeviceRandomResizedCrop(output_size=RandomResizedCrop_size)
+    assert t(images).numpy().shape == (4, 3) + RandomResizedCrop_size
+
+    # the whole images are kept with the crop of scale 1 and ratio 1
+    t = DeviceRandomResizedCrop(
+        output_size=data_shape[:2],
+        scale_range=(1, 1),
+        ratio_range=(1, 1),
+        flip_prob=1,
+        mean=[1, 2, 3],
+        std=2,
+    )
+    expected = (images[:, :, ::-1].astype(np.float32) - [1, 2, 3]) / 2
+    np.testing.assert_allclose(
+        t(images).numpy(), expected.transpose(0, 3, 1, 2), atol=1e-5
+    )
+
+
 def test_Normalize():
     t = Normalize()
     aug_data = t.apply_batch(generate_data())
@@ -244,3 +244,44 @@ def test_get_cuda_compute_capability():
         assert mge.device.get_cuda_compute_capability(dist.get_rank()) > 0
 
     worker()
+
+
+@pytest.mark.require_ngpu(2)
+@pytest.mark.isolated_distributed
+def test_pipeline_executor():
+    data = np.random.random((8, 4)).astype("float32")
+    label = np.random.random((8, 2)).astype("float32")
+    weights = [np.random.random((4, 3)), np.random.random((3, 2))]
+    weights = [w.astype("float32") for w in weights]
+
+    def loss_fn(pred, label):
+        return ((pred - label) ** 2).sum()
+
+    class Stage(mge.module.Module):
+        def __init__(self, w):
+            super().__init__()
+            self.w = mge.Parameter(w)
+
+        def forward(self, x):
+            return mge.functional.matmul(x, self.w)
+
+    def expect_grad(i):
+        stages = [Stage(w) for w in weights]
+        gm = mge.autodiff.GradManager().attach(stages[i].parameters())
+        with gm:
+            gm.backward(loss_fn(stages[1](stages[0](mge.tensor(data))), label))
+        return stages[i].w.grad.numpy()
+
+    @dist.launcher(n_gpus=2)
+    def worker():
+        rank = dist.get_rank()
+        stage = Stage(weights[rank])
+        pipe = dist.PipelineExecutor(stage, 4, loss_fn)
+        assert pipe.bubble_ratio == 0.2
+        loss = pipe.step(mge.tensor(data), mge.tensor(label))
+        assert (loss is None) == (rank == 0)
+        np.testing.assert_allclose(
+            stage.w.grad.numpy() * 4, expect_grad(rank), rtol=1e-5
+        )
+
+    worker()
@@ -919,6 +919,50 @@ def test_layer_norm():
     assert abs(outvar.mean()) < 1e-7
 
 
+@pytest.mark.parametrize("affine", [True, False])
+def test_group_norm(affine):
+    def _group_norm_numpy(x, num_groups, weight, bias, eps=1e-5):
+        N, C = x.shape[:2]
+        g = x.reshape(N, num_groups, -1).astype(np.float64)
+        mean = g.mean(axis=2, keepdims=True)
+        var = g.var(axis=2, keepdims=True)
+        y = ((g - mean) / np.sqrt(var + eps)).reshape(x.shape)
+        if weight is not None:
+            param_shape = (1, C) + (1,) * (x.ndim - 2)
+            y = y * weight.reshape(param_shape) + bias.reshape(param_shape)
+        return y
+
+    x = np.random.randn(4, 6, 5, 7).astype("float32") + 3
+    weight = bias = None
+    if affine:
+        weight = np.random.randn(6).astype("float32")
+        bias = np.random.randn(6).astype("float32")
+    out = F.nn.group_norm(
+        tensor(x),
+        3,
+        affine,
+        None if weight is None else tensor(weight),
+        None if bias is None else tensor(bias),
+    )
+    np.testing.assert_allclose(
+        out.numpy(), _group_norm_numpy(x, 3, weight, bias), rtol=1e-5, atol=1e-5
+    )
+
+
+@pytest.mark.parametrize("shape", [((2, 5, 8), 11, 6), ((2, 3, 7, 16), 1, 16)])
+def test_fused_attention(shape):
+    (*batch, S, D), T, Dv = shape
+    q = np.random.randn(*batch, S, D).astype("float32")
+    k = np.random.randn(*batch, T, D).astype("float32")
+    v = np.random.randn(*batch, T, Dv).astype("float32")
+    scores = np.matmul(q, np.swapaxes(k, -1, -2)) / np.sqrt(D)
+    p = np.exp(scores - scores.max(axis=-1, keepdims=True))
+    expected = np.matmul(p / p.sum(axis=-1, keepdims=True), v)
+    out = F.nn.fused_attention(tensor(q), tensor(k), tensor(v))
+    assert out.shape == expected.shape
+    np.testing.assert_allclose(out.numpy(), expected, rtol=1e-5, atol=1e-5)
+
+
 def test_batchnorm2d_autocast():
     """check amp's result is equal to manually converted result"""
     amp.enabled = True
@@ -944,6 +988,36 @@ def test_batchnorm2d_autocast():
     np.testing.assert_allclose(out.numpy(), expected.numpy())
 
 
+@pytest.mark.parametrize("training", [False, True])
+def test_batch_norm_fused_relu(training):
+    tshape = (2, 4, 5, 7)
+    pshape = (1, 4, 1, 1)
+    x = np.random.randn(*tshape).astype("float32")
+    dy = np.random.randn(*tshape).astype("float32")
+    running_mean = np.random.randn(*pshape).astype("float32")
+    running_var = np.random.rand(*pshape).astype("float32") + 0.5
+
+    def run(fused):
+        inp = tensor(x)
+        grad = Grad().wrt(inp, callback=_save_to(inp))
+        out = F.batch_norm(
+            inp,
+            tensor(running_mean),
+            tensor(running_var),
+            training=training,
+            nonlinear_mode="relu" if fused else "identity",
+        )
+        if not fused:
+            out = F.relu(out)
+        grad(out, tensor(dy))
+        return out.numpy(), inp.grad.numpy()
+
+    out, dx = run(True)
+    expected_out, expected_dx = run(False)
+    np.testing.assert_allclose(out, expected_out, rtol=1e-5, atol=1e-5)
+    np.testing.assert_allclose(dx, expected_dx, rtol=1e-5, atol=1e-5)
+
+
 def test_conv3d():
     inp = tensor(np.ones((2, 2, 4, 4, 4), dtype=np.float32))
     weight = tensor(np.ones((3, 2, 2, 2, 2), dtype=np.float32))
@@ -200,6 +200,19 @@ def test_non_finite():
     np.testing.assert_equal(rst.numpy(), [1])
 
 
+def test_non_finite_scale():
+    data = [np.random.random((3, 4)).astype(np.float32) for _ in range(3)]
+    inps = [tensor(i) for i in data]
+    rst = F.math._check_non_finite(inps, 0.5)
+    np.testing.assert_equal(rst.numpy(), [0])
+    for inp, origin in zip(inps, data):
+        np.testing.assert_allclose(inp.numpy(), origin * 0.5)
+
+    data[1][0][0] = float("inf")
+    rst = F.math._check_non_finite([tensor(i) for i in data], 0.5)
+    np.testing.assert_equal(rst.numpy(), [1])
+
+
 @pytest.mark.parametrize("descending", [True, False])
 @pytest.mark.parametrize("sorted", [True, False])
 @pytest.mark.parametrize("inp1d", [True, False])
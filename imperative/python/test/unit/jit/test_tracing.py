@@ -14,6 +14,7 @@ from tempfile import mkstemp
 import numpy as np
 import pytest
 
+import megengine
 import megengine.core.tensor.megbrain_graph as G
 import megengine.functional as F
 import megengine.optimizer as optim
@@ -236,6 +237,64 @@ def test_capture_dump():
     np.testing.assert_equal(result[0], y)
 
 
+@pytest.mark.parametrize("compression", ["lz", "shuffle_lz"])
+def test_dump_compressed(compression):
+    a = tensor(np.tile(np.arange(16, dtype="float32"), 256))
+
+    @trace(symbolic=True, capture_as_const=True)
+    def f(x):
+        return x * a
+
+    x = tensor(np.random.random(a.shape).astype("float32"))
+    y = f(x).numpy()
+
+    def dump(**kwargs):
+        file = io.BytesIO()
+        f.dump(file, **kwargs)
+        file.seek(0)
+        return file
+
+    raw_size = len(dump().getvalue())
+    file = dump(tensor_value_compression=compression)
+    assert len(file.getvalue()) < raw_size
+    infer_cg = cgtools.GraphInference(file)
+    result = list((infer_cg.run(x)).values())[0]
+    np.testing.assert_equal(result, y)
+
+
+def test_dump_streaming():
+    a = tensor(np.arange(4096, dtype="float32"))
+
+    @trace(symbolic=True, capture_as_const=True)
+    def f(x):
+        return x * a
+
+    x = tensor(np.random.random(a.shape).astype("float32"))
+    y = f(x).numpy()
+
+    class UnseekableFile:
+        def __init__(self):
+            self.buf = io.BytesIO()
+
+        def seekable(self):
+            return False
+
+        def write(self, data):
+            return self.buf.write(data)
+
+    # BytesIO is seekable so values are streamed into it directly
+    streamed = io.BytesIO()
+    f.dump(streamed)
+    buffered = UnseekableFile()
+    f.dump(buffered)
+    assert streamed.getvalue() == buffered.buf.getvalue()
+
+    streamed.seek(0)
+    infer_cg = cgtools.GraphInference(streamed)
+    result = list((infer_cg.run(x)).values())[0]
+    np.testing.assert_equal(result, y)
+
+
 def test_dump_volatile():
     p = tensor([2])
 
@@ -648,3 +707,74 @@ def test_trace_jit_config():
     for fuse_dimshuffle in [None, False, True]:
         for fuse_reduce in [None, False, True]:
             run(fuse_dimshuffle, fuse_reduce)
+
+
+@pytest.mark.parametrize("trace_mode", [False, True])
+def test_trace_persistent_cache(monkeypatch, trace_mode):
+    class DictCache:
+        def __init__(self):
+            self.dict = {}
+
+        def get(self, category, key):
+            return self.dict.get((category, key))
+
+        def put(self, category, key, value):
+            self.dict[(category, key)] = value
+
+    cache = DictCache()
+    monkeypatch.setattr(megengine, "_persistent_cache_impl_ins", cache)
+    scale = 2
+
+    def f(x):
+        return x * scale + 1
+
+    x = tensor([1.0, 2.0])
+    f0 = trace(f, symbolic=trace_mode, persistent_cache=True)
+    np.testing.assert_equal(f0(x).numpy(), [3.0, 5.0])
+    assert len(cache.dict) == 1
+
+    # a new trace, e.g. in a new process, runs the compiled graph at once
+    f1 = trace(f, symbolic=trace_mode, persistent_cache=True)
+    with monkeypatch.context() as mk:
+
+        def record_op(*args):
+            assert False, "the trace should be loaded from cache"
+
+        mk.setattr(f1, "_record_op", record_op)
+        for _ in range(3):
+            np.testing.assert_equal(f1(x).numpy(), [3.0, 5.0])
+
+    # the cached trace mismatches, and is replaced
+    scale = 3
+    f2 = trace(f, symbolic=trace_mode, persistent_cache=True)
+    for _ in range(3):
+        np.testing.assert_equal(f2(x).numpy(), [4.0, 7.0])
+    cached = f2._load_from_cache()
+    assert cached and len(cache.dict) == 1
+
+
+@pytest.mark.parametrize("trace_mode", [False, True])
+def test_trace_specializations(trace_mode):
+    @trace(symbolic=trace_mode, symbolic_shape=False, max_specializations=2)
+    def f(x):
+        # the shape is a const in the trace
+        return x.reshape(-1) * x.shape[0]
+
+    def check(x):
+        np.testing.assert_equal(f(tensor(x)).numpy(), x.reshape(-1) * x.shape[0])
+
+    x0 = np.random.random((2, 3)).astype("float32")
+    x1 = np.random.random((3, 3)).astype("float32")
+    x2 = np.random.random((4, 3)).astype("float32")
+    for _ in range(2):
+        check(x0)
+        check(x1)
+    graph = f._graph
+    check(x0)
+    check(x1)
+    assert f._graph is graph
+    # the trace of x0 is replaced
+    check(x2)
+    check(x1)
+    assert f._graph is graph
+    assert len(f._specializations) == 1
@@ -177,6 +177,19 @@ def test_id_and_name():
     _check_name(flattened_module)
 
 
+def test_same_names():
+    class Chain(M.Module):
+        def forward(self, x):
+            for _ in range(64):
+                x = F.relu(x)
+            return x
+
+    traced_module = trace_module(Chain(), F.zeros((2, 2)))
+    exprs = traced_module.graph.get_function_by_type(F.relu).as_list()
+    names = [expr.outputs[0]._name for expr in exprs]
+    assert names[1:] == ["{}_{}".format(names[0], i) for i in range(1, 64)]
+
+
 def test_set_name():
     traced_module, x, expect = _init_module()
     graph = traced_module.graph
@@ -0,0 +1,39 @@
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+import numpy as np
+import pytest
+
+import megengine.functional as F
+from megengine import tensor
+from megengine.utils.zero_copy import as_numpy, from_numpy
+
+
+def test_from_numpy():
+    data = np.random.random((4, 5)).astype("float32")
+    x = from_numpy(data, "cpu0")
+    np.testing.assert_equal(x.numpy(), data)
+    np.testing.assert_allclose((x + 1).numpy(), data + 1)
+
+    # non-contiguous and unsupported dtypes are copied
+    y = from_numpy(data.T, "cpu0")
+    np.testing.assert_equal(y.numpy(), data.T)
+    z = from_numpy(data.astype("float64"), "cpu0")
+    assert z.dtype == np.float32
+
+    s = from_numpy(np.array(1, dtype="int32"), "cpu0")
+    assert s.shape == ()
+
+
+def test_as_numpy():
+    x = tensor(np.arange(6, dtype="float32").reshape(2, 3), device="cpu0")
+    y = F.exp(x)
+    arr = as_numpy(y)
+    np.testing.assert_allclose(arr, np.exp(np.arange(6).reshape(2, 3)), rtol=1e-6)
+    assert not arr.flags.writeable
+    with pytest.raises(ValueError):
+        arr[0, 0] = 1
@@ -10,7 +10,9 @@
  */
 
 #include "./blob_manager_impl.h"
+#include <limits>
 #include <set>
+#include "../../../src/core/impl/graph/var_node_mem_mgr/static_mem_alloc.h"
 #include "megbrain/utils/arith_helper.h"
 
 namespace mgb {
@@ -28,6 +30,209 @@ BlobManagerImpl::BlobData::BlobData(Blob* in_blob) {
     h_storage.copy_from(const_cast<DeviceTensorStorage&>(d_storage), blob->m_size);
 }
 
+/* ======================= StepArena ======================= */
+
+/*!
+ * \brief records the blob allocation sequence of each step on a comp node and
+ *      serves steps matching the recorded sequence from a static layout
+ *
+ * Time is measured in alloc/free events within a step. Every storage handed
+ * out is wrapped so that its release is recorded; storages freed within the
+ * step they were allocated in are placed into the arena by StaticMemAlloc.
+ */
+class BlobManagerImpl::StepArena final
+        : public std::enable_shared_from_this<StepArena> {
+    using RawStorage = Blob::RawStorage;
+    static constexpr size_t NOT_FREED = std::numeric_limits<size_t>::max();
+
+    struct Interval {
+        size_t size, begin, end;
+
+        bool operator==(const Interval& rhs) const {
+            return size == rhs.size && begin == rhs.begin && end == rhs.end;
+        }
+    };
+
+    struct Slot {
+        bool in_arena = false;
+        size_t offset = 0;
+        //! earlier slots overlapping in address which must have been freed
+        std::vector<size_t> conflicts;
+    };
+
+    const CompNode m_cn;
+    const size_t m_warmup_steps;
+    std::mutex m_mtx;
+
+    size_t m_step = 0, m_time = 0, m_nr_same_steps = 0;
+    std::vector<Interval> m_cur, m_ref;
+
+    //! static layout of m_ref; empty if not planned
+    std::vector<Slot> m_plan;
+    size_t m_arena_size = 0;
+    RawStorage m_arena;
+    std::vector<bool> m_slot_live;
+    bool m_diverged = false;
+
+    void on_free(size_t step, size_t idx) {
+        MGB_LOCK_GUARD(m_mtx);
+        if (step != m_step) {
+            // freed in a later step; it has been recorded as NOT_FREED
+            return;
+        }
+        m_cur[idx].end = m_time++;
+        if (idx < m_slot_live.size()) {
+            m_slot_live[idx] = false;
+        }
+    }
+
+    //! try to serve allocation \p idx from the arena; m_mtx must be held
+    RawStorage alloc_from_arena(size_t idx, size_t size) {
+        if (m_plan.empty() || m_diverged) {
+            return {};
+        }
+        if (idx >= m_plan.size() || m_ref[idx].size != size) {
+            m_diverged = true;
+            return {};
+        }
+        auto&& slot = m_plan[idx];
+        if (!slot.in_arena) {
+            return {};
+        }
+        for (auto i : slot.conflicts) {
+            if (m_slot_live[i]) {
+                m_diverged = true;
+                return {};
+            }
+        }
+        m_slot_live[idx] = true;
+        return {m_arena, m_arena.get() + slot.offset};
+    }
+
+    void plan() {
+        auto allocator = cg::StaticMemAlloc::make(
+                cg::StaticMemAlloc::AllocatorAlgo::PUSHDOWN);
+        allocator->alignment(m_cn.get_mem_addr_alignment());
+        std::vector<Slot> plan(m_ref.size());
+        std::vector<size_t> arena_slots;
+        for (size_t i = 0; i < m_ref.size(); ++i) {
+            auto&& itv = m_ref[i];
+            if (itv.end != NOT_FREED && itv.size) {
+                plan[i].in_arena = true;
+                allocator->add(itv.begin, itv.end, itv.size, &plan[i]);
+                arena_slots.push_back(i);
+            }
+        }
+        if (arena_slots.empty()) {
+            return;
+        }
+        allocator->solve();
+        for (auto i : arena_slots) {
+            plan[i].offset = allocator->get_start_addr(&plan[i]);
+        }
+        // slots are indexed by allocation order, so only earlier slots could
+        // still be alive when a slot is allocated
+        for (size_t j = 0; j < arena_slots.size(); ++j) {
+            auto&& sj = plan[arena_slots[j]];
+            size_t bj = sj.offset, ej = bj + m_ref[arena_slots[j]].size;
+            for (size_t i = 0; i < j; ++i) {
+                auto&& si = plan[arena_slots[i]];
+                size_t bi = si.offset, ei = bi + m_ref[arena_slots[i]].size;
+                if (bi < ej && bj < ei) {
+                    sj.conflicts.push_back(arena_slots[i]);
+                }
+            }
+        }
+        m_plan = std::move(plan);
+        m_arena_size = allocator->tot_alloc();
+        mgb_log_debug(
+                "blob arena on %s planned: %zu/%zu allocations, %zu bytes "
+                "(lower bound %zu)",
+                m_cn.to_string().c_str(), arena_slots.size(), m_ref.size(),
+                m_arena_size, allocator->tot_alloc_lower_bound());
+    }
+
+    void drop_plan() {
+        m_plan.clear();
+        m_arena.reset();
+        m_slot_live.clear();
+    }
+
+public:
+    StepArena(CompNode cn, size_t warmup_steps)
+            : m_cn{cn}, m_warmup_steps{warmup_steps} {}
+
+    RawStorage alloc(size_t size) {
+        size_t step, idx;
+        RawStorage raw;
+        {
+            MGB_LOCK_GUARD(m_mtx);
+            step = m_step;
+            idx = m_cur.size();
+            m_cur.push_back({size, m_time++, NOT_FREED});
+            raw = alloc_from_arena(idx, size);
+        }
+        if (!raw) {
+            DeviceTensorStorage storage(m_cn);
+            storage.ensure_size(size);
+            raw = storage.raw_storage();
+        }
+        auto self = shared_from_this();
+        auto ptr = raw.get();
+        return RawStorage{ptr, [self, step, idx, raw](dt_byte*) mutable {
+                              raw.reset();
+                              self->on_free(step, idx);
+                          }};
+    }
+
+    void mark_step() {
+        MGB_LOCK_GUARD(m_mtx);
+        bool same = !m_cur.empty() && m_cur == m_ref;
+        if (!m_plan.empty() && (m_diverged || !same)) {
+            mgb_log_debug(
+                    "blob arena on %s: allocation sequence changed, restart "
+                    "warmup",
+                    m_cn.to_string().c_str());
+            drop_plan();
+        }
+        if (same) {
+            ++m_nr_same_steps;
+        } else {
+            m_ref = std::move(m_cur);
+            m_nr_same_steps = 1;
+        }
+        m_cur.clear();
+        m_time = 0;
+        ++m_step;
+        m_diverged = false;
+
+        if (m_plan.empty() && m_nr_same_steps >= m_warmup_steps) {
+            plan();
+        }
+        if (m_plan.empty()) {
+            return;
+        }
+        // blobs of previous steps may still reference the arena; fully free
+        // arena is required since the plan only covers the current step
+        if (!m_arena || m_arena.use_count() > 1) {
+            m_arena.reset();
+            MGB_TRY {
+                DeviceTensorStorage storage(m_cn);
+                storage.ensure_size(m_arena_size);
+                m_arena = storage.raw_storage();
+            }
+            MGB_CATCH(MemAllocError&, {
+                mgb_log_warn(
+                        "failed to allocate %zu bytes for blob arena on %s",
+                        m_arena_size, m_cn.to_string().c_str());
+                drop_plan();
+                return;
+            });
+        }
+        m_slot_live.assign(m_plan.size(), false);
+    }
+};
+
 void BlobManagerImpl::register_blob(Blob* blob) {
     // add blob into the comp2blobs map
     MGB_LOCK_GUARD(m_mtx);
@@ -60,8 +265,20 @@ void BlobManagerImpl::alloc_with_defrag(Blob* blob, size_t size) {
 }
 
 void BlobManagerImpl::alloc_direct(Blob* blob, size_t size) {
-    DeviceTensorStorage storage(blob->m_comp_node);
     mgb_assert(blob->m_comp_node.valid());
+    std::shared_ptr<StepArena> arena;
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        auto iter = m_comp2arena.find(blob->m_comp_node);
+        if (iter != m_comp2arena.end()) {
+            arena = iter->second;
+        }
+    }
+    if (arena) {
+        blob->m_storage = arena->alloc(size);
+        return;
+    }
+    DeviceTensorStorage storage(blob->m_comp_node);
     storage.ensure_size(size);
     blob->m_storage = storage.raw_storage();
 }
@@ -158,6 +375,29 @@ void BlobManagerImpl::set_enable(bool flag) {
     m_enable = flag;
 }
 
+void BlobManagerImpl::set_arena(CompNode cn, size_t warmup_steps) {
+    mgb_assert(cn.valid());
+    MGB_LOCK_GUARD(m_mtx);
+    if (!warmup_steps) {
+        m_comp2arena.erase(cn);
+    } else {
+        m_comp2arena[cn] = std::make_shared<StepArena>(cn, warmup_steps);
+    }
+}
+
+void BlobManagerImpl::mark_step() {
+    SmallVector<std::shared_ptr<StepArena>> arenas;
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        for (auto&& i : m_comp2arena) {
+            arenas.push_back(i.second);
+        }
+    }
+    for (auto&& i : arenas) {
+        i->mark_step();
+    }
+}
+
 struct BlobManagerStub : BlobManager {
     void alloc_direct(Blob* blob, size_t size) {
         mgb_assert(0, "prohibited after global variable destruction");
@@ -178,6 +418,10 @@ struct BlobManagerStub : BlobManager {
     void defrag(const CompNode& cn) {
         mgb_assert(0, "prohibited after global variable destruction");
     };
+    void set_arena(CompNode cn, size_t warmup_steps) {
+        mgb_assert(0, "prohibited after global variable destruction");
+    };
+    void mark_step(){};
 };
 
 BlobManager* BlobManager::inst() {
@@ -36,8 +36,11 @@ class BlobManagerImpl final : public BlobManager {
         BlobData(Blob* in_blob);
     };
 
+    class StepArena;
+
     std::mutex m_mtx;
     CompNode::UnorderedMap<BlobSetWithMux> m_comp2blobs_map;
+    CompNode::UnorderedMap<std::shared_ptr<StepArena>> m_comp2arena;
     bool m_enable;
 
     void defrag(const CompNode& cn) override;
@@ -59,6 +62,10 @@ public:
     void unregister_blob(Blob* blob) override;
 
     void set_enable(bool flag) override;
+
+    void set_arena(CompNode cn, size_t warmup_steps) override;
+
+    void mark_step() override;
 };
 
 }  // namespace imperative
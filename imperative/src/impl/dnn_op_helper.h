@@ -18,6 +18,90 @@ using namespace megdnn;
 namespace mgb {
 namespace imperative {
 
+/*!
+ * \brief megdnn oprs and workspaces free to be reused on the current thread,
+ *      so that they are not created on every call of an op
+ *
+ * The oprs on CPU comp nodes except the default one are never reused, since
+ * their kernels are run later by the dispatcher and may read the params of
+ * the oprs then. A workspace is reused by the calls on the same comp node,
+ * whose kernels are executed in order.
+ */
+class DnnOprPool final : public CompNodeDepedentObject {
+    using OprPtr = std::unique_ptr<megdnn::OperatorBase>;
+    struct CompNodeState {
+        std::unordered_map<const void*, std::vector<OprPtr>> free_oprs;
+        DeviceTensorND workspace;
+    };
+    CompNode::UnorderedMap<CompNodeState> m_cn2state;
+
+    std::shared_ptr<void> on_comp_node_finalize() override {
+        m_cn2state.clear();
+        return {};
+    }
+
+public:
+    static DnnOprPool& inst() {
+        thread_local DnnOprPool pool;
+        return pool;
+    }
+
+    static bool reusable(CompNode cn) {
+        return cn.device_type() != CompNode::DeviceType::CPU ||
+               cn == CompNode::default_cpu();
+    }
+
+    template <typename Opr>
+    std::unique_ptr<Opr> alloc(CompNode cn) {
+        if (!is_finalized() && reusable(cn)) {
+            auto&& oprs = m_cn2state[cn].free_oprs[type_key<Opr>()];
+            if (!oprs.empty()) {
+                std::unique_ptr<Opr> opr{static_cast<Opr*>(oprs.back().release())};
+                oprs.pop_back();
+                // the params are left by the last caller
+                if constexpr (has_param<Opr>::value) {
+                    opr->param() = {};
+                }
+                return opr;
+            }
+        }
+        auto&& handle = MegDNNHandle::get(CompNodeEnv::from_comp_node(cn)).handle();
+        return handle->create_operator<Opr>();
+    }
+
+    template <typename Opr>
+    void free(CompNode cn, std::unique_ptr<Opr> opr) {
+        mgb_assert(reusable(cn));
+        if (!is_finalized()) {
+            m_cn2state[cn].free_oprs[type_key<Opr>()].emplace_back(std::move(opr));
+        }
+    }
+
+    //! a workspace of at least \p size bytes, which only grows
+    DeviceTensorND workspace(CompNode cn, size_t size) {
+        mgb_assert(!is_finalized());
+        auto&& ws = m_cn2state[cn].workspace;
+        if (ws.empty() || ws.shape(0) < size) {
+            ws = Tensor::make(TensorLayout{{size}, dtype::Byte()}, cn)->dev_tensor();
+        }
+        return ws;
+    }
+
+private:
+    //! an address distinct for each type of oprs
+    template <typename Opr>
+    static const void* type_key() {
+        static const char key = 0;
+        return &key;
+    }
+
+    template <typename Opr, typename = void>
+    struct has_param : std::false_type {};
+    template <typename Opr>
+    struct has_param<Opr, std::void_t<decltype(std::declval<Opr&>().param())>>
+            : std::true_type {};
+};
+
 /*!
  * \brief A struct for safely calling DNN oprs
  * In some cases, op may be released before the complete of the execution
@@ -30,7 +114,7 @@ struct DnnOprCaller {
     Workspace workspace;
     std::unique_ptr<Opr> op;
 
-    DnnOprCaller(CompNode cn) : cn(cn), op(create_operator(cn)) {}
+    DnnOprCaller(CompNode cn) : cn(cn), op(DnnOprPool::inst().alloc<Opr>(cn)) {}
 
     static std::unique_ptr<Opr> create_operator(CompNode cn) {
         auto&& handle = MegDNNHandle::get(CompNodeEnv::from_comp_node(cn)).handle();
@@ -38,17 +122,21 @@ struct DnnOprCaller {
     }
 
     megdnn::Workspace create_workspace(TensorLayout layout) {
-        dev_tensor = Tensor::make(layout, cn)->dev_tensor();
+        dev_tensor = DnnOprPool::inst().workspace(cn, layout.span().dist_byte());
         workspace =
                 megdnn::Workspace(dev_tensor.raw_ptr(), dev_tensor.storage().size());
         return workspace;
     }
 
     ~DnnOprCaller() {
-        using DT = CompNode::DeviceType;
-        if (cn.device_type() == DT::CPU && cn != CompNode::default_cpu()) {
+        if (!op) {
+            return;
+        }
+        if (!DnnOprPool::reusable(cn)) {
             CompNodeEnv::from_comp_node(cn).cpu_env().dispatch(
                     [p = op.release()] { delete p; });
+        } else {
+            DnnOprPool::inst().free(cn, std::move(op));
         }
     }
 };
@@ -14,6 +14,7 @@
 #include <string>
 #include <unordered_set>
 #include <variant>
+#include <vector>
 
 #include "megbrain/imperative/op_def.h"
 #include "megbrain/imperative/utils/to_string.h"
@@ -170,9 +171,23 @@ struct PopScope {
     const char* get_name() const { return "PopScope"; }
 };
 
+struct Command;
+
+//! commands issued to the worker as one task, see ChannelImpl::start_batch
+struct CommandBatch {
+    std::vector<Command> commands;
+
+    template <typename TFunctor>
+    void get_props(TFunctor&& functor) const {
+        functor("size", commands.size());
+    }
+
+    const char* get_name() const { return "CommandBatch"; }
+};
+
 using CommandData = std::variant<
         Put, ApplyOp, Del, GetValue, SwapIn, SwapOut, Drop, SetOption, StartProfile,
-        StopProfile, PushScope, PopScope>;
+        StopProfile, PushScope, PopScope, CommandBatch>;
 
 struct Command {
     uint64_t id;
@@ -474,7 +474,9 @@ DeviceTensorND ChannelImpl::get_dev_tensor(Handle handle) {
             m_valid_handle.find(handle) != m_valid_handle.end(), "invalid handle: %p",
             handle);
     auto info = reinterpret_cast<TensorInfo*>(handle);
-    return wait_tensor(info, TensorProp::DevValue)->dev_tensor();
+    auto tensor = wait_tensor(info, TensorProp::DevValue);
+    // hand out the tensors produced on side streams on their logical comp node
+    return switch_stream(tensor, info->desc.comp_node)->dev_tensor();
 }
 
 void ChannelImpl::sync() {
@@ -563,6 +565,15 @@ void ChannelImpl::do_drop(TensorInfo* ptr, bool user = false) {
     release_tensor(ptr);
 }
 
+void ChannelImpl::do_swap_out(TensorInfo* ptr) {
+    ptr->h_value = ptr->ptr->get_value();
+    if (ptr->evict_type == EvictType::NONE) {
+        ptr->evict_type = EvictType::SWAP;
+        ptr->status = TensorInfo::Swapped;
+        release_tensor(ptr);
+    }
+}
+
 void ChannelImpl::free(TensorInfo* ptr) {
     auto& state = get_worker_state();
     if (state.options.enable_dtr_auto_drop) {
@@ -631,7 +642,13 @@ void ChannelImpl::produce_tensor(TensorInfo* dest, TensorPtr ptr) {
             ptr->dev_tensor().raw_ptr());
     // update tensor desc for static infer
     dest->desc.layout = ptr->layout();
-    dest->desc.comp_node = ptr->comp_node();
+    // tensors produced on side streams keep the comp node they are used on
+    auto cn = ptr->comp_node(), logical_cn = dest->desc.comp_node;
+    if (!logical_cn.valid() ||
+        (cn != logical_cn && cn != side_stream(logical_cn, CompNode::Stream::COPY) &&
+         cn != side_stream(logical_cn, CompNode::Stream::REMOTE_SEND))) {
+        dest->desc.comp_node = cn;
+    }
     dest->memory = ptr->blob()->size();
     dest->ptr = std::move(ptr);
     dest->evict_type = EvictType::NONE;
@@ -663,6 +680,41 @@ void ChannelImpl::regenerate(TensorInfo* dest) {
     }
 }
 
+CompNode ChannelImpl::side_stream(CompNode cn, int stream) {
+    auto& state = get_worker_state();
+    if (!state.options.enable_multi_stream ||
+        !cn.contain_flag(CompNode::Flag::HAS_COPY_STREAM)) {
+        return cn;
+    }
+    return cn.change_stream(stream);
+}
+
+TensorPtr ChannelImpl::switch_stream(TensorPtr tensor, CompNode cn) {
+    auto src = tensor->comp_node();
+    if (src == cn) {
+        return tensor;
+    }
+    mgb_assert(src.mem_node() == cn.mem_node());
+    auto event = EventPool::without_timer().alloc_shared(src);
+    event->record();
+    cn.device_wait_event(*event);
+    auto dev_tensor = tensor->dev_tensor();
+    auto storage = dev_tensor.storage();
+    storage.comp_node(cn);
+    dev_tensor.reset(storage, dev_tensor.layout());
+    return Tensor::make(dev_tensor);
+}
+
+void ChannelImpl::make_side_stream_wait(CompNode side, CompNode cn) {
+    // memory freed into the pool of a side stream may be still in use by the
+    // work issued to cn, so side work is ordered after all of it
+    if (side != cn) {
+        auto event = EventPool::without_timer().alloc_shared(cn);
+        event->record();
+        side.device_wait_event(*event);
+    }
+}
+
 void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
     using namespace ranges;
     using namespace ranges::views;
@@ -674,11 +726,48 @@ void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
         TensorPtr tensor;
         MemoryDesc desc;
     };
+    // collective communication on the comp node of its input is issued to the
+    // communication stream if multi-stream execution is enabled
+    auto op = cmd.op;
+    CompNode comm_cn;
+    if (auto comm = op->try_cast_final<CollectiveComm>()) {
+        mgb_assert(cmd.inputs.size() == 1);
+        auto cn = cmd.inputs[0]->desc.comp_node;
+        if (comm->comp_node.empty() || CompNode::load(comm->comp_node) == cn) {
+            comm_cn = side_stream(cn, CompNode::Stream::REMOTE_SEND);
+            if (comm_cn != cn) {
+                op = std::make_shared<CollectiveComm>(
+                        comm->mode, comm->key, comm->nr_devices, comm->rank,
+                        comm->is_root, comm->local_grad, comm->addr, comm->port,
+                        comm->dtype, comm->backend, "");
+                make_side_stream_wait(comm_cn, cn);
+            } else {
+                comm_cn = {};
+            }
+        }
+    }
     SmallVector<TensorWithDesc> inputs;
     inputs.reserve(cmd.inputs.size());
+    // inputs whose memory is read on comm_cn, to be held until it finishes
+    SmallVector<TensorPtr> side_inputs;
     // refcnt == 1, owners: [TensorInfo::ptr]
     for (auto i : cmd.inputs) {
         mgb_assert(i->ptr, "Invalid input tensor ptr!");
+        auto cn = comm_cn.valid() ? comm_cn : i->desc.comp_node;
+        if (i->ptr->comp_node() != cn &&
+            i->ptr->comp_node().mem_node() == cn.mem_node()) {
+            // produced on another stream of the device
+            auto tensor = switch_stream(i->ptr, cn);
+            if (comm_cn.valid()) {
+                side_inputs.push_back(i->ptr);
+            } else {
+                // later users on the same comp node need not wait again
+                MGB_LOCK_GUARD(m_mutex);
+                i->ptr = tensor;
+            }
+            inputs.push_back({std::move(tensor), i->mem_desc});
+            continue;
+        }
         // refcnt ++, owners: [i->ptr, tensor_inputs]
         // tensor_inputs.push_back(i->ptr);
         inputs.push_back({i->ptr, i->mem_desc});
@@ -781,9 +870,40 @@ void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
                 (Profiler::get_option("profile_device", 0)), RecordDeviceEvent,
                 Timer::record_device(device));
     }
+    // Measure ops not seen before, so that DTR could estimate recompute cost
+    // by real compute time
+    bool dtr_profile = state.options.enable_dtr_auto_drop &&
+                       state.options.enable_dtr_profile_compute_time;
+    size_t dtr_op_sig = 0;
+    std::unique_ptr<CompNode::Event> dtr_start, dtr_end;
+    if (dtr_profile) {
+        dtr_op_sig = m_dtr.op_signature(*cmd.op, cmd.inputs);
+        if (!m_dtr.op_compute_time.count(dtr_op_sig)) {
+            CompNode cn;
+            for (auto i : cmd.outputs) {
+                if (i && i->desc.comp_node.valid()) {
+                    cn = i->desc.comp_node;
+                    break;
+                }
+            }
+            if (cn.valid()) {
+                dtr_start = cn.create_event(CompNode::Event::NEED_TIMER);
+                dtr_end = cn.create_event(CompNode::Event::NEED_TIMER);
+                dtr_start->record();
+            }
+        }
+    }
     // Apply op
     // Here std::move is REQUIRED for removing duplicated references.
-    auto outputs = apply_on_physical_tensor(apply_on_physical_tensor, *cmd.op, inputs);
+    auto outputs = apply_on_physical_tensor(apply_on_physical_tensor, *op, inputs);
+    for (auto&& i : side_inputs) {
+        i->add_release_callback(comm_cn);
+    }
+    if (dtr_end) {
+        dtr_end->record();
+        dtr_end->host_wait();
+        m_dtr.op_compute_time[dtr_op_sig] = dtr_start->elapsed_time_until(*dtr_end);
+    }
     // After execute
     for (auto&& [device, kernel_id] : kernels) {
         MGB_RECORD_EVENT_IF(
@@ -812,11 +932,21 @@ void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
 
     if (state.options.enable_dtr_auto_drop) {
         double estimate_compute_time = 0;
-        for (auto i : cmd.inputs) {
-            estimate_compute_time += i->memory;
+        auto measured = m_dtr.op_compute_time.end();
+        if (dtr_profile) {
+            measured = m_dtr.op_compute_time.find(dtr_op_sig);
         }
-        for (auto i : outputs) {
-            estimate_compute_time += i.tensor->blob()->size();
+        if (measured != m_dtr.op_compute_time.end()) {
+            // keep the unit of compute_time (bytes of memory traffic) by
+            // assuming a device bandwidth of 100GB/s
+            estimate_compute_time = measured->second * 1e11;
+        } else {
+            for (auto i : cmd.inputs) {
+                estimate_compute_time += i->memory;
+            }
+            for (auto i : outputs) {
+                estimate_compute_time += i.tensor->blob()->size();
+            }
         }
         m_dtr.estimate_timestamp += estimate_compute_time / 1e8;
         for (auto i : cmd.outputs) {
@@ -885,18 +1015,43 @@ bool ChannelImpl::auto_evict(size_t force_num) {
         return false;
     }
     size_t current_memory = m_dtr.comp_node.get_used_memory();
+    size_t threshold = state.options.dtr_eviction_threshold;
+    // once the threshold is exceeded, evict down to the low watermark at a
+    // time, so that the following ops are not interrupted by eviction again
+    size_t target = threshold;
+    size_t low_watermark = state.options.dtr_eviction_low_watermark;
+    if (low_watermark > 0 && low_watermark < threshold) {
+        target = low_watermark;
+    }
+    bool exceeded = threshold > 0 && current_memory > threshold;
     size_t flag = false;
-    while ((state.options.dtr_eviction_threshold > 0 &&
-            current_memory > state.options.dtr_eviction_threshold) ||
-           force_num > 0) {
+    SmallVector<std::pair<TensorInfo*, EvictType>> victims;
+    size_t next = 0;
+    while ((exceeded && current_memory > target) || force_num > 0) {
+        if (next == victims.size()) {
+            victims = m_dtr.find_best_tensors(
+                    state.options.enable_dtr_sqrt_sampling && !force_num,
+                    state.options.dtr_candidate_scan_depth,
+                    force_num ? 0 : current_memory - target,
+                    state.options.dtr_swap_bandwidth);
+            next = 0;
+            if (victims.empty()) {
+                break;
+            }
+            // issue the copies of all the tensors to swap before waiting for
+            // any of them
+            for (auto&& [victim, type] : victims) {
+                if (type == EvictType::SWAP) {
+                    victim->ptr->fetch_value();
+                }
+            }
+        }
+        auto [best, type] = victims[next++];
+        if (!best->ptr || best->evict_type != EvictType::NONE || best->pinned) {
+            continue;
+        }
         MGB_RECORD_EVENT(AutoEvictEvent);
         sample_on_device(m_dtr.comp_node, false);
-        auto best = m_dtr.find_best_tensor(
-                state.options.enable_dtr_sqrt_sampling && !force_num);
-        if (!best) {
-            MGB_RECORD_EVENT(AutoEvictFinishEvent);
-            break;
-        }
         if (best->ptr.unique() && best->ptr->blob().unique()) {
             current_memory -= best->memory;
             if (force_num > 0) {
@@ -904,7 +1059,11 @@ bool ChannelImpl::auto_evict(size_t force_num) {
             }
             flag = true;
         }
-        do_drop(best);
+        if (type == EvictType::SWAP) {
+            do_swap_out(best);
+        } else {
+            do_drop(best);
+        }
         if (best->evict_type == EvictType::DROP) {
             m_dtr.update_dsu_after_evict(best);
         }
@@ -1072,6 +1231,12 @@ ChannelImpl::init_output_and_workspace(
 void ChannelImpl::process_one_task(Command& icmd) {
     using namespace ranges;
     using namespace ranges::views;
+    if (auto* batch = std::get_if<CommandBatch>(&icmd.data)) {
+        for (auto&& cmd : batch->commands) {
+            process_one_task(cmd);
+        }
+        return;
+    }
     auto& state = get_worker_state();
     auto& options = state.options;
     // TODO: remove std::visit for support osx 10.12
@@ -1082,12 +1247,18 @@ void ChannelImpl::process_one_task(Command& icmd) {
             MGB_RECORD_EVENT_IF(
                     (Profiler::get_option("profile_device", 0)), RecordDeviceEvent,
                     Timer::record_device(cmd.value.comp_node()));
-            auto value = cmd.no_cache ? std::make_shared<Tensor>(cmd.value)
-                                      : Tensor::make(cmd.value);
+            auto value = cmd.value;
+            auto copy_cn = side_stream(value.comp_node(), CompNode::Stream::COPY);
+            if (copy_cn != value.comp_node()) {
+                make_side_stream_wait(copy_cn, value.comp_node());
+                value.comp_node(copy_cn);
+            }
+            auto tensor = cmd.no_cache ? std::make_shared<Tensor>(value)
+                                       : Tensor::make(value);
             MGB_RECORD_EVENT_IF(
                     (Profiler::get_option("profile_device", 0)), RecordDeviceEvent,
                     Timer::record_device(cmd.value.comp_node()));
-            produce_tensor(cmd.dest, std::move(value));
+            produce_tensor(cmd.dest, std::move(tensor));
             MGB_RECORD_EVENT(
                     TensorCommandFinishEvent, cmd.dest->id, TensorCommandKind::Put);
             sample_on_device(cmd.dest->desc.comp_node, false);
@@ -1196,12 +1367,7 @@ void ChannelImpl::process_one_task(Command& icmd) {
                 return;
             MGB_RECORD_EVENT(
                     TensorCommandEvent, cmd.dest->id, TensorCommandKind::SwapOut);
-            cmd.dest->h_value = cmd.dest->ptr->get_value();
-            if (cmd.dest->evict_type == EvictType::NONE) {
-                cmd.dest->evict_type = EvictType::SWAP;
-                cmd.dest->status = TensorInfo::Swapped;
-                release_tensor(cmd.dest);
-            }
+            do_swap_out(cmd.dest);
             MGB_RECORD_EVENT(
                     TensorCommandFinishEvent, cmd.dest->id, TensorCommandKind::SwapOut);
             sample_on_device(cmd.dest->desc.comp_node, false);
@@ -1249,6 +1415,8 @@ void ChannelImpl::process_one_task(Command& icmd) {
             MGB_RECORD_EVENT(ScopeEvent, cmd.scope_name);
         } else if constexpr (std::is_same_v<T, PopScope>) {
             MGB_RECORD_EVENT(ScopeFinishEvent, cmd.scope_name);
+        } else if constexpr (std::is_same_v<T, CommandBatch>) {
+            mgb_throw(InternalError, "nested command batch");
         } else {
             static_assert(!std::is_same_v<T, T>);
         }
@@ -1312,13 +1480,54 @@ void ChannelImpl::CommandBuffer::flush() {
 }
 
 void ChannelImpl::CommandBuffer::flush(Handle pos) {
-    for (auto iter = m_commands.begin(); iter != pos; ++iter) {
+    auto& state = m_owner->get_channel_state();
+    auto& options = state.options;
+    // commands are issued as one task in batch mode
+    std::vector<Command> batch;
+    auto issue = [&](Command&& cmd) {
+        if (state.batch_depth) {
+            batch.push_back(std::move(cmd));
+        } else {
+            m_owner->m_worker.add_task(std::move(cmd));
+        }
+    };
+    // fused ops are not recorded by profiler and dtr
+    bool fuse_elemwise_enabled = options.enable_elemwise_fusion &&
+                                 !Profiler::is_profiling() && !options.enable_drop &&
+                                 !options.enable_dtr_auto_drop;
+    for (auto iter = m_commands.begin(); iter != pos;) {
+        if (fuse_elemwise_enabled) {
+            auto chain_end = find_elemwise_chain({iter, pos});
+            auto nr_apply = std::count_if(iter, chain_end, [](const Command& cmd) {
+                return std::holds_alternative<ApplyOp>(cmd.data);
+            });
+            if (nr_apply > 1) {
+                Command fused{
+                        Profiler::next_id(), fuse_elemwise({iter, chain_end}),
+                        iter->trace};
+                // puts have no input, so they can be moved before the chain
+                for (; iter != chain_end; ++iter) {
+                    if (std::holds_alternative<Put>(iter->data)) {
+                        issue(std::move(*iter));
+                    }
+                }
+                issue(std::move(fused));
+                continue;
+            }
+        }
         if (Profiler::is_profiling()) {
             mgb_log_debug("%s Flushed", to_string(*iter).c_str());
         }
-        m_owner->m_worker.add_task(std::move(*iter));
+        issue(std::move(*iter));
+        ++iter;
     }
     m_commands.erase(m_commands.begin(), pos);
+    if (batch.size() == 1) {
+        m_owner->m_worker.add_task(std::move(batch[0]));
+    } else if (!batch.empty()) {
+        m_owner->m_worker.add_task(
+                Command{Profiler::next_id(), CommandBatch{std::move(batch)}, {}});
+    }
 }
 
 auto ChannelImpl::CommandBuffer::flush_pos_for(const Command& cmd) -> Handle {
@@ -1339,6 +1548,12 @@ auto ChannelImpl::CommandBuffer::flush_pos_for(const Command& cmd) -> Handle {
                     return m_commands.end();
                 }
                 size_t buffer_length = state.options.buffer_length;
+                // hold commands until there are enough for a batch
+                if (state.batch_depth &&
+                    m_commands.size() <=
+                            std::max(buffer_length, state.options.batch_length)) {
+                    return m_commands.begin();
+                }
                 if (m_commands.size() > buffer_length) {
                     return m_commands.begin() + (m_commands.size() - buffer_length);
                 }
@@ -1418,6 +1633,132 @@ auto ChannelImpl::CommandBuffer::find_produce(TensorInfo* dest, Range range) ->
     });
 }
 
+auto ChannelImpl::CommandBuffer::find_elemwise_chain(Range range) -> Handle {
+    using namespace ranges::views;
+    CompNode comp_node;
+    auto is_fusible = [&](const Command& cmd) {
+        if (std::holds_alternative<Put>(cmd.data)) {
+            return true;
+        }
+        auto* apply = std::get_if<ApplyOp>(&cmd.data);
+        if (!apply || !apply->op->same_type<Elemwise>()) {
+            return false;
+        }
+        for (auto* info : concat(apply->inputs, apply->outputs)) {
+            if (!comp_node.valid()) {
+                comp_node = info->desc.comp_node;
+            }
+            if (info->desc.comp_node != comp_node) {
+                return false;
+            }
+        }
+        return true;
+    };
+    return std::find_if_not(range[0], range[1], is_fusible);
+}
+
+namespace {
+
+size_t hash_elemwise_chain(const Subgraph& graph) {
+    using namespace ranges::views;
+    size_t ret = mgb::hash(graph.inputs.size());
+    for (auto&& expr : graph.exprs) {
+        ret = mgb::hash_pair_combine(ret, expr.op->hash());
+        for (auto i : concat(expr.inputs, expr.outputs)) {
+            ret = mgb::hash_pair_combine(ret, i);
+        }
+    }
+    for (auto i : graph.outputs) {
+        ret = mgb::hash_pair_combine(ret, i);
+    }
+    return ret;
+}
+
+bool same_elemwise_chain(const Subgraph& lhs, const Subgraph& rhs) {
+    auto same_vars = [](const Subgraph::vars_t& l, const Subgraph::vars_t& r) {
+        return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin());
+    };
+    if (!same_vars(lhs.inputs, rhs.inputs) || !same_vars(lhs.outputs, rhs.outputs) ||
+        lhs.exprs.size() != rhs.exprs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.exprs.size(); ++i) {
+        auto &&l = lhs.exprs[i], &&r = rhs.exprs[i];
+        if (!same_vars(l.inputs, r.inputs) || !same_vars(l.outputs, r.outputs) ||
+            !l.op->is_same(*r.op)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+/**
+ * 1. Map the tensors in range to vars of a subgraph, with the tensors that are
+ *    not produced in range as its inputs
+ * 2. Take the outputs that are not deleted in range as its outputs; the deleted
+ *    ones are only used inside the chain since Del is fused into the only user
+ * 3. Find the CompiledOp of the same subgraph, which caches its compiled graph
+ *    for each input layout, or create one
+ */
+auto ChannelImpl::CommandBuffer::fuse_elemwise(Range range) -> ApplyOp {
+    ApplyOp fused{Profiler::next_id()};
+    auto graph = std::make_shared<Subgraph>();
+    std::unordered_map<TensorInfo*, size_t> tensor2var;
+    std::unordered_set<TensorInfo*> deleted;
+    for (auto iter = range[0]; iter != range[1]; ++iter) {
+        auto* apply_ptr = std::get_if<ApplyOp>(&iter->data);
+        if (!apply_ptr) {
+            continue;
+        }
+        auto& apply = *apply_ptr;
+        Subgraph::expr_t expr{apply.op};
+        for (auto* input : apply.inputs) {
+            auto [var, inserted] = tensor2var.insert({input, tensor2var.size()});
+            if (inserted) {
+                graph->inputs.push_back(var->second);
+                fused.inputs.push_back(input);
+            }
+            expr.inputs.push_back(var->second);
+        }
+        for (auto* output : apply.outputs) {
+            auto var = tensor2var.size();
+            tensor2var[output] = var;
+            expr.outputs.push_back(var);
+        }
+        graph->exprs.push_back(std::move(expr));
+        for (auto* del : apply.dels) {
+            deleted.insert(del);
+            fused.dels.push_back(del);
+        }
+    }
+    for (auto iter = range[0]; iter != range[1]; ++iter) {
+        auto* apply = std::get_if<ApplyOp>(&iter->data);
+        if (!apply) {
+            continue;
+        }
+        for (auto* output : apply->outputs) {
+            if (!deleted.count(output)) {
+                graph->outputs.push_back(tensor2var.at(output));
+                fused.outputs.push_back(output);
+            }
+        }
+    }
+
+    auto& bucket = m_fused_elemwise[hash_elemwise_chain(*graph)];
+    for (auto&& [cached_graph, op] : bucket) {
+        if (same_elemwise_chain(*cached_graph, *graph)) {
+            fused.op = op;
+            return fused;
+        }
+    }
+    // jit fusion is enabled at gopt level 3
+    fused.op = CompiledOp::make(SubgraphOp::make("FusedElemwise", graph), 3);
+    bucket.emplace_back(graph, fused.op);
+    return fused;
+}
+
 void ChannelImpl::start_profile() {
     MGB_LOCK_GUARD(m_spin);
     mgb_assert(check_available(), "Channel already closed");
@@ -1446,6 +1787,24 @@ void ChannelImpl::push_scope(std::string name) {
     m_buffer.enqueue(PushScope{name});
 }
 
+void ChannelImpl::start_batch() {
+    MGB_LOCK_GUARD(m_spin);
+    mgb_assert(check_available(), "Channel already closed");
+    ++get_channel_state().batch_depth;
+}
+
+void ChannelImpl::stop_batch() {
+    MGB_LOCK_GUARD(m_spin);
+    mgb_assert(check_available(), "Channel already closed");
+    auto& state = get_channel_state();
+    mgb_assert(state.batch_depth, "stop_batch() without start_batch()");
+    if (state.batch_depth == 1) {
+        // issue the commands of the outermost batch before leaving batch mode
+        m_buffer.flush();
+    }
+    --state.batch_depth;
+}
+
 void ChannelImpl::pop_scope(std::string name) {
     MGB_LOCK_GUARD(m_spin);
     mgb_assert(check_available(), "Channel already closed");
@@ -1536,36 +1895,79 @@ double ChannelImpl::DynamicSublinear::estimate_neighbor_cost(TensorInfo* ptr) {
     return cost;
 }
 
-TensorInfo* ChannelImpl::DynamicSublinear::find_best_tensor(
-        bool enable_dtr_sqrt_sampling = false) {
-    double min_msps = -1;
-    TensorInfo* best = nullptr;
-    size_t sz = 1;
-    if (enable_dtr_sqrt_sampling) {
-        while (sz * sz <= candidates.size())
-            sz++;
-    } else {
-        sz = candidates.size();
-    }
-    for (auto i : candidates) {
-        if (i->producer && i->ptr && !i->pinned && i->evict_type == EvictType::NONE) {
-            double neighbor_cost = estimate_neighbor_cost(i);
+double ChannelImpl::DynamicSublinear::estimate_swap_cost(
+        TensorInfo* ptr, size_t bandwidth) {
+    // compute_time is measured in bytes of memory traffic, and a measured
+    // second is taken as 1e11 of them
+    double seconds = 2.0 * ptr->memory / (bandwidth * 1024.0 * 1024.0);
+    return seconds * 1e11;
+}
+
+SmallVector<std::pair<TensorInfo*, EvictType>> ChannelImpl::DynamicSublinear::
+        find_best_tensors(
+                bool enable_dtr_sqrt_sampling = false, size_t scan_depth = 0,
+                size_t need_memory = 0, size_t swap_bandwidth = 0) {
+    struct Evaluated {
+        double msps;
+        TensorInfo* tensor;
+        EvictType type;
+    };
+    SmallVector<Evaluated> evaluated;
+    for (auto&& bucket : candidate_buckets) {
+        size_t sz = bucket.size();
+        if (enable_dtr_sqrt_sampling) {
+            sz = 1;
+            while (sz * sz <= bucket.size())
+                sz++;
+        }
+        if (scan_depth) {
+            sz = std::min(sz, scan_depth);
+        }
+        for (auto iter = bucket.begin(); iter != bucket.end() && sz;) {
+            auto i = *(iter++);
+            if (!i->ptr || i->evict_type != EvictType::NONE) {
+                // evicted tensors would be inserted again once produced
+                erase_candidate(i);
+                continue;
+            }
+            if (!i->producer || i->pinned) {
+                continue;
+            }
+            double cost = estimate_neighbor_cost(i);
+            auto type = EvictType::DROP;
+            if (swap_bandwidth) {
+                double swap_cost = estimate_swap_cost(i, swap_bandwidth);
+                if (swap_cost < cost + i->compute_time) {
+                    cost = swap_cost;
+                    type = EvictType::SWAP;
+                }
+            }
             size_t begin_ptr =
                     reinterpret_cast<size_t>(i->ptr->blob()->storage().get());
             auto side_info = i->ptr->comp_node().get_free_left_and_right(
                     begin_ptr, begin_ptr + i->ptr->blob()->size());
             double free_mem = side_info.first + side_info.second;
             double msps = i->eval_func(
-                    neighbor_cost, free_mem, estimate_timestamp, 1.0, 1.0, 1.0, 1.0001);
-            if (min_msps < 0 || msps < min_msps) {
-                min_msps = msps;
-                best = i;
-            }
+                    cost, free_mem, estimate_timestamp, 1.0, 1.0, 1.0, 1.0001);
+            evaluated.push_back({msps, i, type});
+            --sz;
         }
-        if (--sz == 0)
+    }
+    // the scores of the later tensors are not updated with the evictions of
+    // the former ones, which only affect the few neighbors of each evictee
+    std::stable_sort(
+            evaluated.begin(), evaluated.end(),
+            [](auto&& lhs, auto&& rhs) { return lhs.msps < rhs.msps; });
+    SmallVector<std::pair<TensorInfo*, EvictType>> ret;
+    size_t freed = 0;
+    for (auto&& i : evaluated) {
+        ret.emplace_back(i.tensor, i.type);
+        freed += i.tensor->memory;
+        if (freed >= need_memory) {
             break;
+        }
     }
-    return best;
+    return ret;
 }
 
 void ChannelImpl::DynamicSublinear::merge(
@@ -1590,16 +1992,45 @@ std::shared_ptr<DsuNode> ChannelImpl::DynamicSublinear::find_father(
 }
 
 void ChannelImpl::DynamicSublinear::insert_candidate(TensorInfo* ptr) {
-    candidates.insert(ptr);
+    erase_candidate(ptr);
+    int bucket = 0;
+    while ((ptr->memory >> bucket) > 1)
+        ++bucket;
+    auto&& dest = candidate_buckets[bucket];
+    ptr->candidate_bucket = bucket;
+    ptr->candidate_iter = dest.insert(dest.end(), ptr);
     if (!comp_node.valid()) {
         comp_node = ptr->ptr->comp_node();
     }
 }
 
 void ChannelImpl::DynamicSublinear::erase_candidate(TensorInfo* ptr) {
-    candidates.erase(ptr);
+    if (ptr->candidate_bucket < 0) {
+        return;
+    }
+    candidate_buckets[ptr->candidate_bucket].erase(ptr->candidate_iter);
+    ptr->candidate_bucket = -1;
 }
 
 void ChannelImpl::DynamicSublinear::update_used_time(TensorInfo* ptr) {
     ptr->last_used_time = estimate_timestamp;
+    if (ptr->candidate_bucket >= 0) {
+        // keep the bucket ordered by last used time
+        auto&& bucket = candidate_buckets[ptr->candidate_bucket];
+        bucket.splice(bucket.end(), bucket, ptr->candidate_iter);
+    }
+}
+
+size_t ChannelImpl::DynamicSublinear::op_signature(
+        const OpDef& op, const SmallVector<TensorInfo*>& inputs) {
+    size_t ret = op.hash();
+    for (auto i : inputs) {
+        auto&& layout = i->desc.layout;
+        ret = hash_pair_combine(ret, static_cast<size_t>(layout.dtype.enumv()));
+        ret = hash_pair_combine(ret, layout.ndim);
+        for (size_t j = 0; j < layout.ndim; ++j) {
+            ret = hash_pair_combine(ret, layout[j]);
+        }
+    }
+    return ret;
 }
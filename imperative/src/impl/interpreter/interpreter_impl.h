@@ -73,6 +73,9 @@ struct ChannelImpl : Interpreter::Channel {
     void push_scope(std::string) override;
     void pop_scope(std::string) override;
 
+    void start_batch() override;
+    void stop_batch() override;
+
 private:
     struct WorkQueue;
     struct State;
@@ -83,6 +86,7 @@ private:
     void real_free(TensorInfo*);
     void recursive_free(TensorInfo*);
     void do_drop(TensorInfo*, bool);
+    void do_swap_out(TensorInfo*);
     void detach_users(TensorInfo*);
 
     TensorInfo* put_impl(const HostTensorND& value, bool no_cache);
@@ -104,6 +108,13 @@ private:
 
     void regenerate(TensorInfo* dest);
     void flush_apply_stack();
+
+    //! the stream that side work on \p cn is issued to if multi-stream
+    //! execution is enabled, or \p cn itself
+    CompNode side_stream(CompNode cn, int stream);
+    //! make the memory of \p tensor ready and safe to use on \p cn
+    TensorPtr switch_stream(TensorPtr tensor, CompNode cn);
+    void make_side_stream_wait(CompNode side, CompNode cn);
     void do_apply_op(const ApplyOp& cmd, std::string reason);
 
     std::tuple<SmallVector<MemoryDesc>, SmallVector<TensorPtr>, SmallVector<TensorPtr>>
@@ -217,6 +228,18 @@ private:
         Handle find_last_usage(TensorInfo* dest, Range range);
         // Returns the produce position of dest. If not found, returns range[1]
         Handle find_produce(TensorInfo* dest, Range range);
+        // Returns the end of the chain of elemwise ApplyOps on the same comp node
+        // and Puts starting at range[0]
+        Handle find_elemwise_chain(Range range);
+        // Fuse the ApplyOps in range into one CompiledOp. Intermediate tensors,
+        // which are deleted inside the range, are not produced
+        ApplyOp fuse_elemwise(Range range);
+
+        // fused ops of elemwise chains, keyed by the hash of the chain
+        std::unordered_map<
+                size_t, SmallVector<std::pair<
+                                std::shared_ptr<Subgraph>, std::shared_ptr<OpDef>>>>
+                m_fused_elemwise;
     } m_buffer;
 
     //! config whether raise error exactly when invoking op.
@@ -232,6 +255,8 @@ private:
 
     struct ChannelState : State {
         StackManager stack_manager;
+        //! depth of nested start_batch()
+        size_t batch_depth = 0;
     };
 
     struct WorkerState : State {};
@@ -248,16 +273,28 @@ private:
      */
     struct DynamicSublinear {
         /*!
-         * \brief find an available tensor with the largest evaluation function
+         * \brief find the available tensors with the largest evaluation
+         * function, enough to free the given amount of memory
          *
          * Note: An available tensor must satisfy: (1) has computing path,
          * (2) is in memory, (3) is not pinned. Evaluation function refers to:
          * @see: TensorInfo::eval_func.
          *
-         * \return the pointer of the best tensor; nullptr is returned if no
-         * available tensor is found
+         * Only the least recently used available tensors in each bucket of
+         * candidate_buckets are evaluated, at most scan_depth (0 for no
+         * limit) per bucket. The evaluation is done once for all the returned
+         * tensors, so that evicting them takes a single scan.
+         *
+         * The cost of evicting a tensor is the cheaper one of recomputing it
+         * and, if swap_bandwidth is not 0, swapping it out and in.
+         *
+         * \param need_memory the best tensors are returned until their total
+         * memory reaches it; only the best one is returned for 0
+         * \return the tensors in the order to evict, each with the cheaper
+         * way to evict it; empty if no available tensor is found
          */
-        TensorInfo* find_best_tensor(bool);
+        SmallVector<std::pair<TensorInfo*, EvictType>> find_best_tensors(
+                bool, size_t, size_t, size_t);
 
         /*!
          * \brief estimate the cost of recomputing tensor ptr
@@ -267,6 +304,14 @@ private:
          */
         double estimate_neighbor_cost(TensorInfo* ptr);
 
+        /*!
+         * \brief estimate the cost of copying tensor ptr to host memory and
+         * back, in the same unit as TensorInfo::compute_time
+         *
+         * \param bandwidth bandwidth between device and host in MB/s
+         */
+        double estimate_swap_cost(TensorInfo* ptr, size_t bandwidth);
+
         /*!
          * \brief update the last used time of the tensor ptr
          */
@@ -334,8 +379,22 @@ private:
         //! the comp node where dynamic sublinear memory optimization works
         CompNode comp_node;
 
-        //! store all tensors that may be evicted
-        std::unordered_set<TensorInfo*> candidates;
+        /*!
+         * \brief store all tensors that may be evicted
+         *
+         * Tensors are bucketed by log2 of their memory size, and each bucket
+         * is ordered by last used time, from the least recently used one.
+         */
+        std::array<std::list<TensorInfo*>, sizeof(size_t) * 8> candidate_buckets;
+
+        /*!
+         * \brief return the key identifying an op applied on inputs of
+         * specified layouts, used to look up op_compute_time
+         */
+        size_t op_signature(const OpDef& op, const SmallVector<TensorInfo*>& inputs);
+
+        //! measured compute time in seconds, keyed by op_signature
+        std::unordered_map<size_t, double> op_compute_time;
 
         bool is_bad_op(std::string op_name) {
             return std::find(op_blacklist.begin(), op_blacklist.end(), op_name) !=
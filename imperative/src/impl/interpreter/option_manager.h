@@ -53,10 +53,43 @@ public:
     DEF_OPTION(
             dtr_eviction_threshold, "MEGENGINE_DTR_EVICTION_THRESHOLD", 0,
             "auto drop will start whenever gpu memory usage exceeds this value.");
+    DEF_OPTION(
+            dtr_eviction_low_watermark, "MEGENGINE_DTR_EVICTION_LOW_WATERMARK", 0,
+            "once auto drop starts, tensors are evicted until gpu memory usage "
+            "falls below this value; 0 or a value not below the threshold means "
+            "evicting down to the threshold.");
     DEF_OPTION(
             dtr_evictee_minimum_size, "MEGENGINE_DTR_EVICTEE_MINIMUM_SIZE", 1048576,
             "the minimum memory value of a tensor added to the candidate set");
+    DEF_OPTION(
+            enable_dtr_profile_compute_time, "MEGENGINE_DTR_PROFILE_COMPUTE_TIME", 0,
+            "measure the compute time of each distinct op on its first execution "
+            "and use it as the recompute cost instead of memory traffic");
+    DEF_OPTION(
+            dtr_candidate_scan_depth, "MEGENGINE_DTR_CANDIDATE_SCAN_DEPTH", 64,
+            "the number of least recently used tensors evaluated in each size "
+            "bucket of the candidate set when choosing a tensor to evict; 0 means "
+            "evaluating all candidates");
+    DEF_OPTION(
+            dtr_swap_bandwidth, "MEGENGINE_DTR_SWAP_BANDWIDTH", 0,
+            "the bandwidth in MB/s between device and host memory; auto drop "
+            "swaps a tensor to host memory instead of dropping it when copying it "
+            "out and back is estimated to be cheaper than recomputing it. 0 "
+            "disables swapping");
     DEF_OPTION(record_computing_path, "MEGENGINE_RECORD_COMPUTING_PATH", 0, "");
+    DEF_OPTION(
+            enable_elemwise_fusion, "MEGENGINE_ELEMWISE_FUSION", 0,
+            "fuse chains of consecutive elemwise ops in the command buffer into "
+            "compiled ops; longer chains are found with a larger buffer_length");
+    DEF_OPTION(
+            batch_length, "MEGENGINE_COMMAND_BATCH_LENGTH", 256,
+            "max number of commands held in the command buffer and issued to the "
+            "worker at once between start_batch and stop_batch");
+    DEF_OPTION(
+            enable_multi_stream, "MEGENGINE_MULTI_STREAM", 0,
+            "issue host to device copies and collective communication to the copy "
+            "and the communication streams of the devices that have them, so that "
+            "they overlap with computation");
 
 #undef DEF_OPTION
 
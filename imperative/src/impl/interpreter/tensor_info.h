@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <list>
+
 #include "megbrain/imperative/op_def.h"
 #include "megbrain/imperative/physical_tensor.h"
 #include "megbrain/imperative/utils/to_string.h"
@@ -85,6 +87,9 @@ struct TensorInfo {
     size_t recompute_times = 0;
     size_t ref_cnt = 0;
     std::shared_ptr<DsuNode> dsu_ptr;
+    // position in the eviction candidate index of DTR, bucket < 0 if absent
+    int candidate_bucket = -1;
+    std::list<TensorInfo*>::iterator candidate_iter;
 
     // Not reference count, inc when used as input
     size_t ptr_use_count = 0;
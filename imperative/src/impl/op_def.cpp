@@ -66,9 +66,84 @@ VarNodeArray OpDef::apply_on_var_node(const OpDef& def, const VarNodeArray& inpu
     return def.trait()->apply_on_var_node(def, inputs);
 }
 
+namespace {
+// unlike OpMethArgs, shapes of inputs are part of the key, so that inferred
+// output attrs could be reused by later applies with the same input layouts
+struct OutputAttrsArgs {
+    std::shared_ptr<OpDef> op;
+    SmallVector<LogicalTensorDesc> inputs;
+
+    size_t hash() const {
+        XXHash state;
+        size_t op_hash = op->hash();
+        state.update(&op_hash, sizeof(op_hash));
+        for (auto&& i : inputs) {
+            size_t data[] = {
+                    mgb::hash(i.layout.dtype.handle()), mgb::hash(i.comp_node),
+                    i.layout.ndim};
+            state.update(data, sizeof(data));
+            state.update(i.layout.shape, sizeof(size_t) * i.layout.ndim);
+        }
+        return state.digest();
+    }
+
+    bool operator==(const OutputAttrsArgs& rhs) const {
+        if (!op->is_same(*rhs.op) || inputs.size() != rhs.inputs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (inputs[i].comp_node != rhs.inputs[i].comp_node ||
+                !inputs[i].layout.eq_layout(rhs.inputs[i].layout)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct hash_t {
+        size_t operator()(const OutputAttrsArgs& key) const { return key.hash(); }
+    };
+};
+
+struct OutputAttrsCache
+        : std::unordered_map<
+                  OutputAttrsArgs, SmallVector<LogicalTensorDesc>,
+                  OutputAttrsArgs::hash_t>,
+          CompNodeDepedentObject {
+    //! the cache is cleared when it grows larger than this, in case that input
+    //! shapes keep changing
+    static constexpr size_t MAX_SIZE = 8192;
+
+    std::shared_ptr<void> on_comp_node_finalize() override {
+        clear();
+        return {};
+    }
+};
+}  // anonymous namespace
+
 std::tuple<SmallVector<LogicalTensorDesc>, bool> OpDef::infer_output_attrs_fallible(
         const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs) {
-    return def.trait()->infer_output_attrs_fallible(def, inputs);
+    // only shapes are inferred from inputs whose values are unknown, and the
+    // inference of such inputs is redone on every apply without the cache
+    for (auto&& i : inputs) {
+        if (!i.value.empty() || !i.layout.ndim) {
+            return def.trait()->infer_output_attrs_fallible(def, inputs);
+        }
+    }
+    thread_local OutputAttrsCache cache;
+    OutputAttrsArgs cache_key{const_cast<OpDef&>(def).shared_from_this(), inputs};
+    auto iter = cache.find(cache_key);
+    if (iter != cache.end()) {
+        return {iter->second, true};
+    }
+    auto [outputs, validated] = def.trait()->infer_output_attrs_fallible(def, inputs);
+    if (validated) {
+        if (cache.size() >= OutputAttrsCache::MAX_SIZE) {
+            cache.clear();
+        }
+        cache.emplace(std::move(cache_key), outputs);
+    }
+    return {std::move(outputs), validated};
 }
 
 EncodedSubgraph OpDef::make_backward_graph(
@@ -105,9 +105,11 @@ void apply_on_device_tensornd(
     mgb_assert(
             inputs.size() == trait.arity, "%s expects %u inputs; got %zu actually",
             trait.name, trait.arity, inputs.size());
-    auto&& dnn_opr =
-            opr::intl::create_megdnn_opr<megdnn::Elemwise>(inputs[0].comp_node());
+    auto cn = inputs[0].comp_node();
+    DnnOprCaller<megdnn::Elemwise> caller{cn};
+    opr::intl::UniqPtrWithCN<megdnn::Elemwise> dnn_opr{std::move(caller.op), cn};
     opr::Elemwise::perform(op_def.mode, (*outputs)[0], inputs, dnn_opr);
+    caller.op.reset(dnn_opr.release());
 }
 
 void execute(
@@ -8,6 +8,7 @@
  * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
  * ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
+#include "../dnn_op_helper.h"
 #include "../op_trait.h"
 
 #include "megbrain/imperative/ops/autogen.h"
@@ -28,6 +29,93 @@ OP_TRAIT_REG(CheckNonFinite, CheckNonFinite)
         .fallback();
 }  // namespace check_non_finite
 
+namespace check_non_finite_v2 {
+
+// inputs: tensors to be checked and scaled
+// outputs: the scaled tensors, and an int32 flag of whether any non-finite
+// value is found
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = def.cast_final_safe<CheckNonFiniteV2>();
+    OperatorNodeConfig config{op.make_name()};
+    return opr::CheckNonFiniteV2::make(inputs, op.param(), config);
+}
+
+std::tuple<SmallVector<LogicalTensorDesc>, bool> infer_output_attrs_fallible(
+        const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs) {
+    mgb_assert(!inputs.empty(), "CheckNonFiniteV2 expects at least one input");
+    SmallVector<LogicalTensorDesc> outputs;
+    bool succeed = true;
+    for (auto&& i : inputs) {
+        mgb_assert(
+                i.comp_node == inputs[0].comp_node,
+                "inputs of CheckNonFiniteV2 should be in same comp_node");
+        mgb_assert(
+                i.layout.dtype == dtype::Float32(),
+                "inputs of CheckNonFiniteV2 should be float32, got %s",
+                i.layout.dtype.name());
+        outputs.push_back({i.layout, i.comp_node});
+        succeed &= i.layout.ndim != 0;
+    }
+    outputs.push_back({TensorLayout{{1}, dtype::Int32()}, inputs[0].comp_node});
+    return {outputs, succeed};
+}
+
+/*!
+ * The inputs are scaled inplace if no other tensor shares their memory, so
+ * that all the gradients of a model are unscaled and checked by one kernel
+ * without any copy.
+ */
+SmallVector<TensorPtr> apply_on_physical_tensor(
+        const OpDef& def, const SmallVector<TensorPtr>& inputs) {
+    auto&& op = def.cast_final_safe<CheckNonFiniteV2>();
+    auto cn = inputs[0]->comp_node();
+    SmallVector<TensorPtr> outputs;
+    megdnn::TensorNDArray srcs;
+    for (auto&& inp : inputs) {
+        bool inplace = inp->layout().is_contiguous() &&
+                       inp->blob().use_count() == 2 && inp->blob()->storage().unique();
+        TensorPtr out;
+        if (inplace) {
+            out = std::make_shared<Tensor>(inp->blob(), inp->offset(), inp->layout());
+        } else {
+            out = Tensor::make(TensorLayout{inp->shape(), inp->dtype()}, cn);
+            if (!inp->layout().is_empty()) {
+                out->dev_tensor().copy_from_fixlayout(inp->dev_tensor());
+            }
+        }
+        if (!out->layout().is_empty()) {
+            srcs.push_back(out->dev_tensor().as_megdnn());
+        }
+        outputs.push_back(out);
+    }
+    auto flag = Tensor::make(TensorLayout{{1}, dtype::Int32()}, cn);
+    DnnOprCaller<megdnn::CheckNonFiniteV2> dnn_op(cn);
+    dnn_op.op->param() = op.param();
+    size_t workspace_size = dnn_op.op->get_workspace_in_bytes(srcs, flag->layout());
+    megdnn::Workspace workspace;
+    if (workspace_size) {
+        workspace = dnn_op.create_workspace({{workspace_size}, dtype::Byte()});
+    }
+    dnn_op.op->exec(srcs, flag->dev_tensor().as_megdnn(), workspace);
+    outputs.push_back(flag);
+    return outputs;
+}
+
+//! the outputs may be aliases of the inputs, so no memory is planned for them
+std::tuple<SmallVector<MemoryDesc>, SmallVector<MemoryDesc>> infer_output_mem_desc(
+        const OpDef& def, const SmallVector<TensorPtr>& inputs_tensors,
+        const SmallVector<MemoryDesc>& inputs_mems) {
+    return {{}, {}};
+}
+
+OP_TRAIT_REG(CheckNonFiniteV2, CheckNonFiniteV2)
+        .apply_on_var_node(apply_on_var_node)
+        .infer_output_attrs_fallible(infer_output_attrs_fallible)
+        .apply_on_physical_tensor(apply_on_physical_tensor)
+        .infer_output_mem_desc(infer_output_mem_desc)
+        .fallback();
+}  // namespace check_non_finite_v2
+
 }  // namespace imperative
 }  // namespace mgb
 
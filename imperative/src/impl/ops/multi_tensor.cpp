@@ -0,0 +1,384 @@
+/**
+ * \file imperative/src/impl/ops/multi_tensor.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/imperative/ops/autogen.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+
+#include "../dnn_op_helper.h"
+#include "../op_trait.h"
+
+namespace mgb {
+namespace imperative {
+
+namespace {
+
+/*!
+ * The multi-tensor optimizer ops update the params and the states of a whole
+ * param group in a single op. Their inputs are made of groups of equal
+ * length, e.g. (params, grads, states...), and their outputs are the updated
+ * params and states, which share the memory of the corresponding inputs.
+ *
+ * On physical tensors the kernels of all the tensors are issued by one call,
+ * without going through the interpreter for each of them; on var nodes they
+ * are expanded into plain elemwise oprs.
+ */
+class MultiTensorHelper {
+    DnnOprCaller<megdnn::AddUpdate> m_add_update;
+    DnnOprCaller<megdnn::Elemwise> m_elemwise;
+    DeviceTensorND m_workspace;
+
+public:
+    MultiTensorHelper(CompNode cn, size_t workspace_size)
+            : m_add_update{cn}, m_elemwise{cn} {
+        if (workspace_size) {
+            m_workspace = DnnOprPool::inst().workspace(cn, workspace_size);
+        }
+    }
+
+    //! dest = alpha * dest + beta * delta + bias
+    void add_update(
+            const DeviceTensorND& dest, const DeviceTensorND& delta, float alpha,
+            float beta, float bias = 0.f) {
+        m_add_update.op->param() = {alpha, beta, bias};
+        m_add_update.op->exec(dest.as_megdnn(), delta.as_megdnn());
+    }
+
+    void elemwise(
+            megdnn::Elemwise::Mode mode, const SmallVector<DeviceTensorND>& inputs,
+            const DeviceTensorND& dest) {
+        megdnn::TensorNDArray srcs;
+        for (auto&& i : inputs) {
+            srcs.push_back(i.as_megdnn());
+            if (!i.shape().eq_shape(dest.shape())) {
+                srcs.back().layout = srcs.back().layout.broadcast(dest.shape());
+            }
+        }
+        m_elemwise.op->param() = {mode};
+        m_elemwise.op->exec(srcs, dest.as_megdnn());
+    }
+
+    //! a temporary tensor viewing the workspace from \p offset bytes
+    DeviceTensorND temp(size_t offset, const TensorLayout& layout) {
+        DeviceTensorND ret;
+        ret.reset(
+                m_workspace.storage().sub(offset),
+                TensorLayout{TensorShape{layout}, layout.dtype});
+        return ret;
+    }
+
+    //! a temporary copy of \p src
+    DeviceTensorND temp_copy(size_t offset, const DeviceTensorND& src) {
+        auto ret = temp(offset, src.layout());
+        ret.copy_from_fixlayout(src);
+        return ret;
+    }
+};
+
+void check_inplace_dest(const TensorPtr& dest) {
+    mgb_assert(
+            dest->blob().use_count() == 2 && dest->blob()->storage().unique(),
+            "This inplace modification may change the elements of other tensors. "
+            "Please set MEGENGINE_INPLACE_UPDATE to 0 to ensure the program runs "
+            "correctly.");
+}
+
+size_t max_span(const SmallVector<TensorPtr>& inputs, size_t begin, size_t end) {
+    size_t ret = 0;
+    for (size_t i = begin; i < end; ++i) {
+        auto size = inputs[i]->dtype().size(inputs[i]->shape().total_nr_elems());
+        // keep the temporaries aligned
+        ret = std::max(ret, (size + 255) / 256 * 256);
+    }
+    return ret;
+}
+
+/*!
+ * \brief check that the inputs consist of \p nr_groups groups of float32
+ *      tensors, where the tensors at the same position of the first
+ *      \p nr_shaped_groups groups have the same shape, and those of the
+ *      other groups are scalars
+ * \return the number of tensors in each group, and whether the shapes are
+ *      all known
+ */
+std::pair<size_t, bool> check_multi_tensor_inputs(
+        const SmallVector<LogicalTensorDesc>& inputs, size_t nr_groups,
+        size_t nr_shaped_groups, const char* name) {
+    mgb_assert(
+            inputs.size() % nr_groups == 0, "%s expects %zu groups of tensors", name,
+            nr_groups);
+    size_t nr_tensors = inputs.size() / nr_groups;
+    bool succeed = true;
+    for (auto&& i : inputs) {
+        mgb_assert(
+                i.comp_node == inputs[0].comp_node,
+                "inputs of %s should be in same comp_node", name);
+        mgb_assert(
+                i.layout.dtype == dtype::Float32(), "inputs of %s should be float32",
+                name);
+        succeed &= i.layout.ndim != 0;
+    }
+    if (succeed) {
+        for (size_t i = nr_tensors; i < nr_tensors * nr_shaped_groups; ++i) {
+            mgb_assert(
+                    inputs[i].layout.eq_shape(inputs[i % nr_tensors].layout),
+                    "shape mismatch in the inputs of %s: %s vs %s", name,
+                    inputs[i].layout.to_string().c_str(),
+                    inputs[i % nr_tensors].layout.to_string().c_str());
+        }
+        for (size_t i = nr_tensors * nr_shaped_groups; i < inputs.size(); ++i) {
+            mgb_assert(
+                    inputs[i].layout.total_nr_elems() == 1,
+                    "expect scalar inputs of %s, got %s", name,
+                    inputs[i].layout.to_string().c_str());
+        }
+    }
+    return {nr_tensors, succeed};
+}
+
+/*!
+ * \brief output descs of the groups of inputs given by \p groups, which are
+ *      updated inplace
+ */
+std::tuple<SmallVector<LogicalTensorDesc>, bool> inplace_output_attrs(
+        const SmallVector<LogicalTensorDesc>& inputs, size_t nr_tensors,
+        bool succeed, std::initializer_list<size_t> groups) {
+    SmallVector<LogicalTensorDesc> outputs;
+    for (auto group : groups) {
+        for (size_t i = 0; i < nr_tensors; ++i) {
+            auto&& input = inputs[group * nr_tensors + i];
+            outputs.push_back({input.layout, input.comp_node});
+        }
+    }
+    return {outputs, succeed};
+}
+
+//! the outputs are aliases of the inputs, so no memory is planned for them
+std::tuple<SmallVector<MemoryDesc>, SmallVector<MemoryDesc>> infer_no_output_mem_desc(
+        const OpDef& def, const SmallVector<TensorPtr>& inputs_tensors,
+        const SmallVector<MemoryDesc>& inputs_mems) {
+    return {{}, {}};
+}
+
+TensorPtr alias(const TensorPtr& tensor) {
+    return std::make_shared<Tensor>(tensor->blob(), tensor->offset(), tensor->layout());
+}
+
+namespace multi_tensor_adam {
+
+// inputs: params, grads, exp_avgs, exp_avg_sqs, steps
+// outputs: params, exp_avgs, exp_avg_sqs, steps
+constexpr size_t NR_GROUPS = 5;
+
+std::tuple<SmallVector<LogicalTensorDesc>, bool> infer_output_attrs_fallible(
+        const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs) {
+    auto [nr_tensors, succeed] =
+            check_multi_tensor_inputs(inputs, NR_GROUPS, 4, "MultiTensorAdam");
+    return inplace_output_attrs(inputs, nr_tensors, succeed, {0, 2, 3, 4});
+}
+
+SmallVector<TensorPtr> apply_on_physical_tensor(
+        const OpDef& def, const SmallVector<TensorPtr>& inputs) {
+    auto&& op = def.cast_final_safe<MultiTensorAdam>();
+    size_t n = inputs.size() / NR_GROUPS;
+    if (!n) {
+        return {};
+    }
+    auto cn = inputs[0]->comp_node();
+    size_t span = max_span(inputs, 0, n);
+    MultiTensorHelper helper{cn, span * 2};
+    auto half = Tensor::make_scalar(DTypeScalar(0.5f), cn)->dev_tensor();
+    bool coupled_decay = op.weight_decay != 0.f && !op.decoupled_weight_decay;
+    float param_alpha = op.decoupled_weight_decay ? 1.f - op.lr * op.weight_decay : 1.f;
+    float step_size = op.lr / op.bias_correction0;
+    float denom_scale = 1.f / std::sqrt(op.bias_correction1);
+    SmallVector<TensorPtr> outputs;
+    for (size_t i = 0; i < n; ++i) {
+        auto&& param = inputs[i];
+        auto&& exp_avg = inputs[n * 2 + i];
+        auto&& exp_avg_sq = inputs[n * 3 + i];
+        auto&& step = inputs[n * 4 + i];
+        for (auto&& dest : {param, exp_avg, exp_avg_sq, step}) {
+            check_inplace_dest(dest);
+        }
+        auto p = param->dev_tensor(), m = exp_avg->dev_tensor(),
+             v = exp_avg_sq->dev_tensor();
+        auto grad = inputs[n + i]->dev_tensor();
+        if (coupled_decay) {
+            // grad = grad + weight_decay * param
+            grad = helper.temp_copy(0, grad);
+            helper.add_update(grad, p, 1.f, op.weight_decay);
+        }
+        auto t = helper.temp(span, p.layout());
+        helper.add_update(m, grad, op.beta0, 1.f - op.beta0);
+        helper.elemwise(megdnn::Elemwise::Mode::MUL, {grad, grad}, t);
+        helper.add_update(v, t, op.beta1, 1.f - op.beta1);
+        // t = sqrt(exp_avg_sq / bias_correction1) + eps
+        helper.elemwise(megdnn::Elemwise::Mode::POW, {v, half}, t);
+        helper.add_update(t, t, denom_scale, 0.f, op.eps);
+        helper.elemwise(megdnn::Elemwise::Mode::TRUE_DIV, {m, t}, t);
+        // param = param - lr * (exp_avg / bias_correction0 / t
+        //         [+ weight_decay * param])
+        helper.add_update(p, t, param_alpha, -step_size);
+        helper.add_update(step->dev_tensor(), step->dev_tensor(), 1.f, 0.f, 1.f);
+    }
+    for (size_t group : {0, 2, 3, 4}) {
+        for (size_t i = 0; i < n; ++i) {
+            outputs.push_back(alias(inputs[group * n + i]));
+        }
+    }
+    return outputs;
+}
+
+VarNodeArray apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = def.cast_final_safe<MultiTensorAdam>();
+    size_t n = inputs.size() / NR_GROUPS;
+    VarNodeArray params, exp_avgs, exp_avg_sqs, steps;
+    for (size_t i = 0; i < n; ++i) {
+        SymbolVar param = inputs[i], grad = inputs[n + i], m = inputs[n * 2 + i],
+                  v = inputs[n * 3 + i], step = inputs[n * 4 + i];
+        if (op.weight_decay != 0.f && !op.decoupled_weight_decay) {
+            grad = grad + param * op.weight_decay;
+        }
+        m = m * op.beta0 + grad * (1.f - op.beta0);
+        v = v * op.beta1 + grad * grad * (1.f - op.beta1);
+        auto delta = m / (opr::powf(v / op.bias_correction1, 0.5f) + op.eps) /
+                     op.bias_correction0;
+        if (op.decoupled_weight_decay) {
+            delta = delta + param * op.weight_decay;
+        }
+        params.push_back((param - delta * op.lr).node());
+        exp_avgs.push_back(m.node());
+        exp_avg_sqs.push_back(v.node());
+        steps.push_back((step + 1.f).node());
+    }
+    VarNodeArray outputs;
+    for (auto&& group : {params, exp_avgs, exp_avg_sqs, steps}) {
+        outputs.insert(outputs.end(), group.begin(), group.end());
+    }
+    return outputs;
+}
+
+OP_TRAIT_REG(MultiTensorAdam, MultiTensorAdam)
+        .apply_on_var_node(apply_on_var_node)
+        .infer_output_attrs_fallible(infer_output_attrs_fallible)
+        .apply_on_physical_tensor(apply_on_physical_tensor)
+        .infer_output_mem_desc(infer_no_output_mem_desc)
+        .fallback();
+
+}  // namespace multi_tensor_adam
+
+namespace multi_tensor_sgd {
+
+// inputs: params, grads[, momentum_buffers]
+// outputs: params[, momentum_buffers]
+size_t nr_groups(const MultiTensorSGD& op) {
+    return op.momentum != 0.f ? 3 : 2;
+}
+
+std::tuple<SmallVector<LogicalTensorDesc>, bool> infer_output_attrs_fallible(
+        const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs) {
+    auto&& op = def.cast_final_safe<MultiTensorSGD>();
+    auto [nr_tensors, succeed] =
+            check_multi_tensor_inputs(
+            inputs, nr_groups(op), nr_groups(op), "MultiTensorSGD");
+    if (op.momentum != 0.f) {
+        return inplace_output_attrs(inputs, nr_tensors, succeed, {0, 2});
+    }
+    return inplace_output_attrs(inputs, nr_tensors, succeed, {0});
+}
+
+SmallVector<TensorPtr> apply_on_physical_tensor(
+        const OpDef& def, const SmallVector<TensorPtr>& inputs) {
+    auto&& op = def.cast_final_safe<MultiTensorSGD>();
+    size_t n = inputs.size() / nr_groups(op);
+    if (!n) {
+        return {};
+    }
+    bool use_momentum = op.momentum != 0.f;
+    bool need_temp = op.weight_decay != 0.f || op.nesterov;
+    MultiTensorHelper helper{
+            inputs[0]->comp_node(), need_temp ? max_span(inputs, 0, n) : 0};
+    for (size_t i = 0; i < n; ++i) {
+        auto&& param = inputs[i];
+        check_inplace_dest(param);
+        auto p = param->dev_tensor();
+        auto grad = inputs[n + i]->dev_tensor();
+        bool grad_is_temp = false;
+        if (op.weight_decay != 0.f) {
+            // grad = grad + weight_decay * param
+            grad = helper.temp_copy(0, grad);
+            grad_is_temp = true;
+            helper.add_update(grad, p, 1.f, op.weight_decay);
+        }
+        if (use_momentum) {
+            auto&& buf = inputs[n * 2 + i];
+            check_inplace_dest(buf);
+            auto v = buf->dev_tensor();
+            helper.add_update(v, grad, op.momentum, 1.f);
+            if (op.nesterov) {
+                if (!grad_is_temp) {
+                    grad = helper.temp_copy(0, grad);
+                }
+                helper.add_update(grad, v, 1.f, op.momentum);
+            } else {
+                grad = v;
+            }
+        }
+        helper.add_update(p, grad, 1.f, -op.lr);
+    }
+    SmallVector<TensorPtr> outputs;
+    for (size_t i = 0; i < n; ++i) {
+        outputs.push_back(alias(inputs[i]));
+    }
+    if (use_momentum) {
+        for (size_t i = 0; i < n; ++i) {
+            outputs.push_back(alias(inputs[n * 2 + i]));
+        }
+    }
+    return outputs;
+}
+
+VarNodeArray apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = def.cast_final_safe<MultiTensorSGD>();
+    size_t n = inputs.size() / nr_groups(op);
+    VarNodeArray params, bufs;
+    for (size_t i = 0; i < n; ++i) {
+        SymbolVar param = inputs[i], grad = inputs[n + i];
+        if (op.weight_decay != 0.f) {
+            grad = grad + param * op.weight_decay;
+        }
+        if (op.momentum != 0.f) {
+            SymbolVar v = inputs[n * 2 + i];
+            v = v * op.momentum + grad;
+            bufs.push_back(v.node());
+            grad = op.nesterov ? grad + v * op.momentum : v;
+        }
+        params.push_back((param - grad * op.lr).node());
+    }
+    params.insert(params.end(), bufs.begin(), bufs.end());
+    return params;
+}
+
+OP_TRAIT_REG(MultiTensorSGD, MultiTensorSGD)
+        .apply_on_var_node(apply_on_var_node)
+        .infer_output_attrs_fallible(infer_output_attrs_fallible)
+        .apply_on_physical_tensor(apply_on_physical_tensor)
+        .infer_output_mem_desc(infer_no_output_mem_desc)
+        .fallback();
+
+}  // namespace multi_tensor_sgd
+
+}  // anonymous namespace
+
+}  // namespace imperative
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -19,7 +19,10 @@
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/dnn/correlation.h"
 #include "megbrain/opr/dnn/fake_quant.h"
+#include "megbrain/opr/dnn/fused_attention.h"
+#include "megbrain/opr/dnn/group_norm.h"
 #include "megbrain/opr/dnn/images2neibs.h"
+#include "megbrain/opr/dnn/layer_norm.h"
 #include "megbrain/opr/dnn/local.h"
 #include "megbrain/opr/dnn/lrn.h"
 #include "megbrain/opr/dnn/lsq.h"
@@ -27,6 +30,7 @@
 #include "megbrain/opr/dnn/roi_align.h"
 #include "megbrain/opr/dnn/roi_pooling.h"
 #include "megbrain/opr/dnn/sliding_window_transpose.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/dnn/tqt.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/indexing.h"
@@ -553,6 +557,21 @@ OP_TRAIT_REG(ElemwiseMultiType, ElemwiseMultiType)
 }  // namespace elemwise_multi_type
 }  // namespace
 
+namespace {
+namespace elemwise_multi_output {
+cg::OperatorNodeBase* apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const ElemwiseMultiOutput&>(def);
+    OperatorNodeConfig config{op.make_name()};
+    return opr::ElemwiseMultiOutput::make(inputs, op.param(), config)[0]
+            .node()
+            ->owner_opr();
+}
+OP_TRAIT_REG(ElemwiseMultiOutput, ElemwiseMultiOutput)
+        .apply_on_var_node(apply_on_var_node)
+        .fallback();
+}  // namespace elemwise_multi_output
+}  // namespace
+
 namespace {
 namespace svd {
 auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
@@ -636,4 +655,62 @@ auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
 }
 OP_TRAIT_REG(LRN, LRN).apply_on_var_node(apply_on_var_node).fallback();
 }  // namespace lrn
+
+namespace softmax {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const Softmax&>(def);
+    mgb_assert(inputs.size() == 1);
+    return opr::Softmax::make(inputs[0], op.param());
+}
+OP_TRAIT_REG(Softmax, Softmax).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace softmax
+
+namespace layer_norm {
+cg::OperatorNodeBase* apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const LayerNorm&>(def);
+    size_t nr_inp = inputs.size();
+    auto p = op.param();
+    mgb_assert((nr_inp == 3 && p.affine) || (nr_inp == 1 && !p.affine));
+    OperatorNodeConfig config{op.make_name()};
+    if (nr_inp == 3) {
+        return opr::LayerNorm::make(inputs[0], inputs[1], inputs[2], p, config)[0]
+                .node()
+                ->owner_opr();
+    } else {
+        return opr::LayerNorm::make(inputs[0], p, config)[0].node()->owner_opr();
+    }
+}
+OP_TRAIT_REG(LayerNorm, LayerNorm).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace layer_norm
+
+namespace group_norm {
+cg::OperatorNodeBase* apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const GroupNorm&>(def);
+    size_t nr_inp = inputs.size();
+    auto p = op.param();
+    mgb_assert((nr_inp == 3 && p.affine) || (nr_inp == 1 && !p.affine));
+    OperatorNodeConfig config{op.make_name()};
+    if (nr_inp == 3) {
+        return opr::GroupNorm::make(inputs[0], inputs[1], inputs[2], p, config)[0]
+                .node()
+                ->owner_opr();
+    } else {
+        return opr::GroupNorm::make(inputs[0], p, config)[0].node()->owner_opr();
+    }
+}
+OP_TRAIT_REG(GroupNorm, GroupNorm).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace group_norm
+
+namespace fused_attention {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const FusedAttention&>(def);
+    mgb_assert(inputs.size() == 3);
+    OperatorNodeConfig config{op.make_name()};
+    return opr::FusedAttention::make(
+            inputs[0], inputs[1], inputs[2], op.param(), config);
+}
+OP_TRAIT_REG(FusedAttention, FusedAttention)
+        .apply_on_var_node(apply_on_var_node)
+        .fallback();
+}  // namespace fused_attention
 }  // namespace mgb::imperative
@@ -12,6 +12,11 @@
 #include "megbrain/imperative/profiler.h"
 
 #include <chrono>
+#include <thread>
+
+#if MGB_PROFILER_TSC && !defined(_MSC_VER) && !defined(__aarch64__)
+#include <cpuid.h>
+#endif
 
 #include "megbrain/imperative/ops/opr_attr.h"
 #include "megbrain/imperative/physical_tensor.h"
@@ -27,10 +32,59 @@
 namespace mgb {
 namespace imperative {
 
+namespace {
+bool tsc_available() {
+#if defined(__aarch64__)
+    //! the virtual counter runs at a constant frequency
+    return true;
+#elif MGB_PROFILER_TSC && !defined(_MSC_VER)
+    //! the TSC should increase at a constant rate regardless of the frequency
+    //! and the sleep states of the cores, as reported by the invariant TSC bit
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return edx & (1u << 8);
+#elif MGB_PROFILER_TSC
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned int>(regs[0]) < 0x80000007) {
+        return false;
+    }
+    __cpuid(regs, 0x80000007);
+    return regs[3] & (1 << 8);
+#else
+    return false;
+#endif
+}
+}  // namespace
+
+const bool Timer::sm_tsc_available = tsc_available();
+
 profiler::Time Timer::record_host() {
     return std::chrono::system_clock::now();
 }
 
+Timer::TickAnchor Timer::record_anchor() {
+    //! take the middle of the ticks around reading the host clock
+    uint64_t begin = record_ticks();
+    auto time = record_host();
+    uint64_t end = record_ticks();
+    return {begin + (end - begin) / 2, time};
+}
+
+profiler::HostTime Timer::ticks_to_time(
+        uint64_t ticks, const TickAnchor& begin, const TickAnchor& end) {
+    if (end.ticks <= begin.ticks) {
+        return begin.time;
+    }
+    double ratio = static_cast<double>((end.time - begin.time).count()) /
+                   static_cast<double>(end.ticks - begin.ticks);
+    auto offset = static_cast<double>(static_cast<int64_t>(ticks - begin.ticks));
+    return begin.time +
+           profiler::Duration(static_cast<profiler::Duration::rep>(offset * ratio));
+}
+
 std::shared_ptr<CompNode::Event> Timer::record_device(CompNode device) {
     auto event = EventPool::with_timer().alloc_shared(device);
     event->record();
@@ -43,10 +97,10 @@ std::mutex Profiler::sm_mutex;
 std::unordered_map<std::thread::id, std::unique_ptr<Profiler>> Profiler::sm_profilers;
 Timer Profiler::sm_timer;
 profiler::HostTime Profiler::sm_start_at = profiler::HostTime::min();
+Timer::TickAnchor Profiler::sm_start_anchor;
 std::atomic_uint64_t Profiler::sm_last_id = 0;
 bool Profiler::sm_profiling = false;
 thread_local Profiler* Profiler::tm_profiler = nullptr;
-std::atomic_size_t Profiler::sm_preferred_capacity;
 
 auto Profiler::get_thread_dict() -> thread_dict_t {
     thread_dict_t thread_dict;
@@ -56,6 +110,19 @@ auto Profiler::get_thread_dict() -> thread_dict_t {
     return thread_dict;
 }
 
+Timer::TickAnchor Profiler::collect_anchor() {
+    //! the ratio of ticks to host time is measured between the anchors, so
+    //! they should be apart enough for the resolution of the host clock
+    constexpr auto min_interval = std::chrono::milliseconds(10);
+    auto anchor = Timer::record_anchor();
+    auto interval = anchor.time - sm_start_anchor.time;
+    if (sm_start_anchor.ticks && interval < min_interval) {
+        std::this_thread::sleep_for(min_interval - interval);
+        anchor = Timer::record_anchor();
+    }
+    return anchor;
+}
+
 void Profiler::dump_profile(std::string basename, std::string format, bundle_t result) {
     static std::unordered_map<std::string, void (*)(std::string, bundle_t)>
             format_table = {
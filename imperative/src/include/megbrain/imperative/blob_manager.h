@@ -36,6 +36,21 @@ public:
     virtual void set_enable(bool flag) = 0;
 
     virtual void defrag(const CompNode& cn) = 0;
+
+    /*!
+     * \brief enable step-aware arena allocation for blobs on \p cn
+     *
+     * The allocation sequence of each step (delimited by mark_step()) is
+     * recorded. After \p warmup_steps consecutive identical steps, a static
+     * layout is planned for the allocations freed within the step, and
+     * following steps are served from one pre-allocated chunk. Any deviation
+     * from the recorded sequence falls back to direct allocation and
+     * restarts the warmup. Setting \p warmup_steps to 0 disables the arena.
+     */
+    virtual void set_arena(CompNode cn, size_t warmup_steps) = 0;
+
+    //! mark the boundary between two steps for arena allocation
+    virtual void mark_step() = 0;
 };
 
 }  // namespace imperative
@@ -65,6 +65,11 @@ struct Interpreter {
 
         virtual void push_scope(std::string name) = 0;
         virtual void pop_scope(std::string name) = 0;
+
+        //! commands between start_batch() and stop_batch() are issued to the
+        //! worker in batches; batches could be nested
+        virtual void start_batch() = 0;
+        virtual void stop_batch() = 0;
     };
 
     virtual std::unique_ptr<Channel> create_channel() = 0;
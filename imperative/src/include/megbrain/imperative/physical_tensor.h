@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <mutex>
 
@@ -138,14 +139,15 @@ private:
     EventPtr m_value_ready = nullptr;
 };
 
-// Cache for small blobs
-// 1. A blob has to be seen twice (within a window) to be eligible for cache
-// 2. Cache eviction occurs when cache size reaches a threshold, in least frequently
+// Cache for small blobs, keyed by the hash of their contents
+// 1. A blob has to be seen twice (within a window) to be eligible for cache, except
+// for scalars, which are cached when first seen since most of them are reused,
+// e.g. the constants in losses and lr schedules
+// 2. Cache eviction occurs when cache size reaches a threshold, in least recently
 // used order
 class ConstTensorCache {
 public:
     struct Entry {
-        size_t hitcnt = 0;
         std::unique_ptr<dt_byte[]> data;
         size_t size;
         BlobPtr blob;
@@ -158,7 +160,8 @@ public:
 
         // does not check input
         bool match(const HostTensorND& hv) {
-            return 0 == memcmp(data.get(), hv.raw_ptr(), hv.layout().span().high_byte);
+            auto nr_bytes = hv.layout().span().high_byte;
+            return size == nr_bytes && 0 == memcmp(data.get(), hv.raw_ptr(), nr_bytes);
         }
     };
 
@@ -186,25 +189,28 @@ public:
         // lookup in g1
         auto it = g1.find(h);
         if (it != g1.end()) {
-            if (!it->second.match(hv)) {
+            auto&& entry = it->second->second;
+            if (!entry.match(hv)) {
                 mgb_log_warn("hash collision in const tensor cache");
                 return {};
             }
-            it->second.hitcnt += 1;
-            return it->second.blob;
+            // move to the most recently used end
+            lru.splice(lru.begin(), lru, it->second);
+            return entry.blob;
         }
         // lookup in g0
-        if (!g0.extract(h) && !g0b.extract(h)) {
+        bool is_scalar = hv.layout().total_nr_elems() == 1;
+        if (!is_scalar && !g0.extract(h) && !g0b.extract(h)) {
             maybe_collect_g0();
             g0.emplace(h);
             return {};
         }
         // add new entry to g1
         maybe_collect_g1();
-        Entry entry(hv.raw_ptr(), hv.layout().span().high_byte, Tensor(hv).blob());
-        it = g1.emplace_hint(it, h, std::move(entry));
-        it->second.hitcnt += 1;
-        return it->second.blob;
+        lru.emplace_front(
+                h, Entry(hv.raw_ptr(), hv.layout().span().high_byte, Tensor(hv).blob()));
+        g1.emplace(h, lru.begin());
+        return lru.front().second.blob;
     }
 
     void clear() {
@@ -212,11 +218,11 @@ public:
         g0.clear();
         g0b.clear();
         g1.clear();
+        lru.clear();
     }
 
     std::mutex mtx;
-    const size_t hwm = 1024, lwm = 512, max_bytes = TensorShape::MAX_NDIM * 8,
-                 window = 65536;
+    const size_t hwm = 1024, max_bytes = TensorShape::MAX_NDIM * 8, window = 65536;
 
 private:
     void maybe_collect_g0() {
@@ -226,39 +232,25 @@ private:
         }
     }
     void maybe_collect_g1() {
-        if (g1.size() < hwm)
-            return;
-
-        tmp.clear();
-        for (auto&& kv : g1) {
-            tmp.emplace_back(kv.first, std::move(kv.second));
-        }
-        std::nth_element(
-                tmp.begin(), tmp.begin() + lwm, tmp.end(),
-                [](const KV& lhs, const KV& rhs) {
-                    return lhs.second.hitcnt > rhs.second.hitcnt;
-                });
-        tmp.resize(lwm);
-        g1.clear();
-        for (auto&& kv : tmp) {
-            kv.second.hitcnt = 0;
-            g1.emplace(std::move(kv));
+        while (g1.size() >= hwm) {
+            g1.erase(lru.back().first);
+            lru.pop_back();
         }
     }
 
     // g0: records blobs which have been seen at least once (within a window)
     // g0b: backup of g0
-    // g1: records the most frequently used blobs which have been seen at least
-    // twice. When `g1.size() == hwm`, it will be refreshed and only the top
-    // `lhw` frequently used blobs will be kept.
+    // g1: indexes the cached blobs in lru, which are ordered from the most
+    // recently used to the least. When `g1.size() == hwm`, the least recently used
+    // blob is evicted.
     std::unordered_set<uint64_t> g0, g0b;
-    std::unordered_map<uint64_t, Entry> g1;
-    std::vector<KV> tmp;
+    std::list<KV> lru;
+    std::unordered_map<uint64_t, std::list<KV>::iterator> g1;
 
 public:
     ConstTensorCache() {
         g0.reserve(window), g0b.reserve(window);
-        g1.reserve(hwm), tmp.reserve(hwm);
+        g1.reserve(hwm);
     }
 };
 
@@ -12,6 +12,8 @@
 #pragma once
 
 #include <any>
+#include <array>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <deque>
@@ -29,6 +31,18 @@
 #include "megbrain/imperative/op_def.h"
 #include "megbrain/imperative/physical_tensor.h"
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define MGB_PROFILER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MGB_PROFILER_TSC 1
+#elif defined(__aarch64__)
+#define MGB_PROFILER_TSC 1
+#else
+#define MGB_PROFILER_TSC 0
+#endif
+
 namespace mgb {
 namespace imperative {
 
@@ -49,8 +63,110 @@ public:
     using Time = profiler::Time;
     static profiler::Time record_host();
     static std::shared_ptr<CompNode::Event> record_device(CompNode device);
+
+    /*!
+     * \brief read a tick counter, which is much cheaper than reading the host
+     * clock
+     *
+     * It is the TSC on x86 if it is invariant, the virtual counter on aarch64,
+     * and the steady clock otherwise. The ticks are converted to host time by
+     * ticks_to_time() with the anchors sampled around them.
+     */
+    static uint64_t record_ticks() {
+#if MGB_PROFILER_TSC
+        if (sm_tsc_available) {
+#if defined(__aarch64__)
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+#else
+            return __rdtsc();
+#endif
+        }
+#endif
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    //! the ticks and the host time sampled at the same moment
+    struct TickAnchor {
+        uint64_t ticks = 0;
+        profiler::HostTime time;
+    };
+
+    static TickAnchor record_anchor();
+
+    //! interpolate the host time of ticks linearly between two anchors
+    static profiler::HostTime ticks_to_time(
+            uint64_t ticks, const TickAnchor& begin, const TickAnchor& end);
+
+private:
+    static const bool sm_tsc_available;
 };
 
+namespace profiler {
+
+/*!
+ * \brief an unbounded queue of a single producer and a single consumer
+ *
+ * The items are stored in chunks, the producer appends to the last chunk
+ * without locks and only allocates when a chunk is full, and the consumer
+ * frees the chunks it has consumed.
+ */
+template <typename T, size_t ChunkSize = 1024>
+class ChunkedSPSCQueue : NonCopyableObj {
+    struct Chunk {
+        std::array<T, ChunkSize> items;
+        std::atomic_size_t size{0};
+        std::atomic<Chunk*> next{nullptr};
+    };
+    //! accessed by the consumer
+    Chunk* m_head;
+    size_t m_head_pos = 0;
+    //! accessed by the producer
+    Chunk* m_tail;
+
+public:
+    ChunkedSPSCQueue() { m_head = m_tail = new Chunk(); }
+
+    ~ChunkedSPSCQueue() {
+        while (m_head) {
+            delete std::exchange(m_head, m_head->next.load());
+        }
+    }
+
+    template <typename... TArgs>
+    void emplace(TArgs&&... args) {
+        size_t size = m_tail->size.load(std::memory_order_relaxed);
+        if (size == ChunkSize) {
+            auto chunk = new Chunk();
+            m_tail->next.store(chunk, std::memory_order_release);
+            m_tail = chunk;
+            size = 0;
+        }
+        m_tail->items[size] = T{std::forward<TArgs>(args)...};
+        m_tail->size.store(size + 1, std::memory_order_release);
+    }
+
+    //! move the items appended so far to the callback
+    template <typename TFunc>
+    void consume(TFunc&& func) {
+        for (;;) {
+            size_t size = m_head->size.load(std::memory_order_acquire);
+            for (; m_head_pos < size; ++m_head_pos) {
+                func(std::move(m_head->items[m_head_pos]));
+            }
+            auto next = m_head->next.load(std::memory_order_acquire);
+            if (size < ChunkSize || !next) {
+                return;
+            }
+            delete std::exchange(m_head, next);
+            m_head_pos = 0;
+        }
+    }
+};
+
+}  // namespace profiler
+
 class AnyPtr {
 public:
     struct Deleter {
@@ -125,8 +241,16 @@ public:
     };
 
 private:
+    //! a record with the ticks not yet converted to host time
+    struct RawRecord {
+        uint64_t id;
+        uint64_t ticks;
+        AnyPtr data;
+    };
+
     std::thread::id m_thread_id;
-    std::vector<Record> m_records;
+    //! appended by the thread of the profiler, and consumed by collect()
+    profiler::ChunkedSPSCQueue<RawRecord> m_records;
     std::atomic<Status> m_status = Running;
     std::unordered_map<std::type_index, AnyPtr> m_mem_pools;
 
@@ -137,8 +261,8 @@ private:
     static std::unordered_map<std::thread::id, std::unique_ptr<Profiler>> sm_profilers;
     static Timer sm_timer;
     static profiler::HostTime sm_start_at;
+    static Timer::TickAnchor sm_start_anchor;
     static std::atomic_uint64_t sm_last_id;
-    static std::atomic_size_t sm_preferred_capacity;
     static bool sm_profiling;
     static constexpr bool sm_debug = false;
     thread_local static Profiler* tm_profiler;
@@ -189,12 +313,12 @@ public:
             mgb_assert(profiler.m_status.compare_exchange_strong(expected, Recording));
         }
         uint64_t id = next_id();
-        profiler::Time time = sm_timer.record_host();
+        uint64_t ticks = sm_timer.record_ticks();
         auto deleter = [](void* obj, void* ptr) {
             reinterpret_cast<MemPool<T>*>(obj)->free(reinterpret_cast<T*>(ptr));
         };
-        profiler.m_records.emplace_back(
-                id, profiler.m_thread_id, time,
+        profiler.m_records.emplace(
+                id, ticks,
                 AnyPtr{mem_pool.alloc(T{std::forward<TArgs>(args)...}),
                        {&mem_pool, deleter}});
         if constexpr (sm_debug) {
@@ -216,15 +340,15 @@ public:
             }
         }
         std::vector<entry_t> profile_data = std::move(sm_records);
+        auto end_anchor = collect_anchor();
         for (auto&& [tid, profiler] : sm_profilers) {
-            sm_preferred_capacity =
-                    std::max(sm_preferred_capacity.load(), profiler->m_records.size());
-            profile_data.insert(
-                    profile_data.end(),
-                    std::make_move_iterator(profiler->m_records.begin()),
-                    std::make_move_iterator(profiler->m_records.end()));
-            profiler->m_records.clear();
-            profiler->m_records.reserve(sm_preferred_capacity);
+            profiler->m_records.consume([&, tid = tid](RawRecord&& record) {
+                profile_data.emplace_back(
+                        record.id, tid,
+                        Timer::ticks_to_time(
+                                record.ticks, sm_start_anchor, end_anchor),
+                        std::move(record.data));
+            });
         }
         std::sort(profile_data.begin(), profile_data.end(), [](auto& lhs, auto& rhs) {
             return lhs.id < rhs.id;
@@ -262,6 +386,7 @@ public:
     static void start_profile() {
         mgb_assert(!sm_profiling);
         sm_start_at = Timer::record_host();
+        sm_start_anchor = Timer::record_anchor();
         sm_profiling = true;
     }
 
@@ -272,6 +397,9 @@ public:
 
     static thread_dict_t get_thread_dict();
 
+    //! the anchor to convert the ticks recorded since start_profile()
+    static Timer::TickAnchor collect_anchor();
+
     static void dump_profile(std::string basename, std::string format, bundle_t result);
 };
 
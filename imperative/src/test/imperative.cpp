@@ -93,6 +93,90 @@ TEST(TestImperative, Split) {
     OprChecker(op).run({TensorShape{100}, s1, s2});
 }
 
+TEST(TestImperative, BlobArena) {
+    auto cn = CompNode::load("cpu0");
+    auto mgr = BlobManager::inst();
+    mgr->set_arena(cn, 2);
+
+    BlobPtr keep;
+    auto run_step = [&](bool keep_first) {
+        std::vector<std::pair<const dt_byte*, size_t>> ranges;
+        auto alloc = [&](size_t size) {
+            auto blob = Blob::make(cn, size);
+            ranges.emplace_back(blob->storage().get(), size);
+            return blob;
+        };
+        auto a = alloc(1024), b = alloc(2048);
+        if (keep_first) {
+            keep = a;
+        }
+        a.reset();
+        auto c = alloc(512);
+        b.reset();
+        c.reset();
+        mgr->mark_step();
+        return ranges;
+    };
+    auto overlap = [](const std::pair<const dt_byte*, size_t>& x,
+                      const std::pair<const dt_byte*, size_t>& y) {
+        return x.first < y.first + y.second && y.first < x.first + x.second;
+    };
+
+    for (int i = 0; i < 2; ++i) {
+        run_step(false);
+    }
+    // served from the planned layout: identical addresses in each step
+    auto r0 = run_step(false), r1 = run_step(false);
+    ASSERT_EQ(r0, r1);
+
+    // the kept blob is still alive and must not be overwritten
+    auto r2 = run_step(true);
+    ASSERT_FALSE(overlap(r2[0], r2[2]));
+    auto r3 = run_step(false);
+    for (auto&& i : r3) {
+        ASSERT_FALSE(overlap(i, r2[0]));
+    }
+    keep.reset();
+
+    // a diverged step falls back to direct allocation
+    {
+        auto x = Blob::make(cn, 4096);
+        ASSERT_NE(nullptr, x->storage().get());
+        mgr->mark_step();
+    }
+    mgr->set_arena(cn, 0);
+}
+
+TEST(TestImperative, OutputAttrsCache) {
+    auto op = OprAttr::make("Elemwise");
+    auto&& attr = op->cast_final_safe<OprAttr>();
+    using Param = opr::Elemwise::Param;
+    Param param{Param::Mode::ADD};
+    attr.param.write_pod(param);
+    auto cn = CompNode::load("xpu0");
+    auto infer = [&](TensorShape lhs, TensorShape rhs) {
+        SmallVector<LogicalTensorDesc> inputs{
+                {{lhs, dtype::Float32()}, cn}, {{rhs, dtype::Float32()}, cn}};
+        auto [outputs, validated] = OpDef::infer_output_attrs_fallible(*op, inputs);
+        EXPECT_TRUE(validated);
+        EXPECT_EQ(1u, outputs.size());
+        EXPECT_EQ(dtype::Float32(), outputs[0].layout.dtype);
+        EXPECT_EQ(cn, outputs[0].comp_node);
+        return outputs[0].layout;
+    };
+    // the second inference of each key is served by the cache
+    for (size_t i = 0; i < 2; ++i) {
+        ASSERT_TRUE(infer({3, 4}, {3, 4}).eq_shape({3, 4}));
+        ASSERT_TRUE(infer({3, 1}, {1, 5}).eq_shape({3, 5}));
+        ASSERT_TRUE(infer({2, 4}, {1}).eq_shape({2, 4}));
+    }
+
+    // shapes are unknown if any input shape is unknown, which is not cached
+    SmallVector<LogicalTensorDesc> inputs{
+            {{{3, 4}, dtype::Float32()}, cn}, {TensorLayout{dtype::Float32()}, cn}};
+    ASSERT_FALSE(std::get<1>(OpDef::infer_output_attrs_fallible(*op, inputs)));
+}
+
 #if MGB_CUDA && MGB_ENABLE_EXCEPTION
 void run_graph(size_t mem_reserved, bool enable_defrag) {
     CompNode::try_coalesce_all_free_memory();
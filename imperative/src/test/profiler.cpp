@@ -14,6 +14,8 @@
 #include "../impl/profiler/events.h"
 #include "megbrain/imperative/profiler.h"
 
+#include <thread>
+
 using namespace mgb;
 using namespace cg;
 using namespace imperative;
@@ -35,3 +37,53 @@ TEST(TestProfiler, ImperativeLogProfile) {
     mgb_assert(results.entries[0].time < results.entries[1].time);
     mgb_assert(results.entries[0].id < results.entries[1].id);
 }
+
+TEST(TestProfiler, RecordFromThreads) {
+    //! more records than a chunk of the record queue on each thread
+    constexpr size_t nr_threads = 4, nr_records = 3000;
+    imperative::Profiler::start_profile();
+    std::vector<std::thread> workers;
+    std::atomic_size_t nr_started{0};
+    for (size_t i = 0; i < nr_threads; ++i) {
+        workers.emplace_back([&nr_started] {
+            //! keep the threads alive together so that their ids are unique
+            ++nr_started;
+            while (nr_started < nr_threads) {
+                std::this_thread::yield();
+            }
+            for (size_t j = 0; j < nr_records; ++j) {
+                MGB_RECORD_EVENT(profiler::CustomEvent, std::to_string(j));
+            }
+        });
+    }
+    std::unordered_map<std::thread::id, size_t> next_title;
+    auto check = [&](const Profiler::bundle_t& results) {
+        //! the records of a collection are sorted by id, and the host time
+        //! converted from the ticks keeps the order of each thread
+        std::unordered_map<std::thread::id, profiler::HostTime> last_time;
+        for (auto&& entry : results.entries) {
+            auto* event = entry.data.as<profiler::CustomEvent>();
+            ASSERT_EQ(std::to_string(next_title[entry.tid]++), event->title);
+            if (last_time.count(entry.tid)) {
+                ASSERT_LE(last_time[entry.tid], entry.time);
+            }
+            last_time[entry.tid] = entry.time;
+        }
+    };
+    //! collect while the threads are recording, the records are released
+    //! after the threads exit as they are allocated from the pools of them
+    auto results0 = imperative::Profiler::collect();
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+    auto results1 = imperative::Profiler::collect();
+    imperative::Profiler::stop_profile();
+    check(results0);
+    check(results1);
+
+    ASSERT_EQ(nr_threads, next_title.size());
+    for (auto&& [tid, nr] : next_title) {
+        MGB_MARK_USED_VAR(tid);
+        ASSERT_EQ(nr_records, nr);
+    }
+}
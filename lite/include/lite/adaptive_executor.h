@@ -0,0 +1,127 @@
+/**
+ * \file inlude/lite/adaptive_executor.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "macro.h"
+#include "network.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lite {
+
+/*!
+ * \brief the options of AdaptiveExecutor
+ *
+ * \param nr_cores the number of cpu cores shared by all the modes
+ *
+ * \param nr_instances_of_modes the number of network instances of each mode,
+ * each of which should divide nr_cores; an instance of a mode with k
+ * instances runs with nr_cores / k threads. It is {1, nr_cores} if empty,
+ * that is one network of nr_cores threads or nr_cores single-threaded ones
+ *
+ * \param max_in_flight the max number of queued and running requests,
+ * forward_async() blocks when it is reached
+ *
+ * \param decision_interval_ms the min interval to reconsider the mode, which
+ * is done when a request finishes
+ *
+ * \param switch_threshold the min relative reduction of the estimated
+ * latency to switch the mode, to avoid switching back and forth on noise
+ *
+ * \param core_affinity called in each thread of each instance with the core
+ * id in [0, nr_cores) it should be bound to; the instances of a mode use
+ * disjoint cores, so the threads of every mode can be bound to the same cores
+ */
+struct LITE_API AdaptiveOptions {
+    size_t nr_cores = 4;
+    std::vector<size_t> nr_instances_of_modes;
+    size_t max_in_flight = 16;
+    size_t decision_interval_ms = 100;
+    float switch_threshold = 0.1f;
+    std::function<void(size_t core_id)> core_affinity;
+};
+
+/*!
+ * \brief forward the requests of a model on the cpu cores split either by
+ * intra-op parallelism or by requests, depending on the load
+ *
+ * The instances of all the modes are loaded at construction and share the
+ * weights, so a switch of the mode only changes which instances take the
+ * requests: the requests are only run by the instances of the active mode,
+ * and a new mode starts after the running requests of the previous one
+ * finish, so the modes never run on the cores at the same time. Note that the
+ * runtime memory is not shared among the instances.
+ *
+ * The service time of each mode is measured, and the unmeasured modes are
+ * assumed to scale linearly with the number of threads. Every
+ * decision_interval_ms the mode of the lowest estimated latency under the
+ * recent arrival rate is chosen, where each instance is treated as a queue of
+ * its own; the arrival rate is raised to the capacity of the active mode if
+ * requests had to wait in the queue, and the modes that could not keep up
+ * are ranked by throughput.
+ *
+ * The inputs of a request are snapshotted when it is queued as in
+ * AsyncExecutor. Only available on CPU.
+ */
+class LITE_API AdaptiveExecutor {
+public:
+    //! called with the outputs of a request, or an empty map if the request
+    //! is failed
+    using Callback = std::function<void(const IOBindings& outputs)>;
+
+    struct ModeStats {
+        size_t nr_instances;
+        size_t nr_threads;
+        size_t nr_requests;
+        //! the moving average of the time to run a request in milliseconds,
+        //! 0 if the mode has not run any request
+        double service_ms;
+    };
+
+    struct Stats {
+        //! the index of the active mode in nr_instances_of_modes
+        size_t mode;
+        size_t nr_switches;
+        //! the requests per second in the last decision interval
+        double arrival_rate;
+        std::vector<ModeStats> modes;
+    };
+
+    AdaptiveExecutor(
+            std::string model_path, const AdaptiveOptions& options,
+            const Config& config = {}, const NetworkIO& network_io = {});
+
+    //! wait for the requests in flight and stop the threads
+    ~AdaptiveExecutor();
+
+    AdaptiveExecutor(const AdaptiveExecutor&) = delete;
+    AdaptiveExecutor& operator=(const AdaptiveExecutor&) = delete;
+
+    //! queue a request with the inputs of the given names, the callback is
+    //! run in the worker thread after the future is set
+    std::future<IOBindings> forward_async(
+            const IOBindings& inputs, Callback callback = {});
+
+    Stats get_stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
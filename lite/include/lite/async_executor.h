@@ -0,0 +1,90 @@
+/**
+ * \file inlude/lite/async_executor.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "macro.h"
+#include "network.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace lite {
+
+/*!
+ * \brief the options of AsyncExecutor
+ *
+ * \param max_in_flight the max number of queued and running requests,
+ * forward_async() blocks when it is reached; it should be no less than the
+ * number of networks of the executor to keep all of them busy
+ *
+ * \param nr_callback_threads the number of threads to run the callbacks, the
+ * callbacks are run in the order of completion if it is 1
+ */
+struct LITE_API AsyncOptions {
+    size_t max_in_flight = 4;
+    size_t nr_callback_threads = 1;
+};
+
+/*!
+ * \brief forward a network asynchronously with several requests in flight
+ *
+ * The inputs of a request are snapshotted when it is queued, so the caller
+ * can refill them at once. The requests are run one by one by the worker
+ * thread of a network with the snapshots bound to its inputs, and the outputs are
+ * copied out for each request. The networks must not be used by the caller
+ * any more after the executor is created.
+ */
+class LITE_API AsyncExecutor {
+public:
+    //! called with the outputs of a request, or an empty map if the request
+    //! is failed
+    using Callback = std::function<void(const IOBindings& outputs)>;
+
+    AsyncExecutor(std::shared_ptr<Network> network, const AsyncOptions& options = {});
+
+    /*!
+     * \brief run the requests on several networks loaded from one model, such
+     * as the instances of a NetworkPool
+     *
+     * Each network has a worker thread of its own, so consecutive requests are
+     * pipelined over the networks. For a model spanning the CPU and a device,
+     * the CPU stages of a request run while the device stage of the previous
+     * one is in flight, as the comp nodes of a graph are dispatched on
+     * separate threads (see Options::async_exec_level). The requests may
+     * finish out of order.
+     */
+    AsyncExecutor(
+            std::vector<std::shared_ptr<Network>> networks,
+            const AsyncOptions& options = {});
+
+    //! wait for the requests in flight and stop the threads
+    ~AsyncExecutor();
+
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    //! queue a request with the inputs of the given names, the future is set
+    //! with the outputs before the callback is dispatched to the callback
+    //! threads
+    std::future<IOBindings> forward_async(
+            const IOBindings& inputs, Callback callback = {});
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,93 @@
+/**
+ * \file inlude/lite/batching.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "macro.h"
+#include "network.h"
+#include "tensor.h"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lite {
+
+/*!
+ * \brief the options of BatchingExecutor
+ *
+ * \param max_batch_size the max number of requests which are run in one
+ * forward
+ *
+ * \param max_delay_us the max time in microseconds a request waits for other
+ * requests to fill the batch, the batch is run when it is full or the first
+ * request of it has waited for max_delay_us
+ */
+struct LITE_API BatchingOptions {
+    size_t max_batch_size = 8;
+    size_t max_delay_us = 1000;
+};
+
+/*!
+ * \brief serve the requests from many threads by a group of networks, the
+ * requests are combined into batches along the first dim of the inputs
+ *
+ * Every network is driven by a worker thread of its own, so the networks
+ * should be loaded with the same model, e.g. clones made by
+ * Runtime::shared_weight_with_network. The networks must not be used by the
+ * caller any more after the executor is created.
+ *
+ * A request is a map from the input name to the input tensor of it, all the
+ * inputs of the network should be given and the first dim of them is the
+ * number of samples of the request, which is 1 for a single sample. The other
+ * dims, the data type and the device must be the same in a batch, otherwise
+ * the batch is failed. The samples are copied into the input tensors of the
+ * network directly, and the outputs of a batch are copied out once, then the
+ * result of each request is a slice of them, so the result tensors share the
+ * memory of their batch and are not continue if a dim other than the first is
+ * sliced.
+ */
+class LITE_API BatchingExecutor {
+public:
+    using TensorMap = std::unordered_map<std::string, std::shared_ptr<Tensor>>;
+
+    BatchingExecutor(
+            std::vector<std::shared_ptr<Network>> networks,
+            const BatchingOptions& options = {});
+
+    //! wait for the pending requests and stop the worker threads
+    ~BatchingExecutor();
+
+    BatchingExecutor(const BatchingExecutor&) = delete;
+    BatchingExecutor& operator=(const BatchingExecutor&) = delete;
+
+    //! submit a request, the future is set with the map from the output name
+    //! to the output tensor of the request, or the exception if the batch of
+    //! it is failed
+    std::future<TensorMap> submit(TensorMap inputs);
+
+    //! submit a request and wait for the outputs of it
+    TensorMap run(TensorMap inputs);
+
+    const BatchingOptions& options() const { return m_options; }
+
+private:
+    class Impl;
+
+    BatchingOptions m_options;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
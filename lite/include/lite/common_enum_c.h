@@ -95,5 +95,15 @@ typedef enum {
     LITE_ALGO_OPTIMIZED = 1 << 3,
 } LiteAlgoSelectStrategy;
 
+/*!
+ * \brief the priority of the tasks of a network on the CPU thread pool shared
+ * by several networks, the tasks of a higher priority are run first
+ */
+typedef enum {
+    LITE_TASK_PRIORITY_LOW = 0,
+    LITE_TASK_PRIORITY_NORMAL = 1,
+    LITE_TASK_PRIORITY_HIGH = 2,
+} LiteTaskPriority;
+
 #endif
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
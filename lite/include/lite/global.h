@@ -16,6 +16,7 @@
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace lite {
@@ -120,10 +121,48 @@ LITE_API LiteLogLevel get_log_level();
  */
 LITE_API size_t get_device_count(LiteDeviceType device_type);
 
+/*!
+ * \brief get the ids of the cpu cores grouped by their max frequency, the
+ * fastest group first
+ *
+ * On big.LITTLE SoCs the first group holds the big cores, which can be passed
+ * to Runtime::set_runtime_thread_affinity so the threads of the network are
+ * not held back by the little cores. All the cores are in one group if the
+ * frequency is unavailable.
+ */
+LITE_API std::vector<std::vector<int>> get_cpu_core_classes();
+
 /*! \brief try to coalesce all free memory in megenine
  */
 LITE_API void try_coalesce_all_free_memory();
 
+/*!
+ * \brief share one CPU thread pool of nr_threads threads between all the
+ * networks in multi thread mode loaded afterwards, whatever their number of
+ * threads is, so several networks running at the same time would not
+ * oversubscribe the cores; 0 to give each network its own threads again
+ *
+ * \see Runtime::set_runtime_thread_priority
+ */
+LITE_API void set_cpu_shared_thread_pool(size_t nr_threads);
+
+/*!
+ * \brief back the memory of the CPU networks loaded afterwards with huge
+ * pages of page_size, 2MB or 1GB, to reduce TLB misses; 0 to disable
+ *
+ * The allocations not smaller than 1MB, like the static memory, the
+ * workspaces and the weights, are mapped on explicit huge pages from
+ * hugetlbfs, or transparent huge pages if the pool is exhausted. Only
+ * available on linux.
+ */
+LITE_API void set_cpu_huge_page_size(size_t page_size);
+
+/*!
+ * \brief get the number of bytes mapped by set_cpu_huge_page_size() and the
+ * number of bytes of them actually backed by huge pages
+ */
+LITE_API std::pair<size_t, size_t> get_cpu_huge_page_coverage();
+
 /*!
  * \brief Set the loader to the lite
  * \param loader_path is the file path which store the cache
@@ -132,7 +171,10 @@ LITE_API void set_loader_lib_path(const std::string& loader_path);
 
 /*!
  * \brief Set the algo policy cache file for CPU/CUDA ...
- * \param cache_path is the file path which store the cache
+ * \param cache_path is the file path which store the cache; if it is a
+ * directory, which may be shared by multiple machines, the cache file of the
+ * current build in the directory is used. Cache dumped by a different build is
+ * discarded.
  * \param always_sync sync the cache when model run
  */
 LITE_API void set_persistent_cache(
@@ -140,7 +182,9 @@ LITE_API void set_persistent_cache(
 
 /*!
  * \brief dump the PersistentCache policy cache to file, if the network is set
- * to profile when forward, though this the algo policy will dump to file
+ * to profile when forward, though this the algo policy will dump to file. The
+ * cache is merged with the existing file, which may be updated by other
+ * processes concurrently.
  */
 LITE_API void dump_persistent_cache(const std::string& cache_path);
 
@@ -154,6 +198,18 @@ LITE_API void set_tensor_rt_cache(std::string tensorrt_cache_path);
  */
 LITE_API void dump_tensor_rt_cache();
 
+/*!
+ * \brief set the samples to calibrate the float TensorRT subgraphs to int8
+ *
+ * Each sample maps the names of the network inputs to cpu tensors. The
+ * subgraphs whose inputs are the network inputs with the same shapes are
+ * built in int8 with an entropy calibrator on the samples. Quantized models
+ * need no samples. Pass an empty vector to disable calibration.
+ */
+LITE_API void set_tensor_rt_int8_calibration(
+        const std::vector<std::unordered_map<std::string, std::shared_ptr<Tensor>>>&
+                samples);
+
 }  // namespace lite
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,108 @@
+/**
+ * \file inlude/lite/multi_device_network.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "macro.h"
+#include "network.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lite {
+
+/*!
+ * \brief the options of MultiDeviceNetwork
+ *
+ * \param device_ids the devices to replicate the model on, all the devices of
+ * the device type in the config if empty
+ *
+ * \param max_queue_depth the max number of queued and running requests of a
+ * device, forward() blocks when all the devices reach it
+ *
+ * \param share_fast_run_cache run the first request on the first device
+ * alone, so the algos it profiles are in the persistent cache before the
+ * other devices start, see set_persistent_cache(). It only saves profiling
+ * with a profiling algo policy and devices of the same model, as the profiled
+ * algos are cached by the device model.
+ */
+struct LITE_API MultiDeviceOptions {
+    std::vector<int> device_ids;
+    size_t max_queue_depth = 4;
+    bool share_fast_run_cache = true;
+};
+
+/*!
+ * \brief a model replicated on several devices, with the requests routed to
+ * the least loaded device
+ *
+ * The model file is read into host memory once, and the replicas are loaded
+ * from it in parallel, each copying the weights to its own device.
+ *
+ * A request is routed to the device of the shortest queue when it is
+ * forwarded; once every device has finished a request, the queue depth is
+ * weighted by the measured service time of the device, so slower devices get
+ * fewer requests. Each device runs its requests one by one in a worker
+ * thread. The inputs of a request are snapshotted when it is queued as in
+ * AsyncExecutor, and the requests may finish out of order.
+ */
+class LITE_API MultiDeviceNetwork {
+public:
+    //! called with the outputs of a request, or an empty map if the request
+    //! is failed
+    using Callback = std::function<void(const IOBindings& outputs)>;
+
+    struct DeviceStats {
+        int device_id;
+        size_t nr_requests;
+        //! the number of queued and running requests
+        size_t queue_depth;
+        //! the moving average of the time to run a request in milliseconds,
+        //! 0 if the device has not run any request
+        double service_ms;
+    };
+
+    MultiDeviceNetwork(
+            std::string model_path, const MultiDeviceOptions& options = {},
+            const Config& config = {}, const NetworkIO& network_io = {});
+
+    //! wait for the requests in flight and stop the threads
+    ~MultiDeviceNetwork();
+
+    MultiDeviceNetwork(const MultiDeviceNetwork&) = delete;
+    MultiDeviceNetwork& operator=(const MultiDeviceNetwork&) = delete;
+
+    //! route a request with the inputs of the given names to a device, the
+    //! callback is run in the worker thread after the future is set
+    std::future<IOBindings> forward(const IOBindings& inputs, Callback callback = {});
+
+    //! wait until all the requests forwarded are finished
+    void wait();
+
+    size_t nr_devices() const;
+
+    //! get the replica on a device, which can be used to configure it before
+    //! serving, such as the algo policy
+    const std::shared_ptr<Network>& get_network(size_t idx) const;
+
+    std::vector<DeviceStats> get_stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -19,6 +19,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace lite {
 
@@ -69,6 +70,16 @@ LITE_API inline LiteAlgoSelectStrategy operator|(
  * level = 1 means use record inference,
  * level = 2 means record inference with free the extra memory
  *
+ * \param comp_node_seq_record_cache_size max number of record level 1
+ * sequences kept for previous input shapes, so changing between these shapes
+ * would still replay the recorded tasks; 0 means the tasks are recorded again
+ * whenever the input shapes change
+ *
+ * \param weight_preprocess_cache with weight_preprocess on CPU, look up the
+ * preprocessed weights in the persistent cache set by set_persistent_cache()
+ * and put the newly preprocessed ones there, so they are saved by
+ * dump_persistent_cache() and later loads only copy them
+ *
  * \param graph_opt_level optimization level:
  * 0: disable
  * 1: level-1: inplace arith transformations during graph
@@ -107,6 +118,9 @@ struct LITE_API Options {
     bool enable_nchw4 = false;
     bool enable_nchw32 = false;
     bool enable_nchw64 = false;
+
+    uint32_t comp_node_seq_record_cache_size = 0;
+    bool weight_preprocess_cache = false;
 };
 
 /*!
@@ -198,6 +212,34 @@ using FinishCallback =
         std::function<void(const std::unordered_map<
                            std::string, std::pair<IO, std::shared_ptr<Tensor>>>&)>;
 
+/*!
+ * \brief map from the io tensor name to the user tensor bound to it, see
+ * Network::forward(const IOBindings&)
+ */
+using IOBindings = std::unordered_map<std::string, std::shared_ptr<Tensor>>;
+
+/*!
+ * \brief the time in milliseconds spent to get a network ready, see
+ * Network::prepare()
+ *
+ * \param parse_ms parse the model and load the weights
+ *
+ * \param compile_ms optimize and compile the graph
+ *
+ * \param mem_plan_ms for each shape, plan the static memory, which includes
+ * the algorithm selection (fastrun profiling or heuristic) as the workspace
+ * of the oprs is inferred in it
+ *
+ * \param first_run_ms for each shape, the first run after the memory is
+ * planed, which includes the weight preprocess
+ */
+struct LITE_API PrepareTiming {
+    double parse_ms = 0;
+    double compile_ms = 0;
+    std::vector<double> mem_plan_ms;
+    std::vector<double> first_run_ms;
+};
+
 /*!
  * \brief The network is construct form a model, implement model load, init,
  * forward, and display some model information
@@ -250,9 +292,50 @@ public:
     //! to the output tensor
     void forward();
 
+    //! bind the io tensors to the memory of the user tensors and forward, so
+    //! the inputs are read from and the outputs are written to the user memory
+    //! directly, and the graph is not compiled again when the memory changes.
+    //! The bindings are kept until they are bound again, and the user memory
+    //! must be valid until wait() returns. The device of a user tensor must be
+    //! the same with the io tensor, and a host output of a network not on CPU
+    //! must be bound to a pinned host tensor of the device.
+    void forward(const IOBindings& bindings);
+
     //! waite until forward finish in sync model
     void wait();
 
+    //! get the network ready for each set of input layouts in shapes_list, so
+    //! the first requests of these shapes do not pay for the memory plan, the
+    //! algorithm selection and the weight preprocess. The network is run once
+    //! for each set on zero inputs, and the layouts of the last set are kept.
+    //! It returns the time of each phase, with the time of load_model.
+    PrepareTiming prepare(
+            const std::vector<std::unordered_map<std::string, Layout>>& shapes_list);
+
+    /*!
+     * \brief load a new model and switch to it between two requests
+     *
+     * The new model is loaded with the config and io of this network, on the
+     * same device and stream with the same cpu threads, and it is prepared for
+     * shapes_list like prepare(). All of these are done in the calling thread,
+     * so the requests can go on in another thread meanwhile. The network
+     * switches to the new model at the start of the next forward(), and the
+     * old model is released after that request is dispatched. The callbacks
+     * of this network are kept, while the other Runtime settings are not.
+     *
+     * The io tensors of the old model are not updated any more after the
+     * switch, so they should be got again unless the io is bound by
+     * forward(const IOBindings&). The algorithms profiled for the old model
+     * are reused through the persistent cache if the shapes match. The runtime
+     * memory is not shared, since both models run during the warm-up.
+     *
+     * \return the time to get the new model ready
+     */
+    PrepareTiming hot_swap(
+            std::string model_path,
+            const std::vector<std::unordered_map<std::string, Layout>>& shapes_list =
+                    {});
+
     //! get the input tensor name in the order in load return
     std::string get_input_name(size_t index) const;
 
@@ -292,12 +375,23 @@ private:
     //! decrypt and parse the model file
     void prase_model(std::shared_ptr<void> model_data, size_t size);
 
+    //! switch to the network staged by hot_swap(), return the old implement
+    std::unique_ptr<NetworkImplBase> switch_to_swapped();
+
 private:
     bool m_loaded = false;
     Config m_config;
     NetworkIO m_network_io;
     std::unique_ptr<NetworkImplBase> m_impl;
     std::string m_extra_info;
+
+    //! the callbacks are kept to be set to the network of hot_swap()
+    AsyncCallback m_async_callback;
+    StartCallback m_start_callback;
+    FinishCallback m_finish_callback;
+
+    std::mutex m_swap_mtx;
+    std::unique_ptr<Network> m_swapped_network;
 };
 
 /*********************** MGE special network function ***************/
@@ -314,6 +408,19 @@ public:
             std::shared_ptr<Network> network,
             const ThreadAffinityCallback& thread_affinity_callback);
 
+    //! set how the idle threads wait for new tasks in multi thread mode: spin
+    //! nr_spin rounds, then yield nr_yield rounds, and then sleep until new
+    //! task comes. A large spin gets low latency while small spin saves power
+    static void set_runtime_thread_wait_policy(
+            std::shared_ptr<Network> network, size_t nr_spin, size_t nr_yield);
+
+    //! set the priority of the tasks of the network in multi thread mode,
+    //! which decides the order to run them with the tasks of other networks
+    //! on the thread pool shared by set_cpu_shared_thread_pool(); the networks
+    //! with the same device id and number of threads share the priority
+    static void set_runtime_thread_priority(
+            std::shared_ptr<Network> network, LiteTaskPriority priority);
+
     //! Set cpu default mode when device is CPU, in some low computation
     //! device or single core device, this mode will get good performace
     static void set_cpu_inplace_mode(std::shared_ptr<Network> dst_network);
@@ -330,15 +437,36 @@ public:
     //! binary_equal_between_batch: if the content of each input batch is binary
     //!                             equal,whether the content of each output
     //!                             batch is promised to be equal
+    //! shape_bucket_size: non-zero value means that each dim of the layouts
+    //!                    is rounded up to a multiple of this value before
+    //!                    looking up the fastrun cache, so layouts in the same
+    //!                    bucket are profiled only once
+    //! background_profiling: if the layouts of an operator are not in the
+    //!                       fastrun cache, use the heuristic algorithm and
+    //!                       profile in background to fill the cache
     static void set_network_algo_policy(
             std::shared_ptr<Network> dst_network, LiteAlgoSelectStrategy strategy,
-            uint32_t shared_batch_size = 0, bool binary_equal_between_batch = false);
+            uint32_t shared_batch_size = 0, bool binary_equal_between_batch = false,
+            uint32_t shape_bucket_size = 0, bool background_profiling = false);
 
     //! set workspace_limit for oprs with multiple algorithms, set
     //! workspace limitation can save memory but may influence the performance
     static void set_network_algo_workspace_limit(
             std::shared_ptr<Network> dst_network, size_t workspace_limit);
 
+    //! set the memory budget in bytes of the network before the model is
+    //! loaded, the algorithms of the oprs are chosen with workspace within the
+    //! budget, and if the static memory plan still exceeds the budget, some
+    //! activations are dropped and recomputed when they are needed again; the
+    //! weights are not included in the budget
+    static void set_network_memory_budget(
+            std::shared_ptr<Network> dst_network, size_t memory_budget);
+
+    //! get the size in bytes of the static memory allocated by the network for
+    //! the activations and workspaces, which is the peak memory of the last
+    //! forward except the weights and dynamic memory
+    static size_t get_network_memory_peak(std::shared_ptr<Network> dst_network);
+
     //! set the network memroy allocator, the allocator is defined by user
     static void set_memory_allocator(
             std::shared_ptr<Network> dst_network,
@@ -358,10 +486,41 @@ public:
     static void enable_io_bin_dump(
             std::shared_ptr<Network> dst_network, std::string io_bin_out_dir);
 
+    //! profile the network and write the achieved GFLOP/s and GB/s of each
+    //! opr to report_file in JSON format after each forward, ranked by the
+    //! percent of the roofline of its device; device_spec_file gives the peak
+    //! performance of the devices, each line of which is
+    //! "<comp node prefix> <peak GFLOP/s> <peak GB/s>", such as "gpu0 14000
+    //! 900", the percents are omitted without it
+    static void enable_roofline_report(
+            std::shared_ptr<Network> dst_network, std::string report_file,
+            std::string device_spec_file = {});
+
+    //! enable the low-overhead sampling profiler before the model is loaded,
+    //! which records the kernel time of the oprs in one of sample_interval
+    //! forwards, and of one of nr_opr_slices slices of the oprs in turn
+    static void enable_sampling_profiler(
+            std::shared_ptr<Network> dst_network, size_t sample_interval,
+            size_t nr_opr_slices = 1);
+
+    //! get the aggregates of the sampling profiler in JSON format, which are
+    //! the count, total and max time and the log2 histogram in microseconds
+    //! per (opr type, input shapes); the aggregates are cleared if reset
+    static std::string get_sampling_profile(
+            std::shared_ptr<Network> dst_network, bool reset = false);
+
     //! load a new network which will share weights with src network
     static void shared_weight_with_network(
             std::shared_ptr<Network> dst_network,
             const std::shared_ptr<Network> src_network);
+
+    //! share params with identical values between networks loaded from
+    //! different models (e.g. fine-tuned models with a common backbone); it
+    //! must be called before both networks are loaded, and only params of
+    //! models dumped with tensor value deduplication are shared
+    static void shared_weight_by_value_with_network(
+            std::shared_ptr<Network> dst_network,
+            const std::shared_ptr<Network> src_network);
 };
 
 }  // namespace lite
@@ -0,0 +1,135 @@
+/**
+ * \file inlude/lite/network_pool.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "macro.h"
+#include "network.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lite {
+
+/*!
+ * \brief the options of NetworkPool
+ *
+ * \param nr_instances the number of network instances in the pool
+ *
+ * \param nr_threads the number of cpu threads of each instance, only used
+ * when the device is CPU
+ *
+ * \param thread_affinity called in each thread of each instance with the
+ * instance id and the thread id, which can be used to bind the threads of an
+ * instance to its own core group
+ */
+struct LITE_API NetworkPoolOptions {
+    size_t nr_instances = 1;
+    size_t nr_threads = 1;
+    std::function<void(size_t instance_id, int thread_id)> thread_affinity;
+};
+
+/*!
+ * \brief a pool of network instances loaded from one model, all of which
+ * share the weights of the first one
+ *
+ * Each instance runs on a comp node of its own, which is a different device
+ * id on CPU and a different stream on the other devices, so the instances can
+ * forward concurrently. The runtime memory is not shared since the instances
+ * run at the same time.
+ *
+ * The instances are handed out by acquire() without lock, and an instance is
+ * returned to the pool when the handle is destructed. The pool must outlive
+ * all of its handles.
+ */
+class LITE_API NetworkPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! the exclusive access to an instance of the pool
+    class LITE_API Handle {
+    public:
+        Handle() = default;
+        Handle(Handle&& rhs);
+        Handle& operator=(Handle&& rhs);
+        ~Handle() { release(); }
+
+        bool valid() const { return m_pool; }
+        explicit operator bool() const { return valid(); }
+
+        Network* operator->() const { return network().get(); }
+        Network& operator*() const { return *network(); }
+        const std::shared_ptr<Network>& network() const;
+
+        size_t instance_id() const { return m_instance_id; }
+
+        //! return the instance to the pool, the handle becomes invalid
+        void release();
+
+    private:
+        friend class NetworkPool;
+        Handle(NetworkPool* pool, size_t instance_id);
+
+        NetworkPool* m_pool = nullptr;
+        size_t m_instance_id = 0;
+        Clock::time_point m_acquire_time;
+    };
+
+    //! the usage of an instance since the pool is created
+    struct InstanceStats {
+        size_t nr_acquired;
+        //! the total time in milliseconds the instance is held by callers
+        double busy_ms;
+        //! busy_ms divided by the lifetime of the pool
+        double utilization;
+    };
+
+    NetworkPool(
+            std::string model_path, const NetworkPoolOptions& options,
+            const Config& config = {}, const NetworkIO& network_io = {});
+
+    ~NetworkPool();
+
+    NetworkPool(const NetworkPool&) = delete;
+    NetworkPool& operator=(const NetworkPool&) = delete;
+
+    //! get an idle instance, the handle is invalid if all instances are busy
+    Handle try_acquire();
+
+    //! get an idle instance, wait until one is returned if all are busy
+    Handle acquire();
+
+    size_t nr_instances() const { return m_nr_instances; }
+
+    //! get the network of an instance, which can be used to configure it
+    //! before serving
+    const std::shared_ptr<Network>& get_instance(size_t instance_id) const;
+
+    std::vector<InstanceStats> get_stats() const;
+
+private:
+    struct Instance;
+
+    void release(size_t instance_id, Clock::time_point acquire_time);
+
+    size_t m_nr_instances;
+    std::unique_ptr<Instance[]> m_instances;
+    std::atomic_size_t m_next{0};
+    Clock::time_point m_create_time;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
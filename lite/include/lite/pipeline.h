@@ -0,0 +1,82 @@
+/**
+ * \file inlude/lite/pipeline.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "macro.h"
+#include "network.h"
+
+#include <memory>
+
+namespace lite {
+
+/*!
+ * \brief run the requests of a device network in a pipeline, so the input
+ * copies of the next request and the output copies of the previous request
+ * overlap with the compute of the current one
+ *
+ * The inputs are copied to the device on a stream of its own and the outputs
+ * are copied back on another one, which are sequenced with the compute stream
+ * of the network by events. The device buffers of the io are kept for
+ * nr_buffers requests in flight, so the graph is not compiled again when the
+ * buffers are switched.
+ *
+ * The network must be loaded on a device other than CPU, with all of its
+ * inputs and outputs configured with is_host = false. The network must not be
+ * used by the caller any more after the executor is created, and the executor
+ * should be used by one thread.
+ *
+ * \param nr_buffers the max number of requests in flight, 2 for double
+ * buffering and 3 for triple buffering
+ *
+ * \param h2d_stream_id the stream used to copy the inputs, -1 for the stream
+ * next to the stream of the network
+ *
+ * \param d2h_stream_id the stream used to copy the outputs, -1 for the stream
+ * next to h2d_stream_id
+ */
+class LITE_API PipelinedExecutor {
+public:
+    PipelinedExecutor(
+            std::shared_ptr<Network> network, size_t nr_buffers = 2,
+            int h2d_stream_id = -1, int d2h_stream_id = -1);
+
+    //! wait for all the requests in flight
+    ~PipelinedExecutor();
+
+    PipelinedExecutor(const PipelinedExecutor&) = delete;
+    PipelinedExecutor& operator=(const PipelinedExecutor&) = delete;
+
+    /*!
+     * \brief copy the host inputs to the device, forward, and copy the outputs
+     * to the host outputs, all asynchronously
+     *
+     * If all the buffers are in flight, it waits for the oldest request first.
+     * The host tensors must be valid until the request is done, and they
+     * should be pinned host tensors of the device so the copies are really
+     * asynchronous; the host outputs must be pinned. The empty host outputs
+     * are resized to the outputs of the network.
+     *
+     * \return the ticket of the request, which is passed to wait()
+     */
+    size_t submit(const IOBindings& host_inputs, const IOBindings& host_outputs);
+
+    //! wait until the outputs of a request are copied to the host
+    void wait(size_t ticket);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
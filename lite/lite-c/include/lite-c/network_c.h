@@ -59,6 +59,16 @@ extern "C" {
  * level = 1 means use record inference,
  * level = 2 means record inference with free the extra memory
  *
+ * \param comp_node_seq_record_cache_size max number of record level 1
+ * sequences kept for previous input shapes, so changing between these shapes
+ * would still replay the recorded tasks; 0 means the tasks are recorded again
+ * whenever the input shapes change
+ *
+ * \param weight_preprocess_cache with weight_preprocess on CPU, look up the
+ * preprocessed weights in the persistent cache set by set_persistent_cache()
+ * and put the newly preprocessed ones there, so they are saved by
+ * dump_persistent_cache() and later loads only copy them
+ *
  * \param graph_opt_level optimization level:
  * 0: disable
  * 1: level-1: inplace arith transformations during graph
@@ -97,6 +107,9 @@ typedef struct Options {
     int enable_nchw4;
     int enable_nchw32;
     int enable_nchw64;
+
+    int comp_node_seq_record_cache_size;
+    int weight_preprocess_cache;
 } LiteOptions;
 
 //! define a default Options
@@ -265,6 +278,20 @@ LITE_API int LITE_destroy_network(LiteNetwork network);
  */
 LITE_API int LITE_forward(const LiteNetwork network);
 
+/**
+ * \brief bind the io tensors of the given names to the memory of the user
+ * tensors and forward, so the inputs are read from and the outputs are written
+ * to the user memory directly without copy, the bindings are kept until they
+ * are bound again, and the user memory must be valid until LITE_wait returns
+ * \param[in] network The loaded model
+ * \param[in] size The number of the bindings
+ * \param[in] io_names The input or output names of the bindings
+ * \param[in] tensors The user tensors bound to the io of the same index
+ */
+LITE_API int LITE_forward_with_bindings(
+        const LiteNetwork network, size_t size, const char* const* io_names,
+        const LiteTensor* tensors);
+
 /**
  * \brief waite until forward finish in sync model
  * \param[in] network The loaded model
@@ -283,6 +310,19 @@ LITE_API int LITE_get_io_tensor(
         LiteNetwork network, const char* io_name, LiteTensorPhase phase,
         LiteTensor* tensor);
 
+/**
+ * \brief get several input and output tensors of the network in one call
+ * \param[in] network The loaded model
+ * \param[in] size The number of the tensors
+ * \param[in] io_names The input or output names
+ * \param[in] phase The tensor phase of all the names
+ * \param[out] tensors The IO tensors of the names in the same order, which
+ * should have space of size tensors
+ */
+LITE_API int LITE_get_io_tensors(
+        LiteNetwork network, size_t size, const char* const* io_names,
+        LiteTensorPhase phase, LiteTensor* tensors);
+
 /**
  * \brief get the input tensor name in the order in loaded model
  * \param[in] network The loaded model
@@ -432,6 +472,23 @@ LITE_API int LITE_set_network_algo_fastrun_config(
 LITE_API int LITE_set_network_algo_workspace_limit(
         LiteNetwork network, size_t workspace_limit);
 
+/**
+ * \brief set the memory budget of the network before the model is loaded, the
+ * algorithms are chosen within the budget and the activations are recomputed
+ * when the static memory plan exceeds it
+ * \param[in] network The network not loaded
+ * \param[in] memory_budget The memory budget in bytes, except the weights
+ */
+LITE_API int LITE_set_network_memory_budget(LiteNetwork network, size_t memory_budget);
+
+/**
+ * \brief get the size of the static memory allocated for the activations and
+ * workspaces of the network
+ * \param[in] network The loaded model
+ * \param[out] memory_peak The memory size in bytes
+ */
+LITE_API int LITE_get_network_memory_peak(LiteNetwork network, size_t* memory_peak);
+
 /**
  * \brief set the network forward in async mode and set the async callback
  * function
@@ -471,6 +528,15 @@ LITE_API int LITE_set_finish_callback(
 LITE_API int LITE_set_runtime_thread_affinity(
         LiteNetwork network, const LiteThreadAffinityCallback thread_affinity_callback);
 
+/**
+ * \brief set how the idle threads wait for new tasks in multi thread mode
+ * \param[in] network The loaded model
+ * \param[in] nr_spin The busy-spin rounds before yield
+ * \param[in] nr_yield The yield rounds before sleep
+ */
+LITE_API int LITE_set_runtime_thread_wait_policy(
+        LiteNetwork network, size_t nr_spin, size_t nr_yield);
+
 /**
  * \brief set the network memroy allocator, the allocator is defined by user
  * \param[in] network The loaded model
@@ -512,6 +578,38 @@ LITE_API int LITE_enable_io_txt_dump(LiteNetwork network, const char* io_txt_out
  */
 LITE_API int LITE_enable_io_bin_dump(LiteNetwork network, const char* io_bin_out_dir);
 
+/**
+ * \brief Write the achieved GFLOP/s and GB/s of each opr to a JSON file after
+ * each forward, ranked by the percent of the roofline of its device
+ * \param[in] network The network
+ * \param[in] report_file The report file name
+ * \param[in] device_spec_file The peak performance of the devices, each line
+ * of which is "<comp node prefix> <peak GFLOP/s> <peak GB/s>", it can be NULL
+ */
+LITE_API int LITE_enable_roofline_report(
+        LiteNetwork network, const char* report_file, const char* device_spec_file);
+
+/**
+ * \brief Enable the low-overhead sampling profiler before the model is loaded
+ * \param[in] network The network to be loaded
+ * \param[in] sample_interval One of sample_interval forwards is sampled
+ * \param[in] nr_opr_slices The oprs are recorded by one of nr_opr_slices
+ * slices in turn
+ */
+LITE_API int LITE_enable_sampling_profiler(
+        LiteNetwork network, size_t sample_interval, size_t nr_opr_slices);
+
+/**
+ * \brief Get the aggregates of the sampling profiler in JSON format
+ * \param[in] network The loaded model
+ * \param[in] reset Clear the aggregates after they are read if not 0
+ * \param[out] profile The JSON string, which is valid until the next call of
+ * this function on the same thread
+ * \param[out] profile_size The size of the JSON string
+ */
+LITE_API int LITE_get_sampling_profile(
+        LiteNetwork network, int reset, const char** profile, size_t* profile_size);
+
 #ifdef __cplusplus
 }
 #endif
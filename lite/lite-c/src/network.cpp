@@ -43,6 +43,8 @@ const LiteOptions default_option = {
         .enable_nchw32 = 0,
         .enable_nchw64 = 0,
 
+        .comp_node_seq_record_cache_size = 0,
+        .weight_preprocess_cache = false,
 };
 
 //! define a default config
@@ -140,6 +142,10 @@ lite::Config convert_to_lite_config(const LiteConfig c_config) {
     lite_config.options.enable_nhwcd4 = c_config.options.enable_nhwcd4;
     lite_config.options.enable_nchw32 = c_config.options.enable_nchw32;
     lite_config.options.enable_nchw64 = c_config.options.enable_nchw64;
+    lite_config.options.comp_node_seq_record_cache_size =
+            c_config.options.comp_node_seq_record_cache_size;
+    lite_config.options.weight_preprocess_cache =
+            c_config.options.weight_preprocess_cache;
 
     return lite_config;
 }
@@ -223,6 +229,25 @@ int LITE_forward(const LiteNetwork network) {
     LITE_CAPI_END();
 }
 
+int LITE_forward_with_bindings(
+        const LiteNetwork network, size_t size, const char* const* io_names,
+        const LiteTensor* tensors) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    LITE_ASSERT(
+            size == 0 || (io_names && tensors), "The ptr pass to LITE api is null");
+    lite::IOBindings bindings;
+    for (size_t i = 0; i < size; i++) {
+        LITE_ASSERT(io_names[i], "The io name pass to LITE api is null");
+        LITE_ASSERT(tensors[i], "The tensor pass to LITE api is null");
+        //! the user tensors are owned by the caller
+        bindings[io_names[i]] = std::shared_ptr<lite::Tensor>{
+                static_cast<lite::Tensor*>(tensors[i]), [](void*) {}};
+    }
+    static_cast<lite::Network*>(network)->forward(bindings);
+    LITE_CAPI_END();
+}
+
 int LITE_wait(const LiteNetwork network) {
     LITE_CAPI_BEGIN();
     LITE_ASSERT(network, "The network pass to LITE api is null");
@@ -241,6 +266,22 @@ int LITE_get_io_tensor(
     LITE_CAPI_END();
 }
 
+int LITE_get_io_tensors(
+        LiteNetwork network, size_t size, const char* const* io_names,
+        LiteTensorPhase phase, LiteTensor* tensors) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    LITE_ASSERT(
+            size == 0 || (io_names && tensors), "The ptr pass to LITE api is null");
+    for (size_t i = 0; i < size; i++) {
+        LITE_ASSERT(io_names[i], "The io name pass to LITE api is null");
+        tensors[i] = static_cast<lite::Network*>(network)
+                             ->get_io_tensor(io_names[i], phase)
+                             .get();
+    }
+    LITE_CAPI_END();
+}
+
 int LITE_get_input_name(const LiteNetwork network, size_t index, const char** name) {
     LITE_CAPI_BEGIN();
     LITE_ASSERT(network && name, "The network pass to LITE api is null");
@@ -489,6 +530,25 @@ int LITE_set_network_algo_workspace_limit(LiteNetwork network, size_t workspace_
     LITE_CAPI_END();
 }
 
+int LITE_set_network_memory_budget(LiteNetwork network, size_t memory_budget) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    lite::Runtime::set_network_memory_budget(network_shared, memory_budget);
+    LITE_CAPI_END();
+}
+
+int LITE_get_network_memory_peak(LiteNetwork network, size_t* memory_peak) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    LITE_ASSERT(memory_peak, "The ptr pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    *memory_peak = lite::Runtime::get_network_memory_peak(network_shared);
+    LITE_CAPI_END();
+}
+
 int LITE_set_runtime_thread_affinity(
         LiteNetwork network,
         const LiteThreadAffinityCallback thread_affinity_callback) {
@@ -501,6 +561,16 @@ int LITE_set_runtime_thread_affinity(
     LITE_CAPI_END();
 }
 
+int LITE_set_runtime_thread_wait_policy(
+        LiteNetwork network, size_t nr_spin, size_t nr_yield) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    lite::Runtime::set_runtime_thread_wait_policy(network_shared, nr_spin, nr_yield);
+    LITE_CAPI_END();
+}
+
 int LITE_set_memory_allocator(
         LiteNetwork network, const LiteAllocate allocate_fun, const LiteFree free_fun) {
     LITE_CAPI_BEGIN();
@@ -531,6 +601,41 @@ int LITE_enable_io_bin_dump(LiteNetwork network, const char* io_bin_out_dir) {
     LITE_CAPI_END();
 }
 
+int LITE_enable_roofline_report(
+        LiteNetwork network, const char* report_file, const char* device_spec_file) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network && report_file, "The ptr pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    lite::Runtime::enable_roofline_report(
+            network_shared, report_file, device_spec_file ? device_spec_file : "");
+    LITE_CAPI_END();
+}
+
+int LITE_enable_sampling_profiler(
+        LiteNetwork network, size_t sample_interval, size_t nr_opr_slices) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    lite::Runtime::enable_sampling_profiler(
+            network_shared, sample_interval, nr_opr_slices);
+    LITE_CAPI_END();
+}
+
+int LITE_get_sampling_profile(
+        LiteNetwork network, int reset, const char** profile, size_t* profile_size) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network && profile && profile_size, "The ptr pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    static thread_local std::string sampling_profile;
+    sampling_profile = lite::Runtime::get_sampling_profile(network_shared, reset);
+    *profile = sampling_profile.c_str();
+    *profile_size = sampling_profile.size();
+    LITE_CAPI_END();
+}
+
 int LITE_shared_weight_with_network(
         LiteNetwork dst_network, const LiteNetwork src_network) {
     LITE_CAPI_BEGIN();
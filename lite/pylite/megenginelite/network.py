@@ -7,6 +7,7 @@
 # software distributed under the License is distributed on an
 # "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
+import json
 from ctypes import *
 
 import numpy as np
@@ -42,6 +43,8 @@ class LiteOptions(Structure):
         ("enable_nchw4", c_int),
         ("enable_nchw32", c_int),
         ("enable_nchw64", c_int),
+        ("comp_node_seq_record_cache_size", c_int),
+        ("weight_preprocess_cache", c_int),
     ]
 
     def __init__(self):
@@ -57,6 +60,8 @@ class LiteOptions(Structure):
         self.comp_node_seq_record_level = 0
         self.graph_opt_level = 2
         self.async_exec_level = 1
+        self.comp_node_seq_record_cache_size = 0
+        self.weight_preprocess_cache = False
 
     def __repr__(self):
         data = {
@@ -72,6 +77,8 @@ class LiteOptions(Structure):
             "comp_node_seq_record_level": self.comp_node_seq_record_level,
             "graph_opt_level": self.graph_opt_level,
             "async_exec_level": self.async_exec_level,
+            "comp_node_seq_record_cache_size": self.comp_node_seq_record_cache_size,
+            "weight_preprocess_cache": self.weight_preprocess_cache,
         }
         return data.__repr__()
 
@@ -267,6 +274,14 @@ class _NetworkAPI(_LiteCObjBase):
         ("LITE_forward", [_Cnetwork]),
         ("LITE_wait", [_Cnetwork]),
         ("LITE_get_io_tensor", [_Cnetwork, c_char_p, c_int, POINTER(_Ctensor)]),
+        (
+            "LITE_get_io_tensors",
+            [_Cnetwork, c_size_t, POINTER(c_char_p), c_int, POINTER(_Ctensor)],
+        ),
+        (
+            "LITE_forward_with_bindings",
+            [_Cnetwork, c_size_t, POINTER(c_char_p), POINTER(_Ctensor)],
+        ),
         ("LITE_get_input_name", [_Cnetwork, c_size_t, POINTER(c_char_p)]),
         ("LITE_get_output_name", [_Cnetwork, c_size_t, POINTER(c_char_p)]),
         ("LITE_get_all_input_name", [_Cnetwork, POINTER(c_size_t), POINTER(c_char_p)]),
@@ -283,10 +298,18 @@ class _NetworkAPI(_LiteCObjBase):
         ("LITE_set_network_algo_policy", [_Cnetwork, c_int]),
         ("LITE_set_network_algo_fastrun_config", [_Cnetwork, c_int, c_int]),
         ("LITE_set_network_algo_workspace_limit", [_Cnetwork, c_size_t]),
+        ("LITE_set_network_memory_budget", [_Cnetwork, c_size_t]),
+        ("LITE_get_network_memory_peak", [_Cnetwork, POINTER(c_size_t)]),
         ("LITE_share_runtime_memroy", [_Cnetwork, _Cnetwork]),
         ("LITE_enable_profile_performance", [_Cnetwork, c_char_p]),
         ("LITE_enable_io_txt_dump", [_Cnetwork, c_char_p]),
         ("LITE_enable_io_bin_dump", [_Cnetwork, c_char_p]),
+        ("LITE_enable_roofline_report", [_Cnetwork, c_char_p, c_char_p]),
+        ("LITE_enable_sampling_profiler", [_Cnetwork, c_size_t, c_size_t]),
+        (
+            "LITE_get_sampling_profile",
+            [_Cnetwork, c_int, POINTER(c_char_p), POINTER(c_size_t)],
+        ),
         ("LITE_set_async_callback", [_Cnetwork, LiteAsyncCallback]),
         ("LITE_set_start_callback", [_Cnetwork]),
         ("LITE_set_finish_callback", [_Cnetwork]),
@@ -330,8 +353,29 @@ class LiteNetwork(object):
         c_path = c_char_p(path.encode("utf-8"))
         self._api.LITE_load_model_from_path(self._network, c_path)
 
-    def forward(self):
-        self._api.LITE_forward(self._network)
+    def forward(self, bindings=None):
+        """
+        forward the network, if bindings is given as a dict from the io name to
+        LiteTensor, the io tensors are bound to the memory of the tensors in one
+        call before forward, so the inputs are read from and the outputs are
+        written to them without copy, and the tensors must be alive until wait()
+        """
+        if not bindings:
+            self._api.LITE_forward(self._network)
+            return
+        size = len(bindings)
+        c_names = (c_char_p * size)(
+            *[
+                name.encode("utf-8") if type(name) == str else name
+                for name in bindings.keys()
+            ]
+        )
+        c_tensors = (_Ctensor * size)(
+            *[tensor._tensor for tensor in bindings.values()]
+        )
+        # keep the bound tensors alive until they are bound again
+        self._bindings = bindings
+        self._api.LITE_forward_with_bindings(self._network, size, c_names, c_tensors)
 
     def wait(self):
         self._api.LITE_wait(self._network)
@@ -424,6 +468,24 @@ class LiteNetwork(object):
         tensor.update()
         return tensor
 
+    def get_io_tensors(self, names, phase=LiteTensorPhase.LITE_IO):
+        """
+        get several input or output tensors by their names in one call
+        """
+        size = len(names)
+        c_names = (c_char_p * size)(
+            *[name.encode("utf-8") if type(name) == str else name for name in names]
+        )
+        c_tensors = (_Ctensor * size)()
+        self._api.LITE_get_io_tensors(self._network, size, c_names, phase, c_tensors)
+        tensors = []
+        for c_tensor in c_tensors:
+            tensor = LiteTensor()
+            tensor._tensor = c_tensor
+            tensor.update()
+            tensors.append(tensor)
+        return tensors
+
     def get_input_name(self, index):
         """
         get the input name by the index in the network
@@ -507,6 +569,24 @@ class LiteNetwork(object):
     def set_network_algo_workspace_limit(self, size_limit):
         self._api.LITE_set_network_algo_workspace_limit(self._network, size_limit)
 
+    def set_network_memory_budget(self, memory_budget):
+        """
+        set the memory budget in bytes of the network, the algorithms are
+        chosen within the budget and the activations are recomputed when the
+        static memory plan exceeds it
+        Note: this must be set before the network loaded
+        """
+        self._api.LITE_set_network_memory_budget(self._network, memory_budget)
+
+    def get_network_memory_peak(self):
+        """
+        get the size in bytes of the static memory allocated for the
+        activations and workspaces of the network
+        """
+        memory_peak = c_size_t()
+        self._api.LITE_get_network_memory_peak(self._network, byref(memory_peak))
+        return memory_peak.value
+
     def set_network_algo_policy(
         self, policy, shared_batch_size=0, binary_equal_between_batch=False
     ):
@@ -532,3 +612,37 @@ class LiteNetwork(object):
     def io_bin_dump(self, bin_dir):
         c_dir = bin_dir.encode("utf-8")
         self._api.LITE_enable_io_bin_dump(self._network, c_dir)
+
+    def enable_roofline_report(self, report_file, device_spec_file=None):
+        """
+        write the achieved GFLOP/s and GB/s of each opr to report_file after each
+        forward, ranked by the percent of the roofline of its device
+
+        :param device_spec_file: each line of it is "<comp node prefix> <peak
+            GFLOP/s> <peak GB/s>", the percents are omitted without it
+        """
+        c_spec = device_spec_file.encode("utf-8") if device_spec_file else None
+        self._api.LITE_enable_roofline_report(
+            self._network, report_file.encode("utf-8"), c_spec
+        )
+
+    def enable_sampling_profiler(self, sample_interval, nr_opr_slices=1):
+        """
+        enable the low-overhead sampling profiler before the model is loaded, which
+        records the kernel time of the oprs in one of sample_interval forwards
+        """
+        self._api.LITE_enable_sampling_profiler(
+            self._network, sample_interval, nr_opr_slices
+        )
+
+    def get_sampling_profile(self, reset=False):
+        """
+        get the aggregates of the sampling profiler per opr type and input shapes
+        as a dict, they are cleared after read if reset is True
+        """
+        c_profile = c_char_p()
+        size = c_size_t()
+        self._api.LITE_get_sampling_profile(
+            self._network, int(reset), byref(c_profile), byref(size)
+        )
+        return json.loads(string_at(c_profile, size.value).decode("utf-8"))
@@ -413,9 +413,13 @@ class LiteTensor(object):
             self._api.LITE_get_tensor_memory(self._tensor, byref(tensor_memory))
             memmove(tensor_memory, data, data_length)
 
-    def to_numpy(self):
+    def to_numpy(self, copy=True):
         """
         get the buffer of the tensor
+        param copy: if it is False, return a numpy.ndarray sharing the memory of
+        the tensor without copy, which is only avaliable for continue cpu
+        tensor or pinned tensor, and is invalid once the tensor memory is reset
+        or reallocated
         """
         self.update()
         if self.nbytes <= 0:
@@ -428,15 +432,35 @@ class LiteTensor(object):
 
             np_type = _lite_type_to_nptypes[LiteDataType(self._layout.data_type)]
             shape = [self._layout.shapes[i] for i in range(self._layout.ndim)]
+            if not copy:
+                buffer = (c_byte * self.nbytes).from_address(ptr.value)
+                # the view keeps the tensor alive through its base buffer
+                buffer._lite_tensor = self
+                return np.frombuffer(buffer, np_type).reshape(shape)
             np_arr = np.zeros(shape, np_type)
             if np_arr.nbytes:
                 memmove(np_arr.ctypes.data_as(c_void_p), ptr, np_arr.nbytes)
             return np_arr
         else:
+            assert copy, "to_numpy without copy can only apply in continue cpu tensor."
             tmp_tensor = LiteTensor(self.layout)
             tmp_tensor.copy_from(self)
             return tmp_tensor.to_numpy()
 
+    def __array__(self, dtype=None):
+        """
+        the numpy array interface, which shares the memory of the tensor when
+        possible, so numpy.asarray(tensor) does not copy
+        """
+        self.update()
+        zero_copy = self.is_continue and (
+            self.is_pinned_host or self.device_type == LiteDeviceType.LITE_CPU
+        )
+        arr = self.to_numpy(copy=not zero_copy)
+        if dtype is not None:
+            arr = arr.astype(dtype, copy=False)
+        return arr
+
     def __repr__(self):
         self.update()
         data = {
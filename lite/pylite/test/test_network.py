@@ -131,6 +131,24 @@ class TestNetwork(TestShuffleNet):
         output_data = output_tensor.to_numpy()
         self.check_correct(output_data)
 
+    def test_network_forward_with_bindings(self):
+        network = LiteNetwork()
+        network.load(self.model_path)
+
+        input_name = network.get_input_name(0)
+        output_name = network.get_output_name(0)
+        input_tensor, output_tensor = network.get_io_tensors([input_name, output_name])
+        assert input_tensor.layout.shapes[1] == 3
+
+        user_input = LiteTensor()
+        user_input.set_data_by_share(self.input_data)
+        user_output = LiteTensor(output_tensor.layout)
+        for i in range(3):
+            network.forward({input_name: user_input, output_name: user_output})
+            network.wait()
+
+        self.check_correct(user_output.to_numpy(copy=False))
+
     def test_network_get_name(self):
         network = LiteNetwork()
         network.load(self.model_path)
@@ -179,6 +179,26 @@ def test_tensor_share_memory():
         assert real_data[i // 8][i % 8] == i + 5
 
 
+def test_tensor_numpy_view():
+    layout = LiteLayout([4, 8], "int16")
+    tensor = LiteTensor(layout)
+    tensor.set_data_by_copy([i for i in range(32)])
+
+    view = tensor.to_numpy(copy=False)
+    assert view.shape == (4, 8) and view.dtype == np.int16
+    view[1][2] = 100
+    real_data = tensor.to_numpy()
+    assert real_data[1][2] == 100
+
+    arr = np.asarray(tensor)
+    arr[0][0] = 7
+    assert tensor.to_numpy()[0][0] == 7
+
+    # the view keeps the tensor alive
+    del tensor
+    assert view[0][0] == 7
+
+
 def test_tensor_share_ctype_memory():
     layout = LiteLayout([4, 8], "int16")
     tensor1 = LiteTensor(layout)
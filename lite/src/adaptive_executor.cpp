@@ -0,0 +1,364 @@
+/**
+ * \file src/adaptive_executor.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/adaptive_executor.h"
+#include "misc.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace lite;
+
+class AdaptiveExecutor::Impl {
+public:
+    Impl(std::string model_path, const AdaptiveOptions& options, const Config& config,
+         const NetworkIO& network_io);
+    ~Impl();
+
+    std::future<IOBindings> forward_async(const IOBindings& inputs, Callback callback);
+
+    Stats get_stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        IOBindings inputs;
+        Callback callback;
+        std::promise<IOBindings> promise;
+    };
+
+    struct Mode {
+        size_t nr_instances, nr_threads;
+        std::vector<std::shared_ptr<Network>> networks;
+        //! the number of requests being run by the instances
+        size_t nr_running = 0;
+        size_t nr_requests = 0;
+        double service_ms = 0;
+    };
+
+    void worker(size_t mode, Network* network);
+
+    //! whether the instances of the mode can take a request
+    bool can_run(size_t mode) const;
+
+    //! choose the mode for the load of the last interval, with m_mtx held
+    void decide(Clock::time_point now);
+
+    static IOBindings run(Network* network, const IOBindings& inputs);
+
+    const AdaptiveOptions m_options;
+    std::vector<Mode> m_modes;
+
+    mutable std::mutex m_mtx;
+    //! signaled when a request is queued or finished, or the mode changes
+    std::condition_variable m_cv;
+    std::deque<Request> m_queue;
+    size_t m_nr_in_flight = 0;
+    size_t m_mode = 0;
+    size_t m_nr_switches = 0;
+    bool m_stop = false;
+
+    //! the load since the start of the decision interval
+    Clock::time_point m_interval_start;
+    size_t m_nr_arrivals = 0, m_nr_waited = 0;
+    double m_arrival_rate = 0;
+
+    std::vector<std::thread> m_workers;
+};
+
+AdaptiveExecutor::Impl::Impl(
+        std::string model_path, const AdaptiveOptions& options, const Config& config,
+        const NetworkIO& network_io)
+        : m_options{options} {
+    LITE_ASSERT(
+            config.device_type == LiteDeviceType::LITE_CPU,
+            "AdaptiveExecutor is only avaliable in CPU.");
+    size_t nr_cores = m_options.nr_cores;
+    LITE_ASSERT(nr_cores > 0, "nr_cores should be positive.");
+    LITE_ASSERT(m_options.max_in_flight > 0, "max_in_flight should be positive.");
+    auto nr_instances_of_modes = m_options.nr_instances_of_modes;
+    if (nr_instances_of_modes.empty()) {
+        nr_instances_of_modes = {1};
+        if (nr_cores > 1) {
+            nr_instances_of_modes.push_back(nr_cores);
+        }
+    }
+
+    std::shared_ptr<Network> first;
+    int device_id = config.device_id;
+    for (auto nr_instances : nr_instances_of_modes) {
+        LITE_ASSERT(
+                nr_instances > 0 && nr_cores % nr_instances == 0,
+                "the number of instances %zu of a mode should divide nr_cores %zu.",
+                nr_instances, nr_cores);
+        Mode mode;
+        mode.nr_instances = nr_instances;
+        mode.nr_threads = nr_cores / nr_instances;
+        for (size_t i = 0; i < nr_instances; ++i) {
+            auto network = std::make_shared<Network>(config, network_io);
+            //! every instance has a comp node of its own as in NetworkPool
+            network->set_device_id(device_id++);
+            if (mode.nr_threads > 1) {
+                Runtime::set_cpu_threads_number(network, mode.nr_threads);
+            }
+            if (!first) {
+                network->load_model(model_path);
+                first = network;
+            } else {
+                Runtime::shared_weight_with_network(network, first);
+            }
+            if (m_options.core_affinity) {
+                auto&& affinity = m_options.core_affinity;
+                size_t core_begin = i * mode.nr_threads;
+                Runtime::set_runtime_thread_affinity(
+                        network, [affinity, core_begin](int thread_id) {
+                            affinity(core_begin + thread_id);
+                        });
+            }
+            mode.networks.push_back(std::move(network));
+        }
+        m_modes.push_back(std::move(mode));
+    }
+
+    m_interval_start = Clock::now();
+    for (size_t i = 0; i < m_modes.size(); ++i) {
+        for (auto&& network : m_modes[i].networks) {
+            m_workers.emplace_back([this, i, ptr = network.get()]() { worker(i, ptr); });
+        }
+    }
+}
+
+AdaptiveExecutor::Impl::~Impl() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto&& worker : m_workers) {
+        worker.join();
+    }
+}
+
+std::future<IOBindings> AdaptiveExecutor::Impl::forward_async(
+        const IOBindings& inputs, Callback callback) {
+    Request request;
+    for (auto&& input : inputs) {
+        LITE_CHECK_NON_NULL_POINTER(input.second);
+        auto snapshot = std::make_shared<Tensor>(
+                input.second->get_device_id(), input.second->get_device_type());
+        snapshot->copy_from(*input.second);
+        request.inputs[input.first] = std::move(snapshot);
+    }
+    request.callback = std::move(callback);
+    auto future = request.promise.get_future();
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait(lock, [this]() {
+            return m_stop || m_nr_in_flight < m_options.max_in_flight;
+        });
+        LITE_ASSERT(!m_stop, "forward_async on a stopped AdaptiveExecutor.");
+        ++m_nr_in_flight;
+        ++m_nr_arrivals;
+        auto&& mode = m_modes[m_mode];
+        if (m_queue.size() + mode.nr_running >= mode.nr_instances) {
+            ++m_nr_waited;
+        }
+        m_queue.emplace_back(std::move(request));
+    }
+    m_cv.notify_all();
+    return future;
+}
+
+bool AdaptiveExecutor::Impl::can_run(size_t mode) const {
+    if (mode != m_mode || m_queue.empty()) {
+        return false;
+    }
+    //! wait until the previous mode releases the cores
+    for (size_t i = 0; i < m_modes.size(); ++i) {
+        if (i != mode && m_modes[i].nr_running) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AdaptiveExecutor::Impl::decide(Clock::time_point now) {
+    double interval_ms =
+            std::chrono::duration<double, std::milli>(now - m_interval_start).count();
+    if (interval_ms < m_options.decision_interval_ms) {
+        return;
+    }
+    auto&& cur = m_modes[m_mode];
+    //! requests per millisecond
+    double rate = interval_ms > 0 ? m_nr_arrivals / interval_ms : 0;
+    if (m_nr_waited && cur.service_ms > 0) {
+        rate = std::max(rate, cur.nr_instances / cur.service_ms);
+    }
+    m_arrival_rate = rate * 1e3;
+    m_interval_start = now;
+    m_nr_arrivals = m_nr_waited = 0;
+    if (cur.service_ms <= 0) {
+        return;
+    }
+
+    //! the modes that could not keep up are ranked after the others by
+    //! throughput, and the others by the estimated latency
+    struct Score {
+        bool saturated;
+        double value;
+    };
+    auto estimate = [&](const Mode& mode) -> Score {
+        double service_ms = mode.service_ms > 0
+                                  ? mode.service_ms
+                                  : cur.service_ms * cur.nr_threads / mode.nr_threads;
+        double util = rate * service_ms / mode.nr_instances;
+        if (util >= 1) {
+            return {true, -(mode.nr_instances / service_ms)};
+        }
+        return {false, service_ms / (1 - util)};
+    };
+    //! the relative improvement of b over a, 0 for a tie
+    auto gain = [](const Score& a, const Score& b) {
+        if (a.saturated != b.saturated) {
+            return a.saturated ? 1. : -1.;
+        }
+        double diff = (a.value - b.value) / std::abs(a.value);
+        return std::abs(diff) < 1e-6 ? 0. : diff;
+    };
+    Score cur_score = estimate(cur);
+    size_t best = m_mode;
+    Score best_score = cur_score;
+    for (size_t i = 0; i < m_modes.size(); ++i) {
+        auto score = estimate(m_modes[i]);
+        double g = gain(best_score, score);
+        //! prefer more instances on ties, as intra-op parallelism rarely
+        //! scales linearly with the threads
+        if (g > 0 || (g == 0 && m_modes[i].nr_instances > m_modes[best].nr_instances)) {
+            best = i;
+            best_score = score;
+        }
+    }
+    double g = gain(cur_score, best_score);
+    if (best != m_mode && (g > m_options.switch_threshold || g == 0)) {
+        m_mode = best;
+        ++m_nr_switches;
+    }
+}
+
+IOBindings AdaptiveExecutor::Impl::run(Network* network, const IOBindings& inputs) {
+    network->forward(inputs);
+    network->wait();
+    IOBindings outputs;
+    for (auto&& name : network->get_all_output_name()) {
+        auto src = network->get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT);
+        auto dst = std::make_shared<Tensor>(
+                src->get_device_id(), src->get_device_type());
+        dst->copy_from(*src);
+        outputs[name] = std::move(dst);
+    }
+    return outputs;
+}
+
+void AdaptiveExecutor::Impl::worker(size_t mode, Network* network) {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait(lock, [this, mode]() {
+                return (m_stop && m_queue.empty()) || can_run(mode);
+            });
+            if (!can_run(mode)) {
+                return;
+            }
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+            ++m_modes[mode].nr_running;
+        }
+        auto start = Clock::now();
+        IOBindings outputs;
+#if LITE_ENABLE_EXCEPTION
+        try {
+            outputs = run(network, request.inputs);
+            request.promise.set_value(outputs);
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+#else
+        outputs = run(network, request.inputs);
+        request.promise.set_value(outputs);
+#endif
+        auto end = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            auto&& m = m_modes[mode];
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            //! the first request of an instance is skipped, which includes
+            //! the warm up
+            if (m.nr_requests >= m.nr_instances) {
+                m.service_ms = m.service_ms > 0 ? m.service_ms * 0.75 + ms * 0.25 : ms;
+            }
+            ++m.nr_requests;
+            --m.nr_running;
+            --m_nr_in_flight;
+            decide(end);
+        }
+        m_cv.notify_all();
+        if (request.callback) {
+            request.callback(outputs);
+        }
+    }
+}
+
+AdaptiveExecutor::Stats AdaptiveExecutor::Impl::get_stats() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    Stats stats;
+    stats.mode = m_mode;
+    stats.nr_switches = m_nr_switches;
+    stats.arrival_rate = m_arrival_rate;
+    for (auto&& mode : m_modes) {
+        stats.modes.push_back(
+                {mode.nr_instances, mode.nr_threads, mode.nr_requests,
+                 mode.service_ms});
+    }
+    return stats;
+}
+
+/*********************** AdaptiveExecutor ***************/
+AdaptiveExecutor::AdaptiveExecutor(
+        std::string model_path, const AdaptiveOptions& options, const Config& config,
+        const NetworkIO& network_io) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(std::move(model_path), options, config, network_io);
+    LITE_ERROR_HANDLER_END
+}
+
+AdaptiveExecutor::~AdaptiveExecutor() = default;
+
+std::future<IOBindings> AdaptiveExecutor::forward_async(
+        const IOBindings& inputs, Callback callback) {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->forward_async(inputs, std::move(callback));
+    LITE_ERROR_HANDLER_END
+}
+
+AdaptiveExecutor::Stats AdaptiveExecutor::get_stats() const {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->get_stats();
+    LITE_ERROR_HANDLER_END
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,228 @@
+/**
+ * \file src/async_executor.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/async_executor.h"
+#include "misc.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace lite;
+
+class AsyncExecutor::Impl {
+public:
+    Impl(std::vector<std::shared_ptr<Network>> networks, const AsyncOptions& options);
+    ~Impl();
+
+    std::future<IOBindings> forward_async(const IOBindings& inputs, Callback callback);
+
+private:
+    struct Request {
+        IOBindings inputs;
+        Callback callback;
+        std::promise<IOBindings> promise;
+    };
+
+    void worker(Network* network);
+    void callback_worker();
+
+    //! run the request and return a copy of the outputs
+    static IOBindings run(Network* network, const IOBindings& inputs);
+
+    const AsyncOptions m_options;
+    std::vector<std::shared_ptr<Network>> m_networks;
+
+    std::mutex m_mtx;
+    //! signaled when a request is queued or finished
+    std::condition_variable m_cv;
+    std::deque<Request> m_queue;
+    size_t m_nr_in_flight = 0;
+    bool m_stop = false;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_callback_mtx;
+    std::condition_variable m_callback_cv;
+    std::deque<std::function<void()>> m_callbacks;
+    bool m_callback_stop = false;
+    std::vector<std::thread> m_callback_workers;
+};
+
+AsyncExecutor::Impl::Impl(
+        std::vector<std::shared_ptr<Network>> networks, const AsyncOptions& options)
+        : m_options{options}, m_networks{std::move(networks)} {
+    LITE_ASSERT(!m_networks.empty(), "AsyncExecutor needs at least one network.");
+    for (size_t i = 0; i < m_networks.size(); ++i) {
+        LITE_CHECK_NON_NULL_POINTER(m_networks[i]);
+        for (size_t j = 0; j < i; ++j) {
+            LITE_ASSERT(
+                    m_networks[i] != m_networks[j],
+                    "the networks of AsyncExecutor should be different.");
+        }
+    }
+    LITE_ASSERT(m_options.max_in_flight > 0, "max_in_flight should be positive.");
+    LITE_ASSERT(
+            m_options.nr_callback_threads > 0,
+            "nr_callback_threads should be positive.");
+    for (size_t i = 0; i < m_options.nr_callback_threads; ++i) {
+        m_callback_workers.emplace_back([this]() { callback_worker(); });
+    }
+    for (auto&& network : m_networks) {
+        m_workers.emplace_back([this, ptr = network.get()]() { worker(ptr); });
+    }
+}
+
+AsyncExecutor::Impl::~Impl() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto&& worker : m_workers) {
+        worker.join();
+    }
+    //! the callbacks of the finished requests are still run
+    {
+        std::lock_guard<std::mutex> lock(m_callback_mtx);
+        m_callback_stop = true;
+    }
+    m_callback_cv.notify_all();
+    for (auto&& worker : m_callback_workers) {
+        worker.join();
+    }
+}
+
+std::future<IOBindings> AsyncExecutor::Impl::forward_async(
+        const IOBindings& inputs, Callback callback) {
+    Request request;
+    for (auto&& input : inputs) {
+        LITE_CHECK_NON_NULL_POINTER(input.second);
+        auto snapshot = std::make_shared<Tensor>(
+                input.second->get_device_id(), input.second->get_device_type());
+        snapshot->copy_from(*input.second);
+        request.inputs[input.first] = std::move(snapshot);
+    }
+    request.callback = std::move(callback);
+    auto future = request.promise.get_future();
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait(lock, [this]() {
+            return m_stop || m_nr_in_flight < m_options.max_in_flight;
+        });
+        LITE_ASSERT(!m_stop, "forward_async on a stopped AsyncExecutor.");
+        ++m_nr_in_flight;
+        m_queue.emplace_back(std::move(request));
+    }
+    m_cv.notify_all();
+    return future;
+}
+
+IOBindings AsyncExecutor::Impl::run(Network* network, const IOBindings& inputs) {
+    network->forward(inputs);
+    network->wait();
+    IOBindings outputs;
+    for (auto&& name : network->get_all_output_name()) {
+        auto src = network->get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT);
+        //! the outputs of the network are overwritten by the next request
+        auto dst = std::make_shared<Tensor>(
+                src->get_device_id(), src->get_device_type());
+        dst->copy_from(*src);
+        outputs[name] = std::move(dst);
+    }
+    return outputs;
+}
+
+void AsyncExecutor::Impl::worker(Network* network) {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        IOBindings outputs;
+#if LITE_ENABLE_EXCEPTION
+        try {
+            outputs = run(network, request.inputs);
+            request.promise.set_value(outputs);
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+#else
+        outputs = run(network, request.inputs);
+        request.promise.set_value(outputs);
+#endif
+        if (request.callback) {
+            {
+                std::lock_guard<std::mutex> lock(m_callback_mtx);
+                m_callbacks.emplace_back(
+                        [callback = std::move(request.callback),
+                         outputs = std::move(outputs)]() { callback(outputs); });
+            }
+            m_callback_cv.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            --m_nr_in_flight;
+        }
+        m_cv.notify_all();
+    }
+}
+
+void AsyncExecutor::Impl::callback_worker() {
+    for (;;) {
+        std::function<void()> callback;
+        {
+            std::unique_lock<std::mutex> lock(m_callback_mtx);
+            m_callback_cv.wait(
+                    lock, [this]() { return m_callback_stop || !m_callbacks.empty(); });
+            if (m_callbacks.empty()) {
+                return;
+            }
+            callback = std::move(m_callbacks.front());
+            m_callbacks.pop_front();
+        }
+        callback();
+    }
+}
+
+/*********************** AsyncExecutor ***************/
+AsyncExecutor::AsyncExecutor(
+        std::shared_ptr<Network> network, const AsyncOptions& options) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(
+            std::vector<std::shared_ptr<Network>>{std::move(network)}, options);
+    LITE_ERROR_HANDLER_END
+}
+
+AsyncExecutor::AsyncExecutor(
+        std::vector<std::shared_ptr<Network>> networks, const AsyncOptions& options) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(std::move(networks), options);
+    LITE_ERROR_HANDLER_END
+}
+
+AsyncExecutor::~AsyncExecutor() = default;
+
+std::future<IOBindings> AsyncExecutor::forward_async(
+        const IOBindings& inputs, Callback callback) {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->forward_async(inputs, std::move(callback));
+    LITE_ERROR_HANDLER_END
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
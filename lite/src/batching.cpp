@@ -0,0 +1,249 @@
+/**
+ * \file src/batching.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/batching.h"
+#include "misc.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace lite;
+
+class BatchingExecutor::Impl {
+public:
+    Impl(std::vector<std::shared_ptr<Network>> networks,
+         const BatchingOptions& options);
+    ~Impl();
+
+    std::future<TensorMap> submit(TensorMap inputs);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        TensorMap inputs;
+        std::promise<TensorMap> promise;
+        Clock::time_point arrival;
+    };
+
+    //! wait for the next batch, return false if the executor is stopped and
+    //! all the requests are served
+    bool take_batch(std::vector<Request>& batch);
+
+    void worker(Network& network);
+
+    //! run the batch on network and return the outputs of each request
+    static std::vector<TensorMap> run_batch(
+            Network& network, std::vector<Request>& batch);
+
+    const BatchingOptions m_options;
+    std::vector<std::shared_ptr<Network>> m_networks;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::deque<Request> m_queue;
+    bool m_stop = false;
+};
+
+BatchingExecutor::Impl::Impl(
+        std::vector<std::shared_ptr<Network>> networks, const BatchingOptions& options)
+        : m_options{options}, m_networks{std::move(networks)} {
+    LITE_ASSERT(!m_networks.empty(), "BatchingExecutor needs at least one network.");
+    LITE_ASSERT(m_options.max_batch_size > 0, "max_batch_size should be positive.");
+    for (auto&& network : m_networks) {
+        LITE_CHECK_NON_NULL_POINTER(network);
+    }
+    for (auto&& network : m_networks) {
+        m_workers.emplace_back([this, network]() { worker(*network); });
+    }
+}
+
+BatchingExecutor::Impl::~Impl() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto&& worker : m_workers) {
+        worker.join();
+    }
+}
+
+std::future<BatchingExecutor::TensorMap> BatchingExecutor::Impl::submit(
+        TensorMap inputs) {
+    Request request;
+    request.inputs = std::move(inputs);
+    request.arrival = Clock::now();
+    auto future = request.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        LITE_ASSERT(!m_stop, "submit to a stopped BatchingExecutor.");
+        m_queue.emplace_back(std::move(request));
+    }
+    m_cv.notify_one();
+    return future;
+}
+
+bool BatchingExecutor::Impl::take_batch(std::vector<Request>& batch) {
+    auto max_delay = std::chrono::microseconds(m_options.max_delay_us);
+    std::unique_lock<std::mutex> lock(m_mtx);
+    for (;;) {
+        if (m_queue.empty()) {
+            if (m_stop) {
+                return false;
+            }
+            m_cv.wait(lock);
+            continue;
+        }
+        if (m_stop || m_queue.size() >= m_options.max_batch_size) {
+            break;
+        }
+        //! the front may be taken by another worker while waiting, so the
+        //! deadline is computed again after every wake up
+        auto deadline = m_queue.front().arrival + max_delay;
+        if (Clock::now() >= deadline) {
+            break;
+        }
+        m_cv.wait_until(lock, deadline);
+    }
+    while (!m_queue.empty() && batch.size() < m_options.max_batch_size) {
+        batch.emplace_back(std::move(m_queue.front()));
+        m_queue.pop_front();
+    }
+    bool has_more = !m_queue.empty();
+    lock.unlock();
+    if (has_more) {
+        m_cv.notify_one();
+    }
+    return true;
+}
+
+void BatchingExecutor::Impl::worker(Network& network) {
+    std::vector<Request> batch;
+    while (take_batch(batch)) {
+#if LITE_ENABLE_EXCEPTION
+        try {
+            auto outputs = run_batch(network, batch);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                batch[i].promise.set_value(std::move(outputs[i]));
+            }
+        } catch (...) {
+            for (auto&& request : batch) {
+                request.promise.set_exception(std::current_exception());
+            }
+        }
+#else
+        auto outputs = run_batch(network, batch);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batch[i].promise.set_value(std::move(outputs[i]));
+        }
+#endif
+        batch.clear();
+    }
+}
+
+std::vector<BatchingExecutor::TensorMap> BatchingExecutor::Impl::run_batch(
+        Network& network, std::vector<Request>& batch) {
+    //! the number of samples of each request, given by the first input
+    std::vector<size_t> nr_rows;
+    size_t total_rows = 0;
+    for (auto&& name : network.get_all_input_name()) {
+        Layout layout;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            auto iter = batch[i].inputs.find(name);
+            LITE_ASSERT(
+                    iter != batch[i].inputs.end() && iter->second,
+                    "input %s is not given in the request.", name.c_str());
+            auto&& src_layout = iter->second->get_layout();
+            LITE_ASSERT(src_layout.ndim > 0, "input %s is empty.", name.c_str());
+            if (nr_rows.size() < batch.size()) {
+                nr_rows.push_back(src_layout.shapes[0]);
+                total_rows += src_layout.shapes[0];
+            }
+            LITE_ASSERT(
+                    nr_rows[i] == src_layout.shapes[0],
+                    "the inputs of a request have different number of samples.");
+            if (!i) {
+                layout = src_layout;
+                continue;
+            }
+            bool same = layout.ndim == src_layout.ndim &&
+                        layout.data_type == src_layout.data_type;
+            for (size_t axis = 1; same && axis < layout.ndim; ++axis) {
+                same = layout.shapes[axis] == src_layout.shapes[axis];
+            }
+            LITE_ASSERT(
+                    same, "the layout of input %s mismatches in the batch.",
+                    name.c_str());
+        }
+        layout.shapes[0] = total_rows;
+        auto dst = network.get_io_tensor(name, LiteTensorPhase::LITE_INPUT);
+        dst->set_layout(layout);
+        size_t offset = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            dst->slice({offset}, {offset + nr_rows[i]})
+                    ->copy_from(*batch[i].inputs.at(name));
+            offset += nr_rows[i];
+        }
+    }
+
+    network.forward();
+    network.wait();
+
+    std::vector<TensorMap> results(batch.size());
+    for (auto&& name : network.get_all_output_name()) {
+        auto src = network.get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT);
+        //! the output of the network is overwritten by the next batch, so it
+        //! is copied out once and the requests share slices of the copy
+        auto out = std::make_shared<Tensor>(
+                src->get_device_id(), src->get_device_type());
+        out->copy_from(*src);
+        auto&& layout = out->get_layout();
+        LITE_ASSERT(
+                layout.ndim > 0 && layout.shapes[0] == total_rows,
+                "the first dim of output %s is not the batch size.", name.c_str());
+        size_t offset = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            results[i][name] = out->slice({offset}, {offset + nr_rows[i]});
+            offset += nr_rows[i];
+        }
+    }
+    return results;
+}
+
+/*********************** BatchingExecutor ***************/
+BatchingExecutor::BatchingExecutor(
+        std::vector<std::shared_ptr<Network>> networks, const BatchingOptions& options)
+        : m_options{options} {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(std::move(networks), options);
+    LITE_ERROR_HANDLER_END
+}
+
+BatchingExecutor::~BatchingExecutor() = default;
+
+std::future<BatchingExecutor::TensorMap> BatchingExecutor::submit(TensorMap inputs) {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->submit(std::move(inputs));
+    LITE_ERROR_HANDLER_END
+}
+
+BatchingExecutor::TensorMap BatchingExecutor::run(TensorMap inputs) {
+    LITE_ERROR_HANDLER_BEGIN
+    return submit(std::move(inputs)).get();
+    LITE_ERROR_HANDLER_END
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
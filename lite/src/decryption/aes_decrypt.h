@@ -9,11 +9,95 @@
  * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
+#pragma once
+
 #include "./mbedtls/aes.h"
 #include "decrypt_base.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace lite {
 
+/*!
+ * \brief streaming decryption of models encrypted by AES-256-CBC
+ *
+ * The layout of the model is the same as AESDcryption::decrypt_model. In CBC
+ * mode a block is decrypted from itself and the previous cipher block, so any
+ * range of the model can be decrypted directly into the destination.
+ */
+class AESDecryptionStream final : public DecryptionStream {
+    static constexpr size_t BLOCK = 16;
+
+    std::shared_ptr<const void> m_model;
+    //! the IV, followed by the cipher blocks
+    const uint8_t* m_data;
+    size_t m_size;
+    //! only read when decrypting
+    mutable mbedtls_aes_context m_ctx;
+
+public:
+    AESDecryptionStream(
+            std::shared_ptr<const void> model_mem, size_t size,
+            const std::vector<uint8_t>& key)
+            : m_model{std::move(model_mem)},
+              m_data{static_cast<const uint8_t*>(m_model.get())} {
+        LITE_ASSERT(
+                size >= BLOCK + 8 && (size - BLOCK - 8) % BLOCK == 0,
+                "invalid size of AES encrypted model: %zu", size);
+        LITE_ASSERT(key.size() == 32, "AES-256 key should be of 32 bytes");
+        //! last 8 bytes is the big-endian size of the decrypted model
+        m_size = 0;
+        for (size_t i = 0; i < 8; i++) {
+            m_size = (m_size << 8) | m_data[size - 8 + i];
+        }
+        LITE_ASSERT(
+                m_size <= size - BLOCK - 8,
+                "invalid AES encrypted model: decrypted size %zu of %zu bytes",
+                m_size, size);
+        mbedtls_aes_init(&m_ctx);
+        mbedtls_aes_setkey_dec(&m_ctx, key.data(), 256);
+    }
+
+    AESDecryptionStream(const AESDecryptionStream&) = delete;
+    AESDecryptionStream& operator=(const AESDecryptionStream&) = delete;
+
+    ~AESDecryptionStream() { mbedtls_aes_free(&m_ctx); }
+
+    size_t size() const override { return m_size; }
+
+    void decrypt(size_t offset, void* dst, size_t size) const override {
+        LITE_ASSERT(
+                offset <= m_size && size <= m_size - offset,
+                "decrypt %zu bytes at %zu out of range of %zu bytes", size, offset,
+                m_size);
+        auto out = static_cast<uint8_t*>(dst);
+        uint8_t iv[BLOCK], plain[BLOCK];
+        while (size) {
+            size_t in_block = offset % BLOCK;
+            //! the previous cipher block, or IV for the first block
+            auto prev = m_data + offset - in_block;
+            std::copy(prev, prev + BLOCK, iv);
+            if (!in_block && size >= BLOCK) {
+                size_t len = size - size % BLOCK;
+                mbedtls_aes_crypt_cbc(
+                        &m_ctx, MBEDTLS_AES_DECRYPT, len, iv, prev + BLOCK, out);
+                offset += len;
+                out += len;
+                size -= len;
+            } else {
+                mbedtls_aes_crypt_cbc(
+                        &m_ctx, MBEDTLS_AES_DECRYPT, BLOCK, iv, prev + BLOCK, plain);
+                size_t len = std::min(BLOCK - in_block, size);
+                memcpy(out, plain + in_block, len);
+                offset += len;
+                out += len;
+                size -= len;
+            }
+        }
+    }
+};
+
 class AESDcryption {
 public:
     static std::vector<uint8_t> decrypt_model(
@@ -29,7 +113,7 @@ public:
         auto length_ptr = data + size - 8;
         size_t length = 0;
         for (int i = 0; i < 8; i++) {
-            length |= length_ptr[i] << (8 * (7 - i));
+            length |= static_cast<size_t>(length_ptr[i]) << (8 * (7 - i));
         }
         std::copy(data, data + 16, iv);
         auto output = std::vector<uint8_t>(size - 24);
@@ -40,6 +124,12 @@ public:
         return output;
     }
 
+    static std::unique_ptr<DecryptionStream> make_decrypt_stream(
+            std::shared_ptr<const void> model_mem, size_t size,
+            const std::vector<uint8_t>& key) {
+        return std::make_unique<AESDecryptionStream>(std::move(model_mem), size, key);
+    }
+
     static std::vector<uint8_t> get_decrypt_key() {
         std::vector<uint8_t> key = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
                                     0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
@@ -13,18 +13,52 @@
 #include "lite/global.h"
 #include "misc.h"
 
+#include <memory>
+
 namespace lite {
 
+/*!
+ * \brief random access to the decrypted content of an encrypted model
+ *
+ * This is used to decrypt the model chunk by chunk while it is loaded, so
+ * there is no need to hold the whole decrypted model in a new buffer.
+ */
+class DecryptionStream {
+public:
+    virtual ~DecryptionStream() = default;
+
+    //! size of the decrypted model in bytes
+    virtual size_t size() const = 0;
+
+    //! decrypt \p size bytes starting from \p offset of the decrypted model
+    virtual void decrypt(size_t offset, void* dst, size_t size) const = 0;
+};
+
+/*!
+ * \brief make a DecryptionStream of an encrypted model
+ * \param model_mem the encrypted model, which is kept alive by the stream
+ */
+using DecryptionStreamMaker = std::function<std::unique_ptr<DecryptionStream>(
+        std::shared_ptr<const void> model_mem, size_t size,
+        const std::vector<uint8_t>& key)>;
+
 struct DecryptionStaticData {
     std::unordered_map<
             std::string,
             std::pair<DecryptionFunc, std::shared_ptr<std::vector<uint8_t>>>>
             decryption_methods;
+    //! decryption methods that also support streaming decryption; an entry
+    //! is removed when the decryption function of the method is updated
+    std::unordered_map<std::string, DecryptionStreamMaker> stream_decryption_methods;
     LITE_MUTEX map_mutex;
 };
 
 DecryptionStaticData& decryption_static_data();
 
+//! register streaming decryption for a registered decryption method
+bool register_decryption_stream(
+        std::string decrypt_name, const DecryptionStreamMaker& maker);
+
 template <int count>
 struct DecryptionRegister;
 
@@ -45,4 +79,16 @@ struct DecryptionRegister;
     DecryptionRegister<number_> MACRO_CONCAT(decryption_, number_);               \
     }
 
+#define REGIST_DECRYPTION_STREAM_METHOD(name_, maker_) \
+    REGIST_DECRYPTION_STREAM_METHOD_WITH_NUM(__COUNTER__, name_, maker_)
+
+#define REGIST_DECRYPTION_STREAM_METHOD_WITH_NUM(number_, name_, maker_)    \
+    template <>                                                             \
+    struct DecryptionRegister<number_> {                                    \
+        DecryptionRegister() { register_decryption_stream(name_, maker_); } \
+    };                                                                      \
+    namespace {                                                             \
+    DecryptionRegister<number_> MACRO_CONCAT(decryption_, number_);         \
+    }
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -23,8 +23,9 @@
 #include "megbrain/common.h"
 #include "megbrain/comp_node.h"
 #include "megbrain/serialization/extern_c_opr.h"
+#include "megbrain/system.h"
+#include "megbrain/utils/infile_persistent_cache.h"
 #include "megbrain/version.h"
-#include "mge/algo_cache/file_cache.h"
 #include "mge/common.h"
 #if MGB_ENABLE_TENSOR_RT
 #include "megbrain/tensorrt/tensorrt_engine_cache.h"
@@ -93,6 +94,8 @@ bool lite::update_decryption_or_key(
         DecryptionFunc new_func;
         if (func) {
             new_func = func;
+            //! the builtin streaming decryption does not match the new function
+            decryption_static_data().stream_decryption_methods.erase(decrypt_name);
             LITE_LOG("%s decryption function is updated.", decrypt_name.c_str());
         } else {
             new_func = global_map[decrypt_name].first;
@@ -112,6 +115,16 @@ bool lite::update_decryption_or_key(
     }
 }
 
+bool lite::register_decryption_stream(
+        std::string decrypt_name, const DecryptionStreamMaker& maker) {
+    LITE_LOCK_GUARD(decryption_static_data().map_mutex);
+    LITE_ASSERT(
+            decryption_static_data().decryption_methods.count(decrypt_name),
+            "The decryption method %s is not registered.", decrypt_name.c_str());
+    decryption_static_data().stream_decryption_methods[decrypt_name] = maker;
+    return true;
+}
+
 lite::ParseInfoStaticData& lite::parse_info_static_data() {
     static lite::ParseInfoStaticData global_map;
     return global_map;
@@ -148,6 +161,26 @@ void lite::try_coalesce_all_free_memory() {
     mgb::CompNode::try_coalesce_all_free_memory();
 }
 
+void lite::set_cpu_shared_thread_pool(size_t nr_threads) {
+    mgb::CompNode::set_cpu_shared_thread_pool(nr_threads);
+}
+
+void lite::set_cpu_huge_page_size(size_t page_size) {
+    LITE_ASSERT(
+            !page_size || page_size == (2 << 20) || page_size == (1 << 30),
+            "huge page size should be 2MB or 1GB, got %zu", page_size);
+    mgb::CompNode::set_cpu_huge_page_size(page_size);
+}
+
+std::pair<size_t, size_t> lite::get_cpu_huge_page_coverage() {
+    auto stats = mgb::CompNode::get_cpu_huge_page_stats();
+    return {stats.nr_bytes_mapped, stats.nr_bytes_huge};
+}
+
+std::vector<std::vector<int>> lite::get_cpu_core_classes() {
+    return mgb::sys::get_cpu_core_classes();
+}
+
 void lite::set_loader_lib_path(const std::string& loader_path) {
     const char* lib_path = loader_path.c_str();
     LITE_LOG("load a device loader of path %s.", lib_path);
@@ -171,7 +204,8 @@ void lite::set_persistent_cache(const std::string& cache_path, bool always_sync)
     }
     cache_control.config_algo_times++;
     mgb::PersistentCache::set_impl(
-            std::make_shared<InFilePersistentCache>(cache_path.c_str(), always_sync));
+            std::make_shared<mgb::InFilePersistentCache>(
+                    cache_path.c_str(), always_sync));
 }
 
 void lite::dump_persistent_cache(const std::string& cache_path) {
@@ -179,8 +213,9 @@ void lite::dump_persistent_cache(const std::string& cache_path) {
     LITE_ASSERT(
             cache_control.cache_type == "file",
             "now cache type not correct, it can't be dumped.");
-    static_cast<InFilePersistentCache&>(mgb::PersistentCache::inst())
-            .dump_cache(cache_path.c_str());
+    //! merge into the existing file, which may be shared by other processes
+    static_cast<mgb::InFilePersistentCache&>(mgb::PersistentCache::inst())
+            .merge_and_dump_cache(cache_path.c_str());
 }
 
 //! Set the TensorRT engine cache path for serialized prebuilt ICudaEngine
@@ -212,9 +247,52 @@ void lite::dump_tensor_rt_cache() {
 #endif
 }
 
+void lite::set_tensor_rt_int8_calibration(
+        const std::vector<std::unordered_map<std::string, std::shared_ptr<Tensor>>>&
+                samples) {
+#if MGB_ENABLE_TENSOR_RT
+    std::vector<mgb::opr::TensorRTOpr::CalibrationSample> mgb_samples;
+    for (auto&& sample : samples) {
+        mgb_samples.emplace_back();
+        for (auto&& input : sample) {
+            auto&& tensor = input.second;
+            LITE_ASSERT(
+                    tensor->get_device_type() == LiteDeviceType::LITE_CPU &&
+                            tensor->is_continue_memory(),
+                    "calibration sample %s should be a contiguous cpu tensor",
+                    input.first.c_str());
+            auto layout = to_impl_layout(tensor->get_layout());
+            mgb::HostTensorND host{mgb::CompNode::default_cpu(), layout};
+            memcpy(host.raw_ptr(), tensor->get_memory_ptr(), layout.span().dist_byte());
+            mgb_samples.back()[input.first] = std::move(host);
+        }
+    }
+    mgb::opr::TensorRTOpr::set_int8_calibration_samples(std::move(mgb_samples));
+#else
+    LITE_MARK_USED_VAR(samples);
+    LITE_THROW("TensorRT is disable at compile time.");
+#endif
+}
+
 #else  // LITE_BUILD_WITH_MGE
 void lite::try_coalesce_all_free_memory() {}
 
+void lite::set_cpu_shared_thread_pool(size_t) {
+    LITE_THROW("mge is disbale at build time, please build with mge");
+}
+
+void lite::set_cpu_huge_page_size(size_t) {
+    LITE_THROW("mge is disbale at build time, please build with mge");
+}
+
+std::pair<size_t, size_t> lite::get_cpu_huge_page_coverage() {
+    LITE_THROW("mge is disbale at build time, please build with mge");
+}
+
+std::vector<std::vector<int>> lite::get_cpu_core_classes() {
+    LITE_THROW("mge is disbale at build time, please build with mge");
+}
+
 void lite::set_loader_lib_path(const std::string&) {
     LITE_THROW("mge is disbale at build time, please build with mge");
 }
@@ -235,12 +313,19 @@ void lite::set_tensor_rt_cache(std::string) {
 void lite::dump_tensor_rt_cache() {
     LITE_THROW("mge is disbale at build time, please build with mge");
 }
+
+void lite::set_tensor_rt_int8_calibration(
+        const std::vector<std::unordered_map<std::string, std::shared_ptr<Tensor>>>&) {
+    LITE_THROW("mge is disbale at build time, please build with mge");
+}
 #endif
 namespace lite {
 REGIST_DECRYPTION_METHOD(
         "AES_default", lite::AESDcryption::decrypt_model,
         lite::AESDcryption::get_decrypt_key());
 
+REGIST_DECRYPTION_STREAM_METHOD("AES_default", lite::AESDcryption::make_decrypt_stream);
+
 REGIST_DECRYPTION_METHOD(
         "RC4_default", lite::RC4::decrypt_model, lite::RC4::get_decrypt_key());
 
@@ -109,6 +109,32 @@ inline void call_func<NetworkImplDft, void>(
         CALL_FUNC(set_cpu_threads_number, num);
     } else if (func_name == "set_network_algo_workspace_limit") {
         CALL_FUNC(set_network_algo_workspace_limit, num);
+    } else if (func_name == "set_network_memory_budget") {
+        CALL_FUNC(set_network_memory_budget, num);
+    } else {
+        THROW_FUNC_ERROR(func_name);
+    }
+}
+
+template <>
+inline void call_func<NetworkImplDft, void>(
+        std::string func_name, Network::NetworkImplBase* network_impl, size_t num0,
+        size_t num1) {
+    if (func_name == "set_runtime_thread_wait_policy") {
+        CALL_FUNC(set_runtime_thread_wait_policy, num0, num1);
+    } else if (func_name == "enable_sampling_profiler") {
+        CALL_FUNC(enable_sampling_profiler, num0, num1);
+    } else {
+        THROW_FUNC_ERROR(func_name);
+    }
+}
+
+template <>
+inline void call_func<NetworkImplDft, void>(
+        std::string func_name, Network::NetworkImplBase* network_impl,
+        LiteTaskPriority priority) {
+    if (func_name == "set_runtime_thread_priority") {
+        CALL_FUNC(set_runtime_thread_priority, priority);
     } else {
         THROW_FUNC_ERROR(func_name);
     }
@@ -131,6 +157,17 @@ inline size_t call_func<NetworkImplDft, size_t>(
         std::string func_name, Network::NetworkImplBase* network_impl) {
     if (func_name == "get_cpu_threads_number") {
         return CALL_FUNC(get_cpu_threads_number);
+    } else if (func_name == "get_network_memory_peak") {
+        return CALL_FUNC(get_network_memory_peak);
+    }
+    THROW_FUNC_ERROR(func_name);
+}
+
+template <>
+inline std::string call_func<NetworkImplDft, std::string>(
+        std::string func_name, Network::NetworkImplBase* network_impl, bool reset) {
+    if (func_name == "get_sampling_profile") {
+        return CALL_FUNC(get_sampling_profile, reset);
     }
     THROW_FUNC_ERROR(func_name);
 }
@@ -159,11 +196,12 @@ template <>
 inline void call_func<NetworkImplDft, void>(
         std::string func_name, Network::NetworkImplBase* network_impl,
         LiteAlgoSelectStrategy strategy, uint32_t shared_batch_size,
-        bool binary_equal_between_batch) {
+        bool binary_equal_between_batch, uint32_t shape_bucket_size,
+        bool background_profiling) {
     if (func_name == "set_network_algo_policy") {
         return CALL_FUNC(
                 set_network_algo_policy, strategy, shared_batch_size,
-                binary_equal_between_batch);
+                binary_equal_between_batch, shape_bucket_size, background_profiling);
     }
     THROW_FUNC_ERROR(func_name);
 }
@@ -190,6 +228,16 @@ inline void call_func<NetworkImplDft, void>(
     THROW_FUNC_ERROR(func_name);
 }
 
+template <>
+inline void call_func<NetworkImplDft, void>(
+        std::string func_name, Network::NetworkImplBase* network_impl,
+        std::string file_name0, std::string file_name1) {
+    if (func_name == "enable_roofline_report") {
+        return CALL_FUNC(enable_roofline_report, file_name0, file_name1);
+    }
+    THROW_FUNC_ERROR(func_name);
+}
+
 template <>
 inline void call_func<NetworkImplDft, void>(
         std::string func_name, Network::NetworkImplBase* network_impl,
@@ -198,6 +246,8 @@ inline void call_func<NetworkImplDft, void>(
         CALL_FUNC(share_runtime_memory_with, src_network_impl);
     } else if (func_name == "shared_weight_with") {
         CALL_FUNC(shared_weight_with, src_network_impl);
+    } else if (func_name == "shared_weight_by_value_with") {
+        CALL_FUNC(shared_weight_by_value_with, src_network_impl);
     } else {
         THROW_FUNC_ERROR(func_name);
     }
@@ -35,6 +35,7 @@
 #include <fstream>
 #include <memory>
 #include <set>
+#include <sstream>
 
 using namespace lite;
 using namespace mgb;
@@ -53,7 +54,9 @@ void NetworkImplDft::shared_weight_with(const NetworkImplBase* src_network) {
     application_config();
     const auto& src_impl = src_network->cast_final_safe<NetworkImplDft>();
     LITE_ASSERT(src_impl.m_loader, "Clone network must after the network is loaded.");
+    Timer timer("load");
     m_load_result = src_impl.m_loader->load(m_load_config, true);
+    m_parse_ms = timer.get_used_time();
 
     //! flag weather the mode is cross compnode model
     cross_compnode_model_detect();
@@ -62,7 +65,9 @@ void NetworkImplDft::shared_weight_with(const NetworkImplBase* src_network) {
     update_io();
 
     //! replace the IO when there is device input or output
+    timer.reset_start();
     compile_graph();
+    m_compile_ms = timer.get_used_time();
 }
 
 void NetworkImplDft::application_config() {
@@ -79,10 +84,14 @@ void NetworkImplDft::application_config() {
 
     auto&& options = m_load_config.comp_graph->options();
     ConfigOption(graph_opt.weight_preprocess, weight_preprocess);
+    ConfigOption(graph_opt.weight_preprocess_cache, weight_preprocess_cache);
     ConfigOption(graph_opt.fuse_preprocess, fuse_preprocess);
     ConfigOption(fake_next_exec, fake_next_exec);
     ConfigOption(var_sanity_check_first_run, var_sanity_check_first_run);
     m_load_config.const_var_shape = m_user_config->options.const_shape;
+    if (m_user_config->options.const_shape) {
+        options.graph_opt.enable_fold_const_shape();
+    }
     ConfigOption(force_dynamic_alloc, force_dynamic_alloc);
     ConfigOption(force_output_dynamic_alloc, force_output_dynamic_alloc);
     ConfigOption(no_profiling_on_shape_change, no_profiling_on_shape_change);
@@ -93,6 +102,7 @@ void NetworkImplDft::application_config() {
             "jit only support in cuda device.");
     ConfigOption(graph_opt.jit, jit_level);
     ConfigOption(comp_node_seq_record_level, comp_node_seq_record_level);
+    ConfigOption(comp_node_seq_record_cache_size, comp_node_seq_record_cache_size);
     ConfigOption(graph_opt_level, graph_opt_level);
     ConfigOption(async_exec_level, async_exec_level);
 
@@ -140,6 +150,16 @@ void NetworkImplDft::set_memory_allocator(std::shared_ptr<Allocator> user_alloca
     m_load_config.comp_graph->set_device_memory_allocator(allocator);
 }
 
+void NetworkImplDft::shared_weight_by_value_with(NetworkImplBase* src_network) {
+    LITE_ASSERT(src_network);
+    auto&& src_pool = src_network->cast_final_safe<NetworkImplDft>()
+                              .m_load_config.shared_tensor_value_pool;
+    if (!src_pool) {
+        src_pool = std::make_shared<mgb::serialization::SharedTensorValuePool>();
+    }
+    m_load_config.shared_tensor_value_pool = src_pool;
+}
+
 //! share the runtime memory with other network, the weights is not shared
 void NetworkImplDft::share_runtime_memory_with(Network::NetworkImplBase* network_impl) {
     LITE_ASSERT(network_impl);
@@ -191,6 +211,32 @@ void NetworkImplDft::set_runtime_thread_affinity(
     }
 }
 
+void NetworkImplDft::set_runtime_thread_wait_policy(size_t nr_spin, size_t nr_yield) {
+    LITE_ASSERT(
+            m_user_config->device_type == LiteDeviceType::LITE_CPU,
+            "multi threads mode is only avaliable in CPU.");
+    if (m_nr_threads > 1) {
+        mgb::CompNode::Locator loc;
+        m_load_config.comp_node_mapper(loc);
+        auto cn = mgb::CompNode::load(loc);
+        mgb::CompNodeEnv::from_comp_node(cn).cpu_env().set_wait_policy(
+                nr_spin, nr_yield);
+    }
+}
+
+void NetworkImplDft::set_runtime_thread_priority(LiteTaskPriority priority) {
+    LITE_ASSERT(
+            m_user_config->device_type == LiteDeviceType::LITE_CPU,
+            "multi threads mode is only avaliable in CPU.");
+    if (m_nr_threads > 1) {
+        mgb::CompNode::Locator loc;
+        m_load_config.comp_node_mapper(loc);
+        auto cn = mgb::CompNode::load(loc);
+        mgb::CompNodeEnv::from_comp_node(cn).cpu_env().set_priority(
+                static_cast<mgb::TaskPriority>(priority));
+    }
+}
+
 void NetworkImplDft::set_device_id(int device_id) {
     m_compnode_locator.device = device_id;
     m_user_config->device_id = device_id;
@@ -332,12 +378,58 @@ void NetworkImplDft::cross_compnode_model_detect() {
     m_nr_device_type = nr_used_device_type.size();
 }
 
+namespace {
+//! InputFile that decrypts the model as it is read, so tensor values are
+//! decrypted directly into their storage
+class DecryptionInputFile final : public mgb::serialization::InputFile {
+    std::unique_ptr<DecryptionStream> m_stream;
+    size_t m_offset = 0;
+
+public:
+    explicit DecryptionInputFile(std::unique_ptr<DecryptionStream> stream)
+            : m_stream{std::move(stream)} {}
+
+    void rewind() override { m_offset = 0; }
+
+    void skip(size_t bytes) override {
+        LITE_ASSERT(
+                bytes <= m_stream->size() - m_offset,
+                "skip %zu bytes at %zu beyond the end of the model", bytes,
+                m_offset);
+        m_offset += bytes;
+    }
+
+    void read(void* dst, size_t size) override {
+        m_stream->decrypt(m_offset, dst, size);
+        m_offset += size;
+    }
+
+    size_t tell() override { return m_offset; }
+};
+}  // namespace
+
 void NetworkImplDft::load_model(
         std::shared_ptr<void> model_mem, size_t size,
         std::unordered_map<std::string, LiteAny> separate_config_map) {
     if (!m_loader) {
         m_input_file =
                 mgb::serialization::InputFile::make_mem_proxy(model_mem, size, false);
+    }
+    load_model_from_input_file(std::move(separate_config_map));
+}
+
+void NetworkImplDft::load_model_stream(
+        std::unique_ptr<DecryptionStream> stream,
+        std::unordered_map<std::string, LiteAny> separate_config_map) {
+    if (!m_loader) {
+        m_input_file = std::make_unique<DecryptionInputFile>(std::move(stream));
+    }
+    load_model_from_input_file(std::move(separate_config_map));
+}
+
+void NetworkImplDft::load_model_from_input_file(
+        std::unordered_map<std::string, LiteAny> separate_config_map) {
+    if (!m_loader) {
         auto format = mgb::serialization::GraphLoader::identify_graph_dump_format(
                 *m_input_file);
         if (!format.valid()) {
@@ -368,7 +460,9 @@ void NetworkImplDft::load_model(
         use_tensorrt();
     }
 
+    Timer timer("load");
     m_load_result = m_loader->load(m_load_config, true);
+    m_parse_ms = timer.get_used_time();
 
     cross_compnode_model_detect();
 
@@ -376,11 +470,16 @@ void NetworkImplDft::load_model(
     update_io();
 
     //! replace the IO when there is device input or output
+    timer.reset_start();
     compile_graph();
+    m_compile_ms = timer.get_used_time();
 }
 
 void NetworkImplDft::compile_graph() {
     modify_exection_policy();
+    if (m_memory_budget) {
+        set_network_algo_workspace_limit(m_memory_budget);
+    }
     replace_dev_input_pass();
     make_output_spec();
     m_execute_func = m_load_result.graph_compile(m_output_spec);
@@ -413,6 +512,43 @@ void NetworkImplDft::wait() {
     finish();
 }
 
+PrepareTiming NetworkImplDft::prepare(
+        const std::vector<std::unordered_map<std::string, Layout>>& shapes_list) {
+    LITE_ASSERT(m_execute_func, "prepare must be called after network loaded.");
+    PrepareTiming timing;
+    timing.parse_ms = m_parse_ms;
+    timing.compile_ms = m_compile_ms;
+    auto&& options = m_load_config.comp_graph->options();
+    //! the recorder asserts that the fake execution is only the first run
+    //! without var sanity check, so the memory plan is not timed separately
+    bool fake_exec = !options.comp_node_seq_record_level;
+    //! the warmup runs should not call the async callback of the user
+    bool async = m_async;
+    m_async = false;
+    for (auto&& shapes : shapes_list) {
+        for (auto&& shape : shapes) {
+            auto tensor = get_io_tensor(shape.first, LiteTensorPhase::LITE_INPUT);
+            tensor->set_layout(shape.second);
+            tensor->fill_zero();
+        }
+        Timer timer("prepare");
+        double mem_plan_ms = 0;
+        if (fake_exec) {
+            //! the fake execution only plans the memory and initializes the
+            //! oprs, it is reset by the graph after the execution
+            options.fake_next_exec = true;
+            m_execute_func->execute().wait();
+            mem_plan_ms = timer.get_used_time();
+            timer.reset_start();
+        }
+        m_execute_func->execute().wait();
+        timing.mem_plan_ms.push_back(mem_plan_ms);
+        timing.first_run_ms.push_back(timer.get_used_time());
+    }
+    m_async = async;
+    return timing;
+}
+
 void NetworkImplDft::finish() const {
     if (m_async) {
         LITE_ASSERT(m_async_callback, "The callback func must set when async mode.");
@@ -627,7 +763,8 @@ std::shared_ptr<Tensor> NetworkImplDft::get_output_tensor(size_t index) {
 //! set opr algorithm selection strategy in the network
 void NetworkImplDft::set_network_algo_policy(
         LiteAlgoSelectStrategy strategy, uint32_t shared_batch_size,
-        bool binary_equal_between_batch) {
+        bool binary_equal_between_batch, uint32_t shape_bucket_size,
+        bool background_profiling) {
     using S = megdnn::param::ExecutionPolicy::Strategy;
     auto dst_strategy = static_cast<S>(0);
     if (static_cast<uint32_t>(strategy) & LiteAlgoSelectStrategy::LITE_ALGO_HEURISTIC) {
@@ -648,6 +785,8 @@ void NetworkImplDft::set_network_algo_policy(
     auto&& fast_run_config = m_load_config.comp_graph->options().fast_run_config;
     fast_run_config.binary_equal_between_batch = binary_equal_between_batch;
     fast_run_config.shared_batch_size = shared_batch_size;
+    fast_run_config.shape_bucket_size = shape_bucket_size;
+    fast_run_config.background_profiling = background_profiling;
 
     if (m_execute_func) {
         LITE_WARN(
@@ -675,6 +814,27 @@ void NetworkImplDft::set_network_algo_workspace_limit(size_t workspace_limit) {
     mgb::gopt::set_opr_algo_workspace_limit_inplace(vars, workspace_limit);
 }
 
+void NetworkImplDft::set_network_memory_budget(size_t memory_budget) {
+    m_memory_budget = memory_budget;
+#if MGB_ENABLE_DTR
+    //! the static memory plan is simulated with the budget and the evicted
+    //! activations are recomputed, which costs time only when it is exceeded
+    auto&& options = m_load_config.comp_graph->options();
+    options.enable_dtr_memory_opt = memory_budget != 0;
+    options.dtr_config.eviction_threshold = memory_budget;
+#else
+    LITE_WARN(
+            "recomputation is not avaliable in this build, only the workspace "
+            "is limited by the memory budget.");
+#endif
+}
+
+size_t NetworkImplDft::get_network_memory_peak() {
+    mgb::CompNode::Locator loc;
+    m_load_config.comp_node_mapper(loc);
+    return m_load_config.comp_graph->get_device_memory_size(mgb::CompNode::load(loc));
+}
+
 //! get the input tensor name in the order of graph
 std::vector<const char*> NetworkImplDft::get_all_output_name() const {
     std::vector<const char*> output_names;
@@ -722,7 +882,10 @@ void NetworkImplDft::enable_profile_performance(std::string profile_json_file) {
 #if MGB_OPENCL
     mgb::CompNode::enable_opencl_profile(true);
 #endif
-    m_profiler = std::make_unique<mgb::GraphProfiler>(m_load_config.comp_graph.get());
+    if (!m_profiler) {
+        m_profiler =
+                std::make_unique<mgb::GraphProfiler>(m_load_config.comp_graph.get());
+    }
     m_profiler_output_file = profile_json_file;
 #else
     LITE_MARK_USED_VAR(profile_json_file);
@@ -730,6 +893,49 @@ void NetworkImplDft::enable_profile_performance(std::string profile_json_file) {
 #endif
 }
 
+void NetworkImplDft::enable_roofline_report(
+        std::string report_file, std::string device_spec_file) {
+#if MGB_ENABLE_JSON
+    if (!device_spec_file.empty()) {
+        std::ifstream fin{device_spec_file};
+        LITE_ASSERT(fin.good(), "failed to open %s.", device_spec_file.c_str());
+        std::stringstream content;
+        content << fin.rdbuf();
+        m_roofline_spec = mgb::GraphProfiler::parse_device_spec(content.str());
+    }
+    if (!m_profiler) {
+        m_profiler =
+                std::make_unique<mgb::GraphProfiler>(m_load_config.comp_graph.get());
+    }
+    m_roofline_output_file = report_file;
+#else
+    LITE_MARK_USED_VAR(report_file);
+    LITE_MARK_USED_VAR(device_spec_file);
+    LITE_THROW("JSON is disable at compile time.");
+#endif
+}
+
+void NetworkImplDft::enable_sampling_profiler(
+        size_t sample_interval, size_t nr_opr_slices) {
+    mgb::SamplingProfiler::Options options;
+    options.sample_interval = sample_interval;
+    options.nr_opr_slices = nr_opr_slices;
+    m_sampling_profiler = std::make_unique<mgb::SamplingProfiler>(
+            m_load_config.comp_graph.get(), options);
+}
+
+std::string NetworkImplDft::get_sampling_profile(bool reset) {
+    LITE_ASSERT(m_sampling_profiler, "the sampling profiler is not enabled.");
+#if MGB_ENABLE_JSON
+    std::string ret;
+    m_sampling_profiler->to_json(reset)->writeto(ret);
+    return ret;
+#else
+    LITE_MARK_USED_VAR(reset);
+    LITE_THROW("JSON is disable at compile time.");
+#endif
+}
+
 void NetworkImplDft::enable_io_txt_dump(std::string io_txt_out_file) {
     auto iodump = std::make_unique<mgb::TextOprIODump>(
             m_load_config.comp_graph.get(), io_txt_out_file.c_str());
@@ -744,10 +950,14 @@ void NetworkImplDft::enable_io_bin_dump(std::string io_bin_out_dir) {
 
 void inline NetworkImplDft::output_plugin_result() const {
 #if MGB_ENABLE_JSON
-    if (m_profiler && m_execute_func) {
+    if (m_profiler && m_execute_func && !m_profiler_output_file.empty()) {
         m_profiler->to_json_full(m_execute_func.get())
                 ->writeto_fpath(m_profiler_output_file);
     }
+    if (m_profiler && m_execute_func && !m_roofline_output_file.empty()) {
+        m_profiler->to_roofline_json(m_roofline_spec)
+                ->writeto_fpath(m_roofline_output_file);
+    }
 #endif
 }
 #endif
@@ -21,6 +21,7 @@
 #include "megbrain/graph/bases.h"
 #include "megbrain/plugin/opr_io_dump.h"
 #include "megbrain/plugin/profiler.h"
+#include "megbrain/plugin/sampling_profiler.h"
 #include "megbrain/serialization/extern_c_opr.h"
 #include "megbrain/serialization/file.h"
 #include "megbrain/serialization/load_dump_config.h"
@@ -97,6 +98,12 @@ public:
             std::shared_ptr<void> model_mem, size_t size,
             std::unordered_map<std::string, LiteAny> separate_config_map = {}) override;
 
+    //! load the model from a decryption stream without decrypting the whole
+    //! model into a new buffer
+    void load_model_stream(
+            std::unique_ptr<DecryptionStream> stream,
+            std::unordered_map<std::string, LiteAny> separate_config_map = {}) override;
+
     //! forward the network with filled input data and fill the output data
     //! to the output tensor
     void forward() override;
@@ -104,6 +111,12 @@ public:
     //! in sync model, wait utile the inference finish
     void wait() override;
 
+    //! plan the memory by a fake execution and run once for each set of input
+    //! layouts
+    PrepareTiming prepare(
+            const std::vector<std::unordered_map<std::string, Layout>>& shapes_list)
+            override;
+
     virtual LiteDeviceType get_device_type() const override {
         return m_user_config->device_type;
     }
@@ -137,24 +150,41 @@ public:
     //! load a new network which will share weights with src network
     void shared_weight_with(const NetworkImplBase* src_network);
 
+    //! share params with identical values with src network when loading
+    //! models; both networks must not be loaded yet
+    void shared_weight_by_value_with(NetworkImplBase* src_network);
+
     //! share the runtime memory with other network, the weights is not shared
     void share_runtime_memory_with(NetworkImplBase* network);
     //! set threads affinity callback;
     void set_runtime_thread_affinity(
             const ThreadAffinityCallback& thread_affinity_callback);
 
+    //! set how the idle threads wait for new tasks in multi thread mode
+    void set_runtime_thread_wait_policy(size_t nr_spin, size_t nr_yield);
+
+    //! set the priority of the tasks on the shared thread pool
+    void set_runtime_thread_priority(LiteTaskPriority priority);
+
     //! set the network memroy allocator, the allocator is defined by user
     void set_memory_allocator(std::shared_ptr<Allocator> user_allocator);
 
     //! set opr algorithm selection strategy in the network
     void set_network_algo_policy(
             LiteAlgoSelectStrategy strategy, uint32_t shared_batch_size,
-            bool binary_equal_between_batch);
+            bool binary_equal_between_batch, uint32_t shape_bucket_size,
+            bool background_profiling);
 
     //! set workspace_limit for oprs with multiple algorithms, set
     //! workspace limitation can save memory but may influence the performance
     void set_network_algo_workspace_limit(size_t workspace_limit);
 
+    //! set the memory budget of the network, used when the graph is compiled
+    void set_network_memory_budget(size_t memory_budget);
+
+    //! get the size of the static memory allocated by the network
+    size_t get_network_memory_peak();
+
     //! Dump input/output values of all internal variables to output file,
     //! in text format
     void enable_io_txt_dump(std::string io_txt_out_file);
@@ -163,7 +193,21 @@ public:
     //! directory, in binary format
     void enable_io_bin_dump(std::string io_bin_out_dir);
 
+    //! write the roofline report of the oprs after each forward
+    void enable_roofline_report(std::string report_file, std::string device_spec_file);
+
+    //! enable the sampling profiler before the model is loaded
+    void enable_sampling_profiler(size_t sample_interval, size_t nr_opr_slices);
+
+    //! get the aggregates of the sampling profiler in JSON format
+    std::string get_sampling_profile(bool reset);
+
 private:
+    //! load the model from m_input_file, or reload it from the existing
+    //! loader
+    void load_model_from_input_file(
+            std::unordered_map<std::string, LiteAny> separate_config_map);
+
     //! construct the outputspec according to the m_network_io, and set the
     //! call_back to the outputspec
     void make_output_spec();
@@ -206,6 +250,7 @@ private:
     bool m_is_cpu_inplace_mode = false;
     int m_nr_device_type = 0;
     size_t m_nr_threads = 1;
+    size_t m_memory_budget = 0;
     bool m_compute_configured_output_only = false;
     mgb::CompNode::Locator m_compnode_locator;
 
@@ -221,6 +266,8 @@ private:
     mgb::serialization::GraphLoader::LoadResult m_load_result;
     mgb::ComputingGraph::OutputSpec m_output_spec;
     std::shared_ptr<mgb::serialization::GraphLoader> m_loader;
+    //! time of the model load, reported by prepare()
+    double m_parse_ms = 0, m_compile_ms = 0;
 
     //! start and finish callback
     StartCallback m_start_callback = nullptr;
@@ -230,7 +277,10 @@ private:
 #if MGB_ENABLE_JSON
     std::unique_ptr<mgb::GraphProfiler> m_profiler;
     std::string m_profiler_output_file;
+    std::string m_roofline_output_file;
+    mgb::GraphProfiler::DeviceSpecTable m_roofline_spec;
 #endif
+    std::unique_ptr<mgb::SamplingProfiler> m_sampling_profiler;
     std::unique_ptr<mgb::OprIODumpBase> m_iodump;
 };
 
@@ -0,0 +1,342 @@
+/**
+ * \file src/multi_device_network.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/multi_device_network.h"
+#include "lite/global.h"
+#include "misc.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace lite;
+
+class MultiDeviceNetwork::Impl {
+public:
+    Impl(std::string model_path, const MultiDeviceOptions& options,
+         const Config& config, const NetworkIO& network_io);
+    ~Impl();
+
+    std::future<IOBindings> forward(const IOBindings& inputs, Callback callback);
+
+    void wait();
+
+    size_t nr_devices() const { return m_devices.size(); }
+
+    const std::shared_ptr<Network>& get_network(size_t idx) const {
+        LITE_ASSERT(
+                idx < m_devices.size(), "device index %zu out of range %zu.", idx,
+                m_devices.size());
+        return m_devices[idx].network;
+    }
+
+    std::vector<DeviceStats> get_stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        IOBindings inputs;
+        Callback callback;
+        std::promise<IOBindings> promise;
+    };
+
+    struct Device {
+        int device_id;
+        std::shared_ptr<Network> network;
+        std::deque<Request> queue;
+        bool running = false;
+        size_t nr_requests = 0;
+        double service_ms = 0;
+
+        size_t depth() const { return queue.size() + running; }
+    };
+
+    //! the device to take the next request, with m_mtx held
+    size_t route() const;
+
+    void worker(size_t idx);
+
+    static IOBindings run(Network* network, const IOBindings& inputs);
+
+    const MultiDeviceOptions m_options;
+    //! the model read from the file, which the replicas are loaded from
+    std::shared_ptr<void> m_model;
+
+    mutable std::mutex m_mtx;
+    //! signaled when a request is queued or finished
+    std::condition_variable m_cv;
+    std::vector<Device> m_devices;
+    size_t m_nr_in_flight = 0;
+    //! whether the other devices can start, see share_fast_run_cache
+    bool m_first_done = false;
+    bool m_stop = false;
+
+    std::vector<std::thread> m_workers;
+};
+
+MultiDeviceNetwork::Impl::Impl(
+        std::string model_path, const MultiDeviceOptions& options,
+        const Config& config, const NetworkIO& network_io)
+        : m_options{options} {
+    LITE_ASSERT(m_options.max_queue_depth > 0, "max_queue_depth should be positive.");
+    auto device_ids = m_options.device_ids;
+    if (device_ids.empty()) {
+        size_t nr_devices = get_device_count(config.device_type);
+        for (size_t i = 0; i < nr_devices; ++i) {
+            device_ids.push_back(i);
+        }
+    }
+    LITE_ASSERT(!device_ids.empty(), "no device to load the model on.");
+    m_first_done = !m_options.share_fast_run_cache || device_ids.size() == 1;
+
+    FILE* fin = fopen(model_path.c_str(), "rb");
+    LITE_ASSERT(fin, "failed to open %s: %s", model_path.c_str(), strerror(errno));
+    fseek(fin, 0, SEEK_END);
+    size_t size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    m_model = std::shared_ptr<void>{malloc(size), ::free};
+    auto nr = fread(m_model.get(), 1, size, fin);
+    fclose(fin);
+    LITE_ASSERT(nr == size, "failed to read %s.", model_path.c_str());
+
+    m_devices = std::vector<Device>(device_ids.size());
+    std::vector<std::exception_ptr> errors(device_ids.size());
+    std::vector<std::thread> loaders;
+    for (size_t i = 0; i < device_ids.size(); ++i) {
+        auto&& device = m_devices[i];
+        device.device_id = device_ids[i];
+        device.network = std::make_shared<Network>(config, network_io);
+        device.network->set_device_id(device.device_id);
+        //! the weights are copied to the devices in parallel, while the
+        //! model in host memory is shared and only read
+        loaders.emplace_back([this, &device, &error = errors[i], size]() {
+#if LITE_ENABLE_EXCEPTION
+            try {
+                device.network->load_model(m_model.get(), size);
+            } catch (...) {
+                error = std::current_exception();
+            }
+#else
+            LITE_MARK_USED_VAR(error);
+            device.network->load_model(m_model.get(), size);
+#endif
+        });
+    }
+    for (auto&& loader : loaders) {
+        loader.join();
+    }
+    for (auto&& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (size_t i = 0; i < m_devices.size(); ++i) {
+        m_workers.emplace_back([this, i]() { worker(i); });
+    }
+}
+
+MultiDeviceNetwork::Impl::~Impl() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto&& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t MultiDeviceNetwork::Impl::route() const {
+    bool measured = true;
+    for (auto&& device : m_devices) {
+        measured &= device.service_ms > 0;
+    }
+    //! the expected time to finish the request on a device, which is the
+    //! queue depth until all the devices are measured
+    auto cost = [measured](const Device& device) {
+        double depth = device.depth() + 1;
+        return measured ? depth * device.service_ms : depth;
+    };
+    size_t best = m_devices.size();
+    for (size_t i = 0; i < m_devices.size(); ++i) {
+        if (m_devices[i].depth() >= m_options.max_queue_depth) {
+            continue;
+        }
+        if (best == m_devices.size() || cost(m_devices[i]) < cost(m_devices[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::future<IOBindings> MultiDeviceNetwork::Impl::forward(
+        const IOBindings& inputs, Callback callback) {
+    Request request;
+    for (auto&& input : inputs) {
+        LITE_CHECK_NON_NULL_POINTER(input.second);
+        auto snapshot = std::make_shared<Tensor>(
+                input.second->get_device_id(), input.second->get_device_type());
+        snapshot->copy_from(*input.second);
+        request.inputs[input.first] = std::move(snapshot);
+    }
+    request.callback = std::move(callback);
+    auto future = request.promise.get_future();
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        size_t idx;
+        m_cv.wait(lock, [this, &idx]() {
+            idx = route();
+            return m_stop || idx < m_devices.size();
+        });
+        LITE_ASSERT(!m_stop, "forward on a stopped MultiDeviceNetwork.");
+        ++m_nr_in_flight;
+        m_devices[idx].queue.emplace_back(std::move(request));
+    }
+    m_cv.notify_all();
+    return future;
+}
+
+void MultiDeviceNetwork::Impl::wait() {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this]() { return m_nr_in_flight == 0; });
+}
+
+IOBindings MultiDeviceNetwork::Impl::run(Network* network, const IOBindings& inputs) {
+    network->forward(inputs);
+    network->wait();
+    IOBindings outputs;
+    for (auto&& name : network->get_all_output_name()) {
+        auto src = network->get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT);
+        auto dst = std::make_shared<Tensor>(
+                src->get_device_id(), src->get_device_type());
+        dst->copy_from(*src);
+        outputs[name] = std::move(dst);
+    }
+    return outputs;
+}
+
+void MultiDeviceNetwork::Impl::worker(size_t idx) {
+    auto&& device = m_devices[idx];
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            auto ready = [this, idx, &device]() {
+                return !device.queue.empty() && (idx == 0 || m_first_done);
+            };
+            m_cv.wait(lock, [this, &device, &ready]() {
+                return (m_stop && device.queue.empty()) || ready();
+            });
+            if (!ready()) {
+                return;
+            }
+            request = std::move(device.queue.front());
+            device.queue.pop_front();
+            device.running = true;
+        }
+        auto start = Clock::now();
+        IOBindings outputs;
+#if LITE_ENABLE_EXCEPTION
+        try {
+            outputs = run(device.network.get(), request.inputs);
+            request.promise.set_value(outputs);
+        } catch (...) {
+            request.promise.set_exception(std::current_exception());
+        }
+#else
+        outputs = run(device.network.get(), request.inputs);
+        request.promise.set_value(outputs);
+#endif
+        double ms =
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            //! the first request is skipped, which includes the warm up and
+            //! the profiling
+            if (device.nr_requests) {
+                device.service_ms = device.service_ms > 0
+                                          ? device.service_ms * 0.75 + ms * 0.25
+                                          : ms;
+            }
+            ++device.nr_requests;
+            device.running = false;
+            m_first_done = true;
+            --m_nr_in_flight;
+        }
+        m_cv.notify_all();
+        if (request.callback) {
+            request.callback(outputs);
+        }
+    }
+}
+
+std::vector<MultiDeviceNetwork::DeviceStats> MultiDeviceNetwork::Impl::get_stats()
+        const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    std::vector<DeviceStats> stats;
+    for (auto&& device : m_devices) {
+        stats.push_back(
+                {device.device_id, device.nr_requests, device.depth(),
+                 device.service_ms});
+    }
+    return stats;
+}
+
+/*********************** MultiDeviceNetwork ***************/
+MultiDeviceNetwork::MultiDeviceNetwork(
+        std::string model_path, const MultiDeviceOptions& options,
+        const Config& config, const NetworkIO& network_io) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(std::move(model_path), options, config, network_io);
+    LITE_ERROR_HANDLER_END
+}
+
+MultiDeviceNetwork::~MultiDeviceNetwork() = default;
+
+std::future<IOBindings> MultiDeviceNetwork::forward(
+        const IOBindings& inputs, Callback callback) {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->forward(inputs, std::move(callback));
+    LITE_ERROR_HANDLER_END
+}
+
+void MultiDeviceNetwork::wait() {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl->wait();
+    LITE_ERROR_HANDLER_END
+}
+
+size_t MultiDeviceNetwork::nr_devices() const {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->nr_devices();
+    LITE_ERROR_HANDLER_END
+}
+
+const std::shared_ptr<Network>& MultiDeviceNetwork::get_network(size_t idx) const {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->get_network(idx);
+    LITE_ERROR_HANDLER_END
+}
+
+std::vector<MultiDeviceNetwork::DeviceStats> MultiDeviceNetwork::get_stats() const {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->get_stats();
+    LITE_ERROR_HANDLER_END
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
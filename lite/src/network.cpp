@@ -20,6 +20,7 @@
 #include "mge/network_impl.h"
 #endif
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 
@@ -100,11 +101,15 @@ void Network::prase_model(std::shared_ptr<void> model_data, size_t size) {
         m_impl->set_config(m_config);
         m_impl->set_io(m_network_io);
     }
-    //! decryption the model
-    size_t model_length;
-    auto&& model_shared_ptr = model_parser.parse_model(model_length, m_config);
-
-    m_impl->load_model(model_shared_ptr, model_length, separate_config_map);
+    //! decryption the model, while it is loaded if the decryption method
+    //! supports streaming
+    if (auto stream = model_parser.parse_model_stream(m_config)) {
+        m_impl->load_model_stream(std::move(stream), separate_config_map);
+    } else {
+        size_t model_length;
+        auto&& model_shared_ptr = model_parser.parse_model(model_length, m_config);
+        m_impl->load_model(model_shared_ptr, model_length, separate_config_map);
+    }
     m_loaded = true;
     update_from_implement();
 }
@@ -154,7 +159,8 @@ std::shared_ptr<Tensor> Network::get_output_tensor(size_t index) {
 Network& Network::set_async_callback(const AsyncCallback& callback) {
     LITE_ERROR_HANDLER_BEGIN
     LITE_CHECK_NON_NULL_POINTER(m_impl);
-    m_impl->set_async_callback(std::move(callback));
+    m_impl->set_async_callback(callback);
+    m_async_callback = callback;
     return *this;
     LITE_ERROR_HANDLER_END
 }
@@ -162,7 +168,8 @@ Network& Network::set_async_callback(const AsyncCallback& callback) {
 Network& Network::set_start_callback(const StartCallback& callback) {
     LITE_ERROR_HANDLER_BEGIN
     LITE_CHECK_NON_NULL_POINTER(m_impl);
-    m_impl->set_start_callback(std::move(callback));
+    m_impl->set_start_callback(callback);
+    m_start_callback = callback;
     return *this;
     LITE_ERROR_HANDLER_END
 }
@@ -170,7 +177,8 @@ Network& Network::set_start_callback(const StartCallback& callback) {
 Network& Network::set_finish_callback(const FinishCallback& callback) {
     LITE_ERROR_HANDLER_BEGIN
     LITE_CHECK_NON_NULL_POINTER(m_impl);
-    m_impl->set_finish_callback(std::move(callback));
+    m_impl->set_finish_callback(callback);
+    m_finish_callback = callback;
     return *this;
     LITE_ERROR_HANDLER_END
 }
@@ -197,6 +205,42 @@ void Network::forward() {
     LITE_ERROR_HANDLER_BEGIN
     LITE_ASSERT(m_loaded, "forward should be used after model loaded.");
     LITE_CHECK_NON_NULL_POINTER(m_impl.get());
+    auto old_impl = switch_to_swapped();
+    m_impl->forward();
+    LITE_ERROR_HANDLER_END
+}
+
+void Network::forward(const IOBindings& bindings) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_ASSERT(m_loaded, "forward should be used after model loaded.");
+    LITE_CHECK_NON_NULL_POINTER(m_impl.get());
+    //! the old implement is released after the request is dispatched
+    auto old_impl = switch_to_swapped();
+    auto input_names = get_all_input_name();
+    for (auto&& binding : bindings) {
+        auto&& name = binding.first;
+        auto&& user_tensor = binding.second;
+        LITE_CHECK_NON_NULL_POINTER(user_tensor);
+        bool is_input = std::find(input_names.begin(), input_names.end(), name) !=
+                        input_names.end();
+        auto io_tensor =
+                get_io_tensor(name, is_input ? LiteTensorPhase::LITE_INPUT
+                                             : LiteTensorPhase::LITE_OUTPUT);
+        LITE_ASSERT(
+                io_tensor->get_device_type() == user_tensor->get_device_type(),
+                "the tensor bound to %s is not on the device of the io tensor, "
+                "please config the io with is_host.",
+                name.c_str());
+        //! the host output of a device is copied by the comp node of the device,
+        //! which would drop a storage of other memory node
+        LITE_ASSERT(
+                is_input || m_config.device_type == LiteDeviceType::LITE_CPU ||
+                        io_tensor->get_device_type() != LiteDeviceType::LITE_CPU ||
+                        user_tensor->is_pinned_host(),
+                "the host output %s should be bound to a pinned host tensor.",
+                name.c_str());
+        io_tensor->share_memory_with(*user_tensor);
+    }
     m_impl->forward();
     LITE_ERROR_HANDLER_END
 }
@@ -209,6 +253,74 @@ void Network::wait() {
     LITE_ERROR_HANDLER_END
 }
 
+PrepareTiming Network::prepare(
+        const std::vector<std::unordered_map<std::string, Layout>>& shapes_list) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_ASSERT(m_loaded, "prepare should be used after model loaded.");
+    LITE_CHECK_NON_NULL_POINTER(m_impl);
+    return m_impl->prepare(shapes_list);
+    LITE_ERROR_HANDLER_END
+}
+
+PrepareTiming Network::hot_swap(
+        std::string model_path,
+        const std::vector<std::unordered_map<std::string, Layout>>& shapes_list) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_ASSERT(m_loaded, "hot_swap should be used after model loaded.");
+    LITE_CHECK_NON_NULL_POINTER(m_impl);
+    auto network = std::make_unique<Network>(m_config, m_network_io);
+    network->m_impl->set_device_id(m_impl->get_device_id());
+    network->m_impl->set_stream_id(m_impl->get_stream_id());
+    if (m_impl->get_backend_type() == LiteBackend::LITE_DEFAULT &&
+        network->m_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        if (call_func<NetworkImplDft, bool>("is_cpu_inplace_mode", m_impl.get())) {
+            call_func<NetworkImplDft, void>(
+                    "set_cpu_inplace_mode", network->m_impl.get());
+        }
+        auto nr_threads = call_func<NetworkImplDft, size_t>(
+                "get_cpu_threads_number", m_impl.get());
+        if (nr_threads > 1) {
+            call_func<NetworkImplDft, void>(
+                    "set_cpu_threads_number", network->m_impl.get(), nr_threads);
+        }
+    }
+    if (m_async_callback) {
+        network->set_async_callback(m_async_callback);
+    }
+    if (m_start_callback) {
+        network->set_start_callback(m_start_callback);
+    }
+    if (m_finish_callback) {
+        network->set_finish_callback(m_finish_callback);
+    }
+    network->load_model(model_path);
+    auto timing = network->prepare(shapes_list);
+    std::unique_ptr<Network> replaced;
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mtx);
+        //! a model staged but not switched to yet is replaced
+        replaced = std::move(m_swapped_network);
+        m_swapped_network = std::move(network);
+    }
+    return timing;
+    LITE_ERROR_HANDLER_END
+}
+
+std::unique_ptr<Network::NetworkImplBase> Network::switch_to_swapped() {
+    std::unique_ptr<Network> network;
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mtx);
+        network = std::move(m_swapped_network);
+    }
+    if (!network) {
+        return {};
+    }
+    std::swap(m_impl, network->m_impl);
+    m_config = network->m_config;
+    m_extra_info = network->m_extra_info;
+    return std::move(network->m_impl);
+}
+
 std::string Network::get_input_name(size_t index) const {
     LITE_ERROR_HANDLER_BEGIN
     LITE_ASSERT(m_loaded, "get_input_name should be used after model loaded.");
@@ -345,6 +457,39 @@ void Runtime::set_runtime_thread_affinity(
     LITE_ERROR_HANDLER_END
 }
 
+void Runtime::set_runtime_thread_wait_policy(
+        std::shared_ptr<Network> network, size_t nr_spin, size_t nr_yield) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                NetworkHelper::loaded(network),
+                "set_runtime_thread_wait_policy should be used after model "
+                "loaded.");
+        call_func<NetworkImplDft, void>(
+                "set_runtime_thread_wait_policy", network_impl, nr_spin, nr_yield);
+        return;
+    }
+    LITE_THROW("set_runtime_thread_wait_policy is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
+void Runtime::set_runtime_thread_priority(
+        std::shared_ptr<Network> network, LiteTaskPriority priority) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                NetworkHelper::loaded(network),
+                "set_runtime_thread_priority should be used after model loaded.");
+        call_func<NetworkImplDft, void>(
+                "set_runtime_thread_priority", network_impl, priority);
+        return;
+    }
+    LITE_THROW("set_runtime_thread_priority is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
 void Runtime::set_cpu_inplace_mode(std::shared_ptr<Network> network) {
     LITE_ERROR_HANDLER_BEGIN
     auto network_impl = NetworkHelper::implement(network);
@@ -372,13 +517,14 @@ bool Runtime::is_cpu_inplace_mode(const std::shared_ptr<Network> network) {
 //! set opr algorithm selection strategy in the network
 void Runtime::set_network_algo_policy(
         std::shared_ptr<Network> network, LiteAlgoSelectStrategy strategy,
-        uint32_t shared_batch_size, bool binary_equal_between_batch) {
+        uint32_t shared_batch_size, bool binary_equal_between_batch,
+        uint32_t shape_bucket_size, bool background_profiling) {
     LITE_ERROR_HANDLER_BEGIN
     auto network_impl = NetworkHelper::implement(network);
     if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
         call_func<NetworkImplDft, void>(
                 "set_network_algo_policy", network_impl, strategy, shared_batch_size,
-                binary_equal_between_batch);
+                binary_equal_between_batch, shape_bucket_size, background_profiling);
         return;
     }
     LITE_THROW("set_network_algo_policy is not aviliable in the backend.");
@@ -405,6 +551,36 @@ void Runtime::set_network_algo_workspace_limit(
     LITE_ERROR_HANDLER_END
 }
 
+void Runtime::set_network_memory_budget(
+        std::shared_ptr<Network> network, size_t memory_budget) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                !NetworkHelper::loaded(network),
+                "set_network_memory_budget should be used before model loaded.");
+        call_func<NetworkImplDft, void>(
+                "set_network_memory_budget", network_impl, memory_budget);
+        return;
+    }
+    LITE_THROW("set_network_memory_budget is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
+size_t Runtime::get_network_memory_peak(std::shared_ptr<Network> network) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                NetworkHelper::loaded(network),
+                "get_network_memory_peak should be used after model loaded.");
+        return call_func<NetworkImplDft, size_t>(
+                "get_network_memory_peak", network_impl);
+    }
+    LITE_THROW("get_network_memory_peak is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
 //! set the network memroy allocator, the allocator is defined by user
 void Runtime::set_memory_allocator(
         std::shared_ptr<Network> network, std::shared_ptr<Allocator> user_allocator) {
@@ -453,6 +629,51 @@ void Runtime::enable_io_txt_dump(
     LITE_ERROR_HANDLER_END
 }
 
+void Runtime::enable_roofline_report(
+        std::shared_ptr<Network> network, std::string report_file,
+        std::string device_spec_file) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        call_func<NetworkImplDft, void>(
+                "enable_roofline_report", network_impl, report_file,
+                device_spec_file);
+        return;
+    }
+    LITE_THROW("enable_roofline_report is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
+void Runtime::enable_sampling_profiler(
+        std::shared_ptr<Network> network, size_t sample_interval,
+        size_t nr_opr_slices) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                !NetworkHelper::loaded(network),
+                "enable_sampling_profiler should be used before model loaded.");
+        call_func<NetworkImplDft, void>(
+                "enable_sampling_profiler", network_impl, sample_interval,
+                nr_opr_slices);
+        return;
+    }
+    LITE_THROW("enable_sampling_profiler is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
+std::string Runtime::get_sampling_profile(
+        std::shared_ptr<Network> network, bool reset) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        return call_func<NetworkImplDft, std::string>(
+                "get_sampling_profile", network_impl, reset);
+    }
+    LITE_THROW("get_sampling_profile is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
 void Runtime::enable_io_bin_dump(
         std::shared_ptr<Network> network, std::string io_bin_out_dir) {
     LITE_ERROR_HANDLER_BEGIN
@@ -487,4 +708,26 @@ void Runtime::shared_weight_with_network(
     LITE_ERROR_HANDLER_END
 }
 
+void Runtime::shared_weight_by_value_with_network(
+        std::shared_ptr<Network> dst_network,
+        const std::shared_ptr<Network> src_network) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl_dst = NetworkHelper::implement(dst_network);
+    if (network_impl_dst->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                !NetworkHelper::loaded(dst_network) &&
+                        !NetworkHelper::loaded(src_network),
+                "shared_weight_by_value_with_network should be used before "
+                "the networks loaded.");
+        call_func<NetworkImplDft, void>(
+                "shared_weight_by_value_with", network_impl_dst,
+                NetworkHelper::implement(src_network));
+        return;
+    }
+    LITE_THROW(
+            "shared_weight_by_value_with_network is not aviliable in the "
+            "backend.");
+    LITE_ERROR_HANDLER_END
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "decryption/decrypt_base.h"
 #include "lite/network.h"
 #include "misc.h"
 #include "tensor_impl_base.h"
@@ -106,6 +107,19 @@ public:
             std::shared_ptr<void> model_mem, size_t size,
             std::unordered_map<std::string, LiteAny> separate_config_map = {}) = 0;
 
+    //! load the model from a stream which decrypts the model while it is
+    //! read; the default implementation decrypts the whole model into a new
+    //! buffer first
+    virtual void load_model_stream(
+            std::unique_ptr<DecryptionStream> stream,
+            std::unordered_map<std::string, LiteAny> separate_config_map = {}) {
+        size_t size = stream->size();
+        std::shared_ptr<void> buf{malloc(size), ::free};
+        LITE_ASSERT(buf, "failed to allocate %zu bytes for the model", size);
+        stream->decrypt(0, buf.get(), size);
+        load_model(buf, size, std::move(separate_config_map));
+    }
+
     //! forward the network with filled input data and fill the output data
     //! to the output tensor
     virtual void forward() = 0;
@@ -113,6 +127,11 @@ public:
     //! in sync model, wait utile the inference finish
     virtual void wait() = 0;
 
+    //! plan the memory and run once for each set of input layouts
+    virtual PrepareTiming prepare(
+            const std::vector<std::unordered_map<std::string, Layout>>&
+                    shapes_list) = 0;
+
     //! set device id, default device id = 0
     virtual void set_device_id(int device_id) = 0;
     virtual int get_device_id() const = 0;
@@ -0,0 +1,159 @@
+/**
+ * \file src/network_pool.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/network_pool.h"
+#include "misc.h"
+
+#include <thread>
+
+using namespace lite;
+
+struct NetworkPool::Instance {
+    std::shared_ptr<Network> network;
+    std::atomic_bool busy{false};
+    std::atomic_size_t nr_acquired{0};
+    std::atomic<uint64_t> busy_ns{0};
+};
+
+/*********************** NetworkPool::Handle ***************/
+NetworkPool::Handle::Handle(NetworkPool* pool, size_t instance_id)
+        : m_pool{pool}, m_instance_id{instance_id}, m_acquire_time{Clock::now()} {}
+
+NetworkPool::Handle::Handle(Handle&& rhs)
+        : m_pool{rhs.m_pool},
+          m_instance_id{rhs.m_instance_id},
+          m_acquire_time{rhs.m_acquire_time} {
+    rhs.m_pool = nullptr;
+}
+
+NetworkPool::Handle& NetworkPool::Handle::operator=(Handle&& rhs) {
+    if (this != &rhs) {
+        release();
+        m_pool = rhs.m_pool;
+        m_instance_id = rhs.m_instance_id;
+        m_acquire_time = rhs.m_acquire_time;
+        rhs.m_pool = nullptr;
+    }
+    return *this;
+}
+
+const std::shared_ptr<Network>& NetworkPool::Handle::network() const {
+    LITE_ASSERT(m_pool, "use an invalid NetworkPool handle.");
+    return m_pool->get_instance(m_instance_id);
+}
+
+void NetworkPool::Handle::release() {
+    if (m_pool) {
+        m_pool->release(m_instance_id, m_acquire_time);
+        m_pool = nullptr;
+    }
+}
+
+/*********************** NetworkPool ***************/
+NetworkPool::NetworkPool(
+        std::string model_path, const NetworkPoolOptions& options,
+        const Config& config, const NetworkIO& network_io)
+        : m_nr_instances{options.nr_instances} {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_ASSERT(m_nr_instances > 0, "NetworkPool needs at least one instance.");
+    bool is_cpu = config.device_type == LiteDeviceType::LITE_CPU;
+    LITE_ASSERT(
+            is_cpu || options.nr_threads <= 1,
+            "nr_threads of NetworkPool is only avaliable in CPU.");
+    m_instances.reset(new Instance[m_nr_instances]);
+    for (size_t i = 0; i < m_nr_instances; ++i) {
+        auto network = std::make_shared<Network>(config, network_io);
+        //! instances on the same comp node would share its worker threads,
+        //! then they could not run concurrently
+        if (is_cpu) {
+            network->set_device_id(config.device_id + static_cast<int>(i));
+        } else {
+            network->set_stream_id(static_cast<int>(i));
+        }
+        if (is_cpu && options.nr_threads > 1) {
+            Runtime::set_cpu_threads_number(network, options.nr_threads);
+        }
+        if (i == 0) {
+            network->load_model(model_path);
+        } else {
+            Runtime::shared_weight_with_network(network, m_instances[0].network);
+        }
+        if (options.thread_affinity) {
+            auto&& affinity = options.thread_affinity;
+            Runtime::set_runtime_thread_affinity(
+                    network, [affinity, i](int thread_id) { affinity(i, thread_id); });
+        }
+        m_instances[i].network = std::move(network);
+    }
+    m_create_time = Clock::now();
+    LITE_ERROR_HANDLER_END
+}
+
+NetworkPool::~NetworkPool() = default;
+
+NetworkPool::Handle NetworkPool::try_acquire() {
+    //! start from a rotating position so the instances are used evenly
+    size_t start = m_next.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < m_nr_instances; ++i) {
+        size_t id = (start + i) % m_nr_instances;
+        auto&& instance = m_instances[id];
+        bool expected = false;
+        if (!instance.busy.load(std::memory_order_relaxed) &&
+            instance.busy.compare_exchange_strong(
+                    expected, true, std::memory_order_acquire)) {
+            instance.nr_acquired.fetch_add(1, std::memory_order_relaxed);
+            return {this, id};
+        }
+    }
+    return {};
+}
+
+NetworkPool::Handle NetworkPool::acquire() {
+    for (;;) {
+        auto handle = try_acquire();
+        if (handle.valid()) {
+            return handle;
+        }
+        std::this_thread::yield();
+    }
+}
+
+const std::shared_ptr<Network>& NetworkPool::get_instance(size_t instance_id) const {
+    LITE_ASSERT(
+            instance_id < m_nr_instances, "instance id %zu is out of range %zu.",
+            instance_id, m_nr_instances);
+    return m_instances[instance_id].network;
+}
+
+std::vector<NetworkPool::InstanceStats> NetworkPool::get_stats() const {
+    double lifetime_ns = std::chrono::duration<double, std::nano>(
+                                 Clock::now() - m_create_time)
+                                 .count();
+    std::vector<InstanceStats> ret(m_nr_instances);
+    for (size_t i = 0; i < m_nr_instances; ++i) {
+        auto&& instance = m_instances[i];
+        double busy_ns = instance.busy_ns.load(std::memory_order_relaxed);
+        ret[i].nr_acquired = instance.nr_acquired.load(std::memory_order_relaxed);
+        ret[i].busy_ms = busy_ns / 1e6;
+        ret[i].utilization = lifetime_ns > 0 ? busy_ns / lifetime_ns : 0;
+    }
+    return ret;
+}
+
+void NetworkPool::release(size_t instance_id, Clock::time_point acquire_time) {
+    auto&& instance = m_instances[instance_id];
+    auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - acquire_time);
+    instance.busy_ns.fetch_add(busy.count(), std::memory_order_relaxed);
+    instance.busy.store(false, std::memory_order_release);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
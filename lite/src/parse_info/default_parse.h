@@ -100,6 +100,8 @@ bool default_parse_info(
         auto options = info["options"];
         if (options.contains("weight_preprocess"))
             config.options.weight_preprocess = options["weight_preprocess"];
+        if (options.contains("weight_preprocess_cache"))
+            config.options.weight_preprocess_cache = options["weight_preprocess_cache"];
         if (options.contains("fuse_preprocess"))
             config.options.fuse_preprocess = options["fuse_preprocess"];
         if (options.contains("fake_next_exec"))
@@ -122,10 +124,26 @@ bool default_parse_info(
         if (options.contains("comp_node_seq_record_level"))
             config.options.comp_node_seq_record_level =
                     options["comp_node_seq_record_level"];
+        if (options.contains("comp_node_seq_record_cache_size"))
+            config.options.comp_node_seq_record_cache_size =
+                    options["comp_node_seq_record_cache_size"];
         if (options.contains("graph_opt_level"))
             config.options.graph_opt_level = options["graph_opt_level"];
         if (options.contains("async_exec_level"))
             config.options.async_exec_level = options["async_exec_level"];
+
+        //! layout transform options
+#define PARSE_LAYOUT_OPTION(name_) \
+    if (options.contains(#name_))  \
+        config.options.name_ = options[#name_]
+        PARSE_LAYOUT_OPTION(enable_nchw44);
+        PARSE_LAYOUT_OPTION(enable_nchw44_dot);
+        PARSE_LAYOUT_OPTION(enable_nchw88);
+        PARSE_LAYOUT_OPTION(enable_nhwcd4);
+        PARSE_LAYOUT_OPTION(enable_nchw4);
+        PARSE_LAYOUT_OPTION(enable_nchw32);
+        PARSE_LAYOUT_OPTION(enable_nchw64);
+#undef PARSE_LAYOUT_OPTION
     }
     //! IO
     auto get_io_type = [](std::string type) -> LiteIOType {
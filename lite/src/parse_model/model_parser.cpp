@@ -103,6 +103,36 @@ std::shared_ptr<void> ModelParser::parse_model(
             model_data, model_length, m_model_decryption_name, model_length);
 }
 
+std::unique_ptr<DecryptionStream> ModelParser::parse_model_stream(
+        const Config& config) const {
+    std::string decryption_name;
+    const uint8_t* model_data;
+    size_t model_length;
+    if (m_is_bare_model) {
+        decryption_name = config.bare_model_cryption_name;
+        model_data = static_cast<uint8_t*>(m_model.get());
+        model_length = m_total_length;
+    } else {
+        LITE_ASSERT(m_model_data, "packed model parse error!");
+        decryption_name = m_model_decryption_name;
+        model_data = m_model_data->data()->Data();
+        model_length = m_model_data->data()->size();
+    }
+    if (decryption_name.empty() || decryption_name == "NONE") {
+        return nullptr;
+    }
+    LITE_LOCK_GUARD(decryption_static_data().map_mutex);
+    auto&& stream_methods = decryption_static_data().stream_decryption_methods;
+    auto it = stream_methods.find(decryption_name);
+    if (it == stream_methods.end()) {
+        return nullptr;
+    }
+    auto&& key = decryption_static_data().decryption_methods.at(decryption_name).second;
+    //! share the ownership of the whole model buffer
+    return it->second(
+            std::shared_ptr<const void>(m_model, model_data), model_length, *key);
+}
+
 std::shared_ptr<void> ModelParser::decrypt_memory(
         const uint8_t* data, size_t length, const std::string decryption_name,
         size_t& result_length) const {
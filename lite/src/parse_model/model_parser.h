@@ -41,6 +41,11 @@ public:
     //! parse the model and decrypt the model
     std::shared_ptr<void> parse_model(size_t& model_length, const Config& config) const;
 
+    //! get a stream to decrypt the model while it is loaded; return nullptr
+    //! if the model is not encrypted or the decryption method does not
+    //! support streaming, in which case parse_model() should be used
+    std::unique_ptr<DecryptionStream> parse_model_stream(const Config& config) const;
+
 private:
     //! parse the header of the model and store the model related information
     //! to the menber data
@@ -0,0 +1,246 @@
+/**
+ * \file src/pipeline.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/pipeline.h"
+#include "misc.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "mge/common.h"
+#include "mge/tensor_impl.h"
+#include "tensor_impl_base.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace lite;
+
+class PipelinedExecutor::Impl {
+public:
+    Impl(std::shared_ptr<Network> network, size_t nr_buffers, int h2d_stream_id,
+         int d2h_stream_id);
+    ~Impl();
+
+    size_t submit(const IOBindings& host_inputs, const IOBindings& host_outputs);
+    void wait(size_t ticket);
+
+private:
+    using DevTensorMap = std::unordered_map<std::string, mgb::DeviceTensorND>;
+
+    //! the device buffers and the events of a request in flight
+    struct Slot {
+        DevTensorMap inputs, outputs;
+        std::unique_ptr<mgb::CompNode::Event> h2d_done, compute_done, d2h_done;
+        size_t ticket = 0;
+        bool busy = false;
+    };
+
+    static mgb::DeviceTensorND& dev_tensor_of(const std::shared_ptr<Tensor>& tensor) {
+        auto&& impl = TensorHelper::implement(tensor)->cast_final_safe<TensorImplDft>();
+        LITE_ASSERT(impl.dev_tensor(), "the io of a pipelined network must be device.");
+        return *impl.dev_tensor();
+    }
+
+    static mgb::HostTensorND& host_tensor_of(const std::shared_ptr<Tensor>& tensor) {
+        LITE_CHECK_NON_NULL_POINTER(tensor);
+        auto&& impl = TensorHelper::implement(tensor)->cast_final_safe<TensorImplDft>();
+        LITE_ASSERT(impl.host_tensor(), "the io of a request must be host tensors.");
+        return *impl.host_tensor();
+    }
+
+    void wait_slot(Slot& slot);
+
+    std::shared_ptr<Network> m_network;
+    std::vector<std::string> m_input_names, m_output_names;
+    mgb::CompNode m_compute_cn, m_h2d_cn, m_d2h_cn;
+    std::vector<Slot> m_slots;
+    size_t m_next_ticket = 0;
+};
+
+PipelinedExecutor::Impl::Impl(
+        std::shared_ptr<Network> network, size_t nr_buffers, int h2d_stream_id,
+        int d2h_stream_id)
+        : m_network{std::move(network)}, m_slots(nr_buffers) {
+    LITE_CHECK_NON_NULL_POINTER(m_network);
+    LITE_ASSERT(nr_buffers > 0, "PipelinedExecutor needs at least one buffer.");
+    LITE_ASSERT(
+            m_network->get_device_type() != LiteDeviceType::LITE_CPU,
+            "PipelinedExecutor is not avaliable on CPU.");
+    m_input_names = m_network->get_all_input_name();
+    m_output_names = m_network->get_all_output_name();
+    LITE_ASSERT(!m_input_names.empty(), "the network has no input.");
+    for (auto&& name : m_output_names) {
+        dev_tensor_of(m_network->get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT));
+    }
+    m_compute_cn = dev_tensor_of(m_network->get_io_tensor(
+                                         m_input_names[0], LiteTensorPhase::LITE_INPUT))
+                           .comp_node();
+    if (h2d_stream_id < 0) {
+        h2d_stream_id = m_compute_cn.locator().stream + 1;
+    }
+    if (d2h_stream_id < 0) {
+        d2h_stream_id = h2d_stream_id + 1;
+    }
+    m_h2d_cn = m_compute_cn.change_stream(h2d_stream_id);
+    m_d2h_cn = m_compute_cn.change_stream(d2h_stream_id);
+    for (auto&& slot : m_slots) {
+        slot.h2d_done = m_h2d_cn.create_event();
+        slot.compute_done = m_compute_cn.create_event();
+        slot.d2h_done = m_d2h_cn.create_event();
+        for (auto&& name : m_input_names) {
+            slot.inputs[name] = mgb::DeviceTensorND{m_compute_cn};
+        }
+        for (auto&& name : m_output_names) {
+            slot.outputs[name] = mgb::DeviceTensorND{m_compute_cn};
+        }
+    }
+}
+
+PipelinedExecutor::Impl::~Impl() {
+    m_network->wait();
+    for (auto&& slot : m_slots) {
+        wait_slot(slot);
+    }
+}
+
+void PipelinedExecutor::Impl::wait_slot(Slot& slot) {
+    if (slot.busy) {
+        slot.d2h_done->host_wait();
+        slot.busy = false;
+    }
+}
+
+size_t PipelinedExecutor::Impl::submit(
+        const IOBindings& host_inputs, const IOBindings& host_outputs) {
+    size_t ticket = m_next_ticket;
+    auto&& slot = m_slots[ticket % m_slots.size()];
+    //! the buffers of the slot are free once the outputs of its previous
+    //! request are copied, which is after the compute of that request
+    wait_slot(slot);
+
+    for (auto&& name : m_input_names) {
+        auto iter = host_inputs.find(name);
+        LITE_ASSERT(
+                iter != host_inputs.end(), "input %s is not given in the request.",
+                name.c_str());
+        auto&& host = host_tensor_of(iter->second);
+        auto&& dev = slot.inputs.at(name);
+        dev.dtype(host.dtype()).resize(host.shape());
+        dev.raw_ptr();
+        //! the same memory seen from the copy stream
+        mgb::DeviceTensorND dev_h2d = dev;
+        dev_h2d.comp_node(m_h2d_cn);
+        dev_h2d.copy_from(host);
+    }
+    slot.h2d_done->record();
+    m_compute_cn.device_wait_event(*slot.h2d_done);
+
+    for (auto&& name : m_input_names) {
+        dev_tensor_of(m_network->get_io_tensor(name, LiteTensorPhase::LITE_INPUT)) =
+                slot.inputs.at(name);
+    }
+    for (auto&& name : m_output_names) {
+        dev_tensor_of(m_network->get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT)) =
+                slot.outputs.at(name);
+    }
+    //! the execution waits for the compute of the previous request on host,
+    //! which is overlapped with the copies issued above
+    m_network->forward();
+    for (auto&& name : m_output_names) {
+        //! the output may be reallocated by the output callback
+        slot.outputs.at(name) = dev_tensor_of(
+                m_network->get_io_tensor(name, LiteTensorPhase::LITE_OUTPUT));
+    }
+    slot.compute_done->record();
+    m_d2h_cn.device_wait_event(*slot.compute_done);
+
+    for (auto&& name : m_output_names) {
+        auto iter = host_outputs.find(name);
+        if (iter == host_outputs.end()) {
+            continue;
+        }
+        auto&& dev = slot.outputs.at(name);
+        LITE_CHECK_NON_NULL_POINTER(iter->second);
+        iter->second->set_layout(to_lite_layout(dev.layout()));
+        auto&& host_storage = host_tensor_of(iter->second);
+        host_storage.raw_ptr();
+        LITE_ASSERT(
+                host_storage.comp_node().mem_node() == m_d2h_cn.mem_node(),
+                "the host output %s should be a pinned host tensor of the device.",
+                name.c_str());
+        //! the same memory seen from the copy stream
+        mgb::HostTensorND host = host_storage;
+        host.comp_node(m_d2h_cn);
+        mgb::DeviceTensorND dev_d2h = dev;
+        dev_d2h.comp_node(m_d2h_cn);
+        host.copy_from(dev_d2h);
+    }
+    slot.d2h_done->record();
+    slot.ticket = ticket;
+    slot.busy = true;
+    ++m_next_ticket;
+    return ticket;
+}
+
+void PipelinedExecutor::Impl::wait(size_t ticket) {
+    LITE_ASSERT(ticket < m_next_ticket, "wait for a request not submitted.");
+    auto&& slot = m_slots[ticket % m_slots.size()];
+    //! an older ticket of the slot has been waited when the slot is reused
+    if (slot.ticket == ticket) {
+        wait_slot(slot);
+    }
+}
+
+/*********************** PipelinedExecutor ***************/
+PipelinedExecutor::PipelinedExecutor(
+        std::shared_ptr<Network> network, size_t nr_buffers, int h2d_stream_id,
+        int d2h_stream_id) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(
+            std::move(network), nr_buffers, h2d_stream_id, d2h_stream_id);
+    LITE_ERROR_HANDLER_END
+}
+
+PipelinedExecutor::~PipelinedExecutor() = default;
+
+size_t PipelinedExecutor::submit(
+        const IOBindings& host_inputs, const IOBindings& host_outputs) {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->submit(host_inputs, host_outputs);
+    LITE_ERROR_HANDLER_END
+}
+
+void PipelinedExecutor::wait(size_t ticket) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl->wait(ticket);
+    LITE_ERROR_HANDLER_END
+}
+
+#else
+using namespace lite;
+
+class PipelinedExecutor::Impl {};
+
+PipelinedExecutor::PipelinedExecutor(std::shared_ptr<Network>, size_t, int, int) {
+    LITE_THROW("PipelinedExecutor is not avaliable without MegEngine.");
+}
+
+PipelinedExecutor::~PipelinedExecutor() = default;
+
+size_t PipelinedExecutor::submit(const IOBindings&, const IOBindings&) {
+    LITE_THROW("PipelinedExecutor is not avaliable without MegEngine.");
+}
+
+void PipelinedExecutor::wait(size_t) {
+    LITE_THROW("PipelinedExecutor is not avaliable without MegEngine.");
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,80 @@
+/**
+ * \file test/test_adaptive_executor.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/adaptive_executor.h"
+
+#include <atomic>
+using namespace lite;
+
+TEST(TestAdaptiveExecutor, Basic) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    AdaptiveOptions options;
+    options.nr_cores = 2;
+    options.max_in_flight = 4;
+    //! reconsider the mode on every request
+    options.decision_interval_ms = 0;
+    size_t nr_requests = 12;
+    std::atomic_size_t nr_callbacks{0};
+    std::vector<std::future<IOBindings>> futures;
+    {
+        AdaptiveExecutor executor(model_path, options, config);
+        auto stats = executor.get_stats();
+        ASSERT_EQ(stats.modes.size(), 2u);
+        ASSERT_EQ(stats.modes[0].nr_instances, 1u);
+        ASSERT_EQ(stats.modes[0].nr_threads, 2u);
+        ASSERT_EQ(stats.modes[1].nr_instances, 2u);
+        ASSERT_EQ(stats.modes[1].nr_threads, 1u);
+        ASSERT_EQ(stats.mode, 0u);
+
+        for (size_t i = 0; i < nr_requests; i++) {
+            futures.push_back(executor.forward_async(
+                    {{"data", lite_tensor}},
+                    [&](const IOBindings&) { nr_callbacks++; }));
+        }
+        for (auto&& future : futures) {
+            auto outputs = future.get();
+            compare_lite_tensor<float>(outputs.begin()->second, result_mgb);
+        }
+
+        stats = executor.get_stats();
+        size_t nr_run = 0;
+        for (auto&& mode : stats.modes) {
+            nr_run += mode.nr_requests;
+        }
+        ASSERT_EQ(nr_run, nr_requests);
+    }
+    ASSERT_EQ(nr_callbacks, nr_requests);
+}
+
+TEST(TestAdaptiveExecutor, InvalidModes) {
+    Config config;
+    std::string model_path = "./shufflenet.mge";
+    AdaptiveOptions options;
+    options.nr_cores = 4;
+    options.nr_instances_of_modes = {1, 3};
+    ASSERT_THROW(AdaptiveExecutor(model_path, options, config), std::exception);
+
+    config.device_type = LiteDeviceType::LITE_CUDA;
+    options.nr_instances_of_modes = {1, 2};
+    ASSERT_THROW(AdaptiveExecutor(model_path, options, config), std::exception);
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
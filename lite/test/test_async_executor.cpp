@@ -0,0 +1,95 @@
+/**
+ * \file test/test_async_executor.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/async_executor.h"
+#include "lite/network_pool.h"
+
+#include <atomic>
+#include <thread>
+using namespace lite;
+
+TEST(TestAsyncExecutor, Basic) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    auto output_name = network->get_output_name(0);
+
+    //! the input is refilled with zero after it is queued, which should not
+    //! change the result as the input is snapshotted
+    auto input_tensor = std::make_shared<Tensor>();
+    size_t nr_requests = 6;
+    std::atomic_size_t nr_callbacks{0};
+    std::vector<std::future<IOBindings>> futures;
+    {
+        AsyncOptions options;
+        options.max_in_flight = 2;
+        options.nr_callback_threads = 2;
+        AsyncExecutor executor(network, options);
+        for (size_t i = 0; i < nr_requests; i++) {
+            input_tensor->copy_from(*lite_tensor);
+            futures.push_back(executor.forward_async(
+                    {{"data", input_tensor}}, [&](const IOBindings& outputs) {
+                        ASSERT_EQ(outputs.count(output_name), 1u);
+                        nr_callbacks++;
+                    }));
+            input_tensor->fill_zero();
+        }
+        for (auto&& future : futures) {
+            auto outputs = future.get();
+            compare_lite_tensor<float>(outputs.at(output_name), result_mgb);
+        }
+    }
+    ASSERT_EQ(nr_callbacks, nr_requests);
+}
+
+TEST(TestAsyncExecutor, Pipeline) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    NetworkPoolOptions pool_options;
+    pool_options.nr_instances = 2;
+    NetworkPool pool(model_path, pool_options, config);
+    auto output_name = pool.get_instance(0)->get_output_name(0);
+
+    size_t nr_requests = 6;
+    std::vector<std::future<IOBindings>> futures;
+    {
+        AsyncOptions options;
+        options.max_in_flight = 4;
+        AsyncExecutor executor({pool.get_instance(0), pool.get_instance(1)}, options);
+        for (size_t i = 0; i < nr_requests; i++) {
+            futures.push_back(executor.forward_async({{"data", lite_tensor}}));
+        }
+        for (auto&& future : futures) {
+            auto outputs = future.get();
+            compare_lite_tensor<float>(outputs.at(output_name), result_mgb);
+        }
+    }
+
+    ASSERT_THROW(
+            AsyncExecutor({pool.get_instance(0), pool.get_instance(0)}),
+            std::exception);
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,81 @@
+/**
+ * \file test/test_batching.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/batching.h"
+
+#include <thread>
+using namespace lite;
+
+TEST(TestBatching, Basic) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    std::shared_ptr<Network> network2 = std::make_shared<Network>(config);
+    Runtime::shared_weight_with_network(network2, network);
+    auto output_name = network->get_output_name(0);
+
+    BatchingOptions options;
+    options.max_batch_size = 4;
+    options.max_delay_us = 10000;
+    BatchingExecutor executor({network, network2}, options);
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < 4; ++i) {
+        workers.emplace_back([&]() {
+            for (size_t j = 0; j < 3; ++j) {
+                auto outputs = executor.run({{"data", lite_tensor}});
+                auto output_tensor = outputs.at(output_name);
+                ASSERT_EQ(output_tensor->get_layout().shapes[0], 1);
+                compare_lite_tensor<float>(output_tensor, result_mgb);
+            }
+        });
+    }
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+}
+
+TEST(TestBatching, Deadline) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    auto output_name = network->get_output_name(0);
+
+    //! the batch is never full, so every request is run after the deadline
+    BatchingOptions options;
+    options.max_batch_size = 16;
+    options.max_delay_us = 1000;
+    BatchingExecutor executor({network}, options);
+
+    auto future0 = executor.submit({{"data", lite_tensor}});
+    auto future1 = executor.submit({{"data", lite_tensor}});
+    auto outputs0 = future0.get();
+    auto outputs1 = future1.get();
+    compare_lite_tensor<float>(outputs0.at(output_name), result_mgb);
+    compare_lite_tensor<float>(outputs1.at(output_name), result_mgb);
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -12,6 +12,7 @@
 #include "lite_build_config.h"
 
 #if LITE_BUILD_WITH_MGE
+#include "../src/decryption/aes_decrypt.h"
 #include "../src/decryption/decrypt_base.h"
 #include "../src/network_impl_base.h"
 #include "test_common.h"
@@ -56,6 +57,52 @@ TEST(TestMisc, DecryptionUpdate) {
             3);
 }
 
+TEST(TestMisc, DecryptionStreamAES) {
+    auto key = AESDcryption::get_decrypt_key();
+    std::mt19937 rng(42);
+    for (size_t length : {0, 1, 16, 100, 4099}) {
+        std::vector<uint8_t> plain(length);
+        for (auto&& i : plain) {
+            i = rng();
+        }
+        //! IV, cipher blocks and the big-endian length
+        size_t padded = (length + 15) / 16 * 16;
+        std::vector<uint8_t> model(16 + padded + 8);
+        for (size_t i = 0; i < 16; ++i) {
+            model[i] = rng();
+        }
+        std::vector<uint8_t> padded_plain(plain), iv(model.begin(), model.begin() + 16);
+        padded_plain.resize(padded);
+        mbedtls_aes_context ctx;
+        mbedtls_aes_init(&ctx);
+        mbedtls_aes_setkey_enc(&ctx, key.data(), 256);
+        mbedtls_aes_crypt_cbc(
+                &ctx, MBEDTLS_AES_ENCRYPT, padded, iv.data(), padded_plain.data(),
+                model.data() + 16);
+        mbedtls_aes_free(&ctx);
+        for (size_t i = 0; i < 8; ++i) {
+            model[16 + padded + i] = length >> (8 * (7 - i));
+        }
+        ASSERT_EQ(plain, AESDcryption::decrypt_model(model.data(), model.size(), key));
+
+        std::shared_ptr<const void> model_mem{model.data(), [](const void*) {}};
+        auto stream =
+                AESDcryption::make_decrypt_stream(model_mem, model.size(), key);
+        ASSERT_EQ(length, stream->size());
+        std::vector<uint8_t> result(length);
+        stream->decrypt(0, result.data(), length);
+        ASSERT_EQ(plain, result);
+        for (int i = 0; i < 20 && length; ++i) {
+            size_t offset = rng() % length, size = rng() % (length - offset + 1);
+            std::vector<uint8_t> part(size);
+            stream->decrypt(offset, part.data(), size);
+            ASSERT_TRUE(std::equal(part.begin(), part.end(), plain.begin() + offset));
+        }
+        std::vector<uint8_t> out_of_range(2);
+        ASSERT_THROW(stream->decrypt(length, out_of_range.data(), 1), std::exception);
+    }
+}
+
 TEST(TestMisc, SharedSameDeviceTensor) {
     using namespace mgb;
     serialization::GraphLoader::LoadConfig mgb_config;
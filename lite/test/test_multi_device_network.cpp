@@ -0,0 +1,102 @@
+/**
+ * \file test/test_multi_device_network.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/multi_device_network.h"
+
+#include <atomic>
+using namespace lite;
+
+TEST(TestMultiDeviceNetwork, Basic) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    MultiDeviceOptions options;
+    options.device_ids = {0, 1, 2};
+    options.max_queue_depth = 2;
+    size_t nr_requests = 12;
+    std::atomic_size_t nr_callbacks{0};
+    std::vector<std::future<IOBindings>> futures;
+    {
+        MultiDeviceNetwork network(model_path, options, config);
+        ASSERT_EQ(network.nr_devices(), 3u);
+        for (size_t i = 0; i < network.nr_devices(); i++) {
+            ASSERT_EQ(network.get_network(i)->get_device_id(), static_cast<int>(i));
+        }
+
+        for (size_t i = 0; i < nr_requests; i++) {
+            futures.push_back(network.forward(
+                    {{"data", lite_tensor}},
+                    [&](const IOBindings&) { nr_callbacks++; }));
+        }
+        network.wait();
+        auto stats = network.get_stats();
+        ASSERT_EQ(stats.size(), 3u);
+        size_t nr_run = 0;
+        for (auto&& device : stats) {
+            ASSERT_EQ(device.queue_depth, 0u);
+            nr_run += device.nr_requests;
+        }
+        ASSERT_EQ(nr_run, nr_requests);
+        //! only the first device runs until the first request finishes, and the
+        //! others take the requests afterwards
+        ASSERT_GT(stats[1].nr_requests + stats[2].nr_requests, 0u);
+
+        for (auto&& future : futures) {
+            auto outputs = future.get();
+            compare_lite_tensor<float>(outputs.begin()->second, result_mgb);
+        }
+    }
+    ASSERT_EQ(nr_callbacks, nr_requests);
+}
+
+TEST(TestMultiDeviceNetwork, InvalidOptions) {
+    Config config;
+    std::string model_path = "./shufflenet.mge";
+    MultiDeviceOptions options;
+    options.device_ids = {0, 1};
+    options.max_queue_depth = 0;
+    ASSERT_THROW(MultiDeviceNetwork(model_path, options, config), std::exception);
+
+    options.max_queue_depth = 2;
+    ASSERT_THROW(
+            MultiDeviceNetwork("./not_exist.mge", options, config), std::exception);
+}
+
+#if LITE_WITH_CUDA
+TEST(TestMultiDeviceNetwork, AllDevices) {
+    auto lite_tensor = get_input_data("./input_data.npy");
+    Config config;
+    config.device_type = LiteDeviceType::LITE_CUDA;
+    std::string model_path = "./shufflenet.mge";
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    MultiDeviceNetwork network(model_path, {}, config);
+    ASSERT_EQ(network.nr_devices(), get_device_count(LiteDeviceType::LITE_CUDA));
+    std::vector<std::future<IOBindings>> futures;
+    for (size_t i = 0; i < network.nr_devices() * 2; i++) {
+        futures.push_back(network.forward({{"data", lite_tensor}}));
+    }
+    for (auto&& future : futures) {
+        auto outputs = future.get();
+        compare_lite_tensor<float>(outputs.begin()->second, result_mgb);
+    }
+}
+#endif
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -13,11 +13,13 @@
 
 #if LITE_BUILD_WITH_MGE
 #include "./test_common.h"
+#include "lite/pipeline.h"
 #include "megbrain/tensor.h"
 
 #include <chrono>
 #include <memory>
 #include <random>
+#include <thread>
 #include <unordered_map>
 using namespace lite;
 
@@ -271,6 +273,125 @@ TEST(TestNetWork, ThreadAffinity) {
     compare_lite_tensor<float>(output_tensor, result_mgb);
 }
 
+TEST(TestNetWork, ThreadWaitPolicy) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    Runtime::set_cpu_threads_number(network, 4);
+
+    ASSERT_THROW(
+            Runtime::set_runtime_thread_wait_policy(network, 1000, 10),
+            std::exception);
+    network->load_model(model_path);
+    //! park the idle workers almost at once
+    Runtime::set_runtime_thread_wait_policy(network, 0, 1);
+
+    std::shared_ptr<Tensor> input_tensor = network->get_input_tensor(0);
+    auto src_ptr = lite_tensor->get_memory_ptr();
+    auto src_layout = lite_tensor->get_layout();
+    input_tensor->reset(src_ptr, src_layout);
+
+    for (int i = 0; i < 3; i++) {
+        network->forward();
+        network->wait();
+    }
+
+    std::shared_ptr<Tensor> output_tensor = network->get_output_tensor(0);
+    compare_lite_tensor<float>(output_tensor, result_mgb);
+}
+
+TEST(TestNetWork, SharedThreadPool) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    //! use a device id of its own, so the comp nodes on the shared thread
+    //! pool are not reused by other tests
+    config.device_id = 11;
+    set_cpu_shared_thread_pool(4);
+    std::vector<std::shared_ptr<Network>> networks;
+    for (size_t nr_threads : {2, 3}) {
+        auto network = std::make_shared<Network>(config);
+        Runtime::set_cpu_threads_number(network, nr_threads);
+        network->load_model(model_path);
+        networks.push_back(network);
+    }
+    set_cpu_shared_thread_pool(0);
+    Runtime::set_runtime_thread_priority(
+            networks[0], LiteTaskPriority::LITE_TASK_PRIORITY_HIGH);
+
+    //! both networks run on the shared thread pool at the same time
+    std::vector<std::thread> threads;
+    for (auto&& network : networks) {
+        threads.emplace_back([&, network]() {
+            auto input_tensor = network->get_input_tensor(0);
+            input_tensor->copy_from(*lite_tensor);
+            for (int i = 0; i < 5; i++) {
+                network->forward();
+                network->wait();
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (auto&& network : networks) {
+        compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+    }
+}
+
+TEST(TestNetWork, WeightPreprocessCache) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    config.options.weight_preprocess = true;
+    config.options.weight_preprocess_cache = true;
+    //! the second network loads the preprocessed weights of the first one
+    for (int i = 0; i < 2; i++) {
+        std::shared_ptr<Network> network = std::make_shared<Network>(config);
+        network->load_model(model_path);
+        auto input_tensor = network->get_input_tensor(0);
+        input_tensor->copy_from(*lite_tensor);
+        network->forward();
+        network->wait();
+        compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+    }
+}
+
+TEST(TestNetWork, MemoryBudget) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    auto run = [&](size_t memory_budget) {
+        std::shared_ptr<Network> network = std::make_shared<Network>(config);
+        if (memory_budget) {
+            Runtime::set_network_memory_budget(network, memory_budget);
+        }
+        network->load_model(model_path);
+        auto input_tensor = network->get_input_tensor(0);
+        input_tensor->copy_from(*lite_tensor);
+        network->forward();
+        network->wait();
+        compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+        return Runtime::get_network_memory_peak(network);
+    };
+    size_t peak = run(0);
+    ASSERT_GT(peak, 0u);
+    ASSERT_LE(run(peak / 2), peak);
+}
+
 TEST(TestNetWork, BasicCryptAes) {
     Config config;
     auto lite_tensor = get_input_data("./input_data.npy");
@@ -363,6 +484,72 @@ TEST(TestNetWork, ChangeInputShape) {
     ASSERT_EQ(output_layout.shapes[1], 1000);
 }
 
+TEST(TestNetWork, Prepare) {
+    Config config;
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    std::string input_name = "data";
+    auto result_mgb = mgb_lar(model_path, config, input_name, tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+
+    auto layout = tensor->get_layout();
+    auto batch2_layout = layout;
+    batch2_layout.shapes[0] = 2;
+    auto timing = network->prepare(
+            {{{input_name, batch2_layout}}, {{input_name, layout}}});
+    ASSERT_GT(timing.parse_ms, 0);
+    ASSERT_GT(timing.compile_ms, 0);
+    ASSERT_EQ(timing.mem_plan_ms.size(), 2u);
+    ASSERT_EQ(timing.first_run_ms.size(), 2u);
+
+    std::shared_ptr<Tensor> input_tensor = network->get_io_tensor(input_name);
+    ASSERT_EQ(input_tensor->get_layout().shapes[0], 1);
+    input_tensor->copy_from(*tensor);
+    network->forward();
+    network->wait();
+    compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+}
+
+TEST(TestNetWork, HotSwap) {
+    Config config;
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    std::string input_name = "data";
+    auto result_mgb = mgb_lar(model_path, config, input_name, tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    size_t nr_finish = 0;
+    network->set_finish_callback(
+            [&](const std::unordered_map<
+                    std::string, std::pair<IO, std::shared_ptr<Tensor>>>&) {
+                nr_finish++;
+            });
+    auto old_input = network->get_io_tensor(input_name);
+
+    //! the requests go on while the new model is loaded
+    std::thread swapper([&]() {
+        auto timing = network->hot_swap(
+                model_path, {{{input_name, tensor->get_layout()}}});
+        ASSERT_EQ(timing.first_run_ms.size(), 1u);
+    });
+    for (size_t i = 0; i < 4; ++i) {
+        network->get_io_tensor(input_name)->copy_from(*tensor);
+        network->forward();
+        network->wait();
+    }
+    swapper.join();
+
+    network->get_io_tensor(input_name)->copy_from(*tensor);
+    network->forward();
+    network->wait();
+    ASSERT_NE(network->get_io_tensor(input_name), old_input);
+    compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+    ASSERT_EQ(nr_finish, 5u);
+}
+
 TEST(TestNetWork, ResetOutput) {
     Config config;
     auto tensor = get_input_data("./input_data.npy");
@@ -392,6 +579,34 @@ TEST(TestNetWork, ResetOutput) {
     compare_lite_tensor<float>(output_tensor, result_mgb);
 }
 
+TEST(TestNetWork, ForwardWithBindings) {
+    Config config;
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    std::string input_name = "data";
+    auto result_mgb = mgb_lar(model_path, config, input_name, tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    auto output_name = network->get_output_name(0);
+
+    Layout output_layout{{1, 1000}, 2, LiteDataType::LITE_FLOAT};
+    for (size_t i = 0; i < 2; i++) {
+        auto result_tensor =
+                std::make_shared<Tensor>(LiteDeviceType::LITE_CPU, output_layout);
+        void* out_data = result_tensor->get_memory_ptr();
+        network->forward({{input_name, tensor}, {output_name, result_tensor}});
+        network->wait();
+
+        auto output_tensor = network->get_output_tensor(0);
+        ASSERT_EQ(output_tensor->get_memory_ptr(), out_data);
+        ASSERT_EQ(
+                network->get_io_tensor(input_name)->get_memory_ptr(),
+                tensor->get_memory_ptr());
+        compare_lite_tensor<float>(result_tensor, result_mgb);
+    }
+}
+
 TEST(TestNetWork, AsyncExec) {
     Config config;
     config.options.var_sanity_check_first_run = false;
@@ -602,6 +817,53 @@ TEST(TestNetWork, ProfileIOdump) {
     ASSERT_TRUE(fopen("./io_txt_dump.txt", "r"));
 }
 
+TEST(TestNetWork, RooflineReport) {
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    {
+        FILE* fout = fopen("./roofline_spec.txt", "w");
+        ASSERT_TRUE(fout);
+        fputs("cpu 100 10\n", fout);
+        fclose(fout);
+    }
+
+    Config config;
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    Runtime::enable_roofline_report(
+            network, "./roofline.json", "./roofline_spec.txt");
+    network->load_model(model_path);
+    std::shared_ptr<Tensor> input_tensor = network->get_io_tensor("data");
+    input_tensor->reset(tensor->get_memory_ptr(), tensor->get_layout());
+
+    network->forward();
+    network->wait();
+    FILE* fin = fopen("./roofline.json", "r");
+    ASSERT_TRUE(fin);
+    fclose(fin);
+}
+
+TEST(TestNetWork, SamplingProfiler) {
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    Config config;
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    Runtime::enable_sampling_profiler(network, 2);
+    network->load_model(model_path);
+    std::shared_ptr<Tensor> input_tensor = network->get_io_tensor("data");
+    input_tensor->reset(tensor->get_memory_ptr(), tensor->get_layout());
+
+    for (int i = 0; i < 4; i++) {
+        network->forward();
+        network->wait();
+    }
+    auto profile = Runtime::get_sampling_profile(network, true);
+    ASSERT_NE(profile.find("\"nr_sampled\": 2"), std::string::npos);
+    ASSERT_NE(profile.find("\"histogram_us_log2\""), std::string::npos);
+    profile = Runtime::get_sampling_profile(network);
+    ASSERT_EQ(profile.find("\"histogram_us_log2\""), std::string::npos);
+}
+
 TEST(TestNetWork, LoadPackedModel) {
     auto tensor = get_input_data("./input_data.npy");
     std::string model_path = "./test_packed_model.lite";
@@ -917,6 +1179,44 @@ TEST(TestNetWork, DeviceAsyncExec) {
 }
 
 #endif
+
+TEST(TestNetWork, PipelinedExecutorDevice) {
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    std::string input_name = "data";
+    std::string output_name = "TRUE_DIV(EXP[12065],reduce0[12067])[12077]";
+    auto result_mgb = mgb_lar(model_path, {}, input_name, tensor);
+
+    NetworkIO IO;
+    bool is_host = false;
+    IO.inputs.push_back({input_name, is_host});
+    IO.outputs.push_back({output_name, is_host});
+    Config config;
+    config.device_type = LiteDeviceType::LITE_CUDA;
+    std::shared_ptr<Network> network = std::make_shared<Network>(config, IO);
+    network->load_model(model_path);
+
+    auto input_tensor = std::make_shared<Tensor>(LiteDeviceType::LITE_CUDA, true);
+    input_tensor->copy_from(*tensor);
+
+    size_t nr_requests = 5;
+    std::vector<std::shared_ptr<Tensor>> output_tensors;
+    std::vector<size_t> tickets;
+    {
+        PipelinedExecutor executor(network, 3);
+        for (size_t i = 0; i < nr_requests; i++) {
+            output_tensors.push_back(
+                    std::make_shared<Tensor>(LiteDeviceType::LITE_CUDA, true));
+            tickets.push_back(executor.submit(
+                    {{input_name, input_tensor}},
+                    {{output_name, output_tensors.back()}}));
+        }
+        for (size_t i = 0; i < nr_requests; i++) {
+            executor.wait(tickets[i]);
+            compare_lite_tensor<float>(output_tensors[i], result_mgb);
+        }
+    }
+}
 #endif
 #if MGB_ATLAS
 TEST(TestNetWork, AtlasLoadNoDevice) {
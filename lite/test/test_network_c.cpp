@@ -586,6 +586,46 @@ TEST(TestCapiNetWork, BasicResetOutput) {
     LITE_CAPI_CHECK(LITE_destroy_network(c_network));
 }
 
+TEST(TestCapiNetWork, ForwardWithBindings) {
+    ForwardMgb;
+    LiteNetwork c_network;
+    LITE_CAPI_CHECK(LITE_make_default_network(&c_network));
+    LoadNetwork;
+    const char* output_name;
+    LITE_CAPI_CHECK(LITE_get_output_name(c_network, 0, &output_name));
+    const char* io_names[] = {"data", output_name};
+    LiteTensor io_tensors[2];
+    LITE_CAPI_CHECK(LITE_get_io_tensors(c_network, 2, io_names, LITE_IO, io_tensors));
+    LiteLayout output_layout;
+    LITE_CAPI_CHECK(LITE_get_tensor_layout(io_tensors[1], &output_layout));
+
+    LiteTensor c_input_tensor, c_output_tensor;
+    auto input_layout = lite_tensor->get_layout();
+    LiteLayout c_input_layout = default_layout;
+    c_input_layout.ndim = input_layout.ndim;
+    c_input_layout.data_type = input_layout.data_type;
+    for (size_t i = 0; i < input_layout.ndim; i++) {
+        c_input_layout.shapes[i] = input_layout.shapes[i];
+    }
+    LITE_CAPI_CHECK(LITE_make_tensor(default_desc, &c_input_tensor));
+    LITE_CAPI_CHECK(LITE_reset_tensor(
+            c_input_tensor, c_input_layout, lite_tensor->get_memory_ptr()));
+    LiteTensorDesc output_desc = default_desc;
+    output_desc.layout = output_layout;
+    LITE_CAPI_CHECK(LITE_make_tensor(output_desc, &c_output_tensor));
+    void* output_ptr;
+    LITE_CAPI_CHECK(LITE_get_tensor_memory(c_output_tensor, &output_ptr));
+
+    LiteTensor user_tensors[] = {c_input_tensor, c_output_tensor};
+    LITE_CAPI_CHECK(
+            LITE_forward_with_bindings(c_network, 2, io_names, user_tensors));
+    LITE_CAPI_CHECK(LITE_wait(c_network));
+    CompareResult;
+    LITE_CAPI_CHECK(LITE_destroy_network(c_network));
+    LITE_CAPI_CHECK(LITE_destroy_tensor(c_input_tensor));
+    LITE_CAPI_CHECK(LITE_destroy_tensor(c_output_tensor));
+}
+
 TEST(TestCapiNetWork, BasicInplaceAndSingleThreadAffinity) {
     ForwardMgb;
     MakeNetwork;
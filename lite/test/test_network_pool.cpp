@@ -0,0 +1,99 @@
+/**
+ * \file test/test_network_pool.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/network_pool.h"
+
+#include <thread>
+using namespace lite;
+
+TEST(TestNetworkPool, Basic) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::atomic_size_t nr_affinity_calls{0};
+    NetworkPoolOptions options;
+    options.nr_instances = 2;
+    options.nr_threads = 2;
+    options.thread_affinity = [&](size_t instance_id, int thread_id) {
+        ASSERT_LT(instance_id, 2u);
+        ASSERT_LT(thread_id, 2);
+        nr_affinity_calls++;
+    };
+    NetworkPool pool(model_path, options, config);
+    ASSERT_NE(pool.get_instance(0), pool.get_instance(1));
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < 4; ++i) {
+        workers.emplace_back([&]() {
+            for (size_t j = 0; j < 2; ++j) {
+                auto network = pool.acquire();
+                ASSERT_TRUE(network.valid());
+                auto input_tensor = network->get_input_tensor(0);
+                input_tensor->copy_from(*lite_tensor);
+                network->forward();
+                network->wait();
+                compare_lite_tensor<float>(
+                        network->get_output_tensor(0), result_mgb);
+            }
+        });
+    }
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+
+    size_t nr_acquired = 0;
+    for (auto&& stats : pool.get_stats()) {
+        nr_acquired += stats.nr_acquired;
+        ASSERT_GE(stats.utilization, 0.);
+        ASSERT_LE(stats.utilization, 1.);
+    }
+    ASSERT_EQ(nr_acquired, 8u);
+
+    //! the affinity callbacks are run by the worker threads of the instances,
+    //! which are done after the instances forward
+    for (size_t i = 0; i < pool.nr_instances(); ++i) {
+        auto network = pool.get_instance(i);
+        network->get_input_tensor(0)->copy_from(*lite_tensor);
+        network->forward();
+        network->wait();
+    }
+    ASSERT_EQ(nr_affinity_calls, 4u);
+}
+
+TEST(TestNetworkPool, TryAcquire) {
+    Config config;
+    std::string model_path = "./shufflenet.mge";
+
+    NetworkPoolOptions options;
+    options.nr_instances = 2;
+    NetworkPool pool(model_path, options, config);
+
+    auto handle0 = pool.try_acquire();
+    auto handle1 = pool.try_acquire();
+    ASSERT_TRUE(handle0.valid() && handle1.valid());
+    ASSERT_NE(handle0.instance_id(), handle1.instance_id());
+    ASSERT_FALSE(pool.try_acquire().valid());
+
+    handle0.release();
+    auto handle2 = pool.try_acquire();
+    ASSERT_TRUE(handle2.valid());
+    ASSERT_FALSE(handle0.valid());
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+"""search the best load_and_run options of a model on the current device
+
+The candidates are the combinations of the option groups of ``--target``
+(layout, fast-run, weight preprocess, comp seq record level and threads).
+They are ranked by successive halving: all candidates run ``--min-iter``
+iterations, the fastest ``1/eta`` of them run ``eta`` times more iterations,
+and so on until one is left. Candidates with fast-run keep their algo cache
+between rounds, so only the first round pays for profiling.
+
+The winner is written to the output directory as a deployable bundle:
+
+* ``model.mge``: the model, after global layout transform if chosen
+* ``algo_cache``: the fast-run cache, if fast-run is chosen
+* ``lite_info.json``: the model info of the ``LITE_default`` parser, to pack
+  with ``lite/tools/pack_model/pack_model_and_info.py``
+* ``config.json``: the load_and_run args, the Lite ``Options``/``Config`` and
+  runtime settings of the winner, and the latency of every candidate
+"""
+import argparse
+import itertools
+import json
+import math
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from benchmark_models import avg_latency, run_one
+
+# each choice is (name, load_and_run args, lite settings); the lite settings
+# are keys of Options, or "device.*" / "runtime.*" keys of the bundle config
+LAYOUT = {
+    "x86": [
+        ("nchw", [], {}),
+        ("nchw88", ["--enable-nchw88"], {"enable_nchw88": True}),
+        ("gl_transform", ["--layout-transform", "x86"], {}),
+    ],
+    "arm": [
+        ("nchw", [], {}),
+        ("nchw44", ["--enable-nchw44"], {"enable_nchw44": True}),
+        ("nchw44_dot", ["--enable-nchw44-dot"], {"enable_nchw44_dot": True}),
+        ("gl_transform", ["--layout-transform", "arm"], {}),
+    ],
+    "cuda": [
+        ("nchw", [], {}),
+        ("gl_transform", ["--layout-transform", "cuda"], {}),
+    ],
+}
+
+FAST_RUN = [
+    ("heuristic", [], {}),
+    ("fast_run", ["--fast-run"], {"runtime.algo_policy": "LITE_ALGO_PROFILE"}),
+]
+
+WEIGHT_PREPROCESS = [
+    ("no_wp", [], {}),
+    ("wp", ["--weight-preprocess"], {"weight_preprocess": True}),
+]
+
+RECORD = {
+    "cpu": [
+        ("record0", [], {}),
+        ("record1", ["--record-comp-seq"], {"comp_node_seq_record_level": 1}),
+    ],
+    "cuda": [
+        ("record0", [], {}),
+        ("record1", ["--record-comp-seq"], {"comp_node_seq_record_level": 1}),
+        ("record2", ["--record-comp-seq2"], {"comp_node_seq_record_level": 2}),
+    ],
+}
+
+
+def thread_choices(threads):
+    return [
+        ("thread{}".format(n), ["--multithread", str(n)] if n > 1 else [],
+         {"device.number_threads": n})
+        for n in threads
+    ]
+
+
+def make_candidates(args):
+    groups = [LAYOUT[args.target], FAST_RUN, WEIGHT_PREPROCESS]
+    if args.target == "cuda":
+        groups.append(RECORD["cuda"])
+    else:
+        groups.append(RECORD["cpu"])
+        groups.append(thread_choices(args.threads))
+    candidates = []
+    for combo in itertools.product(*groups):
+        name = "-".join(c[0] for c in combo)
+        opts, lite = [], {}
+        for _, o, l in combo:
+            opts += o
+            lite.update(l)
+        candidates.append({"name": name, "opts": opts, "lite": lite})
+    return candidates
+
+
+def uses_algo_cache(cand):
+    return "--fast-run" in cand["opts"]
+
+
+def cache_args(cand, workdir):
+    if not uses_algo_cache(cand):
+        return []
+    return ["--fast-run-algo-policy", os.path.join(workdir, cand["name"] + ".cache")]
+
+
+def successive_halving(args, candidates, workdir):
+    model = {"path": os.path.abspath(args.model), "args": args.model_args}
+    alive, nr_iter, log = candidates, args.min_iter, []
+    while True:
+        print("=== round of {} candidates, {} iters".format(len(alive), nr_iter))
+        scored = []
+        for cand in alive:
+            opts = cand["opts"] + cache_args(cand, workdir)
+            result = run_one(args, ".", model, opts, nr_iter, args.warmup)
+            lat = None if "error" in result else avg_latency(result)
+            log.append({"candidate": cand["name"], "iter": nr_iter, "latency_ms": lat})
+            if lat is None:
+                print("  {}: failed".format(cand["name"]))
+                continue
+            print("  {}: {:.3f}ms".format(cand["name"], lat))
+            cand["result"] = result
+            scored.append((lat, cand["name"], cand))
+        if not scored:
+            raise RuntimeError("all candidates failed")
+        scored.sort(key=lambda x: x[:2])
+        if len(scored) == 1 or nr_iter >= args.max_iter:
+            return scored[0][2], log
+        keep = max(1, int(math.ceil(len(scored) / args.eta)))
+        alive = [c for _, _, c in scored[:keep]]
+        nr_iter = min(nr_iter * args.eta, args.max_iter)
+
+
+def mgb_version(output):
+    m = re.search(r"using MegBrain (\d+)\.(\d+)\.(\d+)", output)
+    return ".".join(m.groups()) if m else None
+
+
+def write_bundle(args, best, log, workdir):
+    os.makedirs(args.output, exist_ok=True)
+    model_out = os.path.join(args.output, "model.mge")
+    opts = best["opts"] + cache_args(best, workdir)
+    cmd = shlex.split(args.runner) if args.runner else []
+    cmd += [args.load_and_run, args.model] + args.model_args + opts
+    cmd += ["--iter", "1", "--warmup-iter", "1"]
+    if "--layout-transform" in opts:
+        cmd += ["--layout-transform-dump", model_out]
+    out = subprocess.run(
+        cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        universal_newlines=True,
+    )
+    if out.returncode:
+        raise RuntimeError("failed to export the winner:\n" + out.stdout[-2000:])
+    if "--layout-transform" not in opts:
+        shutil.copyfile(args.model, model_out)
+
+    has_cache = uses_algo_cache(best)
+    if has_cache:
+        shutil.copyfile(cache_args(best, workdir)[1],
+                        os.path.join(args.output, "algo_cache"))
+
+    options, device, runtime = {}, {}, {}
+    for k, v in best["lite"].items():
+        if k.startswith("device."):
+            device[k[len("device."):]] = v
+        elif k.startswith("runtime."):
+            runtime[k[len("runtime."):]] = v
+        else:
+            options[k] = v
+    if has_cache:
+        runtime["persistent_cache"] = "algo_cache"
+    device["type"] = "CUDA" if args.target == "cuda" else "CPU"
+
+    info = {
+        "name": args.model_name or os.path.splitext(os.path.basename(args.model))[0],
+        "valid": True,
+        "version": mgb_version(out.stdout) or "8.9999.0",
+        "has_compression": False,
+        "device": device,
+        "options": options,
+    }
+    with open(os.path.join(args.output, "lite_info.json"), "w") as fout:
+        json.dump(info, fout, indent=4)
+
+    # the exported model.mge is already transformed
+    lar_args = list(best["opts"])
+    if "--layout-transform" in lar_args:
+        idx = lar_args.index("--layout-transform")
+        del lar_args[idx : idx + 2]
+    if has_cache:
+        lar_args += ["--fast-run-algo-policy", "algo_cache"]
+    config = {
+        "target": args.target,
+        "best": best["name"],
+        "latency_ms": avg_latency(best["result"]),
+        "load_and_run_args": lar_args,
+        "lite": {"device": device, "options": options, "runtime": runtime},
+        "tune_log": log,
+    }
+    with open(os.path.join(args.output, "config.json"), "w") as fout:
+        json.dump(config, fout, indent=4)
+    print("=== best: {} ({:.3f}ms); bundle written to {}".format(
+        best["name"], config["latency_ms"], args.output))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("model", help="model file, with testcases or inputs")
+    parser.add_argument("--target", choices=sorted(LAYOUT), default="x86")
+    parser.add_argument("--model-args", default="",
+                        help="extra load_and_run args of the model, e.g. --input")
+    parser.add_argument("--model-name", help="name in lite_info.json")
+    parser.add_argument("--threads", default="1",
+                        help="comma separated thread numbers to search for cpu")
+    parser.add_argument("--load-and-run", default="load_and_run",
+                        help="path of the load_and_run binary")
+    parser.add_argument("--runner", default="",
+                        help="command prefix to run load_and_run with")
+    parser.add_argument("--min-iter", type=int, default=5,
+                        help="iterations of each candidate in the first round")
+    parser.add_argument("--max-iter", type=int, default=200,
+                        help="iterations in the last round")
+    parser.add_argument("--eta", type=int, default=3,
+                        help="1/eta of the candidates survive each round")
+    parser.add_argument("--warmup", type=int, default=2)
+    parser.add_argument("--timeout", type=float, default=1800,
+                        help="timeout of each run in seconds")
+    parser.add_argument("-o", "--output", required=True,
+                        help="output directory of the bundle")
+    args = parser.parse_args()
+    args.model_args = shlex.split(args.model_args)
+    args.threads = [int(i) for i in args.threads.split(",")]
+    assert args.eta >= 2, "eta should be at least 2"
+
+    candidates = make_candidates(args)
+    print("searching {} candidates".format(len(candidates)))
+    workdir = tempfile.mkdtemp(prefix="lar_autotune_")
+    try:
+        best, log = successive_halving(args, candidates, workdir)
+        write_bundle(args, best, log, workdir)
+    finally:
+        shutil.rmtree(workdir)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
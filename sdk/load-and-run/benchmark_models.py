@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+#
+# Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+"""run load_and_run over a manifest of models and option sets
+
+The manifest is a json file like::
+
+    {
+        "iter": 20,
+        "warmup": 3,
+        "models": [
+            {"name": "resnet50", "path": "resnet50.mge"},
+            {"name": "det", "path": "det.mge", "args": ["--input", "data:img.npy"]}
+        ],
+        "option_sets": {
+            "default": [],
+            "fast_run": ["--fast-run"],
+            "layout_transform": ["--layout-transform", "x86"],
+            "nchw44": ["--enable-nchw44"],
+            "record2": ["--record-comp-seq2"],
+            "thread4": ["--multithread", "4"]
+        }
+    }
+
+Relative model paths are resolved against the directory of the manifest.
+Every model is run with every option set, and the ``--report`` output of each
+run is merged into one report. With ``--baseline``, the report is compared
+with the one of a previous build, e.g. of the master branch, and the exit
+status is non-zero if any latency regresses past ``--threshold``.
+"""
+import argparse
+import json
+import os
+import platform
+import shlex
+import subprocess
+import sys
+import tempfile
+
+METRICS = [
+    ("avg_ms", "latency"),
+    ("first_run_ms", "first run"),
+    ("load_ms", "load"),
+    ("max_rss_kb", "max rss"),
+]
+
+
+def avg_latency(result):
+    cases = result.get("testcases", [])
+    if not cases:
+        return None
+    return sum(i["avg_ms"] for i in cases) / len(cases)
+
+
+def get_metric(result, key):
+    if key == "avg_ms":
+        return avg_latency(result)
+    return result.get(key)
+
+
+def run_one(args, manifest_dir, model, opts, nr_iter, nr_warmup):
+    path = model["path"]
+    if not os.path.isabs(path):
+        path = os.path.join(manifest_dir, path)
+    fd, report = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    cmd = shlex.split(args.runner) if args.runner else []
+    cmd += [args.load_and_run, path] + model.get("args", []) + opts
+    cmd += ["--iter", str(nr_iter), "--warmup-iter", str(nr_warmup)]
+    cmd += ["--report", report]
+    try:
+        out = subprocess.run(
+            cmd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            timeout=args.timeout,
+            universal_newlines=True,
+        )
+        if out.returncode:
+            return {"error": out.stdout[-2000:], "returncode": out.returncode}
+        with open(report) as fin:
+            return json.load(fin)
+    except subprocess.TimeoutExpired:
+        return {"error": "timeout after {}s".format(args.timeout)}
+    finally:
+        os.remove(report)
+
+
+def run_manifest(args):
+    with open(args.manifest) as fin:
+        manifest = json.load(fin)
+    manifest_dir = os.path.dirname(os.path.abspath(args.manifest))
+    option_sets = manifest.get("option_sets", {"default": []})
+    if args.option_sets:
+        names = args.option_sets.split(",")
+        option_sets = {k: v for k, v in option_sets.items() if k in names}
+    nr_iter = manifest.get("iter", 10)
+    nr_warmup = manifest.get("warmup", 1)
+
+    results = {}
+    for model in manifest["models"]:
+        for name, opts in option_sets.items():
+            print("running {} with {}: {}".format(model["name"], name, opts))
+            result = run_one(args, manifest_dir, model, opts, nr_iter, nr_warmup)
+            if "error" in result:
+                print("  failed:\n{}".format(result["error"]))
+            else:
+                print("  latency {:.3f}ms".format(avg_latency(result) or 0))
+            results.setdefault(model["name"], {})[name] = result
+    return {
+        "build": args.build_name or args.load_and_run,
+        "host": platform.node(),
+        "machine": platform.machine(),
+        "results": results,
+    }
+
+
+def fmt(val):
+    if val is None:
+        return "-"
+    return "{:.3f}".format(val) if isinstance(val, float) else str(val)
+
+
+def print_best(report):
+    print("\nbest option set per model:")
+    for model, runs in sorted(report["results"].items()):
+        ok = [(avg_latency(r), k) for k, r in runs.items() if "error" not in r]
+        ok = [i for i in ok if i[0] is not None]
+        if ok:
+            lat, name = min(ok)
+            print("  {}: {} ({:.3f}ms)".format(model, name, lat))
+
+
+def compare(report, baseline, threshold):
+    print("\ncomparing {} against {}:".format(report["build"], baseline["build"]))
+    nr_regression = 0
+    header = "{:<20} {:<20} ".format("model", "options") + " ".join(
+        "{:>24}".format(desc) for _, desc in METRICS
+    )
+    print(header)
+    for model, runs in sorted(report["results"].items()):
+        base_runs = baseline["results"].get(model, {})
+        for name, cur in sorted(runs.items()):
+            base = base_runs.get(name)
+            if base is None or "error" in base or "error" in cur:
+                continue
+            cols = []
+            for key, _ in METRICS:
+                b, c = get_metric(base, key), get_metric(cur, key)
+                if b is None or c is None:
+                    cols.append("{:>24}".format("-"))
+                    continue
+                ratio = c / b if b else 1.0
+                text = "{}->{} ({:+.1%})".format(fmt(b), fmt(c), ratio - 1)
+                if key == "avg_ms" and ratio > 1 + threshold:
+                    nr_regression += 1
+                    text += "!"
+                cols.append("{:>24}".format(text))
+            print("{:<20} {:<20} ".format(model, name) + " ".join(cols))
+    print("{} latency regression(s) over {:.0%}".format(nr_regression, threshold))
+    return nr_regression
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("manifest", help="json manifest of models and option sets")
+    parser.add_argument("--load-and-run", default="load_and_run",
+                        help="path of the load_and_run binary")
+    parser.add_argument("--runner", default="",
+                        help="command prefix to run load_and_run with, e.g. "
+                        "'taskset -c 0-3'; the --report file it writes must be "
+                        "visible to this script")
+    parser.add_argument("--build-name", help="name of the build in the report")
+    parser.add_argument("--option-sets",
+                        help="comma separated option set names to run")
+    parser.add_argument("--timeout", type=float, default=1800,
+                        help="timeout of each run in seconds")
+    parser.add_argument("-o", "--output", help="write the merged report here")
+    parser.add_argument("--baseline", help="report of the baseline build")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative latency slowdown to tolerate")
+    args = parser.parse_args()
+
+    report = run_manifest(args)
+    if args.output:
+        with open(args.output, "w") as fout:
+            json.dump(report, fout, indent=2)
+    print_best(report)
+    if args.baseline:
+        with open(args.baseline) as fin:
+            baseline = json.load(fin)
+        if compare(report, baseline, args.threshold):
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -310,6 +310,13 @@ def optimize_for_inference(args, outputs):
         "enable_fuse_conv_bias_nonlinearity",
         "enable_fuse_conv_bias_with_z",
         "enable_fuse_preprocess",
+        "enable_fuse_horizontal",
+        "enable_block_sparse_weight",
+        "enable_weight_only_quant_int8",
+        "enable_weight_only_quant_int4",
+        "enable_fuse_multi_output_elemwise",
+        "enable_spatial_tiling",
+        "enable_padding_channel",
     ]
     kwargs = {}
     for k in args_list:
@@ -470,7 +477,49 @@ def main():
         "--enable-fuse-preprocess",
         action="store_true",
         help="fuse astype\pad_channel\dimshuffle and etc opr "
-        "from h2d opr",
+        "from h2d opr, and cvt_color/astype/resize/normalize of uint8 images",
+    )
+    parser.add_argument(
+        "--enable-fuse-horizontal",
+        action="store_true",
+        help="fuse the sibling conv/matmul oprs which share an input into "
+        "one wider opr",
+    )
+    parser.add_argument(
+        "--enable-block-sparse-weight",
+        action="store_true",
+        help="compute the matmul/1x1 conv oprs whose weights are mostly zero "
+        "blocks by block sparse matmuls",
+    )
+    parser.add_argument(
+        "--enable-weight-only-quant-int8",
+        action="store_true",
+        help="quantize the constant weights of the matmul oprs to int8 of a "
+        "scale per output channel",
+    )
+    parser.add_argument(
+        "--enable-weight-only-quant-int4",
+        action="store_true",
+        help="quantize the constant weights of the matmul oprs to int4 of a "
+        "scale per output channel",
+    )
+    parser.add_argument(
+        "--enable-fuse-multi-output-elemwise",
+        action="store_true",
+        help="compute sigmoid(x) and sigmoid(x) * y by one kernel when both "
+        "are used",
+    )
+    parser.add_argument(
+        "--enable-spatial-tiling",
+        action="store_true",
+        help="compute the chains of convs, poolings and elemwise oprs on large "
+        "feature maps tile by tile to reduce the memory",
+    )
+    parser.add_argument(
+        "--enable-padding-channel",
+        action="store_true",
+        help="pad the channels of convs to multiple of 4 or 8, so they run in "
+        "the nchw44 or nchw88 layout with --enable-nchw44/nchw44-dot/nchw88",
     )
     args = parser.parse_args()
 
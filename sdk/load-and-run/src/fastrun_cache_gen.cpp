@@ -0,0 +1,357 @@
+/**
+ * \file sdk/load-and-run/src/fastrun_cache_gen.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./fastrun_cache_gen.h"
+
+#include "megbrain/gopt/inference.h"
+#include "megbrain/opr/search_policy/algo_chooser_helper.h"
+#include "megbrain/serialization/serializer.h"
+#include "megbrain/utils/infile_persistent_cache.h"
+#include "megbrain/utils/timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if MGB_HAVE_THREAD
+#include <thread>
+#endif
+
+using namespace mgb;
+
+namespace {
+
+const char* USAGE =
+R"__usage__(
+Usage: load_and_run fastrun-cache-gen <task_file> -o <cache> [options]
+
+Profile every model listed in <task_file> on the given input shapes and write
+the results into one merged fast-run cache, which can be used later by
+`load_and_run --fast-run-algo-policy` or `PersistentCache` on devices of the
+same class (the device name and driver version are part of the cache entries).
+
+Each non-empty line of <task_file> not starting with '#' is
+    <model> [<input>=<shape>]...
+where each of the comma separated dims of <shape> is either a number or an
+inclusive range lo:hi[:step]; all shapes in the ranges are profiled. Inputs not
+given keep the shape stored in the model (or in its test cases). A model may be
+listed on several lines.
+
+Options:
+  -o|--output <path>
+    The cache file or directory to write, see --fast-run-algo-policy of
+    load_and_run. Existing entries are kept and not profiled again.
+  --devices <loc>[,<loc>]...
+    Comp nodes to profile on, such as gpu0,gpu1 or cpu0,cpu1. One worker is
+    started for each device and the tasks are distributed among them, so a
+    device should not be listed twice. All comp nodes of the models are mapped
+    to the device of the worker. Default is xpu0.
+  --full-run
+    Profile all the algorithms instead of only the well optimized ones.
+  --reproducible
+    Only use reproducible algorithms.
+  --shape-bucket-size <size>
+    Set FastRunConfig::shape_bucket_size of the graphs; it is also the default
+    step of shape ranges.
+  --fast-run-shared-batch-size <size>
+    Set FastRunConfig::shared_batch_size of the graphs.
+  --workspace-limit <bytes>
+    Set workspace limit of the profiled operators.
+)__usage__";
+
+//! a model and the shapes its inputs should be profiled on
+struct Task {
+    std::string model_path;
+    //! each item maps input names to shapes
+    std::vector<std::vector<std::pair<std::string, TensorShape>>> shapes;
+};
+
+struct Options {
+    std::string task_file, output;
+    std::vector<std::string> devices;
+    bool full_run = false, reproducible = false;
+    uint32_t shape_bucket_size = 0;
+    int32_t shared_batch_size = 0;
+    int64_t workspace_limit = -1;
+};
+
+std::vector<std::string> split(const std::string& str, char sep) {
+    std::vector<std::string> ret;
+    std::stringstream ss{str};
+    std::string item;
+    while (std::getline(ss, item, sep)) {
+        ret.push_back(item);
+    }
+    return ret;
+}
+
+//! parse a dim like "3" or "224:512:32" into the values it covers
+std::vector<size_t> parse_dim(const std::string& str, size_t default_step) {
+    auto parts = split(str, ':');
+    mgb_assert(
+            !parts.empty() && parts.size() <= 3, "invalid dim in shape: %s",
+            str.c_str());
+    size_t lo = std::stoul(parts[0]), hi = lo, step = default_step;
+    if (parts.size() >= 2) {
+        hi = std::stoul(parts[1]);
+    }
+    if (parts.size() == 3) {
+        step = std::stoul(parts[2]);
+    }
+    mgb_assert(
+            lo && lo <= hi && step, "invalid dim range in shape: %s", str.c_str());
+    std::vector<size_t> ret;
+    for (size_t i = lo; i <= hi; i += step) {
+        ret.push_back(i);
+    }
+    return ret;
+}
+
+//! expand shape ranges of all inputs into their cartesian product
+Task parse_task(const std::string& line, size_t default_step) {
+    std::stringstream ss{line};
+    Task ret;
+    ss >> ret.model_path;
+    ret.shapes.emplace_back();
+    std::string item;
+    while (ss >> item) {
+        auto eq = item.find('=');
+        mgb_assert(
+                eq != std::string::npos && eq, "invalid input shape: %s",
+                item.c_str());
+        auto name = item.substr(0, eq);
+        std::vector<std::vector<size_t>> dims;
+        for (auto&& i : split(item.substr(eq + 1), ',')) {
+            dims.push_back(parse_dim(i, default_step));
+        }
+        mgb_assert(
+                !dims.empty() && dims.size() <= TensorShape::MAX_NDIM,
+                "invalid input shape: %s", item.c_str());
+        std::vector<TensorShape> input_shapes{TensorShape{}};
+        for (auto&& dim : dims) {
+            std::vector<TensorShape> next;
+            for (auto&& shp : input_shapes) {
+                for (auto i : dim) {
+                    auto cur = shp;
+                    cur.shape[cur.ndim++] = i;
+                    next.push_back(cur);
+                }
+            }
+            input_shapes.swap(next);
+        }
+        decltype(ret.shapes) next;
+        for (auto&& prev : ret.shapes) {
+            for (auto&& shp : input_shapes) {
+                next.push_back(prev);
+                next.back().emplace_back(name, shp);
+            }
+        }
+        ret.shapes.swap(next);
+    }
+    return ret;
+}
+
+std::vector<Task> load_tasks(const Options& options) {
+    std::ifstream fin{options.task_file};
+    mgb_assert(fin.good(), "failed to open task file %s", options.task_file.c_str());
+    std::vector<Task> ret;
+    std::string line;
+    while (std::getline(fin, line)) {
+        auto begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        auto default_step = std::max<size_t>(options.shape_bucket_size, 1);
+        ret.push_back(parse_task(line, default_step));
+    }
+    return ret;
+}
+
+//! skip the test cases dumped by dump_with_testcase_mge.py
+void skip_testcase_header(serialization::InputFile& fin) {
+    char magic[8];
+    fin.read(magic, sizeof(magic));
+    if (strncmp(magic, "mgbtest0", 8)) {
+        fin.rewind();
+        return;
+    }
+    uint32_t nr_test;
+    fin.read(&nr_test, sizeof(nr_test));
+}
+
+//! load the model on \p device and execute it on each shape of the task
+void run_task(
+        const Task& task, const CompNode::Locator& device, const Options& options) {
+    auto inp_file = serialization::InputFile::make_fs(task.model_path.c_str());
+    skip_testcase_header(*inp_file);
+    auto format = serialization::GraphLoader::identify_graph_dump_format(*inp_file);
+    mgb_assert(
+            format.valid(), "invalid model %s: unknown model format",
+            task.model_path.c_str());
+    serialization::GraphLoadConfig config;
+    config.comp_graph = ComputingGraph::make();
+    auto&& fast_run_config = config.comp_graph->options().fast_run_config;
+    fast_run_config.shape_bucket_size = options.shape_bucket_size;
+    fast_run_config.shared_batch_size = options.shared_batch_size;
+    config.comp_node_mapper = [device](CompNode::Locator& loc) {
+        loc.type = device.type;
+        loc.device = device.device;
+    };
+    auto loader = serialization::GraphLoader::make(std::move(inp_file), format.val());
+    auto load_ret = loader->load(config, false);
+
+    auto&& output_vars = load_ret.output_var_list;
+    using S = opr::mixin::AlgoChooserHelper::ExecutionPolicy::Strategy;
+    S strategy = S::PROFILE;
+    if (!options.full_run) {
+        strategy = strategy | S::OPTIMIZED;
+    }
+    if (options.reproducible) {
+        strategy = strategy | S::REPRODUCIBLE;
+    }
+    gopt::modify_opr_algo_strategy_inplace(output_vars, strategy);
+    gopt::set_opr_algo_workspace_limit_inplace(output_vars, options.workspace_limit);
+
+    ComputingGraph::OutputSpec out_spec;
+    for (auto&& i : output_vars) {
+        out_spec.push_back({i, {}});
+    }
+    auto func = load_ret.graph_compile(out_spec);
+    for (auto&& shapes : task.shapes) {
+        for (auto&& i : shapes) {
+            auto iter = load_ret.tensor_map.find(i.first);
+            mgb_assert(
+                    iter != load_ret.tensor_map.end(), "model %s has no input %s",
+                    task.model_path.c_str(), i.first.c_str());
+            // only shapes matter for profiling; zero the values to keep
+            // value dependent operators deterministic
+            auto&& tensor = *iter->second;
+            tensor.resize(i.second);
+            memset(tensor.raw_ptr(), 0, tensor.layout().span().dist_byte());
+        }
+        func->execute().wait();
+    }
+}
+
+int parse_args(int argc, char** argv, Options& options) {
+    if (argc < 2) {
+        fprintf(stderr, "%s", USAGE);
+        return 1;
+    }
+    options.task_file = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        auto next = [&]() {
+            mgb_assert(i + 1 < argc, "value not given for %s", argv[i]);
+            return std::string{argv[++i]};
+        };
+        if (!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output")) {
+            options.output = next();
+        } else if (!strcmp(argv[i], "--devices")) {
+            options.devices = split(next(), ',');
+        } else if (!strcmp(argv[i], "--full-run")) {
+            options.full_run = true;
+        } else if (!strcmp(argv[i], "--reproducible")) {
+            options.reproducible = true;
+        } else if (!strcmp(argv[i], "--shape-bucket-size")) {
+            options.shape_bucket_size = std::stoul(next());
+        } else if (!strcmp(argv[i], "--fast-run-shared-batch-size")) {
+            options.shared_batch_size = std::stoi(next());
+        } else if (!strcmp(argv[i], "--workspace-limit")) {
+            options.workspace_limit = std::stoll(next());
+        } else {
+            fprintf(stderr, "invalid option: %s\n%s", argv[i], USAGE);
+            return 1;
+        }
+    }
+    if (options.output.empty()) {
+        fprintf(stderr, "output cache path not given\n%s", USAGE);
+        return 1;
+    }
+    if (options.devices.empty()) {
+        options.devices.push_back("xpu0");
+    }
+#if !MGB_HAVE_THREAD
+    if (options.devices.size() > 1) {
+        mgb_log_warn("no thread support; only profile on %s",
+                     options.devices[0].c_str());
+        options.devices.resize(1);
+    }
+#endif
+    return 0;
+}
+
+}  // anonymous namespace
+
+int mgb_fastrun_cache_gen_main(int argc, char** argv) {
+#if MGB_ENABLE_FASTRUN
+    Options options;
+    if (auto ret = parse_args(argc, argv, options)) {
+        return ret;
+    }
+    auto tasks = load_tasks(options);
+    size_t nr_shape = 0;
+    for (auto&& i : tasks) {
+        nr_shape += i.shapes.size();
+    }
+    mgb_log("profile %zu shapes of %zu tasks on %zu devices", nr_shape, tasks.size(),
+            options.devices.size());
+
+    // all workers share the cache, which is thread safe
+    auto cache_path = InFilePersistentCache::resolve_path(options.output.c_str());
+    auto cache = std::make_shared<InFilePersistentCache>(cache_path.c_str());
+    PersistentCache::set_impl(cache);
+
+    std::atomic_size_t next_task{0}, nr_failed{0};
+    auto worker = [&](const std::string& device) {
+        auto loc = CompNode::Locator::parse(device);
+        for (size_t i; (i = next_task.fetch_add(1)) < tasks.size();) {
+            auto&& task = tasks[i];
+            RealTimer timer;
+            MGB_TRY {
+                run_task(task, loc, options);
+                mgb_log("%s: profiled %zu shapes of %s in %.3fs", device.c_str(),
+                        task.shapes.size(), task.model_path.c_str(),
+                        timer.get_secs());
+            }
+            MGB_CATCH(std::exception & exc, {
+                mgb_log_error("%s: failed to profile %s: %s", device.c_str(),
+                              task.model_path.c_str(), exc.what());
+                ++nr_failed;
+            })
+        }
+    };
+#if MGB_HAVE_THREAD
+    std::vector<std::thread> workers;
+    for (auto&& i : options.devices) {
+        workers.emplace_back(worker, i);
+    }
+    for (auto&& i : workers) {
+        i.join();
+    }
+#else
+    worker(options.devices[0]);
+#endif
+
+    cache->merge_and_dump_cache(options.output.c_str());
+    mgb_log("%zu entries written to %s", cache->nr_entries(), cache_path.c_str());
+    return nr_failed ? 1 : 0;
+#else
+    MGB_MARK_USED_VAR(argc);
+    MGB_MARK_USED_VAR(argv);
+    fprintf(stderr, "fast-run is disabled in this build\n");
+    return 1;
+#endif
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
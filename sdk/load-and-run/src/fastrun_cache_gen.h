@@ -0,0 +1,31 @@
+/**
+ * \file sdk/load-and-run/src/fastrun_cache_gen.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+//! name of the load_and_run subcommand to generate fast-run caches offline
+#define MGB_FASTRUN_CACHE_GEN_CMD "fastrun-cache-gen"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*!
+     * \brief profile a list of models on given shapes and write the results
+     *      into one merged fast-run cache
+     *
+     * argv[0] is the subcommand name; run with no arguments for usage.
+     */
+    int mgb_fastrun_cache_gen_main(int argc, char **argv);
+#ifdef __cplusplus
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
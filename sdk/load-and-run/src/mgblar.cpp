@@ -10,7 +10,7 @@
  */
 
 #include "./mgblar.h"
-#include "./infile_persistent_cache.h"
+#include "./fastrun_cache_gen.h"
 #include "./json_loader.h"
 #include "./npy.h"
 #include "./text_table.h"
@@ -23,32 +23,44 @@
 #include "megbrain/opr/search_policy/algo_chooser_helper.h"
 #include "megbrain/opr/utility.h"
 #include "megbrain/plugin/cpu_dispatch_checker.h"
+#include "megbrain/plugin/non_finite_checker.h"
 #include "megbrain/plugin/num_range_checker.h"
 #include "megbrain/plugin/opr_io_dump.h"
 #include "megbrain/plugin/profiler.h"
+#include "megbrain/plugin/memory_timeline.h"
+#include "megbrain/plugin/startup_profiler.h"
 #include "megbrain/plugin/var_value_checker.h"
 #include "megbrain/serialization/extern_c_opr.h"
 #include "megbrain/serialization/serializer.h"
 #include "megbrain/utils/debug.h"
+#include "megbrain/utils/infile_persistent_cache.h"
 
 #include "megbrain/system.h"
 #include "megbrain/version.h"
 #include "megdnn/version.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <sstream>
+#include <thread>
 
 #if defined(_WIN32)
 #include <io.h>
 #define F_OK 0
 #define access(a, b) _access(a, b)
 #elif __linux__ || __unix__ || __APPLE__
+#include <sys/resource.h>
 #include <unistd.h>
 #include <dlfcn.h>
 #endif
@@ -79,6 +91,23 @@ R"__usage__(
     will be the thread number. for example:--multi-thread-core-ids "0,1,2,3", the
     number thread if 4,the main thread binding the last core '3',
     for best performance, the main thread should binding to the fast core.
+    Use --multi-thread-core-ids auto to bind the threads to the fastest cores
+    detected by their max frequency, with the main thread on the fastest one,
+    so the little cores of big.LITTLE SoCs are not used unless needed.
+  --multi-thread-wait-policy <nr_spin>[:<nr_yield>]
+    How the idle threads of the multi thread pool wait for new tasks: busy-spin
+    nr_spin rounds, then yield nr_yield rounds, and then sleep. nr_yield is
+    unlimited if not given. It should set behind the --multithread param.
+  --cpu-numa
+    Bind the worker threads and memory of CPU comp nodes to the NUMA node
+    selected by the comp node device id (device % number of NUMA nodes). It
+    should set before the --multi-thread-* params.
+  --cpu-huge-page <2M|1G>
+    Back the static memory, workspaces and weights of CPU comp nodes larger
+    than 1MB with huge pages of the given size from hugetlbfs, or transparent
+    huge pages if the hugetlbfs pool is exhausted, to reduce TLB misses. The
+    bytes actually backed by huge pages are logged after running and written
+    to --report. Only available on linux.
   --profile|--profile-host <output>
     Write profiling result to given file. The output file is in JSON format and
     can be processed by scripts in MegHair/utils/debug.
@@ -87,6 +116,28 @@ R"__usage__(
         profiling device time, which may cause additional overhead and make it
         hard to profile host time. Use --profile-host to focus on host time
         profiling.
+  --profile-hw-counter
+    Also read the cycles, instructions, cache misses and branch misses of the
+    operators on CPU comp nodes by perf_event_open, available on Linux and
+    Android. It should set behind the --profile param.
+  --profile-trace <output>
+    Profile the operators and write a timeline to given file in the Chrome
+    trace event format, which can be opened by chrome://tracing or Perfetto.
+    It has a track for each comp node and each dispatch thread, arrows for
+    the dependencies across comp nodes and counters of the used memory.
+  --roofline <output>
+    Profile the operators and write the achieved GFLOP/s and GB/s of each
+    operator to given file in JSON format, ranked by the percent of the
+    roofline of its device, which is given by --roofline-spec.
+  --roofline-spec <file>
+    The peak performance of the devices for --roofline. Each line of the file
+    is "<comp node prefix> <peak GFLOP/s> <peak GB/s>", such as "gpu0 14000
+    900"; the longest matched prefix of the physical comp node name is used.
+  --startup-profile <output>
+    Write the time of the startup phases to given file in JSON format: the
+    flatbuffer parsing, tensor decoding and operator construction of model
+    loading, each graph optimization pass, graph compiling, static memory
+    planning and the fast-run profiling of each operator.
   --input [ filepath | string]
     Set up inputs for megbrain model. for example: --data image.ppm --data
     param.json --data bbox:bbox.npy@batchid:b.npy --data rect:[0,0,227,227];
@@ -98,6 +149,10 @@ R"__usage__(
     Dump input/output values of all internal variables to output file or
     directory, in text or binary format. The binary file can be parsed by
     `megbrain.plugin.load_tensor_binary`.
+  --bin-io-dump-async <output file>
+    Like --bin-io-dump, but write all the values into a single compressed file
+    without synchronizing the execution. The file can be compared by
+    `compare_binary_iodump.py`.
   --io-dump-stdout | --io-dump-stderr
     Dump input/output values of all internal variables to stdout or stderr in text format
   --bin-out-dump <output dir>
@@ -110,6 +165,10 @@ R"__usage__(
     Enable tensor value range check. Exception would be raised if the absolute
     value of any element of any variable does not fit in given range. This can
     be used to debug NaN values.
+  --check-non-finite <interval>
+    Check the float32 outputs of all the operators for inf and nan once in
+    every given number of runs, without syncing and much cheaper than --range.
+    The first operator with non-finite outputs is reported after the runs.
   --check-dispatch
     Enable CPU dispatch checker, which prints a warning message if on operator
     does not the dispatch function. This is used to find potential bugs in
@@ -123,6 +182,13 @@ R"__usage__(
   --disable-mem-opt
     Disable memory optimizations. This is used to check whether memory
     optimization is the cause for unexpected behavior.
+  --cpu-opr-parallel <nr_stream>
+    Distribute the operators on cpuX comp nodes to nr_stream worker threads, so
+    independent branches of the graph run concurrently. It can not be used
+    together with --record-comp-seq.
+  --mem-aware-opr-order <window>
+    Reorder independent operators to lower the peak of static memory usage.
+    At each step at most window ready operators are compared.
   --fake-first
     Enable fake exec for the first run. In fake exec mode, some initialization
     job would be done, but no actual computing is performed. This can be used in
@@ -131,25 +197,48 @@ R"__usage__(
   --const-shape
     Set `GraphLoadConfig::const_var_shape` to true before loading the graph.
     This can be used to reduce memory usage since some static inference data
-    structures can be omitted.
+    structures can be omitted. The shape computations are folded into constants
+    as well.
   --share-param-mem
     Share the memory used by model params with model storage. This can be used
     to reduce memory usage when computing on CPU.
+  --mmap-model
+    Map the model file into memory and share the pages with model params when
+    they are aligned (see GraphDumpConfig::tensor_value_alignment). Processes
+    loading the same model would share the page cache.
   --record-comp-seq | --record-comp-seq2
     Record the computing sequence, in level 1 or 2. It reduces overhead of API
     calls of some asynchronous computing devices, especially for OpenCL. In
     level 2 the computing graph can be destructed to reduce memory usage. Read
     the doc of `ComputingGraph::Options::comp_node_seq_record_level` for more
     details.
+  --record-comp-seq-cache <nr_shape>
+    Keep the computing sequences recorded by --record-comp-seq for at most
+    nr_shape previous input shapes, so they are replayed again when the input
+    shape changes back.
 )__usage__"
 #ifndef __IN_TEE_ENV__
 #if MGB_ENABLE_JSON
 R"__usage__(
   --get-static-mem-info <log_dir_path>
     Record the static graph's static memory info.
+  --memory-timeline <prefix>
+    Write the memory chunks of the static and dynamic vars over the oprs of the
+    last execution to <prefix>.json, with the usage and the chunks live at the
+    peak of each memory node, and draw them to <prefix>.svg.
 )__usage__"
 #endif
 #endif
+#if MGB_ENABLE_JSON
+R"__usage__(
+  --report <path>
+    Write a json summary of the run to the file: the time of loading the model,
+    of preparing and of the first run, the latency statistics of each testcase,
+    the static memory on each comp node and the peak resident memory of the
+    process. The reports of many models and option sets are collected and
+    compared by sdk/load-and-run/benchmark_models.py.
+)__usage__"
+#endif
 #if MGB_ENABLE_FASTRUN
 R"__usage__(
  --full-run
@@ -167,6 +256,11 @@ R"__usage__(
 R"__usage__(
   --fast-run-algo-policy <path>
     It will read the cache file before profile, and save new fastrun in cache file.
+    The path can be a directory shared by multiple machines, and cache of the
+    current build in it would be used. New results are merged into the file, and
+    stale cache of a different build is discarded.
+    Use `load_and_run fastrun-cache-gen` to generate the cache of many models
+    and shapes offline.
   --fast-run-shared-batch-size
     Set the batch size used during fastrun, Note that it may not be the same as the actual running batch size
   --binary-equal-between-batch
@@ -176,6 +270,8 @@ R"__usage__(
     Enable choose algo which is reproducible. It mainly used for cudnn algos.
     See https://docs.nvidia.com/deeplearning/sdk/cudnn-developer-guide/index.html#reproducibility
     for more details.
+    Oprs accumulating by atomics, such as IndexingIncrMultiAxisVec on CUDA,
+    also switch to their deterministic implementations.
   --wait-gdb
     Print PID and wait for a line from stdin before starting execution. Useful
     for waiting for gdb attach.
@@ -189,6 +285,22 @@ R"__usage__(
     Number of threads to run concurrently. All threads perform the same work of
     loading and executing models. This is used for test thread safety, not for
     speed up on multiple cores.
+  --shape-sweep <shapes> | --shape-sweep @<trace file>
+    Run the model with a sequence of input shapes for --iter rounds, and report
+    the latency of each shape set and the cost of shape changes: the latency of
+    the first run after the shape changes, the fast-run cache misses and the
+    reallocations of the static memory. The shape sets are separated by ';',
+    and the inputs in a set are separated by ',', for example
+    "data:1x3x224x224;data:8x3x224x224". The name can be omitted for a model
+    with only one input. With @, the shape sets are read from the trace file,
+    one set per line. The input values are filled with zero.
+  --throughput <nr_clients>
+    Run nr_clients instances of the model concurrently, each in a thread of its
+    own, for a fixed duration, and report the QPS, the p50/p90/p99/p999 latency
+    and the cpu utilization. The instances share the params with
+    --share-param-mem. --iter is ignored in this mode.
+  --throughput-duration <seconds>
+    The duration of --throughput, 10 seconds by default.
   --disable-assert-throw
     Do not throw exception in case AssertEqual fails. Note that the exit code
     would also be zero if this option is enabled. This should only be used for
@@ -240,9 +352,46 @@ R"__usage__(
     Execute operators with weight preprocess, which can optimize the operator execution time with
     algo of winograd, im2col ,etc., but it may consume more memory.
 )__usage__"
+R"__usage__(
+  --weight-preprocess-cache
+    With --weight-preprocess, load the preprocessed weights from the cache given by
+    --fast-run-algo-policy and save the newly preprocessed ones there, so later runs only copy
+    them.
+)__usage__"
 R"__usage__(
   --enable-fuse-preprocess
-    Fusion astype\pad_channel\dimshuffle and etc opr from h2d op
+    Fusion astype\pad_channel\dimshuffle and etc opr from h2d op, and
+    cvt_color\astype\resize\normalize of uint8 images into one opr
+)__usage__"
+R"__usage__(
+  --enable-fuse-horizontal
+    Fuse the sibling conv/matmul oprs which share an input into one wider opr
+)__usage__"
+R"__usage__(
+  --enable-block-sparse-weight
+    Compute the matmul/1x1 conv oprs whose weights are mostly zero blocks by block
+    sparse matmuls
+)__usage__"
+R"__usage__(
+  --enable-weight-only-quant-int8 | --enable-weight-only-quant-int4
+    Quantize the constant weights of the matmul oprs to int8 or int4 of a scale
+    per output channel, while the activations stay in float
+)__usage__"
+R"__usage__(
+  --enable-fuse-multi-output-elemwise
+    Compute sigmoid(x) and sigmoid(x) * y by one kernel when both are used
+)__usage__"
+R"__usage__(
+  --enable-spatial-tiling
+    Compute the chains of NCHW convolutions, poolings and elemwise operators on
+    feature maps larger than 256x256 tile by tile, to run high resolution models
+    with less memory.
+)__usage__"
+R"__usage__(
+  --enable-padding-channel
+    Pad the channels of the float32 and qint8 convolutions to multiple of 4 or 8,
+    so they are also executed with --enable-nchw44, --enable-nchw44-dot or
+    --enable-nchw88 when the channels are not aligned.
 )__usage__"
 R"__usage__(
   --enable-nchw64
@@ -251,7 +400,9 @@ R"__usage__(
 )__usage__"
 R"__usage__(
   --layout-transform [cuda|x86|arm|opencl|unspec]
-    Enable global layout transform optimization for computing graph. User should specify the device target for the optimization, and a series of passes will be applied on the computing graph. The passes will benchmark the elapsed time of operators on different tensor layouts, and select fastest implementation for the operators. The optimization process will take some time. The default target is unspec, which all the available for operators will be profiled. So the optimize time will be longer.
+    Enable global layout transform optimization for computing graph. User should specify the device target for the optimization, and a series of passes will be applied on the computing graph. The passes will benchmark the elapsed time of operators on different tensor layouts, and select fastest implementation for the operators. The optimization process will take some time. The default target is unspec, which all the available for operators will be profiled. So the optimize time will be longer. The profiling results are saved in the cache file given by --fast-run-algo-policy, and would be reused by later runs.
+  --layout-transform-cost-model
+    Estimate the elapsed time of operators in the global layout transform by the cost model of the target, instead of benchmarking them. So the target device is not needed, e.g. for optimizing models of arm on a x86 machine, at the cost of accuracy.
   --layout-transform-dump <dump_path>
     The computing graph after global layout transform will be dumped to the given file path.
   --layout-transform-verify
@@ -531,6 +682,65 @@ private:
     };
 };
 
+#if MGB_ENABLE_JSON
+//! summary of a run written by --report
+class RunReport {
+    std::shared_ptr<json::Object> m_root = json::Object::make();
+    std::shared_ptr<json::Array> m_testcases = json::Array::make();
+
+public:
+    void set(const char* key, double val) {
+        (*m_root)[key] = json::Number::make(val);
+    }
+
+    void add_testcase(
+            int nr_run, double avg_ms, double sd_ms, double min_ms, double max_ms) {
+        auto tc = json::Object::make();
+        (*tc)["nr_run"] = json::NumberInt::make(nr_run);
+        (*tc)["avg_ms"] = json::Number::make(avg_ms);
+        (*tc)["sd_ms"] = json::Number::make(sd_ms);
+        (*tc)["min_ms"] = json::Number::make(min_ms);
+        (*tc)["max_ms"] = json::Number::make(max_ms);
+        m_testcases->add(tc);
+    }
+
+    void set_static_mem(const CompNode::UnorderedMap<size_t>& mem) {
+        auto obj = json::Object::make();
+        for (auto&& i : mem) {
+            (*obj)[i.first.to_string_logical()] = json::NumberInt::make(i.second);
+        }
+        (*m_root)["static_mem_bytes"] = obj;
+    }
+
+    void set_huge_pages(const CompNode::HugePageStats& stats) {
+        auto obj = json::Object::make();
+        (*obj)["mapped_bytes"] = json::NumberInt::make(stats.nr_bytes_mapped);
+        (*obj)["hugetlb_bytes"] = json::NumberInt::make(stats.nr_bytes_hugetlb);
+        (*obj)["huge_bytes"] = json::NumberInt::make(stats.nr_bytes_huge);
+        (*obj)["failed_bytes"] = json::NumberInt::make(stats.nr_bytes_failed);
+        (*m_root)["huge_pages"] = obj;
+    }
+
+    void write(const std::string& model_path, const std::string& path) {
+        (*m_root)["model"] = json::String::make(model_path);
+        (*m_root)["testcases"] = m_testcases;
+#if __linux__ || __unix__ || __APPLE__
+        rusage usage;
+        if (!getrusage(RUSAGE_SELF, &usage)) {
+#if __APPLE__
+            // ru_maxrss is in bytes on macOS and in KiB elsewhere
+            set("max_rss_kb", usage.ru_maxrss / 1024);
+#else
+            set("max_rss_kb", usage.ru_maxrss);
+#endif
+        }
+#endif
+        m_root->writeto_fpath(path);
+        mgb_log("run report written to %s", path.c_str());
+    }
+};
+#endif
+
 struct Args {
     int args_parse_ret = 0;
 
@@ -553,6 +763,7 @@ struct Args {
     bool display_model_info = false;
     bool disable_assert_throw = false;
     bool share_param_mem = false;
+    bool mmap_model = false;
 #if MGB_ENABLE_FASTRUN
     bool use_full_run = false;
     bool use_fast_run = false;
@@ -569,17 +780,32 @@ struct Args {
     int nr_warmup = 1;
     int nr_thread = 1;
     int multithread_number = 1;
+    int throughput_clients = 0;
+    double throughput_duration = 10;
+    std::string shape_sweep;
     size_t workspace_limit = SIZE_MAX;
     std::vector<std::string> data_files;
     serialization::GraphLoader::LoadResult load_ret;
 #if MGB_ENABLE_JSON
     std::unique_ptr<GraphProfiler> profiler;
+    std::unique_ptr<StartupProfiler> startup_profiler;
+    std::unique_ptr<MemoryTimeline> memory_timeline;
 #endif
     std::string profiler_output;
+    std::string startup_profiler_output;
+    std::string memory_timeline_output;
+    std::string trace_output;
+    std::string roofline_output;
+    std::string report_output;
+#if MGB_ENABLE_JSON
+    std::unique_ptr<RunReport> report;
+#endif
+    GraphProfiler::DeviceSpecTable roofline_spec;
     std::string bin_out_dump;
 
     std::unique_ptr<OprIODumpBase> iodump;
     std::unique_ptr<NumRangeChecker> num_range_checker;
+    std::unique_ptr<NonFiniteChecker> non_finite_checker;
     std::unique_ptr<CPUDispatchChecker> cpu_dispatch_checker;
     std::unique_ptr<VarValueChecker> var_value_checker;
     serialization::GraphLoader::LoadConfig load_config;
@@ -588,6 +814,7 @@ struct Args {
     bool layout_transform = false;
     gopt::GraphTuningOptions::Target layout_transform_target =
             gopt::GraphTuningOptions::Target::UNSPEC;
+    bool layout_transform_cost_model = false;
     std::string layout_transform_dump_path;
 
     static Args from_argv(int argc, char **argv);
@@ -701,41 +928,9 @@ void format_and_print(const std::string& tablename, const Args& env) {
     printf("%s\n\n", ss.str().c_str());
 }
 
-void run_test_st(Args &env) {
-    std::unique_ptr<serialization::InputFile> inp_file;
-
-    if (env.share_param_mem) {
-        FILE *fin = fopen(env.model_path.c_str(), "rb");
-        mgb_assert(fin, "failed to open %s: %s", env.model_path.c_str(),
-                strerror(errno));
-        auto size = get_file_size(fin);
-        void *ptr = malloc(size);
-        std::shared_ptr<void> buf{ptr, free};
-        auto nr = fread(buf.get(), 1, size, fin);
-        mgb_assert(nr == size);
-        fclose(fin);
-        inp_file = serialization::InputFile::make_mem_proxy(buf, size);
-    } else {
-        inp_file = serialization::InputFile::make_fs(
-                env.model_path.c_str());
-    }
-    auto nr_test = read_nr_test(*inp_file);
-
-    auto format =
-            serialization::GraphLoader::identify_graph_dump_format(*inp_file);
-    mgb_assert(format.valid(),
-               "invalid model: unknown model format, please make sure input "
-               "file is generated by GraphDumper");
-    auto loader =
-            serialization::GraphLoader::make(std::move(inp_file), format.val());
-    RealTimer timer;
-    env.load_ret = loader->load(env.load_config, false);
-
-    // graph is no longer needed; reset so memory can be reclaimed
-    env.load_config.comp_graph.reset();
-
-    printf("load model: %.3fms\n", timer.get_msecs_reset());
-
+//! apply the algo strategy, workspace limit and fast-run cache of the args to
+//! the loaded model
+void apply_algo_policy(Args& env) {
     auto& output_var_list = env.load_ret.output_var_list;
     mgb::gopt::set_opr_algo_workspace_limit_inplace(output_var_list,
                                                     env.workspace_limit);
@@ -757,22 +952,17 @@ void run_test_st(Args &env) {
 #endif
     mgb::gopt::modify_opr_algo_strategy_inplace(output_var_list, strategy);
     if (!env.fast_run_cache_path.empty()) {
+        // the cache path may be a directory shared by multiple machines
+        auto cache_path = InFilePersistentCache::resolve_path(
+                env.fast_run_cache_path.c_str());
 #if MGB_ENABLE_FASTRUN
-        if (!access(env.fast_run_cache_path.c_str(), F_OK)) {
+        if (!access(cache_path.c_str(), F_OK)) {
 #else
-        mgb_assert(access(env.fast_run_cache_path.c_str(), F_OK) == 0,
+        mgb_assert(access(cache_path.c_str(), F_OK) == 0,
                    "fast-run cache file can't be accessed");
 #endif
-            FILE* fin = fopen(env.fast_run_cache_path.c_str(), "rb");
-            auto flen = get_file_size(fin);
-            std::unique_ptr<uint8_t[]> buf{new uint8_t[flen]};
-            size_t ret = fread(buf.get(), flen, 1, fin);
-            MGB_MARK_USED_VAR(ret);
-            mgb_assert(ret == 1, "read 1 block (got %zu), and block size %zu.",
-                       ret, flen);
-            fclose(fin);
             PersistentCache::set_impl(
-                    std::make_shared<InFilePersistentCache>(buf.get(), flen));
+                    std::make_shared<InFilePersistentCache>(cache_path.c_str()));
 #if MGB_ENABLE_FASTRUN
         } else {
             mgb_assert(env.use_full_run || env.use_fast_run,
@@ -784,6 +974,264 @@ void run_test_st(Args &env) {
 #endif
             mgb::gopt::enable_opr_use_profiling_cache_inplace(output_var_list);
     }
+}
+
+//! the input shapes of one run in --shape-sweep
+using ShapeSet = std::vector<std::pair<std::string, TensorShape>>;
+
+/*!
+ * \brief parse the spec of --shape-sweep, which is a list of shape sets
+ * separated by ';', or '@' followed by a trace file of one shape set per line
+ *
+ * A shape set is the inputs separated by ',' in the form of name:NxCxHxW, and
+ * the name can be omitted for a model with only one input.
+ */
+std::vector<ShapeSet> parse_shape_sweep(const std::string& spec) {
+    std::vector<std::string> lines;
+    if (!spec.empty() && spec[0] == '@') {
+        std::ifstream fin(spec.substr(1));
+        mgb_assert(fin.is_open(), "failed to open shape trace %s",
+                   spec.c_str() + 1);
+        std::string line;
+        while (std::getline(fin, line)) {
+            lines.push_back(line);
+        }
+    } else {
+        std::stringstream ss(spec);
+        std::string line;
+        while (std::getline(ss, line, ';')) {
+            lines.push_back(line);
+        }
+    }
+
+    std::vector<ShapeSet> ret;
+    for (auto&& line : lines) {
+        ShapeSet shape_set;
+        std::stringstream line_ss(line);
+        std::string item;
+        while (std::getline(line_ss, item, ',')) {
+            item.erase(std::remove_if(item.begin(), item.end(), ::isspace),
+                       item.end());
+            if (item.empty()) {
+                continue;
+            }
+            std::string name, dims = item;
+            auto sep = item.find(':');
+            if (sep != std::string::npos) {
+                name = item.substr(0, sep);
+                dims = item.substr(sep + 1);
+            }
+            TensorShape shape;
+            std::stringstream dims_ss(dims);
+            std::string dim;
+            while (std::getline(dims_ss, dim, 'x')) {
+                mgb_assert(shape.ndim < TensorShape::MAX_NDIM,
+                           "too many dims in shape %s", item.c_str());
+                shape[shape.ndim++] = std::stoul(dim);
+            }
+            mgb_assert(shape.ndim, "invalid shape %s", item.c_str());
+            shape_set.emplace_back(name, shape);
+        }
+        if (!shape_set.empty()) {
+            ret.emplace_back(std::move(shape_set));
+        }
+    }
+    mgb_assert(!ret.empty(), "no shape is given by --shape-sweep %s", spec.c_str());
+    return ret;
+}
+
+std::string shape_set_to_string(const ShapeSet& shape_set) {
+    std::string ret;
+    for (auto&& i : shape_set) {
+        if (!ret.empty()) {
+            ret += ",";
+        }
+        ret += i.first + ":" + i.second.to_string();
+    }
+    return ret;
+}
+
+//! forward a PersistentCache and count the lookup misses and the puts, which
+//! are the profilings of fast-run
+class CountingPersistentCache final : public PersistentCache {
+public:
+    //! the forwarded implementation, which is the one replaced by this cache
+    std::shared_ptr<PersistentCache> impl;
+    std::atomic_size_t nr_miss{0}, nr_put{0};
+
+    Maybe<Blob> get(const std::string& category, const Blob& key) override {
+        auto ret = impl->get(category, key);
+        if (!ret.valid()) {
+            ++nr_miss;
+        }
+        return ret;
+    }
+
+    void put(const std::string& category, const Blob& key,
+             const Blob& value) override {
+        ++nr_put;
+        impl->put(category, key, value);
+    }
+};
+
+/*!
+ * \brief run the shape sets of --shape-sweep in order for env.nr_run rounds,
+ * and report the latency of each shape set and the cost of shape changes
+ *
+ * The first run after the shape changes includes the re-planning of the
+ * graph, the fast-run of the new shapes and the reallocation of the static
+ * memory, so it is reported separately from the steady runs of the same shape
+ * set.
+ */
+void run_shape_sweep(Args& env, cg::AsyncExecutable& func) {
+    auto shape_sets = parse_shape_sweep(env.shape_sweep);
+    auto& tensor_map = env.load_ret.tensor_map;
+    mgb_assert(!tensor_map.empty(), "--shape-sweep requires a model with inputs");
+    auto set_shapes = [&](const ShapeSet& shape_set) {
+        for (auto&& i : shape_set) {
+            auto iter = i.first.empty() ? tensor_map.begin()
+                                        : tensor_map.find(i.first);
+            mgb_assert(iter != tensor_map.end() &&
+                               (!i.first.empty() || tensor_map.size() == 1),
+                       "input %s of --shape-sweep is not in the model",
+                       i.first.c_str());
+            auto&& hv = *iter->second;
+            hv.resize(i.second);
+            memset(hv.raw_ptr(), 0, hv.layout().span().dist_byte());
+        }
+    };
+
+    CompNode::UnorderedSet comp_nodes;
+    for (auto&& i : env.load_ret.output_var_list) {
+        comp_nodes.insert(i.node()->comp_node());
+    }
+    auto static_mem_size = [&]() {
+        size_t size = 0;
+        for (auto&& cn : comp_nodes) {
+            size += env.load_ret.graph->get_device_memory_size(cn);
+        }
+        return size;
+    };
+
+
+    struct Stat {
+        std::vector<double> steady_ms, change_ms;
+    };
+    std::vector<Stat> stats(shape_sets.size());
+    size_t nr_change = 0, nr_realloc = 0, max_mem = 0;
+    size_t prev = shape_sets.size();
+    RealTimer timer;
+    // the warmup runs are on the first shape set
+    set_shapes(shape_sets[0]);
+    for (int run = 0; run < env.nr_warmup; ++run) {
+        func.execute().wait();
+        printf("warmup %d: %.3fms\n", run, timer.get_msecs_reset());
+        prev = 0;
+    }
+    size_t mem = static_mem_size();
+
+    // count the fast-run misses after the warmup
+    auto cache = std::make_shared<CountingPersistentCache>();
+    cache->impl = PersistentCache::set_impl(cache);
+    printf("=== going to run %zu shape sets for %d rounds\n", shape_sets.size(),
+           env.nr_run);
+    for (int round = 0; round < env.nr_run; ++round) {
+        for (size_t idx = 0; idx < shape_sets.size(); ++idx) {
+            bool changed = idx != prev &&
+                           (prev == shape_sets.size() ||
+                            shape_set_to_string(shape_sets[idx]) !=
+                                    shape_set_to_string(shape_sets[prev]));
+            set_shapes(shape_sets[idx]);
+            timer.reset();
+            func.execute().wait();
+            auto cur = timer.get_msecs();
+            prev = idx;
+            auto cur_mem = static_mem_size();
+            if (cur_mem != mem) {
+                ++nr_realloc;
+                mem = cur_mem;
+            }
+            max_mem = std::max(max_mem, mem);
+            if (changed) {
+                ++nr_change;
+                stats[idx].change_ms.push_back(cur);
+            } else {
+                stats[idx].steady_ms.push_back(cur);
+            }
+            mgb_log_debug("load_and_run: shape set #%zu: %.3fms%s", idx, cur,
+                          changed ? " (shape changed)" : "");
+        }
+    }
+    PersistentCache::set_impl(cache->impl);
+
+    auto avg = [](const std::vector<double>& v) {
+        return v.empty() ? 0.
+                         : std::accumulate(v.begin(), v.end(), 0.) / v.size();
+    };
+    double tot_overhead = 0;
+    for (size_t idx = 0; idx < shape_sets.size(); ++idx) {
+        auto&& stat = stats[idx];
+        double steady = avg(stat.steady_ms), change = avg(stat.change_ms);
+        printf("shape set #%zu %s: steady=%.3fms (%zu runs) "
+               "after_change=%.3fms (%zu runs)\n",
+               idx, shape_set_to_string(shape_sets[idx]).c_str(), steady,
+               stat.steady_ms.size(), change, stat.change_ms.size());
+        if (!stat.steady_ms.empty()) {
+            tot_overhead += (change - steady) * stat.change_ms.size();
+        }
+    }
+    printf("=== finished shape sweep: shape_changes=%zu avg_change_overhead=%.3fms "
+           "fast_run_misses=%zu fast_run_profiled=%zu static_mem_reallocs=%zu "
+           "max_static_mem=%.3fMiB\n\n",
+           nr_change, nr_change ? tot_overhead / nr_change : 0.,
+           cache->nr_miss.load(), cache->nr_put.load(), nr_realloc,
+           max_mem / 1024.0 / 1024.0);
+}
+
+void run_test_st(Args &env) {
+    std::unique_ptr<serialization::InputFile> inp_file;
+
+    if (env.share_param_mem) {
+        FILE *fin = fopen(env.model_path.c_str(), "rb");
+        mgb_assert(fin, "failed to open %s: %s", env.model_path.c_str(),
+                strerror(errno));
+        auto size = get_file_size(fin);
+        void *ptr = malloc(size);
+        std::shared_ptr<void> buf{ptr, free};
+        auto nr = fread(buf.get(), 1, size, fin);
+        mgb_assert(nr == size);
+        fclose(fin);
+        inp_file = serialization::InputFile::make_mem_proxy(buf, size);
+    } else if (env.mmap_model) {
+        inp_file = serialization::InputFile::make_mmap(env.model_path.c_str());
+    } else {
+        inp_file = serialization::InputFile::make_fs(
+                env.model_path.c_str());
+    }
+    auto nr_test = read_nr_test(*inp_file);
+
+    auto format =
+            serialization::GraphLoader::identify_graph_dump_format(*inp_file);
+    mgb_assert(format.valid(),
+               "invalid model: unknown model format, please make sure input "
+               "file is generated by GraphDumper");
+    auto loader =
+            serialization::GraphLoader::make(std::move(inp_file), format.val());
+    RealTimer timer;
+    env.load_ret = loader->load(env.load_config, false);
+
+    // graph is no longer needed; reset so memory can be reclaimed
+    env.load_config.comp_graph.reset();
+
+    auto load_ms = timer.get_msecs_reset();
+    printf("load model: %.3fms\n", load_ms);
+#if MGB_ENABLE_JSON
+    if (env.report) {
+        env.report->set("load_ms", load_ms);
+    }
+#endif
+
+    apply_algo_policy(env);
 
     // load testcase
     decltype(env.load_ret) testcase;
@@ -795,7 +1243,8 @@ void run_test_st(Args &env) {
 
     if (env.layout_transform) {
         env.load_ret.output_var_list = gopt::layout_transform(
-                env.load_ret.output_var_list, env.layout_transform_target);
+                env.load_ret.output_var_list, env.layout_transform_target,
+                env.layout_transform_cost_model);
         if (!env.layout_transform_dump_path.empty()) {
             auto out_file = serialization::OutputFile::make_fs(
                     env.layout_transform_dump_path.c_str(), 'w');
@@ -873,12 +1322,23 @@ void run_test_st(Args &env) {
 #endif
 #endif
     auto warmup = [&]() {
-        printf("=== prepare: %.3fms; going to warmup\n",
-               timer.get_msecs_reset());
+        auto prepare_ms = timer.get_msecs_reset();
+        printf("=== prepare: %.3fms; going to warmup\n", prepare_ms);
         for (int run = 0; run < env.nr_warmup; ++run) {
             func->execute().wait();
-            printf("warmup %d: %.3fms\n", run, timer.get_msecs_reset());
+            auto cur = timer.get_msecs_reset();
+            printf("warmup %d: %.3fms\n", run, cur);
+#if MGB_ENABLE_JSON
+            if (env.report && !run) {
+                env.report->set("first_run_ms", cur);
+            }
+#endif
         }
+#if MGB_ENABLE_JSON
+        if (env.report) {
+            env.report->set("prepare_ms", prepare_ms);
+        }
+#endif
     };
 
     auto run_iters = [&](uint32_t case_idx) -> float {
@@ -906,17 +1366,28 @@ void run_test_st(Args &env) {
                 max_time = cur;
             }
         }
+        auto sd = std::sqrt(
+                (time_sqrsum * env.nr_run - time_sum * time_sum) /
+                (env.nr_run * (env.nr_run - 1)));
         printf("=== finished test #%u: time=%.3fms avg_time=%.3fms "
                "sd=%.3fms minmax=%.3f,%.3f\n\n",
-               case_idx, time_sum, time_sum / env.nr_run,
-               std::sqrt((time_sqrsum * env.nr_run - time_sum * time_sum) /
-                         (env.nr_run * (env.nr_run - 1))),
-               min_time, max_time);
+               case_idx, time_sum, time_sum / env.nr_run, sd, min_time, max_time);
+#if MGB_ENABLE_JSON
+        if (env.report) {
+            env.report->add_testcase(
+                    env.nr_run, time_sum / env.nr_run, sd, min_time, max_time);
+        }
+#endif
         return time_sum;
 
     };
 
-    if (nr_test) {
+    if (!env.shape_sweep.empty()) {
+        mgb_assert(!env.c_opr_args.is_run_c_opr_with_param,
+                   "run c opr with param only support dump_with_testcase!!");
+        printf("=== prepare: %.3fms\n", timer.get_msecs_reset());
+        run_shape_sweep(env, *func);
+    } else if (nr_test) {
         // run testcase, generated by dump_with_testcase.py
 
         std::vector<std::pair<std::string, HostTensorND*>> inp_tensors;
@@ -1025,6 +1496,11 @@ void run_test_st(Args &env) {
         }
 
         printf("=== total time: %.3fms\n", tot_time);
+#if MGB_ENABLE_JSON
+        if (env.report) {
+            env.report->set("total_ms", tot_time);
+        }
+#endif
     } else if (not env.data_files.empty()) {
         mgb_assert(!env.c_opr_args.is_run_c_opr_with_param,
                    "run c opr with param only support dump_with_testcase!!");
@@ -1064,29 +1540,102 @@ void run_test_st(Args &env) {
         timer.reset();
         printf("=== going to run for %d times; output vars: %s\n",
                 env.nr_run, output_names.c_str());
+        std::vector<double> times;
         for (int i = 0; i < env.nr_run; ++ i) {
             mgb_log_debug("load_and_run: before benchmark iter %d", i);
             auto start = timer.get_msecs();
             func->execute().wait();
             output_dumper.write_to_file();
-            printf("=== finished run #%d: time=%.3fms\n", i,
-                    timer.get_msecs() - start);
+            times.push_back(timer.get_msecs() - start);
+            printf("=== finished run #%d: time=%.3fms\n", i, times.back());
             fflush(stdout);
         }
         printf("avg time: %.3fms\n", timer.get_msecs() / env.nr_run);
+#if MGB_ENABLE_JSON
+        if (env.report && !times.empty()) {
+            double sum = 0, sqrsum = 0;
+            for (auto t : times) {
+                sum += t;
+                sqrsum += t * t;
+            }
+            double avg = sum / times.size(),
+                   sd = std::sqrt(std::max(sqrsum / times.size() - avg * avg, 0.));
+            env.report->set("total_ms", timer.get_msecs());
+            env.report->add_testcase(
+                    env.nr_run, avg, sd,
+                    *std::min_element(times.begin(), times.end()),
+                    *std::max_element(times.begin(), times.end()));
+        }
+#endif
+    }
+    if (env.non_finite_checker && !env.non_finite_checker->poll(true).valid()) {
+        mgb_log("no non-finite value found");
+    }
+    if (CompNode::get_cpu_huge_page_size()) {
+        auto stats = CompNode::get_cpu_huge_page_stats();
+        constexpr double MiB = 1024.0 * 1024.0;
+        mgb_log("huge pages: mapped=%.3fMiB hugetlb=%.3fMiB backed=%.3fMiB "
+                "(%.1f%%) failed=%.3fMiB",
+                stats.nr_bytes_mapped / MiB, stats.nr_bytes_hugetlb / MiB,
+                stats.nr_bytes_huge / MiB,
+                stats.nr_bytes_mapped
+                        ? 100.0 * stats.nr_bytes_huge / stats.nr_bytes_mapped
+                        : 0.0,
+                stats.nr_bytes_failed / MiB);
+#if MGB_ENABLE_JSON
+        if (env.report) {
+            env.report->set_huge_pages(stats);
+        }
+#endif
     }
 
 #if MGB_ENABLE_JSON
-    if (env.profiler) {
+    if (env.profiler && !env.profiler_output.empty()) {
         env.profiler->to_json_full(func.get())->writeto_fpath(
                 env.profiler_output);
         mgb_log("profiling result written to %s", env.profiler_output.c_str());
     }
+    if (env.profiler && !env.trace_output.empty()) {
+        env.profiler->to_chrome_trace()->writeto_fpath(env.trace_output);
+        mgb_log("trace written to %s", env.trace_output.c_str());
+    }
+    if (env.profiler && !env.roofline_output.empty()) {
+        env.profiler->to_roofline_json(env.roofline_spec)
+                ->writeto_fpath(env.roofline_output);
+        mgb_log("roofline report written to %s", env.roofline_output.c_str());
+    }
+    if (env.startup_profiler) {
+        auto json = env.startup_profiler->to_json();
+        json->writeto_fpath(env.startup_profiler_output);
+        mgb_log("startup profiling result written to %s (total %.3fms)",
+                env.startup_profiler_output.c_str(),
+                (*json)["total_ms"]->cast_final_safe<json::Number>().get_impl());
+    }
+    if (env.report) {
+        // the graph is destructed after compiling with record level 2
+        if (auto&& graph = env.load_ret.graph) {
+            CompNode::UnorderedMap<size_t> static_mem;
+            for (auto&& i : env.load_ret.output_var_list) {
+                auto cn = i.node()->comp_node();
+                static_mem[cn] = graph->get_device_memory_size(cn);
+            }
+            env.report->set_static_mem(static_mem);
+        }
+        env.report->write(env.model_path, env.report_output);
+    }
+    if (env.memory_timeline) {
+        auto&& prefix = env.memory_timeline_output;
+        env.memory_timeline->to_json()->writeto_fpath(prefix + ".json");
+        debug::write_to_file(
+                (prefix + ".svg").c_str(), env.memory_timeline->to_svg());
+        mgb_log("memory timeline written to %s.json and %s.svg", prefix.c_str(),
+                prefix.c_str());
+    }
 #endif
 #if MGB_ENABLE_FASTRUN
     if (!env.fast_run_cache_path.empty()) {
         static_cast<InFilePersistentCache&>(PersistentCache::inst())
-                .dump_cache(env.fast_run_cache_path.c_str());
+                .merge_and_dump_cache(env.fast_run_cache_path.c_str());
     }
 #endif
 #if MGB_ENABLE_TENSOR_RT
@@ -1100,9 +1649,214 @@ void run_test_st(Args &env) {
     }
 }
 
+#if MGB_HAVE_THREAD
+//! the cpu time of the process in milliseconds, or a negative value if it is
+//! not avaliable
+double process_cpu_time_ms() {
+#if __linux__ || __unix__ || __APPLE__
+    rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) {
+        auto to_ms = [](const timeval& tv) {
+            return tv.tv_sec * 1e3 + tv.tv_usec * 1e-3;
+        };
+        return to_ms(usage.ru_utime) + to_ms(usage.ru_stime);
+    }
+#endif
+    return -1;
+}
+
+/*!
+ * \brief run env.throughput_clients instances of the model, each in a thread
+ * of its own, for env.throughput_duration seconds and report the QPS and the
+ * latency distribution of all the requests
+ *
+ * All the instances are loaded and warmed up before they start together. With
+ * --share-param-mem the instances load from one copy of the model, so their
+ * params share the same memory.
+ */
+void run_throughput(int argc, char** argv, const Args& main_env) {
+    std::shared_ptr<void> model_buf;
+    size_t model_size = 0;
+    if (main_env.share_param_mem) {
+        FILE* fin = fopen(main_env.model_path.c_str(), "rb");
+        mgb_assert(fin, "failed to open %s: %s", main_env.model_path.c_str(),
+                   strerror(errno));
+        model_size = get_file_size(fin);
+        model_buf = {malloc(model_size), free};
+        auto nr = fread(model_buf.get(), 1, model_size, fin);
+        mgb_assert(nr == model_size);
+        fclose(fin);
+    }
+
+    struct Client {
+        Args env;
+        std::unique_ptr<cg::AsyncExecutable> func;
+        std::vector<double> latency_ms;
+    };
+    int nr_clients = main_env.throughput_clients;
+    std::vector<Client> clients(nr_clients);
+    RealTimer timer;
+    for (auto&& client : clients) {
+        auto&& env = client.env;
+        env = Args::from_argv(argc, argv);
+        std::unique_ptr<serialization::InputFile> inp_file;
+        if (model_buf) {
+            inp_file = serialization::InputFile::make_mem_proxy(
+                    model_buf, model_size);
+        } else if (env.mmap_model) {
+            inp_file = serialization::InputFile::make_mmap(env.model_path.c_str());
+        } else {
+            inp_file = serialization::InputFile::make_fs(env.model_path.c_str());
+        }
+        auto nr_test = read_nr_test(*inp_file);
+        auto format =
+                serialization::GraphLoader::identify_graph_dump_format(*inp_file);
+        mgb_assert(format.valid(),
+                   "invalid model: unknown model format, please make sure input "
+                   "file is generated by GraphDumper");
+        auto loader = serialization::GraphLoader::make(std::move(inp_file),
+                                                       format.val());
+        env.load_ret = loader->load(env.load_config, false);
+        apply_algo_policy(env);
+
+        // the inputs are the first testcase, or the given data files
+        auto& tensor_map = env.load_ret.tensor_map;
+        if (nr_test) {
+            loader = serialization::GraphLoader::make(loader->reset_file(),
+                                                      loader->format());
+            auto testcase = loader->load(env.load_config, false);
+            std::vector<std::pair<std::string, HostTensorND*>> inp_tensors;
+            for (auto&& i : tensor_map) {
+                inp_tensors.emplace_back(i.first, i.second.get());
+            }
+            std::sort(inp_tensors.begin(), inp_tensors.end());
+            mgb_assert(testcase.output_var_list.size() == inp_tensors.size());
+            for (size_t i = 0; i < inp_tensors.size(); ++i) {
+                auto&& opr = testcase.output_var_list[i]
+                                     .node()
+                                     ->owner_opr()
+                                     ->cast_final_safe<opr::SharedDeviceTensor>();
+                inp_tensors[i].second->copy_from(
+                        HostTensorND::make_proxy(*opr.dev_data()));
+            }
+        } else if (!env.data_files.empty()) {
+            DataParser parser;
+            for (auto&& path : env.data_files) {
+                parser.feed(path);
+            }
+            for (auto&& i : parser.inputs) {
+                auto iter = tensor_map.find(i.first);
+                mgb_assert(iter != tensor_map.end() || parser.inputs.size() == 1,
+                           "input %s is not in the model", i.first.c_str());
+                if (iter == tensor_map.end()) {
+                    iter = tensor_map.begin();
+                }
+                iter->second->copy_from(i.second);
+            }
+        } else {
+            mgb_assert(tensor_map.empty(),
+                       "model should not require input values when no input "
+                       "is given");
+        }
+        env.load_config.comp_graph.reset();
+
+        ComputingGraph::OutputSpec out_spec;
+        for (auto&& i : env.load_ret.output_var_list) {
+            ComputingGraph::Callback cb;
+            if (env.copy_to_host) {
+                HostTensorND val;
+                cb = [val](const DeviceTensorND& dv) mutable { val.copy_from(dv); };
+            }
+            out_spec.emplace_back(i, std::move(cb));
+        }
+        client.func = env.load_ret.graph_compile(out_spec);
+        for (int run = 0; run < env.nr_warmup; ++run) {
+            client.func->execute().wait();
+        }
+    }
+    printf("=== %d clients loaded and warmed up: %.3fms; going to run for "
+           "%.1fs\n",
+           nr_clients, timer.get_msecs_reset(), main_env.throughput_duration);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool started = false;
+    RealTimer run_timer;
+    double deadline_ms = main_env.throughput_duration * 1e3;
+    auto run = [&](Client& client) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]() { return started; });
+        }
+        for (;;) {
+            auto start = run_timer.get_msecs();
+            if (start >= deadline_ms) {
+                break;
+            }
+            client.func->execute().wait();
+            client.latency_ms.push_back(run_timer.get_msecs() - start);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (auto&& client : clients) {
+        threads.emplace_back(run, std::ref(client));
+    }
+    double cpu_start = process_cpu_time_ms();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        started = true;
+        run_timer.reset();
+    }
+    cv.notify_all();
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    double elapsed_ms = run_timer.get_msecs();
+    double cpu_ms = process_cpu_time_ms() - cpu_start;
+
+    std::vector<double> latency_ms;
+    for (auto&& client : clients) {
+        latency_ms.insert(latency_ms.end(), client.latency_ms.begin(),
+                          client.latency_ms.end());
+    }
+    mgb_assert(!latency_ms.empty(), "no request finished in %.1fs",
+               main_env.throughput_duration);
+    std::sort(latency_ms.begin(), latency_ms.end());
+    auto percentile = [&](double q) {
+        size_t idx = static_cast<size_t>(q * latency_ms.size());
+        return latency_ms[std::min(idx, latency_ms.size() - 1)];
+    };
+    printf("=== finished throughput test: clients=%d requests=%zu time=%.3fms "
+           "qps=%.3f\n",
+           nr_clients, latency_ms.size(), elapsed_ms,
+           latency_ms.size() * 1e3 / elapsed_ms);
+    printf("latency: avg=%.3fms p50=%.3fms p90=%.3fms p99=%.3fms p999=%.3fms "
+           "minmax=%.3f,%.3f\n",
+           std::accumulate(latency_ms.begin(), latency_ms.end(), 0.0) /
+                   latency_ms.size(),
+           percentile(0.5), percentile(0.9), percentile(0.99),
+           percentile(0.999), latency_ms.front(), latency_ms.back());
+    if (cpu_ms >= 0) {
+        // the utilization is in the unit of one core
+        printf("cpu utilization: %.1f%% (%d cores)\n", cpu_ms / elapsed_ms * 100,
+               sys::get_cpu_count());
+    }
+
+#if MGB_ENABLE_FASTRUN
+    if (!main_env.fast_run_cache_path.empty()) {
+        static_cast<InFilePersistentCache&>(PersistentCache::inst())
+                .merge_and_dump_cache(main_env.fast_run_cache_path.c_str());
+    }
+#endif
+}
+#endif
+
 }  // anonymous namespace
 
 int mgb_load_and_run_main(int argc, char** argv) {
+    if (argc >= 2 && !strcmp(argv[1], MGB_FASTRUN_CACHE_GEN_CMD)) {
+        return mgb_fastrun_cache_gen_main(argc - 1, argv + 1);
+    }
     {
         auto v0 = get_version();
         auto v1 = megdnn::get_version();
@@ -1127,7 +1881,14 @@ int mgb_load_and_run_main(int argc, char** argv) {
         return env.args_parse_ret;
     }
 
-    if (env.nr_thread == 1) {
+    if (env.throughput_clients) {
+#if MGB_HAVE_THREAD
+        run_throughput(argc, argv, env);
+#else
+        mgb_log_error("--throughput requested, but load-and-run was compiled "
+                      "without thread support.");
+#endif
+    } else if (env.nr_thread == 1) {
         run_test_st(env);
     } else {
 #if MGB_HAVE_THREAD
@@ -1218,13 +1979,30 @@ Args Args::from_argv(int argc, char **argv) {
             size_t nr_threads = 0;
             std::vector<int> core_ids;
             mgb_log_warn("multi thread core ids: %s", core_id_string.c_str());
-            while(getline(input_stringstream, id, ',')) {
-                nr_threads++;
-                core_ids.push_back(atoi(id.c_str()));
-            }
             mgb_assert(ret.multithread_number > 0 &&
                                ret.load_config.comp_node_mapper,
                        "the core id should set behind the --multithread param");
+            if (core_id_string == "auto") {
+                for (auto&& cls : mgb::sys::get_cpu_core_classes()) {
+                    core_ids.insert(core_ids.end(), cls.begin(), cls.end());
+                }
+                if (core_ids.size() >
+                    static_cast<size_t>(ret.multithread_number)) {
+                    core_ids.resize(ret.multithread_number);
+                }
+                //! the main thread is the last one
+                std::reverse(core_ids.begin(), core_ids.end());
+                std::string selected;
+                for (auto i : core_ids) {
+                    selected += ssprintf(" %d", i);
+                }
+                mgb_log_warn("auto selected core ids:%s", selected.c_str());
+            } else {
+                while (getline(input_stringstream, id, ',')) {
+                    nr_threads++;
+                    core_ids.push_back(atoi(id.c_str()));
+                }
+            }
             mgb_assert(static_cast<size_t>(ret.multithread_number) ==
                                core_ids.size(),
                        "the core id should equal to the multi thread number");
@@ -1239,6 +2017,43 @@ Args Args::from_argv(int argc, char **argv) {
             CompNodeEnv::from_comp_node(cn).cpu_env().set_affinity(affinity_cb);
             continue;
         }
+        if (!strcmp(argv[i], "--cpu-huge-page")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --cpu-huge-page");
+            std::string page = argv[i];
+            mgb_assert(page == "2M" || page == "1G",
+                       "--cpu-huge-page should be 2M or 1G, got %s", argv[i]);
+            CompNode::set_cpu_huge_page_size(page == "2M" ? 2 << 20 : 1 << 30);
+            continue;
+        }
+        if (!strcmp(argv[i], "--cpu-numa")) {
+            mgb_log_warn("enable numa binding for cpu comp nodes");
+            CompNode::enable_numa_for_cpu(true);
+            continue;
+        }
+        if (!strcmp(argv[i], "--multi-thread-wait-policy")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --multi-thread-wait-policy");
+            std::string policy = argv[i];
+            auto sep = policy.find(':');
+            size_t nr_spin = std::stoull(policy.substr(0, sep));
+            size_t nr_yield = sep == std::string::npos
+                                    ? std::numeric_limits<size_t>::max()
+                                    : std::stoull(policy.substr(sep + 1));
+            mgb_log_warn("multi thread wait policy: spin %zu yield %zu", nr_spin,
+                         nr_yield);
+            mgb_assert(ret.multithread_number > 0 &&
+                               ret.load_config.comp_node_mapper,
+                       "the wait policy should set behind the --multithread param");
+            CompNode::Locator loc;
+            ret.load_config.comp_node_mapper(loc);
+            mgb_assert(loc.type == CompNode::DeviceType::MULTITHREAD,
+                       "wait policy only set on multithread compnode");
+            auto cn = CompNode::load(loc);
+            CompNodeEnv::from_comp_node(cn).cpu_env().set_wait_policy(nr_spin,
+                                                                      nr_yield);
+            continue;
+        }
 #if MGB_ENABLE_TENSOR_RT
         if (!strcmp(argv[i], "--tensorrt")) {
             mgb_log_warn("use tensorrt mode");
@@ -1283,6 +2098,41 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.graph_opt.enable_fuse_preprocess();
             continue;
         }
+        if (!strcmp(argv[i], "--enable-fuse-horizontal")) {
+            mgb_log_warn("enable-fuse-horizontal optimization");
+            graph_opt.graph_opt.enable_fuse_horizontal();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-block-sparse-weight")) {
+            mgb_log_warn("enable-block-sparse-weight optimization");
+            graph_opt.graph_opt.enable_block_sparse_weight();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-weight-only-quant-int8")) {
+            mgb_log_warn("enable-weight-only-quant-int8 optimization");
+            graph_opt.graph_opt.enable_weight_only_quant_int8();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-weight-only-quant-int4")) {
+            mgb_log_warn("enable-weight-only-quant-int4 optimization");
+            graph_opt.graph_opt.enable_weight_only_quant_int4();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-fuse-multi-output-elemwise")) {
+            mgb_log_warn("enable fuse-multi-output-elemwise optimization");
+            graph_opt.graph_opt.enable_fuse_multi_output_elemwise();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-spatial-tiling")) {
+            mgb_log_warn("enable spatial-tiling optimization");
+            graph_opt.graph_opt.enable_spatial_tiling();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-padding-channel")) {
+            mgb_log_warn("enable padding-channel optimization");
+            graph_opt.graph_opt.enable_padding_channel();
+            continue;
+        }
         if (!strcmp(argv[i], "--enable-fuse-conv-bias-nonlinearity")) {
             mgb_log_warn("enable fuse-conv-bias-nonlinearity optimization");
             graph_opt.graph_opt.enable_fuse_conv_bias_nonlinearity();
@@ -1303,11 +2153,73 @@ Args Args::from_argv(int argc, char **argv) {
             }
             ++i;
             mgb_assert(i < argc, "output file not given for --profile");
-            ret.profiler = std::make_unique<GraphProfiler>(
-                    ret.load_config.comp_graph.get());
+            if (!ret.profiler) {
+                ret.profiler = std::make_unique<GraphProfiler>(
+                        ret.load_config.comp_graph.get());
+            }
             ret.profiler_output = argv[i];
             continue;
         }
+        if (!strcmp(argv[i], "--profile-hw-counter")) {
+            mgb_assert(
+                    ret.profiler,
+                    "--profile-hw-counter should be set behind --profile");
+            ret.profiler->enable_hw_counter();
+            continue;
+        }
+        if (!strcmp(argv[i], "--memory-timeline")) {
+            ++i;
+            mgb_assert(i < argc, "output prefix not given for --memory-timeline");
+            ret.memory_timeline = std::make_unique<MemoryTimeline>(
+                    ret.load_config.comp_graph.get());
+            ret.memory_timeline_output = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--report")) {
+            ++i;
+            mgb_assert(i < argc, "output file not given for --report");
+            ret.report = std::make_unique<RunReport>();
+            ret.report_output = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--startup-profile")) {
+            ++i;
+            mgb_assert(i < argc, "output file not given for --startup-profile");
+            ret.startup_profiler = std::make_unique<StartupProfiler>(
+                    ret.load_config.comp_graph.get());
+            ret.startup_profiler_output = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--profile-trace")) {
+            ++i;
+            mgb_assert(i < argc, "output file not given for --profile-trace");
+            if (!ret.profiler) {
+                ret.profiler = std::make_unique<GraphProfiler>(
+                        ret.load_config.comp_graph.get());
+            }
+            ret.trace_output = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--roofline")) {
+            ++i;
+            mgb_assert(i < argc, "output file not given for --roofline");
+            if (!ret.profiler) {
+                ret.profiler = std::make_unique<GraphProfiler>(
+                        ret.load_config.comp_graph.get());
+            }
+            ret.roofline_output = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--roofline-spec")) {
+            ++i;
+            mgb_assert(i < argc, "spec file not given for --roofline-spec");
+            std::ifstream fin{argv[i]};
+            mgb_assert(fin.good(), "failed to open %s", argv[i]);
+            std::stringstream content;
+            content << fin.rdbuf();
+            ret.roofline_spec = GraphProfiler::parse_device_spec(content.str());
+            continue;
+        }
 #endif
         if (!strcmp(argv[i], "--input")) {
             ++i;
@@ -1370,6 +2282,15 @@ Args Args::from_argv(int argc, char **argv) {
                     ret.load_config.comp_graph.get(), argv[i]);
             continue;
         }
+        if (!strcmp(argv[i], "--bin-io-dump-async")) {
+            mgb_log_warn("enable async opr binary io dump");
+            ++ i;
+            mgb_assert(i < argc,
+                    "output file not given for --bin-io-dump-async");
+            ret.iodump = std::make_unique<AsyncBinaryOprIODump>(
+                    ret.load_config.comp_graph.get(), argv[i]);
+            continue;
+        }
         if (!strcmp(argv[i], "--bin-out-dump")) {
             ++ i;
             mgb_assert(i < argc,
@@ -1400,6 +2321,15 @@ Args Args::from_argv(int argc, char **argv) {
                     ret.load_config.comp_graph.get(), range);
             continue;
         }
+        if (!strcmp(argv[i], "--check-non-finite")) {
+            ++i;
+            mgb_assert(i < argc, "interval not given for --check-non-finite");
+            auto interval = std::atoi(argv[i]);
+            mgb_assert(interval > 0);
+            ret.non_finite_checker = std::make_unique<NonFiniteChecker>(
+                    ret.load_config.comp_graph.get(), interval);
+            continue;
+        }
         if (!strcmp(argv[i], "--check-dispatch")) {
             ret.cpu_dispatch_checker =
                 std::make_unique<CPUDispatchChecker>(
@@ -1411,6 +2341,19 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.seq_opt.enable_mem_plan_opt = false;
             continue;
         }
+        if (!strcmp(argv[i], "--cpu-opr-parallel")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --cpu-opr-parallel");
+            graph_opt.seq_opt.cpu_opr_parallel_streams = std::stoul(argv[i]);
+            continue;
+        }
+        if (!strcmp(argv[i], "--mem-aware-opr-order")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --mem-aware-opr-order");
+            graph_opt.seq_opt.enable_mem_aware_opr_order = true;
+            graph_opt.seq_opt.mem_aware_opr_order_window = std::stoul(argv[i]);
+            continue;
+        }
         if (!strcmp(argv[i], "--copy-to-host")) {
             ret.copy_to_host = true;
             continue;
@@ -1448,6 +2391,12 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.comp_node_seq_record_level = 1;
             continue;
         }
+        if (!strcmp(argv[i], "--record-comp-seq-cache")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --record-comp-seq-cache");
+            graph_opt.comp_node_seq_record_cache_size = std::stoul(argv[i]);
+            continue;
+        }
         if (!strcmp(argv[i], "--record-comp-seq2")) {
             graph_opt.comp_node_seq_record_level = 2;
             continue;
@@ -1488,21 +2437,28 @@ Args Args::from_argv(int argc, char **argv) {
         }
         if (!strcmp(argv[i], "--binary-equal-between-batch")) {
             graph_opt.fast_run_config.binary_equal_between_batch = true;
+            graph_opt.deterministic_accumulation = true;
             ret.reproducible = true;
             continue;
         }
         if (!strcmp(argv[i], "--reproducible")) {
+            graph_opt.deterministic_accumulation = true;
             ret.reproducible = true;
             continue;
         }
         if (!strcmp(argv[i], "--const-shape")) {
             ret.load_config.const_var_shape = true;
+            graph_opt.graph_opt.enable_fold_const_shape();
             continue;
         }
         if (!strcmp(argv[i], "--share-param-mem")) {
             ret.share_param_mem = true;
             continue;
         }
+        if (!strcmp(argv[i], "--mmap-model")) {
+            ret.mmap_model = true;
+            continue;
+        }
         if (!strcmp(argv[i], "--disable-assert-throw")) {
             ret.disable_assert_throw = true;
             continue;
@@ -1572,6 +2528,26 @@ Args Args::from_argv(int argc, char **argv) {
             ret.nr_thread = std::stoi(argv[i]);
             continue;
         }
+        if (!strcmp(argv[i], "--shape-sweep")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --shape-sweep");
+            ret.shape_sweep = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--throughput")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --throughput");
+            ret.throughput_clients = std::stoi(argv[i]);
+            mgb_assert(ret.throughput_clients > 0);
+            continue;
+        }
+        if (!strcmp(argv[i], "--throughput-duration")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --throughput-duration");
+            ret.throughput_duration = std::stod(argv[i]);
+            mgb_assert(ret.throughput_duration > 0);
+            continue;
+        }
         if (!strcmp(argv[i], "--enable-jit")) {
             graph_opt.graph_opt.jit = 1;
             continue;
@@ -1581,6 +2557,10 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.graph_opt.enable_weight_preprocess();
             continue;
         }
+        if (!strcmp(argv[i], "--weight-preprocess-cache")) {
+            graph_opt.graph_opt.enable_weight_preprocess_cache();
+            continue;
+        }
         if (!strcmp(argv[i], "--layout-transform")) {
             ret.layout_transform = true;
             ++i;
@@ -1610,6 +2590,11 @@ Args Args::from_argv(int argc, char **argv) {
             continue;
         }
 
+        if (!strcmp(argv[i], "--layout-transform-cost-model")) {
+            ret.layout_transform_cost_model = true;
+            continue;
+        }
+
         if (!strcmp(argv[i], "--layout-transform-dump")) {
             ++i;
             mgb_assert(i < argc,
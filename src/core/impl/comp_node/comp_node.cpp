@@ -66,6 +66,8 @@ std::string get_stream_str(int stream) {
             return "REMOTE_SEND";
         case S::LOOP_SWAP:
             return "LOOP_SWAP";
+        case S::PROFILE:
+            return "PROFILE";
         default:
             return std::to_string(stream);
     }
@@ -647,6 +649,20 @@ std::unique_ptr<CompNodeSeqRecorder> CompNode::ImplBase::create_seq_recorder(
     return {};
 }
 
+void CompNode::ImplBase::batched_copy_to_host(
+        const CopySegment* segs, size_t nr_seg) {
+    for (size_t i = 0; i < nr_seg; ++i) {
+        copy_to_host(segs[i].dest, segs[i].src, segs[i].size);
+    }
+}
+
+void CompNode::ImplBase::batched_copy_to_device(
+        const CopySegment* segs, size_t nr_seg) {
+    for (size_t i = 0; i < nr_seg; ++i) {
+        copy_to_device(segs[i].dest, segs[i].src, segs[i].size);
+    }
+}
+
 size_t CompNode::ImplBase::get_mem_padding() {
     return 0;
 }
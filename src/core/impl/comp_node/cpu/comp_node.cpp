@@ -12,6 +12,7 @@
 #include "./comp_node.h"
 
 #include "megbrain/common.h"
+#include "megbrain/comp_node/alloc.h"
 #include "megbrain/comp_node_env.h"
 #include "megbrain/system.h"
 #include "megbrain/utils/arith_helper.h"
@@ -33,6 +34,12 @@ using namespace mgb;
 
 namespace {
 bool enable_affinity = false;
+bool enable_numa = false;
+//! number of threads of the thread pool shared by all the multithread comp
+//! nodes, 0 if not enabled
+size_t shared_pool_nr_threads = 0;
+//! size of the huge pages backing large allocations, 0 if not enabled
+size_t cpu_huge_page_size = 0;
 using Task = CompNodeEnv::CpuEnv::Task;
 using MultiThreadingTask = megcore::CPUDispatcher::MultiThreadingTask;
 
@@ -42,6 +49,96 @@ struct TaskElem {
     //! number of the parallelism
     size_t nr_parallelism;
 };
+
+//! NUMA node bound to given comp node, or -1 if not bound
+int get_numa_node(const CompNode::Locator& locator) {
+    if (!enable_numa || locator.device < 0) {
+        return -1;
+    }
+    return locator.device % sys::get_numa_node_count();
+}
+
+/*!
+ * \brief maps the large allocations of CPU comp nodes on huge pages if
+ *      enabled by CompNode::set_cpu_huge_page_size()
+ */
+class HugePageAllocator {
+    std::mutex m_mtx;
+    std::atomic_bool m_has_mapping{false};
+    ThinHashMap<void*, sys::HugePageMapping> m_mappings;
+    size_t m_nr_bytes_failed = 0;
+
+public:
+    //! allocations smaller than this are on the heap
+    static constexpr size_t MIN_SIZE = 1 << 20;
+    //! allocations smaller than this use 2MB pages when 1GB ones are enabled
+    static constexpr size_t MIN_SIZE_1GB = 512 << 20;
+
+    //! intentionally leaked, since memory may be freed during static
+    //! destruction
+    static HugePageAllocator& inst() {
+        static auto inst = new HugePageAllocator;
+        return *inst;
+    }
+
+    //! nullptr if not enabled or the size is small
+    void* alloc(size_t size) {
+        auto page_size = cpu_huge_page_size;
+        if (!page_size || size < MIN_SIZE) {
+            return nullptr;
+        }
+        if (size < MIN_SIZE_1GB) {
+            page_size = std::min<size_t>(page_size, 2 << 20);
+        }
+        auto mapping = sys::map_huge_pages(size, page_size);
+        MGB_LOCK_GUARD(m_mtx);
+        if (!mapping.ptr) {
+            m_nr_bytes_failed += size;
+            return nullptr;
+        }
+        m_mappings[mapping.ptr] = mapping;
+        m_has_mapping.store(true, std::memory_order_relaxed);
+        return mapping.ptr;
+    }
+
+    //! whether ptr is allocated by alloc() and has been released
+    bool free(void* ptr) {
+        if (!m_has_mapping.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        sys::HugePageMapping mapping;
+        {
+            MGB_LOCK_GUARD(m_mtx);
+            auto iter = m_mappings.find(ptr);
+            if (iter == m_mappings.end()) {
+                return false;
+            }
+            mapping = iter->second;
+            m_mappings.erase(iter);
+            m_has_mapping.store(!m_mappings.empty(), std::memory_order_relaxed);
+        }
+        sys::unmap_huge_pages(mapping);
+        return true;
+    }
+
+    CompNode::HugePageStats stats() {
+        CompNode::HugePageStats ret;
+        std::vector<std::pair<const void*, size_t>> ranges;
+        {
+            MGB_LOCK_GUARD(m_mtx);
+            for (auto&& i : m_mappings) {
+                ret.nr_bytes_mapped += i.second.size;
+                if (i.second.hugetlb) {
+                    ret.nr_bytes_hugetlb += i.second.size;
+                }
+                ranges.emplace_back(i.second.ptr, i.second.size);
+            }
+            ret.nr_bytes_failed = m_nr_bytes_failed;
+        }
+        ret.nr_bytes_huge = sys::get_huge_page_bytes(ranges);
+        return ret;
+    }
+};
 }  // anonymous namespace
 
 void CpuCompNode::CpuDispatchableBase::add_callback(Task&& task) {
@@ -54,7 +151,12 @@ class CpuCompNode::WorkerQueue final : public AsyncQueueSC<TaskElem, WorkerQueue
 
     void on_async_queue_worker_thread_start() override {
         mgb_assert(m_locator.device >= 0);
-        if (enable_affinity) {
+        auto numa_node = get_numa_node(m_locator);
+        if (numa_node >= 0) {
+#if !defined(ANDROID) && !defined(__ANDROID__)
+            sys::set_cpu_affinity(sys::get_numa_node_cpus(numa_node));
+#endif
+        } else if (enable_affinity) {
 #if !defined(ANDROID) && !defined(__ANDROID__)
             sys::set_cpu_affinity({m_locator.device});
 #endif
@@ -253,6 +355,8 @@ using CompNodeRecorderImpl = CpuCompNode::CompNodeRecorderImpl;
 class CpuCompNode::CompNodeBaseImpl : public CpuDispatchableBase {
 protected:
     Locator m_locator, m_locator_logical;
+    //! NUMA node the memory is bound to, -1 for not bound
+    const int m_numa_node;
 
 public:
     CompNodeBaseImpl(
@@ -260,12 +364,49 @@ public:
             free_func_t fh)
             : CpuDispatchableBase(fd, fh),
               m_locator(locator),
-              m_locator_logical(locator_logical) {}
+              m_locator_logical(locator_logical),
+              m_numa_node(get_numa_node(locator)) {}
 
     virtual ~CompNodeBaseImpl() {}
 
     void* mgb_aligned_alloc(size_t size) {
+        if (auto ptr = HugePageAllocator::inst().alloc(size)) {
+            if (m_numa_node >= 0) {
+                sys::bind_memory_to_numa_node(ptr, size, m_numa_node);
+            }
+            return ptr;
+        }
         auto alignment = get_mem_addr_alignment();
+        if (m_numa_node >= 0 && size >= NUMA_BIND_MIN_SIZE) {
+            //! page aligned, so that all the pages can be bound
+            alignment = std::max<size_t>(alignment, NUMA_BIND_MIN_SIZE);
+            auto ptr = mgb_aligned_alloc(size, alignment);
+            sys::bind_memory_to_numa_node(ptr, size, m_numa_node);
+            return ptr;
+        }
+        if (auto cache = mem_cache()) {
+            mgb_assert(alignment <= cache->alignment());
+            return cache->alloc(size);
+        }
+        return mgb_aligned_alloc(size, alignment);
+    }
+
+    /*!
+     * \brief thread caching front-end for memory allocation, which is
+     *      enabled by MGB_CPU_THREAD_CACHE_ALLOC and shared by comp nodes
+     *      not bound to NUMA nodes
+     * \return nullptr if disabled
+     */
+    mem_alloc::ThreadCachingAlloc* mem_cache() const {
+        return m_numa_node < 0 ? get_thread_caching_alloc() : nullptr;
+    }
+
+    static mem_alloc::ThreadCachingAlloc* get_thread_caching_alloc();
+
+    //! allocations smaller than this are not bound to NUMA node
+    static constexpr size_t NUMA_BIND_MIN_SIZE = 4096;
+
+    static void* mgb_aligned_alloc(size_t size, size_t alignment) {
 #ifdef WIN32
         return _aligned_malloc(size, alignment);
 #elif defined(__ANDROID__) || defined(ANDROID)
@@ -279,6 +420,9 @@ public:
     }
 
     static void mgb_aligned_free(void* ptr) {
+        if (HugePageAllocator::inst().free(ptr)) {
+            return;
+        }
 #ifdef WIN32
         _aligned_free(ptr);
 #else
@@ -286,6 +430,18 @@ public:
 #endif
     }
 
+    //! free memory allocated by mgb_aligned_alloc(size) with mem_cache()
+    static void mgb_aligned_free(mem_alloc::ThreadCachingAlloc* cache, void* ptr) {
+        if (HugePageAllocator::inst().free(ptr)) {
+            return;
+        }
+        if (cache) {
+            cache->free(ptr);
+        } else {
+            mgb_aligned_free(ptr);
+        }
+    }
+
     void* alloc_device(size_t size) override { return mgb_aligned_alloc(size); }
 
     void* alloc_host(size_t size) override { return mgb_aligned_alloc(size); }
@@ -311,6 +467,28 @@ public:
         dest_impl->copy_to_device(dest, src, size);
     }
 
+    void batched_copy_to_host(const CopySegment* segs, size_t nr_seg) override {
+        batched_copy(segs, nr_seg);
+    }
+
+    void batched_copy_to_device(const CopySegment* segs, size_t nr_seg) override {
+        batched_copy(segs, nr_seg);
+    }
+
+    //! copy all the segments in a single task
+    void batched_copy(const CopySegment* segs, size_t nr_seg) {
+        if (!nr_seg) {
+            return;
+        }
+        SmallVector<CopySegment> segs_copy(segs, segs + nr_seg);
+        auto do_copy = [segs_copy]() {
+            for (auto&& i : segs_copy) {
+                std::memcpy(i.dest, i.src, i.size);
+            }
+        };
+        m_env.cpu_env().dispatch(do_copy);
+    }
+
     size_t get_mem_addr_alignment() override { return m_env.property().mem_alignment; }
 
     void dispatch(Task&& task) override { m_env.cpu_env().dispatch(std::move(task)); }
@@ -338,6 +516,7 @@ public:
 //! implementation of CPUDispatcher that is passed to megdnn via megcore
 class CpuCompNode::WorkerQueue::DispatcherImpl final : public CPUDispatcher {
     std::atomic_size_t m_nr_task{0};
+    std::atomic<TaskPriority> m_priority{TaskPriority::NORMAL};
     std::shared_ptr<WorkerQueue> m_queue;
     //! DispatcherImpl only used by CompNodeRecorderImpl, but we still use
     //! CompNodeBaseImpl* because of incomplete type error
@@ -354,16 +533,17 @@ public:
         } else {
             m_nr_task.fetch_add(1, std::memory_order_relaxed);
             auto kern = [task](size_t, size_t) { task(); };
-            m_queue->add_task({kern, static_cast<size_t>(1_z)});
+            m_queue->add_task({kern, static_cast<size_t>(1_z), 0, priority()});
         }
     }
 
     void dispatch(MultiThreadingTask&& task, size_t parallelism) override {
         if (auto recorder = m_comp_node->cur_recorder()) {
-            recorder->dispatch({std::move(task), parallelism}, m_comp_node);
+            recorder->dispatch(
+                    {std::move(task), parallelism, 0, priority()}, m_comp_node);
         } else {
             m_nr_task.fetch_add(1, std::memory_order_relaxed);
-            m_queue->add_task({std::move(task), parallelism});
+            m_queue->add_task({std::move(task), parallelism, 0, priority()});
         }
     }
 
@@ -394,11 +574,24 @@ public:
             m_queue->add_task({affinity_run, 1_z});
         }
     }
+
+    void set_wait_policy(size_t nr_spin, size_t nr_yield) override {
+        if (auto thread_pool = m_queue->get_thread_pool()) {
+            thread_pool->set_wait_policy({nr_spin, nr_yield});
+        }
+    }
+
+    void set_priority(TaskPriority priority) override {
+        m_priority.store(priority, std::memory_order_relaxed);
+    }
+
+    TaskPriority priority() const { return m_priority.load(std::memory_order_relaxed); }
 };
 
 //! implementation of InplaceCPUDispatcher
 class InplaceCPUDispatcher final : public CPUDispatcher {
     std::atomic_size_t m_nr_task{0};
+    std::atomic<TaskPriority> m_priority{TaskPriority::NORMAL};
     std::shared_ptr<ThreadPool> m_thread_pool = nullptr;
     //! InplaceCPUDispatcher may used by both type of compnodes, so
     //! m_comp_node's type should be base class.
@@ -416,7 +609,7 @@ public:
         } else if (m_thread_pool) {
             m_nr_task.fetch_add(1, std::memory_order_relaxed);
             auto kern = [task](size_t, size_t) { task(); };
-            m_thread_pool->add_task({kern, static_cast<size_t>(1_z)});
+            m_thread_pool->add_task({kern, static_cast<size_t>(1_z), 0, priority()});
         } else {
             m_nr_task.fetch_add(1, std::memory_order_relaxed);
             task();
@@ -425,10 +618,11 @@ public:
 
     void dispatch(MultiThreadingTask&& task, size_t parallelism) override {
         if (auto recorder = m_comp_node->cur_recorder()) {
-            recorder->dispatch({std::move(task), parallelism}, m_comp_node);
+            recorder->dispatch(
+                    {std::move(task), parallelism, 0, priority()}, m_comp_node);
         } else if (m_thread_pool) {
             m_nr_task.fetch_add(1, std::memory_order_relaxed);
-            m_thread_pool->add_task({task, parallelism});
+            m_thread_pool->add_task({task, parallelism, 0, priority()});
         } else {
             m_nr_task.fetch_add(1, std::memory_order_relaxed);
             for (size_t i = 0; i < parallelism; i++) {
@@ -460,7 +654,60 @@ public:
             affinity_cb(0);
         }
     }
+
+    void set_wait_policy(size_t nr_spin, size_t nr_yield) override {
+        if (m_thread_pool) {
+            m_thread_pool->set_wait_policy({nr_spin, nr_yield});
+        }
+    }
+
+    void set_priority(TaskPriority priority) override {
+        m_priority.store(priority, std::memory_order_relaxed);
+    }
+
+    TaskPriority priority() const { return m_priority.load(std::memory_order_relaxed); }
+};
+
+namespace {
+class CpuAlignedRawAllocator final : public mem_alloc::RawAllocator {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    void* alloc(size_t size) override {
+        return CompNodeBaseImpl::mgb_aligned_alloc(size, ALIGNMENT);
+    }
+
+    void free(void* ptr) override { CompNodeBaseImpl::mgb_aligned_free(ptr); }
+
+    void get_mem_info(size_t& free, size_t& tot) override {
+        free = 0;
+        tot = 0;
+    }
 };
+}  // anonymous namespace
+
+mem_alloc::ThreadCachingAlloc* CompNodeBaseImpl::get_thread_caching_alloc() {
+    // intentionally leaked, since memory may be freed during static
+    // destruction
+    static mem_alloc::ThreadCachingAlloc* inst = []() {
+        mem_alloc::ThreadCachingAlloc* ret = nullptr;
+        if (MGB_GETENV("MGB_CPU_THREAD_CACHE_ALLOC")) {
+            mem_alloc::ThreadCachingAlloc::Config config;
+            config.alignment = CpuAlignedRawAllocator::ALIGNMENT;
+            if (auto setting = MGB_GETENV("MGB_CPU_THREAD_CACHE_LIMIT")) {
+                config.thread_cache_limit = std::stoull(setting);
+            }
+            ret = mem_alloc::ThreadCachingAlloc::make(
+                          std::make_unique<CpuAlignedRawAllocator>(), config)
+                          .release();
+            mgb_log_debug(
+                    "cpu: use thread caching allocator, thread_cache_limit=%zu",
+                    config.thread_cache_limit);
+        }
+        return ret;
+    }();
+    return inst;
+}
 
 //! ==================== CompNodeDefaultImpl ======================
 /**
@@ -518,18 +765,21 @@ public:
     }
 
     void free_device(void* ptr) {
+        auto cache = mem_cache();
         if (check_global_finalized("free_device()")) {
-            CompNodeBaseImpl::mgb_aligned_free(ptr);
+            CompNodeBaseImpl::mgb_aligned_free(cache, ptr);
             return;
         } else {
-            auto do_free = [ptr]() { CompNodeBaseImpl::mgb_aligned_free(ptr); };
+            auto do_free = [cache, ptr]() {
+                CompNodeBaseImpl::mgb_aligned_free(cache, ptr);
+            };
             m_env.cpu_env().dispatch(do_free);
         }
     }
 
     void free_host(void* ptr) {
         check_global_finalized("free_host()");
-        return CompNodeBaseImpl::mgb_aligned_free(ptr);
+        return CompNodeBaseImpl::mgb_aligned_free(mem_cache(), ptr);
     }
 
     std::unique_ptr<Event> create_event(size_t flags) override {
@@ -612,18 +862,27 @@ public:
         static_cast<CompNodeRecorderImpl*>(self)->free_host(ptr);
     }
 
+    //! \param thread_pool shared thread pool for multithread comp node; a
+    //!     private one would be created if it is null
     CompNodeRecorderImpl(
             const Locator& locator, const Locator& locator_logical,
-            const std::shared_ptr<WorkerQueue>& worker_queue)
+            const std::shared_ptr<WorkerQueue>& worker_queue,
+            const std::shared_ptr<ThreadPool>& thread_pool = {})
             : CompNodeBaseImpl(
                       locator, locator_logical, static_free_device, static_free_host),
+              m_thread_pool(thread_pool),
               m_worker_queue(worker_queue) {
         auto cn = make_comp_node_from_impl(this);
-        if (locator.type == DeviceType::MULTITHREAD) {
+        if (locator.type == DeviceType::MULTITHREAD && !m_thread_pool) {
             m_thread_pool = std::shared_ptr<ThreadPool>(
                     new ThreadPool(static_cast<size_t>(locator.nr_threads)));
             mgb_assert(m_thread_pool, "ThradPool create failed");
         }
+        if (m_thread_pool && m_numa_node >= 0) {
+            auto cpus = sys::get_numa_node_cpus(m_numa_node);
+            m_thread_pool->set_affinity(
+                    [cpus](size_t) { sys::set_cpu_affinity(cpus); });
+        }
         if (locator.type == DeviceType::CPU) {
             if (locator.device == Locator::DEVICE_CPU_DEFAULT) {
                 m_env.init_cpu({std::make_shared<InplaceCPUDispatcher>(this)}, cn);
@@ -689,14 +948,17 @@ public:
     }
 
     void free_device(void* ptr) {
+        auto cache = mem_cache();
         if (sm_cur_recorder || check_global_finalized("free_device()")) {
-            CompNodeBaseImpl::mgb_aligned_free(ptr);
+            CompNodeBaseImpl::mgb_aligned_free(cache, ptr);
             if (sm_cur_recorder) {
                 sm_cur_recorder->on_free(this);
             }
             return;
         } else {
-            auto do_free = [ptr]() { CompNodeBaseImpl::mgb_aligned_free(ptr); };
+            auto do_free = [cache, ptr]() {
+                CompNodeBaseImpl::mgb_aligned_free(cache, ptr);
+            };
             m_env.cpu_env().dispatch(do_free);
         }
     }
@@ -710,13 +972,13 @@ public:
 
     void free_host(void* ptr) {
         if (check_global_finalized("free_host()")) {
-            CompNodeBaseImpl::mgb_aligned_free(ptr);
+            CompNodeBaseImpl::mgb_aligned_free(mem_cache(), ptr);
             return;
         }
         if (m_worker_queue) {
             m_worker_queue->check_exception();
         }
-        CompNodeBaseImpl::mgb_aligned_free(ptr);
+        CompNodeBaseImpl::mgb_aligned_free(mem_cache(), ptr);
     }
 
     void copy_to_host(void* host_ptr, const void* device_ptr, size_t size) override {
@@ -733,6 +995,20 @@ public:
         CompNodeBaseImpl::copy_to_device(device_ptr, host_ptr, size);
     }
 
+    void batched_copy_to_host(const CopySegment* segs, size_t nr_seg) override {
+        if (m_worker_queue) {
+            m_worker_queue->check_exception();
+        }
+        CompNodeBaseImpl::batched_copy_to_host(segs, nr_seg);
+    }
+
+    void batched_copy_to_device(const CopySegment* segs, size_t nr_seg) override {
+        if (m_worker_queue) {
+            m_worker_queue->check_exception();
+        }
+        CompNodeBaseImpl::batched_copy_to_device(segs, nr_seg);
+    }
+
     void peer_copy_to(
             Impl* dest_impl, void* dest, const void* src, size_t size) override {
         //! copy to default_cpu
@@ -844,6 +1120,11 @@ struct CpuCompNode::Pool {
             locator2impl_multi_thread;
     ThinHashMap<std::pair<int, int>, std::weak_ptr<WorkerQueue>>
             physical2queue_multithead;
+    //! work-stealing thread pools shared by multithread comp nodes with the
+    //! same number of threads and NUMA node, so their oprs can run at the same
+    //! time
+    ThinHashMap<std::pair<int, int>, std::weak_ptr<ThreadPool>>
+            nr_threads2shared_pool;
 };
 CpuCompNode::Pool* CpuCompNode::sm_pool;
 Spinlock CpuCompNode::sm_pool_mtx;
@@ -945,8 +1226,27 @@ CpuCompNode::Impl* CpuCompNode::load_cpu(Locator locator, Locator locator_logica
                     sm_pool->nr_used_impl_storage < Pool::MAX_NR_COMP_NODE,
                     "too many cpu multithread comp nodes; max %d allowed",
                     Pool::MAX_NR_COMP_NODE);
+            std::shared_ptr<ThreadPool> thread_pool;
+            int nr_threads = locator.nr_threads;
+            if (shared_pool_nr_threads) {
+                nr_threads = static_cast<int>(shared_pool_nr_threads);
+            }
+            if (shared_pool_nr_threads ||
+                ThreadPool::default_mode() == ThreadPoolMode::WORK_STEALING) {
+                auto&& pool_weak = sm_pool->nr_threads2shared_pool[{
+                        nr_threads, get_numa_node(locator)}];
+                thread_pool = pool_weak.lock();
+                if (!thread_pool) {
+                    thread_pool = std::make_shared<ThreadPool>(
+                            static_cast<size_t>(nr_threads),
+                            ThreadPoolMode::WORK_STEALING);
+                    pool_weak = thread_pool;
+                }
+            }
             pimpl.reset(new (&sm_pool->impl_storage[sm_pool->nr_used_impl_storage++])
-                                CompNodeRecorderImpl{locator, locator_logical, pqueue});
+                                CompNodeRecorderImpl{
+                                        locator, locator_logical, pqueue,
+                                        thread_pool});
         }
         log_comp_node_created(locator, locator_logical);
         return pimpl.get();
@@ -971,6 +1271,12 @@ void CpuCompNode::sync_all() {
 // compute kernel
 // CompNode::load("cpu:default") is "inplace cpu" which is in the
 // CpuCompNode::Pool
+bool CompNode::enable_numa_for_cpu(bool flag) {
+    bool old = enable_numa;
+    enable_numa = flag;
+    return old;
+}
+
 CompNode CompNode::default_cpu() {
     static Locator locator{DeviceType::CPU, Locator::DEVICE_CPU_DEFAULT, {-1}};
     static CompNodeDefaultImpl impl{locator, locator};
@@ -983,6 +1289,29 @@ bool CompNode::enable_affinity_for_cpu(bool flag) {
     return old;
 }
 
+size_t CompNode::set_cpu_shared_thread_pool(size_t nr_threads) {
+    size_t old = shared_pool_nr_threads;
+    shared_pool_nr_threads = nr_threads;
+    return old;
+}
+
+size_t CompNode::set_cpu_huge_page_size(size_t page_size) {
+    mgb_assert(
+            !page_size || page_size == (2 << 20) || page_size == (1 << 30),
+            "huge page size should be 2MB or 1GB, got %zu", page_size);
+    size_t old = cpu_huge_page_size;
+    cpu_huge_page_size = page_size;
+    return old;
+}
+
+size_t CompNode::get_cpu_huge_page_size() {
+    return cpu_huge_page_size;
+}
+
+CompNode::HugePageStats CompNode::get_cpu_huge_page_stats() {
+    return HugePageAllocator::inst().stats();
+}
+
 /* ======================== EventImpl ========================  */
 double CpuCompNode::CpuDispatchableBase::EventImpl::do_elapsed_time_until(
         EventImplHelper& end) {
@@ -21,9 +21,12 @@ using namespace mgb;
 #if MGB_CUDA
 
 #include "megbrain/comp_node/alloc.h"
+#include "megbrain/utils/arith_helper.h"
 
 #include <cctype>
 #include <cstdio>
+#include <limits>
+#include <map>
 
 #include <thread>
 
@@ -54,6 +57,12 @@ void CUDART_CB cuda_host_func_caller(void* ud) {
     MGB_TRY { (*func_ptr)(); }
     MGB_FINALLY(delete func_ptr;);
 }
+//! host func caller for callbacks captured into cuda graphs, which may be
+//! invoked many times and are owned by the recorder
+void CUDART_CB cuda_graph_host_func_caller(void* ud) {
+    mgb_assert(ud);
+    (*reinterpret_cast<CudaHostFunc*>(ud))();
+}
 }  // anonymous namespace
 
 namespace mgb {
@@ -156,6 +165,309 @@ public:
 std::unique_ptr<DevMemAlloc> DevMemAlloc::make_cuda_alloc() {
     return std::make_unique<FwdDevMemAlloc>(std::make_shared<CudaRawAllocator>());
 }
+
+#if CUDART_VERSION >= 11030
+/* ===================== CudaAsyncDevMemAlloc  ===================== */
+/*!
+ * \brief device allocator on a cuda memory pool with stream-ordered
+ *      allocation; all the streams share one pool so freed memory can be
+ *      reused across streams following event dependencies
+ */
+class CudaAsyncDevMemAlloc final : public DevMemAlloc {
+    class StreamMemAllocImpl final : public StreamMemAlloc {
+        CudaAsyncDevMemAlloc* const m_par_alloc;
+        const cudaStream_t m_stream;
+
+        void* alloc(size_t size) override {
+            return m_par_alloc->alloc_on_stream(size, m_stream);
+        }
+
+        void free(void* addr) override {
+            MGB_CUDA_CHECK(cudaFreeAsync(addr, m_stream));
+        }
+
+        void get_mem_info(size_t& free, size_t& tot) override {
+            m_par_alloc->m_raw_alloc->get_mem_info(free, tot);
+        }
+
+        void print_memory_state() override { m_par_alloc->print_memory_state(); }
+
+        size_t get_used_memory() override { return m_par_alloc->get_used_memory(); }
+
+        FreeMemStat get_free_memory() override {
+            return m_par_alloc->get_free_memory();
+        }
+
+        FreeMemStat get_free_memory_dev() override {
+            return m_par_alloc->get_free_memory_dev();
+        }
+
+    public:
+        StreamMemAllocImpl(CudaAsyncDevMemAlloc* par_alloc, cudaStream_t stream)
+                : m_par_alloc{par_alloc}, m_stream{stream} {}
+    };
+
+    const int m_device;
+    cudaMemPool_t m_pool;
+    std::mutex m_mtx;
+    std::shared_ptr<RawAllocator> m_raw_alloc;
+    std::shared_ptr<DeviceRuntimePolicy> m_runtime_policy;
+    ThinHashMap<StreamKey, std::unique_ptr<StreamMemAllocImpl>> m_stream_alloc;
+
+    uint64_t get_pool_attr(cudaMemPoolAttr attr) {
+        uint64_t val = 0;
+        MGB_CUDA_CHECK(cudaMemPoolGetAttribute(m_pool, attr, &val));
+        return val;
+    }
+
+    void* alloc_on_stream(size_t size, cudaStream_t stream) {
+        // keep sub-allocations of the pool on aligned offsets
+        size = get_aligned_power2(size, alignment());
+        void* ptr;
+        auto err = cudaMallocFromPoolAsync(&ptr, size, m_pool, stream);
+        if (err == cudaErrorMemoryAllocation) {
+            // frees pending on other streams may release enough memory
+            cudaGetLastError();
+            m_runtime_policy->device_synchronize(m_device);
+            err = cudaMallocFromPoolAsync(&ptr, size, m_pool, stream);
+        }
+        if (err == cudaSuccess) {
+            return ptr;
+        }
+        cudaGetLastError();
+        print_memory_state();
+        auto msg = ssprintf(
+                "cudaMallocFromPoolAsync failed while requesting %zu bytes "
+                "(%.3fMiB) of memory; error: %s",
+                size, size / (1024.0 * 1024), cudaGetErrorString(err));
+        msg.append(CudaError::get_cuda_extra_info());
+        mgb_throw_raw(MemAllocError{msg});
+    }
+
+    void print_memory_state() override {
+        mgb_log("cuda async allocator stats on gpu%d: used=%zu reserved=%zu",
+                m_device, get_used_memory(),
+                static_cast<size_t>(get_pool_attr(cudaMemPoolAttrReservedMemCurrent)));
+    }
+
+    size_t get_used_memory() override {
+        return get_pool_attr(cudaMemPoolAttrUsedMemCurrent);
+    }
+
+    FreeMemStat get_free_memory() override {
+        size_t free = get_pool_attr(cudaMemPoolAttrReservedMemCurrent) -
+                      get_pool_attr(cudaMemPoolAttrUsedMemCurrent);
+        return {free, 0, free, free ? 1_z : 0_z};
+    }
+
+    FreeMemStat get_free_memory_dev() override {
+        size_t tot, free;
+        m_raw_alloc->get_mem_info(free, tot);
+        free += get_free_memory().tot;
+        return {free, 0, free, 1};
+    }
+
+    StreamMemAlloc* add_stream(StreamKey stream) override {
+        MGB_LOCK_GUARD(m_mtx);
+        auto&& v = m_stream_alloc[stream];
+        if (!v)
+            v = std::make_unique<StreamMemAllocImpl>(
+                    this, static_cast<cudaStream_t>(stream));
+        return v.get();
+    }
+
+    const std::shared_ptr<RawAllocator>& raw_allocator() const override {
+        return m_raw_alloc;
+    }
+
+    const std::shared_ptr<DeviceRuntimePolicy>& device_runtime_policy() const override {
+        return m_runtime_policy;
+    }
+
+    size_t gather_stream_free_blk_and_release_full() override {
+        m_runtime_policy->device_synchronize(m_device);
+        auto reserved = get_pool_attr(cudaMemPoolAttrReservedMemCurrent);
+        MGB_CUDA_CHECK(cudaMemPoolTrimTo(m_pool, 0));
+        return reserved - get_pool_attr(cudaMemPoolAttrReservedMemCurrent);
+    }
+
+public:
+    CudaAsyncDevMemAlloc(int device, size_t release_threshold)
+            : m_device{device},
+              m_raw_alloc{std::make_shared<CudaRawAllocator>()},
+              m_runtime_policy{std::make_shared<CudaDeviceRuntimePolicy>()} {
+        cudaMemPoolProps props = {};
+        props.allocType = cudaMemAllocationTypePinned;
+        props.location.type = cudaMemLocationTypeDevice;
+        props.location.id = device;
+        MGB_CUDA_CHECK(cudaMemPoolCreate(&m_pool, &props));
+        uint64_t threshold = release_threshold;
+        MGB_CUDA_CHECK(cudaMemPoolSetAttribute(
+                m_pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+        int enable = 1;
+        MGB_CUDA_CHECK(cudaMemPoolSetAttribute(
+                m_pool, cudaMemPoolReuseFollowEventDependencies, &enable));
+    }
+
+    ~CudaAsyncDevMemAlloc() {
+        // the pool would be released after outstanding allocations are freed
+        cudaMemPoolDestroy(m_pool);
+    }
+};
+
+std::unique_ptr<DevMemAlloc> DevMemAlloc::make_cuda_async_alloc(
+        int device, size_t release_threshold) {
+    int supported = 0;
+    MGB_CUDA_CHECK(cudaDeviceGetAttribute(
+            &supported, cudaDevAttrMemoryPoolsSupported, device));
+    if (!supported) {
+        return nullptr;
+    }
+    return std::make_unique<CudaAsyncDevMemAlloc>(device, release_threshold);
+}
+#else
+std::unique_ptr<DevMemAlloc> DevMemAlloc::make_cuda_async_alloc(int, size_t) {
+    return nullptr;
+}
+#endif
+
+#if CUDA_VERSION >= 10020
+/* ===================== CudaVmmRawAllocator  ===================== */
+/*!
+ * \brief raw allocator that maps physical memory into one reserved virtual
+ *      address range, so chunks allocated one after another are adjacent
+ *
+ * The physical memory of a chunk is unmapped and returned to the driver when
+ * the chunk is freed, and the hole is reused by later allocations.
+ */
+class CudaVmmRawAllocator final : public RawAllocator {
+    struct Chunk {
+        size_t size;
+        CUmemGenericAllocationHandle handle;
+    };
+
+    CUmemAllocationProp m_prop = {};
+    CUmemAccessDesc m_access = {};
+    size_t m_granularity = 0, m_va_size = 0;
+    CUdeviceptr m_va_base = 0;
+    std::mutex m_mtx;
+    //! mapped chunks, from offset in the reserved range to chunk info
+    std::map<size_t, Chunk> m_chunks;
+
+    //! lowest offset followed by at least \p size unmapped bytes
+    size_t find_hole_unsafe(size_t size) {
+        size_t begin = 0;
+        for (auto&& i : m_chunks) {
+            if (i.first - begin >= size)
+                break;
+            begin = i.first + i.second.size;
+        }
+        return begin;
+    }
+
+public:
+    explicit CudaVmmRawAllocator(int device) {
+        m_prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+        m_prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+        m_prop.location.id = device;
+        MGB_CUDA_CU_CHECK(cuMemGetAllocationGranularity(
+                &m_granularity, &m_prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+        m_access.location = m_prop.location;
+        m_access.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+
+        CUdevice dev;
+        size_t tot;
+        MGB_CUDA_CU_CHECK(cuDeviceGet(&dev, device));
+        MGB_CUDA_CU_CHECK(cuDeviceTotalMem(&tot, dev));
+        // address space is cheap; leave room for the holes of freed chunks
+        m_va_size = get_aligned_power2(tot * 2, m_granularity);
+        MGB_CUDA_CU_CHECK(cuMemAddressReserve(&m_va_base, m_va_size, 0, 0, 0));
+    }
+
+    ~CudaVmmRawAllocator() {
+        for (auto&& i : m_chunks) {
+            cuMemUnmap(m_va_base + i.first, i.second.size);
+            cuMemRelease(i.second.handle);
+        }
+        cuMemAddressFree(m_va_base, m_va_size);
+    }
+
+    size_t granularity() const { return m_granularity; }
+
+    void* alloc(size_t size) override {
+        size = get_aligned_power2(size, m_granularity);
+        MGB_LOCK_GUARD(m_mtx);
+        auto offset = find_hole_unsafe(size);
+        if (offset + size > m_va_size) {
+            mgb_log_error(
+                    "cuda vmm: address range of %zu bytes exhausted while "
+                    "requesting %zu bytes",
+                    m_va_size, size);
+            return nullptr;
+        }
+        CUmemGenericAllocationHandle handle;
+        auto err = cuMemCreate(&handle, size, &m_prop, 0);
+        if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+            mgb_log_error(
+                    "cuMemCreate failed while requesting %zu bytes (%.3fMiB) "
+                    "of memory",
+                    size, size / (1024.0 * 1024));
+            return nullptr;
+        }
+        MGB_CUDA_CU_CHECK(err);
+        auto ptr = m_va_base + offset;
+        MGB_CUDA_CU_CHECK(cuMemMap(ptr, size, 0, handle, 0));
+        MGB_CUDA_CU_CHECK(cuMemSetAccess(ptr, size, &m_access, 1));
+        m_chunks[offset] = {size, handle};
+        return reinterpret_cast<void*>(ptr);
+    }
+
+    void free(void* ptr) override {
+        MGB_LOCK_GUARD(m_mtx);
+        auto iter = m_chunks.find(reinterpret_cast<CUdeviceptr>(ptr) - m_va_base);
+        mgb_assert(iter != m_chunks.end(), "releasing bad pointer: %p", ptr);
+        MGB_CUDA_CU_CHECK(cuMemUnmap(m_va_base + iter->first, iter->second.size));
+        MGB_CUDA_CU_CHECK(cuMemRelease(iter->second.handle));
+        m_chunks.erase(iter);
+    }
+
+    void get_mem_info(size_t& free, size_t& tot) override {
+        MGB_CUDA_CHECK(cudaMemGetInfo(&free, &tot));
+    }
+
+    bool mergeable_chunks() const override { return true; }
+};
+
+std::unique_ptr<DevMemAlloc> DevMemAlloc::make_cuda_vmm_alloc(
+        int device, size_t reserve_size, const PreAllocConfig& prealloc) {
+    CUdevice dev;
+    int supported = 0;
+    MGB_CUDA_CU_CHECK(cuDeviceGet(&dev, device));
+    MGB_CUDA_CU_CHECK(cuDeviceGetAttribute(
+            &supported, CU_DEVICE_ATTRIBUTE_VIRTUAL_ADDRESS_MANAGEMENT_SUPPORTED,
+            dev));
+    if (!supported) {
+        return nullptr;
+    }
+    auto raw_alloc = std::make_shared<CudaVmmRawAllocator>(device);
+    auto granularity = raw_alloc->granularity();
+    // chunks must end on granularity boundaries to be adjacent to the next
+    // one; round down the reservation so it does not exceed free memory
+    reserve_size = reserve_size / granularity * granularity;
+    auto ret = make(
+            device, reserve_size, raw_alloc,
+            std::make_shared<CudaDeviceRuntimePolicy>());
+    auto conf = prealloc;
+    conf.alignment = std::max(conf.alignment, granularity);
+    ret->prealloc_config(conf);
+    return ret;
+}
+#else
+std::unique_ptr<DevMemAlloc> DevMemAlloc::make_cuda_vmm_alloc(
+        int, size_t, const PreAllocConfig&) {
+    return nullptr;
+}
+#endif
 }  // namespace mem_alloc
 }  // namespace mgb
 
@@ -164,6 +476,7 @@ class CudaCompNode::CompNodeImpl final : public CompNode::Impl {
     MGB_DYN_TYPE_OBJ_FINAL_DECL;
 
     friend class EventImpl;
+    friend class SeqRecorderImpl;
     friend class CudaCompNode;
 
     struct DeviceInfo;
@@ -184,6 +497,16 @@ class CudaCompNode::CompNodeImpl final : public CompNode::Impl {
     std::unique_ptr<Event> m_sync_event;
     Spinlock m_sync_event_mtx;
 
+    //! recorder that is currently capturing the stream of this comp node
+    SeqRecorderImpl* m_cur_recorder = nullptr;
+#if CUDART_VERSION >= 11010
+    //! graph exec released by the last destructed recorder, which would be
+    //! updated in place (rather than re-instantiated) by the next recorder if
+    //! their topologies match
+    cudaGraphExec_t m_retired_graph_exec = nullptr;
+    Spinlock m_retired_graph_exec_mtx;
+#endif
+
     void activate() { m_env.cuda_env().activate(); }
 
     void init(const Locator& locator, const Locator& locator_logical);
@@ -197,6 +520,10 @@ class CudaCompNode::CompNodeImpl final : public CompNode::Impl {
 
     static size_t get_compute_capability(int dev);
 
+    //! device memory can only be allocated or freed in fake exec while
+    //! capturing, since the addresses are baked into the cuda graph
+    inline void check_mem_op_during_capture(const char* op);
+
     static void static_free_device(ImplBase* self, void* ptr) {
         static_cast<CompNodeImpl*>(self)->free_device(ptr);
     }
@@ -210,6 +537,7 @@ public:
 
     void* alloc_device(size_t size) override {
         activate();
+        check_mem_op_during_capture("alloc");
 #if MGB_BUILD_SLIM_SERVING
         return m_mem_alloc->alloc(size);
 #else
@@ -246,6 +574,38 @@ public:
     void peer_copy_to(
             Impl* dest_impl, void* dest, const void* src, size_t size) override;
 
+    void batched_copy_to_host(const CopySegment* segs, size_t nr_seg) override {
+        batched_copy(segs, nr_seg, cudaMemcpyDeviceToHost);
+    }
+
+    void batched_copy_to_device(const CopySegment* segs, size_t nr_seg) override {
+        batched_copy(segs, nr_seg, cudaMemcpyHostToDevice);
+    }
+
+    //! merge the segments adjacent in both source and destination, so
+    //! buffers allocated from the same chunk take a single copy
+    void batched_copy(const CopySegment* segs, size_t nr_seg, cudaMemcpyKind kind) {
+        if (!nr_seg) {
+            return;
+        }
+        activate();
+        auto stream = m_env.cuda_env().stream;
+        auto dest = static_cast<dt_byte*>(segs[0].dest);
+        auto src = static_cast<const dt_byte*>(segs[0].src);
+        size_t size = segs[0].size;
+        for (size_t i = 1; i < nr_seg; ++i) {
+            if (segs[i].dest == dest + size && segs[i].src == src + size) {
+                size += segs[i].size;
+                continue;
+            }
+            MGB_CUDA_CHECK(cudaMemcpyAsync(dest, src, size, kind, stream));
+            dest = static_cast<dt_byte*>(segs[i].dest);
+            src = static_cast<const dt_byte*>(segs[i].src);
+            size = segs[i].size;
+        }
+        MGB_CUDA_CHECK(cudaMemcpyAsync(dest, src, size, kind, stream));
+    }
+
     size_t get_mem_addr_alignment() override { return m_env.property().mem_alignment; }
 
     std::unique_ptr<Event> create_event(size_t flags) override;
@@ -279,9 +639,16 @@ public:
 
     Locator locator_logical() override { return m_locator_logical; }
 
+    std::unique_ptr<CompNodeSeqRecorder> create_seq_recorder(
+            cg::ComputingGraph* cg) override;
+
     void add_callback(CudaHostFunc&& cb) override {
 #if CUDART_VERSION >= 10000
         activate();
+        if (m_cur_recorder) {
+            add_captured_callback(std::move(cb));
+            return;
+        }
         CudaHostFunc* func_ptr = new CudaHostFunc(std::move(cb));
         MGB_TRY {
             MGB_CUDA_CHECK(cudaLaunchHostFunc(
@@ -308,6 +675,10 @@ public:
 #endif
 
 private:
+    //! add a host callback that would be invoked on each replay of the
+    //! current recorder
+    void add_captured_callback(CudaHostFunc&& cb);
+
     uint64_t m_uid;
 #if !MGB_BUILD_SLIM_SERVING
     std::unordered_map<void*, size_t> ptr2size;
@@ -318,6 +689,8 @@ MGB_DYN_TYPE_OBJ_FINAL_IMPL(CudaCompNode::CompNodeImpl);
 
 struct CudaCompNodeImpl::DeviceInfo {
     int dev_num = -1;
+    //! whether mem_alloc is backed by a stream-ordered memory pool
+    bool async_alloc = false;
     std::unique_ptr<mem_alloc::DevMemAlloc> mem_alloc;
 
     bool init_done() const { return mem_alloc.get(); }
@@ -425,6 +798,12 @@ void CudaCompNodeImpl::fini() {
         return;
 
     m_sync_event.reset();
+#if CUDART_VERSION >= 11010
+    if (m_retired_graph_exec) {
+        cudaGraphExecDestroy(m_retired_graph_exec);
+        m_retired_graph_exec = nullptr;
+    }
+#endif
     m_env.fini();
     m_mem_alloc = nullptr;
     m_device_info = nullptr;
@@ -436,6 +815,7 @@ void CudaCompNodeImpl::free_device(void* ptr) {
         return;
 
     activate();
+    check_mem_op_during_capture("free");
 #if !MGB_BUILD_SLIM_SERVING
     {
         MGB_LOCK_GUARD(m_update_mem);
@@ -498,6 +878,12 @@ MemNode CudaCompNodeImpl::mem_node() {
 void CudaCompNodeImpl::sync() {
     activate();
 
+    if (m_cur_recorder) {
+        // nothing has been executed while capturing; the actual execution
+        // happens in replay(), which would be synchronized by the caller
+        return;
+    }
+
     // do not use MGB_CUDA_CHECK(cudaStreamSynchronize(m_env->stream)) since
     // other threads may be adding operations into the stream, and we only care
     // about previous operations in current thread. However docs of
@@ -573,11 +959,46 @@ void CudaCompNodeImpl::DeviceInfo::init(const CompNodeEnv& env) {
     auto&& cuenv = env.cuda_env();
     cuenv.activate();
     dev_num = cuenv.device;
+    if (MGB_GETENV("MGB_CUDA_ASYNC_ALLOC")) {
+        size_t threshold = std::numeric_limits<size_t>::max();
+        if (auto setting = MGB_GETENV("MGB_CUDA_ASYNC_ALLOC_RELEASE_THRESHOLD")) {
+            threshold = std::stoull(setting);
+        }
+        mem_alloc = mem_alloc::DevMemAlloc::make_cuda_async_alloc(dev_num, threshold);
+        if (mem_alloc) {
+            async_alloc = true;
+            mem_alloc->alignment(env.property().mem_alignment);
+            mgb_log_debug(
+                    "cuda: gpu%d: name=`%s' use async allocator "
+                    "release_threshold=%zu",
+                    dev_num, cuenv.device_prop.name, threshold);
+            return;
+        }
+        mgb_log_warn(
+                "cuda: gpu%d: memory pools are not supported; fallback to "
+                "default allocator",
+                dev_num);
+    }
     auto reserve_size = StaticData::get_mem_reserve_size();
-    mem_alloc = mem_alloc::DevMemAlloc::make(
-            dev_num, reserve_size, std::make_shared<mem_alloc::CudaRawAllocator>(),
-            std::make_shared<mem_alloc::CudaDeviceRuntimePolicy>());
-    mem_alloc->prealloc_config(sd->prealloc_config);
+    if (MGB_GETENV("MGB_CUDA_VMM_ALLOC")) {
+        mem_alloc = mem_alloc::DevMemAlloc::make_cuda_vmm_alloc(
+                dev_num, reserve_size, sd->prealloc_config);
+        if (mem_alloc) {
+            mgb_log_debug("cuda: gpu%d: use virtual memory allocator", dev_num);
+        } else {
+            mgb_log_warn(
+                    "cuda: gpu%d: virtual memory management is not supported; "
+                    "fallback to default allocator",
+                    dev_num);
+        }
+    }
+    if (!mem_alloc) {
+        mem_alloc = mem_alloc::DevMemAlloc::make(
+                dev_num, reserve_size,
+                std::make_shared<mem_alloc::CudaRawAllocator>(),
+                std::make_shared<mem_alloc::CudaDeviceRuntimePolicy>());
+        mem_alloc->prealloc_config(sd->prealloc_config);
+    }
     auto align = env.property().mem_alignment;
     mem_alloc->alignment(align);
     mgb_log_debug(
@@ -688,6 +1109,223 @@ void CudaCompNode::EventImpl::do_device_wait_by(Impl* cn_impl) {
     mgb_throw(MegBrainError, "unimplemented event device_wait_by config");
 }
 
+/* ===================== SeqRecorderImpl  ===================== */
+
+#if CUDART_VERSION >= 11010
+/*!
+ * \brief record the kernels issued on a cuda comp node into a cuda graph by
+ *      stream capture, and replay them with a single graph launch
+ *
+ * Event record nodes are needed to capture the events of the computing
+ * sequence, so CUDA 11.1 or later is required.
+ */
+class CudaCompNode::SeqRecorderImpl final : public CompNodeSeqRecorder {
+    bool m_fake_exec = false, m_stopped = false;
+    CudaCompNodeImpl* const m_comp_node_impl;
+    const CompNode m_record_compnode;
+    cudaGraphExec_t m_graph_exec = nullptr;
+
+    //! host callbacks captured into the graph; they must be kept alive until
+    //! the graph would not be launched anymore
+    std::vector<std::unique_ptr<CudaHostFunc>> m_host_funcs;
+
+    void check_the_same_comp_node(const CompNode& comp_node) const {
+        if (mgb_unlikely(comp_node.valid())) {
+            mgb_assert(
+                    m_record_compnode == comp_node,
+                    "CompNode %s can't hook in CompNode %s when recording\n",
+                    comp_node.locator().to_string().c_str(),
+                    m_record_compnode.locator().to_string().c_str());
+        }
+    }
+
+    cudaStream_t stream() const { return m_comp_node_impl->m_env.cuda_env().stream; }
+
+    void begin_capture() {
+        MGB_CUDA_CHECK(
+                cudaStreamBeginCapture(stream(), cudaStreamCaptureModeRelaxed));
+    }
+
+    cudaGraph_t end_capture() {
+        cudaGraph_t graph = nullptr;
+        auto err = cudaStreamEndCapture(stream(), &graph);
+        if (err != cudaSuccess) {
+            cudaGetLastError();
+            mgb_throw(
+                    CudaError,
+                    "failed to capture cuda graph on %s: %s; note that "
+                    "synchronization and cross-stream dependencies are not "
+                    "allowed during comp node seq recording",
+                    m_record_compnode.to_string().c_str(), cudaGetErrorString(err));
+        }
+        return graph;
+    }
+
+    //! instantiate \p graph into m_graph_exec, reusing the graph exec retired
+    //! by previous recorder if possible
+    void instantiate(cudaGraph_t graph) {
+        cudaGraphExec_t retired;
+        {
+            MGB_LOCK_GUARD(m_comp_node_impl->m_retired_graph_exec_mtx);
+            retired = m_comp_node_impl->m_retired_graph_exec;
+            m_comp_node_impl->m_retired_graph_exec = nullptr;
+        }
+        if (retired) {
+            // memory reallocation only changes the kernel params in most
+            // cases, which can be updated without re-instantiation
+#if CUDART_VERSION >= 12000
+            cudaGraphExecUpdateResultInfo info;
+            auto err = cudaGraphExecUpdate(retired, graph, &info);
+#else
+            cudaGraphNode_t err_node;
+            cudaGraphExecUpdateResult result;
+            auto err = cudaGraphExecUpdate(retired, graph, &err_node, &result);
+#endif
+            if (err == cudaSuccess) {
+                m_graph_exec = retired;
+                return;
+            }
+            cudaGetLastError();
+            MGB_CUDA_CHECK(cudaGraphExecDestroy(retired));
+        }
+#if CUDART_VERSION >= 12000
+        MGB_CUDA_CHECK(cudaGraphInstantiate(&m_graph_exec, graph, 0));
+#else
+        MGB_CUDA_CHECK(
+                cudaGraphInstantiate(&m_graph_exec, graph, nullptr, nullptr, 0));
+#endif
+    }
+
+public:
+    SeqRecorderImpl(CudaCompNodeImpl* comp_node_impl)
+            : m_comp_node_impl{comp_node_impl},
+              m_record_compnode{make_comp_node_from_impl(comp_node_impl)} {
+        mgb_assert(
+                !m_comp_node_impl->m_cur_recorder,
+                "only one seq recorder could be active on %s",
+                m_record_compnode.to_string().c_str());
+        // allocations from memory pools would become graph nodes in capture
+        mgb_assert(
+                !m_comp_node_impl->m_device_info->async_alloc,
+                "seq recorder can not be used with MGB_CUDA_ASYNC_ALLOC");
+        m_comp_node_impl->activate();
+        begin_capture();
+        m_comp_node_impl->m_cur_recorder = this;
+    }
+
+    ~SeqRecorderImpl() {
+        if (CudaCompNodeImpl::check_global_finalized())
+            return;
+        MGB_TRY {
+            m_comp_node_impl->activate();
+            if (m_comp_node_impl->m_cur_recorder == this) {
+                m_comp_node_impl->m_cur_recorder = nullptr;
+                cudaGraph_t graph = nullptr;
+                if (cudaStreamEndCapture(stream(), &graph) == cudaSuccess) {
+                    if (graph) {
+                        cudaGraphDestroy(graph);
+                    }
+                } else {
+                    cudaGetLastError();
+                }
+            }
+            if (m_graph_exec) {
+                if (!m_host_funcs.empty()) {
+                    // host funcs may still be invoked by the last launch
+                    MGB_CUDA_CHECK(cudaStreamSynchronize(stream()));
+                }
+                MGB_LOCK_GUARD(m_comp_node_impl->m_retired_graph_exec_mtx);
+                std::swap(m_graph_exec, m_comp_node_impl->m_retired_graph_exec);
+                if (m_graph_exec) {
+                    MGB_CUDA_CHECK(cudaGraphExecDestroy(m_graph_exec));
+                }
+            }
+        }
+        MGB_CATCH(MegBrainError & exc, {
+            mgb_log_error("failed to destroy cuda seq recorder: %s", exc.what());
+        })
+    }
+
+    void enter_fake_exec(const CompNode& comp_node) override {
+        check_the_same_comp_node(comp_node);
+        mgb_assert(!m_stopped && !m_fake_exec);
+        // kernels are still captured but would be discarded
+        m_fake_exec = true;
+    }
+
+    void exit_fake_exec(const CompNode& comp_node) override {
+        check_the_same_comp_node(comp_node);
+        mgb_assert(!m_stopped && m_fake_exec);
+        m_comp_node_impl->activate();
+        MGB_CUDA_CHECK(cudaGraphDestroy(end_capture()));
+        m_host_funcs.clear();
+        begin_capture();
+        m_fake_exec = false;
+    }
+
+    void stop(const CompNode& comp_node = {}) override {
+        check_the_same_comp_node(comp_node);
+        mgb_assert(m_comp_node_impl->m_cur_recorder == this);
+        mgb_assert(!m_fake_exec);
+        m_comp_node_impl->m_cur_recorder = nullptr;
+        m_stopped = true;
+        m_comp_node_impl->activate();
+        auto graph = end_capture();
+        MGB_TRY { instantiate(graph); }
+        MGB_FINALLY(cudaGraphDestroy(graph););
+    }
+
+    void replay() override {
+        mgb_assert(m_stopped, "not stopped yet");
+        m_comp_node_impl->activate();
+        MGB_CUDA_CHECK(cudaGraphLaunch(m_graph_exec, stream()));
+    }
+
+    void on_mem_op(const char* op) {
+        mgb_assert(
+                m_fake_exec, "%s is disallowed during comp node seq recording on %s",
+                op, m_record_compnode.to_string().c_str());
+    }
+
+    void add_host_func(CudaHostFunc&& func) {
+        auto func_ptr = std::make_unique<CudaHostFunc>(std::move(func));
+        MGB_CUDA_CHECK(cudaLaunchHostFunc(
+                stream(), cuda_graph_host_func_caller,
+                static_cast<void*>(func_ptr.get())));
+        m_host_funcs.emplace_back(std::move(func_ptr));
+    }
+};
+
+std::unique_ptr<CompNodeSeqRecorder> CudaCompNodeImpl::create_seq_recorder(
+        cg::ComputingGraph*) {
+    return std::make_unique<SeqRecorderImpl>(this);
+}
+
+void CudaCompNodeImpl::check_mem_op_during_capture(const char* op) {
+    if (m_cur_recorder) {
+        m_cur_recorder->on_mem_op(op);
+    }
+}
+
+void CudaCompNodeImpl::add_captured_callback(CudaHostFunc&& cb) {
+    m_cur_recorder->add_host_func(std::move(cb));
+}
+#else
+std::unique_ptr<CompNodeSeqRecorder> CudaCompNodeImpl::create_seq_recorder(
+        cg::ComputingGraph*) {
+    mgb_throw(
+            MegBrainError,
+            "comp node seq recorder on cuda requires CUDA 11.1 or later");
+}
+
+void CudaCompNodeImpl::check_mem_op_during_capture(const char*) {}
+
+void CudaCompNodeImpl::add_captured_callback(CudaHostFunc&&) {
+    MGB_MARK_USED_VAR(cuda_graph_host_func_caller);
+    mgb_throw(MegBrainError, "cuda graph capture is not supported");
+}
+#endif
+
 /* ===================== CudaCompNode static methods ===================== */
 
 namespace {
@@ -13,8 +13,10 @@
 
 #include "./impl.h"
 #include "megbrain/utils/arith_helper.h"
+#include "megbrain/utils/thread_local.h"
 
 #include <algorithm>
+#include <limits>
 
 using namespace mgb;
 using namespace mem_alloc;
@@ -303,7 +305,7 @@ MemAllocImplHelper::MemAddr DevMemAllocImpl::alloc_from_parent(size_t size) {
         insert_free_unsafe({MemAddr{false, ptr_int + size}, size_upper - size});
     }
     m_tot_allocated_from_raw += size_upper;
-    return {true, ptr_int};
+    return {!m_mergeable_chunks, ptr_int};
 }
 
 size_t DevMemAllocImpl::gather_stream_free_blk_and_release_full() {
@@ -311,7 +313,46 @@ size_t DevMemAllocImpl::gather_stream_free_blk_and_release_full() {
     std::vector<void*> to_free_by_raw;
 
     MGB_LOCK_GUARD(m_mutex);
+    // free blocks may span several adjacent chunks if they are mergeable;
+    // release all the chunks covered by a free block and keep the remaining
+    // parts as free blocks
+    auto return_covered_chunks_unsafe = [&](MemAllocImplHelper* alloc) {
+        std::vector<FreeBlock> blks;
+        for (auto&& i : alloc->m_free_blk_size)
+            blks.push_back(i.first);
+        for (auto&& blk : blks) {
+            auto riter = m_alloc_from_raw.lower_bound(blk.addr.addr_ptr());
+            size_t begin = blk.addr.addr;
+            std::vector<FreeBlock> remain;
+            while (riter != m_alloc_from_raw.end()) {
+                auto chunk_addr = reinterpret_cast<size_t>(riter->first);
+                if (chunk_addr + riter->second > blk.end())
+                    break;
+                if (chunk_addr > begin) {
+                    remain.push_back({MemAddr{false, begin}, chunk_addr - begin});
+                }
+                to_free_by_raw.push_back(riter->first);
+                free_size += riter->second;
+                begin = chunk_addr + riter->second;
+                riter = m_alloc_from_raw.erase(riter);
+            }
+            if (begin == blk.addr.addr)
+                continue;
+            if (begin < blk.end()) {
+                remain.push_back({MemAddr{false, begin}, blk.end() - begin});
+            }
+            auto aiter = alloc->m_free_blk_addr.find(blk.addr.addr);
+            alloc->m_free_blk_size.erase(aiter->second.siter);
+            alloc->m_free_blk_addr.erase(aiter);
+            for (auto&& i : remain)
+                alloc->MemAllocImplHelper::insert_free_unsafe(i);
+        }
+    };
     auto return_full_free_blk_unsafe = [&](MemAllocImplHelper* alloc) {
+        if (m_mergeable_chunks) {
+            return_covered_chunks_unsafe(alloc);
+            return;
+        }
         auto&& free_blk_size = alloc->m_free_blk_size;
         auto&& free_blk_addr = alloc->m_free_blk_addr;
         using Iter = decltype(m_free_blk_size.begin());
@@ -378,14 +419,16 @@ DevMemAllocImpl::DevMemAllocImpl(
         const std::shared_ptr<mem_alloc::DeviceRuntimePolicy>& runtime_policy)
         : m_device(device),
           m_raw_allocator(raw_allocator),
-          m_runtime_policy(runtime_policy) {
+          m_runtime_policy(runtime_policy),
+          m_mergeable_chunks(raw_allocator->mergeable_chunks()) {
     if (reserve_size) {
         auto ptr = m_raw_allocator->alloc(reserve_size);
         mgb_throw_if(
                 !ptr, MemAllocError, "failed to reserve memory for %zu bytes",
                 reserve_size);
         insert_free_unsafe(
-                {MemAddr{true, reinterpret_cast<size_t>(ptr)}, reserve_size});
+                {MemAddr{!m_mergeable_chunks, reinterpret_cast<size_t>(ptr)},
+                 reserve_size});
 
         m_alloc_from_raw[ptr] = reserve_size;
         m_tot_allocated_from_raw += reserve_size;
@@ -489,4 +532,311 @@ FreeMemStat SimpleCachingAllocImpl::get_free_memory_dev() {
     return get_free_memory();
 }
 
+/* ===================== ThreadCachingAllocImpl ===================== */
+
+constexpr size_t ThreadCachingAllocImpl::MIN_CLASS_SIZE,
+        ThreadCachingAllocImpl::NR_SIZE_CLASS;
+constexpr size_t ThreadCachingAlloc::MAX_CACHED_SIZE;
+
+struct ThreadCachingAllocImpl::SharedPool {
+    const size_t alignment;
+    std::unique_ptr<RawAllocator> raw_alloc;
+    std::mutex mtx;
+    //! free blocks in the shared pool, protected by mtx
+    std::vector<void*> blocks[NR_SIZE_CLASS];
+    //! number of cached blocks, in both shared pool and thread caches
+    std::atomic_size_t nr_cached[NR_SIZE_CLASS];
+    std::atomic_size_t used{0};
+    //! whether the owner allocator is alive
+    std::atomic_bool alive{true};
+
+    SharedPool(std::unique_ptr<RawAllocator> raw, size_t align)
+            : alignment{align}, raw_alloc{std::move(raw)} {
+        for (auto&& i : nr_cached) {
+            i.store(0);
+        }
+    }
+
+    ~SharedPool() {
+        for (auto&& i : blocks) {
+            for (auto ptr : i) {
+                free_raw(ptr);
+            }
+        }
+    }
+
+    void free_raw(void* ptr) { raw_alloc->free(static_cast<char*>(ptr) - alignment); }
+};
+
+struct ThreadCachingAllocImpl::ThreadCache {
+    const std::shared_ptr<SharedPool> pool;
+    std::vector<void*> blocks[NR_SIZE_CLASS];
+    size_t bytes = 0;
+
+    explicit ThreadCache(std::shared_ptr<SharedPool> p) : pool{std::move(p)} {}
+
+    ~ThreadCache() { flush(true); }
+
+    //! move all the blocks (or the older half of each class) to shared pool
+    void flush(bool all) {
+        MGB_LOCK_GUARD(pool->mtx);
+        for (size_t cls = 0; cls < NR_SIZE_CLASS; ++cls) {
+            auto&& src = blocks[cls];
+            size_t nr = all ? src.size() : src.size() / 2;
+            if (!nr) {
+                continue;
+            }
+            auto&& dst = pool->blocks[cls];
+            dst.insert(dst.end(), src.begin(), src.begin() + nr);
+            src.erase(src.begin(), src.begin() + nr);
+            bytes -= nr * class_size(cls);
+        }
+    }
+};
+
+namespace {
+#if MGB_HAVE_THREAD && USE_STL_THREAD_LOCAL
+//! set when the thread cache list of current thread has been destructed, so
+//! frees from later destructors go to the shared pool directly
+thread_local bool tl_cache_list_destructed = false;
+
+struct ThreadCacheList {
+    std::vector<std::unique_ptr<ThreadCachingAllocImpl::ThreadCache>> caches;
+    ~ThreadCacheList() { tl_cache_list_destructed = true; }
+};
+
+ThreadCacheList* get_thread_cache_list() {
+    if (tl_cache_list_destructed) {
+        return nullptr;
+    }
+    static thread_local ThreadCacheList list;
+    return &list;
+}
+#else
+struct ThreadCacheList {
+    std::vector<std::unique_ptr<ThreadCachingAllocImpl::ThreadCache>> caches;
+};
+
+ThreadCacheList* get_thread_cache_list() {
+    return nullptr;
+}
+#endif
+}  // anonymous namespace
+
+size_t ThreadCachingAllocImpl::size_class(size_t size) {
+    if (size <= MIN_CLASS_SIZE) {
+        return 0;
+    }
+    --size;
+    // p is the index of highest bit; size is at most MAX_CACHED_SIZE here
+    size_t p = 6;
+    while (size >> (p + 1)) {
+        ++p;
+    }
+    return 1 + (p - 6) * 4 + ((size >> (p - 2)) - 4);
+}
+
+size_t ThreadCachingAllocImpl::class_size(size_t cls) {
+    if (!cls) {
+        return MIN_CLASS_SIZE;
+    }
+    --cls;
+    size_t p = 6 + cls / 4, j = cls % 4;
+    return (1_z << p) + ((j + 1) << (p - 2));
+}
+
+std::unique_ptr<ThreadCachingAlloc> ThreadCachingAlloc::make(
+        std::unique_ptr<RawAllocator> raw_alloc, const Config& config) {
+    return std::make_unique<ThreadCachingAllocImpl>(std::move(raw_alloc), config);
+}
+
+ThreadCachingAllocImpl::ThreadCachingAllocImpl(
+        std::unique_ptr<RawAllocator> raw_alloc, const Config& config)
+        : m_config{config} {
+    mgb_assert(
+            config.alignment >= sizeof(BlockHeader) &&
+                    !(config.alignment & (config.alignment - 1)),
+            "bad alignment for ThreadCachingAlloc: %zu", config.alignment);
+    static_assert(MIN_CLASS_SIZE == 64, "size_class() assumes 2^6");
+    mgb_assert(size_class(MAX_CACHED_SIZE) + 1 == NR_SIZE_CLASS);
+    m_pool = std::make_shared<SharedPool>(std::move(raw_alloc), config.alignment);
+}
+
+ThreadCachingAllocImpl::~ThreadCachingAllocImpl() {
+    m_pool->alive = false;
+    if (auto list = get_thread_cache_list()) {
+        auto&& caches = list->caches;
+        for (auto iter = caches.begin(); iter != caches.end(); ++iter) {
+            if ((*iter)->pool == m_pool) {
+                caches.erase(iter);
+                break;
+            }
+        }
+    }
+    // caches of other threads would be returned to the pool on thread exit,
+    // and released when the pool is destructed
+    release_cached();
+}
+
+ThreadCachingAllocImpl::ThreadCache* ThreadCachingAllocImpl::get_thread_cache() {
+    auto list = get_thread_cache_list();
+    if (!list) {
+        return nullptr;
+    }
+    auto&& caches = list->caches;
+    for (size_t i = 0; i < caches.size();) {
+        auto&& pool = caches[i]->pool;
+        if (pool == m_pool) {
+            return caches[i].get();
+        }
+        if (!pool->alive) {
+            // drop caches of destructed allocators
+            caches.erase(caches.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+    caches.emplace_back(std::make_unique<ThreadCache>(m_pool));
+    return caches.back().get();
+}
+
+void* ThreadCachingAllocImpl::alloc_from_raw(size_t cls, size_t size) {
+    auto align = m_config.alignment;
+    void* raw = m_pool->raw_alloc->alloc(size + align);
+    if (!raw) {
+        release_cached();
+        raw = m_pool->raw_alloc->alloc(size + align);
+    }
+    mgb_throw_if(!raw, MemAllocError, "failed to alloc %zu bytes", size);
+    mgb_assert(
+            !(reinterpret_cast<size_t>(raw) & (align - 1)),
+            "raw allocator returned unaligned address %p", raw);
+    auto ptr = static_cast<char*>(raw) + align;
+    auto hdr = reinterpret_cast<BlockHeader*>(ptr) - 1;
+    hdr->magic = BLOCK_MAGIC;
+    hdr->cls = cls;
+    hdr->size = size;
+    return ptr;
+}
+
+void* ThreadCachingAllocImpl::alloc(size_t size) {
+    if (size > MAX_CACHED_SIZE) {
+        auto ptr = alloc_from_raw(NR_SIZE_CLASS, size);
+        m_pool->used += size;
+        return ptr;
+    }
+    auto cls = size_class(size);
+    auto csize = class_size(cls);
+    void* ptr = nullptr;
+    if (auto tc = get_thread_cache()) {
+        auto&& blks = tc->blocks[cls];
+        if (blks.empty()) {
+            // refill from the shared pool in a batch to amortize locking
+            size_t batch = std::min<size_t>(
+                    std::max<size_t>(64 * 1024 / csize, 1), 32);
+            MGB_LOCK_GUARD(m_pool->mtx);
+            auto&& src = m_pool->blocks[cls];
+            batch = std::min(batch, src.size());
+            blks.insert(blks.end(), src.end() - batch, src.end());
+            src.resize(src.size() - batch);
+            tc->bytes += batch * csize;
+        }
+        if (!blks.empty()) {
+            ptr = blks.back();
+            blks.pop_back();
+            tc->bytes -= csize;
+        }
+    } else {
+        MGB_LOCK_GUARD(m_pool->mtx);
+        auto&& src = m_pool->blocks[cls];
+        if (!src.empty()) {
+            ptr = src.back();
+            src.pop_back();
+        }
+    }
+    if (ptr) {
+        --m_pool->nr_cached[cls];
+    } else {
+        ptr = alloc_from_raw(cls, csize);
+    }
+    m_pool->used += csize;
+    return ptr;
+}
+
+void ThreadCachingAllocImpl::free(void* ptr) {
+    auto hdr = static_cast<BlockHeader*>(ptr) - 1;
+    mgb_assert(hdr->magic == BLOCK_MAGIC, "releasing bad pointer: %p", ptr);
+    auto cls = hdr->cls;
+    if (cls == NR_SIZE_CLASS) {
+        m_pool->used -= hdr->size;
+        m_pool->free_raw(ptr);
+        return;
+    }
+    auto csize = class_size(cls);
+    m_pool->used -= csize;
+    ++m_pool->nr_cached[cls];
+    if (auto tc = get_thread_cache()) {
+        tc->blocks[cls].push_back(ptr);
+        tc->bytes += csize;
+        if (tc->bytes > m_config.thread_cache_limit) {
+            tc->flush(false);
+            if (tc->bytes > m_config.thread_cache_limit) {
+                tc->flush(true);
+            }
+        }
+    } else {
+        MGB_LOCK_GUARD(m_pool->mtx);
+        m_pool->blocks[cls].push_back(ptr);
+    }
+}
+
+void ThreadCachingAllocImpl::flush_thread_cache() {
+    if (auto tc = get_thread_cache()) {
+        tc->flush(true);
+    }
+}
+
+size_t ThreadCachingAllocImpl::release_cached() {
+    flush_thread_cache();
+    size_t released = 0;
+    MGB_LOCK_GUARD(m_pool->mtx);
+    for (size_t cls = 0; cls < NR_SIZE_CLASS; ++cls) {
+        auto&& blks = m_pool->blocks[cls];
+        for (auto ptr : blks) {
+            m_pool->free_raw(ptr);
+        }
+        m_pool->nr_cached[cls] -= blks.size();
+        released += blks.size() * class_size(cls);
+        blks.clear();
+    }
+    return released;
+}
+
+void ThreadCachingAllocImpl::print_memory_state() {
+    auto stat = get_free_memory();
+    MGB_MARK_USED_VAR(stat);
+    mgb_log("thread caching allocator stats: "
+            "used=%zu free={tot:%zu, min_blk:%zu, max_blk:%zu, nr:%zu}",
+            get_used_memory(), stat.tot, stat.min, stat.max, stat.nr_blk);
+}
+
+size_t ThreadCachingAllocImpl::get_used_memory() {
+    return m_pool->used.load();
+}
+
+FreeMemStat ThreadCachingAllocImpl::get_free_memory() {
+    FreeMemStat stat{0, std::numeric_limits<size_t>::max(), 0, 0};
+    for (size_t cls = 0; cls < NR_SIZE_CLASS; ++cls) {
+        size_t nr = m_pool->nr_cached[cls].load();
+        if (nr) {
+            auto csize = class_size(cls);
+            stat.tot += nr * csize;
+            stat.min = std::min(stat.min, csize);
+            stat.max = std::max(stat.max, csize);
+            stat.nr_blk += nr;
+        }
+    }
+    return stat;
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
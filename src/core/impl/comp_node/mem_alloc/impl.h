@@ -166,8 +166,12 @@ class DevMemAllocImpl final : public DevMemAlloc, public MemAllocImplHelper {
     std::shared_ptr<DeviceRuntimePolicy> m_runtime_policy;
     ThinHashMap<StreamKey, std::unique_ptr<StreamMemAllocImpl>> m_stream_alloc;
 
-    //!< blocks allocated from raw alloc, addr to size
-    std::unordered_map<void*, size_t> m_alloc_from_raw;
+    //! whether free blocks can be merged across chunks from raw alloc
+    const bool m_mergeable_chunks;
+
+    //!< blocks allocated from raw alloc, addr to size; sorted by address so
+    //!< chunks covered by a merged free block can be found
+    std::map<void*, size_t> m_alloc_from_raw;
 
     size_t m_tot_allocated_from_raw = 0;
     std::atomic_size_t m_used_size{0};
@@ -247,6 +251,57 @@ protected:
     std::string get_name() const override;
 };
 
+class ThreadCachingAllocImpl final : public ThreadCachingAlloc {
+public:
+    //! the smallest size class; larger classes are 1.25x, 1.5x, 1.75x and 2x
+    //! of each power of 2
+    static constexpr size_t MIN_CLASS_SIZE = 64, NR_SIZE_CLASS = 57;
+
+    //! get size class index to hold \p size bytes
+    static size_t size_class(size_t size);
+
+    //! get number of bytes of a size class
+    static size_t class_size(size_t cls);
+
+    struct SharedPool;
+    struct ThreadCache;
+
+private:
+    struct BlockHeader {
+        uint32_t magic;
+        //! size class, or NR_SIZE_CLASS for uncached blocks
+        uint32_t cls;
+        //! requested size for uncached blocks
+        size_t size;
+    };
+    static constexpr uint32_t BLOCK_MAGIC = 0x6d676274;
+
+    const Config m_config;
+    //! states shared with thread caches, which may outlive this allocator
+    std::shared_ptr<SharedPool> m_pool;
+
+    //! get cache of calling thread; return nullptr if thread local storage
+    //! is not available
+    ThreadCache* get_thread_cache();
+
+    void* alloc_from_raw(size_t cls, size_t size);
+
+public:
+    ThreadCachingAllocImpl(std::unique_ptr<RawAllocator> raw_alloc, const Config& config);
+    ~ThreadCachingAllocImpl();
+
+    void* alloc(size_t size) override;
+    void free(void* ptr) override;
+    void flush_thread_cache() override;
+    size_t release_cached() override;
+    size_t alignment() const override { return m_config.alignment; }
+
+    void print_memory_state() override;
+    size_t get_used_memory() override;
+    FreeMemStat get_free_memory() override;
+    FreeMemStat get_free_memory_dev() override { return get_free_memory(); }
+};
+
 }  // namespace mem_alloc
 }  // namespace mgb
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
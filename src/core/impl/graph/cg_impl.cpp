@@ -22,6 +22,7 @@
 #include "megbrain/graph/exc_extra_info.h"
 #include "megbrain/graph/helper.h"
 #include "megbrain/opr/utility.h"
+#include "megbrain/utils/timer.h"
 
 #if MGB_ENABLE_TENSOR_RT
 #include "megbrain/tensorrt/opr_replace.h"
@@ -249,6 +250,18 @@ public:
             m_cb[i].clear();
         }
     }
+
+    //! replace all the callbacks; the caller may be shared by multiple
+    //! compiled functions, each of which installs its own callbacks
+    void set_callback(const CallbackCallerCallbacks& cbs) {
+        mgb_assert(cbs.size() == m_cb.size());
+        clear_callback();
+        for (size_t i = 0; i < cbs.size(); ++i) {
+            for (auto&& cb : cbs[i]) {
+                add_callback(cb, i);
+            }
+        }
+    }
 };
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(ComputingGraphImpl::CallbackCaller);
 
@@ -460,7 +473,11 @@ std::shared_ptr<ComputingGraph> ComputingGraph::make() {
 
 std::unique_ptr<AsyncExecutable> ComputingGraphImpl::compile(
         const OutputSpec& out_spec) {
-    return compile_commit(compile_prepare(out_spec));
+    RealTimer timer;
+    auto ret = compile_commit(compile_prepare(out_spec));
+    event().signal_inplace<event::StartupPhaseFinished>(
+            "compile", "", timer.get_msecs());
+    return ret;
 }
 
 SmallVector<std::unique_ptr<AsyncExecutable>> ComputingGraphImpl::compile_multi_part(
@@ -591,6 +608,8 @@ ComputingGraphImpl::CompileState ComputingGraphImpl::compile_prepare(
     const OprNodeArray* opr_seq = nullptr;
     CompSeqExtraInfo extra_info;
     cmpnt.seq_comp_node_opt.optimize_comp_nodes(dest_vars);
+    VarNodeArray comp_node_opt_dest_vars = dest_vars, callback_caller_vars;
+    std::vector<CallbackCallerCallbacks> callback_caller_cbs;
 
     bool init_flag = false;
     auto init_opr_seq = [&]() {
@@ -637,13 +656,16 @@ ComputingGraphImpl::CompileState ComputingGraphImpl::compile_prepare(
             CallbackCaller* cb_caller =
                     &dvar.node()->owner_opr()->cast_final_safe<CallbackCaller>();
             ++extra_info.var2recvinfo[dvar.node()].nr_direct_comp_req;
-            cb_caller->clear_callback();
+            callback_caller_vars.push_back(dvar.node());
+            callback_caller_cbs.emplace_back(val.vars.size());
+            auto&& cbs = callback_caller_cbs.back();
             for (size_t i = 0; i < val.vars.size(); ++i) {
                 for (auto&& idx : val.indexs[i]) {
-                    cb_caller->add_callback(out_spec[idx].second, i);
+                    cbs[i].push_back(out_spec[idx].second);
                     dest_vars[idx] = cb_caller->output(0);
                 }
             }
+            cb_caller->set_callback(cbs);
         }
         opr_seq = topo_sorter().get_comp_seq(extra_info, dest_vars);
     };
@@ -697,14 +719,38 @@ ComputingGraphImpl::CompileState ComputingGraphImpl::compile_prepare(
         init_opr_seq();
     }
 
-    return {std::move(extra_info), opr_seq, std::move(dest_vars)};
+    return {std::move(extra_info), opr_seq, std::move(dest_vars),
+            std::move(comp_node_opt_dest_vars), std::move(callback_caller_vars),
+            std::move(callback_caller_cbs)};
 }
 
 std::unique_ptr<AsyncExecutable> ComputingGraphImpl::compile_commit(
         CompileState state) {
     auto comp_seq = std::make_unique<ComputingSequence>(shared_from_this());
+    setup_comp_seq(comp_seq.get(), std::move(state));
+
+    if (options().comp_node_seq_record_level > 1) {
+        mgb_assert(
+                options().comp_node_seq_record_level <= 2,
+                "invalid comp_node_seq_record_level: %u",
+                options().comp_node_seq_record_level);
+        mgb_assert(
+                !options().fake_next_exec && !options().var_sanity_check_first_run,
+                "both fake_next_exec and var_sanity_check_first_run "
+                "must be false when comp_node_seq_record_level is 2");
+        return comp_seq->as_recorded_seq();
+    }
+    return comp_seq;
+}
+
+void ComputingGraphImpl::setup_comp_seq(
+        ComputingSequence* comp_seq, CompileState state) {
     comp_seq->extra_info = std::move(state.extra_info);
     comp_seq->set_output_vars(state.dest_vars);
+    comp_seq->set_reattach_dest_vars(
+            std::move(state.comp_node_opt_dest_vars),
+            std::move(state.callback_caller_vars),
+            std::move(state.callback_caller_cbs), std::move(state.dest_vars));
     auto opr_seq = state.opr_seq;
     auto&& cmpnt = components();
 
@@ -728,20 +774,41 @@ std::unique_ptr<AsyncExecutable> ComputingGraphImpl::compile_commit(
     }
     MGB_FINALLY({ var_node_mem_manager().on_graph_compile_finished(); });
 
-    event().signal_inplace<event::CompSeqOrderDetermined>(this, comp_seq.get());
+    event().signal_inplace<event::CompSeqOrderDetermined>(this, comp_seq);
+}
 
-    if (options().comp_node_seq_record_level > 1) {
-        mgb_assert(
-                options().comp_node_seq_record_level <= 2,
-                "invalid comp_node_seq_record_level: %u",
-                options().comp_node_seq_record_level);
-        mgb_assert(
-                !options().fake_next_exec && !options().var_sanity_check_first_run,
-                "both fake_next_exec and var_sanity_check_first_run "
-                "must be false when comp_node_seq_record_level is 2");
-        return comp_seq->as_recorded_seq();
+void ComputingGraphImpl::reattach_comp_seq(ComputingSequence* comp_seq) {
+    mgb_throw_if(
+            options().enable_sublinear_memory_opt ||
+                    options().enable_dtr_memory_opt || options().enable_memory_swap,
+            GraphError,
+            "compiled functions can not be re-attached with sublinear memory, "
+            "dtr or memory swap, which modify the graph for each compiling");
+    auto&& cmpnt = components();
+
+    // the same steps as compile_prepare() after the graph optimization, so
+    // the opr props and comp nodes are modified in the same way
+    topo_sorter().restore_opr_prop();
+    cmpnt.seq_comp_node_opt.restore_comp_nodes();
+    cmpnt.seq_comp_node_opt.optimize_comp_nodes(comp_seq->comp_node_opt_dest_vars());
+
+    CompileState state;
+    auto&& cb_cbs = comp_seq->callback_caller_cbs();
+    for (size_t i = 0; i < comp_seq->callback_caller_vars().size(); ++i) {
+        auto var = comp_seq->callback_caller_vars()[i];
+        ++state.extra_info.var2recvinfo[var].nr_direct_comp_req;
+        // callback callers are deduplicated by their inputs, so a later
+        // compiled function may have installed its own callbacks here
+        var->owner_opr()->cast_final_safe<CallbackCaller>().set_callback(cb_cbs[i]);
     }
-    return comp_seq;
+    state.dest_vars = comp_seq->reattach_dest_vars();
+    state.opr_seq = topo_sorter().get_comp_seq(state.extra_info, state.dest_vars);
+    state.comp_node_opt_dest_vars = comp_seq->comp_node_opt_dest_vars();
+    state.callback_caller_vars = comp_seq->callback_caller_vars();
+    state.callback_caller_cbs = cb_cbs;
+
+    comp_seq->on_reattach();
+    setup_comp_seq(comp_seq, std::move(state));
 }
 
 VarNodeArray ComputingGraphImpl::get_dest_vars_from_out_spec(
@@ -815,6 +882,10 @@ size_t ComputingGraphImpl::get_device_memory_size(CompNode cn) {
 }
 
 size_t ComputingGraphImpl::clear_device_memory() {
+    if (m_current_comp_seq) {
+        // cached recorders hold references to static memory
+        static_cast<ComputingSequence*>(m_current_comp_seq)->clear_recorder_cache();
+    }
 #if !MGB_BUILD_SLIM_SERVING
     if (options().eager_evaluation) {
         for (auto& opr : m_opr_refkeeper) {
@@ -28,18 +28,34 @@ namespace mgb {
 namespace cg {
 
 class ComputingGraphImpl final : public ComputingGraph {
+public:
+    class ComputingSequence;
+
+private:
     class CallbackCaller;
     class RecordedComputingSequence;
     class MegDNNDtorCheck;
     class MultiPartCompiler;
     friend class GradManager;
 
+    //! callbacks of each input var of a CallbackCaller
+    using CallbackCallerCallbacks = std::vector<std::vector<ComputingGraph::Callback>>;
+
     //! temporary state in compiling
     struct CompileState {
         //! extra info that must be set in the ComputingSequence
         CompSeqExtraInfo extra_info;
         const OprNodeArray* opr_seq = nullptr;
         VarNodeArray dest_vars;
+        //! dest vars before adding the callback callers, whose comp nodes are
+        //! optimized; used to re-attach the sequence
+        VarNodeArray comp_node_opt_dest_vars;
+        //! outputs of the callback callers
+        VarNodeArray callback_caller_vars;
+        //! callbacks installed on each callback caller, which must be
+        //! installed again when re-attaching since the callers are shared
+        //! between compiled functions
+        std::vector<CallbackCallerCallbacks> callback_caller_cbs;
     };
 
     struct CallbackCallerKey {
@@ -142,9 +158,18 @@ class ComputingGraphImpl final : public ComputingGraph {
     //! finalize the computing sequence for compiling
     std::unique_ptr<AsyncExecutable> compile_commit(CompileState state);
 
-public:
-    class ComputingSequence;
+    //! attach a computing sequence to the graph and plan its memory
+    void setup_comp_seq(ComputingSequence* comp_seq, CompileState state);
 
+    /*!
+     * \brief make a previously compiled sequence the current one again
+     *
+     * The opr sequence is sorted again from the optimized dest vars of the
+     * sequence; see Options::allow_reattach_comp_seq
+     */
+    void reattach_comp_seq(ComputingSequence* comp_seq);
+
+public:
     ComputingGraphImpl();
     ~ComputingGraphImpl();
 
@@ -59,8 +59,9 @@ class ComputingGraphImpl::ComputingSequence::ExecContext {
 
     void try_reset_recorder() {
         if (m_mem_reallocated) {
-            // clear recorded sequence because memory has been reallocated
-            m_comp_seq->m_comp_node_seq_recorder.reset();
+            // recorded sequence is invalid because memory has been
+            // reallocated; it may be cached for later use
+            m_comp_seq->switch_recorder_on_mem_realloc();
         }
         if (m_comp_seq->m_comp_node_seq_recorder) {
             return;
@@ -102,6 +103,12 @@ class ComputingGraphImpl::ComputingSequence::ExecContext {
         }
         // only move to m_comp_node_seq_recorder after all oprs succeeds
         m_comp_seq->m_comp_node_seq_recorder = std::move(m_recorder);
+        if (m_owner_graph->options().comp_node_seq_record_cache_size) {
+            auto&& refholder = m_owner_graph->var_node_mem_manager()
+                                       .static_device_memory_refholder();
+            m_comp_seq->m_cur_recorder_info.static_mem.assign(
+                    refholder.begin(), refholder.end());
+        }
     }
 
     void after_fake_exec() {
@@ -306,6 +313,7 @@ void ComputingGraphImpl::ComputingSequence::do_execute(MegDNNDtorCheck* dtor_che
 }
 
 void ComputingGraphImpl::ComputingSequence::preprocess(ExecContext* ctx) {
+    reattach_if_needed();
     assert_latest_comp_seq();
     ++m_run_id;
     m_prev_exec_time = None;
@@ -325,16 +333,84 @@ void ComputingGraphImpl::ComputingSequence::preprocess(ExecContext* ctx) {
             m_owner_graph, this, &ctx->m_cleanup_callback, &m_used_comp_node,
             m_owner_graph->event().version());
 
-    if (first_exec || m_cg_event_version != m_owner_graph->event().version()) {
+    if (first_exec || m_reattached ||
+        m_cg_event_version != m_owner_graph->event().version()) {
+        // the tasks must be dispatched again after re-attaching, since the
+        // ready events of the oprs are initialized again
         init_for_exec();
+        m_reattached = false;
     }
     ctx->m_enable_comp_node_seq_recorder = m_enable_comp_node_seq_recorder;
 }
 
+void ComputingGraphImpl::ComputingSequence::switch_recorder_on_mem_realloc() {
+    auto&& options = m_owner_graph->options();
+    if (!options.comp_node_seq_record_cache_size ||
+        options.comp_node_seq_record_level != 1) {
+        m_comp_node_seq_recorder.reset();
+        return;
+    }
+
+    if (m_input_vars.empty()) {
+        for (auto i : *m_opr_seq) {
+            if (i->input().empty()) {
+                for (auto j : i->output()) {
+                    m_input_vars.push_back(j);
+                }
+            }
+        }
+    }
+    TensorShapeArray shapes;
+    shapes.reserve(m_input_vars.size());
+    for (auto i : m_input_vars) {
+        shapes.push_back(i->shape());
+    }
+
+    auto same_shapes = [&shapes](const TensorShapeArray& other) {
+        if (other.size() != shapes.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            if (!other[i].eq_shape(shapes[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto&& cur = m_cur_recorder_info;
+    if (m_comp_node_seq_recorder) {
+        if (same_shapes(cur.input_shapes)) {
+            // memory is reallocated without shape change, so the recorder
+            // has to be discarded
+            m_comp_node_seq_recorder.reset();
+        } else {
+            cur.recorder = std::move(m_comp_node_seq_recorder);
+            m_recorder_cache.emplace_back(std::move(cur));
+            if (m_recorder_cache.size() > options.comp_node_seq_record_cache_size) {
+                m_recorder_cache.erase(m_recorder_cache.begin());
+            }
+        }
+    }
+    cur = {};
+    for (auto iter = m_recorder_cache.begin(); iter != m_recorder_cache.end();
+         ++iter) {
+        if (same_shapes(iter->input_shapes)) {
+            cur = std::move(*iter);
+            m_comp_node_seq_recorder = std::move(cur.recorder);
+            m_recorder_cache.erase(iter);
+            break;
+        }
+    }
+    cur.input_shapes = std::move(shapes);
+}
+
 std::shared_ptr<void> ComputingGraphImpl::ComputingSequence::on_comp_node_finalize() {
     cleanup();
     m_exec_env.clear();
     m_comp_node_seq_recorder.reset();
+    m_recorder_cache.clear();
+    m_cur_recorder_info = {};
     m_opr2stepnum.clear();
     return {};
 }
@@ -345,6 +421,22 @@ void ComputingGraphImpl::ComputingSequence::assert_latest_comp_seq() const {
             "only the latest compiled function could be used");
 }
 
+void ComputingGraphImpl::ComputingSequence::reattach_if_needed() {
+    if (m_owner_graph->m_current_comp_seq != this &&
+        m_owner_graph->options().allow_reattach_comp_seq) {
+        check_not_finalized();
+        m_owner_graph->reattach_comp_seq(this);
+    }
+}
+
+void ComputingGraphImpl::ComputingSequence::on_reattach() {
+    // the recorded kernels refer to the memory of the previous attachment
+    m_comp_node_seq_recorder.reset();
+    m_recorder_cache.clear();
+    m_cur_recorder_info = {};
+    m_reattached = true;
+}
+
 void ComputingGraphImpl::ComputingSequence::attach_to_graph() {
     auto gimpl = m_owner_graph;
     if (gimpl->m_current_comp_seq) {
@@ -598,6 +690,7 @@ void ComputingGraphImpl::ComputingSequence::clear_device_memory() {
 
 const CompNode::UnorderedMap<size_t>& ComputingGraphImpl::ComputingSequence::
         update_static_alloc_plan_and_get_size() {
+    reattach_if_needed();
     assert_latest_comp_seq();
     // waiting for previous execution or some tensor storage may be freed after
     // calling update_static_alloc_plan, which would cause use-after-free.
@@ -26,7 +26,7 @@ class ComputingGraphImpl::ComputingSequence final : public AsyncExecutable {
     ComputingGraphImpl* const m_owner_graph;
     const bool m_have_parent_graph = true;
     bool m_wait_finished = true, m_first_exec = true,
-         m_enable_comp_node_seq_recorder = false;
+         m_enable_comp_node_seq_recorder = false, m_reattached = false;
     size_t m_run_id = 0;
     size_t m_cg_event_version = 0;
     mutable Maybe<double> m_prev_exec_time;
@@ -35,11 +35,31 @@ class ComputingGraphImpl::ComputingSequence final : public AsyncExecutable {
 #endif
     std::unique_ptr<CompNodeSeqRecorder> m_comp_node_seq_recorder;
 
+    //! a recorded sequence and the static memory it refers to
+    struct RecorderCacheEntry {
+        TensorShapeArray input_shapes;
+        std::unique_ptr<CompNodeSeqRecorder> recorder;
+        SmallVector<DeviceTensorStorage> static_mem;
+    };
+    //! recorders for previous input shapes, the most recently used at the
+    //! back; see Options::comp_node_seq_record_cache_size
+    std::vector<RecorderCacheEntry> m_recorder_cache;
+    //! input shapes and static memory of m_comp_node_seq_recorder
+    RecorderCacheEntry m_cur_recorder_info;
+    //! outputs of source oprs, whose shapes key the recorder cache
+    VarNodeArray m_input_vars;
+
     NormalExecEnv m_exec_env;
 
     const OprNodeArray* m_opr_seq = nullptr;
     ThinHashMap<OperatorNodeBase*, size_t> m_opr2stepnum;
 
+    //! optimized dest vars kept to re-attach the sequence; see
+    //! ComputingGraphImpl::CompileState
+    VarNodeArray m_comp_node_opt_dest_vars, m_callback_caller_vars,
+            m_reattach_dest_vars;
+    std::vector<CallbackCallerCallbacks> m_callback_caller_cbs;
+
     CompNode::UnorderedSet m_used_comp_node;
 
     using EventArray = CompNode::UnorderedMap<std::unique_ptr<CompNode::Event>>;
@@ -69,6 +89,15 @@ class ComputingGraphImpl::ComputingSequence final : public AsyncExecutable {
 
     void init_for_exec();
 
+    /*!
+     * \brief update m_comp_node_seq_recorder after static memory has been
+     *      reallocated
+     *
+     * The current recorder is moved into m_recorder_cache and the one
+     * recorded with current input shapes is restored if it exists.
+     */
+    void switch_recorder_on_mem_realloc();
+
     //! called from init_for_exec() when m_first_exec is true
     void on_first_exec();
 
@@ -110,13 +139,45 @@ public:
 
     void assert_latest_comp_seq() const;
 
+    /*!
+     * \brief re-attach this sequence to the graph if it is not the latest
+     *      one and Options::allow_reattach_comp_seq is set
+     */
+    void reattach_if_needed();
+
     void attach_to_graph();
 
+    //! reset the states of execution that depend on the opr sequence
+    void on_reattach();
+
+    void set_reattach_dest_vars(
+            VarNodeArray comp_node_opt_dest_vars, VarNodeArray callback_caller_vars,
+            std::vector<CallbackCallerCallbacks> callback_caller_cbs,
+            VarNodeArray dest_vars) {
+        m_comp_node_opt_dest_vars = std::move(comp_node_opt_dest_vars);
+        m_callback_caller_vars = std::move(callback_caller_vars);
+        m_callback_caller_cbs = std::move(callback_caller_cbs);
+        m_reattach_dest_vars = std::move(dest_vars);
+    }
+
+    const VarNodeArray& comp_node_opt_dest_vars() const {
+        return m_comp_node_opt_dest_vars;
+    }
+
+    const VarNodeArray& callback_caller_vars() const { return m_callback_caller_vars; }
+
+    const std::vector<CallbackCallerCallbacks>& callback_caller_cbs() const {
+        return m_callback_caller_cbs;
+    }
+
+    const VarNodeArray& reattach_dest_vars() const { return m_reattach_dest_vars; }
+
     ~ComputingSequence();
 
     void setup_opr_seq(const OprNodeArray* seq) {
-        mgb_assert(!m_opr_seq && seq);
+        mgb_assert((!m_opr_seq || m_reattached) && seq);
         m_opr_seq = seq;
+        m_opr2stepnum.clear();
         for (size_t i = 0; i < seq->size(); ++i) {
             auto ins = m_opr2stepnum.emplace((*seq)[i], i);
             mgb_assert(ins.second);
@@ -135,6 +196,9 @@ public:
 
     AsyncExecutable& iter_opr_seq(thin_function<bool(OperatorNodeBase*)> cb) override;
 
+    //! drop the recorders cached for other input shapes
+    void clear_recorder_cache() { m_recorder_cache.clear(); }
+
 #if MGB_ENABLE_JSON
     std::shared_ptr<json::Value> to_json() const override;
 #endif
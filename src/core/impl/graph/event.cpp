@@ -28,8 +28,10 @@ MGB_TYPEINFO_OBJ_IMPL(CompSeqExecBeforeStart);
 MGB_TYPEINFO_OBJ_IMPL(CompSeqExecFinished);
 MGB_TYPEINFO_OBJ_IMPL(CompSeqExecError);
 MGB_TYPEINFO_OBJ_IMPL(SubgraphAssociated);
+MGB_TYPEINFO_OBJ_IMPL(StartupPhaseFinished);
 #if MGB_ENABLE_VAR_DEV_MEM_DEFRAGMENTER
 MGB_TYPEINFO_OBJ_IMPL(BeforeMemDefrag);
+MGB_TYPEINFO_OBJ_IMPL(AfterMemDefrag);
 #endif
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -76,9 +76,7 @@ void ExecutionMask::enable(bool flag) {
             stack.pop_back();
             for (auto i : cur->m_nested) {
                 i->m_enabled = false;
-                for (auto j : i->m_nested) {
-                    stack.emplace_back(j);
-                }
+                stack.emplace_back(i);
             }
         }
     }
@@ -75,16 +75,19 @@ void NormalExecEnv::run_task_seq_impl(const TaskSeq& seq) {
     OperatorNodeBase* cur_opr = nullptr;
     MGB_MARK_USED_VAR(cur_opr);
     MGB_TRY {
-        for (auto&& i : seq) {
+        for (size_t idx = 0; idx < seq.size();) {
+            auto&& i = seq[idx];
             cur_opr = i.opr;
 #if MGB_ENABLE_COND_EXEC
             if (check_exec_mask) {
                 if (i.mask && !i.mask->enabled()) {
+                    idx = i.mask_end;
                     continue;
                 }
             }
 #endif
             i.task();
+            ++idx;
 
             if (check_exec_pause) {
                 wait_resume_if_paused();
@@ -98,6 +101,32 @@ void NormalExecEnv::run_task_seq_impl(const TaskSeq& seq) {
     })
 }
 
+#if MGB_ENABLE_COND_EXEC
+void NormalExecEnv::init_mask_end(TaskSeq& seq) {
+    auto is_nested = [](ExecutionMask* mask, ExecutionMask* ancestor) {
+        for (; mask; mask = mask->parent()) {
+            if (mask == ancestor) {
+                return true;
+            }
+        }
+        return false;
+    };
+    // the nested masks are disabled with their ancestors, so the consecutive
+    // tasks under a mask or its nested ones can be skipped together; compute
+    // in reverse order so the runs of nested masks are jumped over
+    for (size_t i = seq.size(); i; --i) {
+        auto&& cur = seq[i - 1];
+        size_t end = i;
+        if (cur.mask) {
+            while (end < seq.size() && is_nested(seq[end].mask, cur.mask)) {
+                end = seq[end].mask_end;
+            }
+        }
+        cur.mask_end = end;
+    }
+}
+#endif
+
 template <bool check_exec_pause>
 void NormalExecEnv::run_task_seq(const TaskSeq& seq) {
 #if MGB_ENABLE_COND_EXEC
@@ -116,6 +145,7 @@ void NormalExecEnv::dispatch_on_comp_node(CompNode cn, Task&& task) {
 
 void NormalExecEnv::dispatch_on_comp_node_with_mask(
         CompNode cn, Task&& task, ExecutionMask* mask) {
+    MGB_IF_COND_EXEC(m_mask_end_valid = false);
     if (m_async_level) {
         normalize_comp_node(cn);
         m_worker_task_queue.at(cn).emplace_back(
@@ -131,6 +161,16 @@ void NormalExecEnv::start_exec() {
     resume_exec();
 #endif
 
+#if MGB_ENABLE_COND_EXEC
+    if (m_has_exec_mask && !m_mask_end_valid) {
+        for (auto&& i : m_worker_task_queue) {
+            init_mask_end(i.second);
+        }
+        init_mask_end(m_sync_task_queue);
+        m_mask_end_valid = true;
+    }
+#endif
+
     if (m_async_level) {
         mgb_assert(!m_worker_task_queue.empty());
         if (m_worker_task_queue.size() > 1 || (m_async_level & 0b100)) {
@@ -167,6 +207,7 @@ void NormalExecEnv::clear() {
     m_sync_task_queue.clear();
     m_cur_active_opr = nullptr;
     MGB_IF_COND_EXEC(m_has_exec_mask = false);
+    MGB_IF_COND_EXEC(m_mask_end_valid = false);
 }
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -24,6 +24,9 @@ class NormalExecEnv final : public GraphExecutable::ExecEnv {
         Task task;
         OperatorNodeBase* opr;
         MGB_IF_COND_EXEC(ExecutionMask* mask);
+        //! index of the first following task not under mask or its nested
+        //! masks, to which the execution jumps if mask is disabled
+        MGB_IF_COND_EXEC(size_t mask_end = 0);
 
         TaskSeqElem(
                 Task task_,
@@ -35,7 +38,8 @@ class NormalExecEnv final : public GraphExecutable::ExecEnv {
         // add noexcept so it can be moved in vector
         TaskSeqElem(TaskSeqElem&& rhs) noexcept
                 : task{std::move(rhs.task)},
-                  opr{rhs.opr} MGB_IF_COND_EXEC(, mask{rhs.mask}) {}
+                  opr{rhs.opr} MGB_IF_COND_EXEC(, mask{rhs.mask})
+                          MGB_IF_COND_EXEC(, mask_end{rhs.mask_end}) {}
 
         TaskSeqElem& operator=(const TaskSeqElem&) = default;
 
@@ -43,6 +47,7 @@ class NormalExecEnv final : public GraphExecutable::ExecEnv {
             task = std::move(rhs.task);
             opr = rhs.opr;
             MGB_IF_COND_EXEC(mask = rhs.mask);
+            MGB_IF_COND_EXEC(mask_end = rhs.mask_end);
             return *this;
         }
     };
@@ -63,6 +68,8 @@ class NormalExecEnv final : public GraphExecutable::ExecEnv {
     OperatorNodeBase* m_cur_active_opr = nullptr;
     MGB_IF_COND_EXEC(ExecutionMask* m_cur_active_opr_mask = nullptr);
     MGB_IF_COND_EXEC(bool m_has_exec_mask = false);
+    //! whether TaskSeqElem::mask_end of the task seqs is up to date
+    MGB_IF_COND_EXEC(bool m_mask_end_valid = false);
 
     inline void wait_resume_if_paused();
 
@@ -74,6 +81,12 @@ class NormalExecEnv final : public GraphExecutable::ExecEnv {
     template <bool check_exec_pause, bool check_exec_mask>
     void run_task_seq_impl(const TaskSeq& seq);
 
+#if MGB_ENABLE_COND_EXEC
+    //! setup TaskSeqElem::mask_end so the tasks of a disabled branch are
+    //! skipped at once
+    static void init_mask_end(TaskSeq& seq);
+#endif
+
 public:
     //! see ComputingGraph::Options::async_exec_level
     void set_async_level(int level) {
@@ -20,10 +20,14 @@
 #include "megbrain/graph/operator_node.h"
 
 #include "megbrain/utils/hash.h"
+#include "megbrain/utils/mempool.h"
 #include "megbrain/utils/metahelper.h"
+#include "megbrain/utils/thread_local.h"
 
 #include "megbrain/plugin/var_sanity_check.h"
 
+#include <atomic>
+
 using namespace mgb;
 using namespace cg;
 
@@ -80,8 +84,72 @@ bool GraphExecutable::ExecDependency::has_runtime_check() const {
 
 void GraphExecutable::ExecDependency::do_runtime_check() {}
 
+/* ===================== OprMemArenaScope =====================  */
+
+class OprMemArenaScope::Arena {
+    MemArena m_storage;
+    //! number of live oprs plus one for the scope
+    std::atomic_size_t m_refcnt{1};
+
+public:
+    void* alloc(size_t size) {
+        ++m_refcnt;
+        return m_storage.alloc(size);
+    }
+
+    void unref() {
+        if (!--m_refcnt) {
+            delete this;
+        }
+    }
+};
+
+namespace {
+#if MGB_HAVE_THREAD
+MGB_THREAD_LOCAL_PTR(OprMemArenaScope::Arena) tl_cur_opr_mem_arena = nullptr;
+#else
+OprMemArenaScope::Arena* tl_cur_opr_mem_arena = nullptr;
+#endif
+
+//! each opr storage is prefixed by the arena it was allocated from, or null
+//! if it is allocated from the heap
+constexpr size_t OPR_STORAGE_HEADER_SIZE = alignof(std::max_align_t);
+static_assert(OPR_STORAGE_HEADER_SIZE >= sizeof(void*), "bad header size");
+}  // anonymous namespace
+
+OprMemArenaScope::OprMemArenaScope()
+        : m_arena{new Arena}, m_prev_arena{tl_cur_opr_mem_arena} {
+    tl_cur_opr_mem_arena = m_arena;
+}
+
+OprMemArenaScope::~OprMemArenaScope() noexcept {
+    mgb_assert(tl_cur_opr_mem_arena == m_arena);
+    tl_cur_opr_mem_arena = m_prev_arena;
+    m_arena->unref();
+}
+
 /* ===================== OperatorNodeBase =====================  */
 
+void* OperatorNodeBase::operator new(size_t size) {
+    OprMemArenaScope::Arena* arena = tl_cur_opr_mem_arena;
+    size += OPR_STORAGE_HEADER_SIZE;
+    void* ptr = arena ? arena->alloc(size) : ::operator new(size);
+    *static_cast<OprMemArenaScope::Arena**>(ptr) = arena;
+    return static_cast<uint8_t*>(ptr) + OPR_STORAGE_HEADER_SIZE;
+}
+
+void OperatorNodeBase::operator delete(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto raw = static_cast<uint8_t*>(ptr) - OPR_STORAGE_HEADER_SIZE;
+    if (auto arena = *reinterpret_cast<OprMemArenaScope::Arena**>(raw)) {
+        arena->unref();
+    } else {
+        ::operator delete(raw);
+    }
+}
+
 OperatorNodeBase::OperatorNodeBase(
         ComputingGraph* owner, const OperatorNodeConfig& config,
         const std::string& default_name, const VarNodeArrayView& input_var_naming)
@@ -13,6 +13,7 @@
 #include "./cg_impl.h"
 #include "./var_node_mem_mgr.h"
 
+#include <algorithm>
 #include <queue>
 
 using namespace mgb;
@@ -23,6 +24,7 @@ void SeqCompNodeOptimizerImpl::optimize_comp_nodes(const VarNodeArray& endpoints
             m_comp_node_to_restore.empty() && m_comp_node_changed_oprs.empty(),
             "restore_comp_nodes not called");
     change_to_specific_stream(endpoints);
+    spread_cpu_oprs_to_streams(endpoints);
 
     for (auto&& i : m_comp_node_to_restore) {
         auto opr = i.first->owner_opr();
@@ -48,10 +50,14 @@ void SeqCompNodeOptimizerImpl::var_to_specific_stream(VarNode* var, const int st
         return;
     if (!old_cn.contain_flag(CompNode::Flag::HAS_COPY_STREAM))
         return;
-    auto new_cn = old_cn.change_stream(stream);
-    mgb_assert(old_cn != new_cn);
+    var_to_comp_node(var, old_cn.change_stream(stream));
+}
+
+void SeqCompNodeOptimizerImpl::var_to_comp_node(VarNode* var, CompNode cn) {
+    auto old_cn = var->comp_node();
+    mgb_assert(old_cn != cn);
     m_comp_node_to_restore.emplace_back(var, old_cn);
-    var->comp_node(new_cn);
+    var->comp_node(cn);
 }
 
 void SeqCompNodeOptimizerImpl::change_to_specific_stream(
@@ -173,6 +179,96 @@ void SeqCompNodeOptimizerImpl::change_to_specific_stream(
     }
 }
 
+void SeqCompNodeOptimizerImpl::spread_cpu_oprs_to_streams(
+        const VarNodeArray& endpoints) {
+    auto&& options = m_owner_graph->options();
+    size_t nr_stream = options.seq_opt.cpu_opr_parallel_streams;
+    if (nr_stream <= 1 || !options.seq_opt.enable_seq_comp_node_opt) {
+        return;
+    }
+    if (options.comp_node_seq_record_level) {
+        mgb_log_warn(
+                "cpu_opr_parallel_streams is ignored because "
+                "comp_node_seq_record_level is set");
+        return;
+    }
+
+    ThinHashSet<VarNode*> moved_vars;
+    for (auto&& i : m_comp_node_to_restore) {
+        moved_vars.insert(i.first);
+    }
+
+    // returns the comp node shared by all outputs if the opr can be moved
+    auto get_movable_cn = [&](OperatorNodeBase* opr) -> Maybe<CompNode> {
+        if (opr->node_prop().contain(
+                    OperatorNodeBase::NodeProp::Flag::DISALLOW_COMP_NODE_OPTIMIZE) ||
+            opr->input().empty()) {
+            // source oprs usually own storage bound to their comp node
+            return None;
+        }
+        CompNode cn = opr->output(0)->comp_node();
+        auto&& loc = cn.locator();
+        // cpu:default runs in the caller thread and multithread comp nodes on
+        // the same device share one worker queue, so only cpuX is handled
+        if (loc.type != CompNode::DeviceType::CPU || loc.device < 0) {
+            return None;
+        }
+        for (auto i : opr->output()) {
+            if (i->comp_node() != cn || moved_vars.count(i)) {
+                return None;
+            }
+        }
+        for (auto i : opr->input()) {
+            if (i->comp_node().locator().type != CompNode::DeviceType::CPU) {
+                return None;
+            }
+        }
+        return cn;
+    };
+
+    // oprs are assigned to lanes in topological order: an opr continues the
+    // lane of the first input opr whose lane has not been taken by another
+    // reader, and otherwise (i.e. on a fork or a new source) starts on the
+    // least loaded lane; lane 0 is the original stream
+    ThinHashMap<OperatorNodeBase*, size_t> opr2lane;
+    ThinHashSet<OperatorNodeBase*> lane_taken;
+    std::vector<size_t> lane_load(nr_stream, 0);
+    auto cb = [&](OperatorNodeBase* opr) {
+        auto cn = get_movable_cn(opr);
+        if (!cn.valid()) {
+            return;
+        }
+        Maybe<size_t> lane;
+        for (auto i : opr->input()) {
+            auto iter = opr2lane.find(i->owner_opr());
+            if (iter != opr2lane.end() && lane_taken.insert(iter->first).second) {
+                lane = iter->second;
+                break;
+            }
+        }
+        if (!lane.valid()) {
+            lane = static_cast<size_t>(
+                    std::min_element(lane_load.begin(), lane_load.end()) -
+                    lane_load.begin());
+        }
+        ++lane_load[lane.val()];
+        opr2lane[opr] = lane.val();
+        if (!lane.val()) {
+            return;
+        }
+        auto new_cn = cn->change_stream(
+                CPU_PARALLEL_STREAM_BASE + static_cast<int>(lane.val()));
+        for (auto i : opr->output()) {
+            var_to_comp_node(i, new_cn);
+        }
+    };
+
+    DepOprIter dep_iter{cb};
+    for (auto i : endpoints) {
+        dep_iter.add(i->owner_opr());
+    }
+}
+
 void SeqCompNodeOptimizerImpl::register_stream_var(
         VarNode* var, StreamPropType stream_prop_type) {
     int stream = stream_prop_type.stream;
@@ -217,12 +313,25 @@ void SeqCompNodeOptimizerImpl::init_ready_event(
     // waited for each comp node
     CompNode::UnorderedMap<VarNode*> vars_to_wait;
 
+    // the steps known to have finished on the comp node of a var when the var
+    // is ready; it is transitively closed since the knowledge of waited vars
+    // is merged, so a wait implies all the waits before it
+    ThinHashMap<VarNode*, CompNode::UnorderedMap<VarStep>> var2known;
+
     CompNode::UnorderedSet cur_used_cn;
     ThinHashMap<VarNode*, VarStep> var2step;
     size_t cur_step = 0;
 
     using OprNodeProp = OperatorNodeBase::NodeProp;
 
+    auto known_step = [&var2known](VarNode* var, CompNode cn) -> const VarStep* {
+        auto iter = var2known.find(var);
+        if (iter == var2known.end())
+            return nullptr;
+        auto step = iter->second.find(cn);
+        return step == iter->second.end() ? nullptr : &step->second;
+    };
+
     // init opr waiting spec and add waiter record
     for (OperatorNodeBase* opr : seq) {
         if (opr->node_prop().contain(
@@ -260,14 +369,35 @@ void SeqCompNodeOptimizerImpl::init_ready_event(
                      i.first->comp_node() != cn) ||
                     pdv_need_sync_host) {
                     auto step = var2step.at(i.first);
-                    auto ins = dep2step.insert({i.first->comp_node(), step});
+                    auto known = dep2step.find(i.first->comp_node());
                     // only wait for var if it is beyond currently known
                     // synchronized step
-                    if (ins.second || step > ins.first->second) {
-                        ins.first->second = step;
-                        vars_to_wait[i.first->comp_node()] = i.first;
+                    if (known != dep2step.end() && step <= known->second)
+                        continue;
+                    auto&& wait = vars_to_wait[i.first->comp_node()];
+                    if (!wait || step > var2step.at(wait)) {
+                        wait = i.first;
+                    }
+                }
+            }
+
+            // drop the vars known to have finished on the comp node of another
+            // waited var
+            for (auto iter = vars_to_wait.begin(); iter != vars_to_wait.end();) {
+                auto step = var2step.at(iter->second);
+                bool implied = false;
+                for (auto&& other : vars_to_wait) {
+                    auto known = known_step(other.second, iter->first);
+                    if (other.first != iter->first && known && *known >= step) {
+                        implied = true;
+                        break;
                     }
                 }
+                if (implied) {
+                    iter = vars_to_wait.erase(iter);
+                } else {
+                    ++iter;
+                }
             }
 
             if (!vars_to_wait.empty()) {
@@ -282,9 +412,15 @@ void SeqCompNodeOptimizerImpl::init_ready_event(
                 }
 
                 auto&& record = m_cnpair2opr_step[cn];
-                for (auto&& i : vars_to_wait) {
-                    auto step_done = var2step.at(i.second).first;
-                    auto&& seq = record[i.first];
+                auto update_known = [&](CompNode other_cn, VarStep step) {
+                    auto ins = dep2step.insert({other_cn, step});
+                    if (!ins.second) {
+                        if (step <= ins.first->second)
+                            return;
+                        ins.first->second = step;
+                    }
+                    auto step_done = step.first;
+                    auto&& seq = record[other_cn];
                     // for multi-output operator, there might be multiple other
                     // operators which depand on different output varnodes, and
                     // those output vars share the same opr step number
@@ -292,13 +428,32 @@ void SeqCompNodeOptimizerImpl::init_ready_event(
                     if (seq.empty() || step_done > seq.back().second) {
                         seq.emplace_back(cur_step, step_done);
                     }
+                };
+                for (auto&& i : vars_to_wait) {
+                    update_known(i.first, var2step.at(i.second));
+                    auto iter = var2known.find(i.second);
+                    if (iter != var2known.end()) {
+                        for (auto&& j : iter->second) {
+                            if (j.first != cn) {
+                                update_known(j.first, j.second);
+                            }
+                        }
+                    }
                 }
             }
         }
 
         opr->input_waiting_spec(std::move(waiting_spec));
         for (size_t i = 0; i < opr->output().size(); ++i) {
-            var2step[opr->output(i)] = {cur_step, i};
+            auto ovar = opr->output(i);
+            var2step[ovar] = {cur_step, i};
+            auto&& known = cnpair2step[ovar->comp_node()];
+            if (!known.empty()) {
+                auto&& dest = var2known[ovar];
+                for (auto&& j : known) {
+                    dest[j.first] = j.second;
+                }
+            }
         }
         cur_step++;
     }
@@ -44,7 +44,18 @@ class SeqCompNodeOptimizerImpl final : public SeqCompNodeOptimizer {
     //! m_comp_node_to_restore
     void var_to_specific_stream(VarNode* var, const int stream);
 
+    //! distribute independent oprs on cpu comp nodes to multiple streams so
+    //! they can run concurrently; see SeqOpt::cpu_opr_parallel_streams
+    void spread_cpu_oprs_to_streams(const VarNodeArray& endpoints);
+
+    //! change comp node of \p var to \p cn and record the original one
+    void var_to_comp_node(VarNode* var, CompNode cn);
+
 public:
+    //! streams used by spread_cpu_oprs_to_streams() are offset by this value
+    //! to avoid conflicting with the streams specified by user
+    static constexpr int CPU_PARALLEL_STREAM_BASE = 1 << 20;
+
     SeqCompNodeOptimizerImpl(ComputingGraphImpl* graph) : m_owner_graph(graph) {}
 
     void init_ready_event(const CompSeqExtraInfo& extra_info, const OprNodeArray& seq);
@@ -80,6 +80,10 @@ void SeqModifierForDTR::modify_endpoint_vars(VarNodeArray& endpoints) {
 void SeqModifierForDTR::ModifyActionPlanner::prepare(const OprNodeArray& opr_seq) {
     init_seq(opr_seq, false);
 
+    //! arithmetic intensity of a typical device, used to convert computation
+    //! into the equivalent memory traffic
+    static constexpr double FLOPS_PER_BYTE = 32;
+    OprFootprint footprint;
     for (size_t i = 0; i < seq().size(); ++i) {
         auto opr = seq()[i].get();
         size_t est = 0;
@@ -89,7 +93,9 @@ void SeqModifierForDTR::ModifyActionPlanner::prepare(const OprNodeArray& opr_seq
         for (auto i : opr->output) {
             est += i->size;
         }
-        opr->estimate_compute_time = static_cast<double>(est) / 1e8;
+        // oprs are bounded by either memory traffic or computation
+        double comp = footprint.get_computation(opr->orig_opr) / FLOPS_PER_BYTE;
+        opr->estimate_compute_time = std::max(static_cast<double>(est), comp) / 1e8;
     }
 }
 
@@ -104,6 +110,8 @@ SeqModifierForDTR::SeqModifyAction SeqModifierForDTR::ModifyActionPlanner::perfo
     }
 
     ThinHashSet<Var*> alive_vars;
+    //! alive vars that are large enough and could be recomputed
+    ThinHashSet<Var*> candidates;
     size_t cur_usage = 0;
     size_t cur_op_cnt = 0;
 
@@ -119,10 +127,15 @@ SeqModifierForDTR::SeqModifyAction SeqModifierForDTR::ModifyActionPlanner::perfo
         auto&& ins = alive_vars.insert(var);
         mgb_assert(ins.second);
         cur_usage += var->size;
+        if (var->size >= config->evictee_minimum_size &&
+            !is_bad_opr(var->owner_opr()->orig_opr)) {
+            candidates.insert(var);
+        }
     };
 
     auto remove_alive = [&](Var* var) {
         if (alive_vars.erase(var)) {
+            candidates.erase(var);
             auto size = var->size;
             mgb_assert(size <= cur_usage);
             cur_usage -= size;
@@ -232,9 +245,8 @@ SeqModifierForDTR::SeqModifyAction SeqModifierForDTR::ModifyActionPlanner::perfo
         dfs_back.clear();
         dfs_front.clear();
         dfs_mem.clear();
-        for (auto var : alive_vars) {
-            if (var->size < config->evictee_minimum_size || pin[var->orig_var] > 0 ||
-                is_bad_opr(var->owner_opr()->orig_opr)) {
+        for (auto var : candidates) {
+            if (pin[var->orig_var] > 0) {
                 continue;
             }
             double regen_t = regen_time(var);
@@ -21,10 +21,14 @@ using namespace cg;
 #include "megbrain/serialization/opr_shallow_copy.h"
 #include "megbrain/system.h"
 #include "megbrain/utils/arith_helper.h"
+#include "megbrain/utils/hash.h"
 #include "megbrain/utils/mempool.h"
+#include "megbrain/utils/persistent_cache.h"
 #include "megbrain/utils/timer.h"
 
+#include <cinttypes>
 #include <cmath>
+#include <cstring>
 #include <random>
 
 namespace {
@@ -505,6 +509,10 @@ class SeqModifierForSublinearMemory::ActionSearcherSingleCN {
     std::vector<std::future<void>> m_futures;
     std::mutex m_mtx;
 
+    //! PersistentCache category and key for the best split point set of
+    //! current opr seq; category is empty if the cache is disabled
+    std::string m_cache_category, m_cache_key;
+
     /*!
      * \brief check given thresh, and update states
      * \return bottleneck value for given thresh
@@ -525,6 +533,19 @@ class SeqModifierForSublinearMemory::ActionSearcherSingleCN {
     void search_genetic();
     void search_refine();
 
+    //! setup m_cache_category and m_cache_key from current opr seq
+    void init_plan_cache(CompNode comp_node);
+
+    /*!
+     * \brief try to load split point set from PersistentCache and evaluate
+     *      it to set the action
+     * \return whether a valid plan is found in the cache
+     */
+    bool load_cached_plan();
+
+    //! put m_best_sps into PersistentCache
+    void store_plan();
+
     static inline bool cmp_sps(const SplitPointSet& a, const SplitPointSet& b) {
         if (a->size() != b->size()) {
             return a->size() < b->size();
@@ -558,6 +579,9 @@ public:
         if (auto env = MGB_GETENV("MGB_SUBLINEAR_MEMORY_LOWER_BOUND_MB")) {
             m_config->lb_memory_mb = std::stoi(env);
         }
+        if (auto env = MGB_GETENV("MGB_SUBLINEAR_MEMORY_GENETIC_EARLY_STOP")) {
+            m_config->genetic_early_stop = std::stoi(env);
+        }
     }
 
     const SeqModifyAction& search(CompNode comp_node, const OprNodeArray* seq);
@@ -651,6 +675,8 @@ void SeqModifierForSublinearMemory::ActionSearcherSingleCN::search_genetic() {
     RNGxorshf rng(2333);
     size_t POOL_SIZE = m_par_modifier->m_config->genetic_pool_size;
     size_t NR_ITER = m_par_modifier->m_config->genetic_nr_iter;
+    size_t NR_EARLY_STOP = m_par_modifier->m_config->genetic_early_stop;
+    size_t nr_iter_no_improve = 0, prev_min_bottleneck = m_min_bottleneck;
     auto mutation = [&](const SplitPointSet& sps) {
         auto s = *sps;
         size_t length = s.size();
@@ -769,6 +795,17 @@ void SeqModifierForSublinearMemory::ActionSearcherSingleCN::search_genetic() {
             invoke_search(crossover(records[i].first, records[perm[i]].first));
         }
         wait_all();
+
+        if (m_min_bottleneck < prev_min_bottleneck) {
+            prev_min_bottleneck = m_min_bottleneck;
+            nr_iter_no_improve = 0;
+        } else if (NR_EARLY_STOP && ++nr_iter_no_improve >= NR_EARLY_STOP) {
+            mgb_log_debug(
+                    "sublinear memory genetic search stopped at iter %zu: no "
+                    "improvement in %zu iters",
+                    time, nr_iter_no_improve);
+            break;
+        }
     }
 }
 
@@ -811,6 +848,7 @@ void SeqModifierForSublinearMemory::ActionSearcherSingleCN::search_refine() {
             auto cur = planner->get_memory_bottleneck(split_point_set);
             if (cur >= lower_bound) {
                 planner->get_prev_action(m_action);
+                m_best_sps = make_split_point_set(*split_point_set);
                 flag = false;
             }
         };
@@ -837,16 +875,26 @@ const SeqModifierForSublinearMemory::SeqModifyAction& SeqModifierForSublinearMem
     RealTimer timer;
     m_best_thresh = m_min_bottleneck = std::numeric_limits<size_t>::max();
 
-    //! init search
-    invoke_search(m_best_thresh);
-    wait_all();
+    double t0 = 0, t1 = 0, t2 = 0;
+    init_plan_cache(comp_node);
+    if (load_cached_plan()) {
+        t0 = timer.get_msecs_reset();
+        mgb_log_debug(
+                "sublinear memory: use cached plan for comp_node=%s seq_len=%zu",
+                comp_node.to_string().c_str(), seq->size());
+    } else {
+        //! init search
+        invoke_search(m_best_thresh);
+        wait_all();
 
-    search_preset();
-    auto t0 = timer.get_msecs_reset();
-    search_genetic();
-    auto t1 = timer.get_msecs_reset();
-    search_refine();
-    auto t2 = timer.get_msecs_reset();
+        search_preset();
+        t0 = timer.get_msecs_reset();
+        search_genetic();
+        t1 = timer.get_msecs_reset();
+        search_refine();
+        t2 = timer.get_msecs_reset();
+        store_plan();
+    }
 
     std::sort(m_history.begin(), m_history.end());
     m_par_modifier->m_prev_min_bottleneck.at(comp_node) = m_min_bottleneck;
@@ -883,6 +931,91 @@ const SeqModifierForSublinearMemory::SeqModifyAction& SeqModifierForSublinearMem
     return m_action;
 }
 
+void SeqModifierForSublinearMemory::ActionSearcherSingleCN::init_plan_cache(
+        CompNode comp_node) {
+    m_cache_category.clear();
+    m_cache_key.clear();
+    auto config = m_par_modifier->m_config;
+    if (!config->enable_plan_cache)
+        return;
+
+    // the plan only depends on the topology and var sizes of the opr seq,
+    // which are hashed by position so the key is stable across processes
+    auto var2memsize = m_par_modifier->mem_opt().var2memsize();
+    ThinHashMap<VarNode*, std::pair<uint64_t, uint64_t>> var2pos;
+    XXHash hasher;
+    auto update = [&hasher](uint64_t v) { hasher.update(&v, sizeof(v)); };
+    auto&& seq = *m_cur_opr_seq;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        auto opr = seq[i];
+        auto name = opr->dyn_typeinfo()->name;
+        hasher.update(name, strlen(name));
+        update(opr->input().size());
+        for (auto inp : opr->input()) {
+            auto iter = var2pos.find(inp);
+            if (iter != var2pos.end()) {
+                update(iter->second.first);
+                update(iter->second.second);
+            } else {
+                update(std::numeric_limits<uint64_t>::max());
+                auto size_iter = var2memsize->find(inp);
+                update(size_iter == var2memsize->end() ? 0 : size_iter->second);
+            }
+        }
+        update(opr->output().size());
+        for (size_t j = 0; j < opr->output().size(); ++j) {
+            auto out = opr->output(j);
+            var2pos[out] = {i, j};
+            auto size_iter = var2memsize->find(out);
+            update(size_iter == var2memsize->end() ? 0 : size_iter->second + 1);
+        }
+    }
+
+    m_cache_category = "sublinear_memory_plan:v1:" +
+                       PersistentCache::make_category_from_comp_node(comp_node);
+    m_cache_key = ssprintf(
+            "%zu:%016" PRIx64 ":%d:%d:%d:%d", seq.size(), hasher.digest(),
+            config->thresh_nr_try, config->genetic_nr_iter,
+            config->genetic_pool_size, config->lb_memory_mb);
+}
+
+bool SeqModifierForSublinearMemory::ActionSearcherSingleCN::load_cached_plan() {
+    if (m_cache_category.empty())
+        return false;
+    auto value = PersistentCache::inst().get(
+            m_cache_category, {m_cache_key.data(), m_cache_key.size()});
+    if (!value.valid() || !value->size || value->size % sizeof(uint64_t))
+        return false;
+
+    // validate the cached split points, which must be strictly increasing
+    // and end at the last opr
+    auto seq_len = m_cur_opr_seq->size();
+    auto ptr = static_cast<const uint8_t*>(value->ptr);
+    auto sps = make_split_point_set();
+    for (size_t i = 0; i < value->size / sizeof(uint64_t); ++i) {
+        uint64_t v;
+        memcpy(&v, ptr + i * sizeof(uint64_t), sizeof(uint64_t));
+        if (v >= seq_len || (!sps->empty() && v <= sps->back()))
+            return false;
+        sps->push_back(v);
+    }
+    if (sps->back() != seq_len - 1)
+        return false;
+
+    invoke_search(std::move(sps));
+    wait_all();
+    return true;
+}
+
+void SeqModifierForSublinearMemory::ActionSearcherSingleCN::store_plan() {
+    if (m_cache_category.empty() || !m_best_sps || m_best_sps->empty())
+        return;
+    std::vector<uint64_t> value(m_best_sps->begin(), m_best_sps->end());
+    PersistentCache::inst().put(
+            m_cache_category, {m_cache_key.data(), m_cache_key.size()},
+            {value.data(), value.size() * sizeof(uint64_t)});
+}
+
 /* ====================  SeqModifierForSublinearMemory ====================  */
 void SeqModifierForSublinearMemory::InternalDeleter::operator()(
         ActionSearcherSingleCN* p) const {
@@ -36,6 +36,10 @@ namespace {
 constexpr size_t INFER_VALUE_SIZE_THRESH_FOR_WARNING = 1024,
                  INFER_VALUE_CHECK_UNCHANGE_MAX_SIZE = TensorLayout::MAX_NDIM;
 
+//! max number of src results memoized by CompSeqManager, and max size of src
+//! values in bytes to be memoized
+constexpr size_t SHAPE_MEMO_CAPACITY = 16, SHAPE_MEMO_MAX_VALUE_SIZE = 1024;
+
 constexpr bool is_static_infer_type(InferType::Flag t) {
     return t & (InferType::RT_STATIC | InferType::CONST);
 }
@@ -227,6 +231,15 @@ public:
     //! whether previous inference succeeds
     bool prev_infer_succeed() const { return m_infer_withoutexc_ret; }
 
+    /*!
+     * \brief mark current result as inferred from current deps, after the
+     *      results of all the traits are restored
+     *
+     * This must be called after TagShapeTrait::restore_shape() of all the
+     * restored traits, because the versions of the deps may change
+     */
+    void mark_restored();
+
     //! original deps given in the InferDesc by the caller
     virtual const DepVal& raw_deps() = 0;
 
@@ -257,6 +270,14 @@ protected:
         return m_deps.empty() && m_infer_type == InferType::RT_STATIC;
     }
 
+    //! called when the result is set without do_infer()
+    void on_result_restored(bool changed) {
+        if (changed) {
+            ++m_inp_element_version;
+            reset_inp_element_synced();
+        }
+    }
+
     /*!
      * \brief whether init() has been called (i.e. whether infer desc is
      *      set)
@@ -311,6 +332,11 @@ public:
         m_desc = desc;
         Super::init(desc.src_type, mgr);
     }
+
+    //! set the shape to a previous infer result with the same inputs
+    void restore_shape(const TensorShape& shp) {
+        on_result_restored(set_shape(shp) == InferResult::CHANGED);
+    }
 };
 
 //! mutable value inference
@@ -639,6 +665,16 @@ void StaticInferManagerImpl::TagTraitMutableBase::sync_from_var() {
     }
 }
 
+void StaticInferManagerImpl::TagTraitMutableBase::mark_restored() {
+    size_t run_id = 0;
+    for (auto dep : m_deps) {
+        run_id += dep->infer_result_version();
+    }
+    m_prev_inp_run_id = run_id;
+    m_infer_withoutexc_ret = &m_inp_element;
+    m_inp_element_synced = true;
+}
+
 void StaticInferManagerImpl::TagTraitMutableBase::reset_inp_element_synced() {
     if (!m_inp_element_synced) {
         return;
@@ -1083,6 +1119,8 @@ void CompSeqManager::add_dest(CompSeqExtraInfo& info, TagTraitBase* dest) {
 
 void CompSeqManager::reset_dest(CompSeqExtraInfo& info) {
     m_static_first_run = true;
+    m_shape_memo.clear();
+    m_shape_memo_next = 0;
     m_added.clear();
     m_static_infer_const_needed.clear();
     m_static_srcnode.clear();
@@ -1118,13 +1156,91 @@ bool CompSeqManager::update_static_check_shape_change() {
     if (!src_changed && !m_static_first_run)
         return false;
 
+    // the mid shapes only depend on the src results, so they are restored
+    // from the memo if the srcs have been seen before; mid values are always
+    // re-inferred, which is usually cheap
+    bool use_memo = !m_static_mid.empty() && make_shape_memo_key();
+    ShapeMemo* memo = nullptr;
+    if (use_memo) {
+        for (auto&& i : m_shape_memo) {
+            if (i.key == m_shape_memo_key) {
+                memo = &i;
+                break;
+            }
+        }
+    }
+    if (memo) {
+        for (size_t i = 0; i < m_static_mid.size(); ++i) {
+            auto trait = m_static_mid[i].trait();
+            if (trait->handler_type() == TagHandlerType::SHAPE) {
+                static_cast<StaticInferManagerImpl::TagShapeTrait*>(trait)
+                        ->restore_shape(memo->mid_shapes[i]);
+            }
+        }
+        for (auto&& i : m_static_mid) {
+            auto trait = i.trait();
+            if (trait->handler_type() == TagHandlerType::SHAPE) {
+                trait->as_mutable_safe()->mark_restored();
+            }
+        }
+    }
+
     for (auto&& i : m_static_mid) {
         shape_changed |= i.update(false).second;
     }
     m_static_first_run = false;
+
+    if (use_memo && !memo) {
+        ShapeMemo cur{m_shape_memo_key, {}};
+        cur.mid_shapes.reserve(m_static_mid.size());
+        for (auto&& i : m_static_mid) {
+            auto trait = i.trait();
+            cur.mid_shapes.emplace_back();
+            if (trait->handler_type() == TagHandlerType::SHAPE) {
+                cur.mid_shapes.back() = trait->infer(false, false)->shape();
+            }
+        }
+        if (m_shape_memo.size() < SHAPE_MEMO_CAPACITY) {
+            m_shape_memo.emplace_back(std::move(cur));
+        } else {
+            m_shape_memo[m_shape_memo_next] = std::move(cur);
+            m_shape_memo_next = (m_shape_memo_next + 1) % SHAPE_MEMO_CAPACITY;
+        }
+    }
     return shape_changed;
 }
 
+bool CompSeqManager::make_shape_memo_key() {
+    auto&& key = m_shape_memo_key;
+    key.clear();
+    auto append = [&key](const void* ptr, size_t size) {
+        key.append(static_cast<const char*>(ptr), size);
+    };
+    for (auto&& i : m_static_srcnode) {
+        auto trait = i.trait();
+        auto elem = trait->infer(false, false);
+        if (trait->handler_type() == TagHandlerType::SHAPE) {
+            auto&& shp = elem->shape();
+            append(&shp.ndim, sizeof(shp.ndim));
+            append(shp.shape, sizeof(shp.shape[0]) * shp.ndim);
+        } else {
+            auto&& val = elem->value();
+            auto&& layout = val.layout();
+            auto span = layout.span();
+            if (span.dist_byte() > SHAPE_MEMO_MAX_VALUE_SIZE) {
+                return false;
+            }
+            auto dtype = layout.dtype.enumv();
+            append(&dtype, sizeof(dtype));
+            append(&layout.ndim, sizeof(layout.ndim));
+            append(layout.shape, sizeof(layout.shape[0]) * layout.ndim);
+            append(layout.stride, sizeof(layout.stride[0]) * layout.ndim);
+            append(val.raw_ptr() + span.low_byte, span.dist_byte());
+        }
+    }
+    return true;
+}
+
 /* ===================== SubgraphStaticInferHelperImpl  ===================== */
 
 /*
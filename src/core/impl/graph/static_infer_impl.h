@@ -184,8 +184,22 @@ class CompSeqManager {
 
     bool m_static_first_run = false;
 
+    //! shapes of m_static_mid inferred from the src results serialized in
+    //! key; mid_shapes has empty shapes for value traits
+    struct ShapeMemo {
+        std::string key;
+        std::vector<TensorShape> mid_shapes;
+    };
+    std::vector<ShapeMemo> m_shape_memo;
+    size_t m_shape_memo_next = 0;  //!< entry to be replaced when full
+    std::string m_shape_memo_key;
+
     void add_dest(CompSeqExtraInfo& info, TagTraitBase* dest);
 
+    //! serialize current src results into m_shape_memo_key; return false
+    //! if any src value is too large to be memoized
+    bool make_shape_memo_key();
+
 public:
     CompSeqManager(ComputingGraph* graph);
     ~CompSeqManager() noexcept;
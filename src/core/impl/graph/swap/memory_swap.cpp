@@ -486,6 +486,45 @@ void MemorySwap::modify_dest_var_inplace(VarNodeArray& vars) {
     } else {
         m_lb_for_distance = std::min(m_lb_for_distance, (long long)opr_seq.size() / 20);
     }
+
+    auto env_prefetch = MGB_GETENV("MGB_MEMORY_SWAP_PARAM_PREFETCH");
+    if (env_prefetch) {
+        int tmp;
+        sscanf(env_prefetch, "%d", &tmp);
+        mgb_assert(tmp == 0 || tmp == 1);
+        m_prefetch = tmp & 1;
+    }
+
+    auto env_prefetch_max_ahead =
+            MGB_GETENV("MGB_MEMORY_SWAP_PARAM_PREFETCH_MAX_AHEAD");
+    if (env_prefetch_max_ahead) {
+        sscanf(env_prefetch_max_ahead, "%d", &m_prefetch_max_ahead);
+        mgb_assert(m_prefetch_max_ahead > 0);
+    }
+
+    auto env_h2d_bandwidth = MGB_GETENV("MGB_MEMORY_SWAP_PARAM_H2D_BANDWIDTH");
+    if (env_h2d_bandwidth) {
+        sscanf(env_h2d_bandwidth, "%lf", &m_cpu_gpu_bandwidth);
+        mgb_assert(m_cpu_gpu_bandwidth > 0);
+    }
+
+    auto env_device_bandwidth =
+            MGB_GETENV("MGB_MEMORY_SWAP_PARAM_DEVICE_BANDWIDTH");
+    if (env_device_bandwidth) {
+        sscanf(env_device_bandwidth, "%lf", &m_device_bandwidth);
+        mgb_assert(m_device_bandwidth > 0);
+    }
+
+    auto env_opr_latency = MGB_GETENV("MGB_MEMORY_SWAP_PARAM_OPR_LATENCY");
+    if (env_opr_latency) {
+        sscanf(env_opr_latency, "%lf", &m_opr_latency);
+        mgb_assert(m_opr_latency + 1e-12 > 0);
+    }
+
+    if (m_bucket_implement && m_prefetch) {
+        mgb_log_warn("memory swap prefetch is not supported in bucket mode");
+        m_prefetch = false;
+    }
     if (!m_bucket_implement)
         m_swap_in_prev = 1;
 
@@ -703,6 +742,10 @@ void MemorySwap::modify_dest_var_inplace(VarNodeArray& vars) {
     }
 
     int fail_counter = 0;
+    size_t nr_prefetch = 0;
+    double tot_transfer = 0, tot_stall = 0;
+    if (m_prefetch)
+        estimate_opr_time(opr_seq);
     for (auto x : fuse_swap) {
         sort((x.second).begin(), (x.second).end(),
              [&](const size_t& lhs, const size_t& rhs) {
@@ -710,8 +753,21 @@ void MemorySwap::modify_dest_var_inplace(VarNodeArray& vars) {
              });
         for (size_t i = 0; i < x.second.size(); ++i) {
             int dep_idx = 0;
-            if (m_opr_seq_dist[x.second[i]] >= m_swap_in_prev)
-                dep_idx = opr_seq[m_opr_seq_dist[x.second[i]] - m_swap_in_prev]
+            long long ahead = m_swap_in_prev;
+            if (m_prefetch) {
+                auto var = m_var_map[x.first];
+                auto sz = var->dtype().size(
+                        m_owner_graph->static_infer_manager()
+                                .infer_shape(var)
+                                .total_nr_elems());
+                ahead = prefetch_distance(
+                        m_opr_seq_dist[x.first], m_opr_seq_dist[x.second[i]], sz,
+                        tot_stall);
+                ++nr_prefetch;
+                tot_transfer += sz / m_cpu_gpu_bandwidth;
+            }
+            if (m_opr_seq_dist[x.second[i]] >= ahead)
+                dep_idx = opr_seq[m_opr_seq_dist[x.second[i]] - ahead]
                                   ->output(0)
                                   ->id() +
                           1;
@@ -735,6 +791,14 @@ void MemorySwap::modify_dest_var_inplace(VarNodeArray& vars) {
         }
     }
 
+    if (nr_prefetch) {
+        mgb_log_debug(
+                "memory swap prefetch: %zu swap-in(s), estimated transfer time "
+                "%.3fms, hidden %.3fms, remaining stall %.3fms\n",
+                nr_prefetch, tot_transfer * 1e3, (tot_transfer - tot_stall) * 1e3,
+                tot_stall * 1e3);
+    }
+
     if (!cur.empty()) {
         ThinHashSet<size_t> tmp;
         tmp.insert(cur[0]->id());
@@ -821,6 +885,48 @@ void MemorySwap::modify_dest_var_inplace(VarNodeArray& vars) {
     rewriter.apply_inplace();
 }
 
+void MemorySwap::estimate_opr_time(const cg::OprNodeArray& opr_seq) {
+    auto&& infer_mgr = m_owner_graph->static_infer_manager();
+    auto traffic = [&](VarNode* var) -> size_t {
+        if (!cg::is_static_var_shape(var))
+            return 0;
+        auto shp = infer_mgr.infer_shape_fallible(var);
+        return shp ? var->dtype().size(shp->total_nr_elems()) : 0;
+    };
+    m_opr_time_prefix.resize(opr_seq.size() + 1);
+    m_opr_time_prefix[0] = 0;
+    for (size_t i = 0; i < opr_seq.size(); ++i) {
+        size_t bytes = 0;
+        for (auto inp : opr_seq[i]->input())
+            bytes += traffic(inp);
+        for (auto o : opr_seq[i]->output())
+            bytes += traffic(o);
+        m_opr_time_prefix[i + 1] =
+                m_opr_time_prefix[i] +
+                std::max(m_opr_latency, bytes / m_device_bandwidth);
+    }
+}
+
+int MemorySwap::prefetch_distance(
+        long long producer, long long consumer, size_t size, double& stall) {
+    mgb_assert(
+            producer < consumer &&
+            consumer < (long long)m_opr_time_prefix.size());
+    auto transfer = size / m_cpu_gpu_bandwidth;
+    // the swap-in starts after opr_seq[consumer - ahead], so that the oprs in
+    // (consumer - ahead, consumer) are overlapped with the transfer
+    long long ahead = 1;
+    auto hidden = [&]() {
+        return m_opr_time_prefix[consumer] -
+               m_opr_time_prefix[consumer - ahead + 1];
+    };
+    while (hidden() < transfer && ahead < m_prefetch_max_ahead &&
+           consumer - ahead - 1 > producer)
+        ++ahead;
+    stall += std::max(0.0, transfer - hidden());
+    return ahead;
+}
+
 VarNode* MemorySwap::apply_bucket(VarNode* lhs, VarNode* dep_node, VarNode* wait_dep) {
     if (m_swap_map.find(lhs) != m_swap_map.end()) {
         if (m_swap_map[lhs].find(dep_node) != m_swap_map[lhs].end()) {
@@ -908,12 +1014,18 @@ VarNode* MemorySwap::apply(
         }
     }
     auto graph = lhs->owner_opr()->owner_graph();
+    OperatorNodeConfig swap_in_config;
+    if (m_prefetch) {
+        swap_in_config.comp_node(
+                lhs->comp_node().change_stream(CompNode::Stream::LOOP_SWAP));
+    }
     if (m_swap_out_map.find(lhs) == m_swap_out_map.end()) {
         HostTensorND tms(lhs->comp_node(), lhs->dtype());
         std::shared_ptr<HostTensorND> tmp;
         tmp = std::make_shared<HostTensorND>(tms);
         auto internal = opr::SwapOut::make(*graph, lhs, {tmp}).node();
-        auto ret = opr::SwapIn::make(*graph, {internal, dep_node}, tmp, {}).node();
+        auto ret = opr::SwapIn::make(*graph, {internal, dep_node}, tmp, swap_in_config)
+                           .node();
         internal->owner_opr()->node_prop().attribute().priority =
                 std::numeric_limits<int>::min();
         ret->owner_opr()->node_prop().attribute().priority =
@@ -927,7 +1039,8 @@ VarNode* MemorySwap::apply(
         auto ret =
                 opr::SwapIn::make(
                         *graph, {internal, dep_node},
-                        (static_cast<SwapOut*>(internal->owner_opr()))->host_data(), {})
+                        (static_cast<SwapOut*>(internal->owner_opr()))->host_data(),
+                        swap_in_config)
                         .node();
         ret->owner_opr()->node_prop().attribute().priority =
                 std::numeric_limits<int>::min();
@@ -127,7 +127,32 @@ class MemorySwap {
      */
     size_t m_max_swap_out_var_size = 0;
 
-    const double m_cpu_gpu_bandwidth = 10000000000.0;
+    //! host-to-device bandwidth in bytes/s, used to estimate transfer time
+    double m_cpu_gpu_bandwidth = 10000000000.0;
+
+    /*!
+     * prefetch mode (serial mode only): swap-in oprs are issued on a
+     * dedicated copy stream, and each of them is triggered early enough
+     * that the estimated computing time of the oprs in between covers its
+     * host-to-device transfer; m_swap_in_prev is ignored in this mode
+     */
+    bool m_prefetch = false;
+
+    //! maximum number of oprs a prefetching swap-in may be issued ahead
+    int m_prefetch_max_ahead = 50;
+
+    /*!
+     * cost model of oprs used by prefetch: each opr is assumed to be memory
+     * bound, and takes max(m_opr_latency, traffic / m_device_bandwidth)
+     */
+    double m_device_bandwidth = 300000000000.0;
+    double m_opr_latency = 0.000005;
+
+    /*!
+     * prefix sum of estimated computing time of opr_seq, i.e.
+     * m_opr_time_prefix[i] is the time spent on opr_seq[0, i)
+     */
+    std::vector<double> m_opr_time_prefix;
 
     ComputingGraph* m_owner_graph;
     /*!
@@ -160,6 +185,19 @@ class MemorySwap {
     ThinHashMap<size_t, int> m_color;
     PSSSet m_swapped_pair;
 
+    //! fill m_opr_time_prefix by the cost model described above
+    void estimate_opr_time(const cg::OprNodeArray& opr_seq);
+
+    /*!
+     * number of oprs that the swap-in of a \p size bytes var consumed by
+     * opr_seq[consumer] should be triggered ahead; it would not be
+     * triggered before opr_seq[producer]
+     *
+     * \param[out] stall estimated transfer time that could not be hidden
+     */
+    int prefetch_distance(
+            long long producer, long long consumer, size_t size, double& stall);
+
     void determine_swap_edge(
             PIPSet& edges, size_t loss_idx, const cg::OprNodeArray& opr_seq,
             std::vector<std::vector<size_t>>&, std::vector<std::vector<size_t>>&);
@@ -16,6 +16,7 @@
 #include "megbrain/utils/arith_helper.h"
 
 #include <queue>
+#include <set>
 #include <tuple>
 
 using namespace mgb;
@@ -43,6 +44,10 @@ struct TopoSorter::NodeTrait {
     //! number of oprs that this opr depends on, modified during bfs
     size_t unresolved_dep_cnt = 0;
 
+    //! number of times this opr is ready but another opr is chosen in
+    //! bfs_make_seq_mem_aware()
+    size_t nr_postponed = 0;
+
     //! nodes that depend on this opr
     OprNodeArray receivers;
 
@@ -440,7 +445,11 @@ const OprNodeArray* TopoSorter::get_comp_seq(
         priority_remapper(dest, items.get(), t.size());
     }
 
-    bfs_make_seq();
+    if (m_owner_graph->options().seq_opt.enable_mem_aware_opr_order) {
+        bfs_make_seq_mem_aware();
+    } else {
+        bfs_make_seq();
+    }
 
     m_cur_extra_info = nullptr;
     m_state = nullptr;
@@ -528,25 +537,147 @@ void TopoSorter::bfs_make_seq() {
     }
 
     if (nr_node_to_add) {
-#if MGB_ENABLE_EXCEPTION
-        std::string msg{
-                "detected circular dependency during topo sort; "
-                "this is usually caused by simultaneous reading from a "
-                "variable and "
-                "its updated version. List of unresolved update var pairs:"};
-        for (auto&& i : state->var_force_update_dest) {
-            auto v0 = i.first, v1 = i.second;
-            if (std::max(
-                        state->opr_trait[v0->owner_opr()].pos,
-                        state->opr_trait[v1->owner_opr()].pos) == NodeTrait::NPOS) {
-                msg.append(ssprintf("\n%s, %s", v0->cname(), v1->cname()));
+        throw_circular_dep();
+    }
+}
+
+void TopoSorter::bfs_make_seq_mem_aware() {
+    using NP = OperatorNodeBase::NodeProp;
+    auto state = m_state;
+    auto&& infer_mgr = m_owner_graph->static_infer_manager();
+    size_t window = std::max<size_t>(
+            m_owner_graph->options().seq_opt.mem_aware_opr_order_window, 1);
+
+    // number of device value readers that have not been added to the seq,
+    // and static memory size (0 if unknown) of each var
+    ThinHashMap<VarNode*, size_t> var_nr_reader, var_size;
+    for (auto&& i : state->opr_trait) {
+        for (auto&& dep : i.first->node_prop().dep_map()) {
+            if (NP::is_device_value_dep(dep.second)) {
+                ++var_nr_reader[dep.first];
             }
         }
-        mgb_throw_raw(GraphError{msg});
+        for (auto var : i.first->output()) {
+            size_t size = 0;
+            if (!var->contain_flag(VarNode::Flag::NO_SYS_MEM_ALLOC)) {
+                if (auto shape = infer_mgr.infer_shape_fallible(var)) {
+                    size = var->dtype().size(shape->total_nr_elems());
+                }
+            }
+            var_size[var] = size;
+        }
+    }
+
+    // change of live memory if given opr is executed now
+    auto mem_delta = [&](OperatorNodeBase* opr) {
+        ptrdiff_t delta = 0;
+        for (auto var : opr->output()) {
+            auto iter = var_nr_reader.find(var);
+            if (iter != var_nr_reader.end() && iter->second) {
+                delta += var_size.at(var);
+            }
+        }
+        for (auto&& dep : opr->node_prop().dep_map()) {
+            auto var = dep.first;
+            if (NP::is_device_value_dep(dep.second) &&
+                var_nr_reader.at(var) == 1 &&
+                !var->contain_flag(VarNode::Flag::NO_MEM_RECLAIM)) {
+                delta -= var_size.at(var);
+            }
+        }
+        return delta;
+    };
+
+    struct OrderBefore {
+        bool operator()(const BFSQueueElem& a, const BFSQueueElem& b) const {
+            return a.order_before(b);
+        }
+    };
+    std::set<BFSQueueElem, OrderBefore> boundary_nodes;
+    size_t cur_timestamp = 0;
+    auto put_queue = [&](State::OprTraitIter node) {
+        boundary_nodes.insert({this, cur_timestamp, node});
+    };
+    for (auto i = state->opr_trait.begin(); i != state->opr_trait.end(); ++i) {
+        auto&& t = i->second;
+        mgb_assert(t.pos == NodeTrait::NPOS);
+        if (!t.unresolved_dep_cnt)
+            put_queue(i);
+    }
+    size_t nr_node_to_add = state->opr_trait.size();
+
+    while (!boundary_nodes.empty()) {
+        // only consider oprs with the same priority as the head in the first
+        // window; the head would be forced if it has been postponed too long
+        auto best = boundary_nodes.begin();
+        auto&& head_trait = best->trait_iter()->second;
+        if (head_trait.nr_postponed < window) {
+            ptrdiff_t best_delta = mem_delta(best->trait_iter()->first);
+            size_t nr = 1;
+            for (auto i = std::next(best); i != boundary_nodes.end() && nr < window;
+                 ++i, ++nr) {
+                auto iter = i->trait_iter();
+                if (iter->second.priority != head_trait.priority)
+                    break;
+                auto delta = mem_delta(iter->first);
+                if (delta < best_delta) {
+                    best = i;
+                    best_delta = delta;
+                }
+            }
+        }
+        for (auto i = boundary_nodes.begin(); i != best; ++i) {
+            ++i->trait_iter()->second.nr_postponed;
+        }
+
+        auto cur = best->trait_iter();
+        boundary_nodes.erase(best);
+        --nr_node_to_add;
+
+        auto&& node_trait = cur->second;
+        node_trait.pos = m_seq.size();
+        m_seq.push_back(cur->first);
+        for (auto&& dep : cur->first->node_prop().dep_map()) {
+            if (NP::is_device_value_dep(dep.second)) {
+                --var_nr_reader.at(dep.first);
+            }
+        }
+
+        ++cur_timestamp;
+        for (auto&& other_opr : node_trait.receivers) {
+            auto iter = state->opr_trait.find(other_opr);
+            mgb_assert(iter != state->opr_trait.end());
+            if ((--iter->second.unresolved_dep_cnt) == 0) {
+                put_queue(iter);
+            }
+        }
+    }
+
+    if (nr_node_to_add) {
+        throw_circular_dep();
+    }
+}
+
+void TopoSorter::throw_circular_dep() {
+#if MGB_ENABLE_EXCEPTION
+    auto state = m_state;
+    std::string msg{
+            "detected circular dependency during topo sort; "
+            "this is usually caused by simultaneous reading from a "
+            "variable and "
+            "its updated version. List of unresolved update var pairs:"};
+    for (auto&& i : state->var_force_update_dest) {
+        auto v0 = i.first, v1 = i.second;
+        if (std::max(
+                    state->opr_trait[v0->owner_opr()].pos,
+                    state->opr_trait[v1->owner_opr()].pos) == NodeTrait::NPOS) {
+            msg.append(ssprintf("\n%s, %s", v0->cname(), v1->cname()));
+        }
+    }
+    mgb_throw_raw(GraphError{msg});
 #else
-        mgb_trap();
+    mgb_trap();
 #endif
-    }
 }
 
 void TopoSorter::add_extra_comp_order_dep(OperatorNodeBase* opr, VarNode* var) {
@@ -78,6 +78,15 @@ private:
      */
     void bfs_make_seq();
 
+    /*!
+     * \brief like bfs_make_seq(), but greedily choose among ready oprs
+     *      to reduce peak memory; see SeqOpt::enable_mem_aware_opr_order
+     */
+    void bfs_make_seq_mem_aware();
+
+    //! throw an error describing the unresolved deps after bfs
+    [[noreturn]] void throw_circular_dep();
+
     /*!
      * \brief add computing order requriment on opr that var must finish
      *      before it
@@ -39,6 +39,20 @@ void MemAllocPlan::ReadonlyFwdList::insert_after(
     }
 }
 
+void MemAllocPlan::ReadonlyFwdList::insert_list_after(
+        const MemAllocPlan& prev, MemAllocPlan* self, MemAllocPlan* last) {
+    MGB_LOCK_GUARD(list_mutex);
+    auto&& last_list = last->m_readonly_fwd_list;
+    mgb_assert(!m_prev && !last_list.m_next);
+    auto next = prev.m_readonly_fwd_list.m_next;
+    prev.m_readonly_fwd_list.m_next = self;
+    m_prev = const_cast<MemAllocPlan*>(&prev);
+    last_list.m_next = next;
+    if (next) {
+        next->m_readonly_fwd_list.m_prev = last;
+    }
+}
+
 void MemAllocPlan::ReadonlyFwdList::remove_self() {
     MGB_LOCK_GUARD(list_mutex);
     if (m_prev) {
@@ -93,6 +107,29 @@ MemAllocPlan& MemAllocPlan::assign_for_forward(
     return *this;
 }
 
+MemAllocPlan& MemAllocPlan::move_chunk_into(
+        const MemAllocPlan& dest, const SubTensorSpec& sub) {
+    auto chk = m_chunk;
+    mgb_assert(
+            valid() && dest.valid() && chk == &m_chunk_storage && !m_offset_byte &&
+            chk != dest.m_chunk && m_layout.is_contiguous() &&
+            sub.layout().is_contiguous() && m_layout.eq_shape(sub.layout()));
+    size_t offset = dest.m_offset_byte + sub.offset_byte();
+    mgb_assert(offset + chk->size() <= dest.m_chunk->size());
+    // all the plans sharing the chunk follow its owner in the list
+    MemAllocPlan* last = this;
+    for (auto i = this; i; i = i->m_readonly_fwd_list.next()) {
+        mgb_assert(i->m_chunk == chk);
+        i->m_chunk = dest.m_chunk;
+        i->m_offset_byte += offset;
+        --chk->m_refcnt;
+        ++dest.m_chunk->m_refcnt;
+        last = i;
+    }
+    m_readonly_fwd_list.insert_list_after(dest, this, last);
+    return *this;
+}
+
 MemAllocPlan& MemAllocPlan::reset_from_owner_var() {
     auto owner_var = m_chunk_storage.owner_var;
     m_layout.dtype = dtype();
@@ -230,6 +267,15 @@ bool VarNode::set_fwd_in2out_readonly(VarNode* input, const SubTensorSpec& sub)
             .fwd_in2out_readonly(input, sub, this);
 }
 
+bool VarNode::set_fwd_out2in(VarNode* input, const SubTensorSpec& sub) {
+    if (owner_graph()->options().imperative_proxy_graph) {
+        return false;
+    }
+    return ComputingGraphImpl::downcast(owner_graph())
+            ->var_node_mem_manager()
+            .fwd_out2in(this, sub, input);
+}
+
 VarNode& VarNode::set_fwd_in2out_writable(VarNode* input) {
     ComputingGraphImpl::downcast(owner_graph())
             ->var_node_mem_manager()
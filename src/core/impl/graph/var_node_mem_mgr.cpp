@@ -258,6 +258,7 @@ VarNodeMemManager::VarNodeMemManager(ComputingGraphImpl* graph)
         m_asyn_var_releaser->wait_release_finish();
 #endif
         m_cpu_async_release_barrier.wait_zero();
+        m_var_dev_mem_defragmenter.on_exec_finish();
     };
 
     auto on_comp_seq_error = [this](const event::CompSeqExecError&) {
@@ -308,6 +309,7 @@ VarNodeMemManager::~VarNodeMemManager() noexcept = default;
 
 void VarNodeMemManager::VarNodeMemTrait::clear_opt_status() {
     readonly_src = nullptr;
+    fwd_out2in_dest = nullptr;
 }
 
 bool VarNodeMemManager::DynamicAllocOprInfo::check_if_mem_status_change() {
@@ -372,6 +374,8 @@ bool VarNodeMemManager::alloc_var_node_mem_static() {
     }
 
     auto time0 = timer.get_msecs();
+    m_owner_graph->event().signal_inplace<event::StartupPhaseFinished>(
+            "static_mem_plan", "", time0);
     make_static_var_tensor_from_alloc_plan();
 
     MGB_MARK_USED_VAR(time0);
@@ -1156,6 +1160,61 @@ bool VarNodeMemManager::fwd_in2out_readonly(
     return true;
 }
 
+bool VarNodeMemManager::fwd_out2in(
+        VarNode* dest, const SubTensorSpec& sub, VarNode* src) {
+    /*
+     * implemented by moving the chunk of src, together with the vars readonly
+     * forwarded from it, into the chunk of dest; the lifetime of the chunk
+     * is then extended by the static allocator to cover all of them
+     */
+
+    assert_in_mem_opt_phase(SeqMemOptimizer::Status::ALLOW_FWD_OUT2IN);
+    mgb_assert(
+            src != dest && dest->m_mem_plan.valid() && src->m_mem_plan.valid() &&
+            src->m_mem_plan.layout().eq_shape(sub.layout()));
+
+    if (!m_owner_graph->options().seq_opt.enable_mem_plan_opt)
+        return false;
+
+    // only statically allocated vars on the same comp node are considered,
+    // whose memory is not shared by force update
+    if (!m_sys_alloc_static_vars.count(src) || !m_sys_alloc_static_vars.count(dest) ||
+        src->comp_node() != dest->comp_node() ||
+        src->contain_flag(VarNode::Flag::VOLATILE_CONTENT)) {
+        return false;
+    }
+    auto&& src_spec = m_node_mem_trait.at(src);
+    auto&& dest_spec = m_node_mem_trait.at(dest);
+    if (src_spec.readonly_src || src_spec.fwd_out2in_dest ||
+        src_spec.force_update_src || src_spec.seq_force_update_dest ||
+        dest_spec.readonly_src || dest_spec.force_update_src ||
+        dest_spec.seq_force_update_dest) {
+        return false;
+    }
+
+    auto&& src_plan = src->m_mem_plan;
+    auto&& dest_plan = dest->m_mem_plan;
+    auto&& src_chk = src_plan.chunk();
+    auto&& dest_chk = dest_plan.chunk();
+    if (src_chk.owner_var != src || dest_chk.owner_var != dest ||
+        src_plan.offset_in_chunk_byte() || dest_plan.offset_in_chunk_byte() ||
+        !src_chk.size() || !src_chk.mem_alloc_status.is_invalid() ||
+        !dest_chk.mem_alloc_status.is_invalid()) {
+        return false;
+    }
+
+    // the producer of src would write into an aligned contiguous region
+    if (!src_plan.layout().is_contiguous() || !sub.layout().is_contiguous() ||
+        sub.offset_byte() % src->comp_node().get_mem_addr_alignment() ||
+        !src_spec.check_layout(sub.layout())) {
+        return false;
+    }
+
+    src_spec.fwd_out2in_dest = dest;
+    src_plan.move_chunk_into(dest_plan, sub);
+    return true;
+}
+
 void VarNodeMemManager::assert_in_mem_opt_phase(size_t status) {
     mgb_assert(
             m_seq_mem_opt.status() & status,
@@ -1204,6 +1263,10 @@ void VarNodeMemManager::fwd_in2out_writable(VarNode* src, VarNode* dest) {
         return;
     assert_in_mem_opt_phase(SeqMemOptimizer::Status::ALLOW_FWD_IN2OUT_WRITABLE);
     auto&& dest_spec = m_node_mem_trait.at(dest);
+    if (dest_spec.fwd_out2in_dest) {
+        // dest already resides in another var
+        return;
+    }
     mgb_assert(!dest_spec.readonly_src, "already readonly forwarded from other var");
 
     MemAllocPlan* plan0 = &src->m_mem_plan;
@@ -133,6 +133,10 @@ public:
          */
         VarNode *force_update_src = nullptr, *seq_force_update_dest = nullptr;
 
+        //! the var whose memory contains this var, see
+        //! VarNode::set_fwd_out2in
+        VarNode* fwd_out2in_dest = nullptr;
+
         LayoutConstraint layout_constraint;
 
         bool check_layout(const TensorLayout& layout) const;
@@ -278,6 +282,11 @@ public:
      */
     bool fwd_in2out_readonly(VarNode* src, const SubTensorSpec& sub, VarNode* dest);
 
+    /*!
+     * \brief see VarNode::set_fwd_out2in
+     */
+    bool fwd_out2in(VarNode* dest, const SubTensorSpec& sub, VarNode* src);
+
     /*!
      * \brief see VarNode::set_fwd_in2out_writable
      */
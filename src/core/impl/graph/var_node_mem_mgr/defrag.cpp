@@ -44,6 +44,13 @@ void VarDevMemDefragmenter::clear_all() {
     m_cninfo_map.clear();
 }
 
+void VarDevMemDefragmenter::on_exec_finish() {
+    MGB_LOCK_GUARD(m_mtx);
+    for (auto&& i : m_cninfo_map) {
+        i.second.incremental_moved = 0;
+    }
+}
+
 void VarDevMemDefragmenter::alloc_with_defrag(
         VarNode* var, DeviceTensorStorage& storage, size_t size) {
     CompNodeInfo* cninfo_ptr;
@@ -62,26 +69,53 @@ void VarDevMemDefragmenter::alloc_with_defrag(
     MGB_CATCH(MemAllocError&, {
         mgb_log_warn(
                 "memory allocation failed for var %s; try defragmenting", var->cname());
-        defrag(var, *cninfo_ptr, size);
-        alloc_direct(var, storage, size);
+        defrag(var, *cninfo_ptr, storage, size);
     });
 }
 
 void VarDevMemDefragmenter::defrag(
-        VarNode* req_var, const CompNodeInfo& cn_info, size_t extra_size) {
+        VarNode* req_var, CompNodeInfo& cn_info, DeviceTensorStorage& storage,
+        size_t extra_size) {
     // pause all other comp nodes before calling defrag_impl()
     auto exec_env =
             ComputingGraphImpl::downcast(req_var->owner_graph())->current_exec_env();
     mgb_assert(exec_env);
     exec_env->pause_exec();
     m_mem_mgr->owner_graph()->event().signal_inplace<event::BeforeMemDefrag>();
-    MGB_TRY { defrag_impl(req_var, cn_info, extra_size); }
+    bool done = false, incremental = false;
+    size_t moved = cn_info.incremental_moved;
+    MGB_TRY {
+        if (defrag_incremental(req_var, cn_info, extra_size)) {
+            incremental = true;
+            moved = cn_info.incremental_moved - moved;
+            MGB_TRY {
+                alloc_direct(req_var, storage, extra_size);
+                done = true;
+            }
+            MGB_CATCH(MemAllocError&, {
+                mgb_log_debug(
+                        "incremental var defragment is not enough for var %s",
+                        req_var->cname());
+            });
+        }
+        if (!done) {
+            incremental = false;
+            moved = defrag_impl(req_var, cn_info, extra_size);
+        }
+    }
     MGB_FINALLY(exec_env->resume_exec(););
+    if (!done) {
+        alloc_direct(req_var, storage, extra_size);
+    }
+
+    auto cn = req_var->comp_node();
+    m_mem_mgr->owner_graph()->event().signal_inplace<event::AfterMemDefrag>(
+            cn, incremental, moved, cn.get_mem_status_bytes().second,
+            cn.get_max_block_size_available());
 }
 
-void VarDevMemDefragmenter::defrag_impl(
-        VarNode* req_var, const CompNodeInfo& cn_info, size_t extra_size) {
-    ThinHashMap<MemAllocPlan::Chunk*, ChunkInfo> chunkinfo;
+size_t VarDevMemDefragmenter::collect_movable_chunks(
+        VarNode* req_var, const CompNodeInfo& cn_info, ChunkInfoMap& chunkinfo) {
     VarNodeSet non_movable_vars;
     if (!m_move_safe_oprs.count(req_var->owner_opr())) {
         // input and output vars of current opr can not be moved
@@ -102,6 +136,112 @@ void VarDevMemDefragmenter::defrag_impl(
         }
     }
 
+    size_t nr_refcnt_mismatch = 0;
+    for (decltype(chunkinfo.begin()) iter = chunkinfo.begin(), inext;
+         iter != chunkinfo.end(); iter = inext) {
+        inext = iter;
+        ++inext;
+        auto refcnt = iter->first->m_refcnt.load(std::memory_order_relaxed);
+        if (refcnt != iter->second.readers.size()) {
+            mgb_assert(refcnt > iter->second.readers.size());
+            ++nr_refcnt_mismatch;
+            chunkinfo.erase(iter);
+        }
+    }
+    return nr_refcnt_mismatch;
+}
+
+void VarDevMemDefragmenter::rebind_chunk(
+        MemAllocPlan::Chunk* chunk, const ChunkInfo& info,
+        const DeviceTensorStorage& storage) {
+    for (auto var : info.readers) {
+        auto&& mplan = var->mem_plan();
+        if (auto sub_off = mplan.offset_in_chunk_byte()) {
+            var->m_dev_tensor.reset(storage.sub(sub_off), mplan.layout());
+        } else {
+            var->m_dev_tensor.reset(storage, mplan.layout());
+        }
+        mgb_assert(var->dev_tensor_valid());
+    }
+    auto owner_var = chunk->owner_var;
+    if (!owner_var->mem_plan().valid()) {
+        owner_var->m_dev_tensor.reset(storage, owner_var->mem_plan().layout());
+    }
+}
+
+bool VarDevMemDefragmenter::defrag_incremental(
+        VarNode* req_var, CompNodeInfo& cn_info, size_t extra_size) {
+    auto limit = m_mem_mgr->owner_graph()->options().var_mem_defragment_incremental_limit;
+    if (cn_info.incremental_moved >= limit) {
+        return false;
+    }
+    ChunkInfoMap chunkinfo;
+    collect_movable_chunks(req_var, cn_info, chunkinfo);
+
+    auto cn = req_var->comp_node();
+    auto alignment = cn.get_mem_addr_alignment();
+
+    // pick the smallest chunk which, together with its adjacent free memory,
+    // is large enough for the request
+    MemAllocPlan::Chunk* best = nullptr;
+    size_t best_size = 0;
+    for (auto&& i : chunkinfo) {
+        auto size = get_aligned_power2(i.first->size(), alignment);
+        if (cn_info.incremental_moved + size > limit || (best && size >= best_size)) {
+            continue;
+        }
+        auto begin = reinterpret_cast<size_t>(
+                i.first->owner_var->m_dev_tensor.storage().ptr());
+        auto side = cn.get_free_left_and_right(begin, begin + i.first->size());
+        if (side.first + side.second + size >= extra_size) {
+            best = i.first;
+            best_size = size;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+
+    auto&& info = chunkinfo.at(best);
+    DeviceTensorStorage storage{cn};
+    MGB_TRY {
+        m_mem_mgr->static_device_memory_manager()->allocator().alloc_dynamic(
+                info.readers.at(0), storage, best->size());
+        storage.ptr();  // apply lazy alloc
+    }
+    MGB_CATCH(MemAllocError&, { return false; });
+
+    // wait all other comp nodes to avoid moved var being read; note that
+    // ExecEnv has been paused, so no new task would be dispatched
+    CompNode::sync_all();
+    auto copy_cn = cn;
+    if (cn.contain_flag(CompNode::Flag::HAS_COPY_STREAM)) {
+        copy_cn = cn.change_stream(CompNode::Stream::COPY);
+    }
+    {
+        auto dest = storage;
+        dest.comp_node(copy_cn);
+        dest.copy_from(best->owner_var->m_dev_tensor.storage(), best->size());
+    }
+    copy_cn.sync();
+
+    // the old storage is released after all the readers are rebound
+    rebind_chunk(best, info, storage);
+    cn_info.incremental_moved += best_size;
+    CompNode::try_coalesce_all_free_memory();
+    mgb_log_debug(
+            "incremental var defragment: vars=%zu size=%.3fMiB "
+            "current_free=%.3fMiB",
+            info.readers.size(), best_size / 1024.0 / 1024,
+            cn.get_mem_status_bytes().second / 1024.0 / 1024);
+    return true;
+}
+
+size_t VarDevMemDefragmenter::defrag_impl(
+        VarNode* req_var, const CompNodeInfo& cn_info, size_t extra_size) {
+    ChunkInfoMap chunkinfo;
+    auto nr_refcnt_mismatch = collect_movable_chunks(req_var, cn_info, chunkinfo);
+
     auto cn = req_var->comp_node();
 
     // here we do not need to handle exceptions and restore vars, since
@@ -109,43 +249,32 @@ void VarDevMemDefragmenter::defrag_impl(
     // vars would be re-allocated
 
     // release all memory
-    size_t tot_size = extra_size, nr_refcnt_mismatch = 0, nr_var = 0;
+    size_t tot_size = extra_size, nr_var = 0;
     auto alignment = cn.get_mem_addr_alignment();
-    for (decltype(chunkinfo.begin()) iter = chunkinfo.begin(), inext;
-         iter != chunkinfo.end(); iter = inext) {
-        inext = iter;
-        ++inext;
+    for (auto&& i : chunkinfo) {
+        tot_size += get_aligned_power2(i.first->size(), alignment);
+        nr_var += i.second.readers.size();
+        auto owner_var = i.first->owner_var;
+        auto&& tensor = owner_var->m_dev_tensor;
+        i.second.value.comp_node(cn)
+                .ensure_size(i.first->size())
+                .copy_from(tensor.storage(), i.first->size());
 
-        auto refcnt = iter->first->m_refcnt.load(std::memory_order_relaxed);
-        if (refcnt == iter->second.readers.size()) {
-            tot_size += get_aligned_power2(iter->first->size(), alignment);
-            nr_var += iter->second.readers.size();
-            auto owner_var = iter->first->owner_var;
-            auto&& tensor = owner_var->m_dev_tensor;
-            iter->second.value.comp_node(cn)
-                    .ensure_size(iter->first->size())
-                    .copy_from(tensor.storage(), iter->first->size());
-
-            // release memory of all readers
-            for (auto var : iter->second.readers) {
-                const_cast<DeviceTensorND&>(var->dev_tensor()).storage({});
-            }
-            // release memory of owner_var
-            auto&& mem_plan = owner_var->mem_plan();
-            if (!mem_plan.valid()) {
-                // mem_plan of owner_var was invalid here if all reader oprs
-                // of owner_var have already been executed, but its tensor
-                // storage should not be released until the refcnt of chunk
-                // decreasing to zero (see release_chunk() for more details)
-                mgb_assert(
-                        tensor.storage().comp_node_valid() &&
-                        tensor.layout().eq_layout(mem_plan.layout()));
-                tensor.storage({});
-            }
-        } else {
-            mgb_assert(refcnt > iter->second.readers.size());
-            ++nr_refcnt_mismatch;
-            chunkinfo.erase(iter);
+        // release memory of all readers
+        for (auto var : i.second.readers) {
+            const_cast<DeviceTensorND&>(var->dev_tensor()).storage({});
+        }
+        // release memory of owner_var
+        auto&& mem_plan = owner_var->mem_plan();
+        if (!mem_plan.valid()) {
+            // mem_plan of owner_var was invalid here if all reader oprs
+            // of owner_var have already been executed, but its tensor
+            // storage should not be released until the refcnt of chunk
+            // decreasing to zero (see release_chunk() for more details)
+            mgb_assert(
+                    tensor.storage().comp_node_valid() &&
+                    tensor.layout().eq_layout(mem_plan.layout()));
+            tensor.storage({});
         }
     }
 
@@ -170,22 +299,11 @@ void VarDevMemDefragmenter::defrag_impl(
         allocator.alloc_dynamic(i.second.readers.at(0), storage, i.first->size());
         storage.copy_from(i.second.value, i.first->size());
         offset += get_aligned_power2(i.first->size(), alignment);
-        for (auto var : i.second.readers) {
-            auto&& mplan = var->mem_plan();
-            if (auto sub_off = mplan.offset_in_chunk_byte()) {
-                var->m_dev_tensor.reset(storage.sub(sub_off), mplan.layout());
-            } else {
-                var->m_dev_tensor.reset(storage, mplan.layout());
-            }
-            mgb_assert(var->dev_tensor_valid());
-        }
-        auto owner_var = i.first->owner_var;
-        if (!owner_var->mem_plan().valid()) {
-            owner_var->m_dev_tensor.reset(storage, owner_var->mem_plan().layout());
-        }
+        rebind_chunk(i.first, i.second, storage);
     }
     mgb_assert(offset + extra_size == tot_size);
     cn.sync();  // wait copy finish before destructing host values
+    return offset;
 }
 
 #endif  // MGB_ENABLE_VAR_DEV_MEM_DEFRAGMENTER
@@ -37,8 +37,11 @@ private:
     struct CompNodeInfo {
         std::mutex mtx;
         VarNodeSet vars;
+        //! bytes relocated by incremental defragmenting in current execution
+        size_t incremental_moved = 0;
     };
     struct ChunkInfo;
+    using ChunkInfoMap = ThinHashMap<MemAllocPlan::Chunk*, ChunkInfo>;
 
     std::mutex m_mtx;
     CompNode::UnorderedMap<CompNodeInfo> m_cninfo_map;
@@ -53,16 +56,44 @@ private:
     void alloc_with_defrag(VarNode* var, DeviceTensorStorage& storage, size_t size);
 
     /*!
-     * \brief perform defragmenting
+     * \brief perform defragmenting and allocate storage for \p req_var
+     *
+     * Incremental defragmenting is tried first, and all movable vars would
+     * be moved if it does not make enough room.
      *
      * Note: lock must be held before entering this method
      * \param req_var the var that initiates this request
+     * \param storage tensor storage to be allocated for \p req_var
      * \param extra_size size needed to be allocated after defragmenting
-     * \return a tensor storage of \p extra_size
      */
-    void defrag(VarNode* req_var, const CompNodeInfo& cn_info, size_t extra_size);
+    void defrag(
+            VarNode* req_var, CompNodeInfo& cn_info, DeviceTensorStorage& storage,
+            size_t extra_size);
+
+    //! move all movable vars into a contiguous storage; return moved bytes
+    size_t defrag_impl(
+            VarNode* req_var, const CompNodeInfo& cn_info, size_t extra_size);
+
+    /*!
+     * \brief relocate the cheapest chunk whose release leaves a free region
+     *      of at least \p extra_size, within the per-execution limit given by
+     *      ComputingGraph::Options::var_mem_defragment_incremental_limit
+     * \return whether a chunk has been relocated
+     */
+    bool defrag_incremental(VarNode* req_var, CompNodeInfo& cn_info, size_t extra_size);
 
-    void defrag_impl(VarNode* req_var, const CompNodeInfo& cn_info, size_t extra_size);
+    /*!
+     * \brief find chunks on the comp node of \p req_var that can be moved,
+     *      i.e. all of their readers are managed by the defragmenter
+     * \return number of chunks ignored due to unknown readers
+     */
+    size_t collect_movable_chunks(
+            VarNode* req_var, const CompNodeInfo& cn_info, ChunkInfoMap& chunkinfo);
+
+    //! rebind the readers of \p chunk to \p storage
+    static void rebind_chunk(
+            MemAllocPlan::Chunk* chunk, const ChunkInfo& info,
+            const DeviceTensorStorage& storage);
 
 public:
     /*!
@@ -85,6 +116,10 @@ public:
 
     //! clear all registered vars
     void clear_all();
+
+    //! reset the relocation budget of incremental defragmenting; called after
+    //! each execution
+    void on_exec_finish();
 #else  // MGB_ENABLE_VAR_DEV_MEM_DEFRAGMENTER
 public:
     void alloc_var_storage(VarNode* var, DeviceTensorStorage& storage, size_t size) {
@@ -93,6 +128,8 @@ public:
 
     void clear_all() {}
 
+    void on_exec_finish() {}
+
     void register_var(VarNode*) {}
 
 #endif  // MGB_ENABLE_VAR_DEV_MEM_DEFRAGMENTER
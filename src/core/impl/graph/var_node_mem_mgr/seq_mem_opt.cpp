@@ -16,9 +16,14 @@
 #include "megbrain/graph/event.h"
 #include "megbrain/graph/exc_extra_info.h"
 #include "megbrain/graph/helper.h"
+#include "megbrain/graph/static_mem_plan.h"
 #include "megbrain/utils/arith_helper.h"
 #include "megbrain/utils/metahelper.h"
 
+#if MGB_HAVE_THREAD
+#include <future>
+#endif
+
 using namespace mgb;
 using namespace cg;
 
@@ -101,6 +106,12 @@ void SeqMemOptimizer::optimize_mem_plan() {
             }
         }
         opr = nullptr;
+        m_status = Status::ALLOW_FWD_OUT2IN;
+        for (auto i : oprs_to_run) {
+            opr = i;
+            opr->mem_plan_fwd_out2in();
+        }
+        opr = nullptr;
         m_status = Status::ALLOW_FWD_IN2OUT_WRITABLE;
         for (auto i : oprs_to_run) {
             opr = i;
@@ -202,12 +213,14 @@ bool SeqMemOptimizer::run_static_mem_alloc() {
                     dest.begin = idx;
                     dest.chunk = cur_chk;
                     dest.comp_node = i->comp_node();
-                    mgb_assert(cur_chk->owner_var == i);
+                    // a chunk may start with a var placed in its owner var
+                    auto&& trait = m_graph->var_node_mem_manager()
+                                           .get_var_node_mem_trait_at(i);
+                    mgb_assert(cur_chk->owner_var == i || trait.fwd_out2in_dest);
                 } else {
-                    // forwarded from another var
-                    mgb_assert(
-                            i->comp_node() == dest.comp_node &&
-                            cur_chk->owner_var != i);
+                    // forwarded from another var, or the owner of a chunk which
+                    // holds vars forwarded by fwd_out2in
+                    mgb_assert(i->comp_node() == dest.comp_node);
                 }
 
                 if (i->contain_flag(VarNode::Flag::NO_MEM_RECLAIM)) {
@@ -267,14 +280,56 @@ bool SeqMemOptimizer::run_static_mem_alloc() {
     StaticMemAllocLogger* logger = &fake_logger;
 #endif
 
-    bool ret = false;
+    std::vector<std::pair<CompNode, const std::vector<MemChunkLifeInterval>*>>
+            cn_chunks;
     for (auto&& i : group_by_cn) {
         auto cmp = [](const MemChunkLifeInterval& a, const MemChunkLifeInterval& b) {
             return a.begin < b.begin || (a.begin == b.begin && a.end < b.end);
         };
         // sort for stable order
         std::sort(i.second.begin(), i.second.end(), cmp);
-        ret |= run_static_mem_alloc_on_comp_node(i.first, i.second, *logger);
+        cn_chunks.emplace_back(i.first, &i.second);
+    }
+
+    // the allocations on different comp nodes are independent, and solving
+    // them dominates the compile time of large graphs with many comp nodes,
+    // so they are solved in parallel; the results are applied in order since
+    // the event handlers and the logger are not thread safe, and the solving
+    // stays on this thread if the thread local plan recorder is active
+    std::vector<std::unique_ptr<StaticMemAlloc>> allocators(cn_chunks.size());
+    auto solve = [&](size_t idx) {
+        allocators[idx] = solve_static_mem_alloc_on_comp_node(
+                cn_chunks[idx].first, *cn_chunks[idx].second);
+    };
+#if MGB_HAVE_THREAD
+    if (cn_chunks.size() > 1 && !StaticMemPlanCache::recording()) {
+        std::vector<std::future<void>> futures;
+        for (size_t i = 1; i < cn_chunks.size(); ++i) {
+            futures.emplace_back(std::async(std::launch::async, solve, i));
+        }
+        MGB_TRY { solve(0); }
+        MGB_FINALLY({
+            // wait for all the workers before rethrowing any of their errors,
+            // since they refer to local states
+            for (auto&& i : futures) {
+                i.wait();
+            }
+        });
+        for (auto&& i : futures) {
+            i.get();
+        }
+    } else
+#endif
+    {
+        for (size_t i = 0; i < cn_chunks.size(); ++i) {
+            solve(i);
+        }
+    }
+
+    bool ret = false;
+    for (size_t i = 0; i < cn_chunks.size(); ++i) {
+        ret |= run_static_mem_alloc_on_comp_node(
+                cn_chunks[i].first, *cn_chunks[i].second, *allocators[i], *logger);
     }
     logger->flush();
 
@@ -294,12 +349,13 @@ bool SeqMemOptimizer::run_static_mem_alloc() {
     return ret;
 }
 
-bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
-        CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks,
-        StaticMemAllocLogger& static_mem_alloc_logger) {
-    size_t size_ub = 0;
-
-    auto allocator = StaticMemAlloc::make(StaticMemAlloc::AllocatorAlgo::PUSHDOWN);
+std::unique_ptr<StaticMemAlloc> SeqMemOptimizer::solve_static_mem_alloc_on_comp_node(
+        CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks) {
+    auto allocator = StaticMemAlloc::make(
+            m_graph->options().seq_opt.profile_static_mem_alloc ||
+                            MGB_GETENV("MGB_STATIC_MEM_ALLOC_PROFILE")
+                    ? StaticMemAlloc::AllocatorAlgo::PROFILE
+                    : StaticMemAlloc::AllocatorAlgo::PUSHDOWN);
     allocator->alignment(comp_node.get_mem_addr_alignment());
     allocator->padding(comp_node.get_mem_padding());
 #if MGB_ENABLE_DEBUG_UTIL
@@ -312,7 +368,6 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
         auto id = allocator->add(chk.begin, chk.end, chk.chunk->size(), &chk);
         auto ins_rst = chunk2allocatorid.emplace(chk.chunk, id);
         mgb_assert(ins_rst.second);
-        size_ub += chk.chunk->size();
     }
 
     for (auto&& i : m_writable_fwd_mem_plans) {
@@ -333,7 +388,17 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
     }
 
     allocator->solve();
-    size_t size = allocator->tot_alloc(), size_lb = allocator->tot_alloc_lower_bound();
+    return allocator;
+}
+
+bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
+        CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks,
+        StaticMemAlloc& allocator, StaticMemAllocLogger& static_mem_alloc_logger) {
+    size_t size_ub = 0;
+    for (auto&& chk : chunks) {
+        size_ub += chk.chunk->size();
+    }
+    size_t size = allocator.tot_alloc(), size_lb = allocator.tot_alloc_lower_bound();
 
     static_mem_alloc_logger.push(comp_node, size, size_lb, size_ub);
 
@@ -345,7 +410,7 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
         m_static_mem_usage.val()[comp_node] = size;
         for (auto&& chk : chunks) {
             chk.chunk->mem_alloc_status.set_static_offset(
-                    allocator->get_start_addr(&chk));
+                    allocator.get_start_addr(&chk));
         }
 #ifndef __IN_TEE_ENV__
         auto& recorder = StaticMemRecorder::Instance();
@@ -16,6 +16,8 @@
 namespace mgb {
 namespace cg {
 
+class StaticMemAlloc;
+
 /*!
  * \brief Computing sequence memory optimizer.
  *
@@ -55,10 +57,19 @@ class SeqMemOptimizer {
     //! return as alloc_mem_chunk_storage
     bool run_static_mem_alloc();
 
-    //! return as alloc_mem_chunk_storage
+    /*!
+     * \brief solve the static memory allocation of the chunks on a comp node
+     *
+     * This only reads the graph, so it may be called for different comp
+     * nodes from multiple threads.
+     */
+    std::unique_ptr<StaticMemAlloc> solve_static_mem_alloc_on_comp_node(
+            CompNode cn, const std::vector<MemChunkLifeInterval>& chunks);
+
+    //! apply a solved allocation; return as alloc_mem_chunk_storage
     bool run_static_mem_alloc_on_comp_node(
             CompNode cn, const std::vector<MemChunkLifeInterval>& chunks,
-            StaticMemAllocLogger& static_mem_alloc_logger);
+            StaticMemAlloc& allocator, StaticMemAllocLogger& static_mem_alloc_logger);
 
 public:
     SeqMemOptimizer(ComputingGraphImpl* graph) : m_graph(graph) {}
@@ -86,7 +97,7 @@ public:
 
     /*!
      * \brief optimize mem_plan for var nodes by performing
-     *      readonly/writable forwarding
+     *      readonly/out2in/writable forwarding
      */
     void optimize_mem_plan();
 
@@ -116,7 +127,7 @@ public:
      */
     struct Status {
         static constexpr size_t ALLOW_FWD_IN2OUT_READONLY = 1,
-                                ALLOW_FWD_IN2OUT_WRITABLE = 2;
+                                ALLOW_FWD_IN2OUT_WRITABLE = 2, ALLOW_FWD_OUT2IN = 4;
     };
 
     /*!
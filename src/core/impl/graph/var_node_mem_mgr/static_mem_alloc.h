@@ -40,6 +40,10 @@ public:
 
         //! O(n log n) allocator with better performance
         PUSHDOWN,
+
+        //! run all the algorithms above and choose the one with lowest
+        //! memory usage; solved plans are added to StaticMemPlanCache
+        PROFILE,
     };
 
     static std::unique_ptr<StaticMemAlloc> make(AllocatorAlgo algo);
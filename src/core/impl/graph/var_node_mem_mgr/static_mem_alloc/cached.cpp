@@ -0,0 +1,140 @@
+/**
+ * \file src/core/impl/graph/var_node_mem_mgr/static_mem_alloc/cached.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./cached.h"
+#include "./impl.h"
+
+#include "megbrain/utils/hash.h"
+#include "megbrain/utils/timer.h"
+
+using namespace mgb;
+using namespace cg;
+
+size_t StaticMemAllocCached::add(
+        size_t begin, size_t end, size_t size, UserKeyType key) {
+    mgb_assert(begin < end);
+    auto id = m_interval.size();
+    m_interval.push_back({begin, end, size, key});
+    return id;
+}
+
+StaticMemAlloc& StaticMemAllocCached::add_overwrite_spec(
+        size_t iid_src, size_t iid_dest, size_t offset) {
+    mgb_assert(
+            iid_src != iid_dest && std::max(iid_src, iid_dest) < m_interval.size());
+    m_overwrite_spec.emplace_back(iid_src, iid_dest, offset);
+    return *this;
+}
+
+uint64_t StaticMemAllocCached::problem_hash() const {
+    std::vector<size_t> buf;
+    buf.reserve(4 + m_interval.size() * 3 + m_overwrite_spec.size() * 3);
+    buf.push_back(m_alignment);
+    buf.push_back(m_padding);
+    buf.push_back(m_interval.size());
+    for (auto&& i : m_interval) {
+        buf.push_back(i.begin);
+        buf.push_back(i.end);
+        buf.push_back(i.size);
+    }
+    buf.push_back(m_overwrite_spec.size());
+    for (auto&& i : m_overwrite_spec) {
+        buf.push_back(std::get<0>(i));
+        buf.push_back(std::get<1>(i));
+        buf.push_back(std::get<2>(i));
+    }
+    return XXHash{}.update(buf.data(), buf.size() * sizeof(size_t)).digest();
+}
+
+double StaticMemAllocCached::run_algo(AllocatorAlgo algo, Plan& plan) const {
+    auto allocator = StaticMemAllocImplHelper::make_solver(algo);
+    allocator->alignment(m_alignment);
+    allocator->padding(m_padding);
+#if MGB_ENABLE_DEBUG_UTIL
+    allocator->dbg_key2varnode = dbg_key2varnode;
+#endif
+    for (auto&& i : m_interval) {
+        allocator->add(i.begin, i.end, i.size, i.key);
+    }
+    for (auto&& i : m_overwrite_spec) {
+        allocator->add_overwrite_spec(std::get<0>(i), std::get<1>(i), std::get<2>(i));
+    }
+
+    RealTimer timer;
+    allocator->solve();
+    double time = timer.get_msecs();
+
+    plan.tot_alloc = allocator->tot_alloc();
+    plan.tot_alloc_lower_bound = allocator->tot_alloc_lower_bound();
+    plan.addr.resize(m_interval.size());
+    for (size_t i = 0; i < m_interval.size(); ++i) {
+        plan.addr[i] = allocator->get_start_addr(m_interval[i].key);
+    }
+    return time;
+}
+
+StaticMemAllocCached::Plan StaticMemAllocCached::profile_algos() const {
+    using Algo = AllocatorAlgo;
+    static const std::pair<Algo, const char*> algos[] = {
+            {Algo::PUSHDOWN, "PUSHDOWN"},
+#if !MGB_BUILD_SLIM_SERVING
+            {Algo::BEST_FIT, "BEST_FIT"},
+            {Algo::INTERVAL_MOVE, "INTERVAL_MOVE"},
+#endif
+    };
+
+    Plan best, cur;
+    const char* best_name = nullptr;
+    double best_time = 0;
+    std::string log;
+    for (auto&& algo : algos) {
+        double time = run_algo(algo.first, cur);
+        log += ssprintf(
+                "\n %14s: %10.2fMiB(%zubytes) in %.3fms", algo.second,
+                cur.tot_alloc / 1024.0 / 1024, cur.tot_alloc, time);
+        if (!best_name || cur.tot_alloc < best.tot_alloc ||
+            (cur.tot_alloc == best.tot_alloc && time < best_time)) {
+            best_name = algo.second;
+            best_time = time;
+            std::swap(best, cur);
+        }
+    }
+    mgb_log_debug(
+            "static mem alloc profile for %zu intervals:%s\n choose %s",
+            m_interval.size(), log.c_str(), best_name);
+    return best;
+}
+
+StaticMemAlloc& StaticMemAllocCached::solve() {
+    m_key2id.clear();
+    for (size_t i = 0; i < m_interval.size(); ++i) {
+        auto ins = m_key2id.insert({m_interval[i].key, i});
+        mgb_assert(ins.second, "duplicated user key");
+    }
+
+    auto&& cache = StaticMemPlanCache::inst();
+    auto hash = problem_hash();
+    if (!cache.get(hash, m_interval.size(), m_plan)) {
+        if (m_algo.valid()) {
+            run_algo(m_algo.val(), m_plan);
+        } else {
+            m_plan = profile_algos();
+        }
+        m_plan.hash = hash;
+        if (!m_algo.valid() || StaticMemPlanCache::recording()) {
+            cache.put(m_plan);
+        }
+    }
+    StaticMemPlanCache::on_plan_used(m_plan);
+    return *this;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,97 @@
+/**
+ * \file src/core/impl/graph/var_node_mem_mgr/static_mem_alloc/cached.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "../static_mem_alloc.h"
+
+#include "megbrain/common.h"
+#include "megbrain/graph/static_mem_plan.h"
+#include "megbrain/utils/metahelper.h"
+#include "megbrain/utils/thin/hash_table.h"
+
+#include <tuple>
+#include <vector>
+
+namespace mgb {
+namespace cg {
+
+/*!
+ * \brief allocator that looks up StaticMemPlanCache before solving
+ *
+ * If constructed without an algorithm (i.e. AllocatorAlgo::PROFILE), all the
+ * available algorithms are timed and the plan with lowest peak memory usage
+ * (faster solver on ties) is kept and added to the cache. Otherwise the given
+ * algorithm is used, and the solved plan is only added to the cache when a
+ * StaticMemPlanCache::Recorder is active.
+ */
+class StaticMemAllocCached final : public StaticMemAlloc {
+public:
+    explicit StaticMemAllocCached(Maybe<AllocatorAlgo> algo) : m_algo{algo} {}
+
+    size_t add(size_t begin, size_t end, size_t size, UserKeyType key) override;
+
+    StaticMemAlloc& add_overwrite_spec(
+            size_t iid_src, size_t iid_dest, size_t offset) override;
+
+    StaticMemAlloc& solve() override;
+
+    size_t tot_alloc() const override { return m_plan.tot_alloc; }
+
+    size_t tot_alloc_lower_bound() const override {
+        return m_plan.tot_alloc_lower_bound;
+    }
+
+    size_t get_start_addr(UserKeyType key) const override {
+        return m_plan.addr.at(m_key2id.at(key));
+    }
+
+    StaticMemAlloc& alignment(size_t alignment) override {
+        mgb_assert(!(alignment & (alignment - 1)));
+        m_alignment = alignment;
+        return *this;
+    }
+
+    StaticMemAlloc& padding(size_t padding) override {
+        m_padding = padding;
+        return *this;
+    }
+
+private:
+    using Plan = StaticMemPlanCache::Plan;
+
+    struct IntervalSpec {
+        size_t begin, end, size;
+        UserKeyType key;
+    };
+
+    Maybe<AllocatorAlgo> m_algo;
+    size_t m_alignment = 1, m_padding = 0;
+    std::vector<IntervalSpec> m_interval;
+    //! tuple of (src, dest, offset)
+    std::vector<std::tuple<size_t, size_t, size_t>> m_overwrite_spec;
+
+    Plan m_plan;
+    ThinHashMap<UserKeyType, size_t> m_key2id;
+
+    uint64_t problem_hash() const;
+
+    //! run given algorithm on the recorded problem and return solve time
+    double run_algo(AllocatorAlgo algo, Plan& plan) const;
+
+    //! run each algorithm and return the best plan
+    Plan profile_algos() const;
+};
+
+}  // namespace cg
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -12,6 +12,7 @@
 #include "./impl.h"
 #include "./best_fit.h"
 #include "./interval_move.h"
+#include "./cached.h"
 #include "./pushdown.h"
 
 #include <map>
@@ -379,6 +380,17 @@ void StaticMemAllocImplHelper::print_bottleneck_oprs(const T& time2event) {
 StaticMemAllocImplHelper::~StaticMemAllocImplHelper() noexcept = default;
 
 std::unique_ptr<StaticMemAlloc> StaticMemAlloc::make(AllocatorAlgo algo) {
+    if (algo == AllocatorAlgo::PROFILE) {
+        return std::make_unique<StaticMemAllocCached>(None);
+    }
+    if (StaticMemPlanCache::inst().active()) {
+        return std::make_unique<StaticMemAllocCached>(algo);
+    }
+    return StaticMemAllocImplHelper::make_solver(algo);
+}
+
+std::unique_ptr<StaticMemAlloc> StaticMemAllocImplHelper::make_solver(
+        AllocatorAlgo algo) {
     switch (algo) {
 #if !MGB_BUILD_SLIM_SERVING
         case AllocatorAlgo::INTERVAL_MOVE:
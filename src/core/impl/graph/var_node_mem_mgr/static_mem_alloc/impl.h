@@ -29,6 +29,9 @@ public:
 
     ~StaticMemAllocImplHelper() noexcept;
 
+    //! make an allocator that runs given algorithm without plan cache
+    static std::unique_ptr<StaticMemAlloc> make_solver(AllocatorAlgo algo);
+
     size_t add(size_t begin, size_t end, size_t size, UserKeyType key) override final;
 
     StaticMemAlloc& add_overwrite_spec(
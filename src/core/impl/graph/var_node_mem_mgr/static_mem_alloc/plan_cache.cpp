@@ -0,0 +1,129 @@
+/**
+ * \file src/core/impl/graph/var_node_mem_mgr/static_mem_alloc/plan_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/graph/static_mem_plan.h"
+#include "megbrain/common.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+using namespace mgb;
+using namespace cg;
+
+namespace {
+thread_local StaticMemPlanCache::Recorder* tl_recorder = nullptr;
+}  // anonymous namespace
+
+StaticMemPlanCache::Recorder::Recorder() : m_prev{tl_recorder} {
+    tl_recorder = this;
+}
+
+StaticMemPlanCache::Recorder::~Recorder() {
+    mgb_assert(tl_recorder == this);
+    tl_recorder = m_prev;
+}
+
+StaticMemPlanCache::StaticMemPlanCache() {
+    if (auto fpath = MGB_GETENV("MGB_STATIC_MEM_PLAN_CACHE")) {
+        m_fpath = fpath;
+        load_file();
+    }
+}
+
+StaticMemPlanCache& StaticMemPlanCache::inst() {
+    static StaticMemPlanCache cache;
+    return cache;
+}
+
+bool StaticMemPlanCache::active() const {
+    return m_nonempty || recording();
+}
+
+bool StaticMemPlanCache::recording() {
+    return tl_recorder;
+}
+
+void StaticMemPlanCache::on_plan_used(const Plan& plan) {
+    for (auto i = tl_recorder; i; i = i->m_prev) {
+        i->m_plans.push_back(plan);
+    }
+}
+
+bool StaticMemPlanCache::get(uint64_t hash, size_t nr_interval, Plan& plan) {
+    MGB_LOCK_GUARD(m_mtx);
+    auto iter = m_plans.find(hash);
+    if (iter == m_plans.end() || iter->second.addr.size() != nr_interval) {
+        return false;
+    }
+    plan = iter->second;
+    return true;
+}
+
+void StaticMemPlanCache::put(const Plan& plan, bool persist) {
+    MGB_LOCK_GUARD(m_mtx);
+    if (!m_plans.emplace(plan.hash, plan).second) {
+        return;
+    }
+    m_nonempty = true;
+    if (persist && !m_fpath.empty()) {
+        append_file(plan);
+    }
+}
+
+void StaticMemPlanCache::load_file() {
+    FILE* fin = fopen(m_fpath.c_str(), "r");
+    if (!fin) {
+        return;
+    }
+    for (;;) {
+        size_t nr;
+        Plan plan;
+        if (fscanf(fin, "%" SCNx64 " %zu %zu %zu", &plan.hash, &plan.tot_alloc,
+                   &plan.tot_alloc_lower_bound, &nr) != 4) {
+            break;
+        }
+        plan.addr.resize(nr);
+        bool ok = true;
+        for (auto&& i : plan.addr) {
+            if (fscanf(fin, "%zu", &i) != 1) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) {
+            mgb_log_warn("truncated static mem plan cache file %s", m_fpath.c_str());
+            break;
+        }
+        auto hash = plan.hash;
+        m_plans[hash] = std::move(plan);
+    }
+    fclose(fin);
+    m_nonempty = !m_plans.empty();
+    mgb_log_debug(
+            "loaded %zu static mem plans from %s", m_plans.size(), m_fpath.c_str());
+}
+
+void StaticMemPlanCache::append_file(const Plan& plan) {
+    FILE* fout = fopen(m_fpath.c_str(), "a");
+    if (!fout) {
+        mgb_log_warn("failed to open static mem plan cache file %s", m_fpath.c_str());
+        return;
+    }
+    fprintf(fout, "%" PRIx64 " %zu %zu %zu", plan.hash, plan.tot_alloc,
+            plan.tot_alloc_lower_bound, plan.addr.size());
+    for (auto i : plan.addr) {
+        fprintf(fout, " %zu", i);
+    }
+    fprintf(fout, "\n");
+    fclose(fout);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
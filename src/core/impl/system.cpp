@@ -13,6 +13,7 @@
 #include "megbrain/common.h"
 #include "megbrain/utils/thin/hash_table.h"
 
+#include <numeric>
 #include <thread>
 
 using namespace mgb;
@@ -45,6 +46,36 @@ void sys::set_cpu_affinity(const std::vector<int>& cpuset) {
     }
 }
 
+void sys::set_thread_low_priority() {
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST)) {
+        mgb_log_error("SetThreadPriority failed (error ignored)");
+    }
+}
+
+int sys::get_numa_node_count() {
+    return 1;
+}
+
+std::vector<int> sys::get_numa_node_cpus(int) {
+    std::vector<int> ret(get_cpu_count());
+    std::iota(ret.begin(), ret.end(), 0);
+    return ret;
+}
+
+bool sys::bind_memory_to_numa_node(void*, size_t, int) {
+    return false;
+}
+
+sys::HugePageMapping sys::map_huge_pages(size_t, size_t) {
+    return {};
+}
+
+void sys::unmap_huge_pages(const HugePageMapping&) {}
+
+size_t sys::get_huge_page_bytes(const std::vector<std::pair<const void*, size_t>>&) {
+    return 0;
+}
+
 std::pair<size_t, size_t> sys::get_ram_status_bytes() {
     MEMORYSTATUSEX statex;
     statex.dwLength = sizeof(statex);
@@ -63,7 +94,10 @@ std::pair<size_t, size_t> sys::get_ram_status_bytes() {
 #include <mach/mach_host.h>
 #else
 #include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <sys/sysinfo.h>
+#include <unistd.h>
 #endif
 
 void sys::set_cpu_affinity(const std::vector<int>& cpuset) {
@@ -85,6 +119,284 @@ void sys::set_cpu_affinity(const std::vector<int>& cpuset) {
 #endif
 }
 
+void sys::set_thread_low_priority() {
+#if defined(__APPLE__) || !MGB_HAVE_THREAD
+#pragma message("set_thread_low_priority not enabled on apple platform")
+#else
+    // nice value is a per-thread attribute on linux
+    auto err = setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+    if (err) {
+        mgb_log_error("failed to setpriority: %s (error ignored)", strerror(errno));
+    }
+#endif
+}
+
+#if defined(__linux__) && !defined(ANDROID) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+
+namespace {
+//! parse cpu list in sysfs like "0-3,8,10-11"
+std::vector<int> parse_cpu_list(const std::string& str) {
+    std::vector<int> ret;
+    size_t pos = 0;
+    while (pos < str.size()) {
+        auto end = str.find(',', pos);
+        if (end == std::string::npos) {
+            end = str.size();
+        }
+        auto item = str.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty() || !isdigit(item[0])) {
+            continue;
+        }
+        auto sep = item.find('-');
+        int begin = std::stoi(item.substr(0, sep)), last = begin;
+        if (sep != std::string::npos) {
+            last = std::stoi(item.substr(sep + 1));
+        }
+        for (int i = begin; i <= last; ++i) {
+            ret.push_back(i);
+        }
+    }
+    return ret;
+}
+}  // anonymous namespace
+
+int sys::get_numa_node_count() {
+    static int cnt = []() {
+        int ret = 0;
+        for (;; ++ret) {
+            auto path = ssprintf("/sys/devices/system/node/node%d/cpulist", ret);
+            if (access(path.c_str(), R_OK)) {
+                break;
+            }
+        }
+        return std::max(ret, 1);
+    }();
+    return cnt;
+}
+
+std::vector<int> sys::get_numa_node_cpus(int node) {
+    std::ifstream fin{ssprintf("/sys/devices/system/node/node%d/cpulist", node)};
+    std::string line;
+    std::vector<int> ret;
+    if (fin.good() && std::getline(fin, line)) {
+        ret = parse_cpu_list(line);
+    }
+    if (ret.empty()) {
+        ret.resize(get_cpu_count());
+        std::iota(ret.begin(), ret.end(), 0);
+    }
+    return ret;
+}
+
+bool sys::bind_memory_to_numa_node(void* ptr, size_t size, int node) {
+#ifdef __NR_mbind
+    constexpr int MPOL_BIND = 2;
+    constexpr size_t NR_MASK_BITS = sizeof(unsigned long) * 8;
+    if (node < 0 || node >= static_cast<int>(NR_MASK_BITS)) {
+        return false;
+    }
+    size_t page = sysconf(_SC_PAGESIZE);
+    auto begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) / page * page,
+         end = (reinterpret_cast<uintptr_t>(ptr) + size) / page * page;
+    if (begin >= end) {
+        return false;
+    }
+    unsigned long mask = 1ul << node;
+    auto err = syscall(
+            __NR_mbind, begin, end - begin, MPOL_BIND, &mask, NR_MASK_BITS + 1, 0);
+    if (err) {
+        mgb_log_debug(
+                "failed to bind memory to numa node %d: %s", node, strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    MGB_MARK_USED_VAR(ptr);
+    MGB_MARK_USED_VAR(size);
+    MGB_MARK_USED_VAR(node);
+    return false;
+#endif
+}
+
+sys::HugePageMapping sys::map_huge_pages(size_t size, size_t page_size) {
+    constexpr size_t PAGE_2MB = 2 << 20;
+    constexpr int HUGE_SHIFT = 26;
+    HugePageMapping ret;
+    if (!size) {
+        return ret;
+    }
+#ifdef MAP_HUGETLB
+    auto try_hugetlb = [&](size_t page, int log2_page) {
+        size_t mapped = (size + page - 1) / page * page;
+        //! the page size is encoded as MAP_HUGE_2MB or MAP_HUGE_1GB
+        auto ptr =
+                mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                             (log2_page << HUGE_SHIFT),
+                     -1, 0);
+        if (ptr == MAP_FAILED) {
+            return false;
+        }
+        ret.ptr = ptr;
+        ret.size = mapped;
+        ret.hugetlb = true;
+        return true;
+    };
+    if ((page_size == (1 << 30) && try_hugetlb(page_size, 30)) ||
+        try_hugetlb(PAGE_2MB, 21)) {
+        return ret;
+    }
+#else
+    MGB_MARK_USED_VAR(page_size);
+    MGB_MARK_USED_VAR(HUGE_SHIFT);
+#endif
+    //! transparent huge pages: over map by one page to align the start
+    size_t mapped = (size + PAGE_2MB - 1) / PAGE_2MB * PAGE_2MB;
+    auto raw =
+            mmap(nullptr, mapped + PAGE_2MB, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return ret;
+    }
+    auto begin = reinterpret_cast<uintptr_t>(raw),
+         aligned = (begin + PAGE_2MB - 1) / PAGE_2MB * PAGE_2MB;
+    if (aligned > begin) {
+        munmap(raw, aligned - begin);
+    }
+    if (auto tail = begin + PAGE_2MB - aligned) {
+        munmap(reinterpret_cast<void*>(aligned + mapped), tail);
+    }
+    ret.ptr = reinterpret_cast<void*>(aligned);
+    ret.size = mapped;
+#ifdef MADV_HUGEPAGE
+    if (madvise(ret.ptr, mapped, MADV_HUGEPAGE)) {
+        mgb_log_debug("failed to madvise huge pages: %s", strerror(errno));
+    }
+#endif
+    return ret;
+}
+
+void sys::unmap_huge_pages(const HugePageMapping& mapping) {
+    if (mapping.ptr) {
+        munmap(mapping.ptr, mapping.size);
+    }
+}
+
+size_t sys::get_huge_page_bytes(
+        const std::vector<std::pair<const void*, size_t>>& ranges) {
+    std::ifstream fin{"/proc/self/smaps"};
+    if (!fin.good()) {
+        return 0;
+    }
+    size_t ret = 0, overlap = 0, huge = 0;
+    auto flush = [&]() {
+        ret += std::min(overlap, huge);
+        overlap = huge = 0;
+    };
+    std::string line;
+    while (std::getline(fin, line)) {
+        unsigned long long begin, end;
+        char sep;
+        if (isxdigit(line[0]) && sscanf(line.c_str(), "%llx%c%llx", &begin, &sep,
+                                        &end) == 3 &&
+            sep == '-') {
+            //! the header of the next mapping
+            flush();
+            for (auto&& i : ranges) {
+                auto rbegin = reinterpret_cast<uintptr_t>(i.first),
+                     rend = rbegin + i.second;
+                auto lo = std::max<uintptr_t>(rbegin, begin),
+                     hi = std::min<uintptr_t>(rend, end);
+                if (lo < hi) {
+                    overlap += hi - lo;
+                }
+            }
+            continue;
+        }
+        if (!overlap) {
+            continue;
+        }
+        for (auto key :
+             {"AnonHugePages:", "FilePmdMapped:", "Shared_Hugetlb:",
+              "Private_Hugetlb:"}) {
+            size_t len = strlen(key);
+            if (!line.compare(0, len, key)) {
+                huge += std::stoull(line.substr(len)) * 1024;
+            }
+        }
+    }
+    flush();
+    return ret;
+}
+#else
+int sys::get_numa_node_count() {
+    return 1;
+}
+
+std::vector<int> sys::get_numa_node_cpus(int) {
+    std::vector<int> ret(get_cpu_count());
+    std::iota(ret.begin(), ret.end(), 0);
+    return ret;
+}
+
+bool sys::bind_memory_to_numa_node(void*, size_t, int) {
+    return false;
+}
+
+sys::HugePageMapping sys::map_huge_pages(size_t, size_t) {
+    return {};
+}
+
+void sys::unmap_huge_pages(const HugePageMapping&) {}
+
+size_t sys::get_huge_page_bytes(const std::vector<std::pair<const void*, size_t>>&) {
+    return 0;
+}
+#endif
+
+#if defined(__linux__) || defined(ANDROID) || defined(__ANDROID__)
+#include <fstream>
+#include <map>
+
+std::vector<std::vector<int>> sys::get_cpu_core_classes() {
+    static std::vector<std::vector<int>> ret = []() {
+        int nr = get_cpu_count();
+        std::map<long, std::vector<int>, std::greater<long>> freq2cpus;
+        for (int i = 0; i < nr; ++i) {
+            std::ifstream fin{ssprintf(
+                    "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i)};
+            long freq = 0;
+            if (!(fin >> freq) || freq <= 0) {
+                freq2cpus.clear();
+                break;
+            }
+            freq2cpus[freq].push_back(i);
+        }
+        std::vector<std::vector<int>> classes;
+        for (auto&& i : freq2cpus) {
+            classes.emplace_back(std::move(i.second));
+        }
+        if (classes.empty()) {
+            classes.emplace_back(nr);
+            std::iota(classes[0].begin(), classes[0].end(), 0);
+        }
+        return classes;
+    }();
+    return ret;
+}
+#else
+std::vector<std::vector<int>> sys::get_cpu_core_classes() {
+    std::vector<int> cpus(get_cpu_count());
+    std::iota(cpus.begin(), cpus.end(), 0);
+    return {cpus};
+}
+#endif
+
 #ifdef MGB_EXTERN_API_MEMSTAT
 extern "C" {
 void mgb_extern_api_memstat(size_t* tot, size_t* free);
@@ -484,17 +796,22 @@ class TimedFuncInvokerImpl final : public TimedFuncInvoker {
     }
 
     Maybe<Result> invoke(FuncId id, const Param& param, double timeout) override {
-        MGB_LOCK_GUARD(m_global_mtx);
+        std::unique_lock<MGB_MUTEX> lock{m_global_mtx};
         mgb_assert(timeout >= 0);
         auto iter = m_func_registry.find(id);
         mgb_assert(iter != m_func_registry.end(), "id %zu does not exist", id);
-        if (!timeout && !check_worker_alive())
+        // direct calls do not use the worker, so they can run concurrently
+        // (e.g. profiling on multiple devices)
+        if (!timeout && !check_worker_alive()) {
+            lock.unlock();
             return iter->second.direct_call(param);
+        }
 
         if (!m_fork_exec_impl) {
             mgb_log_warn(
                     "timeout is set, but no fork_exec_impl not given; "
                     "timeout would be ignored");
+            lock.unlock();
             return iter->second.direct_call(param);
         }
 
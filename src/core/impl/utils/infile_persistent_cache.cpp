@@ -0,0 +1,380 @@
+/**
+ * \file src/core/impl/utils/infile_persistent_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/utils/infile_persistent_cache.h"
+#include "megbrain/version.h"
+#include "megdnn/version.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mgb;
+
+namespace {
+
+constexpr char MAGIC[8] = {'m', 'g', 'b', 'c', 'a', 'c', 'h', 'e'};
+constexpr uint32_t FORMAT_VERSION = 2;
+
+class InputMemory {
+    const uint8_t* m_ptr;
+    size_t m_offset = 0;
+    size_t m_size;
+
+public:
+    InputMemory(const uint8_t* bin, size_t size) : m_ptr{bin}, m_size{size} {}
+
+    const uint8_t* read(size_t size) {
+        mgb_throw_if(
+                size > m_size - m_offset, MegBrainError,
+                "corrupted persistent cache: read %zu bytes at %zu of %zu", size,
+                m_offset, m_size);
+        auto ret = m_ptr + m_offset;
+        m_offset += size;
+        return ret;
+    }
+
+    uint32_t read_u32() {
+        uint32_t ret;
+        memcpy(&ret, read(sizeof(ret)), sizeof(ret));
+        return ret;
+    }
+
+    std::string read_str() {
+        auto size = read_u32();
+        return {reinterpret_cast<const char*>(read(size)), size};
+    }
+
+    size_t offset() const { return m_offset; }
+    size_t size() const { return m_size; }
+};
+
+void write_u32(std::vector<uint8_t>& dst, size_t val) {
+    mgb_assert(val <= std::numeric_limits<uint32_t>::max());
+    uint32_t v = val;
+    auto ptr = reinterpret_cast<const uint8_t*>(&v);
+    dst.insert(dst.end(), ptr, ptr + sizeof(v));
+}
+
+void write_blob(std::vector<uint8_t>& dst, const void* ptr, size_t size) {
+    write_u32(dst, size);
+    auto p = static_cast<const uint8_t*>(ptr);
+    dst.insert(dst.end(), p, p + size);
+}
+
+//! read a whole file; return false if it does not exist
+bool read_file(const std::string& path, std::vector<uint8_t>& dst) {
+    FILE* fin = fopen(path.c_str(), "rb");
+    if (!fin) {
+        return false;
+    }
+    fseek(fin, 0, SEEK_END);
+    long size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    dst.resize(std::max<long>(size, 0));
+    auto nr = dst.empty() ? 0 : fread(dst.data(), dst.size(), 1, fin);
+    fclose(fin);
+    mgb_assert(
+            size >= 0 && (dst.empty() || nr == 1), "failed to read %s",
+            path.c_str());
+    return true;
+}
+
+//! write to a temporary file and rename it to the destination
+void write_file_atomic(const std::string& path, const std::vector<uint8_t>& data) {
+    static std::atomic_size_t tmp_id{0};
+    auto tmp_path = ssprintf("%s.%d.%zu.tmp", path.c_str(), getpid(), tmp_id++);
+    FILE* fout = fopen(tmp_path.c_str(), "wb");
+    mgb_assert(fout, "failed to open %s: %s", tmp_path.c_str(), strerror(errno));
+    bool ok = data.empty() || fwrite(data.data(), data.size(), 1, fout) == 1;
+    ok = !fclose(fout) && ok;
+#ifdef WIN32
+    // rename() does not replace existing files on windows
+    if (ok) {
+        remove(path.c_str());
+    }
+#endif
+    ok = ok && !rename(tmp_path.c_str(), path.c_str());
+    if (!ok) {
+        auto err = errno;
+        remove(tmp_path.c_str());
+        mgb_throw(
+                MegBrainError, "failed to write persistent cache %s: %s",
+                path.c_str(), strerror(err));
+    }
+}
+
+//! exclusive lock of a file among processes
+class FileLock : public NonCopyableObj {
+#ifndef WIN32
+    int m_fd;
+
+public:
+    explicit FileLock(const std::string& path)
+            : m_fd{open(path.c_str(), O_RDWR | O_CREAT, 0644)} {
+        if (m_fd < 0 || flock(m_fd, LOCK_EX)) {
+            mgb_log_warn(
+                    "failed to lock %s: %s; concurrent updates of the "
+                    "persistent cache may be lost",
+                    path.c_str(), strerror(errno));
+        }
+    }
+
+    ~FileLock() {
+        if (m_fd >= 0) {
+            flock(m_fd, LOCK_UN);
+            close(m_fd);
+        }
+    }
+#else
+public:
+    explicit FileLock(const std::string&) {}
+#endif
+};
+
+}  // anonymous namespace
+
+// ================= InFilePersistentCache::BlobStorage ==================
+InFilePersistentCache::BlobStorage& InFilePersistentCache::BlobStorage::init_data_ref(
+        const Blob& b) {
+    data_refhold = std::make_unique<uint8_t[]>(b.size + 1);
+    memcpy(data_refhold.get(), b.ptr, b.size);
+    data_refhold.get()[b.size] = 0;  // for C-string safety
+    ptr = data_refhold.get();
+    size = b.size;
+    return *this;
+}
+
+// ================= InFilePersistentCache ==================
+InFilePersistentCache::InFilePersistentCache(const char* path, bool always_sync) {
+    auto file = resolve_path(path);
+    std::vector<uint8_t> bin;
+    if (read_file(file, bin) && !bin.empty()) {
+        mgb_log_debug("use fastrun cache: %s", file.c_str());
+        merge(bin.data(), bin.size());
+    }
+    if (always_sync) {
+        m_sync_path = file;
+    }
+}
+
+InFilePersistentCache::InFilePersistentCache(const uint8_t* bin, size_t size) {
+    mgb_assert(bin);
+    merge(bin, size);
+}
+
+std::string InFilePersistentCache::version_tag() {
+    auto mgb_ver = get_version();
+    auto dnn_ver = megdnn::get_version();
+    const char* arch =
+#if defined(__x86_64__) || defined(_M_X64)
+            "x86_64"
+#elif defined(__i386__) || defined(_M_IX86)
+            "x86"
+#elif defined(__aarch64__)
+            "aarch64"
+#elif defined(__arm__)
+            "armv7"
+#else
+            "unknown"
+#endif
+#if defined(__AVX2__)
+            "+avx2"
+#endif
+#if defined(__FMA__)
+            "+fma"
+#endif
+#if defined(__ARM_FEATURE_DOTPROD)
+            "+dotprod"
+#endif
+#if defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+            "+fp16"
+#endif
+            ;
+    return ssprintf(
+            "mgb=%d.%d.%d%s;dnn=%d.%d.%d;arch=%s", mgb_ver.major, mgb_ver.minor,
+            mgb_ver.patch, mgb_ver.is_dev ? "-dev" : "", dnn_ver.major,
+            dnn_ver.minor, dnn_ver.patch, arch);
+}
+
+std::string InFilePersistentCache::path_in_dir(const std::string& dir) {
+    auto tag = version_tag();
+    auto hash = XXHash{}.update(tag.data(), tag.size()).digest();
+    return ssprintf(
+            "%s/fastrun-%016llx.cache", dir.c_str(), (unsigned long long)hash);
+}
+
+std::string InFilePersistentCache::resolve_path(const char* path) {
+#ifndef WIN32
+    struct stat st;
+    if (!stat(path, &st) && S_ISDIR(st.st_mode)) {
+        return path_in_dir(path);
+    }
+#endif
+    return path;
+}
+
+size_t InFilePersistentCache::merge(const uint8_t* bin, size_t size) {
+    MGB_LOCK_GUARD(m_mtx);
+    return merge_locked(bin, size);
+}
+
+size_t InFilePersistentCache::merge_locked(const uint8_t* bin, size_t size) {
+    InputMemory inp(bin, size);
+    if (size >= sizeof(MAGIC) && !memcmp(bin, MAGIC, sizeof(MAGIC))) {
+        inp.read(sizeof(MAGIC));
+        auto format_version = inp.read_u32();
+        auto tag = inp.read_str();
+        auto expected_tag = version_tag();
+        if (format_version != FORMAT_VERSION || tag != expected_tag) {
+            mgb_log_warn(
+                    "drop stale persistent cache: format %u, tag %s (expected "
+                    "format %u, tag %s)",
+                    format_version, tag.c_str(), FORMAT_VERSION,
+                    expected_tag.c_str());
+            return 0;
+        }
+    }
+
+    // parse the whole input before merging, so corrupted input does not
+    // leave a partially merged cache
+    std::vector<std::pair<std::string, std::pair<Blob, Blob>>> entries;
+    auto read_blob = [&inp]() {
+        auto size = inp.read_u32();
+        return Blob{inp.read(size), size};
+    };
+    for (uint32_t i = 0, nr_category = inp.read_u32(); i < nr_category; i++) {
+        auto category = inp.read_str();
+        mgb_log_debug("load new category: %s", category.c_str());
+        for (uint32_t j = 0, nr_blob = inp.read_u32(); j < nr_blob; j++) {
+            auto key = read_blob();
+            auto value = read_blob();
+            entries.push_back({category, {key, value}});
+        }
+    }
+    mgb_throw_if(
+            inp.offset() != inp.size(), MegBrainError,
+            "corrupted persistent cache: %zu extra bytes",
+            inp.size() - inp.offset());
+
+    size_t nr_merged = 0;
+    for (auto&& i : entries) {
+        BlobStorage key_storage;
+        key_storage.init_data_ref(i.second.first).init_hash();
+        auto&& category = m_cache[i.first];
+        if (!category.count(key_storage)) {
+            category[std::move(key_storage)].init_data_ref(i.second.second);
+            ++nr_merged;
+        }
+    }
+    return nr_merged;
+}
+
+std::vector<uint8_t> InFilePersistentCache::dump() const {
+    MGB_LOCK_GUARD(m_mtx);
+    return dump_locked();
+}
+
+std::vector<uint8_t> InFilePersistentCache::dump_locked() const {
+    std::vector<uint8_t> ret(MAGIC, MAGIC + sizeof(MAGIC));
+    write_u32(ret, FORMAT_VERSION);
+    auto tag = version_tag();
+    write_blob(ret, tag.data(), tag.size());
+    write_u32(ret, m_cache.size());
+    for (auto&& cached_category : m_cache) {
+        auto&& category = cached_category.first;
+        write_blob(ret, category.data(), category.size());
+        mgb_log_debug("write new category: %s", category.c_str());
+        write_u32(ret, cached_category.second.size());
+        for (auto&& item : cached_category.second) {
+            write_blob(ret, item.first.ptr, item.first.size);
+            write_blob(ret, item.second.ptr, item.second.size);
+        }
+    }
+    return ret;
+}
+
+void InFilePersistentCache::dump_cache(const char* path) {
+    write_file_atomic(resolve_path(path), dump());
+}
+
+void InFilePersistentCache::merge_and_dump_cache(const char* path) {
+    auto file = resolve_path(path);
+    FileLock lock{file + ".lock"};
+    std::vector<uint8_t> bin;
+    read_file(file, bin);
+    std::vector<uint8_t> merged;
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        if (!bin.empty()) {
+            merge_locked(bin.data(), bin.size());
+        }
+        merged = dump_locked();
+    }
+    write_file_atomic(file, merged);
+}
+
+size_t InFilePersistentCache::nr_entries() const {
+    MGB_LOCK_GUARD(m_mtx);
+    size_t ret = 0;
+    for (auto&& i : m_cache) {
+        ret += i.second.size();
+    }
+    return ret;
+}
+
+Maybe<PersistentCache::Blob> InFilePersistentCache::get(
+        const std::string& category, const Blob& key) {
+    BlobStorage key_storage;
+    key_storage.Blob::operator=(key);
+    key_storage.init_hash();
+
+    MGB_LOCK_GUARD(m_mtx);
+    auto iter0 = m_cache.find(category);
+    if (iter0 == m_cache.end())
+        return None;
+    auto iter1 = iter0->second.find(key_storage);
+    if (iter1 == iter0->second.end())
+        return None;
+    return iter1->second;
+}
+
+void InFilePersistentCache::put(
+        const std::string& category, const Blob& key, const Blob& value) {
+    BlobStorage key_storage;
+    key_storage.init_data_ref(key).init_hash();
+
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        auto size0 = m_cache.size();
+        m_cache[category][std::move(key_storage)].init_data_ref(value);
+        if (m_cache.size() > size0) {
+            mgb_log_debug("new cache category: %s", category.c_str());
+        }
+    }
+    if (!m_sync_path.empty()) {
+        merge_and_dump_cache(m_sync_path.c_str());
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -68,4 +68,38 @@ void MemPoolStorage::clear() {
     m_free.clear();
 }
 
+MemArena::MemArena() noexcept = default;
+MemArena::MemArena(MemArena&& rhs) noexcept = default;
+MemArena::~MemArena() noexcept = default;
+MemArena& MemArena::operator=(MemArena&& rhs) noexcept = default;
+
+void* MemArena::alloc(size_t size) {
+    constexpr size_t ALIGN = alignof(std::max_align_t),
+                     BUF_SIZE = 64 * 1024;  // 64 KiB per buf
+    size = (size + ALIGN - 1) / ALIGN * ALIGN;
+    if (size > BUF_SIZE / 4) {
+        // put large objects in their own bufs without wasting the current one
+        auto ptr = new uint8_t[size];
+        if (m_buf.empty()) {
+            m_buf.emplace_back(ptr);
+        } else {
+            m_buf.emplace(m_buf.end() - 1, ptr);
+        }
+        return ptr;
+    }
+    if (m_cur_buf_pos + size > m_cur_buf_size_bytes) {
+        m_buf.emplace_back(new uint8_t[BUF_SIZE]);
+        m_cur_buf_pos = 0;
+        m_cur_buf_size_bytes = BUF_SIZE;
+    }
+    auto ptr = m_buf.back().get() + m_cur_buf_pos;
+    m_cur_buf_pos += size;
+    return ptr;
+}
+
+void MemArena::clear() {
+    m_cur_buf_pos = m_cur_buf_size_bytes = 0;
+    m_buf.clear();
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -118,6 +118,18 @@ size_t SCQueueSynchronizer::get_default_max_spin() {
     return cached_default_max_spin;
 }
 
+size_t SCQueueSynchronizer::get_default_ring_size() {
+    static size_t ring_size = []() -> size_t {
+        if (auto env = MGB_GETENV("MGB_ASYNC_QUEUE_RING_SIZE")) {
+            auto size = std::stoul(env);
+            mgb_log_warn("async queue would use ring buffer of size %zu", size);
+            return size;
+        }
+        return 0;
+    }();
+    return ring_size;
+}
+
 SCQueueSynchronizer::SCQueueSynchronizer(size_t max_spin) {
     m_max_spin = max_spin;
 }
@@ -15,14 +15,52 @@
 using namespace mgb;
 
 #if MGB_HAVE_THREAD
-ThreadPool::ThreadPool(size_t threads_num)
+struct ThreadPool::TaskGroup {
+    //! the task to execute, point to owned_task or to the caller's task
+    const MultiThreadingTask* task;
+    MultiThreadingTask owned_task;
+    //! number of sub tasks not finished yet
+    std::atomic_size_t nr_remaining{0};
+};
+
+ThreadPoolMode ThreadPool::default_mode() {
+    static ThreadPoolMode mode = MGB_GETENV("MGB_THREAD_POOL_WORK_STEALING")
+                                       ? ThreadPoolMode::WORK_STEALING
+                                       : ThreadPoolMode::FORK_JOIN;
+    return mode;
+}
+
+ThreadPoolWaitPolicy ThreadPool::default_wait_policy() {
+    static ThreadPoolWaitPolicy policy = []() {
+        ThreadPoolWaitPolicy ret;
+        if (auto setting = MGB_GETENV("MGB_THREAD_POOL_WAIT_POLICY")) {
+            std::string str{setting};
+            auto sep = str.find(':');
+            ret.nr_spin = std::stoull(str.substr(0, sep));
+            if (sep != std::string::npos) {
+                ret.nr_yield = std::stoull(str.substr(sep + 1));
+            }
+            mgb_log_debug(
+                    "thread pool wait policy: spin %zu, yield %zu", ret.nr_spin,
+                    ret.nr_yield);
+        }
+        return ret;
+    }();
+    return policy;
+}
+
+ThreadPool::ThreadPool(size_t threads_num, ThreadPoolMode mode)
         : m_nr_threads(threads_num),
+          m_mode(mode),
           m_main_affinity_flag{false},
           m_stop{false},
           m_active{false} {
     if (threads_num < 1) {
         m_nr_threads = 1;
     }
+    auto policy = default_wait_policy();
+    m_nr_spin = policy.nr_spin;
+    m_nr_yield = policy.nr_yield;
     if (m_nr_threads > 1) {
         if (m_nr_threads > static_cast<uint32_t>(sys::get_cpu_count())) {
             mgb_log_debug(
@@ -30,46 +68,230 @@ ThreadPool::ThreadPool(size_t threads_num)
                     "physical cpu cores, got: %zu core_number: %zu",
                     static_cast<size_t>(sys::get_cpu_count()), nr_threads());
         }
+        if (m_mode == ThreadPoolMode::WORK_STEALING) {
+            m_deques.reset(new WorkDeque[m_nr_threads]);
+        }
         for (uint32_t i = 0; i < m_nr_threads - 1; i++) {
             m_workers.push_back(new Worker([this, i]() {
-                while (!m_stop) {
-                    while (m_active) {
-                        if (m_workers[i]->affinity_flag &&
-                            m_core_binding_function != nullptr) {
-                            m_core_binding_function(i);
-                            m_workers[i]->affinity_flag = false;
-                        }
-                        //! if the thread should work
-                        if (m_workers[i]->work_flag.load(std::memory_order_acquire)) {
-                            int index = -1;
-                            //! Get one task and execute
-                            while ((index = m_task_iter.fetch_sub(
-                                            1, std::memory_order_acq_rel)) &&
-                                   index > 0) {
-                                //! index is decrease, use
-                                //! m_all_task_number - index to get the
-                                //! increase id which will pass to task
-                                m_task(static_cast<size_t>(m_nr_parallelism - index),
-                                       i);
-                            }
-                            //! Flag worker is finished
-                            m_workers[i]->work_flag.store(
-                                    false, std::memory_order_release);
-                        }
-                        //! Wait next task coming
-                        std::this_thread::yield();
-                    }
-                    {
-                        std::unique_lock<std::mutex> lock(m_mutex);
-                        if (!m_stop && !m_active) {
-                            m_cv.wait(lock, [this] { return m_stop || m_active; });
-                        }
-                    }
+                if (m_mode == ThreadPoolMode::WORK_STEALING) {
+                    worker_work_stealing(i);
+                } else {
+                    worker_fork_join(i);
                 }
             }));
         }
     }
 }
+
+void ThreadPool::bind_worker_affinity(size_t i) {
+    if (m_workers[i]->affinity_flag && m_core_binding_function != nullptr) {
+        m_core_binding_function(i);
+        m_workers[i]->affinity_flag = false;
+    }
+}
+
+void ThreadPool::set_wait_policy(const ThreadPoolWaitPolicy& policy) {
+    m_nr_spin = policy.nr_spin;
+    m_nr_yield = policy.nr_yield;
+    //! parked workers should re-check the new policy
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.notify_all();
+}
+
+bool ThreadPool::has_work(size_t i) const {
+    if (m_mode == ThreadPoolMode::WORK_STEALING) {
+        return m_nr_pending.load() > 0;
+    }
+    return m_workers[i]->work_flag.load();
+}
+
+void ThreadPool::idle_wait(size_t i, size_t nr_idle) {
+    size_t nr_spin = m_nr_spin.load(std::memory_order_relaxed);
+    if (nr_idle < nr_spin) {
+        return;
+    }
+    if (nr_idle - nr_spin < m_nr_yield.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    //! seq_cst pairs with publishing work then reading m_nr_parked in
+    //! notify_parked()
+    m_nr_parked.fetch_add(1);
+    //! a changed policy also wakes the worker, so it would not be parked
+    //! forever if parking is disabled later
+    size_t cur_spin = nr_spin, cur_yield = m_nr_yield.load();
+    m_cv.wait(lock, [&]() {
+        return m_stop || !m_active || has_work(i) || cur_spin != m_nr_spin.load() ||
+               cur_yield != m_nr_yield.load();
+    });
+    m_nr_parked.fetch_sub(1);
+}
+
+void ThreadPool::notify_parked() {
+    if (m_nr_parked.load()) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.notify_all();
+    }
+}
+
+void ThreadPool::worker_fork_join(size_t i) {
+    while (!m_stop) {
+        size_t nr_idle = 0;
+        while (m_active) {
+            bind_worker_affinity(i);
+            //! if the thread should work
+            if (m_workers[i]->work_flag.load(std::memory_order_acquire)) {
+                nr_idle = 0;
+                int index = -1;
+                //! Get one task and execute
+                while ((index = m_task_iter.fetch_sub(1, std::memory_order_acq_rel)) &&
+                       index > 0) {
+                    //! index is decrease, use
+                    //! m_all_task_number - index to get the
+                    //! increase id which will pass to task
+                    m_task(static_cast<size_t>(m_nr_parallelism - index), i);
+                }
+                //! Flag worker is finished
+                m_workers[i]->work_flag.store(false, std::memory_order_release);
+            }
+            //! Wait next task coming
+            idle_wait(i, nr_idle++);
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_stop && !m_active) {
+                m_cv.wait(lock, [this] { return m_stop || m_active; });
+            }
+        }
+    }
+}
+
+void ThreadPool::worker_work_stealing(size_t i) {
+    while (!m_stop) {
+        size_t nr_idle = 0;
+        while (m_active) {
+            bind_worker_affinity(i);
+            if (run_one_chunk(i)) {
+                nr_idle = 0;
+            } else {
+                //! Wait next task coming
+                idle_wait(i, nr_idle++);
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_stop && !m_active) {
+                m_cv.wait(lock, [this] { return m_stop || m_active; });
+            }
+        }
+    }
+}
+
+void ThreadPool::push_chunks(const TaskHandle& group, const TaskElem& task_elem) {
+    size_t nr_parallelism = task_elem.nr_parallelism, grain = task_elem.grain_size;
+    if (!grain) {
+        //! several chunks per thread so that stealing can balance the load
+        grain = std::max<size_t>(1, nr_parallelism / (m_nr_threads * 4));
+    }
+    size_t priority =
+            std::min(static_cast<size_t>(task_elem.priority), NR_TASK_PRIORITY - 1);
+    group->nr_remaining.store(nr_parallelism, std::memory_order_relaxed);
+    m_nr_pending_of[priority].fetch_add(nr_parallelism, std::memory_order_relaxed);
+    //! seq_cst pairs with the re-check of m_nr_pending in deactive()
+    m_nr_pending.fetch_add(nr_parallelism);
+    size_t start = m_next_deque.fetch_add(1, std::memory_order_relaxed);
+    for (size_t begin = 0, k = 0; begin < nr_parallelism; begin += grain, ++k) {
+        size_t end = std::min(begin + grain, nr_parallelism);
+        auto&& dq = m_deques[(start + k) % m_nr_threads];
+        MGB_LOCK_GUARD(dq.mtx);
+        dq.items[priority].push_back({group, begin, end});
+    }
+    notify_parked();
+}
+
+bool ThreadPool::take_chunk(size_t id, size_t priority, WorkItem& item) {
+    {
+        auto&& items = m_deques[id].items[priority];
+        MGB_LOCK_GUARD(m_deques[id].mtx);
+        if (!items.empty()) {
+            item = std::move(items.back());
+            items.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < m_nr_threads; ++k) {
+        auto&& dq = m_deques[(id + k) % m_nr_threads];
+        auto&& items = dq.items[priority];
+        MGB_LOCK_GUARD(dq.mtx);
+        if (!items.empty()) {
+            item = std::move(items.front());
+            items.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::run_one_chunk(size_t id) {
+    WorkItem item;
+    size_t priority = NR_TASK_PRIORITY;
+    while (priority--) {
+        //! the counter includes the running chunks, so it is only a hint
+        if (m_nr_pending_of[priority].load(std::memory_order_relaxed) &&
+            take_chunk(id, priority, item)) {
+            break;
+        }
+    }
+    if (!item.group) {
+        return false;
+    }
+    auto&& task = *item.group->task;
+    for (size_t i = item.begin; i < item.end; ++i) {
+        task(i, id);
+    }
+    size_t nr = item.end - item.begin;
+    item.group->nr_remaining.fetch_sub(nr, std::memory_order_acq_rel);
+    m_nr_pending_of[priority].fetch_sub(nr, std::memory_order_relaxed);
+    m_nr_pending.fetch_sub(nr, std::memory_order_acq_rel);
+    return true;
+}
+
+ThreadPool::TaskHandle ThreadPool::submit(const TaskElem& task_elem) {
+    if (m_mode != ThreadPoolMode::WORK_STEALING || m_nr_threads == 1 ||
+        task_elem.nr_parallelism == 1) {
+        add_task(task_elem);
+        return {};
+    }
+    auto group = std::make_shared<TaskGroup>();
+    group->owned_task = task_elem.task;
+    group->task = &group->owned_task;
+    push_chunks(group, task_elem);
+    active();
+    return group;
+}
+
+void ThreadPool::wait(const TaskHandle& handle) {
+    if (handle) {
+        help_until_zero(handle->nr_remaining);
+    }
+}
+
+void ThreadPool::help_until_zero(const std::atomic_size_t& counter) {
+    bool own_slot = false;
+    while (counter.load(std::memory_order_acquire)) {
+        if (!own_slot) {
+            own_slot = !m_caller_slot_busy.test_and_set(std::memory_order_acquire);
+        }
+        if (!own_slot || !run_one_chunk(m_nr_threads - 1)) {
+            std::this_thread::yield();
+        }
+    }
+    if (own_slot) {
+        m_caller_slot_busy.clear(std::memory_order_release);
+    }
+}
+
 void ThreadPool::add_task(const TaskElem& task_elem) {
     //! Make sure the main thread have bind
     if (m_main_affinity_flag && m_core_binding_function != nullptr) {
@@ -84,6 +306,13 @@ void ThreadPool::add_task(const TaskElem& task_elem) {
             task_elem.task(i, 0);
         }
         return;
+    } else if (m_mode == ThreadPoolMode::WORK_STEALING) {
+        //! the caller blocks until finished, so the task need not be copied
+        auto group = std::make_shared<TaskGroup>();
+        group->task = &task_elem.task;
+        push_chunks(group, task_elem);
+        active();
+        wait(group);
     } else {
         std::lock_guard<std::mutex> lock(m_mutex_task);
         mgb_assert(
@@ -100,6 +329,7 @@ void ThreadPool::add_task(const TaskElem& task_elem) {
         for (uint32_t i = 0; i < m_nr_threads - 1; i++) {
             m_workers[i]->work_flag = true;
         }
+        notify_parked();
         //! Main thread working
         int index = -1;
         while ((index = m_task_iter.fetch_sub(1, std::memory_order_acq_rel)) &&
@@ -126,6 +356,10 @@ size_t ThreadPool::nr_threads() const {
 }
 
 void ThreadPool::sync() {
+    if (m_mode == ThreadPoolMode::WORK_STEALING) {
+        help_until_zero(m_nr_pending);
+        return;
+    }
     bool no_finished = false;
     do {
         no_finished = false;
@@ -148,9 +382,18 @@ void ThreadPool::active() {
     }
 }
 void ThreadPool::deactive() {
+    if (m_mode == ThreadPoolMode::WORK_STEALING && m_nr_threads > 1) {
+        //! submitted tasks must be drained before the workers go to sleep
+        sync();
+    }
     std::lock_guard<std::mutex> lock_task(m_mutex_task);
     std::unique_lock<std::mutex> lock(m_mutex);
     m_active = false;
+    if (m_mode == ThreadPoolMode::WORK_STEALING && m_nr_pending.load()) {
+        //! another caller submitted a task concurrently, keep workers running
+        m_active = true;
+        m_cv.notify_all();
+    }
 }
 ThreadPool::~ThreadPool() {
     std::lock_guard<std::mutex> lock_task(m_mutex_task);
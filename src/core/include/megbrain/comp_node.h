@@ -178,7 +178,8 @@ public:
 
     //! predefined special streams
     struct Stream {
-        static constexpr int COPY = -1, REMOTE_SEND = -2, LOOP_SWAP = -3;
+        static constexpr int COPY = -1, REMOTE_SEND = -2, LOOP_SWAP = -3,
+                             PROFILE = -4;
     };
 
     CompNode() = default;
@@ -241,6 +242,30 @@ public:
         return m_impl->copy_to_device(device_ptr, host_ptr, size);
     }
 
+    //! a memory region to be copied by the batched copy functions
+    struct CopySegment {
+        void* dest;
+        const void* src;
+        size_t size;
+    };
+
+    /*!
+     * \brief copy many buffers from underlying device to host
+     *
+     * This is equivalent to calling copy_to_host() on each segment in order,
+     * but the implementations may merge the segments to reduce the launch
+     * overhead. The segments themselves need not stay alive after return.
+     */
+    void batched_copy_to_host(const CopySegment* segs, size_t nr_seg) const {
+        return m_impl->batched_copy_to_host(segs, nr_seg);
+    }
+
+    //! copy many buffers from host to underlying device; see
+    //! batched_copy_to_host()
+    void batched_copy_to_device(const CopySegment* segs, size_t nr_seg) const {
+        return m_impl->batched_copy_to_device(segs, nr_seg);
+    }
+
     /*!
      * \brief copy from this device to another device; would use the
      *      computing resource on dest_node
@@ -481,6 +506,81 @@ public:
      */
     static bool enable_affinity_for_cpu(bool flag);
 
+    /*!
+     * \brief set whether to bind CPU comp nodes to NUMA nodes
+     *
+     * If enabled, the worker threads of cpux and multithreadn:x and the
+     * memory allocated on them would be bound to the (x % nr_numa_node)'th
+     * NUMA node, so one model replica can be loaded on each socket by
+     * mapping its comp nodes to different device numbers. It takes effect
+     * on comp nodes created afterwards and overrides enable_affinity_for_cpu.
+     *
+     * This is disabled by default.
+     *
+     * (implemented in comp_node/cpu/comp_node.cpp)
+     *
+     * \return original setting
+     */
+    static bool enable_numa_for_cpu(bool flag);
+
+    /*!
+     * \brief set the number of threads of the thread pool shared by all the
+     *      multithread CPU comp nodes
+     *
+     * If it is not zero, the multithread comp nodes created afterwards
+     * submit their tasks to one process-wide work-stealing thread pool of
+     * nr_threads threads regardless of the number of threads in their
+     * locators, so several models running at the same time would not
+     * oversubscribe the cores. The order of the tasks of different comp nodes
+     * is decided by CPUDispatcher::set_priority(). Comp nodes bound to
+     * different NUMA nodes still use different pools.
+     *
+     * This is disabled (0) by default.
+     *
+     * (implemented in comp_node/cpu/comp_node.cpp)
+     *
+     * \return original setting
+     */
+    static size_t set_cpu_shared_thread_pool(size_t nr_threads);
+
+    /*!
+     * \brief set the size of the huge pages backing the large memory of CPU
+     *      comp nodes, 2MB or 1GB, and 0 to disable
+     *
+     * If enabled, the allocations of CPU comp nodes not smaller than 1MB,
+     * like the static memory, the workspaces and the weights, are mapped on
+     * huge pages by sys::map_huge_pages() to reduce TLB misses; 1GB pages are
+     * only used for the allocations not smaller than 512MB. Each allocation
+     * is rounded up to the huge page size. InputFile::make_mmap() also reads
+     * the file into huge pages instead of mapping it. It takes effect on the
+     * allocations afterwards and only works on linux.
+     *
+     * This is disabled (0) by default.
+     *
+     * (implemented in comp_node/cpu/comp_node.cpp)
+     *
+     * \return original setting
+     */
+    static size_t set_cpu_huge_page_size(size_t page_size);
+
+    static size_t get_cpu_huge_page_size();
+
+    //! the memory of CPU comp nodes currently on huge pages
+    struct HugePageStats {
+        //! the bytes mapped by set_cpu_huge_page_size()
+        size_t nr_bytes_mapped = 0;
+        //! the bytes of them on explicit huge pages from hugetlbfs
+        size_t nr_bytes_hugetlb = 0;
+        //! the bytes of them actually backed by huge pages, which are only
+        //! counted when touched; see sys::get_huge_page_bytes()
+        size_t nr_bytes_huge = 0;
+        //! the accumulated bytes of the allocations that failed to be mapped
+        //! and fell back to the heap
+        size_t nr_bytes_failed = 0;
+    };
+
+    static HugePageStats get_cpu_huge_page_stats();
+
 protected:
     //! ImplBase with env(); defined in CompNodeEnv
     class Impl;
@@ -502,6 +602,8 @@ protected:
                 void* device_ptr, const void* host_ptr, size_t size) = 0;
         virtual void peer_copy_to(
                 Impl* dest_impl, void* dest, const void* src, size_t size) = 0;
+        virtual void batched_copy_to_host(const CopySegment* segs, size_t nr_seg);
+        virtual void batched_copy_to_device(const CopySegment* segs, size_t nr_seg);
 
         virtual size_t get_mem_addr_alignment() = 0;
         virtual size_t get_mem_padding();
@@ -44,6 +44,16 @@ public:
      */
     virtual void get_mem_info(size_t& free, size_t& tot) = 0;
 
+    /*!
+     * \brief whether chunks returned by alloc() that are adjacent in address
+     *      can be used as one continuous range
+     *
+     * This holds for allocators that map physical memory into one reserved
+     * virtual address range; DevMemAlloc would then merge free blocks
+     * across chunk boundaries.
+     */
+    virtual bool mergeable_chunks() const { return false; }
+
     virtual ~RawAllocator() = default;
 };
 
@@ -205,6 +215,42 @@ public:
      *      cudaMalloc and cudaFree, so no custom algorithm is involved
      */
     static std::unique_ptr<DevMemAlloc> make_cuda_alloc();
+
+    /*!
+     * \brief create a new allocator for a device on a cuda stream-ordered
+     *      memory pool (cudaMallocAsync), so caching and cross-stream reuse
+     *      are handled by the driver rather than a global free list
+     *
+     * Memory freed on a stream is reused by other streams only after
+     * the event dependencies are satisfied. Requires CUDA 11.3.
+     *
+     * \param[in] device device id
+     * \param[in] release_threshold bytes of cached memory which the pool
+     *      keeps at synchronization points before releasing the rest back
+     *      to the system
+     * \return nullptr if memory pools are not supported by the device
+     */
+    static std::unique_ptr<DevMemAlloc> make_cuda_async_alloc(
+            int device, size_t release_threshold);
+
+    /*!
+     * \brief create a new allocator for a device whose chunks are mapped
+     *      into one reserved virtual address range with the cuda virtual
+     *      memory management API (cuMemCreate and cuMemMap)
+     *
+     * Free blocks from different chunks can be merged, and the physical
+     * memory of fully free chunks is unmapped when the allocator gathers
+     * free memory. Requires CUDA 10.2.
+     *
+     * \param[in] device device id
+     * \param[in] reserve_size initial reserved memory size
+     * \param[in] prealloc pre-allocation config; alignment would be raised
+     *      to the physical allocation granularity
+     * \return nullptr if virtual memory management is not supported by the
+     *      device
+     */
+    static std::unique_ptr<DevMemAlloc> make_cuda_vmm_alloc(
+            int device, size_t reserve_size, const PreAllocConfig& prealloc);
 #endif
 
 #if MGB_ROCM
@@ -382,6 +428,56 @@ public:
     size_t alignment() const { return m_alignment; };
 };
 
+/* ===================== ThreadCachingAlloc  ===================== */
+/*!
+ * \brief a tcmalloc-style caching front-end for host memory, with per-thread
+ *      size class caches in front of a shared pool
+ *
+ * Freed blocks are cached by the freeing thread and most allocations are
+ * served without locking. Once a thread cache holds more than
+ * Config::thread_cache_limit bytes, half of its blocks are returned to the
+ * shared pool, where other threads refill from in batches. This covers the
+ * common case that memory allocated by the caller thread is freed by the
+ * worker thread of a comp node. Requests larger than the largest size class
+ * are forwarded to the raw allocator.
+ *
+ * The raw allocator must return addresses aligned to Config::alignment.
+ * All methods are thread safe.
+ */
+class ThreadCachingAlloc : virtual public MemAllocBase {
+public:
+    struct Config {
+        //! alignment of returned addresses, which must be a power of 2 and
+        //! at least 16 (a block header is stored before each block)
+        size_t alignment = 64;
+        //! max number of bytes cached by each thread
+        size_t thread_cache_limit = 4 * 1024 * 1024;
+    };
+
+    //! largest request size that is cached
+    static constexpr size_t MAX_CACHED_SIZE = 1024 * 1024;
+
+    static std::unique_ptr<ThreadCachingAlloc> make(
+            std::unique_ptr<RawAllocator> raw_alloc, const Config& config);
+
+    virtual ~ThreadCachingAlloc() = default;
+
+    virtual void* alloc(size_t size) = 0;
+    virtual void free(void* ptr) = 0;
+
+    //! return blocks cached by the calling thread to the shared pool
+    virtual void flush_thread_cache() = 0;
+
+    /*!
+     * \brief flush the cache of calling thread, and release all blocks in
+     *      the shared pool to the raw allocator
+     * \return number of bytes released
+     */
+    virtual size_t release_cached() = 0;
+
+    virtual size_t alignment() const = 0;
+};
+
 }  // namespace mem_alloc
 }  // namespace mgb
 
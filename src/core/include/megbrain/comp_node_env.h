@@ -15,6 +15,7 @@
 #include "megbrain/comp_node.h"
 #include "megbrain/utils/metahelper.h"
 #include "megbrain/utils/thread.h"
+#include "megbrain/utils/thread_pool.h"
 #include "megbrain_build_config.h"
 
 #include "megdnn/handle.h"
@@ -224,6 +225,17 @@ public:
     virtual void set_affinity(AffinityCallBack&& /*affinity_cb*/) {
         mgb_assert(0, "The CompNode set_affinity is not implement");
     }
+    //! set how the idle threads of the thread pool wait for new tasks: spin
+    //! nr_spin rounds, yield nr_yield rounds, and then sleep
+    virtual void set_wait_policy(size_t /*nr_spin*/, size_t /*nr_yield*/) {
+        mgb_assert(0, "The CompNode set_wait_policy is not implement");
+    }
+    //! set the priority of the tasks dispatched afterwards, which decides
+    //! the order to run them with the tasks of other comp nodes sharing the
+    //! same work-stealing thread pool
+    virtual void set_priority(TaskPriority /*priority*/) {
+        mgb_assert(0, "The CompNode set_priority is not implement");
+    }
 };
 using AtlasDispatcher = CPUDispatcher;
 
@@ -513,6 +525,14 @@ public:
         void set_affinity(AffinityCallBack&& cb) const {
             dispatcher->set_affinity(std::move(cb));
         }
+
+        void set_wait_policy(size_t nr_spin, size_t nr_yield) const {
+            dispatcher->set_wait_policy(nr_spin, nr_yield);
+        }
+
+        void set_priority(TaskPriority priority) const {
+            dispatcher->set_priority(priority);
+        }
     };
 
     const CpuEnv& cpu_env() const {
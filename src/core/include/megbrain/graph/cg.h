@@ -89,6 +89,8 @@ struct GraphCommonOptimizeOptions {
     bool f16_io_f32_comp = false;
     //! whether to enable tranform to pure float16 model
     bool f16_io_comp = false;
+    //! whether to enable IO in bfloat16 compute in float32
+    bool bf16_io_f32_comp = false;
     //! whether to enable conv bias nonlinearity fusion
     bool fuse_conv_bias_nonlinearity = false;
     //! fuse pattern like ReLU(conv_bias(x, w, b) + z) or conv_bias(x, w, b)
@@ -98,8 +100,38 @@ struct GraphCommonOptimizeOptions {
     //! memory, default disable now, when weight preprocess is enabled, the
     //! input shape should no change
     bool weight_preprocess = false;
-    //! fuse preprocess patten, like astype + pad_channel + dimshuffle
+    //! whether to look up the preprocessed weights of the CPU oprs in
+    //! PersistentCache before preprocessing them, and to put the results
+    //! there, so they can be dumped with the fastrun cache and reused by
+    //! later processes; only takes effect with weight_preprocess
+    bool weight_preprocess_cache = false;
+    //! fuse preprocess patten, like astype + pad_channel + dimshuffle, and
+    //! the cvt_color + astype + resize + normalize chains of uint8 images
     bool fuse_preprocess = false;
+    //! fuse the sibling convs or matmuls that share an input and have
+    //! constant weights into one wider opr followed by a split
+    bool fuse_horizontal = false;
+    //! replace the MatrixMul and 1x1 ConvBias oprs whose constant weights
+    //! are block sparse by BlockSparseMatrixMul
+    bool block_sparse_weight = false;
+    //! replace the MatrixMul oprs of constant weights by
+    //! WeightQuantMatrixMul, with the weights quantized to int8 or int4
+    bool weight_only_quant_int8 = false;
+    bool weight_only_quant_int4 = false;
+    //! replace the vars with constant values, such as the shapes of the
+    //! inputs loaded with GraphLoadConfig::const_var_shape, by constants
+    bool fold_const_shape = false;
+    //! compute sigmoid(x) and sigmoid(x) * y by one ElemwiseMultiOutput
+    //! opr when sigmoid(x) has other readers; only the CUDA backend has a
+    //! dedicated kernel for it
+    bool fuse_multi_output_elemwise = false;
+    //! compute the chains of NCHW convs, poolings and elemwise oprs on
+    //! large feature maps tile by tile to bound the activation memory
+    bool spatial_tiling = false;
+    //! pad the channels of the float32 and qint8 convs to multiple of the
+    //! pack size, so the NCHW44/NCHW88 layout transforms convert them; only
+    //! takes effect with nchw44, nchw44_dot or nchw88
+    bool padding_channel = false;
     enum LayoutTransform : uint32_t {
         DEFAULT,
         NCHW4,       ///< compute using NCHW4 tensor format
@@ -113,6 +145,9 @@ struct GraphCommonOptimizeOptions {
                      ///< used for cuda
         NCHW64,      ///< compute using NCHW64 tensor format, used for fast int4
                      ///< support on Nvidia GPU
+        NHWC,        ///< compute float16 convs and their backward oprs using
+                     ///< NHWC tensor format, used for tensorcore training on
+                     ///< Nvidia GPU
     };
     LayoutTransform layout_transform = LayoutTransform::DEFAULT;
 
@@ -129,10 +164,20 @@ struct GraphCommonOptimizeOptions {
 
     SET(f16_io_f32_comp);
     SET(f16_io_comp);
+    SET(bf16_io_f32_comp);
     SET(fuse_conv_bias_nonlinearity);
     SET(fuse_conv_bias_with_z);
     SET(fuse_preprocess);
+    SET(fuse_horizontal);
+    SET(block_sparse_weight);
+    SET(weight_only_quant_int8);
+    SET(weight_only_quant_int4);
+    SET(fold_const_shape);
+    SET(fuse_multi_output_elemwise);
+    SET(spatial_tiling);
+    SET(padding_channel);
     SET(weight_preprocess);
+    SET(weight_preprocess_cache);
 #undef SET
 #define SET(_trans, _trans_capital)                                 \
     GraphCommonOptimizeOptions& enable_##_trans() {                 \
@@ -156,6 +201,7 @@ struct GraphCommonOptimizeOptions {
     SET(nchw32, NCHW32);
     SET(chwn4, CHWN4);
     SET(nchw64, NCHW64);
+    SET(nhwc, NHWC);
 #undef SET
 };
 
@@ -323,6 +369,41 @@ public:
             //! whether to enable comp node optimization (e.g. using copy
             //! stream for I/O operators)
             bool enable_seq_comp_node_opt = true;
+
+            /*!
+             * number of streams on which oprs on cpuX comp nodes are
+             * distributed, so independent branches of the graph can run
+             * concurrently on different worker threads; value 0 or 1
+             * disables it. It requires enable_seq_comp_node_opt and is
+             * ignored if comp_node_seq_record_level is set.
+             */
+            size_t cpu_opr_parallel_streams = 0;
+
+            /*!
+             * whether to time all static memory allocation algorithms and
+             * use the plan with lowest memory usage; plans are kept in
+             * StaticMemPlanCache and could be persisted with env var
+             * MGB_STATIC_MEM_PLAN_CACHE. It can also be enabled by env var
+             * MGB_STATIC_MEM_ALLOC_PROFILE.
+             */
+            bool profile_static_mem_alloc = false;
+
+            /*!
+             * whether to reorder independent oprs during topological sort
+             * to lower the peak of statically allocated memory: among the
+             * ready oprs with the same priority, the one that allocates the
+             * least memory after releasing its dead inputs is executed
+             * first. Opr priorities are still respected.
+             */
+            bool enable_mem_aware_opr_order = false;
+
+            /*!
+             * number of ready oprs (in default order) considered at each
+             * step of memory-aware ordering; an opr would not be postponed
+             * for more than this number of steps, which bounds the latency
+             * added to the critical path
+             */
+            size_t mem_aware_opr_order_window = 16;
         } seq_opt;
 
         //! graph optimization options
@@ -437,6 +518,12 @@ public:
             int genetic_pool_size = 20;
             int lb_memory_mb = 0;
             int num_worker = sys::get_cpu_count() / 2;
+            //! stop genetic search if the bottleneck is not improved in
+            //! this number of iterations; 0 to disable
+            int genetic_early_stop = 0;
+            //! whether to save the searched plan in PersistentCache, keyed
+            //! by the topology and var sizes of the opr seq
+            bool enable_plan_cache = true;
         } sublinear_mem_config;
 
         //! whether to enable DTR memory optimization
@@ -458,6 +545,12 @@ public:
         //! dynamic var fails
         bool enable_var_mem_defragment = true;
 
+        //! maximum bytes that may be moved by incremental defragmenting in
+        //! each execution; incremental defragmenting only moves the var
+        //! around a free region to make room for the allocation, and all
+        //! vars would be moved at once if it fails; 0 to disable it
+        size_t var_mem_defragment_incremental_limit = 64 * 1024 * 1024;
+
         //! whether to reshape grad var whose wrt shape is statically
         //! inferrable but its own shape is dynamic
         bool enable_grad_var_static_reshape = false;
@@ -486,6 +579,10 @@ public:
          *     sequence
          *  5. Only one comp node can be used in the graph
          *
+         * On CUDA comp nodes the sequence is captured into a CUDA graph
+         * (requires CUDA 11.1), and results of a replay are only
+         * available after waiting for the computing sequence.
+         *
          * Level 2: besides recording the computing sequence, the
          * dependencies are also moved into the compiled func (see
          * GraphExecutable::ExecDependency). Additional constraints:
@@ -496,6 +593,39 @@ public:
          */
         uint8_t comp_node_seq_record_level = 0;
 
+        /*!
+         * max number of sequences recorded by comp_node_seq_record_level 1
+         * that are kept for previous input shapes. A recorded sequence is
+         * cached instead of being discarded when input shapes change, and
+         * is replayed again once the graph is executed with the same input
+         * shapes. The static memory referred by the cached sequences is
+         * kept alive, and host input/output buffers should not be changed
+         * for each of the shapes. Value 0 disables the cache.
+         */
+        size_t comp_node_seq_record_cache_size = 0;
+
+        /*!
+         * whether to record the kernels of one iteration of a loop body
+         * (see opr::Loop) and replay them in the following iterations, so
+         * the sub graph is not dispatched again on every iteration. It only
+         * takes effect on loops whose loop time can be statically inferred,
+         * whose body runs on a cpuX comp node with static memory, and whose
+         * outputs are all recorded with OutputMode::SUM; other loops are
+         * executed normally.
+         */
+        bool enable_loop_body_record = false;
+
+        /*!
+         * whether a compiled function can still be executed after functions
+         * of other output specs are compiled on the same graph. The function
+         * is then re-attached to the graph when executed: the opr sequence
+         * is sorted again from its already optimized vars and the memory is
+         * planned again, but the graph optimization is not repeated. Keeping
+         * the functions of the output specs switched between thus caches
+         * them. Sublinear memory, dtr and memory swap are not supported.
+         */
+        bool allow_reattach_comp_seq = false;
+
 #if !MGB_BUILD_SLIM_SERVING
         //! whether to evaulate var node values as they are inserted
         bool eager_evaluation = false;
@@ -517,6 +647,12 @@ public:
         //! whether to sync comp_node when waiting computing sequence
         bool comp_seq_sync_device = true;
 
+        /*!
+         * whether operators that accumulate by atomics, such as
+         * IndexingIncrMultiAxisVec on CUDA, must give reproducible results
+         */
+        bool deterministic_accumulation = false;
+
         //! add extra deps for the comp seq if a specific var is dependent
         ThinHashMap<VarNode*, VarNodeArray> extra_vardeps;
 
@@ -541,6 +677,45 @@ public:
              * equal
              */
             bool binary_equal_between_batch = false;
+
+            /*!
+             * \brief granularity of the shape buckets used by fastrun
+             *
+             * Non-zero value means that each dim of the layouts is rounded
+             * up to a multiple of this value when looking up the profiling
+             * cache, so layouts in the same bucket are profiled only once
+             * and share the result. Only algorithms whose usability does
+             * not depend on shape are chosen in this case.
+             *
+             * Zero means each distinct layout is profiled
+             */
+            uint32_t shape_bucket_size = 0;
+
+            /*!
+             * \brief whether to profile layouts missing in the cache in
+             * background
+             *
+             * If set, an operator with PROFILE strategy whose layouts are
+             * not in the profiling cache uses the heuristic choice, and
+             * the profiling runs in a low priority background thread (on a
+             * side stream if the device has multiple streams) to fill the
+             * cache. Once profiling finishes, the operators switch to the
+             * profiled algos between two executions. Note that the measured
+             * time may be disturbed by the running graph.
+             */
+            bool background_profiling = false;
+
+            /*!
+             * \brief comp nodes on identical devices to profile the
+             * candidate algos of an operator concurrently
+             *
+             * If more than one comp node is given, the candidates are
+             * distributed among them and the results are put into the
+             * profiling cache of the operator's comp node. The devices
+             * must be of the same model as the operator's device, and
+             * profiling timeouts are not used in this mode.
+             */
+            std::vector<CompNode> parallel_profile_comp_nodes;
         } fast_run_config;
 
     };  // Options
@@ -224,6 +224,32 @@ struct SubgraphAssociated {
     MGB_TYPEINFO_OBJ_DECL;
 };
 
+/*!
+ * \brief signaled when a phase of loading or compiling the graph is finished,
+ *      which is used to profile the startup time
+ *
+ * The phases are:
+ *  - load.parse: read and verify the model structure
+ *  - load.tensor_decode: read and decode the tensor values
+ *  - load.opr: construct the oprs, besides decoding their tensors
+ *  - gopt: an optimization pass, with its name
+ *  - compile: ComputingGraph::compile() in total, including the gopt passes
+ *  - static_mem_plan: update the static memory plan
+ *  - fast_run: profile the algorithms of an opr, with its name
+ *
+ * Note that fast_run may be signaled from the background profiling threads.
+ */
+struct StartupPhaseFinished {
+    const char* phase;
+
+    //! the gopt pass or the opr of the phase, or empty
+    const char* name;
+
+    double time_ms;
+
+    MGB_TYPEINFO_OBJ_DECL;
+};
+
 #if MGB_ENABLE_VAR_DEV_MEM_DEFRAGMENTER
 /*!
  * \brief signaled before graph memory defragementation
@@ -231,6 +257,26 @@ struct SubgraphAssociated {
 struct BeforeMemDefrag {
     MGB_TYPEINFO_OBJ_DECL;
 };
+
+/*!
+ * \brief signaled after graph memory defragementation, which could be used to
+ *      collect fragmentation statistics
+ */
+struct AfterMemDefrag {
+    CompNode comp_node;
+
+    //! whether only part of the vars are moved
+    bool incremental;
+
+    //! total size of the moved chunks in bytes
+    size_t moved_size;
+
+    //! free memory and largest free block on the comp node after
+    //! defragmenting; the latter is 0 if not supported by the allocator
+    size_t free_size, max_free_block;
+
+    MGB_TYPEINFO_OBJ_DECL;
+};
 #endif
 
 }  // namespace event
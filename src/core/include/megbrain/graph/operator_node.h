@@ -490,6 +490,10 @@ public:
 
     virtual ~OperatorNodeBase() noexcept;
 
+    //! allocate storage from the active OprMemArenaScope if there is one
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr) noexcept;
+
 #if MGB_ENABLE_JSON
     /* ===================== json io ===================== */
     std::shared_ptr<json::Value> to_json() const override;
@@ -610,6 +614,15 @@ public:
      */
     virtual void mem_plan_fwd_in2out_writable() {}
 
+    /*!
+     * \brief called by graph compiler to place inputs into sub tensors of
+     *      outputs by VarNode::set_fwd_out2in
+     *
+     * This is called after mem_plan_fwd_in2out_readonly() of all the oprs
+     * and before mem_plan_fwd_in2out_writable()
+     */
+    virtual void mem_plan_fwd_out2in() {}
+
     /* ===================== event callbacks ===================== */
     struct OprEventCallback;
 
@@ -806,6 +819,28 @@ struct OperatorNodeBase::OprEventCallback {
     Maybe<cbptr_t> on_mem_status_changed;
 };
 
+/*!
+ * \brief RAII guard to allocate storage of oprs created in current thread
+ *      from a shared arena
+ *
+ * Oprs are allocated contiguously in creation order (which is topological
+ * order when loading a graph), and the arena is released in bulk after the
+ * guard is destructed and all the oprs allocated in it have been destructed.
+ * Memory of an opr destructed earlier is not reused, so this should only be
+ * used when most of the oprs live as long as the graph.
+ */
+class OprMemArenaScope : public NonCopyableObj {
+public:
+    class Arena;
+
+    OprMemArenaScope();
+    ~OprMemArenaScope() noexcept;
+
+private:
+    Arena* const m_arena;
+    Arena* const m_prev_arena;
+};
+
 //! helper base class for operator mixins
 class OperatorNodeMixinBase : public NonCopyableObj {};
 
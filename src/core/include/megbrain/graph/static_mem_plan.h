@@ -0,0 +1,101 @@
+/**
+ * \file src/core/include/megbrain/graph/static_mem_plan.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/utils/metahelper.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mgb {
+namespace cg {
+
+/*!
+ * \brief process-wide cache of solved static memory allocation plans, keyed
+ *      by the hash of the allocation problem (life intervals, sizes,
+ *      overwrite specs, alignment and padding)
+ *
+ * Plans are added by the PROFILE static memory allocator, by serialized
+ * models carrying precomputed plans, and by the file given in env var
+ * MGB_STATIC_MEM_PLAN_CACHE. Once the cache is non-empty, static memory
+ * allocation of all algorithms looks it up before solving.
+ */
+class StaticMemPlanCache : public NonCopyableObj {
+public:
+    struct Plan {
+        uint64_t hash = 0;
+        size_t tot_alloc = 0, tot_alloc_lower_bound = 0;
+        //! start address of each interval, in the order they are added
+        std::vector<size_t> addr;
+    };
+
+    /*!
+     * \brief collect all the plans used by static memory allocation in the
+     *      current thread during the lifetime of this object
+     *
+     * Recorders could be nested, and each of them sees all the plans. Plans
+     * solved while a recorder is active are also added to the cache.
+     */
+    class Recorder : public NonCopyableObj {
+        friend class StaticMemPlanCache;
+        Recorder* m_prev;
+        std::vector<Plan> m_plans;
+
+    public:
+        Recorder();
+        ~Recorder();
+
+        const std::vector<Plan>& plans() const { return m_plans; }
+    };
+
+    static StaticMemPlanCache& inst();
+
+    //! whether static memory allocation should consult the cache
+    bool active() const;
+
+    //! whether a Recorder is active in current thread
+    static bool recording();
+
+    /*!
+     * \brief find a plan with given hash and number of intervals
+     * \return whether the plan is found
+     */
+    bool get(uint64_t hash, size_t nr_interval, Plan& plan);
+
+    /*!
+     * \brief add a plan to the cache
+     * \param persist whether to also append it to MGB_STATIC_MEM_PLAN_CACHE
+     */
+    void put(const Plan& plan, bool persist = true);
+
+    //! notify the active recorders that a plan is used
+    static void on_plan_used(const Plan& plan);
+
+private:
+    std::mutex m_mtx;
+    std::atomic_bool m_nonempty{false};
+    std::unordered_map<uint64_t, Plan> m_plans;
+    std::string m_fpath;
+
+    StaticMemPlanCache();
+    void load_file();
+    void append_file(const Plan& plan);
+};
+
+}  // namespace cg
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
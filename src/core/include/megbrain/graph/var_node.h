@@ -192,6 +192,15 @@ public:
     //! assign for readonly forward
     MemAllocPlan& assign_for_forward(const MemAllocPlan& src, const SubTensorSpec& sub);
 
+    /*!
+     * \brief move the chunk owned by this plan into a sub tensor of \p dest
+     *
+     * This plan must own its chunk and have the contiguous layout of \p
+     * sub. Readonly-forward readers of this plan are moved along with it.
+     * This is used to implement VarNode::set_fwd_out2in().
+     */
+    MemAllocPlan& move_chunk_into(const MemAllocPlan& dest, const SubTensorSpec& sub);
+
     /*!
      * \brief next readonly-forward reader of this MemAllocPlan
      *
@@ -214,6 +223,9 @@ private:
         MemAllocPlan* next() const { return m_next; }
         void reset();
         inline void insert_after(const MemAllocPlan& prev, MemAllocPlan* self);
+        //! insert the list headed at self and ending at last after prev
+        inline void insert_list_after(
+                const MemAllocPlan& prev, MemAllocPlan* self, MemAllocPlan* last);
         inline void remove_self();
     };
 
@@ -313,6 +325,19 @@ public:
      */
     VarNode& set_fwd_in2out_writable_force(VarNode* input);
 
+    /*!
+     * \brief request that the memory of an input var be a sub tensor of
+     *      this var, so the owner opr does not need to copy it
+     *
+     * The producer of \p input would then write directly into this var.
+     * Note that this function must be called from
+     * OperatorNodeBase::mem_plan_fwd_out2in, and the owner opr should check
+     * whether the input already resides in place when executing.
+     *
+     * \return whether this request could be satisfied
+     */
+    bool set_fwd_out2in(VarNode* input, const SubTensorSpec& sub);
+
     /* ===================== getter and setters =====================  */
 
     OperatorNodeBase* owner_opr() const { return m_owner; }
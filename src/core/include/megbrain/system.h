@@ -41,6 +41,67 @@ int get_cpu_count();
 //! set cpu affinity for caller thread
 void set_cpu_affinity(const std::vector<int>& cpuset);
 
+//! lower the scheduling priority of caller thread, so it only takes idle CPU
+//! time; it is a no-op on platforms without per-thread priority
+void set_thread_low_priority();
+
+//! get number of NUMA nodes on this system; return 1 if NUMA is unavailable
+int get_numa_node_count();
+
+//! get IDs of the CPUs on given NUMA node; return all CPUs if NUMA is
+//! unavailable
+std::vector<int> get_numa_node_cpus(int node);
+
+/*!
+ * \brief bind the pages fully contained in [ptr, ptr + size) to given NUMA
+ *      node, it must be called before the memory is touched
+ * \return whether binding succeeded
+ */
+bool bind_memory_to_numa_node(void* ptr, size_t size, int node);
+
+//! anonymous memory mapped by map_huge_pages()
+struct HugePageMapping {
+    void* ptr = nullptr;
+    //! the mapped size, which is rounded up to the huge page size
+    size_t size = 0;
+    //! whether the pages are explicit huge pages from hugetlbfs, rather than
+    //! transparent huge pages which the kernel may not provide
+    bool hugetlb = false;
+};
+
+/*!
+ * \brief map anonymous memory of at least size bytes on huge pages
+ *
+ * Explicit huge pages of page_size (2MB or 1GB) from the hugetlbfs pool are
+ * tried first, then those of 2MB, and if the pool is exhausted it falls back
+ * to a mapping aligned to 2MB advised by MADV_HUGEPAGE.
+ *
+ * \return the mapping, whose ptr is nullptr if huge pages are unavailable on
+ *      the platform; it should be released by unmap_huge_pages()
+ */
+HugePageMapping map_huge_pages(size_t size, size_t page_size);
+
+void unmap_huge_pages(const HugePageMapping& mapping);
+
+/*!
+ * \brief get the number of bytes backed by huge pages in the memory mappings
+ *      overlapping the given ranges, read from /proc/self/smaps
+ *
+ * The transparent huge pages are counted per mapping, so it may be over
+ * estimated if a range shares a mapping with other memory. 0 if unavailable.
+ */
+size_t get_huge_page_bytes(const std::vector<std::pair<const void*, size_t>>& ranges);
+
+/*!
+ * \brief get IDs of the CPUs grouped by their max frequency, the fastest
+ *      group first
+ *
+ * On big.LITTLE SoCs the first group holds the big cores. All the CPUs are in
+ * one group if the frequency is unavailable, e.g. on platforms other than
+ * linux and android, or if some CPUs are offline.
+ */
+std::vector<std::vector<int>> get_cpu_core_classes();
+
 //! whether stderr supports ansi color code
 bool stderr_ansi_color();
 
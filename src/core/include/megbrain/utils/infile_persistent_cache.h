@@ -0,0 +1,137 @@
+/**
+ * \file src/core/include/megbrain/utils/infile_persistent_cache.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/utils/hash.h"
+#include "megbrain/utils/persistent_cache.h"
+
+namespace mgb {
+
+/*!
+ * \brief persistent cache that can be saved to and loaded from a file
+ *
+ * Dump format (all integers are uint32_t in local endian, effectively little
+ * endian):
+ *
+ *      <magic|8 bytes><format_version><tag_size><tag|uint8_t*>
+ *      <nr_category>[<category_size><category|uint8_t*><nr_blob>
+ *      [<key_size><key|uint8_t*><value_size><value|uint8_t*>]*]*
+ *
+ * The tag identifies the build that produced the cache (see version_tag()).
+ * Entries in a file whose tag differs from the current build are stale,
+ * since profiled algorithms may have been changed or removed, and they are
+ * dropped when loaded. Device traits such as device name and driver version
+ * are already part of the categories (see make_category_from_comp_node()).
+ * Files in the legacy format without magic and tag are still accepted.
+ *
+ * If a path given to this class is a directory, the file for the current
+ * build in that directory (see path_in_dir()) is used, so a directory
+ * shared by many processes or machines can hold caches of several builds.
+ */
+class InFilePersistentCache final : public PersistentCache {
+    struct BlobStorage : public Blob {
+        std::unique_ptr<uint8_t[]> data_refhold;
+        size_t hash = 0;
+
+        BlobStorage& init_data_ref(const Blob& b);
+
+        BlobStorage& init_hash() {
+            hash = XXHash{}.update(ptr, size).digest();
+            return *this;
+        }
+
+        bool operator==(const BlobStorage& rhs) const {
+            return size == rhs.size && !memcmp(ptr, rhs.ptr, size);
+        }
+
+        struct Hash {
+            size_t operator()(const BlobStorage& b) const { return b.hash; }
+        };
+    };
+    std::unordered_map<
+            std::string,
+            std::unordered_map<BlobStorage, BlobStorage, BlobStorage::Hash>>
+            m_cache;
+    mutable MGB_MUTEX m_mtx;
+    //! file to be updated on each put(), or empty to disable syncing
+    std::string m_sync_path;
+
+    //! merge entries in a dumped cache; entries in m_cache are kept
+    size_t merge_locked(const uint8_t* bin, size_t size);
+
+    std::vector<uint8_t> dump_locked() const;
+
+public:
+    InFilePersistentCache() = default;
+
+    /*!
+     * \brief load the cache from a file if it exists
+     * \param always_sync whether to merge the cache into the file on each
+     *      put(); see merge_and_dump_cache()
+     */
+    explicit InFilePersistentCache(const char* path, bool always_sync = false);
+
+    //! load the cache from a memory buffer
+    InFilePersistentCache(const uint8_t* bin, size_t size);
+
+    //! tag of current build, which includes library versions and target arch
+    static std::string version_tag();
+
+    //! path of the cache file of current build in given directory
+    static std::string path_in_dir(const std::string& dir);
+
+    //! path_in_dir() if \p path is a directory, otherwise \p path itself
+    static std::string resolve_path(const char* path);
+
+    /*!
+     * \brief merge entries in a dumped cache into this cache
+     *
+     * Entries already in this cache take precedence.
+     *
+     * \return number of entries merged; it is zero if the cache is stale
+     */
+    size_t merge(const uint8_t* bin, size_t size);
+
+    //! serialize the cache to a buffer
+    std::vector<uint8_t> dump() const;
+
+    /*!
+     * \brief save the cache to a file
+     *
+     * The file is replaced atomically, so processes concurrently loading
+     * the file never see a partially written cache.
+     *
+     * \warning You should invoke dump_cache() or merge_and_dump_cache()
+     *      manually to save the cache file.
+     */
+    void dump_cache(const char* path);
+
+    /*!
+     * \brief merge entries in a file into this cache, and save the merged
+     *      cache back to the file
+     *
+     * The file is locked (on platforms supporting file locks) during the
+     * merge, so concurrent processes sharing a cache file do not lose the
+     * entries of each other.
+     */
+    void merge_and_dump_cache(const char* path);
+
+    //! total number of entries in all categories
+    size_t nr_entries() const;
+
+    Maybe<Blob> get(const std::string& category, const Blob& key) override;
+    void put(const std::string& category, const Blob& key, const Blob& value) override;
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -114,6 +115,29 @@ public:
      */
     void disable_freelist() { m_storage.disable_freelist(); }
 };
+
+/*!
+ * \brief a bump allocator for objects of different sizes
+ *
+ * Objects are allocated contiguously in allocation order, and the memory is
+ * only released in bulk by clear() or destructor. Returned pointers are
+ * aligned to alignof(std::max_align_t).
+ */
+class MemArena {
+    size_t m_cur_buf_pos = 0, m_cur_buf_size_bytes = 0;
+    std::vector<std::unique_ptr<uint8_t[]>> m_buf;
+
+public:
+    MemArena() noexcept;
+    MemArena(MemArena&& rhs) noexcept;
+    ~MemArena() noexcept;
+    MemArena& operator=(MemArena&& rhs) noexcept;
+
+    void* alloc(size_t size);
+
+    //! release all allocated storage
+    void clear();
+};
 }  // namespace mgb
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -44,16 +44,18 @@ public:
 
 class SCQueueSynchronizer {
 public:
-    SCQueueSynchronizer(size_t max_spin) {}
+    SCQueueSynchronizer(size_t) {}
 
     static size_t get_default_max_spin() { return 0; }
+
+    static size_t get_default_ring_size() { return 0; }
 };
 
 // tasks would be dispatched inplace
 template <typename Param, class TaskImpl>
 class AsyncQueueSC : public NonCopyableObj {
 public:
-    AsyncQueueSC(ptrdiff_t max_spin = -1, ptrdiff_t max_items = -1) {}
+    AsyncQueueSC(ptrdiff_t = -1, ptrdiff_t = -1, ptrdiff_t = -1) {}
 
     virtual ~AsyncQueueSC() = default;
 
@@ -76,6 +78,8 @@ public:
      */
     MGB_WARN_UNUSED_RESULT bool all_task_finished() const { return true; }
 
+    bool use_ring_buffer() const { return false; }
+
 protected:
     virtual void on_sync_all_task_finish() {}
     virtual void on_async_queue_worker_thread_start() {}
@@ -82,6 +82,15 @@ public:
     //! get global default max spin from env
     static size_t get_default_max_spin();
 
+    /*!
+     * \brief get global default ring buffer capacity of AsyncQueueSC from
+     *      env MGB_ASYNC_QUEUE_RING_SIZE
+     *
+     * The value is rounded up to a power of 2; 0 means the linked task blocks
+     * are used.
+     */
+    static size_t get_default_ring_size();
+
     void start_worker(std::thread thread);
 
     //! add a new task in producer thread; require worker to have
@@ -120,6 +129,13 @@ public:
  *
  * The worker would be started when first task is added.
  *
+ * Tasks are stored either in a list of linked task blocks (the default) or
+ * in a fixed-size ring buffer. In the ring buffer mode a producer only
+ * performs one atomic increment to allocate a slot and never takes a lock;
+ * it spins and then yields if the ring is full. Tasks added by the worker
+ * itself while the ring is full are kept in a worker-local overflow list, so
+ * a worker can not block on itself.
+ *
  * Note: there are internal size_t counters; on 32-bit platforms they may
  * wrap around within a practical time, which would crash the system.
  *
@@ -149,8 +165,13 @@ class AsyncQueueSC : public NonCopyableObj {
 public:
     //! \param max_spin specify max spin manually, caller must ensure the given value
     //!     is optimal, otherwise caller should leave the value adjustable by user.
-    //! \param max_items limit memory usage by number of items
-    AsyncQueueSC(ptrdiff_t max_spin = -1, ptrdiff_t max_items = -1)
+    //! \param max_items limit memory usage by number of items; it is ignored
+    //!     in the ring buffer mode
+    //! \param ring_size capacity of the ring buffer, 0 for the linked task
+    //!     blocks, and negative for the default given by env
+    AsyncQueueSC(
+            ptrdiff_t max_spin = -1, ptrdiff_t max_items = -1,
+            ptrdiff_t ring_size = -1)
             : m_synchronizer(
                       max_spin >= 0 ? max_spin
                                     : SCQueueSynchronizer::get_default_max_spin()) {
@@ -158,6 +179,16 @@ public:
             // -1 / 2 == 0
             m_block_quota = (max_items - 1) / BLOCK_SIZE + 1;
         }
+        size_t ring = ring_size >= 0 ? static_cast<size_t>(ring_size)
+                                     : SCQueueSynchronizer::get_default_ring_size();
+        if (ring) {
+            m_ring_mask = 1;
+            while (m_ring_mask < ring) {
+                m_ring_mask <<= 1;
+            }
+            m_ring.reset(new SyncedParam[m_ring_mask]);
+            --m_ring_mask;
+        }
     }
 #ifdef WIN32
     bool check_is_into_atexit() {
@@ -257,6 +288,9 @@ public:
         return m_synchronizer.check_finished();
     }
 
+    //! whether the ring buffer is used to store tasks
+    bool use_ring_buffer() const { return static_cast<bool>(m_ring); }
+
     void update_max_items(ptrdiff_t max_items) {
         if (max_items >= 0) {
             // -1 / 2 == 0
@@ -281,6 +315,8 @@ protected:
 
 private:
     static constexpr size_t BLOCK_SIZE = 256;
+    //! spins of a producer waiting for a free ring slot before CPU yield
+    static constexpr size_t RING_FULL_MAX_SPIN = 1024;
     struct TaskBlock {
         size_t first_tid;  //! task id of first task
         TaskBlock* prev = nullptr;
@@ -299,13 +335,85 @@ private:
     Spinlock m_mutex;
     std::condition_variable_any m_cv;
     SyncedParam* m_cur_task = nullptr;
+
+    //! task that is added by the worker while the ring is full; it would be
+    //! processed after the ring slot \p slot is reached
+    struct OverflowTask {
+        size_t slot;
+        SyncedParam param;
+    };
+    //! ring buffer whose size is m_ring_mask + 1; null if not used
+    std::unique_ptr<SyncedParam[]> m_ring;
+    size_t m_ring_mask = 0;
+    std::atomic_size_t m_ring_tail{0},  //!< id of next slot to be allocated
+            m_ring_head{0};             //!< id of next slot to be consumed
+    std::atomic<std::thread::id> m_worker_tid{};
+    std::deque<OverflowTask> m_ring_overflow;  //!< only accessed by worker
+    //! whether m_cur_task is the front of m_ring_overflow
+    bool m_ring_overflow_cur = false;
+
     SCQueueSynchronizer m_synchronizer;
 #if MGB_ENABLE_EXCEPTION
     std::exception_ptr m_worker_exc;  //!< exception caught in worker
 #endif
 
-    MGB_NOINLINE
     SyncedParam* allocate_task() {
+        if (m_ring) {
+            return allocate_ring_task();
+        }
+        return allocate_block_task();
+    }
+
+    //! start the worker thread with m_mutex held
+    void start_worker_unsafe() {
+#ifdef WIN32
+        if (!SCQueueSynchronizer::is_into_atexit) {
+            auto cb_atexit = [] { SCQueueSynchronizer::is_into_atexit = true; };
+            auto err = atexit(cb_atexit);
+            mgb_assert(
+                    !err,
+                    "failed to register windows_call_atexit "
+                    "at exit");
+        }
+#endif
+        m_synchronizer.start_worker(
+                std::thread{&AsyncQueueSC::worker_thread_impl, this});
+    }
+
+    MGB_NOINLINE
+    SyncedParam* allocate_ring_task() {
+        if (!m_queue_tail_tid.fetch_add(1, std::memory_order_relaxed)) {
+            MGB_LOCK_GUARD(m_mutex);
+            start_worker_unsafe();
+        }
+        const size_t cap = m_ring_mask + 1;
+        size_t slot;
+        if (std::this_thread::get_id() ==
+            m_worker_tid.load(std::memory_order_relaxed)) {
+            // the worker must not wait for itself to free a slot
+            slot = m_ring_tail.load(std::memory_order_relaxed);
+            do {
+                if (slot - m_ring_head.load(std::memory_order_acquire) >= cap) {
+                    m_ring_overflow.emplace_back();
+                    m_ring_overflow.back().slot = slot;
+                    return &m_ring_overflow.back().param;
+                }
+            } while (!m_ring_tail.compare_exchange_weak(
+                    slot, slot + 1, std::memory_order_relaxed));
+        } else {
+            slot = m_ring_tail.fetch_add(1, std::memory_order_relaxed);
+            for (size_t spin = 0;
+                 slot - m_ring_head.load(std::memory_order_acquire) >= cap; ++spin) {
+                if (spin >= RING_FULL_MAX_SPIN) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        return &m_ring[slot & m_ring_mask];
+    }
+
+    MGB_NOINLINE
+    SyncedParam* allocate_block_task() {
         TaskBlock* tail = m_queue_tail;
         const size_t tid = m_queue_tail_tid.fetch_add(1, std::memory_order_relaxed);
         int offset;
@@ -317,18 +425,7 @@ private:
             // reload newest tail
             tail = m_queue_tail;
             if (!m_synchronizer.worker_started()) {
-#ifdef WIN32
-                if (!SCQueueSynchronizer::is_into_atexit) {
-                    auto cb_atexit = [] { SCQueueSynchronizer::is_into_atexit = true; };
-                    auto err = atexit(cb_atexit);
-                    mgb_assert(
-                            !err,
-                            "failed to register windows_call_atexit "
-                            "at exit");
-                }
-#endif
-                m_synchronizer.start_worker(
-                        std::thread{&AsyncQueueSC::worker_thread_impl, this});
+                start_worker_unsafe();
             }
             if (!tail) {
                 m_queue_head = allocate_task_block_unsafe(nullptr);
@@ -377,6 +474,7 @@ private:
     }
 
     void worker_thread_impl() {
+        m_worker_tid.store(std::this_thread::get_id(), std::memory_order_relaxed);
         on_async_queue_worker_thread_start();
         size_t qh = 0;
 
@@ -390,13 +488,56 @@ private:
             if (m_cur_task) {
                 m_cur_task->fini();
                 m_cur_task = nullptr;
+                if (m_ring) {
+                    ring_task_done();
+                }
             }
             m_synchronizer.consumer_commit(1);
             m_finished_task.fetch_add(1, std::memory_order_release);
         }
     }
 
+    //! release the slot or overflow entry of m_cur_task in ring mode; called
+    //! after the task is finished
+    void ring_task_done() {
+        if (m_ring_overflow_cur) {
+            m_ring_overflow_cur = false;
+            m_ring_overflow.pop_front();
+        } else {
+            m_ring_head.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void worker_thread_impl_ring() {
+        for (;;) {
+            if (!m_synchronizer.consumer_fetch(1))
+                return;
+
+            auto head = m_ring_head.load(std::memory_order_relaxed);
+            SyncedParam* cur;
+            if (!m_ring_overflow.empty() && m_ring_overflow.front().slot <= head) {
+                m_ring_overflow_cur = true;
+                cur = &m_ring_overflow.front().param;
+            } else {
+                cur = &m_ring[head & m_ring_mask];
+            }
+            while (!cur->init_done.load(std::memory_order_acquire))
+                ;
+            cur->init_done.store(false, std::memory_order_relaxed);
+            m_cur_task = cur;
+            static_cast<TaskImpl*>(this)->process_one_task(*cur->get());
+            m_cur_task = nullptr;
+            cur->fini();
+            ring_task_done();
+            m_synchronizer.consumer_commit(1);
+            m_finished_task.fetch_add(1, std::memory_order_release);
+        }
+    }
+
     void worker_thread_impl_no_exc(size_t* __restrict__ qh_ptr) {
+        if (m_ring) {
+            return worker_thread_impl_ring();
+        }
         size_t& qh = *qh_ptr;
         for (;;) {
             if (!m_synchronizer.consumer_fetch(1))
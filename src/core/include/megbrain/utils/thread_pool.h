@@ -16,16 +16,32 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
 #include <vector>
+#include "megbrain/utils/thread.h"
 
 namespace mgb {
 
 using MultiThreadingTask = thin_function<void(size_t, size_t)>;
 using AffinityCallBack = thin_function<void(size_t)>;
+
+/*!
+ * \brief scheduling priority of a task in WORK_STEALING mode
+ *
+ * The idle threads always take the chunks of the highest priority first, and
+ * the chunks of the same priority are interleaved over the deques, so the
+ * tasks submitted by several callers share the threads at chunk granularity.
+ * It is ignored in FORK_JOIN mode.
+ */
+enum class TaskPriority : uint32_t { LOW = 0, NORMAL = 1, HIGH = 2 };
+static constexpr size_t NR_TASK_PRIORITY = 3;
+
 /**
  * \brief task element
  */
@@ -34,6 +50,33 @@ struct TaskElem {
     MultiThreadingTask task;
     //! number of the parallelism
     size_t nr_parallelism;
+    //! number of consecutive sub tasks which are scheduled as one stealable
+    //! chunk in work-stealing mode; 0 means decided by the thread pool
+    size_t grain_size = 0;
+    //! see TaskPriority
+    TaskPriority priority = TaskPriority::NORMAL;
+};
+
+/*!
+ * \brief schedule policy of ThreadPool
+ *
+ * FORK_JOIN: only one task is in flight, every add_task() is a barrier
+ * WORK_STEALING: each thread owns a deque of chunks and steals from others
+ *      when idle, so several tasks submitted by submit() can run at the
+ *      same time
+ */
+enum class ThreadPoolMode : uint32_t { FORK_JOIN = 0, WORK_STEALING = 1 };
+
+/*!
+ * \brief how an idle worker waits for new sub tasks while the pool is active
+ *
+ * The worker busy-spins nr_spin rounds, then calls std::this_thread::yield()
+ * nr_yield rounds, and at last parks on a condition variable until a new task
+ * comes. The default never parks, which keeps the lowest wake-up latency.
+ */
+struct ThreadPoolWaitPolicy {
+    size_t nr_spin = 0;
+    size_t nr_yield = std::numeric_limits<size_t>::max();
 };
 
 #if MGB_HAVE_THREAD
@@ -57,15 +100,56 @@ public:
  * will fallback to single-thread mode if nr_thread is 1.
  */
 class ThreadPool : public NonCopyableObj {
+    struct TaskGroup;
+
 public:
+    //! handle of a task submitted by submit(), used to wait for it
+    using TaskHandle = std::shared_ptr<TaskGroup>;
+
     //! Create thread-pool nr_threads thread_pool
-    ThreadPool(size_t nr_threads);
+    ThreadPool(size_t nr_threads, ThreadPoolMode mode = default_mode());
     //! The main thread set the task, parallelism and worker flag to
     //! notify other thread.
     void add_task(const TaskElem& task_elem);
 
+    /*!
+     * \brief submit a task without waiting for it
+     *
+     * Only meaningful in WORK_STEALING mode; in FORK_JOIN mode the task is
+     * finished before return. The task is copied, so task_elem need not
+     * outlive this call.
+     */
+    TaskHandle submit(const TaskElem& task_elem);
+
+    /*!
+     * \brief wait for a task returned by submit()
+     *
+     * The calling thread helps to execute pending chunks with thread id
+     * nr_threads() - 1 if no other thread is using that id.
+     */
+    void wait(const TaskHandle& handle);
+
     size_t nr_threads() const;
 
+    ThreadPoolMode mode() const { return m_mode; }
+
+    //! default mode, WORK_STEALING if MGB_THREAD_POOL_WORK_STEALING is set
+    static ThreadPoolMode default_mode();
+
+    //! set how idle workers wait, it can be called at any time
+    void set_wait_policy(const ThreadPoolWaitPolicy& policy);
+
+    ThreadPoolWaitPolicy wait_policy() const {
+        return {m_nr_spin.load(std::memory_order_relaxed),
+                m_nr_yield.load(std::memory_order_relaxed)};
+    }
+
+    /*!
+     * \brief default wait policy, which can be set by the env var
+     *      MGB_THREAD_POOL_WAIT_POLICY in the form of "nr_spin:nr_yield"
+     */
+    static ThreadPoolWaitPolicy default_wait_policy();
+
     //! Set the affinity of all the threads
     void set_affinity(AffinityCallBack affinity_cb);
 
@@ -78,7 +162,38 @@ public:
     ~ThreadPool();
 
 private:
+    //! a chunk of sub tasks [begin, end) of one TaskGroup
+    struct WorkItem {
+        TaskHandle group;
+        size_t begin, end;
+    };
+    //! per-thread chunk deques of each priority, owner pops from back and
+    //! thieves from front
+    struct alignas(64) WorkDeque {
+        Spinlock mtx;
+        std::deque<WorkItem> items[NR_TASK_PRIORITY];
+    };
+
+    void worker_fork_join(size_t id);
+    void worker_work_stealing(size_t id);
+    void bind_worker_affinity(size_t id);
+    //! wait in an idle worker which has been idle for nr_idle rounds
+    void idle_wait(size_t id, size_t nr_idle);
+    //! whether there is work for the given worker
+    bool has_work(size_t id) const;
+    //! wake up the workers parked by idle_wait()
+    void notify_parked();
+    //! enqueue all the chunks of group, round-robin over the deques
+    void push_chunks(const TaskHandle& group, const TaskElem& task_elem);
+    //! execute one chunk from own deque or stolen from others
+    bool run_one_chunk(size_t id);
+    //! take one chunk of the given priority, return whether found
+    bool take_chunk(size_t id, size_t priority, WorkItem& item);
+    //! run chunks as the caller until counter becomes zero
+    void help_until_zero(const std::atomic_size_t& counter);
+
     size_t m_nr_threads = 1;
+    const ThreadPoolMode m_mode;
     //! Indicate whether the main thread have binding
     bool m_main_affinity_flag;
     //! The callback binding the threads to cores
@@ -97,6 +212,22 @@ private:
     std::condition_variable m_cv;
     std::mutex m_mutex;
     std::mutex m_mutex_task;
+
+    //! deques of WORK_STEALING mode, the last one belongs to the caller
+    std::unique_ptr<WorkDeque[]> m_deques;
+    //! number of sub tasks pushed but not finished in WORK_STEALING mode
+    std::atomic_size_t m_nr_pending{0};
+    //! m_nr_pending of each priority, used to skip the empty priorities
+    std::atomic_size_t m_nr_pending_of[NR_TASK_PRIORITY] = {};
+    //! next deque to receive a chunk in push_chunks()
+    std::atomic_size_t m_next_deque{0};
+    //! whether some caller thread is executing with id m_nr_threads - 1
+    std::atomic_flag m_caller_slot_busy = ATOMIC_FLAG_INIT;
+
+    //! see ThreadPoolWaitPolicy
+    std::atomic_size_t m_nr_spin{0}, m_nr_yield{0};
+    //! number of workers parked in idle_wait()
+    std::atomic_size_t m_nr_parked{0};
 };
 #else
 /**
@@ -104,8 +235,19 @@ private:
  */
 class ThreadPool : public NonCopyableObj {
 public:
-    ThreadPool(size_t) {}
+    using TaskHandle = std::shared_ptr<void>;
+    ThreadPool(size_t, ThreadPoolMode = ThreadPoolMode::FORK_JOIN) {}
     void add_task(const TaskElem& task_elem);
+    TaskHandle submit(const TaskElem& task_elem) {
+        add_task(task_elem);
+        return {};
+    }
+    void wait(const TaskHandle&) {}
+    ThreadPoolMode mode() const { return ThreadPoolMode::FORK_JOIN; }
+    static ThreadPoolMode default_mode() { return ThreadPoolMode::FORK_JOIN; }
+    void set_wait_policy(const ThreadPoolWaitPolicy&) {}
+    ThreadPoolWaitPolicy wait_policy() const { return {}; }
+    static ThreadPoolWaitPolicy default_wait_policy() { return {}; }
     void set_affinity(AffinityCallBack affinity_cb);
     void active() {}
     void deactive() {}
@@ -247,6 +247,63 @@ TEST(TestCompNodeCPU, CoreAffinity) {
     ASSERT_EQ(data_v[1], static_cast<size_t>(30));
 }
 
+TEST(TestCompNodeCPU, NumaBinding) {
+    REQUIRE_THREAD();
+    auto nr_node = sys::get_numa_node_count();
+    ASSERT_GE(nr_node, 1);
+    for (int i = 0; i < nr_node; ++i) {
+        ASSERT_FALSE(sys::get_numa_node_cpus(i).empty());
+    }
+    bool old = CompNode::enable_numa_for_cpu(true);
+    //! use fresh streams so the worker threads start with numa enabled
+    for (auto&& str : {"cpu0:17", "multithread2:3"}) {
+        auto cn = CompNode::load(str);
+        constexpr size_t SIZE = 1 << 20;
+        auto ptr = static_cast<uint8_t*>(cn.alloc_device(SIZE));
+        auto&& env = CompNodeEnv::from_comp_node(cn).cpu_env();
+        auto task = [ptr](size_t index, size_t) {
+            memset(ptr + index * (SIZE / 4), index, SIZE / 4);
+        };
+        env.dispatch(task, 4u);
+        cn.sync();
+        for (size_t i = 0; i < SIZE; i += 4096) {
+            ASSERT_EQ(static_cast<size_t>(ptr[i]), i / (SIZE / 4));
+        }
+        cn.free_device(ptr);
+        cn.sync();
+    }
+    CompNode::enable_numa_for_cpu(old);
+}
+
+TEST(TestCompNodeCPU, HugePages) {
+    size_t old = CompNode::set_cpu_huge_page_size(2 << 20);
+    auto cn = CompNode::load("cpu0");
+    auto before = CompNode::get_cpu_huge_page_stats();
+    constexpr size_t SIZE = 3 << 20;
+    auto ptr = static_cast<uint8_t*>(cn.alloc_device(SIZE));
+    memset(ptr, 1, SIZE);
+    auto stats = CompNode::get_cpu_huge_page_stats();
+#if defined(__linux__) && !defined(ANDROID) && !defined(__ANDROID__)
+    //! rounded up to the huge pages
+    ASSERT_EQ(stats.nr_bytes_mapped, before.nr_bytes_mapped + (4 << 20));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % (2 << 20), 0u);
+#endif
+    ASSERT_LE(stats.nr_bytes_huge, stats.nr_bytes_mapped);
+
+    //! small allocations are on the heap
+    auto small = cn.alloc_device(4096);
+    ASSERT_EQ(CompNode::get_cpu_huge_page_stats().nr_bytes_mapped,
+              stats.nr_bytes_mapped);
+
+    cn.free_device(ptr);
+    cn.free_device(small);
+    cn.sync();
+    ASSERT_EQ(CompNode::get_cpu_huge_page_stats().nr_bytes_mapped,
+              before.nr_bytes_mapped);
+    CompNode::set_cpu_huge_page_size(old);
+    ASSERT_THROW(CompNode::set_cpu_huge_page_size(4096), MegBrainError);
+}
+
 TEST(TestCompNode, CPU_MULTI_THREAD) {
     REQUIRE_THREAD();
     std::vector<int> source(100), dst0(100), dst1(100);
@@ -652,6 +709,48 @@ TEST(TestCompNode, MultipleLoad) {
     }
 }
 
+TEST(TestCompNode, BatchedCopy) {
+    auto run = [](CompNode cn) {
+        constexpr size_t SIZE = 64;
+        HostTensorND host(cn, {SIZE}, dtype::Int32{}),
+                result(cn, {SIZE}, dtype::Int32{});
+        DeviceTensorND dev(cn, {SIZE}, dtype::Int32{});
+        auto ph = host.ptr<int>(), pr = result.ptr<int>();
+        auto pd = dev.ptr<int>();
+        for (size_t i = 0; i < SIZE; ++i) {
+            ph[i] = i;
+            pr[i] = -1;
+        }
+        // reversed pieces of unequal sizes, some of which are adjacent
+        std::vector<CompNode::CopySegment> h2d, d2h;
+        for (size_t begin = 0, piece = 1; begin < SIZE; begin += piece++) {
+            size_t size = std::min(piece, SIZE - begin) * sizeof(int);
+            h2d.push_back({pd + SIZE - begin - size / sizeof(int), ph + begin, size});
+        }
+        h2d.push_back({pd + SIZE / 2, ph, 4 * sizeof(int)});
+        h2d.push_back({pd + SIZE / 2 + 4, ph + 4, 4 * sizeof(int)});
+        for (size_t i = 0; i < SIZE; i += 8) {
+            d2h.push_back({pr + i, pd + i, 8 * sizeof(int)});
+        }
+        cn.batched_copy_to_device(h2d.data(), h2d.size());
+        cn.batched_copy_to_host(d2h.data(), d2h.size());
+        cn.sync();
+
+        std::vector<int> expect(SIZE);
+        for (auto&& i : h2d) {
+            memcpy(expect.data() + (static_cast<int*>(i.dest) - pd),
+                   static_cast<const int*>(i.src), i.size);
+        }
+        for (size_t i = 0; i < SIZE; ++i) {
+            ASSERT_EQ(expect[i], pr[i]) << "i=" << i;
+        }
+    };
+    run(CompNode::load("cpux"));
+    if (check_gpu_available(1)) {
+        run(CompNode::load("gpux"));
+    }
+}
+
 #if MGB_CAMBRICON
 TEST(TestCompNodeCambricon, D2DCopy) {
     auto run = [](CompNode cn) {
@@ -795,6 +894,45 @@ TEST(TestCompNode, DepedentObjectList) {
     }
 }
 
+#if MGB_CUDA && CUDART_VERSION >= 11010
+TEST(TestCompNodeCUDA, SeqRecorder) {
+    REQUIRE_GPU(1);
+    using ConvParam = opr::Convolution::Param;
+    ConvParam param;
+    param.sparse = ConvParam::Sparse::GROUP;
+    auto cn = CompNode::load("gpu0");
+    HostTensorGenerator<> gen;
+    for (bool fake_first : {false, true}) {
+        auto host_x = gen({3, 4, 10, 8}, cn), host_y = gen({2, 3, 2, 3, 3}, cn);
+        auto graph = ComputingGraph::make();
+        graph->options().comp_node_seq_record_level = 1;
+        graph->options().var_sanity_check_first_run = false;
+        graph->options().fake_next_exec = fake_first;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             y = opr::Host2DeviceCopy::make(*graph, host_y),
+             z = opr::Convolution::make(x, y, param);
+        HostTensorND host_z;
+        auto func = graph->compile({make_callback_copy(z, host_z, false)});
+        if (fake_first) {
+            func->execute().wait();
+        }
+        for (int i = 0; i < 8; ++i) {
+            if (i == 4) {
+                // memory reallocation would trigger re-recording
+                *host_x = *gen({2, 4, 15, 13}, cn);
+            }
+            host_x->copy_from_fixlayout(*gen(host_x->shape(), cn));
+            // results of replayed graphs are only visible after wait()
+            func->execute().wait();
+            auto expect = comp_node_test::eval_conv_cpu<opr::Convolution>(
+                    *host_x, *host_y, param);
+            MGB_ASSERT_TENSOR_NEAR(expect, host_z, 1e-3)
+                    << "fake_first=" << fake_first << " iter=" << i;
+        }
+    }
+}
+#endif
+
 namespace {
 template <typename tag>
 class TestCPUCompSeqRec : public ::testing::Test {};
@@ -814,6 +952,7 @@ TYPED_TEST(TestCPUCompSeqRec, run_multi_thread_default) {
     auto cn = CompNode::load("multithread:default:4");
     comp_node_test::seq_rec::run<TypeParam>(cn);
 }
+
 }  // anonymous namespace
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -518,6 +518,44 @@ void run<multi_recorder_run>(CompNode cn) {
     }
 }
 
+//! recorders for different input shapes are cached and replayed
+template <>
+void run<shape_cache>(CompNode cn) {
+    using ConvParam = opr::Convolution::Param;
+    ConvParam param;
+    param.sparse = ConvParam::Sparse::GROUP;
+    HostTensorGenerator<> gen;
+    // host buffers must be kept for each recorded shape
+    auto host_x0 = gen({3, 4, 10, 8}, cn), host_x1 = gen({2, 4, 15, 13}, cn),
+         host_y = gen({2, 3, 2, 3, 3}, cn);
+    auto host_x = std::make_shared<HostTensorND>(*host_x0);
+
+    int iter = 0;
+    std::vector<int> executed;
+
+    HostTensorND host_z;
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         y = opr::Host2DeviceCopy::make(*graph, host_y),
+         z = opr::CallbackInjector::make(
+                 opr::Convolution::make(x, y, param),
+                 [&](DeviceTensorND&) { executed.push_back(iter); });
+    graph->options().comp_node_seq_record_level = 1;
+    graph->options().comp_node_seq_record_cache_size = 2;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+    for (; iter < 10; ++iter) {
+        // shape sequence: 0 0 1 1 0 1 0 1 0 1
+        *host_x = (iter < 2 || (iter >= 4 && iter % 2 == 0)) ? *host_x0 : *host_x1;
+        host_x->copy_from_fixlayout(*gen(host_x->shape(), cn));
+        func->execute();
+        auto expect = eval_conv_cpu<opr::Convolution>(*host_x, *host_y, param);
+        MGB_ASSERT_TENSOR_NEAR(expect, host_z, 1e-3) << "iter " << iter;
+    }
+    // each shape is executed normally and then recorded; later executions
+    // all replay the cached recorders
+    ASSERT_EQ(executed, std::vector<int>({0, 1, 2, 3}));
+}
+
 template <>
 void run<void>(CompNode) {}
 
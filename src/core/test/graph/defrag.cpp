@@ -23,7 +23,9 @@ using namespace mgb;
 // defrag only works when exception is enabled
 
 namespace {
-void run_graph(size_t mem_reserved, bool enable_defrag) {
+void run_graph(
+        size_t mem_reserved, bool enable_defrag, size_t incremental_limit = 0,
+        size_t* nr_defrag = nullptr) {
     CompNode::try_coalesce_all_free_memory();
     CompNode::finalize();
     auto cn = CompNode::load("gpux");
@@ -44,6 +46,7 @@ void run_graph(size_t mem_reserved, bool enable_defrag) {
 
     auto graph = ComputingGraph::make();
     graph->options().enable_var_mem_defragment = enable_defrag;
+    graph->options().var_mem_defragment_incremental_limit = incremental_limit;
     graph->options().force_dynamic_alloc = true;
     graph->options().graph_opt_level = 0;
     graph->options().var_sanity_check_first_run = false;
@@ -63,6 +66,21 @@ void run_graph(size_t mem_reserved, bool enable_defrag) {
 
     set_priority(y0, 100);  // y0 executes after defrag
 
+    auto hdl = graph->event().register_receiver<cg::event::AfterMemDefrag>(
+            [&](const cg::event::AfterMemDefrag& ev) {
+                ASSERT_EQ(cn, ev.comp_node);
+                ASSERT_GT(ev.moved_size, 0u);
+                if (!incremental_limit) {
+                    ASSERT_FALSE(ev.incremental);
+                }
+                if (ev.incremental) {
+                    ASSERT_LE(ev.moved_size, incremental_limit);
+                }
+                if (nr_defrag) {
+                    ++*nr_defrag;
+                }
+            });
+
     HostTensorND host_y;
     auto func = graph->compile({make_callback_copy(y, host_y)});
     func->execute();
@@ -100,6 +118,11 @@ TEST(TestGraph, Defragment) {
     auto do_run = [reserve]() {
         ASSERT_THROW(run_graph(reserve, false), MemAllocError);
         run_graph(reserve, true);
+        // moving the vars around a free region incrementally is tried first,
+        // and all the vars are moved if it does not make enough room
+        size_t nr_defrag = 0;
+        run_graph(reserve, true, reserve, &nr_defrag);
+        ASSERT_GT(nr_defrag, 0u);
     };
 
     // reserve memory explicitly to avoid uncontrollable factors
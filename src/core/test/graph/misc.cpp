@@ -25,6 +25,7 @@
 #include "megbrain/opr/tensor_manip.h"
 #include "megbrain/opr/utility.h"
 #include "megbrain/plugin/profiler.h"
+#include "megbrain/utils/persistent_cache.h"
 #include "megbrain/utils/timer.h"
 
 #include "megbrain/test/helper.h"
@@ -449,6 +450,54 @@ TEST(TestGraph, CompileTwice) {
     EXPECT_EQ(host_x->ptr<float>()[0] + 2, host_z2.ptr<float>()[0]);
 }
 
+TEST(TestGraph, ReattachCompSeq) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({23});
+
+    auto graph = ComputingGraph::make();
+    graph->options().allow_reattach_comp_seq = true;
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x), y = x * 2,
+         z1 = opr::Copy::make(y + 1), z2 = opr::Copy::make(y - 1);
+
+    // y is shared by both functions, so they share its callback caller while
+    // writing into different host tensors
+    HostTensorND host_z1, host_z2, host_y1, host_y2;
+    auto func1 = graph->compile(
+            {make_callback_copy(z1, host_z1), make_callback_copy(y, host_y1)});
+    auto func2 = graph->compile(
+            {make_callback_copy(z2, host_z2), make_callback_copy(y, host_y2)});
+    for (int i = 0; i < 3; ++i) {
+        *host_x = *gen({23});
+        host_y1 = {};
+        host_y2 = {};
+        func1->execute().wait();
+        EXPECT_FALSE(graph->var_receiver_in_current_comp_seq(z1.node()).empty());
+        EXPECT_TRUE(graph->var_receiver_in_current_comp_seq(z2.node()).empty());
+        ASSERT_FALSE(host_y1.empty());
+        ASSERT_TRUE(host_y2.empty());
+        auto px = host_x->ptr<float>(), py1 = host_y1.ptr<float>();
+        for (size_t j = 0; j < 23; ++j) {
+            ASSERT_EQ(px[j] * 2, py1[j]);
+        }
+
+        host_y1 = {};
+        func2->execute().wait();
+        EXPECT_TRUE(graph->var_receiver_in_current_comp_seq(z1.node()).empty());
+        ASSERT_TRUE(host_y1.empty());
+        ASSERT_FALSE(host_y2.empty());
+        auto pz1 = host_z1.ptr<float>(), pz2 = host_z2.ptr<float>(),
+             py2 = host_y2.ptr<float>();
+        for (size_t j = 0; j < 23; ++j) {
+            ASSERT_EQ(px[j] * 2 + 1, pz1[j]);
+            ASSERT_EQ(px[j] * 2 - 1, pz2[j]);
+            ASSERT_EQ(px[j] * 2, py2[j]);
+        }
+    }
+
+    graph->options().allow_reattach_comp_seq = false;
+    ASSERT_THROW(func1->execute(), GraphError);
+}
+
 TEST(TestGraph, MultiCNDynamicInputs) {
     auto cns = load_multiple_xpus(3);
     HostTensorGenerator<> gen;
@@ -1014,6 +1063,96 @@ TEST(TestGraph, CopyStream) {
     ASSERT_EQ(int(CompNode::Stream::COPY), host_gx.comp_node().locator().stream);
 }
 
+TEST(TestGraph, CPUOprParallelStreams) {
+    REQUIRE_THREAD();
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({5, 6}, cn);
+    auto run = [&](size_t nr_stream, ThinHashSet<int>* streams) {
+        auto graph = ComputingGraph::make();
+        graph->options().seq_opt.cpu_opr_parallel_streams = nr_stream;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+        SymbolVar z;
+        for (int i = 0; i < 4; ++i) {
+            auto y = x * (i + 1.f);
+            for (int j = 0; j < 3; ++j) {
+                y = opr::relu(y - (j + .5f)) + x;
+            }
+            z = i ? z + y : y;
+        }
+        HostTensorND host_z;
+        auto func = graph->compile({make_callback_copy(z, host_z)});
+        func->execute().wait();
+        if (streams) {
+            func->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+                streams->insert(opr->output(0)->comp_node().locator().stream);
+                return true;
+            });
+        }
+        return host_z;
+    };
+    ThinHashSet<int> streams;
+    auto expect = run(0, nullptr), get = run(4, &streams);
+    MGB_ASSERT_TENSOR_EQ(expect, get);
+    ASSERT_GE(streams.size(), 4u);
+}
+
+TEST(TestGraph, MemAwareOprOrder) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({64, 64});
+    // returns result and peak of live var memory computed from the seq
+    auto run = [&](bool mem_aware, size_t window, std::vector<size_t>* ids) {
+        auto graph = ComputingGraph::make();
+        graph->options().seq_opt.enable_mem_aware_opr_order = mem_aware;
+        graph->options().seq_opt.mem_aware_opr_order_window = window;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x) + 1;
+        SymbolVar z;
+        for (int i = 0; i < 6; ++i) {
+            auto y = opr::reduce_sum(
+                    opr::relu(x * (i + 1.f)) + x, x.make_scalar(1));
+            z = i ? z + y : y;
+        }
+        HostTensorND host_z;
+        auto func = graph->compile({make_callback_copy(z, host_z)});
+        func->execute();
+
+        ThinHashMap<VarNode*, size_t> nr_reader;
+        cg::OprNodeArray seq;
+        func->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+            seq.push_back(opr);
+            if (ids)
+                ids->push_back(opr->id());
+            for (auto i : opr->input())
+                ++nr_reader[i];
+            return true;
+        });
+        size_t live = 0, peak = 0;
+        for (auto opr : seq) {
+            for (auto i : opr->output()) {
+                if (nr_reader[i])
+                    live += i->dtype().size(i->shape().total_nr_elems());
+            }
+            peak = std::max(peak, live);
+            for (auto i : opr->input()) {
+                if (!--nr_reader[i])
+                    live -= i->dtype().size(i->shape().total_nr_elems());
+            }
+        }
+        return std::make_pair(host_z, peak);
+    };
+
+    std::vector<size_t> ids_default, ids_window1;
+    auto expect = run(false, 16, &ids_default);
+    auto get = run(true, 16, nullptr);
+    MGB_ASSERT_TENSOR_EQ(expect.first, get.first);
+    ASSERT_LE(get.second, expect.second);
+
+    // with window 1 the head of the queue is always chosen
+    auto get1 = run(true, 1, &ids_window1);
+    MGB_ASSERT_TENSOR_EQ(expect.first, get1.first);
+    ASSERT_EQ(ids_default, ids_window1);
+}
+
 TEST(TestGraph, DynShapeDepCrossCN) {
     auto cns = load_multiple_xpus(2);
     HostTensorGenerator<> gen;
@@ -1129,6 +1268,37 @@ TEST(TestGraph, InputWaitingSpec) {
     check_wait(z0, {});
 }
 
+TEST(TestGraph, InputWaitingSpecTransitive) {
+    auto cns = load_multiple_xpus(3);
+    constexpr size_t SIZE = 12345;
+    HostTensorGenerator<> gen;
+    auto host_x = gen({SIZE}, cns[0]);
+    auto graph = ComputingGraph::make();
+    graph->options().seq_opt.enable_seq_comp_node_opt = false;  // no copy stream
+    auto x = opr::Host2DeviceCopy::make_no_fwd(*graph, host_x),
+         y = opr::Copy::make(x, cns[1]), z = opr::Copy::make(y + 1, cns[2]),
+         w = opr::Copy::make(x, cns[2]);
+    set_priority(y, 5);
+    set_priority(z, 10);
+    set_priority(w, 15);
+
+    HostTensorND host_z, host_w;
+    auto func = graph->compile(
+            {make_callback_copy(z, host_z), make_callback_copy(w, host_w)});
+    func->execute();
+
+    auto px = host_x->ptr<float>(), pz = host_z.ptr<float>(),
+         pw = host_w.ptr<float>();
+    for (size_t i = 0; i < SIZE; ++i) {
+        MGB_ASSERT_FLOAT_EQ(px[i] + 1, pz[i]);
+        MGB_ASSERT_FLOAT_EQ(px[i], pw[i]);
+    }
+    check_wait(y, x);
+    check_wait(z, y + 1);
+    // x is known to have finished on cns[2] after waiting on y + 1
+    check_wait(w, {});
+}
+
 TEST(TestGraph, InputWaitingSpecMultiOut) {
     auto cn0 = CompNode::load("xpu0:0"), cn1 = CompNode::load("xpu0:1");
     HostTensorGenerator<> gen;
@@ -1696,6 +1866,55 @@ TEST(TestGraph, ExecutionMask) {
     ASSERT_EQ(2, called);
 }
 
+TEST(TestGraph, ExecutionMaskNested) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({1});
+    int called[4] = {0};
+    auto make_cb = [&](int idx) {
+        return [&called, idx](DeviceTensorND&) { ++called[idx]; };
+    };
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+    cg::ExecutionMask* masks[3];
+    SymbolVar y = x;
+    for (int i = 0; i < 3; ++i) {
+        y = opr::CallbackInjector::make(y, make_cb(i));
+        auto mask = std::make_shared<cg::ExecutionMask>(nullptr);
+        mask->register_to_opr(y.node()->owner_opr());
+        if (i) {
+            masks[i - 1]->add_nested(mask.get());
+        }
+        masks[i] = mask.get();
+    }
+    auto z = opr::CallbackInjector::make(x, make_cb(3));
+    auto func = graph->compile({{y, {}}, {z, {}}});
+    for (auto i : masks) {
+        i->enable(true);
+    }
+    func->execute();
+    ASSERT_EQ(1, called[0]);
+    ASSERT_EQ(1, called[2]);
+
+    // all the nested masks are disabled with the outermost one
+    masks[0]->enable(false);
+    for (auto i : masks) {
+        ASSERT_FALSE(i->enabled());
+    }
+    func->execute();
+    ASSERT_EQ(1, called[0]);
+    ASSERT_EQ(1, called[1]);
+    ASSERT_EQ(1, called[2]);
+    ASSERT_EQ(2, called[3]);
+
+    masks[0]->enable(true);
+    masks[1]->enable(true);
+    func->execute();
+    ASSERT_EQ(2, called[0]);
+    ASSERT_EQ(2, called[1]);
+    ASSERT_EQ(1, called[2]);
+    ASSERT_EQ(3, called[3]);
+}
+
 TEST(TestGraph, AsyncRelease) {
     // check that async release happens before reset var mem plan (when mem plan
     // is reset, var
@@ -2010,6 +2229,83 @@ TEST(TestGraph, RecordFreeMemoryInWeightPreprocess) {
     megdnn::HeuristicCache::instance().clear();
 }
 
+namespace {
+//! count the hits and puts of the preprocessed weights
+class WeightPreprocessCountingCache final : public PersistentCache {
+    std::shared_ptr<PersistentCache> m_impl =
+            std::make_shared<InMemoryPersistentCache>();
+
+    static bool is_weight_preprocess(const std::string& category) {
+        return !category.compare(0, 18, "weight_preprocess:");
+    }
+
+public:
+    std::atomic_size_t nr_hit{0}, nr_put{0};
+
+    Maybe<Blob> get(const std::string& category, const Blob& key) override {
+        auto ret = m_impl->get(category, key);
+        if (ret.valid() && is_weight_preprocess(category)) {
+            ++nr_hit;
+        }
+        return ret;
+    }
+
+    void put(const std::string& category, const Blob& key, const Blob& value)
+            override {
+        if (is_weight_preprocess(category)) {
+            ++nr_put;
+        }
+        m_impl->put(category, key, value);
+    }
+};
+}  // anonymous namespace
+
+TEST(TestGraph, WeightPreprocessCache) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({1, 32, 16, 16}, cn), host_w = gen({32, 32, 1, 1}, cn);
+    auto cache = std::make_shared<WeightPreprocessCountingCache>();
+    auto orig_impl = PersistentCache::set_impl(cache);
+
+    //! return whether a weight preprocess algo is used
+    auto run = [&](bool weight_preprocess, HostTensorND& host_y) {
+        auto graph = ComputingGraph::make();
+        graph->options().graph_opt.weight_preprocess = weight_preprocess;
+        graph->options().graph_opt.weight_preprocess_cache = true;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             w = opr::SharedDeviceTensor::make_const(*graph, *host_w);
+        opr::Convolution::Param param;
+        param.pad_h = param.pad_w = 0;
+        auto y = opr::Convolution::make(x, w, param);
+        Maybe<bool> found;
+        y.node()->owner_opr()->cast_final_safe<opr::Convolution>().setup_algo_chooser(
+                [&](const cg::OperatorNodeBase* opr) {
+                    return try_find_any_weight_preprocess_algo(
+                            opr->cast_final_safe<opr::Convolution>().megdnn_opr(),
+                            opr->cname(), found, opr->input(0)->layout(),
+                            opr->input(1)->layout(), opr->output(0)->layout());
+                });
+        auto func = graph->compile({make_callback_copy(y, host_y)});
+        func->execute().wait();
+        return found.valid() && found.val();
+    };
+
+    HostTensorND host_y_expect, host_y0, host_y1;
+    run(false, host_y_expect);
+    if (run(true, host_y0)) {
+        ASSERT_EQ(cache->nr_put, 1u);
+        ASSERT_EQ(cache->nr_hit, 0u);
+        //! a new graph of the same weights loads the preprocessed filter
+        run(true, host_y1);
+        ASSERT_EQ(cache->nr_put, 1u);
+        ASSERT_EQ(cache->nr_hit, 1u);
+        MGB_ASSERT_TENSOR_NEAR(host_y_expect, host_y0, 1e-4);
+        MGB_ASSERT_TENSOR_NEAR(host_y_expect, host_y1, 1e-4);
+    }
+    PersistentCache::set_impl(orig_impl);
+    megdnn::HeuristicCache::instance().clear();
+}
+
 namespace {
 MGB_DEFINE_OPR_CLASS(HostValueReader, cg::SingleCNOutshapePureByInshapeOprBase) // {
     void scn_do_execute() override {
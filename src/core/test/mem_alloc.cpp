@@ -18,6 +18,7 @@
 #include "megbrain/test/helper.h"
 
 #include <atomic>
+#include <future>
 #include <map>
 #include <random>
 #include <thread>
@@ -38,6 +39,7 @@ public:
 
 class DummyAllocator final : public RawAllocator {
     const size_t m_tot_size;
+    const bool m_mergeable;
     bool m_ever_failed = false;
     size_t m_next_addr = 1, m_cur_usage = 0, m_peak_usage = 0, m_nr_alloc = 0,
            m_nr_free = 0;
@@ -45,7 +47,8 @@ class DummyAllocator final : public RawAllocator {
     std::mutex m_mtx;
 
 public:
-    explicit DummyAllocator(size_t tot_size) : m_tot_size(tot_size) {}
+    explicit DummyAllocator(size_t tot_size, bool mergeable = false)
+            : m_tot_size(tot_size), m_mergeable(mergeable) {}
 
     ~DummyAllocator() {
         auto run = [this]() { ASSERT_EQ(0u, m_addr2size.size()); };
@@ -81,6 +84,8 @@ public:
         free = free_size();
     }
 
+    bool mergeable_chunks() const override { return m_mergeable; }
+
     size_t free_size() const { return m_tot_size - m_cur_usage; }
 
     bool ever_failed() const { return m_ever_failed; }
@@ -310,6 +315,41 @@ TEST(TestMemAlloc, NotCrossBoundary) {
             << p0 << " " << p1 << " " << p2;
 }
 
+TEST(TestMemAlloc, MergeableChunks) {
+    using StreamKey = DevMemAlloc::StreamKey;
+    auto raw_alloc = std::make_shared<DummyAllocator>(6, true);
+    auto runtime_policy = std::make_shared<DummyRuntimePolicy>(0);
+    auto dev_alloc = DevMemAlloc::make(0, 0, raw_alloc, runtime_policy);
+    auto conf = dev_alloc->prealloc_config();
+    conf.max_overhead = 0;
+    conf.alignment = 1;
+    dev_alloc->prealloc_config(conf);
+
+    StreamKey stream_key = nullptr;
+    auto salloc = dev_alloc->add_stream(static_cast<StreamKey>(&stream_key));
+    auto p0 = salloc->alloc(2), p1 = salloc->alloc(2);
+    ASSERT_EQ(2u, raw_alloc->nr_alloc());
+    salloc->free(p0);
+    salloc->free(p1);
+
+    // the two adjacent chunks are merged into one free block
+    EXPECT_EQ(4u, salloc->get_free_memory().max);
+    auto p2 = salloc->alloc(4);
+    EXPECT_EQ(p0, p2);
+    EXPECT_EQ(2u, raw_alloc->nr_alloc());
+
+    // covered chunks are released when gathering, and the free part that
+    // does not cover a whole chunk is kept
+    salloc->free(p2);
+    auto p3 = salloc->alloc(1);
+    EXPECT_EQ(2u, dev_alloc->gather_stream_free_blk_and_release_full());
+    EXPECT_EQ(1u, raw_alloc->nr_free());
+    EXPECT_EQ(1u, salloc->get_free_memory().tot);
+    salloc->free(p3);
+    EXPECT_EQ(2u, dev_alloc->gather_stream_free_blk_and_release_full());
+    EXPECT_EQ(2u, raw_alloc->nr_free());
+}
+
 TEST(TestMemAlloc, GrowByGather) {
     using StreamKey = DevMemAlloc::StreamKey;
     auto raw_alloc = std::make_shared<DummyAllocator>(12);
@@ -511,6 +551,133 @@ TEST(TestSimpleCachingAlloc, Basic) {
     EXPECT_EQ(0u, raw_alloc->nr_free());
 };
 
+namespace {
+//! raw allocator on real host memory with aligned addresses
+class AlignedHostAllocator final : public RawAllocator {
+public:
+    struct Stat {
+        std::atomic_size_t nr_alloc{0}, nr_free{0};
+    };
+
+private:
+    static constexpr size_t ALIGN = 64;
+    std::shared_ptr<Stat> m_stat;
+    std::mutex m_mtx;
+    std::unordered_map<void*, void*> m_aligned2orig;
+
+public:
+    explicit AlignedHostAllocator(std::shared_ptr<Stat> stat) : m_stat{stat} {}
+
+    ~AlignedHostAllocator() { EXPECT_TRUE(m_aligned2orig.empty()); }
+
+    void* alloc(size_t size) override {
+        auto orig = malloc(size + ALIGN);
+        auto addr = reinterpret_cast<size_t>(orig);
+        auto ptr = reinterpret_cast<void*>((addr + ALIGN) & ~(ALIGN - 1));
+        MGB_LOCK_GUARD(m_mtx);
+        m_aligned2orig[ptr] = orig;
+        ++m_stat->nr_alloc;
+        return ptr;
+    }
+
+    void free(void* ptr) override {
+        MGB_LOCK_GUARD(m_mtx);
+        auto iter = m_aligned2orig.find(ptr);
+        mgb_assert(iter != m_aligned2orig.end());
+        ::free(iter->second);
+        m_aligned2orig.erase(iter);
+        ++m_stat->nr_free;
+    }
+
+    void get_mem_info(size_t& free, size_t& tot) override { free = tot = 0; }
+};
+}  // anonymous namespace
+
+TEST(TestThreadCachingAlloc, Basic) {
+    auto stat = std::make_shared<AlignedHostAllocator::Stat>();
+    auto alloc = ThreadCachingAlloc::make(
+            std::make_unique<AlignedHostAllocator>(stat), {});
+
+    // 100 bytes are held by the 112-byte size class
+    auto ptr = alloc->alloc(100);
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(ptr) % alloc->alignment());
+    EXPECT_EQ(112u, alloc->get_used_memory());
+    memset(ptr, 1, 100);
+
+    alloc->free(ptr);
+    EXPECT_EQ(0u, alloc->get_used_memory());
+    auto free_stat = alloc->get_free_memory();
+    EXPECT_EQ(112u, free_stat.tot);
+    EXPECT_EQ(112u, free_stat.min);
+    EXPECT_EQ(112u, free_stat.max);
+    EXPECT_EQ(1u, free_stat.nr_blk);
+
+    auto ptr1 = alloc->alloc(110);
+    EXPECT_EQ(ptr, ptr1);
+    EXPECT_EQ(1u, stat->nr_alloc.load());
+    EXPECT_EQ(0u, alloc->get_free_memory().tot);
+
+    // large blocks are not cached
+    auto large = alloc->alloc(ThreadCachingAlloc::MAX_CACHED_SIZE + 1);
+    EXPECT_EQ(2u, stat->nr_alloc.load());
+    alloc->free(large);
+    EXPECT_EQ(1u, stat->nr_free.load());
+    EXPECT_EQ(112u, alloc->get_used_memory());
+
+    alloc->free(ptr1);
+    EXPECT_EQ(112u, alloc->release_cached());
+    EXPECT_EQ(2u, stat->nr_free.load());
+    EXPECT_EQ(0u, alloc->get_free_memory().nr_blk);
+
+    alloc.reset();
+    EXPECT_EQ(stat->nr_alloc.load(), stat->nr_free.load());
+}
+
+TEST(TestThreadCachingAlloc, CrossThread) {
+    REQUIRE_THREAD();
+    constexpr size_t NR_BLK = 64, SIZE = 1000, CLS_SIZE = 1024, LIMIT = 4096;
+    auto stat = std::make_shared<AlignedHostAllocator::Stat>();
+    ThreadCachingAlloc::Config config;
+    config.thread_cache_limit = LIMIT;
+    auto alloc = ThreadCachingAlloc::make(
+            std::make_unique<AlignedHostAllocator>(stat), config);
+
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < NR_BLK; ++i) {
+        ptrs.push_back(alloc->alloc(SIZE));
+    }
+    EXPECT_EQ(NR_BLK, stat->nr_alloc.load());
+
+    std::promise<void> freed, done;
+    std::thread worker{[&]() {
+        for (auto i : ptrs) {
+            alloc->free(i);
+        }
+        freed.set_value();
+        done.get_future().wait();
+    }};
+    freed.get_future().wait();
+
+    // blocks beyond the limit of the worker cache are in the shared pool
+    auto free_stat = alloc->get_free_memory();
+    EXPECT_EQ(NR_BLK, free_stat.nr_blk);
+    EXPECT_EQ(NR_BLK * CLS_SIZE, free_stat.tot);
+    for (auto&& i : ptrs) {
+        i = alloc->alloc(SIZE);
+    }
+    EXPECT_LE(stat->nr_alloc.load(), NR_BLK + LIMIT / CLS_SIZE);
+    EXPECT_EQ(NR_BLK * CLS_SIZE, alloc->get_used_memory());
+    done.set_value();
+    worker.join();
+
+    for (auto i : ptrs) {
+        alloc->free(i);
+    }
+    EXPECT_EQ(0u, alloc->get_used_memory());
+    alloc.reset();
+    EXPECT_EQ(stat->nr_alloc.load(), stat->nr_free.load());
+}
+
 namespace {
 class DevicePolicy {
 public:
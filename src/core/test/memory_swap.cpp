@@ -21,13 +21,16 @@ using namespace mgb;
 using Elemwise = opr::Elemwise;
 using Mode = Elemwise::Mode;
 #if MGB_ENABLE_MEMORY_SWAP
-auto run = [](const int flag) {
+auto run = [](const int flag, const int prefetch = 0) {
     auto KEY = "MGB_MEMORY_SWAP_PARAM_BUCKET_IMPLEMENT";
     auto old_value = getenv(KEY);
     if (flag)
         setenv(KEY, "1", 1);
     else
         setenv(KEY, "0", 1);
+    auto PREFETCH_KEY = "MGB_MEMORY_SWAP_PARAM_PREFETCH";
+    auto old_prefetch = getenv(PREFETCH_KEY);
+    setenv(PREFETCH_KEY, prefetch ? "1" : "0", 1);
 
     HostTensorGenerator<> gen_;
 
@@ -88,6 +91,11 @@ auto run = [](const int flag) {
     } else {
         unsetenv(KEY);
     }
+    if (old_prefetch) {
+        setenv(PREFETCH_KEY, old_prefetch, 1);
+    } else {
+        unsetenv(PREFETCH_KEY);
+    }
 };
 
 TEST(TestMemorySwap, FullConvSerial) {
@@ -100,6 +108,11 @@ TEST(TestMemorySwap, FullConvParallel) {
     run(0);
 }
 
+TEST(TestMemorySwap, FullConvPrefetch) {
+    REQUIRE_GPU(1);
+    run(0, 1);
+}
+
 #endif  // MGB_ENABLE_MEMORY_SWAP
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
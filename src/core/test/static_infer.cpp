@@ -261,6 +261,31 @@ TEST(TestStaticInfer, SrcChangeDetection) {
     ASSERT_EQ(0, tshp_mid.reset_prev_val()->layout().stride[0]);
 }
 
+TEST(TestStaticInfer, MemoizedShape) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3});
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         xshp = opr::GetVarShape::make(x),
+         y = opr::Concat::make({x, x}, 0).reshape(
+                 opr::Concat::make({xshp.make_scalar(2), xshp}, 0));
+    HostTensorND host_y;
+    auto func = graph->compile({make_callback_copy(y, host_y)});
+
+    // shapes inferred from the srcs seen before are restored from the memo
+    for (auto&& shp : {TensorShape{2, 3}, TensorShape{4, 5}, TensorShape{2, 3},
+                       TensorShape{4, 5}, TensorShape{2, 3}, TensorShape{1, 7}}) {
+        *host_x = *gen(shp);
+        func->execute();
+        ASSERT_EQ(TensorShape({2, shp[0], shp[1]}), host_y.shape());
+        ASSERT_EQ(TensorShape({2, shp[0], shp[1]}), y.node()->shape());
+        auto px = host_x->ptr<float>(), py = host_y.ptr<float>();
+        for (size_t i = 0; i < host_x->shape().total_nr_elems(); ++i) {
+            ASSERT_EQ(px[i], py[i]);
+        }
+    }
+}
+
 TEST(TestStaticInfer, AsImmutableScalar) {
     auto graph = ComputingGraph::make();
     HostTensorGenerator<dtype::Int32> gen;
@@ -10,10 +10,12 @@
  */
 
 #include "../impl/graph/var_node_mem_mgr/static_mem_alloc.h"
+#include "megbrain/graph/static_mem_plan.h"
 #include "megbrain/test/helper.h"
 #include "megbrain/utils/arith_helper.h"
 #include "megbrain/utils/timer.h"
 
+#include <limits>
 #include <random>
 
 using namespace mgb;
@@ -233,6 +235,71 @@ TEST(TestStaticMemAllocAlgo, PushdownChain) {
     ASSERT_EQ(NR + NR - 1, allocator->tot_alloc());
 }
 
+TEST(TestStaticMemAllocAlgo, Profile) {
+    using Algo = StaticMemAlloc::AllocatorAlgo;
+    constexpr size_t NR = 300;
+    std::mt19937_64 rng(next_rand_seed());
+    std::vector<std::tuple<size_t, size_t, size_t>> reqs;
+    for (size_t i = 0; i < NR; ++i) {
+        size_t begin = rng() % NR;
+        reqs.emplace_back(begin, begin + 1 + rng() % 20, 1 + rng() % 4096);
+    }
+    auto run = [&](Algo algo, int key_base) {
+        auto allocator = StaticMemAlloc::make(algo);
+        allocator->alignment(64);
+        for (size_t i = 0; i < NR; ++i) {
+            allocator->add(
+                    std::get<0>(reqs[i]), std::get<1>(reqs[i]), std::get<2>(reqs[i]),
+                    makeuk(key_base + i));
+        }
+        allocator->solve();
+        return allocator;
+    };
+
+    size_t best = std::numeric_limits<size_t>::max();
+#define itcb(algo) best = std::min(best, run(Algo::algo, 0)->tot_alloc());
+    ITER_ALGO(itcb)
+#undef itcb
+
+    auto a0 = run(Algo::PROFILE, 0);
+    ASSERT_EQ(best, a0->tot_alloc());
+
+    // same problem with other keys is served from the plan cache
+    auto a1 = run(Algo::PROFILE, NR);
+    ASSERT_EQ(a0->tot_alloc(), a1->tot_alloc());
+    ASSERT_EQ(a0->tot_alloc_lower_bound(), a1->tot_alloc_lower_bound());
+    for (size_t i = 0; i < NR; ++i) {
+        ASSERT_EQ(a0->get_start_addr(makeuk(i)), a1->get_start_addr(makeuk(NR + i)));
+    }
+}
+
+TEST(TestStaticMemAllocAlgo, PlanCacheRecorder) {
+    auto run = [](int key_base) {
+        auto allocator =
+                StaticMemAlloc::make(StaticMemAlloc::AllocatorAlgo::PUSHDOWN);
+        allocator->add(0, 2, 3, makeuk(key_base));
+        allocator->add(1, 3, 5, makeuk(key_base + 1));
+        allocator->add(2, 4, 7, makeuk(key_base + 2));
+        allocator->solve();
+        return allocator;
+    };
+    StaticMemPlanCache::Recorder recorder;
+    auto a0 = run(0);
+    ASSERT_EQ(1u, recorder.plans().size());
+    auto plan = recorder.plans()[0];
+    ASSERT_EQ(a0->tot_alloc(), plan.tot_alloc);
+    ASSERT_EQ(3u, plan.addr.size());
+
+    StaticMemPlanCache::Plan cached;
+    ASSERT_TRUE(StaticMemPlanCache::inst().get(plan.hash, 3, cached));
+    auto a1 = run(3);
+    ASSERT_EQ(2u, recorder.plans().size());
+    ASSERT_EQ(plan.hash, recorder.plans()[1].hash);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(a0->get_start_addr(makeuk(i)), a1->get_start_addr(makeuk(3 + i)));
+    }
+}
+
 #endif  // WIN32
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -19,6 +19,7 @@
 #include "megbrain/opr/utility.h"
 #include "megbrain/serialization/sereg.h"
 #include "megbrain/test/helper.h"
+#include "megbrain/utils/persistent_cache.h"
 
 using namespace mgb;
 
@@ -574,6 +575,73 @@ TEST(TestSublinearMemory, BadOpr) {
     }
 }
 
+TEST(TestSublinearMemory, PlanCache) {
+    class CountingCache final : public PersistentCache {
+        std::shared_ptr<PersistentCache> m_impl =
+                std::make_shared<InMemoryPersistentCache>();
+
+    public:
+        size_t nr_hit = 0, nr_put = 0;
+
+        Maybe<Blob> get(const std::string& category, const Blob& key) override {
+            auto ret = m_impl->get(category, key);
+            nr_hit += ret.valid();
+            return ret;
+        }
+
+        void put(const std::string& category, const Blob& key,
+                 const Blob& value) override {
+            ++nr_put;
+            m_impl->put(category, key, value);
+        }
+    };
+    auto cache = std::make_shared<CountingCache>();
+    auto orig_cache = PersistentCache::set_impl(cache);
+
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("xpu0");
+    constexpr size_t N = 1024, Scale = 2;
+    auto host_x = gen({N}, cn);
+    auto run = [&](size_t* nr_opr) {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make_no_fwd(*graph, host_x),
+             bad_var = SublinearBadOpr::make(x, false, Scale),
+             y0 = opr::reduce_sum(bad_var, x.make_scalar_dt(1)),
+             y1 = SublinearBadOpr::make(y0, false, N * Scale), y = y1 + 1,
+             z = opr::reduce_max(bad_var, x.make_scalar_dt(1));
+        set_priority(y0, 0);
+        set_priority(y1, 1);
+        set_priority(y, 2);
+        set_priority(z, 3);
+        graph->options().graph_opt_level = 0;
+        graph->options().enable_sublinear_memory_opt = 1;
+        graph->options().sublinear_mem_config.genetic_nr_iter = 50;
+        graph->options().sublinear_mem_config.genetic_early_stop = 5;
+        auto func = graph->compile({{y, {}}, {z, {}}});
+        *nr_opr = 0;
+        func->iter_opr_seq([&](cg::OperatorNodeBase*) {
+            ++*nr_opr;
+            return true;
+        });
+        return static_cast<cg::ComputingGraphImpl*>(graph.get())
+                ->seq_modifier_for_sublinear_memory()
+                .prev_min_bottleneck()
+                .at(cn);
+    };
+
+    size_t nr_opr0, nr_opr1;
+    auto bottleneck0 = run(&nr_opr0);
+    ASSERT_EQ(0u, cache->nr_hit);
+    ASSERT_GE(cache->nr_put, 1u);
+    auto bottleneck1 = run(&nr_opr1);
+    ASSERT_GE(cache->nr_hit, 1u);
+    ASSERT_EQ(bottleneck0, bottleneck1);
+    ASSERT_EQ((N * Scale + N) * host_x->dtype().size(), bottleneck1);
+    ASSERT_EQ(nr_opr0, nr_opr1);
+
+    PersistentCache::set_impl(orig_cache);
+}
+
 #else
 #pragma message "tests are disabled as Sublinear is not enabled."
 #endif  // MGB_ENABLE_SUBLINEAR
@@ -20,6 +20,7 @@
 #else
 
 #include <unistd.h>
+#include <algorithm>
 
 using namespace mgb;
 using namespace sys;
@@ -81,6 +82,21 @@ public:
 }  // namespace sys
 }  // namespace mgb
 
+TEST(TestSystem, CpuCoreClasses) {
+    auto classes = get_cpu_core_classes();
+    ASSERT_FALSE(classes.empty());
+    std::vector<int> cpus;
+    for (auto&& i : classes) {
+        ASSERT_FALSE(i.empty());
+        cpus.insert(cpus.end(), i.begin(), i.end());
+    }
+    std::sort(cpus.begin(), cpus.end());
+    ASSERT_EQ(cpus.size(), static_cast<size_t>(get_cpu_count()));
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        ASSERT_EQ(static_cast<int>(i), cpus[i]);
+    }
+}
+
 TEST(TestSystem, TimedFuncInvokerBasic) {
     auto ins = TimedFuncInvokerTest::make_ins();
     double time = 0.1;
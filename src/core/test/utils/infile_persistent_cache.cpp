@@ -0,0 +1,160 @@
+/**
+ * \file src/core/test/utils/infile_persistent_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/utils/infile_persistent_cache.h"
+#include "megbrain/test/helper.h"
+
+#include <cstdio>
+
+using namespace mgb;
+
+namespace {
+using Blob = PersistentCache::Blob;
+
+Blob make_blob(const std::string& str) {
+    return {str.data(), str.size()};
+}
+
+void put(PersistentCache& cache, const char* category, const std::string& key,
+         const std::string& value) {
+    cache.put(category, make_blob(key), make_blob(value));
+}
+
+std::string get(PersistentCache& cache, const char* category, const std::string& key) {
+    auto ret = cache.get(category, make_blob(key));
+    if (!ret.valid()) {
+        return "<none>";
+    }
+    return {static_cast<const char*>(ret->ptr), ret->size};
+}
+
+void append_u32(std::vector<uint8_t>& dst, uint32_t val) {
+    auto ptr = reinterpret_cast<const uint8_t*>(&val);
+    dst.insert(dst.end(), ptr, ptr + sizeof(val));
+}
+
+void append_str(std::vector<uint8_t>& dst, const std::string& str) {
+    append_u32(dst, str.size());
+    dst.insert(dst.end(), str.begin(), str.end());
+}
+}  // anonymous namespace
+
+TEST(TestInFilePersistentCache, DumpAndLoad) {
+    InFilePersistentCache cache;
+    put(cache, "c0", "k0", "v0");
+    put(cache, "c0", "k1", "v1");
+    put(cache, "c1", "k0", std::string("v\0v", 3));
+    ASSERT_EQ(3u, cache.nr_entries());
+
+    auto bin = cache.dump();
+    InFilePersistentCache loaded{bin.data(), bin.size()};
+    ASSERT_EQ(3u, loaded.nr_entries());
+    ASSERT_EQ("v0", get(loaded, "c0", "k0"));
+    ASSERT_EQ("v1", get(loaded, "c0", "k1"));
+    ASSERT_EQ(std::string("v\0v", 3), get(loaded, "c1", "k0"));
+    ASSERT_EQ("<none>", get(loaded, "c1", "k1"));
+    ASSERT_EQ("<none>", get(loaded, "c2", "k0"));
+
+    // truncated input
+    bin.pop_back();
+    ASSERT_THROW(InFilePersistentCache(bin.data(), bin.size()), MegBrainError);
+}
+
+TEST(TestInFilePersistentCache, Legacy) {
+    // caches dumped before the header was added
+    std::vector<uint8_t> bin;
+    append_u32(bin, 1);
+    append_str(bin, "c0");
+    append_u32(bin, 2);
+    append_str(bin, "k0");
+    append_str(bin, "v0");
+    append_str(bin, "k1");
+    append_str(bin, "v1");
+    InFilePersistentCache cache{bin.data(), bin.size()};
+    ASSERT_EQ(2u, cache.nr_entries());
+    ASSERT_EQ("v0", get(cache, "c0", "k0"));
+    ASSERT_EQ("v1", get(cache, "c0", "k1"));
+}
+
+TEST(TestInFilePersistentCache, Stale) {
+    InFilePersistentCache cache;
+    put(cache, "c0", "k0", "v0");
+    auto bin = cache.dump();
+
+    // replace the tag with one from another build
+    std::vector<uint8_t> stale(bin.begin(), bin.begin() + 12);
+    auto tag = InFilePersistentCache::version_tag();
+    ASSERT_EQ(0, memcmp(bin.data() + 16, tag.data(), tag.size()));
+    append_str(stale, tag + "-other");
+    stale.insert(stale.end(), bin.begin() + 16 + tag.size(), bin.end());
+
+    InFilePersistentCache loaded;
+    ASSERT_EQ(0u, loaded.merge(stale.data(), stale.size()));
+    ASSERT_EQ(0u, loaded.nr_entries());
+    ASSERT_EQ(1u, loaded.merge(bin.data(), bin.size()));
+    ASSERT_EQ("v0", get(loaded, "c0", "k0"));
+}
+
+TEST(TestInFilePersistentCache, MergeAndDump) {
+    auto path = output_file("TestInFilePersistentCache.MergeAndDump.cache");
+    remove(path.c_str());
+
+    InFilePersistentCache cache0, cache1;
+    put(cache0, "c0", "k0", "v0");
+    put(cache0, "c0", "k1", "v1");
+    put(cache1, "c0", "k1", "v1-new");
+    put(cache1, "c1", "k2", "v2");
+    cache0.merge_and_dump_cache(path.c_str());
+    cache1.merge_and_dump_cache(path.c_str());
+
+    // entries put by this process take precedence
+    ASSERT_EQ("v1-new", get(cache1, "c0", "k1"));
+    InFilePersistentCache loaded{path.c_str()};
+    ASSERT_EQ(3u, loaded.nr_entries());
+    ASSERT_EQ("v0", get(loaded, "c0", "k0"));
+    ASSERT_EQ("v1-new", get(loaded, "c0", "k1"));
+    ASSERT_EQ("v2", get(loaded, "c1", "k2"));
+
+    // dump_cache() replaces the file
+    cache0.dump_cache(path.c_str());
+    InFilePersistentCache replaced{path.c_str()};
+    ASSERT_EQ(2u, replaced.nr_entries());
+    ASSERT_EQ("v1", get(replaced, "c0", "k1"));
+
+    // always_sync merges each put() into the file
+    {
+        InFilePersistentCache synced{path.c_str(), true};
+        put(synced, "c1", "k3", "v3");
+    }
+    InFilePersistentCache reloaded{path.c_str()};
+    ASSERT_EQ(3u, reloaded.nr_entries());
+    ASSERT_EQ("v3", get(reloaded, "c1", "k3"));
+}
+
+#ifndef WIN32
+TEST(TestInFilePersistentCache, SharedDir) {
+    auto dir = output_file("");
+    auto path = InFilePersistentCache::path_in_dir(dir);
+    remove(path.c_str());
+    ASSERT_EQ(path, InFilePersistentCache::resolve_path(dir.c_str()));
+
+    InFilePersistentCache cache;
+    put(cache, "c0", "k0", "v0");
+    cache.merge_and_dump_cache(dir.c_str());
+    InFilePersistentCache loaded{path.c_str()};
+    ASSERT_EQ("v0", get(loaded, "c0", "k0"));
+    InFilePersistentCache loaded_from_dir{dir.c_str()};
+    ASSERT_EQ("v0", get(loaded_from_dir, "c0", "k0"));
+    remove(path.c_str());
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -11,6 +11,7 @@
 
 #include "megbrain/utils/thread.h"
 #include <atomic>
+#include <chrono>
 #include <random>
 #include "megbrain/test/helper.h"
 #include "megbrain/utils/timer.h"
@@ -29,6 +30,9 @@ public:
 
 class FuncExecutor final : public AsyncQueueSC<thin_function<void()>, FuncExecutor> {
 public:
+    FuncExecutor(ptrdiff_t ring_size = -1)
+            : AsyncQueueSC<thin_function<void()>, FuncExecutor>(-1, -1, ring_size) {}
+
     void process_one_task(const thin_function<void()>& task) { task(); }
 };
 
@@ -339,6 +343,64 @@ TEST(TestAsyncQueue, OutOfOrderCtor) {
     ASSERT_EQ(1, sum);
 }
 
+TEST(TestAsyncQueue, RingBuffer) {
+    class Adder final : public AsyncQueueSC<int, Adder> {
+        int m_sum = 0;
+        std::mt19937 m_rng;
+
+    public:
+        //! use a small ring so it would be full and overflow in the worker
+        Adder() : AsyncQueueSC<int, Adder>(-1, -1, 13) {}
+
+        void process_one_task(int val) {
+            if ((m_rng() & 2)) {
+                add_task(val);
+            } else {
+                m_sum += val;
+            }
+        }
+
+        int sum() const { return m_sum; }
+    };
+    Adder adder;
+    ASSERT_TRUE(adder.use_ring_buffer());
+    constexpr int M = 4;
+    std::atomic_int nr_started{0};
+    auto worker = [&](int id) {
+        ++nr_started;
+        while (nr_started != M)
+            ;
+        for (int i = 0; i < 2000; ++i)
+            adder.add_task(id % 2 ? i : -i);
+        adder.add_task(id);
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < M; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto&& i : threads) {
+        i.join();
+    }
+    adder.wait_task_queue_empty();
+    ASSERT_EQ(M * (M - 1) / 2, adder.sum());
+}
+
+TEST(TestAsyncQueue, RingBufferWaitAll) {
+    FuncExecutor fe{4};
+    ASSERT_TRUE(fe.use_ring_buffer());
+    int sum = 0;
+    for (int i = 0; i < 1000; ++i) {
+        fe.add_task([&sum, i]() { sum += i; });
+        if (i % 100 == 0) {
+            fe.wait_all_task_finish();
+            ASSERT_EQ(i * (i + 1) / 2, sum);
+        }
+    }
+    fe.wait_all_task_finish();
+    ASSERT_EQ(999 * 1000 / 2, sum);
+}
+
 #if MGB_ENABLE_EXCEPTION
 TEST(TestAsyncQueue, Exception) {
     ExcMaker exc_maker;
@@ -404,6 +466,42 @@ TEST(TestAsyncQueue, Benchmark) {
     ASSERT_EQ(N * 5, nr_call);
 }
 
+TEST(TestAsyncQueue, BenchmarkLatency) {
+    // measure the latency from add_task() until the task starts running, with
+    // the worker waiting for new tasks
+    auto run = [](ptrdiff_t ring_size, size_t interval_us) {
+        using clock = std::chrono::steady_clock;
+        FuncExecutor queue{ring_size};
+        constexpr int N = 1000;
+        std::atomic_bool done{false};
+        double tot = 0, max = 0;
+        for (int i = 0; i < N; ++i) {
+            done.store(false);
+            auto start = clock::now();
+            queue.add_task([&done, &tot, &max, start]() {
+                std::chrono::duration<double, std::micro> dur =
+                        clock::now() - start;
+                tot += dur.count();
+                max = std::max(max, dur.count());
+                done.store(true);
+            });
+            while (!done.load())
+                ;
+            if (interval_us) {
+                std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+            }
+        }
+        queue.wait_all_task_finish();
+        printf("submit_to_run_latency: %s interval=%zuus avg=%.3f max=%.3f "
+               "[us]\n",
+               ring_size ? "ring" : "block", interval_us, tot / N, max);
+    };
+    for (size_t interval : {0, 100}) {
+        run(0, interval);
+        run(1024, interval);
+    }
+}
+
 TEST(TestThread, Spinlock) {
     Spinlock lock;
     int cnt = 0;
@@ -10,6 +10,7 @@
  */
 #include "megbrain/utils/thread_pool.h"
 #include <atomic>
+#include <chrono>
 #include <random>
 #include "megbrain/comp_node.h"
 #include "megbrain/opr/io.h"
@@ -62,6 +63,120 @@ TEST(TestThreadPool, BASIC) {
     }
 }
 
+TEST(TestThreadPool, WORK_STEALING) {
+    auto thread_pool = std::make_shared<ThreadPool>(4u, ThreadPoolMode::WORK_STEALING);
+    ASSERT_EQ(thread_pool->mode(), ThreadPoolMode::WORK_STEALING);
+    constexpr size_t N = 1000;
+    std::vector<int> dst(N, 0);
+    std::atomic_size_t count{0};
+    auto func = [&](size_t index, size_t thread_id) {
+        ASSERT_LT(thread_id, 4u);
+        count++;
+        dst[index] += static_cast<int>(index);
+    };
+    thread_pool->active();
+    for (size_t grain : {0, 1, 7, 2000}) {
+        count = 0;
+        thread_pool->add_task({func, N, grain});
+        ASSERT_EQ(count, N);
+    }
+    thread_pool->deactive();
+    for (size_t i = 0; i < N; i++) {
+        ASSERT_EQ(dst[i], static_cast<int>(i * 4));
+    }
+}
+
+TEST(TestThreadPool, WORK_STEALING_MULTI_TASK) {
+    auto thread_pool = std::make_shared<ThreadPool>(4u, ThreadPoolMode::WORK_STEALING);
+    constexpr size_t NR_TASK = 8, N = 257;
+    std::vector<std::vector<int>> dst(NR_TASK, std::vector<int>(N, 0));
+    std::vector<ThreadPool::TaskHandle> handles;
+    thread_pool->active();
+    for (size_t t = 0; t < NR_TASK; ++t) {
+        auto func = [&dst, t](size_t index, size_t) {
+            dst[t][index] = static_cast<int>(index * t);
+        };
+        handles.push_back(thread_pool->submit({func, N}));
+    }
+    //! wait in reverse order, a later task may finish first
+    for (size_t t = NR_TASK; t > 0; --t) {
+        thread_pool->wait(handles[t - 1]);
+        for (size_t i = 0; i < N; i++) {
+            ASSERT_EQ(dst[t - 1][i], static_cast<int>(i * (t - 1)));
+        }
+    }
+    //! deactive should drain tasks which are never waited
+    std::atomic_size_t count{0};
+    thread_pool->submit({[&](size_t, size_t) { count++; }, N});
+    thread_pool->deactive();
+    ASSERT_EQ(count, N);
+}
+
+TEST(TestThreadPool, WORK_STEALING_PRIORITY) {
+    auto thread_pool = std::make_shared<ThreadPool>(2u, ThreadPoolMode::WORK_STEALING);
+    std::atomic_bool started{false}, released{false};
+    std::atomic_size_t count{0};
+    std::mutex mtx;
+    std::string order;
+    auto run = [&](char tag) {
+        {
+            MGB_LOCK_GUARD(mtx);
+            order.push_back(tag);
+        }
+        count++;
+    };
+    //! the first sub task blocks the only worker until all the tasks are
+    //! submitted, and the caller never helps before all of them finish, so
+    //! the order is decided by the priorities only
+    auto blocker = thread_pool->submit(
+            {[&](size_t, size_t) {
+                 if (!started.exchange(true)) {
+                     while (!released) {
+                         std::this_thread::yield();
+                     }
+                 }
+                 run('N');
+             },
+             2, 1});
+    while (!started) {
+        std::this_thread::yield();
+    }
+    auto low = thread_pool->submit(
+            {[&](size_t, size_t) { run('L'); }, 4, 1, TaskPriority::LOW});
+    auto high = thread_pool->submit(
+            {[&](size_t, size_t) { run('H'); }, 4, 1, TaskPriority::HIGH});
+    released = true;
+    while (count < 10) {
+        std::this_thread::yield();
+    }
+    for (auto&& handle : {blocker, low, high}) {
+        thread_pool->wait(handle);
+    }
+    thread_pool->deactive();
+    ASSERT_EQ(order, "NHHHHNLLLL");
+}
+
+TEST(TestThreadPool, WAIT_POLICY) {
+    for (auto mode : {ThreadPoolMode::FORK_JOIN, ThreadPoolMode::WORK_STEALING}) {
+        auto thread_pool = std::make_shared<ThreadPool>(4u, mode);
+        //! park after a few rounds, so the workers are asleep between tasks
+        thread_pool->set_wait_policy({10, 2});
+        ASSERT_EQ(thread_pool->wait_policy().nr_spin, 10u);
+        ASSERT_EQ(thread_pool->wait_policy().nr_yield, 2u);
+        std::atomic_size_t count{0};
+        thread_pool->active();
+        for (size_t i = 0; i < 20; i++) {
+            thread_pool->add_task({[&](size_t, size_t) { count++; }, 16});
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        //! switch back to never park while workers are parked
+        thread_pool->set_wait_policy({});
+        thread_pool->add_task({[&](size_t, size_t) { count++; }, 16});
+        thread_pool->deactive();
+        ASSERT_EQ(count, 21u * 16);
+    }
+}
+
 TEST(TestGraph, ParallelRunMultithreadMode) {
     // check race conditions when graphs are executed on multple threads
     std::atomic_size_t sync_counter{0};
@@ -15,8 +15,11 @@
 
 #include <sstream>
 #include <unordered_set>
+#include "megbrain/comp_node_env.h"
+#include "megbrain/custom/data_adaptor.h"
 #include "megbrain/custom/op.h"
 #include "megbrain/custom/utils.h"
+#include "megbrain/tensor.h"
 
 using namespace mgb;
 
@@ -89,6 +92,74 @@ std::string ArgInfo::str() const {
     return ss.str();
 }
 
+class RuntimeArgsImpl {
+    CompNode m_comp_node;
+    std::vector<DeviceTensorND> m_workspaces;
+
+    friend class RuntimeArgs;
+};
+
+#define RuntimeArgsImplRef(raw_ptr) (*reinterpret_cast<RuntimeArgsImpl*>(raw_ptr))
+
+RuntimeArgs::RuntimeArgs(const Device& device)
+        : m_impl(new RuntimeArgsImpl(), impl_deleter<RuntimeArgsImpl>) {
+    auto cn = to_builtin<CompNode, Device>(device);
+    mgb_assert(cn.valid(), "invalid device of runtime args");
+    RuntimeArgsImplRef(m_impl.get()).m_comp_node = cn;
+}
+
+Device RuntimeArgs::device(void) const {
+    return to_custom<CompNode, Device>(RuntimeArgsImplRef(m_impl.get()).m_comp_node);
+}
+
+size_t RuntimeArgs::nr_threads(void) const {
+    auto cn = RuntimeArgsImplRef(m_impl.get()).m_comp_node;
+    mgb_assert(
+            cn.device_type() == CompNode::DeviceType::CPU,
+            "nr_threads is only available on cpu, but got %s", cn.to_string().c_str());
+    return CompNodeEnv::from_comp_node(cn).cpu_env().dispatcher->nr_threads();
+}
+
+void RuntimeArgs::dispatch(Task&& task) const {
+    auto cn = RuntimeArgsImplRef(m_impl.get()).m_comp_node;
+    mgb_assert(
+            cn.device_type() == CompNode::DeviceType::CPU,
+            "dispatch is only available on cpu, but got %s", cn.to_string().c_str());
+    CompNodeEnv::from_comp_node(cn).cpu_env().dispatch(std::move(task));
+}
+
+void RuntimeArgs::dispatch(MultiThreadingTask&& task, size_t parallelism) const {
+    auto cn = RuntimeArgsImplRef(m_impl.get()).m_comp_node;
+    mgb_assert(
+            cn.device_type() == CompNode::DeviceType::CPU,
+            "dispatch is only available on cpu, but got %s", cn.to_string().c_str());
+    CompNodeEnv::from_comp_node(cn).cpu_env().dispatch(std::move(task), parallelism);
+}
+
+void* RuntimeArgs::cuda_stream(void) const {
+    auto cn = RuntimeArgsImplRef(m_impl.get()).m_comp_node;
+    mgb_assert(
+            cn.device_type() == CompNode::DeviceType::CUDA,
+            "cuda_stream is only available on cuda, but got %s",
+            cn.to_string().c_str());
+#if MGB_CUDA
+    return CompNodeEnv::from_comp_node(cn).cuda_env().stream;
+#else
+    mgb_throw(MegBrainError, "cuda is not enabled in this build");
+#endif
+}
+
+void* RuntimeArgs::alloc_workspace(size_t size) const {
+    if (!size) {
+        return nullptr;
+    }
+    // the workspaces are released with the args, and the comp node does not
+    // reuse the memory until the previously submitted tasks or kernels finish
+    auto&& impl = RuntimeArgsImplRef(m_impl.get());
+    impl.m_workspaces.emplace_back(impl.m_comp_node, TensorShape{size}, dtype::Byte());
+    return impl.m_workspaces.back().raw_ptr();
+}
+
 #define assert_inputs_size_right(inputs_vec)                                         \
     mgb_assert(                                                                      \
             inputs_vec.size() == input_num(), "op %s need %lu inputs but given %lu", \
@@ -168,6 +239,9 @@ class CustomOpImpl {
             const std::vector<Tensor>&, const Param&, std::vector<Tensor>&)>>;
     using Compute = FuncWithSig<Function<void(
             const std::vector<Tensor>&, const Param&, std::vector<Tensor>&)>>;
+    using ComputeWithRuntime = FuncWithSig<Function<void(
+            const std::vector<Tensor>&, const Param&, std::vector<Tensor>&,
+            const RuntimeArgs&)>>;
 
     DeviceInfer infer_output_device_func;
     ShapeInfer infer_output_shape_func;
@@ -175,6 +249,8 @@ class CustomOpImpl {
     FormatInfer infer_output_format_func;
 
     std::unordered_map<std::string, Compute> compute_funcs;
+    //! only contains the devices whose compute function takes RuntimeArgs
+    std::unordered_map<std::string, ComputeWithRuntime> compute_with_runtime_funcs;
     std::unordered_map<std::string, Preprocess> preprocess_funcs;
     std::unordered_map<std::string, Postprocess> postprocess_funcs;
 
@@ -298,6 +374,17 @@ CustomOp& CustomOp::set_compute(const std::string& device, ComputeFuncPtr func)
     return *this;
 }
 
+CustomOp& CustomOp::set_compute(ComputeWithRuntimeFuncPtr func) {
+    set_compute("x86", func);
+    return *this;
+}
+
+CustomOp& CustomOp::set_compute(
+        const std::string& device, ComputeWithRuntimeFuncPtr func) {
+    OpImplRef(m_impl.get())->compute_with_runtime_funcs[device] = func;
+    return *this;
+}
+
 CustomOp& CustomOp::set_description(const std::string& op_desc) {
     OpImplRef(m_impl.get())->m_op_desc = op_desc;
     return *this;
@@ -515,6 +602,11 @@ std::vector<Format> CustomOp::infer_output_format(
     return outputs;
 }
 
+bool CustomOp::has_runtime_compute(const std::string& device) const {
+    auto&& funcs = OpImplRef(m_impl.get())->compute_with_runtime_funcs;
+    return funcs.find(device) != funcs.end();
+}
+
 void CustomOp::compute(
         const std::vector<Tensor>& inputs, const Param& param,
         std::vector<Tensor>& outputs) const {
@@ -524,6 +616,23 @@ void CustomOp::compute(
         return;
     }
 
+    RuntimeArgs args(outputs[0].device());
+    compute(inputs, param, outputs, args);
+    // the caller of this overload expects the outputs to be ready on return
+    if (has_runtime_compute(outputs[0].device().str())) {
+        to_builtin<CompNode, Device>(outputs[0].device()).sync();
+    }
+}
+
+void CustomOp::compute(
+        const std::vector<Tensor>& inputs, const Param& param,
+        std::vector<Tensor>& outputs, const RuntimeArgs& args) const {
+    assert_inputs_size_right(inputs);
+    assert_outputs_size_right(outputs);
+    if (outputs.size() == 0) {
+        return;
+    }
+
     std::string device = outputs[0].device().str();
     for (size_t i = 1; i < outputs.size(); ++i) {
         mgb_assert(
@@ -535,11 +644,16 @@ void CustomOp::compute(
     mgb_assert(Device::is_legal(device), "unsupported device type: %s", device.c_str());
 
     auto preprocess_func = OpImplRef(m_impl.get())->preprocess_funcs[device];
-    auto forward_func = OpImplRef(m_impl.get())->compute_funcs[device];
     auto postprocess_func = OpImplRef(m_impl.get())->postprocess_funcs[device];
 
     preprocess_func(inputs, param, outputs);
-    forward_func(inputs, param, outputs);
+    if (has_runtime_compute(device)) {
+        auto forward_func = OpImplRef(m_impl.get())->compute_with_runtime_funcs[device];
+        forward_func(inputs, param, outputs, args);
+    } else {
+        auto forward_func = OpImplRef(m_impl.get())->compute_funcs[device];
+        forward_func(inputs, param, outputs);
+    }
     postprocess_func(outputs, param, outputs);
     assert_outputs_size_right(outputs);
 }
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <functional>
 #include <unordered_set>
 #include "param.h"
 #include "tensor.h"
@@ -22,7 +23,7 @@
     Cls& operator=(const Cls&&) = delete
 
 #define CUSTOM_OP_MAJOR 0
-#define CUSTOM_OP_MINOR 1
+#define CUSTOM_OP_MINOR 2
 #define CUSTOM_OP_PATCH 0
 
 #define CUSTOM_OP_VERSION \
@@ -47,6 +48,45 @@ class ArgInfo {
     std::string str() const;
 };
 
+/*!
+ * \brief runtime context of the device where a custom op is computed
+ *
+ * On CPU, the compute function is called on the graph executor thread and the
+ * tensors may be not ready yet, so they should only be accessed in the tasks
+ * submitted by dispatch(), which run in order on the thread pool of the comp
+ * node. On CUDA, kernels should be launched on cuda_stream() instead of the
+ * default stream, so no device synchronization is needed.
+ */
+class RuntimeArgs {
+    std::unique_ptr<void, void_deleter> m_impl;
+
+public:
+    using Task = std::function<void(void)>;
+    //! args are (task index, thread id)
+    using MultiThreadingTask = std::function<void(size_t, size_t)>;
+
+    RuntimeArgs(const Device& device);
+    PREVENT_COPY_AND_ASSIGN(RuntimeArgs);
+
+    Device device(void) const;
+
+    //! number of threads in the thread pool of a CPU device
+    size_t nr_threads(void) const;
+    //! submit a task to a CPU device
+    void dispatch(Task&& task) const;
+    //! submit a task to a CPU device which is run parallelism times
+    void dispatch(MultiThreadingTask&& task, size_t parallelism) const;
+
+    //! cudaStream_t of a CUDA device
+    void* cuda_stream(void) const;
+
+    /*!
+     * \brief allocate device memory which is valid until the tasks or kernels
+     *      submitted in the compute function finish
+     */
+    void* alloc_workspace(size_t size) const;
+};
+
 class CustomOp {
     std::unique_ptr<void, void_deleter> m_impl;
 
@@ -68,6 +108,9 @@ public:
             void (*)(const std::vector<Tensor>&, const Param&, std::vector<Tensor>&);
     using ComputeFuncPtr =
             void (*)(const std::vector<Tensor>&, const Param&, std::vector<Tensor>&);
+    using ComputeWithRuntimeFuncPtr = void (*)(
+            const std::vector<Tensor>&, const Param&, std::vector<Tensor>&,
+            const RuntimeArgs&);
 
     // write for forward
     CustomOp& set_device_infer(DeviceInferFuncPtr func);
@@ -80,6 +123,8 @@ public:
     CustomOp& set_postprocess(const std::string& device, PostprocessFuncPtr func);
     CustomOp& set_compute(ComputeFuncPtr func);
     CustomOp& set_compute(const std::string& device, ComputeFuncPtr func);
+    CustomOp& set_compute(ComputeWithRuntimeFuncPtr func);
+    CustomOp& set_compute(const std::string& device, ComputeWithRuntimeFuncPtr func);
 
     CustomOp& set_description(const std::string& op_desc);
     CustomOp& add_input(
@@ -128,7 +173,12 @@ public:
             const std::vector<DType>&, const Param&) const;
     std::vector<Format> infer_output_format(
             const std::vector<Format>&, const Param&) const;
+    //! whether the compute function of the device takes RuntimeArgs
+    bool has_runtime_compute(const std::string& device) const;
     void compute(const std::vector<Tensor>&, const Param&, std::vector<Tensor>&) const;
+    void compute(
+            const std::vector<Tensor>&, const Param&, std::vector<Tensor>&,
+            const RuntimeArgs&) const;
 };
 
 }  // namespace custom
@@ -218,6 +218,64 @@ TEST(TestCustomOp, TestCustomOpFuncSetter) {
 #endif
 }
 
+
+void cpu_runtime_kernel(
+        const std::vector<Tensor>& inputs, const Param& params,
+        std::vector<Tensor>& outputs, const RuntimeArgs& args) {
+    (void)params;
+    ASSERT_TRUE(args.device() == "x86");
+    ASSERT_TRUE(args.nr_threads() >= 1);
+    size_t size = inputs[0].size();
+    auto workspace = static_cast<float*>(args.alloc_workspace(size * sizeof(float)));
+    auto inp = inputs[0].data<float>();
+    auto oup = outputs[0].data<float>();
+    args.dispatch(
+            [=](size_t index, size_t) { workspace[index] = inp[index] * 2; }, size);
+    args.dispatch([=]() {
+        for (size_t i = 0; i < size; ++i) {
+            oup[i] = workspace[i] + 1;
+        }
+    });
+}
+
+TEST(TestCustomOp, TestCustomOpRuntimeArgs) {
+    CustomOp test("TestOp", CUSTOM_OP_VERSION);
+    test.add_input("inp", "inp of Test op", {"float32"}, 2)
+            .add_output("oup", "oup of Test op", {"float32"}, 2);
+    ASSERT_FALSE(test.has_runtime_compute("x86"));
+    test.set_compute(cpu_runtime_kernel);
+    ASSERT_TRUE(test.has_runtime_compute("x86"));
+    ASSERT_FALSE(test.has_runtime_compute("cuda"));
+
+    auto cn = CompNode::load("cpux");
+    HostTensorND host_inp(cn, {3, 5}, dtype::Float32{});
+    for (size_t i = 0; i < 15; ++i) {
+        host_inp.ptr<float>()[i] = i;
+    }
+    DeviceTensorND dev_inp, dev_oup(cn, {3, 5}, dtype::Float32{});
+    dev_inp.copy_from(host_inp);
+
+    std::vector<Tensor> inputs = {to_custom_tensor(dev_inp)};
+    std::vector<Tensor> outputs = {to_custom_tensor(dev_oup)};
+    Param param(test.param_info());
+    test.compute(inputs, param, outputs);
+
+    HostTensorND host_oup;
+    host_oup.copy_from(dev_oup).sync();
+    for (size_t i = 0; i < 15; ++i) {
+        ASSERT_EQ(host_oup.ptr<float>()[i], i * 2.f + 1);
+    }
+
+    // the overload taking the args leaves the tasks running on the comp node
+    RuntimeArgs args(to_custom_device(cn));
+    fill_zero_dev_tensor(dev_oup);
+    test.compute(inputs, param, outputs, args);
+    host_oup.copy_from(dev_oup).sync();
+    for (size_t i = 0; i < 15; ++i) {
+        ASSERT_EQ(host_oup.ptr<float>()[i], i * 2.f + 1);
+    }
+}
+
 }  // namespace custom
 
 #endif
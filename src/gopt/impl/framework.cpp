@@ -573,11 +573,15 @@ SubGraph GraphOptimizer::apply(const SubGraph& graph) const {
     Pass* cur_pass = nullptr;
     MGB_MARK_USED_VAR(cur_pass);
     MGB_TRY {
+        RealTimer pass_timer;
         for (auto&& i : m_passes) {
             state.set_var_replace_check_flag(VarReplaceCheckFlag::CHECK_ALL);
             cur_pass = i.get();
             opt.graph_opt_level = 1;
+            pass_timer.reset();
             i->apply(state);
+            graph.comp_graph()->event().signal_inplace<cg::event::StartupPhaseFinished>(
+                    "gopt", i->name(), pass_timer.get_msecs());
             tot_nr_replace += state.flush_log(
                     mgb_ssprintf_log("apply optimization pass %s:", i->name()).c_str());
         }
@@ -620,6 +624,9 @@ GraphOptimizer& GraphOptimizer::add_preset_passes(
             inference_opt ? ConstVarType::IMMUTABLE_AND_PARAM : ConstVarType::IMMUTABLE;
     if (inference_opt) {
         add_pass<ConvertBatchNormToElemwisePass>();
+        add_pass<FuseSoftmaxPass>();
+        add_pass<FoldMatrixMulDimshufflePass>();
+        add_pass<FuseAttentionPass>();
     }
     if (!after_grad || inference_opt) {
         add_pass<CondExecConstPredicateFolding>();
@@ -730,11 +737,32 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
     }
 
     cb(fuse_preprocess, {
+        add_pass<FuseImagePreprocessPass>();
         add_pass(FuseNCHW4Int8Preprocess::make());
         add_pass<FuseWarpPerspectiveDimshufflePass>();
     });
+    cb(fold_const_shape, { add_pass<FoldConstShapePass>(); });
+    cb(fuse_horizontal, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<FuseHorizontalPass>();
+    });
+    cb(block_sparse_weight, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<ParamFusePass>();
+        add_pass<ConvertToBlockSparsePass>();
+    });
+    cb(weight_only_quant_int8, {
+        add_pass<ParamFusePass>();
+        add_pass<ConvertToWeightQuantPass>(8);
+    });
+    cb(weight_only_quant_int4, {
+        add_pass<ParamFusePass>();
+        add_pass<ConvertToWeightQuantPass>(4);
+    });
+    cb(fuse_multi_output_elemwise, { add_pass<FuseSigmoidMulPass>(); });
     cb(f16_io_comp, { add_pass(ConvertF32ToF16Pass::make(false)); });
     cb(f16_io_f32_comp, { add_pass(ConvertF32ToF16Pass::make(true)); });
+    cb(bf16_io_f32_comp, { add_pass(ConvertF32ToBF16Pass::make()); });
 
     cb(nchw4, {
         add_pass<FuseConvBiasNonlinPass>();
@@ -749,16 +777,25 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
     });
     cb(nchw88, {
         add_pass<FuseConvBiasNonlinPass>();
+        if (options.padding_channel) {
+            add_pass(PaddingChannelPass::make_nchwxx_padding(8));
+        }
         add_pass(EnableNchwxxPass::make_nchwxx_converter(8));
         add_pass<ShuffleShuffleRemovePass>();
     });
     cb(nchw44, {
         add_pass<FuseConvBiasNonlinPass>();
+        if (options.padding_channel) {
+            add_pass(PaddingChannelPass::make_nchwxx_padding(4));
+        }
         add_pass(EnableNchwxxPass::make_nchwxx_converter(4));
         add_pass<ShuffleShuffleRemovePass>();
     });
     cb(nchw44_dot, {
         add_pass<FuseConvBiasNonlinPass>();
+        if (options.padding_channel) {
+            add_pass(PaddingChannelPass::make_nchwxx_padding(4));
+        }
         add_pass(EnableNchw44DotPass::make_nchw44_dot_converter());
         add_pass<ShuffleShuffleRemovePass>();
     });
@@ -796,12 +833,19 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
         add_pass<FoldingConvBiasDimshufflePass>();
 #endif
     });
+    cb(nhwc, { add_pass(EnableNHWCPass::make_nhwc_converter()); });
 
     cb(fuse_conv_bias_nonlinearity, { add_pass<FuseConvBiasNonlinPass>(); });
     cb(fuse_conv_bias_with_z, {
         add_pass<FuseConvBiasNonlinPass>();
         add_pass<FuseConvBiasZPass>();
     });
+    // after the layout transforms, which leave the NCHW oprs they do not
+    // support to be tiled
+    cb(spatial_tiling, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<SpatialTilingPass>();
+    });
 
 #undef cb
 
@@ -823,7 +867,8 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_graph_tuning_options(
     cb(layout_transform, {
         add_pass<FuseConvBiasNonlinPass>();
         add_pass<FuseConvBiasZPass>();
-        add_pass(LayoutTransformPass::make(options.target));
+        add_pass(LayoutTransformPass::make(
+                options.target, options.has_set_cost_model()));
         add_pass<ShuffleShuffleRemovePass>();
         add_pass(FuseNCHW4Int8Preprocess::make());
         add_pass<FuseWarpPerspectiveDimshufflePass>();
@@ -180,9 +180,11 @@ void LayoutTransformPass::apply(OptState& opt) const {
 }
 
 std::unique_ptr<LayoutTransformPass> LayoutTransformPass::make(
-        GraphTuningOptions::Target target) {
+        GraphTuningOptions::Target target, bool cost_model) {
     MIDOUT_B("make")
-    auto profiler = ProfilerBase::make_profiler();
+    auto profiler = cost_model ? ProfilerBase::make_cost_model_profiler(
+                                         ProfilerBase::CostModel::make(target))
+                               : ProfilerBase::make_profiler();
     std::unique_ptr<SolverBase> solver{
             new DynamicProgrammingSolver(std::move(profiler))};
     auto ctx = LayoutTransformContext::make(target);
@@ -21,6 +21,7 @@
 #include "megbrain/opr/nn_int.h"
 #include "megbrain/plugin/base.h"
 #include "megbrain/serialization/sereg.h"
+#include "megbrain/utils/persistent_cache.h"
 
 using namespace mgb;
 using namespace cg;
@@ -151,16 +152,140 @@ void MarkInputContiguous::init_output_static_infer_desc() {
     auto&& mgr = owner_graph()->static_infer_manager();
     mgr.register_shape_infer(output(0), ShapeInferDesc::make_identity(input(0)));
 }
+
+/*!
+ * \brief dump the param of an operator to a string, which is used as a part of
+ * the key of the profiling cache
+ */
+class OprParamDumpContext final : public serialization::OprDumpContextRawPOD {
+    std::string& m_buf;
+
+    void write_raw(const void* data, size_t size) override {
+        m_buf.append(static_cast<const char*>(data), size);
+    }
+
+public:
+    OprParamDumpContext(std::string& buf) : OprDumpContextRawPOD(false), m_buf{buf} {}
+
+    void dump_tensor(
+            const std::string&, const HostTensorND& tensor,
+            TensorWriteMethod) override {
+        auto&& layout = tensor.layout();
+        write_param(layout.dtype);
+        write_raw(&layout.ndim, sizeof(layout.ndim));
+        write_raw(layout.shape, sizeof(layout.shape[0]) * layout.ndim);
+        write_raw(tensor.raw_ptr(), layout.span().dist_byte());
+    }
+
+    const serialization::GraphDumpConfig& config() const override {
+        static serialization::GraphDumpConfig config;
+        return config;
+    }
+};
+
+template <typename T>
+void append_pod(std::string& buf, const T& val) {
+    buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+void append_shape(std::string& buf, DTypeEnum dtype, const TensorShape& shape) {
+    append_pod(buf, dtype);
+    append_pod(buf, shape.ndim);
+    for (size_t i = 0; i < shape.ndim; ++i)
+        append_pod(buf, shape[i]);
+}
+
+/*!
+ * \brief key of profiling an operator: the type, the param and the layouts of
+ * the inputs and the outputs of the operator
+ *
+ * \return None if the param of the operator can not be dumped
+ */
+Maybe<std::string> make_opr_cache_key(const OperatorNodeBase* opr, int runs) {
+    auto registry = serialization::OprRegistry::find_by_type(opr->dyn_typeinfo());
+    if (!registry || !registry->dumper)
+        return None;
+    std::string key = "opr:";
+    key += opr->dyn_typeinfo()->name;
+    append_pod(key, runs);
+    for (auto&& i : opr->input())
+        append_shape(key, i->dtype().enumv(), i->shape());
+    for (auto&& o : opr->usable_output())
+        append_shape(key, o->dtype().enumv(), o->shape());
+    OprParamDumpContext ctx{key};
+    registry->dumper(ctx, *opr);
+    return key;
+}
+
+//! key of profiling the layout transform of a var node
+std::string make_var_cache_key(
+        const VarNode* var, TensorFormats base_format, const ReformatKey& key,
+        int runs) {
+    std::string ret = "var:";
+    append_pod(ret, runs);
+    append_shape(ret, var->dtype().enumv(), var->shape());
+    append_pod(ret, base_format);
+    append_pod(ret, key.input_format);
+    append_pod(ret, key.output_format);
+    append_pod(ret, key.input_dtype);
+    append_pod(ret, key.output_dtype);
+    append_pod(ret, key.attribute);
+    return ret;
+}
+
+/*!
+ * \brief the elapsed time of a profiling run kept in the PersistentCache, so
+ * that repeated layout transforms of a model do not profile again
+ *
+ * The results are put in a category made from the traits of the comp node,
+ * and are not cached on the devices without such a category.
+ */
+class ProfilingCache {
+    Maybe<std::string> m_category, m_key;
+
+public:
+    ProfilingCache(CompNode cn, Maybe<std::string> key) : m_key{std::move(key)} {
+        auto device_type = cn.device_type();
+        if (device_type == CompNode::DeviceType::CPU ||
+            device_type == CompNode::DeviceType::CUDA ||
+            device_type == CompNode::DeviceType::ROCM) {
+            m_category = "layout_transform_profile:v1:" +
+                         PersistentCache::make_category_from_comp_node(cn);
+        }
+    }
+
+    Maybe<float> get() const {
+        if (!m_category.valid() || !m_key.valid())
+            return None;
+        auto&& key = m_key.val();
+        auto ret = PersistentCache::inst().get(
+                m_category.val(), {key.data(), key.size()});
+        if (!ret.valid() || ret->size != sizeof(float))
+            return None;
+        float duration;
+        memcpy(&duration, ret->ptr, sizeof(float));
+        return duration;
+    }
+
+    void put(float duration) const {
+        if (!m_category.valid() || !m_key.valid())
+            return;
+        auto&& key = m_key.val();
+        PersistentCache::inst().put(
+                m_category.val(), {key.data(), key.size()},
+                {&duration, sizeof(float)});
+    }
+};
 }  // namespace
 
 /* ================== ProfilerImpl =================*/
-class ProfilerImpl final : public ProfilerBase {
+class ProfilerImpl : public ProfilerBase {
 public:
     ProfilerImpl(int runs = 10) : m_runs{runs} {};
     ~ProfilerImpl() = default;
     ProfilingResult profile(const Problem& problem) const override;
 
-private:
+protected:
     static constexpr float PROFILE_TIME_OUT = 1e7;
     using ReformatAttribute = ReformatKey::Attribute;
     /*!
@@ -176,7 +301,7 @@ private:
             const OperatorNodeBase* opr, TensorFormats base_format,
             const SmallVector<TensorFormats>& available_tensor_formats,
             ReformatAttribute extra_attribute = ReformatAttribute::DEFAULT) const;
-    float profile_operator(
+    virtual float profile_operator(
             const OperatorNodeBase* opr, TensorFormats base_format,
             TensorFormats tensor_format,
             ReformatAttribute extra_attribute = ReformatAttribute::DEFAULT) const;
@@ -194,7 +319,7 @@ private:
             const OprTensorFormatsConfiguration& base_config,
             const SmallVector<OprTensorFormatsConfiguration>& available_configs,
             ReformatAttribute extra_attribute = ReformatAttribute::DEFAULT) const;
-    float profile_operator(
+    virtual float profile_operator(
             const OperatorNodeBase* opr,
             const OprTensorFormatsConfiguration& base_config,
             const OprTensorFormatsConfiguration& config,
@@ -212,7 +337,7 @@ private:
             const VarNode* var, TensorFormats base_format,
             const SmallVector<TensorFormats>& available_tensor_formats,
             ReformatAttribute extra_attribute = ReformatAttribute::DEFAULT) const;
-    float profile_var_node(
+    virtual float profile_var_node(
             const VarNode* var, TensorFormats base_format,
             const ReformatKey& key) const;
     int m_runs;  /// sample times of the profiler
@@ -255,6 +380,10 @@ float ProfilerImpl::profile_operator(
     if (!m_opr_filter(opr, new_opr))
         return PROFILE_TIME_OUT;
     auto y = new_opr->output(0);
+    ProfilingCache cache{y->comp_node(), make_opr_cache_key(new_opr, m_runs)};
+    auto cached = cache.get();
+    if (cached.valid())
+        return cached.val();
     auto mark = MarkInputContiguous::make(SymbolVar(y));
     auto func = graph->compile({{mark, {}}});
     auto filter = [new_opr](OperatorNodeBase* opr) { return opr == new_opr; };
@@ -262,7 +391,9 @@ float ProfilerImpl::profile_operator(
             std::make_unique<GraphPartitionProfiler>(graph.get(), std::move(filter));
     for (int i = 0; i < m_runs; ++i)
         func->execute();
-    return profiler->duration_in_usec();
+    auto duration = profiler->duration_in_usec();
+    cache.put(duration);
+    return duration;
 }
 
 ProfilerImpl::OperatorNodeRecord ProfilerImpl::profile_operator(
@@ -341,6 +472,10 @@ float ProfilerImpl::profile_operator(
 #endif
     if (!m_opr_filter(opr, y->owner_opr()))
         return PROFILE_TIME_OUT;
+    ProfilingCache cache{y->comp_node(), make_opr_cache_key(y->owner_opr(), m_runs)};
+    auto cached = cache.get();
+    if (cached.valid())
+        return cached.val();
     auto mark = MarkInputContiguous::make(SymbolVar(y));
     auto func = graph->compile({{mark, {}}});
     auto new_opr = y->owner_opr();
@@ -349,7 +484,9 @@ float ProfilerImpl::profile_operator(
             std::make_unique<GraphPartitionProfiler>(graph.get(), std::move(filter));
     for (int i = 0; i < m_runs; ++i)
         func->execute();
-    return profiler->duration_in_usec();
+    auto duration = profiler->duration_in_usec();
+    cache.put(duration);
+    return duration;
 }
 
 ProfilerImpl::VarNodeRecord ProfilerImpl::profile_var_node(
@@ -389,6 +526,10 @@ float ProfilerImpl::profile_var_node(
 
     if (!m_var_node_filter(var, aligned_tensor_shape, y->shape(), key))
         return PROFILE_TIME_OUT;
+    ProfilingCache cache{cn, make_var_cache_key(var, base_format, key, m_runs)};
+    auto cached = cache.get();
+    if (cached.valid())
+        return cached.val();
     ThinHashSet<OperatorNodeBase*> set;
     DepOprIter iter([&set](OperatorNodeBase* opr) { set.insert(opr); });
     iter.add(y->owner_opr());
@@ -400,7 +541,9 @@ float ProfilerImpl::profile_var_node(
             std::make_unique<GraphPartitionProfiler>(graph.get(), std::move(filter));
     for (int i = 0; i < m_runs; ++i)
         func->execute();
-    return profiler->duration_in_usec();
+    auto duration = profiler->duration_in_usec();
+    cache.put(duration);
+    return duration;
 }
 
 ProfilerImpl::ProfilingResult ProfilerImpl::profile(const Problem& problem) const {
@@ -506,6 +649,141 @@ ProfilerImpl::ProfilingResult ProfilerImpl::profile(const Problem& problem) cons
     return profiling_result;
 }
 
+/* ================== CostModelProfiler =================*/
+/*!
+ * \brief a profiler which estimates the costs by ProfilerBase::CostModel, and
+ * never runs the operators
+ */
+class CostModelProfiler final : public ProfilerImpl {
+public:
+    CostModelProfiler(CostModel model) : m_model{std::move(model)} {}
+
+private:
+    float profile_operator(
+            const OperatorNodeBase* opr, TensorFormats base_format,
+            TensorFormats tensor_format,
+            ReformatAttribute extra_attribute) const override;
+    float profile_operator(
+            const OperatorNodeBase* opr,
+            const OprTensorFormatsConfiguration& base_config,
+            const OprTensorFormatsConfiguration& config,
+            ReformatAttribute extra_attribute) const override;
+    float profile_var_node(
+            const VarNode* var, TensorFormats base_format,
+            const ReformatKey& key) const override;
+    /*!
+     * \brief estimated elapsed time in microseconds
+     *
+     * \param opr the original operator
+     * \param opr_format the opr format whose kernels run the operator
+     * \param inputs shapes of the inputs of the operator in the opr format
+     * \param output shape of the output of the operator in the opr format
+     * \param reduce_input whether the operator reduces over the channels of
+     * its first input (like convolution), whose padding also grows the
+     * computation
+     */
+    float estimate(
+            const OperatorNodeBase* opr, OprFormat opr_format,
+            const TensorShapeArray& inputs, const TensorShape& output,
+            bool reduce_input) const;
+    CostModel m_model;
+    mutable OprFootprint m_opr_footprint;
+};
+
+float CostModelProfiler::estimate(
+        const OperatorNodeBase* opr, OprFormat opr_format,
+        const TensorShapeArray& inputs, const TensorShape& output,
+        bool reduce_input) const {
+    mgb_assert(inputs.size() == opr->input().size());
+    size_t memory = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        memory += TensorLayout{inputs[i], opr->input(i)->dtype()}.span().dist_byte();
+    }
+    auto&& y = opr->output(0);
+    memory += TensorLayout{output, y->dtype()}.span().dist_byte();
+    float orig_computation =
+            m_opr_footprint.get_computation(const_cast<OperatorNodeBase*>(opr));
+    float computation = orig_computation;
+    if (reduce_input && opr->input(0)->shape().total_nr_elems() > 0) {
+        computation *= static_cast<float>(inputs[0].total_nr_elems()) /
+                       opr->input(0)->shape().total_nr_elems();
+    }
+    if (y->shape().total_nr_elems() > 0) {
+        computation *= static_cast<float>(output.total_nr_elems()) /
+                       y->shape().total_nr_elems();
+    }
+    if (computation > m_opr_threshold * orig_computation)
+        return PROFILE_TIME_OUT;
+    auto&& throughput = opr->input(0)->dtype().category() == DTypeCategory::FLOAT
+                              ? m_model.float_throughput
+                              : m_model.quantized_throughput;
+    float efficiency = throughput.get_efficiency(opr_format);
+    if (efficiency <= 0.f)
+        return PROFILE_TIME_OUT;
+    //! GFLOPS and GB/s are 1e3 operations and bytes per microsecond
+    float compute_time = computation / (throughput.gflops * efficiency * 1e3f);
+    float memory_time = memory / (m_model.bandwidth * 1e3f);
+    return std::max(compute_time, memory_time);
+}
+
+float CostModelProfiler::profile_operator(
+        const OperatorNodeBase* opr, TensorFormats base_format,
+        TensorFormats tensor_format, ReformatAttribute extra_attribute) const {
+    TensorShapeArray inputs;
+    for (auto&& i : opr->input()) {
+        inputs.emplace_back(ReformatManager::make_aligned_tensor_shape(
+                i, base_format, tensor_format, extra_attribute));
+    }
+    auto output = ReformatManager::make_aligned_tensor_shape(
+            opr->output(0), base_format, tensor_format, extra_attribute);
+    return estimate(
+            opr, tensor_formats_to_opr_format(tensor_format), inputs, output, false);
+}
+
+float CostModelProfiler::profile_operator(
+        const OperatorNodeBase* opr, const OprTensorFormatsConfiguration& base_config,
+        const OprTensorFormatsConfiguration& config,
+        ReformatAttribute extra_attribute) const {
+    TensorShapeArray inputs;
+    size_t nr_input_tensor =
+            std::min(config.input_tensor_formats.size(), opr->input().size());
+    for (size_t i = 0; i < opr->input().size(); ++i) {
+        auto&& var = opr->input(i);
+        if (i >= nr_input_tensor) {
+            inputs.emplace_back(var->shape());
+        } else if (config.input_tensor_types[i] == TensorType::WEIGHT) {
+            inputs.emplace_back(ReformatManager::make_aligned_weight_shape(
+                    var, base_config.input_tensor_formats[i],
+                    config.input_tensor_formats[i], config.output_tensor_formats[0],
+                    extra_attribute));
+        } else {
+            inputs.emplace_back(ReformatManager::make_aligned_tensor_shape(
+                    var, base_config.input_tensor_formats[i],
+                    config.input_tensor_formats[i], extra_attribute));
+        }
+    }
+    auto output = ReformatManager::make_aligned_tensor_shape(
+            opr->output(0), base_config.output_tensor_formats[0],
+            config.output_tensor_formats[0], extra_attribute);
+    bool reduce_input = opr->same_type<opr::ConvBiasForward>() ||
+                        opr->same_type<opr::ConvolutionForward>() ||
+                        opr->same_type<opr::ConvolutionBackwardData>();
+    return estimate(opr, config.opr_format, inputs, output, reduce_input);
+}
+
+float CostModelProfiler::profile_var_node(
+        const VarNode* var, TensorFormats base_format, const ReformatKey& key) const {
+    auto from = ReformatManager::make_aligned_tensor_shape(
+            var, base_format, key.input_format, key.attribute);
+    auto to = ReformatManager::make_aligned_tensor_shape(
+            var, base_format, key.output_format, key.attribute);
+    if (!m_var_node_filter(var, from, to, key))
+        return PROFILE_TIME_OUT;
+    size_t memory = TensorLayout{from, var->dtype()}.span().dist_byte() +
+                    TensorLayout{to, var->dtype()}.span().dist_byte();
+    return memory / (m_model.bandwidth * 1e3f);
+}
+
 /* ================== ProfilerBase =================*/
 ProfilerBase::ProfilerBase(float opr_threshold, float var_node_threshold)
         : m_opr_threshold{opr_threshold}, m_var_node_threshold{var_node_threshold} {
@@ -595,4 +873,61 @@ std::unique_ptr<ProfilerBase> ProfilerBase::make_profiler() {
     return std::make_unique<ProfilerImpl>();
 }
 
+std::unique_ptr<ProfilerBase> ProfilerBase::make_cost_model_profiler(CostModel model) {
+    return std::make_unique<CostModelProfiler>(std::move(model));
+}
+
+float ProfilerBase::CostModel::Throughput::get_efficiency(OprFormat opr_format) const {
+    auto iter = efficiency.find(opr_format);
+    return iter == efficiency.end() ? default_efficiency : iter->second;
+}
+
+ProfilerBase::CostModel ProfilerBase::CostModel::make(
+        GraphTuningOptions::Target target) {
+    using Target = GraphTuningOptions::Target;
+    CostModel model;
+    auto&& fp = model.float_throughput;
+    auto&& q = model.quantized_throughput;
+    switch (target) {
+        case Target::CUDA:
+            fp.gflops = 10000.f;
+            fp.efficiency = {
+                    {OprFormat::NCHW, 0.6f},
+                    {OprFormat::NHWC, 0.6f},
+                    {OprFormat::NCHW4, 0.3f}};
+            q.gflops = 40000.f;
+            //! quantized kernels of NCHW are naive ones
+            q.efficiency = {
+                    {OprFormat::NCHW, 0.01f},  {OprFormat::NHWC, 0.6f},
+                    {OprFormat::NCHW4, 0.4f},  {OprFormat::CHWN4, 0.4f},
+                    {OprFormat::NCHW32, 0.8f}, {OprFormat::NCHW64, 0.8f}};
+            model.bandwidth = 400.f;
+            break;
+        case Target::ARM:
+            fp.gflops = 50.f;
+            fp.efficiency = {
+                    {OprFormat::NCHW, 0.4f},
+                    {OprFormat::NCHW44, 0.8f},
+                    {OprFormat::NCHW88, 0.8f}};
+            q.gflops = 200.f;
+            q.efficiency = {
+                    {OprFormat::NCHW, 0.2f},
+                    {OprFormat::NCHW44, 0.6f},
+                    {OprFormat::NCHW44_DOT, 0.9f}};
+            model.bandwidth = 10.f;
+            break;
+        case Target::X86:
+            fp.gflops = 200.f;
+            fp.efficiency = {{OprFormat::NCHW, 0.5f}, {OprFormat::NCHW88, 0.8f}};
+            q.gflops = 400.f;
+            model.bandwidth = 20.f;
+            break;
+        default:
+            fp.gflops = q.gflops = 100.f;
+            model.bandwidth = 10.f;
+            break;
+    }
+    return model;
+}
+
 // vim: syntax=cpp.doxygen
@@ -17,8 +17,10 @@
 #include "megbrain/opr/blas.h"
 #include "megbrain/opr/dnn/batch_norm.h"
 #include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/dnn/fused_attention.h"
 #include "megbrain/opr/dnn/local.h"
 #include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/misc.h"
 #include "megbrain/opr/nn_int.h"
@@ -27,6 +29,7 @@
 #include "megbrain/opr/tensor_gen.h"
 #include "megbrain/opr/tensor_manip.h"
 #include "megbrain/opr/utility.h"
+#include "megbrain/plugin/opr_footprint.h"
 #include "megbrain/serialization/opr_shallow_copy.h"
 #include "megbrain/utils/hash_ct.h"
 #include "megbrain/utils/shared_set.h"
@@ -117,10 +120,13 @@ SymbolVarArray gopt::optimize_for_inference(
 }
 
 SymbolVarArray gopt::layout_transform(
-        const SymbolVarArray& dest_vars, GraphTuningOptions::Target target) {
+        const SymbolVarArray& dest_vars, GraphTuningOptions::Target target,
+        bool cost_model) {
     GraphTuningOptions options;
     options.target = target;
     options.enable_layout_transform();
+    if (cost_model)
+        options.enable_cost_model();
     return gopt::GraphOptimizer{}
             .add_passes_for_graph_tuning_options(options)
             .apply({dest_vars})
@@ -608,6 +614,69 @@ void ParamFusePass::apply(OptState& state) const {
     MIDOUT_E
 }
 
+/* ================ FoldConstShapePass ================ */
+const char* FoldConstShapePass::name() const {
+    return mgb_cstr_log("fold_const_shape");
+}
+
+void FoldConstShapePass::apply(OptState& state) const {
+    MIDOUT_B("FoldConstShapePass::apply")
+    auto rewriter = state.graph().make_rewriter();
+    auto&& mgr = state.graph().comp_graph()->static_infer_manager();
+
+    auto is_const = [&mgr](VarNode* var) {
+        return !var->contain_flag(VarNode::Flag::VOLATILE_CONTENT) &&
+               cg::is_const_var_value(var) &&
+               var->shape().total_nr_elems() < MAX_NR_ELEMS &&
+               mgr.infer_value(var).layout().is_contiguous();
+    };
+
+    ThinHashSet<VarNode*> processed_var;
+    // reader: null if used as endvar
+    auto replace_single_var = [&](VarNode* var, OperatorNodeBase* reader) {
+        if (!processed_var.insert(var).second)
+            return;
+        HostTensorND hv;
+        hv.copy_from(mgr.infer_value(var)).sync();
+        auto new_var = opr::ImmutableTensor::make(
+                *var->owner_graph(), hv, OperatorNodeConfig{var->comp_node()});
+        std::string log;
+        if (reader) {
+            log = mgb_ssprintf_log(
+                    "due to read by %s{%s}", reader->cname(),
+                    reader->dyn_typeinfo()->name);
+        } else {
+            log = mgb_cstr_log("as endpoint");
+        }
+        rewriter.replace_var(var, new_var.node(), log.c_str());
+    };
+
+    auto replace_opr = [&](OperatorNodeBase* opr) {
+        bool all_const_out = true;
+        for (auto i : opr->output()) {
+            if (!i->contain_flag(VarNode::Flag::VOLATILE_CONTENT))
+                all_const_out &= is_const(i);
+        }
+        for (auto i : opr->input()) {
+            auto src = i->owner_opr();
+            if (!all_const_out && !src->input().empty() && is_const(i)) {
+                state.call_with_opr(src, [&] { replace_single_var(i, opr); });
+            }
+        }
+        rewriter.auto_replace_outputs(opr);
+        if (all_const_out && !opr->input().empty()) {
+            for (auto var : opr->output()) {
+                if (state.graph().endpoint_contain(var) && is_const(var))
+                    replace_single_var(var, nullptr);
+            }
+        }
+    };
+
+    state.graph().iter(replace_opr);
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
 /* ================ One2OneOprReplacePass ================ */
 const char* ConvertF32ToF16Pass::name() const {
     return mgb_cstr_log("convert_f32_to_f16");
@@ -626,26 +695,71 @@ void ConvertF32ToF16Pass::apply(OptState& state) const {
         dtypes.push_back(vars[i].node()->dtype());
     }
 
-    auto on_opr = [this, &rewriter, &new_inp_cache](OperatorNodeBase* opr) {
-        auto it = m_opr_replace_func.find(opr->dyn_typeinfo());
-        if (it != m_opr_replace_func.end()) {
-            auto&& new_inp = new_inp_cache;
-            new_inp.clear();
-            new_inp.reserve(opr->input().size());
-            for (auto i : opr->input()) {
-                new_inp.push_back(rewriter.get_var(i));
+    // float32 outputs of the oprs kept in float32
+    ThinHashSet<VarNode*> f32_vars;
+
+    auto replace_outputs = [&rewriter](OperatorNodeBase* opr,
+                                       OperatorNodeBase* new_opr) {
+        auto &&origin_out = opr->output(), &&cur_out = new_opr->output();
+        mgb_assert(
+                origin_out.size() == cur_out.size(),
+                "bad opr replace: src=%s{%s} dst=%s{%s}", opr->cname(),
+                opr->dyn_typeinfo()->name, new_opr->cname(),
+                new_opr->dyn_typeinfo()->name);
+        for (size_t i = 0; i < origin_out.size(); i++) {
+            rewriter.replace_var(origin_out[i], cur_out[i], nullptr);
+        }
+    };
+
+    auto keep_f32 = [&](OperatorNodeBase* opr) {
+        auto&& new_inp = new_inp_cache;
+        new_inp.clear();
+        bool has_replaced_inp = false;
+        for (auto i : opr->input()) {
+            auto new_var = rewriter.get_var(i);
+            if (i->dtype() == dtype::Float32() && new_var->dtype() != i->dtype()) {
+                auto cvt = try_cast_as_op<opr::TypeCvt>(new_var->owner_opr());
+                if (cvt && cvt->input(0)->dtype() == dtype::Float32())
+                    new_var = cvt->input(0);
+                else
+                    new_var = opr::TypeCvt::make(new_var, dtype::Float32()).node();
             }
-            auto new_opr = (it->second)(opr, new_inp);
+            has_replaced_inp |= new_var != i;
+            new_inp.push_back(new_var);
+        }
+        if (has_replaced_inp) {
+            replace_outputs(
+                    opr, serialization::copy_opr_shallow(*opr, new_inp, opr->config()));
+        }
+        for (auto i : opr->output()) {
+            if (i->dtype() == dtype::Float32())
+                f32_vars.insert(i);
+        }
+    };
 
-            auto &&origin_out = opr->output(), &&cur_out = new_opr->output();
-            mgb_assert(
-                    origin_out.size() == cur_out.size(),
-                    "bad opr replace: src=%s{%s} dst=%s{%s}", opr->cname(),
-                    opr->dyn_typeinfo()->name, new_opr->cname(),
-                    new_opr->dyn_typeinfo()->name);
-            for (size_t i = 0; i < origin_out.size(); i++) {
-                rewriter.replace_var(origin_out[i], cur_out[i], nullptr);
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (m_keep_f32 && m_keep_f32(opr)) {
+            keep_f32(opr);
+            return;
+        }
+        auto&& new_inp = new_inp_cache;
+        new_inp.clear();
+        new_inp.reserve(opr->input().size());
+        bool has_f32_inp = false;
+        for (auto i : opr->input()) {
+            auto new_var = rewriter.get_var(i);
+            if (f32_vars.count(i)) {
+                new_var = opr::TypeCvt::make(new_var, m_target_dtype).node();
+                has_f32_inp = true;
             }
+            new_inp.push_back(new_var);
+        }
+        auto it = m_opr_replace_func.find(opr->dyn_typeinfo());
+        if (it != m_opr_replace_func.end()) {
+            replace_outputs(opr, (it->second)(opr, new_inp));
+        } else if (has_f32_inp) {
+            replace_outputs(
+                    opr, serialization::copy_opr_shallow(*opr, new_inp, opr->config()));
         } else {
             rewriter.auto_replace_outputs(opr);
         }
@@ -672,53 +786,59 @@ void ConvertF32ToF16Pass::apply(OptState& state) const {
     MIDOUT_E
 }
 
-std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp) {
-#if MEGDNN_DISABLE_FLOAT16
-    mgb_throw(SystemError, "float16 disabled at compile time.");
-#else
-    auto replace_h2d_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+void ConvertF32ToF16Pass::init_replace_func(bool use_f32_comp) {
+    DType target = m_target_dtype;
+    auto replace_h2d_opr = [target](
+                                   OperatorNodeBase* opr,
+                                   const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
         auto& h2d_opr = opr->cast_final_safe<opr::Host2DeviceCopy>();
         if (h2d_opr.output(0)->dtype() == dtype::Float32()) {
-            auto cvt_var = opr::TypeCvt::make(h2d_opr.output(0), dtype::Float16(), {});
+            auto cvt_var = opr::TypeCvt::make(h2d_opr.output(0), target, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_sdt_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_sdt_opr = [target](
+                                   OperatorNodeBase* opr,
+                                   const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
         auto& sdt_opr = opr->cast_final_safe<opr::SharedDeviceTensor>();
         if (sdt_opr.output(0)->dtype() == dtype::Float32()) {
-            auto cvt_var = opr::TypeCvt::make(sdt_opr.output(0), dtype::Float16(), {});
+            auto cvt_var = opr::TypeCvt::make(sdt_opr.output(0), target, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_imt_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_imt_opr = [target](
+                                   OperatorNodeBase* opr,
+                                   const VarNodeArray& new_inp) {
         mgb_assert(opr->same_type<opr::ImmutableTensor>());
         mgb_assert(opr->input().size() == new_inp.size());
         auto& imt_opr = opr->cast_final_safe<opr::ImmutableTensor>();
         if (imt_opr.output(0)->dtype() == dtype::Float32()) {
-            auto cvt_var = opr::TypeCvt::make(imt_opr.output(0), dtype::Float16(), {});
+            auto cvt_var = opr::TypeCvt::make(imt_opr.output(0), target, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_lsp_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_lsp_opr = [target](
+                                   OperatorNodeBase* opr,
+                                   const VarNodeArray& new_inp) {
         mgb_assert(opr->same_type<opr::Linspace>());
         mgb_assert(opr->input().size() == new_inp.size());
         auto& lsp_opr = opr->cast_final_safe<opr::Linspace>();
-        if (lsp_opr.output(0)->dtype() != dtype::Float16()) {
-            auto cvt_var = opr::TypeCvt::make(lsp_opr.output(0), dtype::Float16(), {});
+        if (lsp_opr.output(0)->dtype() != target) {
+            auto cvt_var = opr::TypeCvt::make(lsp_opr.output(0), target, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_conv_opr = [use_f32_comp](
+    auto replace_conv_opr = [use_f32_comp, target](
                                     OperatorNodeBase* opr,
                                     const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
@@ -728,11 +848,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::Convolution::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         auto new_conv_opr = opr::Convolution::make(
@@ -741,7 +861,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_conv_opr.node()->owner_opr();
     };
 
-    auto replace_deconv_opr = [use_f32_comp](
+    auto replace_deconv_opr = [use_f32_comp, target](
                                       OperatorNodeBase* opr,
                                       const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
@@ -751,11 +871,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::Convolution::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         auto new_deconv_opr = opr::ConvolutionBackwardData::make(
@@ -764,7 +884,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_deconv_opr.node()->owner_opr();
     };
 
-    auto replace_convbias_opr = [use_f32_comp](
+    auto replace_convbias_opr = [use_f32_comp, target](
                                         OperatorNodeBase* opr,
                                         const VarNodeArray& new_inp) {
         auto& convbias_opr = opr->cast_final_safe<opr::ConvBiasForward>();
@@ -773,11 +893,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::ConvBias::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         if (opr->input().size() == 2) {
@@ -816,7 +936,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
                 return new_matmul_opr.node()->owner_opr();
             };
 
-    auto replace_batched_matmul_opr = [use_f32_comp](
+    auto replace_batched_matmul_opr = [use_f32_comp, target](
                                               OperatorNodeBase* opr,
                                               const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
@@ -826,11 +946,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::MatrixMul::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         auto new_matmul_opr = opr::BatchedMatrixMul::make(
@@ -839,34 +959,47 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_matmul_opr.node()->owner_opr();
     };
 
-    auto replace_reduce_opr = [use_f32_comp](
+    auto replace_reduce_opr = [use_f32_comp, target](
                                       OperatorNodeBase* opr,
                                       const VarNodeArray& new_inp) {
+        using Mode = megdnn::param::Reduce::Mode;
         auto& reduce_opr = opr->cast_final_safe<opr::Reduce>();
         auto new_param = reduce_opr.param();
-        if (use_f32_comp) {
+        auto src = new_inp[0];
+        //! FLOAT_O16xC32 always outputs float16, so the other targets are
+        //! reduced on float32 inputs unless the mode needs no accumulation
+        bool reduce_f32 = target.enumv() != megdnn::DTypeEnum::Float16 &&
+                          src->dtype() == target && new_param.mode != Mode::MAX &&
+                          new_param.mode != Mode::MIN;
+        if (reduce_f32) {
+            src = opr::TypeCvt::make(src, dtype::Float32()).node();
+        } else if (use_f32_comp) {
             new_param.data_type = megdnn::param::Reduce::DataType::FLOAT_O16xC32;
         }
+        SymbolVar new_reduce;
         if (opr->input().size() == 1) {
-            auto new_matmul_opr =
-                    opr::Reduce::make(new_inp[0], new_param, {}, reduce_opr.config());
-            return new_matmul_opr.node()->owner_opr();
+            new_reduce = opr::Reduce::make(src, new_param, {}, reduce_opr.config());
         } else {
             mgb_assert(
                     opr->input().size() == 2, "invalid input size %zu",
                     opr->input().size());
-            auto new_matmul_opr = opr::Reduce::make(
-                    new_inp[0], new_param, new_inp[1], reduce_opr.config());
-            return new_matmul_opr.node()->owner_opr();
+            new_reduce =
+                    opr::Reduce::make(src, new_param, new_inp[1], reduce_opr.config());
         }
+        if (reduce_f32) {
+            new_reduce = opr::TypeCvt::make(new_reduce, target);
+        }
+        return new_reduce.node()->owner_opr();
     };
 
-    auto replace_cvt_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_cvt_opr = [target](
+                                   OperatorNodeBase* opr,
+                                   const VarNodeArray& new_inp) {
         auto& cvt_opr = opr->cast_final_safe<opr::TypeCvt>();
         SymbolVar new_cvt;
         if (cvt_opr.output(0)->dtype() == dtype::Float32()) {
             new_cvt =
-                    opr::TypeCvt::make(new_inp[0], dtype::Float16(), cvt_opr.config());
+                    opr::TypeCvt::make(new_inp[0], target, cvt_opr.config());
         } else {
             new_cvt = opr::TypeCvt::make(
                     new_inp[0], cvt_opr.output()[0]->dtype(), cvt_opr.config());
@@ -921,11 +1054,10 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_remap.node()->owner_opr();
     };
 
-    auto ret = std::make_unique<ConvertF32ToF16Pass>();
     // don't check dtype
-    ret->set_var_replace_check_flag(
+    set_var_replace_check_flag(
             VarReplaceCheckFlag::CHECK_ALL ^ VarReplaceCheckFlag::CHECK_DTYPE);
-    auto&& replace_func = ret->m_opr_replace_func;
+    auto&& replace_func = m_opr_replace_func;
     replace_func[opr::Linspace::typeinfo()] = replace_lsp_opr;
     replace_func[opr::Host2DeviceCopy::typeinfo()] = replace_h2d_opr;
     replace_func[opr::SharedDeviceTensor::typeinfo()] = replace_sdt_opr;
@@ -939,10 +1071,204 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
     replace_func[opr::WarpPerspective::typeinfo()] = replace_warp_opr;
     replace_func[opr::Remap::typeinfo()] = replace_remap_opr;
     replace_func[opr::BatchedMatrixMul::typeinfo()] = replace_batched_matmul_opr;
+}
+
+std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp) {
+#if MEGDNN_DISABLE_FLOAT16
+    mgb_throw(SystemError, "float16 disabled at compile time.");
+#else
+    auto ret = std::make_unique<ConvertF32ToF16Pass>();
+    ret->m_target_dtype = dtype::Float16();
+    ret->init_replace_func(use_f32_comp);
     return ret;
 #endif
 }
 
+/* ================ ConvertF32ToBF16Pass ================ */
+const char* ConvertF32ToBF16Pass::name() const {
+    return mgb_cstr_log("convert_f32_to_bf16");
+}
+
+std::unique_ptr<ConvertF32ToBF16Pass> ConvertF32ToBF16Pass::make() {
+#if MEGDNN_DISABLE_FLOAT16
+    mgb_throw(SystemError, "bfloat16 disabled at compile time.");
+#else
+    auto ret = std::make_unique<ConvertF32ToBF16Pass>();
+    ret->m_target_dtype = dtype::BFloat16();
+    ret->init_replace_func(true);
+    return ret;
+#endif
+}
+
+/* ================ convert_f32_to_f16_with_error_budget ================ */
+#if !MEGDNN_DISABLE_FLOAT16
+namespace {
+float value_at(const HostTensorND& val, size_t idx) {
+    if (val.dtype() == dtype::Float16())
+        return val.ptr<dt_float16>()[idx];
+    return val.ptr<dt_float32>()[idx];
+}
+
+//! max|val - ref| / max|ref|, or infinity if val is not finite
+float relative_error(const HostTensorND& ref, const HostTensorND& val) {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    if (!ref.shape().eq_shape(val.shape()))
+        return inf;
+    float max_ref = 0.f, max_diff = 0.f;
+    for (size_t i = 0, it = ref.shape().total_nr_elems(); i < it; ++i) {
+        float a = value_at(ref, i), b = value_at(val, i);
+        if (!std::isfinite(a))
+            continue;
+        if (!std::isfinite(b))
+            return inf;
+        max_ref = std::max(max_ref, std::abs(a));
+        max_diff = std::max(max_diff, std::abs(a - b));
+    }
+    return max_diff / std::max(max_ref, 1e-6f);
+}
+
+std::vector<HostTensorND> get_values(
+        ComputingGraph& graph, const VarNodeArray& vars) {
+    std::vector<HostTensorND> values(vars.size());
+    ComputingGraph::OutputSpec out_spec;
+    for (size_t i = 0; i < vars.size(); ++i) {
+        auto&& val = values[i];
+        out_spec.push_back(
+                {vars[i], [&val](DeviceTensorND& dv) { val.copy_from(dv).sync(); }});
+    }
+    graph.compile(out_spec)->execute().wait();
+    return values;
+}
+}  // anonymous namespace
+#endif
+
+SymbolVarArray gopt::convert_f32_to_f16_with_error_budget(
+        const SymbolVarArray& dest_vars, float error_budget, bool use_f32_comp) {
+#if MEGDNN_DISABLE_FLOAT16
+    mgb_throw(SystemError, "float16 disabled at compile time.");
+#else
+    mgb_assert(!dest_vars.empty() && error_budget >= 0);
+    auto&& graph = *dest_vars[0].node()->owner_graph();
+    SubGraph orig{dest_vars};
+
+    // the float32 vars to be compared and the oprs which could be kept
+    VarNodeArray vars;
+    std::vector<OperatorNodeBase*> candidates;
+    ThinHashMap<VarNode*, std::vector<OperatorNodeBase*>> readers;
+    orig.iter([&](OperatorNodeBase* opr) {
+        bool has_f32_out = false;
+        for (auto i : opr->output()) {
+            if (i->dtype() == dtype::Float32() &&
+                !i->contain_flag(VarNode::Flag::VOLATILE_CONTENT)) {
+                vars.push_back(i);
+                has_f32_out = true;
+            }
+        }
+        if (has_f32_out && !opr->input().empty())
+            candidates.push_back(opr);
+        for (auto i : opr->input())
+            readers[i].push_back(opr);
+    });
+    auto ref = get_values(graph, vars);
+
+    ThinHashSet<OperatorNodeBase*> kept;
+    OprFootprint opr_footprint;
+    auto is_kept = [&kept](OperatorNodeBase* opr) { return kept.count(opr) > 0; };
+    // an opr with kept producers and readers is kept as well if it is memory
+    // bound, since the casts around it would cost as much as the opr itself
+    auto absorb = [&](OperatorNodeBase* opr) {
+        bool has_kept_inp = false;
+        size_t nr_elems = 0;
+        for (auto i : opr->input()) {
+            if (i->dtype() != dtype::Float32())
+                continue;
+            auto src = i->owner_opr();
+            if (!src->input().empty() && !is_kept(src))
+                return false;
+            has_kept_inp |= !src->input().empty();
+            nr_elems += i->shape().total_nr_elems();
+        }
+        for (auto i : opr->output()) {
+            if (i->dtype() != dtype::Float32())
+                continue;
+            for (auto reader : readers[i]) {
+                if (!is_kept(reader))
+                    return false;
+            }
+            nr_elems += i->shape().total_nr_elems();
+        }
+        return has_kept_inp && opr_footprint.get_computation(opr) <= nr_elems;
+    };
+
+    for (;;) {
+        auto pass = ConvertF32ToF16Pass::make(use_f32_comp);
+        pass->set_keep_f32(is_kept);
+        auto new_vars = GraphOptimizer{}
+                                .add_pass(std::move(pass))
+                                .apply({dest_vars})
+                                .endpoint_vars();
+        if (kept.size() == candidates.size())
+            return new_vars;
+
+        VarNodeArray targets;
+        ThinHashMap<VarNode*, size_t> target2idx;
+        std::vector<size_t> var2target;
+        for (auto i : vars) {
+            auto ins = target2idx.insert(
+                    {GraphOptimizer::var_replace_lookup(i), targets.size()});
+            if (ins.second)
+                targets.push_back(ins.first->first);
+            var2target.push_back(ins.first->second);
+        }
+        auto values = get_values(graph, targets);
+        ThinHashMap<VarNode*, float> error;
+        for (size_t i = 0; i < vars.size(); ++i) {
+            error[vars[i]] = relative_error(ref[i], values[var2target[i]]);
+        }
+        auto max_error = [&error](const VarNodeArray& vars) {
+            float ret = 0.f;
+            for (auto i : vars) {
+                auto iter = error.find(i);
+                if (iter != error.end())
+                    ret = std::max(ret, iter->second);
+            }
+            return ret;
+        };
+        float endpoint_error = max_error(cg::to_var_node_array(dest_vars));
+        mgb_log_debug(
+                "convert_f32_to_f16: %zu of %zu oprs kept in float32, error %g",
+                kept.size(), candidates.size(), endpoint_error);
+        if (endpoint_error <= error_budget)
+            return new_vars;
+
+        // keep the opr amplifying the error the most, or the first one with
+        // the largest error if the error comes from the inputs of the graph
+        OperatorNodeBase* chosen = nullptr;
+        float chosen_gain = 0.f, chosen_error = -1.f;
+        for (auto opr : candidates) {
+            float gain = max_error(opr->output()) - max_error(opr->input());
+            if (!is_kept(opr) && gain > chosen_gain) {
+                chosen = opr;
+                chosen_gain = gain;
+            }
+        }
+        for (auto opr : candidates) {
+            float out_error = max_error(opr->output());
+            if (!chosen_gain && !is_kept(opr) && out_error > chosen_error) {
+                chosen = opr;
+                chosen_error = out_error;
+            }
+        }
+        mgb_assert(chosen);
+        kept.insert(chosen);
+        for (auto opr : candidates) {
+            if (!is_kept(opr) && absorb(opr))
+                kept.insert(opr);
+        }
+    }
+#endif
+}
+
 /* ================ ConvertFormatPass ================ */
 
 void ConvertFormatPass::apply(OptState& state) const {
@@ -1692,6 +2018,10 @@ void ConvertBatchNormToElemwisePass::apply(OptState& state) const {
                         variance + variance.make_scalar_dt(float(bn->param().epsilon)),
                         {-0.5});
                 auto res = scale * (x - mean) * invsqrt_variance + bias;
+                if (bn->param().nonlineMode ==
+                    opr::BatchNorm::Param::NonlineMode::RELU) {
+                    res = opr::Elemwise::make({res}, opr::Elemwise::Mode::RELU);
+                }
                 if (x.dtype() != res.dtype()) {
                     mgb_throw(
                             MegBrainError,
@@ -1836,35 +2166,77 @@ void FuseConvBiasNonlinPass::apply(OptState& state) const {
         return valid_bias_shape;
     };
 
+    //! remake the conv_bias with the new param and config, keeping its inputs
+    auto remake_conv_bias = [&](opr::ConvBias* conv_bias,
+                                const opr::ConvBias::Param& param,
+                                const OperatorNodeConfig& config) -> OperatorNodeBase* {
+        auto&& inp = conv_bias->input();
+        SymbolVar ret;
+        if (inp.size() == 4) {
+            // conv + bias + z
+            ret = opr::ConvBias::make(
+                    inp[0], inp[1], inp[2], inp[3], param,
+                    conv_bias->execution_policy(), config);
+        } else if (inp.size() == 3) {
+            // conv + bias
+            ret = opr::ConvBias::make(
+                    inp[0], inp[1], inp[2], param, conv_bias->execution_policy(),
+                    config);
+        } else {
+            // conv without bias
+            ret = opr::ConvBias::make(
+                    inp[0], inp[1], param, conv_bias->execution_policy(), config);
+        }
+        return ret.node()->owner_opr();
+    };
+
+    //! the requantization of a qint8 conv_bias output is folded into its
+    //! epilogue, which rounds and saturates only once
     auto try_fuse_typecvt = [&](opr::TypeCvt* typecvt) -> OperatorNodeBase* {
         mgb_assert(typecvt->input().size() == 1);
         auto conv_bias = try_cast_as_op<opr::ConvBias>(
                 rewriter.get_var(typecvt->input(0))->owner_opr());
-        if (!conv_bias || m_deps.count(typecvt->input(0)) != 1 ||
+        auto src_dtype = typecvt->input(0)->dtype().enumv();
+        if (!conv_bias || m_deps[typecvt->input(0)].size() != 1 ||
             typecvt->output(0)->dtype().enumv() !=
                     DTypeTrait<dtype::QuantizedS8>::enumv ||
-            typecvt->input(0)->dtype().enumv() !=
-                    DTypeTrait<dtype::QuantizedS32>::enumv)
+            (src_dtype != DTypeTrait<dtype::QuantizedS32>::enumv &&
+             src_dtype != DTypeTrait<dtype::QuantizedS8>::enumv))
             return nullptr;
 
         auto config = conv_bias->config();
         config.output_dtype(typecvt->output(0)->dtype());
-        if (conv_bias->input().size() == 3) {
-            // conv + bias
-            return opr::ConvBias::make(
-                           conv_bias->input(0), conv_bias->input(1),
-                           conv_bias->input(2), conv_bias->param(),
-                           conv_bias->execution_policy(), config)
-                    .node()
-                    ->owner_opr();
+        return remake_conv_bias(conv_bias, conv_bias->param(), config);
+    };
+
+    //! a quantized activation of a qint8 conv_bias without nonlinearity is
+    //! computed in the epilogue before the requantization
+    auto try_fuse_quantized_nonlinearity =
+            [&](opr::ElemwiseMultiType* elem) -> OperatorNodeBase* {
+        using MultiMode = opr::ElemwiseMultiType::Param::Mode;
+        NonlineMode nonline_mode;
+        if (elem->param().mode == MultiMode::QRELU) {
+            nonline_mode = NonlineMode::RELU;
+        } else if (elem->param().mode == MultiMode::QH_SWISH) {
+            nonline_mode = NonlineMode::H_SWISH;
         } else {
-            // conv without bias
-            return opr::ConvBias::make(
-                           conv_bias->input(0), conv_bias->input(1), conv_bias->param(),
-                           conv_bias->execution_policy(), config)
-                    .node()
-                    ->owner_opr();
+            return nullptr;
         }
+        if (elem->input().size() != 1)
+            return nullptr;
+        auto conv_bias = try_cast_as_op<opr::ConvBias>(
+                rewriter.get_var(elem->input(0))->owner_opr());
+        if (!conv_bias || m_deps[elem->input(0)].size() != 1 ||
+            conv_bias->param().nonlineMode != NonlineMode::IDENTITY ||
+            elem->input(0)->dtype().enumv() != DTypeTrait<dtype::QuantizedS8>::enumv ||
+            elem->output(0)->dtype().enumv() != DTypeTrait<dtype::QuantizedS8>::enumv)
+            return nullptr;
+
+        auto param = conv_bias->param();
+        param.nonlineMode = nonline_mode;
+        auto config = conv_bias->config();
+        config.output_dtype(elem->output(0)->dtype());
+        return remake_conv_bias(conv_bias, param, config);
     };
     auto on_opr = [&](OperatorNodeBase* opr) {
         auto check_conv = [](opr::Convolution* conv) -> bool {
@@ -1963,6 +2335,15 @@ void FuseConvBiasNonlinPass::apply(OptState& state) const {
                                      "conv_bias(x, w, b)"));
                 return;
             }
+        } else if (auto elem = try_cast_as_op<opr::ElemwiseMultiType>(opr)) {
+            auto new_opr = try_fuse_quantized_nonlinearity(elem);
+            if (new_opr) {
+                rewriter.replace_var(
+                        opr->output(0), new_opr->output(0),
+                        mgb_cstr_log("replace qnonlinearity(conv_bias(x, w, b)) -> "
+                                     "conv_bias(x, w, b)"));
+                return;
+            }
         }
         rewriter.auto_replace_outputs(opr);
     };
@@ -2170,6 +2551,1523 @@ void FuseDeconvCvtPass::apply(OptState& state) const {
     MIDOUT_E
 }
 
+/* ================ FuseSoftmaxPass ================ */
+const char* FuseSoftmaxPass::name() const {
+    return mgb_cstr_log("fuse_softmax");
+}
+
+void FuseSoftmaxPass::apply(OptState& state) const {
+    MIDOUT_B("FuseSoftmaxPass::apply")
+    using Mode = opr::Elemwise::Mode;
+    using ReduceMode = opr::Reduce::Mode;
+
+    ThinHashMap<VarNode*, size_t> nr_reader;
+    state.graph().iter([&nr_reader](OperatorNodeBase* opr) {
+        for (auto inp : opr->input()) {
+            ++nr_reader[inp];
+        }
+    });
+
+    auto as_elem = [](VarNode* var, Mode mode) -> opr::Elemwise* {
+        auto elem = try_cast_as_op<opr::Elemwise>(var->owner_opr());
+        if (elem && elem->param().mode == mode) {
+            return elem;
+        }
+        return nullptr;
+    };
+    //! return the input of a reduce opr along a single axis, or nullptr
+    auto as_reduce = [](VarNode* var, ReduceMode mode, int& axis) -> VarNode* {
+        auto reduce = try_cast_as_op<opr::Reduce>(var->owner_opr());
+        if (!reduce || reduce->input().size() != 1) {
+            return nullptr;
+        }
+        auto&& param = reduce->param();
+        if (param.mode != mode || param.axis < 0 ||
+            param.data_type != opr::Reduce::Param::DataType::DEFAULT) {
+            return nullptr;
+        }
+        axis = param.axis;
+        return reduce->input(0);
+    };
+
+    //! return the input of softmax if div computes softmax, or nullptr
+    auto match = [&](opr::Elemwise* div, int& axis) -> VarNode* {
+        VarNode *exp_var = div->input(0), *sum_var = div->input(1);
+        auto exp = as_elem(exp_var, Mode::EXP);
+        int max_axis;
+        if (!exp || as_reduce(sum_var, ReduceMode::SUM, axis) != exp_var) {
+            return nullptr;
+        }
+        auto sub = as_elem(exp->input(0), Mode::SUB);
+        if (!sub) {
+            return nullptr;
+        }
+        VarNode* src = sub->input(0);
+        if (as_reduce(sub->input(1), ReduceMode::MAX, max_axis) != src ||
+            max_axis != axis || src->dtype().category() != DTypeCategory::FLOAT) {
+            return nullptr;
+        }
+        // the intermediate values must not be used elsewhere
+        if (nr_reader[exp_var] != 2 || nr_reader[sum_var] != 1 ||
+            nr_reader[exp->input(0)] != 1 || nr_reader[sub->input(1)] != 1) {
+            return nullptr;
+        }
+        return src;
+    };
+
+    auto rewriter = state.graph().make_rewriter();
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        auto div = try_cast_as_op<opr::Elemwise>(opr);
+        int axis;
+        VarNode* src;
+        if (div && div->param().mode == Mode::TRUE_DIV && (src = match(div, axis))) {
+            auto softmax = opr::Softmax::make(
+                    rewriter.get_var(src), {axis}, div->config());
+            rewriter.replace_var(
+                    div->output(0), softmax.node(),
+                    mgb_cstr_log("replace exp(x - max(x)) / sum(exp(x - max(x))) "
+                                 "-> softmax(x)"));
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseAttentionPass ================ */
+const char* FuseAttentionPass::name() const {
+    return mgb_cstr_log("fuse_attention");
+}
+
+void FuseAttentionPass::apply(OptState& state) const {
+    MIDOUT_B("FuseAttentionPass::apply")
+    using Mode = opr::Elemwise::Mode;
+
+    ThinHashMap<VarNode*, size_t> nr_reader;
+    state.graph().iter([&nr_reader](OperatorNodeBase* opr) {
+        for (auto inp : opr->input()) {
+            ++nr_reader[inp];
+        }
+    });
+
+    //! bmm of 3-D float operands without transposed lhs
+    auto as_bmm = [](VarNode* var, bool transpose_b) -> opr::BatchedMatrixMul* {
+        auto bmm = try_cast_as_op<opr::BatchedMatrixMul>(var->owner_opr());
+        if (!bmm) {
+            return nullptr;
+        }
+        auto&& param = bmm->param();
+        using Param = opr::BatchedMatrixMul::Param;
+        if (param.transposeA || param.transposeB != transpose_b ||
+            param.compute_mode != Param::ComputeMode::DEFAULT ||
+            param.format != Param::Format::DEFAULT ||
+            var->dtype() != dtype::Float32() || var->shape().ndim != 3) {
+            return nullptr;
+        }
+        return bmm;
+    };
+    //! value of a scalar float32 constant
+    auto as_scalar = [](VarNode* var, float& val) {
+        auto imm = try_cast_as_op<opr::ImmutableTensor>(var->owner_opr());
+        if (!imm) {
+            return false;
+        }
+        auto&& hv = imm->host_value();
+        if (hv.layout().total_nr_elems() != 1 || hv.dtype() != dtype::Float32()) {
+            return false;
+        }
+        val = hv.ptr<float>()[0];
+        return true;
+    };
+    //! return the bmm computing q * k^T if var is (q * k^T) * scale
+    auto match_scores = [&](VarNode* var, float& scale) -> opr::BatchedMatrixMul* {
+        scale = 1.f;
+        auto elem = try_cast_as_op<opr::Elemwise>(var->owner_opr());
+        if (elem && elem->input().size() == 2) {
+            auto mode = elem->param().mode;
+            VarNode *lhs = elem->input(0), *rhs = elem->input(1);
+            float val;
+            if (mode == Mode::MUL && as_scalar(lhs, val)) {
+                std::swap(lhs, rhs);
+            } else if (
+                    (mode != Mode::MUL && mode != Mode::TRUE_DIV) ||
+                    !as_scalar(rhs, val)) {
+                return nullptr;
+            }
+            if (nr_reader[lhs] != 1 || lhs->shape().ndim != 3) {
+                return nullptr;
+            }
+            scale = mode == Mode::MUL ? val : 1.f / val;
+            var = lhs;
+        }
+        return as_bmm(var, true);
+    };
+
+    auto rewriter = state.graph().make_rewriter();
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        auto bmm = try_cast_as_op<opr::BatchedMatrixMul>(opr);
+        opr::BatchedMatrixMul* bmm_qk = nullptr;
+        float scale;
+        if (bmm && as_bmm(opr->output(0), false)) {
+            auto softmax = try_cast_as_op<opr::Softmax>(opr->input(0)->owner_opr());
+            if (softmax && nr_reader[opr->input(0)] == 1 &&
+                (softmax->param().axis == 2 || softmax->param().axis == -1) &&
+                nr_reader[softmax->input(0)] == 1) {
+                bmm_qk = match_scores(softmax->input(0), scale);
+            }
+        }
+        if (bmm_qk && opr->input(1)->shape().ndim == 3) {
+            auto attn = opr::FusedAttention::make(
+                    rewriter.get_var(bmm_qk->input(0)),
+                    rewriter.get_var(bmm_qk->input(1)),
+                    rewriter.get_var(opr->input(1)), {scale}, opr->config());
+            rewriter.replace_var(
+                    opr->output(0), attn.node(),
+                    mgb_cstr_log("replace bmm(softmax(bmm(q, k^T) * scale), v) "
+                                 "-> fused_attention(q, k, v)"));
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FoldMatrixMulDimshufflePass ================ */
+namespace {
+//! whether the dimshuffle only swaps the last two axes
+bool is_last_two_axes_swap(opr::Dimshuffle* ds) {
+    auto param = ds->param();
+    int ndim = param.pattern_len;
+    if (ndim < 2 || ds->input(0)->shape().ndim != static_cast<size_t>(ndim)) {
+        return false;
+    }
+    for (int i = 0; i + 2 < ndim; ++i) {
+        if (param.pattern[i] != i) {
+            return false;
+        }
+    }
+    return param.pattern[ndim - 2] == ndim - 1 && param.pattern[ndim - 1] == ndim - 2;
+}
+
+//! whether reshaping src to dst only merges or splits the axes before the last
+//! two
+bool reshapes_batch_axes(const TensorShape& src, const TensorShape& dst) {
+    return src.ndim >= 2 && dst.ndim >= 2 && src.total_nr_elems() &&
+           src.total_nr_elems() == dst.total_nr_elems() &&
+           src[src.ndim - 1] == dst[dst.ndim - 1] &&
+           src[src.ndim - 2] == dst[dst.ndim - 2];
+}
+
+//! the param of a float MatrixMul/BatchedMatrixMul of the default format
+Maybe<megdnn::param::MatrixMul> foldable_matmul_param(OperatorNodeBase* opr) {
+    megdnn::param::MatrixMul param;
+    if (auto mm = try_cast_as_op<opr::MatrixMul>(opr)) {
+        param = mm->param();
+    } else if (auto bmm = try_cast_as_op<opr::BatchedMatrixMul>(opr)) {
+        param = bmm->param();
+    } else {
+        return None;
+    }
+    auto dtype = opr->output(0)->dtype();
+    if (param.format != megdnn::param::MatrixMul::Format::DEFAULT ||
+        (dtype != dtype::Float32() && dtype != dtype::Float16())) {
+        return None;
+    }
+    return param;
+}
+
+//! make a matmul of the same type and policy as opr
+VarNode* make_matmul_like(
+        OperatorNodeBase* opr, VarNode* a, VarNode* b,
+        const megdnn::param::MatrixMul& param) {
+    if (auto mm = try_cast_as_op<opr::MatrixMul>(opr)) {
+        return opr::MatrixMul::make(
+                       a, b, param, mm->execution_policy(), opr->config())
+                .node();
+    }
+    auto bmm = &opr->cast_final_safe<opr::BatchedMatrixMul>();
+    return opr::BatchedMatrixMul::make(
+                   a, b, param, bmm->execution_policy(), opr->config())
+            .node();
+}
+}  // namespace
+
+const char* FoldMatrixMulDimshufflePass::name() const {
+    return mgb_cstr_log("fold_matmul_dimshuffle");
+}
+
+void FoldMatrixMulDimshufflePass::apply(OptState& state) const {
+    MIDOUT_B("FoldMatrixMulDimshufflePass::apply")
+    ThinHashMap<VarNode*, size_t> nr_reader;
+    state.graph().iter([&nr_reader](OperatorNodeBase* opr) {
+        for (auto inp : opr->input()) {
+            ++nr_reader[inp];
+        }
+    });
+    for (auto&& i : state.graph().endpoint_vars()) {
+        ++nr_reader[i.node()];
+    }
+
+    auto rewriter = state.graph().make_rewriter();
+    //! return x if var is swap_last_two_axes(x), where a reshape of the
+    //! batch axes after the swap is moved before it
+    auto untranspose = [](VarNode* var) -> VarNode* {
+        auto reshape = try_cast_as_op<opr::Reshape>(var->owner_opr());
+        auto inner = reshape ? reshape->input(0) : var;
+        auto ds = try_cast_as_op<opr::Dimshuffle>(inner->owner_opr());
+        if (!ds || !is_last_two_axes_swap(ds)) {
+            return nullptr;
+        }
+        if (!reshape) {
+            return ds->input(0);
+        }
+        if (!reshapes_batch_axes(inner->shape(), var->shape())) {
+            return nullptr;
+        }
+        auto shape = var->shape();
+        std::swap(shape[shape.ndim - 1], shape[shape.ndim - 2]);
+        return opr::Reshape::make(ds->input(0), shape).node();
+    };
+
+    auto try_fold_inputs = [&](OperatorNodeBase* opr) {
+        auto param = foldable_matmul_param(opr);
+        if (!param.valid()) {
+            return false;
+        }
+        auto new_param = param.val();
+        bool* transpose[2] = {&new_param.transposeA, &new_param.transposeB};
+        VarNode* inps[2];
+        bool folded = false;
+        for (size_t i = 0; i < 2; ++i) {
+            inps[i] = rewriter.get_var(opr->input(i));
+            if (auto src = untranspose(inps[i])) {
+                inps[i] = src;
+                *transpose[i] = !*transpose[i];
+                folded = true;
+            }
+        }
+        if (!folded) {
+            return false;
+        }
+        rewriter.replace_var(
+                opr->output(0), make_matmul_like(opr, inps[0], inps[1], new_param),
+                mgb_cstr_log("fold dimshuffle of matmul input into transpose"));
+        return true;
+    };
+
+    //! (a * b)^T -> b^T * a^T
+    auto try_fold_output = [&](opr::Dimshuffle* ds) {
+        if (!is_last_two_axes_swap(ds)) {
+            return false;
+        }
+        auto var = ds->input(0);
+        auto reshape = try_cast_as_op<opr::Reshape>(var->owner_opr());
+        auto mm_out = reshape ? reshape->input(0) : var;
+        if ((reshape && (nr_reader[var] != 1 ||
+                         !reshapes_batch_axes(mm_out->shape(), var->shape()))) ||
+            nr_reader[mm_out] != 1 || mm_out != mm_out->owner_opr()->output(0) ||
+            !foldable_matmul_param(mm_out->owner_opr()).valid()) {
+            return false;
+        }
+        //! the matmul may have its inputs folded already
+        auto matmul = rewriter.get_var(mm_out)->owner_opr();
+        auto param = foldable_matmul_param(matmul);
+        if (!param.valid()) {
+            return false;
+        }
+        auto new_param = param.val();
+        new_param.transposeA = !param->transposeB;
+        new_param.transposeB = !param->transposeA;
+        auto out = make_matmul_like(
+                matmul, matmul->input(1), matmul->input(0), new_param);
+        if (reshape) {
+            out = opr::Reshape::make(out, ds->output(0)->shape()).node();
+        }
+        rewriter.replace_var(
+                ds->output(0), out,
+                mgb_cstr_log("fold dimshuffle of matmul output into transpose"));
+        return true;
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        if (auto ds = try_cast_as_op<opr::Dimshuffle>(opr)) {
+            if (try_fold_output(ds)) {
+                return;
+            }
+        } else if (try_fold_inputs(opr)) {
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseHorizontalPass ================ */
+namespace {
+//! axis of the weight along which the siblings are concatenated, or -1 if the
+//! opr could not be fused horizontally; the outputs are split along axis 1
+int horizontal_fuse_axis(OperatorNodeBase* opr) {
+    using Sparse = opr::Convolution::Param::Sparse;
+    if (auto conv = try_cast_as_op<opr::Convolution>(opr)) {
+        auto&& param = conv->param();
+        bool ok = param.format == opr::Convolution::Param::Format::NCHW &&
+                  param.sparse == Sparse::DENSE;
+        return ok ? 0 : -1;
+    }
+    if (auto conv_bias = try_cast_as_op<opr::ConvBias>(opr)) {
+        auto&& param = conv_bias->param();
+        bool ok = param.format == opr::ConvBias::Param::Format::NCHW &&
+                  param.sparse == Sparse::DENSE && opr->input().size() <= 3;
+        if (ok && opr->input().size() == 3) {
+            auto&& bias = opr->input(2)->shape();
+            ok = bias.ndim == 4 && bias[0] == 1 && bias[2] == 1 && bias[3] == 1;
+        }
+        return ok ? 0 : -1;
+    }
+    if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+        auto&& param = matmul->param();
+        if (param.format != opr::MatrixMul::Param::Format::DEFAULT)
+            return -1;
+        return param.transposeB ? 0 : 1;
+    }
+    return -1;
+}
+
+template <typename Opr>
+bool same_param(OperatorNodeBase* lhs, OperatorNodeBase* rhs) {
+    auto &&p0 = lhs->cast_final<Opr>().param(), &&p1 = rhs->cast_final<Opr>().param();
+    return !memcmp(&p0, &p1, sizeof(p0));
+}
+
+//! whether rhs could be concatenated to lhs, which is a valid opr for
+//! horizontal_fuse_axis()
+bool horizontal_fusible(OperatorNodeBase* lhs, OperatorNodeBase* rhs) {
+    auto type = lhs->dyn_typeinfo();
+    if (type != rhs->dyn_typeinfo() || horizontal_fuse_axis(rhs) < 0 ||
+        lhs->input().size() != rhs->input().size() ||
+        lhs->output(0)->dtype() != rhs->output(0)->dtype() ||
+        lhs->output(0)->comp_node() != rhs->output(0)->comp_node())
+        return false;
+    bool ok = type == opr::Convolution::typeinfo()
+                    ? same_param<opr::Convolution>(lhs, rhs)
+            : type == opr::ConvBias::typeinfo() ? same_param<opr::ConvBias>(lhs, rhs)
+                                                : same_param<opr::MatrixMul>(lhs, rhs);
+    // the weight of a conv and its bias differ in axis 0 and 1 respectively
+    int axis = horizontal_fuse_axis(lhs);
+    for (size_t i = 1; ok && i < lhs->input().size(); ++i) {
+        auto &&v0 = lhs->input(i), &&v1 = rhs->input(i);
+        TensorShape s0 = v0->shape(), s1 = v1->shape();
+        if (s0.ndim != s1.ndim || v0->dtype() != v1->dtype())
+            return false;
+        s0[i == 1 ? axis : 1] = s1[i == 1 ? axis : 1] = 1;
+        ok = s0.eq_shape(s1);
+    }
+    return ok;
+}
+}  // anonymous namespace
+
+const char* FuseHorizontalPass::name() const {
+    return mgb_cstr_log("fuse_horizontal");
+}
+
+void FuseHorizontalPass::apply(OptState& state) const {
+    MIDOUT_B("FuseHorizontalPass::apply")
+    ConstVarPropogate cvprop{ConstVarType::IMMUTABLE_AND_PARAM};
+    // the candidates reading each input, in topological order
+    ThinHashMap<VarNode*, std::vector<OperatorNodeBase*>> candidates;
+    VarNodeArray shared_inputs;
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        cvprop.add_opr(opr);
+        if (horizontal_fuse_axis(opr) < 0 || cvprop.is_const(opr->input(0)) ||
+            !opr->output(0)->shape().ndim)
+            return;
+        for (size_t i = 1; i < opr->input().size(); ++i) {
+            if (!cvprop.is_const(opr->input(i)) || !opr->input(i)->shape().ndim)
+                return;
+        }
+        auto&& oprs = candidates[opr->input(0)];
+        if (oprs.empty())
+            shared_inputs.push_back(opr->input(0));
+        oprs.push_back(opr);
+    });
+
+    // the groups of the siblings to be fused, keyed by their first opr
+    ThinHashMap<OperatorNodeBase*, std::vector<OperatorNodeBase*>> groups;
+    ThinHashSet<OperatorNodeBase*> fused;
+    for (auto inp : shared_inputs) {
+        auto&& oprs = candidates[inp];
+        for (size_t i = 0; i < oprs.size(); ++i) {
+            if (fused.count(oprs[i]))
+                continue;
+            std::vector<OperatorNodeBase*> group{oprs[i]};
+            for (size_t j = i + 1; j < oprs.size(); ++j) {
+                if (!fused.count(oprs[j]) && horizontal_fusible(oprs[i], oprs[j]))
+                    group.push_back(oprs[j]);
+            }
+            if (group.size() < 2)
+                continue;
+            for (auto opr : group)
+                fused.insert(opr);
+            groups[oprs[i]] = std::move(group);
+        }
+    }
+
+    auto rewriter = state.graph().make_rewriter();
+    auto fuse = [&rewriter](const std::vector<OperatorNodeBase*>& group) {
+        auto leader = group[0];
+        int axis = horizontal_fuse_axis(leader);
+        VarNodeArray new_inp{rewriter.get_var(leader->input(0))};
+        std::vector<size_t> partition;
+        for (size_t i = 1; i < leader->input().size(); ++i) {
+            SymbolVarArray params;
+            for (auto opr : group) {
+                params.push_back(rewriter.get_var(opr->input(i)));
+                if (i == 1)
+                    partition.push_back(opr->input(i)->shape()[axis]);
+            }
+            new_inp.push_back(opr::Concat::make(params, i == 1 ? axis : 1).node());
+        }
+        SymbolVar fused_var;
+        if (auto conv = try_cast_as_op<opr::Convolution>(leader)) {
+            fused_var = opr::Convolution::make(
+                    new_inp[0], new_inp[1], conv->param(), conv->execution_policy(),
+                    leader->config());
+        } else if (auto conv_bias = try_cast_as_op<opr::ConvBias>(leader)) {
+            if (new_inp.size() == 2) {
+                fused_var = opr::ConvBias::make(
+                        new_inp[0], new_inp[1], conv_bias->param(),
+                        conv_bias->execution_policy(), leader->config());
+            } else {
+                fused_var = opr::ConvBias::make(
+                        new_inp[0], new_inp[1], new_inp[2], conv_bias->param(),
+                        conv_bias->execution_policy(), leader->config());
+            }
+        } else {
+            auto&& matmul = leader->cast_final_safe<opr::MatrixMul>();
+            fused_var = opr::MatrixMul::make(
+                    new_inp[0], new_inp[1], matmul.param(), matmul.execution_policy(),
+                    leader->config());
+        }
+        auto outs = opr::Split::make(
+                fused_var,
+                opr::Split::Options::make_partition(fused_var, 1, partition));
+        for (size_t i = 0; i < group.size(); ++i) {
+            rewriter.replace_var(
+                    group[i]->output(0), outs[i].node(),
+                    mgb_cstr_log("fuse sibling oprs sharing an input"));
+        }
+    };
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        auto iter = groups.find(opr);
+        if (iter != groups.end()) {
+            fuse(iter->second);
+        } else if (!fused.count(opr)) {
+            rewriter.auto_replace_outputs(opr);
+        }
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ ConvertToBlockSparsePass ================ */
+namespace {
+//! host value of a var produced by SharedDeviceTensor or ImmutableTensor
+bool get_const_value(VarNode* var, HostTensorND& value) {
+    auto opr = var->owner_opr();
+    const DeviceTensorND* dv = nullptr;
+    if (auto sdt = try_cast_as_op<opr::SharedDeviceTensor>(opr)) {
+        dv = &sdt->get_dev_tensor();
+    } else if (auto imm = try_cast_as_op<opr::ImmutableTensor>(opr)) {
+        dv = &imm->host_value();
+    } else {
+        return false;
+    }
+    value.copy_from(*dv).sync();
+    return true;
+}
+
+//! BSR form of a dense float32 matrix
+struct BlockSparseMatrix {
+    HostTensorND values, col_idx, row_ptr;
+};
+
+/*!
+ * \brief convert the (rows, cols) matrix whose element (r, c) is
+ *      mat[r * rstride + c * cstride] into BSR
+ *
+ * \return false if the fraction of the all-zero blocks is less than
+ *      min_sparsity or there is no non-zero block at all
+ */
+bool to_block_sparse(
+        const float* mat, size_t rows, size_t cols, size_t rstride, size_t cstride,
+        size_t bh, size_t bw, float min_sparsity, CompNode cn,
+        BlockSparseMatrix& dest) {
+    size_t nr_rb = rows / bh, nr_cb = cols / bw;
+    auto elem = [&](size_t r, size_t c) { return mat[r * rstride + c * cstride]; };
+    auto is_zero_block = [&](size_t rb, size_t cb) {
+        for (size_t i = 0; i < bh; ++i) {
+            for (size_t j = 0; j < bw; ++j) {
+                if (elem(rb * bh + i, cb * bw + j) != 0.f)
+                    return false;
+            }
+        }
+        return true;
+    };
+    std::vector<int> cols_of_blocks, row_ptr{0};
+    for (size_t rb = 0; rb < nr_rb; ++rb) {
+        for (size_t cb = 0; cb < nr_cb; ++cb) {
+            if (!is_zero_block(rb, cb))
+                cols_of_blocks.push_back(cb);
+        }
+        row_ptr.push_back(cols_of_blocks.size());
+    }
+    size_t nnz = cols_of_blocks.size();
+    if (!nnz || 1.f - static_cast<float>(nnz) / (nr_rb * nr_cb) < min_sparsity)
+        return false;
+
+    dest.values = {cn, {nnz, bh, bw}, dtype::Float32()};
+    dest.col_idx = {cn, {nnz}, dtype::Int32()};
+    dest.row_ptr = {cn, {nr_rb + 1}, dtype::Int32()};
+    auto values = dest.values.ptr<float>();
+    for (size_t rb = 0, blk = 0; rb < nr_rb; ++rb) {
+        for (; blk < static_cast<size_t>(row_ptr[rb + 1]); ++blk) {
+            size_t cb = cols_of_blocks[blk];
+            for (size_t i = 0; i < bh; ++i) {
+                for (size_t j = 0; j < bw; ++j) {
+                    *(values++) = elem(rb * bh + i, cb * bw + j);
+                }
+            }
+        }
+    }
+    std::copy(
+            cols_of_blocks.begin(), cols_of_blocks.end(), dest.col_idx.ptr<int>());
+    std::copy(row_ptr.begin(), row_ptr.end(), dest.row_ptr.ptr<int>());
+    return true;
+}
+}  // anonymous namespace
+
+ConvertToBlockSparsePass::ConvertToBlockSparsePass(
+        size_t block_h, size_t block_w, float min_sparsity)
+        : m_block_h{block_h}, m_block_w{block_w}, m_min_sparsity{min_sparsity} {
+    mgb_assert(block_h && block_w);
+}
+
+const char* ConvertToBlockSparsePass::name() const {
+    return mgb_cstr_log("convert_to_block_sparse");
+}
+
+void ConvertToBlockSparsePass::apply(OptState& state) const {
+    MIDOUT_B("ConvertToBlockSparsePass::apply")
+    using Mode = opr::BlockSparseMatrixMul::Param::Mode;
+    using NonlineMode = opr::ConvBias::Param::NonlineMode;
+    size_t bh = m_block_h, bw = m_block_w;
+    auto rewriter = state.graph().make_rewriter();
+
+    auto make_sparse = [&](VarNode* weight, const BlockSparseMatrix& mat,
+                           Mode mode, SymbolVar src) {
+        auto&& graph = *weight->owner_graph();
+        auto name = weight->name();
+        auto values = opr::SharedDeviceTensor::make_const(
+                graph, mat.values, {name + ":bsr_values"});
+        auto col_idx = opr::SharedDeviceTensor::make_const(
+                graph, mat.col_idx, {name + ":bsr_col_idx"});
+        auto row_ptr = opr::SharedDeviceTensor::make_const(
+                graph, mat.row_ptr, {name + ":bsr_row_ptr"});
+        opr::BlockSparseMatrixMul::Param param{
+                mode, static_cast<uint32_t>(bh), static_cast<uint32_t>(bw)};
+        return opr::BlockSparseMatrixMul::make(values, col_idx, row_ptr, src, param);
+    };
+
+    //! y = x * w, where x * w^T is computed as DENSE_SPARSE_T
+    auto try_matmul = [&](opr::MatrixMul* matmul, SymbolVar x) -> SymbolVar {
+        auto&& param = matmul->param();
+        using Param = opr::MatrixMul::Param;
+        VarNode* w = matmul->input(1);
+        HostTensorND wv;
+        if (param.format != Param::Format::DEFAULT ||
+            param.compute_mode != Param::ComputeMode::DEFAULT || param.transposeA ||
+            matmul->output(0)->dtype() != dtype::Float32() ||
+            x.dtype() != dtype::Float32() || w->dtype() != dtype::Float32() ||
+            !get_const_value(w, wv))
+            return {};
+        // the sparse matrix is w^T of (N, K)
+        size_t K = wv.shape(param.transposeB ? 1 : 0),
+               N = wv.shape(param.transposeB ? 0 : 1);
+        if (N % bh || K % bw)
+            return {};
+        BlockSparseMatrix mat;
+        size_t rstride = param.transposeB ? K : 1, cstride = param.transposeB ? 1 : N;
+        if (!to_block_sparse(
+                    wv.ptr<float>(), N, K, rstride, cstride, bh, bw, m_min_sparsity,
+                    w->comp_node(), mat))
+            return {};
+        return make_sparse(w, mat, Mode::DENSE_SPARSE_T, x);
+    };
+
+    //! 1x1 conv as A * x[n] in SPARSE_DENSE mode, followed by bias and
+    //! nonlinearity
+    auto try_conv_bias = [&](opr::ConvBias* conv, SymbolVar x) -> SymbolVar {
+        auto&& param = conv->param();
+        using Param = opr::ConvBias::Param;
+        VarNode* w = conv->input(1);
+        HostTensorND wv;
+        bool ok = param.format == Param::Format::NCHW &&
+                  param.sparse == Param::Sparse::DENSE &&
+                  param.mode == Param::Mode::CROSS_CORRELATION &&
+                  param.compute_mode == Param::ComputeMode::DEFAULT &&
+                  !param.pad_h && !param.pad_w && param.stride_h == 1 &&
+                  param.stride_w == 1 && conv->input().size() <= 3 &&
+                  conv->output(0)->dtype() == dtype::Float32() &&
+                  x.dtype() == dtype::Float32() && w->dtype() == dtype::Float32() &&
+                  w->shape().ndim == 4 && w->shape()[2] == 1 && w->shape()[3] == 1;
+        if (!ok ||
+            (param.nonlineMode != NonlineMode::IDENTITY &&
+             param.nonlineMode != NonlineMode::RELU &&
+             param.nonlineMode != NonlineMode::SIGMOID &&
+             param.nonlineMode != NonlineMode::H_SWISH) ||
+            !get_const_value(w, wv))
+            return {};
+        size_t OC = wv.shape(0), IC = wv.shape(1);
+        if (OC % bh || IC % bw)
+            return {};
+        BlockSparseMatrix mat;
+        if (!to_block_sparse(
+                    wv.ptr<float>(), OC, IC, IC, 1, bh, bw, m_min_sparsity,
+                    w->comp_node(), mat))
+            return {};
+        auto shp = [&](int axis) { return opr::GetVarShape::make(x, axis); };
+        auto ic = x.make_scalar(static_cast<int>(IC)),
+             oc = x.make_scalar(static_cast<int>(OC));
+        auto src = x.reshape(opr::Concat::make({shp(0), ic, shp(2) * shp(3)}, 0));
+        auto y = make_sparse(w, mat, Mode::SPARSE_DENSE, src)
+                         .reshape(opr::Concat::make({shp(0), oc, shp(2), shp(3)}, 0));
+        if (conv->input().size() == 3) {
+            y = y + rewriter.get_var(conv->input(2));
+        }
+        using EMode = opr::Elemwise::Mode;
+        switch (param.nonlineMode) {
+            case NonlineMode::RELU:
+                y = opr::Elemwise::make({y}, EMode::RELU);
+                break;
+            case NonlineMode::SIGMOID:
+                y = opr::Elemwise::make({y}, EMode::SIGMOID);
+                break;
+            case NonlineMode::H_SWISH:
+                y = opr::Elemwise::make({y}, EMode::H_SWISH);
+                break;
+            default:
+                break;
+        }
+        return y;
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        SymbolVar new_var;
+        if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            new_var = try_matmul(matmul, rewriter.get_var(opr->input(0)));
+        } else if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+            new_var = try_conv_bias(conv, rewriter.get_var(opr->input(0)));
+        }
+        if (new_var.node()) {
+            rewriter.replace_var(
+                    opr->output(0), new_var.node(),
+                    mgb_cstr_log("use block sparse matmul for sparse weight"));
+        } else {
+            rewriter.auto_replace_outputs(opr);
+        }
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ ConvertToWeightQuantPass ================ */
+ConvertToWeightQuantPass::ConvertToWeightQuantPass(uint32_t bits) : m_bits{bits} {
+    mgb_assert(bits == 8 || bits == 4, "unsupported weight quant bits: %u", bits);
+}
+
+const char* ConvertToWeightQuantPass::name() const {
+    return mgb_cstr_log("convert_to_weight_quant");
+}
+
+void ConvertToWeightQuantPass::apply(OptState& state) const {
+    MIDOUT_B("ConvertToWeightQuantPass::apply")
+    using Param = opr::MatrixMul::Param;
+    uint32_t bits = m_bits;
+    int qmax = bits == 8 ? 127 : 7;
+    auto rewriter = state.graph().make_rewriter();
+
+    auto is_float = [](DType dtype) {
+        return dtype == dtype::Float32() || dtype == dtype::Float16();
+    };
+
+    //! y = x * w as x * (quantized w^T)^T
+    auto try_matmul = [&](opr::MatrixMul* matmul, SymbolVar x) -> SymbolVar {
+        auto&& param = matmul->param();
+        VarNode* w = matmul->input(1);
+        HostTensorND wv;
+        if (param.format != Param::Format::DEFAULT || param.transposeA ||
+            !is_float(x.dtype()) || matmul->output(0)->dtype() != x.dtype() ||
+            !is_float(w->dtype()) || !get_const_value(w, wv))
+            return {};
+        size_t K = wv.shape(param.transposeB ? 1 : 0),
+               N = wv.shape(param.transposeB ? 0 : 1),
+               row_bytes = bits == 8 ? K : (K + 1) / 2;
+        auto elem = [&](size_t n, size_t k) -> float {
+            size_t idx = param.transposeB ? n * K + k : k * N + n;
+            if (wv.dtype() == dtype::Float16())
+                return wv.ptr<dt_float16>()[idx];
+            return wv.ptr<float>()[idx];
+        };
+        auto cn = w->comp_node();
+        HostTensorND qweight{cn, {N, row_bytes}, dtype::Int8()},
+                scale{cn, {N}, dtype::Float32()};
+        auto qptr = qweight.ptr<dt_int8>();
+        auto sptr = scale.ptr<float>();
+        memset(qptr, 0, N * row_bytes);
+        for (size_t n = 0; n < N; ++n) {
+            float amax = 0.f;
+            for (size_t k = 0; k < K; ++k) {
+                amax = std::max(amax, std::abs(elem(n, k)));
+            }
+            float s = amax > 0.f ? amax / qmax : 1.f;
+            sptr[n] = s;
+            dt_int8* row = qptr + n * row_bytes;
+            for (size_t k = 0; k < K; ++k) {
+                int q = static_cast<int>(std::round(elem(n, k) / s));
+                q = std::min(std::max(q, -qmax), qmax);
+                if (bits == 8) {
+                    row[k] = q;
+                } else {
+                    // the even k is in the lower half of a byte
+                    row[k / 2] |= (q & 0xf) << (k % 2 * 4);
+                }
+            }
+        }
+        auto&& graph = *w->owner_graph();
+        auto name = w->name();
+        auto qw = opr::SharedDeviceTensor::make_const(
+                graph, qweight, {name + ":quant_weight"});
+        auto qs = opr::SharedDeviceTensor::make_const(
+                graph, scale, {name + ":quant_scale"});
+        return opr::WeightQuantMatrixMul::make(
+                x, qw, qs, opr::WeightQuantMatrixMul::Param{bits});
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        SymbolVar new_var;
+        if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            new_var = try_matmul(matmul, rewriter.get_var(opr->input(0)));
+        }
+        if (new_var.node()) {
+            rewriter.replace_var(
+                    opr->output(0), new_var.node(),
+                    mgb_cstr_log("use weight quantized matmul for const weight"));
+        } else {
+            rewriter.auto_replace_outputs(opr);
+        }
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ SpatialTilingPass ================ */
+namespace {
+//! the sliding window of an opr on one of the H and W axes
+struct SpatialWindow {
+    size_t kernel = 1, stride = 1, pad = 0, dilate = 1;
+
+    size_t extent() const { return (kernel - 1) * dilate + 1; }
+};
+
+//! an opr of a chain to be computed tile by tile
+struct TileLayer {
+    OperatorNodeBase* opr = nullptr;
+    //! the input computed by the previous layer, or the input of the chain
+    size_t spatial_input = 0;
+    SpatialWindow win[2];
+    //! the value of the explicit paddings
+    float pad_value = 0.f;
+};
+
+//! the output range of a layer for a tile on one axis, and the paddings of
+//! its input
+struct TileRange {
+    size_t begin, end, pad_lo, pad_hi;
+};
+
+template <typename Param>
+bool get_conv_window(const Param& param, VarNode* filter, TileLayer& layer) {
+    auto&& fshp = filter->shape();
+    if (param.format != Param::Format::NCHW || fshp.ndim < 4)
+        return false;
+    layer.win[0] = {fshp[fshp.ndim - 2], param.stride_h, param.pad_h, param.dilate_h};
+    layer.win[1] = {fshp[fshp.ndim - 1], param.stride_w, param.pad_w, param.dilate_w};
+    return true;
+}
+
+bool get_tile_layer(OperatorNodeBase* opr, TileLayer& layer) {
+    layer = {};
+    layer.opr = opr;
+    auto&& oshp = opr->output(0)->shape();
+    auto is_nchw_float = [](VarNode* var) {
+        return var->shape().ndim == 4 &&
+               var->dtype().category() == DTypeCategory::FLOAT;
+    };
+    if (!is_nchw_float(opr->output(0)) || !is_nchw_float(opr->input(0)))
+        return false;
+    if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+        if (opr->input().size() > 3 ||
+            !get_conv_window(conv->param(), opr->input(1), layer))
+            return false;
+        if (opr->input().size() == 3) {
+            auto&& bshp = opr->input(2)->shape();
+            if (bshp.ndim != 4 || bshp[2] != 1 || bshp[3] != 1)
+                return false;
+        }
+    } else if (auto conv = try_cast_as_op<opr::Convolution>(opr)) {
+        if (!get_conv_window(conv->param(), opr->input(1), layer))
+            return false;
+    } else if (auto pool = try_cast_as_op<opr::Pooling>(opr)) {
+        using Param = opr::Pooling::Param;
+        auto&& param = pool->param();
+        // AVERAGE counts the paddings, so they can be applied as zeros
+        if (param.format != Param::Format::NCHW ||
+            (param.mode != Param::Mode::MAX && param.mode != Param::Mode::AVERAGE))
+            return false;
+        layer.win[0] = {param.window_h, param.stride_h, param.pad_h, 1};
+        layer.win[1] = {param.window_w, param.stride_w, param.pad_w, 1};
+        if (param.mode == Param::Mode::MAX)
+            layer.pad_value = std::numeric_limits<float>::lowest();
+    } else if (opr->same_type<opr::Elemwise>()) {
+        // the other inputs are either per-channel or sliced like the output
+        for (auto inp : opr->input()) {
+            auto&& ishp = inp->shape();
+            if (!ishp.eq_shape(oshp) &&
+                (ishp.ndim != 4 || ishp[2] != 1 || ishp[3] != 1))
+                return false;
+        }
+        if (!opr->input(0)->shape().eq_shape(oshp))
+            return false;
+    } else {
+        return false;
+    }
+    for (auto&& w : layer.win) {
+        // each output must be computed from at least one input
+        if (!w.kernel || !w.stride || w.pad >= w.extent())
+            return false;
+    }
+    return true;
+}
+
+//! slice the [begin, end) region on H and W of an NCHW var
+SymbolVar slice_hw(SymbolVar x, const size_t* begin, const size_t* end) {
+    using AIdx = opr::Subtensor::AxisIndexer;
+    auto cv = [&x](size_t v) { return x.make_scalar(static_cast<int>(v)); };
+    opr::Subtensor::IndexDesc desc;
+    for (size_t axis = 0; axis < 2; ++axis) {
+        if (begin[axis] || end[axis] != x.shape()[axis + 2]) {
+            desc.push_back(AIdx::make_interval(
+                    axis + 2, cv(begin[axis]), cv(end[axis]), None));
+        }
+    }
+    return desc.empty() ? x : opr::Subtensor::make(x, desc);
+}
+
+//! pad H and W of an NCHW var with value
+SymbolVar pad_hw(
+        SymbolVar x, const size_t* pad_lo, const size_t* pad_hi, float value) {
+    for (size_t axis = 0; axis < 2; ++axis) {
+        if (!pad_lo[axis] && !pad_hi[axis])
+            continue;
+        SymbolVarArray parts;
+        auto fill = [&](size_t len) {
+            auto shp = x.shape();
+            shp[axis + 2] = len;
+            parts.push_back(x.make_scalar_dt(value).broadcast(shp));
+        };
+        if (pad_lo[axis])
+            fill(pad_lo[axis]);
+        parts.push_back(x);
+        if (pad_hi[axis])
+            fill(pad_hi[axis]);
+        x = opr::Concat::make(parts, axis + 2);
+    }
+    return x;
+}
+}  // anonymous namespace
+
+SpatialTilingPass::SpatialTilingPass(size_t tile_h, size_t tile_w)
+        : m_tile_h{tile_h}, m_tile_w{tile_w} {
+    mgb_assert(tile_h && tile_w);
+}
+
+const char* SpatialTilingPass::name() const {
+    return mgb_cstr_log("spatial_tiling");
+}
+
+void SpatialTilingPass::apply(OptState& state) const {
+    MIDOUT_B("SpatialTilingPass::apply")
+    // the endpoints are read by the caller
+    ThinHashMap<VarNode*, size_t> nr_reader;
+    for (auto&& i : state.graph().endpoint_vars()) {
+        ++nr_reader[i.node()];
+    }
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        for (auto inp : opr->input()) {
+            ++nr_reader[inp];
+        }
+    });
+
+    //! the layers linked to their previous layers, whose outputs have no
+    //! other readers
+    ThinHashMap<OperatorNodeBase*, TileLayer> layers;
+    ThinHashMap<OperatorNodeBase*, OperatorNodeBase*> prev;
+    ThinHashSet<OperatorNodeBase*> has_next;
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        TileLayer layer;
+        if (!get_tile_layer(opr, layer))
+            return;
+        bool is_elem = opr->same_type<opr::Elemwise>();
+        for (size_t i = 0; i < (is_elem ? opr->input().size() : 1); ++i) {
+            VarNode* inp = opr->input(i);
+            auto owner = inp->owner_opr();
+            if (inp->shape().eq_shape(opr->output(0)->shape()) || !is_elem) {
+                if (layers.count(owner) && owner->output(0) == inp &&
+                    nr_reader.at(inp) == 1) {
+                    layer.spatial_input = i;
+                    prev[opr] = owner;
+                    has_next.insert(owner);
+                    break;
+                }
+            }
+        }
+        layers[opr] = layer;
+    });
+
+    //! the chains of at least two layers keyed by their last layers, whose
+    //! outputs are larger than a tile
+    ThinHashMap<OperatorNodeBase*, std::vector<const TileLayer*>> chains;
+    ThinHashSet<OperatorNodeBase*> tiled;
+    for (auto&& i : prev) {
+        auto last = i.first;
+        auto&& oshp = last->output(0)->shape();
+        if (has_next.count(last) || (oshp[2] <= m_tile_h && oshp[3] <= m_tile_w))
+            continue;
+        std::vector<const TileLayer*> chain;
+        for (auto opr = last; opr; opr = prev.count(opr) ? prev.at(opr) : nullptr) {
+            chain.push_back(&layers.at(opr));
+            tiled.insert(opr);
+        }
+        std::reverse(chain.begin(), chain.end());
+        chains[last] = std::move(chain);
+    }
+    if (chains.empty())
+        return;
+
+    auto rewriter = state.graph().make_rewriter();
+    //! compute the [begin, end) region on H and W of the chain output
+    auto make_tile = [&rewriter](
+                             const std::vector<const TileLayer*>& chain,
+                             const size_t* begin, const size_t* end,
+                             size_t tile_idx) {
+        size_t nr_layer = chain.size();
+        std::vector<std::array<TileRange, 2>> ranges(nr_layer);
+        size_t in_begin[2], in_end[2];
+        for (size_t axis = 0; axis < 2; ++axis) {
+            ptrdiff_t b = begin[axis], e = end[axis];
+            for (size_t i = nr_layer; i--;) {
+                auto&& layer = *chain[i];
+                auto&& w = layer.win[axis];
+                ptrdiff_t size =
+                        layer.opr->input(layer.spatial_input)->shape()[axis + 2],
+                        stride = w.stride, pad = w.pad, extent = w.extent();
+                ptrdiff_t lo = b * stride - pad, hi = (e - 1) * stride - pad + extent;
+                ranges[i][axis] = {
+                        static_cast<size_t>(b), static_cast<size_t>(e),
+                        static_cast<size_t>(std::max<ptrdiff_t>(-lo, 0)),
+                        static_cast<size_t>(std::max<ptrdiff_t>(hi - size, 0))};
+                b = std::max<ptrdiff_t>(lo, 0);
+                e = std::min(hi, size);
+            }
+            in_begin[axis] = b;
+            in_end[axis] = e;
+        }
+
+        auto first = chain[0];
+        SymbolVar x = slice_hw(
+                rewriter.get_var(first->opr->input(first->spatial_input)), in_begin,
+                in_end);
+        for (size_t i = 0; i < nr_layer; ++i) {
+            auto&& layer = *chain[i];
+            auto opr = layer.opr;
+            auto&& r = ranges[i];
+            size_t pad_lo[2] = {r[0].pad_lo, r[1].pad_lo},
+                   pad_hi[2] = {r[0].pad_hi, r[1].pad_hi};
+            x = pad_hw(x, pad_lo, pad_hi, layer.pad_value);
+            OperatorNodeConfig config = opr->config();
+            config.name(ssprintf("%s:tile%zu", opr->cname(), tile_idx));
+            if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+                auto param = conv->param();
+                param.pad_h = param.pad_w = 0;
+                auto filter = rewriter.get_var(opr->input(1));
+                if (opr->input().size() == 3) {
+                    x = opr::ConvBias::make(
+                            x, filter, rewriter.get_var(opr->input(2)), param,
+                            conv->execution_policy(), config);
+                } else {
+                    x = opr::ConvBias::make(
+                            x, filter, param, conv->execution_policy(), config);
+                }
+            } else if (auto conv = try_cast_as_op<opr::Convolution>(opr)) {
+                auto param = conv->param();
+                param.pad_h = param.pad_w = 0;
+                x = opr::Convolution::make(
+                        x, rewriter.get_var(opr->input(1)), param,
+                        conv->execution_policy(), config);
+            } else if (auto pool = try_cast_as_op<opr::Pooling>(opr)) {
+                auto param = pool->param();
+                param.pad_h = param.pad_w = 0;
+                x = opr::Pooling::make(x, param, config, pool->execution_policy());
+            } else {
+                size_t out_begin[2] = {r[0].begin, r[1].begin},
+                       out_end[2] = {r[0].end, r[1].end};
+                VarNodeArray inps;
+                for (size_t j = 0; j < opr->input().size(); ++j) {
+                    VarNode* inp = opr->input(j);
+                    if (j == layer.spatial_input) {
+                        inps.push_back(x.node());
+                    } else if (inp->shape().eq_shape(opr->output(0)->shape())) {
+                        inps.push_back(
+                                slice_hw(rewriter.get_var(inp), out_begin, out_end)
+                                        .node());
+                    } else {
+                        inps.push_back(rewriter.get_var(inp));
+                    }
+                }
+                x = serialization::copy_opr_shallow(*opr, inps, config)->output(0);
+            }
+        }
+        return x;
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        auto iter = chains.find(opr);
+        if (iter == chains.end()) {
+            // the other layers of the chains have no readers out of the chains
+            if (!tiled.count(opr))
+                rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        size_t oh = opr->output(0)->shape()[2], ow = opr->output(0)->shape()[3],
+               tile_idx = 0;
+        SymbolVarArray rows;
+        for (size_t h = 0; h < oh; h += m_tile_h) {
+            SymbolVarArray cols;
+            size_t h_end = std::min(h + m_tile_h, oh);
+            for (size_t w = 0; w < ow; w += m_tile_w) {
+                size_t begin[2] = {h, w}, end[2] = {h_end, std::min(w + m_tile_w, ow)};
+                cols.push_back(make_tile(iter->second, begin, end, tile_idx++));
+            }
+            rows.push_back(cols.size() == 1 ? cols[0] : opr::Concat::make(cols, 3));
+        }
+        auto y = rows.size() == 1 ? rows[0] : opr::Concat::make(rows, 2);
+        rewriter.replace_var(
+                opr->output(0), y.node(),
+                mgb_cstr_log("compute spatial opr chain tile by tile"));
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseImagePreprocessPass ================ */
+const char* FuseImagePreprocessPass::name() const {
+    return mgb_cstr_log("fuse_image_preprocess");
+}
+
+void FuseImagePreprocessPass::apply(OptState& state) const {
+    MIDOUT_B("FuseImagePreprocessPass::apply")
+    using Param = opr::ImagePreprocess::Param;
+    using Mode = Param::Mode;
+    using CvtMode = opr::CvtColor::Param::Mode;
+    using ElemMode = opr::Elemwise::Mode;
+    auto rewriter = state.graph().make_rewriter();
+
+    //! the ops applied to a uint8 image so far
+    struct Chain {
+        VarNode* src;
+        Mode mode;
+        bool is_float = false, nchw = false;
+        //! the out shape of the Resize, or nullptr before the Resize
+        VarNode* out_shape = nullptr;
+        Param::InterpolationMode imode;
+        float scale[3] = {1.f, 1.f, 1.f}, bias[3] = {0.f, 0.f, 0.f};
+    };
+    ThinHashMap<VarNode*, Chain> chains;
+
+    //! value of a scalar or per-channel constant of a chain
+    auto get_channel_const = [](VarNode* var, bool nchw, float* value) {
+        HostTensorND hv;
+        if (var->dtype() != dtype::Float32() || !get_const_value(var, hv))
+            return false;
+        auto&& shp = hv.shape();
+        if (shp.ndim > 4)
+            return false;
+        size_t channel_axis = nchw ? 1 : 3, nr = 1;
+        for (size_t i = 0; i < shp.ndim; ++i) {
+            if (shp[i] == 1)
+                continue;
+            if (4 - shp.ndim + i != channel_axis || shp[i] != 3)
+                return false;
+            nr = 3;
+        }
+        auto ptr = hv.ptr<float>();
+        for (int c = 0; c < 3; ++c) {
+            value[c] = ptr[nr == 3 ? c : 0];
+        }
+        return true;
+    };
+
+    //! the chain of the output of opr, or false if opr does not extend one
+    auto try_extend = [&](OperatorNodeBase* opr, Chain& chain) -> bool {
+        auto find = [&](VarNode* var) -> const Chain* {
+            auto iter = chains.find(var);
+            return iter == chains.end() ? nullptr : &iter->second;
+        };
+        if (auto cvt = try_cast_as_op<opr::CvtColor>(opr)) {
+            static const ThinHashMap<CvtMode, Mode> modes = {
+                    {CvtMode::RGB2BGR, Mode::RGB2BGR},
+                    {CvtMode::BGR2RGB, Mode::RGB2BGR},
+                    {CvtMode::YUV2RGB_NV21, Mode::YUV2RGB_NV21},
+                    {CvtMode::YUV2BGR_NV21, Mode::YUV2BGR_NV21},
+                    {CvtMode::YUV2RGB_NV12, Mode::YUV2RGB_NV12},
+                    {CvtMode::YUV2BGR_NV12, Mode::YUV2BGR_NV12}};
+            auto iter = modes.find(cvt->param().mode);
+            if (cvt->input(0)->dtype() != dtype::Uint8() || iter == modes.end())
+                return false;
+            chain = {};
+            chain.src = cvt->input(0);
+            chain.mode = iter->second;
+            return true;
+        }
+        if (auto tc = try_cast_as_op<opr::TypeCvt>(opr)) {
+            VarNode* inp = tc->input(0);
+            if (inp->dtype() != dtype::Uint8() ||
+                tc->output(0)->dtype() != dtype::Float32())
+                return false;
+            if (auto prev = find(inp)) {
+                chain = *prev;
+            } else {
+                if (!cg::is_static_var_shape(inp) || inp->shape().ndim != 4 ||
+                    inp->shape()[3] != 3)
+                    return false;
+                chain = {};
+                chain.src = inp;
+                chain.mode = Mode::RGB;
+            }
+            chain.is_float = true;
+            return true;
+        }
+        auto prev = find(opr->input(0));
+        if (auto dimshuffle = try_cast_as_op<opr::Dimshuffle>(opr)) {
+            auto&& param = dimshuffle->param();
+            if (!prev || prev->nchw || param.pattern_len != 4 ||
+                param.pattern[0] != 0 || param.pattern[1] != 3 ||
+                param.pattern[2] != 1 || param.pattern[3] != 2)
+                return false;
+            chain = *prev;
+            chain.nchw = true;
+            return true;
+        }
+        if (auto resize = try_cast_as_op<opr::Resize>(opr)) {
+            auto&& param = resize->param();
+            auto format = prev && prev->nchw ? Param::Format::NCHW : Param::Format::NHWC;
+            if (!prev || !prev->is_float || prev->out_shape ||
+                param.format != format ||
+                (param.imode != Param::InterpolationMode::LINEAR &&
+                 param.imode != Param::InterpolationMode::NEAREST))
+                return false;
+            chain = *prev;
+            chain.out_shape = resize->input(1);
+            chain.imode = param.imode;
+            return true;
+        }
+        if (auto elem = try_cast_as_op<opr::Elemwise>(opr)) {
+            auto mode = elem->param().mode;
+            if (elem->input().size() != 2 ||
+                elem->output(0)->dtype() != dtype::Float32() ||
+                (mode != ElemMode::ADD && mode != ElemMode::SUB &&
+                 mode != ElemMode::MUL && mode != ElemMode::TRUE_DIV))
+                return false;
+            // the chain is the lhs of the op if rhs is false
+            bool rhs = false;
+            if (!prev || !prev->is_float) {
+                prev = find(elem->input(1));
+                rhs = true;
+                if (!prev || !prev->is_float || mode == ElemMode::TRUE_DIV)
+                    return false;
+            }
+            float value[3];
+            if (!get_channel_const(elem->input(rhs ? 0 : 1), prev->nchw, value))
+                return false;
+            chain = *prev;
+            for (int c = 0; c < 3; ++c) {
+                float &s = chain.scale[c], &b = chain.bias[c];
+                switch (mode) {
+                    case ElemMode::ADD:
+                        b += value[c];
+                        break;
+                    case ElemMode::SUB:
+                        if (rhs) {
+                            s = -s;
+                            b = value[c] - b;
+                        } else {
+                            b -= value[c];
+                        }
+                        break;
+                    case ElemMode::MUL:
+                        s *= value[c];
+                        b *= value[c];
+                        break;
+                    default:
+                        s /= value[c];
+                        b /= value[c];
+                        break;
+                }
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto make_fused = [&](const Chain& chain) {
+        auto cn = chain.src->comp_node();
+        HostTensorND scale{cn, {3}, dtype::Float32()}, bias{cn, {3}, dtype::Float32()};
+        for (int c = 0; c < 3; ++c) {
+            scale.ptr<float>()[c] = chain.scale[c];
+            bias.ptr<float>()[c] = chain.bias[c];
+        }
+        auto&& graph = *chain.src->owner_graph();
+        auto name = chain.src->name();
+        Param param{
+                chain.mode, chain.imode,
+                chain.nchw ? Param::Format::NCHW : Param::Format::NHWC};
+        return opr::ImagePreprocess::make(
+                rewriter.get_var(chain.src),
+                opr::SharedDeviceTensor::make_const(graph, scale, {name + ":scale"}),
+                opr::SharedDeviceTensor::make_const(graph, bias, {name + ":bias"}),
+                rewriter.get_var(chain.out_shape), param);
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        Chain chain;
+        if (try_extend(opr, chain)) {
+            VarNode* out = opr->output(0);
+            chains[out] = chain;
+            if (chain.is_float && chain.out_shape) {
+                // the fused oprs of the intermediate vars read only by the
+                // chain are not reachable from the endpoints
+                rewriter.replace_var(
+                        out, make_fused(chain).node(),
+                        mgb_cstr_log("fuse image preprocess chain"));
+                return;
+            }
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ quantize_by_calibration ================ */
+namespace {
+class QuantizeByScalesPass final : public Pass {
+    const std::unordered_map<std::string, float>& m_scales;
+
+public:
+    QuantizeByScalesPass(const std::unordered_map<std::string, float>& scales)
+            : m_scales{scales} {}
+
+    const char* name() const override { return mgb_cstr_log("quantize_by_scales"); }
+
+    void apply(OptState& state) const override;
+};
+
+void QuantizeByScalesPass::apply(OptState& state) const {
+    using Param = opr::ConvBias::Param;
+    using NonlineMode = Param::NonlineMode;
+    auto rewriter = state.graph().make_rewriter();
+
+    auto scale_of = [this](VarNode* var) {
+        auto iter = m_scales.find(var->name());
+        return iter == m_scales.end() ? 0.f : iter->second;
+    };
+
+    auto try_conv_bias = [&](opr::ConvBias* conv) -> SymbolVar {
+        auto&& param = conv->param();
+        VarNode *x = conv->input(0), *w = conv->input(1), *y = conv->output(0);
+        bool ok = param.format == Param::Format::NCHW &&
+                  param.mode == Param::Mode::CROSS_CORRELATION &&
+                  param.compute_mode == Param::ComputeMode::DEFAULT &&
+                  (param.nonlineMode == NonlineMode::IDENTITY ||
+                   param.nonlineMode == NonlineMode::RELU ||
+                   param.nonlineMode == NonlineMode::H_SWISH) &&
+                  conv->input().size() <= 3 && x->dtype() == dtype::Float32() &&
+                  w->dtype() == dtype::Float32() && y->dtype() == dtype::Float32();
+        float sx = scale_of(x), sy = scale_of(y);
+        HostTensorND wv, bv;
+        if (!ok || sx <= 0 || sy <= 0 || !get_const_value(w, wv))
+            return {};
+        bool has_bias = conv->input().size() == 3;
+        if (has_bias && (conv->input(2)->dtype() != dtype::Float32() ||
+                         !get_const_value(conv->input(2), bv)))
+            return {};
+
+        auto cn = w->comp_node();
+        size_t wsize = wv.shape().total_nr_elems();
+        auto wptr = wv.ptr<float>();
+        float wmax = 0.f;
+        for (size_t i = 0; i < wsize; ++i) {
+            wmax = std::max(wmax, std::abs(wptr[i]));
+        }
+        float sw = wmax > 0.f ? wmax / 127 : 1.f;
+        HostTensorND qw{cn, wv.shape(), dtype::QuantizedS8(sw)};
+        auto qwptr = qw.ptr<dt_qint8>();
+        for (size_t i = 0; i < wsize; ++i) {
+            int q = static_cast<int>(std::round(wptr[i] / sw));
+            qwptr[i] = dt_qint8(std::min(std::max(q, -127), 127));
+        }
+
+        auto&& graph = *w->owner_graph();
+        auto name = w->name();
+        auto qx = opr::TypeCvt::make(rewriter.get_var(x), dtype::QuantizedS8(sx));
+        auto qwv = opr::SharedDeviceTensor::make_const(graph, qw, {name + ":q"});
+        OperatorNodeConfig config;
+        config.output_dtype(dtype::QuantizedS8(sy));
+        SymbolVar qy;
+        if (has_bias) {
+            float sb = sx * sw;
+            size_t bsize = bv.shape().total_nr_elems();
+            HostTensorND qb{cn, bv.shape(), dtype::QuantizedS32(sb)};
+            auto bptr = bv.ptr<float>();
+            auto qbptr = qb.ptr<dt_qint32>();
+            for (size_t i = 0; i < bsize; ++i) {
+                qbptr[i] = dt_qint32(static_cast<int32_t>(std::round(bptr[i] / sb)));
+            }
+            auto qbv = opr::SharedDeviceTensor::make_const(
+                    graph, qb, {conv->input(2)->name() + ":q"});
+            qy = opr::ConvBias::make(
+                    qx, qwv, qbv, param, conv->execution_policy(), config);
+        } else {
+            qy = opr::ConvBias::make(qx, qwv, param, conv->execution_policy(), config);
+        }
+        return opr::TypeCvt::make(qy, dtype::Float32());
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        SymbolVar new_var;
+        if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+            new_var = try_conv_bias(conv);
+        }
+        if (new_var.node()) {
+            rewriter.replace_var(
+                    opr->output(0), new_var.node(),
+                    mgb_cstr_log("quantize conv_bias by calibrated scales"));
+        } else {
+            rewriter.auto_replace_outputs(opr);
+        }
+    });
+    rewriter.apply_inplace();
+}
+}  // anonymous namespace
+
+SymbolVarArray gopt::quantize_by_calibration(
+        const SymbolVarArray& dest_vars,
+        const std::unordered_map<std::string, float>& scales) {
+    return GraphOptimizer{}
+            .add_pass(std::make_unique<QuantizeByScalesPass>(scales))
+            .add_pass<RemoveRedundantTypeCvtPass>()
+            .apply({dest_vars})
+            .endpoint_vars();
+}
+
+/* ================ FuseSigmoidMulPass ================ */
+const char* FuseSigmoidMulPass::name() const {
+    return mgb_cstr_log("fuse_sigmoid_mul");
+}
+
+void FuseSigmoidMulPass::apply(OptState& state) const {
+    MIDOUT_B("FuseSigmoidMulPass::apply")
+    using Mode = opr::Elemwise::Mode;
+
+    ThinHashMap<OperatorNodeBase*, size_t> topo_idx;
+    ThinHashMap<VarNode*, std::vector<OperatorNodeBase*>> readers;
+    size_t nr_opr = 0;
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        topo_idx[opr] = nr_opr++;
+        for (auto inp : opr->input()) {
+            readers[inp].push_back(opr);
+        }
+    });
+
+    auto as_elem = [](OperatorNodeBase* opr, Mode mode) -> opr::Elemwise* {
+        auto elem = try_cast_as_op<opr::Elemwise>(opr);
+        if (elem && elem->param().mode == mode) {
+            return elem;
+        }
+        return nullptr;
+    };
+
+    //! output of the fused opr that replaces the output of a mul opr
+    ThinHashMap<OperatorNodeBase*, VarNode*> mul_replace;
+    auto rewriter = state.graph().make_rewriter();
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        auto iter = mul_replace.find(opr);
+        if (iter != mul_replace.end()) {
+            rewriter.replace_var(
+                    opr->output(0), iter->second,
+                    mgb_cstr_log("replace sigmoid(x) * y -> "
+                                 "elemwise_multi_output(x, y)[1]"));
+            return;
+        }
+        auto sigmoid = as_elem(opr, Mode::SIGMOID);
+        VarNode* s = opr->output(0);
+        if (!sigmoid || s->dtype().category() != DTypeCategory::FLOAT ||
+            readers[s].size() < 2) {
+            rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        for (auto reader : readers[s]) {
+            auto mul = as_elem(reader, Mode::MUL);
+            if (!mul || mul->input().size() != 2 ||
+                mul->input(0) == mul->input(1) ||
+                !mul->output(0)->shape().eq_shape(s->shape())) {
+                continue;
+            }
+            VarNode* y = mul->input(mul->input(0) == s);
+            // y must not depend on s, or the fused opr would depend on itself
+            if (y->dtype() != s->dtype() ||
+                topo_idx.at(y->owner_opr()) > topo_idx.at(opr)) {
+                continue;
+            }
+            auto out = opr::ElemwiseMultiOutput::make(
+                    {rewriter.get_var(opr->input(0)), rewriter.get_var(y)},
+                    {opr::ElemwiseMultiOutput::Mode::SIGMOID_MUL}, opr->config());
+            rewriter.replace_var(
+                    s, out[0].node(),
+                    mgb_cstr_log("replace sigmoid(x) -> "
+                                 "elemwise_multi_output(x, y)[0]"));
+            mul_replace[mul] = out[1].node();
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
 /* ================ ParamMergePass ================ */
 const char* ParamMergePass::name() const {
     return mgb_cstr_log("param_merge");
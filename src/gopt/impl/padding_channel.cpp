@@ -44,11 +44,146 @@ using namespace mgb;
 using namespace gopt;
 using ReformatKey = ReformatManager::ReformatKey;
 
+namespace {
+using ReplaceFunc =
+        thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>;
+using ExtractFunc = thin_function<VarNode*(VarNode*, const TensorShape&)>;
+
+bool is_nchwxx_padding_dtype(DType dtype) {
+    return dtype.enumv() == DTypeEnum::Float32 ||
+           dtype.enumv() == DTypeEnum::QuantizedS8;
+}
+
+//! pad zeros after the var along the axis, which are folded by ParamFusePass
+//! for the weights
+VarNode* pad_zeros(VarNode* inp, size_t axis, size_t pad_channels) {
+    TensorShape shape = inp->shape();
+    mgb_assert(axis < shape.ndim);
+    shape[axis] = pad_channels;
+    std::shared_ptr<HostTensorND> host_val =
+            std::make_shared<HostTensorND>(inp->comp_node(), inp->dtype());
+    host_val->resize(shape);
+    std::memset(host_val->raw_ptr(), 0, host_val->layout().span().dist_byte());
+    auto padding = opr::ImmutableTensor::make(*inp->owner_graph(), *host_val);
+    return opr::Concat::make({inp, padding}, axis).node();
+}
+
+/*!
+ * \brief replace the oprs for the CPU padding policy, which pads the channels
+ * of the float32 and qint8 dense and channel wise ConvBias to multiple of
+ * pack_c_size
+ *
+ * The padded channels of the inputs of a conv are multiplied by zero weights,
+ * so the padded channels of an activation are only required to be finite.
+ * The input channels less than pack_c_size, such as the 3 channels of the
+ * image, are not padded as the hybrid NCHW-NCHWxx algos read them directly.
+ */
+void apply_nchwxx_policy(
+        size_t pack_c_size, ThinHashSet<OperatorNodeBase*>& padding_oprs,
+        ThinHashMap<Typeinfo*, ReplaceFunc>& opr_replace_funcs,
+        const ExtractFunc& extract_subtensor) {
+    auto round_up = [pack_c_size](size_t channels) {
+        return (channels + pack_c_size - 1) / pack_c_size * pack_c_size;
+    };
+    opr_replace_funcs[opr::ConvBiasForward::typeinfo()] =
+            [&padding_oprs, extract_subtensor, pack_c_size, round_up](
+                    OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+                using Param = opr::ConvBiasForward::Param;
+                mgb_assert(opr->input().size() == new_inp.size());
+                auto&& param = opr->cast_final_safe<opr::ConvBiasForward>().param();
+                auto inps = new_inp;
+                auto filter_shape = opr->input(1)->shape();
+                bool padded_inp = padding_oprs.count(opr->input(0)->owner_opr());
+                bool usable = is_nchwxx_padding_dtype(opr->input(0)->dtype()) &&
+                              param.format == Param::Format::NCHW &&
+                              new_inp.size() <= 3;
+                bool dense = param.sparse == Param::Sparse::DENSE;
+                bool channel_wise = param.sparse == Param::Sparse::GROUP &&
+                                    filter_shape[1] == 1 && filter_shape[2] == 1;
+                if (!usable || !(dense || channel_wise)) {
+                    if (padded_inp) {
+                        inps[0] = extract_subtensor(inps[0], opr->input(0)->shape());
+                    }
+                    return serialization::copy_opr_shallow(
+                            *opr, inps, opr->config());
+                }
+                size_t in_channels = opr->input(0)->shape()[1];
+                size_t new_in_channels = new_inp[0]->shape()[1];
+                if (!padded_inp && in_channels % pack_c_size &&
+                    (in_channels > pack_c_size || channel_wise)) {
+                    new_in_channels = round_up(in_channels);
+                    inps[0] = pad_zeros(inps[0], 1, new_in_channels - in_channels);
+                }
+                size_t out_channels, new_out_channels;
+                if (dense) {
+                    if (new_in_channels != in_channels) {
+                        inps[1] = pad_zeros(
+                                inps[1], 1, new_in_channels - in_channels);
+                    }
+                    out_channels = filter_shape[0];
+                    new_out_channels = round_up(out_channels);
+                    if (new_out_channels != out_channels) {
+                        inps[1] = pad_zeros(
+                                inps[1], 0, new_out_channels - out_channels);
+                    }
+                } else {
+                    //! the groups of a channel wise conv follow the channels
+                    out_channels = filter_shape[0];
+                    new_out_channels = new_in_channels;
+                    if (new_out_channels != out_channels) {
+                        inps[1] = pad_zeros(
+                                inps[1], 0, new_out_channels - out_channels);
+                    }
+                }
+                if (new_out_channels != out_channels) {
+                    if (inps.size() == 3) {
+                        inps[2] = pad_zeros(
+                                inps[2], 1, new_out_channels - out_channels);
+                    }
+                    padding_oprs.insert(opr);
+                }
+                return serialization::copy_opr_shallow(*opr, inps, opr->config());
+            };
+
+    auto replace_format_aware_opr = [&padding_oprs, extract_subtensor](
+                                            OperatorNodeBase* opr,
+                                            const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        if (!padding_oprs.count(opr->input(0)->owner_opr())) {
+            return serialization::copy_opr_shallow(*opr, new_inp, opr->config());
+        }
+        if (!is_nchwxx_padding_dtype(opr->input(0)->dtype())) {
+            auto inps = new_inp;
+            inps[0] = extract_subtensor(inps[0], opr->input(0)->shape());
+            return serialization::copy_opr_shallow(*opr, inps, opr->config());
+        }
+        padding_oprs.insert(opr);
+        return serialization::copy_opr_shallow(*opr, new_inp, opr->config());
+    };
+    opr_replace_funcs[opr::PoolingForward::typeinfo()] = replace_format_aware_opr;
+    opr_replace_funcs[opr::WarpPerspectiveForward::typeinfo()] =
+            replace_format_aware_opr;
+    //! the deconvs are not padded on CPU, see the unknown oprs in apply()
+    opr_replace_funcs.erase(opr::ConvolutionBackwardData::typeinfo());
+}
+}  // namespace
+
 /* ==================== PaddingChannelPass ================= */
 const char* PaddingChannelPass::name() const {
     return mgb_cstr_log("padding output channel to multiple of 4/32");
 }
 
+std::unique_ptr<PaddingChannelPass> PaddingChannelPass::make_nchwxx_padding(
+        size_t pack_c_size) {
+    mgb_assert(
+            pack_c_size == 4 || pack_c_size == 8,
+            "only support padding channels for nchw44 and nchw88, got %zu",
+            pack_c_size);
+    auto ret = std::make_unique<PaddingChannelPass>();
+    ret->m_pack_c_size = pack_c_size;
+    return ret;
+}
+
 void PaddingChannelPass::apply(OptState& opt) const {
     MIDOUT_B("PaddingChannelPass::apply");
     // do not check shape
@@ -397,16 +532,35 @@ void PaddingChannelPass::apply(OptState& opt) const {
     opr_replace_funcs[opr::Reduce::typeinfo()] = replace_nonpadding_oprs;
     opr_replace_funcs[opr::Subtensor::typeinfo()] = replace_nonpadding_oprs;
 
-    auto on_opr = [&opt, &rewriter, &opr_replace_funcs,
-                   &extract_subtensor](OperatorNodeBase* opr) {
+    if (m_pack_c_size) {
+        apply_nchwxx_policy(
+                m_pack_c_size, padding_oprs, opr_replace_funcs, extract_subtensor);
+    }
+
+    auto on_opr = [&opt, &rewriter, &opr_replace_funcs, &padding_oprs,
+                   &replace_nonpadding_oprs, &extract_subtensor,
+                   this](OperatorNodeBase* opr) {
         auto it = opr_replace_funcs.find(opr->dyn_typeinfo());
+        ReplaceFunc replace_func;
         if (it != opr_replace_funcs.end()) {
+            replace_func = it->second;
+        } else if (m_pack_c_size) {
+            //! the oprs unknown to the CPU policy may mix the channels, so the
+            //! padded inputs are sliced back
+            for (auto&& inp : opr->input()) {
+                if (padding_oprs.count(inp->owner_opr())) {
+                    replace_func = replace_nonpadding_oprs;
+                    break;
+                }
+            }
+        }
+        if (replace_func) {
             VarNodeArray new_inp;
             new_inp.reserve(opr->input().size());
             for (auto&& inp : opr->input()) {
                 new_inp.push_back(rewriter.get_var(inp));
             }
-            auto new_opr = (it->second)(opr, new_inp);
+            auto new_opr = replace_func(opr, new_inp);
             auto &&out0 = opr->output(), &&out1 = new_opr->output();
             mgb_assert(
                     out0.size() == out1.size(),
@@ -136,14 +136,20 @@ void TensorReformatPass::insert_pass(OptState& opt) const {
     VarNodeArray new_inp_cache;
     auto on_opr = [this, &opt, &rewriter, &new_inp_cache](OperatorNodeBase* opr) {
         auto it = m_opr_replace_func.find(opr->dyn_typeinfo());
-        if (it != m_opr_replace_func.end()) {
+        if (it != m_opr_replace_func.end() || m_default_replace_func) {
             auto& new_inp = new_inp_cache;
             new_inp.clear();
             new_inp.reserve(opr->input().size());
             for (auto&& inp : opr->input()) {
                 new_inp.push_back(rewriter.get_var(inp));
             }
-            auto new_opr = (it->second)(opr, new_inp);
+            auto new_opr = it != m_opr_replace_func.end()
+                                 ? (it->second)(opr, new_inp)
+                                 : m_default_replace_func(opr, new_inp);
+            if (!new_opr) {
+                rewriter.auto_replace_outputs(opr);
+                return;
+            }
             auto &&out0 = opr->output(), &&out1 = new_opr->output();
             mgb_assert(
                     out0.size() == out1.size(),
@@ -3108,4 +3114,212 @@ std::unique_ptr<EnableNCHW64Pass> EnableNCHW64Pass::make_nchw64_converter() {
     MIDOUT_E
 }
 
+/* ================ EnableNHWCPass =============== */
+VarNode* EnableNHWCPass::on_graph_endpoint_var(
+        VarNode* new_var, VarNode* /* orig_var */) const {
+    if (m_nhwc_vars.count(new_var)) {
+        return RelayoutPlaceholder::make(
+                       new_var,
+                       ReformatKey{
+                               TensorFormats::NHWC, TensorFormats::NCHW,
+                               new_var->dtype().enumv(), new_var->dtype().enumv()})
+                .node();
+    }
+    return new_var;
+}
+
+std::unique_ptr<EnableNHWCPass> EnableNHWCPass::make_nhwc_converter() {
+    MIDOUT_B("EnableNHWCPass::make")
+    auto ret = std::make_unique<EnableNHWCPass>();
+    ret->set_var_replace_check_flag(VarReplaceCheckFlag::NOCHECK);
+    auto&& replace_func = ret->m_opr_replace_func;
+    auto&& nhwc_vars = ret->m_nhwc_vars;
+    // the permutation from KCRS to KRSC of the dense filters is the same as
+    // the one from NCHW to NHWC, so filters are tracked as activations
+    auto to_nhwc = [&nhwc_vars](VarNode* var) -> VarNode* {
+        if (nhwc_vars.count(var) || var->shape().ndim != 4) {
+            return var;
+        }
+        ReformatKey key{
+                TensorFormats::NCHW, TensorFormats::NHWC, var->dtype().enumv(),
+                var->dtype().enumv()};
+        return RelayoutPlaceholder::make(var, key).node();
+    };
+    auto to_nchw = [&nhwc_vars](VarNode* var) -> VarNode* {
+        if (!nhwc_vars.count(var)) {
+            return var;
+        }
+        ReformatKey key{
+                TensorFormats::NHWC, TensorFormats::NCHW, var->dtype().enumv(),
+                var->dtype().enumv()};
+        return RelayoutPlaceholder::make(var, key).node();
+    };
+    // cuDNN picks its NHWC tensorcore kernels only for the dense float16
+    // convs whose channels are multiples of 8, the other convs (such as the
+    // first conv of the networks) are kept in NCHW
+    auto nhwc_usable = [](const auto& param, VarNode* data, VarNode* filter) {
+        using Param = megdnn::param::Convolution;
+        auto&& shp = filter->shape();
+        return param.format == Param::Format::NCHW &&
+               param.sparse == Param::Sparse::DENSE &&
+               data->dtype().enumv() == DTypeEnum::Float16 &&
+               filter->dtype().enumv() == DTypeEnum::Float16 && shp.ndim == 4 &&
+               shp[0] % 8 == 0 && shp[1] % 8 == 0;
+    };
+    auto replace_inps_to_nchw = [to_nchw](
+                                        OperatorNodeBase* opr,
+                                        const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        VarNodeArray inps = new_inp;
+        for (auto&& inp : inps) {
+            inp = to_nchw(inp);
+        }
+        return serialization::copy_opr_shallow(*opr, inps, opr->config());
+    };
+    auto replace_conv_opr = [&nhwc_vars, to_nhwc, nhwc_usable, replace_inps_to_nchw](
+                                    OperatorNodeBase* opr,
+                                    const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        auto& conv = opr->cast_final_safe<opr::ConvolutionForward>();
+        if (!nhwc_usable(conv.param(), opr->input(0), opr->input(1))) {
+            return replace_inps_to_nchw(opr, new_inp);
+        }
+        auto param = conv.param();
+        param.format = megdnn::param::Convolution::Format::NHWC;
+        auto new_conv = opr::ConvolutionForward::make(
+                to_nhwc(new_inp[0]), to_nhwc(new_inp[1]), param,
+                conv.execution_policy(), conv.config());
+        nhwc_vars.insert(new_conv.node());
+        return new_conv.node()->owner_opr();
+    };
+    auto replace_conv_bias_opr = [&nhwc_vars, to_nhwc, nhwc_usable,
+                                  replace_inps_to_nchw](
+                                         OperatorNodeBase* opr,
+                                         const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        auto& conv_bias = opr->cast_final_safe<opr::ConvBiasForward>();
+        if (!nhwc_usable(conv_bias.param(), opr->input(0), opr->input(1))) {
+            return replace_inps_to_nchw(opr, new_inp);
+        }
+        auto param = conv_bias.param();
+        param.format = megdnn::param::ConvBias::Format::NHWC;
+        VarNodeArray inps = new_inp;
+        for (auto&& inp : inps) {
+            inp = to_nhwc(inp);
+        }
+        SymbolVar new_conv_bias;
+        if (inps.size() == 2) {
+            new_conv_bias = opr::ConvBiasForward::make(
+                    inps[0], inps[1], param, conv_bias.execution_policy(),
+                    conv_bias.config());
+        } else if (inps.size() == 3) {
+            new_conv_bias = opr::ConvBiasForward::make(
+                    inps[0], inps[1], inps[2], param, conv_bias.execution_policy(),
+                    conv_bias.config());
+        } else {
+            mgb_assert(inps.size() == 4);
+            new_conv_bias = opr::ConvBiasForward::make(
+                    inps[0], inps[1], inps[2], inps[3], param,
+                    conv_bias.execution_policy(), conv_bias.config());
+        }
+        nhwc_vars.insert(new_conv_bias.node());
+        return new_conv_bias.node()->owner_opr();
+    };
+    auto replace_conv_bwd_data_opr = [&nhwc_vars, to_nhwc, nhwc_usable,
+                                      replace_inps_to_nchw](
+                                             OperatorNodeBase* opr,
+                                             const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        auto& deconv = opr->cast_final_safe<opr::ConvolutionBackwardData>();
+        if (!nhwc_usable(deconv.param(), opr->input(1), opr->input(0))) {
+            return replace_inps_to_nchw(opr, new_inp);
+        }
+        auto param = deconv.param();
+        param.format = megdnn::param::Convolution::Format::NHWC;
+        SymbolVar new_deconv;
+        if (new_inp.size() == 2) {
+            new_deconv = opr::ConvolutionBackwardData::make(
+                    to_nhwc(new_inp[0]), to_nhwc(new_inp[1]), param,
+                    deconv.execution_policy(), deconv.config());
+        } else {
+            mgb_assert(new_inp.size() == 3);
+            new_deconv = opr::ConvolutionBackwardData::make(
+                    to_nhwc(new_inp[0]), to_nhwc(new_inp[1]), to_nhwc(new_inp[2]),
+                    param, deconv.execution_policy(), deconv.config());
+        }
+        nhwc_vars.insert(new_deconv.node());
+        return new_deconv.node()->owner_opr();
+    };
+    // the output of the new opr is the filter gradient in KRSC
+    auto replace_conv_bwd_filter_opr = [&nhwc_vars, to_nhwc, nhwc_usable,
+                                        replace_inps_to_nchw](
+                                               OperatorNodeBase* opr,
+                                               const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        auto& conv_bwd = opr->cast_final_safe<opr::ConvolutionBackwardFilter>();
+        if (!nhwc_usable(conv_bwd.param(), opr->input(0), opr->input(2))) {
+            return replace_inps_to_nchw(opr, new_inp);
+        }
+        auto param = conv_bwd.param();
+        param.format = megdnn::param::Convolution::Format::NHWC;
+        auto new_conv_bwd = opr::ConvolutionBackwardFilter::make(
+                to_nhwc(new_inp[0]), to_nhwc(new_inp[1]), to_nhwc(new_inp[2]),
+                param, conv_bwd.execution_policy(), conv_bwd.config());
+        nhwc_vars.insert(new_conv_bwd.node());
+        return new_conv_bwd.node()->owner_opr();
+    };
+    // elemwise like oprs compute on NHWC inputs directly unless some input
+    // could not be permuted in the same way as the NCHW ones
+    auto replace_elemwise_like_opr = [&nhwc_vars, to_nhwc, replace_inps_to_nchw](
+                                             OperatorNodeBase* opr,
+                                             const VarNodeArray& new_inp) {
+        mgb_assert(opr->input().size() == new_inp.size());
+        bool has_nhwc = false, all_permutable = true;
+        for (auto&& inp : new_inp) {
+            if (nhwc_vars.count(inp)) {
+                has_nhwc = true;
+            } else if (inp->shape().ndim != 4 && !inp->shape().is_scalar()) {
+                all_permutable = false;
+            }
+        }
+        if (!has_nhwc) {
+            return serialization::copy_opr_shallow(*opr, new_inp, opr->config());
+        }
+        if (!all_permutable) {
+            return replace_inps_to_nchw(opr, new_inp);
+        }
+        VarNodeArray inps = new_inp;
+        for (auto&& inp : inps) {
+            inp = to_nhwc(inp);
+        }
+        auto new_opr = serialization::copy_opr_shallow(*opr, inps, opr->config());
+        nhwc_vars.insert(new_opr->output(0));
+        return new_opr;
+    };
+    // all the other oprs compute on NCHW inputs
+    ret->m_default_replace_func = [&nhwc_vars, replace_inps_to_nchw](
+                                          OperatorNodeBase* opr,
+                                          const VarNodeArray& new_inp)
+            -> OperatorNodeBase* {
+        for (auto&& inp : new_inp) {
+            if (nhwc_vars.count(inp)) {
+                return replace_inps_to_nchw(opr, new_inp);
+            }
+        }
+        return nullptr;
+    };
+
+    replace_func[opr::ConvolutionForward::typeinfo()] = replace_conv_opr;
+    replace_func[opr::ConvBiasForward::typeinfo()] = replace_conv_bias_opr;
+    replace_func[opr::ConvolutionBackwardData::typeinfo()] = replace_conv_bwd_data_opr;
+    replace_func[opr::ConvolutionBackwardFilter::typeinfo()] =
+            replace_conv_bwd_filter_opr;
+    replace_func[opr::Elemwise::typeinfo()] = replace_elemwise_like_opr;
+    replace_func[opr::ElemwiseMultiType::typeinfo()] = replace_elemwise_like_opr;
+    replace_func[opr::TypeCvt::typeinfo()] = replace_elemwise_like_opr;
+    replace_func[opr::PowC::typeinfo()] = replace_elemwise_like_opr;
+    return ret;
+    MIDOUT_E
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -16,6 +16,8 @@
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/search_policy/algo_chooser_helper.h"
 
+#include <unordered_map>
+
 #if MGB_CUDA
 #include <cuda.h>
 #endif
@@ -76,6 +78,25 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief replace the small vars with constant inferred values, such as the
+ *      shapes computed from the inputs loaded with const_var_shape, by
+ *      ImmutableTensor
+ *
+ * The single-output oprs are already folded on insertion, and this pass also
+ * folds the outputs of the multi-output ones (e.g. Split of a shape). The
+ * vars are replaced where they are read by an opr whose outputs are not all
+ * constant, so the shape subgraphs are no longer executed.
+ */
+class FoldConstShapePass final : public Pass {
+public:
+    //! max number of elements of a var to be folded, as on opr insertion
+    static constexpr size_t MAX_NR_ELEMS = 1024;
+
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief replace the dtype of opr from float32 to float16.
  */
@@ -84,7 +105,12 @@ class ConvertF32ToF16Pass : public Pass {
             Typeinfo*,
             thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>>
             m_opr_replace_func;
+    //! replace rule for the oprs without an entry in m_opr_replace_func, a
+    //! nullptr result means that the opr would be kept as is
+    thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>
+            m_default_replace_func;
     VarReplaceCheckFlag m_var_replace_check_flag = VarReplaceCheckFlag::CHECK_ALL;
+    thin_function<bool(OperatorNodeBase*)> m_keep_f32;
 
 public:
     const char* name() const override;
@@ -94,9 +120,40 @@ public:
         return *this;
     }
 
+    /*!
+     * \brief set the oprs to be kept in float32
+     *
+     * The float16 inputs of the kept oprs are casted back to float32, and the
+     * float32 outputs of them are casted to float16 for the converted readers.
+     */
+    ConvertF32ToF16Pass& set_keep_f32(thin_function<bool(OperatorNodeBase*)> keep) {
+        m_keep_f32 = std::move(keep);
+        return *this;
+    }
+
     void apply(OptState& opt) const override;
 
     static std::unique_ptr<ConvertF32ToF16Pass> make(bool use_f32_comp);
+
+protected:
+    //! the dtype which the float32 vars are converted to
+    DType m_target_dtype;
+
+    //! fill m_opr_replace_func for the oprs converted to m_target_dtype
+    void init_replace_func(bool use_f32_comp);
+};
+
+/*!
+ * \brief replace the dtype of opr from float32 to bfloat16
+ *
+ * The matmuls and convolutions compute in float32; reductions are computed
+ * on float32 inputs, since bfloat16 can not hold the partial sums.
+ */
+class ConvertF32ToBF16Pass final : public ConvertF32ToF16Pass {
+public:
+    const char* name() const override;
+
+    static std::unique_ptr<ConvertF32ToBF16Pass> make();
 };
 
 /*!
@@ -107,6 +164,10 @@ class ConvertFormatPass : public Pass {
             Typeinfo*,
             thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>>
             m_opr_replace_func;
+    //! replace rule for the oprs without an entry in m_opr_replace_func, a
+    //! nullptr result means that the opr would be kept as is
+    thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>
+            m_default_replace_func;
     VarReplaceCheckFlag m_var_replace_check_flag = VarReplaceCheckFlag::CHECK_ALL;
 
 public:
@@ -190,6 +251,155 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief fuse exp(x - max(x)) / sum(exp(x - max(x))) into a softmax opr
+ *
+ * This is the form produced by the decomposed softmax of earlier versions, and
+ * it should be applied before the arith chains are normalized.
+ */
+class FuseSoftmaxPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse bmm(softmax(bmm(q, k^T) * scale), v) into a FusedAttention opr
+ *
+ * The scale is optional and must be a scalar constant that multiplies or
+ * divides the scores; the softmax must be along the last axis.
+ */
+class FuseAttentionPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fold the transposes of the last two axes on the inputs and the
+ *      output of MatrixMul/BatchedMatrixMul into the transpose params
+ *
+ * A reshape between the dimshuffle and the BatchedMatrixMul is allowed if it
+ * only merges or splits the batch axes, which is done on the untransposed
+ * tensor instead. On the output side (a * b)^T is computed as b^T * a^T, and
+ * the matmul must have no other readers. Only float oprs of the default
+ * format are changed, since not all the quantized kernels support transposes.
+ * It should be applied before FuseAttentionPass, which matches the transposed
+ * keys by the param.
+ */
+class FoldMatrixMulDimshufflePass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief compute s = sigmoid(x) and s * y by one ElemwiseMultiOutput opr
+ *
+ * Only applied when s has other readers, so that it has to be written to
+ * memory anyway, and the product has the same shape as x.
+ */
+class FuseSigmoidMulPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse the sibling ConvBias/Convolution/MatrixMul oprs that share an
+ *      input into one wider opr, followed by a split of its output
+ *
+ * The siblings must have the same param and dtypes and constant weights of
+ * the same shape except for the number of output channels, which are
+ * concatenated and left to ParamFusePass to be folded.
+ */
+class FuseHorizontalPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief replace the MatrixMul and 1x1 ConvBias oprs whose constant weights
+ *      are sparse enough by BlockSparseMatrixMul
+ *
+ * The weights are split into blocks of (block_h, block_w), where block_h is
+ * along the output channels, and an opr is converted if at least min_sparsity
+ * of the blocks are all zeros. Only float32 oprs with DEFAULT format
+ * MatrixMul and dense NCHW ConvBias without z are handled; the bias and
+ * nonlinearity of the ConvBias are applied by Elemwise oprs.
+ */
+class ConvertToBlockSparsePass final : public Pass {
+public:
+    ConvertToBlockSparsePass(
+            size_t block_h = 1, size_t block_w = 4, float min_sparsity = 0.7f);
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+
+private:
+    size_t m_block_h, m_block_w;
+    float m_min_sparsity;
+};
+
+/*!
+ * \brief replace the MatrixMul oprs of constant weights by
+ *      WeightQuantMatrixMul, with the weights quantized to the given bits
+ *
+ * Each output channel of a weight is quantized symmetrically with the scale
+ * of its max absolute value, so only the weights are quantized and the
+ * activations stay in float. Only float32 and float16 oprs with DEFAULT
+ * format MatrixMul without transposeA are handled.
+ */
+class ConvertToWeightQuantPass final : public Pass {
+public:
+    ConvertToWeightQuantPass(uint32_t bits = 8);
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+
+private:
+    uint32_t m_bits;
+};
+
+/*!
+ * \brief compute the chains of spatial oprs on large feature maps tile by
+ *      tile, so that only tiles of the intermediate results are alive
+ *
+ * A chain consists of NCHW float Convolution, ConvBias without z, MAX or
+ * AVERAGE Pooling and Elemwise whose other inputs are per-channel, where each
+ * intermediate result has only one reader. The output of a chain of at least
+ * two oprs is split into tiles of (tile_h, tile_w); each tile is computed from
+ * the halo-extended sub-region of the chain input, with the paddings of the
+ * oprs applied explicitly at the borders of the feature maps, and the tiles
+ * are concatenated. The tiles are independent of each other, so the depth
+ * first topological order computes them one after another and the memory
+ * planner reuses the storage of the intermediate tiles.
+ */
+class SpatialTilingPass final : public Pass {
+public:
+    SpatialTilingPass(size_t tile_h = 256, size_t tile_w = 256);
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+
+private:
+    size_t m_tile_h, m_tile_w;
+};
+
+/*!
+ * \brief fuse the preprocessing chains of uint8 images into ImagePreprocess
+ *
+ * A chain starts with a CvtColor of a supported mode, or a TypeCvt to float32
+ * of an (N, H, W, 3) uint8 image. It is followed by the TypeCvt, a single
+ * LINEAR or NEAREST Resize, an optional Dimshuffle from NHWC to NCHW, and any
+ * of ADD, SUB, MUL and TRUE_DIV by constant scalars or per-channel constants,
+ * which may come before or after the Resize. The chains containing a Resize
+ * are computed by one ImagePreprocess opr.
+ */
+class FuseImagePreprocessPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief merge all the SharedDeviceTensor oprs into one
  *      MultipleDeviceTensorHolder
@@ -219,6 +429,10 @@ protected:
             Typeinfo*,
             thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>>
             m_opr_replace_func;
+    //! replace rule for the oprs without an entry in m_opr_replace_func, a
+    //! nullptr result means that the opr would be kept as is
+    thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>
+            m_default_replace_func;
     VarReplaceCheckFlag m_var_replace_check_flag = VarReplaceCheckFlag::CHECK_ALL;
     class RelayoutPlaceholder;
     friend class ShuffleShuffleRemovePass;
@@ -329,6 +543,26 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
             ret |= 1u << 4;
         if (fuse_preprocess)
             ret |= 1u << 5;
+        if (fuse_horizontal)
+            ret |= 1u << 6;
+        if (fold_const_shape)
+            ret |= 1u << 7;
+        if (weight_preprocess_cache)
+            ret |= 1u << 8;
+        if (block_sparse_weight)
+            ret |= 1u << 9;
+        if (weight_only_quant_int8)
+            ret |= 1u << 10;
+        if (weight_only_quant_int4)
+            ret |= 1u << 11;
+        if (fuse_multi_output_elemwise)
+            ret |= 1u << 12;
+        if (bf16_io_f32_comp)
+            ret |= 1u << 13;
+        if (spatial_tiling)
+            ret |= 1u << 14;
+        if (padding_channel)
+            ret |= 1u << 15;
         return ret;
     }
 
@@ -340,6 +574,16 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
         ret.fuse_conv_bias_with_z = buf & 1u << 3;
         ret.weight_preprocess = buf & 1u << 4;
         ret.fuse_preprocess = buf & 1u << 5;
+        ret.fuse_horizontal = buf & 1u << 6;
+        ret.fold_const_shape = buf & 1u << 7;
+        ret.weight_preprocess_cache = buf & 1u << 8;
+        ret.block_sparse_weight = buf & 1u << 9;
+        ret.weight_only_quant_int8 = buf & 1u << 10;
+        ret.weight_only_quant_int4 = buf & 1u << 11;
+        ret.fuse_multi_output_elemwise = buf & 1u << 12;
+        ret.bf16_io_f32_comp = buf & 1u << 13;
+        ret.spatial_tiling = buf & 1u << 14;
+        ret.padding_channel = buf & 1u << 15;
         ret.layout_transform = (LayoutTransform)(buf >> 32);
         return ret;
     }
@@ -364,6 +608,10 @@ struct GraphTuningOptions {
     Target target;
     bool layout_transform = false;  ///< whether to enable graph level
                                     ///< tuning for layouts of tensors
+    bool cost_model = false;        ///< whether to estimate the costs of
+                                    ///< layouts by the cost model of the
+                                    ///< target instead of profiling on the
+                                    ///< device
 #define SET(n)                          \
     GraphTuningOptions& enable_##n() {  \
         n = true;                       \
@@ -375,6 +623,7 @@ struct GraphTuningOptions {
     }                                   \
     bool has_set_##n() const { return n == true; }
     SET(layout_transform);
+    SET(cost_model);
 #undef SET
 };
 
@@ -392,10 +641,49 @@ SymbolVarArray optimize_for_inference(
  *
  * The layout selection optimizers are target-dependent. And this function
  * applies a set of predefined optimizer passes designed for specific
- * device.      */
+ * device.
+ *
+ * \param cost_model estimate the costs by the cost model of the target, so
+ *      that the target device is not needed
+ */
 SymbolVarArray layout_transform(
         const SymbolVarArray& dest_vars,
-        GraphTuningOptions::Target target = GraphTuningOptions::Target::UNSPEC);
+        GraphTuningOptions::Target target = GraphTuningOptions::Target::UNSPEC,
+        bool cost_model = false);
+
+/*!
+ * \brief convert a computing graph to float16 except the oprs that are too
+ *      sensitive to the precision loss
+ *
+ * The current values of the Host2DeviceCopy inputs are used as calibration
+ * data. The oprs are kept in float32 one by one, the one amplifying its input
+ * error the most first, until the relative error max|y16 - y32| / max|y32| of
+ * every endpoint is within \p error_budget. Non-finite values give an
+ * infinite error, so the oprs overflowing float16 are kept as well. An opr
+ * between kept oprs is also kept, since converting it would only add casts.
+ *
+ * \param use_f32_comp whether the converted oprs compute in float32
+ */
+SymbolVarArray convert_f32_to_f16_with_error_budget(
+        const SymbolVarArray& dest_vars, float error_budget,
+        bool use_f32_comp = false);
+
+/*!
+ * \brief convert the float32 ConvBias oprs of a graph to int8 by the
+ *      quantization scales of its vars, such as those computed by a Calibrator
+ *
+ * A ConvBias is converted if the scales of its input and output vars are in
+ * \p scales, keyed by the var names, and its weight and bias are constant.
+ * Only NCHW ConvBias without z whose nonlinearity is IDENTITY, RELU or
+ * H_SWISH is handled. The weight is quantized by its max absolute value, and
+ * the bias to int32 of the product of the input and weight scales. The
+ * converted oprs are surrounded by TypeCvt from and to float32, and the casts
+ * between adjacent converted oprs are removed, so that the chains of them
+ * compute in int8.
+ */
+SymbolVarArray quantize_by_calibration(
+        const SymbolVarArray& dest_vars,
+        const std::unordered_map<std::string, float>& scales);
 
 /*!
  * \brief modify execution strategy for oprs with multiple
@@ -482,11 +770,24 @@ public:
 /*!
  * \brief padding channel to enable fast int8/int4 support
  * assume input network is built in NCHW tensor format
+ *
+ * By default the channels of the quantized convs are padded for the CUDA
+ * NCHW4/NCHW32/NCHW64 kernels. The pass made by make_nchwxx_padding() pads
+ * the channels of the float32 and qint8 convs to multiple of pack_c_size
+ * instead, so they can be converted to NCHW44/NCHW88 on CPU.
  */
 class PaddingChannelPass final : public Pass {
 public:
     const char* name() const override;
     void apply(OptState& opt) const override;
+
+    //! make the padding pass run before EnableNchwxxPass of pack_c_size
+    static std::unique_ptr<PaddingChannelPass> make_nchwxx_padding(
+            size_t pack_c_size);
+
+private:
+    //! 0 for the CUDA padding policy
+    size_t m_pack_c_size = 0;
 };
 
 /*!
@@ -507,6 +808,24 @@ private:
     VarNode* on_graph_endpoint_var(VarNode* new_var, VarNode* orig_var) const override;
 };
 
+/*!
+ * \brief convert the float16 convs and their backward oprs to NHWC, so that
+ * the activations of training graphs stay in NHWC between them and cuDNN
+ * could use its tensorcore NHWC kernels on CUDA
+ */
+class EnableNHWCPass final : public TensorReformatPass {
+public:
+    const char* name() const override { return mgb_cstr_log("tensor_format_nhwc"); }
+
+    //! make nchw -> nhwc converter opt pass
+    static std::unique_ptr<EnableNHWCPass> make_nhwc_converter();
+
+private:
+    ThinHashSet<VarNode*> m_nhwc_vars;
+
+    VarNode* on_graph_endpoint_var(VarNode* new_var, VarNode* orig_var) const override;
+};
+
 }  // namespace gopt
 }  // namespace mgb
 
@@ -32,7 +32,9 @@ public:
             std::unique_ptr<LayoutTransformContext> ctx,
             std::unique_ptr<SolverBase> solver)
             : m_ctx{std::move(ctx)}, m_solver{std::move(solver)} {}
-    static std::unique_ptr<LayoutTransformPass> make(GraphTuningOptions::Target target);
+    //! \param cost_model use the profiler of the cost model of the target
+    static std::unique_ptr<LayoutTransformPass> make(
+            GraphTuningOptions::Target target, bool cost_model = false);
 
 private:
     std::unique_ptr<LayoutTransformContext> m_ctx;
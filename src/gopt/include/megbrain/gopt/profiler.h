@@ -27,6 +27,12 @@ class Problem;
 /*!
  * \brief A profiler that collects all the performance data to describe the
  * global layout transform problem.
+ *
+ * \note the profiler made by make_profiler() keeps the elapsed time of every
+ * profiled operator and layout transform in the PersistentCache, keyed by the
+ * param and the layouts of the operator, in a category made from the comp
+ * node. So an InFilePersistentCache makes repeated layout transforms of a
+ * model skip the profiling.
  */
 class ProfilerBase {
 public:
@@ -70,6 +76,36 @@ public:
         /// A hashmap, that maps the var node to the costs of layout transform
         ThinHashMap<VarNode*, VarNodeRecord> var_record;
     };
+    /*!
+     * \brief calibration table of a device for the cost model, which
+     * estimates the elapsed time of an operator by its computation and its
+     * memory traffic without running it
+     *
+     * The estimated time is the larger one of the computation divided by the
+     * throughput reached by the kernels of the opr format, and the memory
+     * traffic of the (aligned) inputs and outputs divided by the bandwidth.
+     */
+    struct CostModel {
+        struct Throughput {
+            float gflops;  ///< peak arithmetic throughput
+            /// ratio of the throughput reached by the kernels of an opr
+            /// format to the peak, formats absent from the table reach
+            /// default_efficiency
+            ThinHashMap<OprFormat, float> efficiency;
+            float default_efficiency = 0.5f;
+            float get_efficiency(OprFormat opr_format) const;
+        };
+        Throughput float_throughput;      ///< for floating point operators
+        Throughput quantized_throughput;  ///< for quantized operators
+        float bandwidth;                  ///< memory bandwidth in GB/s
+
+        /*!
+         * \brief a rough calibration table of the typical devices of the
+         * target, which is meant to be replaced by the measured one of the
+         * actual device
+         */
+        static CostModel make(GraphTuningOptions::Target target);
+    };
     using OprFilter =
             thin_function<bool(const cg::OperatorNodeBase*, cg::OperatorNodeBase*)>;
     using VarNodeFilter = thin_function<bool(
@@ -82,6 +118,11 @@ public:
     virtual ~ProfilerBase() = default;
     virtual ProfilingResult profile(const Problem& problem) const = 0;
     static std::unique_ptr<ProfilerBase> make_profiler();
+    /*!
+     * \brief make a profiler which estimates the costs by the cost model
+     * instead of profiling, so that it does not need the target device
+     */
+    static std::unique_ptr<ProfilerBase> make_cost_model_profiler(CostModel model);
 
 protected:
     OprFilter m_opr_filter;
@@ -21,13 +21,16 @@
 #include "megbrain/opr/blas.h"
 #include "megbrain/opr/dnn/batch_norm.h"
 #include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/dnn/fused_attention.h"
 #include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/io.h"
 #include "megbrain/opr/nn_int.h"
 #include "megbrain/opr/tensor_gen.h"
 #include "megbrain/opr/tensor_manip.h"
 #include "megbrain/opr/utility.h"
+#include "megbrain/plugin/calibrator.h"
 
 #include "./helper.h"
 #include "megbrain/comp_node_env.h"
@@ -985,6 +988,113 @@ TEST(TestGoptInference, Float32TOFloat16C32) {
     MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-3);
 }
 
+TEST(TestGoptInference, Float32TOBFloat16) {
+    CompNode cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen(0, 1, 0);
+    auto host_x0 = gen({1, 4, 1, 1}, cn), host_x1 = gen({2, 3, 16, 8}, cn),
+         host_x2 = gen({4, 3, 1, 1}, cn);
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+
+    auto d0 = opr::Host2DeviceCopy::make(*graph, host_x0),
+         d1 = opr::Host2DeviceCopy::make(*graph, host_x1),
+         d2 = opr::SharedDeviceTensor::make(*graph, *host_x2);
+
+    auto y = opr::ConvBias::make(d1, d2, d0);
+    y = opr::Reduce::make(y, {}, y.make_scalar(1));
+
+    SymbolVar y_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_bf16_io_f32_comp();
+    unpack_vector(gopt::optimize_for_inference({y}, options), y_opt);
+
+    auto&& conv = find_opr<opr::ConvBias>(y_opt);
+    ASSERT_EQ(conv.param().compute_mode, opr::ConvBias::Param::ComputeMode::FLOAT32);
+    ASSERT_EQ(conv.input(0)->dtype(), dtype::BFloat16{});
+    ASSERT_EQ(conv.output(0)->dtype(), dtype::BFloat16{});
+    //! the sum is accumulated on float32 inputs
+    ASSERT_EQ(find_opr<opr::Reduce>(y_opt).input(0)->dtype(), dtype::Float32{});
+    ASSERT_EQ(y_opt.dtype(), dtype::Float32{});
+
+    HostTensorND host_y_opt, host_y;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_opt, host_y_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-2);
+}
+
+TEST(TestGoptInference, EnableNHWCTraining) {
+    CompNode cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::TypeCvt::make(
+                opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name),
+                dtype::Float16());
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::TypeCvt::make(
+                opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name),
+                dtype::Float16());
+    };
+    auto x = mkvar("x", {2, 8, 8, 8}), w0 = mkcvar("w0", {16, 8, 3, 3}),
+         b0 = mkcvar("b0", {1, 16, 1, 1}), w1 = mkcvar("w1", {16, 16, 3, 3});
+    opr::Convolution::Param param;
+    param.pad_h = param.pad_w = 1;
+    auto y0 = opr::relu(opr::Convolution::make(x, w0, param) + b0);
+    auto y1 = opr::Convolution::make(y0, w1, param);
+    auto loss = opr::reduce_sum(
+            opr::TypeCvt::make(y1 * y1, dtype::Float32()), y1.make_scalar(1));
+    auto to_f32 = [](SymbolVar var) {
+        return opr::TypeCvt::make(var, dtype::Float32());
+    };
+    SymbolVarArray ys{
+            loss, to_f32(cg::grad(loss, x)), to_f32(cg::grad(loss, w0)),
+            to_f32(cg::grad(loss, w1))};
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass(gopt::EnableNHWCPass::make_nhwc_converter())
+                          .apply({ys})
+                          .endpoint_vars();
+
+    using Format = opr::Convolution::Param::Format;
+    size_t nr_conv = 0, nr_bwd_data = 0, nr_bwd_filter = 0;
+    auto cb = [&](cg::OperatorNodeBase* opr) {
+        if (opr->same_type<opr::Convolution>()) {
+            ASSERT_EQ(Format::NHWC, opr->cast_final<opr::Convolution>().param().format);
+            ++nr_conv;
+        } else if (opr->same_type<opr::ConvolutionBackwardData>()) {
+            ASSERT_EQ(
+                    Format::NHWC,
+                    opr->cast_final<opr::ConvolutionBackwardData>().param().format);
+            ++nr_bwd_data;
+        } else if (opr->same_type<opr::ConvolutionBackwardFilter>()) {
+            ASSERT_EQ(
+                    Format::NHWC,
+                    opr->cast_final<opr::ConvolutionBackwardFilter>().param().format);
+            ++nr_bwd_filter;
+        }
+    };
+    cg::DepOprIter iter{cb};
+    for (auto&& y : ys_opt) {
+        iter.add(y.node()->owner_opr());
+    }
+    ASSERT_EQ(2u, nr_conv);
+    ASSERT_EQ(2u, nr_bwd_data);
+    ASSERT_EQ(2u, nr_bwd_filter);
+
+    ComputingGraph::OutputSpec outspec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        outspec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        outspec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+    graph->compile(outspec)->execute();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_ys[i], host_ys_opt[i], 1e-2);
+    }
+}
+
 TEST(TestGoptInference, Float32TOFloat16EndpointElemwise) {
     CompNode cn = CompNode::load("cpu0");
     HostTensorGenerator<> gen(0, 1, 0);
@@ -1125,6 +1235,38 @@ TEST(TestGoptInference, Float32TOFloat16Endpoints) {
     ASSERT_EQ(out[1].node()->owner_opr()->input(0)->dtype(), dtype::Float16());
 }
 
+TEST(TestGoptInference, Float32TOFloat16ErrorBudget) {
+    HostTensorGenerator<> gen(0, 1, 0);
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({1, 4, 8, 8}, cn)),
+         w = opr::SharedDeviceTensor::make(*graph, *gen({4, 4, 3, 3}, cn)),
+         conv = opr::Convolution::make(x, w, {}) * 100.f;
+    // the square overflows float16
+    auto y = conv * conv * 1e-4f;
+
+    auto opt = gopt::OptimizeForInferenceOptions{};
+    opt.enable_f16_io_comp();
+    auto y_f16 = gopt::optimize_for_inference({y}, opt)[0];
+    auto y_opt = gopt::convert_f32_to_f16_with_error_budget({y}, 1e-2)[0];
+    ASSERT_EQ(dtype::Float16(), find_opr<opr::Convolution>(y_opt).output(0)->dtype());
+    ASSERT_EQ(dtype::Float32(), y_opt.node()->owner_opr()->input(0)->dtype());
+
+    HostTensorND host_y, host_y_f16, host_y_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_f16, host_y_f16),
+             make_callback_copy(y_opt, host_y_opt)});
+    func->execute();
+    bool f16_finite = true;
+    for (size_t i = 0; i < host_y_f16.shape().total_nr_elems(); ++i) {
+        f16_finite &= std::isfinite(host_y_f16.ptr<float>()[i]);
+    }
+    ASSERT_FALSE(f16_finite);
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-2);
+}
+
 TEST(TestGoptInference, ConvertFormatNHWCD4) {
     // hwcd4 is only supported in naive handle
     NaiveMegDNNHandleScope naive_megdnn_handle;
@@ -1638,6 +1780,516 @@ TEST(TestGoptInference, concatbypass) {
     ASSERT_EQ(1, relayout_format_nr);
 }
 
+TEST(TestGoptInference, FuseSoftmax) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto host_x = gen({4, 7, 33}, cn);
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x");
+    auto decomposed_softmax = [](SymbolVar x, int axis) {
+        using Mode = opr::Reduce::Mode;
+        auto e = opr::exp(x - opr::Reduce::make(x, {Mode::MAX, axis}));
+        return e / opr::Reduce::make(e, {Mode::SUM, axis});
+    };
+    auto y0 = decomposed_softmax(x, 2), y1 = decomposed_softmax(x, 1);
+
+    // exp(x - max(x)) is used elsewhere and should not be fused
+    auto e = opr::exp(x - opr::Reduce::make(x, {opr::Reduce::Mode::MAX, 0}));
+    auto y2 = e / opr::Reduce::make(e, {opr::Reduce::Mode::SUM, 0}) + e;
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    unpack_vector(
+            gopt::optimize_for_inference(
+                    {y0, y1, y2}, gopt::OptimizeForInferenceOptions{}),
+            y0_opt, y1_opt, y2_opt);
+    ASSERT_EQ(opr::Softmax::typeinfo(), y0_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_EQ(opr::Softmax::typeinfo(), y1_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_EQ(0u, find_opr_num<opr::Softmax>(y2_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::Reduce>(y0_opt));
+    ASSERT_EQ(2, y0_opt.node()->owner_opr()->cast_final<opr::Softmax>().param().axis);
+    ASSERT_EQ(1, y1_opt.node()->owner_opr()->cast_final<opr::Softmax>().param().axis);
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-6);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-6);
+}
+
+TEST(TestGoptInference, FuseAttention) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto q = mkvar("q", {4, 9, 16}), k = mkvar("k", {4, 21, 16}),
+         v = mkvar("v", {4, 21, 8});
+    auto scores = opr::BatchedMatrixMul::make(q, k, {false, true});
+    auto y0 = opr::BatchedMatrixMul::make(opr::Softmax::make(scores * 0.25f, {2}), v);
+    auto y1 = opr::BatchedMatrixMul::make(
+            opr::Softmax::make(
+                    opr::BatchedMatrixMul::make(q, k, {false, true}) / 4.f, {-1}),
+            v);
+
+    // the attention probabilities are used elsewhere and should not be fused
+    auto p = opr::Softmax::make(opr::BatchedMatrixMul::make(q, k, {false, true}), {2});
+    auto y2 = opr::BatchedMatrixMul::make(p, v) +
+              opr::BatchedMatrixMul::make(p, v * 2.f);
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    unpack_vector(
+            gopt::optimize_for_inference(
+                    {y0, y1, y2}, gopt::OptimizeForInferenceOptions{}),
+            y0_opt, y1_opt, y2_opt);
+    auto&& fused = y0_opt.node()->owner_opr();
+    ASSERT_EQ(opr::FusedAttention::typeinfo(), fused->dyn_typeinfo());
+    ASSERT_EQ(0.25f, fused->cast_final<opr::FusedAttention>().param().scale);
+    ASSERT_EQ(
+            opr::FusedAttention::typeinfo(),
+            y1_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_EQ(0u, find_opr_num<opr::FusedAttention>(y2_opt));
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-5);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-5);
+}
+
+TEST(TestGoptInference, FoldMatrixMulDimshuffle) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto a = mkvar("a", {6, 8}), b = mkvar("b", {5, 8}), q = mkvar("q", {4, 9, 16}),
+         k = mkvar("k", {2, 2, 21, 16}), v = mkvar("v", {4, 16, 8});
+    auto y0 = opr::MatrixMul::make(a, opr::Dimshuffle::make(b, {1, 0}));
+    // the batch axes are merged after the transpose
+    auto kt = opr::Reshape::make(opr::Dimshuffle::make(k, {0, 1, 3, 2}), {4, 16, 21});
+    auto y1 = opr::BatchedMatrixMul::make(q, kt);
+    // the batch axes are split before the transpose of the output
+    auto y2 = opr::Dimshuffle::make(
+            opr::Reshape::make(opr::BatchedMatrixMul::make(q, v), {2, 2, 9, 8}),
+            {0, 1, 3, 2});
+    // the product is used elsewhere and should not be computed twice
+    auto c = opr::MatrixMul::make(a, b, {false, true});
+    auto y3 = opr::Dimshuffle::make(c, {1, 0}) + opr::Dimshuffle::make(c * 2.f, {1, 0});
+
+    SymbolVar y0_opt, y1_opt, y2_opt, y3_opt;
+    unpack_vector(
+            gopt::optimize_for_inference(
+                    {y0, y1, y2, y3}, gopt::OptimizeForInferenceOptions{}),
+            y0_opt, y1_opt, y2_opt, y3_opt);
+    ASSERT_EQ(0u, find_opr_num<opr::Dimshuffle>(y0_opt));
+    ASSERT_TRUE(y0_opt.node()->owner_opr()->cast_final_safe<opr::MatrixMul>().param()
+                        .transposeB);
+    ASSERT_EQ(0u, find_opr_num<opr::Dimshuffle>(y1_opt));
+    ASSERT_TRUE(find_opr<opr::BatchedMatrixMul>(y1_opt).param().transposeB);
+    ASSERT_EQ(0u, find_opr_num<opr::Dimshuffle>(y2_opt));
+    auto&& bmm = find_opr<opr::BatchedMatrixMul>(y2_opt);
+    ASSERT_TRUE(bmm.param().transposeA && bmm.param().transposeB);
+    ASSERT_EQ(2u, find_opr_num<opr::Dimshuffle>(y3_opt));
+    ASSERT_EQ(1u, find_opr_num<opr::MatrixMul>(y3_opt));
+
+    HostTensorND host_y[4], host_y_opt[4];
+    SymbolVar ys[] = {y0, y1, y2, y3}, ys_opt[] = {y0_opt, y1_opt, y2_opt, y3_opt};
+    ComputingGraph::OutputSpec out_spec;
+    for (size_t i = 0; i < 4; ++i) {
+        out_spec.push_back(make_callback_copy(ys[i], host_y[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_y_opt[i]));
+    }
+    graph->compile(out_spec)->execute();
+    for (size_t i = 0; i < 4; ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_y[i], host_y_opt[i], 1e-5);
+    }
+}
+
+TEST(TestGoptInference, FuseHorizontal) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+
+    opr::ConvBias::Param param;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto x = mkvar("x", {2, 8, 6, 6});
+    auto c0 = opr::ConvBias::make(
+                 x, mkcvar("w0", {4, 8, 1, 1}), mkcvar("b0", {1, 4, 1, 1}), param),
+         c1 = opr::ConvBias::make(
+                 x, mkcvar("w1", {8, 8, 1, 1}), mkcvar("b1", {1, 8, 1, 1}), param);
+    // the sibling with another param should not be fused
+    auto c2 = opr::ConvBias::make(
+            x, mkcvar("w2", {4, 8, 1, 1}), mkcvar("b2", {1, 4, 1, 1}));
+    auto y0 = opr::Concat::make({c0, c1, c2}, 1);
+
+    auto a = mkvar("a", {5, 16});
+    auto y1 = opr::Concat::make(
+            {opr::MatrixMul::make(a, mkcvar("q", {8, 16}), {false, true}),
+             opr::MatrixMul::make(a, mkcvar("k", {8, 16}), {false, true}),
+             opr::MatrixMul::make(a, mkcvar("v", {4, 16}), {false, true})},
+            1);
+
+    SymbolVar y0_opt, y1_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_horizontal();
+    unpack_vector(gopt::optimize_for_inference({y0, y1}, options), y0_opt, y1_opt);
+    ASSERT_EQ(2u, find_opr_num<opr::ConvBias>(y0_opt));
+    ASSERT_EQ(1u, find_opr_num<opr::MatrixMul>(y1_opt));
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-5);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-5);
+}
+
+TEST(TestGoptInference, ConvertToBlockSparse) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    //! keep one in five 1x4 blocks of the (rows, cols) matrix, which is
+    //! transposed in memory if transpose is true
+    auto mkcvar_sparse = [&](const char* name, const TensorShape& shp, size_t rows,
+                             size_t cols, bool transpose) {
+        auto host = gen(shp, cn);
+        auto ptr = host->ptr<float>();
+        for (size_t r = 0; r < rows; ++r) {
+            for (size_t c = 0; c < cols; c += 4) {
+                if ((r + c / 4) % 5) {
+                    for (size_t j = c; j < c + 4; ++j) {
+                        ptr[transpose ? j * rows + r : r * cols + j] = 0;
+                    }
+                }
+            }
+        }
+        return opr::SharedDeviceTensor::make(*graph, *host).rename(name);
+    };
+
+    auto a = mkvar("a", {5, 16});
+    // (N, K) weight as the sparse matrix and (K, N) one as its transpose
+    auto y0 = opr::MatrixMul::make(
+                 a, mkcvar_sparse("w0", {8, 16}, 8, 16, false), {false, true}),
+         y1 = opr::MatrixMul::make(a, mkcvar_sparse("w1", {16, 12}, 12, 16, true));
+    // dense weights are kept
+    auto y2 = opr::MatrixMul::make(
+            a, opr::SharedDeviceTensor::make(*graph, *gen({16, 4}, cn)));
+
+    opr::ConvBias::Param param;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto x = mkvar("x", {2, 16, 5, 7});
+    auto y3 = opr::ConvBias::make(
+            x, mkcvar_sparse("w3", {8, 16, 1, 1}, 8, 16, false),
+            opr::SharedDeviceTensor::make(*graph, *gen({1, 8, 1, 1}, cn)), param);
+
+    SymbolVarArray ys{y0, y1, y2, y3};
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_block_sparse_weight();
+    auto ys_opt = gopt::optimize_for_inference(ys, options);
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(
+                size_t(i != 2), find_opr_num<opr::BlockSparseMatrixMul>(ys_opt[i]));
+    }
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(ys_opt[3]));
+
+    HostTensorND host_y[4], host_y_opt[4];
+    ComputingGraph::OutputSpec out_spec;
+    for (size_t i = 0; i < 4; ++i) {
+        out_spec.push_back(make_callback_copy(ys[i], host_y[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_y_opt[i]));
+    }
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < 4; ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_y[i], host_y_opt[i], 1e-5);
+    }
+}
+
+TEST(TestGoptInference, ConvertToWeightQuant) {
+    for (int qmax : {127, 7}) {
+        HostTensorGenerator<> gen;
+        auto cn = CompNode::load("cpu0");
+        auto graph = ComputingGraph::make();
+        graph->options().graph_opt_level = 0;
+        //! integers within qmax times the scale of each output channel, with
+        //! qmax in each channel, so that the quantization is lossless
+        auto mkcvar_quant = [&](const char* name, size_t K, size_t N, bool transpose) {
+            auto host = std::make_shared<HostTensorND>(
+                    cn, transpose ? TensorShape{N, K} : TensorShape{K, N},
+                    dtype::Float32());
+            auto ptr = host->ptr<float>();
+            for (size_t n = 0; n < N; ++n) {
+                float scale = 0.1f * (n + 1);
+                for (size_t k = 0; k < K; ++k) {
+                    int q = static_cast<int>((n * 7 + k * 3) % (2 * qmax + 1)) - qmax;
+                    if (!k)
+                        q = qmax;
+                    ptr[transpose ? n * K + k : k * N + n] = q * scale;
+                }
+            }
+            return opr::SharedDeviceTensor::make(*graph, *host).rename(name);
+        };
+
+        auto a = opr::Host2DeviceCopy::make(*graph, gen({5, 7}, cn)).rename("a");
+        // odd K leaves the upper half of the last byte of int4 unused
+        auto y0 = opr::MatrixMul::make(
+                     a, mkcvar_quant("w0", 7, 9, true), {false, true}),
+             y1 = opr::MatrixMul::make(a, mkcvar_quant("w1", 7, 4, false));
+        // non-constant weights are kept
+        auto y2 = opr::MatrixMul::make(
+                a, opr::Host2DeviceCopy::make(*graph, gen({7, 3}, cn)));
+
+        SymbolVarArray ys{y0, y1, y2};
+        auto options = gopt::OptimizeForInferenceOptions{};
+        if (qmax == 127) {
+            options.enable_weight_only_quant_int8();
+        } else {
+            options.enable_weight_only_quant_int4();
+        }
+        auto ys_opt = gopt::optimize_for_inference(ys, options);
+        for (size_t i = 0; i < 3; ++i) {
+            ASSERT_EQ(
+                    size_t(i != 2), find_opr_num<opr::WeightQuantMatrixMul>(ys_opt[i]));
+        }
+
+        HostTensorND host_y[3], host_y_opt[3];
+        ComputingGraph::OutputSpec out_spec;
+        for (size_t i = 0; i < 3; ++i) {
+            out_spec.push_back(make_callback_copy(ys[i], host_y[i]));
+            out_spec.push_back(make_callback_copy(ys_opt[i], host_y_opt[i]));
+        }
+        auto func = graph->compile(out_spec);
+        func->execute();
+        for (size_t i = 0; i < 3; ++i) {
+            MGB_ASSERT_TENSOR_NEAR(host_y[i], host_y_opt[i], 1e-4);
+        }
+    }
+}
+
+TEST(TestGoptInference, FuseImagePreprocess) {
+    using CvtMode = opr::CvtColor::Param::Mode;
+    using Format = opr::Resize::Param::Format;
+    using IMode = opr::Resize::Param::InterpolationMode;
+    HostTensorGenerator<dtype::Uint8, RandomDistribution::UNIFORM> gen(0, 255);
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkcvar = [&](const TensorShape& shape, std::vector<float> values) {
+        auto host = std::make_shared<HostTensorND>(cn, shape, dtype::Float32());
+        std::copy(values.begin(), values.end(), host->ptr<float>());
+        return opr::SharedDeviceTensor::make(*graph, *host);
+    };
+    auto mkresize = [&](SymbolVar x, Format format, IMode imode) {
+        opr::Resize::Param param;
+        param.format = format;
+        param.imode = imode;
+        return opr::Resize::make(x, TensorShape{7, 9}, param);
+    };
+
+    // nv12 -> bgr -> float -> resize -> nchw -> (x - mean) / std
+    auto nv12 = opr::Host2DeviceCopy::make(*graph, gen({2, 12, 10, 1}, cn)),
+         bgr = opr::CvtColor::make(nv12, {CvtMode::YUV2BGR_NV12}),
+         x0 = mkresize(
+                 opr::TypeCvt::make(bgr, dtype::Float32()), Format::NHWC,
+                 IMode::LINEAR),
+         y0 = (opr::Dimshuffle::make(x0, {0, 3, 1, 2}) -
+               mkcvar({1, 3, 1, 1}, {103.5f, 116.3f, 123.7f})) /
+              mkcvar({1, 3, 1, 1}, {57.4f, 57.1f, 58.4f});
+
+    // rgb -> float / 255 -> resize -> 2 * x - 1, kept in nhwc
+    auto rgb = opr::Host2DeviceCopy::make(*graph, gen({2, 5, 6, 3}, cn)),
+         x1 = mkresize(
+                 opr::TypeCvt::make(rgb, dtype::Float32()) / 255.f, Format::NHWC,
+                 IMode::NEAREST),
+         y1 = mkcvar({3}, {1.f, 1.f, 1.f}) - x1 * (-2.f);
+
+    // without a resize the chain is kept
+    auto y2 = opr::TypeCvt::make(rgb, dtype::Float32()) * 0.5f;
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    unpack_vector(
+            gopt::GraphOptimizer{}
+                    .add_pass<gopt::FuseImagePreprocessPass>()
+                    .apply({{y0, y1, y2}})
+                    .endpoint_vars(),
+            y0_opt, y1_opt, y2_opt);
+    SymbolVarArray ys{y0, y1, y2}, ys_opt{y0_opt, y1_opt, y2_opt};
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(size_t(i != 2), find_opr_num<opr::ImagePreprocess>(ys_opt[i]));
+        ASSERT_EQ(size_t(i == 2), find_opr_num<opr::TypeCvt>(ys_opt[i]));
+    }
+
+    HostTensorND host_y[3], host_y_opt[3];
+    ComputingGraph::OutputSpec out_spec;
+    for (size_t i = 0; i < 3; ++i) {
+        out_spec.push_back(make_callback_copy(ys[i], host_y[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_y_opt[i]));
+    }
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < 3; ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_y[i], host_y_opt[i], 1e-4);
+    }
+}
+
+TEST(TestGoptInference, QuantizeByCalibration) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    Calibrator calibrator{graph.get()};
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({2, 4, 8, 8}, cn)).rename("x");
+    opr::ConvBias::Param param;
+    param.pad_h = param.pad_w = 1;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto y0 = opr::ConvBias::make(
+                      x, mkcvar("w0", {8, 4, 3, 3}), mkcvar("b0", {1, 8, 1, 1}), param)
+                      .rename("y0");
+    param.pad_h = param.pad_w = 0;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::IDENTITY;
+    auto y1 = opr::ConvBias::make(y0, mkcvar("w1", {4, 8, 1, 1}), param).rename("y1");
+
+    HostTensorND host_y;
+    auto func = graph->compile({make_callback_copy(y1, host_y)});
+    func->execute();
+    auto scales = calibrator.scales(Calibrator::Method::MAX);
+    ASSERT_EQ(1u, scales.count("y0"));
+
+    auto y1_q = gopt::quantize_by_calibration({y1}, scales)[0];
+    // only the casts of the input and output are left
+    ASSERT_EQ(2u, find_opr_num<opr::TypeCvt>(y1_q));
+    ASSERT_EQ(dtype::Float32(), y1_q.dtype());
+    auto&& conv = find_opr<opr::ConvBias>(y1_q);
+    ASSERT_EQ(DTypeEnum::QuantizedS8, conv.output(0)->dtype().enumv());
+
+    HostTensorND host_y_q;
+    func = graph->compile({make_callback_copy(y1_q, host_y_q)});
+    func->execute();
+    float max_err = 0.f, max_abs = 0.f;
+    auto py = host_y.ptr<float>(), py_q = host_y_q.ptr<float>();
+    for (size_t i = 0; i < host_y.shape().total_nr_elems(); ++i) {
+        max_err = std::max(max_err, std::abs(py[i] - py_q[i]));
+        max_abs = std::max(max_abs, std::abs(py[i]));
+    }
+    ASSERT_LT(max_err, max_abs * 0.05f);
+}
+
+TEST(TestGoptInference, FuseSigmoidMul) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    using Mode = opr::Elemwise::Mode;
+    auto x = mkvar("x", {2, 3, 8}), y = mkvar("y", {2, 3, 8}),
+         b = mkvar("b", {1, 3, 1}), x1 = mkvar("x1", {1, 3, 8});
+    auto s = opr::Elemwise::make({x}, Mode::SIGMOID);
+    auto y0 = s * y + s * b;
+
+    // the product is larger than sigmoid(x1), so it should not be fused
+    auto s1 = opr::Elemwise::make({x1}, Mode::SIGMOID);
+    auto y1 = s1 * y + s1;
+
+    SymbolVar y0_opt, y1_opt;
+    unpack_vector(
+            gopt::GraphOptimizer{}
+                    .add_pass<gopt::FuseSigmoidMulPass>()
+                    .apply({{y0, y1}})
+                    .endpoint_vars(),
+            y0_opt, y1_opt);
+    ASSERT_EQ(1u, find_opr_num<opr::ElemwiseMultiOutput>(y0_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::ElemwiseMultiOutput>(y1_opt));
+
+    HostTensorND host_y0, host_y0_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0),
+             make_callback_copy(y0_opt, host_y0_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-6);
+}
+
+TEST(TestGoptInference, SpatialTiling) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    auto mkpool = [](opr::Pooling::Param::Mode mode, uint32_t window,
+                     uint32_t stride, uint32_t pad) {
+        opr::Pooling::Param param;
+        param.mode = mode;
+        param.window_h = param.window_w = window;
+        param.stride_h = param.stride_w = stride;
+        param.pad_h = param.pad_w = pad;
+        return param;
+    };
+    using PoolMode = opr::Pooling::Param::Mode;
+
+    auto x = mkvar("x", {2, 3, 37, 45});
+    opr::Convolution::Param conv_param;
+    conv_param.pad_h = conv_param.pad_w = 1;
+    auto c0 = opr::Convolution::make(x, mkcvar("w0", {4, 3, 3, 3}), conv_param);
+    auto p0 = opr::Pooling::make(c0, mkpool(PoolMode::MAX, 3, 2, 1));
+    opr::ConvBias::Param param;
+    param.pad_h = param.pad_w = 1;
+    param.dilate_h = param.dilate_w = 2;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto c1 = opr::ConvBias::make(
+            p0, mkcvar("w1", {6, 4, 3, 3}), mkcvar("b1", {1, 6, 1, 1}), param);
+    // the residual is sliced like the output of c1
+    auto e = c1 + mkvar("r", {2, 6, 17, 21});
+    auto y = opr::Pooling::make(e, mkpool(PoolMode::AVERAGE, 2, 1, 1));
+    ASSERT_EQ(TensorShape({2, 6, 18, 22}), y.shape());
+
+    SymbolVar y_opt;
+    unpack_vector(
+            gopt::GraphOptimizer{}
+                    .add_pass<gopt::SpatialTilingPass>(4, 5)
+                    .apply({{y}})
+                    .endpoint_vars(),
+            y_opt);
+    // 5 rows by 5 columns of tiles
+    ASSERT_EQ(25u, find_opr_num<opr::ConvBias>(y_opt));
+    ASSERT_EQ(50u, find_opr_num<opr::Pooling>(y_opt));
+
+    HostTensorND host_y, host_y_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_opt, host_y_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-5);
+}
+
 TEST(TestGoptInference, ConvertBatchNormPass) {
     auto cn = CompNode::load("cpu0");
 
@@ -1780,6 +2432,79 @@ TEST(TestGoptInference, ConvBiasNonlinearityFusePass_FullBias) {
     }
 }
 
+TEST(TestGoptInference, ConvBiasNonlinearityFusePass_Quantized) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<dtype::Int8> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp, const DType& dtype) {
+        return opr::TypeCvt::make(
+                opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name), dtype);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp, const DType& dtype) {
+        return opr::TypeCvt::make(
+                opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name),
+                dtype);
+    };
+    using MultiMode = opr::ElemwiseMultiType::Param::Mode;
+    using NonlineMode = opr::ConvBias::Param::NonlineMode;
+
+    auto x = mkvar("x", {2, 4, 12, 12}, dtype::QuantizedS8(2.5f)),
+         w = mkcvar("w", {8, 4, 3, 3}, dtype::QuantizedS8(2.5f)),
+         b = mkcvar("b", {1, 8, 1, 1}, dtype::QuantizedS32(6.25f));
+    opr::ConvBias::Param param;
+    param.pad_h = param.pad_w = 1;
+    auto conv0 = opr::ConvBias::make(
+            x, w, b, param, {},
+            OperatorNodeConfig{"conv0", cn, dtype::QuantizedS8(300.f)});
+    //! the requantization is exact, so y0 is the same after the fusion
+    auto y0 = opr::ElemwiseMultiType::make(
+            {conv0}, {MultiMode::QRELU},
+            OperatorNodeConfig{dtype::QuantizedS8(300.f)});
+
+    auto w1 = mkcvar("w1", {8, 8, 3, 3}, dtype::QuantizedS8(2.5f)),
+         b1 = mkcvar("b1", {1, 8, 1, 1}, dtype::QuantizedS32(750.f));
+    auto conv1 = opr::ConvBias::make(
+            y0, w1, b1, param, {},
+            OperatorNodeConfig{"conv1", cn, dtype::QuantizedS8(1e5f)});
+    auto y1 = opr::TypeCvt::make(conv1, dtype::QuantizedS8(8e4f));
+
+    param.pad_h = param.pad_w = 0;
+    auto w2 = mkcvar("w2", {8, 8, 1, 1}, dtype::QuantizedS8(2.5f)),
+         b2 = mkcvar("b2", {1, 8, 1, 1}, dtype::QuantizedS32(750.f));
+    auto conv2 = opr::ConvBias::make(
+            y0, w2, b2, param, {},
+            OperatorNodeConfig{"conv2", cn, dtype::QuantizedS8(5e4f)});
+    auto y2 = opr::ElemwiseMultiType::make(
+            {conv2}, {MultiMode::QH_SWISH},
+            OperatorNodeConfig{dtype::QuantizedS8(5e4f)});
+
+    SymbolVar y1_opt, y2_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_conv_bias_nonlinearity();
+    unpack_vector(gopt::optimize_for_inference({y1, y2}, options), y1_opt, y2_opt);
+
+    ASSERT_EQ(0u, find_opr_num<opr::ElemwiseMultiType>(y1_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::ElemwiseMultiType>(y2_opt));
+    ASSERT_EQ(
+            NonlineMode::RELU,
+            find_opr<opr::ConvBias>(y1_opt, "conv0").param().nonlineMode);
+    ASSERT_TRUE(y1_opt.node()->owner_opr()->same_type<opr::ConvBias>());
+    ASSERT_EQ(dtype::QuantizedS8(8e4f), y1_opt.dtype());
+    auto&& conv2_opt = find_opr<opr::ConvBias>(y2_opt, "conv2");
+    ASSERT_EQ(NonlineMode::H_SWISH, conv2_opt.param().nonlineMode);
+    ASSERT_EQ(dtype::QuantizedS8(5e4f), conv2_opt.output(0)->dtype());
+
+    //! the fused oprs round once, so the outputs differ by at most one step
+    HostTensorND host_y1, host_y1_opt, host_y2, host_y2_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt),
+             make_callback_copy(y2, host_y2), make_callback_copy(y2_opt, host_y2_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1.01);
+    MGB_ASSERT_TENSOR_NEAR(host_y2, host_y2_opt, 1.01);
+}
+
 TEST(TestGoptInference, ParamMerge) {
     auto cns = load_multiple_xpus(2);
     HostTensorGenerator<> gen;
@@ -4756,4 +5481,64 @@ TEST(TestGoptInference, PaddingChannelsWithWarpPerspective) {
 
 #endif
 
+TEST(TestGoptInference, PaddingChannelsNCHW44) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+
+    auto x = mkvar("x", {2, 3, 14, 14});
+    opr::ConvBias::Param param;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    param.pad_h = param.pad_w = 1;
+    //! the 3 input channels are read by the hybrid algos, the 6 output
+    //! channels are padded to 8
+    auto w1 = mkcvar("w1", {6, 3, 3, 3}), b1 = mkcvar("b1", {1, 6, 1, 1});
+    auto conv1 = opr::ConvBias::make(x, w1, b1, param, {}, OperatorNodeConfig("conv1"));
+    //! channel wise conv, the 6 groups are padded to 8
+    param.sparse = opr::ConvBias::Param::Sparse::GROUP;
+    auto w2 = mkcvar("w2", {6, 1, 1, 3, 3}), b2 = mkcvar("b2", {1, 6, 1, 1});
+    auto conv2 =
+            opr::ConvBias::make(conv1, w2, b2, param, {}, OperatorNodeConfig("conv2"));
+    //! the channels are padded from 6 to 8 and from 10 to 12
+    param.sparse = opr::ConvBias::Param::Sparse::DENSE;
+    param.pad_h = param.pad_w = 0;
+    auto w3 = mkcvar("w3", {10, 6, 1, 1}), b3 = mkcvar("b3", {1, 10, 1, 1});
+    auto conv3 =
+            opr::ConvBias::make(conv2, w3, b3, param, {}, OperatorNodeConfig("conv3"));
+    opr::Pooling::Param pooling_param;
+    pooling_param.window_h = pooling_param.window_w = 2;
+    pooling_param.stride_h = pooling_param.stride_w = 2;
+    auto y = opr::Pooling::make(conv3, pooling_param);
+
+    SymbolVar y_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_conv_bias_nonlinearity();
+    options.enable_nchw44();
+    options.enable_padding_channel();
+    unpack_vector(gopt::optimize_for_inference({y}, options), y_opt);
+
+    for (auto name : {"conv1", "conv2", "conv3"}) {
+        ASSERT_EQ(
+                opr::ConvBias::Param::Format::NCHW44,
+                find_opr<opr::ConvBias>(y_opt, name).param().format);
+    }
+    ASSERT_EQ(
+            opr::Pooling::Param::Format::NCHW44,
+            find_opr<opr::Pooling>(y_opt).param().format);
+    ASSERT_EQ(y.shape(), y_opt.shape());
+
+    HostTensorND host_y, host_y_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_opt, host_y_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-3);
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
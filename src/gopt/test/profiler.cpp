@@ -18,6 +18,7 @@
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/nn_int.h"
 #include "megbrain/serialization/serializer.h"
+#include "megbrain/utils/persistent_cache.h"
 
 using namespace mgb;
 using namespace gopt;
@@ -325,6 +326,124 @@ TEST(TestProfiler, Elemwise) {
     EXPECT_TRUE(var_rst.count(q8a.node()) > 0);
     EXPECT_TRUE(var_rst.count(q8b.node()) > 0);
 }
+
+TEST(TestProfiler, ProfilingCache) {
+    REQUIRE_GPU(1);
+    auto cn = CompNode::load("gpu0");
+    cn.activate();
+    auto ctx = make_ctx();
+
+    HostTensorGenerator<dtype::Int8> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp, const DType& dtype) {
+        return opr::TypeCvt::make(
+                opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name), dtype);
+    };
+    auto a = mkvar("a", {16, 48, 14, 14}, dtype::QuantizedS8(2.5f));
+    auto b = mkvar("b", {16, 48, 14, 14}, dtype::QuantizedS8(1.2f));
+    auto c = opr::ElemwiseMultiType::make(
+            {a, b}, {opr::ElemwiseMultiType::Param::Mode::QFUSE_ADD_RELU},
+            OperatorNodeConfig(dtype::QuantizedS8(12.f)));
+    auto d = opr::TypeCvt::make(c, dtype::Float32());
+
+    SubGraphExtractor extractor(ctx->opr_list());
+    auto partitions = extractor.extract({d});
+    ASSERT_EQ(partitions.size(), 1u);
+    Problem problem(partitions[0], *ctx);
+
+    auto orig_cache =
+            PersistentCache::set_impl(std::make_shared<InMemoryPersistentCache>());
+    size_t nr_get = 0, nr_hit = 0, nr_put = 0;
+    {
+        auto is_profiling_cache = [](const std::string& category) {
+            return category.find("layout_transform_profile:") == 0;
+        };
+        PersistentCacheHook hook{
+                [&](const std::string& category, const void*, size_t,
+                    const void* val, size_t) {
+                    if (is_profiling_cache(category)) {
+                        ++nr_get;
+                        nr_hit += val != nullptr;
+                    }
+                },
+                [&](const std::string& category, const void*, size_t, const void*,
+                    size_t) { nr_put += is_profiling_cache(category); }};
+        auto profiler = ProfilerBase::make_profiler();
+        auto rst = profiler->profile(problem);
+        ASSERT_GT(nr_put, 0u);
+        size_t nr_put_first = nr_put;
+        nr_get = nr_hit = 0;
+
+        // the second run should get all the results from the cache
+        auto cached_rst = profiler->profile(problem);
+        ASSERT_EQ(nr_put_first, nr_put);
+        ASSERT_GT(nr_get, 0u);
+        ASSERT_EQ(nr_get, nr_hit);
+        ASSERT_EQ(rst.opr_record.size(), cached_rst.opr_record.size());
+        for (auto&& i : rst.opr_record) {
+            auto&& costs = cached_rst.opr_record.at(i.first).costs;
+            for (auto&& j : i.second.costs)
+                ASSERT_EQ(j.second, costs.at(j.first));
+        }
+        ASSERT_EQ(rst.var_record.size(), cached_rst.var_record.size());
+        for (auto&& i : rst.var_record) {
+            auto&& costs = cached_rst.var_record.at(i.first).costs;
+            for (auto&& j : i.second.costs)
+                ASSERT_EQ(j.second, costs.at(j.first));
+        }
+    }
+    PersistentCache::set_impl(std::move(orig_cache));
+}
 #endif
 
+TEST(TestProfiler, CostModel) {
+    //! the cost model does not need the target device, so the graph is built on
+    //! cpu and optimized for cuda
+    auto cn = CompNode::load("cpu0");
+    auto ctx = LayoutTransformContext::make(LayoutTransformContext::Target::CUDA);
+
+    HostTensorGenerator<dtype::Int8> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp, const DType& dtype) {
+        return opr::TypeCvt::make(
+                opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name), dtype);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp, const DType& dtype) {
+        return opr::TypeCvt::make(
+                opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name),
+                dtype);
+    };
+    auto x = mkvar("x", {16, 64, 14, 14}, dtype::QuantizedS8(2.5f));
+    auto w = mkcvar("w", {64, 64, 3, 3}, dtype::QuantizedS8(2.5f));
+    auto b = mkcvar("b", {1, 64, 1, 1}, dtype::QuantizedS32(6.25f));
+    opr::ConvBias::Param param;
+    param.format = opr::ConvBias::Param::Format::NCHW;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    param.stride_h = param.stride_w = 1;
+    param.pad_h = param.pad_w = 1;
+    auto y = opr::ConvBias::make(
+            x, w, b, param, {}, OperatorNodeConfig(dtype::QuantizedS8(2.5f)));
+
+    SubGraphExtractor extractor(ctx->opr_list());
+    auto partitions = extractor.extract({y});
+    ASSERT_EQ(partitions.size(), 1u);
+    Problem problem(partitions[0], *ctx);
+    auto profiler = ProfilerBase::make_cost_model_profiler(
+            ProfilerBase::CostModel::make(LayoutTransformContext::Target::CUDA));
+    auto rst = profiler->profile(problem);
+    using OprFormat = ProfilerBase::OprFormat;
+    auto&& costs = rst.opr_record.at(y.node()->owner_opr()).costs;
+    ASSERT_GT(costs.count(OprFormat::NCHW), 0u);
+    ASSERT_GT(costs.count(OprFormat::NCHW32), 0u);
+    for (auto&& i : costs)
+        ASSERT_GT(i.second, 0.f);
+    //! the quantized kernels of NCHW are the slow naive ones on cuda
+    ASSERT_LT(costs.at(OprFormat::NCHW32), costs.at(OprFormat::NCHW));
+    ASSERT_GT(rst.var_record.count(x.node()), 0u);
+    for (auto&& i : rst.var_record.at(x.node()).costs)
+        ASSERT_GT(i.second, 0.f);
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
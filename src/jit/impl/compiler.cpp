@@ -11,6 +11,7 @@
 
 #include "./mlir/compiler.h"
 #include "./halide/compiler_cuda.h"
+#include "./interpreter/compiler.h"
 #include "./nvrtc/compiler_cuda.h"
 
 #include "megbrain/jit/compiler.h"
@@ -111,6 +112,10 @@ Compiler* Compiler::get(ComputingGraph& graph, CompNode comp_node) {
                     break;
                 }
 #endif
+                if (!backend || !strcmp(backend, "INTERP")) {
+                    compiler = std::make_unique<InterpreterCompiler>();
+                    break;
+                }
                 mgb_throw(InternalError, "No compiler support for cpu");
                 break;
             default:
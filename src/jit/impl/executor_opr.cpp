@@ -245,6 +245,8 @@ void JITExecutor::update_args() {
         do_dimshuffle();
     }
 
+    //! bit mask of the output axes which are reduced
+    uint32_t reduced_axes = 0;
     if (m_compiler->property().contain_flag(CPFlag::NEED_INPUT_COLLAPSE)) {
         // collective collapse datum layout, try to reduce the output ndim
         opr::Elemwise::TensorLayoutPtrArray inp_layouts;
@@ -254,8 +256,23 @@ void JITExecutor::update_args() {
                 inp_layouts.push_back(&m_args.inputs[i].layout);
             }
         }
-        opr::Elemwise::broadcast_collective_collapse(
-                inp_layouts, &m_args.outputs[0].layout);
+        auto&& out_layout = m_args.outputs[0].layout;
+        if (has_reduce() && (m_compiler->property().feature_bits &
+                             JITFeatureBits::REDUCE)) {
+            // the inputs are broadcast to the shape before reduce, and so is
+            // the output, whose zero strides then mark the reduced axes
+            TensorLayout before_reduce{broadcasted_input_shape(), out_layout.dtype};
+            out_layout = out_layout.broadcast(before_reduce);
+            inp_layouts.push_back(&out_layout);
+            opr::Elemwise::broadcast_collective_collapse(inp_layouts, &before_reduce);
+            for (size_t i = 0; i < out_layout.ndim; ++i) {
+                if (!out_layout.stride[i] && out_layout.shape[i] > 1) {
+                    reduced_axes |= 1u << i;
+                }
+            }
+        } else {
+            opr::Elemwise::broadcast_collective_collapse(inp_layouts, &out_layout);
+        }
     }
 
     // compute and update hash
@@ -270,6 +287,7 @@ void JITExecutor::update_args() {
         std::vector<size_t> buf;
         buf.reserve(1024);
         buf.push_back(m_args.inputs.size());
+        buf.push_back(reduced_axes);
         for (auto&& i : m_args.inputs) {
             buf.push_back(i.layout.ndim);
             if (prop.contain_flag(CPFlag::BIND_SHAPE)) {
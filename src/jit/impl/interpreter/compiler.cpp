@@ -0,0 +1,27 @@
+/**
+ * \file src/jit/impl/interpreter/compiler.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./compiler.h"
+#include "./executable.h"
+
+#if MGB_JIT
+
+using namespace mgb;
+using namespace jit;
+
+std::unique_ptr<Executable> InterpreterCompiler::do_compile(
+        const InternalGraph& graph, const JITExecutor::Args& args) {
+    return std::make_unique<InterpreterExecutable>(graph, args);
+}
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
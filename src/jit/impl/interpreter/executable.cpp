@@ -0,0 +1,585 @@
+/**
+ * \file src/jit/impl/interpreter/executable.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./executable.h"
+
+#include "megbrain/comp_node_env.h"
+#include "megbrain/jit/placeholder_opr.h"
+#include "megbrain/opr/basic_arith.h"
+#include "megbrain/opr/tensor_manip.h"
+#include "megbrain/utils/arith_helper.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if MGB_JIT
+
+using namespace mgb;
+using namespace jit;
+
+namespace {
+
+using Mode = opr::Elemwise::Mode;
+using Kern = InterpreterExecutable::Kern;
+constexpr size_t BLOCK_SIZE = InterpreterExecutable::BLOCK_SIZE;
+
+//! minimal number of output elements of each thread
+constexpr size_t MIN_ELEMS_PER_TASK = 16384;
+
+/* ======================= elemwise kernels ======================= */
+
+inline float log_sum_exp(float x, float y) {
+    float a = std::max(x, y), b = std::min(x, y);
+    return a + log1pf(expf(b - a));
+}
+
+inline float h_swish(float x) {
+    return x * std::min(std::max(x + 3.f, 0.f), 6.f) * (1.f / 6.f);
+}
+
+// the expressions follow megdnn elemwise kernels
+#define FOREACH_UNARY_MODE(cb)           \
+    cb(RELU, x <= 0.f ? 0.f : x);        \
+    cb(ABS, fabsf(x));                   \
+    cb(ACOS, acosf(x));                  \
+    cb(ASIN, asinf(x));                  \
+    cb(CEIL, ceilf(x));                  \
+    cb(COS, cosf(x));                    \
+    cb(EXP, expf(x));                    \
+    cb(EXPM1, expm1f(x));                \
+    cb(FLOOR, floorf(x));                \
+    cb(LOG, logf(x));                    \
+    cb(LOG1P, log1pf(x));                \
+    cb(NEGATE, -x);                      \
+    cb(SIGMOID, 1.f / (expf(-x) + 1.f)); \
+    cb(SIN, sinf(x));                    \
+    cb(TANH, tanhf(x));                  \
+    cb(ERF, erff(x));                    \
+    cb(ERFC, erfcf(x));                  \
+    cb(H_SWISH, h_swish(x));
+
+#define FOREACH_BINARY_MODE(cb)                                                   \
+    cb(ABS_GRAD, x > 0.f ? y : -y);                                               \
+    cb(ADD, x + y);                                                               \
+    cb(FLOOR_DIV, floorf(x / y));                                                 \
+    cb(MAX, x > y ? x : y);                                                       \
+    cb(MIN, x < y ? x : y);                                                       \
+    cb(MOD, fmodf(x, y));                                                         \
+    cb(MUL, x* y);                                                                \
+    cb(POW, powf(x, y));                                                          \
+    cb(SIGMOID_GRAD, x*(1.f - x) * y);                                            \
+    cb(SUB, x - y);                                                               \
+    cb(SWITCH_GT0, x > 0.f ? y : 0.f);                                            \
+    cb(TANH_GRAD, (1.f - x * x) * y);                                             \
+    cb(TRUE_DIV, x / y);                                                          \
+    cb(LOG_SUM_EXP, log_sum_exp(x, y));                                           \
+    cb(LT, x < y);                                                                \
+    cb(LEQ, x <= y);                                                              \
+    cb(EQ, x == y);                                                               \
+    cb(ATAN2, atan2f(x, y));                                                      \
+    cb(H_SWISH_GRAD, x < -3.f ? 0.f : (x > 3.f ? y : (2.f * x + 3.f) / 6.f * y)); \
+    cb(FUSE_ADD_RELU, (x + y) <= 0.f ? 0.f : (x + y));                            \
+    cb(FUSE_ADD_SIGMOID, 1.f / (expf(-(x + y)) + 1.f));                           \
+    cb(FUSE_ADD_TANH, tanhf(x + y));                                              \
+    cb(FUSE_ADD_H_SWISH, h_swish(x + y));
+
+#define FOREACH_TERNARY_MODE(cb)        \
+    cb(COND_LEQ_MOV, x <= y ? z : 0.f); \
+    cb(FUSE_MUL_ADD3, x* y + z);
+
+#define FOREACH_QUATERNARY_MODE(cb) cb(FUSE_MUL_ADD4, x* y + z * w);
+
+template <Mode mode>
+struct ElemOp;
+
+#define DEF_OP(_mode, _arity, _args, _expr)               \
+    template <>                                           \
+    struct ElemOp<Mode::_mode> {                          \
+        static constexpr int arity = _arity;              \
+        static inline float apply _args { return _expr; } \
+    }
+
+#define cb(_mode, _expr...) DEF_OP(_mode, 1, (float x), _expr)
+FOREACH_UNARY_MODE(cb)
+#undef cb
+#define cb(_mode, _expr...) DEF_OP(_mode, 2, (float x, float y), _expr)
+FOREACH_BINARY_MODE(cb)
+#undef cb
+#define cb(_mode, _expr...) DEF_OP(_mode, 3, (float x, float y, float z), _expr)
+FOREACH_TERNARY_MODE(cb)
+#undef cb
+#define cb(_mode, _expr...)                                       \
+    DEF_OP(_mode, 4, (float x, float y, float z, float w), _expr)
+FOREACH_QUATERNARY_MODE(cb)
+#undef cb
+#undef DEF_OP
+
+/*!
+ * \brief kernel of an elemwise op
+ *
+ * The loops are simple enough to be vectorized by the compiler; dst may be
+ * the same as one of src.
+ */
+template <typename Op, int arity = Op::arity>
+struct ElemKern;
+
+template <typename Op>
+struct ElemKern<Op, 1> {
+    static void run(size_t n, float* dst, const float* const* src, float) {
+        auto x = src[0];
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = Op::apply(x[i]);
+        }
+    }
+};
+
+template <typename Op>
+struct ElemKern<Op, 2> {
+    static void run(size_t n, float* dst, const float* const* src, float) {
+        auto x = src[0], y = src[1];
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = Op::apply(x[i], y[i]);
+        }
+    }
+};
+
+template <typename Op>
+struct ElemKern<Op, 3> {
+    static void run(size_t n, float* dst, const float* const* src, float) {
+        auto x = src[0], y = src[1], z = src[2];
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = Op::apply(x[i], y[i], z[i]);
+        }
+    }
+};
+
+template <typename Op>
+struct ElemKern<Op, 4> {
+    static void run(size_t n, float* dst, const float* const* src, float) {
+        auto x = src[0], y = src[1], z = src[2], w = src[3];
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = Op::apply(x[i], y[i], z[i], w[i]);
+        }
+    }
+};
+
+std::pair<Kern, int> get_elem_kern(Mode mode) {
+    switch (mode) {
+#define cb(_mode, _expr...)                         \
+    case Mode::_mode:                               \
+        return {ElemKern<ElemOp<Mode::_mode>>::run, \
+                ElemOp<Mode::_mode>::arity};
+        FOREACH_UNARY_MODE(cb)
+        FOREACH_BINARY_MODE(cb)
+        FOREACH_TERNARY_MODE(cb)
+        FOREACH_QUATERNARY_MODE(cb)
+#undef cb
+        default:
+            mgb_throw(
+                    InternalError, "unsupported elemwise mode %d in JIT interpreter",
+                    static_cast<int>(mode));
+    }
+}
+
+#undef FOREACH_UNARY_MODE
+#undef FOREACH_BINARY_MODE
+#undef FOREACH_TERNARY_MODE
+#undef FOREACH_QUATERNARY_MODE
+
+/* ======================= PowC kernels ======================= */
+
+template <typename Op>
+void powc_kern(size_t n, float* dst, const float* const* src, float exp) {
+    auto x = src[0];
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = Op::apply(x[i], exp);
+    }
+}
+
+struct PowCZero {
+    static inline float apply(float, float) { return 1.f; }
+};
+struct PowCOne {
+    static inline float apply(float x, float) { return x; }
+};
+struct PowCSqr {
+    static inline float apply(float x, float) { return x * x; }
+};
+struct PowCCube {
+    static inline float apply(float x, float) { return x * x * x; }
+};
+struct PowCSqrt {
+    static inline float apply(float x, float) { return sqrtf(x); }
+};
+struct PowCCbrt {
+    static inline float apply(float x, float) { return cbrtf(x); }
+};
+struct PowCOddInt {
+    static inline float apply(float x, float exp) {
+        return copysignf(powf(fabsf(x), exp), x);
+    }
+};
+struct PowCEvenInt {
+    static inline float apply(float x, float exp) { return powf(fabsf(x), exp); }
+};
+struct PowCGeneric {
+    static inline float apply(float x, float exp) { return powf(x, exp); }
+};
+
+//! kernel and whether the result should be inverted
+std::pair<Kern, bool> get_powc_kern(float exp) {
+    auto eq = [](float x, float y) { return std::abs(x - y) < 1e-6f; };
+    float abs_exp = std::abs(exp);
+    bool neg = exp < 0;
+    if (eq(abs_exp, 0.f)) {
+        return {powc_kern<PowCZero>, false};
+    }
+    if (eq(abs_exp, 1.f)) {
+        return {powc_kern<PowCOne>, neg};
+    }
+    if (eq(abs_exp, 2.f)) {
+        return {powc_kern<PowCSqr>, neg};
+    }
+    if (eq(abs_exp, 3.f)) {
+        return {powc_kern<PowCCube>, neg};
+    }
+    if (eq(abs_exp, .5f)) {
+        return {powc_kern<PowCSqrt>, neg};
+    }
+    if (eq(abs_exp, 1.f / 3.f)) {
+        return {powc_kern<PowCCbrt>, neg};
+    }
+    int exp_i = std::round(exp);
+    if (eq(static_cast<float>(exp_i), exp)) {
+        if (exp_i & 1) {
+            return {powc_kern<PowCOddInt>, false};
+        }
+        return {powc_kern<PowCEvenInt>, false};
+    }
+    return {powc_kern<PowCGeneric>, false};
+}
+
+void copy_kern(size_t n, float* dst, const float* const* src, float) {
+    memcpy(dst, src[0], sizeof(float) * n);
+}
+
+void inv_kern(size_t n, float* dst, const float* const* src, float) {
+    auto x = src[0];
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = 1.f / x[i];
+    }
+}
+
+/* ======================= load and store ======================= */
+
+template <typename ctype>
+void load_elems(const ctype* ptr, ptrdiff_t stride, size_t n, float* dst) {
+    if (stride == 1) {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = ptr[i];
+        }
+    } else if (!stride) {
+        std::fill_n(dst, n, static_cast<float>(ptr[0]));
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = ptr[i * stride];
+        }
+    }
+}
+
+template <typename ctype>
+void store_elems(ctype* ptr, ptrdiff_t stride, size_t n, const float* src) {
+    if (stride == 1) {
+        for (size_t i = 0; i < n; ++i) {
+            ptr[i] = static_cast<ctype>(src[i]);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            ptr[i * stride] = static_cast<ctype>(src[i]);
+        }
+    }
+}
+
+#define FOREACH_FLOAT_DTYPE(cb)                                            \
+    cb(Float32) DNN_INC_FLOAT16(cb(Float16)) DNN_INC_FLOAT16(cb(BFloat16))
+
+//! load n elements at given element offset of a tensor
+void load(const megdnn::TensorND& tensor, ptrdiff_t offset, size_t n, float* dst) {
+    auto stride = tensor.layout.stride[tensor.layout.ndim - 1];
+    switch (tensor.layout.dtype.enumv()) {
+#define cb(_dt)                                                               \
+    case DTypeTrait<dtype::_dt>::enumv:                                       \
+        return load_elems(                                                    \
+                tensor.ptr<DTypeTrait<dtype::_dt>::ctype>() + offset, stride, \
+                n, dst);
+        FOREACH_FLOAT_DTYPE(cb)
+#undef cb
+        default:
+            mgb_throw(
+                    InternalError, "unsupported dtype %s in JIT interpreter",
+                    tensor.layout.dtype.name());
+    }
+}
+
+void store(
+        const megdnn::TensorND& tensor, ptrdiff_t offset, size_t n, const float* src) {
+    auto stride = tensor.layout.stride[tensor.layout.ndim - 1];
+    switch (tensor.layout.dtype.enumv()) {
+#define cb(_dt)                                                               \
+    case DTypeTrait<dtype::_dt>::enumv:                                       \
+        return store_elems(                                                   \
+                tensor.ptr<DTypeTrait<dtype::_dt>::ctype>() + offset, stride, \
+                n, src);
+        FOREACH_FLOAT_DTYPE(cb)
+#undef cb
+        default:
+            mgb_throw(
+                    InternalError, "unsupported dtype %s in JIT interpreter",
+                    tensor.layout.dtype.name());
+    }
+}
+
+#undef FOREACH_FLOAT_DTYPE
+
+//! element offset of given row, i.e. index on all axes but the last one
+ptrdiff_t get_row_offset(const TensorLayout& layout, size_t row) {
+    ptrdiff_t offset = 0;
+    for (int i = static_cast<int>(layout.ndim) - 2; i >= 0; --i) {
+        offset += static_cast<ptrdiff_t>(row % layout.shape[i]) * layout.stride[i];
+        row /= layout.shape[i];
+    }
+    return offset;
+}
+
+}  // anonymous namespace
+
+/* ======================= InterpreterExecutable ======================= */
+
+constexpr size_t InterpreterExecutable::BLOCK_SIZE;
+
+InterpreterExecutable::InterpreterExecutable(
+        const InternalGraph& graph, const JITExecutor::Args& args) {
+    // first translate the graph into insts on values, and then allocate
+    // registers for the values
+    ThinHashMap<VarNode*, uint32_t> var2val;
+    std::vector<float> const_val;
+    std::vector<bool> is_const;
+    auto new_val = [&](VarNode* var, bool constant = false, float value = 0) {
+        uint32_t ret = is_const.size();
+        is_const.push_back(constant);
+        const_val.push_back(value);
+        var2val[var] = ret;
+        return ret;
+    };
+    auto get_val = [&](VarNode* var) {
+        auto iter = var2val.find(var);
+        mgb_assert(
+                iter != var2val.end(), "value of %s is unavailable in JIT interpreter",
+                var->cname());
+        return iter->second;
+    };
+    auto add_inst = [&](cg::OperatorNodeBase* opr, Kern kern, float param) {
+        Inst inst{false, static_cast<uint32_t>(opr->input().size()), 0, kern, param};
+        mgb_assert(inst.nr_src <= 4);
+        for (uint32_t i = 0; i < inst.nr_src; ++i) {
+            inst.src[i] = get_val(opr->input(i));
+        }
+        inst.dst = new_val(opr->output(0));
+        m_insts.push_back(inst);
+    };
+
+    cg::DepOprIter{[&](cg::OperatorNodeBase* opr) {
+        auto out = opr->output(0);
+        if (auto ph = opr->try_cast_final<JITPlaceholder>()) {
+            if (!ph->is_host_value_shape_input()) {
+                mgb_assert(ph->input_id() < args.inputs.size());
+                Inst inst{true, 0, ph->input_id(), nullptr, 0};
+                inst.dst = new_val(out);
+                m_insts.push_back(inst);
+            }
+            return;
+        }
+        auto imm = SymbolVar{out}.as_immutable_scalar();
+        if (imm.valid()) {
+            new_val(out, true, imm->get_cast<float>());
+            return;
+        }
+        if (opr->same_type<opr::TypeCvt>() || opr->same_type<opr::Reduce>() ||
+            opr->same_type<opr::GetVarShape>() || opr->same_type<opr::Dimshuffle>()) {
+            // values are converted to float on load and converted back on
+            // store; others occur in grad or have been applied to the input
+            // layouts, as in the other compilers
+            auto iter = var2val.find(opr->input(0));
+            if (iter != var2val.end()) {
+                var2val[out] = iter->second;
+            }
+            return;
+        }
+        if (auto elem = opr->try_cast_final<opr::Elemwise>()) {
+            auto kern = get_elem_kern(elem->param().mode);
+            mgb_assert(static_cast<size_t>(kern.second) == opr->input().size());
+            add_inst(opr, kern.first, 0);
+            return;
+        }
+        if (auto powc = opr->try_cast_final<opr::PowC>()) {
+            float exp = powc->param().exp;
+            auto kern = get_powc_kern(exp);
+            add_inst(opr, kern.first, exp);
+            if (kern.second) {
+                Inst inst{false, 1, 0, inv_kern, 0};
+                inst.src[0] = m_insts.back().dst;
+                inst.dst = new_val(out);
+                m_insts.push_back(inst);
+            }
+            return;
+        }
+        mgb_throw(
+                InternalError, "unsupported opr in JIT interpreter: %s{%s}",
+                opr->cname(), opr->dyn_typeinfo()->name);
+    }}.add(graph.output());
+
+    uint32_t out_val = get_val(graph.output());
+    if (is_const[out_val]) {
+        // make sure that the output is written by an inst
+        Inst inst{false, 1, 0, copy_kern, 0};
+        inst.src[0] = out_val;
+        inst.dst = new_val(graph.output());
+        out_val = inst.dst;
+        m_insts.push_back(inst);
+    }
+
+    size_t nr_val = is_const.size();
+    std::vector<size_t> last_use(nr_val, 0);
+    for (size_t i = 0; i < m_insts.size(); ++i) {
+        for (uint32_t j = 0; j < m_insts[i].nr_src; ++j) {
+            last_use[m_insts[i].src[j]] = i;
+        }
+    }
+    last_use[out_val] = m_insts.size();
+
+    std::vector<uint32_t> val2reg(nr_val), free_regs;
+    for (size_t i = 0; i < nr_val; ++i) {
+        if (is_const[i]) {
+            val2reg[i] = m_nr_reg++;
+            m_consts.emplace_back(val2reg[i], const_val[i]);
+        }
+    }
+    for (size_t i = 0; i < m_insts.size(); ++i) {
+        auto&& inst = m_insts[i];
+        for (uint32_t j = 0; j < inst.nr_src; ++j) {
+            auto val = inst.src[j];
+            inst.src[j] = val2reg[val];
+            // the register of a dead src can be reused by dst
+            if (!is_const[val] && last_use[val] == i &&
+                std::find(inst.src, inst.src + j, inst.src[j]) == inst.src + j) {
+                free_regs.push_back(inst.src[j]);
+            }
+        }
+        auto val = inst.dst;
+        if (free_regs.empty()) {
+            val2reg[val] = m_nr_reg++;
+        } else {
+            val2reg[val] = free_regs.back();
+            free_regs.pop_back();
+        }
+        inst.dst = val2reg[val];
+    }
+    m_out_reg = val2reg[out_val];
+}
+
+void InterpreterExecutable::run_units(
+        const megdnn::TensorNDArray& tensors, size_t begin, size_t end) const {
+    std::unique_ptr<float[]> regs{new float[m_nr_reg * BLOCK_SIZE]};
+    for (auto&& i : m_consts) {
+        std::fill_n(regs.get() + i.first * BLOCK_SIZE, BLOCK_SIZE, i.second);
+    }
+
+    auto&& out_layout = tensors.back().layout;
+    size_t row_len = out_layout.shape[out_layout.ndim - 1],
+           nr_blk = divup(row_len, BLOCK_SIZE);
+    SmallVector<ptrdiff_t> row_offset(tensors.size());
+    for (size_t unit = begin; unit < end;) {
+        size_t row = unit / nr_blk, blk = unit % nr_blk;
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            if (tensors[i].raw_ptr) {
+                row_offset[i] = get_row_offset(tensors[i].layout, row);
+            }
+        }
+        for (; blk < nr_blk && unit < end; ++blk, ++unit) {
+            size_t col = blk * BLOCK_SIZE, n = std::min(BLOCK_SIZE, row_len - col);
+            auto col_offset = [&](size_t i) {
+                auto&& layout = tensors[i].layout;
+                return row_offset[i] +
+                       static_cast<ptrdiff_t>(col) * layout.stride[layout.ndim - 1];
+            };
+            for (auto&& inst : m_insts) {
+                float* dst = regs.get() + inst.dst * BLOCK_SIZE;
+                if (inst.is_load) {
+                    load(tensors[inst.input], col_offset(inst.input), n, dst);
+                } else {
+                    const float* src[4];
+                    for (uint32_t i = 0; i < inst.nr_src; ++i) {
+                        src[i] = regs.get() + inst.src[i] * BLOCK_SIZE;
+                    }
+                    inst.kern(n, dst, src, inst.param);
+                }
+            }
+            store(tensors.back(), col_offset(tensors.size() - 1), n,
+                  regs.get() + m_out_reg * BLOCK_SIZE);
+        }
+    }
+}
+
+void InterpreterExecutable::execute(JITExecutor* fusion_opr) {
+    auto&& args = fusion_opr->args();
+    mgb_assert(args.outputs.size() == 1);
+    auto&& out = args.outputs[0];
+    size_t nr_elems = out.layout.total_nr_elems();
+    if (!nr_elems) {
+        return;
+    }
+
+    megdnn::TensorNDArray tensors(args.inputs.size() + 1);
+    for (size_t i = 0; i < args.inputs.size(); ++i) {
+        auto&& inp = args.inputs[i];
+        if (inp.layout.dtype.valid()) {
+            tensors[i] = {inp.from->dev_tensor().raw_ptr(), inp.layout};
+            mgb_assert(inp.layout.ndim == out.layout.ndim);
+        } else {
+            // shape-only input
+            tensors[i].raw_ptr = nullptr;
+        }
+    }
+    tensors.back() = {out.from->dev_tensor().raw_ptr(), out.layout};
+
+    size_t row_len = out.layout.shape[out.layout.ndim - 1],
+           nr_unit = nr_elems / row_len * divup(row_len, BLOCK_SIZE);
+    auto&& env = CompNodeEnv::from_comp_node(fusion_opr->comp_node()).cpu_env();
+    size_t nr_task = std::min<size_t>(
+            {env.dispatcher->nr_threads(), divup(nr_elems, MIN_ELEMS_PER_TASK),
+             nr_unit});
+    if (nr_task <= 1) {
+        env.dispatch([this, tensors, nr_unit]() { run_units(tensors, 0, nr_unit); });
+        return;
+    }
+    size_t unit_per_task = divup(nr_unit, nr_task);
+    env.dispatch(
+            [this, tensors, nr_unit, unit_per_task](size_t task, size_t) {
+                size_t begin = task * unit_per_task;
+                run_units(
+                        tensors, begin, std::min(nr_unit, begin + unit_per_task));
+            },
+            divup(nr_unit, unit_per_task));
+}
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
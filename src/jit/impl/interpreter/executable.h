@@ -0,0 +1,79 @@
+/**
+ * \file src/jit/impl/interpreter/executable.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain_build_config.h"
+
+#if MGB_JIT
+
+#include "megbrain/jit/compiler.h"
+
+namespace mgb {
+namespace jit {
+
+/*!
+ * \brief Executable that interprets an elemwise program on CPU
+ *
+ * Each value in the internal graph is assigned a register holding BLOCK_SIZE
+ * floats, and registers are reused once their values are dead. The output is
+ * computed block by block, so the intermediate values never leave the cache.
+ */
+class InterpreterExecutable final : public Executable {
+public:
+    //! number of elements processed at a time
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    //! compute \p n values of \p dst; \p param is the exponent for PowC
+    using Kern = void (*)(size_t n, float* dst, const float* const* src, float param);
+
+    InterpreterExecutable(const InternalGraph& graph, const JITExecutor::Args& args);
+
+    void execute(JITExecutor* fusion_opr) override final;
+
+    //! number of registers needed by the program
+    size_t nr_reg() const { return m_nr_reg; }
+
+private:
+    struct Inst {
+        //! load input into dst, or apply kern on src
+        bool is_load;
+        uint32_t nr_src;
+        //! index of the input to be loaded
+        size_t input;
+        Kern kern;
+        float param;
+        uint32_t dst, src[4];
+    };
+
+    std::vector<Inst> m_insts;
+    //! registers filled with scalar constants
+    std::vector<std::pair<uint32_t, float>> m_consts;
+    uint32_t m_out_reg = 0, m_nr_reg = 0;
+
+    /*!
+     * \brief compute output elements in units [begin, end)
+     *
+     * A unit is a block of at most BLOCK_SIZE elements in a row along the last
+     * axis of the collapsed output layout.
+     *
+     * \param tensors the inputs followed by the output
+     */
+    void run_units(
+            const megdnn::TensorNDArray& tensors, size_t begin, size_t end) const;
+};
+
+}  // namespace jit
+}  // namespace mgb
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -22,6 +22,8 @@
 #include "megbrain/comp_node_env.h"
 #include "megbrain/jit/mlir/ir/dialect.h"
 #include "megbrain/jit/mlir/ir/passes.h"
+#include "megbrain/utils/arith_helper.h"
+#include "megbrain/utils/persistent_cache.h"
 #include "megbrain/utils/timer.h"
 
 #include <mlir/Conversion/GPUCommon/GPUCommonPass.h>
@@ -38,6 +40,7 @@
 #include <mlir/Target/NVVMIR.h>
 #include <mlir/Transforms/Passes.h>
 
+#include <llvm/Config/llvm-config.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Linker/Linker.h>
 #include <llvm/Pass.h>
@@ -126,6 +129,29 @@ std::unique_ptr<llvm::Module> translate_module_to_nvvm_ir_and_link_device(
 
 #endif
 
+//! minimal number of elements computed by each thread on CPU
+constexpr size_t CPU_MIN_ELEMS_PER_TASK = 16384;
+
+/*!
+ * \brief number of leading rows of the output computed by each thread on CPU
+ *
+ * Return 0 if the kernel should run on the whole output in one thread. The
+ * inputs of dimshuffles are not partitioned along the rows of the output, so
+ * they are not split.
+ */
+size_t get_cpu_nr_rows(const JITExecutor::Args& args) {
+    auto&& out_layout = args.outputs[0].from->layout();
+    auto&& env = CompNodeEnv::from_comp_node(args.owner->comp_node()).cpu_env();
+    size_t nr_elems = out_layout.total_nr_elems();
+    if (!nr_elems || args.owner->has_dimshuffle()) {
+        return 0;
+    }
+    size_t nr_task = std::min<size_t>(
+            {env.dispatcher->nr_threads(), out_layout.shape[0],
+             divup(nr_elems, CPU_MIN_ELEMS_PER_TASK)});
+    return nr_task <= 1 ? 0 : divup(out_layout.shape[0], nr_task);
+}
+
 void add_cpu_lowering_pass(mlir::PassManager& manager) {
     {
         mlir::OpPassManager& opt_pm = manager.nest<mlir::FuncOp>();
@@ -220,17 +246,61 @@ std::unique_ptr<Executable> MLIRCompiler::do_compile(
     ctx.printStackTraceOnDiagnostic(true);
     ctx.printOpOnDiagnostic(true);
 
-    auto&& res = mlir_gen(ctx, graph, args);
+    CompNode cn = args.owner->comp_node();
+    size_t nr_rows = 0;
+    if (cn.device_type() == CompNode::DeviceType::CPU) {
+        nr_rows = get_cpu_nr_rows(args);
+    }
+    auto&& res = mlir_gen(ctx, graph, args, nr_rows);
     mgb_assert(res.second, "failed to generate module");
 
-    CompNode cn = args.owner->comp_node();
+#if MGB_CUDA
+    // the kernels on CUDA are cached by the generated module before lowering,
+    // which contains the internal graph and the layouts of the args
+    std::string cache_category, module_str;
+    if (cn.device_type() == CompNode::DeviceType::CUDA) {
+        llvm::raw_string_ostream os{module_str};
+        res.second->print(os);
+        os.flush();
+        cache_category = "jit:mlir:" +
+                         PersistentCache::make_category_from_comp_node(cn) +
+                         ";llvm=" LLVM_VERSION_STRING;
+        auto cached = PersistentCache::inst().get(
+                cache_category, {module_str.data(), module_str.size()});
+        if (cached.valid()) {
+            mgb_log("MLIR JIT: load %s from persistent cache",
+                    res.first.str().c_str());
+            return std::make_unique<MLIRCUDAExecutable>(
+                    std::string{static_cast<const char*>(cached->ptr), cached->size},
+                    res.first.str());
+        }
+    }
+#endif
     run_lowering_pass(res.second, cn);
     switch (cn.device_type()) {
-        case CompNode::DeviceType::CPU:
-            return std::make_unique<MLIRCPUExecutable>(res.second, res.first.str());
+        case CompNode::DeviceType::CPU: {
+            auto ret = std::make_unique<MLIRCPUExecutable>(
+                    res.second, res.first.str(), nr_rows);
+            size_t nr_tail_rows =
+                    nr_rows ? args.outputs[0].from->shape()[0] % nr_rows : 0;
+            if (nr_tail_rows) {
+                auto&& tail = mlir_gen(ctx, graph, args, nr_tail_rows);
+                mgb_assert(tail.second, "failed to generate module");
+                run_lowering_pass(tail.second, cn);
+                ret->set_tail_kernel(tail.second, tail.first.str());
+            }
+            return ret;
+        }
 #if MGB_CUDA
-        case CompNode::DeviceType::CUDA:
-            return std::make_unique<MLIRCUDAExecutable>(res.second, res.first.str());
+        case CompNode::DeviceType::CUDA: {
+            auto ret = std::make_unique<MLIRCUDAExecutable>(
+                    res.second, res.first.str());
+            auto&& data = ret->kernel_data();
+            PersistentCache::inst().put(
+                    cache_category, {module_str.data(), module_str.size()},
+                    {data.data(), data.size()});
+            return ret;
+        }
 #endif
         default:
             mgb_throw(
@@ -15,12 +15,18 @@
 
 #include "./executable_cpu.h"
 #include "./ir/types.h"
+#include "./mlir_gen.h"
 
+#include "megbrain/comp_node_env.h"
 #include "megbrain/jit/mlir/ir/utils.h"
+#include "megbrain/utils/arith_helper.h"
 
 #include <mlir/ExecutionEngine/CRunnerUtils.h>
 #include <mlir/ExecutionEngine/OptUtils.h>
 
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/Target/TargetMachine.h>
+
 using namespace mgb;
 using namespace jit;
 
@@ -72,62 +78,132 @@ void* tensor2memref(const megdnn::TensorND& tensor) {
     }
 }
 
+/*!
+ * \brief run the kernel on the rows [begin, begin + nr_rows) of the output
+ *
+ * The row partitioned tensors are offset to the first row, and the other
+ * tensors are passed as they are. nr_rows is zero if the kernel is generated
+ * for the whole output.
+ */
+void run_kernel(
+        void (*func)(void**), const megdnn::TensorNDArray& tensors,
+        const TensorLayout& out_layout, size_t begin, size_t nr_rows) {
+    std::vector<void*> memrefs(tensors.size());
+    std::vector<void*> params(tensors.size());
+    for (size_t i = 0; i < tensors.size(); i++) {
+        megdnn::TensorND tensor = tensors[i];
+        if (nr_rows && is_row_partitioned(tensor.layout, out_layout)) {
+            tensor.raw_ptr = static_cast<dt_byte*>(tensor.raw_ptr) +
+                             tensor.layout.dtype.size(begin * tensor.layout.stride[0]);
+            tensor.layout.shape[0] = nr_rows;
+        }
+        memrefs[i] = tensor2memref(tensor);
+        params[i] = &memrefs[i];
+    }
+    int64_t nr_elements = out_layout.total_nr_elems();
+    if (nr_rows) {
+        nr_elements = nr_elements / out_layout.shape[0] * nr_rows;
+    }
+    int64_t nr_threads = 1;
+    params.push_back(&nr_elements);
+    params.push_back(&nr_threads);
+    func(params.data());
+    for (auto&& memref : memrefs) {
+        free(memref);
+    }
+}
+
 }  // namespace
+
 MLIRCPUExecutable::MLIRCPUExecutable(
-        mlir::OwningModuleRef& module, const std::string& kernel_name)
-        : m_kernel_name{kernel_name} {
-    auto opt_pipeline = mlir::makeOptimizingTransformer(3, 3, 0);
+        mlir::OwningModuleRef& module, const std::string& kernel_name,
+        size_t nr_rows)
+        : m_kernel{create_kernel(module, kernel_name)},
+          m_kernel_name{kernel_name},
+          m_nr_rows{nr_rows} {}
+
+void MLIRCPUExecutable::set_tail_kernel(
+        mlir::OwningModuleRef& module, const std::string& kernel_name) {
+    m_tail_kernel = create_kernel(module, kernel_name);
+}
+
+MLIRCPUExecutable::Kernel MLIRCPUExecutable::create_kernel(
+        mlir::OwningModuleRef& module, const std::string& kernel_name) {
+    // the loop and slp vectorizers of llvm are only enabled with a size level
+    // of 0, and need the target machine of the host to choose the vector width
+    auto tm_builder = llvm::orc::JITTargetMachineBuilder::detectHost();
+    mgb_assert(tm_builder, "failed to detect the host target");
+    auto tm = tm_builder->createTargetMachine();
+    mgb_assert(tm, "failed to create the target machine of the host");
+    auto opt_pipeline = mlir::makeOptimizingTransformer(3, 0, tm->get());
     std::vector<std::string> libs;
     auto&& engine = mlir::ExecutionEngine::create(
             *module, nullptr, opt_pipeline, llvm::None,
             std::vector<llvm::StringRef>(libs.begin(), libs.end()), true, false);
     mgb_assert(engine);
-    m_engine = std::move(*engine);
+
+    Kernel ret;
+    ret.engine = std::move(*engine);
+    // lookup once here, as the kernel is called by several threads at the
+    // same time
+    auto func = ret.engine->lookup(std::string("_mlir_ciface_") + kernel_name);
+    if (!func) {
+        llvm::consumeError(func.takeError());
+        mgb_throw(
+                InternalError, "failed to lookup MLIR kernel %s", kernel_name.c_str());
+    }
+    ret.func = *func;
+    return ret;
 }
 
 void MLIRCPUExecutable::execute(JITExecutor* fusion_opr) {
     auto&& args = fusion_opr->args();
-    std::vector<void*> args_array(args.inputs.size() + args.outputs.size());
-    std::vector<void*> args_array_pointer(args.inputs.size() + args.outputs.size());
-    size_t idx = 0;
-    for (size_t i = 0; i < args.inputs.size(); i++) {
-        args_array[idx] = tensor2memref(
-                {args.inputs[i].from->dev_tensor().raw_ptr(), args.inputs[i].layout});
-        args_array_pointer[idx] = &args_array[idx];
-        idx++;
+    megdnn::TensorNDArray tensors;
+    for (auto&& arg : args.inputs) {
+        tensors.push_back({arg.from->dev_tensor().raw_ptr(), arg.layout});
     }
-    int64_t nr_elements = 0;
-    for (size_t i = 0; i < args.outputs.size(); i++) {
+    size_t nr_elements = 0;
+    for (auto&& arg : args.outputs) {
         if (nr_elements == 0) {
-            nr_elements = args.outputs[i].layout.total_nr_elems();
+            nr_elements = arg.layout.total_nr_elems();
         } else {
             mgb_assert(
-                    static_cast<size_t>(nr_elements) ==
-                            args.outputs[i].layout.total_nr_elems(),
+                    nr_elements == arg.layout.total_nr_elems(),
                     "The number of elements of outputs mismatch, expected: "
                     "%zu got: %zu(%s)",
-                    static_cast<size_t>(nr_elements),
-                    args.outputs[i].layout.total_nr_elems(),
-                    args.outputs[i].layout.to_string().c_str());
+                    nr_elements, arg.layout.total_nr_elems(),
+                    arg.layout.to_string().c_str());
         }
-        args_array[idx] = tensor2memref(
-                {args.outputs[i].from->dev_tensor().raw_ptr(), args.outputs[i].layout});
-        args_array_pointer[idx] = &args_array[idx];
-        idx++;
-    }
-
-    args_array_pointer.push_back(&nr_elements);
-    std::string adapter_name = std::string("_mlir_ciface_") + m_kernel_name;
-    auto err = m_engine->invoke(
-            adapter_name, llvm::MutableArrayRef<void*>(args_array_pointer));
-    if (err) {
-        mgb_throw(
-                InternalError, "failed to run MLIR kernel %s\n", m_kernel_name.c_str());
+        tensors.push_back({arg.from->dev_tensor().raw_ptr(), arg.layout});
     }
 
-    for (size_t i = 0; i < args_array.size(); i++) {
-        free(args_array[i]);
+    auto&& env = CompNodeEnv::from_comp_node(fusion_opr->comp_node()).cpu_env();
+    TensorLayout out_layout = args.outputs[0].layout;
+    auto func = m_kernel.func;
+    if (!m_nr_rows) {
+        env.dispatch([func, tensors, out_layout]() {
+            run_kernel(func, tensors, out_layout, 0, 0);
+        });
+        return;
     }
+    size_t nr_rows = m_nr_rows, nr_total_rows = out_layout.shape[0];
+    auto tail_func = m_tail_kernel.func;
+    mgb_assert(
+            nr_total_rows % nr_rows == 0 || tail_func,
+            "no tail kernel for %zu rows in chunks of %zu", nr_total_rows, nr_rows);
+    env.dispatch(
+            [func, tail_func, tensors, out_layout, nr_rows, nr_total_rows](
+                    size_t chunk, size_t) {
+                size_t begin = chunk * nr_rows;
+                if (begin + nr_rows <= nr_total_rows) {
+                    run_kernel(func, tensors, out_layout, begin, nr_rows);
+                } else {
+                    run_kernel(
+                            tail_func, tensors, out_layout, begin,
+                            nr_total_rows - begin);
+                }
+            },
+            divup(nr_total_rows, nr_rows));
 }
 
 MLIRCPUExecutable::~MLIRCPUExecutable() {}
@@ -25,12 +25,23 @@ namespace jit {
 
 /*!
  * \brief Executable class for MLIR
+ *
+ * If nr_rows is not zero, the kernel is generated for nr_rows leading rows of
+ * the output (see mlir_gen()), and the rows are split into chunks run by the
+ * threads of the cpu dispatcher. The remaining rows, if any, are computed by
+ * the tail kernel.
  */
 class MLIRCPUExecutable final : public Executable {
 public:
-    MLIRCPUExecutable(mlir::OwningModuleRef& module, const std::string& kernel_name);
+    MLIRCPUExecutable(
+            mlir::OwningModuleRef& module, const std::string& kernel_name,
+            size_t nr_rows = 0);
     ~MLIRCPUExecutable();
 
+    //! set the kernel computing the rows which do not fill a whole chunk
+    void set_tail_kernel(
+            mlir::OwningModuleRef& module, const std::string& kernel_name);
+
     /*!
      * \brief execute
      * A executable instance can be executed by one or more fusion_opr
@@ -38,8 +49,19 @@ public:
     void execute(JITExecutor* fusion_opr) override final;
 
 private:
-    std::unique_ptr<mlir::ExecutionEngine> m_engine;
+    using KernelFunc = void (*)(void**);
+
+    struct Kernel {
+        std::unique_ptr<mlir::ExecutionEngine> engine;
+        KernelFunc func = nullptr;
+    };
+
+    static Kernel create_kernel(
+            mlir::OwningModuleRef& module, const std::string& kernel_name);
+
+    Kernel m_kernel, m_tail_kernel;
     std::string m_kernel_name;
+    size_t m_nr_rows;
 };
 
 }  // namespace jit
@@ -31,8 +31,15 @@ namespace jit {
 class MLIRCUDAExecutable final : public Executable {
 public:
     MLIRCUDAExecutable(mlir::OwningModuleRef& module, const std::string& kernel_name);
+
+    //! construct from the kernel data of a lowered module, e.g. from cache
+    MLIRCUDAExecutable(std::string kernel_data, const std::string& kernel_name);
+
     ~MLIRCUDAExecutable();
 
+    //! the compiled kernel, which could be loaded by cuModuleLoadData()
+    const std::string& kernel_data() const { return m_kernel_data; }
+
     /*!
      * \brief execute
      * A executable instance can be executed by one or more fusion_opr
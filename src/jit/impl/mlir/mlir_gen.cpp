@@ -48,11 +48,12 @@ public:
     MLIRGenImpl(mlir::MLIRContext& context) : m_builder(&context) {}
 
     std::pair<llvm::StringRef, mlir::OwningModuleRef> gen(
-            const InternalGraph& internal_graph, const JITExecutor::Args& args) {
+            const InternalGraph& internal_graph, const JITExecutor::Args& args,
+            size_t nr_rows) {
         mlir::ModuleOp module = mlir::ModuleOp::create(m_builder.getUnknownLoc());
 
         //! Create main routine function
-        auto func_op = gen_func_op(internal_graph, args);
+        auto func_op = gen_func_op(internal_graph, args, nr_rows);
         module.push_back(func_op);
 
         if (mlir::failed(mlir::verify(module))) {
@@ -68,15 +69,25 @@ private:
     llvm::ScopedHashTable<mlir::StringRef, mlir::Value> m_symbol_table;
 
     mlir::FuncOp gen_func_op(
-            const InternalGraph& internal_graph, const JITExecutor::Args& args) {
+            const InternalGraph& internal_graph, const JITExecutor::Args& args,
+            size_t nr_rows) {
         llvm::ScopedHashTableScope<llvm::StringRef, mlir::Value> var_scope(
                 m_symbol_table);
+        auto&& out_layout = args.outputs[0].from->layout();
+        auto get_arg_type = [&](const TensorLayout& layout) {
+            if (nr_rows && is_row_partitioned(layout, out_layout)) {
+                TensorLayout rows_layout = layout;
+                rows_layout.shape[0] = nr_rows;
+                return get_type(rows_layout);
+            }
+            return get_type(layout);
+        };
         std::vector<mlir::Type> func_args;
         for (auto&& arg : args.inputs) {
-            func_args.push_back(get_type(arg.from->layout()));
+            func_args.push_back(get_arg_type(arg.from->layout()));
         }
         for (auto&& arg : args.outputs) {
-            func_args.push_back(get_type(arg.from->layout()));
+            func_args.push_back(get_arg_type(arg.from->layout()));
         }
         //! nr_elements
         func_args.push_back(m_builder.getIndexType());
@@ -241,10 +252,15 @@ private:
 };
 }  // namespace
 
+bool mgb::jit::is_row_partitioned(
+        const TensorLayout& layout, const TensorLayout& out_layout) {
+    return layout.ndim == out_layout.ndim && layout.shape[0] == out_layout.shape[0];
+}
+
 std::pair<llvm::StringRef, mlir::OwningModuleRef> mgb::jit::mlir_gen(
         mlir::MLIRContext& context, const mgb::jit::InternalGraph& internal_graph,
-        const mgb::jit::JITExecutor::Args& args) {
-    return MLIRGenImpl(context).gen(internal_graph, args);
+        const mgb::jit::JITExecutor::Args& args, size_t nr_rows) {
+    return MLIRGenImpl(context).gen(internal_graph, args, nr_rows);
 }
 
 #endif  // MGB_JIT && MGB_JIT_MLIR
@@ -30,11 +30,20 @@ namespace jit {
  * \param context mlir context
  * \param internal_graph internal graph used to generate mlir
  * \param args input args for the internal graph
+ * \param nr_rows if not zero, the kernel computes only nr_rows leading rows of
+ *      the output, and the row partitioned inputs are given in the same rows
  * \return A pair of {kernel_name, module}
  **/
 std::pair<llvm::StringRef, mlir::OwningModuleRef> mlir_gen(
         mlir::MLIRContext& context, const InternalGraph& internal_graph,
-        const JITExecutor::Args& args);
+        const JITExecutor::Args& args, size_t nr_rows = 0);
+
+/*!
+ * \brief whether a tensor is partitioned along with the rows of the output,
+ *      i.e. its axis 0 is the axis 0 of the output, over which the kernel
+ *      could be split
+ */
+bool is_row_partitioned(const TensorLayout& layout, const TensorLayout& out_layout);
 }  // namespace jit
 }  // namespace mgb
 
@@ -38,27 +38,16 @@ const char* dtype_to_cstr(DType dtype) {
     mgb_throw(GraphError, "unsupported output dtype %s in JIT fusion", dtype.name());
 }
 
-std::string gen_fastdiv_offset(size_t nr_inps) {
-    std::string res = "";
-
-    char tmp[100];
-#define APPEND(fmt...)                   \
-    do {                                 \
-        snprintf(tmp, sizeof(tmp), fmt); \
-        res += tmp;                      \
-    } while (0)
-
-    for (size_t i = 0; i < nr_inps; ++i) {
-        APPEND("offset_%zu = 0;\n", i);
-    }
-    for (size_t i = 0; i < nr_inps; ++i) {
-        APPEND("tmp_idx = global_idx;\n");
-        APPEND("#pragma unroll\n");
-        APPEND("for (int j = {{NDIM}} - 1; j >= 1; --j) {\n");
-        APPEND("Uint32Fastdiv& shp = "
-               "visitors.m[%zu].m_shape_highdim[j-1];\n",
-               i);
-        res += R"(
+//! generate code to compute \p offset of index \p idx by visitors.m[vis_id]
+std::string gen_visitor_offset(
+        size_t vis_id, const char* idx, const std::string& offset) {
+    std::string res = ssprintf("%s = 0;\n", offset.c_str());
+    res += ssprintf("tmp_idx = %s;\n", idx);
+    res += "#pragma unroll\n";
+    res += "for (int j = {{NDIM}} - 1; j >= 1; --j) {\n";
+    res += ssprintf(
+            "Uint32Fastdiv& shp = visitors.m[%zu].m_shape_highdim[j-1];\n", vis_id);
+    res += R"(
         unsigned int
             ans_for_one = tmp_idx & ~shp.m_divisor_is_not_1,
             dfix = tmp_idx + shp.m_inc_dividend,
@@ -66,15 +55,22 @@ std::string gen_fastdiv_offset(size_t nr_inps) {
             ans = hi32 >> shp.m_shift,
             idx_div = (ans & shp.m_divisor_is_not_1) | ans_for_one;
         )";
-        APPEND("offset_%zu += (tmp_idx - idx_div * shp.m_divisor) * "
-               "visitors.m[%zu].m_stride[j];\n",
-               i, i);
-        APPEND("tmp_idx = idx_div;\n");
-        APPEND("}\n");
-        APPEND("offset_%zu += tmp_idx * visitors.m[%zu].m_stride[0];\n", i, i);
-    }
+    res += ssprintf(
+            "%s += (tmp_idx - idx_div * shp.m_divisor) * "
+            "visitors.m[%zu].m_stride[j];\n",
+            offset.c_str(), vis_id);
+    res += "tmp_idx = idx_div;\n";
+    res += "}\n";
+    res += ssprintf(
+            "%s += tmp_idx * visitors.m[%zu].m_stride[0];\n", offset.c_str(), vis_id);
+    return res;
+}
 
-#undef APPEND
+std::string gen_fastdiv_offset(const std::vector<size_t>& data_inps) {
+    std::string res;
+    for (auto i : data_inps) {
+        res += gen_visitor_offset(i, "global_idx", "offset_" + std::to_string(i));
+    }
     return res;
 }
 
@@ -85,17 +81,26 @@ ASTPtr gen_data_ast(size_t input_id, const JITExecutor::Args::Data& n) {
     return ASTPtr::make<VariableAST>(res);
 }
 
-//! generate code to access input values in the kernel
+//! generate code to access input values in the kernel; indices of the inputs
+//! read by the kernel, i.e. excluding the shape inputs, are put in data_inps
 void gen_input_code(
         str_util::StrReplaceMap& replace_map, VarNode2AST& var2ast,
-        const JITExecutor::Args& args, const PlaceholderArray& placeholders) {
+        std::vector<size_t>& data_inps, const JITExecutor::Args& args,
+        const PlaceholderArray& placeholders) {
     std::string decl_exps_str, assign_exps_str, decl_fastdiv_offset_str;
     for (size_t i = 0; i < args.inputs.size(); i++) {
+        auto ph = placeholders[args.inputs[i].idx];
+        if (ph->is_host_value_shape_input()) {
+            // only used as the target shape of Reduce
+            var2ast[ph->output(0)] = ASTPtr::make<VariableAST>("0");
+            continue;
+        }
+        data_inps.push_back(i);
         ASTPtr elem_var = ASTPtr::make<VariableAST>("x" + std::to_string(i));
         ASTPtr elem_val = gen_data_ast(i, args.inputs[i]);
         ASTPtr elem_decl = ASTPtr::make<DeclFloatAST>(elem_var);
         ASTPtr elem_assign = ASTPtr::make<AssignAST>(elem_var, elem_val);
-        var2ast[placeholders[args.inputs[i].idx]->output(0)] = elem_var;
+        var2ast[ph->output(0)] = elem_var;
         decl_exps_str += elem_decl->code_gen();
         assign_exps_str += elem_assign->code_gen();
 
@@ -114,19 +119,97 @@ ASTPtr gen_opr_ast(cg::OperatorNodeBase* opr, const VarNode2AST& var2ast) {
     for (auto inp_node : opr->input()) {
         cur_inputs.push_back(var2ast.at(inp_node));
     }
-    if (opr->same_type<opr::Reduce>() || opr->same_type<opr::GetVarShape>() ||
-        opr->same_type<opr::Dimshuffle>()) {
-        // Reduce and GetVarShape occur in grad and would be ignored
+    if (auto reduce = opr->try_cast_final<opr::Reduce>()) {
+        // Reduce which keeps the shape occurs in grad
+        if (reduce->param().mode == opr::Reduce::Mode::SUM_SQR) {
+            return cur_inputs[0] * cur_inputs[0];
+        }
+        return cur_inputs[0];
+    }
+    if (opr->same_type<opr::GetVarShape>() || opr->same_type<opr::Dimshuffle>()) {
+        // GetVarShape occurs in grad and would be ignored
         return {cur_inputs[0]};
     }
 
     return opr2AST(opr, cur_inputs).at(0);
 }
+
+//! code of the Reduce oprs computed by the block reduction of the kernel
+struct ReduceCode {
+    std::string decl, init, update, store, combine, assign;
+};
+
+void gen_reduce_code(
+        ReduceCode& code, const opr::Reduce* opr, const std::string& out,
+        const std::string& inp) {
+    using Mode = opr::Reduce::Mode;
+    auto mode = opr->param().mode;
+    auto combine = [mode](const std::string& a, const std::string& b) {
+        switch (mode) {
+            case Mode::PRODUCT:
+                return ssprintf("%s * %s", a.c_str(), b.c_str());
+            case Mode::MAX:
+                return ssprintf("fmaxf(%s, %s)", a.c_str(), b.c_str());
+            case Mode::MIN:
+                return ssprintf("fminf(%s, %s)", a.c_str(), b.c_str());
+            default:
+                return ssprintf("%s + %s", a.c_str(), b.c_str());
+        }
+    };
+    const char* identity;
+    switch (mode) {
+        case Mode::SUM:
+        case Mode::SUM_SQR:
+        case Mode::MEAN:
+            identity = "0.f";
+            break;
+        case Mode::PRODUCT:
+            identity = "1.f";
+            break;
+        case Mode::MAX:
+            identity = "-__int_as_float(0x7f800000)";
+            break;
+        case Mode::MIN:
+            identity = "__int_as_float(0x7f800000)";
+            break;
+        default:
+            mgb_throw(
+                    GraphError, "unsupported reduce mode %d in JIT fusion",
+                    static_cast<int>(mode));
+    }
+    auto acc = "acc_" + out, smem = "smem_" + out,
+         tid = smem + "[threadIdx.x]";
+    code.decl += ssprintf(
+            "__shared__ float %s[%d];\nfloat %s;\n", smem.c_str(),
+            NVRTC_REDUCE_MAX_BLOCK_SIZE, acc.c_str());
+    code.init += ssprintf("%s = %s;\n", acc.c_str(), identity);
+    code.update += ssprintf(
+            "%s = %s;\n", acc.c_str(),
+            combine(acc, mode == Mode::SUM_SQR ? inp + " * " + inp : inp).c_str());
+    code.store += ssprintf("%s = %s;\n", tid.c_str(), acc.c_str());
+    code.combine += ssprintf(
+            "%s = %s;\n", tid.c_str(),
+            combine(tid, smem + "[threadIdx.x + s]").c_str());
+    code.assign += ssprintf(
+            "%s = %s[0]%s;\n", out.c_str(), smem.c_str(),
+            mode == Mode::MEAN ? " / reduce_size" : "");
+}
 }  // anonymous namespace
 
+bool mgb::jit::is_reduce_args(const JITExecutor::Args& args) {
+    auto&& layout = args.outputs[0].layout;
+    for (size_t i = 0; i < layout.ndim; ++i) {
+        if (!layout.stride[i] && layout.shape[i] > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::pair<std::string, std::string> mgb::jit::codegen_cuda(
         const InternalGraph& internal_graph, const JITExecutor::Args& args,
         bool copy_param_to_dev) {
+    bool is_reduce = is_reduce_args(args);
     std::string cuda_kernel =
             R"(
 #include <cuda_fp16.h>
@@ -152,7 +235,7 @@ struct Data {
 };
 
 struct PEVisitors {
-    ParamElemVisitor<{{NDIM}}> m[{{NR_INPS}}];
+    ParamElemVisitor<{{NDIM}}> m[{{NR_VISITORS}}];
 };
 
 template<typename T>
@@ -165,16 +248,72 @@ static __forceinline__ __device__ T mgb_log_sum_exp(T x, T y) {
 
 )";
 
-    cuda_kernel += copy_param_to_dev ? R"(
+    if (is_reduce) {
+        // visitors.m[NR_INPS] and visitors.m[NR_INPS + 1] map the output index
+        // and the index in the reduced axes to the index in the shape before
+        // reduce
+        cuda_kernel += copy_param_to_dev ? R"(
+extern "C" __global__ void {{KERNEL_NAME}} (Data* data_ptr, size_t num_elements,
+ PEVisitors* visitors_ptr, unsigned int reduce_size) {
+    Data data = *data_ptr;
+    PEVisitors visitors = *visitors_ptr;
+)"
+                                         : R"(
+extern "C" __global__ void {{KERNEL_NAME}} (Data data, size_t num_elements,
+ PEVisitors visitors, unsigned int reduce_size) { )";
+
+        cuda_kernel += R"(
+    unsigned int global_idx, base_idx, tmp_idx;
+
+    {{DECL_EXPRS}}
+    {{INTERNAL_DECL_EXPRS}}
+    {{DECL_fastdiv_offset}}
+    {{REDUCE_DECL}}
+
+    for (unsigned int out_idx = blockIdx.x; out_idx < num_elements;
+         out_idx += gridDim.x) {
+        {{base_offset}}
+        {{REDUCE_INIT}}
+        for (unsigned int red_idx = threadIdx.x; red_idx < reduce_size;
+             red_idx += blockDim.x) {
+            {{reduce_offset}}
+            global_idx += base_idx;
+            {{fastdiv_offset}}
+            {{ASSIGN_EXPRS}}
+            {{INTERNAL_ASSIGN_EXPRS}}
+            {{REDUCE_UPDATE}}
+        }
+        {{REDUCE_STORE}}
+        __syncthreads();
+        for (unsigned int s = blockDim.x / 2; s; s /= 2) {
+            if (threadIdx.x < s) {
+                {{REDUCE_COMBINE}}
+            }
+            __syncthreads();
+        }
+        if (threadIdx.x == 0) {
+            global_idx = base_idx;
+            {{fastdiv_offset}}
+            {{ASSIGN_EXPRS}}
+            {{INTERNAL_ASSIGN_EXPRS}}
+            {{REDUCE_ASSIGN}}
+            {{POST_REDUCE_ASSIGN_EXPRS}}
+            data.output[out_idx] = {{EXP}};
+        }
+    }
+}
+)";
+    } else {
+        cuda_kernel += copy_param_to_dev ? R"(
 extern "C" __global__ void {{KERNEL_NAME}} (Data* data_ptr, size_t num_elements, PEVisitors* visitors_ptr) {
     Data data = *data_ptr;
     PEVisitors visitors = *visitors_ptr;
 )"
-                                     : R"(
+                                         : R"(
 extern "C" __global__ void {{KERNEL_NAME}} (Data data, size_t num_elements,
  PEVisitors visitors) { )";
 
-    cuda_kernel += R"(
+        cuda_kernel += R"(
     unsigned int global_idx = blockIdx.x * blockDim.x + threadIdx.x;
     unsigned int delta = blockDim.x * gridDim.x;
     unsigned int tmp_idx;
@@ -207,39 +346,99 @@ extern "C" __global__ void {{KERNEL_NAME}} (Data data, size_t num_elements,
     }
 }
 )";
+    }
 
     VarNode2AST var2ast;
     str_util::StrReplaceMap source_replace_map;
 
     // add inputs to the replace map
-    gen_input_code(source_replace_map, var2ast, args, internal_graph.placeholders());
+    std::vector<size_t> data_inps;
+    gen_input_code(
+            source_replace_map, var2ast, data_inps, args,
+            internal_graph.placeholders());
+
+    std::vector<cg::OperatorNodeBase*> oprs;
+    cg::DepOprIter{[&oprs](cg::OperatorNodeBase* opr) {
+        oprs.push_back(opr);
+    }}.add(internal_graph.output());
+
+    // the Reduce oprs not depended by other Reduce oprs are computed by the
+    // block reduction, and so are the oprs depending on them after it
+    ThinHashSet<cg::OperatorNodeBase*> before_reduce, after_reduce;
+    if (is_reduce) {
+        for (auto iter = oprs.rbegin(); iter != oprs.rend(); ++iter) {
+            if ((*iter)->same_type<opr::Reduce>() || before_reduce.count(*iter)) {
+                for (auto inp : (*iter)->input()) {
+                    before_reduce.insert(inp->owner_opr());
+                }
+            }
+        }
+    }
 
     // add other oprs
-    std::string internal_decl_exps_str, internal_assign_exps_str;
-    size_t cur_opr_cnt = 0;
-    cg::DepOprIter{[&](cg::OperatorNodeBase* opr) {
-        ++cur_opr_cnt;
+    std::string internal_decl_exps_str, internal_assign_exps_str,
+            post_reduce_assign_exps_str;
+    ReduceCode reduce_code;
+    for (size_t i = 0; i < oprs.size(); ++i) {
+        auto opr = oprs[i];
         if (opr->same_type<JITPlaceholder>()) {
-            return;
+            continue;
         }
-        ASTPtr elem_var = ASTPtr::make<VariableAST>("y" + std::to_string(cur_opr_cnt));
-        ASTPtr elem_val = gen_opr_ast(opr, var2ast);
+        ASTPtr elem_var = ASTPtr::make<VariableAST>("y" + std::to_string(i + 1));
         ASTPtr elem_decl = ASTPtr::make<DeclFloatAST>(elem_var);
+        internal_decl_exps_str += elem_decl->code_gen();
+        if (is_reduce && opr->same_type<opr::Reduce>() && !before_reduce.count(opr)) {
+            gen_reduce_code(
+                    reduce_code, &opr->cast_final<opr::Reduce>(),
+                    elem_var->code_gen(), var2ast.at(opr->input(0))->code_gen());
+            after_reduce.insert(opr);
+            var2ast[opr->output(0)] = elem_var;
+            continue;
+        }
+        ASTPtr elem_val = gen_opr_ast(opr, var2ast);
         ASTPtr elem_assign = ASTPtr::make<AssignAST>(elem_var, elem_val);
         var2ast[opr->output(0)] = elem_var;
-        internal_decl_exps_str += elem_decl->code_gen();
-        internal_assign_exps_str += elem_assign->code_gen();
-    }}.add(internal_graph.output());
+        bool is_after_reduce = false;
+        for (auto inp : opr->input()) {
+            is_after_reduce |= after_reduce.count(inp->owner_opr()) > 0;
+        }
+        if (is_after_reduce) {
+            after_reduce.insert(opr);
+            post_reduce_assign_exps_str += elem_assign->code_gen();
+        } else {
+            internal_assign_exps_str += elem_assign->code_gen();
+        }
+    }
+    mgb_assert(
+            !is_reduce || !after_reduce.empty(),
+            "reduced output without Reduce opr in JIT fusion");
 
+    size_t nr_inps = args.inputs.size();
     str_util::append_replace_map(
             source_replace_map,
-            {{"{{NR_INPS}}", std::to_string(args.inputs.size())},
+            {{"{{NR_INPS}}", std::to_string(nr_inps)},
+             {"{{NR_VISITORS}}", std::to_string(nr_inps + (is_reduce ? 2 : 0))},
              {"{{NDIM}}", std::to_string(args.outputs[0].layout.ndim)},
-             {"{{fastdiv_offset}}", gen_fastdiv_offset(args.inputs.size())},
+             {"{{fastdiv_offset}}", gen_fastdiv_offset(data_inps)},
              {"{{INTERNAL_DECL_EXPRS}}", internal_decl_exps_str},
              {"{{INTERNAL_ASSIGN_EXPRS}}", internal_assign_exps_str},
              {"{{EXP}}", var2ast.at(internal_graph.output())->code_gen()},
              {"{{OUTPUT_DTYPE}}", dtype_to_cstr(args.outputs[0].layout.dtype)}});
+    if (is_reduce) {
+        str_util::append_replace_map(
+                source_replace_map,
+                {{"{{base_offset}}",
+                  gen_visitor_offset(nr_inps, "out_idx", "base_idx")},
+                 {"{{reduce_offset}}",
+                  gen_visitor_offset(nr_inps + 1, "red_idx", "global_idx")},
+                 {"{{REDUCE_DECL}}", reduce_code.decl},
+                 {"{{REDUCE_INIT}}", reduce_code.init},
+                 {"{{REDUCE_UPDATE}}", reduce_code.update},
+                 {"{{REDUCE_STORE}}", reduce_code.store},
+                 {"{{REDUCE_COMBINE}}", reduce_code.combine},
+                 {"{{REDUCE_ASSIGN}}", reduce_code.assign},
+                 {"{{POST_REDUCE_ASSIGN_EXPRS}}", post_reduce_assign_exps_str}});
+    }
 
     str_util::replace_all_pairs_inplace(cuda_kernel, source_replace_map);
     str_util::replace_all_pairs_inplace(cuda_kernel, source_replace_map);
@@ -19,6 +19,18 @@
 
 namespace mgb {
 namespace jit {
+//! max number of threads in a block of the reduce kernel
+constexpr int NVRTC_REDUCE_MAX_BLOCK_SIZE = 256;
+
+/*!
+ * \brief whether the output in \p args is reduced from the inputs, i.e. it
+ *      has axes of zero stride
+ *
+ * For such args, one block of the kernel computes one output element, which
+ * is the reduction of the inputs in the shape before reduce.
+ */
+bool is_reduce_args(const JITExecutor::Args& args);
+
 /*!
  * \brief generate cuda kernel source code
  * \return (kernel name, kernel source)
@@ -119,15 +119,21 @@ void host_init_pvisitor(ParamElemVisitor<ndim>& pvis, const TensorLayout& layout
 template <size_t out_dim>
 void setup_and_launch(const JITExecutor* fusion_opr, CUfunction func, int block_size) {
     auto&& args = fusion_opr->args();
+    auto&& placeholders = fusion_opr->internal_graph().placeholders();
+    bool is_reduce = is_reduce_args(args);
 
     size_t nr_inps = args.inputs.size();
     bool copy_param_to_dev = nr_inps > CudaCompiler::MAX_CUDA_NR_INPUT;
     SmallVector<CUdeviceptr> datum(nr_inps + 1);
 
-    SmallVector<ParamElemVisitor<out_dim>> pvisitors;
-    pvisitors.reserve(nr_inps);
+    SmallVector<ParamElemVisitor<out_dim>> pvisitors(nr_inps + (is_reduce ? 2 : 0));
 
     for (size_t i = 0; i < args.inputs.size(); i++) {
+        if (placeholders[args.inputs[i].idx]->is_host_value_shape_input()) {
+            // the target shape of Reduce is not read by the kernel
+            datum[i] = 0;
+            continue;
+        }
         datum[i] = reinterpret_cast<CUdeviceptr>(
                 args.inputs[i].from->dev_tensor().raw_ptr());
         host_init_pvisitor<out_dim>(pvisitors[i], args.inputs[i].layout);
@@ -141,8 +147,38 @@ void setup_and_launch(const JITExecutor* fusion_opr, CUfunction func, int block_
             "performance");
     int num_block = (num_elements - 1) / (block_size * 3) + 1;
 
-    void* exec_args[3];
+    uint32_t reduce_size = 1;
+    if (is_reduce) {
+        // the output index and the index in the reduced axes are mapped to the
+        // index in the contiguous shape before reduce
+        TensorLayout out_layout(args.outputs[0].layout, args.outputs[0].layout.dtype);
+        TensorLayout reduce_layout = out_layout;
+        for (size_t i = 0; i < out_layout.ndim; ++i) {
+            if (args.outputs[0].layout.stride[i]) {
+                reduce_layout.shape[i] = 1;
+            } else {
+                out_layout.shape[i] = 1;
+            }
+        }
+        host_init_pvisitor<out_dim>(pvisitors[nr_inps], out_layout);
+        host_init_pvisitor<out_dim>(pvisitors[nr_inps + 1], reduce_layout);
+        num_elements = out_layout.total_nr_elems();
+        reduce_size = reduce_layout.total_nr_elems();
+
+        // one block for each output element, and the block size is a power of
+        // two required by the tree reduction in shared memory
+        int max_block_size = std::min(block_size, NVRTC_REDUCE_MAX_BLOCK_SIZE);
+        block_size = 32;
+        while (block_size * 2 <= max_block_size &&
+               static_cast<uint32_t>(block_size) < reduce_size) {
+            block_size *= 2;
+        }
+        num_block = std::min<size_t>(num_elements, 65535);
+    }
+
+    void* exec_args[4];
     exec_args[1] = &num_elements;
+    exec_args[3] = &reduce_size;
 
     void* datum_dev = nullptr;
     void* p_visitors_dev = nullptr;
@@ -159,8 +195,8 @@ void setup_and_launch(const JITExecutor* fusion_opr, CUfunction func, int block_
         p_visitors_dev = args.outputs[2].from->dev_tensor().as_megdnn().raw_ptr;
         MGB_CUDA_CHECK(cudaMemcpyAsync(
                 p_visitors_dev, pvisitors.data(),
-                nr_inps * sizeof(ParamElemVisitor<out_dim>), cudaMemcpyHostToDevice,
-                env.cuda_env().stream));
+                pvisitors.size() * sizeof(ParamElemVisitor<out_dim>),
+                cudaMemcpyHostToDevice, env.cuda_env().stream));
         exec_args[0] = &datum_dev;
         exec_args[2] = &p_visitors_dev;
     }
@@ -195,8 +231,12 @@ void CudaExecutable::execute(JITExecutor* fusion_opr) {
     {
         MGB_LOCK_GUARD(func->mtx);
         if (func->ptx.empty()) {
+            // the ptx depends on the version of nvrtc besides the device
+            int nvrtc_major = 0, nvrtc_minor = 0;
+            MGB_NVRTC_CHECK(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
             func->compile(
-                    "jit:nvrtc:" + PersistentCache::make_category_from_comp_node(cn),
+                    "jit:nvrtc:" + PersistentCache::make_category_from_comp_node(cn) +
+                            ssprintf(";nvrtc=%d.%d", nvrtc_major, nvrtc_minor),
                     prop.major, prop.minor, this);
         }
     }
@@ -302,7 +342,9 @@ void CudaCompiler::init_workspace_size_infer(JITExecutor* opr) {
                 {(opr->input().size() + 1) * sizeof(unsigned long long)});
         mgr.register_shape_infer(
                 opr->output(1), ShapeInferDesc::make_const(output_shape1));
-        TensorShape output_shape2({opr->input().size() * sizeof(ParamElemVisitor<4>)});
+        // two more visitors are used by the reduce kernel
+        size_t nr_visitors = opr->input().size() + (opr->has_reduce() ? 2 : 0);
+        TensorShape output_shape2({nr_visitors * sizeof(ParamElemVisitor<4>)});
         mgr.register_shape_infer(
                 opr->output(2), ShapeInferDesc::make_const(output_shape2));
     }
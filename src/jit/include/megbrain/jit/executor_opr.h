@@ -77,6 +77,9 @@ public:
             //! for HOST_VALUE_FOR_SHAPE input, this would contain only shape;
             //! dtype would be invalid and stride would be zero. If
             //! \p need_input_collapse is set, this layout would be collapsed.
+            //! If the compiler also supports reduce, the layout of a reduced
+            //! output is broadcast to the shape before reduce, with zero
+            //! strides on the reduced axes.
             TensorLayout layout;
             int idx;  //!< index in the input array; -1 for output
         };
@@ -28,6 +28,7 @@
 #include "megbrain/test/helper.h"
 
 #include "../../core/impl/graph/cg_impl_seq.h"
+#include "../impl/interpreter/executable.h"
 
 #if MGB_JIT
 
@@ -1180,6 +1181,55 @@ TYPED_TEST(TestJITNvrtcFusion, run) {
     set_backend(Backend::NONE);
 }
 
+template <typename tag>
+class TestJITInterpFusion : public ::testing::Test {};
+TYPED_TEST_CASE(TestJITInterpFusion, test_types);
+TYPED_TEST(TestJITInterpFusion, run) {
+    run<TypeParam>(Backend::INTERP, CompNode::load("cpu0"));
+
+    set_backend(Backend::NONE);
+}
+
+TEST(TestJITInterpFusion, LongChain) {
+    set_backend(Backend::INTERP);
+
+    HostTensorGenerator<dtype::Float32, RandomDistribution::UNIFORM> gen{-1.f, 1.f};
+    for (auto&& cn : {CompNode::load("cpu0"), CompNode::load("multithread2:0")}) {
+        // with broadcast inputs
+        auto host_x = gen({7, 300, 300}, cn), host_b = gen({7, 1, 300}, cn),
+             host_c = gen({1}, cn);
+        auto make_dst = [&](ComputingGraph& graph) {
+            auto x = opr::Host2DeviceCopy::make(graph, host_x),
+                 b = opr::Host2DeviceCopy::make(graph, host_b),
+                 c = opr::Host2DeviceCopy::make(graph, host_c);
+            auto y = x;
+            for (int i = 0; i < 8; ++i) {
+                y = opr::sigmoid(y * b + c) * y + 0.5f;
+            }
+            return opr::relu(y - x);
+        };
+        HostTensorND host_y1, host_y2;
+        auto funcs = make_func_pair(host_y1, host_y2, make_dst, 1);
+        for (int i = 0; i < 2; ++i) {
+            funcs.first->execute();
+            funcs.second->execute();
+            MGB_ASSERT_TENSOR_NEAR(host_y1, host_y2, 1e-6);
+        }
+
+        JITExecutor* jit;
+        unpack_vector(find_oprs<JITExecutor>(*funcs.second), jit);
+        ASSERT_TRUE(find_oprs<opr::Elemwise>(*funcs.second).empty());
+        ASSERT_EQ(3u, jit->input().size());
+
+        // registers of dead values are reused
+        auto exe = dynamic_cast<InterpreterExecutable*>(jit->executable());
+        ASSERT_NE(nullptr, exe);
+        ASSERT_LE(exe->nr_reg(), 8u);
+    }
+
+    set_backend(Backend::NONE);
+}
+
 TEST(TestJITNvrtcFusion, SourceCache) {
     REQUIRE_GPU(1);
     set_backend(Backend::NVRTC);
@@ -1429,6 +1479,50 @@ TEST(TestJITNvrtc, DimshuffleGrad) {
     }
 }
 
+TEST(TestJITNvrtc, Reduce) {
+    REQUIRE_GPU(1);
+    set_backend(Backend::NVRTC);
+
+    using Mode = opr::Reduce::Param::Mode;
+    for (auto mode :
+         {Mode::SUM, Mode::SUM_SQR, Mode::PRODUCT, Mode::MIN, Mode::MAX, Mode::MEAN}) {
+        FusionChecker checker{
+                2,
+                [mode](const SymbolVarArray& inp) -> SymbolVar {
+                    auto var1 = opr::Reduce::make(
+                            inp[0] * 0.5f + 0.8f, mode, opr::GetVarShape::make(inp[1]));
+                    return var1 + inp[1];
+                },
+                CompNode::load("gpu0")};
+        checker.run({TensorShape{3, 3}, {3, 1}});
+        checker.run({TensorShape{3, 7, 5}, {3, 1, 5}});
+        checker.run({TensorShape{3, 3}, {1}});  // to scalar
+        if (mode != Mode::PRODUCT) {
+            checker.run({TensorShape{2, 300, 4}, {1, 300, 1}});
+        }
+    }
+}
+
+TEST(TestJITNvrtc, ReduceExp) {
+    REQUIRE_GPU(1);
+    set_backend(Backend::NVRTC);
+
+    // denominator of softmax, in which the max is a placeholder broadcast in
+    // the reduced axis
+    FusionChecker checker{
+            2,
+            [](const SymbolVarArray& inp) -> SymbolVar {
+                auto var1 = opr::reduce_sum(
+                        opr::exp(inp[0] - inp[1]), opr::GetVarShape::make(inp[1]));
+                auto var2 = opr::reduce_sum_sqr(
+                        inp[0] + inp[1], opr::GetVarShape::make(inp[1]));
+                return opr::log(var1) + var2;
+            },
+            CompNode::load("gpu0")};
+    checker.run({TensorShape{4, 1000}, {4, 1}});
+    checker.run({TensorShape{3, 3}, {3, 1}});
+}
+
 TEST(TestJITNvrtc, JITConfig) {
     using JITConfig = cg::ComputingGraph::Options::GraphOpt::JITConfig;
     using CompSeq = cg::ComputingGraphImpl::ComputingSequence;
@@ -1645,13 +1739,13 @@ TEST(TestJITExecutor, GradBehavior) {
 
 #if MGB_JIT_MLIR
 
-void run_mlir(CompNode cn) {
+void run_mlir(CompNode cn, size_t n = 23) {
     set_backend(Backend::MLIR);
 
     HostTensorGenerator<> gen;
-    auto host_x0 = gen({23, 42}, cn), host_x1 = gen({23, 1}, cn),
-         host_x2 = gen({1, 42}, cn), host_x3 = gen({23, 42}, cn),
-         host_x4 = gen({1, 42}, cn), host_x5 = gen({23, 1}, cn);
+    auto host_x0 = gen({n, 42}, cn), host_x1 = gen({n, 1}, cn),
+         host_x2 = gen({1, 42}, cn), host_x3 = gen({n, 42}, cn),
+         host_x4 = gen({1, 42}, cn), host_x5 = gen({n, 1}, cn);
 
     auto make_dst = [&](ComputingGraph& graph) {
         auto a = opr::Host2DeviceCopy::make(graph, host_x0),
@@ -1678,11 +1772,44 @@ TEST(TestJITExecutor, TestJITMlirFusion) {
     run_mlir(CompNode::load("cpu0"));
 }
 
+TEST(TestJITExecutor, TestJITMlirFusionMultiThread) {
+    // the rows are split into chunks of 335 rows with a tail of 333 rows
+    run_mlir(CompNode::load("multithread4:0"), 1003);
+    // evenly split
+    run_mlir(CompNode::load("multithread4:0"), 1200);
+}
+
 TEST(TestJITExecutor, TestJITMlirFusionGpu) {
     REQUIRE_GPU(1);
     run_mlir(CompNode::load("gpu0"));
 }
 
+TEST(TestJITExecutor, TestJITMlirKernelCache) {
+    REQUIRE_GPU(1);
+
+    std::string cache_cat;
+    std::vector<std::string> modules;
+    auto on_cache_get = [&](const std::string& category, const void* key,
+                            size_t key_size, const void*, size_t) {
+        if (category.find("jit:mlir:") != 0) {
+            return;
+        }
+        if (cache_cat.empty()) {
+            cache_cat = category;
+        } else {
+            ASSERT_EQ(cache_cat, category);
+        }
+        modules.push_back(std::string{static_cast<const char*>(key), key_size});
+    };
+    PersistentCacheHook cache_hook{on_cache_get};
+
+    for (size_t i = 0; i < 3; ++i) {
+        run_mlir(CompNode::load("gpu0"));
+        ASSERT_EQ(i + 1, modules.size());
+        ASSERT_EQ(modules[0], modules[i]);
+    }
+}
+
 #endif  // MGB_JIT_MLIR
 
 #endif  // MGB_JIT
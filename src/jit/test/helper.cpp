@@ -38,6 +38,9 @@ void jit::set_backend(Backend backend) {
         case Backend::MLIR:
             setenv("MGB_JIT_BACKEND", "MLIR", 1);
             return;
+        case Backend::INTERP:
+            setenv("MGB_JIT_BACKEND", "INTERP", 1);
+            return;
         default:
             mgb_assert(0);
     }
@@ -244,10 +244,38 @@ class CollectiveComm::ModeTrait::AllReduceBase : public ReducedBasedTrait,
         auto ivar = opr->input(0), ovar = opr->output(0);
         auto &&iv = ivar->dev_tensor(), &&ov = ovar->dev_tensor();
         mgb_assert(ivar->comp_node().mem_node() == ovar->comp_node().mem_node());
-        auto status = opr->m_megray_comm->all_reduce(
-                (void*)iv.raw_ptr(), (void*)ov.raw_ptr(), iv.shape().total_nr_elems(),
-                get_megray_dtype(iv.dtype()), op(), opr->megray_ctx());
-        mgb_assert(status == MegRay::MEGRAY_OK, "MegRay all_reduce failed");
+        auto dtype = get_megray_dtype(iv.dtype());
+        size_t len = iv.shape().total_nr_elems(), done = 0;
+        if (auto&& hier = opr->m_hierarchical_comm) {
+            // reduce scatter inside the host, all reduce the shard of this
+            // rank across the hosts and all gather inside the host; all of
+            // them are in place on the shard in the output
+            size_t shard_len = len / hier->local_size;
+            if (shard_len) {
+                auto elem_size = iv.dtype().size();
+                auto optr = ov.raw_ptr();
+                auto shard = optr + hier->local_rank * shard_len * elem_size;
+                auto status = hier->intra->reduce_scatter(
+                        (void*)iv.raw_ptr(), shard, shard_len, dtype, op(),
+                        opr->megray_ctx());
+                mgb_assert(status == MegRay::MEGRAY_OK, "MegRay reduce_scatter failed");
+                status = hier->inter->all_reduce(
+                        shard, shard, shard_len, dtype, op(), opr->megray_ctx());
+                mgb_assert(status == MegRay::MEGRAY_OK, "MegRay all_reduce failed");
+                status = hier->intra->all_gather(
+                        shard, optr, shard_len, dtype, opr->megray_ctx());
+                mgb_assert(status == MegRay::MEGRAY_OK, "MegRay all_gather failed");
+                done = shard_len * hier->local_size;
+            }
+        }
+        if (done < len) {
+            auto elem_size = iv.dtype().size();
+            auto status = opr->m_megray_comm->all_reduce(
+                    (void*)(iv.raw_ptr() + done * elem_size),
+                    (void*)(ov.raw_ptr() + done * elem_size), len - done,
+                    dtype, op(), opr->megray_ctx());
+            mgb_assert(status == MegRay::MEGRAY_OK, "MegRay all_reduce failed");
+        }
     }
 
     Mode grad_mode() override { return Mode::ALL_REDUCE_SUM; }
@@ -594,6 +622,15 @@ void CollectiveComm::opr_register() {
             reg_info.hash, m_key, m_nr_devices, m_rank, get_megray_backend(m_backend),
             m_group_client);
 
+    static bool hierarchical = getenv("MGB_HIERARCHICAL_ALLREDUCE");
+    if (hierarchical && (m_param.mode == Param::Mode::ALL_REDUCE_SUM ||
+                         m_param.mode == Param::Mode::ALL_REDUCE_MAX ||
+                         m_param.mode == Param::Mode::ALL_REDUCE_MIN)) {
+        m_hierarchical_comm = MegRayCommBuilder::get_hierarchical_comm(
+                reg_info.hash, m_key, m_nr_devices, m_rank,
+                get_megray_backend(m_backend), m_group_client);
+    }
+
     m_megray_ctx = get_megray_context(output(0)->comp_node());
 
     m_init = true;
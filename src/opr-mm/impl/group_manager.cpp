@@ -141,24 +141,21 @@ void GroupManager::bcast_addr(
         std::string& master_ip, int& port, const std::string& key, uint32_t size,
         uint32_t rank, uint32_t root) {
     std::unique_lock<std::mutex> lk{m_key2addr_mtx};
+    auto&& info = m_key2addr[key];
     if (rank == root) {
-        m_key2master_ip[key] = master_ip;
-        m_key2port[key] = port;
+        info.master_ip = master_ip;
+        info.port = port;
     }
-    m_key2addr_size[key]++;
-    if (m_key2addr_size[key] == size) {
-        m_key2addr_flag[key] = true;
-        m_bcast_cv.notify_all();
+    if (++info.nr_ranks == size) {
+        info.ready = true;
+        info.cv.notify_all();
     } else {
-        m_bcast_cv.wait(lk, [&] { return m_key2addr_flag.count(key) > 0; });
+        info.cv.wait(lk, [&] { return info.ready; });
     }
-    master_ip = m_key2master_ip[key];
-    port = m_key2port[key];
-    m_key2addr_size[key]--;
-    if (m_key2addr_size[key] == 0) {
-        m_key2master_ip.erase(key);
-        m_key2port.erase(key);
-        m_key2addr_flag.erase(key);
+    master_ip = info.master_ip;
+    port = info.port;
+    if (--info.nr_ranks == 0) {
+        m_key2addr.erase(key);
     }
 }
 
@@ -202,6 +199,34 @@ uint32_t GroupManager::group_barrier(uint32_t size, uint32_t rank) {
     return m_barrier_size;
 }
 
+std::vector<std::string> GroupManager::gather_hosts(
+        const std::string& key, uint32_t size, uint32_t rank,
+        const std::string& host) {
+    std::unique_lock<std::mutex> lk{m_key2hosts_mtx};
+    auto&& hosts = m_key2hosts[key];
+    if (hosts.empty()) {
+        hosts.resize(size);
+    }
+    mgb_assert(
+            hosts.size() == size && rank < size,
+            "inconsistent size or invalid rank %u in gather_hosts", rank);
+    hosts[rank] = host;
+    auto&& count = m_key2hosts_size[key];
+    if (++count == size) {
+        m_hosts_cv.notify_all();
+    } else {
+        m_hosts_cv.wait(lk, [&] { return m_key2hosts_size[key] >= size; });
+    }
+    auto ret = m_key2hosts[key];
+    // each rank counts once on arrival and once on leaving, and the last one
+    // to leave cleans up
+    if (++m_key2hosts_size[key] == 2 * size) {
+        m_key2hosts.erase(key);
+        m_key2hosts_size.erase(key);
+    }
+    return ret;
+}
+
 void RegInfoCache::set_info(
         const std::string& key, const GroupManager::RegisterInfo& info) {
     std::unique_lock<std::mutex> lock(RegInfoCache::mtx);
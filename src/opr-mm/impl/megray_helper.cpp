@@ -13,6 +13,9 @@
 #include "megbrain/comp_node_env.h"
 #include "megray/common.h"
 
+#include <unistd.h>
+#include <algorithm>
+
 using namespace mgb;
 using namespace opr;
 
@@ -78,16 +81,19 @@ void MegRayCommBuilder::emplace(
     m_megray_comms.emplace(hash, comm);
 }
 
+MegRayCommBuilder* MegRayCommBuilder::instance() {
+    // singleton pattern
+    std::unique_lock<std::mutex> lk(sm_instance_mtx);
+    if (sm_instance == nullptr) {
+        sm_instance = new MegRayCommBuilder();
+    }
+    return sm_instance;
+}
+
 std::shared_ptr<MegRay::Communicator> MegRayCommBuilder::get_megray_comm(
         uint64_t hash, std::string key, uint32_t size, uint32_t rank,
         MegRay::Backend backend, std::shared_ptr<mgb::opr::GroupClient> group_client) {
-    {
-        // singleton pattern
-        std::unique_lock<std::mutex> lk(sm_instance_mtx);
-        if (sm_instance == nullptr) {
-            sm_instance = new MegRayCommBuilder();
-        }
-    }
+    instance();
 
     std::shared_ptr<MegRay::Communicator> comm;
     if (!sm_instance->find(hash, comm)) {
@@ -112,6 +118,68 @@ std::shared_ptr<MegRay::Communicator> MegRayCommBuilder::get_megray_comm(
     return comm;
 }
 
+std::shared_ptr<MegRayHierarchicalComm> MegRayCommBuilder::get_hierarchical_comm(
+        uint64_t hash, std::string key, uint32_t size, uint32_t rank,
+        MegRay::Backend backend, std::shared_ptr<mgb::opr::GroupClient> group_client) {
+    auto builder = instance();
+    {
+        std::unique_lock<std::mutex> lk(builder->m_map_mtx);
+        auto it = builder->m_hierarchical_comms.find(hash);
+        if (it != builder->m_hierarchical_comms.end()) {
+            return it->second;
+        }
+    }
+
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    auto hosts = group_client->gather_hosts(key + ":hosts", size, rank, host);
+
+    // hosts in the order of their first ranks, and the ranks on each host
+    std::vector<std::string> host_order;
+    std::unordered_map<std::string, std::vector<uint32_t>> host2ranks;
+    for (uint32_t i = 0; i < size; ++i) {
+        auto&& ranks = host2ranks[hosts[i]];
+        if (ranks.empty()) {
+            host_order.push_back(hosts[i]);
+        }
+        ranks.push_back(i);
+    }
+    auto&& local_ranks = host2ranks.at(hosts[rank]);
+    uint32_t local_size = local_ranks.size();
+    bool uniform = true;
+    for (auto&& i : host2ranks) {
+        uniform &= i.second.size() == local_size;
+    }
+
+    std::shared_ptr<MegRayHierarchicalComm> ret;
+    if (uniform && host_order.size() > 1 && local_size > 1) {
+        uint32_t local_rank =
+                std::find(local_ranks.begin(), local_ranks.end(), rank) -
+                local_ranks.begin();
+        uint32_t node_rank =
+                std::find(host_order.begin(), host_order.end(), hosts[rank]) -
+                host_order.begin();
+        auto get_comm = [&](const std::string& sub_key, uint32_t sub_size,
+                            uint32_t sub_rank) {
+            auto sub_hash =
+                    XXHash{}.update(sub_key.data(), sub_key.size()).digest() + hash;
+            return get_megray_comm(
+                    sub_hash, sub_key, sub_size, sub_rank, backend, group_client);
+        };
+        ret = std::make_shared<MegRayHierarchicalComm>();
+        ret->intra = get_comm(key + ":intra:" + hosts[rank], local_size, local_rank);
+        ret->inter = get_comm(
+                key + ":inter:" + std::to_string(local_rank), host_order.size(),
+                node_rank);
+        ret->local_rank = local_rank;
+        ret->local_size = local_size;
+    }
+
+    std::unique_lock<std::mutex> lk(builder->m_map_mtx);
+    builder->m_hierarchical_comms.emplace(hash, ret);
+    return ret;
+}
+
 MegRayCommBuilder* MegRayCommBuilder::sm_instance = nullptr;
 
 std::mutex MegRayCommBuilder::sm_instance_mtx;
@@ -42,6 +42,7 @@ public:
         RUNSERVER(get_output_shape);
         RUNSERVER(bcast_addr);
         RUNSERVER(group_barrier);
+        RUNSERVER(gather_hosts);
         mgb_assert(false, "invalid rpc request");
     }
 
@@ -51,6 +52,7 @@ private:
     void get_output_shape(void* input_ptr, size_t input_len, std::string* output);
     void bcast_addr(void* input_ptr, size_t input_len, std::string* output);
     void group_barrier(void* input_ptr, size_t input_len, std::string* output);
+    void gather_hosts(void* input_ptr, size_t input_len, std::string* output);
 
 private:
     GroupManager m_mgr;
@@ -120,6 +122,16 @@ void GroupServerProxy::group_barrier(
     rsp.set_size(rsp_size);
     rsp.SerializeToString(output);
 }
+
+void GroupServerProxy::gather_hosts(
+        void* input_ptr, size_t input_len, std::string* output) {
+    INFO_INIT(mm_handler, GatherHosts);
+    auto hosts = m_mgr.gather_hosts(req.key(), req.size(), req.rank(), req.host());
+    for (auto&& host : hosts) {
+        rsp.add_hosts(host);
+    }
+    rsp.SerializeToString(output);
+}
 #undef INFO_INIT
 
 /* ======================== GroupClientProxy ========================== */
@@ -206,6 +218,18 @@ uint32_t GroupClientProxy::group_barrier(uint32_t size, uint32_t rank) {
     return rsp.size();
 }
 
+std::vector<std::string> GroupClientProxy::gather_hosts(
+        const std::string& key, uint32_t size, uint32_t rank,
+        const std::string& host) {
+    INFO_INIT(mm_handler, gather_hosts, GatherHosts);
+    req.set_key(key.data(), key.size());
+    req.set_size(size);
+    req.set_rank(rank);
+    req.set_host(host.data(), host.size());
+    SOLVE_REQUEST(func_name, req, rsp);
+    return {rsp.hosts().begin(), rsp.hosts().end()};
+}
+
 #undef INFO_INIT
 #undef SOLVE_REQUEST
 
@@ -50,12 +50,16 @@ void ZmqRpcWorker::work(string uid) {
         //  request should be like [address, empty, msg]
         message_t address;
         recv_result_t ret_code;
+        // block in zmq_poll instead of spinning, as a worker is kept for each
+        // pending request and there may be hundreds of them during startup;
+        // the timeout is to check m_stop in time
+        zmq_pollitem_t item = {socket, 0, ZMQ_POLLIN, 0};
         while (!m_stop) {
+            if (zmq_poll(&item, 1, 10) <= 0)
+                continue;
             ret_code = socket.recv(address, recv_flags::dontwait);
             if (ret_code.has_value() && ret_code.value() > 0)
                 break;
-            // retry after 10 usec
-            usleep(10);
         }
         if (m_stop)
             break;
@@ -19,6 +19,8 @@
 namespace mgb {
 namespace opr {
 
+struct MegRayHierarchicalComm;
+
 //! collective communication between multiple CompNode on localhost
 MGB_DEFINE_OPR_CLASS(CollectiveComm, cg::OutshapePureByInshapeOpr<>) // {
 public:
@@ -131,6 +133,8 @@ private:
 
     std::shared_ptr<MegRay::Context> m_megray_ctx;
     std::shared_ptr<MegRay::Communicator> m_megray_comm;
+    //! used by all reduce if MGB_HIERARCHICAL_ALLREDUCE is set
+    std::shared_ptr<MegRayHierarchicalComm> m_hierarchical_comm;
     bool m_init = false;
     bool m_debug_mode = false;
 
@@ -97,6 +97,11 @@ public:
     //! Block clients until all ranks reach this barrier
     uint32_t group_barrier(uint32_t size, uint32_t rank);
 
+    //! gather the host names of all ranks of this key, indexed by rank
+    std::vector<std::string> gather_hosts(
+            const std::string& key, uint32_t size, uint32_t rank,
+            const std::string& host);
+
 private:
     GroupInfo& get_group(const std::string& key);
 
@@ -104,19 +109,31 @@ private:
     std::unordered_map<std::string, GroupInfo> m_key2group_info;
     std::mutex m_key2group_info_mtx;
 
+    //! the addr being broadcast of a key; each key has its own cv so that
+    //! the completion of a group does not wake the ranks of the others
+    struct AddrInfo {
+        std::string master_ip;
+        int port = 0;
+        uint32_t nr_ranks = 0;
+        bool ready = false;
+        std::condition_variable cv;
+    };
+
     //! key -> addr
-    std::unordered_map<std::string, std::string> m_key2master_ip;
-    std::unordered_map<std::string, int> m_key2port;
-    std::unordered_map<std::string, uint32_t> m_key2addr_size;
-    std::unordered_map<std::string, bool> m_key2addr_flag;
+    std::unordered_map<std::string, AddrInfo> m_key2addr;
     std::mutex m_key2addr_mtx;
-    std::condition_variable m_bcast_cv;
 
     //! barrier
     uint32_t m_barrier_size;
     std::set<uint32_t> m_barrier_set;
     std::mutex m_barrier_mtx;
     std::condition_variable m_barrier_cv;
+
+    //! key -> hosts
+    std::unordered_map<std::string, std::vector<std::string>> m_key2hosts;
+    std::unordered_map<std::string, uint32_t> m_key2hosts_size;
+    std::mutex m_key2hosts_mtx;
+    std::condition_variable m_hosts_cv;
 };
 
 /*!
@@ -144,6 +161,10 @@ public:
     virtual TensorShape get_output_shape(const std::string& key) = 0;
 
     virtual uint32_t group_barrier(uint32_t size, uint32_t rank) = 0;
+
+    virtual std::vector<std::string> gather_hosts(
+            const std::string& key, uint32_t size, uint32_t rank,
+            const std::string& host) = 0;
 };
 
 /*!
@@ -27,6 +27,17 @@ MegRay::Backend get_megray_backend(const std::string& backend);
 
 std::shared_ptr<MegRay::Context> get_megray_context(CompNode comp_node);
 
+/*!
+ * communicators to reduce inside each host before across the hosts
+ */
+struct MegRayHierarchicalComm {
+    //! among the ranks on the same host
+    std::shared_ptr<MegRay::Communicator> intra;
+    //! among the ranks with the same local rank on all the hosts
+    std::shared_ptr<MegRay::Communicator> inter;
+    uint32_t local_rank, local_size;
+};
+
 /*!
  * gather MegRay unique ids and build communicator, use hash for deduplication
  */
@@ -36,8 +47,12 @@ private:
     void emplace(uint64_t hash, std::shared_ptr<MegRay::Communicator> comm);
 
     std::unordered_map<uint64_t, std::shared_ptr<MegRay::Communicator>> m_megray_comms;
+    std::unordered_map<uint64_t, std::shared_ptr<MegRayHierarchicalComm>>
+            m_hierarchical_comms;
     std::mutex m_map_mtx;
 
+    static MegRayCommBuilder* instance();
+
     static MegRayCommBuilder* sm_instance;
     static std::mutex sm_instance_mtx;
 
@@ -46,6 +61,18 @@ public:
             uint64_t hash, std::string key, uint32_t size, uint32_t rank,
             MegRay::Backend backend,
             std::shared_ptr<mgb::opr::GroupClient> group_client);
+
+    /*!
+     * \brief split the group of a communicator by the host names of ranks
+     *
+     * All the ranks of the group must call it together. nullptr is returned
+     * if there is only one host, one rank on each host, or different numbers
+     * of ranks on the hosts.
+     */
+    static std::shared_ptr<MegRayHierarchicalComm> get_hierarchical_comm(
+            uint64_t hash, std::string key, uint32_t size, uint32_t rank,
+            MegRay::Backend backend,
+            std::shared_ptr<mgb::opr::GroupClient> group_client);
 };
 
 }  // namespace opr
@@ -45,6 +45,10 @@ public:
 
     uint32_t group_barrier(uint32_t size, uint32_t rank) override;
 
+    std::vector<std::string> gather_hosts(
+            const std::string& key, uint32_t size, uint32_t rank,
+            const std::string& host) override;
+
     const std::string& get_addr() const override { return m_addr; }
 
 private:
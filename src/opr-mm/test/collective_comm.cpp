@@ -1790,3 +1790,27 @@ TEST(TestOprCollectiveComm, AllToAllWithGradThisNodeOnly) {
     MGB_ASSERT_TENSOR_EQ(host_expect_grad0, host_grad0);
     MGB_ASSERT_TENSOR_EQ(host_expect_grad1, host_grad1);
 }
+
+TEST(TestOprCollectiveComm, GatherHosts) {
+    auto client = std::make_shared<test::MockGroupClient>();
+    std::vector<std::string> hosts[3];
+    auto run = [&](uint32_t rank) {
+        hosts[rank] = client->gather_hosts(
+                "gather_hosts", 3, rank, "host" + std::to_string(rank / 2));
+    };
+    std::thread t0(run, 0), t1(run, 1), t2(run, 2);
+    t0.join();
+    t1.join();
+    t2.join();
+    std::vector<std::string> expect{"host0", "host0", "host1"};
+    for (auto&& i : hosts) {
+        ASSERT_EQ(expect, i);
+    }
+    // the key can be used again after all ranks leave
+    hosts[0].clear();
+    std::thread t3(run, 0), t4(run, 1), t5(run, 2);
+    t3.join();
+    t4.join();
+    t5.join();
+    ASSERT_EQ(expect, hosts[0]);
+}
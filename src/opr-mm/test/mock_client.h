@@ -49,6 +49,12 @@ public:
         return m_mgr.group_barrier(size, rank);
     }
 
+    std::vector<std::string> gather_hosts(
+            const std::string& key, uint32_t size, uint32_t rank,
+            const std::string& host) override {
+        return m_mgr.gather_hosts(key, size, rank, host);
+    }
+
 private:
     const std::string m_addr;
     opr::GroupManager m_mgr;
@@ -1151,8 +1151,23 @@ void Reduce::KernScheduler::init_shapes(
                 return ishp.shape[a.kparam.axis] > ishp.shape[b.kparam.axis];
             });
 
-    // init kparam input/output layout
-    setup_kern_params_layout_and_mode(mode, inp_dtype, ishp, data_type);
+    auto dev_type = comp_node.device_type();
+    if (m_kern_param.size() >= 2 && data_type == Param::DataType::DEFAULT &&
+        inp_dtype.category() != DTypeCategory::QUANTIZED &&
+        (dev_type == CompNode::DeviceType::CPU ||
+         dev_type == CompNode::DeviceType::MULTITHREAD)) {
+        // the CPU kernels reduce all the axes in one pass over the input,
+        // rather than writing and reading back the intermediate results
+        m_kern_param.clear();
+        m_kern_param.push_back({mode, megdnn::Reduce::TARGET_SHAPE_AXIS});
+        auto&& kern = m_kern_param[0];
+        kern.input.layout = {ishp, inp_dtype};
+        kern.output.layout = {oshp, inp_dtype};
+        ishp = oshp;
+    } else {
+        // init kparam input/output layout
+        setup_kern_params_layout_and_mode(mode, inp_dtype, ishp, data_type);
+    }
 
     // init workspace size
     memset(m_workspace_spec, 0, sizeof(m_workspace_spec));
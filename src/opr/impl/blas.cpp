@@ -510,6 +510,16 @@ MGB_IMPL_OPR_GRAD(MatrixInverse) {
 }
 #endif
 
+/* ================= BlockSparseMatrixMul =================  */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(BlockSparseMatrixMul);
+MEGDNN_OPR_INIT4(BlockSparseMatrixMul, "block_sparse_matmul")
+
+/* ================= WeightQuantMatrixMul =================  */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(WeightQuantMatrixMul);
+MEGDNN_OPR_INIT3(WeightQuantMatrixMul, "weight_quant_matmul")
+
 /* ================= SVD =================  */
 
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(SVD);
@@ -91,6 +91,8 @@ MGB_SEREG_OPR(BatchedMatrixMulV2, 2);
 MGB_SEREG_OPR(Dot, 2);
 MGB_SEREG_OPR(MatrixInverse, 1);
 MGB_SEREG_OPR(SVD, 1);
+MGB_SEREG_OPR(BlockSparseMatrixMul, 4);
+MGB_SEREG_OPR(WeightQuantMatrixMul, 3);
 
 }  // namespace opr
 
@@ -139,9 +139,16 @@ void CustomOpNode::do_execute(ExecEnv& env) {
                 custom::to_custom<DeviceTensorND, custom::Tensor>(inputs);
         std::vector<custom::Tensor> custom_outputs =
                 custom::to_custom<DeviceTensorND, custom::Tensor>(outputs);
-        m_op->compute(custom_inputs, m_param, custom_outputs);
-        // [TODO] sync should be modified
-        CompNode::sync_all();
+        if (m_op->has_runtime_compute(to_custom_device(m_comp_node).str())) {
+            // the kernels are submitted to the comp node in order, so there is
+            // no need to sync
+            custom::RuntimeArgs args(to_custom_device(m_comp_node));
+            m_op->compute(custom_inputs, m_param, custom_outputs, args);
+        } else {
+            m_op->compute(custom_inputs, m_param, custom_outputs);
+            // [TODO] sync should be modified
+            CompNode::sync_all();
+        }
 
         this->owner_graph()->event().signal_inplace<cg::event::AfterKernel>(
                 this, m_comp_node);
@@ -289,20 +289,25 @@ MGB_IMPL_OPR_GRAD(BatchNormForward) {
             }
             return ret;
         case BatchNorm::Param::FwdMode::INFERENCE:
+            // grad of the fused relu; training handles it with the mask in reserve
+            SymbolVar y_grad = out_grad[5];
+            if (opr.param().nonlineMode == BatchNorm::Param::NonlineMode::RELU) {
+                y_grad = Elemwise::make(
+                        {opr.output(5), y_grad}, Elemwise::Mode::SWITCH_GT0);
+            }
             auto sqrt_var = PowC::make(
                     (SymbolVar{opr.input(4)} +
                      static_cast<dt_float32>(opr.param().epsilon)),
                     0.5, opr.config());
             auto d_bn_scale_unreduced =
-                    SymbolVar{out_grad[5]} *
-                    (SymbolVar{opr.input(0)} - SymbolVar{opr.input(3)}) / sqrt_var;
+                    y_grad * (SymbolVar{opr.input(0)} - SymbolVar{opr.input(3)}) /
+                    sqrt_var;
             auto d_bn_scale = Reduce::make(
                     d_bn_scale_unreduced, Reduce::Param::Mode::SUM,
                     GetVarShape::make(opr.input(1)));
             auto d_bn_bias = Reduce::make(
-                    out_grad[5], Reduce::Param::Mode::SUM,
-                    GetVarShape::make(opr.input(2)));
-            auto dx = SymbolVar{out_grad[5]} * SymbolVar{opr.input(1)} / sqrt_var;
+                    y_grad, Reduce::Param::Mode::SUM, GetVarShape::make(opr.input(2)));
+            auto dx = y_grad * SymbolVar{opr.input(1)} / sqrt_var;
 
             ret[0] = dx.node();
             ret[1] = d_bn_scale.node();
@@ -17,6 +17,7 @@
 
 #include "megbrain/graph/grad_impl.h"
 #include "megbrain/system.h"
+#include "megbrain/utils/hash.h"
 #include "megbrain/utils/hash_ct.h"
 #include "megbrain/utils/timer.h"
 
@@ -146,7 +147,81 @@ void mixin::WeightPreprocessExecutor::mixin_update_preprocessed_filter(
                 new_layout[i].format};
         m_preprocessed_filter->tensors[i] = m_filter_storage[i].as_megdnn();
     }
+
+    auto cn = opr.output(0)->comp_node();
+    auto cache_key = make_preprocess_cache_key(opr);
+    std::string category;
+    if (!cache_key.empty()) {
+        category = "weight_preprocess:" +
+                   PersistentCache::make_category_from_comp_node(cn);
+        auto value = PersistentCache::inst().get(
+                category, {cache_key.data(), cache_key.size()});
+        size_t size = 0;
+        for (auto&& i : m_filter_storage) {
+            size += i.layout().span().dist_byte();
+        }
+        if (value.valid() && value->size == size) {
+            //! the comp node has been synchronized in computing the key, so
+            //! the storage can be written on host directly
+            auto src = static_cast<const dt_byte*>(value->ptr);
+            for (auto&& i : m_filter_storage) {
+                auto span = i.layout().span();
+                memcpy(i.raw_ptr() + span.low_byte, src, span.dist_byte());
+                src += span.dist_byte();
+            }
+            mark_preprocessed_weight_no_need();
+            return;
+        }
+    }
     scn_do_execute_preprocess();
+    mark_preprocessed_weight_no_need();
+    if (!cache_key.empty()) {
+        //! put the preprocessed filter to the cache after it is computed
+        auto put = [category, cache_key, storage = m_filter_storage]() {
+            std::string value;
+            for (auto&& i : storage) {
+                auto span = i.layout().span();
+                value.append(
+                        reinterpret_cast<const char*>(i.raw_ptr() + span.low_byte),
+                        span.dist_byte());
+            }
+            PersistentCache::inst().put(
+                    category, {cache_key.data(), cache_key.size()},
+                    {value.data(), value.size()});
+        };
+        cn.add_callback(put);
+    }
+}
+
+std::string mixin::WeightPreprocessExecutor::make_preprocess_cache_key(
+        const cg::OperatorNodeBase& opr) {
+    auto&& options = opr.owner_graph()->options();
+    auto cn = opr.output(0)->comp_node();
+    //! the weights are hashed on host, so only CPU is supported; the kernels
+    //! are not executed in fake exec
+    if (!options.graph_opt.weight_preprocess_cache || options.fake_next_exec ||
+        cn.device_type() != CompNode::DeviceType::CPU) {
+        return {};
+    }
+    auto key = preprocess_param_blob();
+    if (key.empty()) {
+        return {};
+    }
+    //! the weights are copied to the comp node asynchronously when loading
+    cn.sync();
+    for (size_t i = 1; i < opr.input().size(); ++i) {
+        auto var = opr.input(i);
+        if (!var->contain_flag(VarNode::Flag::PERSISTENT_DEVICE_VALUE)) {
+            continue;
+        }
+        auto&& value = var->dev_tensor();
+        auto span = value.layout().span();
+        XXHash hasher;
+        hasher.update(value.raw_ptr() + span.low_byte, span.dist_byte());
+        uint64_t hash = hasher.digest();
+        key.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    }
+    return key;
 }
 
 void mixin::WeightPreprocessExecutor::record_preprocessed_weight(
@@ -155,6 +230,42 @@ void mixin::WeightPreprocessExecutor::record_preprocessed_weight(
             std::move(m_preprocessed_filter), std::move(m_filter_storage)});
 }
 
+namespace {
+void append_execution_policy(std::string& blob, const megdnn::ExecutionPolicy& policy) {
+    auto&& algo = policy.algo;
+    blob.append(
+            reinterpret_cast<const char*>(&algo.handle_type), sizeof(algo.handle_type));
+    blob.append(reinterpret_cast<const char*>(&algo.type), sizeof(algo.type));
+    blob.append(algo.name).push_back('\0');
+    blob.append(algo.param).push_back('\0');
+    for (auto&& sub : policy.sub_policy) {
+        append_execution_policy(blob, sub);
+    }
+}
+
+//! the layouts, the param and the algorithms of a weight preprocess opr, or
+//! empty if its algorithm is not decided
+template <typename Param>
+std::string make_preprocess_param_blob(
+        const cg::OperatorNodeBase& opr, const Param& param,
+        const megdnn::ExecutionPolicy& policy) {
+    if (!policy.algo.valid()) {
+        return {};
+    }
+    TensorLayoutArray layouts;
+    for (auto&& i : opr.input()) {
+        layouts.push_back(i->layout());
+    }
+    layouts.push_back(opr.output(0)->layout());
+    AlgoChooserProfileCache::Key key{
+            layouts.data(), layouts.size(), &param, sizeof(param)};
+    auto blob = key.build_blob();
+    std::string ret{static_cast<const char*>(blob.ptr), blob.size};
+    append_execution_policy(ret, policy);
+    return ret;
+}
+}  // anonymous namespace
+
 bool mixin::WeightPreprocessExecutor::mixin_allow_weight_preprocess(
         const cg::OperatorNodeBase& opr) const {
     if (!opr.owner_graph()->options().graph_opt.weight_preprocess) {
@@ -286,6 +397,9 @@ void ConvolutionForward::scn_do_execute_preprocess() {
             input(0)->layout(), input(1)->dev_tensor().as_megdnn(), output(0)->layout(),
             preprocessed_filter(),
             intl::get_megdnn_workspace_from_var(output().back()));
+}
+
+void ConvolutionForward::mark_preprocessed_weight_no_need() {
     //! Flag the input(1) no use later, which can be freed when no other
     //! var depend on its dev_value, host_value and shape.
     auto receiver_info =
@@ -296,6 +410,11 @@ void ConvolutionForward::scn_do_execute_preprocess() {
     }
 }
 
+std::string ConvolutionForward::preprocess_param_blob() {
+    return make_preprocess_param_blob(
+            *this, megdnn_opr()->param(), megdnn_opr()->execution_policy());
+}
+
 /* ==================== ConvolutionBackwardData  ==================== */
 IMPL_CONV(ConvolutionBackwardData);
 
@@ -900,6 +1019,17 @@ void ConvBiasForward::scn_do_execute_preprocess() {
                 z_layout, output(0)->layout(), preprocessed_filter(),
                 intl::get_megdnn_workspace_from_var(output().back()));
     }
+}
+
+bool ConvBiasForward::is_bias_preprocessed() {
+    if (input().size() <= 2) {
+        return false;
+    }
+    auto preprocessed_layouts = deduce_preprocessed_filter_layout();
+    return preprocessed_layouts.size() > 1 && !preprocessed_layouts[1].is_empty();
+}
+
+void ConvBiasForward::mark_preprocessed_weight_no_need() {
     //! Flag the weight and bias no use later, which can be freed when no other
     //! var depend on its dev_value, host_value and shape.
     auto receiver_info_weight =
@@ -909,21 +1039,26 @@ void ConvBiasForward::scn_do_execute_preprocess() {
         input(1)->add_flag(VarNode::Flag::MEMORY_NO_NEED);
     }
     //! if bias is preprocessd
-    if (input().size() > 2) {
-        auto preprocessed_layouts = megdnn_opr()->deduce_preprocessed_filter_layout(
-                input(0)->layout(), input(1)->layout(), bias_layout, z_layout,
-                output(0)->layout());
-        if (preprocessed_layouts.size() > 1 && !preprocessed_layouts[1].is_empty()) {
-            auto receiver_info_bias =
-                    input(2)->owner_graph()->var_receiver_in_current_comp_seq(input(2));
-            if (receiver_info_bias.dev_value == 1 &&
-                receiver_info_bias.host_value == 0 && receiver_info_bias.shape == 0) {
-                input(2)->add_flag(VarNode::Flag::MEMORY_NO_NEED);
-            }
+    if (is_bias_preprocessed()) {
+        auto receiver_info_bias =
+                input(2)->owner_graph()->var_receiver_in_current_comp_seq(input(2));
+        if (receiver_info_bias.dev_value == 1 && receiver_info_bias.host_value == 0 &&
+            receiver_info_bias.shape == 0) {
+            input(2)->add_flag(VarNode::Flag::MEMORY_NO_NEED);
         }
     }
 }
 
+std::string ConvBiasForward::preprocess_param_blob() {
+    //! the preprocessed bias can not be cached if its value may change
+    if (is_bias_preprocessed() &&
+        !input(2)->contain_flag(VarNode::Flag::PERSISTENT_DEVICE_VALUE)) {
+        return {};
+    }
+    return make_preprocess_param_blob(
+            *this, megdnn_opr()->param(), megdnn_opr()->execution_policy());
+}
+
 /* ===================== LocalShareForward ==================== */
 
 IMPL_CONV(LocalShareForward);
@@ -0,0 +1,40 @@
+/**
+ * \file src/opr/impl/dnn/fused_attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/fused_attention.h"
+#include "megbrain/graph/grad_impl.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/softmax.h"
+
+#include "../internal/megdnn_opr_wrapper.inl"
+
+using namespace mgb;
+using namespace opr;
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(FusedAttentionForward);
+MEGDNN_OPR_INIT3(FusedAttentionForward, "fused_attention")
+
+#if MGB_ENABLE_GRAD
+MGB_IMPL_OPR_GRAD(FusedAttentionForward) {
+    SymbolVar q = opr.input(0), k = opr.input(1), v = opr.input(2), dy = out_grad[0];
+    float scale = opr.param().scale;
+    auto p = Softmax::make(BatchedMatrixMul::make(q, k, {false, true}) * scale);
+    auto dp = BatchedMatrixMul::make(dy, v, {false, true});
+    auto ds = SoftmaxBackward::make(p, dp) * scale;
+    return VarNodeArray{
+            BatchedMatrixMul::make(ds, k).node(),
+            BatchedMatrixMul::make(ds, q, {true, false}).node(),
+            BatchedMatrixMul::make(p, dy, {true, false}).node()};
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,34 @@
+/**
+ * \file src/opr/impl/dnn/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/softmax.h"
+#include "megbrain/graph/grad_impl.h"
+
+#include "../internal/megdnn_opr_wrapper.inl"
+
+using namespace mgb;
+using namespace opr;
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(SoftmaxForward);
+MEGDNN_OPR_INIT1(SoftmaxForward, "softmax")
+
+#if MGB_ENABLE_GRAD
+MGB_IMPL_OPR_GRAD(SoftmaxForward) {
+    mgb_assert(wrt_idx == 0);
+    SymbolVar grad = SoftmaxBackward::make(opr.output(0), out_grad[0], opr.param());
+    return grad.node();
+}
+#endif
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(SoftmaxBackward);
+MEGDNN_OPR_INIT2(SoftmaxBackward, "softmax_bwd", 0, false);
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -392,6 +392,65 @@ MGB_IMPL_OPR_GRAD(ResizeForward) {
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(ResizeBackward);
 MEGDNN_OPR_INIT2(ResizeBackward, "resize_bwd", 1, false);
 
+/* ======================= ImagePreprocess ======================= */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(ImagePreprocess);
+MEGDNN_OPR_INIT4(ImagePreprocess, "image_preprocess")
+
+void ImagePreprocess::init_output_dtype() {
+    output(0)->dtype(dtype::Float32());
+    outshape_by_symvar_enable(3, 3);
+}
+
+void ImagePreprocess::add_input_layout_constraint() {
+    mixin::megdnn_utils::add_input_layout_constraint_contig(*this);
+}
+
+void ImagePreprocess::outshape_by_symvar_do_get_output_shape(
+        TensorShape& dest, const ShapeInferInfo& shpinfo) {
+    TensorShape oshp2d;
+    cg::copy_tensor_value_to_shape(oshp2d, *shpinfo.shpval_inp_val.at(0));
+    auto imgshp = shpinfo.shape_inp_shp.at(0);
+    mgb_assert(
+            imgshp.ndim == 4 && oshp2d.ndim == 2,
+            "shape mismatch for ImagePreprocess: img=%s out2d=%s",
+            imgshp.to_string().c_str(), oshp2d.to_string().c_str());
+    size_t N = imgshp[0], OH = oshp2d[0], OW = oshp2d[1];
+    switch (param().format) {
+        case Param::Format::NCHW:
+            dest = {N, 3, OH, OW};
+            break;
+        case Param::Format::NHWC:
+            dest = {N, OH, OW, 3};
+            break;
+        case Param::Format::NCHW44:
+            dest = {N, 1, OH, OW, 4};
+            break;
+        default:
+            mgb_throw(MegBrainError, "unsupported image preprocess format");
+    }
+}
+
+void ImagePreprocess::init_output_static_infer_desc() {
+    Super::init_output_static_infer_desc();
+    init_output_static_infer_desc_workspace(false);
+}
+
+void ImagePreprocess::scn_do_execute() {
+    intl::_MegDNNOprMethInvoker<3, 1>::exec(megdnn_opr(), this);
+}
+
+size_t ImagePreprocess::get_workspace_size_bytes(
+        const TensorShapeArray& input_shapes,
+        const TensorShapeArray& output_shapes) const {
+    return intl::_MegDNNOprMethInvoker<3, 1>::get_workspace_in_bytes(
+            megdnn_opr(), this, input_shapes, output_shapes);
+}
+
+void ImagePreprocess::record_execute_deps(ExecDependencyArray& deps) {
+    record_megdnn_opr(deps);
+}
+
 /* ======================= WarpAffineForward ======================= */
 
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(WarpAffineForward);
@@ -16,6 +16,17 @@
 
 #include "./internal/megdnn_opr_wrapper.inl"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace mgb;
 using namespace opr;
 
@@ -71,6 +82,20 @@ struct MegDNNOprInitInputsModifier<IndexingOneHot> {
 template <>
 struct MegDNNOprInitInputsModifier<IndexingSetOneHot>
         : public MegDNNOprInitInputsModifier<IndexingOneHot> {};
+
+template <>
+struct MegDNNOprInitInputsModifier<EmbeddingBag> {
+    static void apply(
+            const EmbeddingBag::Param&, std::initializer_list<SymbolVar*> inputs) {
+        auto iter = inputs.begin();
+        for (++iter; iter != inputs.end(); ++iter) {
+            SymbolVar& index = **iter;
+            if (index.dtype() != dtype::Int32()) {
+                index = opr::TypeCvt::make(index, dtype::Int32());
+            }
+        }
+    }
+};
 }  // namespace intl
 }  // namespace opr
 }  // namespace mgb
@@ -182,6 +207,109 @@ MGB_IMPL_OPR_GRAD(IndexingRemap) {
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(IndexingRemapBackward);
 MEGDNN_OPR_INIT3(IndexingRemapBackward, "indexing_remap_bwd", 2, false);
 
+/* ==================== EmbeddingBag ==================== */
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(EmbeddingBag);
+MEGDNN_OPR_INIT3(EmbeddingBag, "embedding_bag")
+
+void EmbeddingBag::init_output_dtype() {
+    output(0)->dtype(dtype::Float32());
+}
+
+HostTensorND EmbeddingBag::convert_table(const HostTensorND& table, DType dtype) {
+    mgb_assert(
+            table.dtype() == dtype::Float32() && table.shape().ndim == 2 &&
+                    table.layout().is_contiguous(),
+            "table to convert should be a contiguous matrix of Float32, got %s",
+            table.layout().to_string().c_str());
+    size_t nr_rows = table.shape(0), dim = table.shape(1);
+    auto src = table.ptr<float>();
+    HostTensorND ret{table.comp_node(), dtype};
+    if (dtype == dtype::Float32()) {
+        ret.copy_from(table);
+        return ret;
+    }
+#if !MEGDNN_DISABLE_FLOAT16
+    if (dtype == dtype::Float16()) {
+        ret.resize({nr_rows, dim});
+        auto dst = ret.ptr<dt_float16>();
+        for (size_t i = 0; i < nr_rows * dim; ++i) {
+            dst[i] = static_cast<dt_float16>(src[i]);
+        }
+        return ret;
+    }
+#endif
+    mgb_assert(
+            dtype == dtype::Uint8(), "unsupported dtype of embedding table: %s",
+            dtype.name());
+    size_t row_bytes = dim + megdnn::EmbeddingBag::QUANT_ROW_EXTRA_BYTES;
+    ret.resize({nr_rows, row_bytes});
+    for (size_t r = 0; r < nr_rows; ++r) {
+        auto row = src + r * dim;
+        auto dst = ret.ptr<dt_uint8>() + r * row_bytes;
+        float lo = dim ? *std::min_element(row, row + dim) : 0.f,
+              hi = dim ? *std::max_element(row, row + dim) : 0.f;
+        float scale = (hi - lo) / 255.f;
+        for (size_t d = 0; d < dim; ++d) {
+            float q = scale > 0.f ? std::round((row[d] - lo) / scale) : 0.f;
+            dst[d] = static_cast<dt_uint8>(std::min(std::max(q, 0.f), 255.f));
+        }
+        float scale_bias[2] = {scale, lo};
+        memcpy(dst + dim, scale_bias, sizeof(scale_bias));
+    }
+    return ret;
+}
+
+DeviceTensorND EmbeddingBag::mmap_table(
+        const std::string& path, const TensorShape& shape, DType dtype,
+        size_t offset, CompNode cn) {
+    mgb_assert(
+            cn.device_type() == CompNode::DeviceType::CPU,
+            "mmap tables are only available on cpu, got %s", cn.to_string().c_str());
+    TensorLayout layout{shape, dtype};
+    size_t size = layout.span().dist_byte();
+    mgb_assert(
+            offset % dtype.size() == 0, "offset %zu of table is not aligned to %s",
+            offset, dtype.name());
+#ifdef WIN32
+    MGB_MARK_USED_VAR(path);
+    MGB_MARK_USED_VAR(size);
+    mgb_throw(MegBrainError, "mmap tables are unavailable on windows");
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    mgb_throw_if(
+            fd < 0, MegBrainError, "failed to open %s: %s", path.c_str(),
+            strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) || static_cast<size_t>(st.st_size) < offset + size) {
+        close(fd);
+        mgb_throw(
+                MegBrainError, "file %s is too small for a table of %zu bytes at %zu",
+                path.c_str(), size, offset);
+    }
+    // mmap requires the file offset to be aligned to the page size
+    size_t page_offset = offset % static_cast<size_t>(sysconf(_SC_PAGESIZE)),
+           map_size = std::max<size_t>(size + page_offset, 1);
+    void* ptr = mmap(
+            nullptr, map_size, PROT_READ, MAP_SHARED, fd, offset - page_offset);
+    auto err = errno;
+    // the mapping holds its own reference to the file
+    close(fd);
+    mgb_throw_if(
+            ptr == MAP_FAILED, MegBrainError, "failed to mmap %s: %s", path.c_str(),
+            strerror(err));
+    // the lookups are random, and readahead would only waste the memory
+    madvise(ptr, map_size, MADV_RANDOM);
+    std::shared_ptr<dt_byte> refhold{
+            static_cast<dt_byte*>(ptr),
+            [map_size](dt_byte* p) { munmap(p, map_size); }};
+    DeviceTensorStorage storage;
+    storage.reset(cn, size, {refhold, refhold.get() + page_offset});
+    DeviceTensorND ret;
+    ret.reset(storage, layout);
+    return ret;
+#endif
+}
+
 /* ================= IndexingMultiAxisVecMegDNNOprHolder ================= */
 template <class Opr>
 Opr& mixin::IndexingMultiAxisVecMegDNNOprHolder<Opr>::megdnn_opr(
@@ -367,6 +495,17 @@ WARN(IndexingMultiAxisVec);
 WARN(IndexingSetMultiAxisVec);
 WARN(IndexingIncrMultiAxisVec);
 #undef WARN
+
+//! forward the deterministic_accumulation graph option to the megdnn opr
+template <class Opr>
+std::enable_if_t<std::is_base_of<megdnn::IndexingModifyMultiAxisVecBase, Opr>::value>
+set_deterministic(Opr& opr, cg::ComputingGraph* graph) {
+    opr.set_deterministic(graph->options().deterministic_accumulation);
+}
+
+template <class Opr>
+std::enable_if_t<!std::is_base_of<megdnn::IndexingModifyMultiAxisVecBase, Opr>::value>
+set_deterministic(Opr&, cg::ComputingGraph*) {}
 }  // anonymous namespace
 
 template <class Opr>
@@ -431,7 +570,9 @@ void intl::IndexingModifyMultiAxisVecHelper<Opr>::scn_do_execute() {
                 mgb_throw(MegBrainError, "bad modify type");
         }
     } else {
-        this->megdnn_opr(*this).exec(
+        auto&& opr = this->megdnn_opr(*this);
+        set_deterministic(opr, this->owner_graph());
+        opr.exec(
                 inp.first.as_megdnn(), inp.second.as_megdnn(), index_desc.first,
                 intl::get_megdnn_workspace_from_var(output(1)));
     }
@@ -29,6 +29,7 @@ MGB_SEREG_OPR(IndexingOneHot, 2);
 MGB_SEREG_OPR(IndexingRemap, 2);
 MGB_SEREG_OPR(IndexingRemapBackward, 3);
 MGB_SEREG_OPR(IndexingSetOneHot, 3);
+MGB_SEREG_OPR(EmbeddingBag, 3);
 }  // namespace opr
 }  // namespace mgb
 
@@ -151,6 +151,8 @@ bool WorkspaceLimitGetter::is_prealloc_run(ComputingGraph* graph) {
     return false;
 }
 
+void WorkspaceLimitGetter::force_reinfer(ComputingGraph*) {}
+
 #else
 
 class WorkspaceLimitGetter::Impl final : public UserDataContainer::UserData {
@@ -242,6 +244,8 @@ public:
     VarNode* first_run_var() const { return m_first_run_var; }
 
     bool is_prealloc_run() const { return !m_first_alloc_finished; }
+
+    void force_reinfer() { ++*m_static_infer_rerun_marker; }
 };
 MGB_TYPEINFO_OBJ_IMPL(WorkspaceLimitGetter::Impl);
 
@@ -269,6 +273,13 @@ bool WorkspaceLimitGetter::is_prealloc_run(ComputingGraph* graph) {
            get_impl(graph)->is_prealloc_run();
 }
 
+void WorkspaceLimitGetter::force_reinfer(ComputingGraph* graph) {
+    auto container = graph->options().user_data.get_user_data<Impl>();
+    if (container.second) {
+        container.first[0]->force_reinfer();
+    }
+}
+
 VarNode* WorkspaceLimitGetter::register_to_graph(ComputingGraph* graph) {
     if (graph->options().imperative_proxy_graph) {
         return nullptr;
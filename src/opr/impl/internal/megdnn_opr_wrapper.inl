@@ -77,6 +77,14 @@ public:
     //! return 0
     static bool is_prealloc_run(ComputingGraph* graph);
 
+    /*!
+     * \brief force re-computation of workspace sizes, and thus algo setup,
+     *      of the oprs in a graph on next execution
+     *
+     * It must be called from the thread that executes the graph.
+     */
+    static void force_reinfer(ComputingGraph* graph);
+
     /*!
      * \brief register WorkspaceLimitGetter in a graph
      * \return an var to be added as extra value dep for workspace
@@ -601,6 +601,7 @@ void LoopImpl::add_input_layout_constraint() {
         if (!i->param().has_assign)
             i->orig_var()->add_layout_constraint_contiguous();
     }
+    m_body_recordable = -1;
     m_nr_scn_do_execute_run = 0;
     for (auto&& i : m_desc->output_record_spec()) {
         auto used = owner_graph()
@@ -610,6 +611,60 @@ void LoopImpl::add_input_layout_constraint() {
     }
 }
 
+bool LoopImpl::check_body_recordable() {
+    if (m_body_recordable != -1)
+        return m_body_recordable;
+    m_body_recordable = 0;
+
+    auto&& opt = owner_graph()->options();
+    // LoopGrad and mutable state savers rely on host logic in each iteration
+    if (!opt.enable_loop_body_record || opt.comp_node_seq_record_level ||
+        !same_type<Loop>() || m_mutable_state_saver) {
+        return false;
+    }
+
+    auto cn = m_desc->counter_provider()->comp_node();
+    if (cn.device_type() != CompNode::DeviceType::CPU ||
+        cn.locator().device == CompNode::Locator::DEVICE_CPU_DEFAULT) {
+        return false;
+    }
+
+    for (auto&& i : m_desc->output_record_spec()) {
+        // LAST is forwarded from dynamic storage and ALL writes to a
+        // different subtensor in each iteration
+        if (i.enabled() && i.recorder()->output_mode() != Desc::OutputMode::SUM)
+            return false;
+    }
+
+    auto cond_var = m_desc->loop_cond_manager().var().node();
+    if (!cg::is_static_var_value(cond_var))
+        return false;
+
+    bool recordable = true;
+    m_sub_graph_func->iter_opr_seq([&](OperatorNodeBase* opr) {
+        for (auto&& dep : opr->node_prop().dep_map()) {
+            // host values may change with the counter, but they would not be
+            // seen by replayed kernels; the loop cond is only checked on the
+            // last iteration, which is executed normally
+            if ((dep.second & NodeProp::DepType::HOST_VALUE) &&
+                dep.first != cond_var && !cg::is_const_var_value(dep.first)) {
+                recordable = false;
+                return false;
+            }
+        }
+        for (auto i : opr->output()) {
+            // memory allocation is disallowed during recording
+            if (!cg::is_static_var_storage(i)) {
+                recordable = false;
+                return false;
+            }
+        }
+        return true;
+    });
+    m_body_recordable = recordable;
+    return recordable;
+}
+
 void LoopImpl::scn_do_execute() {
     init_sub_graph_func();
 
@@ -630,6 +685,26 @@ void LoopImpl::scn_do_execute() {
         m_sub_graph_func->execute();
     };
 
+    // record kernels of one iteration (including the counter update, which
+    // must be ordered with the body) and replay them for *nr_iter* times
+    auto exec_recorded = [&](size_t nr_iter) {
+        auto counter = m_desc->counter_provider();
+        auto cn = counter->comp_node();
+        auto recorder = cn.create_seq_recorder(m_desc->sub_graph());
+        mgb_assert(recorder);
+        m_desc->update_counter_provider();
+        m_sub_graph_func->execute();
+        recorder->stop(cn);
+
+        // kernels of previous iterations may still be queued on the comp
+        // node, while the recorded ones are replayed in current thread
+        cn.sync();
+        for (size_t i = 0; i < nr_iter; ++i) {
+            recorder->replay();
+        }
+        counter->advance_host_next_val(nr_iter - 1);
+    };
+
     auto&& cond_manager = m_desc->loop_cond_manager();
 
     if (m_static_loop_time_infer) {
@@ -638,7 +713,15 @@ void LoopImpl::scn_do_execute() {
         mgb_assert(nr_loop >= 1);
 
         if (nr_loop > 1) {
-            for (size_t i = 0; i < nr_loop - 1; ++i) {
+            size_t i = 0;
+            if (nr_loop > 3 && check_body_recordable()) {
+                // the first and last iterations are executed normally, so
+                // static memory and host states are set up and finalized
+                exec();
+                exec_recorded(nr_loop - 2);
+                i = nr_loop - 1;
+            }
+            for (; i < nr_loop - 1; ++i) {
                 exec();
             }
             mgb_assert(cond_manager.should_loop());
@@ -388,6 +388,13 @@ public:
     //! update next value by adding delta to it
     void update_next_val();
 
+    /*!
+     * \brief update host next value as if update_next_val() has been
+     *      called for *nr* times; the device value must be updated by the
+     *      caller (i.e. by replaying recorded update_next_val() kernels)
+     */
+    void advance_host_next_val(int nr) { m_next_val += m_delta * nr; }
+
     //! set next valud that this CounterProvider would produce
     void next_val(int v);
 
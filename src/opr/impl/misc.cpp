@@ -496,4 +496,116 @@ struct MegDNNOprInitPostCtor<CheckNonFinite> {
 }  // namespace mgb
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(CheckNonFinite);
 MEGDNN_OPR_INIT1(CheckNonFinite, "check_non_finite")
+
+/* ================= CheckNonFiniteV2 =================  */
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(CheckNonFiniteV2);
+
+CheckNonFiniteV2::CheckNonFiniteV2(
+        const VarNodeArrayView& inp, const Param& param,
+        const OperatorNodeConfig& config)
+        : Super{inp[0]->owner_graph(), config, "check_non_finite", inp},
+          m_param{param} {
+    for (auto i : inp) {
+        mgb_assert(
+                i->dtype() == dtype::Float32(),
+                "inputs of CheckNonFiniteV2 should be float32, got %s",
+                i->dtype().name());
+        add_input({i});
+    }
+    for (size_t i = 0; i < inp.size(); ++i) {
+        add_output(ssprintf("o%zu", i))
+                ->dtype(dtype::Float32())
+                .add_flag(VarNode::Flag::ALLOW_EMPTY_SHAPE);
+    }
+    add_output(ssprintf("o%zu", inp.size()))->dtype(dtype::Int32());
+    cg::add_workspace_output(this);
+    add_equivalence_component<PODHash<Param>>(&m_param);
+}
+
+SymbolVarArray CheckNonFiniteV2::make(
+        const VarNodeArrayView& inp, const Param& param,
+        const OperatorNodeConfig& config) {
+    mgb_assert(!inp.empty(), "CheckNonFiniteV2 expects at least one input");
+    auto&& out = inp[0]->owner_graph()
+                         ->insert_opr(std::make_unique<CheckNonFiniteV2>(
+                                 inp, param, config))
+                         ->output();
+    // exclude the workspace
+    return {out.begin(), out.end() - 1};
+}
+
+CheckNonFiniteV2::NodeProp* CheckNonFiniteV2::do_make_node_prop() const {
+    auto ret = Super::do_make_node_prop();
+    for (auto i : input()) {
+        ret->add_dep_type_existing_var(i, NodeProp::DepType::VALUE_ALLOW_EMPTY);
+    }
+    return ret;
+}
+
+void CheckNonFiniteV2::create_megdnn_opr() {
+    auto opr = intl::get_megdnn_handle(comp_node())
+                       ->create_operator<megdnn::CheckNonFiniteV2>();
+    opr->param() = m_param;
+    set_megdnn_opr(std::move(opr));
+}
+
+void CheckNonFiniteV2::mem_plan_fwd_in2out_writable() {
+    for (size_t i = 0; i < input().size(); ++i) {
+        if (input(i)->layout().is_contiguous()) {
+            output(i)->set_fwd_in2out_writable(input(i));
+        }
+    }
+}
+
+void CheckNonFiniteV2::scn_do_execute() {
+    size_t nr_inp = input().size();
+    megdnn::TensorNDArray srcs;
+    for (size_t i = 0; i < nr_inp; ++i) {
+        auto&& inp = input(i)->dev_tensor();
+        auto&& out = output(i)->dev_tensor();
+        if (out.shape().is_empty()) {
+            continue;
+        }
+        if (inp.raw_ptr() != out.raw_ptr()) {
+            out.copy_from_fixlayout(inp);
+        }
+        srcs.push_back(out.as_megdnn());
+    }
+    static_cast<megdnn::CheckNonFiniteV2*>(megdnn_opr())
+            ->exec(srcs, output(nr_inp)->dev_tensor().as_megdnn(),
+                   intl::get_megdnn_workspace_from_var(output(nr_inp + 1)));
+}
+
+void CheckNonFiniteV2::init_output_static_infer_desc() {
+    using namespace cg::static_infer;
+    auto&& mgr = owner_graph()->static_infer_manager();
+    size_t nr_inp = input().size();
+    DepVal deps;
+    for (size_t i = 0; i < nr_inp; ++i) {
+        mgr.register_shape_infer(output(i), ShapeInferDesc::make_identity(input(i)));
+        deps.push_back({input(i), DepType::SHAPE});
+    }
+    mgr.register_shape_infer(output(nr_inp), ShapeInferDesc::make_const({1}));
+
+    auto infer_workspace = [this](TensorShape& dest, const InpVal& inp) {
+        megdnn::TensorNDArray srcs;
+        for (auto&& i : inp.val) {
+            if (!i.shape().is_empty()) {
+                srcs.push_back({nullptr, {i.shape(), dtype::Float32()}});
+            }
+        }
+        dest.ndim = 1;
+        dest.shape[0] =
+                static_cast<megdnn::CheckNonFiniteV2*>(megdnn_opr())
+                        ->get_workspace_in_bytes(srcs, {{1}, dtype::Int32()});
+        return true;
+    };
+    mgr.register_shape_infer(
+            output(nr_inp + 1), {SourceType::DEP, deps, infer_workspace});
+}
+
+void CheckNonFiniteV2::record_execute_deps(ExecDependencyArray& deps) {
+    record_megdnn_opr(deps);
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
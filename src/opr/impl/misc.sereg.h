@@ -55,6 +55,19 @@ struct OprMaker<opr::TopK, 2> {
     }
 };
 
+template <>
+struct OprMaker<opr::CheckNonFiniteV2, 0> {
+    using Opr = opr::CheckNonFiniteV2;
+    using Param = Opr::Param;
+    static cg::OperatorNodeBase* make(
+            const Param& param, const cg::VarNodeArray& inputs, ComputingGraph& graph,
+            const OperatorNodeConfig& config) {
+        MGB_MARK_USED_VAR(graph);
+        auto out = Opr::make(inputs, param, config);
+        return out[0].node()->owner_opr();
+    }
+};
+
 }  // namespace serialization
 
 namespace opr {
@@ -73,6 +86,7 @@ MGB_SEREG_OPR(CumsumV1, 1);
 MGB_SEREG_OPR(NvOf, 1);
 #endif
 MGB_SEREG_OPR(CheckNonFinite, 1);
+MGB_SEREG_OPR(CheckNonFiniteV2, 0);
 
 }  // namespace opr
 }  // namespace mgb
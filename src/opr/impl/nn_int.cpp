@@ -11,6 +11,10 @@
 #include "megbrain/opr/nn_int.h"
 #include "./internal/megdnn_opr_wrapper.inl"
 
+#include "megbrain/graph/grad_impl.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/tensor_manip.h"
+#include "megbrain/opr/utility.h"
 #include "megdnn/oprs/general.h"
 
 using namespace mgb;
@@ -77,4 +81,93 @@ void ElemwiseMultiType::record_execute_deps(ExecDependencyArray& deps) {
     record_megdnn_opr(deps);
 }
 
+/* f{{{ ElemwiseMultiOutput */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(ElemwiseMultiOutput);
+
+ElemwiseMultiOutput::ElemwiseMultiOutput(
+        const VarNodeArrayView& inputs, Param param, const OperatorNodeConfig& config)
+        : Super{inputs.at(0)->owner_graph(), config, "elemwise_multi_output",
+                inputs} {
+    Super::init_megdnn_opr(*this, param);
+    for (auto i : inputs) {
+        add_input({i});
+    }
+}
+
+SymbolVarArray ElemwiseMultiOutput::make(
+        const VarNodeArrayView& inputs, Param param, const OperatorNodeConfig& config) {
+    mgb_assert(!inputs.empty());
+    auto&& out = inputs[0]->owner_graph()
+                         ->insert_opr(std::make_unique<ElemwiseMultiOutput>(
+                                 inputs, param, config))
+                         ->output();
+    return {out.begin(), out.end()};
+}
+
+void ElemwiseMultiOutput::init_output_dtype() {
+    auto nr_inp = megdnn::ElemwiseMultiOutput::nr_inputs(param().mode);
+    mgb_throw_if(
+            nr_inp != input().size(), MegBrainError,
+            "ElemwiseMultiOutput requires %zu inputs, but %zu are given", nr_inp,
+            input().size());
+    auto dtype = input(0)->dtype();
+    for (auto i : input()) {
+        mgb_throw_if(
+                i->dtype() != dtype, MegBrainError,
+                "ElemwiseMultiOutput inputs must have the same dtype");
+    }
+    output(0)->dtype(dtype);
+    output(1)->dtype(dtype);
+}
+
+void ElemwiseMultiOutput::scn_do_execute() {
+    megdnn::TensorNDArray inp_arr(input().size());
+    for (size_t i = 0; i < input().size(); ++i) {
+        inp_arr[i] = input()[i]->dev_tensor().as_megdnn();
+    }
+    megdnn_opr()->exec(
+            inp_arr, {output(0)->dev_tensor().as_megdnn(),
+                      output(1)->dev_tensor().as_megdnn()});
+}
+
+void ElemwiseMultiOutput::get_output_var_shape(
+        const TensorShapeArray& inp_shape, TensorShapeArray& out_shape) const {
+    mgb_assert(out_shape.size() == 2);
+    megdnn::Elemwise::deduce_shape(inp_shape, out_shape[0]);
+    out_shape[1] = out_shape[0];
+}
+
+void ElemwiseMultiOutput::record_execute_deps(ExecDependencyArray& deps) {
+    record_megdnn_opr(deps);
+}
+
+#if MGB_ENABLE_GRAD
+MGB_IMPL_OPR_GRAD(ElemwiseMultiOutput) {
+    if (opr.param().mode != ElemwiseMultiOutput::Mode::SIGMOID_MUL) {
+        return InvalidGrad::make(opr, wrt_idx);
+    }
+    // s = sigmoid(x), z = s * y
+    SymbolVar y = opr.input(1), s = opr.output(0), result;
+    SymbolVar ds = out_grad.at(0), dz = out_grad.at(1);
+    if (wrt_idx == 1) {
+        if (!dz.node())
+            return nullptr;
+        result = dz * s;
+    } else {
+        SymbolVar grad_s;
+        if (dz.node())
+            grad_s = dz * y;
+        if (ds.node())
+            grad_s = grad_s.node() ? grad_s + ds : ds;
+        if (!grad_s.node())
+            return nullptr;
+        result = grad_s * s * (1 - s);
+    }
+    return reduce_sum(result, GetVarShape::make(opr.input(wrt_idx))).node();
+}
+#endif
+
+/* f}}} */
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -18,10 +18,22 @@ template <>
 struct OprMaker<opr::ElemwiseMultiType, 0>
         : public OprMakerVariadic<opr::ElemwiseMultiType> {};
 
+template <>
+struct OprMaker<opr::ElemwiseMultiOutput, 0> {
+    using Opr = opr::ElemwiseMultiOutput;
+    static cg::OperatorNodeBase* make(
+            const Opr::Param& param, const cg::VarNodeArray& inputs,
+            ComputingGraph& graph, const OperatorNodeConfig& config) {
+        MGB_MARK_USED_VAR(graph);
+        return Opr::make(inputs, param, config)[0].node()->owner_opr();
+    }
+};
+
 }  // namespace serialization
 
 namespace opr {
 MGB_SEREG_OPR(ElemwiseMultiType, 0);
+MGB_SEREG_OPR(ElemwiseMultiOutput, 0);
 MGB_SEREG_OPR(AffineInt, 3);
 }  // namespace opr
 }  // namespace mgb
@@ -11,12 +11,15 @@
  */
 
 #include "megbrain/opr/search_policy/algo_chooser.h"
+#include <atomic>
 #include <limits>
 #include <unordered_set>
+#include "megbrain/graph/event.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/internal/megdnn_opr_wrapper.h"
 #include "megbrain/opr/search_policy/algo_chooser_helper.h"
 #include "megbrain/opr/search_policy/profiler.h"
+#include "megbrain/utils/async_worker.h"
 
 #include "../internal/invoke.h"
 #include "../internal/megdnn_opr_wrapper.inl"
@@ -322,6 +325,108 @@ static Algorithm::Info::Desc deserialize_read_pod(
     return ret;
 }
 
+//! whether current thread runs background profiling, in which case the
+//! workspace limit has been resolved when the task is scheduled
+thread_local bool tl_in_background_profiling = false;
+
+size_t resolve_workspace_limit(
+        cg::ComputingGraph* graph, CompNode cn, size_t old_limit) {
+    if (tl_in_background_profiling) {
+        return old_limit;
+    }
+    return WorkspaceLimitGetter::get_workspace_limit(graph, cn, old_limit);
+}
+
+//! round each dim of the layouts up to a multiple of \p bucket_size
+template <size_t N>
+void round_to_shape_bucket(std::array<TensorLayout, N>& layouts, size_t bucket_size) {
+    for (auto&& layout : layouts) {
+        if (!layout.ndim) {
+            continue;
+        }
+        bool contig = layout.is_contiguous();
+        for (size_t i = 0; i < layout.ndim; ++i) {
+            layout[i] = (layout[i] + bucket_size - 1) / bucket_size * bucket_size;
+        }
+        if (contig) {
+            layout.init_contiguous_stride();
+        }
+    }
+}
+
+/*!
+ * \brief run fastrun profiling of a graph in a low priority background thread
+ *
+ * When some tasks have finished, workspace infer of the graph is forced to
+ * rerun on next execution, so the oprs switch to the profiled algos between
+ * two executions.
+ *
+ * It is stored as user data of the graph, which is destroyed before the
+ * operators, so pending tasks referring to the operators are finished in the
+ * destructor. The tasks must not access the user data of the graph since it is
+ * being cleared at that time.
+ */
+class BackgroundProfiler final : public UserDataContainer::UserData {
+    MGB_TYPEINFO_OBJ_DECL;
+
+    std::mutex m_mtx;
+    //! keys of the layouts that have been scheduled
+    std::unordered_set<std::string> m_scheduled;
+    std::vector<FutureThreadPool<void>::Future> m_futures;
+    std::atomic_size_t m_nr_finished{0};
+    size_t m_nr_applied = 0;
+    FutureThreadPool<void> m_pool{std::string{"fastrun_bg"}};
+
+    void on_exec_start(const cg::event::CompSeqExecBeforeStart& ev) {
+        size_t nr_finished = m_nr_finished;
+        if (nr_finished != m_nr_applied) {
+            m_nr_applied = nr_finished;
+            WorkspaceLimitGetter::force_reinfer(ev.graph);
+        }
+    }
+
+public:
+    explicit BackgroundProfiler(cg::ComputingGraph* graph) {
+        m_pool.start(1);
+#if MGB_HAVE_THREAD
+        m_pool.launch(sys::set_thread_low_priority);
+#endif
+        graph->event().register_receiver_permanent<cg::event::CompSeqExecBeforeStart>(
+                [this](const cg::event::CompSeqExecBeforeStart& ev) {
+                    on_exec_start(ev);
+                });
+    }
+
+    ~BackgroundProfiler() {
+        for (auto&& i : m_futures) {
+            i.get();
+        }
+        m_pool.stop();
+    }
+
+    static BackgroundProfiler& inst(cg::ComputingGraph* graph) {
+        static std::mutex mtx;
+        MGB_LOCK_GUARD(mtx);
+        auto maker = [graph]() { return std::make_shared<BackgroundProfiler>(graph); };
+        return *graph->options().user_data.get_user_data_or_create<BackgroundProfiler>(
+                maker);
+    }
+
+    //! schedule the task if no task with the same key has been scheduled
+    template <typename Func>
+    void schedule(std::string key, Func&& task) {
+        MGB_LOCK_GUARD(m_mtx);
+        if (m_scheduled.insert(std::move(key)).second) {
+            auto wrapped = [this, task = std::forward<Func>(task)]() {
+                task();
+                ++m_nr_finished;
+            };
+            m_futures.emplace_back(m_pool.launch(std::move(wrapped)));
+        }
+    }
+};
+MGB_TYPEINFO_OBJ_IMPL(BackgroundProfiler);
+
 }  // namespace
 
 namespace mgb {
@@ -508,6 +613,12 @@ AlgoChooser<Opr>::AlgoChooserHelper::AlgoChooserHelper(
                 m_fastrun_layouts, m_dnn_opr->param(), fastrun_batch_size);
     }
 
+    if (auto bucket_size = owner_graph()->options().fast_run_config.shape_bucket_size) {
+        //! layouts in a bucket share the profiling result, which is obtained
+        //! on the first layout seen in the bucket
+        round_to_shape_bucket(m_incache_layouts, bucket_size);
+    }
+
     if (owner_graph()->options().no_profiling_on_shape_change) {
         for (size_t i = 0; i < m_incache_layouts.size(); i++) {
             for (size_t j = 0; j < m_incache_layouts.at(i).ndim; j++) {
@@ -534,7 +645,7 @@ typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::AlgoChooserHelp
         choose_by_heuristic(const ExecutionStrategy& selected_strategy) const {
     MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("choose_by_heuristic")))
     ImplExecutionPolicy policy;
-    auto workspace_limit = WorkspaceLimitGetter::get_workspace_limit(
+    auto workspace_limit = resolve_workspace_limit(
             owner_graph(), m_cn, m_execution_policy.workspace_limit);
     auto attr = extract_algo_attribute(selected_strategy);
     policy.algo = APPLY(m_dnn_opr->get_algorithm_info_heuristic(
@@ -696,7 +807,7 @@ void AlgoChooser<Opr>::AlgoChooserHelper::construct_execution_policy(
                 return;
             }
         } else {
-            auto workspace_limit = WorkspaceLimitGetter::get_workspace_limit(
+            auto workspace_limit = resolve_workspace_limit(
                     owner_graph(), m_cn, m_execution_policy.workspace_limit);
 
             auto attr = extract_algo_attribute(selected_strategy);
@@ -797,9 +908,9 @@ std::vector<typename AlgoChooser<Opr>::ImplAlgo> AlgoChooser<
 }
 
 template <typename Opr>
-Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper::
-        profile_single_algo(const ImplExecutionPolicy& policy, double& timeout) const {
-    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("profile_single_algo")))
+typename TimedProfiler<Opr>::Param AlgoChooser<Opr>::AlgoChooserHelper::
+        make_profile_param(const ImplExecutionPolicy& policy) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("make_profile_param")))
     typename TimedProfiler<Opr>::Param param;
     // force check copy size <= dest len-1 from gcc8 for safe
     param.execution_policy =
@@ -822,14 +933,29 @@ Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper:
                 src.to_string().c_str());
         param.dtypes[i] = src.dtype.enumv();
     }
-    param.comp_node_physical = m_cn.locator();
-    param.comp_node_logical = m_cn.locator_logical();
+    auto cn = m_cn;
+    if (tl_in_background_profiling && cn.contain_flag(CompNode::Flag::HAS_COPY_STREAM)) {
+        // profile on a side stream to avoid blocking the running graph
+        cn = cn.change_stream(CompNode::Stream::PROFILE);
+    }
+    param.comp_node_physical = cn.locator();
+    param.comp_node_logical = cn.locator_logical();
     mgb_assert(param.shapes.size() == m_fastrun_layouts.size());
     for (size_t i = 0; i < param.shapes.size(); ++i)
         param.shapes[i] = m_fastrun_layouts[i];
     param.opr_param = m_dnn_opr->param();
     param.allow_weight_preprocess = m_allow_weight_preprocess;
+    return param;
+    MIDOUT_E
+}
 
+template <typename Opr>
+Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper::
+        profile_with_param(
+                const ImplExecutionPolicy& policy,
+                const typename TimedProfiler<Opr>::Param& param,
+                double& timeout) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("profile_with_param")))
     Algorithm* palgo = m_dnn_opr->get_algorithm_from_desc(policy.algo);
     mgb_assert(palgo, "can not find algo when profile single algo");
 
@@ -851,6 +977,70 @@ Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper:
     MIDOUT_E
 }
 
+template <typename Opr>
+Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper::
+        profile_single_algo(const ImplExecutionPolicy& policy, double& timeout) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("profile_single_algo")))
+    return profile_with_param(policy, make_profile_param(policy), timeout);
+    MIDOUT_E
+}
+
+template <typename Opr>
+std::vector<Maybe<AlgoChooserProfileCache::ResultEntry>> AlgoChooser<Opr>::
+        AlgoChooserHelper::profile_parallel(
+                const std::vector<ImplExecutionPolicy>& policies,
+                const std::vector<std::string>& msgs) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("profile_parallel")))
+    auto&& cns = owner_graph()->options().fast_run_config.parallel_profile_comp_nodes;
+    // params are constructed in this thread since get_workspace_size_bytes()
+    // modifies m_dnn_opr
+    std::vector<typename TimedProfiler<Opr>::Param> params;
+    for (auto&& policy : policies) {
+        params.emplace_back(make_profile_param(policy));
+    }
+    for (auto&& cn : cns) {
+        mgb_assert(
+                cn.device_type() == m_cn.device_type(),
+                "device type of parallel profiling comp node %s mismatches %s",
+                cn.to_string().c_str(), m_cn.to_string().c_str());
+    }
+
+    std::vector<Maybe<AlgoChooserProfileCache::ResultEntry>> ret(policies.size());
+    std::atomic_size_t next{0};
+    auto worker = [&](CompNode cn) {
+        for (size_t i; (i = next++) < policies.size();) {
+            auto param = params[i];
+            param.comp_node_physical = cn.locator();
+            param.comp_node_logical = cn.locator_logical();
+            double timeout = 0;
+            MGB_TRY { ret[i] = profile_with_param(policies[i], param, timeout); }
+            MGB_CATCH(std::exception & exc, {
+                mgb_log_warn(
+                        "caught exception during %s on %s: %s", msgs[i].c_str(),
+                        cn.to_string().c_str(), exc.what());
+            })
+            MGB_CATCH(..., {
+                mgb_log_warn(
+                        "caught exception during %s on %s", msgs[i].c_str(),
+                        cn.to_string().c_str());
+            })
+        }
+    };
+
+    FutureThreadPool<void> pool{std::string{"fastrun_par"}};
+    pool.start(cns.size());
+    std::vector<FutureThreadPool<void>::Future> futures;
+    for (auto&& cn : cns) {
+        futures.emplace_back(pool.launch(worker, cn));
+    }
+    for (auto&& i : futures) {
+        i.get();
+    }
+    pool.stop();
+    return ret;
+    MIDOUT_E
+}
+
 template <typename Opr>
 void AlgoChooser<Opr>::AlgoChooserHelper::profile(
         const ExecutionStrategy& selected_strategy) const {
@@ -865,9 +1055,9 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
             format_fixlayouts<Opr>(m_fastrun_layouts, arity_in, arity_out);
     double cur_timeout = 0;
 
-    auto workspace_limit = WorkspaceLimitGetter::get_workspace_limit(
+    auto workspace_limit = resolve_workspace_limit(
             owner_graph(), m_cn, m_execution_policy.workspace_limit);
-    RealTimer timer;
+    RealTimer total_timer, timer;
     std::unordered_set<std::string> rst_algos;
     if (rst.second.valid()) {
         std::transform(
@@ -877,13 +1067,14 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
                     return result.algo;
                 });
     }
+    std::vector<ImplExecutionPolicy> policies;
+    std::vector<std::string> msgs;
     for (auto algo : get_all_candidates()) {
         std::string desc;
         serialize_write_pod(algo.desc, desc);
         if (rst_algos.find(desc) != rst_algos.end()) {
             continue;
         }
-        Maybe<AlgoChooserProfileCache::ResultEntry> cur_rst;
 
         ImplExecutionPolicy policy;
         policy.algo = algo.desc;
@@ -908,11 +1099,35 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
             continue;
         }
 
-        std::string msg = ssprintf(
+        policies.emplace_back(std::move(policy));
+        msgs.emplace_back(ssprintf(
                 "profiling %s algorithm %s %s", m_base_mgb_opr->dyn_typeinfo()->name,
-                algo.desc.name.c_str(), layouts_str.c_str());
+                algo.desc.name.c_str(), layouts_str.c_str()));
+    }
+
+    auto&& fast_run_config = owner_graph()->options().fast_run_config;
+    bool parallel = fast_run_config.parallel_profile_comp_nodes.size() > 1 &&
+                    !tl_in_background_profiling;
+    if (parallel) {
+        auto results = profile_parallel(policies, msgs);
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!results[i].valid()) {
+                mgb_log_warn("failed when %s", msgs[i].c_str());
+                continue;
+            }
+            auto&& rst = results[i].val();
+            mgb_log_debug(
+                    "%s: workspace: %zu; time: %.3gsec", msgs[i].c_str(),
+                    rst.workspace, rst.time);
+            prof_rst.push_back(rst);
+        }
+    }
+
+    for (size_t i = 0; !parallel && i < policies.size(); ++i) {
+        auto&& msg = msgs[i];
+        Maybe<AlgoChooserProfileCache::ResultEntry> cur_rst;
         timer.reset();
-        MGB_TRY { cur_rst = profile_single_algo(policy, cur_timeout); }
+        MGB_TRY { cur_rst = profile_single_algo(policies[i], cur_timeout); }
         MGB_CATCH(std::exception & exc, {
             mgb_log_warn("caught exception during %s: %s", msg.c_str(), exc.what());
             continue;
@@ -954,11 +1169,58 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
             incache_layouts.data(), incache_layouts.size(), &origin_param,
             sizeof(origin_param)};
 
+    owner_graph()->event().template signal_inplace<cg::event::StartupPhaseFinished>(
+            "fast_run", m_base_mgb_opr->cname(), total_timer.get_msecs());
     AlgoChooserProfileCache cache(m_cn, profile_name(m_dnn_opr).c_str());
     cache.put(cache_key, prof_rst);
     MIDOUT_E
 }
 
+template <typename Opr>
+void AlgoChooser<Opr>::AlgoChooserHelper::profile_in_background(
+        const ExecutionStrategy& selected_strategy) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("profile_in_background")))
+    typename Opr::Param origin_param = m_dnn_opr->param();
+    AlgoChooserProfileCache::Key cache_key{
+            m_incache_layouts.data(), m_incache_layouts.size(), &origin_param,
+            sizeof(origin_param)};
+    auto blob = cache_key.build_blob();
+    std::string key = m_cn.to_string() + profile_name(m_dnn_opr);
+    key.append(static_cast<const char*>(blob.ptr), blob.size);
+
+    //! the task owns a megdnn opr, since m_dnn_opr is used by the graph
+    //! concurrently; the workspace limit is resolved here because the
+    //! graph may be recompiled while profiling
+    auto policy = m_execution_policy;
+    policy.workspace_limit =
+            resolve_workspace_limit(owner_graph(), m_cn, policy.workspace_limit);
+    auto task = [layouts = m_fastrun_layouts, origin_param, param_str = m_param,
+                 mgb_opr = m_base_mgb_opr, cn = m_cn, policy,
+                 allow_weight_preprocess = m_allow_weight_preprocess,
+                 selected_strategy]() {
+        auto megdnn_opr = intl::create_megdnn_opr<Opr>(cn);
+        megdnn_opr->param() = origin_param;
+        AlgoChooserHelper helper(
+                layouts, megdnn_opr.get(), param_str, mgb_opr, cn, policy,
+                allow_weight_preprocess);
+        tl_in_background_profiling = true;
+        MGB_TRY { helper.choose_by_profile(selected_strategy, true); }
+        MGB_CATCH(std::exception & exc, {
+            mgb_log_warn(
+                    "caught exception during background profiling of %s: %s",
+                    mgb_opr->cname(), exc.what());
+        })
+        MGB_CATCH(..., {
+            mgb_log_warn(
+                    "caught exception during background profiling of %s",
+                    mgb_opr->cname());
+        })
+        tl_in_background_profiling = false;
+    };
+    BackgroundProfiler::inst(owner_graph()).schedule(std::move(key), std::move(task));
+    MIDOUT_E
+}
+
 template <typename Opr>
 Maybe<PreprocessFilter<Opr>> AlgoChooser<Opr>::AlgoChooserHelper::
         construct_fake_preprocess_filter(const FixedTensorLayouts& layouts) const {
@@ -1018,11 +1280,12 @@ std::pair<AlgoAttribute, AlgoAttribute> AlgoChooser<Opr>::AlgoChooserHelper::
     //! from graph option
     // FIXME: no_profiling_on_shape_change extract USABLE_DEPEND_ON_SHAPE attribute when
     // fixed usable
-    if (owner_graph()->options().fast_run_config.shared_batch_size) {
+    auto&& fast_run_config = owner_graph()->options().fast_run_config;
+    if (fast_run_config.shared_batch_size || fast_run_config.shape_bucket_size) {
         ret.second |= AlgoAttribute::USABLE_DEPEND_ON_SHAPE;
     }
 
-    if (owner_graph()->options().fast_run_config.binary_equal_between_batch) {
+    if (fast_run_config.binary_equal_between_batch) {
         ret.first |= AlgoAttribute::REPRODUCIBLE;
         ret.second |= AlgoAttribute::ACCURACY_DEPEND_ON_BATCH;
     }
@@ -1067,6 +1330,9 @@ std::pair<AlgoAttribute, AlgoAttribute> AlgoChooser<Opr>::AlgoChooserHelper::
     AlgoChooser<megdnn::Opr>::AlgoChooserHelper::extract_algo_attribute(          \
             const ExecutionStrategy& strategy) const;                             \
     template void AlgoChooser<megdnn::Opr>::AlgoChooserHelper::profile(           \
+            const ExecutionStrategy& selected_strategy) const;                    \
+    template void                                                                 \
+    AlgoChooser<megdnn::Opr>::AlgoChooserHelper::profile_in_background(           \
             const ExecutionStrategy& selected_strategy) const;
 
 MGB_FOREACH_FASTRUN_OPR(INST)
@@ -1109,6 +1375,16 @@ typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::get_policy(
     }
 #if MGB_ENABLE_FASTRUN
     else if (opr_strategy & ExecutionStrategy::PROFILE) {
+        if (helper.owner_graph()->options().fast_run_config.background_profiling) {
+            //! use the heuristic choice until the profiling result is cached
+            ImplExecutionPolicy policy;
+            helper.construct_execution_policy(opr_strategy, policy, true, false);
+            if (!policy.algo.valid()) {
+                helper.profile_in_background(opr_strategy);
+                policy = helper.choose_by_heuristic(opr_strategy);
+            }
+            return policy;
+        }
         return helper.choose_by_profile(opr_strategy, true);
     }
 #endif
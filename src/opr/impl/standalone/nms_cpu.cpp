@@ -4,53 +4,79 @@
 #include <cstring>
 
 namespace {
-struct Box {
-    float x0, y0, x1, y1;
+//! number of boxes in a word of the removed mask
+constexpr size_t WORD_BITS = 64;
+
+//! boxes in SoA layout, each array padded to multiple of WORD_BITS
+struct BoxesSoA {
+    float *x0, *y0, *x1, *y1, *area;
 };
 
-bool box_iou(Box a, Box b, float thresh) {
+//! bit k of the result is whether box i overlaps box begin + k
+uint64_t overlap_word(
+        const BoxesSoA& boxes, size_t i, size_t begin, float thresh) {
     using std::max;
     using std::min;
-    float left = max(a.x0, b.x0), right = min(a.x1, b.x1);
-    float top = max(a.y0, b.y0), bottom = min(a.y1, b.y1);
-    float width = max(right - left, 0.f), height = max(bottom - top, 0.f);
-    float interS = width * height;
-    float Sa = (a.x1 - a.x0) * (a.y1 - a.y0);
-    float Sb = (b.x1 - b.x0) * (b.y1 - b.y0);
-    return interS > (Sa + Sb - interS) * thresh;
+    float ix0 = boxes.x0[i], iy0 = boxes.y0[i], ix1 = boxes.x1[i], iy1 = boxes.y1[i],
+          iarea = boxes.area[i];
+    const float *x0 = boxes.x0 + begin, *y0 = boxes.y0 + begin,
+                *x1 = boxes.x1 + begin, *y1 = boxes.y1 + begin,
+                *area = boxes.area + begin;
+    uint8_t overlap[WORD_BITS];
+    for (size_t k = 0; k < WORD_BITS; ++k) {
+        float width = max(min(ix1, x1[k]) - max(ix0, x0[k]), 0.f),
+              height = max(min(iy1, y1[k]) - max(iy0, y0[k]), 0.f);
+        float interS = width * height;
+        overlap[k] = interS > (iarea + area[k] - interS) * thresh;
+    }
+    uint64_t word = 0;
+    for (size_t k = 0; k < WORD_BITS; ++k) {
+        word |= static_cast<uint64_t>(overlap[k]) << k;
+    }
+    return word;
 }
 }  // anonymous namespace
 
 size_t mgb::opr::standalone::nms::cpu_kern_workspace(size_t nr_boxes) {
     if (nr_boxes == 0)
         return 0;
-    return (((nr_boxes - 1) / sizeof(size_t)) + 1) * sizeof(size_t);
+    size_t nr_words = (nr_boxes - 1) / WORD_BITS + 1;
+    // the removed mask and the five arrays of BoxesSoA
+    return nr_words * (sizeof(uint64_t) + WORD_BITS * 5 * sizeof(float));
 }
 
 void mgb::opr::standalone::nms::cpu_kern(
         size_t nr_boxes, size_t max_output, float overlap_thresh, const float* boxes,
         uint32_t* out_idx, uint32_t* out_size, void* workspace) {
-    size_t out_pos = 0, last_out = 0;
-    auto boxes_bptr = reinterpret_cast<const Box*>(boxes);
-    auto kept_mask = static_cast<size_t*>(workspace);
-    memset(kept_mask, 0, cpu_kern_workspace(nr_boxes));
+    size_t nr_words = (nr_boxes - 1) / WORD_BITS + 1, padded = nr_words * WORD_BITS;
+    auto removed = static_cast<uint64_t*>(workspace);
+    auto soa_ptr = reinterpret_cast<float*>(removed + nr_words);
+    memset(removed, 0, cpu_kern_workspace(nr_boxes));
+    BoxesSoA soa{
+            soa_ptr, soa_ptr + padded, soa_ptr + padded * 2, soa_ptr + padded * 3,
+            soa_ptr + padded * 4};
     for (size_t i = 0; i < nr_boxes; ++i) {
-        bool supressed = false;
-        auto ibox = boxes_bptr[i];
-        for (size_t j = 0; j < i; ++j) {
-            bool j_kept = (kept_mask[j / sizeof(size_t)] >> (j % sizeof(size_t))) & 1;
-            if (j_kept && box_iou(ibox, boxes_bptr[j], overlap_thresh)) {
-                supressed = true;
-                break;
+        auto box = boxes + i * 4;
+        soa.x0[i] = box[0];
+        soa.y0[i] = box[1];
+        soa.x1[i] = box[2];
+        soa.y1[i] = box[3];
+        soa.area[i] = (box[2] - box[0]) * (box[3] - box[1]);
+    }
+
+    size_t out_pos = 0, last_out = 0;
+    for (size_t i = 0; i < nr_boxes && out_pos < max_output; ++i) {
+        if ((removed[i / WORD_BITS] >> (i % WORD_BITS)) & 1)
+            continue;
+        last_out = i;
+        out_idx[out_pos++] = i;
+        for (size_t w = (i + 1) / WORD_BITS; w < nr_words && out_pos < max_output;
+             ++w) {
+            // words whose boxes are all removed need no more IoU
+            if (~removed[w]) {
+                removed[w] |= overlap_word(soa, i, w * WORD_BITS, overlap_thresh);
             }
         }
-        if (!supressed) {
-            kept_mask[i / sizeof(size_t)] |= size_t(1) << (i % sizeof(size_t));
-            last_out = i;
-            out_idx[out_pos++] = i;
-            if (out_pos == max_output)
-                break;
-        }
     }
     *out_size = out_pos;
     while (out_pos < max_output) {
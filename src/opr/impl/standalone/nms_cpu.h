@@ -11,12 +11,16 @@ namespace nms {
 /*!
  * \brief CPU single-batch nms kernel
  *
- * See nms_kern.cuh for explanation on the parameters.
+ * See nms_kern.cuh for explanation on the parameters. The suppressed boxes are
+ * recorded in a bitmask as the CUDA kernel does, and the IoU of each kept box
+ * with the boxes after it is computed 64 boxes a time from the SoA copy of the
+ * boxes in the workspace, so the loops could be vectorized.
  */
 void cpu_kern(
         size_t nr_boxes, size_t max_output, float overlap_thresh, const float* boxes,
         uint32_t* out_idx, uint32_t* out_size, void* workspace);
 
+//! workspace size in bytes of a single cpu_kern call
 size_t cpu_kern_workspace(size_t nr_boxes);
 
 }  // namespace nms
@@ -121,11 +121,27 @@ void NMSKeep::CUDAKern::exec(
 
 // f{{{ cpu kernel begins
 class NMSKeep::CPUKern final : public Kern {
+    size_t m_workspace_per_thread;
+
+    void init(const NMSKeep* opr, const TensorShape& boxes) {
+        auto align = opr->comp_node().get_mem_addr_alignment();
+        m_workspace_per_thread =
+                get_aligned_power2(nms::cpu_kern_workspace(boxes[1]), align);
+    }
+
+    static size_t nr_threads(const NMSKeep* opr) {
+        return CompNodeEnv::from_comp_node(opr->comp_node())
+                .cpu_env()
+                .dispatcher->nr_threads();
+    }
+
 public:
     ~CPUKern() = default;
 
-    size_t get_workspace_size(const NMSKeep*, const TensorShape& boxes) override {
-        return nms::cpu_kern_workspace(boxes.shape[1]);
+    //! each thread of the comp node has its own workspace
+    size_t get_workspace_size(const NMSKeep* opr, const TensorShape& boxes) override {
+        init(opr, boxes);
+        return m_workspace_per_thread * nr_threads(opr);
     }
 
     void exec(
@@ -151,21 +167,21 @@ void NMSKeep::CPUKern::exec(
     }
     auto param = opr->param();
 
+    init(opr, inp.shape());
     auto workspace_ptr = workspace.raw_ptr();
+    auto workspace_per_thread = m_workspace_per_thread;
 
     // NOTE: we must copy all the params into the kernel closure since it would
-    // be dispatched on a different thread
-    auto kern = [=]() {
-        for (size_t i = 0; i < batch; ++i) {
-            nms::cpu_kern(
-                    nr_boxes, param.max_output, param.iou_thresh,
-                    inp_ptr + i * nr_boxes * 4, out_idx_ptr + i * param.max_output,
-                    out_size_ptr + i, workspace_ptr);
-        }
+    // be dispatched on a different thread; the batches (e.g. images or the
+    // classes of them) are independent and run on the threads of the comp node
+    auto kern = [=](size_t i, size_t thread_id) {
+        nms::cpu_kern(
+                nr_boxes, param.max_output, param.iou_thresh,
+                inp_ptr + i * nr_boxes * 4, out_idx_ptr + i * param.max_output,
+                out_size_ptr + i, workspace_ptr + thread_id * workspace_per_thread);
     };
 
-    // The kernel should not be invoked
-    CompNodeEnv::from_comp_node(comp_node).cpu_env().dispatch(kern);
+    CompNodeEnv::from_comp_node(comp_node).cpu_env().dispatch(kern, batch);
 }
 
 // f}}} cpu kernel ends
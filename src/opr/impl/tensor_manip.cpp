@@ -1307,8 +1307,12 @@ void Concat::scn_do_execute() {
             real_axis += in.shape().ndim;
         end = begin + in.shape().shape[real_axis];
         if (!in.layout().is_empty()) {
-            out.sub(Slice(begin, end).apply(out.layout(), real_axis))
-                    .copy_from_fixlayout(in);
+            auto dest = out.sub(Slice(begin, end).apply(out.layout(), real_axis));
+            // the input may have been computed in place, see
+            // mem_plan_fwd_out2in()
+            if (dest.raw_ptr() != in.raw_ptr()) {
+                dest.copy_from_fixlayout(in);
+            }
         }
     }
 }
@@ -1363,6 +1367,27 @@ void Concat::add_input_layout_constraint() {
     }
 }
 
+void Concat::mem_plan_fwd_out2in() {
+    auto out = output(0);
+    TensorLayout layout{out->shape(), out->dtype()};
+    auto real_axis = m_axis;
+    if (real_axis < 0)
+        real_axis += layout.ndim;
+    // the slices are contiguous only if all the dims before axis are 1
+    for (int i = 0; i < real_axis; ++i) {
+        if (layout.shape[i] != 1)
+            return;
+    }
+    size_t end = 0;
+    for (auto i : input()) {
+        auto begin = end;
+        end = begin + i->shape().shape[real_axis];
+        if (begin != end) {
+            out->set_fwd_out2in(i, Slice(begin, end).apply(layout, real_axis));
+        }
+    }
+}
+
 void Concat::init_output_comp_node() {
     Super::init_output_comp_node();
 
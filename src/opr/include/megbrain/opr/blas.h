@@ -121,6 +121,46 @@ public:
             const OperatorNodeConfig& config = {});
 };
 
+/*!
+ * \brief product of a block sparse matrix in BSR format and dense matrices
+ *
+ * The sparse matrix is given by the values, col_idx and row_ptr inputs; see
+ * megdnn::BlockSparseMatrixMul for the layouts. It is usually produced by
+ * gopt::ConvertToBlockSparsePass from the constant weights of MatrixMul and
+ * ConvBias oprs, and has no gradient.
+ */
+MGB_DEFINE_OPR_CLASS(
+        BlockSparseMatrixMul,
+        intl::MegDNNOprWrapperFwd<megdnn::BlockSparseMatrixMul>) // {
+public:
+    BlockSparseMatrixMul(
+            VarNode* values, VarNode* col_idx, VarNode* row_ptr, VarNode* src,
+            const Param& param, const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar values, SymbolVar col_idx, SymbolVar row_ptr, SymbolVar src,
+            const Param& param = {}, const OperatorNodeConfig& config = {});
+};
+
+/*!
+ * \brief product of float activations and the transpose of a weight quantized
+ *      to int8 or int4 with a scale of each output channel
+ *
+ * See megdnn::WeightQuantMatrixMul for the layouts. It is usually produced by
+ * gopt::ConvertToWeightQuantPass from the constant weights of MatrixMul oprs,
+ * and has no gradient.
+ */
+MGB_DEFINE_OPR_CLASS(
+        WeightQuantMatrixMul,
+        intl::MegDNNOprWrapperFwd<megdnn::WeightQuantMatrixMul>) // {
+public:
+    WeightQuantMatrixMul(
+            VarNode* src, VarNode* weight, VarNode* scale, const Param& param,
+            const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar src, SymbolVar weight, SymbolVar scale, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+
 }  // namespace opr
 }  // namespace mgb
 
@@ -35,6 +35,10 @@ class WeightPreprocessExecutor : public cg::OperatorNodeMixinBase {
     std::unique_ptr<PreprocessedFilter> m_preprocessed_filter;
     SmallVector<DeviceTensorND> m_filter_storage;
 
+    //! key of the preprocessed filter in PersistentCache, or empty if the
+    //! preprocessed filter should not be cached
+    std::string make_preprocess_cache_key(const OperatorNodeBase& opr);
+
 protected:
     //! this should only be called in scn_do_execute or similar functions (i.e.
     //! post dispatch-to-ExecEnv)
@@ -47,6 +51,12 @@ protected:
     bool mixin_allow_weight_preprocess(const OperatorNodeBase& opr) const;
     virtual SmallVector<TensorLayout> deduce_preprocessed_filter_layout() = 0;
     virtual void scn_do_execute_preprocess() = 0;
+    //! flag the weights consumed by the preprocess as MEMORY_NO_NEED if they
+    //! are not used by others
+    virtual void mark_preprocessed_weight_no_need() = 0;
+    //! the param and the algorithm which the preprocessed filter depends on,
+    //! used as a part of the cache key
+    virtual std::string preprocess_param_blob() = 0;
     virtual ~WeightPreprocessExecutor() = default;
 };
 
@@ -110,6 +120,8 @@ MGB_DEFINE_OPR_CLASS(
     void record_execute_deps(cg::GraphExecutable::ExecDependencyArray& deps) override;
     SmallVector<TensorLayout> deduce_preprocessed_filter_layout() override;
     void scn_do_execute_preprocess() override;
+    void mark_preprocessed_weight_no_need() override;
+    std::string preprocess_param_blob() override;
 
     friend testing::ConvolutionTestingPeer;
 
@@ -144,6 +156,10 @@ MGB_DEFINE_OPR_CLASS(
     }
     SmallVector<TensorLayout> deduce_preprocessed_filter_layout() override;
     void scn_do_execute_preprocess() override;
+    void mark_preprocessed_weight_no_need() override;
+    std::string preprocess_param_blob() override;
+    //! whether the bias is also preprocessed with the filter
+    bool is_bias_preprocessed();
 
 public:
     //! src * filter
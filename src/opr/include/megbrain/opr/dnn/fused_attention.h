@@ -0,0 +1,44 @@
+/**
+ * \file src/opr/include/megbrain/opr/dnn/fused_attention.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/opr/internal/megdnn_opr_wrapper.h"
+#include "megdnn/oprs.h"
+
+namespace mgb {
+namespace opr {
+
+/*!
+ * \brief softmax(query * key^T * scale) * value without materializing the
+ *      (S, T) attention scores
+ *
+ * Inputs are (B, S, D) query, (B, T, D) key and (B, T, Dv) value, where
+ * attention heads are folded into B. The gradient is computed by the
+ * decomposed matmul and softmax oprs, and hence recomputes the scores.
+ */
+MGB_DEFINE_OPR_CLASS(
+        FusedAttentionForward,
+        intl::MegDNNOprWrapperFwd<megdnn::FusedAttentionForward>) // {
+public:
+    FusedAttentionForward(
+            VarNode* query, VarNode* key, VarNode* value, const Param& param,
+            const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar query, SymbolVar key, SymbolVar value, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+using FusedAttention = FusedAttentionForward;
+
+}  // namespace opr
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,49 @@
+/**
+ * \file src/opr/include/megbrain/opr/dnn/softmax.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/opr/internal/megdnn_opr_wrapper.h"
+#include "megdnn/oprs.h"
+
+namespace mgb {
+namespace opr {
+
+/*!
+ * \brief softmax along param().axis, computed by a single megdnn kernel
+ *      rather than the reduce-max, exp, reduce-sum and div chain
+ */
+MGB_DEFINE_OPR_CLASS(
+        SoftmaxForward, intl::MegDNNOprWrapperFwd<megdnn::SoftmaxForward>) // {
+public:
+    SoftmaxForward(VarNode* src, const Param& param, const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar src, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+using Softmax = SoftmaxForward;
+
+//! gradient of softmax wrt. its input, computed from the output \p dst
+MGB_DEFINE_OPR_CLASS(
+        SoftmaxBackward, intl::MegDNNOprWrapperBwd<megdnn::SoftmaxBackward>) // {
+public:
+    SoftmaxBackward(
+            VarNode* dst, VarNode* diff, const Param& param,
+            const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar dst, SymbolVar diff, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+
+}  // namespace opr
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -303,6 +303,51 @@ public:
 
 using DctChannelSelect = DctChannelSelectForward;
 
+/*!
+ * \brief convert the color of uint8 images, resize and normalize them into
+ *      float32 in one pass
+ *
+ * See megdnn::ImagePreprocess for the layouts. It is usually produced by
+ * gopt::FuseImagePreprocessPass from a CvtColor, TypeCvt, Resize and
+ * per-channel affine chain.
+ *
+ * \param out_shape output height and width
+ */
+MGB_DEFINE_OPR_CLASS(
+        ImagePreprocess,
+        intl::WorkspaceSizeInfer<intl::OutshapeBySymvarSCNOpr<
+                mixin::MegDNNOprHolderImpl<megdnn::ImagePreprocess>>>) // {
+public:
+    ImagePreprocess(
+            VarNode* src, VarNode* scale, VarNode* bias, VarNode* out_shape,
+            const Param& param, const OperatorNodeConfig& config);
+
+    static SymbolVar make(
+            SymbolVar src, SymbolVar scale, SymbolVar bias, SymbolVar out_shape,
+            const Param& param = {}, const OperatorNodeConfig& config = {});
+
+    static SymbolVar make(
+            SymbolVar src, SymbolVar scale, SymbolVar bias, const TensorShape& out_shape,
+            const Param& param = {}, const OperatorNodeConfig& config = {}) {
+        return make(
+                src, scale, bias, cg::var_from_tensor_shape(src, out_shape), param,
+                config);
+    }
+
+private:
+    void init_output_dtype() override;
+    void add_input_layout_constraint() override;
+    void init_output_static_infer_desc() override;
+    void outshape_by_symvar_do_get_output_shape(
+            TensorShape& dest, const ShapeInferInfo& shpinfo) override;
+
+    void scn_do_execute() override;
+    size_t get_workspace_size_bytes(
+            const TensorShapeArray& input_shapes,
+            const TensorShapeArray& output_shapes) const override;
+    void record_execute_deps(ExecDependencyArray& deps) override;
+};
+
 }  // namespace opr
 }  // namespace mgb
 
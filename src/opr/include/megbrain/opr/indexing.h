@@ -85,6 +85,47 @@ public:
             const Param& param, const OperatorNodeConfig& config = {});
 };
 
+/*!
+ * \brief sum or mean of the rows of an embedding table by bags of indices
+ *
+ * See megdnn::EmbeddingBag for the inputs and the quantized rows. The output
+ * is of Float32, and there is no gradient.
+ */
+MGB_DEFINE_OPR_CLASS(
+        EmbeddingBag, intl::MegDNNOprWrapperFwd<megdnn::EmbeddingBag>) // {
+public:
+    EmbeddingBag(
+            VarNode* weight, VarNode* indices, VarNode* offsets, const Param& param,
+            const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar weight, SymbolVar indices, SymbolVar offsets,
+            const Param& param = {}, const OperatorNodeConfig& config = {});
+
+    /*!
+     * \brief convert a Float32 table of (N, D) to a table of the given dtype
+     *
+     * For Uint8, each row is quantized linearly from its min to its max, and
+     * the table is of (N, D + 8) with the scale and bias in the rows.
+     */
+    static HostTensorND convert_table(const HostTensorND& table, DType dtype);
+
+    /*!
+     * \brief map a contiguous table of the given shape and dtype at offset of
+     *      a file as a tensor on a cpu comp node, so tables larger than the
+     *      memory can be used by SharedDeviceTensor
+     *
+     * The file is mapped read-only with random access advised, and the pages
+     * are loaded by the lookups; the tensor must not be modified. Note that the
+     * table would be written into the model if the graph is dumped.
+     */
+    static DeviceTensorND mmap_table(
+            const std::string& path, const TensorShape& shape, DType dtype,
+            size_t offset = 0, CompNode cn = CompNode::default_cpu());
+
+private:
+    void init_output_dtype() override;
+};
+
 namespace mixin {
 
 template <class Opr>
@@ -57,6 +57,13 @@ protected:
     //! init m_sub_graph_func from m_desc
     void init_sub_graph_func();
 
+    /*!
+     * \brief whether kernels of the loop body can be recorded and replayed
+     *      between iterations; see
+     *      ComputingGraph::Options::enable_loop_body_record
+     */
+    bool check_body_recordable();
+
     cg::AsyncExecutable* sub_graph_func() const { return m_sub_graph_func.get(); }
 
     //! add input vars needed by loop desc
@@ -85,6 +92,9 @@ private:
     ThinHashMap<VarNode*, bool> test_get_var_rec_spec();
 
     std::unique_ptr<cg::AsyncExecutable> m_sub_graph_func;
+
+    //! cached result of check_body_recordable(); -1 for unknown
+    int m_body_recordable = -1;
 };
 
 }  // namespace intl
@@ -176,6 +176,40 @@ public:
 
 MGB_DEFINE_MEGDNN_OPR_WRAPPER_FWD1(CheckNonFinite);
 
+/*!
+ * \brief check whether any of the float32 inputs contains inf or nan
+ *
+ * The first outputs are the inputs multiplied by param().scale, which are
+ * forwarded from the inputs if possible, and the last output is an int32 flag
+ * of whether any non-finite value is found.
+ */
+MGB_DEFINE_OPR_CLASS(
+        CheckNonFiniteV2, cg::SingleCNOperatorNodeBaseT<mixin::MegDNNOprHolder>) // {
+public:
+    using Param = megdnn::CheckNonFiniteV2::Param;
+
+    const Param& param() const { return m_param; }
+
+    CheckNonFiniteV2(
+            const VarNodeArrayView& inp, const Param& param,
+            const OperatorNodeConfig& config);
+
+    //! the returned vars exclude the workspace
+    static SymbolVarArray make(
+            const VarNodeArrayView& inp, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+
+private:
+    const Param m_param;
+
+    NodeProp* do_make_node_prop() const override;
+    void create_megdnn_opr() override;
+    void mem_plan_fwd_in2out_writable() override;
+    void scn_do_execute() override;
+    void init_output_static_infer_desc() override;
+    void record_execute_deps(ExecDependencyArray& deps) override;
+};
+
 }  // namespace opr
 }  // namespace mgb
 
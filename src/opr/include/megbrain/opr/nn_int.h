@@ -23,6 +23,9 @@ namespace intl {
 using ElemwiseMultiTypeBase = cg::SingleCNOperatorNode<
         cg::OutshapePureByInshapeOpr<>,
         mixin::MegDNNOprHolderImpl<megdnn::ElemwiseMultiType, false>>;
+using ElemwiseMultiOutputBase = cg::SingleCNOperatorNode<
+        cg::OutshapePureByInshapeOpr<>,
+        mixin::MegDNNOprHolderImpl<megdnn::ElemwiseMultiOutput, false>>;
 }
 
 MGB_DEFINE_OPR_CLASS(ElemwiseMultiType, intl::ElemwiseMultiTypeBase) // {
@@ -51,6 +54,35 @@ private:
     void record_execute_deps(ExecDependencyArray& deps) override;
 };
 
+/*!
+ * \brief element-wise oprs with two outputs computed in a single kernel
+ *
+ * See megdnn::param::ElemwiseMultiOutput::Mode for the outputs of each mode.
+ */
+MGB_DEFINE_OPR_CLASS(ElemwiseMultiOutput, intl::ElemwiseMultiOutputBase) // {
+public:
+    using Mode = Param::Mode;
+
+    ElemwiseMultiOutput(
+            const VarNodeArrayView& inputs, Param param,
+            const OperatorNodeConfig& config);
+
+    static SymbolVarArray make(
+            const VarNodeArrayView& inputs, Param param,
+            const OperatorNodeConfig& config = {});
+
+private:
+    void scn_do_execute() override;
+
+    void get_output_var_shape(
+            const TensorShapeArray& inp_shape,
+            TensorShapeArray& out_shape) const override;
+
+    void init_output_dtype() override;
+
+    void record_execute_deps(ExecDependencyArray& deps) override;
+};
+
 //! deprecated; TODO: remove in megbrain 8
 class AffineInt final : public DynTypeObj {
     MGB_DYN_TYPE_OBJ_FINAL_DECL;
@@ -165,6 +165,14 @@ public:
         //! profile and save to cache
         void profile(const ExecutionStrategy& selected_strategy) const;
 
+        /*!
+         * \brief profile and save to cache in a background thread of the
+         *      owner graph
+         *
+         * Layouts with the same cache key are only scheduled once.
+         */
+        void profile_in_background(const ExecutionStrategy& selected_strategy) const;
+
         /**
          * \brief extract algo attribute from execution strategy and graph
          * option.
@@ -178,6 +186,30 @@ public:
     private:
         Maybe<PreprocessFilter<Opr>> construct_fake_preprocess_filter(
                 const FixedTensorLayouts& layouts = {}) const;
+
+        //! construct the param of TimedProfiler<Opr>::profile for given algo
+        typename TimedProfiler<Opr>::Param make_profile_param(
+                const ImplExecutionPolicy& policy) const;
+
+        /*!
+         * \brief profile given algo with param from make_profile_param()
+         *
+         * m_dnn_opr is not modified, so it can be called concurrently
+         */
+        Maybe<AlgoChooserProfileCache::ResultEntry> profile_with_param(
+                const ImplExecutionPolicy& policy,
+                const typename TimedProfiler<Opr>::Param& param,
+                double& timeout) const;
+
+        /*!
+         * \brief profile the given algos concurrently on the comp nodes in
+         *      FastRunConfig::parallel_profile_comp_nodes
+         *
+         * \param msgs messages describing the algos for logging
+         */
+        std::vector<Maybe<AlgoChooserProfileCache::ResultEntry>> profile_parallel(
+                const std::vector<ImplExecutionPolicy>& policies,
+                const std::vector<std::string>& msgs) const;
     };
 
     template <typename U>
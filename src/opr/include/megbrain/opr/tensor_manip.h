@@ -506,6 +506,7 @@ private:
 
     void init_output_static_infer_desc() override;
     void add_input_layout_constraint() override;
+    void mem_plan_fwd_out2in() override;
     void init_output_comp_node() override;
 
     void get_output_var_shape(
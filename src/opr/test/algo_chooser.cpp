@@ -24,8 +24,11 @@
 #include "megdnn/heuristic_cache.h"
 #include "megdnn/oprs/base.h"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <random>
+#include <thread>
 #include <utility>
 
 using namespace mgb;
@@ -345,6 +348,130 @@ TEST(TestOprDNN, FastrunNoProfilingOnShapeChange) {
 #endif  // MGB_ENABLE_FASTRUN
 #endif  // MGB_CUDA
 
+#if MGB_ENABLE_FASTRUN
+void run_fastrun_matmul(
+        const TensorShape& shape_a, const TensorShape& shape_b,
+        thin_function<void(cg::ComputingGraph::Options&)> set_options) {
+    using Policy = opr::MatrixMul::ExecutionPolicy;
+    auto cn = CompNode::load("xpu0");
+    auto graph = ComputingGraph::make();
+    set_options(graph->options());
+
+    HostTensorGenerator<> gen;
+    auto a = opr::Host2DeviceCopy::make(*graph, gen(shape_a, cn)),
+         b = opr::Host2DeviceCopy::make(*graph, gen(shape_b, cn));
+    Policy policy;
+    policy.strategy = Policy::Strategy::PROFILE;
+    auto out = opr::MatrixMul::make(a, b, {}, policy);
+
+    HostTensorND host_out;
+    auto func = graph->compile({make_callback_copy(out, host_out)});
+    func->execute();
+    ASSERT_EQ(TensorShape({shape_a[0], shape_b[1]}), host_out.shape());
+}
+
+TEST(TestOprDNN, FastrunShapeBucket) {
+    std::atomic_int nr_set{0};
+    auto on_get = [](const std::string&, const void*, size_t, const void*, size_t) {};
+    auto on_set = [&nr_set](
+                          const std::string&, const void*, size_t, const void*,
+                          size_t) { ++nr_set; };
+    PersistentCacheHook cache_hook{on_get, on_set};
+    auto set_options = [](cg::ComputingGraph::Options& options) {
+        options.fast_run_config.shape_bucket_size = 8;
+    };
+
+    run_fastrun_matmul({19, 37}, {37, 53}, set_options);
+    int nr = nr_set;
+    ASSERT_GT(nr, 0);
+    // layouts in the same bucket are not profiled again
+    run_fastrun_matmul({21, 35}, {35, 55}, set_options);
+    ASSERT_EQ(nr, nr_set);
+    run_fastrun_matmul({25, 37}, {37, 53}, set_options);
+    ASSERT_GT(nr_set, nr);
+}
+
+TEST(TestOprDNN, FastrunBackgroundProfiling) {
+    std::atomic_int nr_set{0};
+    auto on_get = [](const std::string&, const void*, size_t, const void*, size_t) {};
+    auto on_set = [&nr_set](
+                          const std::string&, const void*, size_t, const void*,
+                          size_t) { ++nr_set; };
+    PersistentCacheHook cache_hook{on_get, on_set};
+    auto set_options = [](cg::ComputingGraph::Options& options) {
+        options.fast_run_config.background_profiling = true;
+    };
+
+    // the graph waits for background profiling when destroyed
+    run_fastrun_matmul({23, 41}, {41, 59}, set_options);
+    int nr = nr_set;
+    ASSERT_GT(nr, 0);
+    run_fastrun_matmul({23, 41}, {41, 59}, set_options);
+    ASSERT_EQ(nr, nr_set);
+}
+
+TEST(TestOprDNN, FastrunParallelProfiling) {
+    REQUIRE_XPU(2);
+    std::atomic_int nr_set{0};
+    auto on_get = [](const std::string&, const void*, size_t, const void*, size_t) {};
+    auto on_set = [&nr_set](
+                          const std::string&, const void*, size_t, const void*,
+                          size_t) { ++nr_set; };
+    PersistentCacheHook cache_hook{on_get, on_set};
+    auto set_options = [](cg::ComputingGraph::Options& options) {
+        options.fast_run_config.parallel_profile_comp_nodes = {
+                CompNode::load("xpu0"), CompNode::load("xpu1")};
+    };
+
+    run_fastrun_matmul({29, 47}, {47, 67}, set_options);
+    int nr = nr_set;
+    ASSERT_GT(nr, 0);
+    // the parallel results are put into the cache of the opr comp node
+    run_fastrun_matmul({29, 47}, {47, 67}, [](cg::ComputingGraph::Options&) {});
+    ASSERT_EQ(nr, nr_set);
+}
+
+TEST(TestOprDNN, FastrunBackgroundProfilingSwitchAlgo) {
+    using Policy = opr::MatrixMul::ExecutionPolicy;
+    std::atomic_int nr_get{0}, nr_set{0};
+    auto on_get = [&nr_get](
+                          const std::string&, const void*, size_t, const void*,
+                          size_t) { ++nr_get; };
+    auto on_set = [&nr_set](
+                          const std::string&, const void*, size_t, const void*,
+                          size_t) { ++nr_set; };
+    PersistentCacheHook cache_hook{on_get, on_set};
+
+    auto cn = CompNode::load("xpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().fast_run_config.background_profiling = true;
+    HostTensorGenerator<> gen;
+    auto a = opr::Host2DeviceCopy::make(*graph, gen({27, 43}, cn)),
+         b = opr::Host2DeviceCopy::make(*graph, gen({43, 61}, cn));
+    Policy policy;
+    policy.strategy = Policy::Strategy::PROFILE;
+    auto out = opr::MatrixMul::make(a, b, {}, policy);
+    HostTensorND host_out;
+    auto func = graph->compile({make_callback_copy(out, host_out)});
+
+    // the first execution uses the heuristic algo
+    func->execute().wait();
+    for (int i = 0; i < 600 && !nr_set; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ASSERT_GT(nr_set, 0);
+    // let the task finish after the result is cached
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // algo setup is rerun on the execution after the profiling finished
+    int nr = nr_get;
+    func->execute().wait();
+    func->execute().wait();
+    ASSERT_GT(nr_get, nr);
+    ASSERT_EQ(TensorShape({27, 61}), host_out.shape());
+}
+#endif  // MGB_ENABLE_FASTRUN
+
 }  // anonymous namespace
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
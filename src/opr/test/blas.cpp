@@ -699,6 +699,94 @@ TEST(TestOprBlas, NonContigMatmul) {
             .run({TensorShape{6, 3}, TensorShape{3, 8}});
 }
 
+TEST(TestOprBlas, BlockSparseMatrixMul) {
+    using Mode = opr::BlockSparseMatrixMul::Param::Mode;
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("xpu0");
+    // A of (4, 8) in 1x4 blocks, whose row 1 is empty
+    std::vector<int> col_idx_val{1, 0, 1, 0}, row_ptr_val{0, 1, 1, 3, 4};
+    size_t nnz = col_idx_val.size();
+    auto host_values = gen({nnz, 1, 4}, cn);
+    HostTensorND host_col_idx{cn, {nnz}, dtype::Int32()},
+            host_row_ptr{cn, {row_ptr_val.size()}, dtype::Int32()},
+            host_dense{cn, {4, 8}, dtype::Float32()};
+    std::copy(col_idx_val.begin(), col_idx_val.end(), host_col_idx.ptr<int>());
+    std::copy(row_ptr_val.begin(), row_ptr_val.end(), host_row_ptr.ptr<int>());
+    auto dense = host_dense.ptr<float>();
+    std::fill(dense, dense + 32, 0.f);
+    for (size_t r = 0; r < 4; ++r) {
+        for (int blk = row_ptr_val[r]; blk < row_ptr_val[r + 1]; ++blk) {
+            for (size_t j = 0; j < 4; ++j) {
+                dense[r * 8 + col_idx_val[blk] * 4 + j] =
+                        host_values->ptr<float>()[blk * 4 + j];
+            }
+        }
+    }
+
+    auto graph = ComputingGraph::make();
+    auto values = opr::SharedDeviceTensor::make(*graph, *host_values),
+         col_idx = opr::SharedDeviceTensor::make(*graph, host_col_idx),
+         row_ptr = opr::SharedDeviceTensor::make(*graph, host_row_ptr),
+         a = opr::SharedDeviceTensor::make(*graph, host_dense),
+         x0 = opr::Host2DeviceCopy::make(*graph, gen({8, 5}, cn)),
+         x1 = opr::Host2DeviceCopy::make(*graph, gen({3, 8}, cn));
+    auto y0 = opr::BlockSparseMatrixMul::make(
+                 values, col_idx, row_ptr, x0, {Mode::SPARSE_DENSE, 1, 4}),
+         y1 = opr::BlockSparseMatrixMul::make(
+                 values, col_idx, row_ptr, x1, {Mode::DENSE_SPARSE_T, 1, 4});
+    auto z0 = opr::MatrixMul::make(a, x0),
+         z1 = opr::MatrixMul::make(x1, a, {false, true});
+    HostTensorND host_y0, host_y1, host_z0, host_z1;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y1, host_y1),
+             make_callback_copy(z0, host_z0), make_callback_copy(z1, host_z1)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z0, host_y0, 1e-5);
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_y1, 1e-5);
+}
+
+TEST(TestOprBlas, WeightQuantMatrixMul) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("xpu0");
+    constexpr size_t M = 3, K = 5, N = 6;
+    for (uint32_t bits : {8, 4}) {
+        int qmax = bits == 8 ? 127 : 7;
+        size_t row_bytes = bits == 8 ? K : (K + 1) / 2;
+        HostTensorND host_weight{cn, {N, row_bytes}, dtype::Int8()},
+                host_scale{cn, {N}, dtype::Float32()},
+                host_dense{cn, {N, K}, dtype::Float32()};
+        auto weight = host_weight.ptr<dt_int8>();
+        auto dense = host_dense.ptr<float>();
+        std::fill(weight, weight + N * row_bytes, 0);
+        for (size_t n = 0; n < N; ++n) {
+            float scale = 0.5f * (n + 1);
+            host_scale.ptr<float>()[n] = scale;
+            for (size_t k = 0; k < K; ++k) {
+                int q = static_cast<int>(n * 5 + k * 3) % (2 * qmax + 1) - qmax;
+                dense[n * K + k] = q * scale;
+                if (bits == 8) {
+                    weight[n * K + k] = q;
+                } else {
+                    weight[n * row_bytes + k / 2] |= (q & 0xf) << (k % 2 * 4);
+                }
+            }
+        }
+
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, gen({M, K}, cn)),
+             w = opr::SharedDeviceTensor::make(*graph, host_weight),
+             scale = opr::SharedDeviceTensor::make(*graph, host_scale),
+             a = opr::SharedDeviceTensor::make(*graph, host_dense);
+        auto y = opr::WeightQuantMatrixMul::make(x, w, scale, {bits}),
+             z = opr::MatrixMul::make(x, a, {false, true});
+        HostTensorND host_y, host_z;
+        auto func = graph->compile(
+                {make_callback_copy(y, host_y), make_callback_copy(z, host_z)});
+        func->execute();
+        MGB_ASSERT_TENSOR_NEAR(host_z, host_y, 1e-5);
+    }
+}
+
 TEST(TestOprBlas, MatrixInverse) {
     using Checker = AutoOprChecker<1, 1>;
     auto make_graph = [=](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
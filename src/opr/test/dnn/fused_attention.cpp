@@ -0,0 +1,78 @@
+/**
+ * \file src/opr/test/dnn/fused_attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/fused_attention.h"
+#include "megbrain/test/autocheck.h"
+#include "megbrain/test/helper.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace mgb;
+
+TEST(TestOprDNN, FusedAttention) {
+    using Checker = AutoOprChecker<3, 1>;
+    float scale;
+
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        return {opr::FusedAttention::make(inputs[0], inputs[1], inputs[2], {scale})};
+    };
+
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        auto &&qs = inp[0]->shape(), &&vs = inp[2]->shape();
+        size_t B = qs[0], S = qs[1], D = qs[2], T = vs[1], Dv = vs[2];
+        auto q = inp[0]->ptr<float>(), k = inp[1]->ptr<float>(),
+             v = inp[2]->ptr<float>();
+        auto dst = dest[0].comp_node(inp[0]->comp_node())
+                           .resize({B, S, Dv})
+                           .ptr<float>();
+        std::vector<float> p(T);
+        for (size_t b = 0; b < B; ++b) {
+            for (size_t s = 0; s < S; ++s) {
+                auto qr = q + (b * S + s) * D;
+                float max_val = -INFINITY, sum = 0;
+                for (size_t t = 0; t < T; ++t) {
+                    auto kr = k + (b * T + t) * D;
+                    float dot = 0;
+                    for (size_t d = 0; d < D; ++d) {
+                        dot += qr[d] * kr[d];
+                    }
+                    p[t] = dot * scale;
+                    max_val = std::max(max_val, p[t]);
+                }
+                for (size_t t = 0; t < T; ++t) {
+                    sum += p[t] = std::exp(p[t] - max_val);
+                }
+                auto dr = dst + (b * S + s) * Dv;
+                for (size_t j = 0; j < Dv; ++j) {
+                    float acc = 0;
+                    for (size_t t = 0; t < T; ++t) {
+                        acc += p[t] * v[(b * T + t) * Dv + j];
+                    }
+                    dr[j] = acc / sum;
+                }
+            }
+        }
+    };
+
+    Checker::RunOptions opt;
+    opt.outputs_max_err = 1e-4;
+    opt.numdiff_max_err = 1e-2;
+    for (float s : {1.f, 0.25f}) {
+        scale = s;
+        Checker(make_graph, fwd)
+                .run({TensorShape{2, 3, 4}, {2, 5, 4}, {2, 5, 6}}, opt)
+                .run({TensorShape{1, 17, 8}, {1, 70, 8}, {1, 70, 3}}, opt)
+                .run({TensorShape{3, 1, 5}, {3, 1, 5}, {3, 1, 2}}, opt);
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
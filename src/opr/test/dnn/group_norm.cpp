@@ -0,0 +1,113 @@
+/**
+ * \file src/opr/test/dnn/group_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/group_norm.h"
+#include "megbrain/test/autocheck.h"
+#include "megbrain/test/helper.h"
+
+#include <cmath>
+
+using namespace mgb;
+
+namespace {
+using Param = opr::GroupNorm::Param;
+
+//! reference group norm; w and b are null if not affine
+void group_norm_brute(
+        const HostTensorND& x, const float* w, const float* b, HostTensorND& y,
+        HostTensorND& mean, HostTensorND& rstd, const Param& param) {
+    auto cn = x.comp_node();
+    auto&& shape = x.shape();
+    size_t N = shape[0], C = shape[1], G = param.group, cpg = C / G,
+           S = shape.total_nr_elems() / (N * C), len = cpg * S;
+    auto xptr = x.ptr<float>();
+    auto yptr = y.comp_node(cn).resize(shape).ptr<float>();
+    auto mptr = mean.comp_node(cn).resize({N, G}).ptr<float>();
+    auto rptr = rstd.comp_node(cn).resize({N, G}).ptr<float>();
+    for (size_t r = 0; r < N * G; ++r) {
+        const float* xr = xptr + r * len;
+        double m = 0, var = 0;
+        for (size_t i = 0; i < len; ++i) {
+            m += xr[i];
+        }
+        m /= len;
+        for (size_t i = 0; i < len; ++i) {
+            var += (xr[i] - m) * (xr[i] - m);
+        }
+        double rs = 1 / std::sqrt(var / len + param.eps);
+        mptr[r] = m;
+        rptr[r] = rs;
+        for (size_t i = 0; i < len; ++i) {
+            size_t c = r % G * cpg + i / S;
+            double v = (xr[i] - m) * rs;
+            yptr[r * len + i] = w ? v * w[c] + b[c] : v;
+        }
+    }
+}
+}  // anonymous namespace
+
+TEST(TestOprDNN, GroupNorm) {
+    using Checker = AutoOprChecker<3, 3>;
+    Param param;
+
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        auto out = opr::GroupNorm::make(inputs[0], inputs[1], inputs[2], param);
+        return {out[0], out[1], out[2]};
+    };
+
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        group_norm_brute(
+                *inp[0], inp[1]->ptr<float>(), inp[2]->ptr<float>(), dest[0], dest[1],
+                dest[2], param);
+    };
+
+    Checker::RunOptions opt;
+    opt.numdiff_eps = 1e-2;
+    opt.numdiff_max_err = 1e-2;
+    for (auto&& desc : std::vector<std::pair<TensorShape, uint32_t>>{
+                 {{2, 4, 3, 5}, 2}, {{3, 6, 7}, 3}, {{2, 8, 4, 4}, 1}, {{2, 6}, 3}}) {
+        param.group = desc.second;
+        TensorShape wshp{desc.first[1]};
+        Checker(make_graph, fwd)
+                .set_output_allow_grad(1, false)
+                .set_output_allow_grad(2, false)
+                .run({desc.first, wshp, wshp}, opt);
+    }
+}
+
+TEST(TestOprDNN, GroupNormNoAffine) {
+    using Checker = AutoOprChecker<1, 3>;
+    Param param;
+    param.affine = false;
+
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        auto out = opr::GroupNorm::make(inputs[0], param);
+        return {out[0], out[1], out[2]};
+    };
+
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        group_norm_brute(*inp[0], nullptr, nullptr, dest[0], dest[1], dest[2], param);
+    };
+
+    Checker::RunOptions opt;
+    opt.numdiff_eps = 1e-2;
+    opt.numdiff_max_err = 1e-2;
+    for (auto&& desc : std::vector<std::pair<TensorShape, uint32_t>>{
+                 {{2, 4, 3, 5}, 2}, {{3, 6, 7}, 6}}) {
+        param.group = desc.second;
+        Checker(make_graph, fwd)
+                .set_output_allow_grad(1, false)
+                .set_output_allow_grad(2, false)
+                .run({desc.first}, opt);
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,143 @@
+/**
+ * \file src/opr/test/dnn/layer_norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/layer_norm.h"
+#include "megbrain/test/autocheck.h"
+#include "megbrain/test/helper.h"
+
+#include <cmath>
+
+using namespace mgb;
+
+namespace {
+using Param = opr::LayerNorm::Param;
+
+TensorShape stat_shape(const TensorShape& shape, size_t normalized_dim) {
+    TensorShape ret{1};
+    if (shape.ndim > normalized_dim) {
+        ret.ndim = shape.ndim - normalized_dim;
+        for (size_t i = 0; i < ret.ndim; ++i) {
+            ret[i] = shape[i];
+        }
+    }
+    return ret;
+}
+
+//! reference layer norm; w and b are null if not affine
+void layer_norm_brute(
+        const HostTensorND& x, const float* w, const float* b, HostTensorND& y,
+        HostTensorND& mean, HostTensorND& rstd, const Param& param) {
+    auto cn = x.comp_node();
+    auto&& shape = x.shape();
+    size_t len = param.normalized_size, nr_row = shape.total_nr_elems() / len;
+    auto sshp = stat_shape(shape, param.normalized_dim);
+    auto xptr = x.ptr<float>();
+    auto yptr = y.comp_node(cn).resize(shape).ptr<float>();
+    auto mptr = mean.comp_node(cn).resize(sshp).ptr<float>();
+    auto rptr = rstd.comp_node(cn).resize(sshp).ptr<float>();
+    for (size_t r = 0; r < nr_row; ++r) {
+        const float* xr = xptr + r * len;
+        double m = 0, var = 0;
+        for (size_t i = 0; i < len; ++i) {
+            m += xr[i];
+        }
+        m /= len;
+        for (size_t i = 0; i < len; ++i) {
+            var += (xr[i] - m) * (xr[i] - m);
+        }
+        double rs = 1 / std::sqrt(var / len + param.eps);
+        mptr[r] = m;
+        rptr[r] = rs;
+        for (size_t i = 0; i < len; ++i) {
+            double v = (xr[i] - m) * rs;
+            yptr[r * len + i] = w ? v * w[i] + b[i] : v;
+        }
+    }
+}
+
+Param make_param(const TensorShape& shape, size_t normalized_dim, bool affine) {
+    Param param;
+    param.affine = affine;
+    param.normalized_dim = normalized_dim;
+    param.normalized_size = 1;
+    for (size_t i = shape.ndim - normalized_dim; i < shape.ndim; ++i) {
+        param.normalized_size *= shape[i];
+    }
+    return param;
+}
+
+TensorShape normalized_shape(const TensorShape& shape, size_t normalized_dim) {
+    TensorShape ret;
+    ret.ndim = normalized_dim;
+    for (size_t i = 0; i < normalized_dim; ++i) {
+        ret[i] = shape[shape.ndim - normalized_dim + i];
+    }
+    return ret;
+}
+}  // anonymous namespace
+
+TEST(TestOprDNN, LayerNorm) {
+    using Checker = AutoOprChecker<3, 3>;
+    Param param;
+
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        auto out = opr::LayerNorm::make(inputs[0], inputs[1], inputs[2], param);
+        return {out[0], out[1], out[2]};
+    };
+
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        layer_norm_brute(
+                *inp[0], inp[1]->ptr<float>(), inp[2]->ptr<float>(), dest[0], dest[1],
+                dest[2], param);
+    };
+
+    Checker::RunOptions opt;
+    opt.numdiff_eps = 1e-2;
+    opt.numdiff_max_err = 1e-2;
+    for (auto&& desc : std::vector<std::pair<TensorShape, size_t>>{
+                 {{2, 3, 8}, 1}, {{4, 5, 6}, 2}, {{3, 17}, 2}, {{2, 33, 40}, 1}}) {
+        auto&& shape = desc.first;
+        param = make_param(shape, desc.second, true);
+        auto wshp = normalized_shape(shape, desc.second);
+        Checker(make_graph, fwd)
+                .set_output_allow_grad(1, false)
+                .set_output_allow_grad(2, false)
+                .run({shape, wshp, wshp}, opt);
+    }
+}
+
+TEST(TestOprDNN, LayerNormNoAffine) {
+    using Checker = AutoOprChecker<1, 3>;
+    Param param;
+
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        auto out = opr::LayerNorm::make(inputs[0], param);
+        return {out[0], out[1], out[2]};
+    };
+
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        layer_norm_brute(*inp[0], nullptr, nullptr, dest[0], dest[1], dest[2], param);
+    };
+
+    Checker::RunOptions opt;
+    opt.numdiff_eps = 1e-2;
+    opt.numdiff_max_err = 1e-2;
+    for (auto&& desc : std::vector<std::pair<TensorShape, size_t>>{
+                 {{2, 3, 8}, 1}, {{4, 5, 6}, 2}, {{3, 1200}, 1}}) {
+        param = make_param(desc.first, desc.second, false);
+        Checker(make_graph, fwd)
+                .set_output_allow_grad(1, false)
+                .set_output_allow_grad(2, false)
+                .run({desc.first}, opt);
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
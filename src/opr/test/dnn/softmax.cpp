@@ -0,0 +1,66 @@
+/**
+ * \file src/opr/test/dnn/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/softmax.h"
+#include "megbrain/test/autocheck.h"
+#include "megbrain/test/helper.h"
+
+#include <cmath>
+
+using namespace mgb;
+
+TEST(TestOprDNN, Softmax) {
+    using Checker = AutoOprChecker<1, 1>;
+    int axis;
+
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        return {opr::Softmax::make(inputs[0], {axis})};
+    };
+
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        auto&& shape = inp[0]->shape();
+        size_t ax = axis < 0 ? axis + shape.ndim : axis, A = 1, B = shape[ax], C = 1;
+        for (size_t i = 0; i < ax; ++i) {
+            A *= shape[i];
+        }
+        for (size_t i = ax + 1; i < shape.ndim; ++i) {
+            C *= shape[i];
+        }
+        auto src = inp[0]->ptr<float>();
+        auto dst = dest[0].comp_node(inp[0]->comp_node()).resize(shape).ptr<float>();
+        for (size_t a = 0; a < A; ++a) {
+            for (size_t c = 0; c < C; ++c) {
+                auto sptr = src + a * B * C + c;
+                auto dptr = dst + a * B * C + c;
+                float max_val = sptr[0], sum = 0;
+                for (size_t b = 0; b < B; ++b) {
+                    max_val = std::max(max_val, sptr[b * C]);
+                }
+                for (size_t b = 0; b < B; ++b) {
+                    sum += dptr[b * C] = std::exp(sptr[b * C] - max_val);
+                }
+                for (size_t b = 0; b < B; ++b) {
+                    dptr[b * C] /= sum;
+                }
+            }
+        }
+    };
+
+    for (int i : {0, 1, 2, -1}) {
+        axis = i;
+        Checker(make_graph, fwd)
+                .run({TensorShape{2, 3, 4}})
+                .run({TensorShape{5, 7, 13}})
+                .run({TensorShape{3, 1, 40}});
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -535,6 +535,41 @@ TEST(TestOprImgproc, ResizeBackward) {
             {{10, 8, 8, 4}, {10, 8, 4, 8}}, param, 1e-1, 1e-2);
 }
 
+TEST(TestOprImgproc, ImagePreprocess) {
+    using Param = opr::ImagePreprocess::Param;
+    using Checker = AutoOprChecker<3, 1>;
+    Param param;
+    // shrinking and enlarging the two kinds of inputs
+    TensorShape out_shp{2, 1, 5, 7, 4};
+    auto make_graph = [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        size_t OH = out_shp[2], OW = out_shp[3];
+        return {opr::ImagePreprocess::make(
+                inputs[0], inputs[1], inputs[2], TensorShape{OH, OW}, param)};
+    };
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        auto opr = megdnn_naive_handle()->create_operator<megdnn::ImagePreprocess>();
+        opr->param() = param;
+        dest[0].resize(out_shp);
+        opr->exec(
+                inp[0]->as_megdnn(), inp[1]->as_megdnn(), inp[2]->as_megdnn(),
+                dest[0].as_megdnn(), {});
+    };
+    HostTensorGenerator<dtype::Uint8> gen_src;
+    auto gen_image = [&](HostTensorND& src) { src = *gen_src(src.shape()); };
+    for (auto mode : {Param::Mode::RGB2BGR, Param::Mode::YUV2RGB_NV21}) {
+        param = {mode, Param::InterpolationMode::LINEAR, Param::Format::NCHW44};
+        size_t C = mode == Param::Mode::RGB2BGR ? 3 : 1;
+        auto src_shp = [&](size_t h, size_t w) {
+            return C == 3 ? TensorShape{2, h, w, 3} : TensorShape{2, h * 3 / 2, w, 1};
+        };
+        Checker checker(make_graph, fwd, CompNode::load("cpu1"));
+        checker.set_input_generator(0, gen_image)
+                .set_input_dtype(0, dtype::Uint8{})
+                .set_output_allow_grad(0, false);
+        checker.run({src_shp(8, 6), {3}, {3}}).run({src_shp(4, 10), {3}, {3}});
+    }
+}
+
 TEST(TestOprImgproc, WarpAffineForward) {
     constexpr size_t INP_H = 6, INP_W = 4, N = 2, C = 3;
 
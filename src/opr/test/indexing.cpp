@@ -552,6 +552,88 @@ TEST(TestOprIndexing, ZeroSize) {
     ASSERT_EQ(host_y.shape(), TensorShape({0}));
 }
 
+TEST(TestOprIndexing, EmbeddingBag) {
+    using Mode = opr::EmbeddingBag::Param::Mode;
+    constexpr size_t N = 50, D = 12;
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto host_table = gen({N, D}, cn);
+    // the second bag is empty
+    std::vector<int> indices_val{3, 7, 3, 49, 0, 11, 11}, offsets_val{0, 2, 2, 5};
+    HostTensorND host_indices{cn, {indices_val.size()}, dtype::Int32()},
+            host_offsets{cn, {offsets_val.size()}, dtype::Int32()};
+    std::copy(indices_val.begin(), indices_val.end(), host_indices.ptr<int>());
+    std::copy(offsets_val.begin(), offsets_val.end(), host_offsets.ptr<int>());
+    size_t B = offsets_val.size();
+
+    auto expect = [&](Mode mode) {
+        HostTensorND ret{cn, {B, D}, dtype::Float32()};
+        auto table = host_table->ptr<float>();
+        for (size_t b = 0; b < B; ++b) {
+            size_t begin = offsets_val[b],
+                   end = b + 1 < B ? offsets_val[b + 1] : indices_val.size();
+            for (size_t d = 0; d < D; ++d) {
+                float acc = 0;
+                for (size_t j = begin; j < end; ++j) {
+                    acc += table[indices_val[j] * D + d];
+                }
+                if (mode == Mode::MEAN && end > begin) {
+                    acc /= end - begin;
+                }
+                ret.ptr<float>()[b * D + d] = acc;
+            }
+        }
+        return ret;
+    };
+
+    // table at an offset of the file which is not aligned to the page size
+    auto table_path = output_file("embedding_bag_table.bin");
+    constexpr size_t table_offset = 100;
+    {
+        FILE* fout = fopen(table_path.c_str(), "wb");
+        ASSERT_NE(fout, nullptr);
+        std::vector<char> padding(table_offset);
+        fwrite(padding.data(), 1, padding.size(), fout);
+        fwrite(host_table->raw_ptr(), 1, N * D * sizeof(float), fout);
+        fclose(fout);
+    }
+    auto mmap_table = opr::EmbeddingBag::mmap_table(
+            table_path, {N, D}, dtype::Float32(), table_offset, cn);
+
+    auto graph = ComputingGraph::make();
+    auto indices = opr::SharedDeviceTensor::make(*graph, host_indices),
+         offsets = opr::SharedDeviceTensor::make(*graph, host_offsets);
+    auto make = [&](const HostTensorND& table, Mode mode) {
+        return opr::EmbeddingBag::make(
+                opr::SharedDeviceTensor::make(*graph, table), indices, offsets,
+                {mode});
+    };
+    auto table_f16 = opr::EmbeddingBag::convert_table(*host_table, dtype::Float16()),
+         table_u8 = opr::EmbeddingBag::convert_table(*host_table, dtype::Uint8());
+    ASSERT_EQ(TensorShape({N, D + 8}), table_u8.shape());
+    SymbolVarArray ys{
+            make(*host_table, Mode::SUM), make(*host_table, Mode::MEAN),
+            make(table_f16, Mode::MEAN), make(table_u8, Mode::SUM),
+            opr::EmbeddingBag::make(
+                    opr::SharedDeviceTensor::make(
+                            *graph, std::make_shared<DeviceTensorND>(mmap_table)),
+                    indices, offsets, {Mode::SUM})};
+    std::vector<HostTensorND> host_ys(ys.size());
+    ComputingGraph::OutputSpec outspec;
+    for (size_t i = 0; i < ys.size(); ++i) {
+        outspec.push_back(make_callback_copy(ys[i], host_ys[i]));
+    }
+    auto func = graph->compile(outspec);
+    func->execute();
+    auto sum = expect(Mode::SUM), mean = expect(Mode::MEAN);
+    MGB_ASSERT_TENSOR_NEAR(sum, host_ys[0], 1e-6);
+    MGB_ASSERT_TENSOR_NEAR(mean, host_ys[1], 1e-6);
+    MGB_ASSERT_TENSOR_NEAR(mean, host_ys[2], 1e-3);
+    // each row is quantized to 1 / 255 of its range, and a bag has 3 rows
+    MGB_ASSERT_TENSOR_NEAR(sum, host_ys[3], 5e-2);
+    MGB_ASSERT_TENSOR_EQ(sum, host_ys[4]);
+}
+
 #if MGB_ENABLE_EXCEPTION
 namespace {
 
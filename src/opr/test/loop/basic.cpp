@@ -46,6 +46,10 @@ public:
     static ThinHashMap<VarNode*, bool> var_rec_spec(cg::OperatorNodeBase* opr) {
         return opr->cast_final_safe<Loop>().test_get_var_rec_spec();
     }
+
+    static int body_recordable(cg::OperatorNodeBase* opr) {
+        return opr->cast_final_safe<Loop>().m_body_recordable;
+    }
 };
 
 }  // namespace intl
@@ -747,6 +751,51 @@ TEST(TestOprLoop, RecordOutputSum) {
             .run({TensorShape{23}}, opt);
 }
 
+TEST(TestOprLoop, BodyRecord) {
+    static constexpr int LOOP_TIME = 9;
+    HostTensorGenerator<> gen;
+    auto host_x = gen({23}, "cpu0");
+    auto run = [&](bool record) {
+        auto graph = ComputingGraph::make();
+        graph->options().enable_loop_body_record = record;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+        auto desc_maker = [&](LoopDesc& desc) {
+            auto xl = desc.add_input_assignable(x),
+                 xu = xl * .5f + desc.add_input(x), cnt = desc.get_counter_var();
+            desc.assign(xl, xu);
+            desc.add_output(xu, OutputMode::SUM);
+            desc.add_output(xu * cnt, OutputMode::SUM);
+            desc.set_loop_condition(cnt < LOOP_TIME - 1);
+        };
+        auto y = opr::Loop::make(desc_maker);
+        HostTensorND host_y0, host_y1;
+        auto f = graph->compile(
+                {make_callback_copy(y[0], host_y0), make_callback_copy(y[1], host_y1)});
+        auto loop_opr = y[0].node()->owner_opr();
+        ASSERT_TRUE(LoopTest::is_static_loop_time(loop_opr));
+
+        for (int iter = 0; iter < 2; ++iter) {
+            *host_x = *gen({23}, "cpu0");
+            f->execute();
+            ASSERT_EQ(record ? 1 : 0, LoopTest::body_recordable(loop_opr));
+
+            auto px = host_x->ptr<float>();
+            for (size_t i = 0; i < 23; ++i) {
+                float xl = px[i], sum0 = 0, sum1 = 0;
+                for (int j = 0; j < LOOP_TIME; ++j) {
+                    xl = xl * .5f + px[i];
+                    sum0 += xl;
+                    sum1 += xl * j;
+                }
+                MGB_ASSERT_FLOAT_EQ(sum0, host_y0.ptr<float>()[i]);
+                MGB_ASSERT_FLOAT_EQ(sum1, host_y1.ptr<float>()[i]);
+            }
+        }
+    };
+    run(false);
+    run(true);
+}
+
 TEST(TestOprLoop, DynamicCases) {
     using Checker = AutoOprChecker<1, 4>;
 
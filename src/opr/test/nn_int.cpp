@@ -677,4 +677,53 @@ TEST(TestOprElemwiseMultiType, QuantizedModeTernary_I8Asymm_O8Asymm) {
 }
 #undef MAKE_TERNARY
 
+TEST(TestOprElemwiseMultiOutput, SigmoidMul) {
+    using Checker = AutoOprChecker<2, 2>;
+    auto make_graph = [](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        auto out = opr::ElemwiseMultiOutput::make(
+                {inputs[0], inputs[1]},
+                {opr::ElemwiseMultiOutput::Mode::SIGMOID_MUL});
+        return {out[0], out[1]};
+    };
+    auto fwd = [](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        auto x = inp[0]->ptr<float>(), y = inp[1]->ptr<float>();
+        auto s = dest[0].resize(inp[0]->shape()).ptr<float>(),
+             z = dest[1].resize(inp[0]->shape()).ptr<float>();
+        for (size_t i = 0, it = inp[0]->shape().total_nr_elems(); i < it; ++i) {
+            s[i] = 1.f / (1.f + std::exp(-x[i]));
+            z[i] = s[i] * y[i];
+        }
+    };
+    Checker{make_graph, fwd}
+            .run({TensorShape{3, 4}, {3, 4}})
+            .run({TensorShape{2, 5, 7}, {2, 5, 7}})
+            .run({TensorShape{1031}, {1031}});
+}
+
+TEST(TestOprElemwiseMultiOutput, MomentumUpdate) {
+    using Checker = AutoOprChecker<3, 2>;
+    opr::ElemwiseMultiOutput::Param param{
+            opr::ElemwiseMultiOutput::Mode::MOMENTUM_UPDATE, 0.9f, 0.1f};
+    auto make_graph =
+            [&](const Checker::SymInpArray& inputs) -> Checker::SymOutArray {
+        auto out = opr::ElemwiseMultiOutput::make(
+                {inputs[0], inputs[1], inputs[2]}, param);
+        return {out[0], out[1]};
+    };
+    auto fwd = [&](Checker::NumOutArray& dest, Checker::NumInpArray inp) {
+        auto p = inp[0]->ptr<float>(), b = inp[1]->ptr<float>(),
+             g = inp[2]->ptr<float>();
+        auto new_p = dest[0].resize(inp[0]->shape()).ptr<float>(),
+             new_b = dest[1].resize(inp[0]->shape()).ptr<float>();
+        for (size_t i = 0, it = inp[0]->shape().total_nr_elems(); i < it; ++i) {
+            new_b[i] = param.momentum * b[i] + g[i];
+            new_p[i] = p[i] - param.lr * new_b[i];
+        }
+    };
+    Checker{make_graph, fwd}
+            .disable_grad_check()
+            .run({TensorShape{3, 4}, {3, 4}, {3, 4}})
+            .run({TensorShape{1031}, {1031}, {1031}});
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
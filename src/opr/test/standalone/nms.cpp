@@ -81,6 +81,42 @@ void run_empty_input_on_comp_node(const char* cn_name) {
     }
 }
 
+//! results of each batch on a multi-thread comp node equal the ones on cpu0
+void run_batched_multi_thread(const char* cn_name) {
+    constexpr size_t BATCH = 7, NR_BOXES = 300;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> pos(0, 100), len(1, 30);
+    auto run = [&](CompNode cn, HostTensorND& host_idx, HostTensorND& host_size) {
+        auto graph = ComputingGraph::make();
+        auto host_x = std::make_shared<HostTensorND>(
+                cn, TensorShape{BATCH, NR_BOXES, 4}, dtype::Float32{});
+        rng.seed(42);
+        auto ptr = host_x->ptr<float>();
+        for (size_t i = 0; i < BATCH * NR_BOXES; ++i) {
+            ptr[i * 4] = pos(rng);
+            ptr[i * 4 + 1] = pos(rng);
+            ptr[i * 4 + 2] = ptr[i * 4] + len(rng);
+            ptr[i * 4 + 3] = ptr[i * 4 + 1] + len(rng);
+        }
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+        auto idx = opr::standalone::NMSKeep::make(x, {0.3, 100});
+        auto size = idx.node()->owner_opr()->output(1);
+        auto func = graph->compile(
+                {make_callback_copy(idx, host_idx),
+                 make_callback_copy(size, host_size)});
+        func->execute().wait();
+    };
+    HostTensorND expect_idx, expect_size, got_idx, got_size;
+    run(CompNode::load("cpu0"), expect_idx, expect_size);
+    run(CompNode::load(cn_name), got_idx, got_size);
+    MGB_ASSERT_TENSOR_EQ(expect_size, got_size);
+    MGB_ASSERT_TENSOR_EQ(expect_idx, got_idx);
+    auto size_ptr = got_size.ptr<int32_t>();
+    for (size_t i = 0; i < BATCH; ++i) {
+        ASSERT_GT(size_ptr[i], 0);
+    }
+}
+
 }  // namespace
 
 TEST(TestOprNMS, CPU) {
@@ -92,6 +128,10 @@ TEST(TestOprNMS, GPU) {
     run_on_comp_node("gpu0");
 }
 
+TEST(TestOprNMS, CPUMultiThread) {
+    run_batched_multi_thread("multithread4:0");
+}
+
 TEST(TestOprNMSEmptyIO, CPU) {
     run_empty_input_on_comp_node("cpu0");
 }
@@ -1433,6 +1433,49 @@ TEST(TestTensorManip, ConcatEmpty) {
     MGB_ASSERT_TENSOR_EQ(*host_y, host_z);
 }
 
+TEST(TestTensorManip, ConcatOut2InFwd) {
+    HostTensorGenerator<> gen;
+    auto host_x0 = gen({1, 3, 4, 4}), host_x1 = gen({1, 5, 4, 4}),
+         host_y0 = gen({2, 3, 4}), host_y1 = gen({2, 5, 4});
+    auto graph = ComputingGraph::make();
+    auto mkx = [&](const std::shared_ptr<HostTensorND>& host) {
+        return opr::Host2DeviceCopy::make(*graph, host);
+    };
+    // a, b are computed directly into the slices of c; y2 can not be
+    // forwarded since the leading dim makes the slices non-contiguous
+    auto a = mkx(host_x0) + 1, b = mkx(host_x1) * 2,
+         c = opr::Concat::make({a, b}, 1), y0 = mkx(host_y0) + 1,
+         y1 = mkx(host_y1) * 2, y2 = opr::Concat::make({y0, y1}, 1);
+    HostTensorND host_c, host_y2;
+    auto func = graph->compile(
+            {make_callback_copy(c, host_c), make_callback_copy(y2, host_y2)});
+    func->execute();
+
+    auto check = [](const HostTensorND& dest, const HostTensorND& src0,
+                    const HostTensorND& src1) {
+        size_t n = src0.shape(0), c0 = src0.shape(1), c1 = src1.shape(1),
+               inner = src0.layout().total_nr_elems() / (n * c0);
+        ASSERT_EQ(n * (c0 + c1) * inner, dest.layout().total_nr_elems());
+        auto i0 = src0.ptr<float>(), i1 = src1.ptr<float>(),
+             o = dest.ptr<float>();
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < c0 * inner; ++j) {
+                ASSERT_EQ(i0[i * c0 * inner + j] + 1, *(o++));
+            }
+            for (size_t j = 0; j < c1 * inner; ++j) {
+                ASSERT_EQ(i1[i * c1 * inner + j] * 2, *(o++));
+            }
+        }
+    };
+    check(host_c, *host_x0, *host_x1);
+    check(host_y2, *host_y0, *host_y1);
+
+    auto c_ptr = static_cast<const dt_byte*>(prev_dev_ptr(c));
+    ASSERT_EQ(c_ptr, prev_dev_ptr(a));
+    ASSERT_EQ(c_ptr + a.node()->dtype().size(3 * 4 * 4), prev_dev_ptr(b));
+    ASSERT_NE(prev_dev_ptr(y2), prev_dev_ptr(y0));
+}
+
 TEST(TestTensorManip, ConcatEmpty2) {
     HostTensorGenerator<> gen;
     auto host_x = gen({2, 0, 5}), host_y = gen({2, 0, 6});
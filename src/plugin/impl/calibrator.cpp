@@ -0,0 +1,257 @@
+/**
+ * \file src/plugin/impl/calibrator.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "megbrain/plugin/calibrator.h"
+#include "megbrain/opr/io.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace mgb;
+
+namespace {
+
+//! log2 of the bin width when only zeros are met
+constexpr int MIN_WIDTH_EXP = -126;
+
+template <typename ctype>
+void update_histogram(const HostTensorND& hv, Calibrator::Histogram& hist) {
+    auto ptr = hv.ptr<ctype>();
+    size_t size = hv.shape().total_nr_elems();
+    float amax = 0.f;
+    for (size_t i = 0; i < size; ++i) {
+        amax = std::max(amax, std::fabs(static_cast<float>(ptr[i])));
+    }
+    hist.cover(amax);
+    float inv_width = 1.f / hist.bin_width();
+    size_t nr_bins = hist.bins.size();
+    for (size_t i = 0; i < size; ++i) {
+        size_t idx = std::fabs(static_cast<float>(ptr[i])) * inv_width;
+        ++hist.bins[std::min(idx, nr_bins - 1)];
+    }
+    hist.amax = std::max(hist.amax, amax);
+    hist.total += size;
+}
+
+//! KL divergence of the bins quantized to nr_levels from the first i bins
+double quantized_kl_divergence(
+        const std::vector<uint64_t>& bins, size_t i, size_t nr_levels) {
+    std::vector<double> p(bins.begin(), bins.begin() + i), q(i, 0.);
+    // the outliers are clipped to the last bin
+    for (size_t j = i; j < bins.size(); ++j) {
+        p[i - 1] += bins[j];
+    }
+    for (size_t level = 0; level < nr_levels; ++level) {
+        size_t start = i * level / nr_levels, stop = i * (level + 1) / nr_levels;
+        double sum = 0;
+        size_t nr_nonzero = 0;
+        for (size_t j = start; j < stop; ++j) {
+            sum += bins[j];
+            nr_nonzero += bins[j] != 0;
+        }
+        // the count of a level is spread over its non-zero bins
+        for (size_t j = start; j < stop; ++j) {
+            if (bins[j]) {
+                q[j] = sum / nr_nonzero;
+            }
+        }
+    }
+    double psum = 0, qsum = 0;
+    for (size_t j = 0; j < i; ++j) {
+        psum += p[j];
+        qsum += q[j];
+    }
+    if (psum == 0 || qsum == 0) {
+        return 0;
+    }
+    double kl = 0;
+    for (size_t j = 0; j < i; ++j) {
+        if (p[j] > 0) {
+            // p of the clipped outliers may have no counterpart in q
+            double pj = p[j] / psum, qj = std::max(q[j] / qsum, 1e-7);
+            kl += pj * std::log(pj / qj);
+        }
+    }
+    return kl;
+}
+
+float threshold_of(
+        const Calibrator::Histogram& hist, Calibrator::Method method,
+        float percentile, int qmax) {
+    using Method = Calibrator::Method;
+    size_t nr_bins = hist.bins.size();
+    if (method == Method::PERCENTILE) {
+        uint64_t target = std::ceil(static_cast<double>(percentile) * hist.total),
+                 cnt = 0;
+        for (size_t i = 0; i < nr_bins; ++i) {
+            cnt += hist.bins[i];
+            if (cnt >= target) {
+                return std::min(hist.amax, (i + 1) * hist.bin_width());
+            }
+        }
+    } else if (method == Method::ENTROPY) {
+        size_t nr_levels = qmax + 1, used = nr_bins;
+        while (used > nr_levels && !hist.bins[used - 1]) {
+            --used;
+        }
+        if (used > nr_levels) {
+            size_t best = used;
+            double best_kl = std::numeric_limits<double>::infinity();
+            for (size_t i = nr_levels; i <= used; ++i) {
+                double kl = quantized_kl_divergence(hist.bins, i, nr_levels);
+                if (kl < best_kl) {
+                    best_kl = kl;
+                    best = i;
+                }
+            }
+            return std::min(hist.amax, best * hist.bin_width());
+        }
+    }
+    return hist.amax;
+}
+
+}  // anonymous namespace
+
+/* ======================= Histogram ======================= */
+
+float Calibrator::Histogram::bin_width() const {
+    return std::ldexp(1.f, width_exp);
+}
+
+void Calibrator::Histogram::cover(float value) {
+    size_t nr_bins = bins.size();
+    if (!total) {
+        width_exp = value > 0 ? std::ilogb(value / nr_bins) + 1 : MIN_WIDTH_EXP;
+    }
+    while (value >= bin_width() * nr_bins) {
+        for (size_t i = 0; i < nr_bins / 2; ++i) {
+            bins[i] = bins[i * 2] + bins[i * 2 + 1];
+        }
+        std::fill(bins.begin() + nr_bins / 2, bins.end(), 0);
+        ++width_exp;
+    }
+}
+
+void Calibrator::Histogram::merge(const Histogram& rhs) {
+    mgb_assert(bins.size() == rhs.bins.size(), "histograms of different sizes");
+    if (!rhs.total) {
+        return;
+    }
+    if (!total) {
+        *this = rhs;
+        return;
+    }
+    Histogram other = rhs;
+    if (other.width_exp < width_exp) {
+        other.cover(bin_width() * bins.size() / 2);
+    } else {
+        cover(other.bin_width() * bins.size() / 2);
+    }
+    mgb_assert(width_exp == other.width_exp);
+    for (size_t i = 0; i < bins.size(); ++i) {
+        bins[i] += other.bins[i];
+    }
+    amax = std::max(amax, other.amax);
+    total += other.total;
+}
+
+/* ======================= Calibrator ======================= */
+
+Calibrator::Calibrator(cg::ComputingGraph* graph, size_t nr_bins)
+        : PluginBase(graph), m_nr_bins{nr_bins} {
+    mgb_assert(
+            nr_bins >= 2 && nr_bins % 2 == 0, "bad number of histogram bins: %zu",
+            nr_bins);
+    add_member_func_as_event_handler(&Calibrator::on_kern_end);
+}
+
+void Calibrator::on_kern_end(const cg::event::OprExecKernelEnd& event) {
+    auto opr = event.opr;
+    if (opr->input().empty() && !opr->same_type<opr::Host2DeviceCopy>()) {
+        return;
+    }
+    for (VarNode* var : opr->output()) {
+        if (!var->contain_flag(VarNode::Flag::VOLATILE_CONTENT) &&
+            var->dtype().category() == DTypeCategory::FLOAT) {
+            event.env->dispatch_on_comp_node(
+                    var->comp_node(), [this, var]() { on_var_computed(var); });
+        }
+    }
+}
+
+void Calibrator::on_var_computed(VarNode* var) {
+    if (!var->dev_tensor_valid())
+        return;
+
+    auto&& val = var->dev_tensor();
+    HostTensorND hv;
+    if (val.layout().is_contiguous()) {
+        hv.copy_from(val).sync();
+    } else {
+        DeviceTensorND contig;
+        contig.copy_from(val);
+        hv.copy_from(contig).sync();
+    }
+    if (!hv.shape().total_nr_elems())
+        return;
+
+    MGB_LOCK_GUARD(m_mtx);
+    auto&& hist = m_histograms[var->name()];
+    if (hist.bins.empty()) {
+        hist.bins.resize(m_nr_bins);
+    }
+    switch (hv.dtype().enumv()) {
+#define cb(_dt)                                             \
+    case DTypeTrait<_dt>::enumv:                            \
+        update_histogram<DTypeTrait<_dt>::ctype>(hv, hist); \
+        break;
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            mgb_assert(0, "unexpected dtype");
+    }
+}
+
+void Calibrator::merge(const Calibrator& rhs) {
+    mgb_assert(
+            this != &rhs && m_nr_bins == rhs.m_nr_bins,
+            "can not merge a calibrator of different bins or itself");
+    MGB_LOCK_GUARD(m_mtx);
+    MGB_LOCK_GUARD(rhs.m_mtx);
+    for (auto&& i : rhs.m_histograms) {
+        auto&& hist = m_histograms[i.first];
+        if (hist.bins.empty()) {
+            hist.bins.resize(m_nr_bins);
+        }
+        hist.merge(i.second);
+    }
+}
+
+Calibrator::ScaleMap Calibrator::scales(
+        Method method, float percentile, int qmax) const {
+    mgb_assert(qmax > 0 && percentile > 0 && percentile <= 1);
+    MGB_LOCK_GUARD(m_mtx);
+    ScaleMap ret;
+    for (auto&& i : m_histograms) {
+        float threshold = threshold_of(i.second, method, percentile, qmax);
+        ret[i.first] = threshold > 0 ? threshold / qmax : 1.f;
+    }
+    return ret;
+}
+
+const Calibrator::Histogram* Calibrator::histogram(const std::string& name) const {
+    MGB_LOCK_GUARD(m_mtx);
+    auto iter = m_histograms.find(name);
+    return iter == m_histograms.end() ? nullptr : &iter->second;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,340 @@
+/**
+ * \file src/plugin/impl/memory_timeline.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/memory_timeline.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace mgb;
+using namespace cg;
+
+MemoryTimeline::MemoryTimeline(cg::ComputingGraph* graph) : PluginBase(graph) {
+    add_member_func_as_event_handler(&MemoryTimeline::on_seq_start);
+    add_member_func_as_event_handler(&MemoryTimeline::on_opr_start);
+    add_member_func_as_event_handler(&MemoryTimeline::on_opr_finish);
+}
+
+void MemoryTimeline::on_seq_start(const cg::event::CompSeqExecBeforeStart&) {
+    MGB_LOCK_GUARD(m_mtx);
+    m_steps.clear();
+    m_var_step.clear();
+    m_var_mem.clear();
+}
+
+void MemoryTimeline::on_opr_start(const cg::event::OprExecStart& event) {
+    MGB_LOCK_GUARD(m_mtx);
+    size_t step = m_steps.size();
+    m_steps.push_back(event.opr->name());
+    for (auto i : event.opr->input()) {
+        auto iter = m_var_step.find(i);
+        if (iter != m_var_step.end()) {
+            iter->second.second = step;
+        }
+    }
+    for (auto i : event.opr->output()) {
+        m_var_step[i] = {step, step};
+    }
+}
+
+void MemoryTimeline::on_opr_finish(const cg::event::OprExecFinished& event) {
+    for (auto var : event.opr->output()) {
+        // dynamic memory is allocated when the kernels run, so it is read
+        // after them on the comp node
+        auto runner = [this, var]() {
+            if (!var->dev_tensor_valid()) {
+                return;
+            }
+            auto&& chunk = var->mem_plan().chunk();
+            auto owner = chunk.owner_var;
+            VarMem mem{
+                    owner,
+                    "dynamic",
+                    0,
+                    chunk.size(),
+                    reinterpret_cast<size_t>(var->dev_tensor().storage().ptr()),
+                    owner->contain_flag(VarNode::Flag::PERSISTENT_DEVICE_VALUE)};
+            if (chunk.mem_alloc_status.is_static_offset()) {
+                mem.kind = "static";
+                mem.static_offset = chunk.mem_alloc_status.static_offset();
+            } else if (owner->contain_flag(VarNode::Flag::NO_SYS_MEM_ALLOC)) {
+                mem.kind = "external";
+            }
+            MGB_LOCK_GUARD(m_mtx);
+            m_var_mem[var] = mem;
+        };
+        event.env->dispatch_on_comp_node(var->comp_node(), runner);
+    }
+}
+
+std::vector<std::string> MemoryTimeline::steps() const {
+    MGB_LOCK_GUARD(m_mtx);
+    return m_steps;
+}
+
+std::vector<MemoryTimeline::Chunk> MemoryTimeline::chunks() const {
+    MGB_LOCK_GUARD(m_mtx);
+    size_t last_step = m_steps.empty() ? 0 : m_steps.size() - 1;
+    std::vector<Chunk> ret;
+    ThinHashMap<VarNode*, size_t> owner2idx;
+    for (auto&& i : m_var_mem) {
+        auto var = i.first;
+        auto&& mem = i.second;
+        auto ins = owner2idx.emplace(mem.owner, ret.size());
+        if (ins.second) {
+            ret.emplace_back();
+            auto&& chunk = ret.back();
+            chunk.owner_var = mem.owner->name();
+            chunk.owner_opr = mem.owner->owner_opr()->name();
+            chunk.comp_node = mem.owner->comp_node();
+            chunk.kind = mem.kind;
+            chunk.static_offset = mem.static_offset;
+            chunk.size = mem.size;
+            chunk.begin = last_step + 1;
+        }
+        auto&& chunk = ret[ins.first->second];
+        chunk.vars.push_back(var->name());
+        // a forwarded var may start in the middle of the chunk
+        if (var == mem.owner || !chunk.addr) {
+            chunk.addr = mem.addr;
+        }
+        if (mem.persistent) {
+            chunk.begin = 0;
+            chunk.end = last_step;
+        }
+        auto step = m_var_step.find(var);
+        if (step != m_var_step.end()) {
+            chunk.begin = std::min(chunk.begin, step->second.first);
+            chunk.end = std::max(chunk.end, step->second.second);
+        }
+    }
+    for (auto&& i : ret) {
+        i.begin = std::min(i.begin, i.end);
+    }
+    std::sort(ret.begin(), ret.end(), [](const Chunk& a, const Chunk& b) {
+        return std::make_pair(a.begin, a.addr) < std::make_pair(b.begin, b.addr);
+    });
+    return ret;
+}
+
+std::vector<size_t> MemoryTimeline::usage(
+        const std::vector<Chunk>& chunks, CompNode cn) const {
+    std::vector<size_t> ret(steps().size());
+    for (auto&& i : chunks) {
+        if (i.comp_node.mem_node() != cn.mem_node()) {
+            continue;
+        }
+        for (size_t step = i.begin; step <= i.end && step < ret.size(); ++step) {
+            ret[step] += i.size;
+        }
+    }
+    return ret;
+}
+
+MemoryTimeline::Peak MemoryTimeline::peak(
+        const std::vector<Chunk>& chunks, CompNode cn) const {
+    Peak ret;
+    auto used = usage(chunks, cn);
+    if (used.empty()) {
+        return ret;
+    }
+    auto iter = std::max_element(used.begin(), used.end());
+    ret.bytes = *iter;
+    ret.step = iter - used.begin();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        auto&& chunk = chunks[i];
+        if (chunk.comp_node.mem_node() == cn.mem_node() && chunk.begin <= ret.step &&
+            ret.step <= chunk.end) {
+            ret.live.push_back(i);
+        }
+    }
+    std::stable_sort(ret.live.begin(), ret.live.end(), [&](size_t a, size_t b) {
+        return chunks[a].size > chunks[b].size;
+    });
+    return ret;
+}
+
+#if MGB_ENABLE_JSON
+std::shared_ptr<json::Object> MemoryTimeline::to_json() const {
+    using namespace json;
+    auto all_steps = steps();
+    auto all_chunks = chunks();
+    auto chunk_json = [&](const Chunk& chunk) {
+        auto vars = Array::make();
+        for (auto&& i : chunk.vars) {
+            vars->add(String::make(i));
+        }
+        auto ret = Object::make(
+                {{"owner_var", String::make(chunk.owner_var)},
+                 {"owner_opr", String::make(chunk.owner_opr)},
+                 {"comp_node", String::make(chunk.comp_node.to_string())},
+                 {"kind", String::make(chunk.kind)},
+                 {"size", NumberInt::make(chunk.size)},
+                 {"addr", NumberInt::make(chunk.addr)},
+                 {"begin", NumberInt::make(chunk.begin)},
+                 {"end", NumberInt::make(chunk.end)},
+                 {"vars", vars}});
+        if (!strcmp(chunk.kind, "static")) {
+            (*ret)["static_offset"] = NumberInt::make(chunk.static_offset);
+        }
+        return ret;
+    };
+
+    auto steps_json = Array::make();
+    for (auto&& i : all_steps) {
+        steps_json->add(String::make(i));
+    }
+    auto chunks_json = Array::make();
+    for (auto&& i : all_chunks) {
+        chunks_json->add(chunk_json(i));
+    }
+
+    //! a comp node for each memory node
+    std::vector<CompNode> mem_nodes;
+    for (auto&& i : all_chunks) {
+        auto iter = std::find_if(mem_nodes.begin(), mem_nodes.end(), [&](CompNode cn) {
+            return cn.mem_node() == i.comp_node.mem_node();
+        });
+        if (iter == mem_nodes.end()) {
+            mem_nodes.push_back(i.comp_node);
+        }
+    }
+    auto mem_nodes_json = Object::make();
+    for (auto cn : mem_nodes) {
+        auto used = Array::make();
+        for (auto i : usage(all_chunks, cn)) {
+            used->add(NumberInt::make(i));
+        }
+        auto rst = peak(all_chunks, cn);
+        auto live = Array::make();
+        for (auto i : rst.live) {
+            live->add(chunk_json(all_chunks[i]));
+        }
+        (*mem_nodes_json)[cn.to_string()] = Object::make(
+                {{"peak_bytes", NumberInt::make(rst.bytes)},
+                 {"peak_step", NumberInt::make(rst.step)},
+                 {"peak_opr", String::make(
+                                      rst.step < all_steps.size() ? all_steps[rst.step]
+                                                                  : "")},
+                 {"usage", used},
+                 {"live_at_peak", live}});
+    }
+    return Object::make(
+            {{"steps", steps_json},
+             {"mem_node", mem_nodes_json},
+             {"chunks", chunks_json}});
+}
+#endif
+
+std::string MemoryTimeline::to_svg() const {
+    auto all_chunks = chunks();
+    auto all_steps = steps();
+    size_t addr_begin = std::numeric_limits<size_t>::max(), addr_end = 0;
+    for (auto&& i : all_chunks) {
+        if (i.addr && i.size) {
+            addr_begin = std::min(addr_begin, i.addr);
+            addr_end = std::max(addr_end, i.addr + i.size);
+        }
+    }
+    if (addr_begin >= addr_end) {
+        addr_begin = addr_end = 0;
+    }
+    // about 1000 pixels in height, and 10 pixels for each step
+    double step_scale = 10, addr_scale = std::max((addr_end - addr_begin) / 1e3, 1.);
+    double width = all_steps.size() * step_scale,
+           height = (addr_end - addr_begin) / addr_scale;
+
+    auto escape = [](const std::string& str) {
+        std::string ret;
+        for (char c : str) {
+            switch (c) {
+                case '&':
+                    ret += "&amp;";
+                    break;
+                case '<':
+                    ret += "&lt;";
+                    break;
+                case '>':
+                    ret += "&gt;";
+                    break;
+                case '"':
+                    ret += "&quot;";
+                    break;
+                default:
+                    ret += c;
+            }
+        }
+        return ret;
+    };
+    auto size2str = [](size_t sz) {
+        static const std::pair<size_t, const char*> units[] = {
+                {1024 * 1024 * 1024, "GB "},
+                {1024 * 1024, "MB "},
+                {1024, "KB "},
+                {1, "B "}};
+        std::string ret;
+        for (auto&& i : units) {
+            if (sz >= i.first) {
+                ret += std::to_string(sz / i.first) + i.second;
+                sz %= i.first;
+            }
+        }
+        return ret;
+    };
+    auto step2str = [&](size_t step) {
+        return ssprintf(
+                "%zu %s", step,
+                step < all_steps.size() ? all_steps[step].c_str() : "");
+    };
+
+    std::string ret =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
+            "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n";
+    ret += ssprintf(
+            "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+            "xmlns:tag=\"https://megengine.org.cn\" width=\"%g\" height=\"%g\">\n",
+            width, height);
+    ret += ssprintf(
+            "<rect x=\"0\" y=\"0\" width=\"%g\" height=\"%g\" fill=\"blue\">\n</rect>\n",
+            width, height);
+    for (auto&& i : all_chunks) {
+        if (!i.addr || !i.size) {
+            continue;
+        }
+        const char* fill = "#AAAAAA";
+        if (!strcmp(i.kind, "dynamic")) {
+            fill = "#DDDDDD";
+        } else if (!strcmp(i.kind, "external")) {
+            fill = "#555555";
+        }
+        std::string vars;
+        for (auto&& var : i.vars) {
+            vars += (vars.empty() ? "" : ",") + var;
+        }
+        ret += ssprintf(
+                "<rect x=\"%g\" y=\"%g\" height=\"%g\" width=\"%g\" fill=\"%s\" "
+                "tag:type=\"%s\" tag:name=\"%s\" tag:address=\"%p\" tag:size=\"%s\" "
+                "tag:produced=\"%s\" tag:erased=\"%s\" tag:duration=\"%zu steps\" "
+                "tag:vars=\"%s\">\n</rect>\n",
+                i.begin * step_scale, (i.addr - addr_begin) / addr_scale,
+                i.size / addr_scale, (i.end - i.begin + 1) * step_scale, fill, i.kind,
+                escape(i.owner_var).c_str(), reinterpret_cast<void*>(i.addr),
+                size2str(i.size).c_str(), escape(step2str(i.begin)).c_str(),
+                escape(step2str(i.end)).c_str(), i.end - i.begin + 1,
+                escape(vars).c_str());
+    }
+    ret += "</svg>\n";
+    return ret;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,190 @@
+/**
+ * \file src/plugin/impl/non_finite_checker.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/non_finite_checker.h"
+
+using namespace mgb;
+
+NonFiniteChecker::NonFiniteChecker(
+        cg::ComputingGraph* graph, size_t interval, VarFilter filter)
+        : PluginBase(graph), m_interval{interval}, m_filter{std::move(filter)} {
+    mgb_assert(interval, "interval of NonFiniteChecker should be positive");
+    m_on_fault = [](const Fault& fault) {
+        mgb_log_error(
+                "non-finite value found in var %s of opr %s{%s} #%zu at run %zu",
+                fault.var_name.c_str(), fault.opr_name.c_str(),
+                fault.opr_type.c_str(), fault.opr_id, fault.run_id);
+    };
+    add_member_func_as_event_handler(&NonFiniteChecker::on_seq_start);
+    add_member_func_as_event_handler(&NonFiniteChecker::on_kern_end);
+    add_member_func_as_event_handler(&NonFiniteChecker::on_seq_finish);
+    add_member_func_as_event_handler(&NonFiniteChecker::on_order_determined);
+}
+
+NonFiniteChecker::~NonFiniteChecker() noexcept {
+    if (m_pending.valid()) {
+        for (auto&& i : m_cn_state) {
+            i.second.copied->host_wait();
+        }
+    }
+}
+
+void NonFiniteChecker::init_slots(cg::AsyncExecutable* exec) {
+    poll(true);
+    m_exec = exec;
+    m_slots.clear();
+    m_var2slot.clear();
+    m_cn_state.clear();
+
+    CompNode::UnorderedMap<size_t> cn2size;
+    exec->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+        for (auto var : opr->output()) {
+            if (var->contain_flag(VarNode::Flag::VOLATILE_CONTENT) ||
+                var->dtype() != dtype::Float32() || (m_filter && !m_filter(var))) {
+                continue;
+            }
+            m_var2slot[var] = m_slots.size();
+            m_slots.push_back({var, cn2size[var->comp_node()]++});
+        }
+        return true;
+    });
+    for (auto&& i : cn2size) {
+        auto cn = i.first;
+        auto&& state = m_cn_state[cn];
+        state.opr = opr::intl::create_megdnn_opr<megdnn::CheckNonFinite>(cn);
+        state.result = {cn, {i.second}, dtype::Int32()};
+        state.workspace = {cn, dtype::Byte()};
+        state.host_result = {cn, {i.second}, dtype::Int32()};
+        state.copied = cn.create_event();
+    }
+    m_checked.reset(new std::atomic_bool[m_slots.size()]);
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        m_checked[i] = false;
+    }
+}
+
+void NonFiniteChecker::check(size_t slot) {
+    auto var = m_slots[slot].var;
+    if (!var->dev_tensor_valid()) {
+        return;
+    }
+    auto&& val = var->dev_tensor();
+    if (!val.layout().is_contiguous() || val.shape().is_empty()) {
+        return;
+    }
+    auto cn = var->comp_node();
+    auto&& state = m_cn_state.at(cn);
+    auto src = val.as_megdnn();
+    src.layout = {{src.layout.total_nr_elems()}, src.layout.dtype};
+    megdnn::TensorND dst{
+            state.result.ptr<dt_int32>() + m_slots[slot].idx,
+            {{1}, dtype::Int32()}};
+    // the kernels of all the checks on a comp node are issued by its
+    // dispatcher sequentially, so they can share the workspace
+    size_t workspace_size = state.opr->get_workspace_in_bytes(src.layout, dst.layout);
+    megdnn::Workspace workspace;
+    if (workspace_size) {
+        if (workspace_size > state.workspace.shape().total_nr_elems()) {
+            state.workspace.resize({workspace_size});
+        }
+        workspace = {state.workspace.raw_ptr(), workspace_size};
+    }
+    cn.activate();
+    state.opr->exec(src, dst, workspace);
+    m_checked[slot] = true;
+}
+
+void NonFiniteChecker::on_seq_start(const cg::event::CompSeqExecBeforeStart& event) {
+    if (m_exec != event.exec) {
+        init_slots(event.exec);
+    }
+    poll();
+    m_active = !m_fault.valid() && !m_slots.empty() && !(m_nr_exec % m_interval);
+    ++m_nr_exec;
+    m_run_id = event.exec->get_run_id();
+}
+
+void NonFiniteChecker::on_kern_end(const cg::event::OprExecKernelEnd& event) {
+    if (!m_active) {
+        return;
+    }
+    for (auto var : event.opr->output()) {
+        auto iter = m_var2slot.find(var);
+        if (iter == m_var2slot.end()) {
+            continue;
+        }
+        m_checked_run_id = m_run_id;
+        event.env->dispatch_on_comp_node(
+                var->comp_node(), [this, slot = iter->second]() { check(slot); });
+    }
+}
+
+void NonFiniteChecker::on_seq_finish(const cg::event::CompSeqExecFinished& event) {
+    if (!event.device_actually_finished || m_slots.empty()) {
+        return;
+    }
+    bool any_checked = false;
+    for (size_t i = 0; i < m_slots.size() && !any_checked; ++i) {
+        any_checked = m_checked[i];
+    }
+    if (!any_checked) {
+        return;
+    }
+    // the copy of the previous check must have been finished long ago
+    poll(true);
+    Pending pending{m_checked_run_id, std::vector<bool>(m_slots.size())};
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        pending.checked[i] = m_checked[i].exchange(false);
+    }
+    for (auto&& i : m_cn_state) {
+        i.second.host_result.copy_from(i.second.result);
+        i.second.copied->record();
+    }
+    m_pending = std::move(pending);
+}
+
+void NonFiniteChecker::on_order_determined(const cg::event::CompSeqOrderDetermined&) {
+    // rebuild the slots before the next execution
+    m_exec = nullptr;
+}
+
+const Maybe<NonFiniteChecker::Fault>& NonFiniteChecker::poll(bool wait) {
+    if (!m_pending.valid()) {
+        return m_fault;
+    }
+    for (auto&& i : m_cn_state) {
+        if (!i.second.copied->finished()) {
+            if (!wait) {
+                return m_fault;
+            }
+            i.second.copied->host_wait();
+        }
+    }
+    auto&& pending = m_pending.val();
+    for (size_t i = 0; i < m_slots.size() && !m_fault.valid(); ++i) {
+        if (!pending.checked[i]) {
+            continue;
+        }
+        auto&& slot = m_slots[i];
+        auto&& host_result = m_cn_state.at(slot.var->comp_node()).host_result;
+        if (host_result.ptr<dt_int32>()[slot.idx]) {
+            auto opr = slot.var->owner_opr();
+            m_fault = Fault{
+                    pending.run_id, opr->id(), opr->name(), opr->dyn_typeinfo()->name,
+                    slot.var->name()};
+            m_on_fault(m_fault.val());
+        }
+    }
+    m_pending.invalidate();
+    return m_fault;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
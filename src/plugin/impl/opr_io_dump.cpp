@@ -15,7 +15,17 @@
 
 #include "megdnn/tensor_iter.h"
 
+#include <cerrno>
 #include <cmath>
+#include <cstring>
+
+#ifndef MGB_HAVE_ZLIB
+#define MGB_HAVE_ZLIB 0
+#endif
+
+#if MGB_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace mgb;
 
@@ -446,4 +456,249 @@ BinaryOprIODump::~BinaryOprIODump() {
     flush_lazy();
 }
 
+/* =================== AsyncBinaryOprIODump =================== */
+
+/*
+ * Layout of the file, all integers in little endian:
+ *
+ *  header:  "MGBIODMP" u32 version u32 reserved
+ *  values:  the values written by debug::dump_tensor, each may be compressed
+ *  index:   for each value: u64 offset u64 size u64 raw_size u64 seq
+ *           u32 codec u32 name_len char name[name_len]
+ *  trailer: u64 index_offset u64 nr_values "MGBIODIX"
+ *
+ * seq is the order in which the values are copied, and name is the file name
+ * that BinaryOprIODump would use for the value. The index and trailer are
+ * rewritten after the values appended by each flush().
+ */
+namespace {
+constexpr char IODUMP_MAGIC[] = "MGBIODMP", IODUMP_INDEX_MAGIC[] = "MGBIODIX";
+constexpr uint32_t IODUMP_VERSION = 1;
+enum IODumpCodec : uint32_t { IODUMP_RAW = 0, IODUMP_ZLIB = 1 };
+
+template <typename T>
+void append_pod(std::string& dst, T val) {
+    dst.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+void write_at(FILE* fout, size_t offset, const std::string& data) {
+    mgb_throw_if(
+            fseek(fout, offset, SEEK_SET) ||
+                    fwrite(data.data(), 1, data.size(), fout) != data.size(),
+            SystemError, "failed to write iodump file: %s", strerror(errno));
+}
+}  // anonymous namespace
+
+struct AsyncBinaryOprIODump::HostBuf {
+    HostTensorND value;
+    //! temp storage for non-contiguous values
+    DeviceTensorND contig;
+    std::unique_ptr<CompNode::Event> copied;
+};
+
+struct AsyncBinaryOprIODump::Entry {
+    std::unique_ptr<HostBuf> buf;
+    std::string name, title;
+    size_t seq, bytes;
+};
+
+struct AsyncBinaryOprIODump::IndexItem {
+    uint64_t offset, size, raw_size, seq;
+    uint32_t codec;
+    std::string name;
+};
+
+AsyncBinaryOprIODump::AsyncBinaryOprIODump(
+        cg::ComputingGraph* graph, const std::string& output_file, size_t nr_threads)
+        : OprIODumpBase(graph) {
+    mgb_assert(nr_threads);
+    m_fout = fopen(output_file.c_str(), "wb");
+    mgb_throw_if(
+            !m_fout, SystemError, "failed to open %s: %s", output_file.c_str(),
+            strerror(errno));
+    std::string header{IODUMP_MAGIC, 8};
+    append_pod<uint32_t>(header, IODUMP_VERSION);
+    append_pod<uint32_t>(header, 0);
+    write_at(m_fout, 0, header);
+    m_data_end = header.size();
+    m_workers.start(nr_threads);
+}
+
+AsyncBinaryOprIODump::~AsyncBinaryOprIODump() {
+    MGB_TRY { flush(); }
+    MGB_CATCH(std::exception & exc, {
+        mgb_log_error("failed to flush AsyncBinaryOprIODump: %s", exc.what());
+    });
+    m_workers.stop();
+    fclose(m_fout);
+}
+
+void AsyncBinaryOprIODump::dump_var(VarNode* var, bool lazy_sync) {
+    mgb_assert(
+            !lazy_sync,
+            "AsyncBinaryOprIODump does not support comp_node_seq_record_level; "
+            "use BinaryOprIODump instead");
+    auto make_title = [](VarNode* var, const char* prefix) {
+        return ssprintf(
+                "%svar=%s owner_opr_inputs=%s", prefix,
+                cg::dump_var_info({var}).c_str(),
+                cg::dump_var_info(var->owner_opr()->input()).c_str());
+    };
+    if (!var->dev_tensor_valid()) {
+        return;
+    }
+    dump_value(var->dev_tensor(), ssprintf("%06zx", var->id()), make_title(var, ""));
+    if (MGB_GETENV("MGB_DUMP_INPUT")) {
+        for (size_t i = 0; i < var->owner_opr()->input().size(); ++i) {
+            auto ivar = var->owner_opr()->input()[i];
+            if (ivar->dev_tensor_valid()) {
+                dump_value(
+                        ivar->dev_tensor(), ssprintf("%06zx-inp%zu", var->id(), i),
+                        make_title(ivar, ssprintf("inp%zu: ", i).c_str()));
+            }
+        }
+    }
+}
+
+void AsyncBinaryOprIODump::dump_value(
+        const DeviceTensorND& value, std::string name, std::string title) {
+    auto cn = value.comp_node();
+    size_t bytes = value.dtype().size(value.shape().total_nr_elems()), seq;
+    {
+        // the values copied before have all been issued, so the writers never
+        // wait for this dispatcher
+        std::unique_lock<std::mutex> lk{m_mtx};
+        m_cv_written.wait(lk, [&]() {
+            return !m_nr_pending || m_pending_bytes + bytes <= m_max_pending_bytes;
+        });
+        ++m_nr_pending;
+        m_pending_bytes += bytes;
+        seq = m_seq++;
+    }
+    auto buf = alloc_buf(cn);
+    // the buffers may have been used for other dtypes
+    buf->value.dtype(value.dtype());
+    if (value.layout().is_contiguous()) {
+        buf->value.copy_from(value);
+    } else {
+        buf->contig.dtype(value.dtype()).copy_from(value);
+        buf->value.copy_from(buf->contig);
+    }
+    buf->copied->record();
+    auto entry = std::make_shared<Entry>(
+            Entry{std::move(buf), std::move(name), std::move(title), seq, bytes});
+    m_workers.launch([this, entry]() { write_entry(*entry); });
+}
+
+void AsyncBinaryOprIODump::write_entry(Entry& entry) {
+    MGB_TRY {
+        entry.buf->copied->host_wait();
+        auto data = debug::dump_tensor(entry.buf->value, entry.title);
+        free_buf(std::move(entry.buf));
+        uint64_t raw_size = data.size();
+        uint32_t codec = IODUMP_RAW;
+#if MGB_HAVE_ZLIB
+        if (m_compress) {
+            uLongf size = compressBound(raw_size);
+            std::string compressed(size, '\0');
+            if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &size,
+                          reinterpret_cast<const Bytef*>(data.data()), raw_size,
+                          Z_BEST_SPEED) == Z_OK &&
+                size < raw_size) {
+                compressed.resize(size);
+                data = std::move(compressed);
+                codec = IODUMP_ZLIB;
+            }
+        }
+#endif
+        MGB_LOCK_GUARD(m_file_mtx);
+        write_at(m_fout, m_data_end, data);
+        m_index.push_back({m_data_end, data.size(), raw_size, entry.seq, codec,
+                           std::move(entry.name)});
+        m_data_end += data.size();
+    }
+    MGB_CATCH(std::exception & exc, {
+        MGB_LOCK_GUARD(m_mtx);
+        if (m_error.empty()) {
+            m_error = exc.what();
+        }
+    });
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        --m_nr_pending;
+        m_pending_bytes -= entry.bytes;
+    }
+    m_cv_written.notify_all();
+}
+
+std::unique_ptr<AsyncBinaryOprIODump::HostBuf> AsyncBinaryOprIODump::alloc_buf(
+        CompNode cn) {
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        auto&& bufs = m_free_bufs[cn];
+        if (!bufs.empty()) {
+            auto ret = std::move(bufs.back());
+            bufs.pop_back();
+            m_free_bytes -= ret->value.storage().size();
+            return ret;
+        }
+    }
+    // host buffers on a device comp node are pinned
+    auto ret = std::make_unique<HostBuf>();
+    ret->value = HostTensorND{cn};
+    ret->contig = DeviceTensorND{cn};
+    ret->copied = cn.create_event();
+    return ret;
+}
+
+void AsyncBinaryOprIODump::free_buf(std::unique_ptr<HostBuf> buf) {
+    auto size = buf->value.storage().size();
+    MGB_LOCK_GUARD(m_mtx);
+    if (m_free_bytes + size <= m_max_pending_bytes) {
+        m_free_bytes += size;
+        m_free_bufs[buf->value.comp_node()].push_back(std::move(buf));
+    }
+}
+
+void AsyncBinaryOprIODump::flush() {
+    std::vector<CompNode> cns;
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        for (auto&& i : m_free_bufs) {
+            cns.push_back(i.first);
+        }
+    }
+    // wait for the dispatchers to issue all the copies
+    for (auto cn : cns) {
+        cn.sync();
+    }
+    {
+        std::unique_lock<std::mutex> lk{m_mtx};
+        m_cv_written.wait(lk, [this]() { return !m_nr_pending; });
+        if (!m_error.empty()) {
+            auto msg = std::move(m_error);
+            m_error.clear();
+            lk.unlock();
+            mgb_throw(MegBrainError, "failed to write iodump: %s", msg.c_str());
+        }
+    }
+
+    MGB_LOCK_GUARD(m_file_mtx);
+    std::string index;
+    for (auto&& i : m_index) {
+        append_pod(index, i.offset);
+        append_pod(index, i.size);
+        append_pod(index, i.raw_size);
+        append_pod(index, i.seq);
+        append_pod(index, i.codec);
+        append_pod<uint32_t>(index, i.name.size());
+        index += i.name;
+    }
+    append_pod<uint64_t>(index, m_data_end);
+    append_pod<uint64_t>(index, m_index.size());
+    index.append(IODUMP_INDEX_MAGIC, 8);
+    write_at(m_fout, m_data_end, index);
+    fflush(m_fout);
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
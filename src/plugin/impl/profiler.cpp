@@ -13,13 +13,111 @@
 #include "megbrain/plugin/opr_footprint.h"
 
 #if MGB_ENABLE_JSON
+#include "megbrain/comp_node_env.h"
 #include "megbrain/graph/event.h"
 #include "megbrain/opr/io.h"
 #include "megbrain/system.h"
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define MGB_HAVE_PERF_EVENT 1
+#else
+#define MGB_HAVE_PERF_EVENT 0
+#endif
+
 using namespace mgb;
 using namespace cg;
 
+/* ======================= HwCounterReader ======================= */
+
+class GraphProfiler::HwCounterReader {
+#if MGB_HAVE_PERF_EVENT
+    RealTimer m_timer;
+    static constexpr size_t NR_EVENT = 5;
+    //! fds of the events, the first of which is the group leader
+    int m_fd[NR_EVENT] = {-1, -1, -1, -1, -1};
+    //! index of the event of each value read from the group
+    size_t m_value_event[NR_EVENT];
+    size_t m_nr_value = 0;
+
+    static int open_event(uint32_t type, uint64_t config, int group_fd) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = group_fd == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // count the calling thread on any cpu
+        return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+
+public:
+    HwCounterReader() {
+        static const uint64_t configs[NR_EVENT] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES};
+        for (size_t i = 0; i < NR_EVENT; ++i) {
+            m_fd[i] = open_event(PERF_TYPE_HARDWARE, configs[i], i ? m_fd[0] : -1);
+            if (m_fd[i] >= 0) {
+                m_value_event[m_nr_value++] = i;
+            } else if (!i) {
+                // no counter is available without the cycles as the leader
+                return;
+            }
+        }
+        ioctl(m_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~HwCounterReader() {
+        for (int fd : m_fd) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    bool valid() const { return m_nr_value; }
+
+    OprHwCounter read() {
+        OprHwCounter ret;
+        ret.time = m_timer.get_secs();
+        uint64_t buf[NR_EVENT + 1];
+        auto size = sizeof(uint64_t) * (m_nr_value + 1);
+        if (::read(m_fd[0], buf, size) != static_cast<ssize_t>(size)) {
+            return ret;
+        }
+        uint64_t OprHwCounter::*fields[NR_EVENT] = {
+                &OprHwCounter::cycles, &OprHwCounter::instructions,
+                &OprHwCounter::cache_references, &OprHwCounter::cache_misses,
+                &OprHwCounter::branch_misses};
+        for (size_t i = 0; i < m_nr_value; ++i) {
+            ret.*fields[m_value_event[i]] = buf[i + 1];
+        }
+        return ret;
+    }
+#else
+public:
+    bool valid() const { return false; }
+
+    OprHwCounter read() { return {}; }
+#endif
+};
+
+/* ======================= GraphProfiler ======================= */
+
 MGB_TYPEINFO_OBJ_IMPL(opr_profile::OprProfileHolder);
 
 GraphProfiler::GraphProfiler(cg::ComputingGraph* graph) : PluginBase(graph) {
@@ -55,9 +153,17 @@ GraphProfiler::GraphProfiler(cg::ComputingGraph* graph) : PluginBase(graph) {
             return;
 
         for (auto&& comp_node : get_opr_comp_node_set(event.opr)) {
-            auto runner = [this, opr]() {
+            auto runner = [this, opr, comp_node]() {
+#if !MGB_BUILD_SLIM_SERVING
+                auto used_mem = comp_node.get_used_memory();
+#endif
                 MGB_LOCK_GUARD(m_mtx);
                 m_host_time[{opr, std::this_thread::get_id()}].end = m_timer.get_secs();
+#if !MGB_BUILD_SLIM_SERVING
+                m_used_mem[{opr, comp_node}] = used_mem;
+#else
+                MGB_MARK_USED_VAR(comp_node);
+#endif
             };
             event.env->dispatch_on_comp_node(comp_node, runner);
         }
@@ -79,11 +185,32 @@ GraphProfiler::GraphProfiler(cg::ComputingGraph* graph) : PluginBase(graph) {
         }
 
         record_event(*evptr, event.comp_node);
+        if (m_hw_counter_enabled &&
+            event.comp_node.device_type() == CompNode::DeviceType::CPU) {
+            auto opr = event.opr;
+            auto comp_node = event.comp_node;
+            CompNodeEnv::from_comp_node(comp_node).cpu_env().dispatch(
+                    [this, opr, comp_node]() {
+                        read_hw_counter(opr, comp_node, false);
+                    });
+        }
     };
     auto on_after_kern = [this](AfterKernel const& event) {
         if (!opr_filter(event.opr))
             return;
 
+        if (m_hw_counter_enabled &&
+            event.comp_node.device_type() == CompNode::DeviceType::CPU) {
+            // read before recording the end event, so waiting on the event
+            // also waits for the reading
+            auto opr = event.opr;
+            auto comp_node = event.comp_node;
+            CompNodeEnv::from_comp_node(comp_node).cpu_env().dispatch(
+                    [this, opr, comp_node]() {
+                        read_hw_counter(opr, comp_node, true);
+                    });
+        }
+
         CompNodeEventPtr* evptr;
         {
             MGB_LOCK_GUARD(m_mtx);
@@ -96,6 +223,9 @@ GraphProfiler::GraphProfiler(cg::ComputingGraph* graph) : PluginBase(graph) {
         m_host_time.clear();
         m_kern_event.clear();
         m_opr_fp_rst.clear();
+        m_hw_counter.clear();
+        m_hw_counter_start.clear();
+        m_used_mem.clear();
         m_start_of_time = None;
     };
     auto&& ev = graph->event();
@@ -141,6 +271,53 @@ void GraphProfiler::record_event(CompNodeEventPtr& dest, CompNode comp_node) {
     dest->record();
 }
 
+bool GraphProfiler::enable_hw_counter() {
+    if (!HwCounterReader{}.valid()) {
+        mgb_log_warn(
+                "hardware performance counters are not available: %s",
+                MGB_HAVE_PERF_EVENT ? "perf_event_open failed" : "not supported");
+        return false;
+    }
+    m_hw_counter_enabled = true;
+    return true;
+}
+
+void GraphProfiler::read_hw_counter(
+        cg::OperatorNodeBase* opr, CompNode comp_node, bool end) {
+    HwCounterReader* reader;
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        auto&& ptr = m_hw_counter_reader[std::this_thread::get_id()];
+        if (!ptr) {
+            ptr = std::make_unique<HwCounterReader>();
+        }
+        reader = ptr.get();
+    }
+    if (!reader->valid()) {
+        return;
+    }
+    // the counters of a thread are only read on that thread
+    auto value = reader->read();
+    MGB_LOCK_GUARD(m_mtx);
+    if (!end) {
+        m_hw_counter_start[{opr, comp_node}] = value;
+        return;
+    }
+    auto iter = m_hw_counter_start.find({opr, comp_node});
+    if (iter == m_hw_counter_start.end()) {
+        return;
+    }
+    auto&& start = iter->second;
+    // keep the last execution like the device time
+    auto&& dest = m_hw_counter[{opr, comp_node}];
+    dest.cycles = value.cycles - start.cycles;
+    dest.instructions = value.instructions - start.instructions;
+    dest.cache_references = value.cache_references - start.cache_references;
+    dest.cache_misses = value.cache_misses - start.cache_misses;
+    dest.branch_misses = value.branch_misses - start.branch_misses;
+    dest.time = value.time - start.time;
+}
+
 bool GraphProfiler::opr_filter(cg::OperatorNodeBase* opr) {
     static bool only_wait = MGB_GETENV("MGB_PROFILE_ONLY_WAIT");
     if (!only_wait)
@@ -191,6 +368,28 @@ std::shared_ptr<json::Object> GraphProfiler::to_json() const {
         opr_fp_item[tpair.first->id_str()] = tpair.second.to_json();
     }
 
+    auto hw_counter = Object::make();
+    for (auto&& i : m_hw_counter) {
+        auto&& opr_prof = visit_json_obj(*hw_counter, i.first.first->id_str());
+        auto&& cnt = i.second;
+        auto ratio = [](uint64_t a, uint64_t b) {
+            return b ? static_cast<double>(a) / b : 0.;
+        };
+        opr_prof[i.first.second.to_string()] = Object::make(
+                {{"cycles", NumberInt::make(cnt.cycles)},
+                 {"instructions", NumberInt::make(cnt.instructions)},
+                 {"ipc", Number::make(ratio(cnt.instructions, cnt.cycles))},
+                 {"cache_references", NumberInt::make(cnt.cache_references)},
+                 {"cache_misses", NumberInt::make(cnt.cache_misses)},
+                 {"cache_miss_rate",
+                  Number::make(ratio(cnt.cache_misses, cnt.cache_references))},
+                 {"branch_misses", NumberInt::make(cnt.branch_misses)},
+                 {"time", Number::make(cnt.time)},
+                 // each last level cache miss loads a 64-byte line from dram
+                 {"dram_bandwidth",
+                  Number::make(cnt.time > 0 ? cnt.cache_misses * 64 / cnt.time : 0.)}});
+    }
+
     auto pf_holder_pair =
             m_owner_graph->options()
                     .user_data.get_user_data<opr_profile::OprProfileHolder>();
@@ -206,9 +405,290 @@ std::shared_ptr<json::Object> GraphProfiler::to_json() const {
             {{"device", dev_prof},
              {"host", host_prof},
              {"opr_footprint", opr_fp},
+             {"hw_counter", hw_counter},
              {"opr_internal_pf", opr_internal_pf}});
 }
 
+std::shared_ptr<json::Object> GraphProfiler::to_chrome_trace() const {
+    using namespace json;
+    constexpr int DEVICE_PID = 1, HOST_PID = 2;
+    auto events = Array::make();
+
+    //! (pid, track name) => tid
+    std::map<std::pair<int, std::string>, int> track2tid;
+    auto get_tid = [&](int pid, const std::string& name) {
+        int tid = static_cast<int>(track2tid.size()) + 1;
+        return track2tid.emplace(std::make_pair(pid, name), tid).first->second;
+    };
+    //! timestamps of the trace are in microseconds
+    auto us = [](double secs) { return Number::make(secs * 1e6); };
+    auto is_copy = [](OperatorNodeBase* opr) {
+        auto type = opr->dyn_typeinfo();
+        return type == opr::Copy::typeinfo() || type == opr::Host2DeviceCopy::typeinfo();
+    };
+    auto make_slice = [&](OperatorNodeBase* opr, int pid, int tid, double begin,
+                          double end) {
+        return Object::make(
+                {{"name", String::make(opr->name())},
+                 {"cat", String::make(is_copy(opr) ? "copy" : "opr")},
+                 {"ph", String::make("X")},
+                 {"pid", NumberInt::make(pid)},
+                 {"tid", NumberInt::make(tid)},
+                 {"ts", us(begin)},
+                 {"dur", us(end - begin)},
+                 {"args", Object::make(
+                                  {{"id", NumberInt::make(opr->id())},
+                                   {"type", String::make(opr->dyn_typeinfo()->name)}})}});
+    };
+
+    struct DeviceSlice {
+        int tid;
+        double kern, end;
+    };
+    std::unordered_map<std::pair<OperatorNodeBase*, CompNode>, DeviceSlice, pairhash>
+            slices;
+    for (auto&& kern_ev : m_kern_event) {
+        auto&& event = kern_ev.second;
+        if (!event.start || !event.kern || !event.end) {
+            continue;
+        }
+        auto opr = kern_ev.first.first;
+        auto comp_node = kern_ev.first.second;
+        auto&& start = m_start_of_time->at(comp_node);
+        event.end->host_wait();
+        auto track = comp_node.to_string();
+        if (is_copy(opr)) {
+            track += " copy";
+        }
+        DeviceSlice slice{
+                get_tid(DEVICE_PID, track), start->elapsed_time_until(*event.kern),
+                start->elapsed_time_until(*event.end)};
+        slices[kern_ev.first] = slice;
+        auto json = make_slice(opr, DEVICE_PID, slice.tid, slice.kern, slice.end);
+        // the time from opr start to kern start is spent on waiting for inputs
+        auto&& args = (*json)["args"]->cast_final_safe<Object>();
+        args["wait"] = us(slice.kern - start->elapsed_time_until(*event.start));
+        events->add(json);
+    }
+
+    int flow_id = 0;
+    for (auto&& i : slices) {
+        auto&& dest = i.second;
+        for (auto inp : i.first.first->input()) {
+            if (inp->comp_node() == i.first.second) {
+                continue;
+            }
+            auto src_iter = slices.find({inp->owner_opr(), inp->comp_node()});
+            if (src_iter == slices.end()) {
+                continue;
+            }
+            auto&& src = src_iter->second;
+            ++flow_id;
+            // the start binds to the producer slice enclosing it, and the
+            // finish binds to the reader slice beginning at it
+            events->add(Object::make(
+                    {{"name", String::make(inp->name())},
+                     {"cat", String::make("flow")},
+                     {"ph", String::make("s")},
+                     {"id", NumberInt::make(flow_id)},
+                     {"pid", NumberInt::make(DEVICE_PID)},
+                     {"tid", NumberInt::make(src.tid)},
+                     {"ts", us((src.kern + src.end) / 2)}}));
+            events->add(Object::make(
+                    {{"name", String::make(inp->name())},
+                     {"cat", String::make("flow")},
+                     {"ph", String::make("f")},
+                     {"bp", String::make("e")},
+                     {"id", NumberInt::make(flow_id)},
+                     {"pid", NumberInt::make(DEVICE_PID)},
+                     {"tid", NumberInt::make(dest.tid)},
+                     {"ts", us(dest.kern)}}));
+        }
+    }
+
+    for (auto&& i : m_used_mem) {
+        auto slice = slices.find(i.first);
+        if (slice == slices.end()) {
+            continue;
+        }
+        events->add(Object::make(
+                {{"name", String::make("memory " + i.first.second.to_string())},
+                 {"ph", String::make("C")},
+                 {"pid", NumberInt::make(DEVICE_PID)},
+                 {"ts", us(slice->second.end)},
+                 {"args", Object::make({{"bytes", NumberInt::make(i.second)}})}}));
+    }
+
+    for (auto&& tpair : m_host_time) {
+        auto&& ev = tpair.second;
+        if (ev.start < 0 || ev.end < 0) {
+            continue;
+        }
+        auto tid = get_tid(HOST_PID, sys::get_thread_name(tpair.first.second));
+        events->add(make_slice(tpair.first.first, HOST_PID, tid, ev.start, ev.end));
+    }
+
+    auto add_meta = [&](const char* name, int pid, int tid, const std::string& value) {
+        auto json = Object::make(
+                {{"name", String::make(name)},
+                 {"ph", String::make("M")},
+                 {"pid", NumberInt::make(pid)},
+                 {"args", Object::make({{"name", String::make(value)}})}});
+        if (tid) {
+            (*json)["tid"] = NumberInt::make(tid);
+        }
+        events->add(json);
+    };
+    add_meta("process_name", DEVICE_PID, 0, "device");
+    add_meta("process_name", HOST_PID, 0, "host");
+    for (auto&& i : track2tid) {
+        add_meta("thread_name", i.first.first, i.second, i.first.second);
+    }
+
+    return Object::make(
+            {{"traceEvents", events}, {"displayTimeUnit", String::make("ms")}});
+}
+
+GraphProfiler::DeviceSpecTable GraphProfiler::parse_device_spec(
+        const std::string& content) {
+    DeviceSpecTable ret;
+    std::istringstream lines{content};
+    std::string line;
+    while (std::getline(lines, line)) {
+        auto comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+        std::istringstream fields{line};
+        std::string name;
+        if (!(fields >> name)) {
+            continue;
+        }
+        DeviceSpec spec;
+        mgb_assert(
+                fields >> spec.gflops >> spec.gbps && spec.gflops >= 0 &&
+                        spec.gbps >= 0,
+                "bad device spec line: %s", line.c_str());
+        ret.emplace_back(name, spec);
+    }
+    return ret;
+}
+
+std::shared_ptr<json::Object> GraphProfiler::to_roofline_json(
+        const DeviceSpecTable& specs) const {
+    using namespace json;
+    auto find_spec = [&](CompNode cn) -> const DeviceSpec* {
+        auto name = cn.to_string_physical();
+        const std::pair<std::string, DeviceSpec>* ret = nullptr;
+        for (auto&& i : specs) {
+            if (!name.compare(0, i.first.size(), i.first) &&
+                (!ret || i.first.size() > ret->first.size())) {
+                ret = &i;
+            }
+        }
+        return ret ? &ret->second : nullptr;
+    };
+
+    struct Entry {
+        cg::OperatorNodeBase* opr;
+        CompNode cn;
+        double time = 0;  //!< device time in seconds
+        double efficiency = -1;
+        std::shared_ptr<Object> json;
+    };
+    //! an opr on several comp nodes takes the longest one
+    ThinHashMap<cg::OperatorNodeBase*, Entry> opr2entry;
+    for (auto&& kern_ev : m_kern_event) {
+        auto&& event = kern_ev.second;
+        if (!event.kern || !event.end) {
+            continue;
+        }
+        event.end->host_wait();
+        auto time = event.kern->elapsed_time_until(*event.end);
+        auto&& entry = opr2entry[kern_ev.first.first];
+        if (!entry.opr || time > entry.time) {
+            entry.opr = kern_ev.first.first;
+            entry.cn = kern_ev.first.second;
+            entry.time = time;
+        }
+    }
+
+    std::vector<Entry> entries;
+    double total_time = 0;
+    for (auto&& i : opr2entry) {
+        auto entry = i.second;
+        auto fp_iter = m_opr_fp_rst.find(entry.opr);
+        if (fp_iter == m_opr_fp_rst.end()) {
+            continue;
+        }
+        auto&& fp = fp_iter->second;
+        total_time += entry.time;
+        double time = std::max(entry.time, 1e-9);
+        double gflops = fp.computation / time * 1e-9,
+               gbps = fp.memory / time * 1e-9;
+        entry.json = Object::make(
+                {{"name", String::make(entry.opr->name())},
+                 {"type", String::make(entry.opr->dyn_typeinfo()->name)},
+                 {"comp_node", String::make(entry.cn.to_string())},
+                 {"time_ms", Number::make(entry.time * 1e3)},
+                 {"computation", NumberInt::make(fp.computation)},
+                 {"memory", NumberInt::make(fp.memory)},
+                 {"gflops", Number::make(gflops)},
+                 {"gbps", Number::make(gbps)}});
+        if (fp.memory) {
+            (*entry.json)["intensity"] =
+                    Number::make(static_cast<double>(fp.computation) / fp.memory);
+        }
+        if (auto spec = find_spec(entry.cn)) {
+            double attainable = 0, achieved = 0;
+            if (fp.computation && spec->gflops) {
+                attainable = spec->gflops;
+                if (fp.memory && spec->gbps) {
+                    attainable = std::min(
+                            attainable, static_cast<double>(fp.computation) /
+                                                fp.memory * spec->gbps);
+                }
+                achieved = gflops;
+                (*entry.json)["peak_gflops_percent"] =
+                        Number::make(gflops / spec->gflops * 100);
+            } else if (fp.memory && spec->gbps) {
+                attainable = spec->gbps;
+                achieved = gbps;
+            }
+            if (spec->gbps) {
+                (*entry.json)["peak_gbps_percent"] =
+                        Number::make(gbps / spec->gbps * 100);
+            }
+            if (attainable > 0) {
+                entry.efficiency = achieved / attainable;
+                (*entry.json)["roofline_percent"] =
+                        Number::make(entry.efficiency * 100);
+                //! the time that would be saved by reaching the roofline
+                (*entry.json)["lost_ms"] = Number::make(
+                        entry.time * std::max(1 - entry.efficiency, 0.) * 1e3);
+            }
+        }
+        entries.emplace_back(std::move(entry));
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        bool known_a = a.efficiency >= 0, known_b = b.efficiency >= 0;
+        if (known_a != known_b) {
+            return known_a;
+        }
+        if (known_a && a.efficiency != b.efficiency) {
+            return a.efficiency < b.efficiency;
+        }
+        return a.time > b.time;
+    });
+
+    auto oprs = Array::make();
+    for (auto&& i : entries) {
+        oprs->add(i.json);
+    }
+    return Object::make(
+            {{"total_time_ms", Number::make(total_time * 1e3)}, {"oprs", oprs}});
+}
+
 #endif  // MGB_ENABLE_JSON
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,189 @@
+/**
+ * \file src/plugin/impl/sampling_profiler.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/sampling_profiler.h"
+#include "megbrain/graph/cg.h"
+
+using namespace mgb;
+
+constexpr size_t SamplingProfiler::NR_BUCKETS;
+
+SamplingProfiler::SamplingProfiler(cg::ComputingGraph* graph)
+        : SamplingProfiler(graph, Options{}) {}
+
+SamplingProfiler::SamplingProfiler(cg::ComputingGraph* graph, const Options& options)
+        : PluginBase(graph), m_options{options} {
+    mgb_assert(
+            m_options.sample_interval && m_options.nr_opr_slices,
+            "sample_interval and nr_opr_slices should be positive");
+    add_member_func_as_event_handler(&SamplingProfiler::on_comp_seq_determined);
+    add_member_func_as_event_handler(&SamplingProfiler::on_exec_start);
+    add_member_func_as_event_handler(&SamplingProfiler::on_opr_start);
+    add_member_func_as_event_handler(&SamplingProfiler::on_before_kern);
+    add_member_func_as_event_handler(&SamplingProfiler::on_after_kern);
+}
+
+void SamplingProfiler::on_comp_seq_determined(
+        const cg::event::CompSeqOrderDetermined& event) {
+    m_opr2slot.clear();
+    size_t index = 0;
+    auto on_opr = [&](cg::OperatorNodeBase* opr) {
+        auto&& slot = m_opr2slot[opr];
+        if (!slot) {
+            slot = std::make_unique<Slot>();
+            slot->index = index++;
+        }
+        return true;
+    };
+    event.exec->iter_opr_seq(on_opr);
+}
+
+void SamplingProfiler::on_exec_start(const cg::event::CompSeqExecBeforeStart&) {
+    m_cur_sampled = m_nr_exec++ % m_options.sample_interval == 0;
+    if (m_cur_sampled) {
+        m_cur_slice = m_nr_sampled++ % m_options.nr_opr_slices;
+    }
+}
+
+void SamplingProfiler::on_opr_start(const cg::event::OprExecStart& event) {
+    if (!m_cur_sampled) {
+        return;
+    }
+    auto iter = m_opr2slot.find(event.opr);
+    if (iter == m_opr2slot.end() ||
+        iter->second->index % m_options.nr_opr_slices != m_cur_slice) {
+        return;
+    }
+    auto&& slot = *iter->second;
+    slot.armed.store(get_bucket(slot, event.opr), std::memory_order_release);
+}
+
+void SamplingProfiler::on_before_kern(const cg::event::BeforeKernel& event) {
+    auto iter = m_opr2slot.find(event.opr);
+    if (iter != m_opr2slot.end() &&
+        iter->second->armed.load(std::memory_order_acquire)) {
+        iter->second->start = std::chrono::steady_clock::now();
+    }
+}
+
+void SamplingProfiler::on_after_kern(const cg::event::AfterKernel& event) {
+    auto iter = m_opr2slot.find(event.opr);
+    if (iter == m_opr2slot.end()) {
+        return;
+    }
+    auto&& slot = *iter->second;
+    //! an opr on several comp nodes is recorded by its first kernel
+    auto bucket = slot.armed.exchange(nullptr, std::memory_order_acq_rel);
+    if (!bucket) {
+        return;
+    }
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - slot.start)
+                          .count();
+    bucket->count.fetch_add(1, std::memory_order_relaxed);
+    bucket->total_ns.fetch_add(ns, std::memory_order_relaxed);
+    auto max_ns = bucket->max_ns.load(std::memory_order_relaxed);
+    while (ns > max_ns && !bucket->max_ns.compare_exchange_weak(
+                                  max_ns, ns, std::memory_order_relaxed)) {
+    }
+    size_t idx = 0;
+    for (uint64_t us = ns / 1000; us > 1 && idx + 1 < NR_BUCKETS; us >>= 1) {
+        ++idx;
+    }
+    bucket->histogram[idx].fetch_add(1, std::memory_order_relaxed);
+}
+
+SamplingProfiler::Bucket* SamplingProfiler::get_bucket(
+        Slot& slot, cg::OperatorNodeBase* opr) {
+    size_t hash = 0;
+    for (auto inp : opr->input()) {
+        auto&& shape = inp->shape();
+        hash = hash_pair_combine(hash, shape.ndim);
+        for (size_t i = 0; i < shape.ndim; ++i) {
+            hash = hash_pair_combine(hash, shape[i]);
+        }
+    }
+    if (slot.bucket && slot.shape_hash == hash) {
+        return slot.bucket;
+    }
+
+    //! the shapes of the opr changed, which is rare
+    std::string shape;
+    for (auto inp : opr->input()) {
+        if (!shape.empty()) {
+            shape.append(",");
+        }
+        shape.append(inp->shape().to_string());
+    }
+    std::string type = opr->dyn_typeinfo()->name;
+    auto key = type + ":" + shape;
+    MGB_LOCK_GUARD(m_bucket_mtx);
+    auto&& bucket = m_key2bucket[key];
+    if (!bucket) {
+        m_buckets.emplace_back();
+        bucket = &m_buckets.back();
+        bucket->opr_type = std::move(type);
+        bucket->shape = std::move(shape);
+    }
+    slot.shape_hash = hash;
+    slot.bucket = bucket;
+    return bucket;
+}
+
+std::vector<SamplingProfiler::Stat> SamplingProfiler::stats(bool reset) {
+    auto read = [reset](std::atomic<uint64_t>& v) -> uint64_t {
+        return reset ? v.exchange(0, std::memory_order_relaxed)
+                     : v.load(std::memory_order_relaxed);
+    };
+    std::vector<Stat> ret;
+    MGB_LOCK_GUARD(m_bucket_mtx);
+    for (auto&& bucket : m_buckets) {
+        Stat stat;
+        stat.count = read(bucket.count);
+        if (!stat.count) {
+            continue;
+        }
+        stat.opr_type = bucket.opr_type;
+        stat.shape = bucket.shape;
+        stat.total_ms = read(bucket.total_ns) * 1e-6;
+        stat.max_ms = read(bucket.max_ns) * 1e-6;
+        for (size_t i = 0; i < NR_BUCKETS; ++i) {
+            stat.histogram[i] = read(bucket.histogram[i]);
+        }
+        ret.emplace_back(std::move(stat));
+    }
+    return ret;
+}
+
+#if MGB_ENABLE_JSON
+std::shared_ptr<json::Object> SamplingProfiler::to_json(bool reset) {
+    auto oprs = json::Array::make();
+    for (auto&& stat : stats(reset)) {
+        auto histogram = json::Array::make();
+        for (auto i : stat.histogram) {
+            histogram->add(json::NumberInt::make(i));
+        }
+        oprs->add(json::Object::make(
+                {{"type", json::String::make(stat.opr_type)},
+                 {"shape", json::String::make(stat.shape)},
+                 {"count", json::NumberInt::make(stat.count)},
+                 {"total_ms", json::Number::make(stat.total_ms)},
+                 {"max_ms", json::Number::make(stat.max_ms)},
+                 {"histogram_us_log2", histogram}}));
+    }
+    return json::Object::make(
+            {{"nr_executions", json::NumberInt::make(nr_executions())},
+             {"nr_sampled", json::NumberInt::make(nr_sampled())},
+             {"oprs", oprs}});
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,70 @@
+/**
+ * \file src/plugin/impl/startup_profiler.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/startup_profiler.h"
+
+#include <algorithm>
+
+using namespace mgb;
+
+StartupProfiler::StartupProfiler(cg::ComputingGraph* graph) : PluginBase(graph) {
+    add_member_func_as_event_handler(&StartupProfiler::on_phase_finished);
+}
+
+void StartupProfiler::on_phase_finished(const cg::event::StartupPhaseFinished& event) {
+    //! fast-run profiling may be finished in the background threads
+    MGB_LOCK_GUARD(m_mtx);
+    auto iter = std::find_if(
+            m_phases.begin(), m_phases.end(),
+            [&](const std::pair<std::string, Phase>& i) {
+                return i.first == event.phase;
+            });
+    if (iter == m_phases.end()) {
+        m_phases.emplace_back(event.phase, Phase{});
+        iter = m_phases.end() - 1;
+    }
+    auto&& phase = iter->second;
+    phase.total_ms += event.time_ms;
+    ++phase.count;
+    if (event.name && event.name[0]) {
+        phase.items.push_back({event.name, event.time_ms});
+    }
+}
+
+std::vector<std::pair<std::string, StartupProfiler::Phase>> StartupProfiler::phases()
+        const {
+    MGB_LOCK_GUARD(m_mtx);
+    return m_phases;
+}
+
+#if MGB_ENABLE_JSON
+std::shared_ptr<json::Object> StartupProfiler::to_json() const {
+    auto ret = json::Object::make();
+    double total_ms = 0;
+    for (auto&& i : phases()) {
+        auto items = json::Array::make();
+        for (auto&& item : i.second.items) {
+            items->add(json::Object::make(
+                    {{"name", json::String::make(item.name)},
+                     {"time_ms", json::Number::make(item.time_ms)}}));
+        }
+        (*ret)[i.first] = json::Object::make(
+                {{"total_ms", json::Number::make(i.second.total_ms)},
+                 {"count", json::NumberInt::make(i.second.count)},
+                 {"items", items}});
+        total_ms += i.second.total_ms;
+    }
+    (*ret)["total_ms"] = json::Number::make(total_ms);
+    return ret;
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,89 @@
+/**
+ * \file src/plugin/include/megbrain/plugin/calibrator.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#pragma once
+
+#include "megbrain/graph.h"
+#include "megbrain/graph/event.h"
+#include "megbrain/plugin/base.h"
+
+#include <unordered_map>
+
+namespace mgb {
+
+/*!
+ * \brief collect the value distributions of the float vars of a computing
+ *      graph to compute their int8 quantization scales
+ *
+ * A histogram of the absolute values is kept for the outputs of each opr
+ * other than the constant ones, keyed by the var name, and is updated every
+ * time the var is computed. The bin width is a power of two, which is doubled
+ * when a larger value is met, so the histograms of a var collected by
+ * different graphs can be merged exactly. A large calibration set can thus be
+ * split among copies of a dumped graph loaded on different threads or
+ * devices, each with its own Calibrator, whose results are merged by merge().
+ *
+ * The scales can be written back into the graph by
+ * gopt::quantize_by_calibration().
+ */
+class Calibrator final : public PluginBase {
+public:
+    enum class Method {
+        MAX,         ///< the max absolute value
+        PERCENTILE,  ///< the given percentile of the absolute values
+        ENTROPY,     ///< the threshold of the min KL divergence, as TensorRT
+    };
+
+    struct Histogram {
+        //! log2 of the bin width
+        int width_exp = 0;
+        float amax = 0;
+        uint64_t total = 0;
+        //! bins[i] counts the absolute values in [i, i + 1) * bin_width
+        std::vector<uint64_t> bins;
+
+        float bin_width() const;
+        //! double the bin width until value is covered by the bins
+        void cover(float value);
+        void merge(const Histogram& rhs);
+    };
+
+    using ScaleMap = std::unordered_map<std::string, float>;
+
+    //! \param nr_bins number of bins of a histogram, which should be even
+    Calibrator(cg::ComputingGraph* graph, size_t nr_bins = 2048);
+
+    //! add the histograms collected by another Calibrator
+    void merge(const Calibrator& rhs);
+
+    /*!
+     * \brief scales of the calibrated vars to quantize to [-qmax, qmax]
+     * \param percentile only used by Method::PERCENTILE
+     */
+    ScaleMap scales(
+            Method method, float percentile = 0.9999f, int qmax = 127) const;
+
+    //! histogram of a var, or nullptr if it is not calibrated
+    const Histogram* histogram(const std::string& name) const;
+
+private:
+    const size_t m_nr_bins;
+    mutable MGB_MUTEX m_mtx;
+    std::unordered_map<std::string, Histogram> m_histograms;
+
+    void on_kern_end(const cg::event::OprExecKernelEnd& event);
+    void on_var_computed(VarNode* var);
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,104 @@
+/**
+ * \file src/plugin/include/megbrain/plugin/memory_timeline.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/graph.h"
+#include "megbrain/graph/event.h"
+#include "megbrain/plugin/base.h"
+#include "megbrain/utils/json.h"
+
+namespace mgb {
+
+/*!
+ * \brief record the memory chunks used by the vars of the last execution of a
+ *      graph, both static and dynamic, over the steps of the execution
+ *
+ * A step is the execution of an opr, in the order that the oprs are executed.
+ * A chunk lives from the step of its first writer to the step of its last
+ * reader; persistent chunks such as the weights live over the whole
+ * execution. The vars that share a chunk by memory forwarding are attributed
+ * to the chunk, whose memory is created by its owner var.
+ */
+class MemoryTimeline final : public PluginBase {
+public:
+    struct Chunk {
+        std::string owner_var, owner_opr;
+        CompNode comp_node;
+        //! "static" for the static memory planner, "dynamic" for the memory
+        //! allocated at runtime, and "external" for the memory managed by the
+        //! owner opr itself
+        const char* kind;
+        //! offset in the static memory buffer, only for static chunks
+        size_t static_offset = 0;
+        size_t size = 0;
+        //! start address of the chunk, 0 for unknown
+        size_t addr = 0;
+        size_t begin = 0, end = 0;  //!< steps of the first writer and last reader
+        //! all vars that use this chunk
+        std::vector<std::string> vars;
+    };
+
+    struct Peak {
+        size_t bytes = 0, step = 0;
+        //! index of the chunks live at the peak, the largest first
+        std::vector<size_t> live;
+    };
+
+    MemoryTimeline(cg::ComputingGraph* graph);
+
+    //! names of the oprs executed at each step
+    std::vector<std::string> steps() const;
+
+    std::vector<Chunk> chunks() const;
+
+    //! bytes used on the memory node of given comp node at each step
+    std::vector<size_t> usage(const std::vector<Chunk>& chunks, CompNode cn) const;
+
+    Peak peak(const std::vector<Chunk>& chunks, CompNode cn) const;
+
+#if MGB_ENABLE_JSON
+    /*!
+     * \brief the usage over the steps and the chunks live at the peak on each
+     *      memory node, and all the chunks
+     */
+    std::shared_ptr<json::Object> to_json() const;
+#endif
+
+    /*!
+     * \brief draw the chunks in address over steps as svg, in the same format
+     *      as the memory flow of the imperative profiler
+     */
+    std::string to_svg() const;
+
+private:
+    struct VarMem {
+        VarNode* owner;
+        const char* kind;
+        size_t static_offset, size, addr;
+        bool persistent;
+    };
+
+    void on_seq_start(const cg::event::CompSeqExecBeforeStart& event);
+    void on_opr_start(const cg::event::OprExecStart& event);
+    void on_opr_finish(const cg::event::OprExecFinished& event);
+
+    mutable MGB_MUTEX m_mtx;
+    std::vector<std::string> m_steps;
+    //! var => (step of its writer, step of its last reader)
+    ThinHashMap<VarNode*, std::pair<size_t, size_t>> m_var_step;
+    //! var => its memory, read on its comp node after the writer finishes
+    ThinHashMap<VarNode*, VarMem> m_var_mem;
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,127 @@
+/**
+ * \file src/plugin/include/megbrain/plugin/non_finite_checker.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/graph.h"
+#include "megbrain/graph/event.h"
+#include "megbrain/opr/internal/megdnn_opr_wrapper.h"
+#include "megbrain/plugin/base.h"
+#include "megbrain/utils/thin/hash_table.h"
+
+#include "megdnn/oprs/general.h"
+
+#include <atomic>
+
+namespace mgb {
+
+/*!
+ * \brief a cheap check for inf and nan in the float32 outputs of the oprs,
+ *      which is meant to be kept in production
+ *
+ * Unlike NumRangeChecker, no sync is needed: every \p interval executions, a
+ * CheckNonFinite kernel is issued on the comp node of each checked var right
+ * after the opr producing it, and writes a flag to a device buffer. When the
+ * execution is waited, the buffers are copied to host asynchronously, and
+ * the flags are examined in poll() or at the start of a later execution; the
+ * first opr in execution order with a non-finite output is reported. The
+ * checks stop after the first fault.
+ *
+ * Non-contiguous vars are not checked, to avoid copying them.
+ */
+class NonFiniteChecker final : public PluginBase {
+public:
+    struct Fault {
+        size_t run_id;  //!< AsyncExecutable::get_run_id() of the execution
+        size_t opr_id;
+        std::string opr_name, opr_type, var_name;
+    };
+
+    //! return whether a var should be checked
+    using VarFilter = thin_function<bool(VarNode*)>;
+    using FaultCallback = thin_function<void(const Fault&)>;
+
+    /*!
+     * \param interval check one in every \p interval executions
+     * \param filter check only the float32 vars accepted by it if given
+     */
+    NonFiniteChecker(
+            cg::ComputingGraph* graph, size_t interval = 1, VarFilter filter = {});
+
+    ~NonFiniteChecker() noexcept;
+
+    //! the callback on the first fault, which logs the fault by default
+    NonFiniteChecker& on_fault(FaultCallback cb) {
+        m_on_fault = std::move(cb);
+        return *this;
+    }
+
+    /*!
+     * \brief examine the result of the last checked execution if it has been
+     *      copied to host
+     * \param wait whether to wait for the copy
+     */
+    const Maybe<Fault>& poll(bool wait = false);
+
+    const Maybe<Fault>& fault() const { return m_fault; }
+
+private:
+    struct Slot {
+        VarNode* var;
+        size_t idx;  //!< index in the device buffer of its comp node
+    };
+
+    struct CompNodeState {
+        opr::intl::UniqPtrWithCN<megdnn::CheckNonFinite> opr;
+        DeviceTensorND result, workspace;
+        HostTensorND host_result;
+        std::unique_ptr<CompNode::Event> copied;
+    };
+
+    struct Pending {
+        size_t run_id;
+        std::vector<bool> checked;
+    };
+
+    const size_t m_interval;
+    const VarFilter m_filter;
+    FaultCallback m_on_fault;
+
+    size_t m_nr_exec = 0;
+    bool m_active = false;
+    //! run id of the execution being started and that being checked
+    size_t m_run_id = 0, m_checked_run_id = 0;
+
+    //! the exec that the slots are built for
+    cg::AsyncExecutable* m_exec = nullptr;
+    //! checked vars in execution order
+    std::vector<Slot> m_slots;
+    ThinHashMap<VarNode*, size_t> m_var2slot;
+    CompNode::UnorderedMap<CompNodeState> m_cn_state;
+
+    //! whether each slot has been checked in current execution; written on
+    //! the dispatcher threads
+    std::unique_ptr<std::atomic_bool[]> m_checked;
+    Maybe<Pending> m_pending;
+    Maybe<Fault> m_fault;
+
+    void init_slots(cg::AsyncExecutable* exec);
+    void check(size_t slot);
+
+    void on_seq_start(const cg::event::CompSeqExecBeforeStart& event);
+    void on_kern_end(const cg::event::OprExecKernelEnd& event);
+    void on_seq_finish(const cg::event::CompSeqExecFinished& event);
+    void on_order_determined(const cg::event::CompSeqOrderDetermined& event);
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
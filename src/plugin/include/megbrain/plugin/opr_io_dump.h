@@ -14,6 +14,9 @@
 #include <cstdio>
 #include "megbrain/graph.h"
 #include "megbrain/plugin/base.h"
+#include "megbrain/utils/async_worker.h"
+
+#include <condition_variable>
 
 namespace mgb {
 
@@ -114,6 +117,82 @@ public:
     void flush_lazy() override;
 };
 
+/*!
+ * \brief similar to BinaryOprIODump, but write the values of all the vars into
+ *      a single indexed file without synchronizing the execution
+ *
+ * Each value is copied to a pinned host buffer on the stream of its comp node
+ * right after the opr producing it, and a pool of background threads waits
+ * for the copy, compresses the value with zlib if enabled and appends it to
+ * the file. The index is written by flush() and in the destructor; values of
+ * later executions are appended to the file as well. MGB_DUMP_INPUT is also
+ * supported.
+ *
+ * The file can be parsed by ``load_iodump_container`` in
+ * ``megengine/tools/compare_binary_iodump.py``. The record mode of
+ * comp_node_seq_record_level is not supported.
+ */
+class AsyncBinaryOprIODump final : public OprIODumpBase {
+    struct HostBuf;
+    struct Entry;
+    struct IndexItem;
+
+    FILE* m_fout;
+    bool m_compress = true;
+    size_t m_max_pending_bytes = 1024 * 1024 * 1024;
+
+    std::mutex m_mtx;
+    //! signaled when a pending value is written
+    std::condition_variable m_cv_written;
+    size_t m_nr_pending = 0, m_pending_bytes = 0, m_seq = 0;
+    //! the first error in the writers, thrown by flush()
+    std::string m_error;
+    CompNode::UnorderedMap<std::vector<std::unique_ptr<HostBuf>>> m_free_bufs;
+    size_t m_free_bytes = 0;
+
+    //! protects the file and the index
+    std::mutex m_file_mtx;
+    size_t m_data_end;
+    std::vector<IndexItem> m_index;
+
+    FutureThreadPool<void> m_workers{std::string{"iodump"}};
+
+    void dump_var(VarNode* var, bool lazy_sync) override;
+    void dump_value(const DeviceTensorND& value, std::string name, std::string title);
+    void write_entry(Entry& entry);
+    std::unique_ptr<HostBuf> alloc_buf(CompNode cn);
+    void free_buf(std::unique_ptr<HostBuf> buf);
+
+public:
+    /*!
+     * \param nr_threads number of threads to compress and write the values
+     */
+    AsyncBinaryOprIODump(
+            cg::ComputingGraph* graph, const std::string& output_file,
+            size_t nr_threads = 2);
+    ~AsyncBinaryOprIODump();
+
+    //! wait for all the values dumped so far to be written, and write the index
+    void flush();
+
+    void flush_lazy() override { flush(); }
+
+    //! set whether to compress the values; only effective if built with zlib
+    AsyncBinaryOprIODump& compress(bool flag) {
+        m_compress = flag;
+        return *this;
+    }
+
+    /*!
+     * \brief set max bytes of the values that have been copied but not written,
+     *      beyond which the execution would wait for the writers
+     */
+    AsyncBinaryOprIODump& max_pending_bytes(size_t size) {
+        m_max_pending_bytes = size;
+        return *this;
+    }
+};
+
 }  // namespace mgb
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
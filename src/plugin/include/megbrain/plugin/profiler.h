@@ -23,6 +23,7 @@
 #include <memory>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace opr_profile {
 class OprProfileHolder final : public mgb::UserDataContainer::UserData {
@@ -71,6 +72,37 @@ class GraphProfiler final : public PluginBase {
 
     std::unique_ptr<OprFootprint> m_opr_footprint_ptr{std::make_unique<OprFootprint>()};
 
+    //! hardware counters of the kernels of an opr on a cpu comp node
+    struct OprHwCounter {
+        uint64_t cycles = 0, instructions = 0, cache_references = 0,
+                 cache_misses = 0, branch_misses = 0;
+        double time = 0;  //!< seconds between the reads on the dispatcher
+    };
+
+    //! perf_event counter group opened on a dispatcher thread
+    class HwCounterReader;
+
+    bool m_hw_counter_enabled = false;
+
+    //! (opr, comp node) => hardware counters
+    std::unordered_map<
+            std::pair<cg::OperatorNodeBase*, CompNode>, OprHwCounter, pairhash>
+            m_hw_counter;
+
+    //! (opr, comp node) => counter values when the kernels start
+    std::unordered_map<
+            std::pair<cg::OperatorNodeBase*, CompNode>, OprHwCounter, pairhash>
+            m_hw_counter_start;
+
+    //! dispatcher thread => counters opened on it
+    std::unordered_map<std::thread::id, std::unique_ptr<HwCounterReader>>
+            m_hw_counter_reader;
+
+    //! (opr, comp node) => memory used on the comp node when the opr
+    //! finishes on host
+    std::unordered_map<std::pair<cg::OperatorNodeBase*, CompNode>, size_t, pairhash>
+            m_used_mem;
+
     //! first event on each comp node
     Maybe<CompNode::UnorderedMap<CompNodeEventPtr>> m_start_of_time;
     std::mutex m_mtx;
@@ -82,10 +114,44 @@ class GraphProfiler final : public PluginBase {
     void ensure_start_time();
     void record_event(CompNodeEventPtr& dest, CompNode comp_node);
 
+    //! read the hardware counters on the dispatcher of a cpu comp node
+    void read_hw_counter(cg::OperatorNodeBase* opr, CompNode comp_node, bool end);
+
 public:
+    //! peak compute and bandwidth of a device, used by the roofline report
+    struct DeviceSpec {
+        double gflops = 0;  //!< peak GFLOP/s, 0 for unknown
+        double gbps = 0;    //!< peak GB/s, 0 for unknown
+    };
+
+    //! (prefix of physical comp node name like "gpu0" or "cpu", spec); the
+    //! longest matched prefix is used
+    using DeviceSpecTable = std::vector<std::pair<std::string, DeviceSpec>>;
+
     GraphProfiler(cg::ComputingGraph* graph);
     ~GraphProfiler() noexcept;
 
+    /*!
+     * \brief parse the device spec table from text, each line of which is
+     *      "<comp node prefix> <peak GFLOP/s> <peak GB/s>"; '#' starts a
+     *      comment
+     */
+    static DeviceSpecTable parse_device_spec(const std::string& content);
+
+    /*!
+     * \brief also count cycles, instructions, cache references, cache
+     *      misses and branch misses of the kernels on cpu comp nodes
+     *
+     * The counters are read by perf_event_open(2) on the dispatcher thread of
+     * the comp node right before and after the kernels of each opr, so only
+     * the work done on that thread is counted, not that of the workers of its
+     * thread pool. The result is put into the "hw_counter" field of to_json().
+     *
+     * \return whether the counters are available, which requires Linux or
+     *      Android and a permissive kernel.perf_event_paranoid
+     */
+    bool enable_hw_counter();
+
     /*!
      * \brief convert only profiling result to json
      */
@@ -98,6 +164,32 @@ public:
         return json::Object::make(
                 {{"graph_exec", graph_exec->to_json()}, {"profiler", to_json()}});
     }
+
+    /*!
+     * \brief convert profiling result to the Chrome trace event format, which
+     *      can be opened by chrome://tracing or Perfetto
+     *
+     * The device time of the oprs is shown on a track for each comp node, with
+     * the copy oprs on a separate track of the comp node; the host time is
+     * shown on a track for each dispatch thread in another process, whose
+     * time has a different origin. A flow arrow goes from an opr to each of
+     * its readers on another comp node, and the memory used on each comp node
+     * is shown as a counter.
+     */
+    std::shared_ptr<json::Object> to_chrome_trace() const;
+
+    /*!
+     * \brief combine the device time with OprFootprint to report the achieved
+     *      GFLOP/s and GB/s of each opr
+     *
+     * The attainable performance of an opr is min(peak GFLOP/s, arithmetic
+     * intensity * peak GB/s) of its device, and the oprs are ranked by the
+     * ratio of the achieved performance to it, the least efficient first. The
+     * bandwidth is used for the oprs without computation footprint, and the
+     * oprs on devices without spec are put at the end.
+     */
+    std::shared_ptr<json::Object> to_roofline_json(
+            const DeviceSpecTable& specs = {}) const;
 };
 
 }  // namespace mgb
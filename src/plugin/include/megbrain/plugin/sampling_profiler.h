@@ -0,0 +1,122 @@
+/**
+ * \file src/plugin/include/megbrain/plugin/sampling_profiler.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/graph/event.h"
+#include "megbrain/plugin/base.h"
+#include "megbrain/utils/json.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+
+namespace mgb {
+
+/*!
+ * \brief a low-overhead profiler which samples the kernel time of the oprs,
+ *      to be kept on in production
+ *
+ * Only one in sample_interval executions is sampled, and the oprs of a
+ * sampled execution are split into nr_opr_slices slices by their order, of
+ * which only one slice is recorded in turn. The kernel time is measured on
+ * the dispatcher threads between BeforeKernel and AfterKernel, so it is the
+ * host time to issue the kernels on asynchronous devices.
+ *
+ * The time is accumulated into the histograms per (opr type, input shapes)
+ * with atomic counters, so recording takes no lock; stats() pulls the
+ * aggregates at any time. The profiler must be attached before the graph is
+ * compiled.
+ */
+class SamplingProfiler final : public PluginBase {
+public:
+    struct Options {
+        size_t sample_interval = 100;
+        size_t nr_opr_slices = 1;
+    };
+
+    //! bucket i of the histogram counts the samples in [2^i, 2^(i+1))
+    //! microseconds, the first and the last buckets also count the shorter
+    //! and the longer ones
+    static constexpr size_t NR_BUCKETS = 24;
+
+    struct Stat {
+        std::string opr_type;
+        std::string shape;
+        size_t count = 0;
+        double total_ms = 0, max_ms = 0;
+        std::array<size_t, NR_BUCKETS> histogram{};
+    };
+
+    SamplingProfiler(cg::ComputingGraph* graph);
+    SamplingProfiler(cg::ComputingGraph* graph, const Options& options);
+
+    /*!
+     * \brief get the aggregates of all the (opr type, input shapes) that have
+     *      been sampled
+     * \param reset whether to clear the aggregates after they are read
+     */
+    std::vector<Stat> stats(bool reset = false);
+
+    //! number of executions seen and sampled
+    size_t nr_executions() const { return m_nr_exec; }
+    size_t nr_sampled() const { return m_nr_sampled; }
+
+#if MGB_ENABLE_JSON
+    std::shared_ptr<json::Object> to_json(bool reset = false);
+#endif
+
+private:
+    struct Bucket {
+        std::string opr_type, shape;
+        std::atomic<uint64_t> count{0}, total_ns{0}, max_ns{0};
+        std::array<std::atomic<uint64_t>, NR_BUCKETS> histogram{};
+    };
+
+    struct Slot {
+        size_t index = 0;
+        //! accessed by the execution thread only
+        size_t shape_hash = 0;
+        Bucket* bucket = nullptr;
+        //! the bucket to record the current kernel into, set by the execution
+        //! thread and taken by the dispatcher thread
+        std::atomic<Bucket*> armed{nullptr};
+        //! accessed by the dispatcher thread only
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void on_comp_seq_determined(const cg::event::CompSeqOrderDetermined& event);
+    void on_exec_start(const cg::event::CompSeqExecBeforeStart& event);
+    void on_opr_start(const cg::event::OprExecStart& event);
+    void on_before_kern(const cg::event::BeforeKernel& event);
+    void on_after_kern(const cg::event::AfterKernel& event);
+
+    //! get the bucket of the current input shapes of the opr
+    Bucket* get_bucket(Slot& slot, cg::OperatorNodeBase* opr);
+
+    const Options m_options;
+    std::atomic_size_t m_nr_exec{0}, m_nr_sampled{0};
+    bool m_cur_sampled = false;
+    size_t m_cur_slice = 0;
+
+    //! built when the graph is compiled and read-only during executions
+    ThinHashMap<cg::OperatorNodeBase*, std::unique_ptr<Slot>> m_opr2slot;
+
+    //! guards the creation of buckets, which are never freed
+    MGB_MUTEX m_bucket_mtx;
+    std::deque<Bucket> m_buckets;
+    std::unordered_map<std::string, Bucket*> m_key2bucket;
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,59 @@
+/**
+ * \file src/plugin/include/megbrain/plugin/startup_profiler.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/graph/event.h"
+#include "megbrain/plugin/base.h"
+#include "megbrain/utils/json.h"
+
+namespace mgb {
+
+/*!
+ * \brief record the time of the startup phases of a graph, from model loading
+ *      to the first execution
+ *
+ * The phases are reported by cg::event::StartupPhaseFinished; the profiler
+ * needs to be attached before the model is loaded to see the load phases.
+ */
+class StartupProfiler final : public PluginBase {
+public:
+    struct Item {
+        std::string name;
+        double time_ms;
+    };
+
+    struct Phase {
+        double total_ms = 0;
+        size_t count = 0;
+        //! the items with non-empty name, such as the gopt passes
+        std::vector<Item> items;
+    };
+
+    StartupProfiler(cg::ComputingGraph* graph);
+
+    //! the phases in the order that they are first reported
+    std::vector<std::pair<std::string, Phase>> phases() const;
+
+#if MGB_ENABLE_JSON
+    std::shared_ptr<json::Object> to_json() const;
+#endif
+
+private:
+    void on_phase_finished(const cg::event::StartupPhaseFinished& event);
+
+    mutable MGB_MUTEX m_mtx;
+    std::vector<std::pair<std::string, Phase>> m_phases;
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
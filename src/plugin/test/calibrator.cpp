@@ -0,0 +1,146 @@
+/**
+ * \file src/plugin/test/calibrator.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "megbrain/plugin/calibrator.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/test/helper.h"
+
+#include <random>
+#include <thread>
+
+using namespace mgb;
+
+namespace {
+using Method = Calibrator::Method;
+
+//! a graph computing b = a * 2 + w of w = 1, with a calibrator attached
+struct CalibratedGraph {
+    std::shared_ptr<HostTensorND> host_a;
+    std::shared_ptr<ComputingGraph> graph;
+    std::unique_ptr<Calibrator> calibrator;
+    std::unique_ptr<cg::AsyncExecutable> func;
+
+    CalibratedGraph(CompNode cn, const TensorShape& shape) {
+        host_a = std::make_shared<HostTensorND>(cn, shape, dtype::Float32());
+        HostTensorND host_w{cn, {1}, dtype::Float32()};
+        host_w.ptr<float>()[0] = 1.f;
+        graph = ComputingGraph::make();
+        calibrator = std::make_unique<Calibrator>(graph.get());
+        auto a = opr::Host2DeviceCopy::make(*graph, host_a).rename("a"),
+             w = opr::SharedDeviceTensor::make(*graph, host_w).rename("w"),
+             b = (a * 2 + w).rename("b");
+        func = graph->compile({{b, {}}});
+    }
+
+    void run(const float* data) {
+        auto ptr = host_a->ptr<float>();
+        std::copy(data, data + host_a->shape().total_nr_elems(), ptr);
+        func->execute();
+    }
+};
+}  // anonymous namespace
+
+TEST(TestCalibrator, Simple) {
+    constexpr size_t N = 1000;
+    CalibratedGraph g{CompNode::load("xpu0"), {N}};
+    std::vector<float> data(N);
+    for (size_t i = 0; i < N; ++i) {
+        data[i] = i % 2 ? -float(i) : float(i);
+    }
+    g.run(data.data());
+    // the constant weight is not calibrated
+    ASSERT_EQ(nullptr, g.calibrator->histogram("w"));
+    auto hist = g.calibrator->histogram("a");
+    ASSERT_NE(nullptr, hist);
+    ASSERT_EQ(N, hist->total);
+    ASSERT_EQ(999.f, hist->amax);
+    ASSERT_NE(nullptr, g.calibrator->histogram("b"));
+
+    auto scales = g.calibrator->scales(Method::MAX);
+    MGB_ASSERT_FLOAT_EQ(999.f / 127, scales.at("a"));
+    // half of the values are within the threshold, give or take a bin
+    float width = hist->bin_width();
+    scales = g.calibrator->scales(Method::PERCENTILE, 0.5f);
+    ASSERT_LE(std::abs(scales.at("a") * 127 - 500.f), width);
+
+    // the bins are widened to cover larger values
+    for (auto&& i : data) {
+        i *= 4;
+    }
+    g.run(data.data());
+    ASSERT_EQ(N * 2, hist->total);
+    ASSERT_EQ(999.f * 4, hist->amax);
+    ASSERT_EQ(width * 4, hist->bin_width());
+}
+
+TEST(TestCalibrator, Entropy) {
+    constexpr size_t N = 10000;
+    CalibratedGraph g{CompNode::load("xpu0"), {N}};
+    std::vector<float> data(N);
+    RNGxorshf rng{next_rand_seed()};
+    std::normal_distribution<float> dist;
+    for (auto&& i : data) {
+        i = dist(rng);
+    }
+    // a single outlier should be clipped
+    data[0] = 100.f;
+    g.run(data.data());
+    float scale = g.calibrator->scales(Method::ENTROPY).at("a");
+    ASSERT_LT(scale * 127, 20.f);
+    ASSERT_GT(scale * 127, 2.f);
+}
+
+TEST(TestCalibrator, MergeThreads) {
+    constexpr size_t N = 512, NR_BATCH = 4;
+    std::vector<std::vector<float>> batches(NR_BATCH, std::vector<float>(N));
+    for (size_t b = 0; b < NR_BATCH; ++b) {
+        for (size_t i = 0; i < N; ++i) {
+            batches[b][i] = (float(i) - N / 2) * (b + 1) * 0.01f;
+        }
+    }
+
+    CalibratedGraph ref{CompNode::load("xpu0"), {N}};
+    for (auto&& i : batches) {
+        ref.run(i.data());
+    }
+
+    // each thread runs every other batch of its own copy of the graph
+    std::vector<std::unique_ptr<CalibratedGraph>> graphs;
+    for (size_t t = 0; t < 2; ++t) {
+        graphs.emplace_back(std::make_unique<CalibratedGraph>(
+                CompNode::load(ssprintf("cpu%zu", t)), TensorShape{N}));
+    }
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 2; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t b = t; b < NR_BATCH; b += 2) {
+                graphs[t]->run(batches[b].data());
+            }
+        });
+    }
+    for (auto&& i : workers) {
+        i.join();
+    }
+    graphs[0]->calibrator->merge(*graphs[1]->calibrator);
+
+    for (auto name : {"a", "b"}) {
+        auto expect = ref.calibrator->histogram(name),
+             get = graphs[0]->calibrator->histogram(name);
+        ASSERT_EQ(expect->total, get->total);
+        ASSERT_EQ(expect->amax, get->amax);
+        ASSERT_EQ(expect->width_exp, get->width_exp);
+        ASSERT_EQ(expect->bins, get->bins);
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,78 @@
+/**
+ * \file src/plugin/test/memory_timeline.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/memory_timeline.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/opr/tensor_manip.h"
+#include "megbrain/test/helper.h"
+
+using namespace mgb;
+
+TEST(TestMemoryTimeline, Peak) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({1024}, cn);
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x"),
+         w = opr::SharedDeviceTensor::make(*graph, *gen({1024}, cn)).rename("w"),
+         y = (x * w).rename("y"), y1 = opr::Reshape::make(y, {32, 32}).rename("y1"),
+         z = (opr::Reshape::make(y1, {1024}) + x).rename("z");
+    HostTensorND host_z;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+    MemoryTimeline timeline{graph.get()};
+    func->execute().wait();
+
+    auto steps = timeline.steps();
+    auto chunks = timeline.chunks();
+    ASSERT_FALSE(steps.empty());
+    const MemoryTimeline::Chunk *chunk_w = nullptr, *chunk_y = nullptr;
+    for (auto&& i : chunks) {
+        ASSERT_LE(i.begin, i.end);
+        ASSERT_LT(i.end, steps.size());
+        if (i.owner_var == "w") {
+            chunk_w = &i;
+        }
+        if (i.owner_var == "y") {
+            chunk_y = &i;
+        }
+    }
+    ASSERT_TRUE(chunk_w && chunk_y);
+    // the weight lives over the whole execution
+    ASSERT_EQ(0u, chunk_w->begin);
+    ASSERT_EQ(steps.size() - 1, chunk_w->end);
+    // y1 is forwarded from y
+    ASSERT_NE(
+            chunk_y->vars.end(),
+            std::find(chunk_y->vars.begin(), chunk_y->vars.end(), "y1"));
+    ASSERT_EQ(1024u * sizeof(float), chunk_y->size);
+
+    auto peak = timeline.peak(chunks, cn);
+    auto usage = timeline.usage(chunks, cn);
+    ASSERT_EQ(steps.size(), usage.size());
+    ASSERT_EQ(*std::max_element(usage.begin(), usage.end()), peak.bytes);
+    size_t live_bytes = 0;
+    for (auto i : peak.live) {
+        live_bytes += chunks[i].size;
+    }
+    ASSERT_EQ(peak.bytes, live_bytes);
+
+#if MGB_ENABLE_JSON
+    auto json = timeline.to_json();
+    ASSERT_TRUE((*json)["mem_node"]);
+    json->writeto_fpath(output_file("TestMemoryTimeline.json"));
+#endif
+    auto svg = timeline.to_svg();
+    ASSERT_NE(std::string::npos, svg.find("tag:name=\"y\""));
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,95 @@
+/**
+ * \file src/plugin/test/non_finite_checker.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/non_finite_checker.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/test/helper.h"
+
+using namespace mgb;
+
+TEST(TestNonFiniteChecker, FirstFault) {
+    HostTensorGenerator<dtype::Float32, RandomDistribution::UNIFORM> gen{0.5f, 1.f};
+    auto host_x = gen({2, 3});
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x"),
+         y = opr::log(x).rename("y"), z = (opr::log(y) * 2).rename("z");
+    HostTensorND host_z;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+
+    size_t nr_fault = 0;
+    NonFiniteChecker checker{graph.get(), 2};
+    checker.on_fault([&](const NonFiniteChecker::Fault&) { ++nr_fault; });
+
+    // log(log(x)) is nan for x in (0.5, 1)
+    func->execute().wait();
+    auto&& fault = checker.poll(true);
+    ASSERT_TRUE(fault.valid());
+    // the first opr with non-finite output is the second log
+    ASSERT_EQ(z.node()->owner_opr()->input(0)->owner_opr()->name(),
+              fault->opr_name);
+    ASSERT_EQ(1u, nr_fault);
+
+    // no more checks after the first fault
+    func->execute().wait();
+    func->execute().wait();
+    checker.poll(true);
+    ASSERT_EQ(1u, nr_fault);
+}
+
+TEST(TestNonFiniteChecker, Interval) {
+    HostTensorGenerator<dtype::Float32, RandomDistribution::UNIFORM> gen{2.f, 3.f};
+    auto host_x = gen({2, 3});
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         y = opr::log(opr::log(x) - 0.5f);
+    HostTensorND host_y;
+    auto func = graph->compile({make_callback_copy(y, host_y)});
+    NonFiniteChecker checker{graph.get(), 2};
+
+    func->execute().wait();
+    ASSERT_FALSE(checker.poll(true).valid());
+
+    // log(2) - 0.5 < 0; the second execution is not checked
+    for (size_t i = 0; i < host_x->shape().total_nr_elems(); ++i) {
+        host_x->ptr<float>()[i] = 1.f;
+    }
+    func->execute().wait();
+    ASSERT_FALSE(checker.poll(true).valid());
+    func->execute().wait();
+    ASSERT_TRUE(checker.poll(true).valid());
+}
+
+TEST(TestNonFiniteChecker, InputUnchanged) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({3, 4});
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x), y = x * 2.f, z = y + 1.f;
+    HostTensorND host_y, host_z;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(z, host_z)});
+    NonFiniteChecker checker{graph.get(), 1};
+
+    // the checked vars are only read, and their readers get the same values
+    for (size_t iter = 0; iter < 3; ++iter) {
+        func->execute().wait();
+        ASSERT_FALSE(checker.poll(true).valid());
+        auto px = host_x->ptr<float>(), py = host_y.ptr<float>(),
+             pz = host_z.ptr<float>();
+        for (size_t i = 0; i < host_x->shape().total_nr_elems(); ++i) {
+            ASSERT_EQ(px[i] * 2.f, py[i]);
+            ASSERT_EQ(px[i] * 2.f + 1.f, pz[i]);
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -19,7 +19,9 @@
 #include "megbrain/plugin/opr_io_dump.h"
 #include "megbrain/utils/debug.h"
 
+#include <cstring>
 #include <fstream>
+#include <map>
 #include <sstream>
 
 using namespace mgb;
@@ -118,7 +120,10 @@ void run_test(const PluginMaker& plugin_maker, const ResultChecker& result_check
             continue;
         if (CompNode::get_device_count(type)) {
             auto cn = CompNode::load({type, -1, 0});
-            if (cn.contain_flag(CompNode::Flag::SUPPORT_RECORDER)) {
+            // the dump plugin reads values on host during execution, which
+            // could not be captured into cuda graphs
+            if (cn.contain_flag(CompNode::Flag::SUPPORT_RECORDER) &&
+                type != CompNode::DeviceType::CUDA) {
                 run_test(cn, plugin_maker);
                 ASSERT_FALSE(::testing::Test::HasFailure())
                         << "failed for comp node " << cn.to_string();
@@ -130,6 +135,19 @@ void run_test(const PluginMaker& plugin_maker, const ResultChecker& result_check
     }
 }
 
+std::string read_file(const std::string& fname) {
+    std::ifstream inp{fname, std::ios::binary};
+    return {std::istreambuf_iterator<char>{inp}, std::istreambuf_iterator<char>{}};
+}
+
+template <typename T>
+T read_pod(const std::string& data, size_t& offset) {
+    T ret;
+    memcpy(&ret, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return ret;
+}
+
 std::vector<std::string> getlines(std::istream& inp, size_t skip_head = 0) {
     std::vector<std::string> ret;
     for (std::string line; std::getline(inp, line);) {
@@ -202,4 +220,63 @@ TEST(TestOprIODump, Binary) {
     run_test(make_plugin, []() {});
 }
 
+TEST(TestOprIODump, AsyncBinary) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({3, 4});
+    auto dir = output_file(""), fname = output_file("test_opr_iodump_async.bin");
+    auto graph = ComputingGraph::make();
+    graph->options().var_sanity_check_first_run = false;
+    auto plug_sync = std::make_unique<BinaryOprIODump>(graph.get(), dir);
+    auto plug_async = std::make_unique<AsyncBinaryOprIODump>(graph.get(), fname);
+    plug_async->compress(false).max_pending_bytes(64);
+
+    using S = opr::Subtensor;
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         // non-contiguous
+         x0 = S::make(x, {S::AxisIndexer::make_interval(1, None, None, x.make_scalar(2))}),
+         y = opr::relu(x0) * x0.make_scalar(2.f);
+    HostTensorND host_y;
+    auto func = graph->compile({make_callback_copy(y, host_y)});
+    for (int i = 0; i < 2; ++i) {
+        host_x->copy_from(*gen(host_x->shape()));
+        func->execute().wait();
+    }
+    plug_async->flush();
+
+    auto data = read_file(fname);
+    ASSERT_EQ("MGBIODMP", data.substr(0, 8));
+    ASSERT_EQ("MGBIODIX", data.substr(data.size() - 8));
+    size_t trailer = data.size() - 24;
+    auto index_offset = read_pod<uint64_t>(data, trailer),
+         nr_values = read_pod<uint64_t>(data, trailer);
+
+    // name => (seq, value) of the last execution
+    std::map<std::string, std::pair<uint64_t, std::string>> values;
+    std::map<std::string, size_t> nr_dumps;
+    size_t offset = index_offset;
+    for (size_t i = 0; i < nr_values; ++i) {
+        auto voff = read_pod<uint64_t>(data, offset),
+             size = read_pod<uint64_t>(data, offset),
+             raw_size = read_pod<uint64_t>(data, offset),
+             seq = read_pod<uint64_t>(data, offset);
+        auto codec = read_pod<uint32_t>(data, offset),
+             name_len = read_pod<uint32_t>(data, offset);
+        auto name = data.substr(offset, name_len);
+        offset += name_len;
+        ASSERT_EQ(0u, codec);
+        ASSERT_EQ(raw_size, size);
+        ++nr_dumps[name];
+        auto&& val = values[name];
+        if (nr_dumps[name] == 1 || seq > val.first) {
+            val = {seq, data.substr(voff, size)};
+        }
+    }
+    ASSERT_EQ(index_offset, offset);
+    ASSERT_FALSE(values.empty());
+    for (auto&& i : values) {
+        ASSERT_EQ(2u, nr_dumps[i.first]) << i.first;
+        ASSERT_EQ(read_file(dir + "/" + i.first), i.second.second) << i.first;
+    }
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
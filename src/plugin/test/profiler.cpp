@@ -10,6 +10,7 @@
  */
 
 #include "megbrain/plugin/profiler.h"
+#include <map>
 #include <sstream>
 #include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/io.h"
@@ -46,4 +47,113 @@ TEST(TestGraphProfiler, APlusBCPU) {
     run_test(CompNode::load("cpu0"), "test_profiler_cpu.json");
 }
 
+TEST(TestGraphProfiler, Roofline) {
+    auto specs = GraphProfiler::parse_device_spec(
+            "cpu 100 10\n"
+            "# the longest prefix is used\n"
+            "cpu0 200 20  # peak of cpu0\n");
+    ASSERT_EQ(2u, specs.size());
+    ASSERT_EQ("cpu0", specs[1].first);
+    ASSERT_EQ(200., specs[1].second.gflops);
+    ASSERT_EQ(20., specs[1].second.gbps);
+    ASSERT_THROW(GraphProfiler::parse_device_spec("cpu0 200"), MegBrainError);
+
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({64, 64}, cn), host_y = gen({64, 64}, cn);
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x"),
+         y = opr::Host2DeviceCopy::make(*graph, host_y).rename("y"),
+         z = (x + y).rename("z");
+    HostTensorND host_z;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+    GraphProfiler profiler{graph.get()};
+    func->execute().wait();
+
+    auto report = profiler.to_roofline_json(specs);
+    auto&& oprs = (*report)["oprs"]->cast_final_safe<json::Array>().get_impl();
+    bool found = false;
+    double last_percent = 0;
+    for (auto&& i : oprs) {
+        auto&& opr = i->cast_final_safe<json::Object>();
+        auto&& percent = opr.get_impl().find(std::string("roofline_percent"));
+        if (percent == opr.get_impl().end()) {
+            continue;
+        }
+        auto value = percent->second->cast_final_safe<json::Number>().get_impl();
+        ASSERT_GE(value, last_percent);
+        last_percent = value;
+        auto&& name = opr.get_impl().at(std::string("name"));
+        if (name->cast_final_safe<json::String>().get_impl() == "z") {
+            found = true;
+        }
+    }
+    ASSERT_TRUE(found);
+}
+
+TEST(TestGraphProfiler, ChromeTrace) {
+    HostTensorGenerator<> gen;
+    auto cn0 = CompNode::load("cpu0"), cn1 = CompNode::load("cpu1");
+    auto host_x = gen({64, 64}, cn0);
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x"),
+         y = (x * 2).rename("y"),
+         z = (opr::Copy::make(y, cn1) + 1).rename("z");
+    HostTensorND host_z;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+    GraphProfiler profiler{graph.get()};
+    func->execute().wait();
+
+    auto trace = profiler.to_chrome_trace();
+    trace->writeto_fpath(output_file("test_profiler_trace.json"));
+    auto&& events =
+            (*trace)["traceEvents"]->cast_final_safe<json::Array>().get_impl();
+    std::map<std::string, int> cnt;
+    bool found_copy_track = false;
+    for (auto&& i : events) {
+        auto&& ev = i->cast_final_safe<json::Object>();
+        auto ph = ev["ph"]->cast_final_safe<json::String>().get_impl();
+        ++cnt[ph];
+        if (ph == "M" &&
+            ev["args"]->cast_final_safe<json::Object>()["name"]
+                            ->cast_final_safe<json::String>()
+                            .get_impl() == cn0.to_string() + " copy") {
+            found_copy_track = true;
+        }
+    }
+    ASSERT_TRUE(found_copy_track);
+    // y on cpu0 is read by Copy on cpu1
+    ASSERT_GE(cnt["s"], 1);
+    ASSERT_EQ(cnt["s"], cnt["f"]);
+    ASSERT_GE(cnt["X"], 4);
+}
+
+TEST(TestGraphProfiler, HwCounter) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({256, 256}, cn), host_y = gen({256, 256}, cn);
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x"),
+         y = opr::Host2DeviceCopy::make(*graph, host_y).rename("y"),
+         z = (x + y).rename("z");
+    HostTensorND host_z;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+    GraphProfiler profiler{graph.get()};
+    if (!profiler.enable_hw_counter()) {
+        printf("skip HwCounter: perf_event not available\n");
+        return;
+    }
+    func->execute().wait();
+
+    auto result = profiler.to_json();
+    auto&& counters = (*result)["hw_counter"]->cast_final_safe<json::Object>();
+    auto&& z_prof = counters[z.node()->owner_opr()->id_str()];
+    ASSERT_TRUE(z_prof);
+    auto&& z_cnt = (*z_prof->cast_final_safe<json::Object>()[cn.to_string()])
+                           .cast_final_safe<json::Object>();
+    ASSERT_GT(z_cnt["cycles"]->cast_final_safe<json::NumberInt>().get_impl(), 0);
+    ASSERT_GT(
+            z_cnt["instructions"]->cast_final_safe<json::NumberInt>().get_impl(), 0);
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,64 @@
+/**
+ * \file src/plugin/test/sampling_profiler.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/sampling_profiler.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/test/helper.h"
+
+using namespace mgb;
+
+TEST(TestSamplingProfiler, Basic) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({16, 16}, cn);
+    auto graph = ComputingGraph::make();
+    SamplingProfiler::Options options;
+    options.sample_interval = 3;
+    options.nr_opr_slices = 1;
+    SamplingProfiler profiler{graph.get(), options};
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         y = opr::exp(x) + 1;
+    HostTensorND host_y;
+    auto func = graph->compile({make_callback_copy(y, host_y)});
+    for (int i = 0; i < 7; ++i) {
+        func->execute().wait();
+    }
+    ASSERT_EQ(7u, profiler.nr_executions());
+    ASSERT_EQ(3u, profiler.nr_sampled());
+
+    auto check = [&](size_t expected_count) {
+        auto stats = profiler.stats(true);
+        ASSERT_FALSE(stats.empty());
+        for (auto&& i : stats) {
+            ASSERT_EQ(expected_count, i.count) << i.opr_type;
+            size_t nr = 0;
+            for (auto c : i.histogram) {
+                nr += c;
+            }
+            ASSERT_EQ(i.count, nr);
+            ASSERT_LE(i.max_ms, i.total_ms);
+        }
+    };
+    check(3);
+    ASSERT_TRUE(profiler.stats().empty());
+
+    //! the stats are kept by the input shapes; only the last of the three
+    //! executions is sampled
+    *host_x = *gen({8, 8}, cn);
+    for (int i = 0; i < 3; ++i) {
+        func->execute().wait();
+    }
+    check(1);
+    ASSERT_TRUE(profiler.stats().empty());
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
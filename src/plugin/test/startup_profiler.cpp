@@ -0,0 +1,61 @@
+/**
+ * \file src/plugin/test/startup_profiler.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/plugin/startup_profiler.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/serialization/serializer.h"
+#include "megbrain/test/helper.h"
+
+using namespace mgb;
+using namespace serialization;
+
+TEST(TestStartupProfiler, LoadAndCompile) {
+    auto fname = output_file("StartupProfilerTest");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3});
+    {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             y = opr::SharedDeviceTensor::make(*graph, *gen({2, 3})),
+             z = x * 2 + y;
+        auto dumper = GraphDumper::make(OutputFile::make_fs(fname.c_str()));
+        dumper->dump({z});
+    }
+
+    GraphLoader::LoadConfig config;
+    config.comp_graph = ComputingGraph::make();
+    StartupProfiler profiler(config.comp_graph.get());
+    auto loader = GraphLoader::make(InputFile::make_fs(fname.c_str()));
+    auto rst = loader->load(config);
+    HostTensorND host_z;
+    auto func = config.comp_graph->compile(
+            {make_callback_copy(rst.output_var_list[0], host_z)});
+    func->execute();
+
+    std::unordered_map<std::string, StartupProfiler::Phase> phases;
+    for (auto&& i : profiler.phases()) {
+        ASSERT_EQ(0u, phases.count(i.first));
+        ASSERT_GE(i.second.total_ms, 0);
+        phases[i.first] = i.second;
+    }
+    for (auto name : {"load.parse", "load.tensor_decode", "load.opr", "compile",
+                      "static_mem_plan"}) {
+        ASSERT_EQ(1u, phases.count(name)) << name;
+        ASSERT_EQ(1u, phases.at(name).count) << name;
+    }
+#if MGB_ENABLE_JSON
+    auto json = profiler.to_json();
+    ASSERT_TRUE((*json)["compile"]);
+    ASSERT_TRUE((*json)["total_ms"]);
+#endif
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -18,49 +18,120 @@ namespace serialization {
 
 std::shared_ptr<DeviceTensorND> BatchedDeviceValueLoader::make(
         CompNode comp_node, HostTensorND value) {
-    auto&& tensor_list = m_cn2tensor_list[comp_node];
+    auto dev_tensor = make_placeholder(comp_node, value.layout());
+    add(dev_tensor, std::move(value));
+    return dev_tensor;
+}
+
+void BatchedDeviceValueLoader::add(
+        std::shared_ptr<DeviceTensorND> dest, HostTensorND value) {
+    auto&& tensor_list = m_cn2tensor_list[dest->comp_node()];
+    tensor_list.size += dest->layout().span().dist_byte();
+    tensor_list.tensors.emplace_back(std::move(value), std::move(dest));
+}
+
+std::shared_ptr<DeviceTensorND> BatchedDeviceValueLoader::make_placeholder(
+        CompNode comp_node, const TensorLayout& layout) {
     auto dev_tensor = std::make_shared<DeviceTensorND>();
     DeviceTensorStorage storage;
 
-    auto size = value.layout().span().dist_byte();
+    auto size = layout.span().dist_byte();
     storage.reset(comp_node, size, nullptr);
-    dev_tensor->reset(storage, value.layout());
-    tensor_list.tensors.emplace_back(std::move(value), dev_tensor);
+    dev_tensor->reset(storage, layout);
     return dev_tensor;
 }
 
-void BatchedDeviceValueLoader::apply() {
-    for (auto&& item : m_cn2tensor_list) {
-        auto alignment = item.first.get_mem_addr_alignment();
-        size_t tot_size = 0;
-        for (auto&& i : item.second.tensors) {
-            tot_size = get_aligned_power2(tot_size, alignment) +
-                       i.second->layout().span().dist_byte();
+size_t BatchedDeviceValueLoader::pending_size(CompNode comp_node) const {
+    auto iter = m_cn2tensor_list.find(comp_node);
+    return iter == m_cn2tensor_list.end() ? 0 : iter->second.size;
+}
+
+void BatchedDeviceValueLoader::flush(CompNode comp_node) {
+    auto iter = m_cn2tensor_list.find(comp_node);
+    if (iter != m_cn2tensor_list.end()) {
+        flush(comp_node, iter->second);
+    }
+}
+
+void BatchedDeviceValueLoader::flush(CompNode comp_node, TensorList& tensor_list) {
+    if (tensor_list.tensors.empty()) {
+        return;
+    }
+    auto alignment = comp_node.get_mem_addr_alignment();
+    size_t tot_size = 0;
+    // host values can be copied to the cpu device directly, without packing
+    // them into a host buffer first
+    bool direct = comp_node.device_type() == CompNode::DeviceType::CPU;
+    for (auto&& i : tensor_list.tensors) {
+        tot_size = get_aligned_power2(tot_size, alignment) +
+                   i.second->layout().span().dist_byte();
+        direct &= i.second->layout().format.is_default();
+    }
+    if (direct) {
+        flush_direct(comp_node, tensor_list, tot_size);
+        return;
+    }
+
+    HostTensorStorage host_storage{comp_node};
+    DeviceTensorStorage dev_storage{comp_node};
+    host_storage.ensure_size(tot_size);
+    dev_storage.ensure_size(tot_size);
+    auto ptr_host = host_storage.ptr();
+    size_t offset = 0;
+    for (auto&& i : tensor_list.tensors) {
+        offset = get_aligned_power2(offset, alignment);
+        auto size = i.second->layout().span().dist_byte();
+        if (i.second->layout().format.is_default()) {
+            mgb_assert(size == i.first.layout().span().dist_byte());
+            memcpy(ptr_host + offset, i.first.raw_ptr(), size);
+        } else {
+            HostTensorND host;
+            host.reset(host_storage.sub(offset), i.second->layout());
+            host.copy_from_fixlayout(i.first);
         }
+        i.second->reset(dev_storage.sub(offset), i.second->layout());
+        offset += size;
+    }
+    dev_storage.copy_from(host_storage, tot_size);
+    m_inflight_host_storage.emplace_back(std::move(host_storage));
+    tensor_list.tensors.clear();
+    tensor_list.size = 0;
+    tensor_list.flushed = true;
+}
+
+void BatchedDeviceValueLoader::flush_direct(
+        CompNode comp_node, TensorList& tensor_list, size_t tot_size) {
+    auto alignment = comp_node.get_mem_addr_alignment();
+    DeviceTensorStorage dev_storage{comp_node};
+    dev_storage.ensure_size(tot_size);
+    SmallVector<CompNode::CopySegment> segs;
+    size_t offset = 0;
+    for (auto&& i : tensor_list.tensors) {
+        offset = get_aligned_power2(offset, alignment);
+        auto size = i.second->layout().span().dist_byte();
+        mgb_assert(size == i.first.layout().span().dist_byte());
+        i.second->reset(dev_storage.sub(offset), i.second->layout());
+        segs.push_back({i.second->raw_ptr(), i.first.raw_ptr(), size});
+        m_inflight_host_storage.emplace_back(i.first.storage());
+        offset += size;
+    }
+    comp_node.batched_copy_to_device(segs.data(), segs.size());
+    tensor_list.tensors.clear();
+    tensor_list.size = 0;
+    tensor_list.flushed = true;
+}
 
-        HostTensorStorage host_storage{item.first};
-        DeviceTensorStorage dev_storage{item.first};
-        host_storage.ensure_size(tot_size);
-        dev_storage.ensure_size(tot_size);
-        auto ptr_host = host_storage.ptr();
-        size_t offset = 0;
-        for (auto&& i : item.second.tensors) {
-            offset = get_aligned_power2(offset, alignment);
-            auto size = i.second->layout().span().dist_byte();
-            if (i.second->layout().format.is_default()) {
-                mgb_assert(size == i.first.layout().span().dist_byte());
-                memcpy(ptr_host + offset, i.first.raw_ptr(), size);
-            } else {
-                HostTensorND host;
-                host.reset(host_storage.sub(offset), i.second->layout());
-                host.copy_from_fixlayout(i.first);
-            }
-            i.second->reset(dev_storage.sub(offset), i.second->layout());
-            offset += size;
+void BatchedDeviceValueLoader::apply() {
+    for (auto&& item : m_cn2tensor_list) {
+        flush(item.first, item.second);
+    }
+    for (auto&& item : m_cn2tensor_list) {
+        if (item.second.flushed) {
+            item.first.sync();
         }
-        dev_storage.copy_from(host_storage, tot_size);
-        item.first.sync();
     }
+    m_cn2tensor_list.clear();
+    m_inflight_host_storage.clear();
 }
 
 }  // namespace serialization
@@ -28,9 +28,21 @@ namespace serialization {
 class BatchedDeviceValueLoader {
     struct TensorList {
         std::vector<std::pair<HostTensorND, std::shared_ptr<DeviceTensorND>>> tensors;
+        //! total size of pending tensors, without alignment padding
+        size_t size = 0;
+        //! whether some async copies on this comp node have been issued
+        bool flushed = false;
     };
     CompNode::UnorderedMap<TensorList> m_cn2tensor_list;
 
+    //! host buffers of issued copies, which must be kept alive until the
+    //! copies finish
+    std::vector<HostTensorStorage> m_inflight_host_storage;
+
+    void flush(CompNode comp_node, TensorList& tensor_list);
+    //! copy the host values to device without packing them on host
+    void flush_direct(CompNode comp_node, TensorList& tensor_list, size_t tot_size);
+
 public:
     /*!
      * \brief make a place holder device tensor that has correct dtype and comp
@@ -40,7 +52,29 @@ public:
      */
     std::shared_ptr<DeviceTensorND> make(CompNode comp_node, HostTensorND value);
 
-    //! apply all the lazy loads
+    /*!
+     * \brief add a lazy load into a placeholder created by make_placeholder()
+     * \param dest the placeholder, whose layout may differ from \p value in
+     *      tensor format
+     */
+    void add(std::shared_ptr<DeviceTensorND> dest, HostTensorND value);
+
+    //! make a device tensor with given layout but an empty pointer
+    static std::shared_ptr<DeviceTensorND> make_placeholder(
+            CompNode comp_node, const TensorLayout& layout);
+
+    //! total size of tensors on given comp node that have not been copied
+    size_t pending_size(CompNode comp_node) const;
+
+    /*!
+     * \brief copy pending tensors on given comp node to device in a single
+     *      transaction without waiting for it to finish
+     *
+     * Host values of the pending tensors must be ready when this is called.
+     */
+    void flush(CompNode comp_node);
+
+    //! apply all the lazy loads and wait for the copies to finish
     void apply();
 };
 
@@ -11,6 +11,13 @@
 
 #include "megbrain/serialization/file.h"
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace mgb {
 namespace serialization {
 
@@ -240,6 +247,57 @@ std::unique_ptr<InputFile> InputFile::make_mem_proxy(
     return std::make_unique<SharedMemProxyImpl>(std::move(ptr), size, writable);
 }
 
+std::unique_ptr<InputFile> InputFile::make_mmap(const char* path) {
+#ifdef WIN32
+    return make_fs(path);
+#else
+    int fd = open(path, O_RDONLY);
+    mgb_assert(fd >= 0, "failed to open %s: %s", path, strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st)) {
+        auto err = errno;
+        close(fd);
+        mgb_throw(MegBrainError, "failed to stat %s: %s", path, strerror(err));
+    }
+    size_t size = st.st_size;
+    if (size && CompNode::get_cpu_huge_page_size()) {
+        // read into the huge pages of the cpu memory rather than map the page
+        // cache, see CompNode::set_cpu_huge_page_size()
+        auto cn = CompNode::default_cpu();
+        std::shared_ptr<void> refhold{
+                cn.alloc_host(size), [cn](void* p) { cn.free_host(p); }};
+        auto dst = static_cast<uint8_t*>(refhold.get());
+        size_t offset = 0;
+        while (offset < size) {
+            auto nr = ::read(fd, dst + offset, size - offset);
+            if (nr <= 0) {
+                auto err = nr ? errno : EIO;
+                close(fd);
+                mgb_throw(
+                        MegBrainError, "failed to read %s: %s", path, strerror(err));
+            }
+            offset += nr;
+        }
+        close(fd);
+        return make_mem_proxy(std::move(refhold), size, false);
+    }
+    void* ptr = MAP_FAILED;
+    int err = 0;
+    if (size) {
+        // writable private mapping, so loaded tensors can be modified
+        // without affecting the file or other processes
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        err = errno;
+    }
+    // the mapping holds its own reference to the file
+    close(fd);
+    mgb_assert(size, "empty file: %s", path);
+    mgb_assert(ptr != MAP_FAILED, "failed to mmap %s: %s", path, strerror(err));
+    std::shared_ptr<void> refhold{ptr, [size](void* p) { munmap(p, size); }};
+    return make_mem_proxy(std::move(refhold), size, false);
+#endif
+}
+
 class OutputFile::VectorProxyImpl final : public OutputFile {
     std::vector<uint8_t>* const m_buf;
     size_t m_offset;
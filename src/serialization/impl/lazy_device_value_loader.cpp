@@ -0,0 +1,132 @@
+/**
+ * \file src/serialization/impl/lazy_device_value_loader.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lazy_device_value_loader.h"
+#include "batched_device_value_loader.h"
+
+#include "megbrain/opr/io.h"
+#include "megbrain/serialization/file.h"
+
+using namespace mgb;
+using namespace serialization;
+
+MGB_TYPEINFO_OBJ_IMPL(LazyDeviceValueLoader);
+
+LazyDeviceValueLoader::LazyDeviceValueLoader(ComputingGraph* graph) : m_graph{graph} {
+    using namespace std::placeholders;
+    graph->event().register_receiver_permanent<cg::event::CompSeqOrderDetermined>(
+            std::bind(&LazyDeviceValueLoader::on_comp_seq_order_determined, this, _1));
+}
+
+LazyDeviceValueLoader* LazyDeviceValueLoader::get(ComputingGraph* graph) {
+    auto maker = [graph]() { return std::make_shared<LazyDeviceValueLoader>(graph); };
+    return graph->options().user_data.get_user_data_or_create<LazyDeviceValueLoader>(
+            maker);
+}
+
+LazyDeviceValueLoader* LazyDeviceValueLoader::try_get(ComputingGraph* graph) {
+    auto container = graph->options().user_data.get_user_data<LazyDeviceValueLoader>();
+    mgb_assert(container.second <= 1);
+    return container.second ? container.first[0] : nullptr;
+}
+
+LazyDeviceValueLoader::ValuePtr LazyDeviceValueLoader::make(
+        CompNode comp_node, const TensorLayout& layout, Decoder decoder) {
+    auto ret = std::make_shared<Value>();
+    ret->dest = BatchedDeviceValueLoader::make_placeholder(comp_node, layout);
+    ret->layout = layout;
+    ret->decoder = std::move(decoder);
+    return ret;
+}
+
+void LazyDeviceValueLoader::materialize(const std::vector<ValuePtr>& values) {
+    BatchedDeviceValueLoader loader;
+    size_t nr_loaded = 0, tot_size = 0;
+    for (auto&& i : values) {
+        if (!i->decoder) {
+            continue;
+        }
+        HostTensorND hv{CompNode::default_cpu()};
+        hv.dtype(i->layout.dtype).resize(i->layout);
+        i->decoder(hv);
+        i->decoder = {};
+        loader.add(i->dest, std::move(hv));
+        ++nr_loaded;
+        tot_size += i->layout.span().dist_byte();
+    }
+    if (nr_loaded) {
+        loader.apply();
+        mgb_log_debug(
+                "lazily loaded %zu device values (%.2fMiB)", nr_loaded,
+                tot_size / 1024.0 / 1024);
+    }
+}
+
+void LazyDeviceValueLoader::add(ValuePtr value) {
+    if (!value->decoder) {
+        return;
+    }
+    auto key = value->dest.get();
+    m_values[key] = std::move(value);
+}
+
+void LazyDeviceValueLoader::materialize_all() {
+    std::vector<ValuePtr> values;
+    values.reserve(m_values.size());
+    for (auto&& i : m_values) {
+        values.push_back(i.second);
+    }
+    m_values.clear();
+    materialize(values);
+}
+
+void LazyDeviceValueLoader::on_comp_seq_order_determined(
+        const cg::event::CompSeqOrderDetermined& ev) {
+    if (m_values.empty()) {
+        return;
+    }
+    std::vector<ValuePtr> values;
+    auto use_value = [&](const DeviceTensorND* dv) {
+        auto iter = m_values.find(dv);
+        if (iter != m_values.end()) {
+            values.push_back(std::move(iter->second));
+            m_values.erase(iter);
+        }
+    };
+    ev.exec->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+        if (opr->same_type<opr::SharedDeviceTensor>() ||
+            opr->same_type<opr::VolatileSharedDeviceTensor>()) {
+            use_value(opr->cast_final<opr::intl::SharedDeviceTensorBase>()
+                              .dev_data()
+                              .get());
+        } else if (opr->same_type<opr::MultipleDeviceTensorHolder>()) {
+            for (auto&& i : opr->cast_final<opr::MultipleDeviceTensorHolder>().values())
+                use_value(i.get());
+        } else if (opr->same_type<opr::MultipleDeviceTensorWithFormatHolder>()) {
+            for (auto&& i :
+                 opr->cast_final<opr::MultipleDeviceTensorWithFormatHolder>().values())
+                use_value(i.get());
+        }
+        return true;
+    });
+    if (values.empty()) {
+        return;
+    }
+    mgb_throw_if(
+            m_graph->options().allocate_static_mem_after_graph_compile,
+            SerializationError,
+            "lazily loaded device values can not be used with "
+            "allocate_static_mem_after_graph_compile, since memory is "
+            "allocated before the values are loaded");
+    materialize(values);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,82 @@
+/**
+ * \file src/serialization/impl/lazy_device_value_loader.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "megbrain/graph.h"
+#include "megbrain/graph/event.h"
+
+namespace mgb {
+namespace serialization {
+
+/*!
+ * \brief defer loading values of shared tensors on non-CPU devices until
+ *      they are needed by a compiled computing sequence
+ *
+ * An instance is attached to each computing graph as user data. When a
+ * computing sequence is compiled, the pending values used by its
+ * SharedDeviceTensor and MultipleDeviceTensorHolder oprs are decoded and
+ * copied to device in a single batch, so params only used by outputs that
+ * are never compiled do not occupy device memory.
+ */
+class LazyDeviceValueLoader final : public UserDataContainer::UserData {
+    MGB_TYPEINFO_OBJ_DECL;
+
+public:
+    using Decoder = thin_function<void(HostTensorND& dest)>;
+
+    //! a device tensor whose value may have not been loaded yet
+    struct Value {
+        //! placeholder that would be filled in place
+        std::shared_ptr<DeviceTensorND> dest;
+        //! layout of the host value to be decoded
+        TensorLayout layout;
+        //! decode the host value into a CPU tensor with given layout; it is
+        //! cleared after the value is loaded
+        Decoder decoder;
+    };
+    using ValuePtr = std::shared_ptr<Value>;
+
+    explicit LazyDeviceValueLoader(ComputingGraph* graph);
+
+    //! get the loader attached to given graph, creating it if needed
+    static LazyDeviceValueLoader* get(ComputingGraph* graph);
+
+    //! get the loader attached to given graph, or nullptr if there is none
+    static LazyDeviceValueLoader* try_get(ComputingGraph* graph);
+
+    //! make a placeholder device tensor and its pending value
+    static ValuePtr make(
+            CompNode comp_node, const TensorLayout& layout, Decoder decoder);
+
+    //! load given values to device; values that have been loaded are ignored
+    static void materialize(const std::vector<ValuePtr>& values);
+
+    //! register a value to be loaded when it is used by the graph; values
+    //! that have been loaded are ignored
+    void add(ValuePtr value);
+
+    //! load all pending values of this graph
+    void materialize_all();
+
+    //! number of pending values registered in this graph
+    size_t nr_pending() const { return m_values.size(); }
+
+private:
+    ComputingGraph* const m_graph;
+    ThinHashMap<const DeviceTensorND*, ValuePtr> m_values;
+
+    void on_comp_seq_order_determined(const cg::event::CompSeqOrderDetermined& ev);
+};
+
+}  // namespace serialization
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
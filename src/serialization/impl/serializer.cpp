@@ -12,6 +12,8 @@
 #include "megbrain/serialization/serializer.h"
 #include "megbrain/opr/utility.h"
 
+#include "lazy_device_value_loader.h"
+
 namespace mgb {
 namespace serialization {
 
@@ -27,6 +29,31 @@ std::unique_ptr<cg::AsyncExecutable> GraphLoader::LoadResult::graph_compile(
     return ret;
 }
 
+std::shared_ptr<DeviceTensorND> SharedTensorValuePool::get(
+        uint64_t hash, CompNode comp_node, const TensorLayout& layout) {
+    MGB_LOCK_GUARD(m_mtx);
+    auto iter = m_values.find({hash, comp_node});
+    if (iter == m_values.end() || !iter->second->layout().eq_layout(layout))
+        return {};
+    return iter->second;
+}
+
+void SharedTensorValuePool::put(
+        uint64_t hash, const std::shared_ptr<DeviceTensorND>& value) {
+    MGB_LOCK_GUARD(m_mtx);
+    m_values.emplace(Key{hash, value->comp_node()}, value);
+}
+
+size_t SharedTensorValuePool::size() {
+    MGB_LOCK_GUARD(m_mtx);
+    return m_values.size();
+}
+
+void SharedTensorValuePool::clear() {
+    MGB_LOCK_GUARD(m_mtx);
+    m_values.clear();
+}
+
 GraphLoader::SharedTensorNameMap GraphLoader::shared_tensor_name_map() {
     SharedTensorNameMap ret;
     for (auto&& i : shared_tensor_id_map()) {
@@ -85,5 +112,15 @@ Maybe<GraphDumpFormat> GraphLoader::identify_graph_dump_format(InputFile& file)
     return {};
 }
 
+size_t GraphLoader::materialize_lazy_device_values(ComputingGraph& graph) {
+    auto loader = LazyDeviceValueLoader::try_get(&graph);
+    if (!loader) {
+        return 0;
+    }
+    auto nr = loader->nr_pending();
+    loader->materialize_all();
+    return nr;
+}
+
 }  // namespace serialization
 }  // namespace mgb
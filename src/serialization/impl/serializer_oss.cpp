@@ -23,8 +23,11 @@
 #if MGB_ENABLE_FBS_SERIALIZATION
 
 #include "batched_device_value_loader.h"
+#include "lazy_device_value_loader.h"
 
+#include "megbrain/graph/event.h"
 #include "megbrain/graph/exc_extra_info.h"
+#include "megbrain/graph/static_mem_plan.h"
 #include "megbrain/opr/io.h"
 #include "megbrain/serialization/helper.h"
 #include "megbrain/serialization/internal/flatbuffers_helper.h"
@@ -32,6 +35,8 @@
 #include "megbrain/serialization/metadata.h"
 #include "megbrain/serialization/opr_load_dump.h"
 #include "megbrain/serialization/serializer.h"
+#include "megbrain/utils/async_worker.h"
+#include "megbrain/utils/timer.h"
 #include "megbrain/version.h"
 
 #include <flatbuffers/flatbuffers.h>
@@ -79,6 +84,28 @@ void check_tensor_value_valid(const std::string& name, const HostTensorND& tenso
     }
 }
 
+//! content hash of a shared tensor value, see dedup_shared_tensor_value
+uint64_t hash_tensor_value(const HostTensorND& tensor) {
+    auto&& layout = tensor.layout();
+    auto dtype = static_cast<uint32_t>(layout.dtype.enumv());
+    XXHash hasher;
+    hasher.update(&dtype, sizeof(dtype))
+            .update(layout.shape, sizeof(layout.shape[0]) * layout.ndim)
+            .update(tensor.raw_ptr(), layout.span().high_byte);
+    return hasher.digest();
+}
+
+bool is_same_tensor_value(const HostTensorND& a, const HostTensorND& b) {
+    return a.comp_node().to_string_logical() == b.comp_node().to_string_logical() &&
+           a.layout().eq_layout(b.layout()) &&
+           !memcmp(a.raw_ptr(), b.raw_ptr(), a.layout().span().high_byte);
+}
+
+//! checksum of the fbs::Graph buffer, see trusted_graph_checksum
+uint64_t graph_buf_checksum(const void* buf, size_t size) {
+    return XXHash{}.update(buf, size).digest();
+}
+
 }  // namespace
 
 namespace mgb {
@@ -101,6 +128,11 @@ class GraphDumperOSS final : public GraphDumper, OprDumpContextFlatBuffers {
 
     std::unordered_set<std::string> m_used_input_names, m_used_param_names;
 
+    //! dumped shared tensors (index and value) by content hash, used for
+    //! dedup_shared_tensor_value
+    ThinHashMap<uint64_t, std::vector<std::pair<size_t, HostTensorND>>>
+            m_shared_tensor_values;
+
     //! current opr to be dumped
     cg::OperatorNodeBase* m_cur_opr = nullptr;
 
@@ -112,6 +144,8 @@ class GraphDumperOSS final : public GraphDumper, OprDumpContextFlatBuffers {
 
     void init_oprs_to_dump(const SymbolVarArray& endpoints);
     flatbuffers::Offset<fbs::Metadata> build_metadata(const Metadata& metadata);
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbs::StaticMemPlan>>>
+    build_static_mem_plans(const SymbolVarArray& output_vars);
     flatbuffers::Offset<fbs::Operator> build_single_opr(
             cg::OperatorNodeBase* opr, const OprRegistry* registry);
 
@@ -289,6 +323,45 @@ flatbuffers::Offset<fbs::Operator> GraphDumperOSS::build_single_opr(
     return builder.Finish();
 }
 
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbs::StaticMemPlan>>>
+GraphDumperOSS::build_static_mem_plans(const SymbolVarArray& output_vars) {
+    cg::StaticMemPlanCache::Recorder recorder;
+    {
+        auto graph = output_vars[0].node()->owner_graph();
+        ComputingGraph::OutputSpec out_spec;
+        for (auto i : output_vars) {
+            out_spec.push_back({i, [](DeviceTensorND&) {}});
+        }
+        auto&& alloc_after_compile =
+                graph->options().allocate_static_mem_after_graph_compile;
+        auto old_value = alloc_after_compile;
+        alloc_after_compile = true;
+        MGB_TRY { graph->compile(out_spec); }
+        MGB_FINALLY({
+            alloc_after_compile = old_value;
+            graph->clear_device_memory();
+        });
+    }
+
+    std::vector<flatbuffers::Offset<fbs::StaticMemPlan>> plans;
+    ThinHashSet<uint64_t> dumped;
+    for (auto&& i : recorder.plans()) {
+        if (!dumped.insert(i.hash).second) {
+            continue;
+        }
+        std::vector<uint64_t> addr(i.addr.begin(), i.addr.end());
+        auto fb_addr = m_builder.CreateVector(addr);
+        fbs::StaticMemPlanBuilder builder(m_builder);
+        builder.add_hash(i.hash);
+        builder.add_tot_alloc(i.tot_alloc);
+        builder.add_tot_alloc_lower_bound(i.tot_alloc_lower_bound);
+        builder.add_addr(fb_addr);
+        plans.push_back(builder.Finish());
+    }
+    mgb_log_debug("embed %zu static memory plans in dumped graph", plans.size());
+    return m_builder.CreateVector(plans);
+}
+
 GraphDumper::DumpResult GraphDumperOSS::dump(
         const SymbolVarArray& output_vars, const DumpConfig& config,
         const Metadata& metadata) {
@@ -302,6 +375,7 @@ GraphDumper::DumpResult GraphDumperOSS::dump(
     m_cur_rst = {};
     m_used_input_names.clear();
     m_used_param_names.clear();
+    m_shared_tensor_values.clear();
     m_nr_shared_tensor = 0;
 
     // process output vars
@@ -354,6 +428,13 @@ GraphDumper::DumpResult GraphDumperOSS::dump(
     content_hash.update(m_builder.GetCurrentBufferPointer(), m_builder.GetSize());
     auto graph_hash = content_hash.digest();
 
+    // built after computing the hash so it does not affect graph identity
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbs::StaticMemPlan>>>
+            fb_static_mem_plans;
+    if (m_config.static_mem_plan) {
+        fb_static_mem_plans = build_static_mem_plans(output_vars);
+    }
+
     fbs::GraphBuilder graph(m_builder);
     graph.add_mgb_version(MGB_VERSION);
     graph.add_hash(graph_hash);
@@ -361,6 +442,9 @@ GraphDumper::DumpResult GraphDumperOSS::dump(
     graph.add_output_vars_idx(fb_output_vars);
     graph.add_nr_shared_tensor(m_nr_shared_tensor);
     graph.add_metadata(fbmeta);
+    if (m_config.static_mem_plan) {
+        graph.add_static_mem_plans(fb_static_mem_plans);
+    }
     m_builder.FinishSizePrefixed(graph.Finish(), fbs::GraphIdentifier());
 
     // Write actual offset_to_fbs
@@ -373,6 +457,9 @@ GraphDumper::DumpResult GraphDumperOSS::dump(
 
     // Write serialized fbs::Graph
     m_file->write(m_builder.GetBufferPointer(), m_builder.GetSize());
+    m_cur_rst.graph_checksum = graph_buf_checksum(
+            m_builder.GetBufferPointer() + sizeof(uint32_t),
+            m_builder.GetSize() - sizeof(uint32_t));
 
     // Finalize DumpResult
     auto&& ret = m_cur_rst;
@@ -422,13 +509,45 @@ void GraphDumperOSS::dump_tensor(
             break;
     }
 
-    size_t value_size = 0;
+    uint32_t value_ref = 0;
+    uint64_t value_hash = 0;
+    if (method == Meth::VALUE_SHARED && m_config.dedup_shared_tensor_value) {
+        value_hash = hash_tensor_value(tensor);
+        auto&& same_hash = m_shared_tensor_values[value_hash];
+        for (auto&& i : same_hash) {
+            if (is_same_tensor_value(i.second, tensor)) {
+                value_ref = i.first + 1;
+                break;
+            }
+        }
+        if (value_ref) {
+            has_value = false;
+        } else {
+            same_hash.emplace_back(m_nr_shared_tensor - 1, tensor);
+        }
+    }
+
+    size_t value_size = 0, value_offset = 0;
+    auto compression = TensorValueCompression::NONE;
     if (has_value) {
         check_tensor_value_valid(name, tensor);
         auto begin = m_file->tell();
+        if (auto align = m_config.tensor_value_alignment) {
+            mgb_assert(
+                    !(align & (align - 1)),
+                    "tensor value alignment must be power of 2, got %zu", align);
+            value_offset = (align - begin % align) % align;
+            if (value_offset) {
+                std::vector<uint8_t> padding(value_offset);
+                m_file->write(padding.data(), value_offset);
+            }
+        }
         auto&& dumper = m_config.tensor_value_dumper;
         if (dumper) {
             dumper(*m_file, *m_cur_opr, tensor);
+        } else if (m_config.tensor_value_compression != TensorValueCompression::NONE) {
+            compression = m_config.tensor_value_compression;
+            compress_tensor_value(*m_file, tensor, compression);
         } else {
             m_file->write(tensor.raw_ptr(), tensor.layout().span().high_byte);
         }
@@ -443,8 +562,9 @@ void GraphDumperOSS::dump_tensor(
             m_builder,
             m_builder.CreateSharedString(tensor.comp_node().to_string_logical()));
     auto dtype = build_dtype(tensor.dtype());
-    auto serialized_tensor =
-            fbs::CreateTensor(m_builder, fbname, shape, comp_node, dtype, value_size);
+    auto serialized_tensor = fbs::CreateTensor(
+            m_builder, fbname, shape, comp_node, dtype, value_size, value_offset,
+            static_cast<fbs::TensorCompression>(compression), value_ref, value_hash);
     m_cur_opr_tensor.emplace_back(serialized_tensor);
 }
 
@@ -462,6 +582,8 @@ class GraphLoaderOSS final : public GraphLoader {
     SharedBuffer m_graph_buf{{}, 0};
     const fbs::Graph* m_graph;
     SharedTensorIDMap m_shared_tensor_map;
+    //! placeholders in m_shared_tensor_map whose values are lazily loaded
+    ThinHashMap<const DeviceTensorND*, LazyDeviceValueLoader::ValuePtr> m_lazy_values;
     uint32_t m_mgb_version = 0;
     uint64_t m_graph_hash = 0;
 
@@ -496,7 +618,13 @@ class GraphLoaderOSS::OprLoadContextImpl final : public OprLoadContextFlatBuffer
     LoadResult::TensorMap m_tensor_map;
     VarNodeArray m_id2varnode;
     BatchedDeviceValueLoader m_device_value_loader;
+    //! workers to decode values of shared tensors on non-CPU devices; only
+    //! created if parallel decoding is enabled
+    std::unique_ptr<FutureThreadPool<void>> m_decode_workers;
+    std::vector<FutureThreadPool<void>::Future> m_decode_futures;
     const fbs::Operator* m_current_opr;
+    //! time of reading and decoding tensor values on the loading thread
+    double m_tensor_decode_ms = 0;
     size_t m_cur_opr_tensor_cnt;
     size_t m_cur_opr_blob_cnt;
     size_t m_cur_opr_param_cnt;
@@ -507,9 +635,24 @@ class GraphLoaderOSS::OprLoadContextImpl final : public OprLoadContextFlatBuffer
         return *m_loader->m_cur_load_config;
     }
 
+    /*!
+     * \brief read a tensor value stored in \p data_size bytes from \p file,
+     *      starting at \p offset bytes after current position
+     *
+     * This only accesses \p file and \p dest, so it can be called from
+     * worker threads.
+     */
+    static void decode_tensor_value(
+            const GraphLoadConfig::TensorValueLoader& loader, InputFile& file,
+            HostTensorND* dest, const TensorLayout& layout, size_t offset,
+            size_t data_size, TensorValueCompression compression);
+
     void load_tensor_value(
             HostTensorND* dest, const TensorLayout& layout, const fbs::Tensor* tensor);
 
+    //! wait for all launched decoding tasks to finish
+    void wait_decode_tasks();
+
     std::shared_ptr<HostTensorND> load_tensor() override;
 
     std::shared_ptr<DeviceTensorND> load_tensor_shared() override;
@@ -530,6 +673,13 @@ public:
         auto got = m_graph->options().user_data.get_user_data_or_create<OprLoadContext>(
                 maker);
         mgb_assert(got == this);
+
+        auto concurrency = loader->m_cur_load_config->tensor_decode_concurrency;
+        if (concurrency > 1) {
+            m_decode_workers = std::make_unique<FutureThreadPool<void>>(
+                    std::string{"tensor_decode"});
+            m_decode_workers->start(concurrency);
+        }
     }
 
     ~OprLoadContextImpl() noexcept {
@@ -608,45 +758,70 @@ TensorLayout load_tensor_layout(const fbs::Tensor* tensor) {
     return layout;
 }
 
-void GraphLoaderOSS::OprLoadContextImpl::load_tensor_value(
-        HostTensorND* dest, const TensorLayout& layout, const fbs::Tensor* tensor) {
-    auto&& loader = m_loader->m_cur_load_config->tensor_value_loader;
-    auto&& file = m_loader->m_file;
-    auto begin_pos = file->tell();
-    file->skip(tensor->offset());
-    if (loader) {
+void GraphLoaderOSS::OprLoadContextImpl::decode_tensor_value(
+        const GraphLoadConfig::TensorValueLoader& loader, InputFile& file,
+        HostTensorND* dest, const TensorLayout& layout, size_t offset,
+        size_t data_size, TensorValueCompression compression) {
+    auto begin_pos = file.tell();
+    file.skip(offset);
+    if (compression != TensorValueCompression::NONE) {
+        if (dest) {
+            dest->dtype(layout.dtype).resize(layout);
+            decompress_tensor_value(dest->raw_ptr(), layout, file, compression);
+        } else {
+            file.skip(data_size - offset);
+        }
+    } else if (loader) {
         // call custom loader
         void* dest_ptr = nullptr;
         if (dest) {
             dest->dtype(layout.dtype).resize(layout);
             dest_ptr = dest->raw_ptr();
         }
-        loader(dest_ptr, layout, *file);
+        loader(dest_ptr, layout, file);
     } else {
         if (dest) {
-            file->read_into_tensor(*dest, layout);
+            file.read_into_tensor(*dest, layout);
         } else {
-            file->skip(layout.span().high_byte);
+            file.skip(layout.span().high_byte);
         }
     }
     mgb_throw_if(
-            file->tell() < begin_pos, SerializationError,
+            file.tell() < begin_pos, SerializationError,
             "Custom tensor value loader accessed out of range data before "
             "start of data blob");
-    auto data_size = tensor->data_size();
-    auto consumed_size = file->tell() - begin_pos;
+    auto consumed_size = file.tell() - begin_pos;
     mgb_throw_if(
             consumed_size > data_size, SerializationError,
             "Custom tensor value loader consumed more data than "
-            "available: consumed %lu, has %u",
+            "available: consumed %zu, has %zu",
             consumed_size, data_size);
     if (consumed_size < data_size) {
         mgb_log_warn(
                 "Tensor value loader consumed less data than available: "
-                "consumed %lu bytes, has %u bytes",
+                "consumed %zu bytes, has %zu bytes",
                 consumed_size, data_size);
-        file->skip(data_size - consumed_size);
+        file.skip(data_size - consumed_size);
+    }
+}
+
+void GraphLoaderOSS::OprLoadContextImpl::load_tensor_value(
+        HostTensorND* dest, const TensorLayout& layout, const fbs::Tensor* tensor) {
+    RealTimer timer;
+    decode_tensor_value(
+            m_loader->m_cur_load_config->tensor_value_loader, *m_loader->m_file, dest,
+            layout, tensor->offset(), tensor->data_size(),
+            static_cast<TensorValueCompression>(tensor->compression()));
+    m_tensor_decode_ms += timer.get_msecs();
+}
+
+void GraphLoaderOSS::OprLoadContextImpl::wait_decode_tasks() {
+    RealTimer timer;
+    for (auto&& i : m_decode_futures) {
+        i.get();
     }
+    m_decode_futures.clear();
+    m_tensor_decode_ms += timer.get_msecs();
 }
 
 std::shared_ptr<HostTensorND> GraphLoaderOSS::OprLoadContextImpl::load_tensor() {
@@ -678,12 +853,52 @@ std::shared_ptr<DeviceTensorND> GraphLoaderOSS::OprLoadContextImpl::
     auto tensor = m_current_opr->tensors()->Get(m_cur_opr_tensor_cnt++);
     auto comp_node = load_comp_node(tensor->comp_node());
     auto layout = load_tensor_layout(tensor);
-    mgb_assert(tensor->data_size());
     auto&& sh_reg = m_loader->m_shared_tensor_map.at(m_cur_shared_tensor_idx++);
     auto&& sh_ptr_ref = sh_reg.second[comp_node.mem_node()];
+    if (tensor->name()) {
+        sh_reg.first = tensor->name()->str();
+    }
+    if (auto ref = tensor->value_ref()) {
+        // value deduplicated at dump time; share the tensor it refers to
+        mgb_assert(ref < m_cur_shared_tensor_idx && !tensor->data_size());
+        auto&& src = m_loader->m_shared_tensor_map.at(ref - 1).second.at(
+                comp_node.mem_node());
+        mgb_assert(src && src->layout().eq_layout(layout));
+        sh_ptr_ref = src;
+        if (src->comp_node() == comp_node)
+            return src;
+        auto lazy = m_loader->m_lazy_values.find(src.get());
+        if (lazy != m_loader->m_lazy_values.end()) {
+            // the value must be ready before it is shared
+            LazyDeviceValueLoader::materialize({lazy->second});
+        }
+        auto ret = std::make_shared<DeviceTensorND>(*src);
+        ret->comp_node(comp_node);
+        return ret;
+    }
+    mgb_assert(tensor->data_size());
+    auto&& pool = config().shared_tensor_value_pool;
+    if (!sh_ptr_ref && pool && tensor->value_hash()) {
+        if (auto value = pool->get(tensor->value_hash(), comp_node, layout)) {
+            // identical value loaded by another graph
+            load_tensor_value(nullptr, layout, tensor);
+            sh_ptr_ref = value;
+            return value;
+        }
+    }
     if (sh_ptr_ref) {
         // cached tensor value is valid so we can reuse it
         load_tensor_value(nullptr, layout, tensor);
+        auto lazy = m_loader->m_lazy_values.find(sh_ptr_ref.get());
+        if (lazy != m_loader->m_lazy_values.end()) {
+            if (config().lazy_load_device_value &&
+                sh_ptr_ref->comp_node() == comp_node) {
+                LazyDeviceValueLoader::get(m_graph.get())->add(lazy->second);
+            } else {
+                // the value must be ready before it is shared
+                LazyDeviceValueLoader::materialize({lazy->second});
+            }
+        }
         if (sh_ptr_ref->comp_node() == comp_node)
             return sh_ptr_ref;
         // same mem node but different comp node, change comp node and share
@@ -692,9 +907,6 @@ std::shared_ptr<DeviceTensorND> GraphLoaderOSS::OprLoadContextImpl::
         ret->comp_node(comp_node);
         return ret;
     }
-    if (tensor->name()) {
-        sh_reg.first = tensor->name()->str();
-    }
 
     if (comp_node.mem_node() == CompNode::default_cpu().mem_node()) {
         // directly forward CPU memory
@@ -702,11 +914,56 @@ std::shared_ptr<DeviceTensorND> GraphLoaderOSS::OprLoadContextImpl::
         load_tensor_value(&hv, layout, tensor);
         sh_ptr_ref = std::make_shared<DeviceTensorND>();
         *sh_ptr_ref = DeviceTensorND::make_proxy(hv);
+    } else if (config().lazy_load_device_value) {
+        // keep the raw blob and decode it when the value is used
+        auto blob = m_loader->m_file->read_shared(tensor->data_size());
+        auto decoder = [loader = config().tensor_value_loader, layout, blob,
+                        offset = tensor->offset(),
+                        compression = static_cast<TensorValueCompression>(
+                                tensor->compression())](HostTensorND& dest) {
+            auto fin = InputFile::make_mem_proxy(blob.data(), blob.size());
+            decode_tensor_value(
+                    loader, *fin, &dest, layout, offset, blob.size(), compression);
+        };
+        auto value = LazyDeviceValueLoader::make(comp_node, layout, decoder);
+        LazyDeviceValueLoader::get(m_graph.get())->add(value);
+        m_loader->m_lazy_values[value->dest.get()] = value;
+        sh_ptr_ref = value->dest;
     } else {
         // use lazy load for non-CPU devices
         HostTensorND hv{CompNode::default_cpu()};
-        load_tensor_value(&hv, layout, tensor);
+        if (m_decode_workers) {
+            // only read the raw blob here (which is zero-copy for memory
+            // backed files) and decode it on the workers while remaining oprs
+            // are being loaded
+            hv.dtype(layout.dtype).resize(layout);
+            auto blob = m_loader->m_file->read_shared(tensor->data_size());
+            auto task = [&loader = config().tensor_value_loader, hv, layout, blob,
+                         offset = tensor->offset(),
+                         compression = static_cast<TensorValueCompression>(
+                                 tensor->compression())]() mutable {
+                auto fin = InputFile::make_mem_proxy(blob.data(), blob.size());
+                decode_tensor_value(
+                        loader, *fin, &hv, layout, offset, blob.size(), compression);
+            };
+            m_decode_futures.emplace_back(m_decode_workers->launch(std::move(task)));
+        } else {
+            load_tensor_value(&hv, layout, tensor);
+        }
         sh_ptr_ref = m_device_value_loader.make(comp_node, std::move(hv));
+
+        auto chunk_size = config().device_value_copy_chunk_size;
+        if (chunk_size && m_device_value_loader.pending_size(comp_node) >= chunk_size) {
+            // start copying to device while loading remaining oprs
+            wait_decode_tasks();
+            RealTimer timer;
+            m_device_value_loader.flush(comp_node);
+            m_tensor_decode_ms += timer.get_msecs();
+        }
+    }
+    if (pool && tensor->value_hash() &&
+        !m_loader->m_lazy_values.count(sh_ptr_ref.get())) {
+        pool->put(tensor->value_hash(), sh_ptr_ref);
     }
     return sh_ptr_ref;
 }
@@ -799,6 +1056,7 @@ void GraphLoaderOSS::OprLoadContextImpl::load_single_opr(const fbs::Operator* fb
 }
 
 GraphLoader::LoadResult GraphLoaderOSS::OprLoadContextImpl::load_oprs() {
+    RealTimer timer;
     // load oprs
     const auto* oprs = m_loader->m_graph->oprs();
     {
@@ -813,7 +1071,16 @@ GraphLoader::LoadResult GraphLoaderOSS::OprLoadContextImpl::load_oprs() {
     }
 
     // batched loading device values
-    m_device_value_loader.apply();
+    wait_decode_tasks();
+    {
+        RealTimer apply_timer;
+        m_device_value_loader.apply();
+        m_tensor_decode_ms += apply_timer.get_msecs();
+    }
+    m_graph->event().signal_inplace<cg::event::StartupPhaseFinished>(
+            "load.tensor_decode", "", m_tensor_decode_ms);
+    m_graph->event().signal_inplace<cg::event::StartupPhaseFinished>(
+            "load.opr", "", timer.get_msecs() - m_tensor_decode_ms);
 
     LoadResult ret;
     ret.graph = m_graph;
@@ -834,6 +1101,7 @@ GraphLoader::LoadResult GraphLoaderOSS::OprLoadContextImpl::load_oprs() {
 
 GraphLoader::LoadResult GraphLoaderOSS::load(const LoadConfig& config, bool rewind) {
     mgb_assert(m_file);
+    RealTimer timer;
     m_cur_load_config = &config;
     if (rewind) {
         m_file->rewind();
@@ -866,7 +1134,17 @@ GraphLoader::LoadResult GraphLoaderOSS::load(const LoadConfig& config, bool rewi
             !fbs::GraphBufferHasIdentifier(m_graph_buf.data()), SerializationError,
             "invalid fbs model");
 
-    {
+    bool trusted = false;
+    if (auto checksum = config.trusted_graph_checksum) {
+        trusted = graph_buf_checksum(m_graph_buf.data(), m_graph_buf.size()) ==
+                  checksum;
+        if (!trusted) {
+            mgb_log_warn(
+                    "graph checksum mismatch with trusted_graph_checksum, "
+                    "verifying the model");
+        }
+    }
+    if (!trusted) {
         flatbuffers::Verifier verifier(
                 static_cast<const uint8_t*>(m_graph_buf.data()), m_graph_buf.size());
         mgb_throw_if(
@@ -904,10 +1182,32 @@ GraphLoader::LoadResult GraphLoaderOSS::load(const LoadConfig& config, bool rewi
         mgb_assert(m_shared_tensor_map.size() == m_graph->nr_shared_tensor());
     }
 
+    if (auto fbplans = m_graph->static_mem_plans()) {
+        auto&& cache = cg::StaticMemPlanCache::inst();
+        for (auto fbplan : *fbplans) {
+            cg::StaticMemPlanCache::Plan plan;
+            plan.hash = fbplan->hash();
+            plan.tot_alloc = fbplan->tot_alloc();
+            plan.tot_alloc_lower_bound = fbplan->tot_alloc_lower_bound();
+            if (auto addr = fbplan->addr()) {
+                plan.addr.assign(addr->begin(), addr->end());
+            }
+            cache.put(plan, false);
+        }
+    }
+
+    auto parse_ms = timer.get_msecs();
     OprLoadContextImpl ctx{this, m_graph->mgb_version()};
     auto metadata = ctx.load_metadata();
+    Maybe<cg::OprMemArenaScope> opr_mem_arena;
+    if (config.opr_mem_arena) {
+        opr_mem_arena.emplace();
+    }
     auto result = ctx.load_oprs();
+    opr_mem_arena.invalidate();
     result.metadata = metadata;
+    result.graph->event().signal_inplace<cg::event::StartupPhaseFinished>(
+            "load.parse", "", parse_ms);
 
     auto fbs_end = tensor_begin + offset_to_fbs + sizeof(size) + size;
     auto cur = m_file->tell();
@@ -0,0 +1,252 @@
+/**
+ * \file src/serialization/impl/tensor_compression.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/serialization/tensor_compression.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace mgb;
+using namespace serialization;
+
+namespace {
+
+/*
+ * Each chunk is stored as (raw_size:uint32, stored_size:uint32, data). If
+ * stored_size equals raw_size, data is stored without LZ compression.
+ *
+ * The LZ stream is a sequence of (token, literals, offset, match) tuples
+ * similar to the LZ4 block format: the high and low 4 bits of the token are
+ * the number of literals and the match length minus LZ_MIN_MATCH, with 15
+ * meaning extra length bytes follow; offset is a little-endian uint16. The
+ * last tuple only contains literals.
+ */
+constexpr size_t LZ_MIN_MATCH = 4, LZ_MAX_OFFSET = 65535, LZ_HASH_LOG = 14;
+constexpr uint32_t LZ_HASH_EMPTY = ~uint32_t(0);
+
+uint32_t read_u32(const uint8_t* ptr) {
+    uint32_t ret;
+    memcpy(&ret, ptr, sizeof(ret));
+    return ret;
+}
+
+void lz_write_length(std::vector<uint8_t>& dst, size_t len) {
+    for (; len >= 255; len -= 255) {
+        dst.push_back(255);
+    }
+    dst.push_back(len);
+}
+
+void lz_emit(
+        std::vector<uint8_t>& dst, const uint8_t* literal, size_t nr_literal,
+        size_t offset, size_t match_len) {
+    size_t extra_match = match_len ? match_len - LZ_MIN_MATCH : 0;
+    dst.push_back(
+            (std::min<size_t>(nr_literal, 15) << 4) |
+            std::min<size_t>(extra_match, 15));
+    if (nr_literal >= 15) {
+        lz_write_length(dst, nr_literal - 15);
+    }
+    dst.insert(dst.end(), literal, literal + nr_literal);
+    if (match_len) {
+        dst.push_back(offset & 0xFF);
+        dst.push_back(offset >> 8);
+        if (extra_match >= 15) {
+            lz_write_length(dst, extra_match - 15);
+        }
+    }
+}
+
+void lz_compress(
+        const uint8_t* src, size_t size, std::vector<uint8_t>& dst,
+        std::vector<uint32_t>& hash_table) {
+    dst.clear();
+    hash_table.assign(1 << LZ_HASH_LOG, LZ_HASH_EMPTY);
+    size_t pos = 0, anchor = 0;
+    while (pos + LZ_MIN_MATCH <= size) {
+        auto seq = read_u32(src + pos);
+        auto&& slot = hash_table[(seq * 2654435761u) >> (32 - LZ_HASH_LOG)];
+        size_t ref = slot;
+        slot = pos;
+        if (ref != LZ_HASH_EMPTY && pos - ref <= LZ_MAX_OFFSET &&
+            read_u32(src + ref) == seq) {
+            size_t len = LZ_MIN_MATCH;
+            while (pos + len < size && src[ref + len] == src[pos + len]) {
+                ++len;
+            }
+            lz_emit(dst, src + anchor, pos - anchor, pos - ref, len);
+            pos += len;
+            anchor = pos;
+        } else {
+            ++pos;
+        }
+    }
+    lz_emit(dst, src + anchor, size - anchor, 0, 0);
+}
+
+void lz_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size) {
+    auto check = [](bool cond) {
+        mgb_throw_if(
+                !cond, SerializationError, "corrupted compressed tensor value");
+    };
+    size_t ipos = 0, opos = 0;
+    auto read_length = [&](size_t len) {
+        if (len == 15) {
+            uint8_t byte;
+            do {
+                check(ipos < src_size);
+                byte = src[ipos++];
+                len += byte;
+            } while (byte == 255);
+        }
+        return len;
+    };
+    for (;;) {
+        check(ipos < src_size);
+        auto token = src[ipos++];
+        auto nr_literal = read_length(token >> 4);
+        check(nr_literal <= src_size - ipos && nr_literal <= dst_size - opos);
+        memcpy(dst + opos, src + ipos, nr_literal);
+        ipos += nr_literal;
+        opos += nr_literal;
+        if (ipos == src_size) {
+            break;
+        }
+
+        check(src_size - ipos >= 2);
+        size_t offset = src[ipos] | (src[ipos + 1] << 8);
+        ipos += 2;
+        auto len = read_length(token & 15) + LZ_MIN_MATCH;
+        check(offset && offset <= opos && len <= dst_size - opos);
+        // the match may overlap with itself, so copy byte by byte
+        auto dptr = dst + opos, sptr = dptr - offset;
+        for (size_t i = 0; i < len; ++i) {
+            dptr[i] = sptr[i];
+        }
+        opos += len;
+    }
+    check(opos == dst_size);
+}
+
+size_t shuffle_elem_size(DType dtype) {
+    return dtype.is_low_bit() ? 1 : dtype.size();
+}
+
+//! whether a chunk of \p size bytes is shuffled into byte planes
+bool chunk_shuffled(TensorValueCompression method, size_t elem_size, size_t size) {
+    return method == TensorValueCompression::SHUFFLE_LZ && elem_size > 1 &&
+           size % elem_size == 0;
+}
+
+void shuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size) {
+    size_t nr_elem = size / elem_size;
+    for (size_t i = 0; i < nr_elem; ++i) {
+        for (size_t j = 0; j < elem_size; ++j) {
+            dst[j * nr_elem + i] = src[i * elem_size + j];
+        }
+    }
+}
+
+void unshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size) {
+    size_t nr_elem = size / elem_size;
+    for (size_t j = 0; j < elem_size; ++j) {
+        for (size_t i = 0; i < nr_elem; ++i) {
+            dst[i * elem_size + j] = src[j * nr_elem + i];
+        }
+    }
+}
+
+}  // anonymous namespace
+
+size_t serialization::compress_tensor_value(
+        OutputFile& fout, const HostTensorND& tensor, TensorValueCompression method,
+        size_t chunk_size) {
+    mgb_assert(
+            method == TensorValueCompression::LZ ||
+                    method == TensorValueCompression::SHUFFLE_LZ,
+            "invalid tensor compression method: %d", static_cast<int>(method));
+    auto ptr = reinterpret_cast<const uint8_t*>(tensor.raw_ptr());
+    auto size = tensor.layout().span().high_byte;
+    auto elem_size = shuffle_elem_size(tensor.dtype());
+    chunk_size = std::max(chunk_size / elem_size, size_t(1)) * elem_size;
+    mgb_assert(chunk_size <= std::numeric_limits<uint32_t>::max());
+
+    std::vector<uint8_t> planes, compressed;
+    std::vector<uint32_t> hash_table;
+    size_t written = 0;
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+        auto raw_size = std::min(chunk_size, size - offset);
+        const uint8_t* src = ptr + offset;
+        if (chunk_shuffled(method, elem_size, raw_size)) {
+            planes.resize(raw_size);
+            shuffle(src, planes.data(), raw_size, elem_size);
+            src = planes.data();
+        }
+        lz_compress(src, raw_size, compressed, hash_table);
+        if (compressed.size() < raw_size) {
+            src = compressed.data();
+        }
+        uint32_t header[2] = {
+                static_cast<uint32_t>(raw_size),
+                static_cast<uint32_t>(std::min(compressed.size(), raw_size))};
+        fout.write(header, sizeof(header));
+        fout.write(src, header[1]);
+        written += sizeof(header) + header[1];
+    }
+    return written;
+}
+
+void serialization::decompress_tensor_value(
+        void* ptr, const TensorLayout& layout, InputFile& fin,
+        TensorValueCompression method) {
+    mgb_throw_if(
+            method != TensorValueCompression::LZ &&
+                    method != TensorValueCompression::SHUFFLE_LZ,
+            SerializationError, "unsupported tensor compression method: %d",
+            static_cast<int>(method));
+    auto dest = static_cast<uint8_t*>(ptr);
+    auto size = layout.span().high_byte;
+    auto elem_size = shuffle_elem_size(layout.dtype);
+
+    std::vector<uint8_t> planes;
+    for (size_t offset = 0; offset < size;) {
+        uint32_t header[2];
+        fin.read(header, sizeof(header));
+        size_t raw_size = header[0], stored_size = header[1];
+        mgb_throw_if(
+                !raw_size || raw_size > size - offset || stored_size > raw_size,
+                SerializationError,
+                "corrupted compressed tensor value: chunk size %zu/%zu at offset "
+                "%zu of %zu",
+                stored_size, raw_size, offset, size);
+        bool shuffled = chunk_shuffled(method, elem_size, raw_size);
+        uint8_t* chunk_dest = dest + offset;
+        if (shuffled) {
+            planes.resize(raw_size);
+            chunk_dest = planes.data();
+        }
+        if (stored_size == raw_size) {
+            fin.read(chunk_dest, raw_size);
+        } else {
+            // zero-copy for memory-backed files
+            auto buf = fin.read_shared(stored_size);
+            lz_decompress(
+                    static_cast<const uint8_t*>(buf.data()), stored_size, chunk_dest,
+                    raw_size);
+        }
+        if (shuffled) {
+            unshuffle(planes.data(), dest + offset, raw_size, elem_size);
+        }
+        offset += raw_size;
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
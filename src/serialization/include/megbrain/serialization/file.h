@@ -74,6 +74,20 @@ public:
     //! create an InputFile correspoding to a file on local file system
     static std::unique_ptr<InputFile> make_fs(const char* path);
 
+    /*!
+     * \brief create an InputFile that maps a file on local file system into
+     *      memory
+     *
+     * Aligned tensor values (see GraphDumpConfig::tensor_value_alignment)
+     * directly use the mapped pages as storage, so processes loading the
+     * same model share the page cache. Pages are mapped copy-on-write, and
+     * modifying loaded tensors would not change the file. It falls back to
+     * make_fs() if mmap is not supported on the platform. If huge pages are
+     * enabled by CompNode::set_cpu_huge_page_size(), the file is read into
+     * them instead.
+     */
+    static std::unique_ptr<InputFile> make_mmap(const char* path);
+
     //! create an InputFile correspoding to a memory region; the memory
     //! region must be alive throughout lifespan of this InputFile
     static std::unique_ptr<InputFile> make_mem_proxy(const void* ptr, size_t size);
@@ -12,9 +12,12 @@
 
 #include "megbrain/serialization/file.h"
 #include "megbrain/serialization/opr_registry.h"
+#include "megbrain/serialization/tensor_compression.h"
 
 namespace mgb {
 namespace serialization {
+class SharedTensorValuePool;
+
 //! config for dumping a whole graph; setup in GraphDumper
 struct GraphDumpConfig {
     /*!
@@ -58,6 +61,50 @@ struct GraphDumpConfig {
     //! names. this list record the mapping between output node and it's name
     std::vector<std::pair<std::string, SymbolVar>> alias_name_map;
 
+    /*!
+     * \brief whether to compile the output vars with shapes of the current
+     *      input values and embed the resulting static memory plans
+     *
+     * The loader adds the plans to cg::StaticMemPlanCache, so compiling the
+     * loaded graph with the same shapes skips static memory planning. Note
+     * that this compiles the graph the output vars belong to, which
+     * invalidates previously compiled functions on it.
+     */
+    bool static_mem_plan = false;
+
+    /*!
+     * \brief alignment in bytes of tensor values relative to the beginning of
+     *      the output file; 0 for no alignment
+     *
+     * Zero padding is written before each tensor value, so loading from a
+     * memory-mapped file (see InputFile::make_mmap()) can use the mapped
+     * pages as tensor storage directly. It must be a power of 2, and should
+     * be no less than the memory alignment of the target comp nodes.
+     */
+    size_t tensor_value_alignment = 0;
+
+    /*!
+     * \brief codec to compress tensor values that are dumped without
+     *      tensor_value_dumper
+     *
+     * The values are decompressed chunk by chunk into the destination buffer
+     * when loading, and GraphLoadConfig::tensor_value_loader is not called for
+     * them.
+     */
+    TensorValueCompression tensor_value_compression = TensorValueCompression::NONE;
+
+    /*!
+     * \brief whether to deduplicate values of shared tensors (i.e. params)
+     *
+     * A param whose dtype, layout, comp node and value are all identical to
+     * a previously dumped one refers to it instead of storing its value
+     * again, and is loaded as the same device tensor. The content hash of
+     * each param value is also recorded, so graphs loaded with the same
+     * GraphLoadConfig::shared_tensor_value_pool share identical params.
+     * Files dumped with this option can not be loaded by older versions.
+     */
+    bool dedup_shared_tensor_value = false;
+
     GraphDumpConfig(
             int keep_var_name_ = 1, bool keep_param_name_ = false,
             bool keep_opr_priority_ = false, bool keep_op_name_ = true,
@@ -132,6 +179,47 @@ struct GraphLoadConfig {
     //! GraphDumpConfig
     TensorValueLoader tensor_value_loader;
 
+    //! number of worker threads to decode values of shared tensors placed on
+    //! non-CPU devices (i.e. running tensor_value_loader, which may perform
+    //! dtype conversion or decompression); values would be decoded on the
+    //! loading thread if it is less than 2. Note that tensor_value_loader
+    //! must be thread-safe if parallel decoding is enabled
+    size_t tensor_decode_concurrency = 0;
+
+    //! if positive, values of shared tensors on each non-CPU comp node would
+    //! be copied to device asynchronously in chunks of about this many bytes,
+    //! so the copies overlap with loading remaining operators; otherwise all
+    //! values are copied in a single transaction after loading the graph
+    size_t device_value_copy_chunk_size = 0;
+
+    //! whether to defer loading values of shared tensors on non-CPU devices
+    //! until a computing sequence that uses them is compiled; the raw values
+    //! are kept on host until then, which is zero-copy if the model is loaded
+    //! from an mmapped or memory-backed InputFile. It can not be used with
+    //! allocate_static_mem_after_graph_compile, and
+    //! GraphLoader::materialize_lazy_device_values() must be called before
+    //! applying graph passes that read param values. tensor_value_loader
+    //! would be copied and invoked after load() returns
+    bool lazy_load_device_value = false;
+
+    //! if not null, values of shared tensors whose content hashes are
+    //! recorded (see GraphDumpConfig::dedup_shared_tensor_value) are looked
+    //! up in and added to this pool, so graphs loaded from different files
+    //! (e.g. fine-tuned models with a common backbone) share identical
+    //! params; values loaded lazily are not added
+    std::shared_ptr<SharedTensorValuePool> shared_tensor_value_pool;
+
+    //! if non-zero, it should be GraphDumper::DumpResult::graph_checksum of
+    //! a trusted model; the full flatbuffer verification would be skipped if
+    //! the checksum of the loaded graph structure matches it, and would still
+    //! be performed otherwise. Only used by the FLATBUFFERS format
+    uint64_t trusted_graph_checksum = 0;
+
+    //! whether to allocate loaded oprs contiguously from an arena, which is
+    //! released in bulk after all of them are destructed; see
+    //! cg::OprMemArenaScope
+    bool opr_mem_arena = false;
+
     GraphLoadConfig(
             const CompNodeMapper& comp_node_mapper_ = {},
             const OprLoaderMaker& opr_loader_maker_ = {},
@@ -19,6 +19,46 @@
 
 namespace mgb {
 namespace serialization {
+/*!
+ * \brief values of shared tensors indexed by the content hashes recorded at
+ *      dump time; see GraphLoadConfig::shared_tensor_value_pool
+ *
+ * Values are matched by hash, comp node and layout. This class is
+ * thread-safe.
+ */
+class SharedTensorValuePool final : public NonCopyableObj {
+    struct Key {
+        uint64_t hash;
+        CompNode comp_node;
+
+        bool operator==(const Key& rhs) const {
+            return hash == rhs.hash && comp_node == rhs.comp_node;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return hash_pair_combine(key.hash, mgb::hash(key.comp_node));
+        }
+    };
+
+    MGB_MUTEX m_mtx;
+    std::unordered_map<Key, std::shared_ptr<DeviceTensorND>, KeyHash> m_values;
+
+public:
+    //! get value of given hash and layout on comp node; nullptr if not found
+    std::shared_ptr<DeviceTensorND> get(
+            uint64_t hash, CompNode comp_node, const TensorLayout& layout);
+
+    //! add a value; an existing value of the same key would be kept
+    void put(uint64_t hash, const std::shared_ptr<DeviceTensorND>& value);
+
+    //! number of values in the pool
+    size_t size();
+
+    //! remove all values
+    void clear();
+};
+
 /*!
  * \brief load graph from megbrain dump file
  *
@@ -102,6 +142,14 @@ public:
 
     static Maybe<GraphDumpFormat> identify_graph_dump_format(InputFile& file);
 
+    /*!
+     * \brief load all device values in given graph that have been deferred
+     *      by GraphLoadConfig::lazy_load_device_value
+     *
+     * \return number of values that were pending in the graph
+     */
+    static size_t materialize_lazy_device_values(ComputingGraph& graph);
+
     virtual ~GraphLoader() = default;
 
     /*!
@@ -142,6 +190,10 @@ public:
 
 /*!
  * \brief dump graph into given output file
+ *
+ * Tensor values are written to the file as soon as their oprs are dumped, and
+ * only the graph structure is kept in memory until the end. The file must
+ * support seek() since the header is patched after the dump.
  */
 class GraphDumper {
 public:
@@ -156,6 +208,10 @@ public:
         //! full dump size and param value size
         size_t tot_bytes = 0, tensor_value_bytes = 0;
 
+        //! checksum of the serialized graph structure (tensor values
+        //! excluded); see GraphLoadConfig::trusted_graph_checksum
+        uint64_t graph_checksum = 0;
+
         std::vector<std::string> inputs,  //!< input tensor names
                 outputs,                  //!< output var names
                 params;                   //!< dumped param names
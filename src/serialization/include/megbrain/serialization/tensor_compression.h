@@ -0,0 +1,63 @@
+/**
+ * \file src/serialization/include/megbrain/serialization/tensor_compression.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/serialization/file.h"
+#include "megbrain/tensor.h"
+
+namespace mgb {
+namespace serialization {
+
+/*!
+ * \brief lossless codecs to compress tensor values in dumped models
+ *
+ * Values are split into chunks which are compressed independently, so they
+ * can be decompressed chunk by chunk into the destination buffer. Keep in
+ * sync with TensorCompression in schema.fbs.
+ */
+enum class TensorValueCompression : uint8_t {
+    NONE = 0,
+    //! LZ77 compression of the raw bytes
+    LZ = 1,
+    //! shuffle the bytes of each chunk into byte planes (i.e. the k-th
+    //! bytes of all elements are stored together) before LZ compression;
+    //! this usually works better for floating point values
+    SHUFFLE_LZ = 2,
+};
+
+/*!
+ * \brief compress raw value of a tensor and write it to a file
+ * \param chunk_size size of the uncompressed chunks in bytes; it would be
+ *      rounded to multiple of dtype size
+ * \return number of bytes written
+ */
+size_t compress_tensor_value(
+        OutputFile& fout, const HostTensorND& tensor, TensorValueCompression method,
+        size_t chunk_size = 64 * 1024);
+
+/*!
+ * \brief read a tensor value written by compress_tensor_value() and
+ *      decompress it into given memory
+ *
+ * Only buffers of a single chunk are allocated, so there is no buffer for
+ * the whole decompressed value.
+ *
+ * \param layout contiguous layout of the tensor
+ */
+void decompress_tensor_value(
+        void* ptr, const TensorLayout& layout, InputFile& fin,
+        TensorValueCompression method);
+
+}  // namespace serialization
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
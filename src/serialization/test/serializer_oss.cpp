@@ -10,6 +10,8 @@
  */
 #if MGB_ENABLE_FBS_SERIALIZATION
 
+#include "megbrain/gopt/inference.h"
+#include "megbrain/graph/static_mem_plan.h"
 #include "megbrain/opr/basic_arith_wrapper.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/io.h"
@@ -18,6 +20,9 @@
 #include "megbrain/serialization/serializer.h"
 #include "megbrain/test/helper.h"
 
+#include <atomic>
+#include <set>
+
 using namespace mgb;
 using namespace serialization;
 
@@ -129,6 +134,62 @@ TEST(TestSerializer2, Metadata) {
     load();
 }
 
+TEST(TestSerializer2, StaticMemPlan) {
+    auto fname = GET_OUTPUT_FILE();
+    TensorShape shape{16, 32};
+    ThinHashSet<uint64_t> dumped_plans;
+
+    auto dump = [&]() {
+        auto cn = CompNode::load("xpu0");
+        auto host_x = std::make_shared<HostTensorND>(cn, shape),
+             host_y = std::make_shared<HostTensorND>(cn, shape);
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             y = opr::Host2DeviceCopy::make(*graph, host_y, {"y"});
+        auto z = opr::exp(x + y) * y + x;
+
+        cg::StaticMemPlanCache::Recorder recorder;
+        GraphDumpConfig config;
+        config.static_mem_plan = true;
+        auto dumper = GraphDumper::make(
+                OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        dumper->dump({z.rename("z")}, config);
+        for (auto&& i : recorder.plans()) {
+            dumped_plans.insert(i.hash);
+        }
+        ASSERT_FALSE(dumped_plans.empty());
+    };
+
+    auto load = [&]() {
+        HostTensorGenerator<> gen;
+        auto loader = GraphLoader::make(
+                InputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        auto rst = loader->load();
+        auto xv = rst.tensor_map.at("x"), yv = rst.tensor_map.at("y");
+        *xv = *gen(shape);
+        *yv = *gen(shape);
+        HostTensorND host_z, host_z_expect{xv->comp_node(), shape};
+        for (size_t i = 0, it = shape.total_nr_elems(); i < it; ++i) {
+            auto x = xv->ptr<float>()[i], y = yv->ptr<float>()[i];
+            host_z_expect.ptr<float>()[i] = std::exp(x + y) * y + x;
+        }
+
+        // the loaded graph has the same allocation problem as the dumped one
+        cg::StaticMemPlanCache::Recorder recorder;
+        auto func = rst.graph_compile(
+                {make_callback_copy(rst.output_var_map.at("z"), host_z)});
+        func->execute();
+        ASSERT_FALSE(recorder.plans().empty());
+        for (auto&& i : recorder.plans()) {
+            ASSERT_TRUE(dumped_plans.count(i.hash));
+        }
+        MGB_ASSERT_TENSOR_NEAR(host_z_expect, host_z, 1e-5);
+    };
+
+    dump();
+    load();
+}
+
 TEST(TestSerializer2, APlusB) {
     auto fname = GET_OUTPUT_FILE();
     TensorShape shape{2, 3};
@@ -225,6 +286,55 @@ TEST(TestSerializer2, APlusBParam) {
     ASSERT_EQ(1u + (cns[1].mem_node() != cns[0].mem_node()), shmap.at("y")->size());
 }
 
+TEST(TestSerializer2, MmapAlignedParam) {
+    auto cn = CompNode::load("cpu0");
+    auto fname = GET_OUTPUT_FILE();
+    TensorShape shape{3, 64, 64};
+    constexpr size_t ALIGN = 4096;
+
+    HostTensorGenerator<> gen;
+    auto bias = std::make_shared<DeviceTensorND>();
+    auto bias_hv = gen(shape, cn);
+    bias->copy_from(*bias_hv);
+
+    {
+        auto host_x = std::make_shared<HostTensorND>(cn, shape);
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             y = opr::SharedDeviceTensor::make(*graph, bias, {"y"});
+
+        auto dumper = GraphDumper::make(
+                OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        GraphDumper::DumpConfig config;
+        config.keep_param_name = true;
+        config.tensor_value_alignment = ALIGN;
+        dumper->dump({(x + y).rename("z")}, config);
+    }
+
+    auto loader = GraphLoader::make(
+            InputFile::make_mmap(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+    auto rst = loader->load();
+
+    // the param should directly use the page-aligned mapped memory
+    auto&& shmap = loader->shared_tensor_name_map();
+    ASSERT_EQ(1u, shmap.at("y")->size());
+    for (auto&& i : *shmap.at("y")) {
+        auto ptr = reinterpret_cast<uintptr_t>(i.second->raw_ptr());
+        ASSERT_EQ(0u, ptr % ALIGN);
+    }
+
+    auto xv = rst.tensor_map.at("x");
+    *xv = *gen(shape, cn);
+    HostTensorND host_z, host_z_expect;
+    host_z_expect.copy_from(*xv);
+    for (size_t i = 0, it = shape.total_nr_elems(); i < it; ++i)
+        host_z_expect.ptr<float>()[i] += bias_hv->ptr<float>()[i];
+    auto func = rst.graph_compile(
+            {make_callback_copy(rst.output_var_map.at("z"), host_z)});
+    func->execute();
+    MGB_ASSERT_TENSOR_EQ(host_z_expect, host_z);
+}
+
 TEST(TestSerializer2, Immutable) {
     auto fname = GET_OUTPUT_FILE();
     TensorShape shape{2, 3};
@@ -628,6 +738,58 @@ TEST(TestSerializer2, ConstVarShapeOutputName) {
     }
 }
 
+TEST(TestSerializer2, ConstVarShapeFold) {
+    auto fname = GET_OUTPUT_FILE();
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3});
+
+    {
+        // dump
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"});
+        auto shp = opr::GetVarShape::make(x);
+        // the outputs of multi-output oprs are not folded on insertion
+        auto parts = opr::Split::make(
+                opr::Concat::make({shp, shp}, 0),
+                opr::Split::Options::make_average(0, 2));
+        auto y = opr::Reshape::make(x, parts[1]) + 1.f;
+        y.rename("out");
+        auto dumper = GraphDumper::make(
+                OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        dumper->dump({y});
+    }
+
+    auto nr_split = [](SymbolVar var) {
+        size_t ret = 0;
+        cg::DepOprIter{[&ret](cg::OperatorNodeBase* opr) {
+            ret += opr->same_type<opr::Split>();
+        }}.add(var.node()->owner_opr());
+        return ret;
+    };
+    for (bool const_shape : {false, true}) {
+        auto loader = GraphLoader::make(
+                InputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        GraphLoadConfig config;
+        config.const_var_shape = const_shape;
+        auto rst = loader->load(config);
+        rst.tensor_map.at("x")->copy_from(*host_x);
+        auto y = rst.output_var_map.at("out");
+        auto y_opt = gopt::GraphOptimizer{}
+                             .add_pass<gopt::FoldConstShapePass>()
+                             .apply({{y}})
+                             .endpoint_vars()[0];
+        ASSERT_EQ(1u, nr_split(y));
+        ASSERT_EQ(const_shape ? 0u : 1u, nr_split(y_opt));
+
+        HostTensorND host_y;
+        auto func = rst.graph_compile({make_callback_copy(y_opt, host_y)});
+        func->execute();
+        for (size_t i = 0; i < 6; ++i) {
+            ASSERT_EQ(host_x->ptr<float>()[i] + 1, host_y.ptr<float>()[i]);
+        }
+    }
+}
+
 TEST(TestSerializer2, Priority) {
     auto fname = GET_OUTPUT_FILE();
     TensorShape shape{2, 3};
@@ -716,6 +878,378 @@ TEST(TestSerializer2, MultipleParams) {
     load();
 }
 
+TEST(TestSerializer2, ParallelDecodeParams) {
+    auto fname = GET_OUTPUT_FILE();
+    HostTensorGenerator<> gen;
+    std::vector<std::shared_ptr<HostTensorND>> tensors;
+    for (size_t i = 0; i < 16; ++i) {
+        tensors.push_back(gen({i + 1, 33}, "xpu0"));
+    }
+
+    // values are stored negated, so the loader has to decode them
+    auto tensor_value_dumper = [](OutputFile& fout, const cg::OperatorNodeBase&,
+                                  const HostTensorND& tensor) {
+        auto ptr = tensor.ptr<float>();
+        for (size_t i = 0, it = tensor.shape().total_nr_elems(); i < it; ++i) {
+            float v = -ptr[i];
+            fout.write(&v, sizeof(v));
+        }
+    };
+    std::atomic_size_t nr_decode{0};
+    auto tensor_value_loader = [&nr_decode](
+                                       void* ptr, const TensorLayout& layout,
+                                       InputFile& fin) {
+        auto size = layout.span().high_byte;
+        if (!ptr) {
+            fin.skip(size);
+            return;
+        }
+        fin.read(ptr, size);
+        auto fptr = static_cast<float*>(ptr);
+        for (size_t i = 0, it = layout.total_nr_elems(); i < it; ++i) {
+            fptr[i] = -fptr[i];
+        }
+        ++nr_decode;
+    };
+
+    {
+        auto graph = ComputingGraph::make();
+        SymbolVarArray outputs;
+        for (auto&& i : tensors) {
+            outputs.push_back(opr::SharedDeviceTensor::make(*graph, *i));
+        }
+        GraphDumpConfig config;
+        config.tensor_value_dumper = tensor_value_dumper;
+        GraphDumper::make(
+                OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS)
+                ->dump(outputs, config);
+    }
+
+    auto load = [&](std::unique_ptr<InputFile> fin, size_t chunk_size) {
+        nr_decode = 0;
+        GraphLoadConfig config;
+        config.tensor_value_loader = tensor_value_loader;
+        config.tensor_decode_concurrency = 4;
+        config.device_value_copy_chunk_size = chunk_size;
+        auto rst = GraphLoader::make(std::move(fin), GraphDumpFormat::FLATBUFFERS)
+                           ->load(config);
+        ASSERT_EQ(tensors.size(), nr_decode.load());
+        ASSERT_EQ(tensors.size(), rst.output_var_list.size());
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            HostTensorND got;
+            got.copy_from(rst.output_var_list[i]
+                                  .node()
+                                  ->owner_opr()
+                                  ->cast_final_safe<opr::SharedDeviceTensor>()
+                                  .get_dev_tensor())
+                    .sync();
+            MGB_ASSERT_TENSOR_EQ(*tensors[i], got);
+        }
+    };
+
+    load(InputFile::make_fs(fname.c_str()), 0);
+    load(InputFile::make_fs(fname.c_str()), 1024);
+    load(InputFile::make_mmap(fname.c_str()), 1);
+}
+
+TEST(TestSerializer2, LazyLoadDeviceValue) {
+    auto fname = GET_OUTPUT_FILE();
+    auto cn = CompNode::load("xpu0");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3}, cn), host_w0 = gen({2, 3}, cn), host_w1 = gen({2, 3}, cn);
+
+    {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             w0 = opr::SharedDeviceTensor::make(*graph, *host_w0),
+             w1 = opr::SharedDeviceTensor::make(*graph, *host_w1);
+        GraphDumper::make(
+                OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS)
+                ->dump({(x + w0).rename("y0"), (x * w1).rename("y1")});
+    }
+
+    // lazy loading only takes effect for values on non-CPU devices
+    size_t nr_lazy = cn.mem_node() == CompNode::default_cpu().mem_node() ? 0 : 2;
+    auto loader = GraphLoader::make(
+            InputFile::make_mmap(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+    GraphLoadConfig config;
+    config.lazy_load_device_value = true;
+
+    auto check = [&](GraphLoader::LoadResult& rst, const char* name, bool add) {
+        HostTensorND host_y, host_y_expect;
+        host_y_expect.copy_from(*host_x);
+        auto px = host_x->ptr<float>(), pw0 = host_w0->ptr<float>(),
+             pw1 = host_w1->ptr<float>(), py = host_y_expect.ptr<float>();
+        for (size_t i = 0; i < 6; ++i) {
+            py[i] = add ? px[i] + pw0[i] : px[i] * pw1[i];
+        }
+        *rst.tensor_map.at("x") = *host_x;
+        auto func = rst.graph_compile(
+                {make_callback_copy(rst.output_var_map.at(name), host_y)});
+        func->execute();
+        MGB_ASSERT_TENSOR_EQ(host_y_expect, host_y);
+    };
+
+    {
+        // only the used param is loaded
+        auto rst = loader->load(config);
+        check(rst, "y0", true);
+        ASSERT_EQ(nr_lazy / 2, GraphLoader::materialize_lazy_device_values(*rst.graph));
+        ASSERT_EQ(0u, GraphLoader::materialize_lazy_device_values(*rst.graph));
+        check(rst, "y1", false);
+    }
+    {
+        // cached params are shared by the new graph
+        auto rst = loader->load(config);
+        check(rst, "y1", false);
+        check(rst, "y0", true);
+        ASSERT_EQ(0u, GraphLoader::materialize_lazy_device_values(*rst.graph));
+    }
+    {
+        auto rst = GraphLoader::make(
+                           InputFile::make_fs(fname.c_str()),
+                           GraphDumpFormat::FLATBUFFERS)
+                           ->load(config);
+        ASSERT_EQ(nr_lazy, GraphLoader::materialize_lazy_device_values(*rst.graph));
+        check(rst, "y1", false);
+        check(rst, "y0", true);
+    }
+}
+
+TEST(TestSerializer2, CompressedTensorValue) {
+    auto fname = GET_OUTPUT_FILE();
+    auto cn = CompNode::load("xpu0");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({64, 64}, cn);
+    HostTensorND host_w{cn, {64, 64}, dtype::Float32()},
+            host_b{cn, {1, 64}, dtype::Int32()};
+    for (size_t i = 0; i < 64 * 64; ++i) {
+        host_w.ptr<float>()[i] = (i % 13) / 4.f;
+    }
+    for (int i = 0; i < 64; ++i) {
+        host_b.ptr<int>()[i] = i - 32;
+    }
+
+    auto dump = [&](TensorValueCompression compression) {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             w = opr::SharedDeviceTensor::make(*graph, host_w),
+             b = opr::ImmutableTensor::make(*graph, host_b),
+             y = (x * w + opr::TypeCvt::make(b, dtype::Float32())).rename("y");
+        GraphDumpConfig config;
+        config.tensor_value_compression = compression;
+        config.tensor_value_alignment = 64;
+        auto rst = GraphDumper::make(
+                           OutputFile::make_fs(fname.c_str()),
+                           GraphDumpFormat::FLATBUFFERS)
+                           ->dump({y}, config);
+        return rst.tensor_value_bytes;
+    };
+
+    HostTensorND host_y_expect;
+    host_y_expect.copy_from(*host_x);
+    for (size_t i = 0; i < 64 * 64; ++i) {
+        host_y_expect.ptr<float>()[i] = host_x->ptr<float>()[i] *
+                                                host_w.ptr<float>()[i] +
+                                        host_b.ptr<int>()[i % 64];
+    }
+    auto load = [&](std::unique_ptr<InputFile> fin) {
+        GraphLoadConfig config;
+        // compressed values should not be passed to the value loader
+        config.tensor_value_loader = [](void*, const TensorLayout&, InputFile&) {
+            ASSERT_TRUE(false);
+        };
+        auto rst = GraphLoader::make(std::move(fin), GraphDumpFormat::FLATBUFFERS)
+                           ->load(config);
+        HostTensorND host_y;
+        *rst.tensor_map.at("x") = *host_x;
+        auto func = rst.graph_compile(
+                {make_callback_copy(rst.output_var_map.at("y"), host_y)});
+        func->execute();
+        MGB_ASSERT_TENSOR_EQ(host_y_expect, host_y);
+    };
+
+    auto raw_bytes = dump(TensorValueCompression::NONE);
+    using Method = TensorValueCompression;
+    for (auto method : {Method::LZ, Method::SHUFFLE_LZ}) {
+        ASSERT_LT(dump(method), raw_bytes / 2);
+        load(InputFile::make_fs(fname.c_str()));
+        load(InputFile::make_mmap(fname.c_str()));
+    }
+}
+
+TEST(TestSerializer2, DedupSharedTensorValue) {
+    auto fname0 = GET_OUTPUT_FILE(), fname1 = fname0 + ".1";
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3}), host_w0 = gen({2, 3}), host_w2 = gen({2, 3});
+    HostTensorND host_w1;
+    host_w1.copy_from(*host_w0);
+
+    // the two files share w0 but have different w2
+    auto dump = [&](const std::string& fname, bool dedup, float w2_scale) {
+        HostTensorND host_w2_scaled;
+        host_w2_scaled.copy_from(*host_w2);
+        for (size_t i = 0; i < 6; ++i) {
+            host_w2_scaled.ptr<float>()[i] *= w2_scale;
+        }
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             w0 = opr::SharedDeviceTensor::make(*graph, *host_w0),
+             w1 = opr::SharedDeviceTensor::make(*graph, host_w1),
+             w2 = opr::SharedDeviceTensor::make(*graph, host_w2_scaled),
+             y = (x * w0 + w1 * w2).rename("y");
+        GraphDumpConfig config;
+        config.dedup_shared_tensor_value = dedup;
+        return GraphDumper::make(
+                       OutputFile::make_fs(fname.c_str()),
+                       GraphDumpFormat::FLATBUFFERS)
+                ->dump({y}, config)
+                .tensor_value_bytes;
+    };
+
+    auto load = [&](const std::string& fname, float w2_scale,
+                    const std::shared_ptr<SharedTensorValuePool>& pool) {
+        GraphLoadConfig config;
+        config.shared_tensor_value_pool = pool;
+        auto rst = GraphLoader::make(
+                           InputFile::make_fs(fname.c_str()),
+                           GraphDumpFormat::FLATBUFFERS)
+                           ->load(config);
+        HostTensorND host_y, host_y_expect;
+        host_y_expect.copy_from(*host_x);
+        auto px = host_x->ptr<float>(), pw0 = host_w0->ptr<float>(),
+             pw2 = host_w2->ptr<float>(), py = host_y_expect.ptr<float>();
+        for (size_t i = 0; i < 6; ++i) {
+            py[i] = px[i] * pw0[i] + pw0[i] * pw2[i] * w2_scale;
+        }
+        *rst.tensor_map.at("x") = *host_x;
+        auto y = rst.output_var_map.at("y");
+        auto func = rst.graph_compile({make_callback_copy(y, host_y)});
+        func->execute();
+        MGB_ASSERT_TENSOR_EQ(host_y_expect, host_y);
+
+        std::vector<const void*> params;
+        cg::DepOprIter{[&](cg::OperatorNodeBase* opr) {
+            if (opr->same_type<opr::SharedDeviceTensor>()) {
+                params.push_back(opr->cast_final<opr::SharedDeviceTensor>()
+                                         .dev_data()
+                                         ->raw_ptr());
+            }
+        }}.add(y.node()->owner_opr());
+        EXPECT_EQ(3u, params.size());
+        return params;
+    };
+
+    size_t value_bytes = 6 * sizeof(float);
+    ASSERT_EQ(dump(fname0, false, 1.f) - value_bytes, dump(fname0, true, 1.f));
+    ASSERT_EQ(value_bytes * 2, dump(fname1, true, 2.f));
+
+    auto pool = std::make_shared<SharedTensorValuePool>();
+    auto p0 = load(fname0, 1.f, pool);
+    ASSERT_EQ(2u, std::set<const void*>(p0.begin(), p0.end()).size());
+    ASSERT_EQ(2u, pool->size());
+
+    auto p1 = load(fname1, 2.f, pool);
+    std::set<const void*> all(p0.begin(), p0.end());
+    all.insert(p1.begin(), p1.end());
+    ASSERT_EQ(3u, all.size());
+    ASSERT_EQ(3u, pool->size());
+
+    // nothing is shared without the pool
+    auto p2 = load(fname1, 2.f, {});
+    for (auto i : p2) {
+        ASSERT_EQ(0u, all.count(i));
+    }
+}
+
+TEST(TestSerializer2, TrustedGraphChecksum) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3}), host_w = gen({2, 3});
+    std::vector<uint8_t> buf;
+    uint64_t checksum;
+    {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             w = opr::SharedDeviceTensor::make(*graph, *host_w),
+             y = (x * w).rename("y");
+        auto rst = GraphDumper::make(
+                           OutputFile::make_vector_proxy(&buf),
+                           GraphDumpFormat::FLATBUFFERS)
+                           ->dump({y});
+        checksum = rst.graph_checksum;
+        ASSERT_NE(0u, checksum);
+    }
+
+    HostTensorND host_y_expect;
+    host_y_expect.copy_from(*host_x);
+    for (size_t i = 0; i < 6; ++i) {
+        host_y_expect.ptr<float>()[i] *= host_w->ptr<float>()[i];
+    }
+    auto load = [&](const std::vector<uint8_t>& data, uint64_t trusted) {
+        GraphLoadConfig config;
+        config.trusted_graph_checksum = trusted;
+        auto rst = GraphLoader::make(
+                           InputFile::make_mem_proxy(data.data(), data.size()),
+                           GraphDumpFormat::FLATBUFFERS)
+                           ->load(config);
+        HostTensorND host_y;
+        *rst.tensor_map.at("x") = *host_x;
+        auto func = rst.graph_compile(
+                {make_callback_copy(rst.output_var_map.at("y"), host_y)});
+        func->execute();
+        MGB_ASSERT_TENSOR_EQ(host_y_expect, host_y);
+    };
+    load(buf, checksum);
+    // mismatched checksum falls back to verification
+    load(buf, checksum + 1);
+
+    // corrupt the root table offset of the fbs::Graph
+    auto corrupted = buf;
+    uint64_t offset_to_fbs;
+    memcpy(&offset_to_fbs, corrupted.data() + 8, sizeof(offset_to_fbs));
+    auto root = corrupted.data() + 16 + offset_to_fbs + sizeof(uint32_t);
+    uint32_t bad_root = 0x7fffffff;
+    memcpy(root, &bad_root, sizeof(bad_root));
+    ASSERT_THROW(load(corrupted, checksum), SerializationError);
+}
+
+TEST(TestSerializer2, OprMemArena) {
+    auto fname = GET_OUTPUT_FILE();
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 3}), host_w = gen({2, 3});
+    {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"}),
+             w = opr::SharedDeviceTensor::make(*graph, *host_w),
+             y = (opr::exp(x) * w + x).rename("y");
+        GraphDumper::make(OutputFile::make_fs(fname.c_str()))->dump({y});
+    }
+
+    HostTensorND host_y_expect;
+    host_y_expect.copy_from(*host_x);
+    for (size_t i = 0; i < 6; ++i) {
+        auto xv = host_x->ptr<float>()[i];
+        host_y_expect.ptr<float>()[i] = std::exp(xv) * host_w->ptr<float>()[i] + xv;
+    }
+
+    GraphLoadConfig config;
+    config.opr_mem_arena = true;
+    auto rst = GraphLoader::make(InputFile::make_fs(fname.c_str()))->load(config);
+    auto y = rst.output_var_map.at("y");
+    // the arena is kept alive by loaded oprs after load() returns
+    auto y_add = opr::exp(y) + 1;
+    HostTensorND host_y, host_y_add;
+    *rst.tensor_map.at("x") = *host_x;
+    auto func = rst.graph_compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_add, host_y_add)});
+    func->execute();
+    MGB_ASSERT_TENSOR_EQ(host_y_expect, host_y);
+    for (size_t i = 0; i < 6; ++i) {
+        MGB_ASSERT_FLOAT_EQ(
+                std::exp(host_y.ptr<float>()[i]) + 1, host_y_add.ptr<float>()[i]);
+    }
+}
+
 TEST(TestSerializer2, ParamerizedDType) {
     auto fname = GET_OUTPUT_FILE();
     TensorShape shape{2, 3, 3};
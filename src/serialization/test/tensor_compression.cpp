@@ -0,0 +1,120 @@
+/**
+ * \file src/serialization/test/tensor_compression.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/serialization/tensor_compression.h"
+#include "megbrain/test/helper.h"
+
+using namespace mgb;
+using namespace serialization;
+
+namespace {
+HostTensorND compress_and_decompress(
+        const HostTensorND& src, TensorValueCompression method, size_t chunk_size,
+        size_t* compressed_size = nullptr) {
+    std::vector<uint8_t> buf;
+    auto size = compress_tensor_value(
+            *OutputFile::make_vector_proxy(&buf), src, method, chunk_size);
+    EXPECT_EQ(buf.size(), size);
+    if (compressed_size) {
+        *compressed_size = size;
+    }
+
+    HostTensorND dst{src.comp_node(), src.layout()};
+    auto fin = InputFile::make_mem_proxy(buf.data(), buf.size());
+    decompress_tensor_value(dst.raw_ptr(), src.layout(), *fin, method);
+    EXPECT_EQ(buf.size(), fin->tell());
+    return dst;
+}
+}  // anonymous namespace
+
+TEST(TestTensorCompression, RoundTrip) {
+    HostTensorGenerator<> gen;
+    HostTensorGenerator<dtype::Int8> gen_i8;
+    using Method = TensorValueCompression;
+    for (auto method : {Method::LZ, Method::SHUFFLE_LZ}) {
+        for (size_t chunk_size : {1, 7, 1024, 64 * 1024}) {
+            for (size_t size : {1, 3, 1000, 50000}) {
+                auto src = gen({size});
+                MGB_ASSERT_TENSOR_EQ(
+                        *src, compress_and_decompress(*src, method, chunk_size));
+                auto src_i8 = gen_i8({size});
+                MGB_ASSERT_TENSOR_EQ(
+                        *src_i8, compress_and_decompress(*src_i8, method, chunk_size));
+            }
+        }
+    }
+}
+
+TEST(TestTensorCompression, Ratio) {
+    // float values with few distinct exponents and mantissas
+    HostTensorND src{CompNode::load("cpu0"), {65536}, dtype::Float32()};
+    auto ptr = src.ptr<float>();
+    for (size_t i = 0; i < 65536; ++i) {
+        ptr[i] = (i * 7 % 61) / 16.f;
+    }
+    size_t size_lz, size_shuffle;
+    MGB_ASSERT_TENSOR_EQ(
+            src, compress_and_decompress(
+                         src, TensorValueCompression::LZ, 64 * 1024, &size_lz));
+    MGB_ASSERT_TENSOR_EQ(
+            src, compress_and_decompress(
+                         src, TensorValueCompression::SHUFFLE_LZ, 64 * 1024,
+                         &size_shuffle));
+    ASSERT_LT(size_lz, 65536u * 4 / 2);
+    ASSERT_LT(size_shuffle, 65536u * 4 / 2);
+
+    // incompressible values are stored as is, with chunk headers only
+    HostTensorGenerator<dtype::Uint8> gen_u8;
+    size_t size_rand;
+    auto rand = gen_u8({100000});
+    MGB_ASSERT_TENSOR_EQ(
+            *rand, compress_and_decompress(
+                           *rand, TensorValueCompression::LZ, 64 * 1024, &size_rand));
+    ASSERT_EQ(100000u + 2 * 8, size_rand);
+}
+
+TEST(TestTensorCompression, Corrupted) {
+    HostTensorND src{CompNode::load("cpu0"), {4096}, dtype::Int32()};
+    auto ptr = src.ptr<int>();
+    for (int i = 0; i < 4096; ++i) {
+        ptr[i] = i % 100;
+    }
+    std::vector<uint8_t> buf;
+    compress_tensor_value(
+            *OutputFile::make_vector_proxy(&buf), src, TensorValueCompression::LZ);
+    HostTensorND dst{src.comp_node(), src.layout()};
+    auto load = [&](std::vector<uint8_t> data) {
+        auto fin = InputFile::make_mem_proxy(data.data(), data.size());
+        decompress_tensor_value(
+                dst.raw_ptr(), src.layout(), *fin, TensorValueCompression::LZ);
+    };
+
+    load(buf);
+    MGB_ASSERT_TENSOR_EQ(src, dst);
+
+    // truncated LZ stream
+    auto bad = buf;
+    uint32_t stored_size;
+    memcpy(&stored_size, bad.data() + 4, 4);
+    ASSERT_LT(stored_size, 4096u * 4);
+    stored_size -= 1;
+    memcpy(bad.data() + 4, &stored_size, 4);
+    bad.pop_back();
+    ASSERT_THROW(load(bad), SerializationError);
+
+    // chunk larger than the tensor
+    bad = buf;
+    uint32_t raw_size = 4096 * 4 + 1;
+    memcpy(bad.data(), &raw_size, 4);
+    ASSERT_THROW(load(bad), SerializationError);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
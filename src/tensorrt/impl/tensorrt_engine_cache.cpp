@@ -25,7 +25,8 @@ using namespace mgb;
 
 /* ========================== TensorRTEngineCache ========================== */
 bool TensorRTEngineCache::sm_enable_engine_cache = false;
-std::string TensorRTEngineCache::make_key_from_trt_opr(const opr::TensorRTOpr* opr) {
+std::string TensorRTEngineCache::make_key_from_trt_opr(
+        const opr::TensorRTOpr* opr, const TensorShapeArray& inp_shape) {
     auto&& env = CompNodeEnv::from_comp_node(opr->output(0)->comp_node());
     mgb_assert(
             env.property().type == CompNode::DeviceType::CUDA,
@@ -37,6 +38,18 @@ std::string TensorRTEngineCache::make_key_from_trt_opr(const opr::TensorRTOpr* o
             "dev=%s;cap=%d.%d;trt=%d;", prop.name, prop.major, prop.minor,
             tensorrt_version);
     key.append(opr->cname());
+    // an engine built with an optimization profile covers a range of shapes,
+    // and is checked against the input shapes after loaded
+    if (opr->use_shape_profile()) {
+        key.append(";profile");
+    } else {
+        for (auto&& shape : inp_shape) {
+            key.append(";" + shape.to_string());
+        }
+        if (opr->use_int8_calibration(inp_shape)) {
+            key.append(";calib");
+        }
+    }
     return key;
 }
 
@@ -52,6 +52,71 @@ void TensorRTProfiler::print_layer_times() {
 
 #endif  // MGB_ENABLE_JSON
 
+#if NV_TENSOR_RT_VERSION >= 6001
+//! whether some axes of the dims are only known at runtime
+bool has_dynamic_dim(const nvinfer1::Dims& dims) {
+    for (int i = 0; i < dims.nbDims; ++i) {
+        if (dims.d[i] < 0)
+            return true;
+    }
+    return false;
+}
+
+bool dims_in_range(
+        const nvinfer1::Dims& dims, const nvinfer1::Dims& min,
+        const nvinfer1::Dims& max) {
+    if (dims.nbDims != min.nbDims || dims.nbDims != max.nbDims)
+        return false;
+    for (int i = 0; i < dims.nbDims; ++i) {
+        if (dims.d[i] < min.d[i] || dims.d[i] > max.d[i])
+            return false;
+    }
+    return true;
+}
+
+//! int8 entropy calibrator reading the samples of the network inputs
+class EntropyCalibrator final : public nvinfer1::IInt8EntropyCalibrator2 {
+    using Samples = std::vector<TensorRTOpr::CalibrationSample>;
+    std::shared_ptr<const Samples> m_samples;
+    CompNode m_cn;
+    size_t m_next = 0;
+    std::unordered_map<std::string, DeviceTensorND> m_dev_tensors;
+
+public:
+    EntropyCalibrator(std::shared_ptr<const Samples> samples, CompNode cn)
+            : m_samples{std::move(samples)}, m_cn{cn} {}
+
+    //! the batch is a part of the input shapes of explicit batch networks
+    int getBatchSize() const override { return 1; }
+
+    bool getBatch(void* bindings[], const char* names[], int nb_bindings) override {
+        if (m_next >= m_samples->size())
+            return false;
+        auto&& sample = (*m_samples)[m_next++];
+        for (int i = 0; i < nb_bindings; ++i) {
+            auto iter = sample.find(names[i]);
+            mgb_assert(
+                    iter != sample.end(), "no input %s in calibration sample %zu",
+                    names[i], m_next - 1);
+            auto dev = m_dev_tensors.find(names[i]);
+            if (dev == m_dev_tensors.end()) {
+                dev = m_dev_tensors.emplace(names[i], DeviceTensorND{m_cn}).first;
+            }
+            dev->second.copy_from(iter->second).sync();
+            bindings[i] = dev->second.raw_ptr();
+        }
+        return true;
+    }
+
+    const void* readCalibrationCache(size_t& length) override {
+        length = 0;
+        return nullptr;
+    }
+
+    void writeCalibrationCache(const void*, size_t) override {}
+};
+#endif
+
 }  // anonymous namespace
 
 /* ========================== Logger ========================== */
@@ -181,6 +246,19 @@ void TensorRTManager::exec(
         for (int i = 0; i < nr_input; ++i) {
             int binding_idx = engine->getBindingIndex(network->getInput(i)->getName());
             m_trt_iobuf[binding_idx] = opr->input(i)->dev_tensor().raw_ptr();
+#if NV_TENSOR_RT_VERSION >= 6001
+            // engines built with an optimization profile need the actual
+            // input shapes
+            if (has_dynamic_dim(engine->getBindingDimensions(binding_idx))) {
+                bool succ = m_context->setBindingDimensions(
+                        binding_idx, TensorRTOpr::shape2dims(
+                                             network->getInput(i),
+                                             opr->input(i)->shape()));
+                mgb_assert(
+                        succ, "failed to set the shape of input %d to %s", i,
+                        opr->input(i)->shape().to_string().c_str());
+            }
+#endif
         }
         int nr_output = network->getNbOutputs();
         for (int i = 0; i < nr_output; ++i) {
@@ -252,6 +330,10 @@ void TensorRTManager::exec(
 /* ========================== TensorRTOpr ========================== */
 
 MGB_DYN_TYPE_OBJ_FINAL_IMPL(TensorRTOpr);
+bool TensorRTOpr::sm_enable_dynamic_shape = false;
+std::shared_ptr<const std::vector<TensorRTOpr::CalibrationSample>>
+        TensorRTOpr::sm_calibration_samples;
+
 TensorRTOpr::TensorRTOpr(
         std::shared_ptr<nvinfer1::IBuilder> builder,
         std::shared_ptr<nvinfer1::INetworkDefinition> network,
@@ -286,19 +368,7 @@ TensorRTOpr::TensorRTOpr(
     add_equivalence_component<mgb::ScalarHash<void*>>(m_network.get());
     mgb_assert(m_builder != nullptr);
 #if NV_TENSOR_RT_VERSION >= 6001
-    m_builder_config = {
-            m_builder->createBuilderConfig(),
-            TensorRTDeleter<nvinfer1::IBuilderConfig>()};
-    m_builder_config->setMaxWorkspaceSize(1 << 30);
-    if (m_feature_bits == TensorRTGraphFeatureBits::NCHW4_QINT8) {
-        mgb_assert(
-                m_builder->platformHasFastInt8(),
-                "Cuda platform does not support fast native int8");
-        m_builder_config->setInt8Calibrator(nullptr);
-        nvinfer1::BuilderFlags flags;
-        flags = 1 << static_cast<int>(nvinfer1::BuilderFlag::kINT8);
-        m_builder_config->setFlags(flags);
-    }
+    m_builder_config = create_builder_config();
 #else
     m_builder->setMaxWorkspaceSize(1 << 30);
     if (m_feature_bits == TensorRTGraphFeatureBits::NCHW4_QINT8) {
@@ -314,6 +384,26 @@ TensorRTOpr::TensorRTOpr(
     m_builder->setGpuAllocator(m_gpu_allocator.get());
 }
 
+#if NV_TENSOR_RT_VERSION >= 6001
+TensorRTOpr::TensorRTUniquePtr<nvinfer1::IBuilderConfig> TensorRTOpr::
+        create_builder_config() const {
+    TensorRTUniquePtr<nvinfer1::IBuilderConfig> config{
+            m_builder->createBuilderConfig(),
+            TensorRTDeleter<nvinfer1::IBuilderConfig>()};
+    config->setMaxWorkspaceSize(1 << 30);
+    if (m_feature_bits == TensorRTGraphFeatureBits::NCHW4_QINT8) {
+        mgb_assert(
+                m_builder->platformHasFastInt8(),
+                "Cuda platform does not support fast native int8");
+        config->setInt8Calibrator(nullptr);
+        nvinfer1::BuilderFlags flags;
+        flags = 1 << static_cast<int>(nvinfer1::BuilderFlag::kINT8);
+        config->setFlags(flags);
+    }
+    return config;
+}
+#endif
+
 SymbolVarArray TensorRTOpr::make(
         std::shared_ptr<nvinfer1::IBuilder> builder,
         std::shared_ptr<nvinfer1::INetworkDefinition> network,
@@ -352,8 +442,8 @@ TensorShape TensorRTOpr::dims2shape(const nvinfer1::Dims& dims, size_t batch) {
     return ret;
 }
 
-void TensorRTOpr::set_input_by_tensor_shape(
-        nvinfer1::ITensor* const input, const TensorShape& tensor_shape) const {
+nvinfer1::Dims TensorRTOpr::shape2dims(
+        nvinfer1::ITensor* input, const TensorShape& tensor_shape) {
     nvinfer1::Dims dims = input->getDimensions();
 #if NV_TENSOR_RT_VERSION >= 6001
     auto tensor_format = input->getAllowedFormats();
@@ -385,7 +475,12 @@ void TensorRTOpr::set_input_by_tensor_shape(
         dims.d[i] = tensor_shape.shape[i];
     }
 #endif
-    input->setDimensions(dims);
+    return dims;
+}
+
+void TensorRTOpr::set_input_by_tensor_shape(
+        nvinfer1::ITensor* const input, const TensorShape& tensor_shape) const {
+    input->setDimensions(shape2dims(input, tensor_shape));
 }
 
 void TensorRTOpr::init_output_dtype() {
@@ -452,40 +547,11 @@ void TensorRTOpr::get_output_var_shape(
     m_builder->setMaxBatchSize(1);
 
     auto self = const_cast<TensorRTOpr*>(this);
-    if (m_engine == nullptr && TensorRTEngineCache::enable_engine_cache()) {
-        self->build_engine_from_cache();
-    }
-
-    bool engine_valid = true;
-    if (m_engine == nullptr) {
-        engine_valid = false;
-    } else {
-        int nr_input = m_network->getNbInputs();
-        mgb_assert(
-                static_cast<size_t>(nr_input) == input().size(), "input size changed");
-        for (int i = 0; i < nr_input; ++i) {
-            int binding_idx =
-                    m_engine->getBindingIndex(m_network->getInput(i)->getName());
-            auto cuda_engine_shp =
-                    dims2shape(m_engine->getBindingDimensions(binding_idx));
-#if NV_TENSOR_RT_VERSION >= 6001
-            auto tensor_format = m_engine->getBindingFormat(binding_idx);
-            // fix tensor shape from tensor format
-            if (tensor_format == nvinfer1::TensorFormat::kCHW4) {
-                mgb_assert(cuda_engine_shp.ndim == 4);
-                cuda_engine_shp.ndim++;
-                cuda_engine_shp[1] /= 4;
-                cuda_engine_shp[4] = 4;
-            }
-#endif
-            if (!cuda_engine_shp.eq_shape(inp_shape[i])) {
-                engine_valid = false;
-                break;
-            }
-        }
+    if (!engine_valid_for(inp_shape) && TensorRTEngineCache::enable_engine_cache()) {
+        self->build_engine_from_cache(inp_shape);
     }
 
-    if (!engine_valid) {
+    if (!engine_valid_for(inp_shape)) {
         comp_node().activate();
         // If a context created by a cuda engine, the context must be destroyed
         // before the corresponding cuda engine. Otherwise, a segmentfault will
@@ -493,9 +559,15 @@ void TensorRTOpr::get_output_var_shape(
         self->m_manager.clear_trt_context();
         RealTimer timer;
 #if NV_TENSOR_RT_VERSION >= 6001
-        self->m_engine = {
-                m_builder->buildEngineWithConfig(*m_network, *m_builder_config),
-                TensorRTDeleter<nvinfer1::ICudaEngine>()};
+        if (use_shape_profile()) {
+            self->build_engine_with_profile(inp_shape);
+        } else if (use_int8_calibration(inp_shape)) {
+            self->build_engine_with_calibration();
+        } else {
+            self->m_engine = {
+                    m_builder->buildEngineWithConfig(*m_network, *m_builder_config),
+                    TensorRTDeleter<nvinfer1::ICudaEngine>()};
+        }
 #else
         self->m_engine = {
                 m_builder->buildCudaEngine(*m_network),
@@ -507,13 +579,225 @@ void TensorRTOpr::get_output_var_shape(
                 timer.get_msecs());
 
         if (TensorRTEngineCache::enable_engine_cache()) {
-            serialize_engine_to_cache();
+            serialize_engine_to_cache(inp_shape);
         }
     }
 
     out_shape.back() = {intl::workspace_size(m_engine.get())};
 }
 
+bool TensorRTOpr::engine_valid_for(const TensorShapeArray& inp_shape) const {
+    if (m_engine == nullptr)
+        return false;
+    int nr_input = m_network->getNbInputs();
+    mgb_assert(static_cast<size_t>(nr_input) == input().size(), "input size changed");
+    for (int i = 0; i < nr_input; ++i) {
+        int binding_idx = m_engine->getBindingIndex(m_network->getInput(i)->getName());
+#if NV_TENSOR_RT_VERSION >= 6001
+        if (has_dynamic_dim(m_engine->getBindingDimensions(binding_idx))) {
+            auto dims = shape2dims(m_network->getInput(i), inp_shape[i]);
+            if (!dims_in_range(
+                        dims,
+                        m_engine->getProfileDimensions(
+                                binding_idx, 0, nvinfer1::OptProfileSelector::kMIN),
+                        m_engine->getProfileDimensions(
+                                binding_idx, 0, nvinfer1::OptProfileSelector::kMAX)))
+                return false;
+            continue;
+        }
+#endif
+        auto cuda_engine_shp = dims2shape(m_engine->getBindingDimensions(binding_idx));
+#if NV_TENSOR_RT_VERSION >= 6001
+        auto tensor_format = m_engine->getBindingFormat(binding_idx);
+        // fix tensor shape from tensor format
+        if (tensor_format == nvinfer1::TensorFormat::kCHW4) {
+            mgb_assert(cuda_engine_shp.ndim == 4);
+            cuda_engine_shp.ndim++;
+            cuda_engine_shp[1] /= 4;
+            cuda_engine_shp[4] = 4;
+        }
+#endif
+        if (!cuda_engine_shp.eq_shape(inp_shape[i]))
+            return false;
+    }
+    return true;
+}
+
+void TensorRTOpr::set_shape_profile(const ShapeProfile& profile) {
+#if NV_TENSOR_RT_VERSION >= 6001
+    mgb_assert(
+            !m_network->hasImplicitBatchDimension(),
+            "optimization profiles need a network with explicit batch dimension");
+    size_t nr_input = m_network->getNbInputs();
+    mgb_assert(
+            profile.min.size() == nr_input && profile.opt.size() == nr_input &&
+                    profile.max.size() == nr_input,
+            "the shape profile should contain %zu inputs", nr_input);
+    m_profile_dims.resize(nr_input);
+    for (size_t i = 0; i < nr_input; ++i) {
+        auto input = m_network->getInput(i);
+        auto&& dims = m_profile_dims[i];
+        dims.min = shape2dims(input, profile.min[i]);
+        dims.opt = shape2dims(input, profile.opt[i]);
+        dims.max = shape2dims(input, profile.max[i]);
+        mgb_assert(
+                dims_in_range(dims.opt, dims.min, dims.max),
+                "invalid shape profile of input %zu: min=%s opt=%s max=%s", i,
+                profile.min[i].to_string().c_str(),
+                profile.opt[i].to_string().c_str(),
+                profile.max[i].to_string().c_str());
+    }
+    m_user_profile = true;
+#else
+    MGB_MARK_USED_VAR(profile);
+    mgb_throw(
+            MegBrainError,
+            "optimization profiles need TensorRT 6 or later, got %d",
+            NV_TENSOR_RT_VERSION);
+#endif
+}
+
+bool TensorRTOpr::use_shape_profile() const {
+#if NV_TENSOR_RT_VERSION >= 6001
+    return !m_network->hasImplicitBatchDimension() &&
+           (m_user_profile || sm_enable_dynamic_shape);
+#else
+    return false;
+#endif
+}
+
+bool TensorRTOpr::enable_dynamic_shape(bool enable_dynamic_shape) {
+    if (enable_dynamic_shape)
+        sm_enable_dynamic_shape = enable_dynamic_shape;
+    return sm_enable_dynamic_shape;
+}
+
+void TensorRTOpr::disable_dynamic_shape() {
+    sm_enable_dynamic_shape = false;
+}
+
+void TensorRTOpr::set_int8_calibration_samples(
+        std::vector<CalibrationSample> samples) {
+    if (samples.empty()) {
+        sm_calibration_samples.reset();
+    } else {
+        sm_calibration_samples =
+                std::make_shared<const std::vector<CalibrationSample>>(
+                        std::move(samples));
+    }
+}
+
+bool TensorRTOpr::use_int8_calibration(const TensorShapeArray& inp_shape) const {
+#if NV_TENSOR_RT_VERSION >= 6001
+    // the calibration of optimization profiles needs a calibration profile,
+    // which is not supported
+    if (m_feature_bits != TensorRTGraphFeatureBits::NCHW_FLOAT ||
+        !sm_calibration_samples || use_shape_profile())
+        return false;
+    auto&& sample = sm_calibration_samples->front();
+    for (int i = 0; i < m_network->getNbInputs(); ++i) {
+        auto iter = sample.find(m_network->getInput(i)->getName());
+        if (iter == sample.end() || !iter->second.shape().eq_shape(inp_shape[i]))
+            return false;
+    }
+    return m_builder->platformHasFastInt8();
+#else
+    MGB_MARK_USED_VAR(inp_shape);
+    return false;
+#endif
+}
+
+#if NV_TENSOR_RT_VERSION >= 6001
+void TensorRTOpr::build_engine_with_calibration() {
+    auto config = create_builder_config();
+    EntropyCalibrator calibrator{sm_calibration_samples, comp_node()};
+    config->setFlags(
+            config->getFlags() |
+            (1 << static_cast<int>(nvinfer1::BuilderFlag::kINT8)));
+    config->setInt8Calibrator(&calibrator);
+    m_engine = {
+            m_builder->buildEngineWithConfig(*m_network, *config),
+            TensorRTDeleter<nvinfer1::ICudaEngine>()};
+    mgb_log_debug(
+            "TensorRTOpr(name:%s) calibrated with %zu samples", cname(),
+            sm_calibration_samples->size());
+}
+
+void TensorRTOpr::build_engine_with_profile(const TensorShapeArray& inp_shape) {
+    size_t nr_input = m_network->getNbInputs();
+    if (!m_user_profile && m_profile_dims.empty() && m_engine) {
+        // start from the shapes covered by the current engine, which may be
+        // loaded from the cache
+        m_profile_dims.resize(nr_input);
+        for (size_t i = 0; i < nr_input; ++i) {
+            int binding_idx =
+                    m_engine->getBindingIndex(m_network->getInput(i)->getName());
+            auto&& dims = m_profile_dims[i];
+            dims.opt = m_engine->getBindingDimensions(binding_idx);
+            dims.min = dims.max = dims.opt;
+            if (has_dynamic_dim(dims.opt)) {
+                dims.min = m_engine->getProfileDimensions(
+                        binding_idx, 0, nvinfer1::OptProfileSelector::kMIN);
+                dims.max = m_engine->getProfileDimensions(
+                        binding_idx, 0, nvinfer1::OptProfileSelector::kMAX);
+            }
+        }
+    }
+    // the first shapes seen by the opr
+    bool first_shape = m_profile_dims.empty();
+    m_profile_dims.resize(nr_input);
+    for (size_t i = 0; i < nr_input; ++i) {
+        auto cur = shape2dims(m_network->getInput(i), inp_shape[i]);
+        auto&& dims = m_profile_dims[i];
+        if (first_shape) {
+            dims = {cur, cur, cur};
+            continue;
+        }
+        if (m_user_profile) {
+            mgb_assert(
+                    dims_in_range(cur, dims.min, dims.max),
+                    "shape %s of input %zu is out of the shape profile of %s",
+                    inp_shape[i].to_string().c_str(), i, cname());
+            continue;
+        }
+        mgb_assert(cur.nbDims == dims.opt.nbDims);
+        for (int j = 0; j < cur.nbDims; ++j) {
+            dims.min.d[j] = std::min(dims.min.d[j], cur.d[j]);
+            dims.max.d[j] = std::max(dims.max.d[j], cur.d[j]);
+        }
+        dims.opt = cur;
+    }
+
+    // profiles are accumulated in the builder config, so use a new one
+    auto config = create_builder_config();
+    auto profile = m_builder->createOptimizationProfile();
+    for (size_t i = 0; i < nr_input; ++i) {
+        auto input = m_network->getInput(i);
+        auto&& dims = m_profile_dims[i];
+        auto dynamic_dims = dims.opt;
+        for (int j = 0; j < dynamic_dims.nbDims; ++j) {
+            if (dims.min.d[j] != dims.max.d[j])
+                dynamic_dims.d[j] = -1;
+        }
+        input->setDimensions(dynamic_dims);
+        profile->setDimensions(
+                input->getName(), nvinfer1::OptProfileSelector::kMIN, dims.min);
+        profile->setDimensions(
+                input->getName(), nvinfer1::OptProfileSelector::kOPT, dims.opt);
+        profile->setDimensions(
+                input->getName(), nvinfer1::OptProfileSelector::kMAX, dims.max);
+    }
+    config->addOptimizationProfile(profile);
+    m_engine = {
+            m_builder->buildEngineWithConfig(*m_network, *config),
+            TensorRTDeleter<nvinfer1::ICudaEngine>()};
+    // restore the static shapes for the shape inference of the outputs
+    for (size_t i = 0; i < nr_input; ++i) {
+        set_input_by_tensor_shape(m_network->getInput(i), inp_shape[i]);
+    }
+}
+#endif
+
 void TensorRTOpr::add_input_layout_constraint() {
     for (auto i : input()) {
         i->add_layout_constraint_contiguous();
@@ -524,26 +808,28 @@ void TensorRTOpr::scn_do_execute() {
     m_manager.exec(this, m_gpu_allocator->comp_node(), m_engine.get());
 }
 
-void TensorRTOpr::build_engine_from_cache() {
+void TensorRTOpr::build_engine_from_cache(const TensorShapeArray& inp_shape) {
     TensorRTUniquePtr<nvinfer1::IRuntime> runtime{
             nvinfer1::createInferRuntime(TensorRTOpr::Logger::instance()), {}};
     runtime->setGpuAllocator(m_gpu_allocator.get());
     auto ret = TensorRTEngineCache::inst().get(
-            TensorRTEngineCache::make_key_from_trt_opr(this));
+            TensorRTEngineCache::make_key_from_trt_opr(this, inp_shape));
     if (!ret.valid())
         return;
     comp_node().activate();
     auto engine = runtime->deserializeCudaEngine(
             reinterpret_cast<const void*>(ret->ptr), ret->size, nullptr);
     mgb_assert(engine, "failed to deserialize ICudaEngine");
+    // the context of the previous engine must be destroyed before it
+    m_manager.clear_trt_context();
     m_engine = {engine, TensorRTDeleter<nvinfer1::ICudaEngine>()};
 }
 
-void TensorRTOpr::serialize_engine_to_cache() const {
+void TensorRTOpr::serialize_engine_to_cache(const TensorShapeArray& inp_shape) const {
     TensorRTUniquePtr<nvinfer1::IHostMemory> buf{trt_cuda_engine()->serialize(), {}};
     mgb_assert(buf, "failed to serialize ICudaEngine");
     TensorRTEngineCache::inst().put(
-            TensorRTEngineCache::make_key_from_trt_opr(this),
+            TensorRTEngineCache::make_key_from_trt_opr(this, inp_shape),
             {buf->data(), buf->size()});
 }
 
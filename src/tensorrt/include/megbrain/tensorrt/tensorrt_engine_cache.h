@@ -21,8 +21,9 @@ namespace mgb {
  *
  * The cache stores tensorrt engine as key-value pairs. The keys are ascii
  * strings, which include the device name, the compute capability, the tensorrt
- * runtime version and the name of operator. The get and put methods must be
- * thread safe. read_cache() and dump_cache() are not thread safe
+ * runtime version, the name of operator and the input shapes of the engine if
+ * it is not built with an optimization profile. The get and put methods must
+ * be thread safe. read_cache() and dump_cache() are not thread safe
  *
  * \note We did not implement the hashing of general graph, and just used the
  * name of tensorrt opr as the key. This implementation is enough, when there is
@@ -45,8 +46,9 @@ public:
     virtual void put(const std::string& key, const Engine& value) = 0;
     virtual void dump_cache() = 0;
 
-    //! get the key of the TensorRTOpr
-    static std::string make_key_from_trt_opr(const opr::TensorRTOpr* opr);
+    //! get the key of the engine of the TensorRTOpr for the input shapes
+    static std::string make_key_from_trt_opr(
+            const opr::TensorRTOpr* opr, const TensorShapeArray& inp_shape = {});
 
     //! enable the tensorrt engine cache, or query whether the cache is used
     static bool enable_engine_cache(bool enable_engine_cache = false);
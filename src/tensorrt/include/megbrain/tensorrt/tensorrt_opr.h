@@ -86,6 +86,9 @@ MGB_DEFINE_OPR_CLASS(TensorRTOpr, mgb::cg::SingleCNOutshapePureByInshapeOprBase)
     void set_input_by_tensor_shape(
             nvinfer1::ITensor* const input, const TensorShape& tensor_shape) const;
 
+    //! whether the current engine can be used for the input shapes
+    bool engine_valid_for(const TensorShapeArray& inp_shape) const;
+
 public:
     template <typename T>
     using TensorRTDeleter = intl::TensorRTDeleter<T>;
@@ -149,16 +152,86 @@ public:
     //! convert TensorRT Dims to mgb TensorShape
     static TensorShape dims2shape(const nvinfer1::Dims& dims, size_t batch = 0);
 
+    //! convert mgb TensorShape to the Dims of a network input, in the format
+    //! allowed by the input
+    static nvinfer1::Dims shape2dims(
+            nvinfer1::ITensor* input, const TensorShape& tensor_shape);
+
+    //! min/opt/max shapes of the inputs of an optimization profile
+    struct ShapeProfile {
+        TensorShapeArray min, opt, max;
+    };
+
+    /*!
+     * \brief build the engine with an optimization profile, so that one
+     *      engine is used for all the input shapes in [min, max]
+     *
+     * Only networks with explicit batch dimension on TensorRT 6 or later
+     * support optimization profiles.
+     */
+    void set_shape_profile(const ShapeProfile& profile);
+
+    //! whether the engine is built with an optimization profile
+    bool use_shape_profile() const;
+
+    /*!
+     * \brief enable optimization profiles for the oprs without a profile
+     *      given by set_shape_profile(), or query whether they are enabled
+     *
+     * The profile covers the input shapes which the opr has been built for.
+     * When a shape out of the profile comes, the profile is widened to cover
+     * it and the engine is rebuilt.
+     */
+    static bool enable_dynamic_shape(bool enable_dynamic_shape = false);
+    //! disable optimization profiles for the oprs without a given profile
+    static void disable_dynamic_shape();
+
+    //! a sample of the network inputs for int8 calibration, which maps the
+    //! names of the inputs to their values
+    using CalibrationSample = std::unordered_map<std::string, HostTensorND>;
+
+    /*!
+     * \brief set the samples to calibrate float networks to int8
+     *
+     * The engines of float networks, whose input names and shapes match the
+     * samples, are built in int8 with an entropy calibrator reading the
+     * samples. Networks with quantized dtypes do not need calibration, as the
+     * scales of the dtypes are used as the dynamic ranges of their tensors.
+     * Pass an empty array to disable calibration.
+     */
+    static void set_int8_calibration_samples(std::vector<CalibrationSample> samples);
+
+    //! whether the engine for the input shapes is calibrated to int8
+    bool use_int8_calibration(const TensorShapeArray& inp_shape) const;
+
     //! get underlying TensorRTManager; for debug
     const intl::TensorRTManager& trt_manager() const { return m_manager; }
 
     //! build cuda engine from cache
-    void build_engine_from_cache();
+    void build_engine_from_cache(const TensorShapeArray& inp_shape);
 
     //! serialize engine to cache
-    void serialize_engine_to_cache() const;
+    void serialize_engine_to_cache(const TensorShapeArray& inp_shape) const;
 
 private:
+#if NV_TENSOR_RT_VERSION >= 6001
+    struct ProfileDims {
+        nvinfer1::Dims min, opt, max;
+    };
+
+    TensorRTUniquePtr<nvinfer1::IBuilderConfig> create_builder_config() const;
+
+    //! widen the profile to the input shapes and build the engine with it
+    void build_engine_with_profile(const TensorShapeArray& inp_shape);
+
+    void build_engine_with_calibration();
+
+    std::vector<ProfileDims> m_profile_dims;
+    bool m_user_profile = false;
+#endif
+    static bool sm_enable_dynamic_shape;
+    static std::shared_ptr<const std::vector<CalibrationSample>> sm_calibration_samples;
+
     // note: gpu allocator must be released after other trt objects
     std::shared_ptr<GpuAllocator> m_gpu_allocator;
     std::shared_ptr<nvinfer1::INetworkDefinition> m_network;
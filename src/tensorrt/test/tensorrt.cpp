@@ -152,6 +152,125 @@ TEST(TestOprTensorRT, ConcatBasic) {
     MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 1e-4);
 }
 
+#if NV_TENSOR_RT_VERSION >= 6001
+TEST(TestOprTensorRT, DynamicShape) {
+    REQUIRE_GPU(1);
+    intl::SimpleTensorRTNetwork net;
+
+    TensorRTOpr::enable_dynamic_shape(true);
+    auto p = net.create_trt_network(true);
+    auto y2 = TensorRTOpr::make(
+            TensorRTOpr::to_shared_ptr_builder(p.first),
+            TensorRTOpr::to_shared_ptr_network(p.second),
+            intl::TensorRTGraphFeatureBits::NCHW_FLOAT, {}, {net.x})[0];
+    auto&& trt_opr = y2.node()->owner_opr()->cast_final_safe<TensorRTOpr>();
+
+    HostTensorND host_z1;
+    HostTensorND host_z2;
+    auto func = net.graph->compile(
+            {make_callback_copy(net.y, host_z1), make_callback_copy(y2, host_z2)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+
+    auto&& host_x = net.host_x;
+    auto&& gen = net.gen;
+
+    // widen the profile to [{5, 23, 28, 28}, {10, 23, 40, 40}]
+    *host_x = *gen({10, 23, 40, 40});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+    auto engine = trt_opr.trt_cuda_engine().get();
+
+    // covered by the profile, the engine should be reused
+    *host_x = *gen({7, 23, 33, 30});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+    ASSERT_EQ(engine, trt_opr.trt_cuda_engine().get());
+
+    *host_x = *gen({1, 23, 28, 28});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+    ASSERT_NE(engine, trt_opr.trt_cuda_engine().get());
+    TensorRTOpr::disable_dynamic_shape();
+}
+
+TEST(TestOprTensorRT, ShapeProfile) {
+    REQUIRE_GPU(1);
+    intl::SimpleTensorRTNetwork net;
+
+    auto p = net.create_trt_network(true);
+    auto y2 = TensorRTOpr::make(
+            TensorRTOpr::to_shared_ptr_builder(p.first),
+            TensorRTOpr::to_shared_ptr_network(p.second),
+            intl::TensorRTGraphFeatureBits::NCHW_FLOAT, {}, {net.x})[0];
+    auto&& trt_opr = y2.node()->owner_opr()->cast_final_safe<TensorRTOpr>();
+    TensorRTOpr::ShapeProfile profile;
+    profile.min = {TensorShape{1, 23, 16, 16}};
+    profile.opt = {TensorShape{5, 23, 28, 28}};
+    profile.max = {TensorShape{8, 23, 32, 32}};
+    trt_opr.set_shape_profile(profile);
+
+    HostTensorND host_z1;
+    HostTensorND host_z2;
+    auto func = net.graph->compile(
+            {make_callback_copy(net.y, host_z1), make_callback_copy(y2, host_z2)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+    auto engine = trt_opr.trt_cuda_engine().get();
+
+    auto&& host_x = net.host_x;
+    auto&& gen = net.gen;
+    for (auto&& shp : TensorShapeArray{{1, 23, 16, 16}, {8, 23, 32, 32}}) {
+        *host_x = *gen(shp);
+        func->execute();
+        MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+        ASSERT_EQ(engine, trt_opr.trt_cuda_engine().get());
+    }
+
+    *host_x = *gen({9, 23, 32, 32});
+    ASSERT_THROW(func->execute(), MegBrainError);
+}
+
+TEST(TestOprTensorRT, Int8Calibration) {
+    REQUIRE_GPU(1);
+    auto&& prop = CompNodeEnv::from_comp_node(CompNode::load("gpu0"))
+                          .cuda_env()
+                          .device_prop;
+    if (prop.major * 10 + prop.minor < 61) {
+        printf("This testcase ignored due to insufficient cuda cap\n");
+        return;
+    }
+    intl::SimpleTensorRTNetwork net;
+    std::vector<TensorRTOpr::CalibrationSample> samples(8);
+    for (auto&& sample : samples) {
+        sample["data"] = *net.gen(net.host_x->shape());
+    }
+    TensorRTOpr::set_int8_calibration_samples(samples);
+
+    auto p = net.create_trt_network(true);
+    auto y2 = TensorRTOpr::make(
+            TensorRTOpr::to_shared_ptr_builder(p.first),
+            TensorRTOpr::to_shared_ptr_network(p.second),
+            intl::TensorRTGraphFeatureBits::NCHW_FLOAT, {}, {net.x})[0];
+    auto&& trt_opr = y2.node()->owner_opr()->cast_final_safe<TensorRTOpr>();
+
+    HostTensorND host_z1;
+    HostTensorND host_z2;
+    auto func = net.graph->compile(
+            {make_callback_copy(net.y, host_z1), make_callback_copy(y2, host_z2)});
+    func->execute();
+    ASSERT_TRUE(trt_opr.use_int8_calibration({net.host_x->shape()}));
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 1e-1);
+
+    // no sample for the shape, fall back to float
+    *net.host_x = *net.gen({1, 23, 28, 28});
+    func->execute();
+    ASSERT_FALSE(trt_opr.use_int8_calibration({net.host_x->shape()}));
+    MGB_ASSERT_TENSOR_NEAR(host_z1, host_z2, 2e-4);
+    TensorRTOpr::set_int8_calibration_samples({});
+}
+#endif
+
 #endif  // MGB_ENABLE_TENSOR_RT
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}